@@ -0,0 +1,82 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Diff the results of relax_bench.py between two commits.
+
+Every metric is better when lower. A metric regresses when it grows by more than the threshold,
+relative to the baseline. The times in seconds below --min-seconds in both results, e.g. of the
+passes that barely run, are left out as noise. The exit code is 1 when any metric regressed, so
+that the script can gate a CI job.
+"""
+import argparse
+import json
+import sys
+
+
+def _parse_args():
+    args = argparse.ArgumentParser()
+    args.add_argument("baseline", type=str)
+    args.add_argument("candidate", type=str)
+    args.add_argument("--threshold", type=float, default=0.05)
+    args.add_argument("--min-seconds", type=float, default=0.01)
+    return args.parse_args()
+
+
+def compare(baseline, candidate, threshold, min_seconds):
+    """Return the (metric, baseline, candidate, relative change) of the regressions and of the
+    improvements, and the metrics found in only one of the results."""
+    regressions, improvements = [], []
+    for key in sorted(set(baseline) & set(candidate)):
+        old, new = baseline[key], candidate[key]
+        if key.endswith("_s") and max(old, new) < min_seconds:
+            continue
+        if old == 0:
+            change = 0.0 if new == 0 else float("inf")
+        else:
+            change = (new - old) / old
+        if change > threshold:
+            regressions.append((key, old, new, change))
+        elif change < -threshold:
+            improvements.append((key, old, new, change))
+    unmatched = sorted(set(baseline) ^ set(candidate))
+    return regressions, improvements, unmatched
+
+
+def main():
+    args = _parse_args()
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    with open(args.candidate) as f:
+        candidate = json.load(f)
+    if baseline["meta"]["target"] != candidate["meta"]["target"]:
+        print(
+            "warning: the results are of the targets %s and %s"
+            % (baseline["meta"]["target"], candidate["meta"]["target"])
+        )
+    regressions, improvements, unmatched = compare(
+        baseline["metrics"], candidate["metrics"], args.threshold, args.min_seconds
+    )
+    for title, rows in [("Regressions", regressions), ("Improvements", improvements)]:
+        print("%s (%d):" % (title, len(rows)))
+        for key, old, new, change in rows:
+            print("  %-70s %14.4f -> %14.4f  %+7.1f%%" % (key, old, new, change * 100))
+    if unmatched:
+        print("Metrics in only one of the results: %s" % ", ".join(unmatched))
+    sys.exit(1 if regressions else 0)
+
+
+if __name__ == "__main__":
+    main()
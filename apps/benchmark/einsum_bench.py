@@ -0,0 +1,94 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Latency of topi.einsum in a single nested loop and contracted pairwise, on one target.
+
+The pairwise contractions follow the path of `topi.einsum_path`, each one a batched matmul,
+where the single nested loop multiplies all the operands at each point of the iteration space
+of all the labels. The functions are built with the default schedule, or tuned by meta_schedule
+with `--tune-trials`, which the GPU targets require, e.g.
+
+    python3 einsum_bench.py --target llvm --tune-trials 256 --output einsum.json
+"""
+import argparse
+import json
+import os
+import tempfile
+
+import numpy as np
+
+import tvm
+from tvm import meta_schedule as ms
+from tvm import te, topi
+
+# The equations and the shapes of their operands, small enough for the single nested loop to
+# run in seconds.
+EQUATIONS = {
+    "matmul_chain": ("ij,jk,kl,lm->im", [(64, 64), (64, 64), (64, 64), (64, 16)]),
+    "bilinear": ("bi,ioj,bj->bo", [(64, 128), (128, 64, 128), (64, 128)]),
+    "attention": ("bhqd,bhkd,bhkv->bhqv", [(4, 8, 64, 32), (4, 8, 64, 32), (4, 8, 64, 32)]),
+    "tensor_train": ("ia,ajb,bkc,cl->ijkl", [(16, 8), (8, 16, 8), (8, 16, 8), (8, 16)]),
+}
+
+
+def build(equation, shapes, optimize, target, tune_trials, work_dir):
+    """Build the einsum with the given optimization."""
+    inputs = [te.placeholder(shape, name="x%d" % i) for i, shape in enumerate(shapes)]
+    out = topi.einsum(equation, *inputs, optimize=optimize)
+    func = te.create_prim_func(inputs + [out])
+    if tune_trials > 0:
+        database = ms.tune_tir(func, target, work_dir, tune_trials)
+        sch = ms.tir_integration.compile_tir(database, func, target)
+        func = sch.mod if sch is not None else func
+    return tvm.build(func, target=target)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--target", type=str, default="llvm", help="The target to build for.")
+    parser.add_argument("--tune-trials", type=int, default=0, help="The trials of each build.")
+    parser.add_argument("--repeat", type=int, default=20, help="The runs of each function.")
+    parser.add_argument("--output", type=str, default=None, help="The JSON file of the results.")
+    args = parser.parse_args()
+
+    target = tvm.target.Target(args.target)
+    dev = tvm.device(target.kind.name, 0)
+    results = {}
+    with tempfile.TemporaryDirectory() as work_root:
+        for name, (equation, shapes) in EQUATIONS.items():
+            arrays = [
+                tvm.nd.array(np.random.uniform(-1, 1, shape).astype("float32"), dev)
+                for shape in shapes
+            ]
+            inputs = [te.placeholder(shape) for shape in shapes]
+            path = topi.einsum_path(equation, *inputs, optimize="optimal")
+            print("%s: %s, path %s" % (name, equation, path))
+            for optimize in [False, "greedy", "optimal"]:
+                work_dir = os.path.join(work_root, "%s_%s" % (name, optimize))
+                func = build(equation, shapes, optimize, target, args.tune_trials, work_dir)
+                out_shape = np.einsum(equation, *[np.empty(shape) for shape in shapes]).shape
+                out = tvm.nd.empty(out_shape, "float32", dev)
+                timer = func.time_evaluator(func.entry_name, dev, number=args.repeat)
+                key = "%s/%s_us" % (name, "loop" if optimize is False else optimize)
+                results[key] = timer(*arrays, out).mean * 1e6
+                print("%24s: %.1f us" % (key, results[key]))
+    if args.output:
+        with open(args.output, "w") as out_file:
+            json.dump(results, out_file, indent=2)
+
+
+if __name__ == "__main__":
+    main()
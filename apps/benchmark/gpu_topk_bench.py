@@ -0,0 +1,100 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Latency of the top-k of the rows of a batch of logits on CUDA, by radix select or by sort.
+
+`tvm.contrib.thrust.radix_topk` selects the k first elements of each row before sorting them,
+where `tvm.contrib.thrust.sort` sorts whole rows, the path of topi's topk with thrust. The
+softmax top-p of the same rows is also timed. Needs a build with USE_THRUST, e.g.
+
+    python3 gpu_topk_bench.py --batch 32 --vocab 128000 --k 50 --output topk.json
+"""
+import argparse
+import json
+
+import numpy as np
+
+import tvm
+from tvm import te
+
+
+def build_extern(inputs, out_shapes, out_dtypes, func_name, *scalar_args):
+    """Build a function calling the packed function `func_name` in the destination style."""
+    outs = te.extern(
+        out_shapes,
+        inputs,
+        lambda ins, outs: tvm.tir.call_packed(func_name, *ins, *outs, *scalar_args),
+        dtype=out_dtypes,
+    )
+    outs = outs if isinstance(outs, list) else [outs]
+    sch = te.create_schedule([out.op for out in outs])
+    return tvm.build(sch, [*inputs, *outs], "cuda")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--batch", type=int, default=32, help="The rows of the logits.")
+    parser.add_argument("--vocab", type=int, default=128000, help="The length of the rows.")
+    parser.add_argument("--k", type=int, default=50, help="The elements selected by row.")
+    parser.add_argument("--dtype", type=str, default="float32", help="float32 or float16.")
+    parser.add_argument("--repeat", type=int, default=100, help="The runs of each kernel.")
+    parser.add_argument("--output", type=str, default=None, help="The JSON file of the results.")
+    args = parser.parse_args()
+
+    batch, vocab, k, dtype = args.batch, args.vocab, args.k, args.dtype
+    data = te.placeholder((batch, vocab), name="data", dtype=dtype)
+    top_p = te.placeholder((batch,), name="top_p", dtype="float32")
+    # The inputs, the shapes and the dtypes of the outputs, the packed function and its scalars.
+    benchmarks = {
+        "radix_topk": (
+            [data],
+            [(batch, k), (batch, k)],
+            [dtype, "int32"],
+            ["tvm.contrib.thrust.radix_topk", k, False],
+        ),
+        "thrust_sort": (
+            [data],
+            [(batch, vocab), (batch, vocab)],
+            [dtype, "int32"],
+            ["tvm.contrib.thrust.sort", False],
+        ),
+        "softmax_top_p": (
+            [data, top_p],
+            [(batch, vocab)],
+            ["float32"],
+            ["tvm.contrib.thrust.softmax_top_p"],
+        ),
+    }
+
+    dev = tvm.cuda(0)
+    arrays = {
+        data: tvm.nd.array(np.random.normal(size=(batch, vocab)).astype(dtype), dev),
+        top_p: tvm.nd.array(np.full((batch,), 0.9, "float32"), dev),
+    }
+    results = {}
+    for name, (inputs, out_shapes, out_dtypes, call) in benchmarks.items():
+        func = build_extern(inputs, out_shapes, out_dtypes, *call)
+        outs = [tvm.nd.empty(shape, dt, dev) for shape, dt in zip(out_shapes, out_dtypes)]
+        timer = func.time_evaluator(func.entry_name, dev, number=args.repeat)
+        results[name] = timer(*[arrays[x] for x in inputs], *outs).mean * 1e6
+        print(f"{name:>16}: {results[name]:.1f} us")
+    if args.output:
+        with open(args.output, "w") as out_file:
+            json.dump(results, out_file, indent=2)
+
+
+if __name__ == "__main__":
+    main()
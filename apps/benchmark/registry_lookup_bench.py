@@ -0,0 +1,51 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Multi-threaded throughput of the lookups of the global PackedFunc registry.
+
+The VM resolves the functions it calls, e.g. in `vm.call_tir_dyn`, through the registry, so
+that concurrent serving threads contend on it. The lookups run in C++ threads, without the GIL.
+Run it on two builds and compare the results, e.g.
+
+    python3 registry_lookup_bench.py --threads 1 2 4 8 --output after.json
+"""
+import argparse
+import json
+
+import tvm
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--threads", type=int, nargs="+", default=[1, 2, 4, 8])
+    parser.add_argument("--lookups", type=int, default=1000000, help="The lookups per thread.")
+    parser.add_argument("--name", type=str, default="vm.builtin.alloc_storage")
+    parser.add_argument("--output", type=str, default=None, help="The JSON file of the results.")
+    args = parser.parse_args()
+
+    f_bench = tvm.get_global_func("testing.registry_lookup_throughput")
+    results = {}
+    for num_threads in args.threads:
+        f_bench(args.name, num_threads, args.lookups // 10)  # warm up
+        results[num_threads] = f_bench(args.name, num_threads, args.lookups)
+        print(f"{num_threads:>3} threads: {results[num_threads] / 1e6:.2f} M lookups/s")
+    if args.output:
+        with open(args.output, "w") as out_file:
+            json.dump(results, out_file, indent=2)
+
+
+if __name__ == "__main__":
+    main()
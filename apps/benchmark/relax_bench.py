@@ -0,0 +1,195 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""End-to-end benchmark suite of Relax.
+
+It measures, on one target:
+
+- the compile time of the reference models of relax_models.py, in total and per pass,
+- the per-invocation overhead of the VM, on an empty function and on a one-kernel function,
+- the end-to-end latency of the models and the peak bytes held by the allocators of the VM.
+
+The results are written as a flat JSON dict of metrics, all of which are better when lower, so
+that the results of two commits can be diffed by compare_bench_results.py.
+"""
+import argparse
+import json
+import platform
+import time
+
+import numpy as np
+
+import tvm
+from tvm import relax, tir, topi
+from tvm.ir.instrument import pass_instrument
+
+from relax_models import MODELS
+
+
+def _parse_args():
+    args = argparse.ArgumentParser()
+    args.add_argument("--models", type=str, default=",".join(MODELS))
+    args.add_argument("--target", type=str, default="llvm")
+    args.add_argument(
+        "--seq-lens",
+        type=str,
+        default="32,128",
+        help="The values the symbolic dimensions of the models are measured at.",
+    )
+    args.add_argument("--number", type=int, default=10)
+    args.add_argument("--repeat", type=int, default=5)
+    args.add_argument(
+        "--tune-trials",
+        type=int,
+        default=0,
+        help="The MetaSchedule trials of each model, "
+        "needed on the GPU targets where the kernels must be scheduled.",
+    )
+    args.add_argument("--work-dir", type=str, default="relax_bench_tuning")
+    args.add_argument("--output", type=str, default="relax_bench.json")
+    return args.parse_args()
+
+
+@pass_instrument
+class PassTimer:
+    """Accumulate the wall time of each pass by name. The time of a pass includes the time of the
+    passes it runs, e.g. of the passes of a Sequential."""
+
+    def __init__(self):
+        self.seconds = {}
+        self._starts = []
+
+    def run_before_pass(self, mod, info):
+        self._starts.append(time.perf_counter())
+
+    def run_after_pass(self, mod, info):
+        elapsed = time.perf_counter() - self._starts.pop()
+        self.seconds[info.name] = self.seconds.get(info.name, 0.0) + elapsed
+
+
+def compile_model(mod, target, tune_trials, work_dir):
+    """Build the model, returning the executable, the compile time and the time of each pass."""
+    timer = PassTimer()
+    start = time.perf_counter()
+    with target, tvm.transform.PassContext(opt_level=3, instruments=[timer]):
+        if tune_trials > 0:
+            seq = tvm.transform.Sequential(
+                [
+                    relax.transform.MetaScheduleTuneIRMod(
+                        params={}, work_dir=work_dir, max_trials_global=tune_trials
+                    ),
+                    relax.transform.MetaScheduleApplyDatabase(work_dir),
+                ]
+            )
+            mod = seq(mod)
+        ex = relax.vm.build(mod, target)
+    return ex, time.perf_counter() - start, timer.seconds
+
+
+def make_inputs(shapes, bindings, dev):
+    """Create the inputs of the given (shape, dtype), binding the symbolic dimensions by name. The
+    token ids are random and the other inputs zero."""
+    inputs = []
+    for shape, dtype in shapes:
+        shape = [bindings[dim.name] if isinstance(dim, tir.Var) else dim for dim in shape]
+        if dtype == "int32":
+            data = np.random.randint(0, 100, size=shape).astype(dtype)
+        else:
+            data = np.zeros(shape, dtype=dtype)
+        inputs.append(tvm.nd.array(data, dev))
+    return inputs
+
+
+def time_main(vm, dev, inputs, number, repeat):
+    """The BenchmarkResult of main on the inputs, without the lookups of the function."""
+    vm.save_function("main", "main_saved", *inputs, include_return=False)
+    return vm.time_evaluator("main_saved", dev, number=number, repeat=repeat)()
+
+
+def bench_vm_overhead(target, dev, metrics):
+    """Time the invocations of an empty function and of a function of one tiny kernel, where the
+    time is dominated by the VM rather than by the kernels."""
+    for name, kernel in [("empty", None), ("tiny_kernel", topi.add)]:
+        bb = relax.BlockBuilder()
+        x = relax.Var("x", [1], relax.DynTensorType(1, "float32"))
+        with bb.function("main", [x]):
+            out = x if kernel is None else bb.emit_te(kernel, x, x)
+            bb.emit_func_output(out)
+        ex = relax.vm.build(bb.get(), target)
+        vm = relax.VirtualMachine(ex, dev)
+        res = time_main(vm, dev, [tvm.nd.array(np.zeros((1,), "float32"), dev)], 1000, 5)
+        metrics["vm_overhead/%s_us" % name] = res.median * 1e6
+
+
+def bench_model(name, args, target, dev, metrics):
+    """Compile a model and time it at each binding of its symbolic dimensions."""
+    start = time.perf_counter()
+    mod, shapes = MODELS[name](target)
+    metrics["%s/import_s" % name] = time.perf_counter() - start
+    ex, seconds, pass_seconds = compile_model(
+        mod, target, args.tune_trials, "%s/%s" % (args.work_dir, name)
+    )
+    metrics["%s/compile_s" % name] = seconds
+    for pass_name, pass_time in pass_seconds.items():
+        metrics["%s/compile/%s_s" % (name, pass_name)] = pass_time
+
+    sym_vars = []
+    for shape, _ in shapes:
+        for dim in shape:
+            if isinstance(dim, tir.Var) and dim.name not in sym_vars:
+                sym_vars.append(dim.name)
+    seq_lens = [int(value) for value in args.seq_lens.split(",")] if sym_vars else [None]
+    vm = relax.VirtualMachine(ex, dev)
+    for seq_len in seq_lens:
+        inputs = make_inputs(shapes, {var: seq_len for var in sym_vars}, dev)
+        res = time_main(vm, dev, inputs, args.number, args.repeat)
+        suffix = "" if seq_len is None else "/%s=%d" % ("_".join(sym_vars), seq_len)
+        metrics["%s%s/latency_ms" % (name, suffix)] = res.median * 1e3
+    # the allocators keep their high-water mark over all the runs above
+    peak_bytes = sum(stats["peak_bytes_in_use"] for stats in vm.memory_stats().values())
+    metrics["%s/peak_bytes" % name] = peak_bytes
+
+
+def main():
+    args = _parse_args()
+    target = tvm.target.Target(args.target, host="llvm")
+    dev = tvm.device(target.kind.name, 0)
+    metrics = {}
+    bench_vm_overhead(target, dev, metrics)
+    for name in args.models.split(","):
+        if name not in MODELS:
+            raise ValueError("Unknown model %s, expect one of %s" % (name, ", ".join(MODELS)))
+        bench_model(name, args, target, dev, metrics)
+
+    result = {
+        "meta": {
+            "git_commit": tvm.support.libinfo().get("GIT_COMMIT_HASH", "unknown"),
+            "target": str(target),
+            "host": platform.node(),
+            "number": args.number,
+            "repeat": args.repeat,
+            "tune_trials": args.tune_trials,
+        },
+        "metrics": metrics,
+    }
+    with open(args.output, "w") as f:
+        json.dump(result, f, indent=2, sort_keys=True)
+    for key in sorted(metrics):
+        print("%-70s %14.4f" % (key, metrics[key]))
+
+
+if __name__ == "__main__":
+    main()
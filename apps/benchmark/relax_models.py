@@ -0,0 +1,164 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Reference models of the Relax benchmark suite, see relax_bench.py.
+
+Each builder returns the IRModule of the model and the (shape, dtype) of each parameter of its
+main function. A symbolic dimension is given as the tir.Var in the shape, whose values are picked
+by the benchmark.
+"""
+import math
+
+import tvm.relay.testing
+from tvm import relax, relay, te, tir, topi
+from tvm.relax.testing import relay_translator
+
+
+def resnet50(target, batch_size=1):
+    """ResNet-50 of the Relay testing workloads, translated to Relax."""
+    relay_mod, _ = relay.testing.resnet.get_workload(
+        num_layers=50, batch_size=batch_size, dtype="float32"
+    )
+    mod = relay_translator.from_relay(relay_mod["main"], target)
+    shapes = [[int(dim) for dim in param.shape_] for param in mod["main"].params]
+    return mod, [(shape, "float32") for shape in shapes]
+
+
+class _Transformer:
+    """A transformer of pre-norm (decoder) or post-norm (encoder) blocks, built with the emit_te of
+    a BlockBuilder so that the sequence length can be symbolic."""
+
+    def __init__(self, num_layers, hidden, num_heads, ffn, vocab, max_positions, causal):
+        self.num_layers = num_layers
+        self.hidden = hidden
+        self.num_heads = num_heads
+        self.ffn = ffn
+        self.vocab = vocab
+        self.max_positions = max_positions
+        self.causal = causal
+        self.params = []
+
+    def _param(self, name, shape):
+        var = relax.Var(name, shape, relax.DynTensorType(len(shape), "float32"))
+        self.params.append(var)
+        return var
+
+    def _linear(self, bb, x, name, in_features, out_features):
+        weight = self._param(name + "_weight", (out_features, in_features))
+        bias = self._param(name + "_bias", (out_features,))
+        return bb.emit_te(topi.nn.dense, x, weight, bias)
+
+    def _layer_norm(self, bb, x, name):
+        gamma = self._param(name + "_gamma", (self.hidden,))
+        beta = self._param(name + "_beta", (self.hidden,))
+        return bb.emit_te(topi.nn.layer_norm, x, gamma, beta, axis=[-1])
+
+    def _heads(self, bb, x, seq_len):
+        head_dim = self.hidden // self.num_heads
+        x = bb.emit_te(topi.reshape, x, (seq_len, self.num_heads, head_dim))
+        return bb.emit_te(topi.transpose, x, [1, 0, 2])
+
+    def _attention(self, bb, x, name, seq_len):
+        q = self._heads(bb, self._linear(bb, x, name + "_q", self.hidden, self.hidden), seq_len)
+        k = self._heads(bb, self._linear(bb, x, name + "_k", self.hidden, self.hidden), seq_len)
+        v = self._heads(bb, self._linear(bb, x, name + "_v", self.hidden, self.hidden), seq_len)
+        scores = bb.emit_te(topi.nn.batch_matmul, q, k)
+        scale = 1.0 / math.sqrt(self.hidden // self.num_heads)
+        scores = bb.emit_te(topi.multiply, scores, scale)
+        if self.causal:
+            scores = bb.emit_te(_causal_mask, scores)
+        probs = bb.emit_te(topi.nn.softmax, scores, axis=-1)
+        out = bb.emit_te(topi.nn.batch_matmul, probs, v, transpose_b=False)
+        out = bb.emit_te(topi.transpose, out, [1, 0, 2])
+        out = bb.emit_te(topi.reshape, out, (seq_len, self.hidden))
+        return self._linear(bb, out, name + "_out", self.hidden, self.hidden)
+
+    def _mlp(self, bb, x, name):
+        x = self._linear(bb, x, name + "_fc1", self.hidden, self.ffn)
+        x = bb.emit_te(_gelu, x)
+        return self._linear(bb, x, name + "_fc2", self.ffn, self.hidden)
+
+    def build(self, seq_len):
+        """Build the main function taking the token ids of shape (seq_len,) then the params."""
+        bb = relax.BlockBuilder()
+        ids = relax.Var("ids", (seq_len,), relax.DynTensorType(1, "int32"))
+        with bb.function("main"):
+            with bb.dataflow():
+                token_embed = self._param("token_embed", (self.vocab, self.hidden))
+                pos_embed = self._param("pos_embed", (self.max_positions, self.hidden))
+                x = bb.emit_te(topi.take, token_embed, ids, axis=0)
+                x = bb.emit_te(topi.add, x, bb.emit_te(_positions, pos_embed, ids))
+                for i in range(self.num_layers):
+                    name = "layer%d" % i
+                    if self.causal:
+                        h = self._layer_norm(bb, x, name + "_ln1")
+                        h = self._attention(bb, h, name, seq_len)
+                        x = bb.emit_te(topi.add, x, h)
+                        h = self._mlp(bb, self._layer_norm(bb, x, name + "_ln2"), name)
+                        x = bb.emit_te(topi.add, x, h)
+                    else:
+                        h = self._attention(bb, x, name, seq_len)
+                        x = self._layer_norm(bb, bb.emit_te(topi.add, x, h), name + "_ln1")
+                        h = self._mlp(bb, x, name)
+                        x = self._layer_norm(bb, bb.emit_te(topi.add, x, h), name + "_ln2")
+                if self.causal:
+                    x = self._layer_norm(bb, x, "final_ln")
+                    # the LM head shares the weights of the token embedding
+                    x = bb.emit_te(topi.nn.dense, x, token_embed)
+                gv = bb.emit_output(x)
+            bb.emit_func_output(gv, [ids] + self.params)
+        shapes = [([seq_len], "int32")]
+        shapes += [([int(dim) for dim in param.shape_], "float32") for param in self.params]
+        return bb.get(), shapes
+
+
+def _causal_mask(scores):
+    return te.compute(
+        scores.shape,
+        lambda h, i, j: tir.if_then_else(j > i, tir.min_value(scores.dtype), scores[h, i, j]),
+        name="causal_mask",
+    )
+
+
+def _gelu(x):
+    return te.compute(
+        x.shape,
+        lambda *i: 0.5 * x(*i) * (1.0 + tir.erf(x(*i) * tir.const(1 / math.sqrt(2), x.dtype))),
+        name="gelu",
+    )
+
+
+def _positions(pos_embed, ids):
+    return te.compute(
+        (ids.shape[0], pos_embed.shape[1]), lambda i, j: pos_embed[i, j], name="positions"
+    )
+
+
+def bert_base(target, seq_len=128):
+    """The BERT-base encoder, without the pooler, on a static sequence length."""
+    del target
+    model = _Transformer(12, 768, 12, 3072, 30522, 512, causal=False)
+    return model.build(seq_len)
+
+
+def decoder_lm(target):
+    """A small decoder-only language model on a symbolic sequence length "n"."""
+    del target
+    model = _Transformer(6, 512, 8, 2048, 32000, 2048, causal=True)
+    return model.build(tir.Var("n", "int64"))
+
+
+MODELS = {"resnet50": resnet50, "bert_base": bert_base, "decoder_lm": decoder_lm}
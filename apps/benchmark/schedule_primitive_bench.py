@@ -0,0 +1,111 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Compile-time microbenchmarks of the TIR schedule primitives and the iter map detection.
+
+The schedule primitives validate the bindings of the blocks with `DetectIterMap`, so that the
+time of their common patterns guards against compile-time regressions of the arithmetic
+analysis. Run it on two builds and compare the medians, e.g.
+
+    python3 schedule_primitive_bench.py --repeat 200 --output before.json
+"""
+import argparse
+import json
+import timeit
+
+import tvm
+from tvm import te, tir
+from tvm.meta_schedule.testing import te_workload
+
+
+def _matmul() -> tvm.IRModule:
+    return tvm.IRModule({"main": te.create_prim_func(te_workload.matmul(512, 512, 512))})
+
+
+def _conv2d() -> tvm.IRModule:
+    func = te.create_prim_func(te_workload.conv2d_nhwc(1, 56, 56, 64, 64, 3, 1, 1))
+    return tvm.IRModule({"main": func})
+
+
+def bench_split_fuse(mod: tvm.IRModule) -> None:
+    sch = tir.Schedule(mod)
+    i, j, _ = sch.get_loops(sch.get_block("C"))
+    i0, i1 = sch.split(i, factors=[None, 32])
+    j0, j1 = sch.split(j, factors=[None, 32])
+    sch.reorder(i0, j0, i1, j1)
+    sch.fuse(i0, j0)
+
+
+def bench_compute_at(mod: tvm.IRModule) -> None:
+    sch = tir.Schedule(mod)
+    block = sch.get_block("C")
+    cache = sch.cache_write(block, 0, "global")
+    i, j, _ = sch.get_loops(block)
+    i0, i1 = sch.split(i, factors=[None, 32])
+    j0, _ = sch.split(j, factors=[None, 32])
+    sch.reorder(i0, j0, i1)
+    sch.reverse_compute_at(cache, j0)
+
+
+def bench_transform_layout(mod: tvm.IRModule) -> None:
+    sch = tir.Schedule(mod)
+    sch.transform_layout(sch.get_block("C"), ("write", 0), lambda i, j: (i // 16, j, i % 16))
+
+
+def bench_conv2d_tiling(mod: tvm.IRModule) -> None:
+    sch = tir.Schedule(mod)
+    block = sch.get_block("conv2d_nhwc")
+    loops = sch.get_loops(block)
+    sch.split(loops[1], factors=[None, 7])
+    sch.split(loops[2], factors=[None, 8])
+    sch.fuse(*sch.get_loops(block)[:3])
+
+
+def bench_detect_iter_map() -> None:
+    i, j, k = tir.Var("i", "int32"), tir.Var("j", "int32"), tir.Var("k", "int32")
+    dom = {i: tvm.ir.Range(0, 64), j: tvm.ir.Range(0, 32), k: tvm.ir.Range(0, 16)}
+    tvm.arith.detect_iter_map([i, j, k], dom)
+    tvm.arith.detect_iter_map([i * 32 + j, k], dom)
+    tvm.arith.detect_iter_map([(i * 32 + j) // 16, (i * 32 + j) % 16, k], dom)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--repeat", type=int, default=100, help="The runs of each benchmark.")
+    parser.add_argument("--output", type=str, default=None, help="The JSON file of the results.")
+    args = parser.parse_args()
+
+    matmul, conv2d = _matmul(), _conv2d()
+    benchmarks = {
+        "split_fuse": lambda: bench_split_fuse(matmul),
+        "compute_at": lambda: bench_compute_at(matmul),
+        "transform_layout": lambda: bench_transform_layout(matmul),
+        "conv2d_tiling": lambda: bench_conv2d_tiling(conv2d),
+        "detect_iter_map": bench_detect_iter_map,
+    }
+    results = {}
+    for name, func in benchmarks.items():
+        func()  # warm up
+        times = sorted(timeit.repeat(func, number=1, repeat=args.repeat))
+        results[name] = times[len(times) // 2] * 1e3
+        print(f"{name:>20}: {results[name]:.3f} ms")
+    if args.output:
+        with open(args.output, "w") as out_file:
+            json.dump(results, out_file, indent=2)
+
+
+if __name__ == "__main__":
+    main()
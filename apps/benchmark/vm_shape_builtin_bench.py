@@ -0,0 +1,68 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Latency of the shape builtins of the relax VM, called from C++.
+
+The VM calls the builtins, e.g. `vm.builtin.load_shape` of the symbolic shapes, between the
+kernels, so that their allocations and reference counting weigh on the small models. Run
+it on two builds and compare the results, e.g.
+
+    python3 vm_shape_builtin_bench.py --calls 1000000 --output after.json
+"""
+import argparse
+import json
+
+import numpy as np
+
+import tvm
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--calls", type=int, default=1000000, help="The calls of each builtin.")
+    parser.add_argument("--output", type=str, default=None, help="The JSON file of the results.")
+    args = parser.parse_args()
+
+    f_latency = tvm.get_global_func("testing.packed_call_latency")
+    load_shape = tvm.get_global_func("vm.builtin.load_shape")
+    broadcast = tvm.get_global_func("vm.binary_broadcast_shape_infer")
+    heap = tvm.nd.array(np.arange(16, dtype="int64"))
+    benchmarks = {
+        "load_shape_4d": (load_shape, heap, tvm.runtime.ShapeTuple([0, 3, 5, 7])),
+        "load_shape_8d": (load_shape, heap, tvm.runtime.ShapeTuple(list(range(8)))),
+        "broadcast_4d": (
+            broadcast,
+            tvm.runtime.ShapeTuple([8, 1, 64, 64]),
+            tvm.runtime.ShapeTuple([12, 1, 64]),
+        ),
+        "broadcast_8d": (
+            broadcast,
+            tvm.runtime.ShapeTuple([2] * 8),
+            tvm.runtime.ShapeTuple([1] * 8),
+        ),
+    }
+    results = {}
+    for name, (func, *func_args) in benchmarks.items():
+        f_latency(args.calls // 10, func, *func_args)  # warm up
+        results[name] = f_latency(args.calls, func, *func_args)
+        print(f"{name:>16}: {results[name]:.1f} ns/call")
+    if args.output:
+        with open(args.output, "w") as out_file:
+            json.dump(results, out_file, indent=2)
+
+
+if __name__ == "__main__":
+    main()
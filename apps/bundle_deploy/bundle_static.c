@@ -20,6 +20,7 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <tvm/runtime/crt/arena_allocator.h>
 #include <tvm/runtime/crt/crt.h>
 #include <tvm/runtime/crt/graph_executor.h>
 #include <tvm/runtime/crt/packed_func.h>
@@ -31,10 +32,15 @@
 #endif
 #include "bundle.h"
 
+#ifdef TVM_CRT_STATIC_ARENA_SIZE_BYTES
+// Serve all the memory from the arena planned by tvm.micro.plan_static_arena.
+TVM_CRT_DEFINE_STATIC_ARENA(g_crt_memory, TVM_CRT_STATIC_ARENA_SIZE_BYTES);
+#else
 #define CRT_MEMORY_NUM_PAGES 16384
 #define CRT_MEMORY_PAGE_SIZE_LOG2 10
 
 static uint8_t g_crt_memory[CRT_MEMORY_NUM_PAGES * (1 << CRT_MEMORY_PAGE_SIZE_LOG2)];
+#endif
 static MemoryManagerInterface* g_memory_manager;
 
 /*! \brief macro to do C API call */
@@ -64,8 +70,12 @@ TVM_DLL void* tvm_runtime_create(const char* json_data, const char* params_data,
   dev.device_id = device_id;
 
   // get pointers
+#ifdef TVM_CRT_STATIC_ARENA_SIZE_BYTES
+  TVM_CCALL(ArenaMemoryManagerCreate(&g_memory_manager, g_crt_memory, sizeof(g_crt_memory)));
+#else
   TVM_CCALL(PageMemoryManagerCreate(&g_memory_manager, g_crt_memory, sizeof(g_crt_memory),
                                     CRT_MEMORY_PAGE_SIZE_LOG2));
+#endif
   TVM_CCALL(TVMInitializeRuntime());
   TVMPackedFunc pf;
   TVMArgs args = TVMArgs_Create(NULL, NULL, 0);
@@ -78,6 +88,10 @@ TVM_DLL void* tvm_runtime_create(const char* json_data, const char* params_data,
   TVMGraphExecutor* graph_executor = NULL;
   TVM_CCALL(TVMGraphExecutor_Create(json_data, mod_syslib, &dev, &graph_executor));
   TVM_CCALL(TVMGraphExecutor_LoadParams(graph_executor, params.data, params.size));
+#ifdef TVM_CRT_STATIC_ARENA_SIZE_BYTES
+  // Only the workspaces of the operators are allocated from now on.
+  TVM_CCALL(ArenaMemoryManager_Seal(g_memory_manager));
+#endif
 
   return graph_executor;
 }
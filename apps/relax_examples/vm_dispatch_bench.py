@@ -0,0 +1,69 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+# Microbenchmark of the Relax VM instruction dispatch loop.
+#
+# The benchmarked function is a long chain of calls to a no-op packed function,
+# so the measured time is dominated by the interpreter overhead between calls.
+
+import argparse
+
+import numpy as np
+
+import tvm
+from tvm import relax
+
+
+@tvm.register_func("bench.vm.noop")
+def noop(x):
+    return x
+
+
+def _parse_args():
+    args = argparse.ArgumentParser()
+    args.add_argument("--num-instrs", type=int, default=1000)
+    args.add_argument("--number", type=int, default=100)
+    args.add_argument("--repeat", type=int, default=5)
+    return args.parse_args()
+
+
+def build_chain(num_instrs):
+    ib = relax.ExecBuilder()
+    with ib.function("main", num_inputs=1):
+        ib.emit_call("bench.vm.noop", args=[ib.r(0)], dst=ib.r(1))
+        for i in range(1, num_instrs):
+            ib.emit_call("bench.vm.noop", args=[ib.r(i)], dst=ib.r(i + 1))
+        ib.emit_ret(ib.r(num_instrs))
+    return ib.get()
+
+
+def main():
+    args = _parse_args()
+    ex = build_chain(args.num_instrs)
+    inp = tvm.nd.array(np.zeros((1,), dtype="float32"))
+    for dispatch_mode in ["switch", "threaded"]:
+        vm = relax.VirtualMachine(ex, tvm.cpu(), dispatch_mode=dispatch_mode)
+        vm.save_function("main", "main_saved", inp, include_return=False)
+        res = vm.time_evaluator("main_saved", tvm.cpu(), number=args.number, repeat=args.repeat)()
+        print(
+            "%-8s dispatch: %.2f ns/instr (mean over %d instructions)"
+            % (dispatch_mode, res.mean * 1e9 / args.num_instrs, args.num_instrs)
+        )
+
+
+if __name__ == "__main__":
+    main()
@@ -92,6 +92,9 @@ set(USE_KHRONOS_SPIRV OFF)
 # whether enable SPIRV_KHR_DOT_PRODUCT
 set(USE_SPIRV_KHR_INTEGER_DOT_PRODUCT OFF)
 
+# whether enable SPIRV_KHR_COOPERATIVE_MATRIX, needs the SPIR-V headers of Vulkan SDK 1.3.255+
+set(USE_SPIRV_KHR_COOPERATIVE_MATRIX OFF)
+
 # Whether enable OpenGL runtime
 set(USE_OPENGL OFF)
 
@@ -122,6 +125,10 @@ set(USE_PIPELINE_EXECUTOR OFF)
 # Whether to enable the profiler for the graph executor and vm
 set(USE_PROFILER ON)
 
+# Whether to build the tracing hooks of the runtime, recording the spans of the VM calls, the
+# kernel launches, the allocations and the copies after tvm.runtime.profiling.start_trace
+set(USE_RUNTIME_TRACE ON)
+
 # Whether enable microTVM standalone runtime
 set(USE_MICRO_STANDALONE_RUNTIME OFF)
 
@@ -222,6 +229,10 @@ set(USE_ROCBLAS OFF)
 # Whether use contrib sort
 set(USE_SORT ON)
 
+# Whether to build the runtime configuring the x86 AMX tiles, needed by the kernels
+# tensorized with the AMX intrinsics
+set(USE_AMX OFF)
+
 # Whether to use Arm Compute Library (ACL) codegen
 # We provide 2 separate flags since we cannot build the ACL runtime on x86.
 # This is useful for cases where you want to cross-compile a relay graph
@@ -299,6 +310,13 @@ set(USE_THRUST OFF)
 # Whether use cuRAND
 set(USE_CURAND OFF)
 
+# Whether use NCCL, for the collectives of the Relax VM on CUDA devices
+# Possible values:
+# - ON: enable NCCL with cmake's auto search
+# - OFF: disable NCCL
+# - /path/to/nccl: use specific path to NCCL
+set(USE_NCCL OFF)
+
 # Whether to build the TensorFlow TVMDSOOp module
 set(USE_TF_TVMDSOOP OFF)
 
@@ -387,6 +405,10 @@ set(USE_PAPI OFF)
 # predefined variables to specify the path to the GTest package if needed.
 set(USE_GTEST AUTO)
 
+# Whether to build the C++ microbenchmarks of tests/cpp_bench with Google Benchmark, as the
+# `cppbench` target. Google Benchmark is found with `find_package(benchmark)`.
+set(USE_GBENCH OFF)
+
 # Enable using CUTLASS as a BYOC backend
 # Need to have USE_CUDA=ON
 set(USE_CUTLASS OFF)
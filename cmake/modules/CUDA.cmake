@@ -31,6 +31,8 @@ if(USE_CUDA)
   message(STATUS "Build with CUDA ${CUDA_VERSION} support")
   tvm_file_glob(GLOB RUNTIME_CUDA_SRCS src/runtime/cuda/*.cc)
   list(APPEND RUNTIME_SRCS ${RUNTIME_CUDA_SRCS})
+  tvm_file_glob(GLOB RUNTIME_RELAX_VM_CUDA_SRCS src/runtime/relax_vm/cuda/*.cc)
+  list(APPEND RUNTIME_SRCS ${RUNTIME_RELAX_VM_CUDA_SRCS})
   list(APPEND COMPILER_SRCS src/target/opt/build_cuda_on.cc)
 
   list(APPEND TVM_LINKER_LIBS ${CUDA_NVRTC_LIBRARY})
@@ -52,6 +54,8 @@ if(USE_CUDA)
     message(STATUS "Build with cuBLAS support")
     tvm_file_glob(GLOB CUBLAS_RELAY_CONTRIB_SRC src/relay/backend/contrib/cublas/*.cc)
     list(APPEND COMPILER_SRCS ${CUBLAS_RELAY_CONTRIB_SRC})
+    tvm_file_glob(GLOB CUBLAS_RELAX_CONTRIB_SRC src/relax/backend/contrib/cublas/*.cc)
+    list(APPEND COMPILER_SRCS ${CUBLAS_RELAX_CONTRIB_SRC})
     tvm_file_glob(GLOB CONTRIB_CUBLAS_SRCS src/runtime/contrib/cublas/*.cc)
     list(APPEND RUNTIME_SRCS ${CONTRIB_CUBLAS_SRCS})
     list(APPEND TVM_RUNTIME_LINKER_LIBS ${CUDA_CUBLAS_LIBRARY})
@@ -81,6 +85,24 @@ if(USE_CUDA)
     list(APPEND RUNTIME_SRCS ${CONTRIB_CURAND_SRC_CU})
   endif(USE_CURAND)
 
+  if(USE_NCCL)
+    if(IS_DIRECTORY ${USE_NCCL})
+      find_path(NCCL_INCLUDE_DIR nccl.h HINTS ${USE_NCCL}/include NO_DEFAULT_PATH)
+      find_library(NCCL_LIBRARY nccl HINTS ${USE_NCCL}/lib ${USE_NCCL}/lib64 NO_DEFAULT_PATH)
+    else()
+      find_path(NCCL_INCLUDE_DIR nccl.h HINTS ${CUDA_TOOLKIT_ROOT_DIR}/include)
+      find_library(NCCL_LIBRARY nccl HINTS ${CUDA_TOOLKIT_ROOT_DIR}/lib64)
+    endif()
+    if(NOT NCCL_INCLUDE_DIR OR NOT NCCL_LIBRARY)
+      message(FATAL_ERROR "Cannot find NCCL, USE_NCCL=" ${USE_NCCL})
+    endif()
+    message(STATUS "Build with NCCL support: ${NCCL_LIBRARY}")
+    include_directories(SYSTEM ${NCCL_INCLUDE_DIR})
+    tvm_file_glob(GLOB RUNTIME_RELAX_VM_NCCL_SRCS src/runtime/relax_vm/nccl/*.cc)
+    list(APPEND RUNTIME_SRCS ${RUNTIME_RELAX_VM_NCCL_SRCS})
+    list(APPEND TVM_RUNTIME_LINKER_LIBS ${NCCL_LIBRARY})
+  endif(USE_NCCL)
+
   if(USE_GRAPH_EXECUTOR_CUDA_GRAPH)
     if(NOT USE_GRAPH_EXECUTOR)
       message(FATAL_ERROR "CUDA Graph is only supported by graph executor, please set USE_GRAPH_EXECUTOR=ON")
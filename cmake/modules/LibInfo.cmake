@@ -51,6 +51,7 @@ function(add_lib_info src_file)
     TVM_INFO_ROCM_PATH="${ROCM_PATH}"
     TVM_INFO_SUMMARIZE="${SUMMARIZE}"
     TVM_INFO_USE_ALTERNATIVE_LINKER="${USE_ALTERNATIVE_LINKER}"
+    TVM_INFO_USE_AMX="${USE_AMX}"
     TVM_INFO_USE_AOT_EXECUTOR="${USE_AOT_EXECUTOR}"
     TVM_INFO_USE_ARM_COMPUTE_LIB_GRAPH_EXECUTOR="${USE_ARM_COMPUTE_LIB_GRAPH_EXECUTOR}"
     TVM_INFO_USE_ARM_COMPUTE_LIB="${USE_ARM_COMPUTE_LIB}"
@@ -99,8 +100,10 @@ function(add_lib_info src_file)
     TVM_INFO_USE_ROCM="${USE_ROCM}"
     TVM_INFO_USE_RPC="${USE_RPC}"
     TVM_INFO_USE_RTTI="${USE_RTTI}"
+    TVM_INFO_USE_RUNTIME_TRACE="${USE_RUNTIME_TRACE}"
     TVM_INFO_USE_RUST_EXT="${USE_RUST_EXT}"
     TVM_INFO_USE_SORT="${USE_SORT}"
+    TVM_INFO_USE_SPIRV_KHR_COOPERATIVE_MATRIX="${USE_SPIRV_KHR_COOPERATIVE_MATRIX}"
     TVM_INFO_USE_SPIRV_KHR_INTEGER_DOT_PRODUCT="${USE_SPIRV_KHR_INTEGER_DOT_PRODUCT}"
     TVM_INFO_USE_STACKVM_RUNTIME="${USE_STACKVM_RUNTIME}"
     TVM_INFO_USE_TARGET_ONNX="${USE_TARGET_ONNX}"
@@ -112,6 +115,7 @@ function(add_lib_info src_file)
     TVM_INFO_USE_THREADS="${USE_THREADS}"
     TVM_INFO_USE_THRUST="${USE_THRUST}"
     TVM_INFO_USE_CURAND="${USE_CURAND}"
+    TVM_INFO_USE_NCCL="${USE_NCCL}"
     TVM_INFO_USE_VITIS_AI="${USE_VITIS_AI}"
     TVM_INFO_USE_VULKAN="${USE_VULKAN}"
     TVM_INFO_USE_CLML="${USE_CLML}"
@@ -528,6 +528,16 @@ class IntSetAnalyzer {
   Impl* impl_;
 };
 
+/*! \brief The statistics of the cache of Analyzer::Simplify. */
+struct SimplifyCacheStats {
+  /*! \brief The number of expressions found in the cache. */
+  int64_t num_hits = 0;
+  /*! \brief The number of expressions simplified and added to the cache. */
+  int64_t num_misses = 0;
+  /*! \brief The number of times the cached results are dropped by a change of the state. */
+  int64_t num_invalidations = 0;
+};
+
 /*!
  * \brief Analyzer that contains bunch of sub-analyzers.
  *
@@ -559,6 +569,8 @@ class TVM_DLL Analyzer {
   TransitiveComparisonAnalyzer transitive_comparisons;
   /*! \brief constructor */
   Analyzer();
+  /*! \brief destructor */
+  ~Analyzer();
   /*!
    * \brief Notify all the sub-analyzers that var
    *        is created and binded to expr.
@@ -653,6 +665,32 @@ class TVM_DLL Analyzer {
    * \note Analyzer will call into sub-analyzers to get the result.
    */
   PrimExpr Simplify(const PrimExpr& expr, int steps = 2);
+  /*!
+   * \brief Enable the memoization of Simplify, keyed by the structural equality of the
+   *        expressions, for the users simplifying the same expressions many times.
+   *
+   *  The cache only holds the results found under the current bindings and constraints.
+   *  Binding a var drops them. A constraint scope starts with an empty cache, and restores the
+   *  enclosing one on exit unless a var is bound within the scope.
+   *
+   * \param enable Whether to enable the cache. Disabling it drops the cached results.
+   *
+   * \note The updates made directly through the sub-analyzers are not tracked, and need a call
+   *       to ClearSimplifyCache.
+   */
+  void EnableSimplifyCache(bool enable = true);
+  /*! \brief Drop the cached results of Simplify, if the cache is enabled. */
+  void ClearSimplifyCache();
+  /*! \return The statistics of the cache of Simplify since it is enabled. */
+  SimplifyCacheStats GetSimplifyCacheStats() const;
+
+ private:
+  friend class ConstraintContext;
+  class SimplifyCache;
+  /*! \brief Simplify without looking up the cache. */
+  PrimExpr SimplifyUncached(const PrimExpr& expr, int steps);
+  /*! \brief The cache of Simplify, nullptr if it is disabled. */
+  std::shared_ptr<SimplifyCache> simplify_cache_;
 };
 
 }  // namespace arith
@@ -128,6 +128,13 @@ class PythonBasedModelNode : public CostModelNode {
   PackedFunc predict_func;
   /*! \brief Pointer to the predict function in python */
   PackedFunc predict_stage_func;
+  /*!
+   * \brief Pointer to the batched predict function in python, taking the features extracted
+   * by GetPerStoreFeaturesFromStatesFlatten. Used by Predict instead of predict_func if defined.
+   */
+  PackedFunc predict_features_func;
+  /*! \brief The maximum number of extracted buffers for one statement of the features */
+  int max_n_bufs;
 
   void Update(const Array<MeasureInput>& inputs, const Array<MeasureResult>& results) final;
 
@@ -153,8 +160,12 @@ class PythonBasedModel : public CostModel {
    * \param update_func The pointer to the update function defined in python
    * \param predict_func The pointer to the prediction function defined in python
    * \param predict_stage_func The pointer to the prediction function defined in python
+   * \param predict_features_func The pointer to the batched prediction function defined in
+   * python, or nullptr
+   * \param max_n_bufs The maximum number of extracted buffers for one statement of the features
    */
-  PythonBasedModel(PackedFunc update_func, PackedFunc predict_func, PackedFunc predict_stage_func);
+  PythonBasedModel(PackedFunc update_func, PackedFunc predict_func, PackedFunc predict_stage_func,
+                   PackedFunc predict_features_func = nullptr, int max_n_bufs = 5);
 
   TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(PythonBasedModel, CostModel, PythonBasedModelNode);
 };
@@ -33,6 +33,7 @@
 
 #include <tvm/auto_scheduler/compute_dag.h>
 #include <tvm/auto_scheduler/measure.h>
+#include <tvm/runtime/ndarray.h>
 #include <tvm/tir/function.h>
 
 #include <string>
@@ -85,6 +86,21 @@ void GetPerStoreFeaturesFromStates(const Array<State>& states, const std::vector
                                    int skip_first_n_feature_extraction, int max_n_bufs,
                                    std::vector<std::vector<float>>* features);
 
+/*!
+ * \brief Get per-store feature from states of the same task, flattened into one buffer for
+ * the cost models to predict in one batch.
+ * \param states The input states
+ * \param task The same search task for all states
+ * \param max_n_bufs The maximum number of extracted buffers for one statement
+ * \param features The returned float32 features of shape (num_rows, feature_len), with one row
+ * per BufferStoreNode statement of the states, the rows of a state being contiguous
+ * \param row_offsets The returned int64 offsets of shape (num_states + 1,), the rows of state i
+ * being [row_offsets[i], row_offsets[i + 1]). The states that failed to be lowered have no rows.
+ */
+void GetPerStoreFeaturesFromStatesFlatten(const Array<State>& states, const SearchTask& task,
+                                          int max_n_bufs, runtime::NDArray* features,
+                                          runtime::NDArray* row_offsets);
+
 /*!
  * \brief Get per-store features from a log file
  * \param filename The name of log file
@@ -290,6 +290,20 @@ class PassContext : public ObjectRef {
   friend class With<PassContext>;
 };
 
+/*!
+ * \brief Make a pass context current on a worker thread of its scope, e.g. a thread applying a
+ *  pass to the functions of a module in parallel. Unlike With<PassContext>, the instruments are
+ *  not called again, as the calling thread has already entered the pass context.
+ */
+class PassContextThreadScope {
+ public:
+  TVM_DLL explicit PassContextThreadScope(PassContext pass_ctx);
+  TVM_DLL ~PassContextThreadScope();
+
+ private:
+  PassContext pass_ctx_;
+};
+
 #define TVM_PASS_CTX_CONFIG_VAR_DEF static TVM_ATTRIBUTE_UNUSED uint32_t __make_PassContext_tid
 
 /*!
@@ -199,6 +199,16 @@ class DatabaseNode : public runtime::Object {
    * \return An Array of all the tuning records in the database.
    */
   virtual Array<TuningRecord> GetAllTuningRecords() = 0;
+  /*!
+   * \brief Get the top K tuning records of the workloads structurally equal to the given one
+   * modulo their integer constants, e.g. the same operator on other shapes, to transfer their
+   * traces to the given workload.
+   * \param mod The IRModule to be searched for.
+   * \param top_k The number of records to be returned.
+   * \return The records ordered by their rank within their workloads first, and then by how close
+   * the constants of their workloads are to the ones of `mod`. The records of `mod` are excluded.
+   */
+  virtual Array<TuningRecord> GetTopKNearest(const IRModule& mod, int top_k);
   /*!
    * \brief Get the size of the database.
    * \return The size of the database.
@@ -421,9 +431,21 @@ class Database : public runtime::ObjectRef {
    * \param path_workload The path to the workload table.
    * \param path_tuning_record The path to the database table.
    * \param allow_missing Whether to create new file when the given path is not found.
+   * \param concurrent Whether the tables are shared with other processes committing to them.
    */
   TVM_DLL static Database JSONDatabase(String path_workload, String path_tuning_record,
-                                       bool allow_missing);
+                                       bool allow_missing, bool concurrent);
+  /*!
+   * \brief Create a database that keeps the tuning records on disk and only an index of them in
+   * memory, reading the records lazily on query. The tuning record table has the same format as
+   * the one of JSONDatabase, and the records missing from the index are indexed on creation.
+   * \param path_workload The path to the workload table.
+   * \param path_tuning_record The path to the database table.
+   * \param path_index The path to the index of the database table.
+   * \param allow_missing Whether to create new file when the given path is not found.
+   */
+  TVM_DLL static Database IndexedDatabase(String path_workload, String path_tuning_record,
+                                          String path_index, bool allow_missing);
   /*!
    * \brief A database composed of multiple databases, allowing users to guide IR rewriting using
    * combined knowledge of those databases. To each query, it returns the best record among all the
@@ -28,6 +28,8 @@
 #include <tvm/runtime/object.h>
 #include <tvm/runtime/packed_func.h>
 
+#include <vector>
+
 namespace tvm {
 namespace meta_schedule {
 
@@ -49,6 +51,19 @@ class FeatureExtractorNode : public runtime::Object {
    */
   virtual Array<tvm::runtime::NDArray> ExtractFrom(const TuneContext& context,
                                                    const Array<MeasureCandidate>& candidates) = 0;
+  /*!
+   * \brief Extract the features of a batch of measure candidates into one contiguous buffer.
+   * \param context The tuning context for feature extraction.
+   * \param candidates The measure candidates to extract features from.
+   * \param row_offsets The offsets of the rows of each candidate in the buffer, with the number
+   * of rows appended at the end, i.e. the features of candidate i are the rows in
+   * [row_offsets[i], row_offsets[i + 1]).
+   * \return The float32 feature ndarray of shape (num_rows, feature_vector_length).
+   * \note The default implementation concatenates the results of ExtractFrom.
+   */
+  virtual tvm::runtime::NDArray ExtractBatch(const TuneContext& context,
+                                             const Array<MeasureCandidate>& candidates,
+                                             std::vector<int64_t>* row_offsets);
 
   static constexpr const char* _type_key = "meta_schedule.FeatureExtractor";
   TVM_DECLARE_BASE_OBJECT_INFO(FeatureExtractorNode, Object);
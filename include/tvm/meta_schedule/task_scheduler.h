@@ -32,6 +32,7 @@
 #include <tvm/support/random_engine.h>
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace tvm {
@@ -139,6 +140,38 @@ class TaskSchedulerNode : public runtime::Object {
   Optional<CostModel> cost_model_;
   /*! \brief The number of remaining tasks to be tuned. */
   int remaining_tasks_;
+  /*!
+   * \brief The number of candidates built and sent to the runner at a time, so that the runner
+   * measures a chunk while the next one is built. 0 builds each batch as a whole.
+   */
+  int pipeline_chunk_size = 0;
+  /*!
+   * \brief The maximum number of candidates sent to the runner but not measured yet, over which
+   * building the next chunk waits for the runner. 0 means no limit.
+   */
+  int max_unmeasured_candidates = 0;
+  /*!
+   * \brief The path to the persistent measure cache, which maps the scheduled modules measured
+   * in this or previous sessions to their run time, so that they are neither rebuilt nor
+   * remeasured. Empty if the cache is disabled.
+   */
+  String measure_cache_path;
+  /*! \brief The run time of the measured candidates, keyed by their module hash and target */
+  std::unordered_map<std::string, Array<FloatImm>> measure_cache_;
+  /*! \brief The wall-clock budget of tuning in seconds. 0 means no limit. */
+  double max_tuning_time_sec = 0.0;
+  /*!
+   * \brief The number of the latest trials of a task over which its best latency is checked for
+   * convergence. 0 disables the convergence-based stopping.
+   */
+  int convergence_window = 0;
+  /*!
+   * \brief The relative improvement of the best latency over the convergence window, at or below
+   * which a task is considered converged and stops, leaving its trials to the other tasks.
+   */
+  double convergence_threshold = 0.0;
+  /*! \brief The path to append the stopping decisions to. Empty if they are not recorded. */
+  String stopping_log_path;
 
   /*! \brief The default destructor. */
   virtual ~TaskSchedulerNode() = default;
@@ -150,6 +183,14 @@ class TaskSchedulerNode : public runtime::Object {
     v->Visit("database_", &database_);
     v->Visit("cost_model_", &cost_model_);
     v->Visit("remaining_tasks_", &remaining_tasks_);
+    v->Visit("pipeline_chunk_size", &pipeline_chunk_size);
+    v->Visit("max_unmeasured_candidates", &max_unmeasured_candidates);
+    v->Visit("measure_cache_path", &measure_cache_path);
+    // `measure_cache_` is not visited
+    v->Visit("max_tuning_time_sec", &max_tuning_time_sec);
+    v->Visit("convergence_window", &convergence_window);
+    v->Visit("convergence_threshold", &convergence_threshold);
+    v->Visit("stopping_log_path", &stopping_log_path);
   }
 
   /*!
@@ -198,6 +239,37 @@ class TaskSchedulerNode : public runtime::Object {
   void TouchTask(int task_id);
   /*! \brief Returns a human-readable string of the tuning statistics. */
   std::string TuningStatistics() const;
+  /*!
+   * \brief Build and measure the candidates of a task chunk by chunk, overlapping the build of a
+   * chunk with the measurement of the previous ones.
+   * \param task_id The id of the task whose measure candidates are sent.
+   * \param builder The MetaSchedule builder
+   * \param runner The MetaSchedule runner
+   */
+  void SendToPipeline(int task_id, const Builder& builder, const Runner& runner);
+  /*!
+   * \brief Wait until at most the given number of candidates are sent to the runner but not
+   * measured yet.
+   * \param num_unmeasured The maximum number of unmeasured candidates.
+   * \param pending The futures sent to the runner which are not recorded in any task yet.
+   */
+  void WaitForRunner(int num_unmeasured, const Array<RunnerFuture>& pending) const;
+  /*!
+   * \brief Load the measure cache from the given path, and append the later measurements to it.
+   * \param path The path to the measure cache. Empty to disable the cache.
+   */
+  void SetMeasureCache(const String& path);
+  /*!
+   * \brief Log a decision that stops one or all of the tasks, and append it to the stopping log.
+   * \param task_id The id of the stopped task, or -1 if all the remaining tasks are stopped.
+   * \param reason The reason of the decision.
+   * \param elapsed_sec The wall-clock time spent in tuning so far.
+   */
+  void LogStopping(int task_id, const String& reason, double elapsed_sec);
+  /*! \brief The measure cache, or nullptr if it is disabled. */
+  const std::unordered_map<std::string, Array<FloatImm>>* GetMeasureCache() const {
+    return measure_cache_path.empty() ? nullptr : &measure_cache_;
+  }
 
   static constexpr const char* _type_key = "meta_schedule.TaskScheduler";
   TVM_DECLARE_BASE_OBJECT_INFO(TaskSchedulerNode, Object);
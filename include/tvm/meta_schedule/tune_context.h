@@ -113,6 +113,14 @@ class TuneContext : public runtime::ObjectRef {
   TVM_DEFINE_MUTABLE_NOTNULLABLE_OBJECT_REF_METHODS(TuneContext, ObjectRef, TuneContextNode);
 };
 
+/*!
+ * \brief Normalize a PrimFunc or an IRModule into the IRModule of a tuning task, whose only
+ * function is named "main". It is the same as `tvm.meta_schedule.normalize_mod` in python.
+ * \param mod The PrimFunc or the IRModule with a single function.
+ * \return The normalized IRModule.
+ */
+TVM_DLL IRModule NormalizeMod(const ObjectRef& mod);
+
 }  // namespace meta_schedule
 }  // namespace tvm
 
@@ -47,5 +47,23 @@ TVM_DLL std::string SaveJSON(const runtime::ObjectRef& node);
  */
 TVM_DLL runtime::ObjectRef LoadJSON(std::string json_str);
 
+/*!
+ * \brief save the node as well as all the node it depends on in a compact binary format.
+ *  It is faster to save and load than json for large IR, such as the IRModules
+ *  with many bindings or constants. The payload of the NDArrays are stored as raw bytes,
+ *  aligned at the end of the blob.
+ *
+ * \return The binary blob of the node.
+ */
+TVM_DLL std::string SaveBinary(const runtime::ObjectRef& node);
+
+/*!
+ * \brief Load tvm Node object from the blob created by SaveBinary.
+ * \param blob The binary blob to load from.
+ *
+ * \return The loaded node.
+ */
+TVM_DLL runtime::ObjectRef LoadBinary(const std::string& blob);
+
 }  // namespace tvm
 #endif  // TVM_NODE_SERIALIZATION_H_
@@ -28,6 +28,7 @@
 #include <tvm/runtime/ndarray.h>
 
 #include <functional>
+#include <memory>
 #include <string>
 
 namespace tvm {
@@ -84,6 +85,42 @@ class StructuralHash : public BaseValueHash {
   TVM_DLL size_t operator()(const ObjectRef& key) const;
 };
 
+/*!
+ * \brief Structural hashing memoized on the nodes hashed, for the containers deduplicating the
+ *  same large IR nodes over and over, such as the PrimFuncs deduplicated along a pass.
+ *
+ *  The hashes are kept in a cache keyed by the node, owned by the hasher and the copies of it,
+ *  e.g. the ones of an unordered_map, so that it is released with the container. The cache holds
+ *  a reference to each node it knows until then.
+ *
+ * \note The keys must not be mutated once hashed, thus IRModules, which are updated in place,
+ *  and the expressions whose type is deduced later by const_cast must not be hashed with this
+ *  class.
+ */
+class CachedStructuralHash : public StructuralHash {
+ public:
+  TVM_DLL CachedStructuralHash();
+  using StructuralHash::operator();
+  /*!
+   * \brief Compute the structural hash of an object, or get it from the cache.
+   * \param key The object to be hashed.
+   * \return The hash value.
+   */
+  TVM_DLL size_t operator()(const ObjectRef& key) const;
+  /*!
+   * \brief Get the cached structural hash of an object.
+   * \param key The object to be looked up.
+   * \param hashed_value The cached hash value, set when the object is in the cache.
+   * \return Whether the object is in the cache.
+   */
+  TVM_DLL bool Lookup(const ObjectRef& key, size_t* hashed_value) const;
+
+ private:
+  class Cache;
+  /*! \brief The cache, shared by the copies of the hasher. */
+  std::shared_ptr<Cache> cache_;
+};
+
 /*!
  * \brief A Reducer class to reduce the structural hash value.
  *
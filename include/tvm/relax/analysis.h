@@ -30,20 +30,52 @@
 #include <tvm/relay/op_attr_types.h>
 #include <tvm/tir/function.h>
 
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace tvm {
 namespace relax {
 
+/*!
+ * \brief The cache of WellFormed, remembering the well formed functions of the last IRModule
+ *  checked with it, so that only the functions changed since then are checked again.
+ */
+class WellFormedCacheNode : public Object {
+ public:
+  /*! \brief The well formed functions, with the GlobalVars they refer to. */
+  std::unordered_map<Function, Array<GlobalVar>, ObjectPtrHash, ObjectPtrEqual> checked;
+
+  void VisitAttrs(AttrVisitor* v) {}
+
+  static constexpr const char* _type_key = "relax.analysis.WellFormedCache";
+  TVM_DECLARE_FINAL_OBJECT_INFO(WellFormedCacheNode, Object);
+};
+
+/*!
+ * \brief Managed reference to WellFormedCacheNode.
+ * \sa WellFormedCacheNode
+ */
+class WellFormedCache : public ObjectRef {
+ public:
+  /*! \brief Create an empty cache, the default constructor creates a null reference. */
+  TVM_DLL static WellFormedCache Create();
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(WellFormedCache, ObjectRef, WellFormedCacheNode);
+};
+
 /*!
  * \brief Check if the IRModule is well formed.
  *
  * \param m the IRModule to check.
  * \param diag_ctx the diagnostic context.
+ * \param cache The cache of the functions found well formed by the previous checks. A function
+ *  is not checked again if it is the same object as a cached one and the GlobalVars it refers to
+ *  are still defined. The cache is updated to the well formed functions of m.
  * \return true if the IRModule is well formed, false if not.
  */
 TVM_DLL bool WellFormed(const IRModule& m,
-                        Optional<DiagnosticContext> diag_ctx = Optional<DiagnosticContext>());
+                        Optional<DiagnosticContext> diag_ctx = Optional<DiagnosticContext>(),
+                        Optional<WellFormedCache> cache = NullOpt);
 
 /*!
  * \brief Annotate Op Pattern Kind for PrimFunc, which is used in relax FuseOps.
@@ -170,6 +202,135 @@ TVM_DLL Map<Var, Array<Var>> DataflowBlockUseDef(const DataflowBlock& dfb);
  */
 std::pair<Map<Var, Array<Var>>, Array<Var>> FunctionUseDef(const Function& fn);
 
+/*!
+ * \brief The liveness of the vars of a function, over the sequence of the bindings of the top-level
+ * SeqExpr of its body, all blocks together.
+ *
+ * The vars are indexed densely, the params first and then the binding vars in order. Positions are
+ * the indices of the bindings in the sequence, and the position of the bindings count is the body
+ * of the SeqExpr. The uses in nested expressions, e.g. the branches of an If, are the uses of the
+ * binding containing them. All the queries take constant time.
+ */
+class LivenessAnalysis {
+ public:
+  /*!
+   * \brief Analyze a function, in time linear to its size.
+   * \param fn The function to be analyzed.
+   */
+  TVM_DLL explicit LivenessAnalysis(const Function& fn);
+
+  /*! \return The number of the vars. */
+  int num_vars() const { return static_cast<int>(vars_.size()); }
+  /*! \return The number of the bindings, which is the position of the body. */
+  int num_bindings() const { return static_cast<int>(bindings_.size()); }
+  /*! \return The var of an index. */
+  const VarNode* var(int index) const { return vars_[index]; }
+  /*! \return The binding at a position. */
+  const Binding& binding(int pos) const { return bindings_[pos]; }
+  /*! \return The index of a var, or -1 if it is neither a param nor bound in the sequence. */
+  int GetIndex(const VarNode* var) const {
+    auto it = var2index_.find(var);
+    return it == var2index_.end() ? -1 : it->second;
+  }
+  /*! \return The position of the binding of a var, or -1 for the params. */
+  int def_pos(int index) const { return def_pos_[index]; }
+  /*! \return The position of the last use of a var, or -1 if it is unused. */
+  int last_use(int index) const { return last_use_[index]; }
+  /*! \return Whether a var is used by the body, i.e. lives until the end of the function. */
+  bool IsOutput(int index) const { return last_use_[index] == num_bindings(); }
+  /*! \return Whether a var is still used after a position. */
+  bool IsLiveAfter(int index, int pos) const { return last_use_[index] > pos; }
+  /*! \return The positions using a var, in increasing order and without duplicates. */
+  const std::vector<int>& uses(int index) const { return uses_[index]; }
+  /*! \return The indices of the vars whose last use is at a position. */
+  const std::vector<int>& killed_at(int pos) const { return killed_at_[pos]; }
+
+ private:
+  std::vector<const VarNode*> vars_;
+  std::vector<Binding> bindings_;
+  std::unordered_map<const VarNode*, int> var2index_;
+  std::vector<int> def_pos_;
+  std::vector<int> last_use_;
+  std::vector<std::vector<int>> uses_;
+  std::vector<std::vector<int>> killed_at_;
+};
+
+/*!
+ * \brief Find the call_tir bindings that can write their output into one of their inputs.
+ *
+ * An input qualifies when it is a tensor freshly produced by another call_tir, it dies at the
+ * call, it has the shape and dtype of the output, and the PrimFunc reads each of its elements
+ * only to compute the output element at the same index.
+ *
+ * \param mod The module containing the PrimFuncs.
+ * \param fn The function to be analyzed.
+ * \return A map from the call_tir binding vars to the index of the input to write into.
+ */
+TVM_DLL Map<Var, Integer> CallTIRInplaceInputs(const IRModule& mod, const Function& fn);
+
+/*!
+ * \brief The resources a function needs to run, estimated at compile time.
+ * \sa EstimateFootprint
+ */
+class FootprintNode : public Object {
+ public:
+  /*! \brief The peak bytes allocated by the function and its callees, over the allocations of
+   * bounded size. */
+  int64_t peak_bytes = 0;
+  /*! \brief The bytes of the constants of the function and its callees, by their device. */
+  Map<String, Integer> constant_bytes;
+  /*! \brief The operations of the kernels, over the kernels whose loops are of static extents. */
+  double flops = 0;
+  /*! \brief The number of kernel launches, the calls to the PrimFuncs. */
+  int64_t num_kernel_launches = 0;
+  /*! \brief The number of calls to packed functions, the builtins of the VM included. */
+  int64_t num_packed_calls = 0;
+  /*! \brief The number of allocations of unbounded size, which are not in peak_bytes. */
+  int64_t num_unbounded_allocs = 0;
+  /*! \brief The number of kernel launches whose operations are not in flops. */
+  int64_t num_unestimated_kernels = 0;
+
+  void VisitAttrs(AttrVisitor* v) {
+    v->Visit("peak_bytes", &peak_bytes);
+    v->Visit("constant_bytes", &constant_bytes);
+    v->Visit("flops", &flops);
+    v->Visit("num_kernel_launches", &num_kernel_launches);
+    v->Visit("num_packed_calls", &num_packed_calls);
+    v->Visit("num_unbounded_allocs", &num_unbounded_allocs);
+    v->Visit("num_unestimated_kernels", &num_unestimated_kernels);
+  }
+
+  static constexpr const char* _type_key = "relax.analysis.Footprint";
+  TVM_DECLARE_FINAL_OBJECT_INFO(FootprintNode, Object);
+};
+
+/*!
+ * \brief Managed reference to FootprintNode.
+ * \sa FootprintNode
+ */
+class Footprint : public ObjectRef {
+ public:
+  TVM_DEFINE_OBJECT_REF_METHODS(Footprint, ObjectRef, FootprintNode);
+};
+
+/*!
+ * \brief Estimate the peak memory, the constant bytes, the operations and the kernel launches
+ * of a function without running it.
+ *
+ * The allocations are the storages and tensors of the memory lowering, so the estimate follows
+ * the memory plan of VMMemoryLower, or the outputs of the call_tirs before the lowering. An
+ * allocation is live from its binding until the last use of anything that may alias it, the
+ * outputs until the end. The sizes of symbolic shapes are bounded by the tir_var_upper_bound
+ * attribute of the function. The operations of each PrimFunc are the ones of
+ * tir::EstimateTIRFlops. The calls to Relax functions add their own footprints, and both
+ * branches of the Ifs are counted.
+ *
+ * \param mod The module containing the callees.
+ * \param fn The function to be analyzed.
+ * \return The footprint.
+ */
+TVM_DLL Footprint EstimateFootprint(const IRModule& mod, const Function& fn);
+
 /*!
  * \brief Remove unused statements inside DataflowBlocks.
  *
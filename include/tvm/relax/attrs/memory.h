@@ -92,6 +92,8 @@ struct AllocTensorAttrs : public tvm::AttrsNode<AllocTensorAttrs> {
 struct VMAllocStorageAttrs : public tvm::AttrsNode<VMAllocStorageAttrs> {
   DataType dtype;
   int64_t runtime_device_index;
+  bool persistent;
+  std::string storage_scope;
 
   TVM_DECLARE_ATTRS(VMAllocStorageAttrs, "relax.attrs.VMAllocStorageAttrs") {
     TVM_ATTR_FIELD(dtype)
@@ -102,6 +104,14 @@ struct VMAllocStorageAttrs : public tvm::AttrsNode<VMAllocStorageAttrs> {
             "The device index indicating on which device the tensor is to be allocated at runtime. "
             "Index -1 is reserved for the host device.")
         .set_default(-1);
+    TVM_ATTR_FIELD(persistent)
+        .describe(
+            "Whether the VM keeps the storage across calls. It requires a static size and that "
+            "no tensor allocated from the storage outlives the call.")
+        .set_default(false);
+    TVM_ATTR_FIELD(storage_scope)
+        .describe("The memory scope of the storage, e.g. global.vtcm for the VTCM of Hexagon.")
+        .set_default("global");
   }
 };
 
@@ -25,6 +25,7 @@
 #define TVM_RELAX_ATTRS_SHAPE_H_
 
 #include <tvm/ir/attrs.h>
+#include <tvm/ir/expr.h>
 
 namespace tvm {
 namespace relax {
@@ -39,6 +40,20 @@ struct ShapeHeapAttrs : public tvm::AttrsNode<ShapeHeapAttrs> {
   }
 };
 
+/*!
+ * \brief Attributes for computing shape values on the VM heap.
+ */
+struct ComputeShapeAttrs : public tvm::AttrsNode<ComputeShapeAttrs> {
+  Array<PrimExpr> values;
+  Array<Integer> indices;
+
+  TVM_DECLARE_ATTRS(ComputeShapeAttrs, "relax.attrs.ComputeShapeAttrs") {
+    TVM_ATTR_FIELD(values).describe(
+        "The values to compute, which read the heap through loads of a buffer of the heap.");
+    TVM_ATTR_FIELD(indices).describe("The indices of the heap to store the values to.");
+  }
+};
+
 }  // namespace relax
 }  // namespace tvm
 #endif  // TVM_RELAX_ATTRS_SHAPE_H_
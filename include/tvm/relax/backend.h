@@ -33,16 +33,20 @@ namespace transform {
 /*!
  * \brief Perform memory lowering. Lowers the relax.builtin.alloc_tensor intrinsic to VM intrinsics.
  *
+ * \param plan_memory Whether to plan the allocations statically, so that the tensors with
+ * disjoint lifetimes share storage and the tensors of a block are allocated from one storage.
  * \return The Pass.
  */
-TVM_DLL Pass VMMemoryLower();
+TVM_DLL Pass VMMemoryLower(bool plan_memory = false);
 
 /*!
  * \brief Lower the shape expression in relax to VM shape heap and TIR functions.
  *
+ * \param native_shape_arith Whether to compute the shape expressions that only use integer
+ * arithmetic with VM instructions, instead of generating TIR functions for them.
  * \return The Pass.
  */
-TVM_DLL Pass VMShapeLower();
+TVM_DLL Pass VMShapeLower(bool native_shape_arith = false);
 
 }  // namespace transform
 }  // namespace relax
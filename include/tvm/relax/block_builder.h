@@ -24,6 +24,7 @@
 #ifndef TVM_RELAX_BLOCK_BUILDER_H_
 #define TVM_RELAX_BLOCK_BUILDER_H_
 
+#include <tvm/arith/analyzer.h>
 #include <tvm/ir/expr.h>
 #include <tvm/relax/expr.h>
 #include <tvm/relax/utils.h>
@@ -238,6 +239,12 @@ class BlockBuilderNode : public Object {
 
   /*! \brief The internal normalizer used for ANF conversion. */
   std::unique_ptr<ExprNormalizer> normalizer_;
+
+  /*!
+   * \brief The analyzer shared by the shape checks of the builder, so that the symbolic
+   *  dimensions shared by the bindings of a function are only simplified once.
+   */
+  arith::Analyzer analyzer_;
 };
 
 class BlockBuilder : public ObjectRef {
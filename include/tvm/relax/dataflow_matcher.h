@@ -61,6 +61,21 @@ TVM_DLL tvm::runtime::Map<DFPattern, Var> MatchGraph(const PatternContext& ctx,
                                                      Optional<Var> start_hint = NullOpt,
                                                      bool must_include_hint = false);
 
+/**
+ * \brief Rewrite the bindings of a function matching a graph of patterns.
+ * \note Each DataflowBlock is indexed by the ops of its bindings once, and all its non-overlapping
+ * matches are enumerated in the order of the bindings, where the vars shared by the matches can
+ * only be defined outside of the block. The bindings left unused by the rewriting are not removed,
+ * which is left to RemoveAllUnused or DeadCodeElimination.
+ *
+ * \param ctx The graph-wise patterns.
+ * \param rewriter The function mapping the vars matched by the patterns to the new values of the
+ * bindings of some of them, (Map<DFPattern, Var>) -> Map<Var, Expr>.
+ * \param f The function to rewrite.
+ * \return The rewritten function.
+ */
+TVM_DLL Function RewriteBindings(const PatternContext& ctx, PackedFunc rewriter, Function f);
+
 /**
  * \brief Match a graph-wise pattern with the current context (PatternContext::Current()).
  */
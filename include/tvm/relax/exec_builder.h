@@ -55,6 +55,14 @@ class ExecBuilderNode : public Object {
    * \param param_names The function parameter names.
    */
   void EmitFunction(std::string func, int64_t num_inputs, Array<String> param_names);
+  /*!
+   * \brief Declare a packed function in the executable's function table.
+   * \param func The packed function name.
+   * \return The index of the function in the function table.
+   * \note The VM resolves every declared function once, when it is first called, so the index
+   *       can be passed as an immediate and looked up without string hashing.
+   */
+  vm::Index DeclarePackedFunc(const std::string& func);
   /*!
    * \brief Emit a call instruction for a packed function.
    * \param func The packed function name.
@@ -78,17 +86,85 @@ class ExecBuilderNode : public Object {
    * \param false_offset The program counter offset for the false branch.
    */
   void EmitIf(vm::RegName cond, vm::Index false_offset);
+  /*!
+   * \brief Emit a LoadShape instruction.
+   * \param heap The register of the shape heap.
+   * \param indices The heap index of each dimension of the shape.
+   * \param dst The destination register of the shape.
+   */
+  void EmitLoadShape(vm::RegName heap, std::vector<vm::Index> indices, vm::RegName dst);
+  /*!
+   * \brief Emit a StoreShape instruction.
+   * \param shape The register of the shape to store.
+   * \param heap The register of the shape heap.
+   * \param indices The heap index of each dimension of the shape.
+   */
+  void EmitStoreShape(vm::RegName shape, vm::RegName heap, std::vector<vm::Index> indices);
+  /*!
+   * \brief Emit a ComputeShape instruction.
+   * \param heap The register of the shape heap.
+   * \param program The (operation, operand) pairs of the computation, see vm::ShapeOp.
+   */
+  void EmitComputeShape(vm::RegName heap, std::vector<vm::ExecWord> program);
+  /*!
+   * \brief Emit a Move instruction.
+   * \param src The register to copy from.
+   * \param dst The destination register.
+   */
+  void EmitMove(vm::RegName src, vm::RegName dst);
+  /*!
+   * \brief Emit a LoadConst instruction.
+   * \param const_idx The index of the constant, as returned by EmitConstant.
+   * \param dst The destination register.
+   */
+  void EmitLoadConst(vm::Index const_idx, vm::RegName dst);
+  /*!
+   * \brief Emit a MakeTuple instruction.
+   * \param fields The fields of the tuple, registers or constants.
+   * \param dst The destination register.
+   */
+  void EmitMakeTuple(std::vector<vm::Instruction::Arg> fields, vm::RegName dst);
+  /*!
+   * \brief Emit a GetTupleItem instruction.
+   * \param tuple The register of the tuple.
+   * \param index The index of the item.
+   * \param dst The destination register.
+   */
+  void EmitGetTupleItem(vm::RegName tuple, vm::Index index, vm::RegName dst);
+  /*!
+   * \brief Emit a Kill instruction.
+   * \param regs The registers whose values are released.
+   */
+  void EmitKill(std::vector<vm::RegName> regs);
   /*!
    * \brief Emit a constant value to the constant pool.
    * \param obj The constant value to be emitted
+   * \param device_index The index of the VM device an NDArray constant is used on, -1 for the
+   *        host. The VM copies the constant to the device when it is first used.
    * \return The index that represents the constant.
    */
-  vm::Index EmitConstant(TVMRetValue obj);
+  vm::Index EmitConstant(TVMRetValue obj, vm::Index device_index = 0);
   /*!
    * \brief Get the built executable.
    * \return The built executable.
    */
   ObjectPtr<vm::Executable> Get();
+  /*!
+   * \brief Fuse frequent instruction sequences of the built executable into superinstructions
+   * that the VM runs without packed function calls: an alloc_storage followed by an alloc_tensor
+   * on the storage, and a load_shape followed by the call consuming the shape.
+   * \note This is a peephole pass over the executable returned by Get, so it must be called
+   * once no more instructions are emitted.
+   */
+  void FuseInstructions();
+  /*!
+   * \brief Allocate the registers of the built executable by liveness, so that the values whose
+   * live ranges do not overlap share a register, and emit Kill instructions releasing the values
+   * after their last use.
+   * \note Like FuseInstructions, this must be called once no more instructions are emitted.
+   * Functions jumping backward are left as they are.
+   */
+  void AllocateRegisters();
   /*!
    * \brief Create an ExecBuilder.
    * \return The ExecBuilder.
@@ -111,6 +187,16 @@ class ExecBuilderNode : public Object {
    * \brief Formalize the executable.
    */
   void Formalize();
+  /*!
+   * \brief Replace the instructions of the executable, updating the jump offsets and the function
+   * entries.
+   * \param new_index The new index of each instruction, followed by the new number of instructions.
+   * \param instr_offset The new instruction offsets.
+   * \param instr_data The new instruction data.
+   */
+  void ReplaceInstructions(const std::vector<vm::Index>& new_index,
+                           std::vector<vm::Index> instr_offset,
+                           std::vector<vm::ExecWord> instr_data);
 };
 
 class ExecBuilder : public ObjectRef {
@@ -484,6 +484,16 @@ constexpr const char* kCodegen = "Codegen";
 constexpr const char* kComposite = "Composite";
 /*! \brief Indicate the function was created by the Pattern Partitioning Pass. */
 constexpr const char* kPartitionedFromPattern = "PartitionedFromPattern";
+/*!
+ * \brief The upper bounds of the symbolic shape variables in the function, keyed by the var
+ * name. Memory planning uses them to bound the storage of symbolically shaped tensors.
+ */
+constexpr const char* kTIRVarUpperBound = "tir_var_upper_bound";
+/*!
+ * \brief The number of trailing parameters of a PrimFunc that are scratch buffers lifted from
+ * its body, which the caller allocates after the outputs.
+ */
+constexpr const char* kNumWorkspaces = "num_workspaces";
 }  // namespace attr
 
 /*! \brief The extern function, which can represent packed function. */
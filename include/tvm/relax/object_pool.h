@@ -0,0 +1,109 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/relax/object_pool.h
+ * \brief A thread-local pool recycling the storage of the Relax IR nodes, for the passes creating
+ *        and discarding many temporary nodes on large graphs.
+ */
+#ifndef TVM_RELAX_OBJECT_POOL_H_
+#define TVM_RELAX_OBJECT_POOL_H_
+
+#include <tvm/runtime/memory.h>
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace tvm {
+namespace relax {
+
+/*!
+ * \brief The scope in which the storage of the nodes created by PoolObjAllocator on the current
+ *  thread is recycled. Once the outermost scope of a thread exits, the storage it keeps is freed.
+ * \note Nodes may outlive the scope creating them and be released on any thread: the storage of a
+ *  node released out of any scope simply goes back to the heap.
+ */
+class ObjectPoolScope {
+ public:
+  TVM_DLL ObjectPoolScope();
+  TVM_DLL ~ObjectPoolScope();
+  ObjectPoolScope(const ObjectPoolScope&) = delete;
+  ObjectPoolScope& operator=(const ObjectPoolScope&) = delete;
+
+  /*!
+   * \brief Allocate a storage from the pool of the current thread, or from the heap.
+   * \param size The size of the storage.
+   */
+  TVM_DLL static void* Allocate(size_t size);
+  /*!
+   * \brief Give a storage allocated by Allocate back to the pool of the current thread, if any.
+   * \param ptr The storage.
+   * \param size The size of the storage, the same as the one it was allocated with.
+   */
+  TVM_DLL static void Free(void* ptr, size_t size);
+};
+
+/*!
+ * \brief The object allocator recycling the storage through ObjectPoolScope. Out of any scope, it
+ *  behaves as SimpleObjAllocator.
+ */
+class PoolObjAllocator : public runtime::ObjAllocatorBase<PoolObjAllocator> {
+ public:
+  template <typename T>
+  class Handler {
+   public:
+    using StorageType = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+    static_assert(alignof(StorageType) <= alignof(std::max_align_t),
+                  "The pooled storage is only aligned as the storage from operator new");
+
+    template <typename... Args>
+    static T* New(PoolObjAllocator*, Args&&... args) {
+      void* data = ObjectPoolScope::Allocate(sizeof(StorageType));
+      new (data) T(std::forward<Args>(args)...);
+      return reinterpret_cast<T*>(data);
+    }
+
+    static runtime::Object::FDeleter Deleter() { return Deleter_; }
+
+   private:
+    static void Deleter_(runtime::Object* objptr) {
+      T* tptr = static_cast<T*>(objptr);
+      tptr->T::~T();
+      ObjectPoolScope::Free(tptr, sizeof(StorageType));
+    }
+  };
+};
+
+/*!
+ * \brief Allocate a node whose storage is recycled within ObjectPoolScope.
+ * \param args The arguments to the constructor.
+ * \tparam T The node type.
+ * \return The ObjectPtr to the allocated node.
+ */
+template <typename T, typename... Args>
+inline runtime::ObjectPtr<T> make_pooled_object(Args&&... args) {
+  return PoolObjAllocator().make_object<T>(std::forward<Args>(args)...);
+}
+
+}  // namespace relax
+}  // namespace tvm
+
+#endif  // TVM_RELAX_OBJECT_POOL_H_
@@ -61,6 +61,28 @@ using FInferType = runtime::TypedPackedFunc<Type(const Call& call, DiagnosticCon
  */
 using FCallPacked = String;
 
+/*! \brief The policy of an operator in the mixed precision conversion. */
+enum MixedPrecisionPolicyKind : int {
+  /*! \brief Always compute the operator in the lower precision. */
+  kMixedPrecisionAlways = 0,
+  /*! \brief Compute the operator in the lower precision if any of its inputs already is. */
+  kMixedPrecisionFollow = 1,
+  /*! \brief Never compute the operator in the lower precision. */
+  kMixedPrecisionNever = 2,
+};
+
+/*!
+ * \brief The MixedPrecisionPolicyKind of an operator in ToMixedPrecision. The operators without
+ * this attribute are never converted.
+ */
+using TMixedPrecisionPolicy = Integer;
+
+/*!
+ * \brief Whether the packed function of an operator only enqueues its work on the current stream
+ * of the device, so that the VM codegen schedules its calls on the streams as the kernels.
+ */
+using TStreamOrdered = Bool;
+
 /*! \brief Attributes used in unique operator */
 struct UniqueAttrs : public tvm::AttrsNode<UniqueAttrs> {
   bool sorted;
@@ -88,6 +110,53 @@ struct UniqueAttrs : public tvm::AttrsNode<UniqueAttrs> {
   }
 };  // struct UniqueAttrs
 
+/*! \brief Attributes used in quantize and dequantize operators */
+struct QuantizeAttrs : public tvm::AttrsNode<QuantizeAttrs> {
+  double scale;
+  int zero_point;
+  DataType out_dtype;
+  TVM_DECLARE_ATTRS(QuantizeAttrs, "relax.attrs.QuantizeAttrs") {
+    TVM_ATTR_FIELD(scale)
+        .describe(
+            "The scale of the quantized values. A non-positive scale marks a quantization whose "
+            "parameters are yet to be calibrated.")
+        .set_default(0.0);
+    TVM_ATTR_FIELD(zero_point)
+        .describe("The quantized value the real value zero is mapped to.")
+        .set_default(0);
+    TVM_ATTR_FIELD(out_dtype).describe("The data type of the output tensor.");
+  }
+};  // struct QuantizeAttrs
+
+/*! \brief Attributes used in the attention operator */
+struct AttentionAttrs : public tvm::AttrsNode<AttentionAttrs> {
+  double scale;
+  bool causal;
+  TVM_DECLARE_ATTRS(AttentionAttrs, "relax.attrs.AttentionAttrs") {
+    TVM_ATTR_FIELD(scale)
+        .describe(
+            "The scale of the scores before the softmax. A non-positive scale stands for "
+            "1 / sqrt(head_dim).")
+        .set_default(0.0);
+    TVM_ATTR_FIELD(causal)
+        .describe(
+            "Whether each query only attends to the keys up to its position, aligned on the last "
+            "query and the last key.")
+        .set_default(false);
+  }
+};  // struct AttentionAttrs
+
+struct RMSNormAttrs : public tvm::AttrsNode<RMSNormAttrs> {
+  int axis;
+  double epsilon;
+  TVM_DECLARE_ATTRS(RMSNormAttrs, "relax.attrs.RMSNormAttrs") {
+    TVM_ATTR_FIELD(axis).describe("The axis normalized by its root mean square.").set_default(-1);
+    TVM_ATTR_FIELD(epsilon)
+        .describe("Small float added to the mean square to avoid dividing by zero.")
+        .set_default(1e-5);
+  }
+};  // struct RMSNormAttrs
+
 struct PrintAttrs : public tvm::AttrsNode<PrintAttrs> {
   std::string format;
   TVM_DECLARE_ATTRS(PrintAttrs, "relax.attrs.PrintAttrs") {
@@ -109,6 +178,42 @@ struct AssertOpAttrs : public tvm::AttrsNode<AssertOpAttrs> {
   }
 };
 
+/*! \brief Attributes used in the param_load operator */
+struct ParamLoadAttrs : public tvm::AttrsNode<ParamLoadAttrs> {
+  std::string name;
+  Array<PrimExpr> shape;
+  DataType dtype;
+  TVM_DECLARE_ATTRS(ParamLoadAttrs, "relax.attrs.ParamLoadAttrs") {
+    TVM_ATTR_FIELD(name).describe("The name of the param in the param store of the VM.");
+    TVM_ATTR_FIELD(shape).describe("The shape of the param.");
+    TVM_ATTR_FIELD(dtype).describe("The data type of the param.");
+  }
+};  // struct ParamLoadAttrs
+
+/*! \brief Attributes used in the collective communication operators */
+struct CCLAttrs : public tvm::AttrsNode<CCLAttrs> {
+  std::string op_type;
+  int num_workers;
+  TVM_DECLARE_ATTRS(CCLAttrs, "relax.attrs.CCLAttrs") {
+    TVM_ATTR_FIELD(op_type)
+        .describe("The reduction of allreduce and reduce_scatter, sum, prod, min or max.")
+        .set_default("sum");
+    TVM_ATTR_FIELD(num_workers)
+        .describe("The number of workers of the group, the ranks the tensors are split across.")
+        .set_default(1);
+  }
+};  // struct CCLAttrs
+
+/*! \brief Attributes used in the prefetch operator */
+struct PrefetchAttrs : public tvm::AttrsNode<PrefetchAttrs> {
+  std::string scope;
+  TVM_DECLARE_ATTRS(PrefetchAttrs, "relax.attrs.PrefetchAttrs") {
+    TVM_ATTR_FIELD(scope)
+        .describe("The memory scope the tensor is copied to, e.g. global.vtcm.")
+        .set_default("global.vtcm");
+  }
+};  // struct PrefetchAttrs
+
 }  // namespace relax
 }  // namespace tvm
 #endif  // TVM_RELAX_OP_ATTR_TYPES_H_
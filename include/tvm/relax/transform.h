@@ -25,6 +25,10 @@
 #define TVM_RELAX_TRANSFORM_H_
 
 #include <tvm/ir/transform.h>
+#include <tvm/meta_schedule/builder.h>
+#include <tvm/meta_schedule/cost_model.h>
+#include <tvm/meta_schedule/runner.h>
+#include <tvm/relax/dataflow_pattern.h>
 #include <tvm/relax/expr.h>
 
 namespace tvm {
@@ -86,6 +90,16 @@ TVM_DLL Pass FMARewrite();
  */
 TVM_DLL Pass LambdaLift();
 
+/*!
+ * \brief Turn the invocations of the closures whose target is statically known, as bound to
+ * `make_closure` in the invoking function, into direct calls of the lifted functions with the
+ * captured values as trailing arguments, and remove the closures left unused. It is expected to
+ * run after LambdaLift.
+ *
+ * \return The Pass.
+ */
+TVM_DLL Pass DevirtualizeClosures();
+
 /*!
  * \brief Transform all dataflow structure to non-dataflow version.
  *
@@ -93,12 +107,24 @@ TVM_DLL Pass LambdaLift();
  */
 TVM_DLL Pass ToNonDataflow();
 
+/*!
+ * \brief Lift the scratch buffers of static shape allocated by the root block of the PrimFuncs
+ * called by call_tir into trailing parameters, which CallTIRRewrite allocates as tensors, so
+ * that the VM plans them with the other tensors instead of allocating a workspace per call.
+ *
+ * \return The Pass.
+ */
+TVM_DLL Pass LiftTIRWorkspace();
+
 /*!
  * \brief Perform explicit tensor allocation for call_tir.
  *
+ * \param inplace Whether to write the output of a call_tir into an input that dies at the call
+ * instead of allocating it, when the PrimFunc reads each input element only to compute the
+ * output element at the same index.
  * \return The Pass.
  */
-TVM_DLL Pass CallTIRRewrite();
+TVM_DLL Pass CallTIRRewrite(bool inplace = false);
 
 /*!
  * \brief Simplify a Relax module by folding var bindings and match shape nodes.
@@ -127,6 +153,88 @@ TVM_DLL Pass Normalize();
  */
 TVM_DLL Pass BindParams(String name, Map<String, runtime::NDArray> params);
 
+/*!
+ * \brief Load params of function of the module by name from the param store of the VM at
+ * runtime, so that they are neither inputs of the function nor constants of the executable.
+ *
+ * \param func_name The name of the function.
+ * \param names The names of the params to load, which must have static shapes.
+ *
+ * \return The Pass.
+ */
+TVM_DLL Pass ExternalizeParams(String func_name, Array<String> names);
+
+/*!
+ * \brief Eliminate the bindings of DataflowBlocks computing the same value as an earlier binding
+ * of the block, i.e. the calls with the same callee and arguments. The calls of packed functions
+ * are kept since they may have side effects.
+ *
+ * \return The Pass.
+ */
+TVM_DLL Pass EliminateCommonSubexpr();
+
+/*!
+ * \brief Remove the bindings of DataflowBlocks whose vars are never used, until none is left.
+ *
+ * \return The Pass.
+ */
+TVM_DLL Pass DeadCodeElimination();
+
+/*!
+ * \brief Combine the matmuls of each DataflowBlock which share the same input into a single
+ * wider matmul, whose weight is the concatenation of their weights, followed by a split of its
+ * output. The concatenation of constant weights is folded by FoldConstant.
+ * \note Only the matmul PrimFuncs with static shapes whose weights are defined outside of the
+ * block are combined.
+ *
+ * \return The Pass.
+ */
+TVM_DLL Pass CombineParallelMatmul();
+
+/*!
+ * \brief Make the function return the inputs of its quantize ops whose scales are yet to be
+ * calibrated, in the order of the ops, after its original return value. Calibration runs the
+ * resulting function to collect the ranges of these inputs.
+ *
+ * \param func_name The name of the function to be calibrated.
+ * \return The Pass.
+ */
+TVM_DLL Pass ExposeQuantizeInputs(String func_name);
+
+/*!
+ * \brief Set the scales and zero points of the quantize ops of the function which are yet to be
+ * calibrated, in the order of the ops. The uncalibrated dequantize ops of their outputs take the
+ * same parameters.
+ *
+ * \param func_name The name of the calibrated function.
+ * \param scales The scale of each quantize op.
+ * \param zero_points The zero point of each quantize op.
+ * \return The Pass.
+ */
+TVM_DLL Pass BindQuantizeParams(String func_name, Array<FloatImm> scales,
+                                Array<Integer> zero_points);
+
+/*!
+ * \brief Fold the quantize of a matmul of dequantized integer tensors into a single call_tir to an
+ * integer matmul, which accumulates in int32 and requantizes its result.
+ * \note Only the calibrated ops and the matmul PrimFuncs with static shapes are folded.
+ *
+ * \return The Pass.
+ */
+TVM_DLL Pass FoldQDQ();
+
+/*!
+ * \brief Compute the float32 operators of the DataflowBlocks in float16 or bfloat16, as decided
+ * by the TMixedPrecisionPolicy attribute of the operators, and the "mixed_precision_policy" or
+ * "op_pattern" attribute of the PrimFuncs called by call_tir. The casts are only inserted at the
+ * boundaries of the converted regions. When the params are bound as constants by BindParams, the
+ * casts of the weights are folded by a following FoldConstant.
+ *
+ * \param out_dtype The data type the operators are computed in.
+ * \return The Pass.
+ */
+TVM_DLL Pass ToMixedPrecision(DataType out_dtype);
+
 /*!
  * \brief Fold constant expressions.
  *
@@ -134,6 +242,40 @@ TVM_DLL Pass BindParams(String name, Map<String, runtime::NDArray> params);
  */
 TVM_DLL Pass FoldConstant();
 
+/*!
+ * \brief Cancel the pairs of adjacent layout transforms that undo each other, where a layout
+ * transform is a call_tir to a PrimFunc which only permutes the axes of its input. It is meant
+ * to run after the operators are emitted in their preferred layouts, before FoldConstant, which
+ * folds the remaining transforms of the weights, and FuseOps.
+ *
+ * \return The Pass.
+ */
+TVM_DLL Pass ElideLayoutTransforms();
+
+/*!
+ * \brief Specialize a Relax function to the concrete shapes of its inputs. The symbolic shape
+ * vars of its parameters are replaced with the given dimensions, and the PrimFuncs it calls with
+ * static shapes only are specialized to them, as new PrimFuncs of the module.
+ *
+ * \param func_name The name of the function.
+ * \param shapes The shape of each parameter, ignored for the parameters without a ShapeExpr.
+ * \return The Pass.
+ */
+TVM_DLL Pass SpecializeShapes(String func_name, Array<runtime::ShapeTuple> shapes);
+
+/*!
+ * \brief Dispatch the call_tir of PrimFuncs with symbolic shapes among their variants tuned for
+ * buckets of shapes. Each call is rewritten into a chain of If, whose conditions are computed by
+ * predicate PrimFuncs reading the symbolic shapes of the inputs. The first bucket containing the
+ * shapes selects its variant, and the original PrimFunc handles the shapes outside all buckets.
+ *
+ * \param buckets The buckets of each PrimFunc, keyed by its name, in the order they are checked.
+ * Each bucket is a pair of the inclusive range [min, max] of some symbolic vars of the inputs,
+ * keyed by their names, and the variant PrimFunc, which takes the same arguments.
+ * \return The Pass.
+ */
+TVM_DLL Pass DispatchShapeBuckets(Map<String, Array<Array<ObjectRef>>> buckets);
+
 /*!
  * \brief Annotate Op Pattern Kind for TIR functions, which is used in FuseOps.
  * \note It is an auto-detect pass for "unscheduled prim_funcs", the op_pattern will be
@@ -152,9 +294,37 @@ TVM_DLL Pass AnnotateTIROpPattern();
  * A follow-up pass named "FuseTIR" will generate a TIR PrimFunc for each grouped function.
  * \param fuse_opt_level The level of fuse optimization.
  *        -1 indicates that the level will be inferred from pass context.
+ * \param fcheck_group The optional function `(Function grouped, IRModule mod) -> bool` deciding
+ *        whether each group found by the fusion algorithm is actually fused, e.g. by comparing
+ *        the costs predicted for the fused and unfused kernels. All the groups are fused if absent.
  * \return The Pass.
  */
-TVM_DLL Pass FuseOps(int fuse_opt_level = -1);
+TVM_DLL Pass FuseOps(int fuse_opt_level = -1, Optional<PackedFunc> fcheck_group = NullOpt);
+
+/*!
+ * \brief Group the bindings of the dataflow blocks matching the given patterns into functions
+ * offloaded to external codegens. Each match is wrapped into a composite function, with the
+ * attribute "Composite" set to the name of the pattern, which is called by a function with the
+ * attributes "Codegen" and "global_symbol", the input of RunCodegen.
+ * \param pattern_names The names of the patterns, each prefixed by the name of the codegen, such
+ *        as "tensorrt.add". The codegen of a match is the part preceding the first dot.
+ * \param patterns The patterns, in the order of priority when several match the same binding.
+ * \param fcheck_group The optional function `(Function grouped, IRModule mod) -> bool` deciding
+ *        whether each match is actually offloaded, e.g. by comparing the costs of the external
+ *        kernel and of the TVM one. All the matches are offloaded if absent.
+ * \return The Pass.
+ */
+TVM_DLL Pass FuseOpsByPattern(Array<runtime::String> pattern_names, Array<DFPattern> patterns,
+                              Optional<PackedFunc> fcheck_group = NullOpt);
+
+/*!
+ * \brief Merge the chains of functions created by FuseOpsByPattern that are offloaded to the same
+ * codegen, when each intermediate result is only used by the next function of the chain, so that
+ * each chain is compiled by its codegen as a whole, e.g. keeping the intermediate tensors in the
+ * layouts of the external library.
+ * \return The Pass.
+ */
+TVM_DLL Pass MergeCompositeFunctions();
 
 /*!
  * \brief Fuse relax sub-function into a larger TIR function if possible.
@@ -164,6 +334,36 @@ TVM_DLL Pass FuseOps(int fuse_opt_level = -1);
  */
 TVM_DLL Pass FuseTIR();
 
+/*!
+ * \brief Inline the injective stages of the PrimFuncs fused by FuseTIR, so that the buffers
+ * passing data between the stages are no longer allocated. An injective producer read by a
+ * single consumer is inlined into it, which fuses a prologue such as a dequantize into a
+ * matmul, and an injective consumer of a complete block is inlined into it, which fuses the
+ * chains of elementwise epilogues. The reduction blocks are never inlined.
+ * \return The Pass.
+ */
+TVM_DLL Pass InlineFusedIntermediates();
+
+/*!
+ * \brief Move the producer of each buffer passing data between the stages of the PrimFuncs fused
+ * by FuseTIR under the deepest loop of its single consumer where it still computes each element
+ * once. The lowering then allocates the buffer in that loop, compacted to the region live in an
+ * iteration, e.g. one row of the row reduction of a softmax, instead of the full tensor.
+ * \return The Pass.
+ */
+TVM_DLL Pass LocalizeFusedIntermediates();
+
+/*!
+ * \brief Prefetch the weights of each call_tir to a memory scope of the device, e.g. the VTCM
+ * of Hexagon, during the previous call_tir of its binding block.
+ * \param scope The memory scope the weights are copied to.
+ * \param weight_params The names of the function parameters that are weights, besides the
+ * constants and the params loaded by relax.param_load.
+ * \param max_bytes The bytes prefetched for a kernel at most, 0 for no limit.
+ * \return The Pass.
+ */
+TVM_DLL Pass PrefetchWeights(String scope, Array<String> weight_params, int64_t max_bytes);
+
 /*!
  * \brief Remove unused global relax functions in a IRModule.
  * \param entry_functions list of entry functions
@@ -180,6 +380,26 @@ TVM_DLL Pass RemoveUnusedFunctions(Array<runtime::String> entry_functions);
 TVM_DLL Pass RunCodegen(Optional<Array<runtime::String>> target_codegens,
                         Array<runtime::String> entry_functions);
 
+/*!
+ * \brief Tune the PrimFuncs called by the Relax functions with MetaSchedule under the current
+ * target, and replace them with their best schedules. Task extraction, the task scheduler and the
+ * database are all driven from C++, so no python interpreter is needed as long as the builder,
+ * the runner and the cost model are not implemented in python.
+ * \param work_dir The directory of the JSONDatabase that keeps the tuning records.
+ * \param max_trials_global The maximum number of trials over all the tasks.
+ * \param max_trials_per_task The maximum number of trials of each task.
+ * \param num_trials_per_iter The number of trials measured in one batch.
+ * \param builder The builder of the measured candidates.
+ * \param runner The runner of the measured candidates.
+ * \param cost_model The cost model guiding the evolutionary search. If not provided, the traces
+ * of the design spaces are replayed with random decisions instead.
+ * \return The Pass.
+ */
+TVM_DLL Pass MetaScheduleTune(runtime::String work_dir, Integer max_trials_global,
+                              Integer max_trials_per_task, Integer num_trials_per_iter,
+                              meta_schedule::Builder builder, meta_schedule::Runner runner,
+                              Optional<meta_schedule::CostModel> cost_model);
+
 }  // namespace transform
 }  // namespace relax
 }  // namespace tvm
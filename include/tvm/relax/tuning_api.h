@@ -379,9 +379,11 @@ class Database : public runtime::ObjectRef {
    * \param path_tuning_record The path to the tuning record table.
    * \param path_measurement_record The path to the measurement_record table.
    * \param allow_missing Whether to create new file when the given path is not found.
+   * \param concurrent Whether the tables are shared with other processes committing to them.
    */
   TVM_DLL static Database JSONDatabase(String path_workload, String path_tuning_record,
-                                       String path_measurement_record, bool allow_missing);
+                                       String path_measurement_record, bool allow_missing,
+                                       bool concurrent);
   TVM_DEFINE_MUTABLE_NOTNULLABLE_OBJECT_REF_METHODS(Database, runtime::ObjectRef, DatabaseNode);
 };
 
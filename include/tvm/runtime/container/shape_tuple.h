@@ -24,6 +24,9 @@
 #ifndef TVM_RUNTIME_CONTAINER_SHAPE_TUPLE_H_
 #define TVM_RUNTIME_CONTAINER_SHAPE_TUPLE_H_
 
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -46,9 +49,14 @@ class ShapeTupleObj : public Object {
   static constexpr const char* _type_key = "runtime.ShapeTuple";
   TVM_DECLARE_FINAL_OBJECT_INFO(ShapeTupleObj, Object);
 
+  /*! \brief The number of dimensions up to which the shape is stored inline in the object. */
+  static constexpr const size_t kMaxInlineDims = 6;
+
  private:
   /*! \brief ShapeTuple object which is moved from std::vector container. */
   class FromStd;
+  /*! \brief ShapeTuple object which stores a small shape inline, without another allocation. */
+  class Inline;
 
   friend class ShapeTuple;
 };
@@ -75,6 +83,15 @@ class ShapeTupleObj::FromStd : public ShapeTupleObj {
   friend class ShapeTuple;
 };
 
+/*! \brief An object representing a shape tuple of up to kMaxInlineDims dimensions. */
+class ShapeTupleObj::Inline : public ShapeTupleObj {
+ private:
+  /*! \brief The storage of the dimensions. */
+  index_type storage_[kMaxInlineDims];
+
+  friend class ShapeTuple;
+};
+
 /*!
  * \brief Reference to shape tuple objects.
  */
@@ -86,16 +103,32 @@ class ShapeTuple : public ObjectRef {
   /*!
    * \brief Construct an empty shape tuple.
    */
-  ShapeTuple() : ShapeTuple(std::vector<index_type>()) {}
+  ShapeTuple() : ShapeTuple(std::initializer_list<index_type>()) {}
 
   /*!
    * \brief Constructor from iterator
    * \param begin begin of iterator
    * \param end end of iterator
    * \tparam IterType The type of iterator
+   * \note The shape of up to kMaxInlineDims dimensions, given by forward iterators, is stored
+   *  inline in the object.
    */
   template <typename IterType>
-  ShapeTuple(IterType begin, IterType end) : ShapeTuple(std::vector<index_type>(begin, end)) {}
+  ShapeTuple(IterType begin, IterType end) {
+    using Category = typename std::iterator_traits<IterType>::iterator_category;
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+      auto ndim = std::distance(begin, end);
+      if (ndim >= 0 && static_cast<size_t>(ndim) <= ShapeTupleObj::kMaxInlineDims) {
+        auto ptr = make_object<ShapeTupleObj::Inline>();
+        ptr->size = ndim;
+        ptr->data = ptr->storage_;
+        std::copy(begin, end, ptr->storage_);
+        data_ = std::move(ptr);
+        return;
+      }
+    }
+    *this = ShapeTuple(std::vector<index_type>(begin, end));
+  }
 
   /*!
    * \brief constructor from initializer list
@@ -164,6 +197,10 @@ class ShapeTuple : public ObjectRef {
 };
 
 inline ShapeTuple::ShapeTuple(std::vector<index_type> shape) {
+  if (shape.size() <= ShapeTupleObj::kMaxInlineDims) {
+    *this = ShapeTuple(shape.begin(), shape.end());
+    return;
+  }
   auto ptr = make_object<ShapeTupleObj::FromStd>(std::move(shape));
   ptr->size = ptr->data_container.size();
   ptr->data = ptr->data_container.data();
@@ -0,0 +1,98 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/runtime/crt/arena_allocator.h
+ * \brief A memory manager serving all the memory of the CRT from one static arena.
+ *
+ * The allocations made while the runtime and the executor are set up are placed one after
+ * another and are never reused, so the layout of the arena is the same on every boot. Once
+ * ArenaMemoryManager_Seal is called, the allocations made afterwards, i.e. the workspaces of the
+ * operators, are stacked above the sealed ones, each behind a small header recording its size.
+ * The memory of the top block is reused once it is released, and a block released out of LIFO
+ * order is only reused once the blocks above it are released too. An allocation of zero bytes
+ * yields NULL. The arena never falls back to the heap; an allocation that does not fit fails
+ * with kTvmErrorPlatformNoMemory.
+ */
+
+#ifndef TVM_RUNTIME_CRT_ARENA_ALLOCATOR_H_
+#define TVM_RUNTIME_CRT_ARENA_ALLOCATOR_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <tvm/runtime/crt/error_codes.h>
+#include <tvm/runtime/crt/page_allocator.h>
+
+#ifndef TVM_RUNTIME_ALLOC_ALIGNMENT_BYTES
+#define TVM_RUNTIME_ALLOC_ALIGNMENT_BYTES 16
+#endif
+
+/*!
+ * \brief Define the static arena, placed in the linker section named by
+ * TVM_CRT_STATIC_ARENA_SECTION when it is defined.
+ */
+#ifdef TVM_CRT_STATIC_ARENA_SECTION
+#define TVM_CRT_DEFINE_STATIC_ARENA(name, size_bytes)                                   \
+  static uint8_t name[size_bytes] __attribute__((section(TVM_CRT_STATIC_ARENA_SECTION), \
+                                                 aligned(TVM_RUNTIME_ALLOC_ALIGNMENT_BYTES)))
+#else
+#define TVM_CRT_DEFINE_STATIC_ARENA(name, size_bytes) \
+  static uint8_t name[size_bytes] __attribute__((aligned(TVM_RUNTIME_ALLOC_ALIGNMENT_BYTES)))
+#endif
+
+/*!
+ * \brief Create the arena memory manager, whose state is kept at the start of the arena.
+ *
+ * \param manager Pointer, initialized with the new MemoryManager.
+ * \param arena The arena the memory of the CRT is served from.
+ * \param arena_size_bytes Size of `arena`, in bytes.
+ * \return kTvmErrorNoError on success.
+ */
+tvm_crt_error_t ArenaMemoryManagerCreate(MemoryManagerInterface** manager, uint8_t* arena,
+                                         size_t arena_size_bytes);
+
+/*!
+ * \brief Seal the allocations made so far, after which the allocations are released in LIFO
+ * order and the sealed ones are kept until the arena is recreated.
+ *
+ * \param manager The arena memory manager.
+ * \return kTvmErrorNoError on success.
+ */
+tvm_crt_error_t ArenaMemoryManager_Seal(MemoryManagerInterface* manager);
+
+/*!
+ * \brief Get the bytes of the arena in use.
+ *
+ * \param manager The arena memory manager.
+ * \param sealed_bytes Written with the bytes sealed, or in use before the arena is sealed.
+ * \param peak_bytes Written with the most bytes ever in use, to check the arena size against.
+ * \return kTvmErrorNoError on success.
+ */
+tvm_crt_error_t ArenaMemoryManager_GetUsage(MemoryManagerInterface* manager,
+                                            size_t* sealed_bytes, size_t* peak_bytes);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // TVM_RUNTIME_CRT_ARENA_ALLOCATOR_H_
@@ -30,6 +30,10 @@
 #include <tvm/runtime/crt/error_codes.h>
 #include <tvm/runtime/crt/rpc_common/write_stream.h>
 
+#ifndef TVM_CRT_FRAMER_BUFFER_SIZE_BYTES
+#define TVM_CRT_FRAMER_BUFFER_SIZE_BYTES 128
+#endif
+
 namespace tvm {
 namespace runtime {
 namespace micro_rpc {
@@ -224,8 +228,11 @@ class Framer {
   void Reset();
 
  private:
-  /*! \brief Maximum size of stack-based buffer. */
-  static constexpr const size_t kMaxStackBufferSizeBytes = 128;
+  /*!
+   * \brief Maximum size of stack-based buffer, the bytes of each write to the stream.
+   *  Targets whose writes have a high fixed cost can grow it with TVM_CRT_FRAMER_BUFFER_SIZE_BYTES.
+   */
+  static constexpr const size_t kMaxStackBufferSizeBytes = TVM_CRT_FRAMER_BUFFER_SIZE_BYTES;
 
   enum class State : uint8_t {
     /*! \brief State entered at construction time or after write error, before first packet sent. */
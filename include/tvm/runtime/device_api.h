@@ -138,6 +138,16 @@ class TVM_DLL DeviceAPI {
    */
   virtual TVMStreamHandle CreateStream(Device dev);
 
+  /*!
+   * \brief Create a new stream for the copies overlapping the work on the default stream.
+   *
+   * Unlike the streams of CreateStream, it is not implicitly synchronized with the default
+   * stream, so the orders with it are only the ones set by SyncStreamFromTo.
+   *
+   * \param dev The device of allocation.
+   */
+  virtual TVMStreamHandle CreateCopyStream(Device dev);
+
   /*!
    * \brief Free a stream of execution
    *
@@ -269,6 +269,8 @@ constexpr const char* tvm_param_prefix = "__tvm_param__";
 constexpr const char* tvm_lookup_linked_param = "_lookup_linked_param";
 /*! \brief Model entrypoint generated as an interface to the AOT function outside of TIR */
 constexpr const char* tvm_entrypoint_suffix = "run";
+/*! \brief Suffix of the entry of a PrimFunc trusting its arguments, see tir.make_unchecked_api */
+constexpr const char* tvm_unchecked_suffix = "_unchecked";
 }  // namespace symbol
 
 // implementations of inline functions.
@@ -799,7 +799,10 @@ struct ObjectPtrEqual {
 inline void Object::IncRef() { ref_counter_.fetch_add(1, std::memory_order_relaxed); }
 
 inline void Object::DecRef() {
-  if (ref_counter_.fetch_sub(1, std::memory_order_release) == 1) {
+  // Fast path of the last reference, such as the one of a temporary confined to a thread: no
+  // other thread can take a new reference, so the object is deleted without the atomic write.
+  if (ref_counter_.load(std::memory_order_acquire) == 1 ||
+      ref_counter_.fetch_sub(1, std::memory_order_release) == 1) {
     std::atomic_thread_fence(std::memory_order_acquire);
     if (this->deleter_ != nullptr) {
       (*this->deleter_)(this);
@@ -503,6 +503,12 @@ String ShapeString(NDArray shape, DLDataType dtype);
  */
 String ShapeString(const std::vector<int64_t>& shape, DLDataType dtype);
 
+/*! \brief String representation of a device, as in the reports.
+ *  \param dev The device.
+ *  \return A textual representation of the device. For example: `cpu0`.
+ */
+std::string DeviceString(Device dev);
+
 /*! \brief Collect performance information of a function execution. Usually
  * used with a compiled PrimFunc (via tvm.build).
  *
@@ -587,6 +593,34 @@ PackedFunc WrapTimeEvaluator(PackedFunc f, Device dev, int number, int repeat, i
                              int limit_zero_time_iterations, int cooldown_interval_ms,
                              int repeats_to_cooldown, PackedFunc f_preproc = nullptr);
 
+/*!
+ * \brief Wrap a timer function to measure the time cost of a given packed function, repeating
+ *  the measurement until the mean cost is known precisely enough.
+ *
+ *  The number of runs of a repeat is calibrated once, so that a repeat lasts at least
+ *  min_repeat_ms and all the repeats run the function the same number of times. The function
+ *  is then measured for at least min_repeat and at most max_repeat repeats, until the standard
+ *  error of the mean cost is below max_relative_error of the mean. The leading repeats which
+ *  are outliers of the others, e.g. from cold caches or clocks ramping up, are discarded.
+ *
+ * \param f The function argument.
+ * \param dev The device.
+ * \param min_repeat The minimum number of repeats kept, at least 2.
+ * \param max_repeat The maximum number of repeats.
+ * \param min_repeat_ms The minimum duration of one repeat in milliseconds.
+ * \param max_relative_error The target standard error of the mean cost, relative to it.
+ * \param cooldown_interval_ms The cooldown interval in milliseconds between the number of repeats
+ *        defined by `repeats_to_cooldown`.
+ * \param repeats_to_cooldown The number of repeats before the cooldown is activated.
+ * \param f_preproc The function to be executed before each repeat.
+ * \return f_timer A timer function, returning the costs of the kept repeats in the format of
+ *  WrapTimeEvaluator.
+ */
+PackedFunc WrapStatisticalTimeEvaluator(PackedFunc f, Device dev, int min_repeat, int max_repeat,
+                                        int min_repeat_ms, double max_relative_error,
+                                        int cooldown_interval_ms, int repeats_to_cooldown,
+                                        PackedFunc f_preproc = nullptr);
+
 }  // namespace profiling
 }  // namespace runtime
 }  // namespace tvm
@@ -58,6 +58,39 @@ enum class Opcode {
   Ret = 2U,
   Goto = 3U,
   If = 4U,
+  AllocStorageTensor = 5U,
+  LoadShapeCall = 6U,
+  LoadShape = 7U,
+  StoreShape = 8U,
+  ComputeShape = 9U,
+  Move = 10U,
+  LoadConst = 11U,
+  MakeTuple = 12U,
+  GetTupleItem = 13U,
+  Kill = 14U,
+};
+
+/*!
+ * \brief The operations of a ComputeShape instruction.
+ *
+ * A ComputeShape instruction runs a postfix program of (operation, operand) pairs over
+ * a small stack of int64 values: kLoad pushes the heap slot given by the operand, kImm
+ * pushes the operand itself, kStore pops the top of the stack into the heap slot given
+ * by the operand, and the arithmetic operations pop two values and push the result.
+ */
+enum class ShapeOp : ExecWord {
+  kLoad = 0,
+  kImm = 1,
+  kStore = 2,
+  kAdd = 3,
+  kSub = 4,
+  kMul = 5,
+  kDiv = 6,
+  kMod = 7,
+  kFloorDiv = 8,
+  kFloorMod = 9,
+  kMin = 10,
+  kMax = 11,
 };
 
 /*! \brief A single virtual machine instruction.
@@ -120,13 +153,40 @@ struct Instruction {
   /*! \brief The destination register. */
   RegName dst;
   union {
-    struct /* Call */ {
+    struct /* Call, LoadShapeCall */ {
       /*! \brief The index into the packed function table. */
       Index func_idx;
       /*! \brief The number of arguments to the packed function. */
       Index num_args;
       /*! \brief The arguments of the packed function. */
       Arg* args;
+      /*!
+       * \brief LoadShapeCall only: the register to load the shape into, the shape heap and
+       * the heap indices of the shape, in this order.
+       */
+      Arg* shape_args;
+    };
+    struct /* AllocStorageTensor */ {
+      /*! \brief The register to hold the allocated storage. */
+      RegName storage;
+      /*!
+       * \brief The size, device index and dtype hint of the storage, followed by the offset,
+       * shape and dtype of the tensor.
+       */
+      Arg* alloc_args;
+    };
+    struct /* LoadShape, StoreShape, ComputeShape */ {
+      /*! \brief The register of the shape heap. */
+      RegName heap;
+      /*! \brief StoreShape only: the register of the shape to store. */
+      RegName shape;
+      /*! \brief The number of words in heap_args. */
+      Index heap_num_args;
+      /*!
+       * \brief The heap indices of the shape for LoadShape and StoreShape, or the
+       * (operation, operand) pairs of the program for ComputeShape.
+       */
+      ExecWord* heap_args;
     };
     struct /* Ret */ {
       /*! \brief The return result. */
@@ -142,6 +202,32 @@ struct Instruction {
       /*! \brief The program counter offset for the false branch. */
       Index false_offset;
     };
+    struct /* Move */ {
+      /*! \brief The register to copy from. */
+      RegName src;
+    };
+    struct /* LoadConst */ {
+      /*! \brief The index into the constant pool. */
+      Index const_idx;
+    };
+    struct /* MakeTuple */ {
+      /*! \brief The number of fields of the tuple. */
+      Index num_fields;
+      /*! \brief The fields of the tuple, registers or constants. */
+      Arg* fields;
+    };
+    struct /* GetTupleItem */ {
+      /*! \brief The register of the tuple. */
+      RegName tuple;
+      /*! \brief The index of the item. */
+      Index item_index;
+    };
+    struct /* Kill */ {
+      /*! \brief The number of registers to release. */
+      Index num_regs;
+      /*! \brief The registers to release. */
+      RegName* regs;
+    };
   };
   /*!
    * \brief Construct a Call instruction.
@@ -171,6 +257,96 @@ struct Instruction {
    * \return The If instruction.
    */
   static Instruction If(RegName cond, Index false_offset);
+  /*!
+   * \brief Construct an AllocStorageTensor instruction, the fusion of a call to
+   * vm.builtin.alloc_storage and a call to vm.builtin.alloc_tensor on the storage.
+   * \param storage The register to hold the allocated storage.
+   * \param alloc_args The size, device index and dtype hint of the storage, followed by the
+   * offset, shape and dtype of the tensor.
+   * \param dst The destination register of the tensor.
+   * \return The AllocStorageTensor instruction.
+   */
+  static Instruction AllocStorageTensor(RegName storage, Arg* alloc_args, RegName dst);
+  /*!
+   * \brief Construct a LoadShapeCall instruction, the fusion of a call to vm.builtin.load_shape
+   * and the call that consumes the loaded shape.
+   * \param func_idx The index of the function to call.
+   * \param num_args The number of arguments.
+   * \param args The input arguments.
+   * \param shape_args The shape register, the shape heap and the heap indices.
+   * \param dst The destination register.
+   * \return The LoadShapeCall instruction.
+   */
+  static Instruction LoadShapeCall(Index func_idx, Index num_args, Arg* args, Arg* shape_args,
+                                   RegName dst);
+  /*!
+   * \brief Construct a LoadShape instruction.
+   * \param heap The register of the shape heap.
+   * \param num_indices The number of dimensions of the shape.
+   * \param indices The heap index of each dimension.
+   * \param dst The destination register of the shape.
+   * \return The LoadShape instruction.
+   */
+  static Instruction LoadShape(RegName heap, Index num_indices, ExecWord* indices, RegName dst);
+  /*!
+   * \brief Construct a StoreShape instruction.
+   * \param shape The register of the shape to store.
+   * \param heap The register of the shape heap.
+   * \param num_indices The number of dimensions of the shape.
+   * \param indices The heap index of each dimension.
+   * \return The StoreShape instruction.
+   */
+  static Instruction StoreShape(RegName shape, RegName heap, Index num_indices,
+                                ExecWord* indices);
+  /*!
+   * \brief Construct a ComputeShape instruction.
+   * \param heap The register of the shape heap.
+   * \param num_words The number of words in the program, twice the number of operations.
+   * \param program The (operation, operand) pairs, see ShapeOp.
+   * \return The ComputeShape instruction.
+   */
+  static Instruction ComputeShape(RegName heap, Index num_words, ExecWord* program);
+  /*!
+   * \brief Construct a Move instruction.
+   * \param src The register to copy from.
+   * \param dst The destination register.
+   * \return The Move instruction.
+   */
+  static Instruction Move(RegName src, RegName dst);
+  /*!
+   * \brief Construct a LoadConst instruction.
+   * \param const_idx The index into the constant pool.
+   * \param dst The destination register.
+   * \return The LoadConst instruction.
+   */
+  static Instruction LoadConst(Index const_idx, RegName dst);
+  /*!
+   * \brief Construct a MakeTuple instruction.
+   * \param num_fields The number of fields.
+   * \param fields The fields of the tuple, registers or constants.
+   * \param dst The destination register.
+   * \return The MakeTuple instruction.
+   */
+  static Instruction MakeTuple(Index num_fields, Arg* fields, RegName dst);
+  /*!
+   * \brief Construct a GetTupleItem instruction.
+   * \param tuple The register of the tuple.
+   * \param index The index of the item.
+   * \param dst The destination register.
+   * \return The GetTupleItem instruction.
+   */
+  static Instruction GetTupleItem(RegName tuple, Index index, RegName dst);
+  /*!
+   * \brief Construct a Kill instruction, which releases the values of dead registers.
+   * \param num_regs The number of registers.
+   * \param regs The registers to release.
+   * \return The Kill instruction.
+   */
+  static Instruction Kill(Index num_regs, RegName* regs);
+  /*! \brief The number of arguments of an AllocStorageTensor instruction. */
+  static constexpr Index kNumAllocArgs = 6;
+  /*! \brief The number of shape arguments of a LoadShapeCall instruction. */
+  static constexpr Index kNumShapeArgs = 3;
 };
 
 }  // namespace relax_vm
@@ -0,0 +1,120 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/runtime/relax_vm/compiled_function.h
+ * \brief The interface between the VM and the Relax functions whose bytecode is compiled to
+ * native code.
+ *
+ * A compiled function is a PackedFunc of the kernel library named by CompiledFunctionSymbol.
+ * Its first argument is the CompiledFunctionContext of the calling VM, followed by the
+ * arguments of the Relax function. This header is included by the generated source, so it only
+ * relies on the inline parts of the runtime.
+ */
+#ifndef TVM_RUNTIME_RELAX_VM_COMPILED_FUNCTION_H_
+#define TVM_RUNTIME_RELAX_VM_COMPILED_FUNCTION_H_
+
+#include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/container/adt.h>
+#include <tvm/runtime/container/shape_tuple.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
+
+#include <cctype>
+#include <string>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*!
+ * \brief The entries of a VM a compiled function calls back into, for what the bytecode
+ * delegates to the VM rather than to a PackedFunc.
+ */
+struct CompiledFunctionContext {
+  /*! \brief The VM, passed as the VM register to the builtins. */
+  void* vm;
+  /*! \brief Get an entry of the function table of the VM, resolving it on first use. */
+  const PackedFunc* (*get_func)(void* vm, int64_t func_idx);
+  /*! \brief Get a constant of the executable, copying it to its device on first use. */
+  const TVMRetValue* (*get_constant)(void* vm, int64_t const_idx);
+  /*! \brief Allocate a storage and a tensor in it, as the AllocStorageTensor instruction. */
+  void (*alloc_storage_tensor)(void* vm, const TVMRetValue& size, int64_t device_index,
+                               const TVMRetValue& dtype_hint, int64_t offset,
+                               const TVMRetValue& shape, const TVMRetValue& dtype,
+                               TVMRetValue* storage, TVMRetValue* tensor);
+  /*! \brief Read the integer held by a scalar tensor, on any device. */
+  int64_t (*load_scalar_int)(void* vm, const TVMRetValue& cond);
+};
+
+/*!
+ * \brief The symbol of the compiled code of a Relax function in the kernel library.
+ * \param func_name The name of the Relax function.
+ * \return The symbol, in which the characters invalid in a C identifier are replaced by '_'.
+ */
+inline std::string CompiledFunctionSymbol(const std::string& func_name) {
+  std::string symbol = "__tvm_vm_compiled_" + func_name;
+  for (char& c : symbol) {
+    if (!std::isalnum(static_cast<unsigned char>(c))) c = '_';
+  }
+  return symbol;
+}
+
+/*!
+ * \brief Get the slots of the shape heap held by a register.
+ * \param heap The register holding the heap.
+ * \param min_size The number of slots accessed, checked against the size of the heap.
+ * \return The slots.
+ */
+inline int64_t* CompiledShapeHeap(const TVMRetValue& heap, int64_t min_size) {
+  DLTensor* tensor = heap;
+  ICHECK_LE(min_size, tensor->shape[0]) << "The shape heap is smaller than its accesses";
+  return reinterpret_cast<int64_t*>(static_cast<char*>(tensor->data) + tensor->byte_offset);
+}
+
+/*! \brief Truncated division of the shape computations. */
+inline int64_t CompiledShapeDiv(int64_t a, int64_t b) {
+  ICHECK_NE(b, 0) << "Division by zero in shape computation";
+  return a / b;
+}
+
+/*! \brief Truncated modulo of the shape computations. */
+inline int64_t CompiledShapeMod(int64_t a, int64_t b) {
+  ICHECK_NE(b, 0) << "Division by zero in shape computation";
+  return a % b;
+}
+
+/*! \brief Floor division of the shape computations, rounding towards negative infinity. */
+inline int64_t CompiledShapeFloorDiv(int64_t a, int64_t b) {
+  ICHECK_NE(b, 0) << "Division by zero in shape computation";
+  int64_t q = a / b;
+  return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+}
+
+/*! \brief Floor modulo of the shape computations, of the sign of the divisor. */
+inline int64_t CompiledShapeFloorMod(int64_t a, int64_t b) {
+  return a - CompiledShapeFloorDiv(a, b) * b;
+}
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_RELAX_VM_COMPILED_FUNCTION_H_
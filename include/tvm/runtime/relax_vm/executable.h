@@ -24,9 +24,12 @@
 #define TVM_RUNTIME_RELAX_VM_EXECUTABLE_H_
 
 #include <tvm/runtime/container/closure.h>
+#include <tvm/runtime/container/shape_tuple.h>
+#include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/object.h>
 #include <tvm/runtime/registry.h>
 
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -127,6 +130,11 @@ class Executable : public runtime::ModuleNode {
   String AsPython() const;
   /*!
    * \brief Write the Executable to the binary stream in serialized form.
+   *
+   * The header is followed by a table of the offsets, sizes and checksums of the global,
+   * constant, packed function names and code sections, so that each of them can be located,
+   * verified or rewritten on its own.
+   *
    * \param stream The binary stream to save the executable to.
    */
   void SaveToBinary(dmlc::Stream* stream) final;
@@ -138,6 +146,10 @@ class Executable : public runtime::ModuleNode {
   static Module LoadFromBinary(void* stream);
   /*!
    * \brief Write the Executable to the provided path as a file containing its serialized content.
+   *
+   * The contents of the NDArray constants are stored after the other sections, each aligned to
+   * kAllocAlignment from a page boundary, so that LoadFromFile can map them instead of reading.
+   *
    * \param file_name The name of the file to write the serialized data to.
    * \param format The target format of the saved file.
    */
@@ -146,8 +158,17 @@ class Executable : public runtime::ModuleNode {
    * \brief Load Executable from the file.
    * \param file_name The path of the file that load the executable from.
    * \return The loaded executable, in the form of a `runtime::Module`.
+   * \note The file is memory mapped when supported, and the NDArray constants are views of the
+   *       mapping, which stays alive as long as they do.
    */
   static Module LoadFromFile(const std::string& file_name);
+  /*!
+   * \brief Read the section table of an executable file, without loading its sections.
+   * \param file_name The path of the file saved by SaveToFile or SaveToBinary.
+   * \return The name, the offset in the file, the size and the checksum of each section, as a
+   *         JSON list.
+   */
+  static String SectionTable(const std::string& file_name);
 
   /*! \brief The virtual machine's function table. */
   std::vector<VMFunction> global_funcs;
@@ -155,6 +176,18 @@ class Executable : public runtime::ModuleNode {
   std::unordered_map<std::string, Index> global_map;
   /*! \brief The global constant pool. */
   std::vector<TVMRetValue> constants;
+  /*!
+   * \brief The index of the VM device each NDArray constant is used on, -1 for the host,
+   * recorded at compile time from the devices of the calls using it.
+   */
+  std::vector<Index> constant_devices;
+  /*!
+   * \brief The codec compressing the NDArray constants when the executable is saved, a
+   * ConstantCodec of src/runtime/relax_vm/constant_codec.h. The loaded executables keep none.
+   */
+  int constant_codec{0};
+  /*! \brief The minimum size in bytes of the NDArray constants compressed by constant_codec. */
+  int64_t constant_codec_min_bytes{0};
   /*! \brief The name of packed functions. */
   std::vector<std::string> func_names;
   /*!
@@ -172,6 +205,23 @@ class Executable : public runtime::ModuleNode {
   const char* type_key() const final { return "relax.Executable"; }
 
  private:
+  /*!
+   * \brief Serialize the header, the section table and the sections.
+   * \param constant_data Where to store the contents of the NDArray constants out of the
+   *        constant section, see SaveConstantSection.
+   * \return The serialized executable.
+   */
+  std::string SaveSections(std::string* constant_data);
+  /*!
+   * \brief Load an executable serialized by SaveSections, checking the section checksums.
+   * \param data The serialized executable.
+   * \param size The size of the serialized executable.
+   * \param fload_data Make the NDArray constants stored out of the constant section.
+   * \return The loaded executable.
+   */
+  static ObjectPtr<Executable> LoadSections(
+      char* data, size_t size,
+      const std::function<NDArray(ShapeTuple, DLDataType, uint64_t)>& fload_data = nullptr);
   /*!
    * \brief Save the globals.
    * \param strm The input stream.
@@ -180,8 +230,10 @@ class Executable : public runtime::ModuleNode {
   /*!
    * \brief Save the constant pool.
    * \param strm The input stream.
+   * \param data If defined, the contents of the NDArray constants are appended to it instead,
+   *        aligned to kAllocAlignment, and the stream only refers to their offsets.
    */
-  void SaveConstantSection(dmlc::Stream* strm);
+  void SaveConstantSection(dmlc::Stream* strm, std::string* data = nullptr);
   /*!
    * \brief Save the instructions.
    * \param strm The input stream.
@@ -200,8 +252,12 @@ class Executable : public runtime::ModuleNode {
   /*!
    * \brief Load the constant pool.
    * \param strm The input stream.
+   * \param fload_data Make an NDArray constant from the shape, the data type and the offset of
+   *        its contents saved out of the stream, required if any.
    */
-  void LoadConstantSection(dmlc::Stream* strm);
+  void LoadConstantSection(
+      dmlc::Stream* strm,
+      const std::function<NDArray(ShapeTuple, DLDataType, uint64_t)>& fload_data = nullptr);
   /*!
    * \brief Load the instructions.
    * \param strm The input stream.
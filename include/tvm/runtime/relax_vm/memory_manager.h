@@ -27,9 +27,11 @@
 #include <tvm/runtime/c_runtime_api.h>
 #include <tvm/runtime/ndarray.h>
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -49,8 +51,62 @@ struct Buffer {
 enum AllocatorType {
   kNaive = 1,
   kPooled,
+  kBestFit,
+  /*! \brief The pooled allocator owned by each VM, which allocates without locks. */
+  kLocalPooled,
+  /*!
+   * \brief The pooled allocator owned by each VM, which keeps the memory within a budget and
+   * spills the intermediate tensors of the VM to the host when the budget is exhausted.
+   */
+  kBudgeted,
+  /*!
+   * \brief The allocator owned by each VM, which leaves the caching to the stream ordered
+   * allocation of the device, not synchronizing the device on the misses of its pool.
+   */
+  kStreamOrdered,
+  /*!
+   * \brief The allocator owned by each VM for a memory scope of a device other than its global
+   * memory, e.g. the VTCM of Hexagon, created by the VM for the scopes it allocates from.
+   */
+  kScoped,
 };
 
+/*! \brief The counters of an allocator. */
+struct AllocatorStats {
+  /*! \brief The bytes of the buffers handed out and not freed yet. */
+  size_t bytes_in_use{0};
+  /*! \brief The bytes of the freed buffers kept by the allocator for reuse. */
+  size_t bytes_cached{0};
+  /*! \brief The peak of bytes_in_use. */
+  size_t peak_bytes_in_use{0};
+  /*! \brief The size of the largest cached buffer. */
+  size_t largest_cached_block{0};
+  /*! \brief The number of allocation requests. */
+  size_t num_allocs{0};
+  /*! \brief The number of allocation requests served from the cached buffers. */
+  size_t num_cache_hits{0};
+  /*! \brief The number of allocations from the device API. */
+  size_t num_device_allocs{0};
+  /*! \brief The number of frees to the device API. */
+  size_t num_device_frees{0};
+  /*! \brief The budget of the reserved bytes, 0 for no budget. */
+  size_t memory_budget{0};
+  /*! \brief The number of cached buffers released to stay within the budget. */
+  size_t num_evictions{0};
+  /*! \brief The number of buffers in use copied to the host to stay within the budget. */
+  size_t num_spills{0};
+  /*! \brief The bytes of the spilled buffers. */
+  size_t bytes_spilled{0};
+  /*! \brief The number of spilled buffers copied back to the device. */
+  size_t num_reloads{0};
+};
+
+/*!
+ * \brief Format the counters of an allocator as a JSON object, including the hit rate and the
+ * fragmentation derived from them.
+ */
+std::string AllocatorStatsToJSON(const AllocatorStats& stats);
+
 class Allocator {
  public:
   explicit Allocator(AllocatorType type) : type_(type) {}
@@ -75,6 +131,8 @@ class Allocator {
    *  \param buffer The buffer to free.
    */
   virtual void Free(const Buffer& buffer) = 0;
+  /*! \brief Return the counters of the allocator. */
+  virtual AllocatorStats Stats() const = 0;
 
  private:
   AllocatorType type_;
@@ -96,6 +154,13 @@ class MemoryManager {
    * \return The memory allocator.
    */
   static Allocator* GetAllocator(Device dev);
+  /*!
+   * \brief Create an allocator that is not registered in the memory manager.
+   * \param dev The TVM device
+   * \param type The allocator type
+   * \return The memory allocator.
+   */
+  static std::unique_ptr<Allocator> CreateAllocator(Device dev, AllocatorType type);
 
  private:
   MemoryManager() {}
@@ -105,11 +170,111 @@ class MemoryManager {
   std::unordered_map<Device, std::unique_ptr<Allocator>> allocators_;
 };
 
+/*!
+ * \brief A free list of fixed-size host memory blocks.
+ *
+ * Pop is only called by the owner of the list, while Push can be called from any thread:
+ * the pushed blocks are linked in place onto an atomic stack, which the owner takes as a
+ * whole once its own blocks run out.
+ */
+class BlockFreeList {
+ public:
+  explicit BlockFreeList(size_t block_size)
+      : block_size_(block_size < sizeof(Block) ? sizeof(Block) : block_size) {}
+
+  ~BlockFreeList() {
+    Release(local_);
+    Release(remote_.exchange(nullptr, std::memory_order_acquire));
+  }
+
+  /*! \brief Get a block, only called by the owner. */
+  void* Pop() {
+    if (local_ == nullptr) {
+      local_ = remote_.exchange(nullptr, std::memory_order_acquire);
+      if (local_ == nullptr) return ::operator new(block_size_);
+    }
+    Block* block = local_;
+    local_ = block->next;
+    return block;
+  }
+
+  /*! \brief Return a block to the list, can be called from any thread. */
+  void Push(void* ptr) {
+    Block* block = static_cast<Block*>(ptr);
+    block->next = remote_.load(std::memory_order_relaxed);
+    while (!remote_.compare_exchange_weak(block->next, block, std::memory_order_release,
+                                          std::memory_order_relaxed)) {
+    }
+  }
+
+ private:
+  struct Block {
+    Block* next;
+  };
+
+  static void Release(Block* block) {
+    while (block != nullptr) {
+      Block* next = block->next;
+      ::operator delete(block);
+      block = next;
+    }
+  }
+
+  size_t block_size_;
+  Block* local_{nullptr};
+  std::atomic<Block*> remote_{nullptr};
+};
+
+class StorageObj;
+
+/*!
+ * \brief The pool of the host-side headers of the storages and of the arrays allocated from
+ * them, owned by a VM, so that the steady state of the VM does not allocate the headers.
+ *
+ * The headers are only allocated by the owner and can be released from any thread. Each
+ * header holds a reference to the pool, which lets the arrays outlive the VM.
+ */
+class HeaderPool {
+ public:
+  /*! \brief Create a pool, the caller owns a reference to it. */
+  static HeaderPool* Create() { return new HeaderPool(); }
+
+  void IncRef() { ref_counter_.fetch_add(1, std::memory_order_relaxed); }
+
+  void DecRef() {
+    if (ref_counter_.fetch_sub(1, std::memory_order_release) == 1) {
+      std::atomic_thread_fence(std::memory_order_acquire);
+      delete this;
+    }
+  }
+
+  /*! \brief Make a storage object with the header from the pool. */
+  ObjectPtr<StorageObj> MakeStorage();
+
+  /*! \brief Make an array header from the pool for an array allocated from the storage. */
+  runtime::NDArray::Container* MakeContainer(StorageObj* storage, ShapeTuple shape,
+                                             DLDataType dtype);
+
+ private:
+  friend class PooledStorageAllocator;
+
+  HeaderPool();
+  static void ContainerDeleter(Object* obj);
+
+  std::atomic<int64_t> ref_counter_{1};
+  BlockFreeList storages_;
+  BlockFreeList containers_;
+};
+
 /*! \brief An object representing a storage allocation. */
 class StorageObj : public Object {
  public:
   /*! \brief The index into the VM function table. */
   Buffer buffer;
+  /*! \brief The allocator owning the buffer, the global allocator of the device if null. */
+  std::shared_ptr<Allocator> allocator;
+  /*! \brief The pool of the storage header, which also holds the array headers if defined. */
+  HeaderPool* header_pool{nullptr};
 
   /*! \brief Allocate an NDArray from a given piece of storage. */
   runtime::NDArray AllocNDArray(uint64_t offset, ShapeTuple shape, DLDataType dtype);
@@ -118,13 +283,20 @@ class StorageObj : public Object {
   static void Deleter(Object* ptr);
 
   ~StorageObj() {
-    auto alloc = MemoryManager::Global()->GetAllocator(buffer.device);
-    alloc->Free(buffer);
+    if (allocator != nullptr) {
+      allocator->Free(buffer);
+    } else {
+      MemoryManager::Global()->GetAllocator(buffer.device)->Free(buffer);
+    }
   }
 
   static constexpr const uint32_t _type_index = runtime::TypeIndex::kDynamic;
   static constexpr const char* _type_key = "relax.Storage";
   TVM_DECLARE_FINAL_OBJECT_INFO(StorageObj, Object);
+
+ private:
+  // the array deleter of the pool releases the reference of the array to the storage
+  friend class HeaderPool;
 };
 
 /*! \brief reference to storage. */
@@ -23,11 +23,20 @@
 #ifndef TVM_RUNTIME_RELAX_VM_VM_H_
 #define TVM_RUNTIME_RELAX_VM_VM_H_
 
+#include <tvm/runtime/profiling.h>
+
+#include <atomic>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "./bytecode.h"
+#include "./compiled_function.h"
 #include "./executable.h"
 #include "./memory_manager.h"
 
@@ -40,6 +49,94 @@ namespace relax_vm {
  */
 using RegType = TVMRetValue;
 
+/*!
+ * \brief The constant pool of a VM, shared by all the sessions created from it.
+ *
+ * Each NDArray constant stays on the host until an instruction first reads it, and is
+ * then copied once to the device the compiler placed it on.
+ */
+class ConstantPool {
+ public:
+  /*!
+   * \brief Create the pool.
+   * \param constants The constants of the executable.
+   * \param devices The device of each constant, only used for NDArray constants.
+   */
+  ConstantPool(std::vector<TVMRetValue> constants, std::vector<Device> devices)
+      : values_(constants),
+        hosts_(std::move(constants)),
+        devices_(std::move(devices)),
+        resident_(new std::atomic<bool>[values_.size()]) {
+    ICHECK_EQ(values_.size(), devices_.size());
+    for (size_t i = 0; i < values_.size(); ++i) {
+      resident_[i].store(values_[i].type_code() != kTVMNDArrayHandle, std::memory_order_relaxed);
+    }
+  }
+  ~ConstantPool();
+  /*!
+   * \brief Take the device copies of the NDArray constants from a process-wide cache keyed by
+   *        their contents, so that the pools of the executables with identical constants share
+   *        one copy per device, released when the last of them is destroyed.
+   * \note It must be enabled before any constant is uploaded. The kernels must not write to the
+   *       shared constants.
+   */
+  void EnableSharing() { share_ = true; }
+  /*!
+   * \brief Replace the NDArray constants placed on the CPU by copies allocated by the calling
+   *        thread, such as a replica on the NUMA node its CPU memory is placed on.
+   * \note It must be called before the VM runs, and not with the sharing enabled.
+   */
+  void Localize();
+  /*!
+   * \brief Take the device copies of the constants of another pool whose contents, compared by
+   *        fingerprint then byte by byte, and devices equal the ones of constants of this pool,
+   *        such as the pool of the executable a VM is reloaded from.
+   * \param prev The other pool, whose constants resident on their devices are reused.
+   * \return The number of the reused constants and their bytes.
+   * \note It must be called before any constant of this pool is uploaded, with the sharing
+   *       enabled in both pools or in none.
+   */
+  std::pair<size_t, size_t> ReuseResident(ConstantPool* prev);
+  /*!
+   * \brief Copy all the NDArray constants to their devices ahead of their first use.
+   * \return The number of the constants copied and their bytes.
+   */
+  std::pair<size_t, size_t> UploadAll();
+  /*! \return Whether the device copies are taken from the process-wide cache. */
+  bool sharing() const { return share_; }
+  /*!
+   * \brief Get a constant, copying it to its device on first use.
+   * \param index The index of the constant.
+   * \return The constant.
+   */
+  const TVMRetValue& Get(Index index) {
+    if (!resident_[index].load(std::memory_order_acquire)) {
+      Upload(index);
+    }
+    return values_[index];
+  }
+  /*! \return The number of constants. */
+  size_t size() const { return values_.size(); }
+
+ private:
+  void Upload(Index index);
+
+  /*! \brief The constants, on their devices once resident. */
+  std::vector<TVMRetValue> values_;
+  /*! \brief The constants of the executable, which the contents of values_ are compared by. */
+  std::vector<TVMRetValue> hosts_;
+  /*! \brief The device of each constant. */
+  std::vector<Device> devices_;
+  /*! \brief Whether each constant is resident on its device. */
+  std::unique_ptr<std::atomic<bool>[]> resident_;
+  /*! \brief Guards the uploads of the constants. */
+  std::mutex mutex_;
+  /*! \brief Whether the device copies are taken from the process-wide cache. */
+  bool share_{false};
+  /*! \brief The constants whose device copy is held from the process-wide cache. */
+  std::vector<Index> shared_;
+};
+
 /*!
  * \brief A representation of a stack frame.
  *
@@ -61,9 +158,45 @@ struct VMFrame {
   std::vector<TVMValue> call_arg_values;
   /*! \brief Temporary argument tcode stack for packed func call. */
   std::vector<int> call_arg_tcodes;
+  /*!
+   * \brief The int64 shape heap of the function, kept with the frame so that it is reused
+   *        by later calls with the same heap size.
+   */
+  NDArray shape_heap;
+  /*! \brief Temporary value stack for the programs of ComputeShape instructions. */
+  std::vector<int64_t> shape_stack;
 
   VMFrame(Index pc, Index register_file_size)
       : return_pc(pc), register_file(register_file_size), caller_return_register(0) {}
+
+  /*!
+   * \brief Reset the frame so that it can be reused by another function call.
+   * \param pc The return program counter.
+   * \param register_file_size The register file size of the callee.
+   * \note The register file keeps its capacity, so no allocation happens when the
+   *       callee does not need more registers than previous users of the frame.
+   */
+  void Reset(Index pc, Index register_file_size) {
+    return_pc = pc;
+    caller_return_register = 0;
+    register_file.resize(register_file_size);
+  }
+
+  /*! \brief Release the values held by the registers, keeping the storage. */
+  void Clear() { register_file.clear(); }
+};
+
+/*!
+ * \brief The strategy used by the VM to dispatch instructions.
+ */
+enum class DispatchMode : int {
+  /*! \brief Decode each instruction through a switch in the dispatch loop. */
+  kSwitch = 0,
+  /*!
+   * \brief Jump directly from the handler of one instruction to the next through
+   *        a table of label addresses (falls back to kSwitch without computed goto).
+   */
+  kThreaded = 1,
 };
 
 /*!
@@ -90,6 +223,25 @@ class VirtualMachine : public runtime::ModuleNode {
    * \param exec The executable.
    */
   void LoadExecutable(ObjectPtr<Executable> exec);
+  /*!
+   * \brief Replace the executable of an initialized VM, such as a new build of its model.
+   *
+   * The new program is prepared aside, then swapped in at once. The NDArray constants of the
+   * new executable equal to constants of the previous one already on their devices reuse their
+   * device copies, so that weights unchanged by a rebuild are neither copied again nor held
+   * twice. The sessions created before keep running the previous program, whose constants are
+   * freed with the last of them, and the sessions created after run the new one.
+   *
+   * \param exec The new executable.
+   * \param upload_constants Whether the other constants are copied to their devices before the
+   *        swap rather than on first use, so that the first calls run without uploads.
+   * \return The number of the constants, the reused ones and their bytes, and the uploaded ones
+   *         and their bytes, as a JSON string.
+   * \note The VM itself must not run a call meanwhile. The inputs and outputs of the stateful
+   *       calls, the captured graphs, the saved closures and the shape specializations of the
+   *       previous program are dropped.
+   */
+  std::string HotReload(ObjectPtr<Executable> exec, bool upload_constants);
   /*!
    * \brief Get a PackedFunc from module.
    *
@@ -109,7 +261,84 @@ class VirtualMachine : public runtime::ModuleNode {
    */
   PackedFunc GetFunction(const std::string& name, const ObjectPtr<Object>& sptr_to_self) final;
 
-  ~VirtualMachine() {}
+  /*!
+   * \brief Create a new session of the virtual machine.
+   *
+   * The session shares the loaded executable, the decoded instructions, the devices,
+   * the global allocators and the constant pool with this VM, while owning its
+   * own execution state (call frames, inputs, outputs, saved closures and local pooled
+   * allocators). Sessions
+   * can run concurrently on different threads, and each constant is copied to its device
+   * only once whichever session uses it first.
+   *
+   * \return The new session.
+   * \note The VM must be initialized before sessions are created from it.
+   */
+  ObjectPtr<VirtualMachine> CreateSession() const;
+  /*!
+   * \brief Get a function from the function table of the loaded executable.
+   *
+   * The functions are resolved lazily: the first call with an index looks its name up in the
+   * kernel library, the global PackedFunc registry and the Relax functions of the executable,
+   * in this order, and caches the result in the table. Later calls return the cached function.
+   *
+   * \param func_idx The index of the function in the executable's function table.
+   * \return The function.
+   * \throws Error when the index is out of the table range, or when the name cannot be resolved.
+   *  A failed resolution caches nothing, so the next call with the index looks the name up again.
+   */
+  const PackedFunc& GetFuncFromTable(Index func_idx);
+
+  /*!
+   * \brief Get a stream of the first device, creating it on first use.
+   * \param stream_index The index of the stream, 0 is the default stream of the device.
+   * \return The stream handle.
+   */
+  TVMStreamHandle GetStream(int64_t stream_index);
+
+  /*!
+   * \brief Allocate a storage with the allocator of a device.
+   * \param size The size of the storage in bytes.
+   * \param device_index The index of the device in devices, -1 for the host.
+   * \param dtype_hint The data type hint for the allocator.
+   * \param mem_scope The memory scope of the storage, empty or "global" for the global memory.
+   * \return The allocated storage.
+   */
+  Storage AllocStorage(int64_t size, Index device_index, DLDataType dtype_hint,
+                       const std::string& mem_scope = "");
+
+  /*!
+   * \brief Get a storage that the VM keeps across calls, allocating it on first use.
+   * \param size The size of the storage in bytes.
+   * \param device_index The index of the device in devices, -1 for the host.
+   * \param dtype_hint The data type hint for the allocator.
+   * \param slot The slot of the storage in the VM.
+   * \param mem_scope The memory scope of the storage, empty or "global" for the global memory.
+   * \return The storage, or a new one if the kept storage is still referenced, e.g. by an
+   *         outer call of a recursive function.
+   */
+  Storage AllocStaticStorage(int64_t size, Index device_index, DLDataType dtype_hint,
+                             Index slot, const std::string& mem_scope = "");
+
+  /*!
+   * \brief Keep the memory of a device using the budgeted allocator within a budget.
+   * \param device_index The index of the device in devices.
+   * \param budget The bytes the allocator can reserve, 0 for no budget.
+   * \param spill_threshold The minimum size of the storages the VM copies to the host when the
+   *        tensors in use exceed the budget, negative to never spill.
+   * \note The storages are only spilled from non-CPU devices, to pinned memory if the device has
+   *       a pinned host memory.
+   */
+  void SetMemoryBudget(Index device_index, int64_t budget, int64_t spill_threshold);
+
+  /*!
+   * \brief Get the shape heap of the current function on the host.
+   * \param size The number of slots of the heap.
+   * \return The shape heap.
+   */
+  NDArray AllocShapeHeap(int64_t size);
+
+  ~VirtualMachine();
 
   const char* type_key() const final { return "relax.VirtualMachine"; }
 
@@ -117,8 +346,28 @@ class VirtualMachine : public runtime::ModuleNode {
   Optional<runtime::Module> lib;
   /*! \brief The memory allocators. */
   std::vector<Allocator*> allocators;
+  /*!
+   * \brief The allocators owned by this VM, null for the devices using the global allocator.
+   * The storages allocated from them keep them alive after the VM is destroyed.
+   */
+  std::vector<std::shared_ptr<Allocator>> owned_allocators;
   /*! \brief Runtime physical device list. */
   std::vector<Device> devices;
+  /*!
+   * \brief When defined, the storage allocated by the VM is appended to it and kept alive,
+   *        so that a captured CUDA graph can be replayed on the same memory.
+   */
+  std::vector<ObjectRef>* retained_storage{nullptr};
+  /*!
+   * \brief The store of the params kept out of the executable, loaded by vm.builtin.param_load.
+   *        It is shared with the sessions.
+   */
+  ObjectRef param_store;
+  /*!
+   * \brief The communicator of the rank of the VM in its group, used by the collectives. It is
+   *        not shared with the sessions, whose collectives would not match the other ranks.
+   */
+  ObjectRef communicator;
 
  protected:
   /*!
@@ -144,7 +393,60 @@ class VirtualMachine : public runtime::ModuleNode {
    * \param reg The register to read from.
    * \return The value of the register.
    */
-  inline RegType ReadRegister(VMFrame* frame, RegName reg) const;
+  inline RegType ReadRegister(VMFrame* frame, RegName reg);
+  /*!
+   * \brief Reset the function table of the loaded executable, and look up the compiled code
+   *        of its Relax functions in the kernel library.
+   * \note The functions are resolved when they are first called, so that the kernels of the
+   *       entry points that are never run are never looked up, nor loaded onto the devices
+   *       by the modules loading their kernels lazily.
+   */
+  void InitFuncTable();
+  /*!
+   * \brief Create the constant pool of an executable, placing its NDArray constants on the
+   *        devices of the VM they are used on.
+   * \param exec The executable.
+   * \return The pool, whose constants are only copied to their devices on first use.
+   */
+  std::shared_ptr<ConstantPool> CreateConstantPool(const Executable& exec) const;
+  /*!
+   * \brief Report the functions of the function table resolved so far, as a JSON string.
+   * \return The number of functions, the number of resolved ones with their names, and the
+   *         time spent resolving them.
+   */
+  std::string FuncTableStats() const;
+  /*!
+   * \brief Resolve the functions of the function table ahead of their first call.
+   * \param func_names The names of the functions, the unknown ones being ignored.
+   */
+  void PreloadFunctions(const std::vector<std::string>& func_names);
+  /*!
+   * \brief Allocate and free a set of buffers on a device, so that its allocator caches them.
+   * \param device_index The index of the device.
+   * \param sizes The sizes of the buffers, all allocated before any of them is freed.
+   * \note The buffers are only kept by the allocators caching the freed ones.
+   */
+  void ReserveStorage(Index device_index, const std::vector<int64_t>& sizes);
+  /*!
+   * \brief Count a call of a function by the shapes of its arguments, and get the variant of the
+   *        function specialized to them, if any.
+   * \param func_name The name of the function.
+   * \param args The arguments of the call.
+   * \return The specialized variant, or nullptr to run the function itself.
+   * \note The specialization callback is called when the calls of a shape signature reach the
+   *       threshold.
+   */
+  PackedFunc LookupSpecialization(const std::string& func_name, TVMArgs args);
+  /*! \return The calls of each function by shape signature, as a JSON string. */
+  std::string SpecializationStats();
+  /*!
+   * \brief Look up a function by name in the kernel library, the global registry
+   *        and the Relax functions of the executable, in that order.
+   * \param func_name The function name.
+   * \param gf_idx Set to the index of the Relax function when it resolves to one, -1 otherwise.
+   * \return The function, or PackedFunc(nullptr) if it cannot be found.
+   */
+  PackedFunc ResolvePackedFunc(const std::string& func_name, Index* gf_idx = nullptr);
   /*!
    * \brief Prepare function table so that func_table_[func_index] is populated.
    * \param func_index The function index.
@@ -157,20 +459,113 @@ class VirtualMachine : public runtime::ModuleNode {
    * \return The object representing the result.
    */
   RegType Invoke(Index fidx, const std::vector<RegType>& args);
+  /*!
+   * \brief Invoke the compiled code of a VM function, which runs without the dispatch loop.
+   * \param fidx The function index.
+   * \param args The arguments to the function.
+   * \return The object representing the result.
+   */
+  RegType InvokeCompiled(Index fidx, const std::vector<RegType>& args);
   /*!
    * \brief Read a VM register and cast it to int64_t.
    * \param reg The register to read from.
    * \return The read scalar.
    */
-  int64_t LoadScalarInt(RegName reg) const;
+  int64_t LoadScalarInt(RegName reg);
+  /*!
+   * \brief Cast a scalar tensor to int64_t.
+   * \param obj The scalar tensor, on any device.
+   * \return The scalar.
+   */
+  int64_t ScalarToInt(const RegType& obj);
   /*! \brief Run VM dispatch loop. */
   void RunLoop();
+  /*! \brief Run VM dispatch loop using threaded dispatch. */
+  void RunLoopThreaded();
   /*!
    * \brief Run call instruction.
    * \param curr_frame The current frame.
    * \param inst The call instruction.
    */
   inline void RunInstrCall(VMFrame* curr_frame, Instruction inst);
+  /*!
+   * \brief Run a call instruction whose result is returned right away by reusing the current
+   *        frame for the callee, when the callee is the bytecode of a Relax function.
+   * \param curr_frame The current frame, which becomes the frame of the callee.
+   * \param inst The call instruction.
+   * \return Whether the call was run as a tail call, which continues at the callee's first
+   *         instruction. The call is left to RunInstrCall otherwise.
+   */
+  inline bool RunInstrTailCall(VMFrame* curr_frame, const Instruction& inst);
+  /*!
+   * \brief Run a fused alloc_storage and alloc_tensor instruction.
+   * \param curr_frame The current frame.
+   * \param inst The AllocStorageTensor instruction.
+   */
+  inline void RunInstrAllocStorageTensor(VMFrame* curr_frame, const Instruction& inst);
+  /*!
+   * \brief Run a fused load_shape and call instruction.
+   * \param curr_frame The current frame.
+   * \param inst The LoadShapeCall instruction.
+   */
+  inline void RunInstrLoadShapeCall(VMFrame* curr_frame, const Instruction& inst);
+  /*!
+   * \brief Run a LoadShape instruction.
+   * \param curr_frame The current frame.
+   * \param inst The LoadShape instruction.
+   */
+  inline void RunInstrLoadShape(VMFrame* curr_frame, const Instruction& inst);
+  /*!
+   * \brief Run a StoreShape instruction.
+   * \param curr_frame The current frame.
+   * \param inst The StoreShape instruction.
+   */
+  inline void RunInstrStoreShape(VMFrame* curr_frame, const Instruction& inst);
+  /*!
+   * \brief Run a ComputeShape instruction.
+   * \param curr_frame The current frame.
+   * \param inst The ComputeShape instruction.
+   */
+  inline void RunInstrComputeShape(VMFrame* curr_frame, const Instruction& inst);
+  /*!
+   * \brief Run a MakeTuple instruction.
+   * \param curr_frame The current frame.
+   * \param inst The MakeTuple instruction.
+   */
+  inline void RunInstrMakeTuple(VMFrame* curr_frame, const Instruction& inst);
+  /*!
+   * \brief Run a GetTupleItem instruction.
+   * \param curr_frame The current frame.
+   * \param inst The GetTupleItem instruction.
+   */
+  inline void RunInstrGetTupleItem(VMFrame* curr_frame, const Instruction& inst);
+  /*!
+   * \brief Run a Kill instruction.
+   * \param curr_frame The current frame.
+   * \param inst The Kill instruction.
+   */
+  inline void RunInstrKill(VMFrame* curr_frame, const Instruction& inst);
+  /*!
+   * \brief Read a register or constant argument of an instruction.
+   * \param curr_frame The current frame.
+   * \param arg The argument, which must not be an immediate.
+   * \return The value of the argument.
+   */
+  inline RegType ReadArg(VMFrame* curr_frame, Instruction::Arg arg);
+  /*!
+   * \brief Copy the storages only referenced by the registers of the call stack to the host,
+   *        the least recently defined first, until the given bytes are freed.
+   * \param device_index The index of the device in devices.
+   * \param nbytes The bytes to free.
+   */
+  void SpillStorages(Index device_index, size_t nbytes);
+  /*!
+   * \brief Copy the storage of a register value back to the device if it has been spilled.
+   * \param reg The register value.
+   */
+  void ReloadSpilled(const RegType& reg);
+  /*! \brief Drop the spilled storages that are no longer referenced by any register. */
+  void PruneSpilled();
 
   /*!
    * \brief Set inputs to a function.
@@ -178,11 +573,15 @@ class VirtualMachine : public runtime::ModuleNode {
    * \param args args[offset:] are arguments to the function. If the arguments are not of the
    * correct device for the function, they will be copied to the device.
    * \param offset Starting offset of the arguments in \p args.
+   * \param borrow Whether to borrow the memory of the tensor arguments instead of copying them,
+   * see BorrowInputTensorWithIndex.
    * \note This interface works when using VM over RPC by internally converting NDArray in
    * the arguments to DLTensor, which is supported in RPC where remote could only have a minimal C
    * runtime.
+   * \note The binding is updated in place: an argument that still refers to the memory bound by
+   * the previous call is not converted again.
    */
-  void SetInput(std::string func_name, TVMArgs args, int offset);
+  void SetInput(std::string func_name, TVMArgs args, int offset, bool borrow = false);
 
   /*!
    * \brief Set a function argument with a given index to an input tensor.
@@ -195,6 +594,76 @@ class VirtualMachine : public runtime::ModuleNode {
   void SetInputTensorWithIndex(std::vector<RegType>& func_args, const TVMArgValue& inp_tensor,
                                int index, Device dev);
 
+  /*!
+   * \brief Set a function argument with a given index to an input tensor, copied to \p dev on
+   * the input copy stream, so that the copy overlaps the functions still running on the device.
+   * \param func_args the function arguments.
+   * \param inp_tensor some input tensor. A tensor in page-locked host memory is read after the
+   * call returns, so it must stay unchanged until the next stateful call.
+   * \param index The input tensor index in the function arguments.
+   * \param dev device to copy to if needed.
+   */
+  void UploadInputTensorWithIndex(std::vector<RegType>& func_args, const TVMArgValue& inp_tensor,
+                                  int index, Device dev);
+
+  /*!
+   * \brief Order the stateful call about to run after the uploads of its inputs, and the later
+   * uploads after the functions run so far.
+   */
+  void WaitForUploadedInputs();
+
+  /*!
+   * \brief Bind a function argument with a given index to the memory of an input tensor,
+   * without copying.
+   * \param func_args the function arguments.
+   * \param inp_tensor some input tensor. It must reside on \p dev, or in page-locked host
+   * memory that \p dev can address. The caller keeps ownership of the memory of a DLTensor and
+   * must keep it alive while the binding is used.
+   * \param index The input tensor index in the function arguments.
+   * \param dev device the function runs on.
+   */
+  void BorrowInputTensorWithIndex(std::vector<RegType>& func_args, const TVMArgValue& inp_tensor,
+                                  int index, Device dev);
+
+  /*!
+   * \brief Invoke a function once on a batch of requests.
+   *
+   * The batched arguments are concatenated along the batch axis, and the function is invoked
+   * once. The output tensors are split back along their batch axes, as
+   * views of the output without copying when the axis is 0, while the outputs without a batch
+   * axis are shared by all the requests.
+   *
+   * \param gf_idx The function index.
+   * \param requests The arguments of each request, which must all be tensors.
+   * \param batched Whether each argument is batched, or shared by all the requests and passed
+   *  as the tensor of the first request.
+   * \param batch_axis The axis the arguments are concatenated along.
+   * \param output_axes The batch axis of each output tensor, in the depth-first order of the
+   *  output tuples, -1 for the outputs shared by all the requests. When empty, all the output
+   *  tensors are split along batch_axis.
+   * \return The outputs of each request, as an ADT.
+   */
+  RegType InvokeBatched(Index gf_idx, const std::vector<std::vector<RegType>>& requests,
+                        const std::vector<bool>& batched, int batch_axis = 0,
+                        const std::vector<int64_t>& output_axes = {});
+
+  /*!
+   * \brief Capture the kernels launched by a function into a CUDA graph, or a Vulkan command
+   *        graph when the first device of the VM is a Vulkan device.
+   * \param func_name The function name, whose inputs must have been set by `set_input`.
+   * \note The function is run once before it is captured, so that lazy initialization
+   *       happens outside of the capture. A graph is kept for each shape signature of the
+   *       inputs, since the launches of the graph are only valid for the shapes captured.
+   */
+  void CaptureCUDAGraph(const std::string& func_name);
+
+  /*!
+   * \brief Replay the CUDA graph captured from a function for the shapes of its current inputs,
+   *        capturing one first if there is none for them.
+   * \param func_name The function name.
+   */
+  void RunCUDAGraph(const std::string& func_name);
+
   /*!
    * \brief Look up whether the VM has a function by the given name.
    * \param func_name the function's name
@@ -220,23 +689,142 @@ class VirtualMachine : public runtime::ModuleNode {
    *       cannot change when the vm get loaded.
    */
   std::vector<PackedFunc> func_table_;
+  /*!
+   * \brief The index of the Relax function each entry of func_table_ resolves to, -1 for the
+   *        other functions, which cannot be run as tail calls.
+   */
+  std::vector<Index> func_table_vm_funcs_;
+  /*!
+   * \brief The compiled code of each Relax function found in the kernel library, see
+   *        CompiledFunctionSymbol, or nullptr to interpret its bytecode.
+   */
+  std::vector<PackedFunc> compiled_funcs_;
+  /*! \brief The context passed to the compiled functions, which call back into this VM. */
+  CompiledFunctionContext compiled_ctx_;
+  /*! \brief The time spent resolving the functions of the function table, in seconds. */
+  double func_resolve_seconds_{0};
+  /*! \brief The calls of a function with a shape signature, and its variant for them. */
+  struct ShapeSpecialization {
+    int64_t num_calls{0};
+    PackedFunc func;
+  };
+  /*!
+   * \brief The shape specializations of each function by shape signature, the shapes of the
+   *        NDArray arguments, counted while specialization is enabled.
+   */
+  std::unordered_map<std::string, std::unordered_map<std::string, ShapeSpecialization>>
+      specializations_;
+  /*! \brief Whether the calls are looked up in specializations_. */
+  bool specialize_shapes_{false};
+  /*! \brief The number of calls of a shape signature making it hot, 0 to never. */
+  int64_t specialization_threshold_{0};
+  /*! \brief Called with the function name and the argument shapes of the hot signatures. */
+  PackedFunc specialization_callback_;
+  /*! \brief Guards specializations_, updated by the threads compiling the variants. */
+  std::mutex specialization_mutex_;
+  /*! \brief Whether the buffers allocated by AllocStorage are recorded for a warmup. */
+  bool record_storage_{false};
+  /*!
+   * \brief The buffers allocated on each device while recording, by address. An address
+   *        allocated again, as the cached buffers are, is only recorded once.
+   */
+  std::vector<std::unordered_map<void*, size_t>> recorded_buffers_;
+  /*! \brief The allocators of the memory scopes other than the global one, by device and scope. */
+  std::map<std::pair<Index, std::string>, std::shared_ptr<Allocator>> scoped_allocators_;
+  /*!
+   * \brief The instructions of the executable, decoded once at load time.
+   * \note Call arguments point into the instruction data of exec_.
+   */
+  std::vector<Instruction> instrs_;
+  /*! \brief The instruction dispatch strategy. */
+  DispatchMode dispatch_mode_{DispatchMode::kSwitch};
+  /*! \brief The named thread pool running the parallel kernels, empty for the default pool. */
+  std::string thread_pool_;
+  /*! \brief The number of the Invoke calls running, the outermost one attaches the pool. */
+  int invoke_depth_{0};
+  /*! \brief Whether the kernels are called through their unchecked entries when present. */
+  bool unchecked_kernels_{false};
   /*!
    * \brief The current stack of call frames.
    * \note: Use unique ptr to avoid re-allocation and copy when frames_ get resized.
    */
   std::vector<std::unique_ptr<VMFrame>> frames_;
+  /*!
+   * \brief Frames released by returned calls, which are reused by later calls
+   *        to avoid allocating frames and register files in steady state.
+   */
+  std::vector<std::unique_ptr<VMFrame>> frame_pool_;
+  /*! \brief The arguments of a tail call, kept to reuse its storage across the calls. */
+  std::vector<RegType> tail_call_args_;
+  /*!
+   * \brief The pool of the storage and array headers allocated by this VM, created on
+   *        initialization, which avoids allocating the headers of tensors in steady state.
+   */
+  HeaderPool* header_pool_{nullptr};
+  /*! \brief The storages kept across calls, indexed by their slots. */
+  std::vector<Storage> static_storages_;
+  /*! \brief A storage copied to the host to stay within the memory budget of its device. */
+  struct SpilledStorage {
+    /*! \brief The storage, whose buffer has been freed. */
+    Storage storage;
+    /*! \brief The tensors allocated from the storage, with their offsets in it. */
+    std::vector<std::pair<NDArray, size_t>> views;
+    /*! \brief The content of the storage on the host. */
+    NDArray host;
+  };
+  /*! \brief The spilled storages, indexed by the storage and the tensors allocated from it. */
+  std::unordered_map<const Object*, std::shared_ptr<SpilledStorage>> spilled_;
+  /*! \brief The minimum size of the storages to spill of each device, negative to never spill. */
+  std::vector<int64_t> spill_thresholds_;
   /*! \brief The virtual machine PC. */
   Index pc_{0};
   /*! \brief The special return register. */
   RegType return_value_;
-  /*! \brief The global constant pool */
-  std::vector<TVMRetValue> constants;
+  /*! \brief The global constant pool, shared with the sessions. */
+  std::shared_ptr<ConstantPool> constants;
+  /*!
+   * \brief Guards the program of the VM, its executable, kernel library, instructions and
+   *        constants, which HotReload swaps while sessions are created from it.
+   */
+  mutable std::mutex program_mutex_;
+  /*! \brief The number of hot reloads, checked by the functions looked up before them. */
+  int64_t program_version_{0};
   /*! \brief The function name to input register mapping. */
   std::unordered_map<std::string, std::vector<RegType>> inputs_;
   /*! \brief The function name to output register. */
   std::unordered_map<std::string, RegType> outputs_;
+  /*! \brief A CUDA or Vulkan graph captured from a VM function. */
+  struct CapturedGraph {
+    /*! \brief The instantiated graph. */
+    ObjectRef graph_exec;
+    /*! \brief The global function replaying the graph. */
+    const PackedFunc* f_launch{nullptr};
+    /*! \brief The storage used by the graph, alive as long as the graph. */
+    std::vector<ObjectRef> storage;
+    /*! \brief The inputs read by the graph, which the new inputs are copied into. */
+    std::vector<RegType> inputs;
+    /*! \brief The outputs written by the graph. */
+    RegType outputs;
+  };
+  /*! \brief The captured CUDA graphs of each function, by the shape signature of the inputs. */
+  std::unordered_map<std::string, std::unordered_map<std::string, CapturedGraph>> cuda_graphs_;
+  /*! \brief The streams of the first device used by the VM, created on first use. */
+  std::vector<TVMStreamHandle> streams_;
+  /*! \brief The stream the inputs are uploaded on, null to copy them synchronously. */
+  TVMStreamHandle input_copy_stream_{nullptr};
+  /*! \brief A buffer the inputs are uploaded to, and the stateful call it was uploaded for. */
+  struct UploadBuffer {
+    NDArray array;
+    int64_t epoch;
+  };
+  /*! \brief The buffers of the uploaded inputs, reused once the functions reading them ran. */
+  std::vector<UploadBuffer> upload_buffers_;
+  /*! \brief The number of stateful calls waiting for the uploaded inputs. */
+  int64_t upload_epoch_{0};
   /*! \brief A store of closures created by `save_function`. */
   std::unordered_map<std::string, PackedFunc> saved_closures_;
+  /*! \brief The profiler of the packed calls, only set while running `profile`. */
+  std::optional<profiling::Profiler> prof_;
 };
 
 }  // namespace relax_vm
@@ -24,8 +24,11 @@
 #ifndef TVM_RUNTIME_THREADING_BACKEND_H_
 #define TVM_RUNTIME_THREADING_BACKEND_H_
 
+#include <tvm/runtime/c_backend_api.h>
+
 #include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
 #if defined(__linux__) || defined(__ANDROID__)
@@ -146,6 +149,82 @@ TVM_DLL void Configure(tvm::runtime::threading::ThreadGroup::AffinityMode mode,
  */
 int32_t NumThreads();
 
+/*!
+ * \brief Get the CPUs of each NUMA node of the system.
+ * \return The ids of the CPUs of each node, a single node of all the CPUs when the topology
+ *  cannot be read.
+ */
+TVM_DLL std::vector<std::vector<unsigned int>> NumaNodeCpus();
+
+/*!
+ * \brief Set the NUMA node on which the CPU memory allocated by the calling thread is placed.
+ * \param node The node, or -1 to follow the policy of the system.
+ */
+TVM_DLL void SetPreferredNumaNode(int node);
+
+/*!
+ * \return The NUMA node on which the CPU memory allocated by the calling thread is placed, or -1
+ *  if it follows the policy of the system.
+ */
+TVM_DLL int PreferredNumaNode();
+
+/*!
+ * \brief Create a named thread pool, with a worker bound to each of the given CPUs, which runs
+ *  the parallel launches of the threads attached to it.
+ * \param name The name of the pool.
+ * \param cpus The CPUs of the workers.
+ */
+TVM_DLL void CreateThreadPool(const std::string& name, const std::vector<unsigned int>& cpus);
+
+/*!
+ * \brief Destroy a named thread pool, once the threads attached to it are detached.
+ * \param name The name of the pool.
+ */
+TVM_DLL void DestroyThreadPool(const std::string& name);
+
+/*!
+ * \brief Attach the calling thread to a named thread pool, which runs its parallel launches.
+ * \param name The name of the pool, or empty to use the thread local pool of the thread.
+ * \return The name of the pool previously attached.
+ */
+TVM_DLL std::string AttachThreadPool(const std::string& name);
+
+/*!
+ * \brief The parallel launch of a device runtime, with the signature of
+ *  TVMBackendParallelLaunch.
+ */
+using DeviceParallelLauncher = int (*)(FTVMParallelLambda flambda, void* cdata, int num_task);
+
+/*!
+ * \brief Run the parallel launches of the threads not attached to a named pool on the threads of
+ *  a device runtime rather than on the thread pool, e.g. on the HVX threads of Hexagon.
+ * \param launcher The parallel launch of the device runtime, nullptr to use the thread pool.
+ */
+TVM_DLL void SetDeviceParallelLauncher(DeviceParallelLauncher launcher);
+
+/*!
+ * \brief Attach the calling thread to a named thread pool during the scope.
+ */
+class ThreadPoolScope {
+ public:
+  /*!
+   * \brief Attach the thread to the pool.
+   * \param name The name of the pool, nothing is attached when it is empty.
+   */
+  explicit ThreadPoolScope(const std::string& name) : attached_(!name.empty()) {
+    if (attached_) prev_ = AttachThreadPool(name);
+  }
+  ~ThreadPoolScope() {
+    if (attached_) AttachThreadPool(prev_);
+  }
+
+ private:
+  /*! \brief Whether a pool is attached by the scope. */
+  bool attached_;
+  /*! \brief The pool attached before the scope. */
+  std::string prev_;
+};
+
 }  // namespace threading
 }  // namespace runtime
 }  // namespace tvm
@@ -50,6 +50,8 @@ struct Buffer {
 enum AllocatorType {
   kNaive = 1,
   kPooled,
+  /*! \brief The size class allocator shared with the Relax VM. */
+  kBestFit,
 };
 
 class Allocator {
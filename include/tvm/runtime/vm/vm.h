@@ -425,6 +425,8 @@ class TVM_DLL VirtualMachine : public runtime::ModuleNode {
   std::vector<PackedFunc> packed_funcs_;
   /*! \brief The current stack of call frames. */
   std::vector<VMFrame> frames_;
+  /*! \brief The popped frames, whose register files are reused by the next calls. */
+  std::vector<VMFrame> frame_pool_;
   /*! \brief The fuction table index of the current function. */
   Index func_index_;
   /*! \brief The current pointer to the code section. */
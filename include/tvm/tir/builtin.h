@@ -694,6 +694,31 @@ TVM_DLL const Op& vectorlow();
  */
 TVM_DLL const Op& vectorcombine();
 
+/*!
+ * \brief Load the lanes of a vector whose mask is set, see the pseudocode below.
+ *
+ *  VecType masked_load(Handle address, BoolVecType mask) {
+ *     for (i = 0; i < lanes; ++i) {
+ *       if (mask[i]) result[i] = ((ElemType*)address)[i];
+ *     }
+ *     return result;
+ *  }
+ *
+ * \note The lanes whose mask is unset are undefined, and their memory is not accessed.
+ */
+TVM_DLL const Op& masked_load();
+
+/*!
+ * \brief Store the lanes of a vector whose mask is set, see the pseudocode below.
+ *
+ *  void masked_store(Handle address, VecType value, BoolVecType mask) {
+ *     for (i = 0; i < lanes; ++i) {
+ *       if (mask[i]) ((ElemType*)address)[i] = value[i];
+ *     }
+ *  }
+ */
+TVM_DLL const Op& masked_store();
+
 /*!
  * \brief atomic add instruction, corresponding e.g. to atomicAdd in CUDA
  */
@@ -340,6 +340,22 @@ class ScheduleNode : public runtime::Object {
    * \return The new loop created
    */
   virtual LoopRV AddUnitLoop(const LoopRV& loop_rv) = 0;
+  /*!
+   * \brief Bound the iterations of a loop over a ragged dimension, e.g. the tokens of the
+   * sequences of a batch padded to the longest one, by the length of the row indexed by an outer
+   * loop, computed from the prefix sum of the lengths as indptr[i + 1] - indptr[i]. The loop
+   * keeps its domain in the schedule, and the iterations beyond the row are skipped when lowered,
+   * leaving the padding of the outputs unwritten. Since the bound refers to the outer loop var,
+   * the loops involved must not be transformed afterwards. It requires:
+   * 1) The min of the loop is zero.
+   * 2) The outer loop is an ancestor of the loop.
+   * 3) The indptr is the name of a 1-D integer buffer parameter of the function.
+   * \param loop_rv The loop over the ragged dimension
+   * \param outer_loop_rv The loop over the rows
+   * \param indptr The name of the buffer of the prefix sum of the row lengths
+   */
+  virtual void SetRaggedExtent(const LoopRV& loop_rv, const LoopRV& outer_loop_rv,
+                               const String& indptr) = 0;
   /******** Schedule: Manipulate ForKind ********/
   /*!
    * \brief Parallelize the input loop. It requires:
@@ -674,7 +690,10 @@ class ScheduleNode : public runtime::Object {
    * The padding is a list of non-negative integers, each element corresponds to the padding for
    * each block iter in the order of block iters. The block and its producer blocks should have
    * trivial bindings, i.e. each block iter is bound to a single loop variable. After padding, the
-   * block iter extent and the corresponding outer loop is extended by the padding size.
+   * block iter extent and the corresponding outer loop is extended by the padding size. For a
+   * block iter with a non-constant extent, the exact padding size is unknown at scheduling time,
+   * and the element is instead the factor that the extent is rounded up to, i.e. the padded
+   * extent is `ceildiv(extent, padding) * padding`. A zero leaves the block iter unchanged.
    *
    * The size of the producer buffers are infered from the padding size of the Einsum computation.
    * The producer buffers are padded by the initial value of the corresponding reduction.
@@ -1545,6 +1545,32 @@ constexpr const char* software_pipeline_order = "software_pipeline_order";
  */
 constexpr const char* software_pipeline_async_stages = "software_pipeline_async_stages";
 
+/*!
+ * \brief Mark the number of iterations ahead of which a loop prefetches the global memory it reads.
+ * \note The value is a positive integer, see tir.transform.InjectSoftwarePrefetch.
+ */
+constexpr const char* software_prefetch_distance = "software_prefetch_distance";
+
+/*!
+ * \brief Mark a parallel loop to be scheduled dynamically, where the threads repeatedly grab the
+ *  next chunk of the given number of iterations until the loop is exhausted.
+ * \note The value is a positive integer, see the parallel loop codegen of the CPU.
+ */
+constexpr const char* parallel_chunk_size = "parallel_chunk_size";
+
+/*!
+ * \brief Mark that a serial loop should be vectorized by the LLVM loop vectorizer with scalable
+ *  vectors, i.e. with lanes as multiples of vscale on SVE or RVV, which the fixed lanes of
+ *  ForKind::kVectorized cannot express.
+ */
+constexpr const char* scalable_vectorize = "scalable_vectorize";
+
+/*!
+ * \brief Mark the bound of the iterations of a loop over a ragged dimension, which depends on
+ *  the outer loops. See ScheduleNode::SetRaggedExtent and tir.transform.FlattenBuffer.
+ */
+constexpr const char* ragged_extent = "ragged_extent";
+
 /*! \brief Mark the buffers which is const access and can be transformed layout. */
 constexpr const char* layout_free_buffers = "layout_free_buffers";
 
@@ -1578,6 +1604,9 @@ constexpr const char* meta_schedule_parallel = "meta_schedule.parallel";
 /*! \brief Mark auto-vectorize setting on the block. */
 constexpr const char* meta_schedule_vectorize = "meta_schedule.vectorize";
 
+/*! \brief Mark that the auto-vectorized loops of the block use scalable vectors. */
+constexpr const char* meta_schedule_scalable_vectorize = "meta_schedule.scalable_vectorize";
+
 /*! \brief Mark auto-unroll setting on the block. */
 constexpr const char* meta_schedule_unroll_explicit = "meta_schedule.unroll_explicit";
 
@@ -65,6 +65,16 @@ TVM_DLL Pass CreatePrimFuncPass(
  */
 TVM_DLL Pass InjectPrefetch();
 
+/*!
+ * \brief Prefetch the global memory read by the future iterations of the loops annotated with
+ *  attr::software_prefetch_distance. At the beginning of the body of each such loop, a
+ *  builtin::prefetch is inserted for each distinct load whose flattened index depends on the loop
+ *  var, with the loop var advanced by the distance and clamped to the last iteration.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass InjectSoftwarePrefetch();
+
 // TODO(tvm-team): consolidate configs to the PassContext
 /*!
  * \brief Flatten the multi-dimensional read/write
@@ -119,6 +129,11 @@ TVM_DLL Pass LoopPartition();
  *
  * \param enable_vectorize Whether vectorization is enabled.
  *
+ * \note With the config "tir.VectorizeLoop" {"enable_predication": true}, the stores guarded by a
+ *  vector condition, e.g. the tail predicate of a loop with symbolic extent, are lowered to
+ *  builtin::masked_load and builtin::masked_store instead of being scalarized. Only the LLVM
+ *  targets support these builtins.
+ *
  * \return The pass.
  */
 TVM_DLL Pass VectorizeLoop(bool enable_vectorize = true);
@@ -343,6 +358,13 @@ TVM_DLL Pass NarrowDataType(int target_bits);
  */
 TVM_DLL Pass BF16Legalize();
 
+/*!
+ * \brief Legalize the e4m3 and e5m2 float8 typed Ops. The Ops are computed in fp32, and the
+ *   float8 values are stored as uint8, converted with rounding to the nearest even.
+ * \return The pass.
+ */
+TVM_DLL Pass FP8Legalize();
+
 /*!
  * \brief Rewrite the pointer content type of arguments,
  *  as well as Alloc internal to the function to use
@@ -461,7 +483,8 @@ TVM_DLL Pass LowerOpaqueBlock();
 
 /*!
  * \brief Flatten the multi-dimensional BufferLoad and BufferStore to single dimensional
- *        BufferLoad/BufferStore for the TIR not contains opaque block.
+ *        BufferLoad/BufferStore for the TIR not contains opaque block. The loops with a ragged
+ *        extent are bounded by it, see ScheduleNode::SetRaggedExtent.
  * \return The pass.
  */
 TVM_DLL Pass FlattenBuffer();
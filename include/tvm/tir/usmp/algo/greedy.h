@@ -67,7 +67,7 @@ class GreedyBase {
   /*!
    * \brief Selects a pool for placement in the given set of ordered pool candidates
    */
-  PoolInfo SelectPlacementPool(
+  virtual PoolInfo SelectPlacementPool(
       const BufferInfo& buf_info,
       const std::unordered_map<PoolInfo, size_t, ObjectPtrHash, ObjectPtrEqual>& pool_offsets);
 
@@ -53,6 +53,18 @@ Map<BufferInfo, PoolAllocation> GreedyBySize(const Array<BufferInfo>& buffer_inf
  */
 Map<BufferInfo, PoolAllocation> GreedyByConflicts(const Array<BufferInfo>& buffer_info_arr,
                                                   const Integer& memory_pressure);
+/*!
+ * \brief The Tiered-by-Access algorithm to plan memory
+ *
+ * This will perform a greedy algorithm placing the buffers with the most accessed bytes per
+ * byte of size first, each in the candidate pool of the highest bandwidth that still fits it, so
+ * that the hot buffers land in the fast memories of the SoC.
+ *
+ * \return A Map of BufferInfo objects and their associated PoolAllocation
+ */
+Map<BufferInfo, PoolAllocation> TieredByAccess(const Array<BufferInfo>& buffer_info_arr,
+                                               const Integer& memory_pressure);
+
 /*!
  *\brief The Hill-Climb algoritm to plan memory
  *
@@ -81,6 +81,11 @@ struct BufferInfoNode : public Object {
   Array<ObjectRef> conflicts;
   /*! \brief Whether BufferInfo object retains info about IO tensors or intermediaries */
   BufferInfoKind kind;
+  /*!
+   * \brief The estimated bytes read from and written to the buffer, each access weighted by
+   * the extents of the loops around it
+   */
+  int64_t access_bytes = 0;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     v->Visit("name_hint", &name_hint);
@@ -89,12 +94,14 @@ struct BufferInfoNode : public Object {
     v->Visit("alignment", &alignment);
     v->Visit("conflicts", &conflicts);
     v->Visit("kind", &kind);
+    v->Visit("access_bytes", &access_bytes);
   }
 
   bool SEqualReduce(const BufferInfoNode* other, SEqualReducer equal) const {
     return equal(name_hint, other->name_hint) && equal(size_bytes, other->size_bytes) &&
            equal(pool_candidates, other->pool_candidates) && equal(alignment, other->alignment) &&
-           equal(conflicts, other->conflicts) && equal(kind, other->kind);
+           equal(conflicts, other->conflicts) && equal(kind, other->kind) &&
+           equal(access_bytes, other->access_bytes);
   }
 
   void SHashReduce(SHashReducer hash_reduce) const {
@@ -104,6 +111,7 @@ struct BufferInfoNode : public Object {
     hash_reduce(conflicts);
     hash_reduce(pool_candidates);
     hash_reduce(kind);
+    hash_reduce(access_bytes);
   }
   /*!
    * \brief Set the liveness conflicts of this BufferInfo
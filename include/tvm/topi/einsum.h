@@ -67,11 +67,34 @@ Array<PrimExpr> InferEinsumShape(const std::string& subscripts,
  * \param inputs Arrays for the operation.
  * \param name The name of the operation.
  * \param tag The tag to mark the operation.
+ * \param optimize "none" to compute the summation in a single nested loop, "greedy" or
+ * "optimal" to contract the operands pairwise in the order given by EinsumContractionPath, each
+ * contraction being a batched matmul. The summations that are not decomposable are computed in a
+ * single nested loop whatever the value.
  *
  * \return The calculation based on the Einstein summation convention.
  */
 Tensor einsum(const std::string& subscripts_str, const Array<Tensor> inputs,
-              std::string name = "T_einsum", std::string tag = kEinsum);
+              std::string name = "T_einsum", std::string tag = kEinsum,
+              std::string optimize = "none");
+
+/*!
+ * \brief Find the order in which to contract the operands of an Einstein summation pairwise.
+ *
+ * \param subscripts_str The subscripts of the summation.
+ * \param input_shapes The shapes of the operands.
+ * \param optimize "greedy" to contract first the pair of the smallest result, as opt_einsum,
+ * "optimal" to search all the orders for the fewest multiply-adds. "optimal" falls back to
+ * "greedy" beyond 6 operands.
+ *
+ * \return The positions of the pair of operands contracted at each step, in the list of the
+ * operands from which the previous pairs are removed and to which their results are appended,
+ * as numpy.einsum_path. Empty when the summation has fewer than two operands, an ellipsis,
+ * repeated labels in a subscript, broadcast or non-constant extents.
+ */
+Array<Array<Integer>> EinsumContractionPath(const std::string& subscripts_str,
+                                            const Array<Array<PrimExpr>>& input_shapes,
+                                            const std::string& optimize = "greedy");
 
 struct EinsumEquation {
   /*!
@@ -15,6 +15,8 @@
 # specific language governing permissions and limitations
 # under the License.
 """Arithmetic data structure and utility"""
+from typing import Dict
+
 import tvm._ffi
 from tvm.runtime import Object
 from . import _ffi_api
@@ -91,6 +93,8 @@ class Analyzer:
         self._int_set = _mod("int_set")
         self._enter_constraint_context = _mod("enter_constraint_context")
         self._can_prove_equal = _mod("can_prove_equal")
+        self._enable_simplify_cache = _mod("enable_simplify_cache")
+        self._simplify_cache_stats = _mod("simplify_cache_stats")
 
     def const_int_bound(self, expr):
         """Find constant integer bound for expr.
@@ -270,3 +274,28 @@ class Analyzer:
             Whether we can prove that lhs == rhs
         """
         return self._can_prove_equal(lhs, rhs)
+
+    def enable_simplify_cache(self, enable: bool = True):
+        """Enable the memoization of simplify, keyed by the structural equality of the
+        expressions.
+
+        The cache only holds the results found under the current bindings and constraints.
+        Binding a var drops them. A constraint scope starts with an empty cache, and restores the
+        enclosing one on exit unless a var is bound within the scope.
+
+        Parameters
+        ----------
+        enable: bool
+            Whether to enable the cache. Disabling it drops the cached results.
+        """
+        self._enable_simplify_cache(enable)
+
+    def simplify_cache_stats(self) -> Dict[str, int]:
+        """The statistics of the cache of simplify since it is enabled.
+
+        Returns
+        -------
+        stats: Dict[str, int]
+            The number of hits, misses and invalidations of the cache.
+        """
+        return {name: int(value) for name, value in self._simplify_cache_stats().items()}
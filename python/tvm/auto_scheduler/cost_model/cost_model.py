@@ -22,6 +22,7 @@ import numpy as np
 import tvm._ffi
 from tvm.runtime import Object
 from .. import _ffi_api
+from ..feature import DEFAULT_MAX_N_BUFS, as_numpy_view
 
 
 @tvm._ffi.register_object("auto_scheduler.CostModel")
@@ -103,8 +104,22 @@ class PythonBasedModel(CostModel):
             array_wrapper = np.ctypeslib.as_array(return_ptr, shape=ret.shape)
             array_wrapper[:] = ret
 
+        def predict_features_func(features, row_offsets, return_ptr):
+            row_offsets = row_offsets.numpy()
+            return_ptr = ctypes.cast(return_ptr, ctypes.POINTER(ctypes.c_float))
+            array_wrapper = np.ctypeslib.as_array(return_ptr, shape=(len(row_offsets) - 1,))
+            array_wrapper[:] = self.predict_features(as_numpy_view(features), row_offsets)
+
+        # The features are extracted in C++ and predicted in one batch by the models
+        # overriding predict_features.
+        batched = type(self).predict_features is not PythonBasedModel.predict_features
         self.__init_handle_by_constructor__(
-            _ffi_api.PythonBasedModel, update_func, predict_func, predict_stage_func
+            _ffi_api.PythonBasedModel,
+            update_func,
+            predict_func,
+            predict_stage_func,
+            predict_features_func if batched else None,
+            DEFAULT_MAX_N_BUFS,
         )
 
     def update(self, inputs, results):
@@ -136,6 +151,25 @@ class PythonBasedModel(CostModel):
         """
         raise NotImplementedError
 
+    def predict_features(self, features, row_offsets):
+        """Predict the scores of states from their features, in one batch. The models
+        implementing it are given the features extracted in C++ instead of the states.
+
+        Parameters
+        ----------
+        features : np.ndarray
+            The feature vectors of all the statements of the states, one per row.
+        row_offsets : np.ndarray
+            The rows of state i are features[row_offsets[i]:row_offsets[i + 1]].
+
+        Returns
+        -------
+        scores: np.ndarray
+            The predicted scores for all states. The states without features are scored -inf
+            by the caller.
+        """
+        raise NotImplementedError
+
     def predict_stages(self, task, states):
         """Predict the scores of all stages in states. This is the breakdown version of `predict`.
 
@@ -244,6 +244,30 @@ class XGBModel(PythonBasedModel):
 
         return ret
 
+    def predict_features(self, features, row_offsets):
+        """Predict the scores of states from their flattened features in one batch
+
+        Parameters
+        ----------
+        features : np.ndarray
+            The feature vectors of all the statements of the states, one per row.
+        row_offsets : np.ndarray
+            The rows of state i are features[row_offsets[i]:row_offsets[i + 1]].
+
+        Returns
+        -------
+        scores: np.ndarray
+            The predicted scores for all states
+        """
+        n_states = len(row_offsets) - 1
+        if self.bst is None or len(self.inputs) <= self.num_warmup_sample:
+            return np.random.uniform(0, 1, (n_states,))
+        if len(features) == 0:
+            return np.zeros((n_states,))
+        pack_ids = np.repeat(np.arange(n_states), np.diff(row_offsets))
+        raw_preds = self.bst.predict(xgb.DMatrix(features))
+        return np.bincount(pack_ids, weights=raw_preds, minlength=n_states)
+
     def predict_stages(self, task, states):
         """Predict the scores of all stages in states. This is the breakdown version of `predict`.
 
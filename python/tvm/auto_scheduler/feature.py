@@ -239,6 +239,57 @@ def get_per_store_features_from_states(
     return unpack_feature(byte_arr)[0]
 
 
+def as_numpy_view(arr) -> np.ndarray:
+    """View a tvm.nd.NDArray on the CPU as a numpy array, copying it only when the installed
+    numpy cannot import it by DLPack.
+
+    Parameters
+    ----------
+    arr: tvm.nd.NDArray
+        The array
+
+    Returns
+    -------
+    view: np.ndarray
+        The numpy array
+    """
+    if hasattr(np, "from_dlpack"):
+        return np.from_dlpack(arr)
+    return arr.numpy()
+
+
+def get_per_store_features_from_states_flatten(
+    states: List[Union[State, StateObject]], task: "SearchTask", max_n_bufs: Optional[int] = None
+) -> Tuple[np.ndarray, np.ndarray]:
+    """Get per-store features from states, flattened into one matrix
+
+    Parameters
+    ----------
+    states: List[Union[State, StateObject]]
+        The input states
+    task: SearchTask
+        The search task of the input states
+    max_n_bufs: Optional[int]
+        The maximum number of extracted buffers for one statement
+
+    Returns
+    -------
+    features: np.ndarray
+        The feature vectors of all the statements, of shape (num_rows, feature_len)
+    row_offsets: np.ndarray
+        The rows of state i are features[row_offsets[i]:row_offsets[i + 1]]. The states that
+        failed to be lowered have no rows.
+    """
+    if isinstance(states[0], State):
+        state_objects = [s.state_object for s in states]
+    elif isinstance(states[0], StateObject):
+        state_objects = states
+    features, row_offsets = _ffi_api.GetPerStoreFeaturesFromStatesFlatten(
+        state_objects, task, max_n_bufs or DEFAULT_MAX_N_BUFS
+    )
+    return as_numpy_view(features), row_offsets.numpy()
+
+
 def get_per_store_feature_names(max_n_bufs: Optional[int] = None) -> List[str]:
     """Get the name of every element in the feature vector. Use this for debug and inspection.
 
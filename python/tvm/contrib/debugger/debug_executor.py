@@ -120,6 +120,9 @@ class GraphModuleDebug(graph_executor.GraphModule):
         self._get_node_output = module["get_node_output"]
         self._profile = module["profile"]
         self._profile_rpc = module["profile_rpc"]
+        self._set_sampling_interval = module["set_sampling_interval"]
+        self._sampled_report = module["sampled_report"]
+        self._sampled_report_rpc = module["sampled_report_rpc"]
         graph_executor.GraphModule.__init__(self, module)
         self._create_debug_env(graph_json_str, device)
 
@@ -505,6 +508,40 @@ class GraphModuleDebug(graph_executor.GraphModule):
             return Report.from_json(self._profile_rpc())
         return self._profile(collectors)
 
+    def set_sampling_interval(self, interval):
+        """Profile every `interval`-th call of the `run` function of the underlying module.
+
+        The sampled runs time each node with the timers of its device, the other runs are left
+        untouched, so that a served graph can be profiled at a small cost. Note that the
+        :py:meth:`run` of this class dumps the outputs of every node and is not sampled, the
+        runs sampled are the ones of ``module["run"]``, e.g. through a
+        :py:class:`tvm.contrib.graph_executor.GraphModule` on the same module.
+
+        Parameters
+        ----------
+        interval : int
+            The number of runs per sampled run, 0 disables the sampling.
+        """
+        self._set_sampling_interval(interval)
+
+    def sampled_report(self, reset=False):
+        """Aggregate the sampled runs into a report, which can be taken while serving.
+
+        Parameters
+        ----------
+        reset : bool
+            Whether to drop the samples once reported.
+
+        Return
+        ------
+        report : tvm.runtime.profiling.Report
+            One call per node, whose duration is the total over the sampled runs and whose
+            count is the number of samples.
+        """
+        if self.module.type_key == "rpc":
+            return Report.from_json(self._sampled_report_rpc(reset))
+        return self._sampled_report(reset)
+
     def exit(self):
         """Exits the dump folder and all its contents"""
         self._remove_dump_root()
@@ -66,6 +66,32 @@ def create(graph_json_str, libmod, device):
     return GraphModule(fcreate(graph_json_str, libmod, *device_type_id))
 
 
+def create_shared(factory, device):
+    """Create a runtime executor module sharing its params with the other ones created on the
+    same devices by this function, e.g. one per serving thread.
+
+    The params are placed on the devices once, by the first executor, an executor then only
+    allocates the storage of its activations. The shared params must not be modified, e.g. by
+    set_input or load_params.
+
+    Parameters
+    ----------
+    factory : tvm.runtime.Module
+        The executor factory module, e.g. built by relay.build or loaded from its library.
+
+    device : Device or list of Device
+        The devices to deploy the module.
+
+    Returns
+    -------
+    graph_module : GraphModule
+        Runtime graph module that can be used to execute the graph.
+    """
+    if isinstance(device, Device):
+        device = [device]
+    return GraphModule(factory["shared_create"](*device))
+
+
 def get_device(libmod, device):
     """Parse and validate all the device(s).
 
@@ -207,6 +233,48 @@ class GraphModule(object):
             self.set_input(**input_dict)
         self._run()
 
+    def set_thread_pool(self, name):
+        """Run the parallel kernels of the graph on a named thread pool
+
+        Parameters
+        ----------
+        name : str
+            The name of a pool given to :py:func:`tvm.runtime.create_thread_pool`, or empty to
+            use the default pool of the calling thread.
+        """
+        self.module["set_thread_pool"](name)
+
+    def set_max_concurrency(self, max_concurrency):
+        """Run up to max_concurrency operations of the graph at the same time
+
+        The independent operations, e.g. of the branches of a model, are dispatched onto
+        worker threads as soon as the operations they depend on are done. Each worker runs the
+        parallel kernels on its own default thread pool, or on the pool set by
+        :py:meth:`set_thread_pool`, so the pools may need fewer threads to not oversubscribe
+        the cores.
+
+        Parameters
+        ----------
+        max_concurrency : int
+            The maximum number of concurrent operations, 1 to run them one by one in order.
+        """
+        self.module["set_max_concurrency"](max_concurrency)
+
+    def capture_vulkan_graph(self):
+        """Record the kernels of the graph on its Vulkan device into a command graph
+
+        The graph is run once with the current inputs before being captured. After the
+        capture, :py:meth:`set_input` copies new inputs into the captured input buffers, and
+        :py:meth:`run_vulkan_graph` replays the kernels with a single queue submission rather
+        than dispatching them one by one. Only the graphs whose operators all run on the Vulkan
+        device can be captured, and inputs set by zero copy are not seen by the replay.
+        """
+        self.module["capture_vulkan_graph"]()
+
+    def run_vulkan_graph(self):
+        """Replay the command graph recorded by :py:meth:`capture_vulkan_graph`"""
+        self.module["run_vulkan_graph"]()
+
     def get_num_outputs(self):
         """Get the number of outputs from the graph
 
@@ -59,6 +59,7 @@ class PipelineModule(object):
         self._get_num_inputs = self.module["get_num_inputs"]
         self._get_input_pipeline_map = self.module["get_input_pipeline_map"]
         self._get_pipe_execute_count = self.module["get_execute_count"]
+        self._get_stage_statistics = self.module["get_stage_statistics"]
 
     def run(self):
         """Run the pipeline executor."""
@@ -163,6 +164,19 @@ class PipelineModule(object):
         """
         return self._get_pipe_execute_count()
 
+    def get_stage_statistics(self):
+        """Get the statistics of each stage of the pipeline, to find the stage to rebalance.
+
+        Returns
+        -------
+        statistics : List[Dict[str, Union[int, float]]]
+            One dictionary per stage, with its "mod_idx", its "execution_count", the "run_us"
+            spent running the module, the "wait_us" spent waiting for the data of its parents,
+            the "blocked_us" spent waiting for room in the full queues of its children, and its
+            "utilization", the fraction of the time since the pipeline started spent running.
+        """
+        return json.loads(self._get_stage_statistics())
+
     @property
     def num_outputs(self):
         """Get the number of outputs.
@@ -417,6 +417,10 @@ class PipelineConfig(object):
             self.dev = None
             self.export_cc = None
             self.cpu_affinity = ""
+            # The capacity of the queues forwarding the outputs, 0 for the default one. A
+            # stage whose output queues are full blocks until its children catch up, which
+            # bounds the memory held by a pipeline whose consumer is slow.
+            self.queue_capacity = 0
             self.idx = None
             self.mod = mod
             self.input_params = InferType()(mod)["main"].params
@@ -593,6 +597,7 @@ class PipelineConfig(object):
 
             mconf["mod_idx"] = module.idx
             mconf["cpu_affinity"] = module.cpu_affinity
+            mconf["queue_capacity"] = module.queue_capacity
             mconf["output"] = output_conf
 
             module_connection[mod] = {
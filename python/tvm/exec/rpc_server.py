@@ -17,6 +17,7 @@
 # pylint: disable=redefined-outer-name, invalid-name
 """Start an RPC server"""
 import argparse
+import json
 import logging
 from .. import rpc
 
@@ -49,6 +50,7 @@ def main(args):
         custom_addr=args.custom_addr,
         silent=args.silent,
         no_fork=not args.fork,
+        tags=json.loads(args.tags) if args.tags else None,
     )
     server.proc.join()
 
@@ -90,6 +92,11 @@ if __name__ == "__main__":
     parser.add_argument(
         "--custom-addr", type=str, help="Custom IP Address to Report to RPC Tracker"
     )
+    parser.add_argument(
+        "--tags",
+        type=str,
+        help='The device capabilities reported to RPC Tracker as json, e.g. \'{"gpu": "a100"}\'',
+    )
 
     parser.set_defaults(fork=True)
     args = parser.parse_args()
@@ -0,0 +1,38 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Serve an RPC session through the shared memory of its client, see rpc.SharedMemorySession."""
+import argparse
+
+from ..rpc import _ffi_api
+from ..rpc.server import _server_env
+
+
+def main():
+    """Main function"""
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--load-library", type=str, help="Additional library to load, separated by colons"
+    )
+    parser.add_argument("fd", type=int, help="The file descriptor of the shared memory")
+    args = parser.parse_args()
+    temp = _server_env(args.load_library)
+    _ffi_api.SharedMemoryServerLoop(args.fd)
+    temp.remove()
+
+
+if __name__ == "__main__":
+    main()
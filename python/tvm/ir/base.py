@@ -157,6 +157,42 @@ def save_json(node):
     return tvm.runtime._ffi_node_api.SaveJSON(node)
 
 
+def load_binary(blob):
+    """Load tvm object from the bytes created by save_binary.
+
+    Parameters
+    ----------
+    blob : bytearray
+        The binary blob.
+
+    Returns
+    -------
+    node : Object
+        The loaded tvm node.
+    """
+    return tvm.runtime._ffi_node_api.LoadBinary(bytearray(blob))
+
+
+def save_binary(node):
+    """Save tvm object in a compact binary format.
+
+    Unlike save_json, the strings are only stored once and the NDArrays are stored as raw bytes,
+    which makes it faster to save and load large IRModules. The format is not meant to be
+    compatible across TVM versions.
+
+    Parameters
+    ----------
+    node : Object
+        A TVM object to be saved.
+
+    Returns
+    -------
+    blob : bytearray
+        Saved binary blob.
+    """
+    return tvm.runtime._ffi_node_api.SaveBinary(node)
+
+
 def structural_equal(lhs, rhs, map_free_vars=False):
     """Check structural equality of lhs and rhs.
 
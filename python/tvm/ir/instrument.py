@@ -16,6 +16,7 @@
 # under the License.
 # pylint: disable=invalid-name,unused-argument
 """Common pass instrumentation across IR variants."""
+import contextlib
 import inspect
 import functools
 
@@ -229,10 +230,26 @@ def pass_instrument(pi_cls=None):
 
 @tvm._ffi.register_object("instrument.PassInstrument")
 class PassTimingInstrument(tvm.runtime.Object):
-    """A wrapper to create a passes time instrument that implemented in C++"""
+    """A wrapper to create a passes time instrument that implemented in C++
 
-    def __init__(self):
-        self.__init_handle_by_constructor__(_ffi_instrument_api.MakePassTimingInstrument)
+    Besides the wall time, each pass records the processor time of the process, the growth of its
+    peak resident set size, and optionally the number of nodes of the IRModule before and after
+    the pass. The results of the passes run in the pass context are rendered as text by
+    :py:meth:`render`, as CSV by :py:meth:`render_csv`, or as a Chrome trace by
+    :py:meth:`render_chrome_trace`.
+
+    Parameters
+    ----------
+    count_nodes : bool
+        Whether to count the distinct nodes reachable from the IRModule before and after each
+        pass. The counting is excluded from the times of the pass itself, but not from the ones
+        of the enclosing passes, and it is proportional to the size of the IRModule.
+    """
+
+    def __init__(self, count_nodes=False):
+        self.__init_handle_by_constructor__(
+            _ffi_instrument_api.MakePassTimingInstrument, count_nodes
+        )
 
     @staticmethod
     def render():
@@ -255,3 +272,55 @@ class PassTimingInstrument(tvm.runtime.Object):
                 profiles = timing_inst.render()
         """
         return _ffi_instrument_api.RenderTimePassProfiles()
+
+    @staticmethod
+    def render_csv():
+        """Retrieve the profiles as CSV, one row per pass in the order they were entered.
+
+        The columns are the name, the nesting depth and the name of the enclosing pass, the wall
+        time, the wall time excluding the sub-passes and the processor time in microseconds, the
+        growth of the peak resident set size in KB, and the node counts of the IRModule before
+        and after the pass. The unknown memory and the uncounted nodes are -1.
+
+        Returns
+        -------
+        string : string
+            The CSV text, with a header row.
+        """
+        return _ffi_instrument_api.RenderPassProfilesCSV()
+
+    @staticmethod
+    def render_chrome_trace():
+        """Retrieve the profiles in the Chrome trace event format.
+
+        Each pass is a complete event, nested passes appear stacked under their parent, and the
+        processor time, the memory and the node counts of the pass are in its arguments. The
+        trace can be opened with chrome://tracing or Perfetto.
+
+        Returns
+        -------
+        string : string
+            The JSON text of the trace.
+        """
+        return _ffi_instrument_api.RenderPassProfilesChromeTrace()
+
+
+@contextlib.contextmanager
+def pass_profile_scope(name):
+    """Group the passes run in the scope under an entry of the pass profiles.
+
+    The entry is profiled as a pass named `name`, so steps that run several passes, e.g. the
+    evaluation of a tuning candidate, can be told apart in the profiles. It does nothing unless a
+    :py:class:`PassTimingInstrument` is active in the current thread.
+
+    Parameters
+    ----------
+    name : str
+        The name of the entry.
+    """
+    entered = _ffi_instrument_api.EnterPassProfileScope(name)
+    try:
+        yield
+    finally:
+        if entered:
+            _ffi_instrument_api.ExitPassProfileScope()
@@ -26,6 +26,7 @@ from . import (
     postproc,
     relax_integration,
     relay_integration,
+    retuning,
     runner,
     schedule_rule,
     search_strategy,
@@ -45,12 +46,13 @@ from .relay_integration import (
     is_meta_schedule_dispatch_enabled,
     is_meta_schedule_enabled,
 )
+from .retuning import RetuningService
 from .runner import Runner
 from .schedule_rule import ScheduleRule
 from .search_strategy import MeasureCandidate, SearchStrategy
 from .space_generator import SpaceGenerator
 from .task_scheduler import TaskScheduler
-from .tir_integration import tune_tir
-from .tune import tune_tasks
+from .tir_integration import tune_tir, tune_tir_dynamic
+from .tune import tune_tasks, tune_tasks_distributed
 from .tune_context import TuneContext
 from .utils import derived_object
@@ -24,7 +24,6 @@ from typing import TYPE_CHECKING, Any, Callable, Dict, List, NamedTuple, Optiona
 import numpy as np  # type: ignore
 
 from ...contrib.tar import tar, untar
-from ...runtime import NDArray
 from ..cost_model import PyCostModel
 from ..feature_extractor import FeatureExtractor
 from ..logging import get_logger
@@ -37,12 +36,19 @@ if TYPE_CHECKING:
     import xgboost as xgb  # type: ignore
     from xgboost.callback import TrainingCallback  # type: ignore
 
+    from ..database import Database, TuningRecord
     from ..tune_context import TuneContext
 
 
 logger = get_logger(__name__)  # pylint: disable=invalid-name
 
 
+def _mean_cost(run_secs: Optional[List[float]]) -> float:
+    if not run_secs:
+        return 1e10
+    return float(np.median([float(s) for s in run_secs]))
+
+
 def make_metric_sorter(focused_metric):
     """Make sure the focused metric is the first one."""
 
@@ -459,25 +465,90 @@ class XGBModel(PyCostModel):
         assert len(candidates) == len(results)
         if len(candidates) == 0:
             return
+        self._append_data(context, candidates, results)
+
+        if (
+            self.adaptive_training
+            and self.data_size - self.last_train_size < self.last_train_size / 5
+        ):
+            # Set a training threshold related to `last_train_size` to reduce the training
+            # overhead when there're too many results
+            return
+        self.last_train_size = self.data_size
+
+        # Re-train the model
+        self._train_on_data()
+
+    def pretrain(
+        self,
+        database: "Database",
+        max_records_per_workload: Optional[int] = None,
+    ) -> None:
+        """Warm start the cost model from the tuning records of a database, e.g. the logs of
+        previous tuning sessions on structurally similar workloads.
+
+        Parameters
+        ----------
+        database : Database
+            The database whose measured tuning records are used as the training data.
+        max_records_per_workload : Optional[int]
+            The maximum number of the best records used for each workload. All records are
+            used if not specified.
+
+        Note
+        ----
+        The records are kept in the training data, grouped by workload like the online updates,
+        so the model keeps being fine-tuned on them with the results measured afterwards. The
+        warmup of random predictions is skipped once the records outnumber
+        `num_warmup_samples`.
+        """
+        # pylint: disable=import-outside-toplevel
+        from ..tune_context import TuneContext
+
+        # pylint: enable=import-outside-toplevel
+        workloads: Dict[str, List[TuningRecord]] = OrderedDict()
+        for record in database.get_all_tuning_records():
+            if not record.run_secs or record.target is None:
+                continue
+            workloads.setdefault(shash2hex(record.workload.mod), []).append(record)
+        for records in workloads.values():
+            records.sort(key=lambda r: _mean_cost(r.run_secs))
+            if max_records_per_workload is not None:
+                records = records[:max_records_per_workload]
+            self._append_data(
+                TuneContext(mod=records[0].workload.mod, target=records[0].target),
+                [record.as_measure_candidate() for record in records],
+                [RunnerResult(record.run_secs, None) for record in records],
+                validate=False,
+            )
+        if self.data_size == 0:
+            return
+        logger.info(
+            "Pre-training XGBModel on %d record(s) of %d workload(s)",
+            self.data_size,
+            len(self.data),
+        )
+        self.last_train_size = self.data_size
+        self._train_on_data()
 
+    def _append_data(
+        self,
+        context: "TuneContext",
+        candidates: List[MeasureCandidate],
+        results: List[RunnerResult],
+        validate: bool = True,
+    ) -> None:
+        """Add the features and the costs of the measured candidates into the training data."""
         # Step 1. Get the feature group
         new_group_hash = shash2hex(context.mod)
         group = self.data.get(new_group_hash, None)
 
         # Step 2. Extract features
-        def _feature(x: NDArray) -> np.ndarray:
-            return x.numpy().astype("float32")
-
-        def _mean_cost(x: RunnerResult) -> float:
-            if not x.run_secs:
-                return 1e10
-            return float(np.median([float(s) for s in x.run_secs]))
-
-        new_features = [_feature(x) for x in self.extractor.extract_from(context, candidates)]
-        new_mean_costs = np.array([_mean_cost(x) for x in results]).astype("float32")
+        new_features = self._extract_features(context, candidates)
+        new_mean_costs = np.array([_mean_cost(x.run_secs) for x in results]).astype("float32")
 
         # Steps 3. Run validation
-        if group is not None and self.booster is not None:
+        if validate and group is not None and self.booster is not None:
             logger.debug(
                 "XGB validation: %s",
                 "\t".join(
@@ -501,16 +572,8 @@ class XGBModel(PyCostModel):
         self.data[new_group_hash] = group
         self.data_size += len(new_features)
 
-        if (
-            self.adaptive_training
-            and self.data_size - self.last_train_size < self.last_train_size / 5
-        ):
-            # Set a training threshold related to `last_train_size` to reduce the training
-            # overhead when there're too many results
-            return
-        self.last_train_size = self.data_size
-
-        # Step 5. Re-train the model
+    def _train_on_data(self) -> None:
+        """Train the model on all the data points."""
         self._train(
             xs=list(itertools_chain.from_iterable([g.features for g in self.data.values()])),
             ys=np.concatenate(
@@ -539,15 +602,7 @@ class XGBModel(PyCostModel):
             The predicted normalized score.
         """
         if self.data_size >= self.num_warmup_samples and self.booster is not None:
-            ret = self._predict(
-                xs=[
-                    x.numpy().astype("float32")
-                    for x in self.extractor.extract_from(
-                        context,
-                        candidates,
-                    )
-                ]
-            )
+            ret = self._predict(xs=self._extract_features(context, candidates))
         else:
             ret = np.random.uniform(
                 low=0,
@@ -556,6 +611,15 @@ class XGBModel(PyCostModel):
             )
         return ret.astype("float64")
 
+    def _extract_features(
+        self,
+        context: "TuneContext",
+        candidates: List[MeasureCandidate],
+    ) -> List[np.ndarray]:
+        """Extract the float32 features of each candidate, as views of one batched buffer."""
+        features, row_offsets = self.extractor.extract_batch(context, candidates)
+        return np.split(features.numpy(), row_offsets.numpy()[1:-1])
+
     def _train(  # type: ignore # pylint: disable=invalid-name
         self,
         xs: List[np.ndarray],
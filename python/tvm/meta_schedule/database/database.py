@@ -120,6 +120,21 @@ class TuningRecord(Object):
             args_info,
         )
 
+    def run_secs_variance(self) -> Optional[float]:
+        """The sample variance of the measured run times, which tells how noisy the measurement
+        of the record is.
+
+        Returns
+        -------
+        variance : Optional[float]
+            The variance, or None if the record has less than two measurements.
+        """
+        if self.run_secs is None or len(self.run_secs) < 2:
+            return None
+        run_secs = [float(sec) for sec in self.run_secs]
+        mean = sum(run_secs) / len(run_secs)
+        return sum((sec - mean) ** 2 for sec in run_secs) / (len(run_secs) - 1)
+
     def as_measure_candidate(self) -> Any:
         """Generate a measure candidate given an initial IR module and a trace
         stored in the tuning record.
@@ -231,6 +246,26 @@ class Database(Object):
         """
         return _ffi_api.DatabaseGetAllTuningRecords(self)  # type: ignore # pylint: disable=no-member
 
+    def get_top_k_nearest(self, mod: IRModule, top_k: int) -> List[TuningRecord]:
+        """Get the top K tuning records of the workloads structurally equal to the given one
+        modulo their integer constants, e.g. the same operator on other shapes.
+
+        Parameters
+        ----------
+        mod : IRModule
+            The IRModule to be searched for.
+        top_k : int
+            The number of records to be returned.
+
+        Returns
+        -------
+        top_k_records : List[TuningRecord]
+            The records, the best record of each workload first, with the workloads ordered by
+            how close their constants are to the ones of `mod`. The records of `mod` itself are
+            excluded.
+        """
+        return _ffi_api.DatabaseGetTopKNearest(self, mod, top_k)  # type: ignore # pylint: disable=no-member
+
     def __len__(self) -> int:
         """Get the number of records in the database.
 
@@ -368,6 +403,7 @@ class Database(Object):
         kind: Union[
             Literal[
                 "json",
+                "indexed",
                 "memory",
                 "union",
                 "ordered_union",
@@ -381,9 +417,10 @@ class Database(Object):
 
         Parameters
         ----------
-        kind : str = "json" | "memory" | "union" | "ordered_union" | Callable[[Schedule], bool]
+        kind : str = "json" | "indexed" | "memory" | "union" | "ordered_union" | Callable
             The kind of the database to be created. The following kinds are supported:
-            "json", "memory", "union", "ordered_union", and a custom schedule function.
+            "json", "indexed", "memory", "union", "ordered_union", and a custom schedule
+            function.
 
         Returns
         -------
@@ -391,6 +428,7 @@ class Database(Object):
             The created database.
         """
         from . import (  # pylint: disable=import-outside-toplevel
+            IndexedDatabase,
             JSONDatabase,
             MemoryDatabase,
             OrderedUnionDatabase,
@@ -402,6 +440,8 @@ class Database(Object):
             return ScheduleFnDatabase(kind, *args, **kwargs)  # type: ignore
         if kind == "json":
             return JSONDatabase(*args, **kwargs)
+        if kind == "indexed":
+            return IndexedDatabase(*args, **kwargs)  # type: ignore
         if kind == "memory":
             return MemoryDatabase(*args, **kwargs)  # type: ignore
         if kind == "union":
@@ -34,10 +34,13 @@ class JSONDatabase(Database):
         The path to the workload table.
     path_tuning_record : str
         The path to the tuning record table.
+    concurrent : bool
+        Whether the tables are shared with other processes committing to them.
     """
 
     path_workload: str
     path_tuning_record: str
+    concurrent: bool
 
     def __init__(
         self,
@@ -46,6 +49,7 @@ class JSONDatabase(Database):
         *,
         work_dir: Optional[str] = None,
         allow_missing: bool = True,
+        concurrent: bool = False,
     ) -> None:
         """Constructor.
 
@@ -62,6 +66,10 @@ class JSONDatabase(Database):
             and `path_workload`.
         allow_missing : bool
             Whether to create new file when the given path is not found.
+        concurrent : bool
+            Whether the tables are shared with other processes, possibly on other hosts of a
+            shared file system. If so, every access locks the tables and first loads the
+            records committed by the other processes.
         """
         if work_dir is not None:
             if path_workload is None:
@@ -77,4 +85,5 @@ class JSONDatabase(Database):
             path_workload,
             path_tuning_record,
             allow_missing,
+            concurrent,
         )
@@ -15,7 +15,7 @@
 # specific language governing permissions and limitations
 # under the License.
 """Meta Schedule FeatureExtractor."""
-from typing import Callable, List, Union
+from typing import Callable, List, Tuple, Union
 
 # isort: off
 from typing_extensions import Literal
@@ -60,6 +60,31 @@ class FeatureExtractor(Object):
         )
         return result
 
+    def extract_batch(
+        self, context: TuneContext, candidates: List[MeasureCandidate]
+    ) -> Tuple[NDArray, NDArray]:
+        """Extract the features of a batch of measure candidates into one contiguous buffer.
+
+        Parameters
+        ----------
+        context : TuneContext
+            The tuning context for feature extraction.
+        candidates : List[MeasureCandidate]
+            The measure candidates to extract features from.
+
+        Returns
+        -------
+        features : NDArray
+            The float32 features of all the candidates, of shape (num_rows, feature_length).
+        row_offsets : NDArray
+            The int64 offsets of the rows of each candidate, with the number of rows appended,
+            i.e. the features of candidate i are `features[row_offsets[i]:row_offsets[i + 1]]`.
+        """
+        result = _ffi_api.FeatureExtractorExtractBatch(  # type: ignore # pylint: disable=no-member
+            self, context, candidates
+        )
+        return result[0], result[1]
+
     @staticmethod
     def create(
         kind: Literal["per-store-feature"],
@@ -15,6 +15,7 @@
 # specific language governing permissions and limitations
 # under the License.
 """Meta schedule integration with high-level IR"""
+import json
 from typing import TYPE_CHECKING, Dict, List, Optional, Tuple, Union
 
 # isort: off
@@ -25,8 +26,11 @@ from typing_extensions import Literal
 from tvm._ffi import get_global_func, register_func
 from tvm.ir import IRModule
 from tvm.ir.transform import PassContext
+from tvm.ir import structural_hash
 from tvm.runtime import NDArray
+from tvm.runtime.profiling import Report
 from tvm.target import Target
+from tvm.tir import PrimFunc
 from tvm.tir.expr import IntImm
 
 from .builder import Builder
@@ -40,7 +44,7 @@ from .search_strategy import SearchStrategy
 from .space_generator import SpaceGenerator
 from .task_scheduler import TaskScheduler
 from .tune import tune_tasks
-from .tune_context import TuneContext
+from .tune_context import TuneContext, _normalize_mod
 from .utils import fork_seed
 
 if TYPE_CHECKING:
@@ -56,6 +60,7 @@ def extract_tasks(
     mod: Union[IRModule, "relax.Function"],
     target: Target,
     params: Optional[Dict[str, NDArray]] = None,
+    profile: Optional[Union[Report, Dict[str, float]]] = None,
 ) -> List[ExtractedTask]:
     """Extract tuning tasks from a relax program.
 
@@ -65,6 +70,11 @@ def extract_tasks(
         The module or function to tune
     target : tvm.target.Target
         The compilation target
+    params : Optional[Dict[str, tvm.runtime.NDArray]]
+        The associated parameters of the program
+    profile : Optional[Union[Report, Dict[str, float]]]
+        A runtime profile of the program. If given, the tasks are weighted by their share of the
+        measured time instead of their number of call sites, see `weight_tasks_by_profile`.
 
     Returns
     -------
@@ -82,7 +92,96 @@ def extract_tasks(
         target = Target(target)
     if params:
         mod = BindParams("main", params)(mod)
-    return list(_extract_task_func(mod, target))
+    tasks = list(_extract_task_func(mod, target))
+    if profile is not None:
+        tasks = weight_tasks_by_profile(tasks, mod, profile)
+    return tasks
+
+
+def _report_samples(report: Report) -> Dict[str, Tuple[int, float]]:
+    """The number of calls and the total time in microseconds of each kernel in a report"""
+    samples: Dict[str, Tuple[int, float]] = {}
+    for call in json.loads(report.json())["calls"]:
+        name = call["Name"]
+        count = int(call["Count"]["count"]) if "Count" in call else 1
+        duration = float(call["Duration (us)"]["microseconds"])
+        prev_count, prev_duration = samples.get(name, (0, 0.0))
+        samples[name] = (prev_count + count, prev_duration + duration)
+    return samples
+
+
+def _kernel_to_task(tasks: List[ExtractedTask], mod: IRModule) -> Dict[str, int]:
+    """Map the names of the kernels in the module to the indices of the tasks they come from.
+    The tasks are deduplicated by the structure of the kernels, and a kernel is known both by its
+    global var and its global symbol.
+    """
+    hash2task = {structural_hash(task.mod): i for i, task in enumerate(tasks)}
+    result: Dict[str, int] = {}
+    for global_var, func in mod.functions.items():
+        if not isinstance(func, PrimFunc):
+            continue
+        task_idx = hash2task.get(structural_hash(_normalize_mod(func)))
+        if task_idx is None:
+            continue
+        result[global_var.name_hint] = task_idx
+        if func.attrs is not None and "global_symbol" in func.attrs:
+            result[str(func.attrs["global_symbol"])] = task_idx
+    return result
+
+
+def weight_tasks_by_profile(
+    tasks: List[ExtractedTask],
+    mod: IRModule,
+    profile: Union[Report, Dict[str, float]],
+    scale: int = 1000,
+) -> List[ExtractedTask]:
+    """Weight the tasks by their share of the measured time in a runtime profile.
+
+    The call sites counted by `extract_tasks` miss how often each kernel actually runs, e.g. in
+    a loop or from entry points with very different call frequencies. A task is weighted by the
+    total time of the kernels it comes from, as `max(1, round(scale * share))`. The tasks whose
+    kernels are missing from the profile keep the minimal weight of 1.
+
+    Parameters
+    ----------
+    tasks : List[ExtractedTask]
+        The tasks extracted from the module
+    mod : IRModule
+        The module the tasks are extracted from
+    profile : Union[Report, Dict[str, float]]
+        The profiling report of running the module, e.g. collected with
+        `tvm.runtime.profiling.profile_function`, or a map from kernel names to their total time
+        in any unit
+    scale : int
+        The weight of a task taking the whole measured time
+
+    Returns
+    -------
+    tasks : List[ExtractedTask]
+        The tasks with the new weights
+    """
+    if isinstance(profile, Report):
+        kernel_times = {name: total for name, (_, total) in _report_samples(profile).items()}
+    else:
+        kernel_times = {str(k): float(v) for k, v in profile.items()}
+
+    task_times = [0.0] * len(tasks)
+    for name, task_idx in _kernel_to_task(tasks, mod).items():
+        task_times[task_idx] += kernel_times.get(name, 0.0)
+
+    total = sum(task_times)
+    if total <= 0.0:
+        return tasks
+    return [
+        ExtractedTask(
+            task_name=task.task_name,
+            mod=task.mod,
+            target=task.target,
+            dispatched=list(task.dispatched),
+            weight=max(1, round(scale * time / total)),
+        )
+        for task, time in zip(tasks, task_times)
+    ]
 
 
 def extracted_tasks_to_tune_contexts(
@@ -158,6 +257,10 @@ def tune_relax(
     space: SpaceGenerator.SpaceGeneratorType = "post-order-apply",
     strategy: SearchStrategy.SearchStrategyType = "evolutionary",
     seed: Optional[int] = None,
+    profile: Optional[Union[Report, Dict[str, float]]] = None,
+    max_tuning_time: Optional[float] = None,
+    convergence_window: int = 0,
+    convergence_threshold: float = 0.0,
 ) -> Database:
     """Tune a Relax program.
 
@@ -195,6 +298,17 @@ def tune_relax(
         The search strategy to use
     seed : Optional[int]
         The random seed
+    profile : Optional[Union[Report, Dict[str, float]]]
+        A runtime profile of the program, used to weight the tasks by their share of the
+        measured time. The tasks are weighted by their number of call sites if not given.
+    max_tuning_time : Optional[float]
+        The wall-clock budget of tuning in seconds. Unlimited if not provided.
+    convergence_window : int
+        The number of the latest trials of a task over which its best latency is checked for
+        convergence. A converged task stops and leaves its trials to the others. 0 disables it.
+    convergence_threshold : float
+        The relative improvement of the best latency over the window, at or below which a task
+        is considered converged.
 
     Returns
     -------
@@ -202,7 +316,7 @@ def tune_relax(
         The database that contains the tuning records
     """
     tasks, task_weights = extracted_tasks_to_tune_contexts(
-        extracted_tasks=extract_tasks(mod, target, params),
+        extracted_tasks=extract_tasks(mod, target, params, profile=profile),
         work_dir=work_dir,
         space=space,
         strategy=strategy,
@@ -221,6 +335,9 @@ def tune_relax(
         cost_model=cost_model,
         measure_callbacks=measure_callbacks,
         task_scheduler=task_scheduler,
+        max_tuning_time=max_tuning_time,
+        convergence_window=convergence_window,
+        convergence_threshold=convergence_threshold,
     )
 
 
@@ -231,6 +348,9 @@ def _tune_relax(
     target: Union[str, Target],
     work_dir: str,
     max_trials_global: int,
+    max_tuning_time: float = 0.0,
+    convergence_window: int = 0,
+    convergence_threshold: float = 0.0,
     *,
     max_trials_per_task: Optional[int] = None,
     num_trials_per_iter: int = 64,
@@ -258,6 +378,12 @@ def _tune_relax(
         The working directory to store the tuning records
     max_trials_global : int
         The maximum number of trials to run
+    max_tuning_time : float
+        The wall-clock budget of tuning in seconds, 0 for no limit
+    convergence_window : int
+        The number of trials over which a task is checked for convergence, 0 to disable it
+    convergence_threshold : float
+        The relative improvement at or below which a task is considered converged
     max_trials_per_task : Optional[int]
         The maximum number of trials to run for each task
     num_trials_per_iter : int
@@ -288,6 +414,10 @@ def _tune_relax(
     """
     if isinstance(max_trials_global, IntImm):
         max_trials_global = int(max_trials_global)
+    if isinstance(convergence_window, IntImm):
+        convergence_window = int(convergence_window)
+    max_tuning_time = float(max_tuning_time)
+    convergence_threshold = float(convergence_threshold)
 
     tune_relax(
         mod,
@@ -306,6 +436,9 @@ def _tune_relax(
         space=space,
         strategy=strategy,
         seed=seed,
+        max_tuning_time=max_tuning_time if max_tuning_time > 0 else None,
+        convergence_window=convergence_window,
+        convergence_threshold=convergence_threshold,
     )
     # Return original IRModule
     # This pass only makes optimization decision
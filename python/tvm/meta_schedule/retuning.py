@@ -0,0 +1,265 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Background retuning of the kernels of a Relax program driven by their measured latency"""
+import queue
+import threading
+from typing import Dict, List, Optional, Set, Tuple, Union
+
+# isort: off
+from typing_extensions import Literal
+
+# isort: on
+
+from tvm.ir import IRModule
+from tvm.runtime import NDArray
+from tvm.runtime.profiling import Report
+from tvm.target import Target
+from tvm.tir.analysis import estimate_tir_flops
+
+from .builder import Builder
+from .cost_model import CostModel
+from .database import JSONDatabase
+from .logging import get_logger
+from .measure_callback import MeasureCallback
+from .relax_integration import (
+    _kernel_to_task,
+    _report_samples,
+    extract_tasks,
+    extracted_tasks_to_tune_contexts,
+)
+from .runner import Runner
+from .tune import tune_tasks
+
+logger = get_logger(__name__)  # pylint: disable=invalid-name
+
+
+class RetuningService:
+    """Retune the kernels of a Relax program that are slow in production.
+
+    The service consumes the latency of the kernels observed while the program runs, e.g. the
+    reports of `tvm.runtime.profiling.profile_function` or samples fed by a telemetry exporter.
+    Once a kernel has enough samples, its throughput is compared to the roofline given by
+    `peak_gflops`, and the kernels below `efficiency_threshold` are queued for tuning. The queued
+    tasks are tuned one at a time, in a background thread after `start` or synchronously with
+    `process`, into the JSONDatabase in `work_dir`, so that the next build with
+    `relax.transform.MetaScheduleApplyDatabase(work_dir)` picks the improved kernels up. Each task
+    is queued at most once.
+
+    Parameters
+    ----------
+    mod : IRModule
+        The program running in production
+    target : Union[Target, str]
+        The target the program runs on
+    work_dir : str
+        The working directory of the tuning database and logs
+    peak_gflops : float
+        The peak throughput of the target in GFLOPS, the roofline of the kernels
+    params : Optional[Dict[str, NDArray]]
+        The associated parameters of the program
+    efficiency_threshold : float
+        The fraction of the roofline below which a kernel is retuned
+    min_samples : int
+        The number of calls of a kernel observed before it is judged
+    max_trials_per_task : int
+        The number of trials spent on each retuned task
+    num_trials_per_iter : int
+        The number of trials measured in one batch
+    builder : Builder.BuilderType
+        The builder
+    runner : Runner.RunnerType
+        The runner
+    cost_model : CostModel.CostModelType
+        The cost model
+    measure_callbacks : MeasureCallback.CallbackListType
+        The measure callbacks
+    seed : Optional[int]
+        The random seed
+    """
+
+    def __init__(
+        self,
+        mod: IRModule,
+        target: Union[Target, str],
+        work_dir: str,
+        peak_gflops: float,
+        *,
+        params: Optional[Dict[str, NDArray]] = None,
+        efficiency_threshold: float = 0.5,
+        min_samples: int = 10,
+        max_trials_per_task: int = 64,
+        num_trials_per_iter: int = 16,
+        builder: Builder.BuilderType = "local",
+        runner: Runner.RunnerType = "local",
+        cost_model: Union[Literal["xgb", "random"], CostModel] = "xgb",
+        measure_callbacks: MeasureCallback.CallbackListType = "default",
+        seed: Optional[int] = None,
+    ):
+        if peak_gflops <= 0:
+            raise ValueError(f"peak_gflops must be positive, but gets: {peak_gflops}")
+        self.work_dir = work_dir
+        self.peak_gflops = peak_gflops
+        self.efficiency_threshold = efficiency_threshold
+        self.min_samples = min_samples
+        self.max_trials_per_task = max_trials_per_task
+        self.num_trials_per_iter = num_trials_per_iter
+        self.builder = builder
+        self.runner = runner
+        self.cost_model = cost_model
+        self.measure_callbacks = measure_callbacks
+        self.seed = seed
+        self.tasks = extract_tasks(mod, target, params)
+        self.flops = [estimate_tir_flops(task.dispatched[0]) for task in self.tasks]
+        self._kernel2task = _kernel_to_task(self.tasks, mod)
+        # The number of calls and the total latency in seconds of each task
+        self._samples: List[Tuple[int, float]] = [(0, 0.0) for _ in self.tasks]
+        self._queued: Set[int] = set()
+        self._queue: "queue.Queue[Optional[int]]" = queue.Queue()
+        self._lock = threading.Lock()
+        self._thread: Optional[threading.Thread] = None
+        # The tables are created before the builds of the program read them
+        self._database = JSONDatabase(work_dir=work_dir, concurrent=True)
+
+    def record(self, kernel_name: str, latency_sec: float, count: int = 1) -> None:
+        """Record the total latency of `count` calls of a kernel.
+
+        Parameters
+        ----------
+        kernel_name : str
+            The global var or global symbol of the kernel. Unknown kernels are ignored.
+        latency_sec : float
+            The total latency of the calls in seconds
+        count : int
+            The number of calls
+        """
+        task_idx = self._kernel2task.get(kernel_name)
+        if task_idx is None:
+            return
+        with self._lock:
+            prev_count, prev_latency = self._samples[task_idx]
+            self._samples[task_idx] = (prev_count + count, prev_latency + latency_sec)
+            if task_idx in self._queued or prev_count + count < self.min_samples:
+                return
+            efficiency = self._efficiency(task_idx)
+            if efficiency is None or efficiency >= self.efficiency_threshold:
+                return
+            self._queued.add(task_idx)
+        logger.info(
+            "Queueing task %s for retuning, running at %.2f%% of the roofline",
+            self.tasks[task_idx].task_name,
+            efficiency * 100,
+        )
+        self._queue.put(task_idx)
+
+    def record_report(self, report: Report) -> None:
+        """Record the latency of the kernels in a profiling report.
+
+        Parameters
+        ----------
+        report : Report
+            The report, e.g. collected with `tvm.runtime.profiling.profile_function`
+        """
+        for name, (count, total_us) in _report_samples(report).items():
+            self.record(name, total_us * 1e-6, count)
+
+    def efficiency(self, kernel_name: str) -> Optional[float]:
+        """The measured throughput of a kernel as a fraction of the roofline.
+
+        Parameters
+        ----------
+        kernel_name : str
+            The global var or global symbol of the kernel
+
+        Returns
+        -------
+        efficiency : Optional[float]
+            The efficiency, None if the kernel is unknown, not sampled, or has no FLOP
+        """
+        task_idx = self._kernel2task.get(kernel_name)
+        if task_idx is None:
+            return None
+        with self._lock:
+            return self._efficiency(task_idx)
+
+    def _efficiency(self, task_idx: int) -> Optional[float]:
+        count, latency = self._samples[task_idx]
+        if count == 0 or latency <= 0 or self.flops[task_idx] <= 0:
+            return None
+        gflops = self.flops[task_idx] * count / latency / 1e9
+        return gflops / self.peak_gflops
+
+    def process(self, block: bool = False) -> int:
+        """Tune the queued tasks in the calling thread.
+
+        Parameters
+        ----------
+        block : bool
+            Whether to wait for new tasks until `stop` is called
+
+        Returns
+        -------
+        num_tuned : int
+            The number of tasks tuned
+        """
+        num_tuned = 0
+        while True:
+            try:
+                task_idx = self._queue.get(block=block)
+            except queue.Empty:
+                return num_tuned
+            if task_idx is None:
+                return num_tuned
+            self._tune(task_idx)
+            num_tuned += 1
+
+    def _tune(self, task_idx: int) -> None:
+        task = self.tasks[task_idx]
+        tasks, task_weights = extracted_tasks_to_tune_contexts(
+            extracted_tasks=[task],
+            work_dir=self.work_dir,
+            seed=self.seed,
+        )
+        try:
+            tune_tasks(
+                tasks=tasks,
+                task_weights=task_weights,
+                work_dir=self.work_dir,
+                max_trials_global=self.max_trials_per_task,
+                num_trials_per_iter=self.num_trials_per_iter,
+                builder=self.builder,
+                runner=self.runner,
+                database=self._database,
+                cost_model=self.cost_model,
+                measure_callbacks=self.measure_callbacks,
+            )
+        except Exception:  # pylint: disable=broad-except
+            logger.exception("Failed to retune task %s", task.task_name)
+
+    def start(self) -> None:
+        """Start tuning the queued tasks in a background thread."""
+        if self._thread is not None:
+            return
+        self._thread = threading.Thread(target=self.process, args=(True,), daemon=True)
+        self._thread.start()
+
+    def stop(self) -> None:
+        """Stop the background thread once the tasks queued so far are tuned."""
+        if self._thread is None:
+            return
+        self._queue.put(None)
+        self._thread.join()
+        self._thread = None
@@ -41,6 +41,23 @@ class EvaluatorConfig(NamedTuple):
         increase the number of runs to the given time (in ms) to reduce the measurement error.
     enable_cpu_cache_flush: bool
         Whether to flush the cache on CPU.
+    max_repeat: Optional[int]
+        If set, measure adaptively, one repeat at a time: a candidate stops being measured once it
+        is statistically slower than `best_cost`, and otherwise is measured for at least `repeat`
+        and at most `max_repeat` repeats, until the standard error of its mean cost is below
+        `max_relative_error` of the mean. Without `best_cost` to stop against, the repeats of a
+        single set of arguments run in one call to the statistical mode of `time_evaluator`,
+        which calibrates the runs of a repeat from `min_repeat_ms` instead of `number`.
+    z_score: float
+        The width of the confidence interval of the adaptive measurement, in standard errors.
+    max_relative_error: float
+        The target standard error of the mean cost of the adaptive measurement, relative to it.
+    best_cost: Optional[float]
+        The mean cost in seconds of the best candidate measured so far, which is filled by the
+        runner in adaptive mode.
+    enable_gpu_cache_flush: bool
+        Whether to overwrite the L2 cache of CUDA and ROCm devices between the repeats, so that
+        the kernels are measured with cold caches as in the runs of a full model.
 
     Note
     ----
@@ -52,6 +69,11 @@ class EvaluatorConfig(NamedTuple):
     repeat: int = 1
     min_repeat_ms: int = 100
     enable_cpu_cache_flush: bool = False
+    max_repeat: Optional[int] = None
+    z_score: float = 1.96
+    max_relative_error: float = 0.02
+    best_cost: Optional[float] = None
+    enable_gpu_cache_flush: bool = False
 
     @staticmethod
     def _normalized(config: Optional["EvaluatorConfig"]) -> "EvaluatorConfig":
@@ -62,7 +84,16 @@ class EvaluatorConfig(NamedTuple):
             repeat=config.repeat,
             min_repeat_ms=config.min_repeat_ms,
             enable_cpu_cache_flush=config.enable_cpu_cache_flush,
+            max_repeat=config.max_repeat,
+            z_score=config.z_score,
+            max_relative_error=config.max_relative_error,
+            best_cost=config.best_cost,
+            enable_gpu_cache_flush=config.enable_gpu_cache_flush,
         )
+        if config.max_repeat is not None and config.max_repeat < max(config.repeat, 2):
+            raise ValueError(
+                f"Expect max_repeat to be at least max(repeat, 2), but got {config.max_repeat}"
+            )
         return config
 
 
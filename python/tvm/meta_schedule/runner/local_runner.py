@@ -282,13 +282,20 @@ class LocalRunner(PyRunner):
 
     def run(self, runner_inputs: List[RunnerInput]) -> List[RunnerFuture]:
         results: List[RunnerFuture] = []
+        # In adaptive mode, the candidates of the batch are early stopped against the best one
+        # measured so far in the batch, since a batch comes from a single task
+        adaptive = self.evaluator_config.max_repeat is not None
+        best_cost: Optional[float] = None
         for runner_input in runner_inputs:
+            evaluator_config = self.evaluator_config
+            if adaptive:
+                evaluator_config = evaluator_config._replace(best_cost=best_cost)
             future = self.pool.submit(
                 _worker_func,
                 self.f_alloc_argument,
                 self.f_run_evaluator,
                 self.f_cleanup,
-                self.evaluator_config,
+                evaluator_config,
                 self.alloc_repeat,
                 str(runner_input.artifact_path),
                 str(runner_input.device_type),
@@ -303,6 +310,10 @@ class LocalRunner(PyRunner):
             except Exception as exception:  # pylint: disable=broad-except
                 result = None
                 error_message = "LocalRunner: An exception occurred\n" + str(exception)
+            if adaptive and result:
+                mean = sum(result) / len(result)
+                if best_cost is None or mean < best_cost:
+                    best_cost = mean
             local_future = LocalRunnerFuture(res=result, error_message=error_message)
             results.append(local_future)  # type: ignore
         return results
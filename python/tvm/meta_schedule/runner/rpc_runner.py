@@ -16,10 +16,12 @@
 # under the License.
 """RPC Runner"""
 import concurrent.futures
+import json
 import os.path as osp
 from contextlib import contextmanager
-from typing import Callable, List, Optional, Union
+from typing import Any, Callable, Dict, List, Optional, Union
 
+from tvm._ffi.runtime_ctypes import RPC_SESS_MASK
 from tvm.contrib.popen_pool import PopenPoolExecutor
 from tvm.rpc import RPCSession
 from tvm.runtime import Device, Module
@@ -38,6 +40,7 @@ from .utils import (
     T_ARG_INFO_JSON_OBJ_LIST,
     T_ARGUMENT_LIST,
     alloc_argument_common,
+    cache_flush_preproc,
     run_evaluator_common,
 )
 
@@ -94,12 +97,20 @@ class RPCRunnerFuture(PyRunnerFuture):
         The concurrent function to check when the function is done and to return the result.
     timeout_sec: float
         The timeout in seconds.
+    index: Optional[int]
+        The index of the result in the results of a batch, or None if the future is not batched.
     """
 
     future: concurrent.futures.Future
     timeout_sec: float
+    index: Optional[int]
 
-    def __init__(self, future: concurrent.futures.Future, timeout_sec: float) -> None:
+    def __init__(
+        self,
+        future: concurrent.futures.Future,
+        timeout_sec: float,
+        index: Optional[int] = None,
+    ) -> None:
         """Constructor
 
         Parameters
@@ -108,17 +119,25 @@ class RPCRunnerFuture(PyRunnerFuture):
             The concurrent function to check when the function is done and to return the result.
         timeout_sec: float
             The timeout in seconds.
+        index: Optional[int]
+            The index of the result in the results of a batch, or None if the future is not
+            batched.
         """
         super().__init__()
         self.future = future
         self.timeout_sec = timeout_sec
+        self.index = index
 
     def done(self) -> bool:
         return self.future.done()
 
     def result(self) -> RunnerResult:
         try:
-            run_secs: List[float] = self.future.result()
+            run_secs: Union[List[float], str] = self.future.result()
+            if self.index is not None:
+                run_secs = run_secs[self.index]
+            if isinstance(run_secs, str):
+                raise RuntimeError(run_secs)
         except TimeoutError:
             return RunnerResult(
                 None,
@@ -156,6 +175,12 @@ class RPCRunner(PyRunner):
         The function name to run the evaluator or the function itself.
     f_cleanup: Optional[str, Callable]
         The function name to cleanup the session or the function itself.
+    batch_size: int
+        The number of candidates measured in a single session by one call to the server, which
+        amortizes the round trips of the measurement of fast kernels.
+    cache_arguments: bool
+        Whether to reuse the randomly filled arguments kept by the server for the candidates of
+        the same argument shapes, instead of allocating and filling them for each candidate.
     pool: PopenPoolExecutor
         The popen pool executor.
 
@@ -230,6 +255,8 @@ class RPCRunner(PyRunner):
     f_alloc_argument: Union[T_ALLOC_ARGUMENT, str, None]
     f_run_evaluator: Union[T_RUN_EVALUATOR, str, None]
     f_cleanup: Union[T_CLEANUP, str, None]
+    batch_size: int
+    cache_arguments: bool
 
     pool: PopenPoolExecutor
 
@@ -244,6 +271,8 @@ class RPCRunner(PyRunner):
         f_alloc_argument: Union[T_ALLOC_ARGUMENT, str, None] = None,
         f_run_evaluator: Union[T_RUN_EVALUATOR, str, None] = None,
         f_cleanup: Union[T_CLEANUP, str, None] = None,
+        batch_size: int = 1,
+        cache_arguments: bool = False,
         max_workers: Optional[int] = None,
         initializer: Optional[Callable[[], None]] = None,
     ) -> None:
@@ -269,6 +298,17 @@ class RPCRunner(PyRunner):
             The function name to run the evaluator or the function itself.
         f_cleanup: Union[T_CLEANUP, str, None]
             The function name to cleanup the session or the function itself.
+        batch_size: int
+            The number of candidates measured in a single session. The candidates of a batch
+            are uploaded, and then measured back to back on the server by a single call of
+            `tvm.rpc.server.BatchMeasure`, which returns all of their costs at once. Batching
+            requires the default `f_upload_module`, `f_alloc_argument` and `f_run_evaluator`,
+            and a fixed number of repeats of the evaluator. A server without the batch function
+            measures the candidates of the batch one by one in the session.
+        cache_arguments: bool
+            Whether to reuse the randomly filled arguments kept by the server for the
+            candidates of the same argument shapes, see `cached_alloc_argument`. It applies to
+            the default `f_alloc_argument` only.
         max_workers: Optional[int] = None
             The maximum number of connections. Defaults to number of logical CPU cores.
         initializer: Optional[Callable[[], None]]
@@ -284,6 +324,21 @@ class RPCRunner(PyRunner):
         self.f_alloc_argument = f_alloc_argument
         self.f_run_evaluator = f_run_evaluator
         self.f_cleanup = f_cleanup
+        if batch_size < 1:
+            raise ValueError(f"Expect batch_size to be positive, but got {batch_size}")
+        if batch_size > 1 and (
+            f_upload_module is not None
+            or f_alloc_argument is not None
+            or f_run_evaluator is not None
+            or self.evaluator_config.max_repeat is not None
+        ):
+            logger.warning(
+                "RPCRunner: batch_size is ignored with custom upload, allocation or evaluator "
+                "functions, or with an adaptive number of repeats"
+            )
+            batch_size = 1
+        self.batch_size = batch_size
+        self.cache_arguments = cache_arguments
         if max_workers is None:
             max_workers = cpu_count(logical=True)
         logger.info("RPCRunner: max_workers = %d", max_workers)
@@ -295,6 +350,8 @@ class RPCRunner(PyRunner):
         self._sanity_check()
 
     def run(self, runner_inputs: List[RunnerInput]) -> List[RunnerFuture]:
+        if self.batch_size > 1:
+            return self._run_batched(runner_inputs)
         results: List[RunnerFuture] = []
         for runner_input in runner_inputs:
             future = RPCRunnerFuture(
@@ -308,6 +365,7 @@ class RPCRunner(PyRunner):
                     self.rpc_config,
                     self.evaluator_config,
                     self.alloc_repeat,
+                    self.cache_arguments,
                     str(runner_input.artifact_path),
                     str(runner_input.device_type),
                     tuple(arg_info.as_json() for arg_info in runner_input.args_info),
@@ -317,6 +375,36 @@ class RPCRunner(PyRunner):
             results.append(future)  # type: ignore
         return results
 
+    def _run_batched(self, runner_inputs: List[RunnerInput]) -> List[RunnerFuture]:
+        results: List[RunnerFuture] = []
+        for begin in range(0, len(runner_inputs), self.batch_size):
+            batch = runner_inputs[begin : begin + self.batch_size]
+            future = self.pool.submit(
+                _batch_worker_func,
+                self.f_create_session,
+                self.f_cleanup,
+                self.rpc_config,
+                self.evaluator_config,
+                self.alloc_repeat,
+                self.cache_arguments,
+                [str(runner_input.artifact_path) for runner_input in batch],
+                str(batch[0].device_type),
+                [
+                    tuple(arg_info.as_json() for arg_info in runner_input.args_info)
+                    for runner_input in batch
+                ],
+            )
+            for index in range(len(batch)):
+                results.append(
+                    RPCRunnerFuture(
+                        future=future,
+                        # the session measures the whole batch before replying
+                        timeout_sec=self.rpc_config.session_timeout_sec * len(batch),
+                        index=index,
+                    )
+                )
+        return results  # type: ignore
+
     def _sanity_check(self) -> None:
         def _check(
             f_create_session,
@@ -351,6 +439,7 @@ def _worker_func(
     rpc_config: RPCConfig,
     evaluator_config: EvaluatorConfig,
     alloc_repeat: int,
+    cache_arguments: bool,
     artifact_path: str,
     device_type: str,
     args_info: T_ARG_INFO_JSON_OBJ_LIST,
@@ -363,7 +452,7 @@ def _worker_func(
         _f_upload_module, default_upload_module
     )
     f_alloc_argument: T_ALLOC_ARGUMENT = get_global_func_with_default_on_worker(
-        _f_alloc_argument, default_alloc_argument
+        _f_alloc_argument, cached_alloc_argument if cache_arguments else default_alloc_argument
     )
     f_run_evaluator: T_RUN_EVALUATOR = get_global_func_with_default_on_worker(
         _f_run_evaluator, default_run_evaluator
@@ -412,6 +501,91 @@ def _worker_func(
     return costs
 
 
+def _batch_worker_func(
+    _f_create_session: Union[T_CREATE_SESSION, str, None],
+    _f_cleanup: Union[T_CLEANUP, str, None],
+    rpc_config: RPCConfig,
+    evaluator_config: EvaluatorConfig,
+    alloc_repeat: int,
+    cache_arguments: bool,
+    artifact_paths: List[str],
+    device_type: str,
+    args_infos: List[T_ARG_INFO_JSON_OBJ_LIST],
+) -> List[Union[List[float], str]]:
+    f_create_session: T_CREATE_SESSION = get_global_func_with_default_on_worker(
+        _f_create_session, default_create_session
+    )
+    f_cleanup: T_CLEANUP = get_global_func_with_default_on_worker(_f_cleanup, default_cleanup)
+    session: Optional[RPCSession] = None
+    remote_paths: List[str] = []
+    try:
+        with Profiler.timeit("RPCRunner/create_session"):
+            session = f_create_session(rpc_config)
+            device = session.device(dev_type=device_type, dev_id=0)
+        with Profiler.timeit("RPCRunner/upload_module"):
+            for artifact_path in artifact_paths:
+                _, remote_path = osp.split(artifact_path)
+                session.upload(artifact_path, remote_path)
+                remote_paths.append(remote_path)
+        try:
+            f_batch_measure = session.get_function("tvm.rpc.server.BatchMeasure")
+        except AttributeError:
+            f_batch_measure = None
+        if f_batch_measure is None:
+            f_alloc_argument = (
+                cached_alloc_argument if cache_arguments else default_alloc_argument
+            )
+            return _measure_one_by_one(
+                session,
+                device,
+                f_alloc_argument,
+                evaluator_config,
+                alloc_repeat,
+                remote_paths,
+                args_infos,
+            )
+        with Profiler.timeit("RPCRunner/batch_measure"):
+            results = f_batch_measure(
+                json.dumps([list(spec) for spec in zip(remote_paths, args_infos)]),
+                # the device on the server, without the mask of the session
+                device.device_type % RPC_SESS_MASK,
+                device.device_id,
+                evaluator_config.number,
+                evaluator_config.repeat,
+                evaluator_config.min_repeat_ms,
+                cache_flush_preproc(evaluator_config, device),
+                alloc_repeat,
+                cache_arguments,
+            )
+        return json.loads(results)
+    finally:
+        with Profiler.timeit("RPCRunner/cleanup"):
+            for remote_path in remote_paths or [None]:
+                f_cleanup(session, remote_path)
+
+
+def _measure_one_by_one(
+    session: RPCSession,
+    device: Device,
+    f_alloc_argument: T_ALLOC_ARGUMENT,
+    evaluator_config: EvaluatorConfig,
+    alloc_repeat: int,
+    remote_paths: List[str],
+    args_infos: List[T_ARG_INFO_JSON_OBJ_LIST],
+) -> List[Union[List[float], str]]:
+    results: List[Union[List[float], str]] = []
+    for remote_path, args_info in zip(remote_paths, args_infos):
+        try:
+            rt_mod: Module = session.load_module(remote_path)
+            repeated_args = f_alloc_argument(session, device, args_info, alloc_repeat)
+            results.append(
+                default_run_evaluator(session, rt_mod, device, evaluator_config, repeated_args)
+            )
+        except Exception as exception:  # pylint: disable=broad-except
+            results.append(str(exception))
+    return results
+
+
 def default_create_session(rpc_config: RPCConfig) -> RPCSession:
     """Default function to create the session
 
@@ -487,6 +661,56 @@ def default_alloc_argument(
     return alloc_argument_common(f_random_fill, device, args_info, alloc_repeat)
 
 
+def cached_alloc_argument(
+    session: RPCSession,
+    device: Device,
+    args_info: T_ARG_INFO_JSON_OBJ_LIST,
+    alloc_repeat: int,
+) -> List[T_ARGUMENT_LIST]:
+    """Allocation function taking the arguments from the argument cache of the server
+
+    The server keeps the randomly filled arrays it hands out, keyed by their device, type and
+    shape, so that the candidates of the same workload reuse them instead of allocating and
+    filling again. The arguments of a candidate never alias each other. The cache lives as
+    long as the server process; servers forking a process per session keep it for a session.
+
+    Parameters
+    ----------
+    session: RPCSession
+        The session to allocate the arguments
+    device: Device
+        The device to allocate the arguments
+    args_info: T_ARG_INFO_JSON_OBJ_LIST
+        The arguments info
+    alloc_repeat: int
+        The number of times to repeat the allocation
+
+    Returns
+    -------
+    repeated_args: List[T_ARGUMENT_LIST]
+        The allocation args
+    """
+    try:
+        f_get_cached = session.get_function("tvm.rpc.server.GetCachedArgument")
+    except AttributeError:
+        logger.warning("RPCRunner: The server has no argument cache, allocating the arguments")
+        return default_alloc_argument(session, device, args_info, alloc_repeat)
+
+    slots: Dict[Any, int] = {}
+    repeated_args: List[T_ARGUMENT_LIST] = []
+    for _ in range(alloc_repeat):
+        args: T_ARGUMENT_LIST = []
+        for arg_info in args_info:
+            if arg_info[0] != "TENSOR":
+                raise NotImplementedError(arg_info)
+            _, dtype, shape = arg_info
+            key = (dtype, tuple(shape))
+            slot = slots.get(key, 0)
+            slots[key] = slot + 1
+            args.append(f_get_cached(device, dtype, slot, *shape))
+        repeated_args.append(args)
+    return repeated_args
+
 def default_run_evaluator(
     session: RPCSession,  # pylint: disable=unused-argument
     rt_mod: Module,
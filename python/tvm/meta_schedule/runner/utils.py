@@ -16,8 +16,10 @@
 # under the License.
 """Runner utility functions"""
 import itertools
-from typing import Any, Callable, Dict, List
+import math
+from typing import Any, Callable, Dict, List, Optional, Sequence, Tuple
 
+from ..._ffi.runtime_ctypes import RPC_SESS_MASK
 from ...runtime import Device, Module, ndarray
 from .config import EvaluatorConfig
 
@@ -26,6 +28,12 @@ T_ARG_INFO_JSON_OBJ_LIST = List[T_ARG_INFO_JSON_OBJ]  # pylint: disable=invalid-
 T_ARGUMENT = Any  # pylint: disable=invalid-name
 T_ARGUMENT_LIST = List[T_ARGUMENT]  # pylint: disable=invalid-name
 
+# The functions overwriting the L2 cache of the GPUs, by device type
+_GPU_CACHE_FLUSH = {
+    Device.STR2MASK["cuda"]: "cache_flush_cuda_l2",
+    Device.STR2MASK["rocm"]: "cache_flush_rocm_l2",
+}
+
 
 def alloc_argument_common(
     f_random_fill: Callable,
@@ -101,15 +109,15 @@ def run_evaluator_common(
     costs: List[float]
         The evaluator results
     """
+    if evaluator_config.max_repeat is not None:
+        return _run_evaluator_adaptive(rt_mod, device, evaluator_config, repeated_args)
     evaluator = rt_mod.time_evaluator(
         func_name=rt_mod.entry_name,
         dev=device,
         number=evaluator_config.number,
         repeat=evaluator_config.repeat,
         min_repeat_ms=evaluator_config.min_repeat_ms,
-        f_preproc="cache_flush_cpu_non_first_arg"
-        if evaluator_config.enable_cpu_cache_flush
-        else "",
+        f_preproc=cache_flush_preproc(evaluator_config, device),
     )
     repeated_costs: List[List[float]] = []
     for args in repeated_args:
@@ -118,3 +126,96 @@ def run_evaluator_common(
         repeated_costs.append(profile_result.results)
     costs = [float(cost) for cost in itertools.chain.from_iterable(repeated_costs)]
     return costs
+
+
+def cache_flush_preproc(evaluator_config: EvaluatorConfig, device: Device) -> str:
+    """The function flushing the caches of the device before each repeat.
+
+    Parameters
+    ----------
+    evaluator_config : EvaluatorConfig
+        The evaluator config.
+    device : Device
+        The device, possibly remote.
+
+    Returns
+    -------
+    f_preproc : str
+        The name of the function, empty for none.
+    """
+    # the device on the server, without the mask of the session
+    device_type = device.device_type % RPC_SESS_MASK
+    if device_type in _GPU_CACHE_FLUSH:
+        return _GPU_CACHE_FLUSH[device_type] if evaluator_config.enable_gpu_cache_flush else ""
+    return "cache_flush_cpu_non_first_arg" if evaluator_config.enable_cpu_cache_flush else ""
+
+
+def mean_and_stderr(costs: Sequence[float]) -> Tuple[float, float]:
+    """The mean of the measured costs and its standard error.
+
+    Parameters
+    ----------
+    costs : Sequence[float]
+        The measured costs.
+
+    Returns
+    -------
+    mean : float
+        The mean of the costs.
+    stderr : float
+        The standard error of the mean, which is infinite with less than two costs.
+    """
+    n = len(costs)
+    mean = sum(costs) / n
+    if n < 2:
+        return mean, math.inf
+    variance = sum((cost - mean) ** 2 for cost in costs) / (n - 1)
+    return mean, math.sqrt(variance / n)
+
+
+def _run_evaluator_adaptive(
+    rt_mod: Module,
+    device: Device,
+    evaluator_config: EvaluatorConfig,
+    repeated_args: List[T_ARGUMENT_LIST],
+) -> List[float]:
+    """Measure one repeat at a time, until the candidate is either statistically slower than the
+    best one, or measured precisely enough."""
+    f_preproc = cache_flush_preproc(evaluator_config, device)
+    if evaluator_config.best_cost is None and len(repeated_args) == 1:
+        # Nothing to stop early against, so the remote repeats until the mean is precise enough
+        evaluator = rt_mod.time_evaluator(
+            func_name=rt_mod.entry_name,
+            dev=device,
+            repeat=evaluator_config.repeat,
+            min_repeat_ms=evaluator_config.min_repeat_ms,
+            f_preproc=f_preproc,
+            max_repeat=evaluator_config.max_repeat,
+            max_relative_error=evaluator_config.max_relative_error,
+        )
+        device.sync()
+        return [float(cost) for cost in evaluator(*repeated_args[0]).results]
+    evaluator = rt_mod.time_evaluator(
+        func_name=rt_mod.entry_name,
+        dev=device,
+        number=evaluator_config.number,
+        repeat=1,
+        min_repeat_ms=evaluator_config.min_repeat_ms,
+        f_preproc=f_preproc,
+    )
+    best_cost: Optional[float] = evaluator_config.best_cost
+    z_score = evaluator_config.z_score
+    min_repeat = max(evaluator_config.repeat, 2)
+    costs: List[float] = []
+    while len(costs) < evaluator_config.max_repeat:
+        args = repeated_args[len(costs) % len(repeated_args)]
+        device.sync()
+        costs.extend(float(cost) for cost in evaluator(*args).results)
+        mean, stderr = mean_and_stderr(costs)
+        if best_cost is not None and mean - z_score * stderr > best_cost:
+            # Statistically slower than the best candidate
+            break
+        if len(costs) >= min_repeat and stderr <= evaluator_config.max_relative_error * mean:
+            # Measured precisely enough
+            break
+    return costs
@@ -62,6 +62,8 @@ class TaskScheduler(Object):
     database_: Optional[Database]
     cost_model_: Optional[CostModel]
     remaining_tasks_: int
+    pipeline_chunk_size: int
+    max_unmeasured_candidates: int
 
     TaskSchedulerType = Union["TaskScheduler", Literal["gradient", "round-robin"]]
 
@@ -173,6 +175,65 @@ class TaskScheduler(Object):
         """
         return _ffi_api.TaskSchedulerTuningStatistics(self)  # type: ignore # pylint: disable=no-member
 
+    def set_pipeline(self, chunk_size: int, max_unmeasured_candidates: int = 0) -> None:
+        """Build and measure the candidates chunk by chunk, so that the runner measures a chunk
+        while the builder builds the next one.
+
+        Parameters
+        ----------
+        chunk_size : int
+            The number of candidates built and sent to the runner at a time. 0 builds each
+            batch as a whole.
+        max_unmeasured_candidates : int
+            The maximum number of candidates sent to the runner but not measured yet, over which
+            building the next chunk waits for the runner. 0 means no limit.
+        """
+        _ffi_api.TaskSchedulerSetPipeline(  # type: ignore # pylint: disable=no-member
+            self, chunk_size, max_unmeasured_candidates
+        )
+
+    def set_measure_cache(self, path: str) -> None:
+        """Cache the run time of the measured candidates in a file, keyed by the structural hash
+        of their scheduled module and the target, so that the candidates identical to those
+        measured in this or previous sessions are neither rebuilt nor remeasured.
+
+        Parameters
+        ----------
+        path : str
+            The path to the measure cache, which is created if missing. Empty to disable the cache.
+        """
+        _ffi_api.TaskSchedulerSetMeasureCache(  # type: ignore # pylint: disable=no-member
+            self, path
+        )
+
+    def set_stopping(
+        self,
+        max_tuning_time_sec: float = 0.0,
+        convergence_window: int = 0,
+        convergence_threshold: float = 0.0,
+        log_path: str = "",
+    ) -> None:
+        """Stop tuning once the wall-clock budget is spent, and stop the tasks whose best latency
+        has plateaued, so that their trials go to the tasks still improving.
+
+        Parameters
+        ----------
+        max_tuning_time_sec : float
+            The wall-clock budget of tuning in seconds. 0 means no limit.
+        convergence_window : int
+            The number of the latest trials of a task over which its best latency is checked for
+            convergence. 0 disables the convergence-based stopping.
+        convergence_threshold : float
+            The relative improvement of the best latency over the window, at or below which a
+            task is considered converged.
+        log_path : str
+            The path to append the stopping decisions to, one JSON line per decision. Empty if
+            they are not recorded.
+        """
+        _ffi_api.TaskSchedulerSetStopping(  # type: ignore # pylint: disable=no-member
+            self, max_tuning_time_sec, convergence_window, convergence_threshold, log_path
+        )
+
     @staticmethod
     def create(  # pylint: disable=keyword-arg-before-vararg
         kind: Literal["round-robin", "gradient"] = "gradient",
@@ -119,6 +119,7 @@ def run_with_graph_executor(
     import itertools
 
     from tvm.contrib.graph_executor import GraphModule
+    from tvm.meta_schedule.runner.utils import cache_flush_preproc
 
     graph_mod = GraphModule(rt_mod["default"](device))
     evaluator = graph_mod.module.time_evaluator(
@@ -127,9 +128,7 @@ def run_with_graph_executor(
         number=evaluator_config.number,
         repeat=evaluator_config.repeat,
         min_repeat_ms=evaluator_config.min_repeat_ms,
-        f_preproc="cache_flush_cpu_non_first_arg"
-        if evaluator_config.enable_cpu_cache_flush
-        else "",
+        f_preproc=cache_flush_preproc(evaluator_config, device),
     )
     repeated_costs = []
     for args in repeated_args:
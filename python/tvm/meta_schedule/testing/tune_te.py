@@ -86,6 +86,13 @@ def _parse_args():
         help="example: True / False",
         default=True,
     )
+    args.add_argument(
+        "--pretrain-work-dir",
+        type=str,
+        required=False,
+        help="The work directory of a previous tuning session to warm start the cost model",
+        default=None,
+    )
     args.add_argument(
         "--cpu-flush",
         type=lambda x: bool(strtobool(x)),
@@ -113,6 +120,14 @@ ARGS = _parse_args()
 def main():
     describe()
     print(f"Workload: {ARGS.workload}")
+    cost_model = ms.cost_model.XGBModel(  # type: ignore
+        extractor=ms.feature_extractor.PerStoreFeature(),
+        adaptive_training=ARGS.adaptive_training,
+    )
+    if ARGS.pretrain_work_dir is not None:
+        cost_model.pretrain(
+            ms.database.JSONDatabase(work_dir=ARGS.pretrain_work_dir, allow_missing=False)
+        )
     with ms.Profiler() as profiler:
         sch: Optional[tir.Schedule] = ms.tir_integration.tune_tir(
             mod=create_te_workload(ARGS.workload, 0),
@@ -130,10 +145,7 @@ def main():
                 ),
                 alloc_repeat=1,
             ),
-            cost_model=ms.cost_model.XGBModel(  # type: ignore
-                extractor=ms.feature_extractor.PerStoreFeature(),
-                adaptive_training=ARGS.adaptive_training,
-            ),
+            cost_model=cost_model,
             strategy=ms.search_strategy.EvolutionarySearch(),
             task_name=ARGS.workload,
         )
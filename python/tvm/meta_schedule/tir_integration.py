@@ -15,7 +15,8 @@
 # specific language governing permissions and limitations
 # under the License.
 """MetaSchedule-TIR integration"""
-from typing import Optional, Union
+import math
+from typing import Dict, List, Optional, Sequence, Tuple, Union
 
 # isort: off
 from typing_extensions import Literal
@@ -23,21 +24,24 @@ from typing_extensions import Literal
 # isort: on
 from tvm import ir, tir
 from tvm._ffi import register_func
+from tvm._ffi.base import TVMError
 from tvm.target import Target
 from tvm.tir.expr import IntImm
+from tvm.tir.schedule import Trace
 
-from .builder import Builder
+from .arg_info import ArgInfo
+from .builder import Builder, BuilderInput
 from .cost_model import CostModel
-from .database import Database
+from .database import Database, TuningRecord
 from .logging import get_loggers_from_work_dir
 from .measure_callback import MeasureCallback
-from .runner import Runner
+from .runner import Runner, RunnerInput
 from .search_strategy import SearchStrategy
 from .space_generator import SpaceGenerator
 from .task_scheduler import TaskScheduler
 from .tune import tune_tasks
 from .tune_context import TuneContext, _normalize_mod
-from .utils import fork_seed
+from .utils import fork_seed, remove_build_dir
 
 
 def tune_tir(
@@ -242,3 +246,357 @@ def compile_tir(
     if not isinstance(target, Target):
         target = Target(target)
     return database.query_schedule(mod, target, workload_name="main")
+
+
+def sample_shape_values(
+    ranges: Dict[str, Tuple[int, int]],
+    num_samples: int,
+) -> List[Dict[str, int]]:
+    """Sample representative values of symbolic shape variables. The values are spaced
+    geometrically within each range, so that small shapes are sampled as densely as large ones.
+
+    Parameters
+    ----------
+    ranges : Dict[str, Tuple[int, int]]
+        The inclusive range of each symbolic variable, keyed by its name.
+    num_samples : int
+        The number of samples to draw.
+
+    Returns
+    -------
+    shape_samples : List[Dict[str, int]]
+        The distinct samples, each mapping variable names to concrete values.
+    """
+    if num_samples < 1:
+        raise ValueError(f"Expect num_samples to be positive, but got {num_samples}")
+    for name, (low, high) in ranges.items():
+        if not 1 <= low <= high:
+            raise ValueError(f"Invalid range of {name}: [{low}, {high}]")
+    shape_samples: List[Dict[str, int]] = []
+    for i in range(num_samples):
+        ratio = i / (num_samples - 1) if num_samples > 1 else 1.0
+        sample = {
+            name: int(round(math.exp(math.log(low) + ratio * (math.log(high) - math.log(low)))))
+            for name, (low, high) in ranges.items()
+        }
+        if sample not in shape_samples:
+            shape_samples.append(sample)
+    return shape_samples
+
+
+def specialize_shape_vars(
+    mod: Union[ir.IRModule, tir.PrimFunc],
+    values: Dict[str, int],
+) -> ir.IRModule:
+    """Specialize the symbolic shape variables of a TIR function to concrete values.
+
+    Parameters
+    ----------
+    mod : Union[ir.IRModule, tir.PrimFunc]
+        The TIR function with symbolic shapes.
+    values : Dict[str, int]
+        The concrete values, keyed by the name of the symbolic variables.
+
+    Returns
+    -------
+    mod : IRModule
+        The IRModule whose "main" function has the given shape.
+    """
+    func = _normalize_mod(mod)["main"]
+    var_map: Dict[tir.Var, ir.PrimExpr] = {}
+
+    def _specialize(expr: ir.PrimExpr) -> ir.PrimExpr:
+        if isinstance(expr, tir.Var) and expr.name in values:
+            value = IntImm(expr.dtype, values[expr.name])
+            var_map[expr] = value
+            return value
+        return expr
+
+    param_map: Dict[tir.Var, Union[ir.PrimExpr, tir.Buffer]] = {}
+    for param in func.params:
+        if param in func.buffer_map:
+            buffer = func.buffer_map[param]
+            if any(isinstance(dim, tir.Var) and dim.name in values for dim in buffer.shape):
+                param_map[param] = tir.decl_buffer(
+                    [_specialize(dim) for dim in buffer.shape],
+                    buffer.dtype,
+                    buffer.name,
+                    strides=buffer.strides,
+                    elem_offset=buffer.elem_offset,
+                    scope=buffer.scope(),
+                    data_alignment=buffer.data_alignment,
+                    offset_factor=buffer.offset_factor,
+                )
+        elif param.name in values:
+            param_map[param] = _specialize(param)
+    missing = sorted(set(values) - {var.name for var in var_map})
+    if missing:
+        raise ValueError(f"Cannot find the symbolic variables {missing} in the function signature")
+    return _normalize_mod(func.specialize(param_map))
+
+
+def _shape_sample_name(task_name: str, values: Dict[str, int]) -> str:
+    return task_name + "".join(f"_{name}{value}" for name, value in sorted(values.items()))
+
+
+def tune_tir_dynamic(
+    mod: Union[ir.IRModule, tir.PrimFunc],
+    target: Union[str, Target],
+    work_dir: str,
+    max_trials_global: int,
+    shape_samples: Sequence[Dict[str, int]],
+    *,
+    sample_weights: Optional[Sequence[float]] = None,
+    num_cross_candidates: int = 4,
+    num_trials_per_iter: int = 64,
+    builder: Builder.BuilderType = "local",
+    runner: Runner.RunnerType = "local",
+    database: Database.DatabaseType = "json",
+    cost_model: CostModel.CostModelType = "xgb",
+    measure_callbacks: MeasureCallback.CallbackListType = "default",
+    task_scheduler: TaskScheduler.TaskSchedulerType = "gradient",
+    space: SpaceGenerator.SpaceGeneratorType = "post-order-apply",
+    strategy: SearchStrategy.SearchStrategyType = "evolutionary",
+    task_name: str = "main",
+    num_threads: Union[Literal["physical", "logical"], int] = "physical",
+    seed: Optional[int] = None,
+) -> Database:
+    """Tune a TIR function with symbolic shapes over a distribution of concrete shapes.
+
+    The function is specialized to each shape sample and all the specializations are tuned
+    together. The best schedules of each sample are then measured on every other sample as well,
+    so that `compile_tir_dynamic` can pick the schedules that are robust over the distribution.
+
+    Parameters
+    ----------
+    mod : Union[ir.IRModule, tir.PrimFunc]
+        The TIR function with symbolic shapes to tune.
+    target : Union[str, Target]
+        The target to tune for.
+    work_dir : str
+        The working directory.
+    max_trials_global : int
+        The maximum number of trials to run globally.
+    shape_samples : Sequence[Dict[str, int]]
+        The concrete values of the symbolic variables to tune for, e.g. `sample_shape_values`.
+    sample_weights : Optional[Sequence[float]]
+        The frequency of each shape sample. Uniform if not given.
+    num_cross_candidates : int
+        The number of best schedules of each sample to measure on the other samples.
+    num_trials_per_iter : int
+        The number of trials to run per iteration
+    builder : Builder.BuilderType
+        The builder.
+    runner : Runner.RunnerType
+        The runner.
+    database : Database.DatabaseType
+        The database.
+    cost_model : CostModel.CostModelType
+        The cost model.
+    measure_callbacks : MeasureCallback.CallbackListType
+        The measure callbacks.
+    task_scheduler : TaskScheduler.TaskSchedulerType
+        The task scheduler.
+    space : SpaceGenerator.SpaceGeneratorType
+        The space generator.
+    strategy : SearchStrategy.SearchStrategyType
+        The search strategy.
+    task_name : str
+        The name of the task.
+    num_threads : Union[Literal["physical", "logical"], int]
+        The number of threads to use.
+    seed : Optional[int]
+        The seed for the random number generator.
+
+    Returns
+    -------
+    database : Database
+        The database with all tuning records
+    """
+    if not shape_samples:
+        raise ValueError("Expect at least one shape sample")
+    if sample_weights is None:
+        sample_weights = [1.0] * len(shape_samples)
+    if len(sample_weights) != len(shape_samples):
+        raise ValueError(
+            f"Length of shape_samples ({len(shape_samples)}) and sample_weights "
+            f"({len(sample_weights)}) do not match."
+        )
+    if not isinstance(target, Target):
+        target = Target(target)
+    if not isinstance(builder, Builder):
+        builder = Builder.create(builder)
+    if not isinstance(runner, Runner):
+        runner = Runner.create(runner)
+    if database == "json":
+        database = Database.create(database, work_dir=work_dir)
+    elif not isinstance(database, Database):
+        database = Database.create(database)
+    mods = [specialize_shape_vars(mod, values) for values in shape_samples]
+    task_names = [_shape_sample_name(task_name, values) for values in shape_samples]
+    loggers = get_loggers_from_work_dir(work_dir, task_names)
+    seeds = fork_seed(seed, n=len(mods))
+    database = tune_tasks(
+        tasks=[
+            TuneContext(
+                mod=sample_mod,
+                target=target,
+                space_generator=space,
+                search_strategy=strategy,
+                task_name=name,
+                logger=logger,
+                rand_state=rand_state,
+                num_threads=num_threads,
+            ).clone()
+            for sample_mod, name, logger, rand_state in zip(mods, task_names, loggers, seeds)
+        ],
+        task_weights=[float(weight) for weight in sample_weights],
+        work_dir=work_dir,
+        max_trials_global=max_trials_global,
+        num_trials_per_iter=num_trials_per_iter,
+        builder=builder,
+        runner=runner,
+        database=database,
+        cost_model=cost_model,
+        measure_callbacks=measure_callbacks,
+        task_scheduler=task_scheduler,
+    )
+    _cross_measure(database, mods, target, builder, runner, num_cross_candidates)
+    return database
+
+
+def _cross_measure(
+    database: Database,
+    mods: List[ir.IRModule],
+    target: Target,
+    builder: Builder,
+    runner: Runner,
+    num_candidates: int,
+) -> None:
+    """Measure the best traces of each shape sample on all the other samples, and commit the
+    results to the database under the traces they come from."""
+    workloads = [database.commit_workload(mod) for mod in mods]
+    measured = [
+        {str(record.trace) for record in database.get_top_k(workload, num_candidates)}
+        for workload in workloads
+    ]
+    jobs: List[Tuple[Trace, int, tir.Schedule]] = []
+    for i, workload in enumerate(workloads):
+        for record in database.get_top_k(workload, num_candidates):
+            for j, mod in enumerate(mods):
+                if str(record.trace) in measured[j]:
+                    continue
+                measured[j].add(str(record.trace))
+                sch = tir.Schedule(mod)
+                try:
+                    record.trace.apply_to_schedule(sch, remove_postproc=False)
+                except TVMError:
+                    continue
+                jobs.append((record.trace, j, sch))
+    if not jobs:
+        return
+    builder_results = builder.build([BuilderInput(sch.mod, target) for _, _, sch in jobs])
+    runner_inputs: List[RunnerInput] = []
+    runner_jobs: List[Tuple[Trace, int, List[ArgInfo]]] = []
+    for (trace, j, sch), builder_result in zip(jobs, builder_results):
+        if builder_result.error_msg is None:
+            args_info = ArgInfo.from_entry_func(sch.mod, remove_preproc=True)
+            runner_inputs.append(
+                RunnerInput(builder_result.artifact_path, target.kind.name, args_info)
+            )
+            runner_jobs.append((trace, j, args_info))
+    runner_futures = runner.run(runner_inputs)
+    for (trace, j, args_info), future in zip(runner_jobs, runner_futures):
+        result = future.result()
+        if result.error_msg is None:
+            database.commit_tuning_record(
+                TuningRecord(trace, workloads[j], result.run_secs, target, args_info)
+            )
+    for builder_result in builder_results:
+        if builder_result.error_msg is None:
+            remove_build_dir(builder_result.artifact_path)
+
+
+def compile_tir_dynamic(
+    database: Database,
+    mod: Union[ir.IRModule, tir.PrimFunc],
+    target: Union[Target, str],
+    shape_samples: Sequence[Dict[str, int]],
+    *,
+    sample_weights: Optional[Sequence[float]] = None,
+    max_dispatch: int = 1,
+) -> List[Tuple[Dict[str, int], tir.Schedule]]:
+    """Select the schedules of a TIR function with symbolic shapes that are robust over a
+    distribution of shapes, according to the records in the database.
+
+    Every trace measured on all the shape samples is a candidate. Up to `max_dispatch`
+    candidates are picked greedily to minimize the weighted mean slowdown over the samples,
+    relative to the best record of each sample, and each sample is dispatched to the fastest of
+    the picked ones. With `max_dispatch=1`, a single schedule is used for the whole range.
+
+    Parameters
+    ----------
+    database : Database
+        The database of tuning records, e.g. the one returned by `tune_tir_dynamic`.
+    mod : Union[ir.IRModule, tir.PrimFunc]
+        The TIR function with symbolic shapes.
+    target : Union[str, Target]
+        The target to compile for.
+    shape_samples : Sequence[Dict[str, int]]
+        The concrete values of the symbolic variables.
+    sample_weights : Optional[Sequence[float]]
+        The frequency of each shape sample. Uniform if not given.
+    max_dispatch : int
+        The maximum number of distinct schedules to dispatch to.
+
+    Returns
+    -------
+    dispatch : List[Tuple[Dict[str, int], tir.Schedule]]
+        The selected schedule of each shape sample, applied to the function specialized to it.
+    """
+    if max_dispatch < 1:
+        raise ValueError(f"Expect max_dispatch to be positive, but got {max_dispatch}")
+    if sample_weights is None:
+        sample_weights = [1.0] * len(shape_samples)
+    if not isinstance(target, Target):
+        target = Target(target)
+    mods = [specialize_shape_vars(mod, values) for values in shape_samples]
+    traces: Dict[str, Trace] = {}
+    costs: Dict[str, List[float]] = {}
+    for j, sample_mod in enumerate(mods):
+        workload = database.commit_workload(sample_mod)
+        for record in database.get_top_k(workload, len(database)):
+            if record.target.kind.name != target.kind.name:
+                continue
+            key = str(record.trace)
+            traces.setdefault(key, record.trace)
+            cost = costs.setdefault(key, [math.inf] * len(mods))
+            run_secs = [float(sec) for sec in record.run_secs]
+            cost[j] = min(cost[j], sum(run_secs) / len(run_secs))
+    best = [min((cost[j] for cost in costs.values()), default=math.inf) for j in range(len(mods))]
+    for values, best_cost in zip(shape_samples, best):
+        if math.isinf(best_cost):
+            raise ValueError(f"No valid tuning record for the shape sample: {values}")
+
+    def _slowdown(selected: List[str]) -> float:
+        return sum(
+            weight * min(costs[key][j] for key in selected) / best[j]
+            for j, weight in enumerate(sample_weights)
+        )
+
+    selected: List[str] = []
+    while len(selected) < max_dispatch:
+        current = _slowdown(selected) if selected else math.inf
+        key = min(costs, key=lambda key: _slowdown(selected + [key]))
+        if _slowdown(selected + [key]) >= current:
+            break
+        selected.append(key)
+    if math.isinf(_slowdown(selected)):
+        raise ValueError("No combination of the tuning records covers all the shape samples")
+    dispatch: List[Tuple[Dict[str, int], tir.Schedule]] = []
+    for j, (values, sample_mod) in enumerate(zip(shape_samples, mods)):
+        key = min(selected, key=lambda key: costs[key][j])  # pylint: disable=cell-var-from-loop
+        sch = tir.Schedule(sample_mod)
+        traces[key].apply_to_schedule(sch, remove_postproc=False)
+        dispatch.append((dict(values), sch))
+    return dispatch
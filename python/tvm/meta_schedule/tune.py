@@ -15,15 +15,30 @@
 # specific language governing permissions and limitations
 # under the License.
 """The core tuning API"""
-from typing import List, Optional
+import concurrent.futures
+import os.path
+import random
+from typing import Callable, Dict, List, Optional, Tuple, Union
+
+# isort: off
+from typing_extensions import Literal
+
+# isort: on
+from tvm.contrib.popen_pool import PopenPoolExecutor
+from tvm.ir import IRModule
+from tvm.target import Target
 
 from .builder import Builder
 from .cost_model import CostModel
-from .database import Database
+from .database import Database, JSONDatabase
+from .extracted_task import ExtractedTask
+from .logging import get_logger, get_loggers_from_work_dir
 from .measure_callback import MeasureCallback
 from .runner import Runner
 from .task_scheduler import TaskScheduler
-from .tune_context import TuneContext
+from .tune_context import TuneContext, _normalize_mod
+
+logger = get_logger(__name__)  # pylint: disable=invalid-name
 
 
 def tune_tasks(
@@ -40,6 +55,9 @@ def tune_tasks(
     cost_model: CostModel.CostModelType = "xgb",
     measure_callbacks: MeasureCallback.CallbackListType = "default",
     task_scheduler: TaskScheduler.TaskSchedulerType = "gradient",
+    max_tuning_time: Optional[float] = None,
+    convergence_window: int = 0,
+    convergence_threshold: float = 0.0,
 ) -> Database:
     """Tune a list of tasks. Using a task scheduler.
 
@@ -69,11 +87,24 @@ def tune_tasks(
         The measure callbacks.
     task_scheduler : TaskScheduler.TaskSchedulerType
         The task scheduler.
+    max_tuning_time : Optional[float]
+        The wall-clock budget of tuning in seconds. Unlimited if not provided.
+    convergence_window : int
+        The number of the latest trials of a task over which its best latency is checked for
+        convergence. A converged task stops and leaves its trials to the others. 0 disables it.
+    convergence_threshold : float
+        The relative improvement of the best latency over the window, at or below which a task
+        is considered converged.
 
     Returns
     -------
     database : Database
         The database with all tuning records
+
+    Note
+    ----
+    The stopping decisions are appended to `database_stopping.json` in `work_dir`, next to the
+    tuning records.
     """
     if len(tasks) != len(task_weights):
         raise ValueError(
@@ -97,6 +128,13 @@ def tune_tasks(
         measure_callbacks = MeasureCallback.create(measure_callbacks)
     if not isinstance(task_scheduler, TaskScheduler):
         task_scheduler = TaskScheduler.create(task_scheduler)
+    if max_tuning_time is not None or convergence_window > 0:
+        task_scheduler.set_stopping(
+            max_tuning_time_sec=max_tuning_time or 0.0,
+            convergence_window=convergence_window,
+            convergence_threshold=convergence_threshold,
+            log_path=os.path.join(work_dir, "database_stopping.json"),
+        )
     task_scheduler.tune(
         tasks=tasks,
         task_weights=task_weights,
@@ -110,3 +148,216 @@ def tune_tasks(
         cost_model=cost_model,
     )
     return database
+
+
+def tune_tasks_distributed(
+    *,
+    tasks: List[ExtractedTask],
+    work_dir: str,
+    max_trials_global: int,
+    max_trials_per_task: Optional[int] = None,
+    num_trials_per_iter: int = 64,
+    num_workers: int = 2,
+    executor: Optional[concurrent.futures.Executor] = None,
+    builder: Union[Literal["local"], Callable[[], Builder]] = "local",
+    runner: Union[Literal["local", "rpc"], Callable[[], Runner]] = "local",
+    cost_model: Literal["xgb", "random"] = "xgb",
+    alpha: float = 0.2,
+    window_size: int = 3,
+    seed: Optional[int] = None,
+) -> Database:
+    """Tune a list of tasks on several worker processes, possibly on several hosts.
+
+    The calling process is a coordinator that allocates the trials across the tasks the same way
+    as the `GradientBased` task scheduler, and sends each worker a chunk of `num_trials_per_iter`
+    trials of one task at a time. A task runs on at most one worker at a time. Each worker runs
+    the search, the cost model and the measurement of its chunk, and commits the results to a
+    JSONDatabase in `work_dir` that is shared by all the workers in concurrent mode. The records
+    committed by the other workers warm start the search and the XGBoost cost model of the next
+    chunks.
+
+    Parameters
+    ----------
+    tasks : List[ExtractedTask]
+        The list of tasks to tune, weighted by their `weight`.
+    work_dir : str
+        The working directory, which must be visible to all the workers.
+    max_trials_global : int
+        The maximum number of trials to run globally.
+    max_trials_per_task : Optional[int]
+        The maximum number of trials to run per task.
+    num_trials_per_iter : int
+        The number of trials of a task sent to a worker at a time.
+    num_workers : int
+        The number of chunks tuned at the same time.
+    executor : Optional[concurrent.futures.Executor]
+        The executor running the chunks, e.g. one dispatching them to other hosts. The local
+        worker processes of a PopenPoolExecutor are used if not given.
+    builder : Union[Literal["local"], Callable[[], Builder]]
+        The builder, or a picklable function creating it in the worker.
+    runner : Union[Literal["local", "rpc"], Callable[[], Runner]]
+        The runner, or a picklable function creating it in the worker.
+    cost_model : Literal["xgb", "random"]
+        The cost model of the workers.
+    alpha : float
+        The parameter alpha in the gradient computation of the trial allocation.
+    window_size : int
+        The backward window size in the gradient computation of the trial allocation.
+    seed : Optional[int]
+        The seed for the random number generator.
+
+    Returns
+    -------
+    database : Database
+        The database with all tuning records
+    """
+    if max_trials_per_task is None:
+        max_trials_per_task = max_trials_global
+    # The tables are created before any worker accesses them
+    JSONDatabase(work_dir=work_dir, concurrent=True)
+    if executor is None:
+        executor = PopenPoolExecutor(max_workers=num_workers)
+    rand = random.Random(seed)
+    n_tasks = len(tasks)
+    best_latency_history: List[List[float]] = [[] for _ in range(n_tasks)]
+    num_trials = [0 for _ in range(n_tasks)]
+    is_terminated = [False for _ in range(n_tasks)]
+    running: Dict[concurrent.futures.Future, Tuple[int, int]] = {}
+
+    def _next_task_id() -> int:
+        running_ids = {task_id for task_id, _ in running.values()}
+        tasks_alive = [
+            i
+            for i in range(n_tasks)
+            if not is_terminated[i] and i not in running_ids and num_trials[i] < max_trials_per_task
+        ]
+        if not tasks_alive:
+            return -1
+        # Step 1. Tune every task once in the round robin order
+        for task_id in tasks_alive:
+            if not best_latency_history[task_id]:
+                return task_id
+        # Step 2. Select the task with the largest gradient, as `GradientBased` does
+        grad: List[float] = []
+        for task_id in tasks_alive:
+            best_latency = best_latency_history[task_id]
+            n = len(best_latency)
+            best = best_latency[-1]
+            if best < 1e9:
+                g1 = (best_latency[-1 - window_size] - best) / window_size if n > window_size else 0
+                g2 = best / n
+                grad.append((alpha * g1 + (1 - alpha) * g2) * float(tasks[task_id].weight))
+            else:
+                grad.append(-1e9)
+        if max(grad) == min(grad):
+            return rand.choice(tasks_alive)
+        return tasks_alive[grad.index(max(grad))]
+
+    num_trials_sent = 0
+    while True:
+        while len(running) < num_workers and num_trials_sent < max_trials_global:
+            task_id = _next_task_id()
+            if task_id == -1:
+                break
+            task = tasks[task_id]
+            num = min(
+                num_trials_per_iter,
+                max_trials_global - num_trials_sent,
+                max_trials_per_task - num_trials[task_id],
+            )
+            num_trials_sent += num
+            num_trials[task_id] += num
+            future = executor.submit(
+                _tune_task_in_worker,
+                mod=task.mod,
+                target=str(task.target),
+                target_host=str(task.target.host) if task.target.host is not None else None,
+                task_name=task.task_name,
+                work_dir=work_dir,
+                num_trials=num,
+                builder=builder,
+                runner=runner,
+                cost_model=cost_model,
+                seed=rand.randint(1, 2**30),
+            )
+            running[future] = (task_id, num)
+        if not running:
+            break
+        done, _ = concurrent.futures.wait(running, return_when=concurrent.futures.FIRST_COMPLETED)
+        for future in done:
+            task_id, num = running.pop(future)
+            num_measured, best_latency_ms = future.result()
+            if num_measured < num:
+                # The search space of the task is exhausted
+                is_terminated[task_id] = True
+            best_latency_history[task_id].append(best_latency_ms)
+            logger.info(
+                "Task #%d %s: %d trials in total, best latency %.4f ms",
+                task_id,
+                tasks[task_id].task_name,
+                num_trials[task_id],
+                best_latency_ms,
+            )
+    return JSONDatabase(work_dir=work_dir, concurrent=True)
+
+
+def _tune_task_in_worker(
+    *,
+    mod: IRModule,
+    target: str,
+    target_host: Optional[str],
+    task_name: str,
+    work_dir: str,
+    num_trials: int,
+    builder: Union[str, Callable[[], Builder]],
+    runner: Union[str, Callable[[], Runner]],
+    cost_model: str,
+    seed: int,
+) -> Tuple[int, float]:
+    """Tune a chunk of trials of a task in a worker of `tune_tasks_distributed`.
+
+    Returns
+    -------
+    num_measured : int
+        The number of trials measured.
+    best_latency_ms : float
+        The best latency of the task in milliseconds so far, among all the workers.
+    """
+    mod = _normalize_mod(mod)
+    database = JSONDatabase(work_dir=work_dir, concurrent=True)
+    workload = database.commit_workload(mod)
+    num_records = len(database.get_top_k(workload, len(database)))
+    model = CostModel.create(cost_model)
+    if cost_model == "xgb":
+        model.pretrain(database)  # type: ignore # pylint: disable=no-member
+    (task_logger,) = get_loggers_from_work_dir(work_dir, [task_name])
+    tune_tasks(
+        tasks=[
+            TuneContext(
+                mod=mod,
+                target=Target(target, host=target_host),
+                space_generator="post-order-apply",
+                search_strategy="evolutionary",
+                task_name=task_name,
+                logger=task_logger,
+                rand_state=seed,
+                num_threads="physical",
+            ).clone()
+        ],
+        task_weights=[1.0],
+        work_dir=work_dir,
+        max_trials_global=num_trials,
+        max_trials_per_task=num_trials,
+        num_trials_per_iter=num_trials,
+        builder=builder() if callable(builder) else builder,
+        runner=runner() if callable(runner) else runner,
+        database=database,
+        cost_model=model,
+        task_scheduler="round-robin",
+    )
+    records = database.get_top_k(workload, len(database))
+    best_latency_ms = 1e10
+    if records and records[0].run_secs:
+        run_secs = [float(sec) for sec in records[0].run_secs]
+        best_latency_ms = sum(run_secs) / len(run_secs) * 1000.0
+    return len(records) - num_records, best_latency_ms
@@ -25,6 +25,7 @@ from .model_library_format import (
     UnsupportedInModelLibraryFormatError,
 )
 from .project import generate_project, GeneratedProject, TemplateProject
+from .static_arena import plan_static_arena, StaticArenaReport
 from .session import (
     create_local_graph_executor,
     create_local_debug_executor,
@@ -0,0 +1,228 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Plan the static arena the CRT graph executor runs from.
+
+With the arena memory manager of the CRT (tvm/runtime/crt/arena_allocator.h), all the memory of
+the runtime is served from one arena sized at compile time: the allocations made while the
+executor is created and the parameters are loaded are laid out one after another and never
+reused, and the workspaces of the operators are stacked above them while the graph runs. The
+size of the arena is computed here from the graph, following the allocations of
+src/runtime/crt/graph_executor and bounding the size of the runtime structures from the
+configuration of the CRT.
+"""
+
+import json
+import re
+
+from ..relay.backend import executor_factory
+
+# This should be kept identical to runtime::symbol::tvm_module_main
+MAIN_FUNC_NAME_STR = "__tvm_main__"
+
+# The defaults of src/runtime/crt/crt_config-template.h.
+DEFAULT_CRT_CONFIG = {
+    "TVM_CRT_MAX_NDIM": 6,
+    "TVM_CRT_MAX_ARGS": 10,
+    "TVM_CRT_GLOBAL_FUNC_REGISTRY_SIZE_BYTES": 512,
+    "TVM_CRT_MAX_STRLEN_DLTYPE": 10,
+    "TVM_CRT_MAX_STRLEN_FUNCTION_NAME": 120,
+    "TVM_CRT_MAX_STRLEN_PARAM_NAME": 80,
+}
+
+
+class StaticArenaReport:
+    """The bytes of the static arena, by what they hold.
+
+    Parameters
+    ----------
+    state_bytes : int
+        The structures of the runtime and the graph executor, including the copy of the graph
+        JSON made while it is parsed.
+
+    storage_bytes : int
+        The storage of the tensors of the graph, as planned in the graph.
+
+    params_bytes : int
+        The parameters loaded by TVMGraphExecutor_LoadParams.
+
+    workspace_bytes : int
+        The largest workspace of an operator, stacked above the sealed allocations.
+
+    alignment_bytes : int
+        The alignment of the allocations, TVM_RUNTIME_ALLOC_ALIGNMENT_BYTES.
+    """
+
+    def __init__(self, state_bytes, storage_bytes, params_bytes, workspace_bytes, alignment_bytes):
+        self.state_bytes = state_bytes
+        self.storage_bytes = storage_bytes
+        self.params_bytes = params_bytes
+        self.workspace_bytes = workspace_bytes
+        self.alignment_bytes = alignment_bytes
+
+    @property
+    def sealed_bytes(self):
+        """The bytes of the allocations made before the arena is sealed."""
+        return self.state_bytes + self.storage_bytes + self.params_bytes
+
+    @property
+    def total_bytes(self):
+        """The size of the arena."""
+        return self.sealed_bytes + self.workspace_bytes
+
+    def to_c_header(self):
+        """Get a C header defining the size of the arena, for TVM_CRT_DEFINE_STATIC_ARENA.
+
+        Returns
+        -------
+        header : str
+            The header defining TVM_CRT_STATIC_ARENA_SIZE_BYTES.
+        """
+        return (
+            "// Generated by tvm.micro.plan_static_arena.\n"
+            "#ifndef TVM_CRT_STATIC_ARENA_SIZE_BYTES\n"
+            f"// state {self.state_bytes}, storage {self.storage_bytes}, "
+            f"params {self.params_bytes}, workspace {self.workspace_bytes}\n"
+            f"#define TVM_CRT_STATIC_ARENA_SIZE_BYTES {self.total_bytes}\n"
+            "#endif  // TVM_CRT_STATIC_ARENA_SIZE_BYTES\n"
+        )
+
+    def __str__(self):
+        return (
+            f"static arena: {self.total_bytes} bytes (state {self.state_bytes}, "
+            f"storage {self.storage_bytes}, params {self.params_bytes}, "
+            f"workspace {self.workspace_bytes})"
+        )
+
+
+def _dtype_bytes(dtype):
+    m = re.match(r"^[a-zA-Z]+([0-9]+)(x([0-9]+))?$", str(dtype))
+    if m is None:
+        raise ValueError(f"Cannot plan the static arena for dtype {dtype}")
+    lanes = int(m.group(3)) if m.group(3) else 1
+    return (int(m.group(1)) * lanes + 7) // 8
+
+
+def _num_elements(shape):
+    num_elements = 1
+    for dim in shape:
+        num_elements *= int(dim)
+    return num_elements
+
+
+def plan_static_arena(mod, pointer_bytes=8, alignment_bytes=16, crt_config=None):
+    """Compute the size of the static arena to run a graph with the CRT from.
+
+    The structures of the runtime are bounded for pointers of the given size, so the default
+    also covers the 32-bit microcontrollers. The size can be checked on the device against
+    ArenaMemoryManager_GetUsage.
+
+    Parameters
+    ----------
+    mod : tvm.relay.backend.executor_factory.GraphExecutorFactoryModule
+        The module built by tvm.relay.build for the graph executor.
+
+    pointer_bytes : int
+        The size of a pointer and of size_t on the device.
+
+    alignment_bytes : int
+        The alignment of the allocations, TVM_RUNTIME_ALLOC_ALIGNMENT_BYTES.
+
+    crt_config : Optional[Dict[str, int]]
+        The values of crt_config.h that differ from DEFAULT_CRT_CONFIG.
+
+    Returns
+    -------
+    report : StaticArenaReport
+        The size of the arena.
+    """
+    if not isinstance(mod, executor_factory.GraphExecutorFactoryModule):
+        raise ValueError(
+            "plan_static_arena supports the modules built for the graph executor, "
+            f"got {type(mod).__name__}; the AOT executor places its workspaces with USMP"
+        )
+    config = dict(DEFAULT_CRT_CONFIG)
+    config.update(crt_config or {})
+    max_ndim = config["TVM_CRT_MAX_NDIM"]
+    max_args = config["TVM_CRT_MAX_ARGS"]
+    strlen_function_name = config["TVM_CRT_MAX_STRLEN_FUNCTION_NAME"]
+
+    def align(num_bytes):
+        return (num_bytes + alignment_bytes - 1) // alignment_bytes * alignment_bytes
+
+    def aligned_struct(num_bytes):
+        return (num_bytes + pointer_bytes - 1) // pointer_bytes * pointer_bytes
+
+    graph_json = mod.get_graph_json()
+    graph = json.loads(graph_json)
+    nodes = graph["nodes"]
+    storage_ids = graph["attrs"]["storage_id"][1]
+    shapes = graph["attrs"]["shape"][1]
+    dltypes = graph["attrs"]["dltype"][1]
+    num_nodes = len(nodes)
+    num_entries = len(storage_ids)
+
+    # The upper bounds of the structures of the CRT, as laid out for the pointer size.
+    ndarray_bytes = aligned_struct(pointer_bytes + 8 + 4 + 4 + 2 * pointer_bytes + 8 + 4)
+    node_entry_bytes = aligned_struct(12 + pointer_bytes)
+    op_param_bytes = strlen_function_name + 12
+    node_bytes = aligned_struct(16 + strlen_function_name + op_param_bytes + 80) + 4 * pointer_bytes
+    args_bytes = aligned_struct(max_args * 8 + max_args * 4 + 4)
+    packed_func_bytes = aligned_struct(200 + pointer_bytes) + 2 * args_bytes + 2 * pointer_bytes
+    seq_bytes = aligned_struct(pointer_bytes + 8 + 4) + 3 * pointer_bytes
+    executor_bytes = 24 * pointer_bytes + 16 * 4
+
+    state = align(8 * pointer_bytes)  # The memory manager.
+    state += align(config["TVM_CRT_GLOBAL_FUNC_REGISTRY_SIZE_BYTES"])
+    state += align(executor_bytes)
+    # The JSON reader.
+    state += align(seq_bytes) + align(4 * 200) + align(len(graph_json) + 1)
+    # The nodes and the graph attributes.
+    state += align(node_bytes * num_nodes)
+    state += sum(align(node_entry_bytes * len(node.get("inputs", []))) for node in nodes)
+    state += align(config["TVM_CRT_MAX_STRLEN_DLTYPE"] * num_entries)
+    state += 3 * align(4 * num_entries) + align(8 * max_ndim * num_entries)
+    state += align(4 * len(graph["arg_nodes"])) + align(4 * len(graph["node_row_ptr"]))
+    state += align(node_entry_bytes * len(graph["heads"]))
+    # The storage plan, the views of the entries and the operators.
+    state += align(4 * num_entries) + align(3 * pointer_bytes * num_nodes)
+    num_storages = max(storage_ids) + 1 if storage_ids else 0
+    state += align(aligned_struct(4 + ndarray_bytes) * num_storages)
+    state += align(ndarray_bytes * num_entries)
+    state += sum(align(8 * len(shape)) for shape in shapes)
+    state += align(packed_func_bytes * num_nodes)
+
+    storage_sizes = [0] * num_storages
+    for storage_id, shape, dltype in zip(storage_ids, shapes, dltypes):
+        num_bytes = _num_elements(shape) * _dtype_bytes(dltype)
+        storage_sizes[storage_id] = max(storage_sizes[storage_id], num_bytes)
+    storage = sum(align(8) + align((size + 3) // 4 * 4) for size in storage_sizes)
+
+    params = 0
+    mod_params = mod.get_params()
+    if mod_params:
+        params += align(config["TVM_CRT_MAX_STRLEN_PARAM_NAME"] * num_nodes)
+        for param in mod_params.values():
+            num_bytes = _num_elements(param.shape) * _dtype_bytes(param.dtype)
+            params += align(8 * len(param.shape)) + align(num_bytes)
+
+    workspace = 0
+    for func_name, finfo in mod.function_metadata.items():
+        if func_name == MAIN_FUNC_NAME_STR:
+            continue
+        workspace = max(workspace, sum(align(int(size)) for size in finfo.workspace_sizes.values()))
+
+    return StaticArenaReport(state, storage, params, workspace, alignment_bytes)
@@ -20,11 +20,15 @@ from . import exec_builder
 from . import expr
 from . import ty
 from . import vm
+from . import aot
 from . import block_builder
 from . import op
 from . import analysis
 from . import transform
 from . import expr_functor
+from . import param_store
+from . import tensor_parallel
+from . import optimizer
 
 # Expr
 Expr = expr.Expr
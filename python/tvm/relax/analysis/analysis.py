@@ -21,10 +21,11 @@ This file contains the set of passes for Relax, which exposes an interface for
 configuring the passes and scripting them in Python.
 """
 
-from typing import Dict, List
+from typing import Dict, List, Optional
 
 import tvm
 from tvm import tir
+from tvm.runtime import Object
 from tvm.relax.expr import DataflowBlock, GlobalVar, Var, Expr, Function, Binding
 from . import _ffi_api
 
@@ -45,7 +46,18 @@ def post_order_visit(expr, fvisit):
     return _ffi_api.post_order_visit(expr, fvisit)
 
 
-def well_formed(mod: tvm.IRModule) -> bool:
+@tvm._ffi.register_object("relax.analysis.WellFormedCache")
+class WellFormedCache(Object):
+    """The cache of well_formed, remembering the well formed functions of the last IRModule
+    checked with it, so that checking the IRModules produced by a sequence of passes only
+    checks again the functions changed by each pass.
+    """
+
+    def __init__(self):
+        self.__init_handle_by_constructor__(_ffi_api.WellFormedCache)  # type: ignore
+
+
+def well_formed(mod: tvm.IRModule, cache: Optional[WellFormedCache] = None) -> bool:
     """Check if the IRModule is well formed.
 
     Parameters
@@ -53,12 +65,17 @@ def well_formed(mod: tvm.IRModule) -> bool:
     mod : tvm.IRModule
         The input IRModule.
 
+    cache : Optional[WellFormedCache]
+        The cache of the previous checks. A function is not checked again if it is the same
+        object as a function found well formed before, and the GlobalVars it refers to are
+        still defined in mod.
+
     Returns
     -------
     ret: bool
         True if the IRModule is well formed, False if not.
     """
-    return _ffi_api.well_formed(mod)
+    return _ffi_api.well_formed(mod, cache)
 
 
 def get_var2val(func: Function) -> Dict[Var, Expr]:
@@ -95,6 +112,24 @@ def udchain(dfb: DataflowBlock) -> Dict[Var, List[Var]]:
     return _ffi_api.udchain(dfb)
 
 
+def liveness_killed_vars(func: Function) -> List[List[Var]]:
+    """
+    Analyze the liveness of the vars of a function, over the bindings of the top-level SeqExpr
+    of its body.
+
+    Parameters
+    ----------
+    func : Function
+        The function to analyze
+
+    Returns
+    -------
+    List[List[Var]]
+        The vars whose last use is at each binding, followed by the ones used by the body.
+    """
+    return _ffi_api.liveness_killed_vars(func)
+
+
 def name_to_binding(func: Function) -> Dict[str, List[Binding]]:
     """Return a map from variable name to its bindings."""
     return _ffi_api.name_to_binding(func)
@@ -249,3 +284,83 @@ def called_global_vars(expr: Expr) -> List[GlobalVar]:
         in post-DFS order
     """
     return _ffi_api.called_global_vars(expr)
+
+
+def call_tir_inplace_inputs(mod: tvm.IRModule, func: Function) -> Dict[Var, int]:
+    """
+    Find the call_tir bindings in func that can write their output into one of their inputs.
+
+    An input qualifies when it is a tensor freshly produced by another call_tir, it dies at
+    the call, it has the shape and dtype of the output, and the PrimFunc reads each of its
+    elements only to compute the output element at the same index.
+
+    Parameters
+    ----------
+    mod: tvm.IRModule
+        The module containing the PrimFuncs.
+
+    func: Function
+        The function to be analyzed.
+
+    Returns
+    -------
+    ret: Dict[Var, int]
+        Map from the call_tir binding vars to the index of the input to write into.
+    """
+    return {var: int(index) for var, index in _ffi_api.call_tir_inplace_inputs(mod, func).items()}
+
+
+@tvm._ffi.register_object("relax.analysis.Footprint")
+class Footprint(Object):
+    """The resources a function needs to run, estimated at compile time by
+    :py:func:`estimate_footprint`.
+
+    Attributes
+    ----------
+    peak_bytes : int
+        The peak bytes allocated by the function and its callees, over the allocations of
+        bounded size.
+
+    constant_bytes : Dict[str, int]
+        The bytes of the constants by their device, e.g. "cpu(0)".
+
+    flops : float
+        The operations of the kernels, over the kernels whose loops are of static extents.
+
+    num_kernel_launches : int
+        The number of calls to the PrimFuncs.
+
+    num_packed_calls : int
+        The number of calls to packed functions, the builtins of the VM included.
+
+    num_unbounded_allocs : int
+        The number of allocations of unbounded size, which are not in peak_bytes.
+
+    num_unestimated_kernels : int
+        The number of kernel launches whose operations are not in flops.
+    """
+
+
+def estimate_footprint(mod: tvm.IRModule, func_name: str = "main") -> Footprint:
+    """Estimate the peak memory, the constant bytes, the operations and the kernel launches of a
+    function without running it.
+
+    The allocations are the ones of the memory lowering, so the estimate of a module lowered by
+    VMMemoryLower follows its memory plan, and the outputs of the call_tirs before the lowering.
+    The sizes of symbolic shapes are bounded by the tir_var_upper_bound attribute of the
+    function.
+
+    Parameters
+    ----------
+    mod : tvm.IRModule
+        The module containing the function and its callees.
+
+    func_name : str
+        The name of the function.
+
+    Returns
+    -------
+    footprint : Footprint
+        The estimated footprint.
+    """
+    return _ffi_api.estimate_footprint(mod, mod[func_name])  # type: ignore
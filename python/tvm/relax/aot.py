@@ -0,0 +1,83 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Build static-shape Relax functions for the AOT executor."""
+from typing import Union
+
+import tvm
+from tvm import relax
+from tvm.ir.module import IRModule
+from tvm.runtime import Module
+
+from . import _ffi_api
+
+
+def build(
+    mod: IRModule,
+    target: Union[str, tvm.target.Target],
+    mod_name: str = "default",
+    func_name: str = "main",
+) -> Module:
+    """Build a Relax function into the factory of an AOT executor.
+
+    Rather than the bytecode of the VM, the function is lowered into a TIR main which
+    allocates the planned storages and calls the kernels directly. Only the functions with
+    static shapes whose computations are all call_tir of the PrimFuncs of the module are
+    supported, and the kernels must run on the CPU.
+
+    Parameters
+    ----------
+    mod : IRModule
+        The input IRModule to be built.
+
+    target : Union[str, tvm.target.Target]
+        The target of the kernels and the main, with its host.
+
+    mod_name : str
+        The name of the module, which mangles the symbol of the main.
+
+    func_name : str
+        The Relax function to build.
+
+    Returns
+    -------
+    factory : tvm.runtime.Module
+        The AOT executor factory. ``factory[mod_name](dev)`` creates the executor, which can be
+        wrapped by :py:class:`tvm.runtime.executor.AotModule`. Its inputs are named after the
+        parameters of the function, and its outputs are ``output`` or ``output0``, ``output1``...
+
+    Example
+    -------
+
+    .. code-block:: python
+
+        factory = relax.aot.build(mod, "llvm")
+        executor = tvm.runtime.executor.AotModule(factory["default"](tvm.cpu()))
+        executor.set_input("x", x)
+        executor.run()
+        out = executor.get_output(0)
+    """
+    if isinstance(target, str):
+        target = tvm.target.Target(target)
+
+    passes = [relax.transform.ToNonDataflow()]
+    passes.append(relax.transform.LiftTIRWorkspace())
+    passes.append(relax.transform.CallTIRRewrite(inplace=True))
+    passes.append(relax.transform.VMMemoryLower(plan_memory=True))
+    new_mod = tvm.transform.Sequential(passes)(mod)
+
+    lib = _ffi_api.AOTCodeGen(new_mod, target, mod_name, func_name)
+    return tvm.get_global_func("tvm.aot_executor_factory.create")(lib, mod_name)
@@ -17,10 +17,10 @@
 
 """The Graph Matching Context Manager for Dataflow Pattern Language."""
 
-from typing import Optional, Dict
+from typing import Callable, Dict, Optional
 
 import tvm
-from tvm.relax import DataflowBlock, Var
+from tvm.relax import DataflowBlock, Expr, Function, Var
 from .pattern import DFPattern
 from . import _ffi as ffi
 
@@ -84,3 +84,28 @@ class PatternContext(tvm.runtime.Object):
             The mapping from DFPattern to matched expression
         """
         return ffi.match_dfb(self, dfb, start_hint, must_include_hint)
+
+    def rewrite_bindings(
+        self,
+        rewriter: Callable[[Dict[DFPattern, Var]], Dict[Var, Expr]],
+        func: Function,
+    ) -> Function:
+        """
+        Rewrite all the non-overlapping matches of the graph of DFPattern in a function.
+        Each DataflowBlock is indexed once, so this is much cheaper than calling match_dfb
+        with a start_hint per binding.
+
+        Parameters
+        ----------
+        rewriter : Callable[[Dict[DFPattern, Var]], Dict[Var, Expr]]
+            The function taking the vars matched by each pattern, and returning the new values
+            of the bindings to be replaced
+        func : Function
+            The function to rewrite
+
+        Returns
+        -------
+        Function
+            The rewritten function, where the bindings left unused are not removed yet
+        """
+        return ffi.rewrite_bindings(self, rewriter, func)
@@ -33,6 +33,23 @@ class SpecialReg(IntEnum):
     VM_STATE = 0x008D14FA4379015C
 
 
+class ShapeOp(IntEnum):
+    """The operations of a shape computation instruction, in sync with vm::ShapeOp."""
+
+    LOAD = 0
+    IMM = 1
+    STORE = 2
+    ADD = 3
+    SUB = 4
+    MUL = 5
+    DIV = 6
+    MOD = 7
+    FLOOR_DIV = 8
+    FLOOR_MOD = 9
+    MIN = 10
+    MAX = 11
+
+
 class VMFuncScope(object):
     """An object corresponds to each VM function, working as a context manager."""
 
@@ -82,8 +99,10 @@ class ExecBuilder(Object):
         if len(VMFuncScope.stack) == 0:
             raise ValueError("emit should happen in a function scope")
 
-    def emit_constant(self, const: TVMRetValueHandle) -> int:
-        return _ffi_api.ExecBuilderEmitConstant(self, const)
+    def emit_constant(self, const: TVMRetValueHandle, device_index: int = 0) -> int:
+        """emit a constant, which the VM copies to the device of index
+        `device_index` (-1 for the host) when it is first used."""
+        return _ffi_api.ExecBuilderEmitConstant(self, const, device_index)
 
     def emit_call(
         self,
@@ -124,6 +143,68 @@ class ExecBuilder(Object):
         self._check_scope()
         _ffi_api.ExecBuilderEmitIf(self, cond, false_offset)
 
-    def get(self) -> Executable:
-        """return the executable"""
-        return Executable(_ffi_api.ExecBuilderGet(self))
+    def emit_load_shape(self, heap: int, indices: List[int], dst: int) -> None:
+        """emit an instruction which loads a shape from the shape heap"""
+        self._check_scope()
+        _ffi_api.ExecBuilderEmitLoadShape(self, heap, indices, dst)
+
+    def emit_store_shape(self, shape: int, heap: int, indices: List[int]) -> None:
+        """emit an instruction which stores a shape into the shape heap"""
+        self._check_scope()
+        _ffi_api.ExecBuilderEmitStoreShape(self, shape, heap, indices)
+
+    def emit_compute_shape(self, heap: int, program: List[int]) -> None:
+        """emit an instruction which computes shape values on the shape heap.
+
+        The program is a flattened list of (operation, operand) pairs, see ShapeOp.
+        """
+        self._check_scope()
+        _ffi_api.ExecBuilderEmitComputeShape(self, heap, program)
+
+    def emit_move(self, src: int, dst: int) -> None:
+        """emit an instruction which copies a register into another register"""
+        self._check_scope()
+        _ffi_api.ExecBuilderEmitMove(self, src, dst)
+
+    def emit_load_const(self, const: Union[int, tvm.nd.NDArray, ShapeTuple], dst: int) -> None:
+        """emit an instruction which loads a constant into a register"""
+        self._check_scope()
+        if not isinstance(const, int):
+            const = self.emit_constant(const)
+        _ffi_api.ExecBuilderEmitLoadConst(self, const, dst)
+
+    def emit_make_tuple(self, fields: List[int], dst: int) -> None:
+        """emit an instruction which makes a tuple of registers or constants"""
+        self._check_scope()
+        _ffi_api.ExecBuilderEmitMakeTuple(self, fields, dst)
+
+    def emit_get_tuple_item(self, tuple_reg: int, index: int, dst: int) -> None:
+        """emit an instruction which gets an item of a tuple"""
+        self._check_scope()
+        _ffi_api.ExecBuilderEmitGetTupleItem(self, tuple_reg, index, dst)
+
+    def emit_kill(self, regs: List[int]) -> None:
+        """emit an instruction which releases the values of dead registers"""
+        self._check_scope()
+        _ffi_api.ExecBuilderEmitKill(self, regs)
+
+    def get(
+        self, fuse_instructions: bool = False, allocate_registers: bool = False
+    ) -> Executable:
+        """return the executable
+
+        Parameters
+        ----------
+        fuse_instructions : bool
+            Whether to fuse frequent instruction sequences into superinstructions.
+
+        allocate_registers : bool
+            Whether to share the registers of the values with disjoint live ranges, and to
+            release the values after their last use.
+        """
+        exec_module = _ffi_api.ExecBuilderGet(self)
+        if fuse_instructions:
+            _ffi_api.ExecBuilderFuseInstructions(self)
+        if allocate_registers:
+            _ffi_api.ExecBuilderAllocateRegisters(self)
+        return Executable(exec_module)
@@ -249,7 +249,7 @@ class Function(BaseFunc):
         script : str
             The TVM Script of the relax.Function
         """
-        return tvm._ffi.get_global_func("script.AsRelaxScript")(self, show_meta)  # type: ignore
+        return tvm._ffi.get_global_func("script.AsRelaxScript")(self, show_meta, 1)  # type: ignore
 
     def show(self, style: str = "light") -> None:
         """
@@ -0,0 +1,24 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Frontends importing models to Relax directly, without going through Relay.
+
+The frontends emit the high-level Relax ops where they exist and the TOPI compute of the others,
+keeping the dynamic dimensions of the inputs as symbolic shapes. The frameworks are imported
+lazily, when a model is converted.
+"""
+from .onnx import from_onnx
+from .torch_fx import from_fx
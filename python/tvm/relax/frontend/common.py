@@ -0,0 +1,274 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name
+"""The emitters of the ops shared by the Relax frontends."""
+import math
+from typing import Dict, List, Optional, Sequence, Union
+
+import numpy as np
+
+from tvm import relax, te, tir, topi
+
+from ..block_builder import BlockBuilder
+from ..expr import Expr
+
+
+def _prod(values):
+    return math.prod(values) if values else 1
+
+
+def _is_one(d) -> bool:
+    return int(d) == 1 if isinstance(d, (int, tir.IntImm)) else False
+
+
+class ImporterBase:
+    """The block builder and the symbolic dimensions of an import, with the emitters of the ops
+    of the frontends.
+
+    The emitters take the converted inputs, Relax expressions of known shapes, along with the
+    attributes of the op. The shapes are lists of PrimExpr, whose symbolic dimensions are the
+    tir.Var of the inputs.
+    """
+
+    def __init__(self):
+        self.bb = BlockBuilder()
+        self.dims: Dict[str, tir.Var] = {}
+
+    def dim(self, d: Union[int, str, tir.PrimExpr]) -> tir.PrimExpr:
+        """A dimension of an input, a symbolic one for a name, shared by the inputs."""
+        if isinstance(d, str):
+            if d not in self.dims:
+                self.dims[d] = tir.Var(d, "int64")
+            return self.dims[d]
+        if isinstance(d, tir.PrimExpr):
+            return d
+        return tir.IntImm("int64", int(d))
+
+    def input_var(self, name: str, shape: Sequence, dtype: str) -> relax.Var:
+        """An input of the model, whose dimensions are ints or the names of symbolic ones."""
+        shape = [self.dim(d) for d in shape]
+        return relax.Var(name, shape, relax.DynTensorType(len(shape), dtype))
+
+    @staticmethod
+    def shape_of(x: Expr) -> List[tir.PrimExpr]:
+        """The shape of a converted value."""
+        shape = x.shape
+        if not isinstance(shape, relax.ShapeExpr):
+            raise ValueError("The frontends require the values of known shape, got %s" % shape)
+        return list(shape.values)
+
+    @staticmethod
+    def dtype_of(x: Expr) -> str:
+        return x.checked_type.dtype
+
+    def const(self, value, dtype: Optional[str] = None) -> Expr:
+        value = np.asarray(value)
+        return relax.const(value.astype(dtype) if dtype else value)
+
+    def emit_te(self, func, *args, name: Optional[str] = None) -> Expr:
+        """Emit a TOPI compute. The attributes are to be captured by func, as emit_te only passes
+        the tensors and the immediates."""
+        return self.bb.emit_te(func, *args, primfunc_name_hint=name or func.__name__)
+
+    def _tensor(self, value, like: Expr) -> Expr:
+        if isinstance(value, Expr):
+            return value
+        return self.const(value, self.dtype_of(like))
+
+    def binary(self, op: str, lhs, rhs) -> Expr:
+        """A broadcasting binary op of topi, add and multiply use the Relax ops. A Python scalar
+        takes the dtype of the tensor."""
+        lhs, rhs = self._tensor(lhs, rhs), self._tensor(rhs, lhs)
+        if op in ("add", "multiply"):
+            return self.bb.emit(getattr(relax.op, op)(lhs, rhs))
+        return self.emit_te(getattr(topi, op), lhs, rhs, name=op)
+
+    def unary(self, op: str, x: Expr) -> Expr:
+        """An elementwise op, relu is the Relax op, gelu the exact one with erf."""
+        if op == "relu":
+            return self.bb.emit(relax.op.nn.relu(x))
+        if op == "gelu":
+
+            def gelu(t):
+                half = tir.const(0.5, t.dtype)
+                return te.compute(
+                    t.shape,
+                    lambda *i: t(*i)
+                    * half
+                    * (1 + te.erf(t(*i) * tir.const(1 / math.sqrt(2), t.dtype))),
+                    name="gelu",
+                )
+
+            return self.emit_te(gelu, x)
+        return self.emit_te(getattr(topi, op), x, name=op)
+
+    def cast(self, x: Expr, dtype: str) -> Expr:
+        return self.emit_te(lambda t: topi.cast(t, dtype), x, name="cast")
+
+    def matmul(self, a: Expr, b: Expr) -> Expr:
+        """A matmul of numpy semantics, the Relax op when b is 2-D and a batched compute
+        broadcasting the batch dimensions otherwise."""
+        a_shape, b_shape = self.shape_of(a), self.shape_of(b)
+        if len(b_shape) == 2 and len(a_shape) >= 1:
+            return self.bb.emit(relax.op.nn.matmul(a, b))
+        if len(a_shape) < 2 or len(b_shape) < 2:
+            raise ValueError("matmul of shapes %s and %s is not supported" % (a_shape, b_shape))
+        ndim = max(len(a_shape), len(b_shape))
+        a_batch = [1] * (ndim - len(a_shape)) + a_shape[:-2]
+        b_batch = [1] * (ndim - len(b_shape)) + b_shape[:-2]
+        batch = [bd if _is_one(ad) else ad for ad, bd in zip(a_batch, b_batch)]
+
+        def batch_matmul(ta, tb):
+            k = te.reduce_axis((0, a_shape[-1]), name="k")
+
+            def index(t, batch_dims, i):
+                # broadcast the batch dimensions of size 1
+                offset = ndim - len(t.shape)
+                return [0 if _is_one(d) else i[j] for j, d in enumerate(batch_dims)][offset:]
+
+            return te.compute(
+                batch + [a_shape[-2], b_shape[-1]],
+                lambda *i: te.sum(
+                    ta(*index(ta, a_batch, i), i[-2], k) * tb(*index(tb, b_batch, i), k, i[-1]),
+                    axis=k,
+                ),
+                name="matmul",
+            )
+
+        return self.emit_te(batch_matmul, a, b)
+
+    def linear(self, x: Expr, weight: Expr, bias: Optional[Expr], transpose_w: bool) -> Expr:
+        """x * weight(^T) + bias, with a 2-D weight."""
+        out = self.bb.emit(relax.op.nn.matmul(x, weight, transpose_b=transpose_w))
+        return out if bias is None else self.binary("add", out, bias)
+
+    def reshape(self, x: Expr, new_shape: Sequence, allow_zero: bool = False) -> Expr:
+        """A reshape, in which -1 stands for the remaining size and 0, unless allow_zero, for the
+        dimension of the input."""
+        in_shape = self.shape_of(x)
+        new_shape = list(new_shape)
+        for i, d in enumerate(new_shape):
+            if not allow_zero and isinstance(d, int) and d == 0:
+                new_shape[i] = in_shape[i]
+        if any(isinstance(d, int) and d == -1 for d in new_shape):
+            known = [d for d in new_shape if not (isinstance(d, int) and d == -1)]
+            new_shape = [
+                tir.floordiv(_prod(in_shape), _prod(known)) if isinstance(d, int) and d == -1 else d
+                for d in new_shape
+            ]
+        new_shape = [self.dim(d) for d in new_shape]
+        return self.emit_te(lambda t: topi.reshape(t, new_shape), x, name="reshape")
+
+    def flatten(self, x: Expr, start: int = 1, end: int = -1) -> Expr:
+        """Merge the dimensions from start to end, both included."""
+        shape = self.shape_of(x)
+        start, end = start % len(shape), end % len(shape)
+        return self.reshape(x, shape[:start] + [_prod(shape[start : end + 1])] + shape[end + 1 :])
+
+    def transpose(self, x: Expr, axes: Optional[Sequence[int]]) -> Expr:
+        axes = list(axes) if axes is not None else None
+        return self.emit_te(lambda t: topi.transpose(t, axes), x, name="transpose")
+
+    def expand_dims(self, x: Expr, axes: Sequence[int]) -> Expr:
+        shape = self.shape_of(x)
+        ndim = len(shape) + len(axes)
+        axes = sorted(a % ndim for a in axes)
+        for a in axes:
+            shape.insert(a, 1)
+        return self.reshape(x, shape)
+
+    def squeeze(self, x: Expr, axes: Optional[Sequence[int]] = None) -> Expr:
+        shape = self.shape_of(x)
+        if axes is None:
+            axes = [i for i, d in enumerate(shape) if isinstance(d, tir.IntImm) and d.value == 1]
+        axes = {a % len(shape) for a in axes}
+        return self.reshape(x, [d for i, d in enumerate(shape) if i not in axes])
+
+    def concat(self, xs: Sequence[Expr], axis: int) -> Expr:
+        return self.emit_te(lambda *ts: topi.concatenate(ts, axis), *xs, name="concatenate")
+
+    def take(self, x: Expr, indices: Expr, axis: int) -> Expr:
+        return self.emit_te(lambda t, i: topi.take(t, i, axis=axis), x, indices, name="take")
+
+    def strided_slice(self, x: Expr, begin, end, strides, axes) -> Expr:
+        return self.emit_te(
+            lambda t: topi.strided_slice(t, begin, end, strides, axes), x, name="strided_slice"
+        )
+
+    def softmax(self, x: Expr, axis: int) -> Expr:
+        return self.bb.emit(relax.op.nn.softmax(x, axis))
+
+    def layer_norm(self, x: Expr, gamma: Expr, beta: Expr, axis: int, epsilon: float) -> Expr:
+        return self.bb.emit(relax.op.nn.layer_norm(x, gamma, beta, axis, epsilon))
+
+    def reduce(self, op: str, x: Expr, axes: Optional[Sequence[int]], keepdims: bool) -> Expr:
+        """A reduction, sum is the Relax op, the others are topi ones: mean, max, min, prod."""
+        axes = list(axes) if axes is not None else None
+        if op == "sum":
+            return self.bb.emit(relax.op.sum(x, axes, keepdims))
+        return self.emit_te(lambda t: getattr(topi, op)(t, axes, keepdims), x, name=op)
+
+    def conv2d(self, x, weight, bias, strides, padding, dilation, groups) -> Expr:
+        """An NCHW conv2d with an OIHW weight, padding is (top, left, bottom, right)."""
+
+        def conv(t, w):
+            if groups == 1:
+                return topi.nn.conv2d(t, w, strides, padding, dilation, "NCHW")
+            return topi.nn.group_conv2d_nchw(t, w, strides, padding, dilation, groups)
+
+        out = self.emit_te(conv, x, weight, name="conv2d")
+        if bias is None:
+            return out
+        return self.binary("add", out, self.reshape(bias, [1, -1, 1, 1]))
+
+    def pool2d(
+        self, x, pool_type, kernel, strides, padding, dilation, ceil_mode, count_include_pad=False
+    ) -> Expr:
+        """An NCHW max or avg pooling, padding is (top, left, bottom, right)."""
+        return self.emit_te(
+            lambda t: topi.nn.pool2d(
+                t,
+                kernel,
+                strides,
+                dilation,
+                padding,
+                pool_type,
+                ceil_mode,
+                "NCHW",
+                count_include_pad,
+            ),
+            x,
+            name=pool_type + "_pool2d",
+        )
+
+    def adaptive_avg_pool2d(self, x, output_size) -> Expr:
+        return self.emit_te(
+            lambda t: topi.nn.adaptive_pool(t, output_size, "avg", "NCHW"),
+            x,
+            name="adaptive_avg_pool2d",
+        )
+
+    def batch_norm(self, x, gamma, beta, mean, var, epsilon: float) -> Expr:
+        """An inference batch norm over the axis 1, folded to a scale and a shift when its
+        parameters are constants."""
+        ndim = len(self.shape_of(x))
+        scale = gamma / np.sqrt(var + epsilon)
+        shift = beta - mean * scale
+        bshape = [1, -1] + [1] * (ndim - 2)
+        dtype = self.dtype_of(x)
+        out = self.binary("multiply", x, self.const(scale.reshape(bshape), dtype))
+        return self.binary("add", out, self.const(shift.reshape(bshape), dtype))
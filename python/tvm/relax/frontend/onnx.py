@@ -0,0 +1,409 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name, import-outside-toplevel, unused-argument
+"""Import an ONNX model to Relax.
+
+The nodes are converted in the topological order of the graph. The initializers, the Constant
+nodes and the shapes read by the Shape nodes are static values, numpy arrays, and the nodes whose
+inputs are all static are folded with numpy. The dimensions of a shape are PrimExpr, held by an
+array of objects, so that the Shape, Gather, Concat and Reshape chains of the models exported with
+dynamic axes keep their symbolic dimensions rather than becoming runtime shape computations.
+
+The ops follow the semantics of the opset 13 and later: the axes of the reductions, Squeeze and
+Unsqueeze can be inputs, and Softmax is over a single axis.
+"""
+import math
+from typing import Dict, List, Optional, Sequence, Union
+
+import numpy as np
+
+from tvm import relax, tir
+from tvm.ir.module import IRModule
+
+from .common import ImporterBase
+
+_INT_MAX = 2**63 - 1
+
+
+def _np_dtype(onnx_dtype: int):
+    from onnx import helper
+
+    if hasattr(helper, "tensor_dtype_to_np_dtype"):
+        return helper.tensor_dtype_to_np_dtype(onnx_dtype)
+    from onnx import mapping
+
+    return mapping.TENSOR_TYPE_TO_NP_TYPE[onnx_dtype]
+
+
+def _static_int(v):
+    """An int of a static value, an int or a constant PrimExpr."""
+    if isinstance(v, tir.IntImm):
+        return int(v.value)
+    return int(v)
+
+
+class ONNXImporter(ImporterBase):
+    """The converter of the nodes of an ONNX graph."""
+
+    def __init__(self):
+        super().__init__()
+        self.env: Dict[str, Union[relax.Expr, np.ndarray]] = {}
+        self.converters = {
+            "Add": self._binary("add", np.add),
+            "Sub": self._binary("subtract", np.subtract),
+            "Mul": self._binary("multiply", np.multiply),
+            "Div": self._binary("divide", None),
+            "Pow": self._binary("power", np.power),
+            "Relu": self._unary("relu"),
+            "Sigmoid": self._unary("sigmoid"),
+            "Tanh": self._unary("tanh"),
+            "Exp": self._unary("exp"),
+            "Log": self._unary("log"),
+            "Sqrt": self._unary("sqrt"),
+            "Erf": self._unary("erf"),
+            "Neg": self._unary("negative"),
+            "Abs": self._unary("abs"),
+            "Gelu": self._gelu,
+            "MatMul": lambda node, a, b: self.matmul(self.tensor(a), self.tensor(b)),
+            "Gemm": self._gemm,
+            "Conv": self._conv,
+            "MaxPool": self._pool("max"),
+            "AveragePool": self._pool("avg"),
+            "GlobalAveragePool": lambda node, x: self.adaptive_avg_pool2d(x, (1, 1)),
+            "BatchNormalization": self._batch_norm,
+            "Flatten": self._flatten,
+            "Reshape": self._reshape,
+            "Transpose": self._transpose,
+            "Softmax": lambda node, x: self.softmax(x, self.attr(node, "axis", -1)),
+            "LayerNormalization": self._layer_norm,
+            "ReduceSum": self._reduce("sum"),
+            "ReduceMean": self._reduce("mean"),
+            "ReduceMax": self._reduce("max"),
+            "Concat": self._concat,
+            "Identity": lambda node, x: x,
+            "Dropout": lambda node, x, *args: x,
+            "Unsqueeze": self._unsqueeze,
+            "Squeeze": self._squeeze,
+            "Gather": self._gather,
+            "Cast": self._cast,
+            "Constant": self._constant,
+            "Shape": self._shape,
+            "Slice": self._slice,
+        }
+
+    # the values
+
+    @staticmethod
+    def attr(node, name: str, default=None):
+        from onnx import helper
+
+        for a in node.attribute:
+            if a.name == name:
+                value = helper.get_attribute_value(a)
+                return value.decode() if isinstance(value, bytes) else value
+        return default
+
+    @staticmethod
+    def is_static(v) -> bool:
+        return isinstance(v, np.ndarray)
+
+    def tensor(self, v) -> relax.Expr:
+        """A value as a tensor, the static ones as constants."""
+        if not self.is_static(v):
+            return v
+        if v.dtype == object:
+            if not all(isinstance(d, (int, tir.IntImm)) for d in v.flat):
+                raise ValueError("A symbolic shape %s cannot be used as a tensor" % v)
+            v = np.vectorize(_static_int, otypes=["int64"])(v) if v.size else v.astype("int64")
+        return self.const(v)
+
+    def static(self, v, what: str) -> np.ndarray:
+        if not self.is_static(v):
+            raise ValueError("The %s must be a constant" % what)
+        return v
+
+    def static_ints(self, v, what: str) -> List[int]:
+        return [_static_int(d) for d in self.static(v, what).flat]
+
+    # the converters
+
+    def _binary(self, op, np_op):
+        def convert(node, a, b):
+            if self.is_static(a) and self.is_static(b):
+                if np_op is not None:
+                    return np.asarray(np_op(a, b))
+                integral = a.dtype == object or np.issubdtype(a.dtype, np.integer)
+                return np.asarray(a // b if integral else a / b)
+            return self.binary(op, self._operand(a, b), self._operand(b, a))
+
+        return convert
+
+    def _operand(self, v, other):
+        """An operand of a binary op, the static ones in the dtype of the other operand."""
+        if not self.is_static(v):
+            return v
+        return self.const(self.tensor(v).data.numpy().astype(self.dtype_of(other)))
+
+    def _unary(self, op):
+        return lambda node, x: self.unary(op, self.tensor(x))
+
+    def _gelu(self, node, x):
+        if self.attr(node, "approximate", "none") != "none":
+            raise ValueError("Only the exact Gelu is supported")
+        return self.unary("gelu", self.tensor(x))
+
+    def _gemm(self, node, a, b, c=None):
+        a, b = self.tensor(a), self.tensor(b)
+        alpha, beta = self.attr(node, "alpha", 1.0), self.attr(node, "beta", 1.0)
+        if self.attr(node, "transA", 0):
+            a = self.transpose(a, [1, 0])
+        out = self.linear(a, b, None, transpose_w=bool(self.attr(node, "transB", 0)))
+        if alpha != 1.0:
+            out = self.binary("multiply", out, alpha)
+        if c is not None:
+            c = self.tensor(c)
+            out = self.binary("add", out, c if beta == 1.0 else self.binary("multiply", c, beta))
+        return out
+
+    def _pads(self, node):
+        if self.attr(node, "auto_pad", "NOTSET") not in ("NOTSET", "VALID"):
+            raise ValueError("%s with an auto_pad is not supported" % node.op_type)
+        pads = self.attr(node, "pads", [0, 0, 0, 0])
+        if len(pads) != 4:
+            raise ValueError("Only the 2-D %s is supported" % node.op_type)
+        return tuple(pads)
+
+    def _conv(self, node, x, w, b=None):
+        return self.conv2d(
+            self.tensor(x),
+            self.tensor(w),
+            None if b is None else self.tensor(b),
+            tuple(self.attr(node, "strides", [1, 1])),
+            self._pads(node),
+            tuple(self.attr(node, "dilations", [1, 1])),
+            self.attr(node, "group", 1),
+        )
+
+    def _pool(self, pool_type):
+        def convert(node, x):
+            kernel = tuple(self.attr(node, "kernel_shape"))
+            return self.pool2d(
+                x,
+                pool_type,
+                kernel,
+                tuple(self.attr(node, "strides", [1, 1])),
+                self._pads(node),
+                tuple(self.attr(node, "dilations", [1, 1])),
+                bool(self.attr(node, "ceil_mode", 0)),
+                bool(self.attr(node, "count_include_pad", 0)),
+            )
+
+        return convert
+
+    def _batch_norm(self, node, x, gamma, beta, mean, var):
+        params = [
+            self.static(v, "parameters of BatchNormalization") for v in (gamma, beta, mean, var)
+        ]
+        return self.batch_norm(x, *params, self.attr(node, "epsilon", 1e-5))
+
+    def _flatten(self, node, x):
+        shape = self.shape_of(x)
+        axis = self.attr(node, "axis", 1) % (len(shape) + 1)
+        return self.reshape(x, [math.prod(shape[:axis]), math.prod(shape[axis:])])
+
+    def _reshape(self, node, x, shape):
+        new_shape = list(self.static(shape, "shape of Reshape").flat)
+        allow_zero = bool(self.attr(node, "allowzero", 0))
+        if self.is_static(x):
+            return x.reshape([_static_int(d) for d in new_shape])
+        new_shape = [
+            d if isinstance(d, tir.PrimExpr) and not isinstance(d, tir.IntImm) else _static_int(d)
+            for d in new_shape
+        ]
+        return self.reshape(x, new_shape, allow_zero)
+
+    def _transpose(self, node, x):
+        perm = self.attr(node, "perm")
+        if self.is_static(x):
+            return np.transpose(x, perm)
+        return self.transpose(x, perm)
+
+    def _layer_norm(self, node, x, scale, bias=None):
+        if bias is None:
+            bias = np.zeros(self.static(scale, "scale of LayerNormalization").shape, "float32")
+        return self.layer_norm(
+            x,
+            self.tensor(scale),
+            self.tensor(bias),
+            self.attr(node, "axis", -1),
+            self.attr(node, "epsilon", 1e-5),
+        )
+
+    def _axes(self, node, axes_input):
+        """The axes of an op, an input since the opset 13 (18 for the reductions), an attribute
+        before."""
+        if axes_input is not None:
+            return self.static_ints(axes_input, "axes of " + node.op_type)
+        return self.attr(node, "axes")
+
+    def _reduce(self, op):
+        def convert(node, x, axes=None):
+            axes = self._axes(node, axes)
+            if not axes and self.attr(node, "noop_with_empty_axes", 0):
+                return x
+            keepdims = bool(self.attr(node, "keepdims", 1))
+            return self.reduce(op, self.tensor(x), axes or None, keepdims)
+
+        return convert
+
+    def _concat(self, node, *xs):
+        axis = self.attr(node, "axis")
+        if all(self.is_static(x) for x in xs):
+            return np.concatenate(xs, axis)
+        return self.concat([self.tensor(x) for x in xs], axis)
+
+    def _unsqueeze(self, node, x, axes=None):
+        axes = self._axes(node, axes)
+        if self.is_static(x):
+            ndim = x.ndim + len(axes)
+            for a in sorted(a % ndim for a in axes):
+                x = np.expand_dims(x, a)
+            return x
+        return self.expand_dims(x, axes)
+
+    def _squeeze(self, node, x, axes=None):
+        axes = self._axes(node, axes)
+        if self.is_static(x):
+            return np.squeeze(x, tuple(axes) if axes else None)
+        return self.squeeze(x, axes)
+
+    def _gather(self, node, x, indices):
+        axis = self.attr(node, "axis", 0)
+        if self.is_static(x) and self.is_static(indices):
+            return np.take(x, indices.astype("int64"), axis)
+        return self.take(self.tensor(x), self.tensor(indices), axis)
+
+    def _cast(self, node, x):
+        dtype = np.dtype(_np_dtype(self.attr(node, "to"))).name
+        if self.is_static(x):
+            return x if x.dtype == object else x.astype(dtype)
+        return self.cast(x, dtype)
+
+    def _constant(self, node):
+        from onnx import numpy_helper
+
+        for a in node.attribute:
+            if a.name == "value":
+                return numpy_helper.to_array(a.t)
+            if a.name in ("value_float", "value_int"):
+                return np.array(a.f if a.name == "value_float" else a.i)
+            if a.name in ("value_floats", "value_ints"):
+                return np.array(list(a.floats if a.name == "value_floats" else a.ints))
+        raise ValueError("Unsupported Constant %s" % node.name)
+
+    def _shape(self, node, x):
+        if self.is_static(x):
+            return np.array(x.shape, "int64")
+        shape = np.empty(len(self.shape_of(x)), dtype=object)
+        shape[:] = self.shape_of(x)
+        return shape
+
+    def _slice(self, node, x, starts, ends, axes=None, steps=None):
+        starts = self.static_ints(starts, "starts of Slice")
+        ends = self.static_ints(ends, "ends of Slice")
+        ndim = x.ndim if self.is_static(x) else len(self.shape_of(x))
+        axes = self.static_ints(axes, "axes of Slice") if axes is not None else range(len(starts))
+        if steps is None:
+            steps = [1] * len(starts)
+        else:
+            steps = self.static_ints(steps, "steps of Slice")
+        if self.is_static(x):
+            index = [slice(None)] * ndim
+            for start, end, axis, step in zip(starts, ends, axes, steps):
+                index[axis] = slice(start, end, step)
+            return x[tuple(index)]
+        ends = [min(e, _INT_MAX) for e in ends]
+        return self.strided_slice(x, starts, ends, steps, [a % ndim for a in axes])
+
+    # the graph
+
+    def input_shape(self, value_info) -> List[Union[int, str]]:
+        shape = []
+        for i, d in enumerate(value_info.type.tensor_type.shape.dim):
+            if d.dim_param:
+                shape.append(d.dim_param)
+            elif d.dim_value > 0:
+                shape.append(d.dim_value)
+            else:
+                shape.append("%s_%d" % (value_info.name, i))
+        return shape
+
+    def from_onnx(self, model, shape_dict: Optional[Dict[str, Sequence]]) -> IRModule:
+        """Convert an ONNX model, see from_onnx."""
+        from onnx import numpy_helper
+
+        graph = model.graph
+        shape_dict = shape_dict or {}
+        for init in graph.initializer:
+            self.env[init.name] = numpy_helper.to_array(init)
+        inputs = []
+        for value_info in graph.input:
+            if value_info.name in self.env:
+                continue
+            shape = shape_dict.get(value_info.name, self.input_shape(value_info))
+            dtype = np.dtype(_np_dtype(value_info.type.tensor_type.elem_type)).name
+            inputs.append(self.input_var(value_info.name, shape, dtype))
+            self.env[value_info.name] = inputs[-1]
+        with self.bb.function("main", inputs):
+            with self.bb.dataflow():
+                for node in graph.node:
+                    converter = self.converters.get(node.op_type)
+                    if converter is None:
+                        raise ValueError("Unsupported ONNX op %s of %s" % (node.op_type, node.name))
+                    args = [self.env[name] if name else None for name in node.input]
+                    # the absent optional inputs at the end are left to their defaults
+                    while args and args[-1] is None:
+                        args.pop()
+                    out = converter(node, *args)
+                    self.env[node.output[0]] = out
+                outputs = [self.tensor(self.env[out.name]) for out in graph.output]
+                output = self.bb.emit_output(
+                    outputs[0] if len(outputs) == 1 else relax.Tuple(outputs)
+                )
+            self.bb.emit_func_output(output)
+        return self.bb.get()
+
+
+def from_onnx(model, shape_dict: Optional[Dict[str, Sequence[Union[int, str]]]] = None) -> IRModule:
+    """Convert an ONNX model to a Relax module whose "main" function computes the graph.
+
+    Parameters
+    ----------
+    model : onnx.ModelProto
+        The model.
+
+    shape_dict : Optional[Dict[str, Sequence[Union[int, str]]]]
+        The shapes of the inputs overriding the ones of the graph, by name. A dimension is an int
+        or the name of a symbolic dimension. The dimensions of the graph named by a dim_param are
+        symbolic, as well as the unknown ones.
+
+    Returns
+    -------
+    mod : IRModule
+        The Relax module.
+    """
+    return ONNXImporter().from_onnx(model, shape_dict)
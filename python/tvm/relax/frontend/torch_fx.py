@@ -0,0 +1,412 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name, import-outside-toplevel, unused-argument
+"""Import a torch.fx graph to Relax.
+
+The graph of a symbolically traced module is converted node by node: the placeholders become the
+parameters of the Relax function, with the shapes given by the input info in which a dimension
+can be the name of a symbolic one, and the parameters of the module become constants. The sizes
+of the tensors read by the graph, x.size() or x.shape, are the PrimExpr of their shapes, so that
+the reshapes computed from them stay symbolic.
+"""
+import operator
+from typing import Callable, Dict, List, Sequence, Tuple, Union
+
+import numpy as np
+
+from tvm import relax
+from tvm.ir.module import IRModule
+
+from .common import ImporterBase
+
+
+class TorchFXImporter(ImporterBase):
+    """The converter of the nodes of a torch.fx graph."""
+
+    def __init__(self):
+        super().__init__()
+        self.env = {}
+        self.named_modules = {}
+        self.module_converters: Dict[type, Callable] = {}
+        self.function_converters: Dict[Union[Callable, str], Callable] = {}
+        self.method_converters: Dict[str, Callable] = {}
+
+    # the values of the graph
+
+    def retrieve(self, arg):
+        """The converted value of an argument of a node, recursively in the tuples and lists."""
+        import torch.fx
+
+        if isinstance(arg, torch.fx.Node):
+            return self.env[arg]
+        if isinstance(arg, (tuple, list)):
+            return type(arg)(self.retrieve(a) for a in arg)
+        if isinstance(arg, dict):
+            return {k: self.retrieve(v) for k, v in arg.items()}
+        return arg
+
+    def param(self, tensor):
+        """A parameter or a buffer of the module, as a constant."""
+        return self.const(tensor.detach().cpu().numpy())
+
+    @staticmethod
+    def dtype_str(dtype) -> str:
+        return str(dtype).split(".")[-1]
+
+    # the converters
+
+    def _binary(self, op):
+        def convert(node, lhs, rhs, **kwargs):
+            if not isinstance(lhs, relax.Expr) and not isinstance(rhs, relax.Expr):
+                # arithmetic of the sizes
+                return {
+                    "add": operator.add,
+                    "subtract": operator.sub,
+                    "multiply": operator.mul,
+                    "floor_divide": operator.floordiv,
+                }[op](lhs, rhs)
+            return self.binary(op, lhs, rhs)
+
+        return convert
+
+    def _unary(self, op):
+        return lambda node, x, *args, **kwargs: self.unary(op, x)
+
+    def _size(self, node, x, dim=None):
+        shape = self.shape_of(x)
+        return shape if dim is None else shape[dim]
+
+    def _reshape(self, node, x, *shape):
+        if len(shape) == 1 and isinstance(shape[0], (list, tuple)):
+            shape = shape[0]
+        return self.reshape(x, shape)
+
+    def _permute(self, node, x, *axes):
+        if len(axes) == 1 and isinstance(axes[0], (list, tuple)):
+            axes = axes[0]
+        return self.transpose(x, axes)
+
+    def _transpose(self, node, x, dim0, dim1):
+        axes = list(range(len(self.shape_of(x))))
+        axes[dim0], axes[dim1] = axes[dim1], axes[dim0]
+        return self.transpose(x, axes)
+
+    def _flatten(self, node, x, start_dim=1, end_dim=-1):
+        return self.flatten(x, start_dim, end_dim)
+
+    def _softmax(self, node, x, dim=-1, **kwargs):
+        return self.softmax(x, dim)
+
+    def _cat(self, node, xs, dim=0):
+        return self.concat(xs, dim)
+
+    def _getitem(self, node, x, index):
+        if isinstance(x, (list, tuple)):
+            return x[index]
+        if isinstance(x, relax.Expr) and isinstance(x.checked_type, relax.TupleType):
+            return self.bb.emit(relax.TupleGetItem(x, index))
+        raise ValueError("Indexing a tensor is not supported, in %s" % node.format_node())
+
+    def _getattr(self, node, x, attr):
+        if attr != "shape":
+            raise ValueError("Unsupported attribute %s, in %s" % (attr, node.format_node()))
+        return self.shape_of(x)
+
+    def _identity_module(self, node, module, x):
+        return x
+
+    def _matmul(self, node, a, b):
+        return self.matmul(a, b)
+
+    def _linear(self, node, x, weight, bias=None):
+        return self.linear(x, weight, bias, transpose_w=True)
+
+    def _sdpa(self, node, q, k, v, attn_mask=None, dropout_p=0.0, is_causal=False, **kwargs):
+        if attn_mask is not None:
+            raise ValueError("scaled_dot_product_attention with a mask is not supported")
+        # torch is (batch, heads, seq, dim), relax.nn.attention (batch, seq, heads, dim)
+        q, k, v = [self.transpose(t, [0, 2, 1, 3]) for t in (q, k, v)]
+        out = self.bb.emit(relax.op.nn.attention(q, k, v, kwargs.get("scale"), bool(is_causal)))
+        return self.transpose(out, [0, 2, 1, 3])
+
+    def _mean(self, node, x, dim=None, keepdim=False, **kwargs):
+        dims = [dim] if isinstance(dim, int) else dim
+        return self.reduce("mean", x, dims, keepdim)
+
+    def _sum(self, node, x, dim=None, keepdim=False, **kwargs):
+        dims = [dim] if isinstance(dim, int) else dim
+        return self.reduce("sum", x, dims, keepdim)
+
+    def _unsqueeze(self, node, x, dim):
+        return self.expand_dims(x, [dim])
+
+    def _squeeze(self, node, x, dim=None):
+        return self.squeeze(x, None if dim is None else [dim])
+
+    def _to(self, node, x, *args, **kwargs):
+        import torch
+
+        dtype = kwargs.get("dtype", next((a for a in args if isinstance(a, torch.dtype)), None))
+        return x if dtype is None else self.cast(x, self.dtype_str(dtype))
+
+    def _conv2d_module(self, node, module, x):
+        def pair(v):
+            return (v, v) if isinstance(v, int) else tuple(v)
+
+        if isinstance(module.padding, str):
+            raise ValueError("Conv2d with a padding of %s is not supported" % module.padding)
+        pad = pair(module.padding)
+        return self.conv2d(
+            x,
+            self.param(module.weight),
+            self.param(module.bias) if module.bias is not None else None,
+            pair(module.stride),
+            (pad[0], pad[1], pad[0], pad[1]),
+            pair(module.dilation),
+            module.groups,
+        )
+
+    def _pool2d_module(self, pool_type):
+        def convert(node, module, x):
+            def pair(v):
+                return (v, v) if isinstance(v, int) else tuple(v)
+
+            pad = pair(module.padding)
+            return self.pool2d(
+                x,
+                pool_type,
+                pair(module.kernel_size),
+                pair(module.stride or module.kernel_size),
+                (pad[0], pad[1], pad[0], pad[1]),
+                pair(getattr(module, "dilation", 1)),
+                module.ceil_mode,
+            )
+
+        return convert
+
+    def _adaptive_avg_pool2d_module(self, node, module, x):
+        size = module.output_size
+        return self.adaptive_avg_pool2d(x, (size, size) if isinstance(size, int) else size)
+
+    def _batch_norm_module(self, node, module, x):
+        if module.training:
+            raise ValueError("BatchNorm is only supported in eval mode")
+
+        def numpy(t):
+            return t.detach().cpu().numpy()
+
+        num = module.num_features
+        gamma = numpy(module.weight) if module.affine else np.ones(num, "float32")
+        beta = numpy(module.bias) if module.affine else np.zeros(num, "float32")
+        return self.batch_norm(
+            x, gamma, beta, numpy(module.running_mean), numpy(module.running_var), module.eps
+        )
+
+    def _layer_norm_module(self, node, module, x):
+        if len(module.normalized_shape) != 1:
+            raise ValueError("LayerNorm is only supported over the last axis")
+        num = module.normalized_shape[0]
+        affine = module.elementwise_affine
+        gamma = self.param(module.weight) if affine else self.const(np.ones(num, "float32"))
+        beta = self.param(module.bias) if affine else self.const(np.zeros(num, "float32"))
+        return self.layer_norm(x, gamma, beta, -1, module.eps)
+
+    def _embedding_module(self, node, module, x):
+        return self.take(self.param(module.weight), x, 0)
+
+    def create_converters(self):
+        """Fill the converters of the modules, the functions and the methods."""
+        import torch
+        from torch import nn
+        from torch.nn import functional as F
+
+        binary = {
+            "add": [operator.add, torch.add],
+            "subtract": [operator.sub, torch.sub],
+            "multiply": [operator.mul, torch.mul],
+            "divide": [operator.truediv, torch.div],
+            "floor_divide": [operator.floordiv],
+            "power": [operator.pow, torch.pow],
+        }
+        for op, targets in binary.items():
+            for target in targets:
+                self.function_converters[target] = self._binary(op)
+            self.method_converters[targets[-1].__name__] = self._binary(op)
+        unary = {
+            "relu": [F.relu, torch.relu],
+            "gelu": [F.gelu],
+            "sigmoid": [torch.sigmoid],
+            "tanh": [torch.tanh],
+            "exp": [torch.exp],
+            "sqrt": [torch.sqrt],
+            "erf": [torch.erf],
+            "negative": [operator.neg, torch.neg],
+        }
+        for op, targets in unary.items():
+            for target in targets:
+                self.function_converters[target] = self._unary(op)
+            self.method_converters[targets[-1].__name__] = self._unary(op)
+        self.function_converters.update(
+            {
+                torch.matmul: self._matmul,
+                operator.matmul: self._matmul,
+                F.linear: self._linear,
+                F.softmax: self._softmax,
+                torch.softmax: self._softmax,
+                torch.flatten: self._flatten,
+                torch.cat: self._cat,
+                torch.transpose: self._transpose,
+                torch.permute: self._permute,
+                torch.reshape: self._reshape,
+                torch.mean: self._mean,
+                torch.sum: self._sum,
+                torch.unsqueeze: self._unsqueeze,
+                torch.squeeze: self._squeeze,
+                operator.getitem: self._getitem,
+                getattr: self._getattr,
+            }
+        )
+        if hasattr(F, "scaled_dot_product_attention"):
+            self.function_converters[F.scaled_dot_product_attention] = self._sdpa
+        self.method_converters.update(
+            {
+                "size": self._size,
+                "view": self._reshape,
+                "reshape": self._reshape,
+                "permute": self._permute,
+                "transpose": self._transpose,
+                "flatten": self._flatten,
+                "softmax": self._softmax,
+                "contiguous": lambda node, x, *args, **kwargs: x,
+                "mean": self._mean,
+                "sum": self._sum,
+                "unsqueeze": self._unsqueeze,
+                "squeeze": self._squeeze,
+                "to": self._to,
+                "float": lambda node, x: self.cast(x, "float32"),
+            }
+        )
+        self.module_converters.update(
+            {
+                nn.Linear: lambda node, module, x: self.linear(
+                    x,
+                    self.param(module.weight),
+                    self.param(module.bias) if module.bias is not None else None,
+                    transpose_w=True,
+                ),
+                nn.Conv2d: self._conv2d_module,
+                nn.MaxPool2d: self._pool2d_module("max"),
+                nn.AvgPool2d: self._pool2d_module("avg"),
+                nn.AdaptiveAvgPool2d: self._adaptive_avg_pool2d_module,
+                nn.BatchNorm2d: self._batch_norm_module,
+                nn.LayerNorm: self._layer_norm_module,
+                nn.Embedding: self._embedding_module,
+                nn.ReLU: lambda node, module, x: self.unary("relu", x),
+                nn.GELU: lambda node, module, x: self.unary("gelu", x),
+                nn.Sigmoid: lambda node, module, x: self.unary("sigmoid", x),
+                nn.Tanh: lambda node, module, x: self.unary("tanh", x),
+                nn.Softmax: lambda node, module, x: self.softmax(x, module.dim),
+                nn.Flatten: lambda node, module, x: self.flatten(
+                    x, module.start_dim, module.end_dim
+                ),
+                nn.Dropout: self._identity_module,
+                nn.Identity: self._identity_module,
+            }
+        )
+
+    # the graph
+
+    def convert_node(self, node, model):
+        """Convert a call node of the graph."""
+        args = self.retrieve(node.args)
+        kwargs = self.retrieve(node.kwargs)
+        if node.op == "call_module":
+            module = self.named_modules[node.target]
+            converter = self.module_converters.get(type(module))
+            if converter is None:
+                raise ValueError("Unsupported module %s of %s" % (type(module), node.target))
+            return converter(node, module, *args, **kwargs)
+        if node.op == "call_function":
+            converter = self.function_converters.get(node.target)
+            name = getattr(node.target, "__name__", node.target)
+        else:
+            converter = self.method_converters.get(node.target)
+            name = node.target
+        if converter is None:
+            raise ValueError("Unsupported %s %s, in %s" % (node.op, name, node.format_node()))
+        return converter(node, *args, **kwargs)
+
+    def from_fx(self, model, input_info: List[Tuple[Sequence, str]]) -> IRModule:
+        """Convert a torch.fx.GraphModule, see from_fx."""
+        self.create_converters()
+        self.named_modules = dict(model.named_modules())
+        inputs = []
+        with self.bb.function("main"):
+            with self.bb.dataflow():
+                for node in model.graph.nodes:
+                    if node.op == "placeholder":
+                        if len(inputs) >= len(input_info):
+                            raise ValueError("The input info misses the input %s" % node.name)
+                        shape, dtype = input_info[len(inputs)]
+                        inputs.append(self.input_var(node.name, shape, dtype))
+                        self.env[node] = inputs[-1]
+                    elif node.op == "get_attr":
+                        attr = model
+                        for name in node.target.split("."):
+                            attr = getattr(attr, name)
+                        self.env[node] = self.param(attr)
+                    elif node.op == "output":
+                        out = self.retrieve(node.args[0])
+                        if isinstance(out, (tuple, list)):
+                            out = self.bb.emit(relax.Tuple(list(out)))
+                        output = self.bb.emit_output(out)
+                    else:
+                        self.env[node] = self.convert_node(node, model)
+            self.bb.emit_func_output(output, inputs)
+        return self.bb.get()
+
+
+def from_fx(model, input_info: List[Tuple[Sequence[Union[int, str]], str]]) -> IRModule:
+    """Convert a torch.fx.GraphModule, or a torch.nn.Module traced symbolically, to a Relax
+    module whose "main" function computes the module in inference.
+
+    Parameters
+    ----------
+    model : Union[torch.fx.GraphModule, torch.nn.Module]
+        The model, in eval mode.
+
+    input_info : List[Tuple[Sequence[Union[int, str]], str]]
+        The shape and the dtype of each input, in order. A dimension is an int or the name of a
+        symbolic dimension, the dimensions of the same name are equal.
+
+    Returns
+    -------
+    mod : IRModule
+        The Relax module.
+
+    Example
+    -------
+
+    .. code-block:: python
+
+        mod = from_fx(torch.fx.symbolic_trace(model), [(("batch", 3, 224, 224), "float32")])
+    """
+    import torch.fx
+
+    if not isinstance(model, torch.fx.GraphModule):
+        model = torch.fx.symbolic_trace(model)
+    return TorchFXImporter().from_fx(model, input_info)
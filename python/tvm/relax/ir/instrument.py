@@ -23,15 +23,17 @@ from tvm import relax
 class WellFormedInstrument:
     """An instrument that checks the input/output IRModule of the Pass
     is well formed. It will skip specific passes, like Normalize.
+    The functions left unchanged by a pass are not checked again.
     """
 
     def __init__(self):
         self.skip_pass_name = ["Normalize", "ResolveGlobals"]
+        self.cache = relax.analysis.WellFormedCache()
 
     def run_before_pass(self, mod, pass_info):
         if pass_info.name not in self.skip_pass_name:
-            assert relax.analysis.well_formed(mod)
+            assert relax.analysis.well_formed(mod, self.cache)
 
     def run_after_pass(self, mod, pass_info):
         if pass_info.name not in self.skip_pass_name:
-            assert relax.analysis.well_formed(mod)
+            assert relax.analysis.well_formed(mod, self.cache)
@@ -23,3 +23,5 @@ from .tensor import *
 from .op_attrs import *
 from . import builtin
 from . import memory
+from . import nn
+from . import ccl
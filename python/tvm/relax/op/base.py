@@ -23,7 +23,7 @@ from tvm.runtime.object import Object
 from . import _ffi_api
 from ..expr import Expr, ShapeExpr, Tuple, Call, ExternFunc
 from ..ty import DynTensorType, TupleType
-from ...ir import Array
+from ...ir import Array, PrimExpr
 
 py_print = print  # pylint: disable=invalid-name
 
@@ -216,6 +216,65 @@ def print(values: Union[Expr, List[Expr]], format: str) -> Expr:
     return _ffi_api.print(values, format)  # type: ignore # pylint: disable=no-member
 
 
+def param_load(name: str, shape: List[PrimExpr], dtype: str) -> Expr:
+    """Load a param by name from the param store of the VM, see
+    :py:func:`tvm.relax.transform.ExternalizeParams`.
+
+    Parameters
+    ----------
+    name : str
+        The name of the param in the store.
+
+    shape : List[PrimExpr]
+        The shape of the param.
+
+    dtype : str
+        The data type of the param.
+
+    Returns
+    -------
+    result : Expr
+        A relax Call, which returns the param on the device of the VM at runtime.
+    """
+    return _ffi_api.param_load(name, shape, dtype)  # type: ignore # pylint: disable=no-member
+
+
+def prefetch(data: Expr, scope: str = "global.vtcm") -> Expr:
+    """Start copying a tensor to a memory scope of its device, e.g. by DMA to the VTCM of
+    Hexagon, see :py:func:`tvm.relax.transform.PrefetchWeights`.
+
+    Parameters
+    ----------
+    data : Expr
+        The tensor to copy.
+
+    scope : str
+        The memory scope of the copy.
+
+    Returns
+    -------
+    result : Expr
+        A relax Call, whose result is only valid once passed through :py:func:`prefetch_wait`.
+    """
+    return _ffi_api.prefetch(data, scope)  # type: ignore # pylint: disable=no-member
+
+
+def prefetch_wait(data: Expr) -> Expr:
+    """Wait for the copy started by :py:func:`prefetch`.
+
+    Parameters
+    ----------
+    data : Expr
+        The result of the prefetch.
+
+    Returns
+    -------
+    result : Expr
+        A relax Call, which returns the copied tensor.
+    """
+    return _ffi_api.prefetch_wait(data)  # type: ignore # pylint: disable=no-member
+
+
 @tvm.register_func("relax.run.assert_op")
 def relax_assert_op(condition: tvm.Object, format_str: str, *format_args: tvm.Object) -> None:
     """
@@ -0,0 +1,104 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Relax collective communication operators.
+
+The collectives run in the VM of each worker of a group executing the same program, on the
+communicator set with :py:meth:`tvm.relax.VirtualMachine.set_communicator`. They work along the
+first axis of the tensors.
+"""
+from . import _ffi_api
+from ...expr import Expr
+
+
+def allreduce(data: Expr, op_type: str = "sum") -> Expr:
+    """Reduce the tensors of all the workers, each worker getting the result.
+
+    Parameters
+    ----------
+    data : Expr
+        The input tensor.
+
+    op_type : str
+        The reduction, one of "sum", "prod", "min" and "max".
+
+    Returns
+    -------
+    ret: Expr
+        The created relax call.
+    """
+    return _ffi_api.allreduce(data, op_type)  # type: ignore
+
+
+def allgather(data: Expr, num_workers: int) -> Expr:
+    """Concatenate the tensors of all the workers along the first axis, in rank order.
+
+    Parameters
+    ----------
+    data : Expr
+        The input tensor.
+
+    num_workers : int
+        The number of workers of the group.
+
+    Returns
+    -------
+    ret: Expr
+        The created relax call.
+    """
+    return _ffi_api.allgather(data, num_workers)  # type: ignore
+
+
+def reduce_scatter(data: Expr, num_workers: int, op_type: str = "sum") -> Expr:
+    """Reduce the tensors of all the workers, each worker getting its chunk of the result along
+    the first axis.
+
+    Parameters
+    ----------
+    data : Expr
+        The input tensor, whose first dimension is divisible by num_workers.
+
+    num_workers : int
+        The number of workers of the group.
+
+    op_type : str
+        The reduction, one of "sum", "prod", "min" and "max".
+
+    Returns
+    -------
+    ret: Expr
+        The created relax call.
+    """
+    return _ffi_api.reduce_scatter(data, num_workers, op_type)  # type: ignore
+
+
+def local_shard(data: Expr, num_workers: int) -> Expr:
+    """The chunk of the worker of a tensor replicated on all the workers, along the first axis.
+
+    Parameters
+    ----------
+    data : Expr
+        The input tensor, whose first dimension is divisible by num_workers.
+
+    num_workers : int
+        The number of workers of the group.
+
+    Returns
+    -------
+    ret: Expr
+        The created relax call, a view of the input.
+    """
+    return _ffi_api.local_shard(data, num_workers)  # type: ignore
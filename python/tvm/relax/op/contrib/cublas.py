@@ -0,0 +1,95 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""cuBLAS Relax integration.
+
+The matmuls, with their bias add and activation, are offloaded to cuBLASLt, which fuses the bias
+and the activation in the epilogue of the matmul.
+"""
+from typing import List, Tuple
+
+import tvm
+from tvm import relax
+from tvm.relax.dpl import DFPattern, is_op, wildcard
+
+
+def get_patterns() -> List[Tuple[str, DFPattern]]:
+    """Get the cuBLAS patterns, in the order of priority.
+
+    Returns
+    -------
+    patterns : List[Tuple[str, DFPattern]]
+        The table of (name, pattern) pairs, to be passed to
+        :py:func:`tvm.relax.transform.FuseOpsByPattern`.
+    """
+    matmul = is_op("relax.nn.matmul")(wildcard(), wildcard())
+    matmul_bias = is_op("relax.add")(matmul, wildcard())
+    patterns = []
+    for name, pattern in [("matmul_bias", matmul_bias), ("matmul", matmul)]:
+        patterns.append(("cublas." + name + "_gelu", is_op("relax.nn.gelu")(pattern)))
+        patterns.append(("cublas." + name + "_relu", is_op("relax.nn.relu")(pattern)))
+    patterns.append(("cublas.matmul_bias", matmul_bias))
+    patterns.append(("cublas.matmul", matmul))
+    return patterns
+
+
+def check_matmul(func: relax.Function, _mod: tvm.IRModule) -> bool:
+    """Check whether a match is supported by the cuBLASLt epilogues: float16 or float32 inputs,
+    and a bias of shape [N].
+
+    Parameters
+    ----------
+    func : relax.Function
+        The function offloading the match, calling its composite function.
+
+    _mod : tvm.IRModule
+        The module.
+
+    Returns
+    -------
+    ret : bool
+        Whether the match is offloaded.
+    """
+    composite = func.body.blocks[0].bindings[0].value.op
+    matmul_var = None
+    for binding in composite.body.blocks[0].bindings:
+        call = binding.value
+        if call.op == tvm.ir.Op.get("relax.nn.matmul"):
+            if call.args[0].checked_type.dtype not in ["float16", "float32"]:
+                return False
+            matmul_var = binding.var
+        elif call.op == tvm.ir.Op.get("relax.add"):
+            bias = call.args[1] if call.args[0].same_as(matmul_var) else call.args[0]
+            if bias.checked_type.ndim != 1:
+                return False
+    return True
+
+
+def partition_for_cublas(mod: tvm.IRModule) -> tvm.IRModule:
+    """Partition the module to offload its matmuls to cuBLAS. The offloaded functions are
+    compiled by :py:func:`tvm.relax.transform.RunCodegen`.
+
+    Parameters
+    ----------
+    mod : tvm.IRModule
+        The module to partition.
+
+    Returns
+    -------
+    ret : tvm.IRModule
+        The partitioned module.
+    """
+    return relax.transform.FuseOpsByPattern(get_patterns(), check_matmul)(mod)
@@ -0,0 +1,132 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""DNNL (oneDNN) Relax integration.
+
+The dense layers, with their bias add and ReLU, and the elementwise ops are offloaded to the DNNL
+JSON runtime. The consecutive offloaded ops are merged into one subgraph, in which the runtime
+keeps the intermediate tensors in the blocked layouts preferred by oneDNN, without reordering them
+back to the plain layouts between the ops.
+"""
+from typing import List, Tuple
+
+import tvm
+from tvm import relax
+from tvm.relax.dpl import DFPattern, is_op, wildcard
+
+
+def get_patterns() -> List[Tuple[str, DFPattern]]:
+    """Get the DNNL patterns, in the order of priority.
+
+    Returns
+    -------
+    patterns : List[Tuple[str, DFPattern]]
+        The table of (name, pattern) pairs, to be passed to
+        :py:func:`tvm.relax.transform.FuseOpsByPattern`.
+    """
+    dense = is_op("relax.nn.matmul")(wildcard(), wildcard())
+    dense_bias = is_op("relax.add")(dense, wildcard())
+    return [
+        ("dnnl.dense_bias_relu", is_op("relax.nn.relu")(dense_bias)),
+        ("dnnl.dense_relu", is_op("relax.nn.relu")(dense)),
+        ("dnnl.dense_bias", dense_bias),
+        ("dnnl.dense", dense),
+        ("dnnl.relu", is_op("relax.nn.relu")(wildcard())),
+        ("dnnl.add", is_op("relax.add")(wildcard(), wildcard())),
+        ("dnnl.multiply", is_op("relax.multiply")(wildcard(), wildcard())),
+    ]
+
+
+def _is_static_tensor(expr: relax.Expr) -> bool:
+    """Whether an expr is a float32 or bfloat16 tensor of a static shape, as the DNNL primitives
+    are created for the shapes known at compile time."""
+    if not isinstance(expr.checked_type, relax.DynTensorType):
+        return False
+    if expr.checked_type.dtype not in ["float32", "bfloat16"]:
+        return False
+    shape = expr.shape
+    return isinstance(shape, relax.ShapeExpr) and all(
+        isinstance(dim, tvm.tir.IntImm) for dim in shape.values
+    )
+
+
+def check_op(func: relax.Function, _mod: tvm.IRModule) -> bool:
+    """Check whether a match is supported by the DNNL JSON runtime: static float32 or bfloat16
+    tensors, dense layers of 2-D inputs with the weight of shape [N, K] and a bias of shape [N],
+    and elementwise ops on operands of the same rank.
+
+    Parameters
+    ----------
+    func : relax.Function
+        The function offloading the match, calling its composite function.
+
+    _mod : tvm.IRModule
+        The module.
+
+    Returns
+    -------
+    ret : bool
+        Whether the match is offloaded.
+    """
+    composite = func.body.blocks[0].bindings[0].value.op
+    is_dense = composite.attrs["Composite"].startswith("dnnl.dense")
+    if not all(_is_static_tensor(param) for param in composite.params):
+        return False
+    matmul_var = None
+    for binding in composite.body.blocks[0].bindings:
+        call = binding.value
+        if not _is_static_tensor(binding.var):
+            return False
+        if call.op == tvm.ir.Op.get("relax.nn.matmul"):
+            data, weight = call.args
+            if not call.attrs.transpose_b or data.checked_type.ndim != 2:
+                return False
+            if weight.checked_type.ndim != 2:
+                return False
+            matmul_var = binding.var
+        elif is_dense and call.op == tvm.ir.Op.get("relax.add"):
+            bias = call.args[1] if call.args[0].same_as(matmul_var) else call.args[0]
+            if bias.checked_type.ndim != 1:
+                return False
+        elif call.op in [tvm.ir.Op.get("relax.add"), tvm.ir.Op.get("relax.multiply")]:
+            lhs, rhs = call.args
+            if lhs.checked_type.ndim != rhs.checked_type.ndim:
+                return False
+    return True
+
+
+def partition_for_dnnl(mod: tvm.IRModule) -> tvm.IRModule:
+    """Partition the module to offload its dense layers and elementwise ops to DNNL. The chains of
+    offloaded ops are merged into one subgraph each, compiled by
+    :py:func:`tvm.relax.transform.RunCodegen`.
+
+    Parameters
+    ----------
+    mod : tvm.IRModule
+        The module to partition.
+
+    Returns
+    -------
+    ret : tvm.IRModule
+        The partitioned module.
+    """
+    seq = tvm.transform.Sequential(
+        [
+            relax.transform.FuseOpsByPattern(get_patterns(), check_op),
+            relax.transform.MergeCompositeFunctions(),
+        ]
+    )
+    return seq(mod)
@@ -0,0 +1,55 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""TensorRT Relax integration.
+
+The precision of the engines is set by the "relax.ext.tensorrt.options" config of RunCodegen:
+`use_fp16` or `use_int8` for the whole engines, with `fp16_layers` and `fp32_layers` listing
+the ops falling back to a higher precision. The int8 engines are calibrated on the inputs of
+their first `num_calibration_batches` runs, which :py:func:`calibrate_int8` drives through the
+VM. With a `calibration_cache_dir`, the calibration is saved there and reused by the later
+builds, whose engines are built on their first run.
+"""
+from typing import Iterable, Sequence
+
+import tvm
+
+
+def calibrate_int8(vm: "tvm.relax.VirtualMachine", func_name: str, dataset: Iterable[Sequence]):
+    """Calibrate the int8 TensorRT engines of a function on representative data, then build them.
+
+    The calibration runs do not compute the outputs of the function. The dataset must provide
+    `num_calibration_batches` batches of the compiler config, the number of calibration runs.
+
+    Parameters
+    ----------
+    vm : tvm.relax.VirtualMachine
+        The VM of the executable whose offloaded functions were compiled with `use_int8`.
+
+    func_name : str
+        The function to run.
+
+    dataset : Iterable[Sequence[tvm.nd.NDArray]]
+        The arguments of each calibration run.
+    """
+    first_args = None
+    for args in dataset:
+        first_args = first_args or list(args)
+        vm[func_name](*args)
+    if first_args is None:
+        raise ValueError("The calibration dataset is empty")
+    # The run following the calibration runs builds the int8 engines.
+    vm[func_name](*first_args)
@@ -0,0 +1,210 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Relax neural network operators."""
+from typing import Optional
+
+import numpy as np
+import tvm
+
+from . import _ffi_api
+from ...expr import Expr
+
+
+def matmul(data: Expr, weight: Expr, transpose_b: bool = False, out_dtype: Optional[str] = None):
+    """Multiply an input of shape ``[..., K]`` by a weight of shape ``[K, N]``.
+
+    Parameters
+    ----------
+    data : Expr
+        The input tensor.
+
+    weight : Expr
+        The weight tensor, of shape ``[N, K]`` when ``transpose_b`` is set.
+
+    transpose_b : bool
+        Whether the weight is transposed, as the weight of a dense layer.
+
+    out_dtype : Optional[str]
+        The data type of the output, the one of the inputs if None.
+
+    Returns
+    -------
+    ret: Expr
+        The created relax call.
+    """
+    return _ffi_api.matmul(data, weight, transpose_b, out_dtype or "")
+
+
+def relu(data: Expr) -> Expr:
+    """Rectified linear unit, ``max(data, 0)``.
+
+    Parameters
+    ----------
+    data : Expr
+        The input tensor.
+
+    Returns
+    -------
+    ret: Expr
+        The created relax call.
+    """
+    return _ffi_api.relu(data)
+
+
+def gelu(data: Expr) -> Expr:
+    """Gaussian error linear unit in its tanh approximation,
+    ``0.5 * data * (1 + tanh(sqrt(2 / pi) * (data + 0.044715 * data^3)))``.
+
+    Parameters
+    ----------
+    data : Expr
+        The input tensor.
+
+    Returns
+    -------
+    ret: Expr
+        The created relax call.
+    """
+    return _ffi_api.gelu(data)
+
+
+def attention(
+    query: Expr, key: Expr, value: Expr, scale: Optional[float] = None, causal: bool = False
+) -> Expr:
+    """Scaled dot-product attention, ``softmax(query * key^T * scale) * value`` per batch and
+    head. It is lowered to a fused kernel with an online softmax, that never holds the scores of
+    more than a tile of keys, see :py:func:`tvm.topi.nn.flash_attention`.
+
+    Parameters
+    ----------
+    query : Expr
+        The query of shape ``[batch, seq_len, num_heads, head_dim]``.
+
+    key : Expr
+        The key of shape ``[batch, kv_seq_len, num_heads, head_dim]``.
+
+    value : Expr
+        The value of shape ``[batch, kv_seq_len, num_heads, head_dim_v]``.
+
+    scale : Optional[float]
+        The scale of the scores, ``1 / sqrt(head_dim)`` if None.
+
+    causal : bool
+        Whether the query at position ``i`` only attends to the keys up to the position
+        ``i + kv_seq_len - seq_len``.
+
+    Returns
+    -------
+    ret: Expr
+        The created relax call, of shape ``[batch, seq_len, num_heads, head_dim_v]``.
+    """
+    return _ffi_api.attention(query, key, value, scale or 0.0, causal)
+
+
+def softmax(data: Expr, axis: int = -1) -> Expr:
+    """Softmax over an axis.
+
+    Parameters
+    ----------
+    data : Expr
+        The input tensor.
+
+    axis : int
+        The axis of the softmax.
+
+    Returns
+    -------
+    ret: Expr
+        The created relax call.
+    """
+    return _ffi_api.softmax(data, axis)
+
+
+def layer_norm(
+    data: Expr,
+    gamma: Expr,
+    beta: Expr,
+    axis: int = -1,
+    epsilon: float = 1e-5,
+    center: bool = True,
+    scale: bool = True,
+) -> Expr:
+    """Layer normalization over an axis, as :py:func:`tvm.relay.nn.layer_norm`.
+
+    Parameters
+    ----------
+    data : Expr
+        The input tensor.
+
+    gamma : Expr
+        The 1-D scale, of the size of the axis.
+
+    beta : Expr
+        The 1-D shift, of the size of the axis.
+
+    axis : int
+        The axis normalized.
+
+    epsilon : float
+        Small float added to the variance to avoid dividing by zero.
+
+    center : bool
+        Whether beta is added.
+
+    scale : bool
+        Whether the output is multiplied by gamma.
+
+    Returns
+    -------
+    ret: Expr
+        The created relax call.
+    """
+    return _ffi_api.layer_norm(data, gamma, beta, axis, epsilon, center, scale)
+
+
+def rms_norm(data: Expr, weight: Expr, axis: int = -1, epsilon: float = 1e-5) -> Expr:
+    """Root mean square normalization over an axis,
+    ``data / sqrt(mean(data * data, axis) + epsilon) * weight``.
+
+    Parameters
+    ----------
+    data : Expr
+        The input tensor.
+
+    weight : Expr
+        The 1-D scale, of the size of the axis.
+
+    axis : int
+        The axis normalized.
+
+    epsilon : float
+        Small float added to the mean square to avoid dividing by zero.
+
+    Returns
+    -------
+    ret: Expr
+        The created relax call.
+    """
+    return _ffi_api.rms_norm(data, weight, axis, epsilon)
+
+
+@tvm.register_func("relax.run.gelu")
+def numpy_gelu(a: tvm.nd.array) -> tvm.nd.array:
+    """Compute gelu with numpy."""
+    x = a.numpy()
+    y = 0.5 * x * (1 + np.tanh(np.sqrt(2 / np.pi) * (x + 0.044715 * np.power(x, 3))))
+    return tvm.nd.array(y.astype(x.dtype), a.device)
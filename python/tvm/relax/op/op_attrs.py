@@ -44,11 +44,31 @@ class VMAllocTensorAttrs(Attrs):
     """Attributes used in VM alloc_tensor operators"""
 
 
+@tvm._ffi.register_object("relax.attrs.ComputeShapeAttrs")
+class ComputeShapeAttrs(Attrs):
+    """Attributes used in VM compute_shape operators"""
+
+
 @tvm._ffi.register_object("relax.attrs.UniqueAttrs")
 class UniqueAttrs(Attrs):
     """Attributes used for the unique operator"""
 
 
+@tvm._ffi.register_object("relax.attrs.QuantizeAttrs")
+class QuantizeAttrs(Attrs):
+    """Attributes used for the quantize and dequantize operators"""
+
+
+@tvm._ffi.register_object("relax.attrs.AttentionAttrs")
+class AttentionAttrs(Attrs):
+    """Attributes used for the attention operator"""
+
+
+@tvm._ffi.register_object("relax.attrs.RMSNormAttrs")
+class RMSNormAttrs(Attrs):
+    """Attributes used for the rms_norm operator"""
+
+
 @tvm._ffi.register_object("relax.attrs.PrintAttrs")
 class PrintAttrs(Attrs):
     """Attributes used for the print operator"""
@@ -57,3 +77,18 @@ class PrintAttrs(Attrs):
 @tvm._ffi.register_object("relax.attrs.AssertOpAttrs")
 class AssertOpAttrs(Attrs):
     """Attributes used for the assert operator"""
+
+
+@tvm._ffi.register_object("relax.attrs.ParamLoadAttrs")
+class ParamLoadAttrs(Attrs):
+    """Attributes used for the param_load operator"""
+
+
+@tvm._ffi.register_object("relax.attrs.CCLAttrs")
+class CCLAttrs(Attrs):
+    """Attributes used for the collective communication operators"""
+
+
+@tvm._ffi.register_object("relax.attrs.PrefetchAttrs")
+class PrefetchAttrs(Attrs):
+    """Attributes used for the prefetch operator"""
@@ -15,6 +15,8 @@
 # specific language governing permissions and limitations
 # pylint: disable=redefined-builtin
 """Basic tensor operations."""
+from typing import List, Optional, Union
+
 import numpy as np
 import tvm
 
@@ -30,6 +32,38 @@ def multiply(lhs: Expr, rhs: Expr) -> Expr:
     return _ffi_api.multiply(lhs, rhs)
 
 
+def sum(
+    data: Expr,
+    axis: Optional[Union[int, List[int]]] = None,
+    keepdims: bool = False,
+    exclude: bool = False,
+) -> Expr:
+    """Sum of the elements over the given axes, as :py:func:`tvm.relay.sum`.
+
+    Parameters
+    ----------
+    data : Expr
+        The input tensor.
+
+    axis : Optional[Union[int, List[int]]]
+        The axes summed over, all of them if None.
+
+    keepdims : bool
+        Whether the reduced axes are kept in the result with size one.
+
+    exclude : bool
+        Whether the sum is over the axes not in axis instead.
+
+    Returns
+    -------
+    ret: Expr
+        The created relax call.
+    """
+    if isinstance(axis, int):
+        axis = [axis]
+    return _ffi_api.sum(data, axis, keepdims, exclude)
+
+
 def unique(
     data: Expr,
     sorted: bool = True,
@@ -91,3 +125,81 @@ def numpy_unique(
         return tvm.nd.array(output_sorted_numpy)
     output_numpy = [a_numpy.flatten()[index] for index in sorted(indices, reverse=True)]
     return tvm.nd.array(output_numpy)
+
+
+def quantize(data: Expr, scale: float = 0.0, zero_point: int = 0, out_dtype: str = "int8") -> Expr:
+    """Quantize a floating point tensor as ``clip(round(data / scale) + zero_point)`` in the
+    range of ``out_dtype``.
+
+    Parameters
+    ----------
+    data : Expr
+        The input tensor.
+
+    scale : float
+        The scale of the quantized values. A non-positive scale marks a quantization whose
+        parameters are to be filled in by :py:func:`tvm.relax.transform.Calibrate`.
+
+    zero_point : int
+        The quantized value the real value zero is mapped to.
+
+    out_dtype : str
+        The integer data type of the output.
+
+    Returns
+    -------
+    ret: Expr
+        The created relax call.
+    """
+    return _ffi_api.quantize(data, scale, zero_point, out_dtype)
+
+
+def dequantize(
+    data: Expr, scale: float = 0.0, zero_point: int = 0, out_dtype: str = "float32"
+) -> Expr:
+    """Dequantize an integer tensor as ``(data - zero_point) * scale``.
+
+    Parameters
+    ----------
+    data : Expr
+        The input tensor.
+
+    scale : float
+        The scale of the quantized values. A non-positive scale takes the parameters of the
+        quantize op producing ``data`` once the module is calibrated.
+
+    zero_point : int
+        The quantized value the real value zero is mapped to.
+
+    out_dtype : str
+        The floating point data type of the output.
+
+    Returns
+    -------
+    ret: Expr
+        The created relax call.
+    """
+    return _ffi_api.dequantize(data, scale, zero_point, out_dtype)
+
+
+@tvm.register_func("relax.run.quantize")
+def numpy_quantize(
+    a: tvm.nd.array, scale: float, zero_point: int, out_dtype: str
+) -> tvm.nd.array:
+    """Quantize the input tensor with numpy."""
+    if scale <= 0:
+        raise ValueError("quantize is run before its scale was calibrated")
+    info = np.iinfo(out_dtype)
+    quantized = np.round(a.numpy() / scale) + zero_point
+    return tvm.nd.array(np.clip(quantized, info.min, info.max).astype(out_dtype))
+
+
+@tvm.register_func("relax.run.dequantize")
+def numpy_dequantize(
+    a: tvm.nd.array, scale: float, zero_point: int, out_dtype: str
+) -> tvm.nd.array:
+    """Dequantize the input tensor with numpy."""
+    if scale <= 0:
+        raise ValueError("dequantize is run before its scale was calibrated")
+    real = (a.numpy().astype("int32") - zero_point) * scale
+    return tvm.nd.array(real.astype(out_dtype))
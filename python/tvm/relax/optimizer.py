@@ -0,0 +1,245 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""The optimizers updating the params of a Relax function from their gradients.
+
+An optimizer adds an update function to the module, taking the params, their gradients, e.g.
+computed by the adjoint of :py:class:`tvm.relax.transform.Gradient`, and the states of the
+optimizer, and returning the updated params and states. The update of each param and of its
+states is one kernel, reading the param, its gradient and its states once.
+"""
+from typing import List
+
+import numpy as np
+
+from tvm import te, tir
+from tvm.ir.module import IRModule
+
+from .block_builder import BlockBuilder
+from .expr import Tuple, TupleGetItem, Var
+from .ty import DynTensorType
+
+
+class Optimizer:
+    """The base class of the optimizers, whose states are per param."""
+
+    # the names of the states of each param, of its shape and dtype
+    param_states: List[str] = []
+
+    def init_states(self, params: List[np.ndarray]) -> List[np.ndarray]:
+        """The initial states of the optimizer, in the order of the update function."""
+        return [np.zeros_like(p) for p in params for _ in self.param_states]
+
+    def update_param(self, w: te.Tensor, g: te.Tensor, states: List[te.Tensor], extra):
+        """The updated param and states of a param, as te tensors."""
+        raise NotImplementedError
+
+    def extra_state_vars(self) -> List[Var]:
+        """The states shared by the params, following the states of the params."""
+        return []
+
+    def emit_extra(self, builder: BlockBuilder, extra_states: List[Var]):
+        """Emit the updates of the shared states, returning the updated states and the extra
+        args of update_param."""
+        return [], []
+
+    def add_update_function(
+        self, mod: IRModule, params: List[Var], name: str = "update"
+    ) -> IRModule:
+        """Add the update function of params to a module.
+
+        The function takes the params, their gradients, and the states of the optimizer in the
+        order of :py:meth:`init_states`, and returns the tuple of the updated params and of the
+        updated states.
+
+        Parameters
+        ----------
+        mod : IRModule
+            The module.
+
+        params : List[Var]
+            The params, for their names, shapes and dtypes.
+
+        name : str
+            The name of the function.
+
+        Returns
+        -------
+        mod : IRModule
+            The module with the update function.
+        """
+
+        def like(param, suffix):
+            return Var(param.name_hint + suffix, param.shape, param.checked_type)
+
+        ws = [like(p, "") for p in params]
+        gs = [like(p, "_grad") for p in params]
+        states = [like(p, "_" + s) for p in params for s in self.param_states]
+        extra = self.extra_state_vars()
+        builder = BlockBuilder(mod)
+        with builder.function(name, ws + gs + states + extra):
+            with builder.dataflow():
+                new_extra, extra_args = self.emit_extra(builder, extra)
+                new_ws, new_states = [], []
+                per_param = len(self.param_states)
+                for i, (w, g) in enumerate(zip(ws, gs)):
+                    param_states = states[i * per_param : (i + 1) * per_param]
+                    out = builder.emit_te(
+                        self.update_param,
+                        w,
+                        g,
+                        param_states,
+                        extra_args,
+                        primfunc_name_hint=type(self).__name__.lower() + "_update",
+                    )
+                    if per_param:
+                        new_ws.append(builder.emit(TupleGetItem(out, 0)))
+                        new_states += [
+                            builder.emit(TupleGetItem(out, j + 1)) for j in range(per_param)
+                        ]
+                    else:
+                        new_ws.append(out)
+                gv = builder.emit_output(Tuple([Tuple(new_ws), Tuple(new_states + new_extra)]))
+            builder.emit_func_output(gv)
+        return builder.get()
+
+
+class SGD(Optimizer):
+    """Stochastic gradient descent, with momentum and weight decay.
+
+    Parameters
+    ----------
+    lr : float
+        The learning rate.
+
+    momentum : float
+        The momentum, none if 0, in which case the optimizer has no states.
+
+    weight_decay : float
+        The L2 penalty added to the gradients.
+    """
+
+    def __init__(self, lr: float, momentum: float = 0.0, weight_decay: float = 0.0):
+        self.lr = lr
+        self.momentum = momentum
+        self.weight_decay = weight_decay
+        self.param_states = ["velocity"] if momentum else []
+
+    def update_param(self, w, g, states, extra):
+        def const(value):
+            return tir.const(value, w.dtype)
+
+        def grad(*i):
+            return g(*i) + const(self.weight_decay) * w(*i) if self.weight_decay else g(*i)
+
+        if not self.momentum:
+            return te.compute(w.shape, lambda *i: w(*i) - const(self.lr) * grad(*i), name="T_w")
+        (v,) = states
+
+        def velocity(*i):
+            return const(self.momentum) * v(*i) + grad(*i)
+
+        # both outputs are computed from the inputs, without materializing one for the other
+        new_w = te.compute(w.shape, lambda *i: w(*i) - const(self.lr) * velocity(*i), name="T_w")
+        new_v = te.compute(w.shape, velocity, name="T_velocity")
+        return [new_w, new_v]
+
+
+class Adam(Optimizer):
+    """Adam, with the weight decay decoupled from the gradients as in AdamW.
+
+    The step count of the bias corrections is a float32 scalar state, following the states of
+    the params.
+
+    Parameters
+    ----------
+    lr : float
+        The learning rate.
+
+    beta1 : float
+        The decay of the mean of the gradients.
+
+    beta2 : float
+        The decay of the mean of the squares of the gradients.
+
+    eps : float
+        The term added to the denominator.
+
+    weight_decay : float
+        The decoupled weight decay.
+    """
+
+    param_states = ["mean", "sqmean"]
+
+    def __init__(
+        self,
+        lr: float = 1e-3,
+        beta1: float = 0.9,
+        beta2: float = 0.999,
+        eps: float = 1e-8,
+        weight_decay: float = 0.0,
+    ):
+        self.lr = lr
+        self.beta1 = beta1
+        self.beta2 = beta2
+        self.eps = eps
+        self.weight_decay = weight_decay
+
+    def init_states(self, params: List[np.ndarray]) -> List[np.ndarray]:
+        return super().init_states(params) + [np.zeros((), "float32")]
+
+    def extra_state_vars(self) -> List[Var]:
+        return [Var("step", [], DynTensorType(0, "float32"))]
+
+    def emit_extra(self, builder: BlockBuilder, extra_states: List[Var]):
+        (step,) = extra_states
+        new_step = builder.emit_te(
+            lambda t: te.compute((), lambda: t() + tir.const(1, "float32"), name="T_step"),
+            step,
+            primfunc_name_hint="adam_step",
+        )
+        return [new_step], [new_step]
+
+    def update_param(self, w, g, states, extra):
+        m, v = states
+        (t,) = extra
+        dtype = w.dtype
+
+        def const(value):
+            return tir.const(value, dtype)
+
+        def mean(*i):
+            return const(self.beta1) * m(*i) + const(1 - self.beta1) * g(*i)
+
+        def sqmean(*i):
+            return const(self.beta2) * v(*i) + const(1 - self.beta2) * g(*i) * g(*i)
+
+        def new_w(*i):
+            step = t()
+            corr1 = tir.const(1, "float32") - tir.power(tir.const(self.beta1, "float32"), step)
+            corr2 = tir.const(1, "float32") - tir.power(tir.const(self.beta2, "float32"), step)
+            m_hat = mean(*i) / corr1.astype(dtype)
+            v_hat = sqmean(*i) / corr2.astype(dtype)
+            update = m_hat / (tir.sqrt(v_hat) + const(self.eps))
+            if self.weight_decay:
+                update = update + const(self.weight_decay) * w(*i)
+            return w(*i) - const(self.lr) * update
+
+        return [
+            te.compute(w.shape, new_w, name="T_w"),
+            te.compute(w.shape, mean, name="T_mean"),
+            te.compute(w.shape, sqmean, name="T_sqmean"),
+        ]
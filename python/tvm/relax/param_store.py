@@ -0,0 +1,173 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Params kept out of the executable, in a sharded directory loaded lazily by the VM.
+
+A store is a directory holding a manifest, ``params.json``, and shard files concatenating the
+raw bytes of the params at aligned offsets. The functions compiled after
+:py:func:`tvm.relax.transform.ExternalizeParams` load their params from the store of the VM by
+name, mapping a shard only while its params are copied to the device.
+"""
+import json
+import os
+from typing import Dict, List, Optional, Union
+
+import numpy as np
+
+import tvm
+from tvm.runtime import Device, NDArray
+from tvm.runtime.object import Object
+
+MANIFEST = "params.json"
+
+
+def save_params(
+    params: Dict[str, Union[NDArray, np.ndarray]],
+    path: str,
+    shard_bytes: int = 1 << 30,
+    alignment: int = 64,
+) -> List[str]:
+    """Save params as a store.
+
+    The params are written in the order of the dict, so the params used together should be
+    adjacent. A shard holds at least one param, and the params are added to it until it reaches
+    shard_bytes.
+
+    Parameters
+    ----------
+    params : Dict[str, Union[NDArray, np.ndarray]]
+        The params by name.
+
+    path : str
+        The directory of the store, created if needed.
+
+    shard_bytes : int
+        The target size of a shard.
+
+    alignment : int
+        The alignment of the offsets of the params in a shard.
+
+    Returns
+    -------
+    shards : List[str]
+        The file names of the shards.
+    """
+    os.makedirs(path, exist_ok=True)
+    shards = []
+    records = []
+    out = None
+    offset = 0
+    for name, value in params.items():
+        data = value.numpy() if isinstance(value, NDArray) else np.ascontiguousarray(value)
+        nbytes = data.nbytes
+        if out is None or (offset > 0 and offset + nbytes > shard_bytes):
+            if out is not None:
+                out.close()
+            shards.append("params_shard_{}.bin".format(len(shards)))
+            out = open(os.path.join(path, shards[-1]), "wb")
+            offset = 0
+        padding = -offset % alignment
+        out.write(b"\0" * padding)
+        offset += padding
+        out.write(data.tobytes())
+        records.append(
+            {
+                "name": name,
+                "shard": len(shards) - 1,
+                "offset": offset,
+                "nbytes": nbytes,
+                "shape": list(data.shape),
+                "dtype": str(data.dtype),
+            }
+        )
+        offset += nbytes
+    if out is not None:
+        out.close()
+    with open(os.path.join(path, MANIFEST), "w") as manifest:
+        json.dump({"shards": shards, "params": records}, manifest, indent=2)
+    return shards
+
+
+def load_manifest(path: str) -> Dict[str, Dict]:
+    """Read the records of the params of a store, by name.
+
+    Parameters
+    ----------
+    path : str
+        The directory of the store.
+
+    Returns
+    -------
+    records : Dict[str, Dict]
+        The shard, offset, nbytes, shape and dtype of each param.
+    """
+    with open(os.path.join(path, MANIFEST)) as manifest:
+        return {record["name"]: record for record in json.load(manifest)["params"]}
+
+
+@tvm._ffi.register_object("relax.vm.ParamStore")
+class ParamStore(Object):
+    """A store opened on a device, see :py:meth:`tvm.relax.VirtualMachine.set_param_store`.
+
+    No param is loaded when the store is opened. A param is copied to the device the first time
+    a function loads it, and kept there until released.
+    """
+
+    def __init__(self, path: str, device: Device):
+        # pylint: disable=super-init-not-called
+        self.__init_handle_by_constructor__(
+            tvm.get_global_func("vm.builtin.param_store_create"),
+            path,
+            device.device_type,
+            device.device_id,
+        )
+
+    def load_shard(self, shard: int) -> None:
+        """Load all the params of a shard to the device, e.g. ahead of their first use."""
+        tvm.get_global_func("vm.builtin.param_store_load_shard")(self, shard)
+
+    def release(self, name: str) -> None:
+        """Drop the device copy held by the store of a param, loaded again on its next use."""
+        tvm.get_global_func("vm.builtin.param_store_release")(self, name)
+
+    @property
+    def num_resident(self) -> int:
+        """The number of params held on the device."""
+        return tvm.get_global_func("vm.builtin.param_store_num_resident")(self)
+
+    @property
+    def num_mapped_shards(self) -> int:
+        """The number of shards currently mapped."""
+        return tvm.get_global_func("vm.builtin.param_store_num_mapped_shards")(self)
+
+
+def open_params(path: str, device: Optional[Device] = None) -> ParamStore:
+    """Open a store on a device.
+
+    Parameters
+    ----------
+    path : str
+        The directory of the store.
+
+    device : Optional[Device]
+        The device to load the params to, the CPU by default.
+
+    Returns
+    -------
+    store : ParamStore
+        The store.
+    """
+    return ParamStore(path, device if device is not None else tvm.cpu())
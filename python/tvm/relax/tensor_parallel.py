@@ -0,0 +1,130 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""The tensor parallel execution of a Relax function over a group of devices.
+
+The function is sharded with :py:class:`tvm.relax.transform.ShardTensorParallel`, and each device
+runs it in a VM of its own, on its thread, with the communicator of its rank.
+"""
+from concurrent.futures import ThreadPoolExecutor
+from typing import Any, Dict, List, Optional, Union
+
+import numpy as np
+
+import tvm
+from tvm.runtime import Device, NDArray, ShapeTuple
+from tvm.runtime.object import Object
+
+from .vm import Executable, VirtualMachine
+
+
+def create_group(devices: List[Device]) -> List[Object]:
+    """Create the communicators of a group of devices of the process.
+
+    The CPU devices communicate through shared memory, the CUDA devices through NCCL, which needs
+    TVM to be built with USE_NCCL.
+
+    Parameters
+    ----------
+    devices : List[Device]
+        The device of each rank.
+
+    Returns
+    -------
+    communicators : List[Object]
+        The communicator of each rank.
+    """
+    device_types = {dev.device_type for dev in devices}
+    if device_types == {tvm.cpu().device_type}:
+        return list(tvm.get_global_func("vm.builtin.ccl.cpu_group")(len(devices)))
+    if device_types == {tvm.cuda().device_type}:
+        nccl_group = tvm.get_global_func("vm.builtin.ccl.nccl_group", allow_missing=True)
+        if nccl_group is None:
+            raise RuntimeError("The CUDA collectives need TVM to be built with USE_NCCL")
+        return list(nccl_group(ShapeTuple([dev.device_id for dev in devices])))
+    raise ValueError("A group must be either of CPU or of CUDA devices, got {}".format(devices))
+
+
+class TensorParallelVM:
+    """The VMs of a group of devices running the same sharded functions.
+
+    Parameters
+    ----------
+    exec : Executable
+        The executable of the sharded functions.
+
+    devices : List[Device]
+        The device of each rank.
+
+    memory_cfg : Optional[str]
+        The memory allocation strategy of the VMs, see :py:class:`VirtualMachine`.
+    """
+
+    def __init__(
+        self, exec: Executable, devices: List[Device], memory_cfg: Optional[str] = None
+    ):  # pylint: disable=redefined-builtin
+        self.devices = list(devices)
+        self.communicators = create_group(self.devices)
+        self.vms = [VirtualMachine(exec, dev, memory_cfg=memory_cfg) for dev in self.devices]
+        for vm, comm in zip(self.vms, self.communicators):
+            vm.set_communicator(comm)
+        self._pool = ThreadPoolExecutor(max_workers=len(self.devices))
+
+    def run(
+        self,
+        func_name: str,
+        args: List[Union[np.ndarray, NDArray]],
+        rank_args: Optional[List[List[Union[np.ndarray, NDArray]]]] = None,
+    ) -> List[Any]:
+        """Run a function on all the ranks.
+
+        Parameters
+        ----------
+        func_name : str
+            The name of the function.
+
+        args : List[Union[np.ndarray, NDArray]]
+            The replicated arguments, copied to each device.
+
+        rank_args : Optional[List[List[Union[np.ndarray, NDArray]]]]
+            The arguments of each rank following the replicated ones, e.g. its shards of the
+            weights.
+
+        Returns
+        -------
+        outputs : List[Any]
+            The outputs of each rank, the same for all the ranks.
+        """
+        if rank_args is not None and len(rank_args) != len(self.vms):
+            raise ValueError("rank_args must hold the arguments of each of the ranks")
+
+        def run_rank(rank):
+            dev = self.devices[rank]
+            inputs = list(args) + (list(rank_args[rank]) if rank_args is not None else [])
+            inputs = [
+                x.copyto(dev) if isinstance(x, NDArray) else tvm.nd.array(x, dev) for x in inputs
+            ]
+            return self.vms[rank][func_name](*inputs)
+
+        futures = [self._pool.submit(run_rank, rank) for rank in range(len(self.vms))]
+        return [future.result() for future in futures]
+
+    def shard_args(
+        self, params: Dict[str, np.ndarray], names: List[str], sharding: Dict[str, int]
+    ) -> List[List[np.ndarray]]:
+        """The rank_args of :py:meth:`run` holding the shards of params in the order of names."""
+        shards = tvm.relax.transform.shard_params(params, len(self.vms), sharding)
+        return [[shard[name] for name in names] for shard in shards]
@@ -20,12 +20,14 @@
 from __future__ import annotations
 from tvm import ir
 from tvm import relax
+from tvm import topi
 from tvm.ir.module import IRModule
 from tvm.ir.transform import PassContext
 from tvm.target import Target
 from tvm.ir import transform
 from tvm.relax import PyExprMutator
 from tvm.relax.expr import Call
+from tvm.relax.transform.legalize_reductions import LEGALIZATIONS, legalize_reduction
 from tvm.relay.backend.te_compiler import select_implementation
 
 
@@ -79,6 +81,22 @@ class LowerWithRelayOpStrategyPass(transform.Pass):
                 if isinstance(call_node.op, (relax.GlobalVar, relax.expr.ExternFunc)):
                     return call_node
 
+                # The reductions and normalizations get the row-wise kernels of the target.
+                if call_node.op.name in LEGALIZATIONS:
+                    return legalize_reduction(self.builder_, call_node, target)
+
+                # Attention has no relay op, it is lowered to the fused kernel of the target.
+                if call_node.op.name == "relax.nn.attention":
+                    is_gpu = "gpu" in target.keys
+                    impl = topi.cuda.flash_attention if is_gpu else topi.nn.flash_attention
+                    return self.builder_.call_te(
+                        impl,
+                        *call_node.args,
+                        scale=call_node.attrs.scale or None,
+                        causal=bool(call_node.attrs.causal),
+                        primfunc_name_hint="flash_attention",
+                    )
+
                 # Current relax op name simply adds "relax." prefix to relay op name.
                 # Thus, remove "relax." prefix to deduce relay op name.
                 relay_op_name = call_node.op.name[6:]
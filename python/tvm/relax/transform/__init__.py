@@ -19,3 +19,7 @@
 
 from .transform import *
 from .fma_rewrite import *
+from .cost_partition import *
+from .legalize_reductions import *
+from .gradient import *
+from .shard_tensor_parallel import ShardTensorParallel, shard_params
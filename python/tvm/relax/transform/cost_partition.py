@@ -0,0 +1,251 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name, unused-argument, arguments-differ
+"""Partition a module for external codegens by the measured latency of the matches of their
+patterns, rather than offloading every match.
+
+A small subgraph can run slower on an external library than the native kernels of TVM, once its
+call overhead is counted. As in the collage partitioner of Relay, each candidate is measured on
+its own: the match wrapped into a module offloading it to its codegen, and the same ops lowered
+to the native kernels. The candidates are the matches of the patterns of every backend, and the
+ones of the same ops, types and shapes share their measurements. A match is then offloaded when
+its backend is the fastest on its ops, and faster than the native kernels.
+
+The decision is taken by match, in the priority order of FuseOpsByPattern: the search does not
+combine the candidates into a global partition as collage does, so the gains of merging the
+consecutive offloaded matches by MergeCompositeFunctions are not accounted for.
+"""
+import logging
+import math
+from typing import Callable, Dict, List, Optional, Tuple
+
+import numpy as np
+
+import tvm
+from tvm import ir, relax
+from tvm.ir import transform
+from tvm.ir.module import IRModule
+from tvm.ir.transform import PassContext
+from tvm.target import Target
+
+from .transform import FuseOpsByPattern, MergeCompositeFunctions, RunCodegen
+
+__all__ = ["OffloadBackend", "MeasuringEstimator", "CostAwarePartition"]
+
+
+class OffloadBackend:
+    """An external codegen candidate to the offload of the matches of its patterns.
+
+    Parameters
+    ----------
+    patterns : List[Tuple[str, DFPattern]]
+        The patterns of the codegen, as passed to FuseOpsByPattern.
+
+    check : Optional[Callable[[relax.Function, IRModule], bool]]
+        The check of the matches supported by the codegen, as passed to FuseOpsByPattern.
+
+    target : Union[str, Target]
+        The target of the host code calling the offloaded functions, e.g. "cuda" for TensorRT.
+    """
+
+    def __init__(
+        self,
+        patterns: List[Tuple[str, "tvm.relax.dpl.DFPattern"]],
+        check: Optional[Callable] = None,
+        target="llvm",
+    ):
+        self.patterns = patterns
+        self.check = check
+        self.target = Target(target) if isinstance(target, str) else target
+        self.codegen = patterns[0][0].split(".")[0] if patterns else ""
+
+
+def _random_args(func: relax.Function, dev: tvm.runtime.Device) -> Optional[List]:
+    """Random arguments of a function of static tensor parameters, None otherwise."""
+    args = []
+    for param in func.params:
+        shape = param.shape_
+        if not isinstance(shape, relax.ShapeExpr) or not all(
+            isinstance(dim, tvm.tir.IntImm) for dim in shape.values
+        ):
+            return None
+        shape = [int(dim) for dim in shape.values]
+        dtype = param.checked_type.dtype
+        args.append(tvm.nd.array(np.random.uniform(-1, 1, shape).astype(dtype), dev))
+    return args
+
+
+class MeasuringEstimator:
+    """Estimate the latency of a candidate module by building and running its "main" function.
+
+    Parameters
+    ----------
+    native_lower : Optional[Callable[[IRModule, Target], IRModule]]
+        The lowering of the high-level ops to native kernels. The default, the lowering by
+        the op strategies of Relay, only has default schedules on the CPU targets.
+
+    number : int
+        The runs of each measurement.
+
+    repeat : int
+        The measurements, of which the mean is taken.
+    """
+
+    def __init__(self, native_lower: Optional[Callable] = None, number: int = 10, repeat: int = 3):
+        if native_lower is None:
+            from tvm.relax.testing.transform import (  # pylint: disable=import-outside-toplevel
+                LowerWithRelayOpStrategyPass,
+            )
+
+            native_lower = lambda mod, target: LowerWithRelayOpStrategyPass(target)(mod)
+        self.native_lower = native_lower
+        self.number = number
+        self.repeat = repeat
+
+    def __call__(self, mod: IRModule, target: Target) -> float:
+        """The mean latency of "main" in seconds, infinite when it cannot be built or run."""
+        offloaded = any(
+            isinstance(func, relax.Function) and func.attrs is not None and "Codegen" in func.attrs
+            for func in mod.functions.values()
+        )
+        dev = tvm.device(target.kind.name, 0)
+        args = _random_args(mod["main"], dev)
+        if args is None:
+            return math.inf
+        try:
+            mod = RunCodegen()(mod) if offloaded else self.native_lower(mod, target)
+            vm = relax.VirtualMachine(relax.vm.build(mod, target), dev)
+            vm["main"](*args)  # warm up
+            timer = vm.time_evaluator("main", dev, number=self.number, repeat=self.repeat)
+            return timer(*args).mean
+        except tvm.TVMError as err:
+            logging.info("Assigning an infinite cost to a candidate failing to run: %s", err)
+            return math.inf
+
+
+def _offloaded_module(func: relax.Function) -> IRModule:
+    """A module whose "main" calls a function offloading a match."""
+    bb = relax.BlockBuilder()
+    gv = bb.add_func(func.with_attr("global_symbol", "fused"), "fused")
+    params = [relax.Var(p.name_hint, p.shape_, p.checked_type) for p in func.params]
+    with bb.function("main", params):
+        with bb.dataflow():
+            out = bb.emit_output(relax.Call(gv, params))
+        bb.emit_func_output(out)
+    return bb.get()
+
+
+def _native_module(composite: relax.Function) -> IRModule:
+    """A module whose "main" runs the ops of a composite function."""
+    main = relax.Function(composite.params, composite.body, composite.ret_type, composite.ret_shape)
+    return IRModule({"main": main.with_attr("global_symbol", "main")})
+
+
+@ir.transform.module_pass(opt_level=0)
+class CostAwarePartition(transform.Pass):
+    """Group the matches of the patterns of external codegens into functions offloaded by
+    RunCodegen, as FuseOpsByPattern, but only the matches measured faster on their codegen than
+    on the other codegens and on the native kernels.
+
+    Parameters
+    ----------
+    backends : List[OffloadBackend]
+        The codegen candidates, in the order of priority.
+
+    native_target : Union[str, Target]
+        The target of the native kernels.
+
+    estimator : Optional[Callable[[IRModule, Target], float]]
+        The latency of the "main" function of a module, either calling a function offloaded to a
+        codegen, or of high-level ops to lower to native kernels. Defaults to MeasuringEstimator.
+
+    merge : bool
+        Whether to merge the chains of offloaded functions by MergeCompositeFunctions.
+    """
+
+    def __init__(
+        self,
+        backends: List[OffloadBackend],
+        native_target="llvm",
+        estimator: Optional[Callable] = None,
+        merge: bool = True,
+    ):
+        self.backends = backends
+        if isinstance(native_target, str):
+            native_target = Target(native_target)
+        self.native_target = native_target
+        self.estimator = estimator or MeasuringEstimator()
+        self.merge = merge
+
+    def transform_module(self, mod: IRModule, ctx: PassContext) -> IRModule:
+        """Measure the candidates of each backend, then offload the selected ones."""
+        # The costs of the ops of each candidate, by the structural hash of its composite function
+        # without attributes: the native cost, and the cost of each backend supporting them.
+        native_costs: Dict[int, float] = {}
+        backend_costs: Dict[int, Dict[str, float]] = {}
+
+        def region_of(func: relax.Function) -> Tuple[int, relax.Function]:
+            composite = func.body.blocks[0].bindings[0].value.op
+            ops = relax.Function(
+                composite.params, composite.body, composite.ret_type, composite.ret_shape
+            )
+            return ir.structural_hash(ops, map_free_vars=True), composite
+
+        def make_recorder(backend: OffloadBackend) -> Callable:
+            def record(func: relax.Function, mod: IRModule) -> bool:
+                if backend.check is not None and not backend.check(func, mod):
+                    return False
+                key, composite = region_of(func)
+                costs = backend_costs.setdefault(key, {})
+                if backend.codegen not in costs:
+                    costs[backend.codegen] = self.estimator(_offloaded_module(func), backend.target)
+                if key not in native_costs:
+                    native_costs[key] = self.estimator(
+                        _native_module(composite), self.native_target
+                    )
+                # Every match is rejected, so that all the patterns are tried on all bindings.
+                return False
+
+            return record
+
+        for backend in self.backends:
+            FuseOpsByPattern(backend.patterns, make_recorder(backend))(mod)
+
+        backends = {backend.codegen: backend for backend in self.backends}
+
+        def select(func: relax.Function, mod: IRModule) -> bool:
+            key, composite = region_of(func)
+            costs = backend_costs.get(key)
+            codegen = composite.attrs["Composite"].split(".")[0]
+            if not costs or codegen not in costs:
+                return False
+            check = backends[codegen].check
+            if check is not None and not check(func, mod):
+                return False
+            # The first backend by priority among the fastest, e.g. when none can be measured.
+            best = min(costs.values())
+            fastest = next(b.codegen for b in self.backends if costs.get(b.codegen) == best)
+            native = native_costs[key]
+            # An unmeasured match is offloaded only if the native kernels cannot run it either,
+            # which is the decision of the greedy partitioning.
+            return codegen == fastest and (best < native or native == math.inf)
+
+        patterns = [pattern for backend in self.backends for pattern in backend.patterns]
+        mod = FuseOpsByPattern(patterns, select)(mod)
+        if self.merge:
+            mod = MergeCompositeFunctions()(mod)
+        return mod
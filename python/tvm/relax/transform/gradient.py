@@ -0,0 +1,508 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name, unused-argument, arguments-differ
+"""Reverse-mode automatic differentiation of Relax functions, with checkpointing.
+
+Gradient adds the adjoint of a function to the module. The adjoint computes the output of the
+function and the gradients of the sum of that output, usually a scalar loss, with respect to the
+given params. It runs the bindings of the function followed by their gradients in reverse order,
+in one dataflow block.
+
+The backward pass needs some values of the forward pass, the activations, e.g. the inputs of a
+matmul or the output of a relu. Under a memory budget the activations are kept alive until the
+backward pass only while their bytes fit in the budget. The others are recomputed from the kept
+ones when the backward pass needs them, so that their live ranges end in the forward pass. The
+activations dropped first are the cheapest to recompute per byte, see plan_checkpoints.
+
+The gradients are defined for relax.add, relax.multiply, relax.sum, relax.nn.matmul,
+relax.nn.relu, relax.nn.gelu and relax.nn.softmax, in GRADIENTS.
+"""
+import math
+from typing import Callable, Dict, List, Optional, Set, Tuple
+
+from tvm import ir, te, tir, topi
+from tvm.ir.module import IRModule
+from tvm.ir.transform import PassContext
+from tvm.runtime import DataType
+
+from ..block_builder import BlockBuilder
+from ..expr import (
+    Call,
+    DataflowBlock,
+    Expr,
+    Function,
+    ShapeExpr,
+    Tuple as RxTuple,
+    TupleGetItem,
+    Var,
+    VarBinding,
+)
+from ..op import add, multiply
+from ..op.nn import matmul
+
+__all__ = ["GRADIENTS", "plan_checkpoints", "Gradient"]
+
+# The gradient of each op: the forward values it reads, as the indices of the args of the call
+# or -1 for its output, and the function computing the gradients of the args of a call,
+#   fgrad(adjoint, call, out, grad, needs) -> List[Optional[Expr]]
+# where out is the variable bound to the call, grad the gradient of out and needs whether the
+# gradient of each arg is required. The forward values are read with adjoint.value.
+GRADIENTS: Dict[str, Tuple[Tuple[int, ...], Callable]] = {}
+
+
+def _register(op_name: str, uses: Tuple[int, ...] = ()):
+    def _do_register(fgrad):
+        GRADIENTS[op_name] = (uses, fgrad)
+        return fgrad
+
+    return _do_register
+
+
+def _shape_of(expr: Expr) -> List[tir.PrimExpr]:
+    if not isinstance(expr.shape, ShapeExpr):
+        raise ValueError("Gradient requires the tensors to have a known shape, got " + str(expr))
+    return list(expr.shape.values)
+
+
+def _is_one(dim: tir.PrimExpr) -> bool:
+    return isinstance(dim, tir.IntImm) and dim.value == 1
+
+
+def _numel(shape: List[tir.PrimExpr]) -> Optional[int]:
+    numel = 1
+    for dim in shape:
+        if not isinstance(dim, tir.IntImm):
+            return None
+        numel *= dim.value
+    return numel
+
+
+def _nbytes(expr: Expr) -> Optional[int]:
+    """The bytes of a tensor of static shape, None otherwise."""
+    if not isinstance(expr.shape, ShapeExpr):
+        return None
+    numel = _numel(expr.shape.values)
+    if numel is None:
+        return None
+    dtype = DataType(expr.checked_type.dtype)
+    return numel * ((dtype.bits * dtype.lanes + 7) // 8)
+
+
+def _recompute_cost(call: Call, out: Var) -> float:
+    """The estimated operations to recompute a binding, infinite when its shapes are unknown."""
+    numel = _numel(_shape_of(out)) if isinstance(out.shape, ShapeExpr) else None
+    if numel is None:
+        return math.inf
+    if call.op.name == "relax.nn.matmul":
+        k = _numel(_shape_of(call.args[0])[-1:])
+        return math.inf if k is None else 2.0 * numel * k
+    return float(numel)
+
+
+def _collapse_sum(builder: BlockBuilder, grad: Expr, shape: List[tir.PrimExpr]) -> Expr:
+    """Sum a gradient over the axes an operand of the shape was broadcast along."""
+    grad_shape = _shape_of(grad)
+    lead = len(grad_shape) - len(shape)
+    axes = list(range(lead)) + [
+        lead + i
+        for i, dim in enumerate(shape)
+        if _is_one(dim) and not _is_one(grad_shape[lead + i])
+    ]
+    if not axes:
+        return grad
+    return builder.emit_te(
+        lambda g: topi.reshape(topi.sum(g, axis=axes, keepdims=True), shape),
+        grad,
+        primfunc_name_hint="collapse_sum",
+    )
+
+
+@_register("relax.add")
+def _add_grad(adjoint, call, out, grad, needs):
+    return [
+        _collapse_sum(adjoint.builder, grad, _shape_of(arg)) if need else None
+        for arg, need in zip(call.args, needs)
+    ]
+
+
+@_register("relax.multiply", uses=(0, 1))
+def _multiply_grad(adjoint, call, out, grad, needs):
+    a, b = call.args
+    grads = [None, None]
+    if needs[0]:
+        grads[0] = adjoint.builder.emit(multiply(grad, adjoint.value(b)))
+        grads[0] = _collapse_sum(adjoint.builder, grads[0], _shape_of(a))
+    if needs[1]:
+        grads[1] = adjoint.builder.emit(multiply(adjoint.value(a), grad))
+        grads[1] = _collapse_sum(adjoint.builder, grads[1], _shape_of(b))
+    return grads
+
+
+@_register("relax.nn.matmul", uses=(0, 1))
+def _matmul_grad(adjoint, call, out, grad, needs):
+    a, w = call.args
+    transpose_b = bool(call.attrs.transpose_b)
+    grads = [None, None]
+    if needs[0]:
+        # the weight of [K, N] is the transposed weight of [N, K] of the gradient, and back
+        grads[0] = adjoint.builder.emit(
+            matmul(grad, adjoint.value(w), transpose_b=not transpose_b)
+        )
+    if needs[1]:
+        *batch, k = _shape_of(a)
+        n = _shape_of(out)[-1]
+        m = tir.IntImm("int64", 1)
+        for dim in batch:
+            m = m * dim
+
+        def fcompute(x, g):
+            x = topi.reshape(x, [m, k])
+            g = topi.reshape(g, [m, n])
+            # the rows of all the batch dimensions are summed over
+            return topi.matmul(g, x, transp_a=True) if transpose_b else topi.matmul(
+                x, g, transp_a=True
+            )
+
+        grads[1] = adjoint.builder.emit_te(
+            fcompute, adjoint.value(a), grad, primfunc_name_hint="matmul_weight_grad"
+        )
+    return grads
+
+
+@_register("relax.nn.relu", uses=(-1,))
+def _relu_grad(adjoint, call, out, grad, needs):
+    def fcompute(y, g):
+        zero = tir.const(0, g.dtype)
+        return te.compute(
+            g.shape, lambda *i: tir.Select(y(*i) > zero, g(*i), zero), name="T_relu_grad"
+        )
+
+    return [
+        adjoint.builder.emit_te(
+            fcompute, adjoint.value(out), grad, primfunc_name_hint="relu_grad"
+        )
+    ]
+
+
+@_register("relax.nn.gelu", uses=(0,))
+def _gelu_grad(adjoint, call, out, grad, needs):
+    # d/dx 0.5 x (1 + tanh(u)), u = c (x + 0.044715 x^3)
+    def fcompute(x, g):
+        def f(*i):
+            v = x(*i)
+            c = tir.const(math.sqrt(2 / math.pi), v.dtype)
+            a = tir.const(0.044715, v.dtype)
+            half = tir.const(0.5, v.dtype)
+            one = tir.const(1, v.dtype)
+            t = tir.tanh(c * (v + a * v * v * v))
+            a3 = tir.const(3 * 0.044715, v.dtype)
+            dy = half * (one + t) + half * v * (one - t * t) * c * (one + a3 * v * v)
+            return g(*i) * dy
+
+        return te.compute(g.shape, f, name="T_gelu_grad")
+
+    return [
+        adjoint.builder.emit_te(
+            fcompute, adjoint.value(call.args[0]), grad, primfunc_name_hint="gelu_grad"
+        )
+    ]
+
+
+@_register("relax.nn.softmax", uses=(-1,))
+def _softmax_grad(adjoint, call, out, grad, needs):
+    axis = int(call.attrs.axis)
+
+    def fcompute(y, g):
+        dot = topi.sum(topi.multiply(g, y), axis=axis, keepdims=True)
+        return topi.multiply(y, topi.subtract(g, dot))
+
+    return [
+        adjoint.builder.emit_te(
+            fcompute, adjoint.value(out), grad, primfunc_name_hint="softmax_grad"
+        )
+    ]
+
+
+@_register("relax.sum")
+def _sum_grad(adjoint, call, out, grad, needs):
+    shape = _shape_of(call.args[0])
+    attrs = call.attrs
+    axes = [int(a) % len(shape) for a in attrs.axis] if attrs.axis else list(range(len(shape)))
+    if attrs.axis and attrs.exclude:
+        axes = [i for i in range(len(shape)) if i not in axes]
+    kept = [1 if i in axes else dim for i, dim in enumerate(shape)]
+    return [
+        adjoint.builder.emit_te(
+            lambda g: topi.broadcast_to(topi.reshape(g, kept), shape),
+            grad,
+            primfunc_name_hint="sum_grad",
+        )
+    ]
+
+
+def _remap(expr: Expr, fvar: Callable[[Var], Expr]) -> Expr:
+    """An expression with its variables replaced."""
+    if isinstance(expr, Var):
+        return fvar(expr)
+    if isinstance(expr, RxTuple):
+        return RxTuple([_remap(field, fvar) for field in expr.fields])
+    if isinstance(expr, TupleGetItem):
+        return TupleGetItem(_remap(expr.tuple_value, fvar), expr.index)
+    if isinstance(expr, Call):
+        args = [_remap(arg, fvar) for arg in expr.args]
+        return Call(_remap(expr.op, fvar), args, expr.attrs, expr.type_args)
+    return expr
+
+
+def _bindings_of(func: Function) -> List[VarBinding]:
+    bindings = []
+    for block in func.body.blocks:
+        if not isinstance(block, DataflowBlock):
+            raise ValueError("Gradient only supports the functions made of dataflow blocks")
+        for binding in block.bindings:
+            if not isinstance(binding, VarBinding):
+                raise ValueError("Gradient does not support the match_shape bindings")
+            bindings.append(binding)
+    if not isinstance(func.body.body, Var):
+        raise ValueError("Gradient requires the output of the function to be a variable")
+    return bindings
+
+
+def _backward_uses(
+    func: Function, bindings: List[VarBinding], require_grads: Set[Var]
+) -> Tuple[Set[Var], List[Var]]:
+    """The variables depending on the required params and the forward values of the bindings
+    read by the backward pass, in the order of the bindings."""
+    requires = set(require_grads)
+    for binding in bindings:
+        value = binding.value
+        args = value.args if isinstance(value, Call) else [value]
+        if any(isinstance(arg, Var) and arg in requires for arg in args):
+            requires.add(binding.var)
+
+    reached = {func.body.body}
+    uses = set()
+    for binding in reversed(bindings):
+        value = binding.value
+        if binding.var not in reached or binding.var not in requires:
+            continue
+        if isinstance(value, Var):
+            reached.add(value)
+            continue
+        if not isinstance(value, Call) or not isinstance(value.op, ir.Op):
+            continue
+        if value.op.name in GRADIENTS:
+            for index in GRADIENTS[value.op.name][0]:
+                used = binding.var if index < 0 else value.args[index]
+                if isinstance(used, Var):
+                    uses.add(used)
+        reached.update(arg for arg in value.args if isinstance(arg, Var) and arg in requires)
+    params = set(func.params)
+    activations = [
+        b.var for b in bindings if b.var in uses and b.var not in params and b.var != func.body.body
+    ]
+    return requires, activations
+
+
+def plan_checkpoints(
+    func: Function, require_grads: List[Var], memory_budget: Optional[int]
+) -> Tuple[List[Var], List[Var]]:
+    """Choose the activations of a function kept for its backward pass under a memory budget.
+
+    The activations are dropped by increasing cost of their recomputation per byte until the
+    bytes of the kept ones fit in the budget. The activations of unknown shape are always kept,
+    and so are the ones that are not op calls.
+
+    Parameters
+    ----------
+    func : Function
+        The function.
+
+    require_grads : List[Var]
+        The params whose gradients are computed.
+
+    memory_budget : Optional[int]
+        The bytes of the kept activations, unbounded if None.
+
+    Returns
+    -------
+    kept, recomputed : Tuple[List[Var], List[Var]]
+        The kept and the recomputed activations, in the order of their bindings.
+    """
+    bindings = _bindings_of(func)
+    _, activations = _backward_uses(func, bindings, set(require_grads))
+    if memory_budget is None:
+        return activations, []
+    values = {b.var: b.value for b in bindings}
+    total = sum(_nbytes(var) or 0 for var in activations)
+    candidates = []
+    for var in activations:
+        value, nbytes = values[var], _nbytes(var)
+        if isinstance(value, Call) and isinstance(value.op, ir.Op) and nbytes:
+            candidates.append((_recompute_cost(value, var) / nbytes, var))
+    dropped = set()
+    for _, var in sorted(candidates, key=lambda c: c[0]):
+        if total <= memory_budget:
+            break
+        dropped.add(var)
+        total -= _nbytes(var)
+    kept = [var for var in activations if var not in dropped]
+    return kept, [var for var in activations if var in dropped]
+
+
+class _Adjoint:
+    """The emission of the forward and the backward passes of a function."""
+
+    def __init__(self, builder: BlockBuilder, func: Function, params: List[Var]):
+        self.builder = builder
+        self.params = dict(zip(func.params, params))
+        self.forward = dict(self.params)
+        self.values = {}
+        self.kept = set()
+        self.recomputed = {}
+
+    def value(self, expr: Expr) -> Expr:
+        """A forward value read by the backward pass, recomputed unless it was kept."""
+        if not isinstance(expr, Var) or expr in self.params or expr in self.kept:
+            return _remap(expr, self.forward.get)
+        if expr not in self.values:
+            return expr
+        if expr not in self.recomputed:
+            self.recomputed[expr] = self.builder.emit(_remap(self.values[expr], self.value))
+        return self.recomputed[expr]
+
+    def run(self, func: Function, require_grads: List[Var], memory_budget: Optional[int]):
+        bindings = _bindings_of(func)
+        requires, _ = _backward_uses(func, bindings, set(require_grads))
+        # the output is alive until the end of the function anyway
+        self.kept = set(plan_checkpoints(func, require_grads, memory_budget)[0])
+        self.kept.add(func.body.body)
+        for binding in bindings:
+            self.values[binding.var] = binding.value
+            self.forward[binding.var] = self.builder.emit(
+                _remap(binding.value, self.forward.get)
+            )
+
+        output = self.forward[func.body.body]
+        adjoints = {
+            func.body.body: self.builder.emit_te(
+                topi.full_like, output, 1.0, primfunc_name_hint="ones_like"
+            )
+        }
+
+        def accumulate(var, grad):
+            if var in adjoints:
+                grad = self.builder.emit(add(adjoints[var], grad))
+            adjoints[var] = grad
+
+        for binding in reversed(bindings):
+            var, value = binding.var, binding.value
+            if var not in adjoints or var not in requires:
+                continue
+            grad = adjoints.pop(var)
+            if isinstance(value, Var):
+                accumulate(value, grad)
+                continue
+            if not (isinstance(value, Call) and isinstance(value.op, ir.Op)) or (
+                value.op.name not in GRADIENTS
+            ):
+                raise ValueError("Gradient has no gradient for the binding of " + str(value))
+            needs = [isinstance(arg, Var) and arg in requires for arg in value.args]
+            grads = GRADIENTS[value.op.name][1](self, value, var, grad, needs)
+            for arg, arg_grad, need in zip(value.args, grads, needs):
+                if need and arg_grad is not None:
+                    accumulate(arg, arg_grad)
+
+        grads = []
+        for param in require_grads:
+            if param in adjoints:
+                grads.append(adjoints[param])
+            else:
+                grads.append(
+                    self.builder.emit_te(
+                        topi.full_like, self.params[param], 0.0, primfunc_name_hint="zeros_like"
+                    )
+                )
+        return output, grads
+
+
+def emit_adjoint(
+    builder: BlockBuilder,
+    name: str,
+    func: Function,
+    require_grads: Optional[List[str]] = None,
+    memory_budget: Optional[int] = None,
+) -> None:
+    """Emit the adjoint of a function into the builder, see Gradient."""
+    if require_grads is None:
+        required = list(func.params)
+    else:
+        by_name = {param.name_hint: param for param in func.params}
+        missing = [name for name in require_grads if name not in by_name]
+        if missing:
+            raise ValueError("The function has no params named {}".format(missing))
+        required = [by_name[name] for name in require_grads]
+
+    params = [Var(p.name_hint, p.shape, p.checked_type) for p in func.params]
+    with builder.function(name, params):
+        with builder.dataflow():
+            output, grads = _Adjoint(builder, func, params).run(func, required, memory_budget)
+            gv = builder.emit_output(RxTuple([output, RxTuple(grads)]))
+        builder.emit_func_output(gv)
+
+
+@ir.transform.module_pass(opt_level=0)
+class Gradient(ir.transform.Pass):
+    """Add the adjoint of a function to the module, as <func_name>_adjoint.
+
+    The adjoint takes the params of the function and returns a tuple of its output and of the
+    gradients of the sum of the output with respect to the required params. The function must be
+    made of dataflow blocks of the ops of GRADIENTS and of tensors of known shapes.
+
+    Parameters
+    ----------
+    func_name : str
+        The name of the function.
+
+    require_grads : Optional[List[str]]
+        The names of the params whose gradients are computed, in the order of the returned
+        gradients, all the params if None.
+
+    memory_budget : Optional[int]
+        The bytes of the activations kept for the backward pass, the others being recomputed,
+        unbounded if None.
+    """
+
+    def __init__(
+        self,
+        func_name: str,
+        require_grads: Optional[List[str]] = None,
+        memory_budget: Optional[int] = None,
+    ):
+        self.func_name = func_name
+        self.require_grads = require_grads
+        self.memory_budget = memory_budget
+
+    def transform_module(self, mod: IRModule, ctx: PassContext) -> IRModule:
+        func = mod[self.func_name]
+        if not isinstance(func, Function):
+            raise ValueError("{} is not a Relax function".format(self.func_name))
+        builder = BlockBuilder(mod)
+        emit_adjoint(
+            builder, self.func_name + "_adjoint", func, self.require_grads, self.memory_budget
+        )
+        return builder.get()
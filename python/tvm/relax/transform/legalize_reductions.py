@@ -0,0 +1,289 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name, unused-argument, arguments-differ
+"""Legalize the reductions and the normalizations, relax.sum, relax.nn.softmax,
+relax.nn.layer_norm and relax.nn.rms_norm, to scheduled TIR.
+
+Each op is computed row by row: the reductions over the reduced axes of a row, then the
+elementwise output of the row, all under one loop over the rows. On GPU a thread block handles a
+row, the loops over the reduced axes are bound to its threads, and the reductions become
+cross-thread reductions through shared memory in the LowerCrossThreadReduction pass of the TIR
+lowering. On CPU the rows run in parallel, and the elementwise loop over a row is vectorized
+when its extent is a static multiple of the vector lanes.
+
+The statistics of float16 data are accumulated in float32.
+"""
+from typing import Callable, Dict, List
+
+from tvm import ir, te, tir, topi
+from tvm.ir.module import IRModule
+from tvm.ir.transform import PassContext
+from tvm.target import Target
+
+from ..block_builder import BlockBuilder
+from ..expr import Call, Function, te_tensor
+from ..expr_functor import PyExprMutator, mutator
+from ..op.base import call_tir
+
+__all__ = ["LEGALIZATIONS", "legalize_reduction", "LegalizeReductions"]
+
+
+def _acc_dtype(dtype):
+    return "float32" if dtype == "float16" else dtype
+
+
+def _row_compute(x, axis):
+    """The shape of the rows of x over an axis, and the element k of the row at indices."""
+    rows = [dim for i, dim in enumerate(x.shape) if i != axis]
+
+    def at(indices, k):
+        return x(*indices[:axis], k, *indices[axis:])
+
+    return rows, at
+
+
+def _row(indices, axis):
+    return indices[:axis] + indices[axis + 1 :]
+
+
+def softmax(x, axis):
+    """Softmax over an axis, with the max and the sum of the exponentials of each row."""
+    axis = axis % len(x.shape)
+    acc = _acc_dtype(x.dtype)
+    rows, at = _row_compute(x, axis)
+    k = te.reduce_axis((0, x.shape[axis]), name="k")
+    x_max = te.compute(rows, lambda *i: te.max(at(i, k), axis=k), name="T_softmax_maxelem")
+    k = te.reduce_axis((0, x.shape[axis]), name="k")
+    x_sum = te.compute(
+        rows,
+        lambda *i: te.sum(te.exp(at(i, k) - x_max(*i)).astype(acc), axis=k),
+        name="T_softmax_expsum",
+    )
+    return te.compute(
+        x.shape,
+        lambda *i: (
+            te.exp(x(*i) - x_max(*_row(i, axis))).astype(acc) / x_sum(*_row(i, axis))
+        ).astype(x.dtype),
+        name="T_softmax_norm",
+    )
+
+
+def _mean_of(x, axis, f, name):
+    rows, at = _row_compute(x, axis)
+    k = te.reduce_axis((0, x.shape[axis]), name="k")
+    total = te.compute(rows, lambda *i: te.sum(f(at(i, k)), axis=k), name=name)
+    return total, tir.const(1, _acc_dtype(x.dtype)) / x.shape[axis].astype(_acc_dtype(x.dtype))
+
+
+def layer_norm(x, gamma, beta, axis, epsilon, center=True, scale=True):
+    """Layer normalization over an axis, with the sum and the sum of squares of each row."""
+    axis = axis % len(x.shape)
+    acc = _acc_dtype(x.dtype)
+    x_sum, inv_n = _mean_of(x, axis, lambda v: v.astype(acc), "T_layer_norm_sum")
+    x_sqsum, _ = _mean_of(x, axis, lambda v: v.astype(acc) * v.astype(acc), "T_layer_norm_sqsum")
+
+    def f(*i):
+        row = _row(i, axis)
+        mean = x_sum(*row) * inv_n
+        var = x_sqsum(*row) * inv_n - mean * mean
+        out = (x(*i).astype(acc) - mean) * tir.rsqrt(var + tir.const(epsilon, acc))
+        if scale:
+            out = out * gamma(i[axis]).astype(acc)
+        if center:
+            out = out + beta(i[axis]).astype(acc)
+        return out.astype(x.dtype)
+
+    return te.compute(x.shape, f, name="T_layer_norm")
+
+
+def rms_norm(x, weight, axis, epsilon):
+    """Root mean square normalization over an axis, with the sum of squares of each row."""
+    axis = axis % len(x.shape)
+    acc = _acc_dtype(x.dtype)
+    x_sqsum, inv_n = _mean_of(x, axis, lambda v: v.astype(acc) * v.astype(acc), "T_rms_norm_sqsum")
+
+    def f(*i):
+        rms = tir.rsqrt(x_sqsum(*_row(i, axis)) * inv_n + tir.const(epsilon, acc))
+        return (x(*i).astype(acc) * rms * weight(i[axis]).astype(acc)).astype(x.dtype)
+
+    return te.compute(x.shape, f, name="T_rms_norm")
+
+
+def schedule_rowwise(func: tir.PrimFunc, target: Target, col_axes: List[int]) -> tir.PrimFunc:
+    """Schedule a function computing rows: the reduction blocks over each row, followed by the
+    output block, all over the same rows.
+
+    Parameters
+    ----------
+    func : tir.PrimFunc
+        The function, whose last block is the output.
+
+    target : Target
+        The target, a thread block handles a row when it is a GPU.
+
+    col_axes : List[int]
+        The loops of the output block over the elements of a row, the reduced axes. The
+        reduction loops of an output block that is a reduction are always the last ones.
+
+    Returns
+    -------
+    func : tir.PrimFunc
+        The scheduled function.
+    """
+    sch = tir.Schedule(func)
+    *reductions, out = sch.get_child_blocks(sch.get_block("root"))
+    loops = sch.get_loops(out)
+    rows = [loop for i, loop in enumerate(loops) if i not in col_axes]
+    cols = [loop for i, loop in enumerate(loops) if i in col_axes]
+    sch.reorder(*rows, *cols)
+    row = sch.fuse(*rows) if rows else sch.add_unit_loop(cols[0])
+    col = sch.fuse(*cols)
+    for block in reversed(reductions):
+        sch.compute_at(block, row)
+
+    if "gpu" in target.keys:
+        num_threads = min(256, int(target.max_num_threads))
+        sch.bind(row, "blockIdx.x")
+        # the loops of the reductions under the row are over its elements
+        for elems in [sch.get_loops(block)[1:] for block in reductions] + [[col]]:
+            elem = sch.fuse(*elems) if len(elems) > 1 else elems[0]
+            _, tx = sch.split(elem, [None, num_threads])
+            sch.bind(tx, "threadIdx.x")
+        for block in reductions:
+            sch.set_scope(block, 0, "shared")
+    else:
+        sch.parallel(row)
+        is_reduction = any(
+            iv.iter_type == tir.IterVar.CommReduce for iv in sch.get(out).iter_vars
+        )
+        extent = sch.get(col).extent
+        lanes = 8
+        if not is_reduction and isinstance(extent, tir.IntImm) and extent.value % lanes == 0:
+            _, vec = sch.split(col, [None, lanes])
+            sch.vectorize(vec)
+    return sch.mod["main"]
+
+
+def _legalize_softmax(call: Call):
+    axis = call.attrs.axis % call.args[0].checked_type.ndim
+    return lambda x: softmax(x, axis), [axis]
+
+
+def _legalize_layer_norm(call: Call):
+    attrs = call.attrs
+    axis = attrs.axis % call.args[0].checked_type.ndim
+    return (
+        lambda x, gamma, beta: layer_norm(
+            x, gamma, beta, axis, attrs.epsilon, bool(attrs.center), bool(attrs.scale)
+        ),
+        [axis],
+    )
+
+
+def _legalize_rms_norm(call: Call):
+    axis = call.attrs.axis % call.args[0].checked_type.ndim
+    return lambda x, weight: rms_norm(x, weight, axis, call.attrs.epsilon), [axis]
+
+
+def _legalize_sum(call: Call):
+    ndim = call.args[0].checked_type.ndim
+    attrs = call.attrs
+    axes = [int(a) % ndim for a in attrs.axis] if attrs.axis else list(range(ndim))
+    if attrs.axis and attrs.exclude:
+        axes = [i for i in range(ndim) if i not in axes]
+    keepdims = bool(attrs.keepdims)
+    out_ndim = ndim if keepdims else ndim - len(axes)
+    # the reduction loops follow the spatial loops of the output
+    return (
+        lambda x: topi.sum(x, axis=axes, keepdims=keepdims),
+        list(range(out_ndim, out_ndim + len(axes))),
+    )
+
+
+# The row-wise compute of each op and the loops over the reduced axes of its output block.
+LEGALIZATIONS: Dict[str, Callable[[Call], tuple]] = {
+    "relax.nn.softmax": _legalize_softmax,
+    "relax.nn.layer_norm": _legalize_layer_norm,
+    "relax.nn.rms_norm": _legalize_rms_norm,
+    "relax.sum": _legalize_sum,
+}
+
+
+def legalize_reduction(builder: BlockBuilder, call: Call, target: Target) -> Call:
+    """Legalize a call to one of the ops of LEGALIZATIONS to a call_tir of a scheduled kernel.
+
+    Parameters
+    ----------
+    builder : BlockBuilder
+        The builder the kernel is added to.
+
+    call : Call
+        The call, whose input is of known rank.
+
+    target : Target
+        The target the kernel is scheduled for.
+
+    Returns
+    -------
+    call : Call
+        The call_tir.
+    """
+    if call.args[0].checked_type.ndim < 0:
+        raise ValueError("%s requires an input of known rank" % call.op.name)
+    compute, col_axes = LEGALIZATIONS[call.op.name](call)
+    te_args = [te_tensor(arg) for arg in call.args]
+    out = compute(*te_args)
+    func = te.create_prim_func(te_args + [out])
+    func = schedule_rowwise(func, target, col_axes)
+    gvar = builder.add_func(func, call.op.name.split(".")[-1])
+    return call_tir(gvar, list(call.args), out.shape, out.dtype)
+
+
+@ir.transform.module_pass(opt_level=0)
+class LegalizeReductions(ir.transform.Pass):
+    """Legalize the calls to relax.sum, relax.nn.softmax, relax.nn.layer_norm and
+    relax.nn.rms_norm to scheduled row-wise kernels.
+
+    Parameters
+    ----------
+    target : Target
+        The target the kernels are scheduled for.
+    """
+
+    def __init__(self, target: Target):
+        self.target = Target(target) if isinstance(target, str) else target
+
+    def transform_module(self, mod: IRModule, ctx: PassContext) -> IRModule:
+        target = self.target
+
+        @mutator
+        class Legalizer(PyExprMutator):
+            """Mutator replacing the calls to the ops of LEGALIZATIONS."""
+
+            def visit_call_(self, call: Call):
+                call = self.visit_expr_post_order(call)
+                if isinstance(call.op, ir.Op) and call.op.name in LEGALIZATIONS:
+                    return legalize_reduction(self.builder_, call, target)
+                return call
+
+            def transform(self):
+                for gv, func in mod.functions.items():
+                    if isinstance(func, Function):
+                        self.builder_.update_func(gv, self.visit_expr(func))
+                return self.builder_.get()
+
+        return Legalizer(mod).transform()
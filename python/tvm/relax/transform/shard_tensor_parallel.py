@@ -0,0 +1,338 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name, unused-argument, arguments-differ
+"""Shard a Relax function for the tensor parallel execution over a group of workers.
+
+Each worker runs the same sharded function on its shards of the weights, with the collectives
+of relax.op.ccl between them. The weights are split along an axis given per param: for a weight
+of shape [K, N] of relax.nn.matmul, axis 1 splits it column-wise and axis 0 row-wise.
+
+The layout of each value is propagated through the bindings. A value is replicated on all the
+workers, split along an axis, each worker holding a chunk, or partial, the sum over the
+workers being the value:
+
+- a matmul by a column-split weight splits the last axis of a replicated input,
+- a matmul by a row-split weight of an input split along its last axis is partial, so a
+  column-split matmul followed by elementwise ops and a row-split matmul, as in the MLPs and
+  the projections of the attention layers, only communicates once with an allreduce,
+- the elementwise ops keep the split layouts, and the sums of partial values stay partial.
+
+Any other use of a value makes it replicated first, with an allreduce for the partial values and
+an allgather for the split ones, and so do the outputs of the function.
+"""
+import contextlib
+from typing import Dict, List, Optional, Tuple
+
+import numpy as np
+
+from tvm import ir, tir, topi
+from tvm.ir.module import IRModule
+from tvm.ir.transform import PassContext
+
+from ..block_builder import BlockBuilder
+from ..expr import (
+    Call,
+    Constant,
+    DataflowBlock,
+    DataflowVar,
+    ExternFunc,
+    Expr,
+    Function,
+    GlobalVar,
+    MatchShape,
+    ShapeExpr,
+    Tuple as RxTuple,
+    TupleGetItem,
+    Var,
+)
+from ..op import ccl
+
+# The layouts of the values: None for replicated, PARTIAL, or ("split", axis) with a negative
+# axis, counted from the end so that it is kept through the broadcasts.
+PARTIAL = "partial"
+
+
+def _split(axis: int) -> Tuple[str, int]:
+    return ("split", axis)
+
+
+def _is_split(layout) -> bool:
+    return isinstance(layout, tuple)
+
+
+def _static_dim(dim: tir.PrimExpr) -> Optional[int]:
+    return dim.value if isinstance(dim, tir.IntImm) else None
+
+
+class _Sharder:
+    """Rewrite the bindings of a function into the sharded ones, tracking their layouts."""
+
+    ELEMENTWISE = ("relax.nn.relu", "relax.nn.gelu")
+
+    def __init__(self, builder: BlockBuilder, num_workers: int):
+        self.builder = builder
+        self.num_workers = num_workers
+        # the original variables to their sharded value and its layout
+        self.values = {}
+        # the replicated and the row-split values already emitted, valid in the current block
+        self.replicas = {}
+        self.locals = {}
+
+    def lookup(self, expr: Expr):
+        if isinstance(expr, Var) and expr in self.values:
+            return self.values[expr]
+        return expr, None
+
+    def _move_axis(self, x: Expr, axis: int, collective) -> Expr:
+        """Apply a collective of the first axis to another axis, transposing it to the front."""
+        ndim = x.checked_type.ndim
+        axis = axis % ndim
+        if axis == 0:
+            return self.builder.emit(collective(x, self.num_workers))
+        perm = [axis] + [i for i in range(ndim) if i != axis]
+        front = self.builder.emit_te(topi.transpose, x, perm)
+        out = self.builder.emit(collective(front, self.num_workers))
+        return self.builder.emit_te(topi.transpose, out, [int(i) for i in np.argsort(perm)])
+
+    def replicated(self, expr: Expr) -> Expr:
+        """The sharded value of an original expression, made replicated."""
+        if isinstance(expr, RxTuple):
+            return RxTuple([self.replicated(field) for field in expr.fields])
+        new, layout = self.lookup(expr)
+        if layout is None:
+            return new
+        if expr not in self.replicas:
+            if layout == PARTIAL:
+                self.replicas[expr] = self.builder.emit(ccl.allreduce(new))
+            else:
+                self.replicas[expr] = self._move_axis(new, layout[1], ccl.allgather)
+        return self.replicas[expr]
+
+    def split_last(self, expr: Expr) -> Expr:
+        """The chunk of the worker along the last axis of a replicated value."""
+        if expr not in self.locals:
+            self.locals[expr] = self._move_axis(self.lookup(expr)[0], -1, ccl.local_shard)
+        return self.locals[expr]
+
+    def end_block(self):
+        self.replicas.clear()
+        self.locals.clear()
+
+    def _matmul(self, call: Call):
+        a, la = self.lookup(call.args[0])
+        b, lb = self.lookup(call.args[1])
+        n_axis, k_axis = (-2, -1) if call.attrs.transpose_b else (-1, -2)
+        if la == PARTIAL:
+            a, la = self.replicated(call.args[0]), None
+        if lb == _split(n_axis) and la is None:
+            return Call(call.op, [a, b], call.attrs), _split(-1)
+        if lb == _split(k_axis):
+            if la is None:
+                a, la = self.split_last(call.args[0]), _split(-1)
+            if la == _split(-1):
+                return Call(call.op, [a, b], call.attrs), PARTIAL
+        if lb is None and _is_split(la) and la != _split(-1):
+            # the rows of the input are independent
+            return Call(call.op, [a, b], call.attrs), la
+        return None
+
+    def _elementwise(self, call: Call):
+        x, layout = self.lookup(call.args[0])
+        if layout == PARTIAL:
+            return None
+        return Call(call.op, [x], call.attrs), layout
+
+    @staticmethod
+    def _broadcasts_along(x: Expr, axis: int) -> bool:
+        shape = x.shape
+        if not isinstance(shape, ShapeExpr):
+            return False
+        return len(shape.values) < -axis or _static_dim(shape.values[axis]) == 1
+
+    def _binary(self, call: Call):
+        (a, la), (b, lb) = self.lookup(call.args[0]), self.lookup(call.args[1])
+        is_add = call.op.name == "relax.add"
+        if la is None and lb is None:
+            return None
+        if la == PARTIAL and lb == PARTIAL:
+            return (Call(call.op, [a, b]), PARTIAL) if is_add else None
+        if PARTIAL in (la, lb):
+            # the product by a replicated value is linear
+            if not is_add and None in (la, lb):
+                return Call(call.op, [a, b]), PARTIAL
+            return None
+        if la == lb:
+            return Call(call.op, [a, b]), la
+        if la is None and self._broadcasts_along(a, lb[1]):
+            return Call(call.op, [a, b]), lb
+        if lb is None and self._broadcasts_along(b, la[1]):
+            return Call(call.op, [a, b]), la
+        return None
+
+    def emit(self, binding, is_dataflow: bool):
+        """Emit the sharded binding of a binding of the function."""
+        if isinstance(binding, MatchShape):
+            var = self.builder.match_shape(self.replicated(binding.value), binding.pattern)
+            if binding.var is not None:
+                self.values[binding.var] = (var, None)
+            return
+        value, layout = self.rewrite(binding.value)
+        if is_dataflow and not isinstance(binding.var, DataflowVar):
+            var = self.builder.emit_output(value)
+        else:
+            var = self.builder.emit(value)
+        self.values[binding.var] = (var, layout)
+
+    def rewrite(self, value: Expr):
+        """The sharded value of a binding and its layout."""
+        if isinstance(value, Var):
+            return self.lookup(value)
+        if isinstance(value, Call) and isinstance(value.op, ir.Op):
+            result = None
+            if value.op.name == "relax.nn.matmul":
+                result = self._matmul(value)
+            elif value.op.name in self.ELEMENTWISE:
+                result = self._elementwise(value)
+            elif value.op.name in ("relax.add", "relax.multiply"):
+                result = self._binary(value)
+            if result is not None:
+                return result
+        if isinstance(value, Call):
+            args = [self.replicated(arg) for arg in value.args]
+            return Call(value.op, args, value.attrs, value.type_args), None
+        if isinstance(value, RxTuple):
+            return self.replicated(value), None
+        if isinstance(value, TupleGetItem):
+            return TupleGetItem(self.replicated(value.tuple_value), value.index), None
+        if isinstance(value, (Constant, ShapeExpr, ExternFunc, GlobalVar)):
+            return value, None
+        raise ValueError(
+            "ShardTensorParallel does not support the bindings of " + type(value).__name__
+        )
+
+
+def _shard_param(param: Var, axis: int, num_workers: int) -> Tuple[Var, Tuple[str, int]]:
+    shape = [_static_dim(dim) for dim in param.shape]
+    if None in shape:
+        raise ValueError("The sharded param {} must have a static shape".format(param.name_hint))
+    axis = axis % len(shape)
+    if shape[axis] % num_workers != 0:
+        raise ValueError(
+            "The axis {} of the param {} of shape {} is not divisible by the {} workers".format(
+                axis, param.name_hint, shape, num_workers
+            )
+        )
+    shape[axis] //= num_workers
+    return Var(param.name_hint, shape, param.checked_type), _split(axis - len(shape))
+
+
+def shard_function(
+    builder: BlockBuilder, name: str, func: Function, num_workers: int, sharding: Dict[str, int]
+) -> None:
+    """Emit the sharded function of a function into the builder, see ShardTensorParallel."""
+    sharder = _Sharder(builder, num_workers)
+    params = []
+    for param in func.params:
+        if param.name_hint in sharding:
+            new_param, layout = _shard_param(param, sharding[param.name_hint], num_workers)
+            sharder.values[param] = (new_param, layout)
+            params.append(new_param)
+        else:
+            params.append(param)
+    attrs = {}
+    if func.attrs is not None:
+        attrs = {key: func.attrs[key] for key in func.attrs.keys() if key != "global_symbol"}
+
+    with builder.function(name, params, attrs):
+        for block in func.body.blocks:
+            is_dataflow = isinstance(block, DataflowBlock)
+            with builder.dataflow() if is_dataflow else contextlib.nullcontext():
+                for binding in block.bindings:
+                    sharder.emit(binding, is_dataflow)
+            sharder.end_block()
+        builder.emit_func_output(sharder.replicated(func.body.body))
+
+
+@ir.transform.module_pass(opt_level=0)
+class ShardTensorParallel(ir.transform.Pass):
+    """Shard a function for the tensor parallel execution over a group of workers, splitting the
+    given params along an axis and inserting the collectives between the workers.
+
+    The workers run the sharded function on their shards of the params, see
+    :py:func:`shard_params`, and get the replicated outputs.
+
+    Parameters
+    ----------
+    func_name : str
+        The name of the function.
+
+    num_workers : int
+        The number of workers.
+
+    sharding : Dict[str, int]
+        The axis each sharded param is split along. For a weight of shape [K, N] of
+        relax.nn.matmul, 1 splits it column-wise and 0 row-wise.
+    """
+
+    def __init__(self, func_name: str, num_workers: int, sharding: Dict[str, int]):
+        self.func_name = func_name
+        self.num_workers = num_workers
+        self.sharding = sharding
+
+    def transform_module(self, mod: IRModule, ctx: PassContext) -> IRModule:
+        target_gv = mod.get_global_var(self.func_name)
+        func = mod[target_gv]
+        if not isinstance(func, Function):
+            raise ValueError("{} is not a Relax function".format(self.func_name))
+        others = {gv: f for gv, f in mod.functions.items() if not gv.same_as(target_gv)}
+        builder = BlockBuilder(IRModule(others, attrs=mod.attrs))
+        shard_function(builder, self.func_name, func, self.num_workers, self.sharding)
+        return builder.get()
+
+
+def shard_params(
+    params: Dict[str, np.ndarray], num_workers: int, sharding: Dict[str, int]
+) -> List[Dict[str, np.ndarray]]:
+    """Split the params of a function as ShardTensorParallel does.
+
+    Parameters
+    ----------
+    params : Dict[str, np.ndarray]
+        The params by name.
+
+    num_workers : int
+        The number of workers.
+
+    sharding : Dict[str, int]
+        The axis each sharded param is split along, the others being replicated.
+
+    Returns
+    -------
+    shards : List[Dict[str, np.ndarray]]
+        The params of each worker, in rank order.
+    """
+    shards = [{} for _ in range(num_workers)]
+    for name, value in params.items():
+        value = np.asarray(value)
+        chunks = (
+            np.split(value, num_workers, axis=sharding[name])
+            if name in sharding
+            else [value] * num_workers
+        )
+        for shard, chunk in zip(shards, chunks):
+            shard[name] = np.ascontiguousarray(chunk)
+    return shards
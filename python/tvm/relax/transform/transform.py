@@ -19,7 +19,7 @@
 import functools
 import inspect
 import types
-from typing import Callable, Dict, List, Optional, Union
+from typing import Callable, Dict, List, Optional, Tuple, Union
 
 import numpy as np
 import tvm.ir
@@ -81,6 +81,20 @@ def LambdaLift():
     return _ffi_api.LambdaLift()
 
 
+def DevirtualizeClosures() -> tvm.ir.transform.Pass:
+    """
+    Turn the invocations of the closures whose target is statically known into direct calls of
+    the lifted functions, passing the captured values after the arguments, and remove the
+    closures left unused. This removes the closure allocation and the indirect dispatch of the VM
+    at the call sites produced by LambdaLift, so it is expected to run after it.
+
+    Returns
+    -------
+    ret : tvm.ir.transform.Pass
+    """
+    return _ffi_api.DevirtualizeClosures()
+
+
 def ToNonDataflow() -> tvm.ir.transform.Pass:
     """Transform all dataflow structure to non-dataflow version.
 
@@ -91,35 +105,75 @@ def ToNonDataflow() -> tvm.ir.transform.Pass:
     return _ffi_api.ToNonDataflow()
 
 
-def CallTIRRewrite() -> tvm.ir.transform.Pass:
+def LiftTIRWorkspace() -> tvm.ir.transform.Pass:
+    """Lift the scratch buffers of static shape allocated by the root block of the PrimFuncs
+    called by call_tir into trailing parameters, which CallTIRRewrite allocates as tensors, so
+    that the VM plans them with the other tensors instead of allocating a workspace per call.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+    """
+    return _ffi_api.LiftTIRWorkspace()
+
+
+def CallTIRRewrite(inplace: bool = False) -> tvm.ir.transform.Pass:
     """Perform explicit tensor allocation for call_tir.
 
+    Parameters
+    ----------
+    inplace : bool
+        Whether to write the output of a call_tir into an input that dies at the call instead
+        of allocating it, when the PrimFunc reads each input element only to compute the output
+        element at the same index. See :py:func:`tvm.relax.analysis.call_tir_inplace_inputs`.
+
     Returns
     -------
     ret: tvm.ir.transform.Pass
     """
-    return _ffi_api.CallTIRRewrite()
+    return _ffi_api.CallTIRRewrite(inplace)
 
 
-def VMMemoryLower() -> tvm.ir.transform.Pass:
+def VMMemoryLower(plan_memory: bool = False) -> tvm.ir.transform.Pass:
     """Perform memory lowering. Lowers the relax.builtin.alloc_tensor intrinsic to VM intrinsics.
 
+    Parameters
+    ----------
+    plan_memory : bool
+        Whether to plan the allocations statically. The tensors with disjoint lifetimes share
+        storage, and the tensors of a binding block are allocated from a single storage per
+        device. Symbolically shaped tensors are planned when the function attribute
+        "tir_var_upper_bound" bounds all their shape variables. The VM allocates the
+        planned storages once and keeps them across calls.
+
+        The offsets are assigned by reusing storage tokens as the graph memory planner,
+        unless the "relax.VMMemoryLower.algorithm" config names a USMP algorithm:
+        "greedy_by_size", "greedy_by_conflicts", "hill_climb", "tiered_by_access" or the name
+        of a custom "tir.usmp.algo.<name>" function. The total size of the planned storages is
+        reported by the function attribute "planned_arena_bytes".
+
     Returns
     -------
     ret: tvm.ir.transform.Pass
     """
-    return _ffi_api.VMMemoryLower()
+    return _ffi_api.VMMemoryLower(plan_memory)
 
 
-def VMShapeLower() -> tvm.ir.transform.Pass:
+def VMShapeLower(native_shape_arith: bool = False) -> tvm.ir.transform.Pass:
     """Lower the shape expressions in relax to VM shape heap manipulations and generate related
     TIR functions to do shape calculations.
 
+    Parameters
+    ----------
+    native_shape_arith : bool
+        Whether to compute the shape expressions that only use integer arithmetic with VM
+        instructions, instead of generating TIR functions for them.
+
     Returns
     -------
     ret: tvm.ir.transform.Pass
     """
-    return _ffi_api.VMShapeLower()
+    return _ffi_api.VMShapeLower(native_shape_arith)
 
 
 def Normalize() -> tvm.ir.transform.Pass:
@@ -190,6 +244,29 @@ def BindParams(
     return _ffi_api.BindParams(func_name, tvm_params)
 
 
+def ExternalizeParams(func_name: str, names: List[str]) -> tvm.ir.transform.Pass:
+    """Load params of function of the module by name from the param store of the VM at runtime.
+
+    The params are removed from the signature of the function and bound to
+    :py:func:`tvm.relax.op.param_load` calls at its start, so the executable only carries their
+    names. The params are saved with :py:func:`tvm.relax.param_store.save_params`, and the store
+    is set on the VM with :py:meth:`tvm.relax.VirtualMachine.set_param_store`.
+
+    Parameters
+    ----------
+    func_name: str
+        The name of the function.
+
+    names : List[str]
+        The names of the params to load, which must have static shapes.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+    """
+    return _ffi_api.ExternalizeParams(func_name, names)  # type: ignore
+
+
 def RemoveUnusedFunctions(entry_functions: Optional[List[str]] = None) -> tvm.ir.transform.Pass:
     """Remove unused relax/prim functions without external linkage in a IRModule.
 
@@ -230,9 +307,202 @@ def RunCodegen(
     return _ffi_api.RunCodegen(target_codegens, entry_functions)
 
 
+def EliminateCommonSubexpr() -> tvm.ir.transform.Pass:
+    """Eliminate the bindings of DataflowBlocks computing the same value as an earlier binding
+    of the block, i.e. the calls with the same callee and arguments. The calls of packed
+    functions are kept since they may have side effects.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+    """
+    return _ffi_api.EliminateCommonSubexpr()
+
+
+def DeadCodeElimination() -> tvm.ir.transform.Pass:
+    """Remove the bindings of DataflowBlocks whose vars are never used, until none is left.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+    """
+    return _ffi_api.DeadCodeElimination()
+
+
+def CombineParallelMatmul() -> tvm.ir.transform.Pass:
+    """Combine the matmuls of each DataflowBlock which share the same input into a single
+    wider matmul, whose weight is the concatenation of their weights, followed by a split of
+    its output. The concatenation of constant weights is folded by FoldConstant.
+
+    Only the matmul PrimFuncs with static shapes whose weights are defined outside of the
+    block are combined.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+    """
+    return _ffi_api.CombineParallelMatmul()
+
+
+def ExposeQuantizeInputs(func_name: str = "main") -> tvm.ir.transform.Pass:
+    """Make the function return the inputs of its quantize ops whose scales are yet to be
+    calibrated, in the order of the ops, after its original return value.
+
+    Parameters
+    ----------
+    func_name: str
+        The name of the function to be calibrated.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+    """
+    return _ffi_api.ExposeQuantizeInputs(func_name)
+
+
+def BindQuantizeParams(
+    scales: List[float], zero_points: List[int], func_name: str = "main"
+) -> tvm.ir.transform.Pass:
+    """Set the scales and zero points of the quantize ops of the function which are yet to be
+    calibrated, in the order of the ops. The uncalibrated dequantize ops of their outputs take
+    the same parameters.
+
+    Parameters
+    ----------
+    scales: List[float]
+        The scale of each quantize op.
+
+    zero_points: List[int]
+        The zero point of each quantize op.
+
+    func_name: str
+        The name of the calibrated function.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+    """
+    scales = [tvm.tir.FloatImm("float64", scale) for scale in scales]
+    zero_points = [int(zero_point) for zero_point in zero_points]
+    return _ffi_api.BindQuantizeParams(func_name, scales, zero_points)
+
+
+def Calibrate(
+    dataset: List[List[Union[np.ndarray, NDArray]]],
+    target: Union[str, "tvm.target.Target"] = "llvm",
+    dev: Optional["tvm.runtime.Device"] = None,
+    func_name: str = "main",
+) -> tvm.ir.transform.Pass:
+    """Calibrate the quantize ops of the function whose scales are non-positive. The function is
+    run by the VM on each sample of the dataset, and the scale and zero point of each op are set
+    so that the range of values observed at its input, extended to contain zero, maps to the
+    range of its output data type.
+
+    Parameters
+    ----------
+    dataset: List[List[Union[numpy.ndarray, tvm.nd.NDArray]]]
+        The samples, each of which is the list of arguments of the function.
+
+    target: Union[str, tvm.target.Target]
+        The target the function is run on for calibration.
+
+    dev: Optional[tvm.runtime.Device]
+        The device the function is run on, the CPU if None.
+
+    func_name: str
+        The name of the function to be calibrated.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+    """
+    quantize_op = tvm.ir.Op.get("relax.quantize")
+
+    def transform(mod, ctx):  # pylint: disable=unused-argument
+        out_dtypes = []
+
+        def fvisit(expr):
+            if isinstance(expr, tvm.relax.Call) and expr.op == quantize_op:
+                if expr.attrs.scale <= 0:
+                    out_dtypes.append(expr.attrs.out_dtype)
+
+        tvm.relax.analysis.post_order_visit(mod[func_name], fvisit)
+        if not out_dtypes:
+            return mod
+
+        device = tvm.cpu() if dev is None else dev
+        exposed = ExposeQuantizeInputs(func_name)(mod)
+        ex = tvm.relax.vm.build(exposed, target)
+        vm = tvm.relax.VirtualMachine(ex, device)
+        lows = [0.0] * len(out_dtypes)
+        highs = [0.0] * len(out_dtypes)
+        for sample in dataset:
+            args = [tvm.nd.array(arg, device) for arg in sample]
+            outputs = vm[func_name](*args)
+            for i in range(len(out_dtypes)):
+                value = outputs[i + 1].numpy()
+                lows[i] = min(lows[i], float(value.min()))
+                highs[i] = max(highs[i], float(value.max()))
+
+        scales = []
+        zero_points = []
+        for low, high, dtype in zip(lows, highs, out_dtypes):
+            info = np.iinfo(str(dtype))
+            scale = (high - low) / (int(info.max) - int(info.min))
+            if scale == 0:
+                scale = 1.0
+            zero_point = int(np.clip(round(int(info.min) - low / scale), info.min, info.max))
+            scales.append(scale)
+            zero_points.append(zero_point)
+        return BindQuantizeParams(scales, zero_points, func_name)(mod)
+
+    return tvm.ir.transform.module_pass(transform, opt_level=0, name="Calibrate")
+
+
+def FoldQDQ() -> tvm.ir.transform.Pass:
+    """Fold the quantize of a matmul of dequantized integer tensors into a single call_tir to an
+    integer matmul, which accumulates in int32 and requantizes its result.
+
+    Only the calibrated ops and the matmul PrimFuncs with static shapes are folded.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+    """
+    return _ffi_api.FoldQDQ()
+
+
+def ToMixedPrecision(out_dtype: str = "float16") -> tvm.ir.transform.Pass:
+    """Compute the float32 operators of the DataflowBlocks in a lower precision.
+
+    An operator is converted according to its ``TMixedPrecisionPolicy`` attribute, and a call_tir
+    according to the ``mixed_precision_policy`` attribute of its PrimFunc: 0 to always convert,
+    1 to convert when any of its inputs already is converted and 2 to never convert. Without the
+    attribute, the matmul-like PrimFuncs are always converted, the elementwise, broadcast and
+    injective ones follow their inputs, and the others, such as the reductions, are never
+    converted. The casts are only inserted at the boundaries of the converted regions.
+
+    To cast the weights at compile time, bind them with :py:func:`BindParams` before this pass,
+    and run :py:func:`FoldConstant` after it.
+
+    Parameters
+    ----------
+    out_dtype: str
+        The data type the operators are computed in, "float16" or "bfloat16".
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+    """
+    return _ffi_api.ToMixedPrecision(out_dtype)
+
+
 def FoldConstant() -> tvm.ir.transform.Pass:
     """Fold constant expressions.
 
+    The PrimFuncs evaluated by the folding are built together in a single LLVM module,
+    unless the pass config "relax.FoldConstant.batch_build" is set to False.
+
     Returns
     -------
     ret: tvm.ir.transform.Pass
@@ -240,6 +510,87 @@ def FoldConstant() -> tvm.ir.transform.Pass:
     return _ffi_api.FoldConstant()
 
 
+def ElideLayoutTransforms() -> tvm.ir.transform.Pass:
+    """Cancel the pairs of adjacent layout transforms that undo each other.
+
+    A layout transform is a call_tir to a PrimFunc which only permutes the axes of its input,
+    like the NCHW <-> NHWC transposes emitted around the operators using another layout. Run
+    it before FoldConstant, which folds the remaining transforms of the weights, and FuseOps.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+    """
+    return _ffi_api.ElideLayoutTransforms()
+
+
+def SpecializeShapes(func_name: str, shapes: List[List[int]]) -> tvm.ir.transform.Pass:
+    """Specialize a Relax function to the concrete shapes of its inputs.
+
+    The symbolic shape vars of its parameters are replaced with the given dimensions, and the
+    PrimFuncs it calls with static shapes only are specialized to them, as new PrimFuncs of the
+    module. The specialized function keeps its name.
+
+    Parameters
+    ----------
+    func_name : str
+        The name of the function.
+
+    shapes : List[List[int]]
+        The shape of each parameter, ignored for the parameters without a shape annotation.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+    """
+    shapes = [tvm.runtime.ShapeTuple(shape) for shape in shapes]
+    return _ffi_api.SpecializeShapes(func_name, shapes)
+
+
+def DispatchShapeBuckets(
+    buckets: Dict[str, List[Tuple[Dict[str, Union[int, Tuple[int, int]]], "tvm.tir.PrimFunc"]]]
+) -> tvm.ir.transform.Pass:
+    """Dispatch the call_tir of PrimFuncs with symbolic shapes among their variants tuned for
+    buckets of shapes.
+
+    Each call is rewritten into a chain of If, whose conditions are computed by predicate
+    PrimFuncs reading the symbolic shapes of the inputs. The first bucket containing the shapes
+    selects its variant, and the original PrimFunc handles the shapes outside all buckets. The
+    Relax functions are converted out of the dataflow form.
+
+    Parameters
+    ----------
+    buckets : Dict[str, List[Tuple[Dict[str, Union[int, Tuple[int, int]]], tvm.tir.PrimFunc]]]
+        The buckets of each PrimFunc, keyed by its name, in the order they are checked. Each
+        bucket is a pair of the inclusive range of some symbolic vars of the inputs, keyed by
+        their names, and the variant, which takes the same arguments. A single value is the
+        range of one value. The variant can also be a tir.Schedule, or an IRModule with a "main"
+        PrimFunc, e.g. the dispatch returned by `meta_schedule.tir_integration.compile_tir_dynamic`.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+    """
+
+    def _normalize_bucket(ranges, variant):
+        ranges = {
+            name: [value, value] if isinstance(value, int) else list(value)
+            for name, value in ranges.items()
+        }
+        if isinstance(variant, tvm.tir.Schedule):
+            variant = variant.mod
+        if isinstance(variant, tvm.IRModule):
+            variant = variant["main"]
+        return [ranges, variant]
+
+    return _ffi_api.DispatchShapeBuckets(
+        {
+            name: [_normalize_bucket(ranges, variant) for ranges, variant in func_buckets]
+            for name, func_buckets in buckets.items()
+        }
+    )
+
+
 def AnnotateTIROpPattern() -> tvm.ir.transform.Pass:
     """Annotate Op Pattern Kind for TIR functions
 
@@ -250,7 +601,10 @@ def AnnotateTIROpPattern() -> tvm.ir.transform.Pass:
     return _ffi_api.AnnotateTIROpPattern()
 
 
-def FuseOps(fuse_opt_level=-1) -> tvm.ir.transform.Pass:
+def FuseOps(
+    fuse_opt_level=-1,
+    fcheck_group: Optional[Callable] = None,
+) -> tvm.ir.transform.Pass:
     """This pass groups bindings in a dataflow block of Relax functions and generate a new grouped
     Relax function for each group, according to the fusion algorithm described in the pass
     implementation. By grouping bindings into new Relax functions, we substitute the bindings in
@@ -264,12 +618,108 @@ def FuseOps(fuse_opt_level=-1) -> tvm.ir.transform.Pass:
         The level of fuse optimization. -1 indicates that the level will be
         inferred from pass context.
 
+    fcheck_group : Optional[Callable[[tvm.relax.Function, tvm.IRModule], bool]]
+        The function deciding whether each group found by the fusion algorithm is
+        actually fused, given the grouped function and the module, e.g. the one created
+        by :py:func:`database_fusion_check`. All the groups are fused if None.
+
     Returns
     -------
     ret : tvm.transform.Pass
         The registered pass for operator fusion.
     """
-    return _ffi_api.FuseOps(fuse_opt_level)
+    return _ffi_api.FuseOps(fuse_opt_level, fcheck_group)
+
+
+def FuseOpsByPattern(
+    patterns: List[Tuple[str, "tvm.relax.dpl.DFPattern"]],
+    fcheck_group: Optional[Callable] = None,
+) -> tvm.ir.transform.Pass:
+    """Group the bindings of dataflow blocks matching the patterns of external codegens
+    into functions to be offloaded by RunCodegen. Each match is wrapped into a composite
+    function whose "Composite" attribute is the pattern name, called by a function with
+    the "Codegen" attribute set to the codegen name.
+
+    Parameters
+    ----------
+    patterns : List[Tuple[str, DFPattern]]
+        The table of patterns as (name, pattern) pairs, in the order of priority. Each name
+        is prefixed by its codegen, e.g. "tensorrt.add" is offloaded to "relax.ext.tensorrt".
+
+    fcheck_group : Optional[Callable[[tvm.relax.Function, tvm.IRModule], bool]]
+        The function deciding whether each match is actually offloaded, given the function
+        offloading it and the module. All the matches are offloaded if None.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass for pattern-based partitioning.
+    """
+    pattern_names = [name for name, _ in patterns]
+    dfpatterns = [pattern for _, pattern in patterns]
+    return _ffi_api.FuseOpsByPattern(pattern_names, dfpatterns, fcheck_group)
+
+
+def MergeCompositeFunctions() -> tvm.ir.transform.Pass:
+    """Merge the chains of functions created by FuseOpsByPattern that are offloaded to the same
+    codegen, when each intermediate result is only used by the next function of the chain. Each
+    chain is then compiled by its codegen as a whole, which can e.g. keep the intermediate tensors
+    in the layouts of the external library.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass for merging the offloaded functions.
+    """
+    return _ffi_api.MergeCompositeFunctions()  # type: ignore
+
+
+def database_fusion_check(database, target: Union[str, "tvm.target.Target"]) -> Callable:
+    """Create a check for FuseOps which keeps a group fused unless the tuning records of
+    a meta_schedule database show that its fused kernel runs slower than its kernels do
+    one by one. Groups whose kernels are not all in the database stay fused.
+
+    Parameters
+    ----------
+    database : tvm.meta_schedule.database.Database
+        The database holding the tuning records of the fused and unfused kernels.
+
+    target : Union[str, tvm.target.Target]
+        The target the kernels were tuned for.
+
+    Returns
+    -------
+    fcheck_group : Callable[[tvm.relax.Function, tvm.IRModule], bool]
+        The check to be passed to FuseOps.
+    """
+    target = tvm.target.Target(target)
+    normalize_mod = tvm.get_global_func("tvm.meta_schedule.normalize_mod")
+    call_tir_op = tvm.ir.Op.get("relax.call_tir")
+
+    def run_secs(prim_func):
+        record = database.query_tuning_record(normalize_mod(prim_func), target, "main")
+        if record is None or not record.run_secs:
+            return None
+        return sum(float(secs) for secs in record.run_secs) / len(record.run_secs)
+
+    def fcheck_group(func, mod):
+        parts = []
+
+        def fvisit(expr):
+            if isinstance(expr, tvm.relax.Call) and expr.op == call_tir_op:
+                parts.append(mod[expr.args[0]])
+
+        tvm.relax.analysis.post_order_visit(func.body, fvisit)
+        gvar = tvm.ir.GlobalVar("fused")
+        funcs = {gv: f for gv, f in mod.functions.items() if isinstance(f, tvm.tir.PrimFunc)}
+        funcs[gvar] = func
+        fused = _ffi_api.FusedPrimFunc(tvm.IRModule(funcs), gvar)
+        costs = [run_secs(f) for f in [fused] + parts]
+        if any(cost is None for cost in costs):
+            return True
+        return costs[0] <= sum(costs[1:])
+
+    return fcheck_group
 
 
 def FuseTIR() -> tvm.ir.transform.Pass:
@@ -283,19 +733,89 @@ def FuseTIR() -> tvm.ir.transform.Pass:
     return _ffi_api.FuseTIR()
 
 
+def InlineFusedIntermediates() -> tvm.ir.transform.Pass:
+    """Inline the injective stages of the PrimFuncs fused by FuseTIR, so that the buffers
+    passing data between the stages are no longer allocated. An injective producer read by a
+    single consumer is inlined into it, e.g. a dequantize into the matmul reading it. An
+    injective consumer of a complete block is inlined into it, e.g. a chain of elementwise
+    epilogues. The reduction blocks are never inlined.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass inlining the intermediate stages.
+    """
+    return _ffi_api.InlineFusedIntermediates()
+
+
+def LocalizeFusedIntermediates() -> tvm.ir.transform.Pass:
+    """Move the producer of each buffer passing data between the stages of the PrimFuncs fused
+    by FuseTIR under the deepest loop of its single consumer where it still computes each
+    element once. The lowering then allocates the buffer in that loop, compacted to the region
+    live in an iteration, e.g. one row of the row reduction of a softmax, instead of the full
+    tensor. It is meant to run after :py:func:`InlineFusedIntermediates`.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass moving the producers of the intermediate buffers.
+    """
+    return _ffi_api.LocalizeFusedIntermediates()
+
+
+def PrefetchWeights(
+    scope: str = "global.vtcm",
+    weight_params: Optional[List[str]] = None,
+    max_bytes: int = 0,
+) -> tvm.ir.transform.Pass:
+    """Prefetch the weights of each call_tir to a memory scope of its device during the
+    previous call_tir of the binding block. A relax.prefetch of the weight is started right
+    before the previous kernel, and the kernel reads it through a relax.prefetch_wait. On
+    Hexagon, the copy to the VTCM is a DMA overlapping the previous kernel. The weights are the
+    constants, the results of relax.param_load and the parameters named in weight_params.
+
+    It is meant to run before :py:func:`CallTIRRewrite`, together with the VTCM placement of
+    the hottest intermediates by the ``relax.VMMemoryLower.fast_scope`` and
+    ``relax.VMMemoryLower.fast_capacity`` configs.
+
+    Parameters
+    ----------
+    scope : str
+        The memory scope the weights are copied to.
+
+    weight_params : Optional[List[str]]
+        The names of the function parameters that are weights.
+
+    max_bytes : int
+        The bytes prefetched for a kernel at most, 0 for no limit. The prefetched weights of two
+        kernels are in the scope at a time.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass prefetching the weights.
+    """
+    return _ffi_api.PrefetchWeights(scope, weight_params or [], max_bytes)  # type: ignore
+
+
 def MetaScheduleApplyDatabase(
     work_dir: Optional[str] = None,
+    enable_fallback: bool = True,
 ) -> tvm.ir.transform.Pass:
     """Apply the best schedule from tuning database.
     work_dir : Optional[str]
        work directory to deduce default database if database is not provided
        (it will be ignored when an user passes database)
+    enable_fallback : bool
+       whether to schedule the PrimFuncs without a tuning record, with the best traces of the
+       nearest workloads in the database which differ only in shapes, or else with a sample of
+       the default schedule rules of the target
     Returns
     -------
     ret : tvm.transform.Pass
         The registered pass
     """
-    return _ffi_api.MetaScheduleApplyDatabase(work_dir)
+    return _ffi_api.MetaScheduleApplyDatabase(work_dir, enable_fallback)
 
 
 def MetaScheduleTuneTIR(
@@ -320,6 +840,9 @@ def MetaScheduleTuneIRMod(
     params: Dict[str, NDArray],
     work_dir: str,
     max_trials_global: int,
+    max_tuning_time: Optional[float] = None,
+    convergence_window: int = 0,
+    convergence_threshold: float = 0.0,
 ) -> tvm.ir.transform.Pass:
     """Tune Relax IRModule with MetaSchedule.
     Parameters
@@ -330,11 +853,70 @@ def MetaScheduleTuneIRMod(
        work directory
     max_trials_gloabl: int
        maximum number of total trials allowed for tuning
+    max_tuning_time: Optional[float]
+       wall-clock budget of tuning in seconds, unlimited if not provided
+    convergence_window: int
+       number of the latest trials of a task over which its best latency is checked for
+       convergence, 0 to disable the convergence-based stopping
+    convergence_threshold: float
+       relative improvement over the window at or below which a task is considered converged
+       and its trials go to the other tasks
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+    """
+    return _ffi_api.MetaScheduleTuneIRMod(
+        params,
+        work_dir,
+        max_trials_global,
+        tvm.tir.FloatImm("float64", max_tuning_time or 0.0),
+        convergence_window,
+        tvm.tir.FloatImm("float64", convergence_threshold),
+    )
+
+
+def MetaScheduleTune(
+    work_dir: str,
+    max_trials_global: int,
+    builder: "tvm.meta_schedule.builder.Builder",
+    runner: "tvm.meta_schedule.runner.Runner",
+    max_trials_per_task: Optional[int] = None,
+    num_trials_per_iter: int = 64,
+    cost_model: Optional["tvm.meta_schedule.cost_model.CostModel"] = None,
+) -> tvm.ir.transform.Pass:
+    """Tune the PrimFuncs of a Relax IRModule with MetaSchedule and apply the best schedules.
+    Unlike `MetaScheduleTuneIRMod`, the whole tuning loop runs in C++.
+    Parameters
+    ----------
+    work_dir: str
+       work directory of the tuning database
+    max_trials_global: int
+       maximum number of total trials allowed for tuning
+    builder: tvm.meta_schedule.builder.Builder
+       builder of the measured candidates
+    runner: tvm.meta_schedule.runner.Runner
+       runner of the measured candidates
+    max_trials_per_task: Optional[int]
+       maximum number of trials of each task, max_trials_global if not provided
+    num_trials_per_iter: int
+       number of trials measured in one batch
+    cost_model: Optional[tvm.meta_schedule.cost_model.CostModel]
+       cost model guiding the evolutionary search, replay the traces randomly if not provided
     Returns
     -------
     ret: tvm.ir.transform.Pass
     """
-    return _ffi_api.MetaScheduleTuneIRMod(params, work_dir, max_trials_global)
+    if max_trials_per_task is None:
+        max_trials_per_task = max_trials_global
+    return _ffi_api.MetaScheduleTune(  # type: ignore
+        work_dir,
+        max_trials_global,
+        max_trials_per_task,
+        num_trials_per_iter,
+        builder,
+        runner,
+        cost_model,
+    )
 
 
 def _wrap_class_function_pass(pass_cls, pass_info):
@@ -20,3 +20,5 @@
 from .primitives import *
 from .default_functions import *
 from .database import *
+from .search import *
+from .graph_tuning import *
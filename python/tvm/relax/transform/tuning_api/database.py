@@ -238,11 +238,14 @@ class JSONDatabase(Database):
     path_measurement_record : str
         The path to the path_measurement_record table.
         Manages pairs of <Workload (out_mod), run_secs>
+    concurrent : bool
+        Whether the tables are shared with other processes committing to them.
     """
 
     path_workload: str
     path_tuning_record: str
     path_measurement_record: str
+    concurrent: bool
 
     def __init__(
         self,
@@ -250,6 +253,7 @@ class JSONDatabase(Database):
         path_tuning_record: str,
         path_measurement_record: str,
         allow_missing: bool = True,
+        concurrent: bool = False,
     ) -> None:
         """Constructor.
 
@@ -263,6 +267,10 @@ class JSONDatabase(Database):
             The path to the path_measurement_record table.
         allow_missing : bool
             Whether to create new file when the given path is not found.
+        concurrent : bool
+            Whether the tables are shared with other processes, e.g. parallel tuning jobs writing
+            the same work_dir. If so, every access locks the tables and first loads the records
+            committed by the other processes.
         """
         self.__init_handle_by_constructor__(
             _ffi_api.DatabaseJSONDatabase,  # type: ignore # pylint: disable=no-member
@@ -270,4 +278,5 @@ class JSONDatabase(Database):
             path_tuning_record,
             path_measurement_record,
             allow_missing,
+            concurrent,
         )
@@ -22,6 +22,7 @@ import logging
 import numpy as np
 
 import tvm
+from tvm.ir.instrument import pass_profile_scope
 from tvm.ir.module import IRModule
 from tvm.ir.transform import PassContext, Pass
 from tvm import meta_schedule
@@ -91,7 +92,9 @@ def default_generate_candidate(
                 # Generate new candidate when this condition satisfies.
                 if choice.check_constr(cur_trace.out_mod):
                     new_trace = cur_trace.deepcopy()
-                    new_trace.add(knob, decision)
+                    # Attribute the passes applying the decision to the candidate in the profiles.
+                    with pass_profile_scope(f"tuning_api.candidate[{knob.name}={decision}]"):
+                        new_trace.add(knob, decision)
                     candidates.append(new_trace)
 
     # Expand candidates by using eval passes if provided. This will enable joint-optimization.
@@ -130,7 +133,8 @@ def default_consider_eval_passes(
 
     for trace in init_candidates:
         ctx.push_trace(trace)
-        tvm.transform.Sequential(eval_passes)(trace.out_mod)
+        with pass_profile_scope("tuning_api.eval_passes"):
+            tvm.transform.Sequential(eval_passes)(trace.out_mod)
         new_trace = ctx.pop_trace()
         # A new trace contains the best decisions in eval_passes
         candidates.append(new_trace)
@@ -217,54 +221,79 @@ def default_evaluate(
 
     # Keep track of number of evaluations (mostly for the debugging purpose)
     num_evals = 0
-    # Evaluation
+    # The measurement of each candidate, either fetched from the database or given by the index
+    # of its workload in the batch to measure. Candidates producing the same IRModule share one
+    # workload, so that it is only built and measured once.
+    run_secs_list: List[Optional[List[float]]] = []
+    batch_indices: List[int] = []
+    batch: List[meta_schedule.database.Workload] = []
+    hash_to_index: Dict[int, int] = {}
     for candidate in candidates:
+        run_secs_list.append(None)
+        batch_indices.append(-1)
         # If this candidate is already evaluated, skip the measurement
         if candidate.perf != -1:
             continue
 
-        # Evaluate candidates
         num_evals += 1
-        mod = candidate.out_mod
-        workload = database.commit_workload(mod)
-
+        workload = database.commit_workload(candidate.out_mod)
         # If this workload and target pair has measured before, fetch its data.
         if database.has_measurement_record(workload, target):
-            run_secs = database.get_measurement_record(workload, target)
-        # Otherwise, measure it.
+            run_secs_list[-1] = database.get_measurement_record(workload, target)
         else:
-            # Build candidate
-            (builder_result,) = builder.build([BuilderInput(mod, target, params)])
-
-            if builder_result.artifact_path is None:
-                # Build error
-                # Assign the worst performance and move on to the next candidate.
-                logger.warning(builder_result.error_msg)
-                run_secs = [1e100]
-            else:
-                # If build passes, set up runner input and measure the performance.
-                args_info = [
-                    TensorInfo(shape=[int(i) for i in p.shape], dtype=p.checked_type.dtype)
-                    for p in mod["main"].params
-                ]  # convert list[Var] to list[TensorInfo]
-                runner_input = RunnerInput(
-                    builder_result.artifact_path, target_str, args_info=args_info
-                )
-                (runner_future,) = runner.run([runner_input])
-                runner_result = runner_future.result()
-
-                run_secs = runner_result.run_secs
-                # Runtime error
-                # Assign the worst performance and move on to the next candidate.
-                if runner_result.error_msg is not None:
-                    logger.warning(runner_result.error_msg)
-                    run_secs = [1e100]
-
-                database.commit_measurement_record(workload, target, run_secs)
-
-            # Clean up the artifact
-            f_clean_build(builder_result.artifact_path)
-
+            mod_hash = tvm.ir.structural_hash(workload.mod)
+            if mod_hash not in hash_to_index:
+                hash_to_index[mod_hash] = len(batch)
+                batch.append(workload)
+            batch_indices[-1] = hash_to_index[mod_hash]
+
+    # Build the whole batch at once, so that the builder can compile the candidates in parallel,
+    # e.g., in the process pool of LocalBuilder.
+    # The passes of the builds run in the processes of the builder, only the wall time of the batch
+    # is profiled here.
+    with pass_profile_scope("tuning_api.build"):
+        builder_results = builder.build([BuilderInput(w.mod, target, params) for w in batch])
+
+    # Submit every successful build to the runner before waiting for any of them, so that the
+    # runner can measure them in parallel, e.g., across the devices behind an RPC tracker.
+    runner_futures = []
+    for workload, builder_result in zip(batch, builder_results):
+        if builder_result.artifact_path is None:
+            runner_futures.append(None)
+            continue
+        args_info = [
+            TensorInfo(shape=[int(i) for i in p.shape], dtype=p.checked_type.dtype)
+            for p in workload.mod["main"].params
+        ]  # convert list[Var] to list[TensorInfo]
+        runner_input = RunnerInput(builder_result.artifact_path, target_str, args_info=args_info)
+        (runner_future,) = runner.run([runner_input])
+        runner_futures.append(runner_future)
+
+    batch_run_secs: List[List[float]] = []
+    for workload, builder_result, runner_future in zip(batch, builder_results, runner_futures):
+        if runner_future is None:
+            # Build error
+            # Assign the worst performance and move on to the next candidate.
+            logger.warning(builder_result.error_msg)
+            batch_run_secs.append([1e100])
+            continue
+        runner_result = runner_future.result()
+        run_secs = runner_result.run_secs
+        # Runtime error
+        # Assign the worst performance and move on to the next candidate.
+        if runner_result.error_msg is not None:
+            logger.warning(runner_result.error_msg)
+            run_secs = [1e100]
+        database.commit_measurement_record(workload, target, run_secs)
+        batch_run_secs.append(run_secs)
+        # Clean up the artifact
+        f_clean_build(builder_result.artifact_path)
+
+    for candidate, run_secs, batch_index in zip(candidates, run_secs_list, batch_indices):
+        if candidate.perf != -1:
+            continue
+        if run_secs is None:
+            run_secs = batch_run_secs[batch_index]
         # For valid measurments, compute the average and update the trace performance.
         perfs = []
         for result in run_secs:
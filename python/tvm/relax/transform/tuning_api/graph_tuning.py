@@ -0,0 +1,247 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Relax Tuning Pass API joint search over graph-level decisions with estimated kernel costs.
+
+Graph-level knobs, e.g. the layout or the fusion of the operators, change which kernels exist.
+Measuring every combination end to end requires building and running the whole program each
+time. Instead, the candidates here are lowered by the evaluation passes, and their cost is the
+sum of the estimated cost of their kernels, weighted by their number of call sites. A kernel
+already tuned in a meta_schedule database costs its best measured run time. Otherwise the cost
+model scores a few samples of its design space.
+"""
+from typing import Callable, Dict, List, Optional, Union
+
+import numpy as np
+
+import tvm
+from tvm import meta_schedule
+from tvm.ir import IRModule, structural_hash
+from tvm.ir.transform import Pass, PassContext
+from tvm.target import Target
+from tvm.tir.analysis import estimate_tir_flops
+from .primitives import Knob, Trace
+from .search import evolutionary_search, greedy_search
+from .default_functions import default_generate_candidate, select_best_candidate
+
+
+class KernelCostEstimator:
+    """Estimate the run time of a Relax program from the run time of its kernels.
+
+    Parameters
+    ----------
+    target : Union[Target, str]
+        The compilation target.
+    peak_gflops : float
+        The peak throughput of the target in GFLOPS. The estimated run time of an untuned kernel
+        is its FLOP count divided by the peak, scaled by the best predicted score of its samples.
+    cost_model : Union[str, meta_schedule.CostModel]
+        The cost model scoring the samples of the untuned kernels.
+    database : Optional[meta_schedule.Database]
+        The database of tuned kernels, whose best measured run time is used as is.
+    eval_passes : Optional[List[Pass]]
+        The passes lowering a candidate to its kernels before the estimation.
+    num_samples : int
+        The number of samples of the design space of each untuned kernel.
+    seed : Optional[int]
+        The random seed of the sampling.
+    """
+
+    def __init__(
+        self,
+        target: Union[Target, str],
+        peak_gflops: float,
+        cost_model: Union[str, meta_schedule.CostModel] = "xgb",
+        database: Optional[meta_schedule.Database] = None,
+        eval_passes: Optional[List[Pass]] = None,
+        num_samples: int = 16,
+        seed: Optional[int] = None,
+    ):
+        if peak_gflops <= 0:
+            raise ValueError(f"peak_gflops must be positive, but gets: {peak_gflops}")
+        self.target = target if isinstance(target, Target) else Target(target)
+        self.peak_gflops = peak_gflops
+        if not isinstance(cost_model, meta_schedule.CostModel):
+            cost_model = meta_schedule.CostModel.create(cost_model)
+        self.cost_model = cost_model
+        self.database = database
+        self.eval_passes = eval_passes or []
+        self.num_samples = num_samples
+        self.seed = seed
+        # The estimated run time of each kernel, keyed by its structural hash
+        self._kernel_costs: Dict[int, float] = {}
+
+    def kernel_cost(self, mod: IRModule) -> float:
+        """Estimate the run time of a kernel in seconds.
+
+        Parameters
+        ----------
+        mod : IRModule
+            The normalized kernel, e.g. the `dispatched` module of an extracted task.
+
+        Returns
+        -------
+        cost : float
+            The estimated run time
+        """
+        mod_hash = structural_hash(mod)
+        if mod_hash not in self._kernel_costs:
+            self._kernel_costs[mod_hash] = self._estimate(mod)
+        return self._kernel_costs[mod_hash]
+
+    def _estimate(self, mod: IRModule) -> float:
+        if self.database is not None and self.database.has_workload(mod):
+            records = self.database.get_top_k(self.database.commit_workload(mod), 1)
+            if records and records[0].run_secs:
+                return float(np.mean([float(s) for s in records[0].run_secs]))
+        flops = estimate_tir_flops(mod)
+        if flops <= 0:
+            return 0.0
+        context = meta_schedule.TuneContext(
+            mod=mod,
+            target=self.target,
+            space_generator="post-order-apply",
+            search_strategy=meta_schedule.search_strategy.ReplayTrace(),
+            rand_state=-1 if self.seed is None else self.seed,
+        )
+        context.pre_tuning(self.num_samples, self.num_samples)
+        candidates = context.generate_measure_candidates() or []
+        context.post_tuning()
+        score = 0.0
+        if candidates:
+            score = float(np.max(self.cost_model.predict(context, candidates)))
+        # The normalized score of a sample approximates its throughput relative to the best
+        # schedule, which is bounded by the peak of the target.
+        score = min(max(score, 1e-3), 1.0)
+        return flops / (self.peak_gflops * 1e9 * score)
+
+    def __call__(self, mod: IRModule) -> float:
+        """Estimate the run time of a Relax program in seconds.
+
+        Parameters
+        ----------
+        mod : IRModule
+            The Relax program.
+
+        Returns
+        -------
+        cost : float
+            The sum of the estimated run time of the kernels, weighted by their call sites
+        """
+        if self.eval_passes:
+            mod = tvm.transform.Sequential(self.eval_passes)(mod)
+        tasks = meta_schedule.relax_integration.extract_tasks(mod, self.target)
+        return sum(task.weight * self.kernel_cost(task.dispatched[0]) for task in tasks)
+
+
+def make_estimated_evaluate(estimator: KernelCostEstimator) -> Callable:
+    """Create an evaluation function setting the performance of the candidates to their
+    estimated run time, in place of `default_evaluate`.
+
+    Parameters
+    ----------
+    estimator : KernelCostEstimator
+        The estimator of the run time of a candidate.
+
+    Return
+    ----------
+    f_evaluate : Callable
+        The function evaluating a list of candidates, with the signature of `default_evaluate`.
+    """
+
+    def f_evaluate(
+        candidates: List[Trace],
+        target_str: str,  # pylint: disable=unused-argument
+        params: Optional[Dict[str, np.ndarray]] = None,
+        builder: Optional[meta_schedule.builder.Builder] = None,  # pylint: disable=unused-argument
+        runner: Optional[meta_schedule.runner.Runner] = None,  # pylint: disable=unused-argument
+    ) -> None:
+        num_evals = 0
+        for candidate in candidates:
+            if candidate.perf != -1:
+                continue
+            num_evals += 1
+            mod = candidate.out_mod
+            if params:
+                mod = tvm.relax.transform.BindParams("main", params)(mod)
+            candidate.set_perf(estimator(mod))
+        PassContext.current().inc_num_evals(num_evals)
+
+    return f_evaluate
+
+
+def graph_tune(
+    mod: IRModule,
+    knobs: List[Knob],
+    estimator: KernelCostEstimator,
+    params: Optional[Dict[str, np.ndarray]] = None,
+    *,
+    strategy: str = "exhaustive",
+    max_evals: Optional[int] = None,
+    seed: Optional[int] = None,
+) -> Optional[Trace]:
+    """
+    Jointly search the decisions of graph-level knobs, e.g. the layout and the fusion of the
+    operators, for the lowest end-to-end run time estimated from the kernels they produce. The
+    kernels of the best trace can then be tuned with meta_schedule as usual.
+
+    Parameters
+    ----------
+    mod : IRModule
+        The Relax program.
+    knobs : List[Knob]
+        List of Knobs of the graph-level decisions, applied in order.
+    estimator : KernelCostEstimator
+        The estimator of the run time of a candidate.
+    params: Optional[Dict[str, np.ndarray]]
+        Params to bind.
+    strategy : str
+        The search over the decisions: "exhaustive", "greedy" or "evolutionary".
+    max_evals: Optional[int]
+        The upper bound of `PassContext.current().num_evals` of the greedy and the evolutionary
+        searches. Unlimited if not provided.
+    seed: Optional[int]
+        The random seed of the evolutionary search.
+
+    Return
+    ----------
+    best_trace: Optional[Trace]
+        The best trace found, None if no valid candidate exists.
+    """
+    trace = Trace(mod)
+    target_str = str(estimator.target)
+    f_evaluate = make_estimated_evaluate(estimator)
+    if strategy == "exhaustive":
+        candidates = default_generate_candidate(knobs, trace)
+        if not candidates:
+            return None
+        f_evaluate(candidates, target_str, params)
+        return select_best_candidate(candidates)
+    if strategy == "greedy":
+        return greedy_search(
+            knobs, trace, target_str, params, max_evals=max_evals, f_evaluate=f_evaluate
+        )
+    if strategy == "evolutionary":
+        return evolutionary_search(
+            knobs,
+            trace,
+            target_str,
+            params,
+            max_evals=max_evals,
+            seed=seed,
+            f_evaluate=f_evaluate,
+        )
+    raise ValueError(f"Unknown search strategy: {strategy}")
@@ -0,0 +1,289 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Relax Tuning Pass API search strategies over the decisions of knobs.
+
+Unlike `default_generate_candidate`, which enumerates every combination of decisions, the
+strategies here only evaluate a bounded number of candidates. Every strategy takes the knobs, the
+incoming trace and the arguments of `f_evaluate`, and returns the best trace it has measured. The
+evaluations are counted by the current PassContext, so the budget `max_evals` is shared by all the
+tuning passes of a pipeline.
+"""
+from typing import Callable, Dict, List, Optional, Tuple
+import random
+import sys
+
+import numpy as np
+
+from tvm import meta_schedule
+from tvm.ir.transform import PassContext
+from .primitives import Knob, Trace
+from .default_functions import default_evaluate, select_best_candidate
+
+Decisions = Tuple[str, ...]
+
+
+class _Searcher:
+    """The shared states of a search: the measured candidates and the evaluation budget."""
+
+    def __init__(
+        self,
+        knobs: List[Knob],
+        trace: Trace,
+        target_str: str,
+        params: Optional[Dict[str, np.ndarray]],
+        builder: Optional[meta_schedule.builder.Builder],
+        runner: Optional[meta_schedule.runner.Runner],
+        max_evals: Optional[int],
+        f_evaluate: Callable,
+    ):
+        self.knobs = knobs
+        self.trace = trace
+        self.target_str = target_str
+        self.params = params
+        self.builder = builder
+        self.runner = runner
+        self.max_evals = max_evals
+        self.f_evaluate = f_evaluate
+        # The candidate of each assignment of decisions, None if the assignment is invalid.
+        self.candidates: Dict[Decisions, Optional[Trace]] = {}
+
+    def remaining(self) -> int:
+        if self.max_evals is None:
+            return sys.maxsize
+        return self.max_evals - PassContext.current().num_evals
+
+    def build(self, decisions: Decisions) -> Optional[Trace]:
+        """Apply the decisions on top of the incoming trace, None if a constraint fails."""
+        if decisions in self.candidates:
+            return self.candidates[decisions]
+        candidate = self.trace.deepcopy()
+        for knob, decision in zip(self.knobs, decisions):
+            if not knob.choices[decision].check_constr(candidate.out_mod):
+                candidate = None
+                break
+            candidate.add(knob, decision)
+        self.candidates[decisions] = candidate
+        return candidate
+
+    def evaluate(self, batch: List[Decisions]) -> bool:
+        """Evaluate the new candidates in the batch within the budget.
+
+        Returns False if the budget is exhausted.
+        """
+        traces = []
+        for decisions in dict.fromkeys(batch):
+            candidate = self.build(decisions)
+            if candidate is not None and candidate.perf == -1:
+                traces.append(candidate)
+        budget = self.remaining()
+        if budget <= 0:
+            return False
+        if traces:
+            self.f_evaluate(
+                traces[:budget], self.target_str, self.params, self.builder, self.runner
+            )
+        return len(traces) <= budget
+
+    def perf(self, decisions: Decisions) -> float:
+        candidate = self.candidates.get(decisions)
+        if candidate is None or candidate.perf == -1:
+            return float("inf")
+        return candidate.perf
+
+    def best(self) -> Optional[Trace]:
+        measured = [c for c in self.candidates.values() if c is not None and c.perf != -1]
+        return select_best_candidate(measured) if measured else None
+
+    def first_valid(self) -> Optional[Decisions]:
+        """Pick the first decision of each knob whose constraint holds."""
+        decisions: Tuple[str, ...] = ()
+        candidate = self.trace.deepcopy()
+        for knob in self.knobs:
+            for decision in knob.choices.keys():
+                if knob.choices[decision].check_constr(candidate.out_mod):
+                    candidate.add(knob, decision)
+                    decisions = decisions + (str(decision),)
+                    break
+            else:
+                return None
+        self.candidates[decisions] = candidate
+        return decisions
+
+
+def greedy_search(
+    knobs: List[Knob],
+    trace: Trace,
+    target_str: str,
+    params: Optional[Dict[str, np.ndarray]] = None,
+    builder: Optional[meta_schedule.builder.Builder] = None,
+    runner: Optional[meta_schedule.runner.Runner] = None,
+    *,
+    max_evals: Optional[int] = None,
+    max_rounds: int = 2,
+    f_evaluate: Callable = default_evaluate,
+) -> Optional[Trace]:
+    """
+    Greedy coordinate descent over the decisions of the knobs. Starting from the first valid
+    decision of each knob, it tries every decision of one knob at a time while keeping the others
+    at their best decisions so far. Each round costs the sum of the number of choices rather than
+    their product.
+
+    Parameters
+    ----------
+    knobs : List[Knob]
+        List of Knobs to tune, applied in order.
+    trace: Trace
+        Input trace.
+    target_str: str,
+        Compilation target (e.g., llvm, cuda).
+    params: Optional[Dict[str, np.ndarray]]
+        Params to bind.
+    builder: Optional[meta_schedule.builder.Builder]
+        builder function, passed to `f_evaluate`.
+    runner: Optional[meta_schedule.runner.Runner]
+        runner function, passed to `f_evaluate`.
+    max_evals: Optional[int]
+        The upper bound of `PassContext.current().num_evals`. Unlimited if not provided.
+    max_rounds: int
+        The maximum number of sweeps over all the knobs. It stops earlier if a sweep makes no
+        improvement.
+    f_evaluate: Callable
+        The function that evaluates a list of candidates.
+
+    Return
+    ----------
+    best_trace: Optional[Trace]
+        The best trace measured, None if no valid candidate is found within the budget.
+    """
+    searcher = _Searcher(knobs, trace, target_str, params, builder, runner, max_evals, f_evaluate)
+    current = searcher.first_valid()
+    if current is None or not searcher.evaluate([current]):
+        return searcher.best()
+    for _ in range(max_rounds):
+        improved = False
+        for i, knob in enumerate(knobs):
+            batch = [current[:i] + (str(d),) + current[i + 1 :] for d in knob.choices.keys()]
+            has_budget = searcher.evaluate(batch)
+            best = min(batch, key=searcher.perf)
+            if searcher.perf(best) < searcher.perf(current):
+                current = best
+                improved = True
+            if not has_budget:
+                return searcher.best()
+        if not improved:
+            break
+    return searcher.best()
+
+
+def evolutionary_search(
+    knobs: List[Knob],
+    trace: Trace,
+    target_str: str,
+    params: Optional[Dict[str, np.ndarray]] = None,
+    builder: Optional[meta_schedule.builder.Builder] = None,
+    runner: Optional[meta_schedule.runner.Runner] = None,
+    *,
+    max_evals: Optional[int] = None,
+    population_size: int = 8,
+    num_generations: int = 4,
+    mutation_prob: float = 0.2,
+    seed: Optional[int] = None,
+    f_evaluate: Callable = default_evaluate,
+) -> Optional[Trace]:
+    """
+    Evolutionary search over the decisions of the knobs. Each generation breeds children from the
+    measured population by tournament selection, uniform crossover and mutation, measures them as
+    a batch and keeps the best `population_size` assignments.
+
+    Parameters
+    ----------
+    knobs : List[Knob]
+        List of Knobs to tune, applied in order.
+    trace: Trace
+        Input trace.
+    target_str: str,
+        Compilation target (e.g., llvm, cuda).
+    params: Optional[Dict[str, np.ndarray]]
+        Params to bind.
+    builder: Optional[meta_schedule.builder.Builder]
+        builder function, passed to `f_evaluate`.
+    runner: Optional[meta_schedule.runner.Runner]
+        runner function, passed to `f_evaluate`.
+    max_evals: Optional[int]
+        The upper bound of `PassContext.current().num_evals`. Unlimited if not provided.
+    population_size: int
+        The number of assignments kept and bred in each generation.
+    num_generations: int
+        The number of generations after the initial population.
+    mutation_prob: float
+        The probability of resampling the decision of each knob in a child.
+    seed: Optional[int]
+        The random seed.
+    f_evaluate: Callable
+        The function that evaluates a list of candidates.
+
+    Return
+    ----------
+    best_trace: Optional[Trace]
+        The best trace measured, None if no valid candidate is found within the budget.
+    """
+    rng = random.Random(seed)
+    searcher = _Searcher(knobs, trace, target_str, params, builder, runner, max_evals, f_evaluate)
+    choices = [[str(d) for d in knob.choices.keys()] for knob in knobs]
+    max_tries = population_size * 4
+
+    def f_sample(f_make: Callable[[], Decisions]) -> List[Decisions]:
+        children: List[Decisions] = []
+        for _ in range(max_tries):
+            if len(children) == population_size:
+                break
+            child = f_make()
+            is_new = child not in searcher.candidates and child not in children
+            if is_new and searcher.build(child) is not None:
+                children.append(child)
+        return children
+
+    population = [d for d in [searcher.first_valid()] if d is not None]
+    population += f_sample(lambda: tuple(rng.choice(c) for c in choices))
+    if not searcher.evaluate(population):
+        return searcher.best()
+
+    def f_tournament() -> Decisions:
+        a, b = rng.choice(population), rng.choice(population)
+        return a if searcher.perf(a) <= searcher.perf(b) else b
+
+    def f_breed() -> Decisions:
+        parent_a, parent_b = f_tournament(), f_tournament()
+        child = []
+        for i, decisions in enumerate(choices):
+            decision = parent_a[i] if rng.random() < 0.5 else parent_b[i]
+            if rng.random() < mutation_prob:
+                decision = rng.choice(decisions)
+            child.append(decision)
+        return tuple(child)
+
+    for _ in range(num_generations):
+        if not population:
+            break
+        children = f_sample(f_breed)
+        if not children:
+            break
+        has_budget = searcher.evaluate(children)
+        population = sorted(population + children, key=searcher.perf)[:population_size]
+        if not has_budget:
+            break
+    return searcher.best()
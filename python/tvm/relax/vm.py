@@ -16,7 +16,12 @@
 # under the License.
 # pylint: disable=invalid-name, redefined-builtin, no-else-return
 """The Relax virtual machine"""
-from typing import Callable, List, Optional, Union, Dict, Tuple
+from typing import Any, Callable, List, Optional, Union, Dict, Tuple
+import hashlib
+import json
+import logging
+import os
+import threading
 import numpy as np
 
 from tvm._ffi import base as _base
@@ -26,6 +31,7 @@ from tvm.ir.module import IRModule
 from tvm.relay import Any
 from tvm.runtime import Device, Module, PackedFunc, container
 from tvm.runtime.object import Object
+from tvm.runtime.profiling import Report
 from tvm.tir.function import PrimFunc
 from . import _ffi_api
 from ..rpc.base import RPC_SESS_MASK
@@ -52,18 +58,63 @@ class Executable(object):
         """print the instructions as python program."""
         return self._as_python()
 
+    def set_constant_codec(self, codec: str, min_bytes: int = 4096) -> None:
+        """Compress the NDArray constants when the executable is saved.
+
+        The constants are decompressed in parallel when the executable is loaded. The
+        compressed constants are read into memory rather than mapped from the file.
+
+        Parameters
+        ----------
+        codec : str
+            The codec, can be ["none", "lz", "fp16"]. The "lz" codec is lossless. The "fp16"
+            codec is lossy, saving the float32 constants as float16, and ignoring the others.
+
+        min_bytes : int
+            The minimum size of the constants to compress.
+        """
+        self.mod["set_constant_codec"](codec, min_bytes)
+
+    @staticmethod
+    def section_table(path: str) -> List[Dict[str, Any]]:
+        """Read the section table of a saved executable without loading its sections.
+
+        Parameters
+        ----------
+        path : str
+            The path of the executable file.
+
+        Returns
+        -------
+        table : List[Dict[str, Any]]
+            The name, the offset in the file, the size and the checksum of each section.
+        """
+        return json.loads(tvm.get_global_func("runtime.relax_vm.ExecutableSectionTable")(path))
+
 
 class VirtualMachine(object):
     """Relax VM runtime."""
 
     NAIVE_ALLOCATOR = 1
     POOLED_ALLOCATOR = 2
+    BEST_FIT_ALLOCATOR = 3
+    LOCAL_POOLED_ALLOCATOR = 4
+    BUDGETED_ALLOCATOR = 5
+    STREAM_ORDERED_ALLOCATOR = 6
+
+    SWITCH_DISPATCH = 0
+    THREADED_DISPATCH = 1
 
     def __init__(
         self,
         exec: Union[Executable, Module],
         device: Union[Device, List[Device]],
         memory_cfg: Optional[Union[str, Dict[Device, str]]] = None,
+        dispatch_mode: str = "switch",
+        share_constants: bool = False,
+        localize_constants: bool = False,
+        unchecked_kernels: bool = False,
+        async_input_copy: bool = False,
     ) -> None:
         """
         Construct a VirtualMachine wrapper object.
@@ -78,26 +129,156 @@ class VirtualMachine(object):
 
         memory_cfg : Optional[Union[str, Dict[Device, str]]]
             Config the type of memory allocator. The allocator type can be ["naive",
-            "pooled"]. If memory_cfg is None, all devices will use pooled allocator
-            by default. If memory_cfg is string, all devices will use the specified
-            allocator type. If memory_cfg is a dict, each device uses the allocator
-            type specified in the dict, or pooled allocator if not specified in the
-            dict.
+            "pooled", "best_fit", "local_pooled", "budgeted", "stream_ordered"]. The
+            "local_pooled" allocator is owned by the VM and each of its sessions, which allocate
+            without taking locks. The "budgeted" allocator is owned in the same way and keeps the
+            memory of the device within the budget given to :py:meth:`set_memory_budget`. The
+            "stream_ordered" allocator of CUDA devices allocates with cudaMallocAsync, which does
+            not synchronize the device, see :py:func:`tvm.runtime.config_cuda_mem_pool`. If
+            memory_cfg is
+            None, all devices will use pooled allocator by default. If memory_cfg is string,
+            all devices will use the specified allocator type. If memory_cfg is a dict, each
+            device uses the allocator type specified in the dict, or pooled allocator if not
+            specified in the dict.
+
+        dispatch_mode : str
+            The instruction dispatch strategy of the interpreter, can be ["switch",
+            "threaded"]. The threaded mode jumps directly between instruction handlers,
+            which lowers the interpreter overhead between small kernels.
+
+        share_constants : bool
+            Whether the device copies of the NDArray constants are shared, through a
+            process-wide cache keyed by their contents, with the other VMs sharing them, such as
+            the VMs of the variants of a model built with the same weights. The kernels must not
+            write to the constants. See :py:func:`shared_constant_stats`.
+
+        localize_constants : bool
+            Whether the NDArray constants used on the CPU are copied into the memory allocated
+            by the calling thread, rather than read from the executable. After
+            :py:func:`tvm.runtime.config_threadpool_numa_node`, the copies are placed on the
+            NUMA node of the thread, so that the VMs serving from each node read a local
+            replica of the weights. It cannot be combined with share_constants.
+
+        unchecked_kernels : bool
+            Whether the kernels are called through the entries generated without the checks
+            of their arguments, when the library was built with the pass config
+            `tir.make_unchecked_api`. The shapes and the types of the arguments are trusted to
+            be verified by the compiler, so a mismatch is undefined behavior.
+
+        async_input_copy : bool
+            Whether the inputs given to :py:meth:`set_input` are copied to the device on a
+            stream of their own, so that the upload of the inputs of the next request overlaps
+            the stateful call of the previous one. :py:meth:`invoke_stateful` waits for the
+            copies on the device. The inputs in page-locked host memory must stay unchanged
+            until the call. It has no effect on the devices without streams.
         """
-        self.module = (
+        self._bind_module(
             exec.mod["vm_load_executable"]()
             if isinstance(exec, Executable)
             else exec["vm_load_executable"]()
         )
+        self._setup_device(device, memory_cfg)
+        self._set_dispatch_mode(dispatch_mode)
+        if share_constants:
+            self.module["share_constants"]()
+        if localize_constants:
+            self.module["localize_constants"]()
+        if unchecked_kernels:
+            self.module["set_unchecked_kernels"](True)
+        if async_input_copy:
+            self.module["set_async_input_copy"](True)
+
+    def _bind_module(self, module: Module) -> None:
+        """bind the wrapper to a VM runtime module."""
+        self.module = module
         self._invoke_closure = self.module["invoke_closure"]
         self._save_function = self.module["save_function"]
         self._set_input = self.module["set_input"]
+        self._set_input_borrowed = self.module["set_input_borrowed"]
         self._invoke_stateful = self.module["invoke_stateful"]
         self._get_output = self.module["get_output"]
         self._get_output_arity = self.module["get_output_arity"]
         self._get_function_arity = self.module["get_function_arity"]
         self._get_function_param_name = self.module["get_function_param_name"]
-        self._setup_device(device, memory_cfg)
+
+    def create_session(self) -> "VirtualMachine":
+        """Create a new session of the virtual machine.
+
+        The session shares the loaded executable and the device-resident constants
+        with this VM but has its own execution state, so that different sessions can
+        serve requests concurrently on different threads. Each session must only be
+        used by one thread at a time.
+
+        Returns
+        -------
+        session : VirtualMachine
+            The new session.
+        """
+        session = VirtualMachine.__new__(VirtualMachine)
+        session._bind_module(self.module["create_session"]())
+        session.devices = self.devices
+        return session
+
+    def hot_reload(
+        self, exec: Union[Executable, Module], upload_constants: bool = True
+    ) -> Dict[str, int]:
+        """Replace the executable of the VM, such as a new build of its model, without
+        recreating the VM.
+
+        The new program is prepared aside, then swapped in at once. The NDArray constants of the
+        new executable equal to constants of the previous one already on their devices reuse
+        their device copies, so that the weights unchanged by a rebuild are neither copied again
+        nor held twice. The sessions created before keep running the previous program, whose
+        constants are freed with the last of them, and the sessions created after run the new
+        one. The VM itself must not run a call meanwhile.
+
+        The inputs and outputs set for :py:meth:`invoke_stateful`, the captured graphs, the
+        saved functions and the shape specializations of the previous program are dropped.
+
+        Parameters
+        ----------
+        exec: Union[Executable, Module]
+            The new executable.
+
+        upload_constants : bool
+            Whether the other constants are copied to their devices before the swap rather than
+            on first use, so that the first calls run without uploads.
+
+        Returns
+        -------
+        stats : Dict[str, int]
+            The number of the constants of the new executable, of the reused ones and their
+            bytes, and of the uploaded ones and their bytes, as num_constants, num_reused,
+            reused_bytes, num_uploaded and uploaded_bytes.
+        """
+        exec_mod = exec.mod if isinstance(exec, Executable) else exec
+        return json.loads(self.module["hot_reload"](exec_mod, upload_constants))
+
+    def _set_dispatch_mode(self, dispatch_mode: str) -> None:
+        """set the instruction dispatch strategy."""
+        modes = {
+            "switch": VirtualMachine.SWITCH_DISPATCH,
+            "threaded": VirtualMachine.THREADED_DISPATCH,
+        }
+        if dispatch_mode not in modes:
+            raise ValueError(
+                "dispatch_mode is expected to be one of {}, but received {}".format(
+                    list(modes.keys()), dispatch_mode
+                )
+            )
+        self.module["set_dispatch_mode"](modes[dispatch_mode])
+
+    def set_thread_pool(self, name: str) -> None:
+        """Run the parallel kernels called by the VM on a named thread pool.
+
+        Parameters
+        ----------
+        name : str
+            The name of a pool given to :py:func:`tvm.runtime.create_thread_pool`, or empty to
+            use the default pool of the calling thread. The sessions created afterwards
+            inherit it.
+        """
+        self.module["set_thread_pool"](name)
 
     def _setup_device(self, dev: Device, memory_cfg: Union[str, Dict[Device, str]]) -> None:
         """init devices and allocators."""
@@ -119,13 +300,20 @@ class VirtualMachine(object):
         if devs[-1].device_type % RPC_SESS_MASK != tvm.cpu().device_type:
             devs.append(tvm.cpu())
 
+        alloc_types = {
+            "naive": VirtualMachine.NAIVE_ALLOCATOR,
+            "pooled": VirtualMachine.POOLED_ALLOCATOR,
+            "best_fit": VirtualMachine.BEST_FIT_ALLOCATOR,
+            "local_pooled": VirtualMachine.LOCAL_POOLED_ALLOCATOR,
+            "budgeted": VirtualMachine.BUDGETED_ALLOCATOR,
+            "stream_ordered": VirtualMachine.STREAM_ORDERED_ALLOCATOR,
+        }
         default_alloc_type = VirtualMachine.POOLED_ALLOCATOR
         if memory_cfg is None:
             memory_cfg = {}
         elif isinstance(memory_cfg, str):
-            assert memory_cfg in ["naive", "pooled"]
-            if memory_cfg == "naive":
-                default_alloc_type = VirtualMachine.NAIVE_ALLOCATOR
+            assert memory_cfg in alloc_types
+            default_alloc_type = alloc_types[memory_cfg]
             memory_cfg = {}
         elif not isinstance(memory_cfg, dict):
             raise TypeError(
@@ -136,10 +324,281 @@ class VirtualMachine(object):
         for device in devs:
             init_args.append(device.device_type % RPC_SESS_MASK)
             init_args.append(device.device_id)
-            alloc_type = memory_cfg[device] if device in memory_cfg else default_alloc_type
+            alloc_type = default_alloc_type
+            if device in memory_cfg:
+                assert memory_cfg[device] in alloc_types
+                alloc_type = alloc_types[memory_cfg[device]]
             init_args.append(alloc_type)
+        self.devices = devs
         self.module["vm_initialization"](*init_args)
 
+    def memory_stats(self) -> Dict[Device, Dict[str, Union[int, float]]]:
+        """Get the counters of the memory allocators used by the VM.
+
+        Returns
+        -------
+        stats : Dict[Device, Dict[str, Union[int, float]]]
+            The counters of the allocator on each device, including bytes_in_use,
+            bytes_cached, peak_bytes_in_use, hit_rate and fragmentation. The fragmentation
+            is the share of the cached bytes outside the largest cached block.
+        """
+        memory_stats = self.module["memory_stats"]
+        return {dev: json.loads(memory_stats(i)) for i, dev in enumerate(self.devices)}
+
+    def func_table_stats(self) -> Dict[str, Any]:
+        """Get the functions of the executable resolved so far.
+
+        The functions, including the kernels of the library, are only looked up when they are
+        first called, so the kernels of the entry points that never run are not loaded.
+
+        Returns
+        -------
+        stats : Dict[str, Any]
+            The number of functions, the number and the names of the resolved ones, the time
+            spent resolving them in milliseconds, and the number of Relax functions running
+            their compiled code, as num_functions, num_resolved, resolved, resolve_time_ms and
+            num_compiled.
+        """
+        return json.loads(self.module["func_table_stats"]())
+
+    def warmup(self, func_name: str, *args: Any) -> Object:
+        """Run a function once on representative inputs, recording the storages it allocates
+        and the kernels it resolves into the runtime profile of :py:meth:`runtime_profile`.
+
+        The function can be warmed up several times, with different input shapes, the
+        profile covering all of the runs.
+
+        Parameters
+        ----------
+        func_name : str
+            The name of the function.
+
+        args : List[Any]
+            The arguments to the function.
+
+        Returns
+        -------
+        ret : Object
+            The output of the function.
+        """
+        self.module["set_storage_recording"](True)
+        try:
+            return self[func_name](*args)
+        finally:
+            self.module["set_storage_recording"](False)
+
+    def profile(
+        self,
+        func_name: str,
+        *args: Any,
+        collectors: Optional[List["tvm.runtime.profiling.MetricCollector"]] = None,
+    ) -> "tvm.runtime.profiling.Report":
+        """Profile the packed calls of a function, the kernels and the builtins it calls.
+
+        The function is run once to warm up, then once more, timing each packed call on the
+        device of its first tensor argument. The metric collectors, e.g. the
+        PAPIMetricCollector, add their metrics to each call. The report can be extended with
+        the roofline metrics of :py:func:`tvm.utils.roofline.roofline_from_counters`.
+
+        The VM may be remote, the report is then serialized by the remote and deserialized
+        here, and cannot have collectors. Reports of two builds can be compared with
+        :py:meth:`tvm.runtime.profiling.Report.diff`.
+
+        Parameters
+        ----------
+        func_name : str
+            The name of the function.
+
+        args : List[Any]
+            The arguments to the function.
+
+        collectors : Optional[List[MetricCollector]]
+            The collectors of the additional metrics of each call, must be None over RPC.
+
+        Returns
+        -------
+        report : tvm.runtime.profiling.Report
+            The per call and per device metrics of the run.
+        """
+        cargs: List[Any] = []
+        for arg in args:
+            self._convert(arg, cargs)
+        if self.module.type_key == "rpc":
+            # the metric collectors and the report cannot be sent over RPC
+            if collectors is not None:
+                raise ValueError("Profiling with collectors is not supported over RPC")
+            return Report.from_json(self.module["profile_rpc"](func_name, *cargs))
+        return self.module["profile"](func_name, collectors, *cargs)
+
+    def runtime_profile(self) -> Dict[str, Any]:
+        """Get the runtime profile recorded by :py:meth:`warmup`.
+
+        Returns
+        -------
+        profile : Dict[str, Any]
+            The names of the functions resolved so far as functions, and for each device in the
+            order of the VM devices the sizes of the distinct buffers allocated during the
+            warmups as storage, with the peak bytes in use of their allocator as peak_bytes_in_use.
+        """
+        memory_stats = self.module["memory_stats"]
+        devices = []
+        for i in range(len(self.devices)):
+            stats = json.loads(memory_stats(i))
+            devices.append(
+                {
+                    "storage": [int(x) for x in self.module["recorded_storage"](i)],
+                    "peak_bytes_in_use": stats["peak_bytes_in_use"],
+                }
+            )
+        return {"functions": self.func_table_stats()["resolved"], "devices": devices}
+
+    def save_runtime_profile(self, path: str) -> None:
+        """Save the runtime profile recorded by :py:meth:`warmup` as a JSON file, usually
+        next to the exported executable.
+
+        Parameters
+        ----------
+        path : str
+            The path of the profile.
+        """
+        with open(path, "w") as f:
+            json.dump(self.runtime_profile(), f)
+
+    def load_runtime_profile(self, path: str) -> None:
+        """Apply a runtime profile saved by :py:meth:`save_runtime_profile`, resolving its
+        functions and reserving its storages in the allocators of the devices so that the
+        first calls do not pay for them. The devices whose allocator does not cache the freed
+        buffers, such as the "naive" one, are not preallocated.
+
+        Parameters
+        ----------
+        path : str
+            The path of the profile.
+        """
+        with open(path, "r") as f:
+            profile = json.load(f)
+        self.module["preload_functions"](*profile["functions"])
+        for i, device in enumerate(profile["devices"][: len(self.devices)]):
+            if device["storage"]:
+                self.module["reserve_storage"](i, tvm.runtime.ShapeTuple(device["storage"]))
+
+    def enable_shape_specialization(
+        self,
+        mod: IRModule,
+        target: Union[str, tvm.target.Target],
+        threshold: int = 8,
+        background: bool = True,
+    ) -> None:
+        """Specialize the functions to their hot input shapes.
+
+        The calls of the functions are counted by the shapes of their NDArray arguments. Once
+        the calls with some shapes reach the threshold, a variant of the function specialized
+        to them by :py:func:`relax.transform.SpecializeShapes` is built, and runs the later
+        calls with these shapes.
+
+        Parameters
+        ----------
+        mod : IRModule
+            The module this VM was built from.
+
+        target : Union[str, tvm.target.Target]
+            The target to build the variants for.
+
+        threshold : int
+            The number of calls with the same shapes making them hot, 0 to stop specializing.
+
+        background : bool
+            Whether the variants are built on a background thread, the calls running the
+            generic function until they are ready, or by the call reaching the threshold.
+        """
+
+        def build_variant(func_name, shapes):
+            try:
+                variant_mod = relax.transform.SpecializeShapes(func_name, shapes)(mod)
+                variant = VirtualMachine(build(variant_mod, target), self.devices)
+                self.module["add_specialization"](func_name, shapes, variant.module[func_name])
+            except Exception:  # pylint: disable=broad-except
+                logging.warning(
+                    "Failed to specialize %s to the shapes %s", func_name, shapes, exc_info=True
+                )
+
+        def on_hot(func_name, shapes):
+            if background:
+                thread = threading.Thread(target=build_variant, args=(func_name, shapes))
+                thread.daemon = True
+                thread.start()
+            else:
+                build_variant(func_name, shapes)
+
+        self.module["set_shape_specialization"](threshold, on_hot)
+
+    def specialization_stats(self) -> Dict[str, Dict[str, Dict[str, Any]]]:
+        """Get the calls of each function by shape signature, counted since
+        :py:meth:`enable_shape_specialization`.
+
+        Returns
+        -------
+        stats : Dict[str, Dict[str, Dict[str, Any]]]
+            For each function and each shape signature, the shapes of its NDArray arguments like
+            "4x8,8", the number of calls and whether a specialized variant runs them, as calls
+            and specialized.
+        """
+        return json.loads(self.module["specialization_stats"]())
+
+    def set_memory_budget(
+        self, device: Device, budget: int, spill_threshold: Optional[int] = None
+    ) -> None:
+        """Keep the memory of a device using the "budgeted" allocator within a budget.
+
+        Once the budget is reached, the cached free buffers are released least recently
+        freed first. If the tensors in use still exceed the budget, the storages of at least
+        spill_threshold bytes held only by the VM are copied to the (pinned) host memory, the
+        least recently defined first, and copied back to the device when they are used again.
+        The numbers of spills and reloads are reported by :py:meth:`memory_stats`.
+
+        Parameters
+        ----------
+        device : Device
+            The device, which must use the "budgeted" allocator.
+
+        budget : int
+            The bytes the allocator of the device can reserve, 0 for no budget.
+
+        spill_threshold : Optional[int]
+            The minimum size of the storages to spill, None to never spill. The storages of
+            CPU devices are never spilled.
+        """
+        if device not in self.devices:
+            raise ValueError("{} is not a device of the VM".format(device))
+        spill_threshold = -1 if spill_threshold is None else spill_threshold
+        self.module["set_memory_budget"](self.devices.index(device), budget, spill_threshold)
+
+    def set_communicator(self, communicator: Object) -> None:
+        """Set the communicator of the rank of the VM in its group, used by the collectives of
+        :py:mod:`tvm.relax.op.ccl`, see :py:func:`tvm.relax.tensor_parallel.create_group`.
+
+        The communicator is not shared with the sessions created from the VM.
+
+        Parameters
+        ----------
+        communicator : Object
+            The communicator.
+        """
+        self.module["set_communicator"](communicator)
+
+    def set_param_store(self, store: "tvm.relax.param_store.ParamStore") -> None:
+        """Set the store the params externalized by
+        :py:func:`tvm.relax.transform.ExternalizeParams` are loaded from.
+
+        The store is shared with the sessions created afterwards.
+
+        Parameters
+        ----------
+        store : tvm.relax.param_store.ParamStore
+            The store, opened on the device of the VM.
+        """
+        self.module["set_param_store"](store)
+
     def __getitem__(self, key: str) -> PackedFunc:
         return self.module[key]
 
@@ -295,6 +754,39 @@ class VirtualMachine(object):
 
         self._set_input(func_name, *cargs)
 
+    def set_input_borrowed(self, func_name: str, *args: Any, **kwargs: Any) -> None:
+        """Set the inputs to a function without copying them.
+
+        Unlike `set_input`, the tensor arguments are never copied: the function reads
+        directly from their memory, so they must reside on the device of the VM or in
+        page-locked host memory it can address. Objects implementing the DLPack protocol
+        (e.g. numpy arrays or framework tensors) are imported zero-copy. The caller must
+        keep the arguments alive and unchanged while the function runs.
+
+        Setting the same buffers again reuses the previous binding, so steady-state
+        serving loops only pay for the arguments that actually changed.
+
+        Parameters
+        ----------
+        func_name : str
+            The name of the function.
+        args: List[tvm.runtime.NDArray] or List[DLPack compatible tensor]
+            The arguments to the function.
+        kwargs: dict of str to tvm.runtime.NDArray or DLPack compatible tensor
+            Named arguments to the function.
+        """
+        cargs = []
+
+        if kwargs:
+            args = self._convert_func_named_args(func_name, args, **kwargs)
+
+        for arg in args:
+            if not isinstance(arg, (Object, tvm.runtime.NDArray)) and hasattr(arg, "__dlpack__"):
+                arg = tvm.nd.from_dlpack(arg)
+            self._convert(arg, cargs)
+
+        self._set_input_borrowed(func_name, *cargs)
+
     def invoke_stateful(self, func_name: str) -> None:
         """
         Call the named function from the VM module using the arguments set using `set_input`.
@@ -311,6 +803,107 @@ class VirtualMachine(object):
         """
         self._invoke_stateful(func_name)
 
+    def invoke_batched(
+        self,
+        func_name: str,
+        requests: List[List[Any]],
+        batch_axis: int = 0,
+        output_batch_axes: Optional[List[Optional[int]]] = None,
+    ) -> List[Object]:
+        """
+        Invoke the named function once on a batch of requests.
+
+        The arguments that differ across requests are concatenated along the batch axis, so
+        the function is expected to have a symbolic extent there. Arguments passed as the same
+        tensor object to every request (e.g. weights) are not batched, even when they are
+        copied to the device. The outputs are split back
+        along their batch axes, into zero-copy views when the axis is 0.
+
+        Parameters
+        ----------
+        func_name: str
+            The name of the function to call.
+
+        requests: List[List[Any]]
+            The arguments of each request, which must all be tensors.
+
+        batch_axis: int
+            The axis the arguments of the requests are concatenated along.
+
+        output_batch_axes: Optional[List[Optional[int]]]
+            The batch axis of each output tensor, in the depth-first order of the output
+            tuples, None for the outputs shared by all the requests. By default all the output
+            tensors are split along batch_axis.
+
+        Returns
+        -------
+        ret: List[Object]
+            The outputs of each request.
+        """
+        if batch_axis < 0:
+            raise ValueError("The batch axis must be non-negative, but got {}".format(batch_axis))
+        output_axes = []
+        for axis in output_batch_axes or []:
+            if axis is not None and axis < 0:
+                raise ValueError("The output batch axes must be non-negative, but got " + str(axis))
+            output_axes.append(-1 if axis is None else axis)
+        cargs = []
+        # A numpy array passed to every request is converted once, so it stays shared.
+        converted = {}
+        for i, request in enumerate(requests):
+            for arg in request:
+                if not isinstance(arg, (tvm.runtime.NDArray, np.ndarray)):
+                    raise TypeError(
+                        "Batched calls only take tensor arguments, but request {} has an "
+                        "argument of type {}".format(i, type(arg))
+                    )
+                if isinstance(arg, np.ndarray):
+                    if id(arg) not in converted:
+                        converted[id(arg)] = (arg, tvm.nd.array(arg, device=tvm.cpu(0)))
+                    arg = converted[id(arg)][1]
+                cargs.append(arg)
+        return list(
+            self.module["invoke_batched"](
+                func_name, batch_axis, tvm.runtime.ShapeTuple(output_axes), *cargs
+            )
+        )
+
+    def capture_cuda_graph(self, func_name: str) -> None:
+        """
+        Capture the kernels launched by the named function into a CUDA graph, using the
+        arguments set by `set_input`. The function is run once before being captured.
+        After the capture, `run_cuda_graph` copies the arguments set by `set_input` into
+        the captured input buffers and replays the graph with a single launch.
+
+        A graph is only valid for the shapes of the inputs it was captured with, since the
+        host-side shape computation is not replayed by the graph. A graph is therefore kept
+        for each shape signature of the inputs. Only functions whose other work entirely
+        runs on the CUDA device can be captured.
+
+        When the first device of the VM is a Vulkan device, the kernels are recorded into a
+        Vulkan command buffer instead, which is replayed with a single queue submission.
+
+        Parameters
+        ----------
+        func_name: str
+            The name of the function to capture.
+        """
+        self.module["capture_cuda_graph"](func_name)
+
+    def run_cuda_graph(self, func_name: str) -> None:
+        """
+        Replay the CUDA graph captured from the named function for the shapes of its
+        current inputs, capturing one first when there is none for these shapes. The results
+        can be obtained by calling `get_outputs`, and are overwritten by the next replay of
+        the same graph.
+
+        Parameters
+        ----------
+        func_name: str
+            The name of the captured function.
+        """
+        self.module["run_cuda_graph"](func_name)
+
     def get_outputs(self, func_name: str) -> Union[tvm.Object, Tuple[Any]]:
         """
         Get the value output by the function by the given name
@@ -351,6 +944,8 @@ class VirtualMachine(object):
         cooldown_interval_ms=0,
         repeats_to_cooldown=1,
         f_preproc="",
+        max_repeat=None,
+        max_relative_error=0.01,
     ) -> Callable[..., tvm.runtime.module.BenchmarkResult]:
         """
         Returns an evaluator that times a function in the module.
@@ -395,6 +990,14 @@ class VirtualMachine(object):
         f_preproc: str, optional
             The preprocess function name we want to execute before executing the time evaluator.
 
+        max_repeat: Optional[int]
+            If set, measure statistically until the mean cost is known precisely enough, see
+            :py:meth:`tvm.runtime.Module.time_evaluator`.
+
+        max_relative_error: float, optional
+            The target standard error of the mean cost of the statistical measurement, relative
+            to it.
+
         Note
         ----
         The function will be invoked  (1 + number x repeat) times,
@@ -448,13 +1051,30 @@ class VirtualMachine(object):
             cooldown_interval_ms=cooldown_interval_ms,
             repeats_to_cooldown=repeats_to_cooldown,
             f_preproc=f_preproc,
+            max_repeat=max_repeat,
+            max_relative_error=max_relative_error,
         )
 
 
+def shared_constant_stats() -> Dict[str, int]:
+    """Get the device copies of the constants shared by the VMs created with share_constants.
+
+    Returns
+    -------
+    stats : Dict[str, int]
+        The number of the shared copies, the number of the VMs using each of them in total, and
+        their size in bytes, as num_constants, num_uses and bytes.
+    """
+    return json.loads(tvm.get_global_func("runtime.relax_vm.SharedConstantStats")())
+
+
 def build(
     mod: tvm.IRModule,
     target: Union[str, tvm.target.Target],
     params: Optional[Dict[str, list]] = None,
+    cache_dir: Optional[str] = None,
+    num_tir_shards: int = 1,
+    exec_mode: str = "bytecode",
 ) -> Executable:
     """
     Build an IRModule to VM executable.
@@ -477,10 +1097,32 @@ def build(
     params: Optional[Dict[str, list]]
         Parameters for the input IRModule that will be bound.
 
+    cache_dir: Optional[str]
+        The directory caching the compiled PrimFuncs across builds. Each PrimFunc is compiled
+        on its own and stored under the structural hash of the lowered PrimFunc and the target,
+        so that only the PrimFuncs not found in the cache are compiled. It only applies to the
+        llvm targets, the other targets are always compiled from scratch.
+
+    num_tir_shards: int
+        The number of shards the PrimFuncs are split into. With more than one shard, the shards
+        are lowered and compiled in parallel, and their modules are linked as the imports of the
+        first one. It does not apply when the PrimFuncs are built with `cache_dir`.
+
+    exec_mode: str
+        "bytecode" to interpret the Relax functions, or "compiled" to also translate their
+        bytecode into C++ which is compiled with the kernels by `ex.mod.export_library`. Once
+        the library is loaded back, the VM calls the compiled functions in place of its dispatch
+        loop, with the same shape computations, allocations and kernel calls. The functions are
+        registered in the system library when the runtime of `mod` has "system-lib" set. The
+        executables which are not exported, and the profiler, still run the bytecode.
+
     Returns
     -------
     ex: tvm.relax.vm.Executable
-        An executable that can be loaded by virtual machine.
+        An executable that can be loaded by virtual machine. The external modules of the
+        module attribute "external_mods" are linked into it. The TensorRT engines they build
+        on their first run are saved with it by `ex.mod.export_library`, and deserialized
+        rather than built again when it is loaded.
 
     Example
     -------
@@ -498,17 +1140,25 @@ def build(
     """
     if isinstance(target, str):
         target = tvm.target.Target(target)
+    if exec_mode not in ("bytecode", "compiled"):
+        raise ValueError("Unknown exec_mode {}, expect bytecode or compiled".format(exec_mode))
 
     passes = [relax.transform.ToNonDataflow()]
-    passes.append(relax.transform.CallTIRRewrite())
-    passes.append(relax.transform.VMMemoryLower())
-    passes.append(relax.transform.VMShapeLower())
+    passes.append(relax.transform.LiftTIRWorkspace())
+    passes.append(relax.transform.CallTIRRewrite(inplace=True))
+    passes.append(relax.transform.VMMemoryLower(plan_memory=True))
+    passes.append(relax.transform.VMShapeLower(native_shape_arith=True))
     seq = tvm.transform.Sequential(passes)
     new_mod = seq(mod)
 
     # Split primfunc and relax function
     rx_mod, tir_mod = _split_tir_relax(new_mod)
-    lib = tvm.build(tir_mod, target=target)
+    if cache_dir is not None and target.kind.name == "llvm" and tir_mod.functions:
+        lib = _build_with_cache(tir_mod, target, cache_dir)
+    elif num_tir_shards > 1 and tir_mod.functions:
+        lib = _ffi_api.VMBuildTIRInShards(tir_mod, target, num_tir_shards)
+    else:
+        lib = tvm.build(tir_mod, target=target)
 
     # Extract external runtime modules if exist.
     ext_libs = []
@@ -518,7 +1168,71 @@ def build(
     if params is None:
         params = {}
 
-    return Executable(_ffi_api.VMCodeGen(rx_mod, lib, ext_libs, target, params))
+    ex = Executable(_ffi_api.VMCodeGen(rx_mod, lib, ext_libs, target, params))
+    if exec_mode == "compiled":
+        runtime = mod.get_attr("runtime")
+        system_lib = runtime is not None and "system-lib" in runtime and bool(runtime["system-lib"])
+        ex.mod.imported_modules[0].import_module(_ffi_api.VMCompileBytecode(ex.mod, system_lib))
+    return ex
+
+
+def _build_with_cache(tir_mod: tvm.IRModule, target: tvm.target.Target, cache_dir: str) -> Module:
+    """Build the PrimFuncs one by one, loading the ones compiled before from the cache, and link
+    them as the imports of the first one.
+
+    A kernel is keyed by the structural hash of the PrimFunc, the target and the pass context it
+    is built in. The full key is saved next to the kernel and compared when the kernel is loaded,
+    so that a hash collision rebuilds the kernel instead of loading another one."""
+    os.makedirs(cache_dir, exist_ok=True)
+    ctx = tvm.transform.PassContext.current()
+    libs = []
+    for gv, func in tir_mod.functions.items():
+        key = {
+            "target": str(target),
+            "opt_level": int(ctx.opt_level),
+            "required_pass": sorted(str(name) for name in ctx.required_pass),
+            "disabled_pass": sorted(str(name) for name in ctx.disabled_pass),
+        }
+        digest = "{}:{}:{}".format(
+            tvm.ir.structural_hash(func),
+            tvm.ir.structural_hash(ctx.config),
+            json.dumps(key, sort_keys=True),
+        )
+        path = os.path.join(cache_dir, hashlib.sha256(digest.encode()).hexdigest() + ".ll")
+        key_path = path + ".key"
+        if not _match_cache_key(key_path, key, func, ctx.config):
+            lib = tvm.build(IRModule({gv: func}), target=target)
+            # Write to temporary files first, so that concurrent builds never load partial files.
+            temp_path = "{}.{}.tmp".format(path, os.getpid())
+            temp_key_path = "{}.{}.tmp".format(key_path, os.getpid())
+            lib.save(temp_path, "ll")
+            with open(temp_key_path, "w") as key_file:
+                json.dump(dict(key, objects=tvm.ir.save_json([func, ctx.config])), key_file)
+            os.replace(temp_key_path, key_path)
+            os.replace(temp_path, path)
+        libs.append(tvm.runtime.load_module(path))
+    for lib in libs[1:]:
+        libs[0].import_module(lib)
+    return libs[0]
+
+
+def _match_cache_key(key_path: str, key: Dict[str, Any], func: PrimFunc, config: Object) -> bool:
+    """Check whether the key saved at key_path by _build_with_cache is the key of the kernel, a
+    file that is missing or cannot be read does not match."""
+    if not os.path.exists(key_path) or not os.path.exists(key_path[: -len(".key")]):
+        return False
+    try:
+        with open(key_path) as key_file:
+            saved = json.load(key_file)
+        objects = tvm.ir.load_json(saved.pop("objects"))
+    except (OSError, ValueError, KeyError, tvm.TVMError):
+        logging.warning("Ignoring the corrupted kernel cache key %s", key_path)
+        return False
+    return (
+        saved == key
+        and tvm.ir.structural_equal(objects[0], func)
+        and tvm.ir.structural_equal(objects[1], config)
+    )
 
 
 def _split_tir_relax(mod: tvm.IRModule) -> Tuple[tvm.IRModule, tvm.IRModule]:
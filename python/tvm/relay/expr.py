@@ -547,7 +547,7 @@ class StorageInfo(Node):
     The static storage information produced by memory planning.
     Contains the storage ids where expressions are stored, the
     type of the "virtual devices" the expressions are stored on,
-    and the sizes of each storage element."""
+    and the sizes and offsets of each storage element."""
 
     def __init__(self, sids, dev_types, sizes):
         self.__init_handle_by_constructor__(_ffi_api.StorageInfo, sids, dev_types, sizes)
@@ -564,6 +564,10 @@ class StorageInfo(Node):
     def storage_sizes(self):
         return _ffi_api.StorageInfoStorageSizes(self)
 
+    @property
+    def storage_offsets(self):
+        return _ffi_api.StorageInfoStorageOffsets(self)
+
     @property
     def virtual_devices(self):
         return _ffi_api.StorageInfoVirtualDevices(self)
@@ -15,10 +15,12 @@
 # specific language governing permissions and limitations
 # under the License.
 """RPC client tools"""
+import json
 import os
 import socket
 import stat
 import struct
+import sys
 import time
 
 import tvm._ffi
@@ -29,6 +31,44 @@ from tvm.runtime import ndarray as nd
 from . import _ffi_api, base, server
 
 
+class RPCFuture(object):
+    """The future of a request submitted to a remote session.
+
+    Note
+    ----
+    The returns of the submitted requests are received in order by :py:meth:`result`, and
+    by the synchronous requests of the session, which first receive the returns of the
+    earlier submitted requests. :py:meth:`done` does not receive them.
+    """
+
+    def __init__(self, fwait):
+        self._fwait = fwait
+
+    def done(self):
+        """Whether the return of the request was received.
+
+        Returns
+        -------
+        done : bool
+        """
+        return bool(self._fwait(False))
+
+    def result(self):
+        """Wait for the request, and get its return value.
+
+        Returns
+        -------
+        value : object
+            The return value of the call, None for a copy.
+
+        Raises
+        ------
+        TVMError
+            The error of the remote when the request failed.
+        """
+        return self._fwait(True)
+
+
 class RPCSession(object):
     """RPC Client session module
 
@@ -70,6 +110,91 @@ class RPCSession(object):
         """
         return self._sess.get_function(name)
 
+    def set_copy_options(self, window=4, block_bytes=1 << 20, compress=False):
+        """Configure the transfers of the arrays to and from the remote.
+
+        The arrays are transferred by blocks, and the next blocks are sent while waiting for
+        the first ones, which hides the round trip of each block on high latency links.
+
+        Parameters
+        ----------
+        window : int
+            The number of blocks in flight, 1 to wait for each block.
+
+        block_bytes : int
+            The maximum bytes of a block, 0 for the maximum transfer size of the remote.
+
+        compress : bool
+            Whether to compress the uploaded blocks. The remotes that cannot decompress them,
+            e.g. older servers, get the blocks as they are. Compression pays off on slow
+            links, for contents that compress, e.g. sparse or quantized weights.
+
+        Note
+        ----
+        The event driven servers hosting asynchronous sessions, e.g. the web runtime, only
+        accept a window of 1.
+        """
+        _ffi_api.SessSetCopyOptions(self._sess, window, block_bytes, compress)
+
+    def submit(self, func, *args):
+        """Call a remote function without waiting for its return.
+
+        The server runs the submitted requests in order, so that several calls can be in flight
+        on high latency links instead of waiting for the round trip of each.
+
+        Parameters
+        ----------
+        func : PackedFunc
+            The remote function, from :py:meth:`get_function` or a remote module.
+
+        args : list
+            The arguments of the function.
+
+        Returns
+        -------
+        future : RPCFuture
+            The future of the return value.
+        """
+        return RPCFuture(_ffi_api.SessSubmitCall(func, *args))
+
+    def submit_copy_to(self, source, target):
+        """Copy a local array into a remote array without waiting for the copy.
+
+        Parameters
+        ----------
+        source : numpy.ndarray or NDArray
+            The contiguous local array, which can be modified once the function returns.
+
+        target : NDArray
+            The contiguous remote array of the same size.
+
+        Returns
+        -------
+        future : RPCFuture
+            The future of the copy.
+        """
+        if not isinstance(source, nd.NDArray):
+            source = nd.array(source)
+        return RPCFuture(_ffi_api.SessSubmitCopyToRemote(source, target))
+
+    def submit_copy_from(self, source, target):
+        """Copy a remote array into a local array without waiting for the copy.
+
+        Parameters
+        ----------
+        source : NDArray
+            The contiguous remote array.
+
+        target : NDArray
+            The contiguous local cpu array of the same size, written until the copy completes.
+
+        Returns
+        -------
+        future : RPCFuture
+            The future of the copy.
+        """
+        return RPCFuture(_ffi_api.SessSubmitCopyFromRemote(source, target))
+
     def device(self, dev_type, dev_id=0):
         """Construct a remote device.
 
@@ -278,6 +403,29 @@ class PopenSession(RPCSession):
         RPCSession.__init__(self, _popen_session(binary))
 
 
+class SharedMemorySession(RPCSession):
+    """RPCSession interface backed by a server process on the same host.
+
+    The messages go through rings in a shared memory region instead of a socket, which
+    makes the copies of the arrays plain memory copies. Linux only.
+
+    Parameters
+    ----------
+    ring_bytes : int
+        The bytes of the ring of each direction. A smaller ring only splits the larger
+        messages into more rounds.
+
+    load_library : list of str, optional
+        The additional libraries to load in the server process.
+    """
+
+    def __init__(self, ring_bytes=64 << 20, load_library=None):
+        cmd = [sys.executable, "-m", "tvm.exec.rpc_shm_server"]
+        if load_library:
+            cmd += ["--load-library", ":".join(load_library)]
+        RPCSession.__init__(self, _ffi_api.CreateSharedMemoryClient(ring_bytes, *cmd))
+
+
 class TrackerSession(object):
     """Tracker client session.
 
@@ -324,19 +472,23 @@ class TrackerSession(object):
 
         res = ""
         res += "Server List\n"
-        res += "------------------------------\n"
-        res += "server-address           key\n"
-        res += "------------------------------\n"
+        res += "----------------------------------------------\n"
+        res += "server-address           util  sessions  key\n"
+        res += "----------------------------------------------\n"
         sorted_server = sorted(data["server_info"], key=lambda x: x["key"])
         for item in sorted_server:
             addr = item["addr"]
             res += "%21s    " % ":".join(map(str, addr))
-            res += item["key"] + "\n"
+            res += "%3d%%  %-8d  " % (100 * item.get("utilization", 0), item.get("sessions", 0))
+            res += item["key"]
+            if item.get("tags"):
+                res += "  " + json.dumps(item["tags"], sort_keys=True)
+            res += "\n"
             key = item["key"].split(":")[1]  # 'server:rasp3b` -> 'rasp3b'
             if key not in total_ct:
                 total_ct[key] = 0
             total_ct[key] += 1
-        res += "------------------------------\n"
+        res += "----------------------------------------------\n"
         res += "\n"
 
         # compute max length of device key
@@ -366,7 +518,13 @@ class TrackerSession(object):
         return res
 
     def request(
-        self, key, priority=1, session_timeout=0, max_retry=5, session_constructor_args=None
+        self,
+        key,
+        priority=1,
+        session_timeout=0,
+        max_retry=5,
+        session_constructor_args=None,
+        requirements=None,
     ):
         """Request a new connection from the tracker.
 
@@ -390,13 +548,20 @@ class TrackerSession(object):
             List of additional arguments to passed as the remote session constructor.
             The first element of the list is always a string specifying the name of
             the session constructor, the following args are the positional args to that function.
+
+        requirements : dict, optional
+            The capabilities the device must have, matched against the tags its server
+            reported. A number requires a tag of at least this value, e.g. {"memory_gb": 16},
+            anything else an equal tag, e.g. {"gpu": "a100"}.
         """
         last_err = None
         for _ in range(max_retry):
             try:
                 if self._sock is None:
                     self._connect()
-                base.sendjson(self._sock, [base.TrackerCode.REQUEST, key, "", priority])
+                base.sendjson(
+                    self._sock, [base.TrackerCode.REQUEST, key, "", priority, requirements]
+                )
                 value = base.recvjson(self._sock)
                 if value[0] != base.TrackerCode.SUCCESS:
                     raise RuntimeError("Invalid return value %s" % str(value))
@@ -417,7 +582,9 @@ class TrackerSession(object):
             "Cannot request %s after %d retry, last_error:%s" % (key, max_retry, str(last_err))
         )
 
-    def request_and_run(self, key, func, priority=1, session_timeout=0, max_retry=2):
+    def request_and_run(
+        self, key, func, priority=1, session_timeout=0, max_retry=2, requirements=None
+    ):
         """Request a resource from tracker and run the func.
 
         This function safe-guard rare server node dropout during execution.
@@ -441,11 +608,19 @@ class TrackerSession(object):
 
         max_retry : int, optional
             Maximum number of times to retry the function before give up.
+
+        requirements : dict, optional
+            The capabilities the device must have, see request.
         """
         last_err = None
         for _ in range(max_retry):
             try:
-                sess = self.request(key, priority=priority, session_timeout=session_timeout)
+                sess = self.request(
+                    key,
+                    priority=priority,
+                    session_timeout=session_timeout,
+                    requirements=requirements,
+                )
                 tstart = time.time()
                 return func(sess)
             except TVMError as err:
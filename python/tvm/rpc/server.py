@@ -137,7 +137,7 @@ def _parse_server_opt(opts):
     return ret
 
 
-def _listen_loop(sock, port, rpc_key, tracker_addr, load_library, custom_addr):
+def _listen_loop(sock, port, rpc_key, tracker_addr, load_library, custom_addr, tags=None):
     """Listening loop of the server."""
 
     def _accept_conn(listen_sock, tracker_conn, ping_period=2):
@@ -158,7 +158,9 @@ def _listen_loop(sock, port, rpc_key, tracker_addr, load_library, custom_addr):
         # Report resource to tracker
         if tracker_conn:
             matchkey = base.random_key(rpc_key + ":")
-            base.sendjson(tracker_conn, [TrackerCode.PUT, rpc_key, (port, matchkey), custom_addr])
+            base.sendjson(
+                tracker_conn, [TrackerCode.PUT, rpc_key, (port, matchkey), custom_addr, tags]
+            )
             assert base.recvjson(tracker_conn) == TrackerCode.SUCCESS
         else:
             matchkey = rpc_key
@@ -184,7 +186,8 @@ def _listen_loop(sock, port, rpc_key, tracker_addr, load_library, custom_addr):
                         logger.info("no incoming connections, regenerate key ...")
                         matchkey = base.random_key(rpc_key + ":", old_keyset)
                         base.sendjson(
-                            tracker_conn, [TrackerCode.PUT, rpc_key, (port, matchkey), custom_addr]
+                            tracker_conn,
+                            [TrackerCode.PUT, rpc_key, (port, matchkey), custom_addr, tags],
                         )
                         assert base.recvjson(tracker_conn) == TrackerCode.SUCCESS
                         unmatch_period_count = 0
@@ -319,6 +322,7 @@ class PopenRPCServerState(object):
         load_library=None,
         custom_addr=None,
         silent=False,
+        tags=None,
     ):
 
         # start update
@@ -349,7 +353,15 @@ class PopenRPCServerState(object):
             self.sock = sock
             self.thread = threading.Thread(
                 target=_listen_loop,
-                args=(self.sock, self.port, key, tracker_addr, load_library, self.custom_addr),
+                args=(
+                    self.sock,
+                    self.port,
+                    key,
+                    tracker_addr,
+                    load_library,
+                    self.custom_addr,
+                    tags,
+                ),
             )
             self.thread.start()
         else:
@@ -371,6 +383,7 @@ def _popen_start_rpc_server(
     silent=False,
     no_fork=False,
     server_init_callback=None,
+    tags=None,
 ):
     if no_fork:
         multiprocessing.set_start_method("spawn")
@@ -382,7 +395,7 @@ def _popen_start_rpc_server(
     # Popen worker to run on a separate process.
     # Create and start the server in a different thread
     state = PopenRPCServerState(
-        host, port, port_end, is_proxy, tracker_addr, key, load_library, custom_addr, silent
+        host, port, port_end, is_proxy, tracker_addr, key, load_library, custom_addr, silent, tags
     )
     PopenRPCServerState.current = state
     # returns the port so that the main can get the port number.
@@ -434,6 +447,10 @@ class Server(object):
     server_init_callback: Callable, optional
         Additional initialization function when starting the server.
 
+    tags: dict, optional
+        The capabilities of the device reported to the RPC Tracker, e.g.
+        {"gpu": "a100", "memory_gb": 80}, matched against the requirements of the requests.
+
     Note
     ----
     The RPC server only sees functions in the tvm namespace.
@@ -464,6 +481,7 @@ class Server(object):
         silent=False,
         no_fork=False,
         server_init_callback=None,
+        tags=None,
     ):
         try:
             if _ffi_api.ServerLoop is None:
@@ -486,6 +504,7 @@ class Server(object):
                 silent,
                 no_fork,
                 server_init_callback,
+                tags,
             ],
         )
         # receive the port
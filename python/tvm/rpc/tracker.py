@@ -32,20 +32,23 @@ List of available APIs:
   - input: [TrackerCode.PING]
   - return: TrackerCode.SUCCESS
 - PUT: report resource to tracker
-  - input: [TrackerCode.PUT, [port, match-key]]
+  - input: [TrackerCode.PUT, [port, match-key], custom-addr, tags]
   - return: TrackerCode.SUCCESS
   - note: match-key is a randomly generated identify the resource during connection.
+  - note: custom-addr and tags are optional, tags is a dict of the device capabilities.
 - REQUEST: request a new resource from tracker
-  - input: [TrackerCode.REQUEST, [key, user, priority]]
+  - input: [TrackerCode.REQUEST, [key, user, priority, requirements]]
   - return: [TrackerCode.SUCCESS, [url, port, match-key]]
+  - note: requirements is an optional dict matched against the tags of the resources,
+    see match_tags.
 """
 # pylint: disable=invalid-name
 
 import asyncio
-import heapq
 import logging
 import socket
 import threading
+import time
 import errno
 import struct
 import json
@@ -75,6 +78,39 @@ logger.setLevel(logging.INFO)
 logger.propagate = False
 
 
+def _is_number(value):
+    return isinstance(value, (int, float)) and not isinstance(value, bool)
+
+
+def match_tags(tags, requirements):
+    """Whether the tags of a resource satisfy the requirements of a request.
+
+    Parameters
+    ----------
+    tags : dict
+        The capabilities of the resource, e.g. {"gpu": "a100", "memory_gb": 80}.
+
+    requirements : Optional[dict]
+        The capabilities requested. A number is satisfied by a tag of at least
+        this value, anything else by an equal tag.
+
+    Returns
+    -------
+    matched : bool
+        Whether all the requirements are satisfied.
+    """
+    for name, required in (requirements or {}).items():
+        if name not in tags:
+            return False
+        value = tags[name]
+        if _is_number(required) and _is_number(value):
+            if value < required:
+                return False
+        elif value != required:
+            return False
+    return True
+
+
 class Scheduler(object):
     """Abstract interface of scheduler."""
 
@@ -90,7 +126,7 @@ class Scheduler(object):
         """
         raise NotImplementedError()
 
-    def request(self, user, priority, callback):
+    def request(self, user, priority, callback, requirements=None):
         """Request a resource.
 
         Parameters
@@ -104,6 +140,9 @@ class Scheduler(object):
         callback : function: value->bool
             Callback function to receive an resource when ready
             returns True if the resource is consumed.
+
+        requirements : Optional[dict]
+            The tags the resource must match, see match_tags.
         """
         raise NotImplementedError()
 
@@ -122,7 +161,11 @@ class Scheduler(object):
 
 
 class PriorityScheduler(Scheduler):
-    """Priority based scheduler, FIFO based on request order"""
+    """Priority based scheduler, FIFO based on request order.
+
+    A request is served by the first free resource whose tags match its requirements,
+    a request that no free resource matches does not hold back the requests after it.
+    """
 
     def __init__(self, key):
         self._key = key
@@ -132,12 +175,17 @@ class PriorityScheduler(Scheduler):
         self._requests = []
 
     def _schedule(self):
-        while self._requests and self._values:
-            value = self._values.pop(0)
-            item = heapq.heappop(self._requests)
-            callback = item[-1]
+        for item in sorted(self._requests, key=lambda x: x[:2]):
+            if not self._values:
+                break
+            requirements, callback = item[2:]
+            value = next((v for v in self._values if match_tags(v[0].tags, requirements)), None)
+            if value is None:
+                continue
+            self._values.remove(value)
+            self._requests.remove(item)
             if callback(value[1:]):
-                value[0].pending_matchkeys.remove(value[-1])
+                value[0].acquire(value[-1])
             else:
                 self._values.append(value)
 
@@ -145,9 +193,9 @@ class PriorityScheduler(Scheduler):
         self._values.append(value)
         self._schedule()
 
-    def request(self, user, priority, callback):
+    def request(self, user, priority, callback, requirements=None):
         with self._lock:
-            heapq.heappush(self._requests, (-priority, self._request_cnt, callback))
+            self._requests.append((-priority, self._request_cnt, requirements, callback))
             self._request_cnt += 1
         self._schedule()
 
@@ -181,6 +229,13 @@ class TCPEventHandler(tornado_util.TCPHandler):
         self.pending_matchkeys = set()
         self._tracker._connections.add(self)
         self.put_values = []
+        # the capabilities of the reported resources
+        self.tags = {}
+        # the utilization of the reported resources
+        self._start_time = time.time()
+        self._busy_since = None
+        self._busy_time = 0.0
+        self._num_sessions = 0
 
     def name(self):
         """name of connection"""
@@ -188,7 +243,33 @@ class TCPEventHandler(tornado_util.TCPHandler):
 
     def summary(self):
         """Summary of this connection"""
-        return self._info
+        busy_time = self._busy_time
+        if self._busy_since is not None:
+            busy_time += time.time() - self._busy_since
+        uptime = max(time.time() - self._start_time, 1e-9)
+        return dict(
+            self._info,
+            tags=self.tags,
+            sessions=self._num_sessions,
+            utilization=min(busy_time / uptime, 1.0),
+        )
+
+    def acquire(self, matchkey):
+        """Mark the resource as handed to a client, until it is reported again.
+
+        Parameters
+        ----------
+        matchkey : str
+            The match key of the resource.
+        """
+        self.pending_matchkeys.remove(matchkey)
+        self._busy_since = time.time()
+        self._num_sessions += 1
+
+    def _release(self):
+        if self._busy_since is not None:
+            self._busy_time += time.time() - self._busy_since
+            self._busy_since = None
 
     def _init_conn(self, message):
         """Initialize the connection"""
@@ -245,6 +326,10 @@ class TCPEventHandler(tornado_util.TCPHandler):
             key = args[1]
             port, matchkey = args[2]
             self.pending_matchkeys.add(matchkey)
+            self._release()
+            if len(args) >= 5 and args[4] is not None:
+                assert isinstance(args[4], dict)
+                self.tags = args[4]
             # got custom address (from rpc server)
             if len(args) >= 4 and args[3] is not None:
                 value = (self, args[3], port, matchkey)
@@ -257,6 +342,7 @@ class TCPEventHandler(tornado_util.TCPHandler):
             key = args[1]
             user = args[2]
             priority = args[3]
+            requirements = args[4] if len(args) >= 5 else None
 
             def _cb(value):
                 # if the connection is already closed
@@ -268,7 +354,7 @@ class TCPEventHandler(tornado_util.TCPHandler):
                     return False
                 return True
 
-            self._tracker.request(key, user, priority, _cb)
+            self._tracker.request(key, user, priority, _cb, requirements)
         elif code == TrackerCode.PING:
             self.ret_value(TrackerCode.SUCCESS)
         elif code == TrackerCode.GET_PENDING_MATCHKEYS:
@@ -337,11 +423,11 @@ class TrackerServerHandler(object):
             self._scheduler_map[key] = self.create_scheduler(key)
         self._scheduler_map[key].put(value)
 
-    def request(self, key, user, priority, callback):
+    def request(self, key, user, priority, callback, requirements=None):
         """Request a new resource."""
         if key not in self._scheduler_map:
             self._scheduler_map[key] = self.create_scheduler(key)
-        self._scheduler_map[key].request(user, priority, callback)
+        self._scheduler_map[key].request(user, priority, callback, requirements)
 
     def close(self, conn):
         self._connections.remove(conn)
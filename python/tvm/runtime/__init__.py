@@ -22,13 +22,15 @@ from .object import Object
 from .object_path import ObjectPath, ObjectPathPair
 from .object_generic import ObjectGeneric, ObjectTypes
 from .ndarray import NDArray, DataType, DataTypeCode, Device
-from .module import Module, num_threads
+from .module import Module, num_threads, numa_node_cpus, config_threadpool_numa_node
+from .module import create_thread_pool, destroy_thread_pool
 from .profiling import Report
 
 # function exposures
 from .object_generic import convert_to_object, convert, const
 from .ndarray import device, cpu, cuda, gpu, opencl, cl, vulkan, metal, mtl
-from .ndarray import vpi, rocm, ext_dev
+from .ndarray import vpi, rocm, ext_dev, config_cuda_pinned_staging, config_cuda_mem_pool
+from .ndarray import config_workspace_pool, workspace_pool_stats, trim_workspace_pool
 from .module import load_module, enabled, system_lib, load_static_library
 from .container import String, ShapeTuple
 from .params import save_param_dict, load_param_dict
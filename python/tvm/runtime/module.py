@@ -20,7 +20,7 @@
 import os
 import ctypes
 import struct
-from typing import Sequence
+from typing import List, Sequence
 import numpy as np
 
 import tvm._ffi
@@ -62,6 +62,13 @@ class BenchmarkResult:
             Standard deviation in seconds of runtimes. If py:meth:`Module.time_evaluator` is called
             with `number` > 0, then each result is already the mean of a `number` of runtimes, so
             this becomes the standard deviation of means.
+        p90 : float
+            The 90th percentile of the runtimes in seconds.
+        p99 : float
+            The 99th percentile of the runtimes in seconds.
+        confidence_interval : Tuple[float, float]
+            The 95% confidence interval in seconds of the mean runtime, from the standard error of
+            the results. It only holds the mean with a single result.
         results : Sequence[float]
             The collected runtimes (in seconds). This may be a series of mean runtimes if
             py:meth:`Module.time_evaluator` or `benchmark` was run with `number` > 1.
@@ -72,6 +79,10 @@ class BenchmarkResult:
         self.median = np.median(self.results)
         self.min = np.min(self.results)
         self.max = np.max(self.results)
+        self.p90 = np.percentile(self.results, 90)
+        self.p99 = np.percentile(self.results, 99)
+        stderr = np.std(self.results, ddof=1) / np.sqrt(len(results)) if len(results) > 1 else 0.0
+        self.confidence_interval = (self.mean - 1.96 * stderr, self.mean + 1.96 * stderr)
 
     def __repr__(self):
         return "BenchmarkResult(min={}, mean={}, median={}, max={}, std={}, results={})".format(
@@ -281,6 +292,8 @@ class Module(object):
         cooldown_interval_ms=0,
         repeats_to_cooldown=1,
         f_preproc="",
+        max_repeat=None,
+        max_relative_error=0.01,
     ):
         """Get an evaluator that measures time cost of running function.
 
@@ -325,6 +338,17 @@ class Module(object):
         f_preproc: str, optional
             The preprocess function name we want to execute before executing the time evaluator.
 
+        max_repeat: Optional[int]
+            If set, measure statistically: the runs of a repeat are calibrated once to last at
+            least `min_repeat_ms`, instead of `number`, and the function is measured for at least
+            max(repeat, 2) and at most `max_repeat` repeats, until the standard error of the mean
+            cost is below `max_relative_error` of the mean. The leading repeats which are
+            outliers of the others, e.g. from cold caches, are discarded from the results.
+
+        max_relative_error: float, optional
+            The target standard error of the mean cost of the statistical measurement, relative
+            to it. The 95% confidence interval of the mean is then about 4 times as wide.
+
         Note
         ----
         The function will be invoked  (1 + number x repeat) times,
@@ -337,25 +361,40 @@ class Module(object):
             The ProfileResult reports `repeat` time costs in seconds.
         """
         try:
-            feval = _ffi_api.RPCTimeEvaluator(
-                self,
-                func_name,
-                dev.device_type,
-                dev.device_id,
-                number,
-                repeat,
-                min_repeat_ms,
-                limit_zero_time_iterations,
-                cooldown_interval_ms,
-                repeats_to_cooldown,
-                f_preproc,
-            )
+            if max_repeat is None:
+                feval = _ffi_api.RPCTimeEvaluator(
+                    self,
+                    func_name,
+                    dev.device_type,
+                    dev.device_id,
+                    number,
+                    repeat,
+                    min_repeat_ms,
+                    limit_zero_time_iterations,
+                    cooldown_interval_ms,
+                    repeats_to_cooldown,
+                    f_preproc,
+                )
+            else:
+                feval = _ffi_api.RPCStatisticalTimeEvaluator(
+                    self,
+                    func_name,
+                    dev.device_type,
+                    dev.device_id,
+                    max(repeat, 2),
+                    max_repeat,
+                    min_repeat_ms,
+                    max_relative_error,
+                    cooldown_interval_ms,
+                    repeats_to_cooldown,
+                    f_preproc,
+                )
 
             def evaluator(*args):
                 """Internal wrapped evaluator."""
                 # Wrap feval so we can add more stats in future.
                 blob = feval(*args)
-                fmt = "@" + ("d" * repeat)
+                fmt = "@" + ("d" * (len(blob) // struct.calcsize("d")))
                 results = struct.unpack(fmt, blob)
                 return BenchmarkResult(results)
 
@@ -653,4 +692,65 @@ def num_threads() -> int:
     return _ffi_api.NumThreads()
 
 
+def create_thread_pool(name: str, cpus: Sequence[int]) -> None:
+    """Create a named thread pool, with a worker bound to each of the given CPUs.
+
+    The VMs and graph executors attached to the pool with their `set_thread_pool` run their
+    parallel kernels on its workers, so that the models co-hosted in a process take their
+    CPUs from isolated pools.
+
+    Parameters
+    ----------
+    name : str
+        The name of the pool.
+
+    cpus : Sequence[int]
+        The CPUs of the workers.
+    """
+    from .container import ShapeTuple
+
+    _ffi_api.CreateThreadPool(name, ShapeTuple(list(cpus)))
+
+
+def destroy_thread_pool(name: str) -> None:
+    """Destroy a named thread pool, once the threads using it are done.
+
+    Parameters
+    ----------
+    name : str
+        The name of the pool.
+    """
+    _ffi_api.DestroyThreadPool(name)
+
+
+def numa_node_cpus() -> List[List[int]]:
+    """Get the CPUs of each NUMA node of the system.
+
+    Returns
+    -------
+    nodes : List[List[int]]
+        The ids of the CPUs of each node, a single node of all the CPUs when the topology
+        cannot be read.
+    """
+    return [list(cpus) for cpus in _ffi_api.NumaNodeCpus()]
+
+
+def config_threadpool_numa_node(node: int, num_threads: int = 0) -> None:
+    """Restrict the thread pool of the calling thread to the CPUs of a NUMA node, and place
+    the CPU memory allocated by the thread on the node.
+
+    The thread pools are per calling thread, so that a process serves from several sockets
+    by configuring one serving thread per node.
+
+    Parameters
+    ----------
+    node : int
+        The NUMA node.
+
+    num_threads : int
+        The number of threads of the pool, 0 to use all the CPUs of the node.
+    """
+    _ffi_api.config_threadpool_numa_node(node, num_threads)
+
+
 _set_class_module(Module)
@@ -17,6 +17,7 @@
 # pylint: disable=invalid-name, unused-import, redefined-outer-name
 """Runtime NDArray API"""
 import ctypes
+import json
 import warnings
 import numpy as np
 import tvm._ffi
@@ -171,11 +172,13 @@ class NDArray(NDArrayBase):
             if source_array.dtype in numpy_str_map
             else str(source_array.dtype)
         )
+        # the bfloat16 and float8 arrays are given as the raw bits of their elements
+        storage_dtype = {"bfloat16": "uint16", "e4m3_float8": "uint8", "e5m2_float8": "uint8"}
         if (not source_array.flags["C_CONTIGUOUS"]) or (
-            dtype == "bfloat16" or dtype != np_dtype_str
+            dtype in storage_dtype or dtype != np_dtype_str
         ):
             source_array = np.ascontiguousarray(
-                source_array, dtype="uint16" if dtype == "bfloat16" else dtype
+                source_array, dtype=storage_dtype.get(dtype, dtype)
             )
         assert source_array.flags["C_CONTIGUOUS"]
         data = source_array.ctypes.data_as(ctypes.c_void_p)
@@ -220,6 +223,8 @@ class NDArray(NDArrayBase):
             dtype = "int8"
         if dtype == "bfloat16":
             dtype = "uint16"
+        if dtype in ("e4m3_float8", "e5m2_float8"):
+            dtype = "uint8"
         np_arr = np.empty(shape, dtype=dtype)
         assert np_arr.flags["C_CONTIGUOUS"]
         data = np_arr.ctypes.data_as(ctypes.c_void_p)
@@ -604,5 +609,86 @@ def array(arr, device=cpu(0), mem_scope=None):
     return empty(arr.shape, arr.dtype, device, mem_scope).copyfrom(arr)
 
 
+def config_cuda_pinned_staging(chunk_bytes=4 << 20, min_bytes=1 << 20):
+    """Configure the staging of the copies between the pageable host memory and CUDA devices.
+
+    The copies of at least min_bytes are split in chunks, staged through two page-locked buffers
+    of each thread, so that the host fills or drains one of them while the other is copied by
+    the DMA engine. The uploads return once the source has been read.
+
+    Parameters
+    ----------
+    chunk_bytes : int
+        The size of each staging buffer, or 0 to leave all the copies to the driver.
+
+    min_bytes : int
+        The minimum size of the copies to stage.
+    """
+    func = tvm.get_global_func("runtime.config_cuda_pinned_staging", allow_missing=True)
+    if func is None:
+        raise RuntimeError("The staging of the copies requires TVM built with CUDA")
+    func(chunk_bytes, min_bytes)
+
+
+def config_cuda_mem_pool(release_threshold=0, device_id=0):
+    """Configure the memory pool of a CUDA device, from which the "stream_ordered" allocator of
+    the Relax VM allocates.
+
+    Parameters
+    ----------
+    release_threshold : int
+        The bytes of the freed memory the pool keeps when the device synchronizes, or -1 to keep
+        all of it. The default of the driver is 0.
+
+    device_id : int
+        The CUDA device.
+    """
+    func = tvm.get_global_func("runtime.config_cuda_mem_pool", allow_missing=True)
+    if func is None:
+        raise RuntimeError("The memory pool requires TVM built with CUDA 11.2 or later")
+    func(device_id, release_threshold)
+
+
+def config_workspace_pool(max_cached_bytes=-1):
+    """Configure the pools of the workspace allocated by the kernels.
+
+    Parameters
+    ----------
+    max_cached_bytes : int
+        The maximum bytes each pool of a thread caches for a device after they are freed by the
+        kernels, the largest pages beyond it are returned to the device. Negative for no limit.
+    """
+    _ffi_api.config_workspace_pool(max_cached_bytes)
+
+
+def workspace_pool_stats(dev):
+    """Get the counters of the workspace pool of the calling thread for a device.
+
+    Parameters
+    ----------
+    dev : Device
+        The device.
+
+    Returns
+    -------
+    stats : Dict[str, int]
+        The allocations served by a cached page and by new device memory, the pages returned to
+        the device, and the bytes in use and cached, as num_hits, num_misses, num_releases,
+        bytes_in_use and bytes_cached.
+    """
+    return json.loads(_ffi_api.workspace_pool_stats(dev))
+
+
+def trim_workspace_pool(dev):
+    """Return the pages cached by the workspace pool of the calling thread to a device.
+
+    Parameters
+    ----------
+    dev : Device
+        The device.
+    """
+    _ffi_api.trim_workspace_pool(dev)
+
+
 # Register back to FFI
 _set_class_ndarray(NDArray)
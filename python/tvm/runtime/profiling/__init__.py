@@ -16,7 +16,7 @@
 # under the License.
 """Registration of profiling objects in python."""
 
-from typing import Dict, Sequence, Optional
+from typing import Dict, Sequence, Optional, Tuple
 from ... import _ffi
 from . import _ffi_api
 from .. import Object, Device
@@ -171,6 +171,35 @@ class Report(Object):
         """
         return _ffi_api.FromJSON(s)
 
+    def diff(self, baseline: "Report") -> Dict[str, Tuple[float, float]]:
+        """Compare the total duration of each called function against a baseline report,
+        e.g. the report of the same model compiled by another build.
+
+        Parameters
+        ----------
+        baseline : Report
+            The report to compare against.
+
+        Returns
+        -------
+        durations : Dict[str, Tuple[float, float]]
+            The total microseconds of the calls of each function name in the baseline and in
+            this report, 0 in the report without the function.
+        """
+
+        def totals(report):
+            result = {}
+            for call in report.calls:
+                name = str(call["Name"])
+                result[name] = result.get(name, 0.0) + call["Duration (us)"].microseconds
+            return result
+
+        before, after = totals(baseline), totals(self)
+        return {
+            name: (before.get(name, 0.0), after.get(name, 0.0))
+            for name in sorted(set(before) | set(after))
+        }
+
 
 @_ffi.register_object("runtime.profiling.Count")
 class Count(Object):
@@ -269,6 +298,49 @@ def profile_function(mod, dev, collectors, func_name=None, warmup_iters=10):
     )
 
 
+def start_trace(capacity: int = 1 << 16) -> None:
+    """Start recording the spans of the runtime in all the threads.
+
+    The calls of the Relax VM, the kernel launches, the parallel launches, the allocations and
+    the copies are recorded in a buffer of each thread, which keeps its latest spans. Starting
+    again drops the spans recorded so far. The runtime built without USE_RUNTIME_TRACE records
+    no span.
+
+    Parameters
+    ----------
+    capacity : int
+        The number of spans kept by each thread.
+    """
+    _ffi.get_global_func("runtime.trace.Start")(capacity)
+
+
+def stop_trace() -> None:
+    """Stop recording the spans of the runtime."""
+    _ffi.get_global_func("runtime.trace.Stop")()
+
+
+def dump_trace(path: Optional[str] = None) -> str:
+    """Get the recorded spans in the Chrome trace format, read by chrome://tracing and Perfetto.
+
+    The spans are read consistently after :py:func:`stop_trace`.
+
+    Parameters
+    ----------
+    path : Optional[str]
+        The file to write the trace to.
+
+    Returns
+    -------
+    trace : str
+        The trace, as a JSON object.
+    """
+    trace = _ffi.get_global_func("runtime.trace.Dump")()
+    if path is not None:
+        with open(path, "w") as trace_file:
+            trace_file.write(trace)
+    return trace
+
+
 # We only enable this class when TVM is build with PAPI support
 if _ffi.get_global_func("runtime.profiling.PAPIMetricCollector", allow_missing=True) is not None:
 
@@ -341,15 +341,17 @@ class VirtualMachine(object):
 
     memory_cfg : str or Dict[tvm.runtime.Device, str], optional
         Config the type of memory allocator. The allocator type can be ["naive",
-        "pooled"]. If memory_cfg is None, all devices will use pooled allocator
-        by default. If memory_cfg is string, all devices will use the specified
-        allocator type. If memory_cfg is a dict, each device uses the allocator
+        "pooled", "best_fit"], where "best_fit" is the size class allocator that reuses the
+        blocks of similar sizes under dynamic shapes. If memory_cfg is None, all devices will
+        use pooled allocator by default. If memory_cfg is string, all devices will use the
+        specified allocator type. If memory_cfg is a dict, each device uses the allocator
         type specified in the dict, or pooled allocator if not specified in the
         dict.
     """
 
     NAIVE_ALLOCATOR = 1
     POOLED_ALLOCATOR = 2
+    BEST_FIT_ALLOCATOR = 3
 
     def __init__(self, exe, device, memory_cfg=None):
         """
@@ -418,9 +420,11 @@ class VirtualMachine(object):
         if memory_cfg is None:
             memory_cfg = {}
         elif isinstance(memory_cfg, str):
-            assert memory_cfg in ["naive", "pooled"]
+            assert memory_cfg in ["naive", "pooled", "best_fit"]
             if memory_cfg == "naive":
                 default_alloc_type = VirtualMachine.NAIVE_ALLOCATOR
+            elif memory_cfg == "best_fit":
+                default_alloc_type = VirtualMachine.BEST_FIT_ALLOCATOR
             memory_cfg = {}
         elif not isinstance(memory_cfg, dict):
             raise TypeError(
@@ -1762,11 +1762,11 @@ def pretty_print(node, show_meta_data=False):
         Whether to include meta data section in the text
         if there is meta data.
     """
-    print(tvm.script._ffi_api.AsRelaxScript(node, show_meta_data))
+    print(tvm.script._ffi_api.AsRelaxScript(node, show_meta_data, 1))
 
 
 # TODO(@altanh): printer stuff should probably live elsewhere?
-def astext(node, show_meta_data=False) -> str:
+def astext(node, show_meta_data=False, num_threads=1) -> str:
     """Returns the Relax text format representation of the given Relax IR node.
 
     Parameters
@@ -1778,6 +1778,10 @@ def astext(node, show_meta_data=False) -> str:
         Whether to include meta data section in the text
         if there is meta data.
 
+    num_threads : int
+        The number of threads printing the PrimFuncs of an IRModule in parallel.
+        Use all the cores if nonpositive. The text is the same for any number of threads.
+
     Returns
     -------
     relax_text: str
@@ -1785,4 +1789,4 @@ def astext(node, show_meta_data=False) -> str:
         If show_meta_data is True, the meta data section will be printed in the beginning
         of the the return string.
     """
-    return tvm.script._ffi_api.AsRelaxScript(node, show_meta_data)
+    return tvm.script._ffi_api.AsRelaxScript(node, show_meta_data, num_threads)
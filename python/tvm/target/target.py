@@ -211,6 +211,14 @@ class Target(Object):
                 return True
         return False
 
+    @property
+    def supports_cooperative_matrix(self):
+        """Returns whether the target lowers the wmma tensor intrinsics to the KHR cooperative
+        matrices of Vulkan."""
+        if self.attrs.get("supports_cooperative_matrix", []):
+            return bool(self.attrs["supports_cooperative_matrix"])
+        return False
+
     @property
     def libs(self):
         return list(self.attrs.get("libs", []))
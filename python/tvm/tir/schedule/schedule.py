@@ -782,6 +782,64 @@ class Schedule(Object):
         """
         return _ffi_api.ScheduleAddUnitLoop(self, block_or_loop)  # type: ignore # pylint: disable=no-member
 
+    @type_checked
+    def set_ragged_extent(self, loop: LoopRV, outer_loop: LoopRV, indptr: str) -> None:
+        """Bound the iterations of a loop over a ragged dimension, e.g. the tokens of the
+        sequences of a batch padded to the longest one, by the length of the row indexed by an
+        outer loop, computed from the prefix sum of the lengths as `indptr[i + 1] - indptr[i]`.
+        The loop keeps its domain in the schedule, and the iterations beyond the row are skipped
+        when lowered, leaving the padding of the outputs unwritten. Since the bound refers to the
+        outer loop var, the loops involved must not be transformed afterwards. It requires:
+        1) The min of the loop is zero.
+        2) The outer loop is an ancestor of the loop.
+        3) The indptr is the name of a 1-D integer buffer parameter of the function.
+
+        Parameters
+        ----------
+        loop : LoopRV
+            The loop over the ragged dimension
+        outer_loop : LoopRV
+            The loop over the rows
+        indptr : str
+            The name of the buffer of the prefix sum of the row lengths
+
+        Examples
+        --------
+
+        Before set_ragged_extent, in TensorIR, the IR is:
+
+        .. code-block:: python
+
+            @T.prim_func
+            def before_set_ragged_extent(
+                A: T.Buffer[(4, 16), "float32"],
+                indptr: T.Buffer[(5,), "int32"],
+                B: T.Buffer[(4, 16), "float32"],
+            ) -> None:
+                for i, j in T.grid(4, 16):
+                    with T.block("B"):
+                        vi, vj = T.axis.remap("SS", [i, j])
+                        B[vi, vj] = A[vi, vj] * 2.0
+
+        Create the schedule and do set_ragged_extent:
+
+        .. code-block:: python
+
+            sch = tir.Schedule(before_set_ragged_extent)
+            i, j = sch.get_loops(sch.get_block("B"))
+            sch.set_ragged_extent(j, i, "indptr")
+
+        After lowering, the loop over `j` becomes:
+
+        .. code-block:: python
+
+            for j in T.serial(T.min(16, indptr[i + 1] - indptr[i])):
+                B[i * 16 + j] = A[i * 16 + j] * T.float32(2)
+        """
+        _ffi_api.ScheduleSetRaggedExtent(  # type: ignore # pylint: disable=no-member
+            self, loop, outer_loop, indptr
+        )
+
     ########## Schedule: Manipulate ForKind ##########
 
     @type_checked
@@ -2933,6 +2991,10 @@ class Schedule(Object):
         each block iter in the order of block iters. The block and it's producer blocks should have
         trivial bindings, i.e. each block iter is bound to a single loop variable. After padding,
         thblock iter extent and the corresponding outer loop is extended by the padding size.
+        For a block iter with a non-constant extent, the exact padding size is unknown when
+        scheduling, and the element is instead the factor that the extent is rounded up to, i.e.
+        the padded extent is `ceildiv(extent, padding) * padding`. A zero leaves the block iter
+        unchanged.
 
         The size of the producer buffers are infered from the padding size of the Einsum
         computation. The producer buffers are padded by the initial value of the corresponding
@@ -71,3 +71,120 @@ VNNI_DOT_16x4_INTRIN = "dot_16x4_vnni"
 TensorIntrin.register(
     VNNI_DOT_16x4_INTRIN, dot_product_16x4_u8i8i32_desc, dot_product_16x4_u8i8i32_vnni
 )
+
+
+# AMX tensorized intrinsics. Each of them accumulates a 16x16 tile of C from the 16 rows of 64
+# bytes of A, and the 16 rows of 64 bytes of B packed in the VNNI layout, i.e. B[k // p, j, k % p]
+# with `p` elements per 4 bytes. The tiles of the calling thread must be configured with 16 rows
+# of 64 bytes before, e.g. with `T.call_packed("runtime.amx_tileconfig", 16, 64)` at the
+# beginning of the kernel, or of each parallel task, which requires building with USE_AMX.
+
+
+def get_amx_dot_intrin(lhs_dtype, rhs_dtype, out_dtype, llvm_intrin):
+    """Generator of the AMX dot product intrins, tiles 0, 1 and 2 holding C, A and B."""
+    pack = 2 if lhs_dtype == "bfloat16" else 4
+    in_bytes = 4 // pack
+    k_dim = 64 // in_bytes
+
+    @T.prim_func
+    def amx_dot_desc(a: T.handle, b: T.handle, c: T.handle) -> None:
+        A = T.match_buffer(a, (16, k_dim), lhs_dtype, offset_factor=1)
+        B = T.match_buffer(b, (k_dim // pack, 16, pack), rhs_dtype, offset_factor=1)
+        C = T.match_buffer(c, (16, 16), out_dtype, offset_factor=1)
+        with T.block("root"):
+            T.reads(C[0:16, 0:16], A[0:16, 0:k_dim], B[0 : k_dim // pack, 0:16, 0:pack])
+            T.writes(C[0:16, 0:16])
+            for i, j, k in T.grid(16, 16, k_dim):
+                with T.block("update"):
+                    vi, vj, vk = T.axis.remap("SSR", [i, j, k])
+                    C[vi, vj] = C[vi, vj] + T.cast(A[vi, vk], out_dtype) * T.cast(
+                        B[vk // pack, vj, vk % pack], out_dtype
+                    )
+
+    @T.prim_func
+    def amx_dot_impl(a: T.handle, b: T.handle, c: T.handle) -> None:
+        sa = T.var("int32")
+        sb = T.var("int32")
+        sc = T.var("int32")
+        A = T.match_buffer(a, (16, k_dim), lhs_dtype, offset_factor=1, strides=[sa, 1])
+        B = T.match_buffer(
+            b, (k_dim // pack, 16, pack), rhs_dtype, offset_factor=1, strides=[sb, pack, 1]
+        )
+        C = T.match_buffer(c, (16, 16), out_dtype, offset_factor=1, strides=[sc, 1])
+        with T.block("root"):
+            T.reads(C[0:16, 0:16], A[0:16, 0:k_dim], B[0 : k_dim // pack, 0:16, 0:pack])
+            T.writes(C[0:16, 0:16])
+            T.evaluate(
+                T.call_llvm_intrin(
+                    T.llvm_lookup_intrinsic_id("llvm.x86.tileloadd64"),
+                    T.uint32(0),
+                    T.uint8(0),
+                    C.access_ptr("r"),
+                    T.cast(sc * 4, "int64"),
+                    dtype="int32",
+                )
+            )
+            T.evaluate(
+                T.call_llvm_intrin(
+                    T.llvm_lookup_intrinsic_id("llvm.x86.tileloadd64"),
+                    T.uint32(0),
+                    T.uint8(1),
+                    A.access_ptr("r"),
+                    T.cast(sa * in_bytes, "int64"),
+                    dtype="int32",
+                )
+            )
+            T.evaluate(
+                T.call_llvm_intrin(
+                    T.llvm_lookup_intrinsic_id("llvm.x86.tileloadd64"),
+                    T.uint32(0),
+                    T.uint8(2),
+                    B.access_ptr("r"),
+                    T.cast(sb * in_bytes, "int64"),
+                    dtype="int32",
+                )
+            )
+            T.evaluate(
+                T.call_llvm_intrin(
+                    T.llvm_lookup_intrinsic_id(llvm_intrin),
+                    T.uint32(0),
+                    T.uint8(0),
+                    T.uint8(1),
+                    T.uint8(2),
+                    dtype="int32",
+                )
+            )
+            T.evaluate(
+                T.call_llvm_intrin(
+                    T.llvm_lookup_intrinsic_id("llvm.x86.tilestored64"),
+                    T.uint32(0),
+                    T.uint8(0),
+                    C.access_ptr("w"),
+                    T.cast(sc * 4, "int64"),
+                    dtype="int32",
+                )
+            )
+
+    return amx_dot_desc, amx_dot_impl
+
+
+AMX_DOT_16x16x64_I8I8I32_INTRIN = "dot_16x16x64_amx_i8i8i32"
+
+TensorIntrin.register(
+    AMX_DOT_16x16x64_I8I8I32_INTRIN,
+    *get_amx_dot_intrin("int8", "int8", "int32", "llvm.x86.tdpbssd"),
+)
+
+AMX_DOT_16x16x64_U8I8I32_INTRIN = "dot_16x16x64_amx_u8i8i32"
+
+TensorIntrin.register(
+    AMX_DOT_16x16x64_U8I8I32_INTRIN,
+    *get_amx_dot_intrin("uint8", "int8", "int32", "llvm.x86.tdpbusd"),
+)
+
+AMX_DOT_16x16x32_BF16_INTRIN = "dot_16x16x32_amx_bf16"
+
+TensorIntrin.register(
+    AMX_DOT_16x16x32_BF16_INTRIN,
+    *get_amx_dot_intrin("bfloat16", "bfloat16", "float32", "llvm.x86.tdpbf16ps"),
+)
@@ -58,6 +58,22 @@ def InjectPrefetch():
     return _ffi_api.InjectPrefetch()  # type: ignore
 
 
+def InjectSoftwarePrefetch():
+    """Prefetch the global memory read by the future iterations of the loops annotated with
+    "software_prefetch_distance", e.g. by `sch.annotate(loop, "software_prefetch_distance", 8)`.
+
+    For each distinct load in the loop body whose flattened index depends on the loop var, a
+    prefetch of the address read `distance` iterations ahead is inserted at the beginning of the
+    body, so that the loads of bandwidth-bound loops overlap with their compute.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.InjectSoftwarePrefetch()  # type: ignore
+
+
 def ApplyLayoutTransforms():
     """Reshape buffers that appear in the "layout_transform_map"
     fucntion attribute.
@@ -173,6 +189,13 @@ def VectorizeLoop(enable_vectorize: bool = True):
         Whether vectorization is enabled.
         Will lower to scalar loop when it is turned off.
 
+    Note
+    ----
+    With the config ``{"tir.VectorizeLoop": {"enable_predication": True}}``, the stores guarded by
+    a vector condition, e.g. the tail predicate ``i0 * lanes + i1 < n`` of a loop with symbolic
+    extent split by the lanes, are lowered to masked loads and stores instead of being scalarized.
+    Only the LLVM targets support the masked loads and stores.
+
     Returns
     -------
     fpass : tvm.transform.Pass
@@ -330,6 +353,41 @@ def BF16TypeLowering():
     return _ffi_api.BF16TypeLowering()  # type: ignore
 
 
+def FP8Legalize():
+    """Legalize the e4m3 and e5m2 float8 typed Ops.
+    Runs FP8Promote and FP8TypeLowering
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.FP8Legalize()  # type: ignore
+
+
+def FP8Promote():
+    """Promote float8 typed Ops to fp32, and cast the results back to float8.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.FP8Promote()  # type: ignore
+
+
+def FP8TypeLowering():
+    """Replace all float8 types with uint8. Also lower the casting between fp32 and float8 to
+    bit manipulations, rounding to the nearest even and saturating the overflows.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.FP8TypeLowering()  # type: ignore
+
+
 def CommonSubexprElimTIR(enable_cse_tir: bool = True, identify_equiv_terms: bool = False):
     """Replace redundant computations by new variables.
 
@@ -410,6 +468,11 @@ def MakePackedAPI():
     `DLTensor` of shape `[16,32]`, will define `n = 16` and `n=32`, based
     on the argument's shape.
 
+    With the pass config `tir.make_unchecked_api`, each PrimFunc also gets an entry suffixed by
+    `_unchecked` with the same signature, which skips the assertions on the number, the type
+    codes and the `DLTensor` fields of its arguments, for the trusted callers such as the VM
+    calling kernels whose shapes are verified at compile time.
+
     Returns
     -------
     fpass : tvm.transform.Pass
@@ -827,7 +890,8 @@ def LowerOpaqueBlock():
 
 def FlattenBuffer():
     """Flatten the multi-dimensional BufferLoad and BufferStore to single dimensional
-    BufferLoad/BufferStore for the TIR not contains opaque block.
+    BufferLoad/BufferStore for the TIR not contains opaque block. The loops with a ragged extent
+    are bounded by it, see :py:meth:`tvm.tir.Schedule.set_ragged_extent`.
 
     Returns
     -------
@@ -60,6 +60,10 @@ class BufferInfo(Object):
     alignment : Optional[int]
         The byte alignment required in the workspace memory
 
+    access_bytes : int
+        The estimated bytes read from and written to the buffer, which the "tiered_by_access"
+        algorithm uses to place the most accessed buffers in the fastest pools
+
     """
 
     def __init__(
@@ -68,6 +72,7 @@ class BufferInfo(Object):
         size_bytes: int,
         pool_candidates: List[PoolInfo],
         alignment: Optional[int] = None,
+        access_bytes: int = 0,
     ):
         self.__init_handle_by_constructor__(
             _ffi_api.BufferInfo,  # type: ignore # pylint: disable=no-member
@@ -75,6 +80,7 @@ class BufferInfo(Object):
             size_bytes,
             pool_candidates,
             alignment,
+            access_bytes,
         )
 
     def set_conflicts(self, conflicts: list):
@@ -0,0 +1,136 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name
+"""Scaled dot-product attention with an online softmax on GPU.
+
+A thread block handles a tile of queries of one batch and head, one query per thread. The tiles of
+the keys and the values are staged in shared memory, the scores of a query and its partial output
+are kept in registers, see topi.nn.flash_attention for the online softmax.
+"""
+import tvm
+from tvm import te, tir
+
+from ..nn.flash_attention import accumulate_tile, attention_shape, kv_end
+from ..utils import ceil_div
+
+
+def _sync(ib):
+    ib.emit(tvm.tir.Call(None, "tir.tvm_storage_sync", tvm.runtime.convert(["shared"])))
+
+
+def _flash_attention_ir(query, key, value, out, scale, causal, q_tile, kv_tile):
+    ib = tvm.tir.ir_builder.create()
+    batch, seq_len, num_heads, head_dim = query.shape
+    kv_len = key.shape[1]
+    head_dim_v = value.shape[3]
+    q = ib.buffer_ptr(query)
+    k = ib.buffer_ptr(key)
+    v = ib.buffer_ptr(value)
+    o = ib.buffer_ptr(out)
+    acc_dtype = "float32"
+
+    num_q_tiles = ceil_div(seq_len, q_tile)
+    tx = te.thread_axis("threadIdx.x")
+    bx = te.thread_axis("blockIdx.x")
+    ib.scope_attr(tx, "thread_extent", q_tile)
+    ib.scope_attr(bx, "thread_extent", batch * num_heads * num_q_tiles)
+    b = bx // (num_heads * num_q_tiles)
+    h = bx // num_q_tiles % num_heads
+    first = bx % num_q_tiles * q_tile
+    i = first + tx
+    end = kv_end(causal, i, seq_len, kv_len)
+    # all the threads of the block go over the keys of its last query, for the loads and syncs
+    block_end = kv_end(causal, te.min(first + q_tile, seq_len) - 1, seq_len, kv_len)
+
+    k_shared = ib.allocate(acc_dtype, (kv_tile * head_dim,), name="k_shared", scope="shared")
+    v_shared = ib.allocate(acc_dtype, (kv_tile * head_dim_v,), name="v_shared", scope="shared")
+    q_local = ib.allocate(acc_dtype, (head_dim,), name="q_local", scope="local")
+    scores = ib.allocate(acc_dtype, (kv_tile,), name="scores", scope="local")
+    acc = ib.allocate(acc_dtype, (head_dim_v,), name="acc", scope="local")
+    state = ib.allocate(acc_dtype, (3,), name="state", scope="local")
+    state[0] = tir.min_value(acc_dtype)
+    state[1] = tir.const(0, acc_dtype)
+    with ib.for_range(0, head_dim_v, name="d") as d:
+        acc[d] = tir.const(0, acc_dtype)
+    with ib.for_range(0, head_dim, name="d") as d:
+        q_local[d] = tir.const(0, acc_dtype)
+    with ib.if_scope(i < seq_len):
+        with ib.for_range(0, head_dim, name="d") as d:
+            q_local[d] = q[b, i, h, d].astype(acc_dtype) * tir.const(scale, acc_dtype)
+
+    with ib.for_range(0, ceil_div(block_end, kv_tile), name="tile") as t:
+        _sync(ib)
+        for shared, src, dim in [(k_shared, k, head_dim), (v_shared, v, head_dim_v)]:
+            with ib.for_range(0, ceil_div(kv_tile * dim, q_tile), name="it") as it:
+                e = it * q_tile + tx
+                with ib.if_scope(e < kv_tile * dim):
+                    j = t * kv_tile + e // dim
+                    shared[e] = tir.if_then_else(
+                        j < kv_len, src[b, j, h, e % dim].astype(acc_dtype), tir.const(0, acc_dtype)
+                    )
+        _sync(ib)
+
+        with ib.if_scope(i < seq_len):
+            state[2] = state[0]
+            with ib.for_range(0, kv_tile, name="jj") as jj:
+                with ib.if_scope(t * kv_tile + jj < end):
+                    scores[jj] = tir.const(0, acc_dtype)
+                    with ib.for_range(0, head_dim, name="d") as d:
+                        scores[jj] = scores[jj] + q_local[d] * k_shared[jj * head_dim + d]
+                    state[2] = tir.max(state[2], scores[jj])
+            accumulate_tile(
+                ib,
+                state,
+                scores,
+                acc,
+                end - t * kv_tile,
+                head_dim_v,
+                lambda jj, d: v_shared[jj * head_dim_v + d],
+            )
+
+    with ib.if_scope(i < seq_len):
+        with ib.for_range(0, head_dim_v, name="d") as d:
+            o[b, i, h, d] = tir.if_then_else(
+                state[1] > 0, acc[d] / state[1], tir.const(0, acc_dtype)
+            ).astype(out.dtype)
+    return ib.get()
+
+
+def flash_attention(query, key, value, scale=None, causal=False, q_tile=64, kv_tile=32):
+    """Scaled dot-product attention with an online softmax on GPU, see
+    :py:func:`tvm.topi.nn.flash_attention` for the parameters.
+
+    Parameters
+    ----------
+    q_tile : int
+        The number of queries of a thread block, which is its number of threads.
+
+    kv_tile : int
+        The number of keys and values staged in shared memory at a time. The tiles take
+        kv_tile * (head_dim + head_dim_v) * 4 bytes of shared memory.
+    """
+    out_shape, scale = attention_shape(query, key, value, scale)
+    return te.extern(
+        [out_shape],
+        [query, key, value],
+        lambda ins, outs: _flash_attention_ir(
+            ins[0], ins[1], ins[2], outs[0], scale, causal, q_tile, kv_tile
+        ),
+        dtype=[query.dtype],
+        name="flash_attention",
+        tag="flash_attention",
+    )
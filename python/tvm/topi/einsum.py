@@ -19,7 +19,15 @@
 from . import cpp
 
 
-def einsum(subscripts, *operand):
+def _optimize_mode(optimize):
+    if optimize is True:
+        return "greedy"
+    if optimize is False or optimize is None:
+        return "none"
+    return optimize
+
+
+def einsum(subscripts, *operand, optimize=False):
     """Evaluates the Einstein summation convention on the operands.
 
     Parameters
@@ -35,10 +43,43 @@ def einsum(subscripts, *operand):
         The only difference of einsum between in tvm and numpy is it needs an extra brackets
         for the tensors. For example, topi.einsum("ij, jk -> ik", (A, B)).
 
+    optimize : {False, True, "greedy", "optimal"}
+        As in numpy.einsum, whether to contract the operands pairwise in the order found by
+        einsum_path, True meaning "greedy". Each pairwise contraction is a batched matmul.
+        False computes the whole summation in a single nested loop, as do the summations with
+        an ellipsis, repeated labels in a subscript or broadcast extents.
+
     Returns
     -------
     out : tvm.te.Tensor
         The calculation based on the Einstein summation convention.
     """
 
-    return cpp.einsum(subscripts, operand)
+    return cpp.einsum(subscripts, operand, _optimize_mode(optimize))
+
+
+def einsum_path(subscripts, *operand, optimize="greedy"):
+    """Find the order of the pairwise contractions of an Einstein summation.
+
+    Parameters
+    ----------
+    subscripts : string
+        The subscripts of the summation, as in einsum.
+
+    operand : tuple of tvm.te.Tensor
+        The operands of the summation.
+
+    optimize : {True, "greedy", "optimal"}
+        "greedy" contracts first the pair of the smallest result, "optimal" searches all the
+        orders for the fewest multiply-adds, falling back to "greedy" beyond 6 operands.
+
+    Returns
+    -------
+    path : list of tuple of int
+        The positions of the pair contracted at each step, in the list of the operands from
+        which the previous pairs are removed and to which their results are appended, as the
+        path of numpy.einsum_path. Empty when the summation cannot be contracted pairwise.
+    """
+    shapes = [operand_i.shape for operand_i in operand]
+    path = cpp.einsum_path(subscripts, shapes, _optimize_mode(optimize))
+    return [tuple(int(x) for x in pair) for pair in path]
@@ -53,3 +53,4 @@ from .space_to_batch_nd import *
 from .batch_to_space_nd import *
 from .loss import *
 from .lstm import *
+from .flash_attention import *
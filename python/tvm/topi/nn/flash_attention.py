@@ -0,0 +1,170 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name
+"""Scaled dot-product attention with an online softmax.
+
+The scores of a query are computed a tile of keys at a time. The softmax is accumulated with a
+running max and a running sum of the exponentials, rescaling the partial output whenever the max
+grows, so that the memory of the kernel is linear in the sequence length rather than holding the
+seq_len x kv_seq_len matrix of the scores.
+"""
+import math
+
+import tvm
+from tvm import te, tir
+
+from ..utils import ceil_div
+
+
+def attention_shape(query, key, value, scale):
+    """Check the head dimensions, which must be static, and get the shape of the output and the
+    scale of the scores."""
+    del key
+    head_dim, head_dim_v = query.shape[3], value.shape[3]
+    if not isinstance(head_dim, tir.IntImm) or not isinstance(head_dim_v, tir.IntImm):
+        raise ValueError(
+            "flash_attention requires static head dimensions, got %s and %s"
+            % (head_dim, head_dim_v)
+        )
+    if not scale:
+        scale = 1.0 / math.sqrt(int(head_dim))
+    return (query.shape[0], query.shape[1], query.shape[2], head_dim_v), scale
+
+
+def kv_end(causal, i, seq_len, kv_len):
+    """The end of the keys attended to by the query at position i."""
+    if not causal:
+        return kv_len
+    return te.max(te.min(kv_len, i + kv_len - seq_len + 1), 0)
+
+
+def accumulate_tile(ib, state, scores, acc, num_keys, head_dim_v, value_at):
+    """Fold the scores of a tile of keys into the running softmax.
+
+    state holds the running max, the running sum of the exponentials and the max of the tile,
+    which must have been computed into state[2] with the scores. value_at(jj, d) is the element d
+    of the value of the key jj of the tile, passed when jj < num_keys.
+    """
+    acc_dtype = acc.dtype
+    # rescale the partial sums to the new max
+    corr = ib.allocate(acc_dtype, (1,), name="corr", scope="local")
+    corr[0] = tir.exp(state[0] - state[2])
+    state[0] = state[2]
+    state[1] = state[1] * corr[0]
+    with ib.for_range(0, head_dim_v, name="d") as d:
+        acc[d] = acc[d] * corr[0]
+    with ib.for_range(0, scores.shape[0], name="jj") as jj:
+        with ib.if_scope(jj < num_keys):
+            scores[jj] = tir.exp(scores[jj] - state[0])
+            state[1] = state[1] + scores[jj]
+            with ib.for_range(0, head_dim_v, name="d") as d:
+                acc[d] = acc[d] + scores[jj] * value_at(jj, d)
+
+
+def _flash_attention_ir(query, key, value, out, scale, causal, kv_tile):
+    ib = tvm.tir.ir_builder.create()
+    batch, seq_len, num_heads, head_dim = query.shape
+    kv_len = key.shape[1]
+    head_dim_v = value.shape[3]
+    q = ib.buffer_ptr(query)
+    k = ib.buffer_ptr(key)
+    v = ib.buffer_ptr(value)
+    o = ib.buffer_ptr(out)
+    acc_dtype = "float32"
+
+    with ib.for_range(0, batch * num_heads * seq_len, kind="parallel", name="row") as row:
+        b = row // (num_heads * seq_len)
+        h = row // seq_len % num_heads
+        i = row % seq_len
+        end = kv_end(causal, i, seq_len, kv_len)
+        scores = ib.allocate(acc_dtype, (kv_tile,), name="scores", scope="local")
+        acc = ib.allocate(acc_dtype, (head_dim_v,), name="acc", scope="local")
+        state = ib.allocate(acc_dtype, (3,), name="state", scope="local")
+        state[0] = tir.min_value(acc_dtype)
+        state[1] = tir.const(0, acc_dtype)
+        with ib.for_range(0, head_dim_v, name="d") as d:
+            acc[d] = tir.const(0, acc_dtype)
+
+        with ib.for_range(0, ceil_div(end, kv_tile), name="tile") as t:
+            state[2] = state[0]
+            with ib.for_range(0, kv_tile, name="jj") as jj:
+                j = t * kv_tile + jj
+                with ib.if_scope(j < end):
+                    scores[jj] = tir.const(0, acc_dtype)
+                    with ib.for_range(0, head_dim, name="d") as d:
+                        scores[jj] = scores[jj] + q[b, i, h, d].astype(acc_dtype) * k[
+                            b, j, h, d
+                        ].astype(acc_dtype)
+                    scores[jj] = scores[jj] * tir.const(scale, acc_dtype)
+                    state[2] = tir.max(state[2], scores[jj])
+            accumulate_tile(
+                ib,
+                state,
+                scores,
+                acc,
+                end - t * kv_tile,
+                head_dim_v,
+                lambda jj, d: v[b, t * kv_tile + jj, h, d].astype(acc_dtype),
+            )
+
+        with ib.for_range(0, head_dim_v, name="d") as d:
+            o[b, i, h, d] = tir.if_then_else(
+                state[1] > 0, acc[d] / state[1], tir.const(0, acc_dtype)
+            ).astype(out.dtype)
+    return ib.get()
+
+
+def flash_attention(query, key, value, scale=None, causal=False, kv_tile=32):
+    """Scaled dot-product attention with an online softmax, parallel over the queries.
+
+    Parameters
+    ----------
+    query : tvm.te.Tensor
+        4-D with shape [batch, seq_len, num_heads, head_dim].
+
+    key : tvm.te.Tensor
+        4-D with shape [batch, kv_seq_len, num_heads, head_dim].
+
+    value : tvm.te.Tensor
+        4-D with shape [batch, kv_seq_len, num_heads, head_dim_v].
+
+    scale : Optional[float]
+        The scale of the scores, 1 / sqrt(head_dim) if None.
+
+    causal : bool
+        Whether the query at position i only attends to the keys up to the position
+        i + kv_seq_len - seq_len. A query attending to no key gets zeros.
+
+    kv_tile : int
+        The number of keys whose scores are computed at a time.
+
+    Returns
+    -------
+    out : tvm.te.Tensor
+        4-D with shape [batch, seq_len, num_heads, head_dim_v], accumulated in float32.
+    """
+    out_shape, scale = attention_shape(query, key, value, scale)
+    return te.extern(
+        [out_shape],
+        [query, key, value],
+        lambda ins, outs: _flash_attention_ir(
+            ins[0], ins[1], ins[2], outs[0], scale, causal, kv_tile
+        ),
+        dtype=[query.dtype],
+        name="flash_attention",
+        tag="flash_attention",
+    )
@@ -193,6 +193,106 @@ def roofline_from_existing(
     return profiling.Report(new_calls, report.device_metrics, new_configuration)
 
 
+def roofline_from_counters(
+    report: profiling.Report,
+    mod: IRModule,
+    target: Target,
+    dev: Device,
+    remote: Optional[RPCSession] = None,
+    bytes_metric: str = "perf::CACHE-MISSES",
+    cache_line_bytes: int = 64,
+) -> profiling.Report:
+    """Add roofline statistics measured by hardware counters to an existing profiling report.
+
+    Unlike :py:func:`roofline_from_existing`, which estimates the bytes loaded by each
+    operator from its TIR features, the bytes are measured: the lines missing the last level
+    cache, counted by `bytes_metric` of a :py:class:`PAPIMetricCollector`, are moved from
+    memory. The FLOPs are estimated by :py:func:`tvm.tir.analysis.estimate_tir_flops`. The calls
+    are matched to the PrimFuncs of `mod` by name, so this works with the reports of every
+    executor, including the Relax VM.
+
+    Example
+    -------
+
+    ..code: : python
+
+        ex = relax.vm.build(mod, target)
+        vm = relax.VirtualMachine(ex, tvm.cpu())
+        papi = tvm.runtime.profiling.PAPIMetricCollector()
+        report = vm.profile("main", *inputs, collectors=[papi])
+        roofline_report = roofline_from_counters(report, mod, target, tvm.cpu())
+
+    Parameters
+    ----------
+    report : Report
+        Existing profiling report, with the counters of `bytes_metric` in its calls.
+    mod : IRModule
+        The module containing the PrimFuncs called in `report`.
+    target : Target
+        TVM target that `report` was generated with.
+    dev : Device
+        Device that `report` was generated with.
+    remote : Optional[RPCSession]
+      Remote session used to upload artifacts for runtime evaluation. Must be
+      the same session used to create `dev`.
+    bytes_metric : str
+        The counter of the cache lines moved from memory.
+    cache_line_bytes : int
+        The bytes of a cache line.
+
+    Returns
+    -------
+    profiling.Report
+        New profiling report that includes all information from `report` along with the
+        roofline metrics of :py:func:`roofline_analysis`, where "Loaded Bytes" is measured.
+    """
+    with target:
+        peak_bandwidth = registry.estimate_peak_bandwidth(target, dev, remote)
+        peak_flops = registry.estimate_peak_flops(target, dev, remote)
+
+    ridge_point = peak_flops / peak_bandwidth
+
+    all_flops = {}
+    for gvar, prim in mod.functions.items():
+        if isinstance(prim, tir.PrimFunc):
+            name = prim.attrs["global_symbol"] if "global_symbol" in prim.attrs else gvar.name_hint
+            all_flops[str(name)] = tir.analysis.estimate_tir_flops(IRModule({gvar: prim}))
+
+    new_calls = []
+    for call in report.calls:
+        name = str(call["Name"])
+        if name not in all_flops or bytes_metric not in call.keys():
+            new_calls.append(call)
+            continue
+        # The counts of the calls aggregated in a row are summed along with their durations.
+        count = call["Count"].value if "Count" in call.keys() else 1
+        flops = all_flops[name] * count
+        loaded_bytes = call[bytes_metric].value * cache_line_bytes
+        runtime = call["Duration (us)"].microseconds * 1e-6
+        if loaded_bytes <= 0 or runtime <= 0:
+            new_calls.append(call)
+            continue
+        arith_inten = flops / loaded_bytes
+        call = dict(call)
+        call["Loaded Bytes"] = profiling.Count(int(loaded_bytes))
+        call["Estimated FLOPs"] = profiling.Count(int(flops))
+        call["Arithmetic Intensity"] = profiling.Ratio(arith_inten)
+        call["FLOP/s"] = profiling.Ratio(flops / runtime)
+        call["Bandwidth"] = profiling.Ratio(loaded_bytes / runtime)
+        compute_bound = arith_inten > ridge_point
+        call["Bound"] = "compute" if compute_bound else "memory"
+        per_mem_bound = (loaded_bytes / runtime) / peak_bandwidth * 100
+        per_compute_bound = (flops / runtime) / peak_flops * 100.0
+        call["Percent of Theoretical Optimal"] = profiling.Ratio(
+            per_compute_bound if compute_bound else per_mem_bound
+        )
+        new_calls.append(call)
+    new_configuration = dict(report.configuration.items())
+    new_configuration["Estimated Peak FLOP/s"] = profiling.Ratio(peak_flops)
+    new_configuration["Estimated Peak Bandwidth (byte/second)"] = profiling.Ratio(peak_bandwidth)
+    return profiling.Report(new_calls, report.device_metrics, new_configuration)
+
+
 def roofline_analysis(
     mod: IRModule,
     params: Dict[str, nd.NDArray],
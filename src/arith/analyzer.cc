@@ -21,13 +21,106 @@
  * \file tvm/arith/analyzer.cc
  */
 #include <tvm/arith/analyzer.h>
+#include <tvm/node/structural_equal.h>
+#include <tvm/node/structural_hash.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/tir/expr.h>
 #include <tvm/tir/op.h>
 
+#include <unordered_map>
+
+#include "../support/utils.h"
+
 namespace tvm {
 namespace arith {
 
+/*!
+ * \brief The results of Simplify under the current state of the analyzer, and the results of
+ * the enclosing constraint scopes, restored when the scopes exit.
+ */
+class Analyzer::SimplifyCache {
+ public:
+  /*! \brief The cached results are dropped beyond this size, to bound the memory. */
+  static constexpr size_t kMaxSize = 1 << 16;
+
+  Optional<PrimExpr> Lookup(const PrimExpr& expr, int steps,
+                            RewriteSimplifier::Extension extensions) {
+    if (extensions != extensions_) {
+      Invalidate();
+      extensions_ = extensions;
+      return NullOpt;
+    }
+    auto it = table_.find(Key{expr, steps});
+    if (it == table_.end()) return NullOpt;
+    ++stats_.num_hits;
+    return it->second;
+  }
+
+  void Insert(const PrimExpr& expr, int steps, const PrimExpr& result) {
+    if (table_.size() >= kMaxSize) table_.clear();
+    table_.emplace(Key{expr, steps}, result);
+    ++stats_.num_misses;
+  }
+
+  /*! \brief Drop the results, as the state of the analyzer changes beyond the current scope. */
+  void Invalidate() {
+    if (!table_.empty()) ++stats_.num_invalidations;
+    table_.clear();
+    ++generation_;
+  }
+
+  /*!
+   * \brief Start an empty cache for a constraint scope.
+   * \return The function restoring the results of the enclosing scope, if no var is bound
+   * within the scope.
+   */
+  static std::function<void()> EnterScope(const std::shared_ptr<SimplifyCache>& cache) {
+    auto outer = std::make_shared<Table>();
+    std::swap(*outer, cache->table_);
+    int64_t generation = cache->generation_;
+    std::weak_ptr<SimplifyCache> weak_cache = cache;
+    return [weak_cache, outer, generation]() {
+      std::shared_ptr<SimplifyCache> cache = weak_cache.lock();
+      if (cache == nullptr) return;
+      if (cache->generation_ == generation) {
+        std::swap(*outer, cache->table_);
+      } else {
+        cache->table_.clear();
+      }
+    };
+  }
+
+  const SimplifyCacheStats& stats() const { return stats_; }
+
+ private:
+  struct Key {
+    PrimExpr expr;
+    int steps;
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const {
+      return support::HashCombine(StructuralHash()(key.expr), key.steps);
+    }
+  };
+
+  struct KeyEqual {
+    bool operator()(const Key& lhs, const Key& rhs) const {
+      return lhs.steps == rhs.steps && StructuralEqual()(lhs.expr, rhs.expr);
+    }
+  };
+
+  using Table = std::unordered_map<Key, PrimExpr, KeyHash, KeyEqual>;
+
+  /*! \brief The results under the current state. */
+  Table table_;
+  /*! \brief The number of invalidations, to tell if the state changes within a scope. */
+  int64_t generation_ = 0;
+  /*! \brief The extensions of the rewrite simplifier the results are found with. */
+  RewriteSimplifier::Extension extensions_ = RewriteSimplifier::kNone;
+  SimplifyCacheStats stats_;
+};
+
 Analyzer::Analyzer()
     : const_int_bound(this),
       modular_set(this),
@@ -35,7 +128,10 @@ Analyzer::Analyzer()
       canonical_simplify(this),
       int_set(this) {}
 
+Analyzer::~Analyzer() = default;
+
 void Analyzer::Bind(const Var& var, const PrimExpr& expr, bool allow_override) {
+  ClearSimplifyCache();
   PrimExpr new_expr = expr;
   new_expr = this->canonical_simplify(new_expr);
   new_expr = this->rewrite_simplify(new_expr);
@@ -50,6 +146,7 @@ void Analyzer::Bind(const Var& var, const PrimExpr& expr, bool allow_override) {
 
 void Analyzer::Bind(const Var& var, const Range& range, bool allow_override) {
   ICHECK(range.defined());
+  ClearSimplifyCache();
   if (tir::is_one(range->extent)) {
     this->Bind(var, range->min, allow_override);
   } else {
@@ -75,6 +172,10 @@ void ConstraintContext::EnterWithScope() {
   recovery_functions_.push_back(analyzer_->rewrite_simplify.EnterConstraint(constraint_));
   recovery_functions_.push_back(analyzer_->int_set.EnterConstraint(constraint_));
   recovery_functions_.push_back(analyzer_->transitive_comparisons.EnterConstraint(constraint_));
+  if (analyzer_->simplify_cache_ != nullptr) {
+    recovery_functions_.push_back(
+        Analyzer::SimplifyCache::EnterScope(analyzer_->simplify_cache_));
+  }
 }
 
 void ConstraintContext::ExitWithScope() {
@@ -127,6 +228,18 @@ bool Analyzer::CanProve(const PrimExpr& expr) {
 }
 
 PrimExpr Analyzer::Simplify(const PrimExpr& expr, int steps) {
+  if (simplify_cache_ == nullptr || tir::is_const_int(expr)) {
+    return SimplifyUncached(expr, steps);
+  }
+  Optional<PrimExpr> cached =
+      simplify_cache_->Lookup(expr, steps, rewrite_simplify.GetEnabledExtensions());
+  if (cached.defined()) return cached.value();
+  PrimExpr res = SimplifyUncached(expr, steps);
+  simplify_cache_->Insert(expr, steps, res);
+  return res;
+}
+
+PrimExpr Analyzer::SimplifyUncached(const PrimExpr& expr, int steps) {
   PrimExpr res = expr;
 
   for (int i = 0; i < steps; ++i) {
@@ -143,6 +256,22 @@ PrimExpr Analyzer::Simplify(const PrimExpr& expr, int steps) {
   return res;
 }
 
+void Analyzer::EnableSimplifyCache(bool enable) {
+  if (!enable) {
+    simplify_cache_ = nullptr;
+  } else if (simplify_cache_ == nullptr) {
+    simplify_cache_ = std::make_shared<SimplifyCache>();
+  }
+}
+
+void Analyzer::ClearSimplifyCache() {
+  if (simplify_cache_ != nullptr) simplify_cache_->Invalidate();
+}
+
+SimplifyCacheStats Analyzer::GetSimplifyCacheStats() const {
+  return simplify_cache_ != nullptr ? simplify_cache_->stats() : SimplifyCacheStats();
+}
+
 TVM_REGISTER_GLOBAL("arith.CreateAnalyzer").set_body([](TVMArgs args, TVMRetValue* ret) {
   using runtime::PackedFunc;
   using runtime::TypedPackedFunc;
@@ -157,6 +286,7 @@ TVM_REGISTER_GLOBAL("arith.CreateAnalyzer").set_body([](TVMArgs args, TVMRetValu
     } else if (name == "const_int_bound_update") {
       return PackedFunc([self](TVMArgs args, TVMRetValue* ret) {
         self->const_int_bound.Update(args[0], args[1], args[2]);
+        self->ClearSimplifyCache();
       });
     } else if (name == "Simplify") {
       return PackedFunc([self](TVMArgs args, TVMRetValue* ret) {
@@ -197,6 +327,17 @@ TVM_REGISTER_GLOBAL("arith.CreateAnalyzer").set_body([](TVMArgs args, TVMRetValu
     } else if (name == "can_prove_equal") {
       return PackedFunc(
           [self](TVMArgs args, TVMRetValue* ret) { *ret = self->CanProveEqual(args[0], args[1]); });
+    } else if (name == "enable_simplify_cache") {
+      return PackedFunc(
+          [self](TVMArgs args, TVMRetValue* ret) { self->EnableSimplifyCache(args[0]); });
+    } else if (name == "simplify_cache_stats") {
+      return PackedFunc([self](TVMArgs args, TVMRetValue* ret) {
+        SimplifyCacheStats stats = self->GetSimplifyCacheStats();
+        DataType dtype = DataType::Int(64);
+        *ret = Map<String, IntImm>{{"num_hits", IntImm(dtype, stats.num_hits)},
+                                   {"num_misses", IntImm(dtype, stats.num_misses)},
+                                   {"num_invalidations", IntImm(dtype, stats.num_invalidations)}};
+      });
     }
     return PackedFunc();
   };
@@ -1097,6 +1097,59 @@ bool IterRangeSanityCheck(const Map<Var, Range>& iter_ranges) {
   return true;
 }
 
+/*!
+ * \brief Map the indices made of distinct input iterators and constants only, e.g. the block
+ *  iters bound to loop vars, without the rewriting and the checks of IterMapRewriter. The
+ *  result is structurally equal to the one of the general algorithm.
+ * \return The mapped indices, or NullOpt if the indices are not of this pattern.
+ */
+Optional<Array<IterSumExpr>> DetectTrivialIterMap(const Array<PrimExpr>& indices,
+                                                  const Map<Var, Range>& input_iters,
+                                                  IterMapLevel check_level,
+                                                  arith::Analyzer* analyzer,
+                                                  bool simplify_trivial_iterators) {
+  std::unordered_set<const VarNode*> used_iters;
+  Array<IterSumExpr> results;
+  results.reserve(indices.size());
+  for (const PrimExpr& index : indices) {
+    if (index->IsInstance<IntImmNode>()) {
+      results.push_back(IterSumExpr({}, index));
+      continue;
+    }
+    const auto* var = index.as<VarNode>();
+    if (var == nullptr) return NullOpt;
+    Optional<Range> range = input_iters.Get(GetRef<Var>(var));
+    if (!range.defined()) return NullOpt;
+    if (simplify_trivial_iterators && is_one(range.value()->extent)) {
+      results.push_back(IterSumExpr({}, range.value()->min));
+      continue;
+    }
+    if (!is_zero(range.value()->min) || !used_iters.insert(var).second) return NullOpt;
+    // The single split of the iterator is fused into a new mark, as in
+    // IterMapRewriter::TryFuseIters.
+    IterSplitExpr split(IterMark(index, range.value()->extent));
+    IterSumExpr expr({split}, make_zero(index->dtype));
+    IntImm base_scale = Downcast<IntImm>(split->scale);
+    IterSplitExpr arg = split;
+    arg.CopyOnWrite()->scale = analyzer->Simplify(div(arg->scale, base_scale));
+    PrimExpr expected_scale = split->scale * split->extent;
+    PrimExpr tail_extent = 0;
+    PrimExpr expected_extra_base = 0;
+    IterSumExpr structured_form = expr;
+    structured_form.CopyOnWrite()->args = {arg};
+    structured_form.CopyOnWrite()->base = 0;
+    IterMark mark(structured_form, div(expected_scale, base_scale) + tail_extent);
+    results.push_back(
+        IterSumExpr({IterSplitExpr(mark, base_scale)}, expr->base + expected_extra_base));
+  }
+  if (check_level == IterMapLevel::Bijective) {
+    for (const auto& kv : input_iters) {
+      if (!is_one(kv.second->extent) && used_iters.count(kv.first.get()) == 0) return NullOpt;
+    }
+  }
+  return results;
+}
+
 IterMapResult DetectIterMap(const Array<PrimExpr>& indices, const Map<Var, Range>& input_iters,
                             const PrimExpr& predicate, IterMapLevel check_level,
                             arith::Analyzer* analyzer, bool simplify_trivial_iterators) {
@@ -1109,6 +1162,15 @@ IterMapResult DetectIterMap(const Array<PrimExpr>& indices, const Map<Var, Range
     result->errors.push_back("Invalid iterators.  Iterators may not be expressions of each other.");
     return result;
   }
+  if (is_one(predicate)) {
+    Optional<Array<IterSumExpr>> trivial = DetectTrivialIterMap(
+        indices, input_iters, check_level, analyzer, simplify_trivial_iterators);
+    if (trivial.defined()) {
+      result->indices = trivial.value();
+      result->padding_predicate = const_false();
+      return result;
+    }
+  }
   Map<Var, Range> constrained_input_iters = input_iters;
   std::vector<IterConstraint> constraints;
   if (!is_one(predicate) &&
@@ -23,6 +23,10 @@
  */
 
 #include <tvm/auto_scheduler/cost_model.h>
+#include <tvm/auto_scheduler/feature.h>
+
+#include <algorithm>
+#include <limits>
 
 namespace tvm {
 namespace auto_scheduler {
@@ -49,11 +53,14 @@ void RandomModelNode::Predict(const SearchTask& task, const Array<State>& states
 }
 
 PythonBasedModel::PythonBasedModel(PackedFunc update_func, PackedFunc predict_func,
-                                   PackedFunc predict_stage_func) {
+                                   PackedFunc predict_stage_func, PackedFunc predict_features_func,
+                                   int max_n_bufs) {
   auto node = make_object<PythonBasedModelNode>();
   node->update_func = std::move(update_func);
   node->predict_func = std::move(predict_func);
   node->predict_stage_func = std::move(predict_stage_func);
+  node->predict_features_func = std::move(predict_features_func);
+  node->max_n_bufs = max_n_bufs;
   data_ = std::move(node);
 }
 
@@ -65,7 +72,28 @@ void PythonBasedModelNode::Update(const Array<MeasureInput>& inputs,
 void PythonBasedModelNode::Predict(const SearchTask& task, const Array<State>& states,
                                    std::vector<float>* scores) {
   scores->resize(states.size());
-  predict_func(task, states, static_cast<void*>(scores->data()));
+  if (predict_features_func == nullptr) {
+    predict_func(task, states, static_cast<void*>(scores->data()));
+    return;
+  }
+
+  // Extract the features of all the states in parallel into one buffer, which the model
+  // predicts in one call.
+  runtime::NDArray features, row_offsets;
+  GetPerStoreFeaturesFromStatesFlatten(states, task, max_n_bufs, &features, &row_offsets);
+  predict_features_func(features, row_offsets, static_cast<void*>(scores->data()));
+
+  // Predict -inf for invalid states that failed to be lowered.
+  const int64_t* offsets = static_cast<const int64_t*>(row_offsets->data);
+  const float* data = static_cast<const float*>(features->data);
+  int64_t feature_len = features->shape[1];
+  for (size_t i = 0; i < states.size(); ++i) {
+    const float* begin = data + offsets[i] * feature_len;
+    const float* end = data + offsets[i + 1] * feature_len;
+    if (std::all_of(begin, end, [](float x) { return x == 0; })) {
+      (*scores)[i] = -std::numeric_limits<float>::infinity();
+    }
+  }
 }
 
 void PythonBasedModelNode::PredictStages(const SearchTask& task, const Array<State>& states,
@@ -149,8 +177,10 @@ TVM_REGISTER_GLOBAL("auto_scheduler.RandomModel").set_body_typed([]() { return R
 
 TVM_REGISTER_GLOBAL("auto_scheduler.PythonBasedModel")
     .set_body_typed([](PackedFunc update_func, PackedFunc predict_func,
-                       PackedFunc predict_stage_func) {
-      return PythonBasedModel(update_func, predict_func, predict_stage_func);
+                       PackedFunc predict_stage_func, PackedFunc predict_features_func,
+                       int max_n_bufs) {
+      return PythonBasedModel(update_func, predict_func, predict_stage_func,
+                              predict_features_func, max_n_bufs);
     });
 
 TVM_REGISTER_GLOBAL("auto_scheduler.CostModelUpdate")
@@ -1441,6 +1441,40 @@ void GetPerStoreFeaturesFromStates(const Array<State>& states, const std::vector
                         });
 }
 
+void GetPerStoreFeaturesFromStatesFlatten(const Array<State>& states, const SearchTask& task,
+                                          int max_n_bufs, runtime::NDArray* features,
+                                          runtime::NDArray* row_offsets) {
+  std::vector<std::vector<float>> state_features;
+  GetPerStoreFeaturesFromStates(states, task, 0, max_n_bufs, &state_features);
+
+  std::vector<std::string> names;
+  GetPerStoreFeatureName(max_n_bufs, &names);
+  int64_t feature_len = names.size();
+
+  // The per-state vectors hold the number of rows followed by the rows.
+  int64_t num_states = states.size();
+  *row_offsets = runtime::NDArray::Empty({num_states + 1}, {kDLInt, 64, 1}, {kDLCPU, 0});
+  int64_t* offsets = static_cast<int64_t*>((*row_offsets)->data);
+  offsets[0] = 0;
+  for (int64_t i = 0; i < num_states; ++i) {
+    const std::vector<float>& vec = state_features[i];
+    int64_t num_rows = vec.empty() ? 0 : static_cast<int64_t>(vec[0] + 0.5);
+    int64_t num_values = vec.empty() ? 0 : static_cast<int64_t>(vec.size()) - 1;
+    ICHECK_EQ(num_values, num_rows * feature_len) << "The length of feature vector is wrong";
+    offsets[i + 1] = offsets[i] + num_rows;
+  }
+
+  *features = runtime::NDArray::Empty({offsets[num_states], feature_len}, {kDLFloat, 32, 1},
+                                      {kDLCPU, 0});
+  float* data = static_cast<float*>((*features)->data);
+  support::parallel_for(0, num_states, [&](int i) {
+    const std::vector<float>& vec = state_features[i];
+    if (!vec.empty()) {
+      std::copy(vec.begin() + 1, vec.end(), data + offsets[i] * feature_len);
+    }
+  });
+}
+
 void GetPerStoreFeaturesFromFile(const std::string& filename, int max_lines, int max_n_bufs,
                                  std::vector<std::vector<float>>* features,
                                  std::vector<float>* normalized_throughputs,
@@ -1718,6 +1752,13 @@ TVM_REGISTER_GLOBAL("auto_scheduler.GetPerStoreFeaturesFromStates")
                                std::move(task_ids), &byte_data);
     });
 
+TVM_REGISTER_GLOBAL("auto_scheduler.GetPerStoreFeaturesFromStatesFlatten")
+    .set_body_typed([](Array<State> states, SearchTask task, int max_n_bufs) {
+      runtime::NDArray features, row_offsets;
+      GetPerStoreFeaturesFromStatesFlatten(states, task, max_n_bufs, &features, &row_offsets);
+      return Array<runtime::NDArray>{features, row_offsets};
+    });
+
 TVM_REGISTER_GLOBAL("auto_scheduler.GetPerStoreFeatureNames")
     .set_body([](TVMArgs args, TVMRetValue* ret) {
       int max_n_bufs = args[0];
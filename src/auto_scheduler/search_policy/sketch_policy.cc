@@ -587,20 +587,36 @@ Array<State> SketchPolicyNode::EvolutionarySearch(const Array<State>& init_popul
 
     // TODO(merrymercy, comaniac): add crossover.
 
-    // Do mutation
+    // Do mutation. The parents and the random generators of a round are drawn from rand_gen
+    // up front, so that the mutations run in parallel while the result only depends on the seed.
     while (pnext->size() < population) {
-      State tmp_s = (*pnow)[RandomChoose(pop_selection_probs, &rand_gen)];
+      int num_children = population - pnext->size();
+      std::vector<State> children(num_children);
+      std::vector<uint8_t> mutated(num_children);
+      std::vector<std::mt19937> child_rand_gens;
+      child_rand_gens.reserve(num_children);
+      for (int i = 0; i < num_children; ++i) {
+        children[i] = (*pnow)[RandomChoose(pop_selection_probs, &rand_gen)];
+        mutated[i] = dis(rand_gen) < mutation_prob;
+        child_rand_gens.push_back(std::mt19937(rand_gen()));
+      }
+
+      support::parallel_for(0, num_children, [&](int i) {
+        if (!mutated[i]) return;
+        const auto& rule = mutation_rules[RandomChoose(rule_selection_probs, &child_rand_gens[i])];
+        if (rule->Apply(this, &children[i], &child_rand_gens[i]) !=
+            PopulationGenerationRule::ResultKind::kValid) {
+          children[i] = State();
+        }
+      });
 
-      if (dis(rand_gen) < mutation_prob) {
-        const auto& rule = mutation_rules[RandomChoose(rule_selection_probs, &rand_gen)];
-        if (rule->Apply(this, &tmp_s, &rand_gen) == PopulationGenerationRule::ResultKind::kValid) {
-          pnext->push_back(std::move(tmp_s));
-          mutation_success_ct++;
+      for (int i = 0; i < num_children; ++i) {
+        if (children[i].defined()) {
+          pnext->push_back(std::move(children[i]));
+          mutation_success_ct += mutated[i];
         } else {
           mutation_fail_ct++;
         }
-      } else {
-        pnext->push_back(std::move(tmp_s));
       }
     }
 
@@ -27,7 +27,13 @@
 #include <tvm/node/repr_printer.h>
 #include <tvm/runtime/registry.h>
 
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include <ctime>
 #include <stack>
+#include <unordered_set>
 
 namespace tvm {
 namespace instrument {
@@ -214,11 +220,31 @@ struct PassProfile {
   Time end;
   /*! \brief The total duration of the pass, i.e. end - start. */
   Duration duration;
+  /*! \brief The processor time of the process when the pass was entered. */
+  std::clock_t cpu_start;
+  /*! \brief The processor time spent by the process, over all its threads, during the pass. */
+  Duration cpu_duration;
+  /*! \brief The peak resident set size of the process in KB when the pass was entered. */
+  int64_t peak_rss_start_kb;
+  /*! \brief The growth of the peak resident set size during the pass, -1 if unknown. */
+  int64_t peak_rss_delta_kb;
+  /*! \brief The number of nodes of the IRModule before the pass, -1 if not counted. */
+  int64_t nodes_before;
+  /*! \brief The number of nodes of the IRModule after the pass, -1 if not counted. */
+  int64_t nodes_after;
   /*! \brief PassProfiles for all sub-passes invoked during the execution of the pass. */
   std::vector<PassProfile> children;
 
   explicit PassProfile(String name)
-      : name(name), start(Clock::now()), end(Clock::now()), children() {}
+      : name(name),
+        start(Clock::now()),
+        end(Clock::now()),
+        cpu_start(std::clock()),
+        peak_rss_start_kb(PeakRSSKB()),
+        peak_rss_delta_kb(-1),
+        nodes_before(-1),
+        nodes_after(-1),
+        children() {}
 
   /*! \brief Gets the PassProfile of the currently executing pass. */
   static PassProfile* Current();
@@ -226,6 +252,8 @@ struct PassProfile {
   static void EnterPass(String name);
   /*! \brief Pops the current PassProfile. */
   static void ExitPass();
+  /*! \brief The peak resident set size of the process in KB, -1 if unknown on the platform. */
+  static int64_t PeakRSSKB();
 };
 
 struct PassProfileThreadLocalEntry {
@@ -233,6 +261,8 @@ struct PassProfileThreadLocalEntry {
   PassProfile root;
   /*! \brief The stack of PassProfiles for nested passes currently running. */
   std::stack<PassProfile*> profile_stack;
+  /*! \brief The number of pass timing instruments in the pass contexts entered. */
+  int num_active_instruments = 0;
 
   PassProfileThreadLocalEntry() : root("root") {}
 };
@@ -251,9 +281,79 @@ void PassProfile::ExitPass() {
   ICHECK_NE(cur->name, "root") << "mismatched enter/exit for pass profiling";
   cur->end = PassProfile::Clock::now();
   cur->duration = std::chrono::duration_cast<PassProfile::Duration>(cur->end - cur->start);
+  cur->cpu_duration = PassProfile::Duration(static_cast<double>(std::clock() - cur->cpu_start) *
+                                            1e6 / CLOCKS_PER_SEC);
+  int64_t peak_rss_kb = PeakRSSKB();
+  if (peak_rss_kb >= 0 && cur->peak_rss_start_kb >= 0) {
+    cur->peak_rss_delta_kb = peak_rss_kb - cur->peak_rss_start_kb;
+  }
   PassProfileThreadLocalStore::Get()->profile_stack.pop();
 }
 
+int64_t PassProfile::PeakRSSKB() {
+#ifndef _WIN32
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#ifdef __APPLE__
+  // ru_maxrss is in bytes on macOS and in KB elsewhere.
+  return static_cast<int64_t>(usage.ru_maxrss) / 1024;
+#else
+  return static_cast<int64_t>(usage.ru_maxrss);
+#endif
+#else
+  return -1;
+#endif
+}
+
+/*!
+ * \brief Count the distinct nodes reachable from an IRModule, through the reflected fields, the
+ * arrays and the maps, as a measure of its size that does not depend on the IR.
+ */
+class IRNodeCounter : public AttrVisitor {
+ public:
+  int64_t Count(const IRModule& mod) {
+    Push(mod.get());
+    while (!stack_.empty()) {
+      const Object* node = stack_.back();
+      stack_.pop_back();
+      if (node->IsInstance<ArrayNode>()) {
+        for (const ObjectRef& elem : *static_cast<const ArrayNode*>(node)) {
+          Push(elem.get());
+        }
+      } else if (node->IsInstance<MapNode>()) {
+        for (const auto& kv : *static_cast<const MapNode*>(node)) {
+          Push(kv.first.get());
+          Push(kv.second.get());
+        }
+      } else {
+        ReflectionVTable::Global()->VisitAttrs(const_cast<Object*>(node), this);
+      }
+    }
+    return static_cast<int64_t>(visited_.size());
+  }
+
+  void Visit(const char* key, double* value) final {}
+  void Visit(const char* key, int64_t* value) final {}
+  void Visit(const char* key, uint64_t* value) final {}
+  void Visit(const char* key, int* value) final {}
+  void Visit(const char* key, bool* value) final {}
+  void Visit(const char* key, std::string* value) final {}
+  void Visit(const char* key, void** value) final {}
+  void Visit(const char* key, DataType* value) final {}
+  void Visit(const char* key, runtime::NDArray* value) final {}
+  void Visit(const char* key, ObjectRef* value) final { Push(value->get()); }
+
+ private:
+  void Push(const Object* node) {
+    if (node != nullptr && visited_.insert(node).second) {
+      stack_.push_back(node);
+    }
+  }
+
+  std::unordered_set<const Object*> visited_;
+  std::vector<const Object*> stack_;
+};
+
 PassProfile* PassProfile::Current() {
   PassProfileThreadLocalEntry* entry = PassProfileThreadLocalStore::Get();
   if (!entry->profile_stack.empty()) {
@@ -315,23 +415,154 @@ String RenderPassProfiles() {
   return os.str();
 }
 
+/*! \brief A profiled pass with its position in the tree of passes. */
+struct PassProfileRow {
+  /*! \brief The nesting depth, 0 for the top level passes. */
+  size_t depth;
+  /*! \brief The name of the enclosing pass, empty for the top level passes. */
+  String parent;
+  /*! \brief The time spent in the pass itself, excluding its sub-passes. */
+  PassProfile::Duration self_duration;
+  /*! \brief The profile. */
+  const PassProfile* profile;
+};
+
+/*! \brief Flatten the profiles of the current thread in the order the passes were entered. */
+static std::vector<PassProfileRow> FlattenPassProfiles() {
+  PassProfileThreadLocalEntry* entry = PassProfileThreadLocalStore::Get();
+  CHECK(entry->profile_stack.empty()) << "cannot print pass profile while still in a pass!";
+  std::vector<PassProfileRow> rows;
+  // (depth, parent, pass)
+  std::stack<std::tuple<size_t, String, const PassProfile*>> profiles;
+  for (auto it = entry->root.children.rbegin(); it != entry->root.children.rend(); ++it) {
+    profiles.push(std::make_tuple(0, String(), &*it));
+  }
+  while (profiles.size() > 0) {
+    auto [depth, parent, profile] = profiles.top();
+    profiles.pop();
+    PassProfile::Duration self_duration = profile->duration;
+    for (auto it = profile->children.rbegin(); it != profile->children.rend(); ++it) {
+      self_duration -= it->duration;
+      profiles.push(std::make_tuple(depth + 1, profile->name, &*it));
+    }
+    rows.push_back(PassProfileRow{depth, parent, self_duration, profile});
+  }
+  return rows;
+}
+
+/*! \brief Quote a CSV field if it holds a separator, a quote or a newline. */
+static std::string QuoteCSV(const std::string& field) {
+  if (field.find_first_of(",\"\n") == std::string::npos) return field;
+  std::string quoted = "\"";
+  for (char c : field) {
+    if (c == '"') quoted += '"';
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+/*! \brief Escape a string for a JSON string literal. */
+static std::string EscapeJSON(const std::string& str) {
+  std::ostringstream os;
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      os << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      os << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+         << std::dec;
+    } else {
+      os << c;
+    }
+  }
+  return os.str();
+}
+
+String RenderPassProfilesCSV() {
+  std::vector<PassProfileRow> rows = FlattenPassProfiles();
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(0);
+  os << "name,depth,parent,wall_us,self_us,cpu_us,peak_rss_delta_kb,nodes_before,nodes_after\n";
+  for (const PassProfileRow& row : rows) {
+    const PassProfile* profile = row.profile;
+    os << QuoteCSV(profile->name) << "," << row.depth << "," << QuoteCSV(row.parent) << ","
+       << profile->duration.count() << "," << row.self_duration.count() << ","
+       << profile->cpu_duration.count() << "," << profile->peak_rss_delta_kb << ","
+       << profile->nodes_before << "," << profile->nodes_after << "\n";
+  }
+  return os.str();
+}
+
+String RenderPassProfilesChromeTrace() {
+  std::vector<PassProfileRow> rows = FlattenPassProfiles();
+  // The timestamps are relative to the first pass entered.
+  PassProfile::Time origin = rows.empty() ? PassProfile::Clock::now() : rows[0].profile->start;
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(0);
+  os << "{\"traceEvents\": [";
+  for (size_t i = 0; i < rows.size(); ++i) {
+    const PassProfile* profile = rows[i].profile;
+    PassProfile::Duration ts =
+        std::chrono::duration_cast<PassProfile::Duration>(profile->start - origin);
+    os << (i ? ",\n" : "\n") << "  {\"name\": \"" << EscapeJSON(profile->name)
+       << "\", \"cat\": \"pass\", \"ph\": \"X\", \"pid\": 0, \"tid\": 0, \"ts\": "
+       << ts.count() << ", \"dur\": " << profile->duration.count()
+       << ", \"args\": {\"cpu_us\": " << profile->cpu_duration.count()
+       << ", \"peak_rss_delta_kb\": " << profile->peak_rss_delta_kb
+       << ", \"nodes_before\": " << profile->nodes_before
+       << ", \"nodes_after\": " << profile->nodes_after << "}}";
+  }
+  os << "\n], \"displayTimeUnit\": \"ms\"}\n";
+  return os.str();
+}
+
 TVM_REGISTER_GLOBAL("instrument.RenderTimePassProfiles").set_body_typed(RenderPassProfiles);
 
-TVM_REGISTER_GLOBAL("instrument.MakePassTimingInstrument").set_body_typed([]() {
-  auto run_before_pass = [](const IRModule&, const transform::PassInfo& pass_info) {
+TVM_REGISTER_GLOBAL("instrument.RenderPassProfilesCSV").set_body_typed(RenderPassProfilesCSV);
+
+TVM_REGISTER_GLOBAL("instrument.RenderPassProfilesChromeTrace")
+    .set_body_typed(RenderPassProfilesChromeTrace);
+
+TVM_REGISTER_GLOBAL("instrument.EnterPassProfileScope").set_body_typed([](String name) {
+  if (PassProfileThreadLocalStore::Get()->num_active_instruments == 0) return false;
+  PassProfile::EnterPass(name);
+  return true;
+});
+
+TVM_REGISTER_GLOBAL("instrument.ExitPassProfileScope").set_body_typed([]() {
+  PassProfile::ExitPass();
+});
+
+TVM_REGISTER_GLOBAL("instrument.MakePassTimingInstrument").set_body_typed([](bool count_nodes) {
+  auto run_before_pass = [count_nodes](const IRModule& mod, const transform::PassInfo& pass_info) {
     PassProfile::EnterPass(pass_info->name);
+    if (count_nodes) {
+      PassProfile* cur = PassProfile::Current();
+      cur->nodes_before = IRNodeCounter().Count(mod);
+      // The counting is not accounted to the pass.
+      cur->start = PassProfile::Clock::now();
+      cur->cpu_start = std::clock();
+    }
     return true;
   };
 
-  auto run_after_pass = [](const IRModule&, const transform::PassInfo& pass_info) {
+  auto run_after_pass = [count_nodes](const IRModule& mod, const transform::PassInfo& pass_info) {
+    PassProfile* cur = PassProfile::Current();
     PassProfile::ExitPass();
+    if (count_nodes) {
+      cur->nodes_after = IRNodeCounter().Count(mod);
+    }
   };
 
-  auto exit_pass_ctx = []() { PassProfileThreadLocalStore::Get()->root.children.clear(); };
+  auto enter_pass_ctx = []() { ++PassProfileThreadLocalStore::Get()->num_active_instruments; };
+
+  auto exit_pass_ctx = []() {
+    PassProfileThreadLocalEntry* entry = PassProfileThreadLocalStore::Get();
+    entry->root.children.clear();
+    if (entry->num_active_instruments > 0) --entry->num_active_instruments;
+  };
 
-  return BasePassInstrument("PassTimingInstrument",
-                            /* enter_pass_ctx */ nullptr, exit_pass_ctx, /* should_run */ nullptr,
-                            run_before_pass, run_after_pass);
+  return BasePassInstrument("PassTimingInstrument", enter_pass_ctx, exit_pass_ctx,
+                            /* should_run */ nullptr, run_before_pass, run_after_pass);
 });
 
 }  // namespace instrument
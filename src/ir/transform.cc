@@ -74,6 +74,17 @@ void PassContext::ExitWithScope() {
   InstrumentExitPassContext();
 }
 
+PassContextThreadScope::PassContextThreadScope(PassContext pass_ctx)
+    : pass_ctx_(std::move(pass_ctx)) {
+  RelayPassContextThreadLocalStore::Get()->context_stack.push(pass_ctx_);
+}
+
+PassContextThreadScope::~PassContextThreadScope() {
+  PassContextThreadLocalEntry* entry = RelayPassContextThreadLocalStore::Get();
+  ICHECK(!entry->context_stack.empty() && entry->context_stack.top().same_as(pass_ctx_));
+  entry->context_stack.pop();
+}
+
 PassContext PassContext::Current() {
   PassContextThreadLocalEntry* entry = RelayPassContextThreadLocalStore::Get();
   if (!entry->context_stack.empty()) {
@@ -16,6 +16,11 @@
  * specific language governing permissions and limitations
  * under the License.
  */
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <unordered_map>
+
 #include "../utils.h"
 
 namespace tvm {
@@ -154,6 +159,63 @@ TuningRecord TuningRecord::FromJSON(const ObjectRef& json_obj, const Workload& w
   return TuningRecord(trace, workload, run_secs, target, args_info);
 }
 
+/******** Nearest workloads ********/
+
+WorkloadShapeKey WorkloadShapeKey::FromModule(const IRModule& mod) {
+  WorkloadShapeKey key;
+  std::string script = tir::AsTVMScript(mod);
+  key.text.reserve(script.size());
+  auto is_word = [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; };
+  for (size_t i = 0, n = script.size(); i < n;) {
+    if (!std::isdigit(static_cast<unsigned char>(script[i])) ||
+        (i > 0 && (is_word(script[i - 1]) || script[i - 1] == '.'))) {
+      key.text.push_back(script[i++]);
+      continue;
+    }
+    size_t j = i;
+    while (j < n && std::isdigit(static_cast<unsigned char>(script[j]))) ++j;
+    if (j < n && (script[j] == '.' || script[j] == 'e' || is_word(script[j]))) {
+      // Part of a floating point literal or of an identifier
+      key.text.append(script, i, j - i);
+    } else {
+      key.text.push_back('?');
+      key.constants.push_back(std::strtoll(script.c_str() + i, nullptr, 10));
+    }
+    i = j;
+  }
+  return key;
+}
+
+double WorkloadShapeKey::Distance(const WorkloadShapeKey& other) const {
+  ICHECK_EQ(constants.size(), other.constants.size());
+  double distance = 0.0;
+  for (size_t i = 0; i < constants.size(); ++i) {
+    distance += std::abs(std::log1p(std::abs(static_cast<double>(constants[i]))) -
+                         std::log1p(std::abs(static_cast<double>(other.constants[i]))));
+  }
+  return distance;
+}
+
+Array<TuningRecord> InterleaveNearestRecords(
+    std::vector<std::pair<double, std::vector<TuningRecord>>> groups, int top_k) {
+  std::stable_sort(groups.begin(), groups.end(),
+                   [](const auto& a, const auto& b) { return a.first < b.first; });
+  Array<TuningRecord> results;
+  for (size_t rank = 0; static_cast<int>(results.size()) < top_k; ++rank) {
+    bool found = false;
+    for (const auto& group : groups) {
+      if (rank < group.second.size() && static_cast<int>(results.size()) < top_k) {
+        results.push_back(group.second[rank]);
+        found = true;
+      }
+    }
+    if (!found) {
+      break;
+    }
+  }
+  return results;
+}
+
 /******** Database ********/
 
 Optional<TuningRecord> DatabaseNode::QueryTuningRecord(const IRModule& mod, const Target& target,
@@ -192,6 +254,36 @@ Optional<IRModule> DatabaseNode::QueryIRModule(const IRModule& mod, const Target
   }
 }
 
+Array<TuningRecord> DatabaseNode::GetTopKNearest(const IRModule& mod, int top_k) {
+  CHECK_GE(top_k, 0) << "ValueError: top_k must be non-negative";
+  if (top_k == 0) {
+    return {};
+  }
+  Workload workload(mod, tvm::StructuralHash()(mod));
+  WorkloadShapeKey key = WorkloadShapeKey::FromModule(mod);
+  std::unordered_map<Workload, std::vector<TuningRecord>, WorkloadHash, WorkloadEqual> records;
+  for (const TuningRecord& record : this->GetAllTuningRecords()) {
+    records[record->workload].push_back(record);
+  }
+  std::vector<std::pair<double, std::vector<TuningRecord>>> groups;
+  for (auto& [other, other_records] : records) {
+    if (WorkloadEqual()(other, workload)) {
+      continue;
+    }
+    WorkloadShapeKey other_key = WorkloadShapeKey::FromModule(other->mod);
+    if (other_key.text != key.text) {
+      continue;
+    }
+    std::stable_sort(other_records.begin(), other_records.end(),
+                     SortTuningRecordByMeanRunSecs());
+    if (static_cast<int>(other_records.size()) > top_k) {
+      other_records.erase(other_records.begin() + top_k, other_records.end());
+    }
+    groups.emplace_back(key.Distance(other_key), std::move(other_records));
+  }
+  return InterleaveNearestRecords(std::move(groups), top_k);
+}
+
 std::vector<Database>* ThreadLocalDatabases() {
   static thread_local std::vector<Database> tls;
   return &tls;
@@ -269,6 +361,8 @@ TVM_REGISTER_GLOBAL("meta_schedule.DatabaseCommitTuningRecord")
     .set_body_method<Database>(&DatabaseNode::CommitTuningRecord);
 TVM_REGISTER_GLOBAL("meta_schedule.DatabaseGetTopK")
     .set_body_method<Database>(&DatabaseNode::GetTopK);
+TVM_REGISTER_GLOBAL("meta_schedule.DatabaseGetTopKNearest")
+    .set_body_method<Database>(&DatabaseNode::GetTopKNearest);
 TVM_REGISTER_GLOBAL("meta_schedule.DatabaseGetAllTuningRecords")
     .set_body_method<Database>(&DatabaseNode::GetAllTuningRecords);
 TVM_REGISTER_GLOBAL("meta_schedule.DatabaseSize").set_body_method<Database>(&DatabaseNode::Size);
@@ -0,0 +1,437 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <algorithm>
+#include <fstream>
+#include <thread>
+#include <unordered_map>
+
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+std::vector<ObjectRef> JSONFileReadLines(const String& path, int num_threads, bool allow_missing);
+void JSONFileAppendLine(const String& path, const std::string& line);
+
+/*! \brief The magic number at the beginning of an index file. */
+constexpr uint64_t kIndexFileMagic = 0x5844494D4D535654;  // "TVSMMIDX"
+/*! \brief The version of the index file format. */
+constexpr uint64_t kIndexFileVersion = 1;
+
+/*! \brief An entry of the index file, locating one line of the tuning record table. */
+struct IndexEntry {
+  /*! \brief The offset of the line in the tuning record table. */
+  uint64_t offset;
+  /*! \brief The length of the line, excluding the newline. */
+  uint32_t length;
+  /*! \brief The index of the workload of the record. */
+  uint32_t workload_index;
+  /*! \brief The hash of the target of the record, 0 if the record has no target. */
+  uint64_t target_hash;
+  /*! \brief The mean running time of the record, used to rank the records. */
+  double mean_run_secs;
+};
+static_assert(sizeof(IndexEntry) == 32, "IndexEntry must be packed to be stored on disk");
+
+/*!
+ * \brief Hash a target by its string form, with FNV-1a so the hash stays stable across builds.
+ * \param target The target to be hashed.
+ * \return The hash, 0 if the target is not defined.
+ */
+uint64_t TargetHash(const Optional<Target>& target) {
+  if (!target.defined()) {
+    return 0;
+  }
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (char c : target.value()->str()) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3ULL;
+  }
+  return hash == 0 ? 1 : hash;
+}
+
+/*!
+ * \brief A database keeping the tuning records on disk, and only an index of them in memory. The
+ *  tuning record table is the same JSON-lines file as JSONDatabase's, and the index file next to
+ *  it locates each line with its workload, target and mean running time. Records are parsed only
+ *  when a query returns them, and both files are only appended to.
+ */
+class IndexedDatabaseNode : public DatabaseNode {
+ public:
+  /*! \brief The path to the workload table */
+  String path_workload;
+  /*! \brief The path to the tuning record table */
+  String path_tuning_record;
+  /*! \brief The path to the index of the tuning record table */
+  String path_index;
+  /*! \brief All the workloads in the database */
+  std::unordered_map<Workload, int, WorkloadHash, WorkloadEqual> workloads2idx_;
+  /*! \brief The workloads in the order of their indices */
+  std::vector<Workload> workloads_;
+  /*! \brief The index entries of all the tuning records, in the order of the table */
+  std::vector<IndexEntry> entries_;
+  /*! \brief The entries of each workload, sorted by the mean running time */
+  std::vector<std::vector<uint32_t>> sorted_entries_;
+  /*! \brief The records parsed so far, by their entry */
+  std::unordered_map<uint32_t, TuningRecord> parsed_;
+  /*! \brief The size of the tuning record table */
+  uint64_t table_size_ = 0;
+  /*! \brief The shape keys of the workloads computed so far, by their index */
+  std::unordered_map<int, WorkloadShapeKey> shape_keys_;
+
+  void VisitAttrs(tvm::AttrVisitor* v) {
+    v->Visit("path_workload", &path_workload);
+    v->Visit("path_tuning_record", &path_tuning_record);
+    v->Visit("path_index", &path_index);
+    // `workloads2idx_` is not visited
+    // `workloads_` is not visited
+    // `entries_` is not visited
+    // `sorted_entries_` is not visited
+    // `parsed_` is not visited
+    // `table_size_` is not visited
+    // `shape_keys_` is not visited
+  }
+
+  static constexpr const char* _type_key = "meta_schedule.IndexedDatabase";
+  TVM_DECLARE_FINAL_OBJECT_INFO(IndexedDatabaseNode, DatabaseNode);
+
+ public:
+  bool HasWorkload(const IRModule& mod) {
+    return workloads2idx_.find(Workload(mod, tvm::StructuralHash()(mod))) !=
+           workloads2idx_.end();
+  }
+
+  Workload CommitWorkload(const IRModule& mod) {
+    auto [it, inserted] =
+        this->workloads2idx_.emplace(Workload(mod, tvm::StructuralHash()(mod)), -1);
+    if (inserted) {
+      it->second = static_cast<int>(this->workloads_.size());
+      this->workloads_.push_back(it->first);
+      this->sorted_entries_.emplace_back();
+      JSONFileAppendLine(this->path_workload, JSONDumps(it->first->AsJSON()));
+    }
+    return it->first;
+  }
+
+  void CommitTuningRecord(const TuningRecord& record) {
+    int workload_index = this->workloads2idx_.at(record->workload);
+    std::string line = JSONDumps(Array<ObjectRef>{
+        /*workload_index=*/Integer(workload_index),
+        /*tuning_record=*/record->AsJSON()  //
+    });
+    {
+      std::ofstream os(this->path_tuning_record, std::ofstream::binary | std::ofstream::app);
+      CHECK(os.good()) << "ValueError: Cannot open the file to write: " << path_tuning_record;
+      os << line << '\n';
+    }
+    IndexEntry entry{table_size_, static_cast<uint32_t>(line.size()),
+                     static_cast<uint32_t>(workload_index), TargetHash(record->target),
+                     SortTuningRecordByMeanRunSecs::Mean(record->run_secs.value_or({}))};
+    AppendIndexEntries(&entry, 1);
+    table_size_ += line.size() + 1;
+    parsed_.emplace(AddEntry(entry), record);
+  }
+
+  Array<TuningRecord> GetTopK(const Workload& workload, int top_k) {
+    CHECK_GE(top_k, 0) << "ValueError: top_k must be non-negative";
+    auto it = this->workloads2idx_.find(workload);
+    if (top_k == 0 || it == this->workloads2idx_.end()) {
+      return {};
+    }
+    const std::vector<uint32_t>& sorted = sorted_entries_[it->second];
+    int n = std::min(static_cast<int>(sorted.size()), top_k);
+    return ParseRecords(std::vector<uint32_t>(sorted.begin(), sorted.begin() + n));
+  }
+
+  Array<TuningRecord> GetAllTuningRecords() {
+    std::vector<std::pair<double, uint32_t>> order;
+    order.reserve(entries_.size());
+    for (uint32_t i = 0; i < entries_.size(); ++i) {
+      order.emplace_back(entries_[i].mean_run_secs, i);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    std::vector<uint32_t> ids;
+    ids.reserve(order.size());
+    for (const auto& kv : order) {
+      ids.push_back(kv.second);
+    }
+    return ParseRecords(ids);
+  }
+
+  Optional<TuningRecord> QueryTuningRecord(const IRModule& mod, const Target& target,
+                                           const String& workload_name) final {
+    auto it = this->workloads2idx_.find(Workload(mod, tvm::StructuralHash()(mod)));
+    if (it == this->workloads2idx_.end()) {
+      return NullOpt;
+    }
+    const std::vector<uint32_t>& sorted = sorted_entries_[it->second];
+    if (sorted.empty()) {
+      return NullOpt;
+    }
+    // Prefer the best record tuned for the target, and fall back to the best record otherwise.
+    uint64_t target_hash = TargetHash(target);
+    uint32_t best = sorted[0];
+    for (uint32_t id : sorted) {
+      if (entries_[id].target_hash == target_hash) {
+        best = id;
+        break;
+      }
+    }
+    return ParseRecords({best})[0];
+  }
+
+  Array<TuningRecord> GetTopKNearest(const IRModule& mod, int top_k) final {
+    CHECK_GE(top_k, 0) << "ValueError: top_k must be non-negative";
+    if (top_k == 0) {
+      return {};
+    }
+    Workload workload(mod, tvm::StructuralHash()(mod));
+    WorkloadShapeKey key = WorkloadShapeKey::FromModule(mod);
+    std::vector<std::pair<double, std::vector<TuningRecord>>> groups;
+    for (int i = 0, n = workloads_.size(); i < n; ++i) {
+      const std::vector<uint32_t>& sorted = sorted_entries_[i];
+      if (sorted.empty() || WorkloadEqual()(workloads_[i], workload)) {
+        continue;
+      }
+      auto it = shape_keys_.find(i);
+      if (it == shape_keys_.end()) {
+        it = shape_keys_.emplace(i, WorkloadShapeKey::FromModule(workloads_[i]->mod)).first;
+      }
+      if (it->second.text != key.text) {
+        continue;
+      }
+      // Only the returned records of the matching workloads are parsed.
+      int num = std::min(static_cast<int>(sorted.size()), top_k);
+      Array<TuningRecord> records =
+          ParseRecords(std::vector<uint32_t>(sorted.begin(), sorted.begin() + num));
+      groups.emplace_back(key.Distance(it->second),
+                          std::vector<TuningRecord>(records.begin(), records.end()));
+    }
+    return InterleaveNearestRecords(std::move(groups), top_k);
+  }
+
+  int64_t Size() { return entries_.size(); }
+
+  /*!
+   * \brief Add an entry to the in-memory index.
+   * \param entry The entry to be added.
+   * \return The id of the entry.
+   */
+  uint32_t AddEntry(const IndexEntry& entry) {
+    uint32_t id = entries_.size();
+    CHECK_LT(entry.workload_index, sorted_entries_.size())
+        << "ValueError: Unknown workload index " << entry.workload_index << " in the index file "
+        << path_index;
+    entries_.push_back(entry);
+    // Records with the same running time keep their order of commit, as in JSONDatabase.
+    std::vector<uint32_t>& sorted = sorted_entries_[entry.workload_index];
+    auto pos = std::upper_bound(sorted.begin(), sorted.end(), entry.mean_run_secs,
+                                [this](double secs, uint32_t other) {
+                                  return secs < entries_[other].mean_run_secs;
+                                });
+    sorted.insert(pos, id);
+    return id;
+  }
+
+  /*!
+   * \brief Append entries to the index file, creating the file with its header if missing.
+   * \param entries The entries to be appended.
+   * \param n The number of entries.
+   */
+  void AppendIndexEntries(const IndexEntry* entries, size_t n) {
+    bool exists = std::ifstream(path_index).good();
+    std::ofstream os(path_index, std::ofstream::binary | std::ofstream::app);
+    CHECK(os.good()) << "ValueError: Cannot open the file to write: " << path_index;
+    if (!exists) {
+      os.write(reinterpret_cast<const char*>(&kIndexFileMagic), sizeof(kIndexFileMagic));
+      os.write(reinterpret_cast<const char*>(&kIndexFileVersion), sizeof(kIndexFileVersion));
+    }
+    os.write(reinterpret_cast<const char*>(entries), n * sizeof(IndexEntry));
+  }
+
+  /*!
+   * \brief Parse the records of the given entries from the tuning record table.
+   * \param ids The ids of the entries.
+   * \return The records, in the order of the ids.
+   */
+  Array<TuningRecord> ParseRecords(const std::vector<uint32_t>& ids) {
+    std::vector<uint32_t> missing;
+    for (uint32_t id : ids) {
+      if (!parsed_.count(id)) missing.push_back(id);
+    }
+    if (!missing.empty()) {
+      std::ifstream is(path_tuning_record, std::ifstream::binary);
+      CHECK(is.good()) << "ValueError: Cannot open the file to read: " << path_tuning_record;
+      std::vector<std::string> lines(missing.size());
+      for (size_t i = 0; i < missing.size(); ++i) {
+        const IndexEntry& entry = entries_[missing[i]];
+        lines[i].resize(entry.length);
+        is.seekg(entry.offset);
+        is.read(lines[i].data(), entry.length);
+        CHECK(is.good()) << "ValueError: The index file " << path_index
+                         << " is out of date with the tuning record table " << path_tuning_record;
+      }
+      std::vector<TuningRecord> records(missing.size(), TuningRecord{nullptr});
+      int num_threads = std::thread::hardware_concurrency();
+      support::parallel_for_dynamic(0, missing.size(), num_threads, [&](int, int task_id) {
+        const IndexEntry& entry = entries_[missing[task_id]];
+        records[task_id] = ParseRecord(lines[task_id], entry.workload_index);
+      });
+      for (size_t i = 0; i < missing.size(); ++i) {
+        parsed_.emplace(missing[i], records[i]);
+      }
+    }
+    Array<TuningRecord> results;
+    results.reserve(ids.size());
+    for (uint32_t id : ids) {
+      results.push_back(parsed_.at(id));
+    }
+    return results;
+  }
+
+  /*!
+   * \brief Parse a line of the tuning record table.
+   * \param line The line.
+   * \param workload_index The workload index the index file records for the line.
+   * \return The parsed tuning record.
+   */
+  TuningRecord ParseRecord(const std::string& line, uint32_t workload_index) {
+    ObjectRef json_obj = JSONLoads(line);
+    const ArrayNode* arr = json_obj.as<ArrayNode>();
+    CHECK(arr && arr->size() == 2 &&
+          Downcast<Integer>(arr->at(0)).IntValue() == static_cast<int64_t>(workload_index))
+        << "ValueError: The index file " << path_index
+        << " is out of date with the tuning record table " << path_tuning_record;
+    return TuningRecord::FromJSON(arr->at(1), workloads_[workload_index]);
+  }
+
+  /*!
+   * \brief Index the lines of the tuning record table after the given offset, which are left
+   *  out of the index file, e.g. when the table is written by JSONDatabase.
+   * \param offset The offset the index file covers the table up to.
+   */
+  void IndexTail(uint64_t offset) {
+    std::ifstream is(path_tuning_record, std::ifstream::binary);
+    is.seekg(offset);
+    std::vector<std::pair<uint64_t, std::string>> lines;
+    for (std::string str; std::getline(is, str); offset += str.size() + 1) {
+      if (!str.empty()) lines.emplace_back(offset, std::move(str));
+    }
+    if (lines.empty()) {
+      return;
+    }
+    std::vector<IndexEntry> entries(lines.size());
+    int num_threads = std::thread::hardware_concurrency();
+    support::parallel_for_dynamic(0, lines.size(), num_threads, [&](int, int task_id) {
+      const auto& [line_offset, line] = lines[task_id];
+      try {
+        const ArrayNode* arr = JSONLoads(line).as<ArrayNode>();
+        ICHECK(arr && arr->size() == 2);
+        const ArrayNode* json_record = arr->at(1).as<ArrayNode>();
+        ICHECK(json_record && json_record->size() == 4);
+        Optional<Target> target;
+        if (json_record->at(2).defined()) {
+          target = Target(Downcast<Map<String, ObjectRef>>(json_record->at(2)));
+        }
+        double mean_run_secs = SortTuningRecordByMeanRunSecs::kMaxMeanTime;
+        if (json_record->at(1).defined()) {
+          mean_run_secs = SortTuningRecordByMeanRunSecs::Mean(AsFloatArray(json_record->at(1)));
+        }
+        entries[task_id] = IndexEntry{line_offset, static_cast<uint32_t>(line.size()),
+                                      static_cast<uint32_t>(
+                                          Downcast<Integer>(arr->at(0)).IntValue()),
+                                      TargetHash(target), mean_run_secs};
+      } catch (std::runtime_error& e) {
+        LOG(FATAL) << "ValueError: Unable to index the TuningRecord at offset " << line_offset
+                   << " of file " << path_tuning_record << ". The line is:\n"
+                   << line << "\nThe error message is:\n"
+                   << e.what();
+      }
+    });
+    for (const IndexEntry& entry : entries) {
+      AddEntry(entry);
+    }
+    AppendIndexEntries(entries.data(), entries.size());
+  }
+};
+
+Database Database::IndexedDatabase(String path_workload, String path_tuning_record,
+                                   String path_index, bool allow_missing) {
+  int num_threads = std::thread::hardware_concurrency();
+  ObjectPtr<IndexedDatabaseNode> n = make_object<IndexedDatabaseNode>();
+  n->path_workload = path_workload;
+  n->path_tuning_record = path_tuning_record;
+  n->path_index = path_index;
+  // The workloads are few compared to the records, and are loaded eagerly as in JSONDatabase.
+  {
+    std::vector<ObjectRef> json_objs = JSONFileReadLines(path_workload, num_threads, allow_missing);
+    n->workloads2idx_.reserve(json_objs.size());
+    for (const ObjectRef& json_obj : json_objs) {
+      Workload workload = Workload::FromJSON(json_obj);
+      n->workloads2idx_.emplace(workload, n->workloads_.size());
+      n->workloads_.push_back(workload);
+    }
+    n->sorted_entries_.resize(n->workloads_.size());
+  }
+  // Locate the end of the tuning record table.
+  {
+    std::ifstream is(path_tuning_record, std::ifstream::binary | std::ifstream::ate);
+    if (is.good()) {
+      n->table_size_ = is.tellg();
+    } else {
+      CHECK(allow_missing) << "ValueError: File doesn't exist: " << path_tuning_record;
+      std::ofstream os(path_tuning_record);
+      CHECK(os.good()) << "ValueError: Cannot create new file: " << path_tuning_record;
+    }
+  }
+  // Load the index, and index the records appended to the table without it.
+  uint64_t indexed_size = 0;
+  {
+    std::ifstream is(path_index, std::ifstream::binary);
+    if (is.good()) {
+      uint64_t magic = 0, version = 0;
+      is.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+      is.read(reinterpret_cast<char*>(&version), sizeof(version));
+      CHECK(is.good() && magic == kIndexFileMagic)
+          << "ValueError: Not a tuning record index file: " << path_index;
+      CHECK_EQ(version, kIndexFileVersion)
+          << "ValueError: Unsupported version of the tuning record index file: " << path_index;
+      IndexEntry entry;
+      while (is.read(reinterpret_cast<char*>(&entry), sizeof(entry))) {
+        CHECK_LE(entry.offset + entry.length, n->table_size_)
+            << "ValueError: The index file " << path_index
+            << " is out of date with the tuning record table " << path_tuning_record;
+        n->AddEntry(entry);
+        indexed_size = std::max(indexed_size, entry.offset + entry.length + 1);
+      }
+      CHECK_EQ(is.gcount(), 0) << "ValueError: The index file " << path_index << " is truncated";
+    }
+  }
+  if (indexed_size < n->table_size_) {
+    n->IndexTail(indexed_size);
+  }
+  return Database(n);
+}
+
+TVM_REGISTER_NODE_TYPE(IndexedDatabaseNode);
+TVM_REGISTER_GLOBAL("meta_schedule.DatabaseIndexedDatabase")
+    .set_body_typed(Database::IndexedDatabase);
+
+}  // namespace meta_schedule
+}  // namespace tvm
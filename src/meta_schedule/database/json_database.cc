@@ -16,6 +16,13 @@
  * specific language governing permissions and limitations
  * under the License.
  */
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+#include <memory>
 #include <set>
 #include <thread>
 #include <unordered_map>
@@ -64,6 +71,41 @@ void JSONFileAppendLine(const String& path, const std::string& line) {
   os << line << std::endl;
 }
 
+FileLock::FileLock(const std::string& path) {
+#ifndef _WIN32
+  fd_ = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  CHECK_NE(fd_, -1) << "ValueError: Cannot open the lock file: " << path;
+  CHECK_EQ(flock(fd_, LOCK_EX), 0) << "ValueError: Cannot lock the file: " << path;
+#else
+  LOG(FATAL) << "ValueError: Concurrent JSONDatabase is not supported on Windows";
+#endif
+}
+
+FileLock::~FileLock() {
+#ifndef _WIN32
+  flock(fd_, LOCK_UN);
+  close(fd_);
+#endif
+}
+
+std::vector<std::string> JSONFileReadNewLines(const String& path, int64_t* offset) {
+  std::vector<std::string> lines;
+  std::ifstream is(path);
+  if (!is.good()) {
+    return lines;
+  }
+  is.seekg(*offset);
+  for (std::string str; std::getline(is, str);) {
+    if (is.eof()) {
+      // The last line is still being written
+      break;
+    }
+    *offset += str.size() + 1;
+    lines.push_back(std::move(str));
+  }
+  return lines;
+}
+
 /*! \brief The default database implementation, which mimics two database tables with two files. */
 class JSONDatabaseNode : public DatabaseNode {
  public:
@@ -71,16 +113,31 @@ class JSONDatabaseNode : public DatabaseNode {
   String path_workload;
   /*! \brief The path to the tuning record table */
   String path_tuning_record;
+  /*!
+   * \brief Whether the tables are shared with other processes. If so, every access locks the
+   * tables and first loads the lines appended by the other processes.
+   */
+  bool concurrent;
   /*! \brief All the workloads in the database */
   std::unordered_map<Workload, int, WorkloadHash, WorkloadEqual> workloads2idx_;
+  /*! \brief The workloads indexed by their line in the workload table */
+  std::vector<Workload> workloads_;
   /*! \brief All the tuning records in the database */
   std::multiset<TuningRecord, SortTuningRecordByMeanRunSecs> tuning_records_;
+  /*! \brief The number of bytes of the workload table already loaded, in concurrent mode */
+  int64_t workload_offset_ = 0;
+  /*! \brief The number of bytes of the tuning record table already loaded, in concurrent mode */
+  int64_t tuning_record_offset_ = 0;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     v->Visit("path_workload", &path_workload);
     v->Visit("path_tuning_record", &path_tuning_record);
+    v->Visit("concurrent", &concurrent);
     // `workloads2idx_` is not visited
+    // `workloads_` is not visited
     // `tuning_records_` is not visited
+    // `workload_offset_` is not visited
+    // `tuning_record_offset_` is not visited
   }
 
   static constexpr const char* _type_key = "meta_schedule.JSONDatabase";
@@ -88,33 +145,42 @@ class JSONDatabaseNode : public DatabaseNode {
 
  public:
   bool HasWorkload(const IRModule& mod) {
-    return workloads2idx_.find(Workload(mod, tvm::StructuralHash()(mod))) != workloads2idx_.end();
+    std::unique_ptr<FileLock> lock = this->Sync();
+    return workloads2idx_.find(Workload(mod, tvm::StructuralHash()(mod))) !=
+           workloads2idx_.end();
   }
 
   Workload CommitWorkload(const IRModule& mod) {
+    std::unique_ptr<FileLock> lock = this->Sync();
     // Try to insert `mod` into `workloads_`
     auto [it, inserted] =
         this->workloads2idx_.emplace(Workload(mod, tvm::StructuralHash()(mod)), -1);
     Workload workload = it->first;
     // If `mod` is new in `workloads2idx_`, append it to the workload file
     if (inserted) {
-      it->second = static_cast<int>(this->workloads2idx_.size()) - 1;
-      JSONFileAppendLine(this->path_workload, JSONDumps(workload->AsJSON()));
+      it->second = static_cast<int>(this->workloads_.size());
+      this->workloads_.push_back(workload);
+      std::string line = JSONDumps(workload->AsJSON());
+      JSONFileAppendLine(this->path_workload, line);
+      this->workload_offset_ += line.size() + 1;
     }
     return it->first;
   }
 
   void CommitTuningRecord(const TuningRecord& record) {
+    std::unique_ptr<FileLock> lock = this->Sync();
     this->tuning_records_.insert(record);
-    JSONFileAppendLine(this->path_tuning_record,
-                       JSONDumps(Array<ObjectRef>{
-                           /*workload_index=*/Integer(this->workloads2idx_.at(record->workload)),
-                           /*tuning_record=*/record->AsJSON()  //
-                       }));
+    std::string line = JSONDumps(Array<ObjectRef>{
+        /*workload_index=*/Integer(this->workloads2idx_.at(record->workload)),
+        /*tuning_record=*/record->AsJSON()  //
+    });
+    JSONFileAppendLine(this->path_tuning_record, line);
+    this->tuning_record_offset_ += line.size() + 1;
   }
 
   Array<TuningRecord> GetTopK(const Workload& workload, int top_k) {
     CHECK_GE(top_k, 0) << "ValueError: top_k must be non-negative";
+    std::unique_ptr<FileLock> lock = this->Sync();
     if (top_k == 0) {
       return {};
     }
@@ -133,6 +199,7 @@ class JSONDatabaseNode : public DatabaseNode {
   }
 
   Array<TuningRecord> GetAllTuningRecords() {
+    std::unique_ptr<FileLock> lock = this->Sync();
     Array<TuningRecord> results;
     results.reserve(Size());
     for (const TuningRecord& record : this->tuning_records_) {
@@ -141,13 +208,63 @@ class JSONDatabaseNode : public DatabaseNode {
     return results;
   }
 
-  int64_t Size() { return tuning_records_.size(); }
+  int64_t Size() {
+    std::unique_ptr<FileLock> lock = this->Sync();
+    return tuning_records_.size();
+  }
+
+  /*!
+   * \brief In concurrent mode, lock the tables and load the lines appended to them since the last
+   * access.
+   * \return The lock, or nullptr if the database is not concurrent.
+   */
+  std::unique_ptr<FileLock> Sync() {
+    if (!concurrent) {
+      return nullptr;
+    }
+    std::unique_ptr<FileLock> lock = std::make_unique<FileLock>(path_tuning_record + ".lock");
+    for (const std::string& line : JSONFileReadNewLines(path_workload, &workload_offset_)) {
+      Workload workload = Workload::FromJSON(JSONLoads(line));
+      workloads2idx_.emplace(workload, static_cast<int>(workloads_.size()));
+      workloads_.push_back(workload);
+    }
+    std::vector<std::string> lines =
+        JSONFileReadNewLines(path_tuning_record, &tuning_record_offset_);
+    std::vector<TuningRecord> records(lines.size(), TuningRecord{nullptr});
+    support::parallel_for_dynamic(
+        0, lines.size(), std::thread::hardware_concurrency(), [&](int thread_id, int task_id) {
+          ObjectRef json_obj = JSONLoads(lines[task_id]);
+          const ArrayNode* arr = json_obj.as<ArrayNode>();
+          ICHECK(arr && arr->size() == 2)
+              << "ValueError: Unable to parse TuningRecord from: " << lines[task_id];
+          const Workload& workload = workloads_.at(Downcast<Integer>(arr->at(0)).IntValue());
+          records[task_id] = TuningRecord::FromJSON(arr->at(1), workload);
+        });
+    tuning_records_.insert(records.begin(), records.end());
+    return lock;
+  }
 };
 
 Database Database::JSONDatabase(String path_workload, String path_tuning_record,
-                                bool allow_missing) {
+                                bool allow_missing, bool concurrent) {
   int num_threads = std::thread::hardware_concurrency();
   ObjectPtr<JSONDatabaseNode> n = make_object<JSONDatabaseNode>();
+  n->path_workload = path_workload;
+  n->path_tuning_record = path_tuning_record;
+  n->concurrent = concurrent;
+  if (concurrent) {
+    // The tables are loaded under the lock on the first access
+    for (const String& path : {path_workload, path_tuning_record}) {
+      std::ifstream is(path);
+      if (!is.good()) {
+        CHECK(allow_missing) << "ValueError: File doesn't exist: " << path;
+        std::ofstream os(path, std::ofstream::app);
+        CHECK(os.good()) << "ValueError: Cannot create new file: " << path;
+      }
+    }
+    n->Sync();
+    return Database(n);
+  }
   // Load `n->workloads2idx_` from `path_workload`
   std::vector<Workload> workloads;
   {
@@ -160,6 +277,7 @@ Database Database::JSONDatabase(String path_workload, String path_tuning_record,
       n->workloads2idx_.emplace(workload, i);
       workloads.push_back(workload);
     }
+    n->workloads_ = workloads;
   }
   // Load `n->tuning_records_` from `path_tuning_record`
   {
@@ -189,8 +307,6 @@ Database Database::JSONDatabase(String path_workload, String path_tuning_record,
       n->tuning_records_.insert(record);
     }
   }
-  n->path_workload = path_workload;
-  n->path_tuning_record = path_tuning_record;
   return Database(n);
 }
 
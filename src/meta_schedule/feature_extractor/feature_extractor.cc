@@ -21,6 +21,46 @@
 namespace tvm {
 namespace meta_schedule {
 
+runtime::NDArray FeatureExtractorNode::ExtractBatch(const TuneContext& context,
+                                                   const Array<MeasureCandidate>& candidates,
+                                                   std::vector<int64_t>* row_offsets) {
+  Array<runtime::NDArray> features = this->ExtractFrom(context, candidates);
+  ICHECK_EQ(features.size(), candidates.size());
+  int64_t num_rows = 0;
+  int64_t num_cols = 0;
+  row_offsets->clear();
+  row_offsets->reserve(features.size() + 1);
+  for (const runtime::NDArray& feature : features) {
+    ICHECK_EQ(feature->ndim, 2) << "ValueError: The features of a candidate must be 2-D";
+    row_offsets->push_back(num_rows);
+    num_rows += feature->shape[0];
+    if (feature->shape[0] > 0) num_cols = feature->shape[1];
+  }
+  row_offsets->push_back(num_rows);
+  runtime::NDArray result =
+      runtime::NDArray::Empty({num_rows, num_cols}, DLDataType{kDLFloat, 32, 1}, {kDLCPU, 0});
+  float* data = static_cast<float*>(result->data);
+  for (const runtime::NDArray& feature : features) {
+    int64_t n = feature->shape[0] * feature->shape[1];
+    if (n == 0) continue;
+    ICHECK_EQ(feature->shape[1], num_cols)
+        << "ValueError: The feature vectors of the candidates have different lengths";
+    runtime::NDArray src = feature.CopyTo({kDLCPU, 0});
+    runtime::DataType dtype(src->dtype);
+    if (dtype == runtime::DataType::Float(64)) {
+      const double* values = static_cast<const double*>(src->data);
+      std::copy(values, values + n, data);
+    } else {
+      ICHECK(dtype == runtime::DataType::Float(32))
+          << "ValueError: Unsupported feature dtype " << dtype;
+      const float* values = static_cast<const float*>(src->data);
+      std::copy(values, values + n, data);
+    }
+    data += n;
+  }
+  return result;
+}
+
 Array<tvm::runtime::NDArray> PyFeatureExtractorNode::ExtractFrom(
     const TuneContext& context, const Array<MeasureCandidate>& candidates) {
   ICHECK(f_extract_from != nullptr) << "PyFeatureExtractor's ExtractFrom method not implemented!";
@@ -50,6 +90,16 @@ TVM_REGISTER_NODE_TYPE(PyFeatureExtractorNode);
 
 TVM_REGISTER_GLOBAL("meta_schedule.FeatureExtractorExtractFrom")
     .set_body_method<FeatureExtractor>(&FeatureExtractorNode::ExtractFrom);
+TVM_REGISTER_GLOBAL("meta_schedule.FeatureExtractorExtractBatch")
+    .set_body_typed([](FeatureExtractor self, TuneContext context,
+                       Array<MeasureCandidate> candidates) -> Array<runtime::NDArray> {
+      std::vector<int64_t> row_offsets;
+      runtime::NDArray features = self->ExtractBatch(context, candidates, &row_offsets);
+      runtime::NDArray offsets = runtime::NDArray::Empty(
+          {static_cast<int64_t>(row_offsets.size())}, DLDataType{kDLInt, 64, 1}, {kDLCPU, 0});
+      offsets.CopyFromBytes(row_offsets.data(), row_offsets.size() * sizeof(int64_t));
+      return {features, offsets};
+    });
 TVM_REGISTER_GLOBAL("meta_schedule.FeatureExtractorPyFeatureExtractor")
     .set_body_typed(FeatureExtractor::PyFeatureExtractor);
 
@@ -18,6 +18,7 @@
  */
 #include <tvm/tir/transform.h>
 
+#include <array>
 #include <cmath>
 #include <memory>
 #include <numeric>
@@ -1367,24 +1368,31 @@ class PerStoreFeatureNode : public FeatureExtractorNode {
   }
 
   void ExtractSingle(IRModule mod, bool is_gpu, std::vector<std::vector<double>>* results) {
-    static transform::Sequential passes = tir::transform::PassListForPerStoreFeature();
-    mod = passes(std::move(mod));
-    std::vector<tir::Feature> features = tir::PerStoreFeatureCollector::Collect(
-        is_gpu, this->cache_line_bytes, this->arith_intensity_curve_num_samples, mod);
+    std::vector<tir::Feature> features = CollectFeatures(std::move(mod), is_gpu);
     int n_features = features.size();
     results->resize(n_features);
     for (int i = 0; i < n_features; ++i) {
-      const tir::Feature& feature = features[i];
       std::vector<double>& result = (*results)[i];
       result.reserve(feature_vector_length);
-      feature.group1->Export(&result);
-      feature.group2->Export(&result, this->buffers_per_store);
-      feature.group3->Export(&result);
-      feature.group4->Export(&result, feature.group5->outer_prod);
-      feature.group5->Export(&result);
+      ExportFeature(features[i], &result);
     }
   }
 
+  std::vector<tir::Feature> CollectFeatures(IRModule mod, bool is_gpu) {
+    static transform::Sequential passes = tir::transform::PassListForPerStoreFeature();
+    mod = passes(std::move(mod));
+    return tir::PerStoreFeatureCollector::Collect(is_gpu, this->cache_line_bytes,
+                                                  this->arith_intensity_curve_num_samples, mod);
+  }
+
+  void ExportFeature(const tir::Feature& feature, std::vector<double>* result) {
+    feature.group1->Export(result);
+    feature.group2->Export(result, this->buffers_per_store);
+    feature.group3->Export(result);
+    feature.group4->Export(result, feature.group5->outer_prod);
+    feature.group5->Export(result);
+  }
+
   Array<runtime::NDArray> ExtractFrom(const TuneContext& tune_context,
                                       const Array<MeasureCandidate>& candidates) {
     bool is_gpu = tune_context->target.value()->kind->name == "cuda";
@@ -1409,6 +1417,61 @@ class PerStoreFeatureNode : public FeatureExtractorNode {
     return results;
   }
 
+  runtime::NDArray ExtractBatch(const TuneContext& tune_context,
+                                const Array<MeasureCandidate>& candidates,
+                                std::vector<int64_t>* row_offsets) final {
+    bool is_gpu = tune_context->target.value()->kind->name == "cuda";
+    int n = candidates.size();
+    int num_threads = std::max(1, tune_context->num_threads);
+    std::unique_ptr<tir::group6::Feature> feature_group6 = nullptr;
+    if (extract_workload) {
+      feature_group6 = std::make_unique<tir::group6::Feature>(tune_context->mod.value());
+    }
+    // Each thread exports the rows of its candidates into its own buffer, reusing one row of
+    // scratch space, and the buffers are gathered into the result once all rows are known.
+    struct ThreadState {
+      std::vector<double> row;
+      std::vector<float> rows;
+    };
+    std::vector<ThreadState> states(num_threads);
+    // The thread, the first row in its buffer, and the number of rows of each candidate.
+    std::vector<std::array<int64_t, 3>> locations(n);
+    auto f = [&](int thread_id, int task_id) -> void {
+      ThreadState& state = states[thread_id];
+      std::vector<tir::Feature> features =
+          CollectFeatures(DeepCopyIRModule(candidates[task_id]->sch->mod()), is_gpu);
+      int64_t start = state.rows.size() / feature_vector_length;
+      for (const tir::Feature& feature : features) {
+        state.row.clear();
+        ExportFeature(feature, &state.row);
+        if (feature_group6) {
+          feature_group6->Export(&state.row);
+        }
+        ICHECK_EQ(state.row.size(), static_cast<size_t>(feature_vector_length));
+        state.rows.insert(state.rows.end(), state.row.begin(), state.row.end());
+      }
+      locations[task_id] = {thread_id, start, static_cast<int64_t>(features.size())};
+    };
+    support::parallel_for_dynamic(0, n, num_threads, f);
+    row_offsets->resize(n + 1);
+    int64_t num_rows = 0;
+    for (int i = 0; i < n; ++i) {
+      (*row_offsets)[i] = num_rows;
+      num_rows += locations[i][2];
+    }
+    (*row_offsets)[n] = num_rows;
+    runtime::NDArray result = runtime::NDArray::Empty(
+        {num_rows, feature_vector_length}, DLDataType{kDLFloat, 32, 1}, {kDLCPU, 0});
+    float* data = static_cast<float*>(result->data);
+    for (int i = 0; i < n; ++i) {
+      const auto& [thread_id, start, count] = locations[i];
+      const float* src = states[thread_id].rows.data() + start * feature_vector_length;
+      std::copy(src, src + count * feature_vector_length, data);
+      data += count * feature_vector_length;
+    }
+    return result;
+  }
+
   static constexpr const char* _type_key = "meta_schedule.PerStoreFeature";
   TVM_DECLARE_FINAL_OBJECT_INFO(PerStoreFeatureNode, FeatureExtractorNode);
 };
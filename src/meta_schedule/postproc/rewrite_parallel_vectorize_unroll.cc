@@ -98,11 +98,12 @@ struct ParsedAnnotation {
   int unroll_implicit;
   int num_parallel_loops;
   int num_vectorize_loops;
+  int scalable_vectorize;
 };
 
 bool ParseAnnotation(const Block& block, ParsedAnnotation* parsed) {
   bool found = false;
-  *parsed = ParsedAnnotation{-1, -1, -1, -1, -1, -1};
+  *parsed = ParsedAnnotation{-1, -1, -1, -1, -1, -1, -1};
   for (const auto& ann : block->annotations) {
     if (ann.first == attr::meta_schedule_parallel) {
       found = true;
@@ -114,6 +115,11 @@ bool ParseAnnotation(const Block& block, ParsedAnnotation* parsed) {
       if (const auto* imm = ann.second.as<tir::IntImmNode>()) {
         parsed->max_vectorize_extent = imm->value;
       }
+    } else if (ann.first == attr::meta_schedule_scalable_vectorize) {
+      found = true;
+      if (const auto* imm = ann.second.as<tir::IntImmNode>()) {
+        parsed->scalable_vectorize = imm->value;
+      }
     } else if (ann.first == attr::meta_schedule_unroll_explicit) {
       found = true;
       if (const auto* imm = ann.second.as<tir::IntImmNode>()) {
@@ -136,6 +142,9 @@ void RemoveParsedAnn(const Schedule& sch, const BlockRV& block_rv, const ParsedA
   if (parsed.max_vectorize_extent != -1) {
     sch->Unannotate(block_rv, attr::meta_schedule_vectorize);
   }
+  if (parsed.scalable_vectorize != -1) {
+    sch->Unannotate(block_rv, attr::meta_schedule_scalable_vectorize);
+  }
   if (parsed.unroll_explicit != -1) {
     sch->Unannotate(block_rv, attr::meta_schedule_unroll_explicit);
   }
@@ -259,6 +268,7 @@ void AdjustParallelVectorize(const Schedule& sch, const BlockRV& block_rv,
     int max_extent = parsed->max_vectorize_extent;
     int& num_fusible = parsed->num_vectorize_loops = 0;
     int64_t prod_extent = 1;
+    bool symbolic_extent = false;
     for (int i = n_loops - 1;
          i >= 0 && loop_types[i] == IterVarType::kDataPar && num_fusible < max_fusible; --i) {
       const StmtSRef& loop_sref = loop_srefs[i];
@@ -277,6 +287,11 @@ void AdjustParallelVectorize(const Schedule& sch, const BlockRV& block_rv,
       // Check if the loop extent is valid
       const int64_t* extent = GetLoopIntExtent(loop_sref);
       if (extent == nullptr) {
+        // Scalable vectors cover the innermost loop of a symbolic extent alone
+        symbolic_extent = parsed->scalable_vectorize > 0 && num_fusible == 0;
+        if (symbolic_extent) {
+          num_fusible = 1;
+        }
         break;
       }
       // Check if the extent is still in a good range
@@ -286,7 +301,7 @@ void AdjustParallelVectorize(const Schedule& sch, const BlockRV& block_rv,
       }
       ++num_fusible;
     }
-    if (prod_extent == 1) {
+    if (prod_extent == 1 && !symbolic_extent) {
       num_fusible = -1;
     }
   }
@@ -326,11 +341,16 @@ void RewriteParallel(const Schedule& sch, size_t n, Array<LoopRV>* loop_rvs) {
   }
 }
 
-void RewriteVectorize(const Schedule& sch, size_t n, Array<LoopRV>* loop_rvs) {
+void RewriteVectorize(const Schedule& sch, size_t n, bool scalable, Array<LoopRV>* loop_rvs) {
   size_t n_loops = loop_rvs->size();
   ICHECK_LE(n, n_loops);
   LoopRV fused = sch->Fuse({loop_rvs->end() - n, loop_rvs->end()});
-  sch->Vectorize(fused);
+  if (scalable) {
+    // Leave the loop serial for the LLVM loop vectorizer to pick a multiple of vscale
+    sch->Annotate(fused, attr::scalable_vectorize, Integer(1));
+  } else {
+    sch->Vectorize(fused);
+  }
   for (size_t i = n_loops - n; i < n_loops; ++i) {
     loop_rvs->Set(i, fused);
   }
@@ -370,7 +390,8 @@ class RewriteParallelVectorizeUnrollNode : public PostprocNode {
         }
         // Vectorize
         if (parsed.num_vectorize_loops > 0) {
-          tir::RewriteVectorize(sch, parsed.num_vectorize_loops, &loop_rvs);
+          tir::RewriteVectorize(sch, parsed.num_vectorize_loops, parsed.scalable_vectorize > 0,
+                                &loop_rvs);
         }
         // AutoUnroll
         if (parsed.unroll_explicit != -1 || parsed.unroll_implicit != -1) {
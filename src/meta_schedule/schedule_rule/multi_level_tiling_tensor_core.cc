@@ -317,7 +317,11 @@ std::vector<State> MultiLevelTilingTensorCoreNode::AddSoftwarePipeline(
     const Array<LoopRV>& tiles = state->tiles[r_index];
     for (const LoopRV& tile : tiles) {
       const auto* extent = sch->Get(tile)->extent.as<IntImmNode>();
-      ICHECK(extent != nullptr) << "Dynamic extent is not supported.";
+      if (extent == nullptr) {
+        // The reduction loop is padded to a dynamic length; skip the pipeline, whose prologue and
+        // epilogue need a static trip count.
+        return {state};
+      }
       reduction_length *= extent->value;
     }
   }
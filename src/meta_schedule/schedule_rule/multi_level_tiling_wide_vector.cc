@@ -88,8 +88,9 @@ Array<tir::LoopRV> MultiLevelTilingWideVectorNode::SplitLoop(const Schedule& sch
     return MultiLevelTilingNode::SplitLoop(sch, block_rv, loop_rv, n_tiles);
   } else {
     // We split the innermost spatial loop in a way that always uses the maximum vector length.
+    // A dynamic extent is split in the same way, leaving the tail to the predicate of the block.
     const int64_t* extent_int = tir::GetLoopIntExtent(loop);
-    if (extent_int && *extent_int > vec_len) {
+    if (!extent_int || *extent_int > vec_len) {
       Array<tir::LoopRV> inner_splits = sch->Split(/*loop=*/loop_rv,
                                                    /*factors=*/{NullOpt, PrimExpr(vec_len)});
       Array<tir::ExprRV> outer_factors = sch->SamplePerfectTile(
@@ -31,6 +31,20 @@ bool CheckSpatialPrimFunc(const Schedule& sch, const BlockRV& root_block_rv) {
       GetRef<PrimFunc>(GetRootPrimFunc(sch->mod(), sch->Get(root_block_rv).get(), nullptr)));
 }
 
+/*! \brief Check if the target has scalable vectors, i.e. Arm SVE or the RISC-V V extension. */
+bool HasScalableVector(const Target& target) {
+  if (target->kind->name != "llvm") {
+    return false;
+  }
+  Array<String> mattr = target->GetAttr<Array<String>>("mattr").value_or({});
+  for (const String& feature : mattr) {
+    if (feature == "+sve" || feature == "+sve2" || feature == "+v") {
+      return true;
+    }
+  }
+  return false;
+}
+
 }  // namespace tir
 }  // namespace tvm
 
@@ -46,6 +60,7 @@ class ParallelizeVectorizeUnrollNode : public ScheduleRuleNode {
       Target target = context->target.value();
       this->max_parallel_extent_ = GetTargetNumCores(target) * max_jobs_per_core;
     }
+    this->scalable_vectorize_ = tir::HasScalableVector(context->target.value());
   }
 
   // Inherited from ScheduleRuleNode
@@ -63,6 +78,9 @@ class ParallelizeVectorizeUnrollNode : public ScheduleRuleNode {
     // Vectorization
     if (max_vectorize_extent != -1) {
       sch->Annotate(root_rv, tir::attr::meta_schedule_vectorize, Integer(max_vectorize_extent));
+      if (scalable_vectorize_) {
+        sch->Annotate(root_rv, tir::attr::meta_schedule_scalable_vectorize, Integer(1));
+      }
     }
     // Unroll
     if (!unroll_max_steps.empty() && !tir::CheckSpatialPrimFunc(sch, root_rv)) {
@@ -107,13 +125,15 @@ class ParallelizeVectorizeUnrollNode : public ScheduleRuleNode {
   bool unroll_explicit;
   /*! \brief The number of maximum available jobs in CPU. */
   int64_t max_parallel_extent_;
+  /*! \brief Whether the target vectorizes with scalable vectors. */
+  bool scalable_vectorize_ = false;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     v->Visit("max_jobs_per_core", &max_jobs_per_core);
     v->Visit("max_vectorize_extent", &max_vectorize_extent);
     v->Visit("unroll_max_steps", &unroll_max_steps);
     v->Visit("unroll_explicit", &unroll_explicit);
-    // `max_parallel_extent_` is not visited
+    // `max_parallel_extent_` and `scalable_vectorize_` are not visited
   }
 
   static constexpr const char* _type_key = "meta_schedule.ParallelizeVectorizeUnroll";
@@ -263,6 +263,8 @@ class EvolutionarySearchNode : public SearchStrategyNode {
     CostModel cost_model_{nullptr};
     /*! \brief The token registered for the given workload in database. */
     Workload token_{nullptr};
+    /*! \brief The best traces of the same computation on other shapes, to seed the population. */
+    std::vector<tir::Trace> transferred_traces_;
 
     explicit State(EvolutionarySearchNode* self, int max_trials, int num_trials_per_iter,
                    Array<Schedule> design_space_schedules, Database database, CostModel cost_model)
@@ -286,6 +288,10 @@ class EvolutionarySearchNode : public SearchStrategyNode {
       this->database_ = database;
       this->cost_model_ = cost_model;
       this->token_ = database->CommitWorkload(mod);
+      int num_transferred = self->population_size * self->init_measured_ratio;
+      for (const TuningRecord& record : database->GetTopKNearest(mod, num_transferred)) {
+        this->transferred_traces_.push_back(record->trace);
+      }
     }
 
     /*!
@@ -477,6 +483,30 @@ std::vector<Schedule> EvolutionarySearchNode::State::PickBestFromDatabase(int nu
     }
   };
   support::parallel_for_dynamic(0, actual_num, self->ctx_->num_threads, f_proc_measured);
+  // Fill up with the traces tuned on other shapes. Their sampling decisions are adapted to the
+  // new extents on replay, and the ones no longer valid on this workload are dropped.
+  int num_transferred = std::min(num - actual_num, static_cast<int>(transferred_traces_.size()));
+  if (num_transferred > 0) {
+    std::vector<Schedule> transferred(num_transferred, Schedule{nullptr});
+    auto f_proc_transferred = [this, &transferred, &pp](int thread_id, int trace_id) -> void {
+      PerThreadData& data = this->per_thread_data_.at(thread_id);
+      try {
+        if (Optional<Schedule> sch =
+                pp.Apply(data.mod, transferred_traces_.at(trace_id), &data.rand_state)) {
+          transferred.at(trace_id) = sch.value();
+        }
+      } catch (const std::exception& e) {
+        // The trace does not apply to this workload
+      }
+    };
+    support::parallel_for_dynamic(0, num_transferred, self->ctx_->num_threads,
+                                  f_proc_transferred);
+    for (const Schedule& sch : transferred) {
+      if (sch.defined()) {
+        results.push_back(sch);
+      }
+    }
+  }
   return results;
 }
 
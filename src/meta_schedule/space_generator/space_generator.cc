@@ -49,6 +49,10 @@ String GetRuleKindFromTarget(const Target& target) {
     return "cuda";
   }
   if (target->kind->name == "vulkan") {
+    // The wmma tensor intrinsics are lowered to the KHR cooperative matrices.
+    if (target->GetAttr<Bool>("supports_cooperative_matrix", Bool(false)).value()) {
+      return "cuda_tensorcore";
+    }
     return "cuda";
   }
   LOG(FATAL) << "Unsupported target: " << target;
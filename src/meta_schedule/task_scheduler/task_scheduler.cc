@@ -16,11 +16,20 @@
  * specific language governing permissions and limitations
  * under the License.
  */
+#include <chrono>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
 #include "../utils.h"
 
 namespace tvm {
 namespace meta_schedule {
 
+std::vector<ObjectRef> JSONFileReadLines(const String& path, int num_threads, bool allow_missing);
+void JSONFileAppendLine(const String& path, const std::string& line);
+
 TaskRecord::TaskRecord(TuneContext ctx, double task_weight) {
   ObjectPtr<TaskRecordNode> n = runtime::make_object<TaskRecordNode>();
   n->ctx = ctx;
@@ -38,43 +47,93 @@ TaskRecord::TaskRecord(TuneContext ctx, double task_weight) {
   this->data_ = std::move(n);
 }
 
-void SendToBuilder(TaskRecordNode* self, const Builder& builder) {
-  auto _ = Profiler::TimedScope("SendToBuilder");
-  Array<MeasureCandidate> candidates = self->measure_candidates.value();
-  Target target = self->ctx->target.value();
+/*! \brief The run time of the measured candidates, keyed by MeasureCacheKey. */
+using MeasureCache = std::unordered_map<std::string, Array<FloatImm>>;
+
+/*!
+ * \brief The key of a measure candidate in the measure cache, i.e. the structural hash of its
+ * scheduled module together with the target.
+ * \param candidate The measure candidate.
+ * \param target The target to run on.
+ * \return The key.
+ */
+std::string MeasureCacheKey(const MeasureCandidate& candidate, const Target& target) {
+  return std::to_string(StructuralHash()(candidate->sch->mod())) + "|" + target->str();
+}
+
+/*!
+ * \brief Build the candidates that are not in the measure cache. The builder results of the cached
+ * candidates have neither an artifact nor an error.
+ * \param candidates The measure candidates.
+ * \param target The target to build for.
+ * \param builder The builder.
+ * \param measure_cache The measure cache, or nullptr if it is disabled.
+ * \return The builder results of the candidates.
+ */
+Array<BuilderResult> BuildCandidates(const Array<MeasureCandidate>& candidates,
+                                     const Target& target, const Builder& builder,
+                                     const MeasureCache* measure_cache) {
+  int n = candidates.size();
+  std::vector<bool> is_cached(n, false);
   Array<BuilderInput> inputs;
-  inputs.reserve(candidates.size());
-  for (const MeasureCandidate& candidate : candidates) {
-    inputs.push_back(BuilderInput(candidate->sch->mod(), target));
+  inputs.reserve(n);
+  for (int i = 0; i < n; ++i) {
+    const MeasureCandidate& candidate = candidates[i];
+    if (measure_cache != nullptr && measure_cache->count(MeasureCacheKey(candidate, target))) {
+      is_cached[i] = true;
+    } else {
+      inputs.push_back(BuilderInput(candidate->sch->mod(), target));
+    }
+  }
+  if (static_cast<int>(inputs.size()) == n) {
+    return builder->Build(inputs);
   }
-  self->builder_results = builder->Build(inputs);
+  Array<BuilderResult> built = inputs.empty() ? Array<BuilderResult>{} : builder->Build(inputs);
+  Array<BuilderResult> results;
+  results.reserve(n);
+  for (int i = 0, j = 0; i < n; ++i) {
+    results.push_back(is_cached[i] ? BuilderResult(NullOpt, NullOpt) : built[j++]);
+  }
+  return results;
 }
 
-void SendToRunner(TaskRecordNode* self, const Runner& runner) {
-  auto _ = Profiler::TimedScope("SendToRunner");
-  Array<MeasureCandidate> candidates = self->measure_candidates.value();
-  Array<BuilderResult> builder_results = self->builder_results.value();
-  Target target = self->ctx->target.value();
+void SendToBuilder(TaskRecordNode* self, const Builder& builder,
+                   const MeasureCache* measure_cache) {
+  auto _ = Profiler::TimedScope("SendToBuilder");
+  self->builder_results = BuildCandidates(self->measure_candidates.value(),
+                                          self->ctx->target.value(), builder, measure_cache);
+}
+
+/*!
+ * \brief Send the built candidates to the runner, with the failed builds resolved to their errors,
+ * and the cached candidates resolved to their cached run time.
+ * \param candidates The measure candidates.
+ * \param builder_results The builder results of the candidates.
+ * \param target The target to run on.
+ * \param runner The runner.
+ * \param measure_cache The measure cache, or nullptr if it is disabled.
+ * \return The runner futures of the candidates.
+ */
+Array<RunnerFuture> SubmitToRunner(const Array<MeasureCandidate>& candidates,
+                                   const Array<BuilderResult>& builder_results,
+                                   const Target& target, const Runner& runner,
+                                   const MeasureCache* measure_cache) {
   ICHECK_EQ(candidates.size(), builder_results.size());
   int n = candidates.size();
-  int n_build_errors = 0;
   Array<RunnerInput> inputs;
   inputs.reserve(n);
   for (int i = 0; i < n; ++i) {
     const MeasureCandidate& candidate = candidates[i];
     const BuilderResult& builder_result = builder_results[i];
-    if (builder_result->error_msg.defined()) {
-      ++n_build_errors;
-      continue;
+    if (builder_result->artifact_path.defined() && !builder_result->error_msg.defined()) {
+      inputs.push_back(RunnerInput(/*artifact_path=*/builder_result->artifact_path.value(),
+                                   /*device_type=*/target->kind->name,
+                                   /*args_info=*/candidate->args_info));
     }
-    inputs.push_back(RunnerInput(/*artifact_path=*/builder_result->artifact_path.value(),
-                                 /*device_type=*/target->kind->name,
-                                 /*args_info=*/candidate->args_info));
   }
-  Array<RunnerFuture> futures = runner->Run(inputs);
-  if (n_build_errors == 0) {
-    self->runner_futures = futures;
-    return;
+  Array<RunnerFuture> futures = inputs.empty() ? Array<RunnerFuture>{} : runner->Run(inputs);
+  if (static_cast<int>(futures.size()) == n) {
+    return futures;
   }
   Array<RunnerFuture> results;
   results.reserve(n);
@@ -87,11 +146,25 @@ void SendToRunner(TaskRecordNode* self, const Runner& runner) {
           [msg = builder_result->error_msg]() -> RunnerResult {
             return RunnerResult(NullOpt, msg);
           }));
+    } else if (!builder_result->artifact_path.defined()) {
+      ICHECK(measure_cache != nullptr);
+      Array<FloatImm> run_secs = measure_cache->at(MeasureCacheKey(candidates[i], target));
+      results.push_back(RunnerFuture(
+          /*f_done=*/[]() -> bool { return true; },
+          /*f_result=*/
+          [run_secs]() -> RunnerResult { return RunnerResult(run_secs, NullOpt); }));
     } else {
       results.push_back(futures[j++]);
     }
   }
-  self->runner_futures = results;
+  return results;
+}
+
+void SendToRunner(TaskRecordNode* self, const Runner& runner, const MeasureCache* measure_cache) {
+  auto _ = Profiler::TimedScope("SendToRunner");
+  self->runner_futures = SubmitToRunner(self->measure_candidates.value(),
+                                        self->builder_results.value(), self->ctx->target.value(),
+                                        runner, measure_cache);
 }
 
 void TaskCleanUp(TaskRecordNode* self, int task_id, const Array<RunnerResult>& results) {
@@ -138,6 +211,29 @@ void TaskCleanUp(TaskRecordNode* self, int task_id, const Array<RunnerResult>& r
   self->runner_futures = NullOpt;
 }
 
+/*!
+ * \brief Check if the best latency of a task improves by no more than the threshold over the
+ * latest trials.
+ * \param task The task to be checked.
+ * \param window The number of the latest trials.
+ * \param threshold The relative improvement at or below which the task is converged.
+ * \return Whether the task is converged.
+ */
+bool IsConverged(const TaskRecordNode* task, int window, double threshold) {
+  int n = task->latency_ms.size();
+  if (window <= 0 || n <= window) {
+    return false;
+  }
+  double best_before = *std::min_element(task->latency_ms.begin(), task->latency_ms.end() - window);
+  double best = std::min(best_before, *std::min_element(task->latency_ms.end() - window,
+                                                        task->latency_ms.end()));
+  // A task without any valid measurement before the window keeps searching.
+  if (best_before >= 1e9) {
+    return false;
+  }
+  return best_before - best <= threshold * best_before;
+}
+
 void TaskSchedulerNode::Tune(Array<TuneContext> ctxs, Array<FloatImm> task_weights,
                              int max_trials_global, int max_trials_per_task,
                              int num_trials_per_iter, Builder builder, Runner runner,
@@ -173,6 +269,10 @@ void TaskSchedulerNode::Tune(Array<TuneContext> ctxs, Array<FloatImm> task_weigh
                                             database, cost_model);
   }
 
+  auto start_time = std::chrono::steady_clock::now();
+  auto f_elapsed_sec = [&start_time]() -> double {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+  };
   int num_trials_already = 0;
   for (int task_id; num_trials_already < max_trials_global && (task_id = NextTaskId()) != -1;) {
     TVM_PY_LOG(INFO, this->logger)
@@ -184,14 +284,33 @@ void TaskSchedulerNode::Tune(Array<TuneContext> ctxs, Array<FloatImm> task_weigh
       TerminateTask(task_id);
       continue;
     }
+    if (double elapsed_sec = f_elapsed_sec();
+        max_tuning_time_sec > 0 && elapsed_sec >= max_tuning_time_sec) {
+      LogStopping(/*task_id=*/-1, "time_budget", elapsed_sec);
+      break;
+    }
+    if (IsConverged(task, convergence_window, convergence_threshold)) {
+      LogStopping(task_id, "converged", f_elapsed_sec());
+      TerminateTask(task_id);
+      continue;
+    }
     if (Optional<Array<MeasureCandidate>> candidates = task->measure_candidates =
             task->ctx->search_strategy.value()->GenerateMeasureCandidates()) {
       int num_candidates = candidates.value().size();
       num_trials_already += num_candidates;
-      TVM_PY_LOG(INFO, this->logger) << "Sending " << num_candidates << " sample(s) to builder";
-      SendToBuilder(task, builder);
-      TVM_PY_LOG(INFO, this->logger) << "Sending " << num_candidates << " sample(s) to runner";
-      SendToRunner(task, runner);
+      if (pipeline_chunk_size > 0 && num_candidates > pipeline_chunk_size) {
+        TVM_PY_LOG(INFO, this->logger) << "Sending " << num_candidates << " sample(s) to builder "
+                                       << "and runner in chunks of " << pipeline_chunk_size;
+        SendToPipeline(task_id, builder, runner);
+      } else {
+        TVM_PY_LOG(INFO, this->logger) << "Sending " << num_candidates << " sample(s) to builder";
+        SendToBuilder(task, builder, this->GetMeasureCache());
+        if (max_unmeasured_candidates > 0) {
+          WaitForRunner(std::max(0, max_unmeasured_candidates - num_candidates), {});
+        }
+        TVM_PY_LOG(INFO, this->logger) << "Sending " << num_candidates << " sample(s) to runner";
+        SendToRunner(task, runner, this->GetMeasureCache());
+      }
     } else {
       TerminateTask(task_id);
     }
@@ -226,6 +345,22 @@ Array<RunnerResult> TaskSchedulerNode::JoinRunningTask(int task_id) {
   ICHECK(task->builder_results.defined());
   ICHECK_EQ(results.size(), task->measure_candidates.value().size());
   ICHECK_EQ(results.size(), task->builder_results.value().size());
+  if (!this->measure_cache_path.empty()) {
+    auto _ = Profiler::TimedScope("UpdateMeasureCache");
+    Target target = task->ctx->target.value();
+    for (int i = 0, n = results.size(); i < n; ++i) {
+      const BuilderResult& builder_result = task->builder_results.value()[i];
+      const RunnerResult& result = results[i];
+      if (builder_result->artifact_path.defined() && result->run_secs.defined() &&
+          !result->error_msg.defined()) {
+        std::string key = MeasureCacheKey(task->measure_candidates.value()[i], target);
+        if (this->measure_cache_.emplace(key, result->run_secs.value()).second) {
+          JSONFileAppendLine(this->measure_cache_path,
+                             JSONDumps(Array<ObjectRef>{String(key), result->run_secs.value()}));
+        }
+      }
+    }
+  }
   for (const MeasureCallback& callback : this->measure_callbacks_) {
     callback->Apply(GetRef<TaskScheduler>(this), task_id, task->measure_candidates.value(),
                     task->builder_results.value(), results);
@@ -238,6 +373,66 @@ Array<RunnerResult> TaskSchedulerNode::JoinRunningTask(int task_id) {
   return results;
 }
 
+void TaskSchedulerNode::SendToPipeline(int task_id, const Builder& builder,
+                                       const Runner& runner) {
+  TaskRecordNode* task = this->tasks_[task_id].get();
+  Array<MeasureCandidate> candidates = task->measure_candidates.value();
+  Target target = task->ctx->target.value();
+  int n = candidates.size();
+  Array<BuilderResult> builder_results;
+  Array<RunnerFuture> runner_futures;
+  builder_results.reserve(n);
+  runner_futures.reserve(n);
+  for (int st = 0; st < n; st += pipeline_chunk_size) {
+    int ed = std::min(st + pipeline_chunk_size, n);
+    Array<MeasureCandidate> chunk(candidates.begin() + st, candidates.begin() + ed);
+    Array<BuilderResult> chunk_results;
+    {
+      auto _ = Profiler::TimedScope("SendToBuilder");
+      chunk_results = BuildCandidates(chunk, target, builder, this->GetMeasureCache());
+    }
+    // The chunk is built while the previous ones are measured; it waits only for the runner to
+    // drain below the limit, so that the built artifacts do not pile up.
+    if (max_unmeasured_candidates > 0) {
+      WaitForRunner(std::max(0, max_unmeasured_candidates - (ed - st)), runner_futures);
+    }
+    {
+      auto _ = Profiler::TimedScope("SendToRunner");
+      for (const RunnerFuture& future :
+           SubmitToRunner(chunk, chunk_results, target, runner, this->GetMeasureCache())) {
+        runner_futures.push_back(future);
+      }
+    }
+    for (const BuilderResult& result : chunk_results) {
+      builder_results.push_back(result);
+    }
+  }
+  task->builder_results = builder_results;
+  task->runner_futures = runner_futures;
+}
+
+void TaskSchedulerNode::WaitForRunner(int num_unmeasured,
+                                      const Array<RunnerFuture>& pending) const {
+  auto _ = Profiler::TimedScope("WaitForRunner");
+  auto count_unmeasured = [&]() {
+    int count = 0;
+    for (const RunnerFuture& future : pending) {
+      count += !future->Done();
+    }
+    for (const TaskRecord& task : this->tasks_) {
+      if (task->runner_futures.defined()) {
+        for (const RunnerFuture& future : task->runner_futures.value()) {
+          count += !future->Done();
+        }
+      }
+    }
+    return count;
+  };
+  while (count_unmeasured() > num_unmeasured) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+}
+
 void TaskSchedulerNode::TouchTask(int task_id) {
   TaskRecordNode* task = this->tasks_[task_id].get();
   if (!task->is_terminated && task->runner_futures.defined()) {
@@ -262,6 +457,35 @@ void TaskSchedulerNode::TerminateTask(int task_id) {
                                  << this->TuningStatistics();
 }
 
+void TaskSchedulerNode::LogStopping(int task_id, const String& reason, double elapsed_sec) {
+  std::string task_name = "*";
+  int trials = 0;
+  double best_ms = 1e9;
+  for (int i = 0, n = this->tasks_.size(); i < n; ++i) {
+    const TaskRecordNode* task = this->tasks_[i].get();
+    if (task_id == -1 ? task->is_terminated : i != task_id) {
+      continue;
+    }
+    trials += task->latency_ms.size();
+    if (!task->latency_ms.empty()) {
+      best_ms = std::min(best_ms,
+                         *std::min_element(task->latency_ms.begin(), task->latency_ms.end()));
+    }
+  }
+  if (task_id != -1) {
+    task_name = this->tasks_[task_id]->ctx->task_name.value();
+  }
+  TVM_PY_LOG(INFO, this->logger) << std::fixed << std::setprecision(4) << "Stopping "
+                                 << (task_id == -1 ? "all the remaining tasks" : task_name)
+                                 << " after " << elapsed_sec << " sec: " << reason;
+  if (!this->stopping_log_path.empty()) {
+    JSONFileAppendLine(this->stopping_log_path,
+                       JSONDumps(Array<ObjectRef>{String(task_name), reason, Integer(trials),
+                                                  FloatImm(DataType::Float(64), best_ms),
+                                                  FloatImm(DataType::Float(64), elapsed_sec)}));
+  }
+}
+
 std::string TaskSchedulerNode::TuningStatistics() const {
   std::ostringstream os;
   int n_tasks = this->tasks_.size();
@@ -354,6 +578,22 @@ void PyTaskSchedulerNode::Tune(Array<TuneContext> tasks, Array<FloatImm> task_we
   }
 }
 
+void TaskSchedulerNode::SetMeasureCache(const String& path) {
+  this->measure_cache_path = path;
+  this->measure_cache_.clear();
+  if (path.empty()) {
+    return;
+  }
+  std::vector<ObjectRef> json_objs =
+      JSONFileReadLines(path, std::thread::hardware_concurrency(), /*allow_missing=*/true);
+  for (const ObjectRef& json_obj : json_objs) {
+    const ArrayNode* arr = json_obj.as<ArrayNode>();
+    CHECK(arr && arr->size() == 2)
+        << "ValueError: Unable to parse the measure cache entry: " << json_obj;
+    this->measure_cache_.emplace(Downcast<String>(arr->at(0)), AsFloatArray(arr->at(1)));
+  }
+}
+
 TVM_REGISTER_NODE_TYPE(TaskRecordNode);
 TVM_REGISTER_OBJECT_TYPE(TaskSchedulerNode);
 TVM_REGISTER_NODE_TYPE(PyTaskSchedulerNode);
@@ -371,6 +611,27 @@ TVM_REGISTER_GLOBAL("meta_schedule.TaskSchedulerTouchTask")
     .set_body_method<TaskScheduler>(&TaskSchedulerNode::TouchTask);
 TVM_REGISTER_GLOBAL("meta_schedule.TaskSchedulerTuningStatistics")
     .set_body_method<TaskScheduler>(&TaskSchedulerNode::TuningStatistics);
+TVM_REGISTER_GLOBAL("meta_schedule.TaskSchedulerSetMeasureCache")
+    .set_body_method<TaskScheduler>(&TaskSchedulerNode::SetMeasureCache);
+TVM_REGISTER_GLOBAL("meta_schedule.TaskSchedulerSetStopping")
+    .set_body_typed([](TaskScheduler self, double max_tuning_time_sec, int convergence_window,
+                       double convergence_threshold, String stopping_log_path) {
+      CHECK_GE(max_tuning_time_sec, 0) << "ValueError: max_tuning_time_sec must be non-negative";
+      CHECK_GE(convergence_window, 0) << "ValueError: convergence_window must be non-negative";
+      self->max_tuning_time_sec = max_tuning_time_sec;
+      self->convergence_window = convergence_window;
+      self->convergence_threshold = convergence_threshold;
+      self->stopping_log_path = stopping_log_path;
+    });
+TVM_REGISTER_GLOBAL("meta_schedule.TaskSchedulerSetPipeline")
+    .set_body_typed([](TaskScheduler self, int pipeline_chunk_size,
+                       int max_unmeasured_candidates) {
+      CHECK_GE(pipeline_chunk_size, 0) << "ValueError: pipeline_chunk_size must be non-negative";
+      CHECK_GE(max_unmeasured_candidates, 0)
+          << "ValueError: max_unmeasured_candidates must be non-negative";
+      self->pipeline_chunk_size = pipeline_chunk_size;
+      self->max_unmeasured_candidates = max_unmeasured_candidates;
+    });
 
 }  // namespace meta_schedule
 }  // namespace tvm
@@ -62,6 +62,28 @@ void TuneContextNode::Initialize() {
   }
 }
 
+IRModule NormalizeMod(const ObjectRef& mod) {
+  IRModule result{nullptr};
+  if (const auto* prim_func = mod.as<tir::PrimFuncNode>()) {
+    tir::PrimFunc func = GetRef<tir::PrimFunc>(prim_func);
+    func = WithAttr(std::move(func), tvm::attr::kGlobalSymbol, String("main"));
+    func = WithAttr(std::move(func), tir::attr::kNoAlias, Bool(true));
+    result = IRModule({{GlobalVar("main"), func}});
+  } else if (const auto* ir_mod = mod.as<IRModuleNode>()) {
+    result = GetRef<IRModule>(ir_mod);
+  } else {
+    LOG(FATAL) << "TypeError: Expected `mod` to be PrimFunc or IRModule, but gets: "
+               << mod->GetTypeKey();
+  }
+  CHECK_EQ(result->functions.size(), 1)
+      << "ValueError: Expected the IRModule to contain a single function, but gets: " << result;
+  const auto& [gv, func] = *result->functions.begin();
+  if (gv->name_hint != "main") {
+    result = IRModule({{GlobalVar("main"), func}});
+  }
+  return result;
+}
+
 TVM_REGISTER_NODE_TYPE(TuneContextNode);
 TVM_REGISTER_GLOBAL("meta_schedule.TuneContext")
     .set_body_typed([](Optional<IRModule> mod, Optional<Target> target,
@@ -71,6 +93,7 @@ TVM_REGISTER_GLOBAL("meta_schedule.TuneContext")
       return TuneContext(mod, target, space_generator, search_strategy, task_name, num_threads,
                          rand_state, logger);
     });
+TVM_REGISTER_GLOBAL("meta_schedule.NormalizeMod").set_body_typed(NormalizeMod);
 TVM_REGISTER_GLOBAL("meta_schedule._SHash2Hex").set_body_typed(SHash2Hex);
 TVM_REGISTER_GLOBAL("meta_schedule.TuneContextInitialize")
     .set_body_method<TuneContext>(&TuneContextNode::Initialize);
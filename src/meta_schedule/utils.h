@@ -191,6 +191,30 @@ ObjectRef JSONLoads(std::string json_str);
  */
 std::string JSONDumps(ObjectRef json_obj);
 
+/*!
+ * \brief An exclusive advisory lock of a file, held until the object is destroyed. It serializes
+ * the accesses to a JSON database shared by multiple processes, possibly on different hosts of a
+ * shared file system.
+ */
+class FileLock {
+ public:
+  explicit FileLock(const std::string& path);
+  ~FileLock();
+  FileLock(const FileLock&) = delete;
+  FileLock& operator=(const FileLock&) = delete;
+
+ private:
+  int fd_ = -1;
+};
+
+/*!
+ * \brief Read the complete lines of a json file after the given offset.
+ * \param path The path to the json file.
+ * \param offset The offset to start reading from, advanced past the lines read.
+ * \return The lines read.
+ */
+std::vector<std::string> JSONFileReadNewLines(const String& path, int64_t* offset);
+
 /*!
  * \brief Converts a structural hash code to string
  * \param hash_code The hash code
@@ -466,6 +490,41 @@ struct SortTuningRecordByMeanRunSecs {
   }
 };
 
+/*!
+ * \brief The form of a workload with its integer constants abstracted out, which is shared by the
+ *  same computation on different shapes.
+ */
+struct WorkloadShapeKey {
+  /*! \brief The TVMScript of the workload with each integer constant replaced by `?`. */
+  std::string text;
+  /*! \brief The integer constants of the workload, in the order of the script. */
+  std::vector<int64_t> constants;
+
+  /*!
+   * \brief Get the shape key of a workload.
+   * \param mod The IRModule of the workload.
+   * \return The shape key.
+   */
+  static WorkloadShapeKey FromModule(const IRModule& mod);
+  /*!
+   * \brief The distance between the constants of two workloads with the same text, as the sum of
+   *  the differences of their constants in log scale.
+   * \param other The shape key of the other workload.
+   * \return The distance.
+   */
+  double Distance(const WorkloadShapeKey& other) const;
+};
+
+/*!
+ * \brief Interleave the records of the nearest workloads: the best record of every workload comes
+ *  first, ordered by the distance of the workloads, then the second best ones, and so on.
+ * \param groups The distance of each workload and its records, sorted by running time.
+ * \param top_k The number of records to be returned.
+ * \return The interleaved records.
+ */
+Array<TuningRecord> InterleaveNearestRecords(
+    std::vector<std::pair<double, std::vector<TuningRecord>>> groups, int top_k);
+
 /*!
  * \brief The helper function to clone schedule rules, postprocessors, and mutators.
  * \param src The source space generator.
@@ -33,6 +33,7 @@
 #include <tvm/runtime/registry.h>
 
 #include <cctype>
+#include <cstring>
 #include <map>
 #include <string>
 
@@ -468,6 +469,47 @@ class JSONAttrSetter : public AttrVisitor {
   }
 };
 
+/*!
+ * \brief Sort the nodes so that every node comes after the nodes it refers to.
+ * \param nodes The nodes, each with the `data` and `fields` it refers to.
+ * \return The indices of the nodes in the sorted order.
+ */
+template <typename TNode>
+std::vector<size_t> TopoSortNodes(const std::vector<TNode>& nodes) {
+  size_t n_nodes = nodes.size();
+  std::vector<size_t> topo_order;
+  std::vector<size_t> in_degree(n_nodes, 0);
+  for (const TNode& jnode : nodes) {
+    for (size_t i : jnode.data) {
+      ++in_degree[i];
+    }
+    for (size_t i : jnode.fields) {
+      ++in_degree[i];
+    }
+  }
+  for (size_t i = 0; i < n_nodes; ++i) {
+    if (in_degree[i] == 0) {
+      topo_order.push_back(i);
+    }
+  }
+  for (size_t p = 0; p < topo_order.size(); ++p) {
+    const TNode& jnode = nodes[topo_order[p]];
+    for (size_t i : jnode.data) {
+      if (--in_degree[i] == 0) {
+        topo_order.push_back(i);
+      }
+    }
+    for (size_t i : jnode.fields) {
+      if (--in_degree[i] == 0) {
+        topo_order.push_back(i);
+      }
+    }
+  }
+  ICHECK_EQ(topo_order.size(), n_nodes) << "Cyclic reference detected in the serialized graph";
+  std::reverse(std::begin(topo_order), std::end(topo_order));
+  return topo_order;
+}
+
 // json graph structure to store node
 struct JSONGraph {
   // the root of the graph
@@ -527,40 +569,7 @@ struct JSONGraph {
     return g;
   }
 
-  std::vector<size_t> TopoSort() const {
-    size_t n_nodes = nodes.size();
-    std::vector<size_t> topo_order;
-    std::vector<size_t> in_degree(n_nodes, 0);
-    for (const JSONNode& jnode : nodes) {
-      for (size_t i : jnode.data) {
-        ++in_degree[i];
-      }
-      for (size_t i : jnode.fields) {
-        ++in_degree[i];
-      }
-    }
-    for (size_t i = 0; i < n_nodes; ++i) {
-      if (in_degree[i] == 0) {
-        topo_order.push_back(i);
-      }
-    }
-    for (size_t p = 0; p < topo_order.size(); ++p) {
-      const JSONNode& jnode = nodes[topo_order[p]];
-      for (size_t i : jnode.data) {
-        if (--in_degree[i] == 0) {
-          topo_order.push_back(i);
-        }
-      }
-      for (size_t i : jnode.fields) {
-        if (--in_degree[i] == 0) {
-          topo_order.push_back(i);
-        }
-      }
-    }
-    ICHECK_EQ(topo_order.size(), n_nodes) << "Cyclic reference detected in JSON file";
-    std::reverse(std::begin(topo_order), std::end(topo_order));
-    return topo_order;
-  }
+  std::vector<size_t> TopoSort() const { return TopoSortNodes(nodes); }
 };
 
 std::string SaveJSON(const ObjectRef& n) {
@@ -622,7 +631,605 @@ ObjectRef LoadJSON(std::string json_str) {
   return ObjectRef(nodes.at(jgraph.root));
 }
 
+/*!
+ * \brief The binary format of the serialized graph.
+ *
+ *  The header is the magic number followed by the byte offset of the tensor data region, both as
+ *  little endian uint64. The metadata follows, in unsigned LEB128 varints:
+ *  the global attributes, the string table, the nodes, the root index, and the tensor table.
+ *  All the strings, such as the type keys, the field names and the string values, are only
+ *  stored once in the string table and referred to by their index. The raw tensor payloads are
+ *  stored out of line in the data region, each aligned to kBinaryTensorAlignment bytes, so that
+ *  they can be mapped from a file without being parsed.
+ */
+constexpr uint64_t kTVMBinaryIRMagic = 0x52494E49424D5654;  // "TVMBINIR" in little endian
+constexpr size_t kBinaryTensorAlignment = 64;
+
+/*! \brief The kind of a node in the binary format. */
+enum class BinaryNodeKind : uint8_t {
+  kNull = 0,
+  kObject = 1,
+  kReprBytes = 2,
+  kArray = 3,
+  kStrMap = 4,
+  kMap = 5,
+};
+
+/*! \brief The kind of attribute in the binary format. */
+enum class BinaryAttrKind : uint8_t {
+  kInt = 0,
+  kUInt = 1,
+  kDouble = 2,
+  kString = 3,
+  kDataType = 4,
+  kNDArray = 5,
+  kObjectRef = 6,
+};
+
+/*! \brief The writer of the binary format, appending to a byte buffer. */
+class BinaryWriter {
+ public:
+  explicit BinaryWriter(std::string* buf) : buf_(buf) {}
+
+  void WriteVarint(uint64_t value) {
+    while (value >= 0x80) {
+      buf_->push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    buf_->push_back(static_cast<char>(value));
+  }
+  void WriteSignedVarint(int64_t value) {
+    // zigzag encoding, so that small negative values stay short.
+    WriteVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+  }
+  void WriteFixed64(uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+      buf_->push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+    }
+  }
+  void WriteByte(uint8_t value) { buf_->push_back(static_cast<char>(value)); }
+  void WriteBytes(const std::string& value) {
+    WriteVarint(value.size());
+    buf_->append(value);
+  }
+
+ private:
+  std::string* buf_;
+};
+
+/*! \brief The reader of the binary format, with bound checks. */
+class BinaryReader {
+ public:
+  BinaryReader(const char* begin, const char* end) : ptr_(begin), end_(end) {}
+
+  uint64_t ReadVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      uint8_t byte = ReadByte();
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) return value;
+    }
+    LOG(FATAL) << "BinaryReader: malformed varint";
+    return 0;
+  }
+  int64_t ReadSignedVarint() {
+    uint64_t value = ReadVarint();
+    return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+  }
+  uint64_t ReadFixed64() {
+    ICHECK_LE(8, end_ - ptr_) << "BinaryReader: unexpected end of data";
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+      value |= static_cast<uint64_t>(static_cast<uint8_t>(ptr_[i])) << (i * 8);
+    }
+    ptr_ += 8;
+    return value;
+  }
+  uint8_t ReadByte() {
+    ICHECK(ptr_ < end_) << "BinaryReader: unexpected end of data";
+    return static_cast<uint8_t>(*ptr_++);
+  }
+  std::string ReadBytes() {
+    uint64_t size = ReadVarint();
+    ICHECK_LE(size, static_cast<uint64_t>(end_ - ptr_)) << "BinaryReader: unexpected end of data";
+    std::string value(ptr_, size);
+    ptr_ += size;
+    return value;
+  }
+
+ private:
+  const char* ptr_;
+  const char* end_;
+};
+
+/*! \brief Helper class to write the nodes in the binary format using the existing index. */
+class BinaryAttrGetter : public AttrVisitor {
+ public:
+  const std::unordered_map<Object*, size_t>* node_index_;
+  const std::unordered_map<DLTensor*, size_t>* tensor_index_;
+  ReflectionVTable* reflection_ = ReflectionVTable::Global();
+
+  /*! \brief The string table. */
+  std::vector<std::string> strings_;
+  /*! \brief The serialized nodes. */
+  std::string buf_;
+
+  void Visit(const char* key, double* value) final {
+    uint64_t bits;
+    static_assert(sizeof(bits) == sizeof(*value), "double is expected to be 64 bits");
+    std::memcpy(&bits, value, sizeof(bits));
+    WriteAttr(key, BinaryAttrKind::kDouble);
+    writer_.WriteFixed64(bits);
+  }
+  void Visit(const char* key, int64_t* value) final {
+    WriteAttr(key, BinaryAttrKind::kInt);
+    writer_.WriteSignedVarint(*value);
+  }
+  void Visit(const char* key, uint64_t* value) final {
+    WriteAttr(key, BinaryAttrKind::kUInt);
+    writer_.WriteVarint(*value);
+  }
+  void Visit(const char* key, int* value) final {
+    WriteAttr(key, BinaryAttrKind::kInt);
+    writer_.WriteSignedVarint(*value);
+  }
+  void Visit(const char* key, bool* value) final {
+    WriteAttr(key, BinaryAttrKind::kUInt);
+    writer_.WriteVarint(*value);
+  }
+  void Visit(const char* key, std::string* value) final {
+    WriteAttr(key, BinaryAttrKind::kString);
+    writer_.WriteVarint(Intern(*value));
+  }
+  void Visit(const char* key, void** value) final {
+    LOG(FATAL) << "not allowed to serialize a pointer";
+  }
+  void Visit(const char* key, DataType* value) final {
+    WriteAttr(key, BinaryAttrKind::kDataType);
+    writer_.WriteVarint(value->code());
+    writer_.WriteVarint(value->bits());
+    writer_.WriteVarint(value->lanes());
+  }
+  void Visit(const char* key, runtime::NDArray* value) final {
+    WriteAttr(key, BinaryAttrKind::kNDArray);
+    writer_.WriteVarint(tensor_index_->at(const_cast<DLTensor*>((*value).operator->())));
+  }
+  void Visit(const char* key, ObjectRef* value) final {
+    WriteAttr(key, BinaryAttrKind::kObjectRef);
+    writer_.WriteVarint(node_index_->at(const_cast<Object*>(value->get())));
+  }
+
+  // Write the node
+  void Write(Object* node) {
+    if (node == nullptr) {
+      writer_.WriteByte(static_cast<uint8_t>(BinaryNodeKind::kNull));
+      return;
+    }
+    std::string repr_bytes;
+    if (reflection_->GetReprBytes(node, &repr_bytes)) {
+      writer_.WriteByte(static_cast<uint8_t>(BinaryNodeKind::kReprBytes));
+      writer_.WriteVarint(Intern(node->GetTypeKey()));
+      writer_.WriteVarint(Intern(repr_bytes));
+    } else if (node->IsInstance<ArrayNode>()) {
+      ArrayNode* n = static_cast<ArrayNode*>(node);
+      writer_.WriteByte(static_cast<uint8_t>(BinaryNodeKind::kArray));
+      writer_.WriteVarint(n->size());
+      for (const ObjectRef& elem : *n) {
+        writer_.WriteVarint(node_index_->at(const_cast<Object*>(elem.get())));
+      }
+    } else if (node->IsInstance<MapNode>()) {
+      MapNode* n = static_cast<MapNode*>(node);
+      bool is_str_map = std::all_of(n->begin(), n->end(), [](const auto& v) {
+        return v.first->template IsInstance<StringObj>();
+      });
+      writer_.WriteByte(
+          static_cast<uint8_t>(is_str_map ? BinaryNodeKind::kStrMap : BinaryNodeKind::kMap));
+      writer_.WriteVarint(n->size());
+      for (const auto& kv : *n) {
+        if (is_str_map) {
+          writer_.WriteVarint(Intern(Downcast<String>(kv.first)));
+        } else {
+          writer_.WriteVarint(node_index_->at(const_cast<Object*>(kv.first.get())));
+        }
+        writer_.WriteVarint(node_index_->at(const_cast<Object*>(kv.second.get())));
+      }
+    } else {
+      writer_.WriteByte(static_cast<uint8_t>(BinaryNodeKind::kObject));
+      writer_.WriteVarint(Intern(node->GetTypeKey()));
+      // The number of attributes is only known after visiting them.
+      std::string attrs;
+      std::swap(attrs, buf_);
+      num_attrs_ = 0;
+      reflection_->VisitAttrs(node, this);
+      std::swap(attrs, buf_);
+      writer_.WriteVarint(num_attrs_);
+      buf_.append(attrs);
+    }
+  }
+
+  uint64_t Intern(const std::string& str) {
+    auto it = string_index_.find(str);
+    if (it != string_index_.end()) return it->second;
+    string_index_.emplace(str, strings_.size());
+    strings_.push_back(str);
+    return strings_.size() - 1;
+  }
+
+ private:
+  void WriteAttr(const char* key, BinaryAttrKind kind) {
+    ++num_attrs_;
+    writer_.WriteVarint(Intern(key));
+    writer_.WriteByte(static_cast<uint8_t>(kind));
+  }
+
+  BinaryWriter writer_{&buf_};
+  std::unordered_map<std::string, uint64_t> string_index_;
+  uint64_t num_attrs_ = 0;
+};
+
+/*! \brief An attribute loaded from the binary format. */
+struct BinaryAttr {
+  /*! \brief The index of the field name in the string table. */
+  uint64_t key;
+  BinaryAttrKind kind;
+  /*! \brief The value: the integer, the bits of the double or the index it refers to. */
+  uint64_t value;
+  /*! \brief The value of a DataType attribute. */
+  DLDataType dtype;
+};
+
+/*! \brief A node loaded from the binary format. */
+struct BinaryNode {
+  BinaryNodeKind kind;
+  /*! \brief The index of the type key in the string table. */
+  uint64_t type_key;
+  /*! \brief The index of the str repr in the string table. */
+  uint64_t repr_bytes;
+  /*! \brief The string table indices of the keys of a map. */
+  std::vector<uint64_t> keys;
+  /*! \brief values of a map or array. */
+  std::vector<size_t> data;
+  /*! \brief field member dependency. */
+  std::vector<size_t> fields;
+  /*! \brief the attributes, in the order they were visited when saving. */
+  std::vector<BinaryAttr> attrs;
+};
+
+// Helper class to set the attributes of a node
+// from the given binary node.
+class BinaryAttrSetter : public AttrVisitor {
+ public:
+  const std::vector<std::string>* strings_;
+  const std::vector<ObjectPtr<Object>>* node_list_;
+  const std::vector<runtime::NDArray>* tensor_list_;
+  const BinaryNode* bnode_;
+  ReflectionVTable* reflection_ = ReflectionVTable::Global();
+
+  void Visit(const char* key, double* value) final {
+    uint64_t bits = GetAttr(key, BinaryAttrKind::kDouble).value;
+    std::memcpy(value, &bits, sizeof(bits));
+  }
+  void Visit(const char* key, int64_t* value) final {
+    *value = static_cast<int64_t>(GetAttr(key, BinaryAttrKind::kInt).value);
+  }
+  void Visit(const char* key, uint64_t* value) final {
+    *value = GetAttr(key, BinaryAttrKind::kUInt).value;
+  }
+  void Visit(const char* key, int* value) final {
+    *value = static_cast<int>(GetAttr(key, BinaryAttrKind::kInt).value);
+  }
+  void Visit(const char* key, bool* value) final {
+    *value = GetAttr(key, BinaryAttrKind::kUInt).value != 0;
+  }
+  void Visit(const char* key, std::string* value) final {
+    *value = strings_->at(GetAttr(key, BinaryAttrKind::kString).value);
+  }
+  void Visit(const char* key, void** value) final {
+    LOG(FATAL) << "not allowed to deserialize a pointer";
+  }
+  void Visit(const char* key, DataType* value) final {
+    *value = DataType(GetAttr(key, BinaryAttrKind::kDataType).dtype);
+  }
+  void Visit(const char* key, runtime::NDArray* value) final {
+    *value = tensor_list_->at(GetAttr(key, BinaryAttrKind::kNDArray).value);
+  }
+  void Visit(const char* key, ObjectRef* value) final {
+    *value = ObjectRef(node_list_->at(GetAttr(key, BinaryAttrKind::kObjectRef).value));
+  }
+
+  // set node from the binary node
+  void Set(ObjectPtr<Object>* node, const BinaryNode* bnode) {
+    switch (bnode->kind) {
+      case BinaryNodeKind::kNull:
+      case BinaryNodeKind::kReprBytes:
+        return;
+      case BinaryNodeKind::kArray: {
+        std::vector<ObjectRef> container;
+        container.reserve(bnode->data.size());
+        for (size_t index : bnode->data) {
+          container.push_back(ObjectRef(node_list_->at(index)));
+        }
+        Array<ObjectRef> array(container);
+        *node = runtime::ObjectInternal::MoveObjectPtr(&array);
+        return;
+      }
+      case BinaryNodeKind::kStrMap:
+      case BinaryNodeKind::kMap: {
+        std::unordered_map<ObjectRef, ObjectRef, ObjectHash, ObjectEqual> container;
+        for (size_t i = 0; i < bnode->data.size(); ++i) {
+          ObjectRef value(node_list_->at(bnode->data[i]));
+          if (bnode->kind == BinaryNodeKind::kStrMap) {
+            container[String(strings_->at(bnode->keys[i]))] = value;
+          } else {
+            container[ObjectRef(node_list_->at(bnode->keys[i]))] = value;
+          }
+        }
+        Map<ObjectRef, ObjectRef> map(container);
+        *node = runtime::ObjectInternal::MoveObjectPtr(&map);
+        return;
+      }
+      case BinaryNodeKind::kObject:
+        bnode_ = bnode;
+        next_attr_ = 0;
+        reflection_->VisitAttrs(node->get(), this);
+        return;
+    }
+  }
+
+ private:
+  const BinaryAttr& GetAttr(const char* key, BinaryAttrKind kind) {
+    const std::vector<BinaryAttr>& attrs = bnode_->attrs;
+    // The attributes are visited in the order they were saved, unless the node layout changed.
+    size_t i = next_attr_;
+    if (i >= attrs.size() || strings_->at(attrs[i].key) != key) {
+      for (i = 0; i < attrs.size(); ++i) {
+        if (strings_->at(attrs[i].key) == key) break;
+      }
+      if (i == attrs.size()) {
+        LOG(FATAL) << "BinaryReader: cannot find field " << key;
+      }
+    }
+    next_attr_ = i + 1;
+    if (attrs[i].kind != kind) {
+      LOG(FATAL) << "Wrong value format for field " << key;
+    }
+    return attrs[i];
+  }
+
+  size_t next_attr_ = 0;
+};
+
+std::string SaveBinary(const ObjectRef& n) {
+  NodeIndexer indexer;
+  indexer.MakeIndex(const_cast<Object*>(n.get()));
+  BinaryAttrGetter getter;
+  getter.node_index_ = &indexer.node_index_;
+  getter.tensor_index_ = &indexer.tensor_index_;
+  for (Object* node : indexer.node_list_) {
+    getter.Write(node);
+  }
+
+  std::string meta;
+  BinaryWriter writer(&meta);
+  // global attributes
+  writer.WriteVarint(1);
+  writer.WriteBytes("tvm_version");
+  writer.WriteBytes(TVM_VERSION);
+  // string table
+  writer.WriteVarint(getter.strings_.size());
+  for (const std::string& str : getter.strings_) {
+    writer.WriteBytes(str);
+  }
+  // nodes
+  writer.WriteVarint(indexer.node_list_.size());
+  meta.append(getter.buf_);
+  writer.WriteVarint(indexer.node_index_.at(const_cast<Object*>(n.get())));
+  // tensor table, the offsets are relative to the data region.
+  std::vector<uint64_t> offsets;
+  uint64_t data_size = 0;
+  writer.WriteVarint(indexer.tensor_list_.size());
+  for (DLTensor* tensor : indexer.tensor_list_) {
+    writer.WriteVarint(tensor->dtype.code);
+    writer.WriteVarint(tensor->dtype.bits);
+    writer.WriteVarint(tensor->dtype.lanes);
+    writer.WriteVarint(tensor->ndim);
+    for (int i = 0; i < tensor->ndim; ++i) {
+      writer.WriteSignedVarint(tensor->shape[i]);
+    }
+    uint64_t nbytes = runtime::GetDataSize(*tensor);
+    data_size = (data_size + kBinaryTensorAlignment - 1) / kBinaryTensorAlignment *
+                kBinaryTensorAlignment;
+    offsets.push_back(data_size);
+    writer.WriteVarint(data_size);
+    writer.WriteVarint(nbytes);
+    data_size += nbytes;
+  }
+
+  std::string blob;
+  BinaryWriter header(&blob);
+  uint64_t data_begin = 2 * sizeof(uint64_t) + meta.size();
+  data_begin = (data_begin + kBinaryTensorAlignment - 1) / kBinaryTensorAlignment *
+               kBinaryTensorAlignment;
+  header.WriteFixed64(kTVMBinaryIRMagic);
+  header.WriteFixed64(data_begin);
+  blob.append(meta);
+  blob.resize(data_begin + data_size, '\0');
+  // Always save the data of CPU tensors in little endian, as SaveDLTensor does.
+  for (size_t i = 0; i < indexer.tensor_list_.size(); ++i) {
+    DLTensor* tensor = indexer.tensor_list_[i];
+    size_t nbytes = runtime::GetDataSize(*tensor);
+    if (nbytes == 0) continue;
+    char* dst = &blob[data_begin + offsets[i]];
+    ICHECK_EQ(TVMArrayCopyToBytes(tensor, dst, nbytes), 0) << TVMGetLastError();
+    if (!DMLC_IO_NO_ENDIAN_SWAP) {
+      dmlc::ByteSwap(dst, (tensor->dtype.bits + 7) / 8, nbytes / ((tensor->dtype.bits + 7) / 8));
+    }
+  }
+  return blob;
+}
+
+ObjectRef LoadBinary(const std::string& blob) {
+  ReflectionVTable* reflection = ReflectionVTable::Global();
+  const char* begin = blob.data();
+  const char* end = begin + blob.size();
+  BinaryReader header(begin, end);
+  ICHECK_EQ(header.ReadFixed64(), kTVMBinaryIRMagic) << "Invalid binary IR format";
+  uint64_t data_begin = header.ReadFixed64();
+  ICHECK_LE(data_begin, blob.size()) << "Invalid binary IR format";
+  BinaryReader reader(begin + 2 * sizeof(uint64_t), begin + data_begin);
+
+  // global attributes, currently unused.
+  for (uint64_t i = 0, n = reader.ReadVarint(); i < n; ++i) {
+    reader.ReadBytes();
+    reader.ReadBytes();
+  }
+  std::vector<std::string> strings(reader.ReadVarint());
+  for (std::string& str : strings) {
+    str = reader.ReadBytes();
+  }
+  size_t n_nodes = reader.ReadVarint();
+  auto check_node = [n_nodes](uint64_t index) {
+    ICHECK_LT(index, n_nodes) << "Invalid binary IR format";
+    return static_cast<size_t>(index);
+  };
+  auto check_string = [&strings](uint64_t index) {
+    ICHECK_LT(index, strings.size()) << "Invalid binary IR format";
+    return index;
+  };
+  std::vector<BinaryNode> bnodes(n_nodes);
+  for (BinaryNode& bnode : bnodes) {
+    bnode.kind = static_cast<BinaryNodeKind>(reader.ReadByte());
+    switch (bnode.kind) {
+      case BinaryNodeKind::kNull:
+        break;
+      case BinaryNodeKind::kReprBytes:
+        bnode.type_key = check_string(reader.ReadVarint());
+        bnode.repr_bytes = check_string(reader.ReadVarint());
+        break;
+      case BinaryNodeKind::kArray:
+        bnode.data.resize(reader.ReadVarint());
+        for (size_t& index : bnode.data) {
+          index = check_node(reader.ReadVarint());
+        }
+        break;
+      case BinaryNodeKind::kStrMap:
+      case BinaryNodeKind::kMap: {
+        size_t size = reader.ReadVarint();
+        for (size_t i = 0; i < size; ++i) {
+          uint64_t key = reader.ReadVarint();
+          if (bnode.kind == BinaryNodeKind::kStrMap) {
+            bnode.keys.push_back(check_string(key));
+          } else {
+            // The keys of a non-string map are nodes it depends on as well.
+            bnode.keys.push_back(check_node(key));
+            bnode.fields.push_back(bnode.keys.back());
+          }
+          bnode.data.push_back(check_node(reader.ReadVarint()));
+        }
+        break;
+      }
+      case BinaryNodeKind::kObject: {
+        bnode.type_key = check_string(reader.ReadVarint());
+        bnode.attrs.resize(reader.ReadVarint());
+        for (BinaryAttr& attr : bnode.attrs) {
+          attr.key = check_string(reader.ReadVarint());
+          attr.kind = static_cast<BinaryAttrKind>(reader.ReadByte());
+          switch (attr.kind) {
+            case BinaryAttrKind::kInt:
+              attr.value = static_cast<uint64_t>(reader.ReadSignedVarint());
+              break;
+            case BinaryAttrKind::kDouble:
+              attr.value = reader.ReadFixed64();
+              break;
+            case BinaryAttrKind::kString:
+              attr.value = check_string(reader.ReadVarint());
+              break;
+            case BinaryAttrKind::kDataType:
+              attr.dtype.code = static_cast<uint8_t>(reader.ReadVarint());
+              attr.dtype.bits = static_cast<uint8_t>(reader.ReadVarint());
+              attr.dtype.lanes = static_cast<uint16_t>(reader.ReadVarint());
+              break;
+            case BinaryAttrKind::kObjectRef:
+              attr.value = check_node(reader.ReadVarint());
+              bnode.fields.push_back(attr.value);
+              break;
+            case BinaryAttrKind::kUInt:
+            case BinaryAttrKind::kNDArray:
+              attr.value = reader.ReadVarint();
+              break;
+            default:
+              LOG(FATAL) << "Invalid binary IR format: unknown attribute kind "
+                         << static_cast<int>(attr.kind);
+          }
+        }
+        break;
+      }
+      default:
+        LOG(FATAL) << "Invalid binary IR format: unknown node kind "
+                   << static_cast<int>(bnode.kind);
+    }
+  }
+  size_t root = check_node(reader.ReadVarint());
+
+  std::vector<runtime::NDArray> tensors(reader.ReadVarint());
+  for (runtime::NDArray& tensor : tensors) {
+    DLDataType dtype;
+    dtype.code = static_cast<uint8_t>(reader.ReadVarint());
+    dtype.bits = static_cast<uint8_t>(reader.ReadVarint());
+    dtype.lanes = static_cast<uint16_t>(reader.ReadVarint());
+    std::vector<int64_t> shape(reader.ReadVarint());
+    for (int64_t& extent : shape) {
+      extent = reader.ReadSignedVarint();
+    }
+    uint64_t offset = reader.ReadVarint();
+    uint64_t nbytes = reader.ReadVarint();
+    ICHECK_LE(offset + nbytes, blob.size() - data_begin) << "Invalid binary IR format";
+    tensor = runtime::NDArray::Empty(ShapeTuple(shape), dtype, {kDLCPU, 0});
+    ICHECK_EQ(runtime::GetDataSize(*tensor.operator->()), nbytes) << "Invalid binary IR format";
+    if (nbytes == 0) continue;
+    std::memcpy(tensor->data, begin + data_begin + offset, nbytes);
+    if (!DMLC_IO_NO_ENDIAN_SWAP) {
+      dmlc::ByteSwap(tensor->data, (dtype.bits + 7) / 8, nbytes / ((dtype.bits + 7) / 8));
+    }
+  }
+
+  // Pass 1: create all non-container objects
+  std::vector<ObjectPtr<Object>> nodes(n_nodes, nullptr);
+  for (size_t i = 0; i < n_nodes; ++i) {
+    const BinaryNode& bnode = bnodes[i];
+    if (bnode.kind == BinaryNodeKind::kReprBytes) {
+      nodes[i] = reflection->CreateInitObject(strings[bnode.type_key], strings[bnode.repr_bytes]);
+    } else if (bnode.kind == BinaryNodeKind::kObject) {
+      nodes[i] = reflection->CreateInitObject(strings[bnode.type_key]);
+    }
+  }
+  // Pass 2: topo sort, the field dependency is recorded when loading the nodes.
+  std::vector<size_t> topo_order = TopoSortNodes(bnodes);
+  // Pass 3: set all values
+  BinaryAttrSetter setter;
+  setter.strings_ = &strings;
+  setter.node_list_ = &nodes;
+  setter.tensor_list_ = &tensors;
+  for (size_t i : topo_order) {
+    setter.Set(&nodes[i], &bnodes[i]);
+  }
+  return ObjectRef(nodes.at(root));
+}
+
 TVM_REGISTER_GLOBAL("node.SaveJSON").set_body_typed(SaveJSON);
 
 TVM_REGISTER_GLOBAL("node.LoadJSON").set_body_typed(LoadJSON);
+
+TVM_REGISTER_GLOBAL("node.SaveBinary").set_body([](TVMArgs args, TVMRetValue* rv) {
+  ObjectRef node = args[0];
+  std::string blob = SaveBinary(node);
+  TVMByteArray arr;
+  arr.data = blob.data();
+  arr.size = blob.size();
+  *rv = arr;
+});
+
+TVM_REGISTER_GLOBAL("node.LoadBinary").set_body_typed([](std::string blob) {
+  return LoadBinary(blob);
+});
 }  // namespace tvm
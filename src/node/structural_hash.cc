@@ -30,7 +30,9 @@
 #include <tvm/runtime/registry.h>
 
 #include <algorithm>
+#include <mutex>
 #include <unordered_map>
+#include <utility>
 
 #include "../support/base64.h"
 #include "../support/str_escape.h"
@@ -296,6 +298,43 @@ size_t StructuralHash::operator()(const ObjectRef& object) const {
   return SHashHandlerDefault().Hash(object, false);
 }
 
+/*! \brief The cache of a CachedStructuralHash and its copies. */
+class CachedStructuralHash::Cache {
+ public:
+  bool Lookup(const Object* key, size_t* hashed_value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return false;
+    *hashed_value = it->second.second;
+    return true;
+  }
+
+  void Insert(const ObjectRef& key, size_t hashed_value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.emplace(key.get(), std::make_pair(key, hashed_value));
+  }
+
+ private:
+  std::mutex mutex_;
+  /*! \brief The hash of each node, along with a reference keeping its address from reuse. */
+  std::unordered_map<const Object*, std::pair<ObjectRef, size_t>> entries_;
+};
+
+CachedStructuralHash::CachedStructuralHash() : cache_(std::make_shared<Cache>()) {}
+
+size_t CachedStructuralHash::operator()(const ObjectRef& key) const {
+  if (!key.defined()) return StructuralHash::operator()(key);
+  size_t hashed_value;
+  if (Lookup(key, &hashed_value)) return hashed_value;
+  hashed_value = StructuralHash::operator()(key);
+  cache_->Insert(key, hashed_value);
+  return hashed_value;
+}
+
+bool CachedStructuralHash::Lookup(const ObjectRef& key, size_t* hashed_value) const {
+  return key.defined() && cache_->Lookup(key.get(), hashed_value);
+}
+
 // SEQualReduce traits for runtime containers.
 struct StringObjTrait {
   static constexpr const std::nullptr_t VisitAttrs = nullptr;
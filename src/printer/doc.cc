@@ -27,6 +27,8 @@
 
 #include <tvm/runtime/packed_func.h>
 
+#include <algorithm>
+#include <iterator>
 #include <sstream>
 #include <vector>
 
@@ -96,16 +98,21 @@ Doc& Doc::operator<<(const DocAtom& right) {
 
 std::string Doc::str() {
   std::ostringstream os;
-  for (auto atom : this->stream_) {
+  Print(os);
+  return os.str();
+}
+
+void Doc::Print(std::ostream& os, int indent) const {
+  for (const DocAtom& atom : this->stream_) {
     if (auto* text = atom.as<DocTextNode>()) {
       os << text->str;
     } else if (auto* line = atom.as<DocLineNode>()) {
-      os << "\n" << std::string(line->indent, ' ');
+      os << '\n';
+      std::fill_n(std::ostreambuf_iterator<char>(os), indent + line->indent, ' ');
     } else {
       LOG(FATAL) << "do not expect type " << atom->GetTypeKey();
     }
   }
-  return os.str();
 }
 
 Doc Doc::NewLine(int indent) { return Doc() << DocLine(indent); }
@@ -30,6 +30,7 @@
 #include <tvm/runtime/data_type.h>
 #include <tvm/runtime/object.h>
 
+#include <ostream>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -105,6 +106,12 @@ class Doc {
    * \return The string representation.
    */
   std::string str();
+  /*!
+   * \brief Write the doc stream to the output stream, without building the string first.
+   * \param os The output stream.
+   * \param indent The amount of indent added to every new line.
+   */
+  void Print(std::ostream& os, int indent = 0) const;
   /*!
    * \brief Create a doc that represents text content.
    * \return The created doc.
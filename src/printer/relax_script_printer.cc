@@ -25,8 +25,11 @@
 #include <tvm/ir/type_functor.h>
 #include <tvm/relax/ir_functor.h>
 #include <tvm/relax/utils.h>
+#include <tvm/support/parallel_for.h>
 
 #include <algorithm>
+#include <sstream>
+#include <thread>
 #include <utility>
 
 #include "doc.h"
@@ -510,6 +513,53 @@ Doc RelaxScriptPrinter::PrintIRModule(const IRModule& mod) {
   return doc;
 }
 
+void RelaxScriptPrinter::PrintIRModule(const IRModule& mod, std::ostream& os, int num_threads) {
+  std::vector<std::pair<GlobalVar, BaseFunc>> funcs(mod->functions.begin(), mod->functions.end());
+  // The PrimFuncs do not depend on the state of this printer, so they can be printed in parallel.
+  std::vector<int> prim_funcs;
+  for (size_t i = 0; i < funcs.size(); ++i) {
+    if (funcs[i].second->IsInstance<tir::PrimFuncNode>()) {
+      prim_funcs.push_back(i);
+    }
+  }
+  std::vector<Doc> docs(funcs.size());
+  auto f_print = [&](int thread_id, int task_id) {
+    const std::pair<GlobalVar, BaseFunc>& pr = funcs[prim_funcs[task_id]];
+    docs[prim_funcs[task_id]] =
+        PrintPrimFunc(pr.first->name_hint, Downcast<tir::PrimFunc>(pr.second));
+  };
+  if (num_threads <= 0) {
+    num_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  }
+  num_threads = std::min(num_threads, static_cast<int>(prim_funcs.size()));
+  if (num_threads > 1) {
+    support::parallel_for_dynamic(0, prim_funcs.size(), num_threads, f_print);
+  } else {
+    for (size_t i = 0; i < prim_funcs.size(); ++i) {
+      f_print(0, i);
+    }
+  }
+
+  Doc header;
+  if (ShowMetaData()) {
+    header << "@tvm.script.ir_module(metadata=metadata)" << Doc::NewLine();
+  } else {
+    header << "@tvm.script.ir_module" << Doc::NewLine();
+  }
+  header << "class Module:";
+  header.Print(os);
+  for (size_t i = 0; i < funcs.size(); ++i) {
+    Doc func = Doc::NewLine();
+    if (funcs[i].second->IsInstance<tir::PrimFuncNode>()) {
+      func << docs[i];
+      docs[i] = Doc();
+    } else {
+      func << Print(funcs[i].second);
+    }
+    func.Print(os, 4);
+  }
+}
+
 Doc RelaxScriptPrinter::PrintPrimFunc(const String& name, const tir::PrimFunc& func) {
   // we need the mod for TVMScriptPrinter to properly print the function name - maybe it's worth
   // refactoring to avoid this?
@@ -653,13 +703,13 @@ Doc RelaxScriptPrinter::GetUniqueName(std::string prefix, std::string fallback =
 
 bool RelaxScriptPrinter::ShowMetaData() { return show_meta_data_; }
 
-String AsRelaxScript(const ObjectRef& mod, bool show_meta_data) {
+String AsRelaxScript(const ObjectRef& mod, bool show_meta_data, int num_threads) {
   ICHECK(mod->IsInstance<IRModuleNode>() || mod->IsInstance<relax::FunctionNode>() ||
          mod->IsInstance<tir::PrimFuncNode>());
-  Doc doc;
+  std::ostringstream os;
   runtime::TypedPackedFunc<std::string(ObjectRef)> ftyped = nullptr;
-  doc << TextPrinter(show_meta_data, ftyped).PrintRelax(mod);
-  return doc.str();
+  TextPrinter(show_meta_data, ftyped).PrintRelax(mod, os, num_threads);
+  return os.str();
 }
 
 TVM_REGISTER_GLOBAL("script.AsRelaxScript").set_body_typed(AsRelaxScript);
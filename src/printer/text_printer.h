@@ -38,6 +38,7 @@
 #include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/var.h>
 
+#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -247,6 +248,15 @@ class RelaxScriptPrinter : public relax::IRFunctor<Doc(const ObjectRef&)>,
   explicit RelaxScriptPrinter(bool show_meta_data, TextMetaDataContext* meta)
       : show_meta_data_(show_meta_data), meta_(meta) {}
   TVM_DLL Doc Print(const ObjectRef& node);
+  /*!
+   * \brief Print the IRModule to the output stream one function at a time, without building the
+   *  doc of the whole module.
+   * \param mod The IRModule to be printed.
+   * \param os The output stream.
+   * \param num_threads The number of threads printing the PrimFuncs, which are printed by their
+   *  own TVMScriptPrinter. Use all the cores if nonpositive.
+   */
+  void PrintIRModule(const IRModule& mod, std::ostream& os, int num_threads = 1);
   bool ShowMetaData();
 
  private:
@@ -294,7 +304,7 @@ class RelaxScriptPrinter : public relax::IRFunctor<Doc(const ObjectRef&)>,
   Doc VisitExpr_(const tir::MaxNode* op) override;
 
   Doc PrintIRModule(const IRModule& mod);
-  Doc PrintPrimFunc(const String& name, const tir::PrimFunc& func);
+  static Doc PrintPrimFunc(const String& name, const tir::PrimFunc& func);
 
   Doc PrintIfStmt(const relax::Var& var, const relay::If& ite);
   Doc PrintFunctionDef(const Doc& name, const relax::Function& func);
@@ -359,7 +369,7 @@ class RelaxScriptPrinter : public relax::IRFunctor<Doc(const ObjectRef&)>,
   };
 };
 
-String AsRelaxScript(const ObjectRef& mod, bool show_meta_data);
+String AsRelaxScript(const ObjectRef& mod, bool show_meta_data, int num_threads = 1);
 
 }  // namespace relax
 }  // namespace tvm
@@ -609,16 +619,30 @@ class TextPrinter {
     return doc;
   }
 
-  Doc PrintRelax(const ObjectRef& node) {
-    relax_text_printer_.Print(node);
-    Doc doc;
-    if (show_meta_data_ && !meta_.empty()) {
-      doc << "metadata = ";
-      doc << meta_.GetMetaSection();
-      doc << Doc::NewLine();
+  /*!
+   * \brief Print the Relax node to the output stream, after its meta data section if shown.
+   * \param node The node to be printed.
+   * \param os The output stream.
+   * \param num_threads The number of threads printing the PrimFuncs of an IRModule.
+   */
+  void PrintRelax(const ObjectRef& node, std::ostream& os, int num_threads = 1) {
+    // The meta data is only known once the node is printed, so the text is buffered when the
+    // meta data section has to be printed first.
+    std::ostringstream buffer;
+    std::ostream& body = show_meta_data_ ? buffer : os;
+    if (node->IsInstance<IRModuleNode>()) {
+      relax_text_printer_.PrintIRModule(Downcast<IRModule>(node), body, num_threads);
+    } else {
+      relax_text_printer_.Print(node).Print(body);
+    }
+    if (show_meta_data_) {
+      if (!meta_.empty()) {
+        os << "metadata = ";
+        meta_.GetMetaSection().Print(os);
+        os << '\n';
+      }
+      os << buffer.str();
     }
-    doc << relax_text_printer_.Print(node);
-    return doc;
   }
 
   Doc PrintMod(const IRModule& mod);
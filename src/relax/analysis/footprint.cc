@@ -0,0 +1,330 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/analysis/footprint.cc
+ * \brief Compile-time estimation of the memory, operations and kernel launches of a function.
+ */
+
+#include <tvm/arith/analyzer.h>
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/attrs/memory.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/op_attr_types.h>
+#include <tvm/relax/type.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+TVM_REGISTER_NODE_TYPE(FootprintNode);
+
+class FootprintEstimator {
+ public:
+  explicit FootprintEstimator(const IRModule& mod) : mod_(mod) {}
+
+  Footprint Estimate(const Function& fn) {
+    auto n = make_object<FootprintNode>();
+    result_ = n.get();
+    n->peak_bytes = FunctionPeak(fn);
+    Map<String, Integer> constant_bytes;
+    for (const auto& kv : constant_bytes_) {
+      constant_bytes.Set(kv.first, Integer(IntImm(DataType::Int(64), kv.second)));
+    }
+    n->constant_bytes = std::move(constant_bytes);
+    return Footprint(n);
+  }
+
+ private:
+  /*! \brief An allocation of a SeqExpr, live from def to last_use. */
+  struct Alloc {
+    int64_t def;
+    int64_t last_use;
+    int64_t bytes;
+  };
+
+  /*! \brief The peak bytes of a function, accumulating the counts of its calls. */
+  int64_t FunctionPeak(const Function& fn) {
+    // a recursive call does not add to the footprint of the calls in progress
+    if (!visiting_.insert(fn.get()).second) return 0;
+    PostOrderVisit(fn, [this](const ObjectRef& obj) {
+      const auto* constant = obj.as<ConstantNode>();
+      if (constant == nullptr || !seen_constants_.insert(constant->data.get()).second) return;
+      std::ostringstream os;
+      // the printer of DLDevice is not found by the lookup, it is declared in tvm::runtime
+      runtime::operator<<(os, constant->data->device);
+      constant_bytes_[os.str()] += runtime::GetDataSize(*constant->data.operator->());
+    });
+    Map<String, Integer> upper_bounds =
+        fn->GetAttr<Map<String, Integer>>(attr::kTIRVarUpperBound).value_or({});
+    int64_t peak = BodyPeak(fn->body, upper_bounds);
+    visiting_.erase(fn.get());
+    return peak;
+  }
+
+  int64_t BodyPeak(const Expr& body, const Map<String, Integer>& upper_bounds) {
+    if (const auto* seq = body.as<SeqExprNode>()) return SeqPeak(seq, upper_bounds);
+    return VisitValue(body, upper_bounds);
+  }
+
+  int64_t SeqPeak(const SeqExprNode* seq, const Map<String, Integer>& upper_bounds) {
+    std::vector<Alloc> allocs;
+    // the allocations each var may refer to
+    std::unordered_map<const VarNode*, std::vector<size_t>> roots;
+    // the peak bytes of the nested calls and bodies of each position
+    std::vector<int64_t> transient;
+    int64_t pos = 0;
+
+    auto use = [&](const Expr& expr) {
+      std::vector<size_t> used;
+      PostOrderVisit(expr, [&](const ObjectRef& obj) {
+        const auto* var = obj.as<VarNode>();
+        if (var == nullptr) return;
+        auto it = roots.find(var);
+        if (it == roots.end()) return;
+        for (size_t root : it->second) {
+          allocs[root].last_use = pos;
+          used.push_back(root);
+        }
+      });
+      return used;
+    };
+
+    for (const BindingBlock& block : seq->blocks) {
+      for (const Binding& binding : block->bindings) {
+        Var var;
+        Expr value;
+        if (const auto* var_binding = binding.as<VarBindingNode>()) {
+          var = var_binding->var;
+          value = var_binding->value;
+        } else if (const auto* match_shape = binding.as<MatchShapeNode>()) {
+          var = match_shape->var;
+          value = match_shape->value;
+        }
+        transient.push_back(VisitValue(value, upper_bounds));
+        std::vector<size_t> used = use(value);
+        Optional<PrimExpr> bytes;
+        if (AllocBytes(value, &bytes)) {
+          int64_t bound = 0;
+          if (!bytes.defined() || !UpperBound(bytes.value(), upper_bounds, &bound)) {
+            ++result_->num_unbounded_allocs;
+          }
+          if (var.defined()) roots[var.get()] = {allocs.size()};
+          allocs.push_back({pos, pos, bound});
+        } else if (var.defined() && !used.empty()) {
+          // conservatively assume the result can refer to any of the allocations used
+          roots[var.get()] = std::move(used);
+        }
+        ++pos;
+      }
+    }
+    transient.push_back(VisitValue(seq->body, upper_bounds));
+    use(seq->body);
+
+    std::vector<int64_t> live(pos + 2, 0);
+    for (const Alloc& alloc : allocs) {
+      live[alloc.def] += alloc.bytes;
+      live[alloc.last_use + 1] -= alloc.bytes;
+    }
+    int64_t peak = 0;
+    int64_t bytes = 0;
+    for (int64_t i = 0; i <= pos; ++i) {
+      bytes += live[i];
+      peak = std::max(peak, bytes + transient[i]);
+    }
+    return peak;
+  }
+
+  /*! \brief Count the calls of a value, returning the peak bytes of its nested bodies. */
+  int64_t VisitValue(const Expr& expr, const Map<String, Integer>& upper_bounds) {
+    if (const auto* if_node = expr.as<IfNode>()) {
+      return std::max(BodyPeak(if_node->true_branch, upper_bounds),
+                      BodyPeak(if_node->false_branch, upper_bounds));
+    }
+    if (const auto* seq = expr.as<SeqExprNode>()) {
+      return SeqPeak(seq, upper_bounds);
+    }
+    if (const auto* tuple = expr.as<TupleNode>()) {
+      int64_t peak = 0;
+      for (const Expr& field : tuple->fields) {
+        peak = std::max(peak, VisitValue(field, upper_bounds));
+      }
+      return peak;
+    }
+    const auto* call = expr.as<CallNode>();
+    if (call == nullptr) return 0;
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    static const Op& call_tir_dyn_op = Op::Get("relax.vm.call_tir_dyn");
+    static const auto& fcall_packed = Op::GetAttrMap<FCallPacked>("FCallPacked");
+    if (const auto* gv = call->op.as<GlobalVarNode>()) {
+      BaseFunc callee = mod_->Lookup(GetRef<GlobalVar>(gv));
+      if (const auto* prim_func = callee.as<tir::PrimFuncNode>()) {
+        CountKernel(prim_func);
+      } else if (const auto* func = callee.as<FunctionNode>()) {
+        return FunctionPeak(GetRef<Function>(func));
+      }
+    } else if (call->op.same_as(call_tir_op) || call->op.same_as(call_tir_dyn_op)) {
+      if (const auto* gv = call->args[0].as<GlobalVarNode>()) {
+        if (const auto* prim_func = mod_->Lookup(GetRef<GlobalVar>(gv)).as<tir::PrimFuncNode>()) {
+          CountKernel(prim_func);
+        }
+      } else {
+        ++result_->num_packed_calls;
+      }
+    } else if (const auto* op = call->op.as<OpNode>()) {
+      if (fcall_packed.count(GetRef<Op>(op))) ++result_->num_packed_calls;
+    } else if (call->op.as<ExternFuncNode>()) {
+      ++result_->num_packed_calls;
+    }
+    return 0;
+  }
+
+  void CountKernel(const tir::PrimFuncNode* func) {
+    ++result_->num_kernel_launches;
+    auto it = kernel_flops_.find(func);
+    if (it == kernel_flops_.end()) {
+      // the flops of the kernels with dynamic loops are unknown
+      bool is_static = true;
+      tir::PostOrderVisit(func->body, [&](const ObjectRef& obj) {
+        if (const auto* loop = obj.as<tir::ForNode>()) {
+          is_static = is_static && loop->extent->IsInstance<IntImmNode>();
+        }
+      });
+      double flops = is_static ? tir::EstimateTIRFlops(func->body) : -1;
+      it = kernel_flops_.emplace(func, flops).first;
+    }
+    if (it->second < 0) {
+      ++result_->num_unestimated_kernels;
+    } else {
+      result_->flops += it->second;
+    }
+  }
+
+  /*!
+   * \brief Check whether a value allocates, and get the bytes it allocates.
+   * \param value The value.
+   * \param bytes The bytes, left undefined if they are not computable from the shapes.
+   * \return Whether the value allocates.
+   */
+  static bool AllocBytes(const Expr& value, Optional<PrimExpr>* bytes) {
+    static const Op& vm_alloc_storage_op = Op::Get("relax.vm.builtin.alloc_storage");
+    static const Op& mem_alloc_storage_op = Op::Get("relax.memory.alloc_storage");
+    static const Op& alloc_tensor_op = Op::Get("relax.builtin.alloc_tensor");
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    const auto* call = value.as<CallNode>();
+    if (call == nullptr) return false;
+    if (call->op.same_as(vm_alloc_storage_op) || call->op.same_as(mem_alloc_storage_op)) {
+      // the size of a storage is in bytes
+      if (const auto* size = call->args[0].as<ShapeExprNode>()) {
+        *bytes = Product(size->values, DataType::UInt(8));
+      }
+      return true;
+    }
+    if (call->op.same_as(alloc_tensor_op)) {
+      const auto* shape = call->args[0].as<ShapeExprNode>();
+      const auto* attrs = call->attrs.as<AllocTensorAttrs>();
+      if (shape != nullptr && attrs != nullptr) *bytes = Product(shape->values, attrs->dtype);
+      return true;
+    }
+    if (call->op.same_as(call_tir_op)) {
+      // the outputs of the call_tirs before the lowering
+      Array<Expr> shapes;
+      Array<Type> types;
+      if (const auto* tuple = call->args[2].as<TupleNode>()) {
+        shapes = tuple->fields;
+        types = Downcast<TupleType>(call->type_args[0])->fields;
+      } else {
+        shapes = {call->args[2]};
+        types = {call->type_args[0]};
+      }
+      PrimExpr total = tir::make_const(DataType::Int(64), 0);
+      for (size_t i = 0; i < shapes.size(); ++i) {
+        const auto* shape = shapes[i].as<ShapeExprNode>();
+        const auto* type = types[i].as<DynTensorTypeNode>();
+        if (shape == nullptr || type == nullptr || type->IsUnknownDtype()) return true;
+        total = total + Product(shape->values, type->dtype);
+      }
+      *bytes = total;
+      return true;
+    }
+    return false;
+  }
+
+  static PrimExpr Product(const Array<PrimExpr>& shape, DataType dtype) {
+    PrimExpr bytes = tir::make_const(DataType::Int(64), (dtype.bits() * dtype.lanes() + 7) / 8);
+    for (const PrimExpr& dim : shape) {
+      bytes = bytes * cast(DataType::Int(64), dim);
+    }
+    return bytes;
+  }
+
+  /*! \brief Get the upper bound of bytes, returns false if unbounded. */
+  static bool UpperBound(const PrimExpr& bytes, const Map<String, Integer>& upper_bounds,
+                         int64_t* bound) {
+    arith::Analyzer analyzer;
+    bool bounded = true;
+    std::unordered_set<const tir::VarNode*> bound_vars;
+    tir::PostOrderVisit(bytes, [&](const ObjectRef& obj) {
+      const auto* var = obj.as<tir::VarNode>();
+      if (var == nullptr || !bound_vars.insert(var).second) return;
+      auto it = upper_bounds.find(var->name_hint);
+      if (it == upper_bounds.end()) {
+        bounded = false;
+        return;
+      }
+      analyzer.Bind(GetRef<tir::Var>(var),
+                    Range::FromMinExtent(IntImm(var->dtype, 0),
+                                         IntImm(var->dtype, (*it).second->value + 1)));
+    });
+    if (!bounded) return false;
+    arith::ConstIntBound const_bound = analyzer.const_int_bound(bytes);
+    if (const_bound->max_value == arith::ConstIntBound::kPosInf || const_bound->max_value < 0) {
+      return false;
+    }
+    *bound = const_bound->max_value;
+    return true;
+  }
+
+  IRModule mod_;
+  FootprintNode* result_ = nullptr;
+  std::unordered_set<const FunctionNode*> visiting_;
+  std::unordered_set<const void*> seen_constants_;
+  std::map<std::string, int64_t> constant_bytes_;
+  std::unordered_map<const tir::PrimFuncNode*, double> kernel_flops_;
+};
+
+Footprint EstimateFootprint(const IRModule& mod, const Function& fn) {
+  return FootprintEstimator(mod).Estimate(fn);
+}
+
+TVM_REGISTER_GLOBAL("relax.analysis.estimate_footprint").set_body_typed(EstimateFootprint);
+
+}  // namespace relax
+}  // namespace tvm
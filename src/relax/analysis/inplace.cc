@@ -0,0 +1,136 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/relax/analysis/inplace.cc
+ * \brief Analysis of the call_tir bindings that can write their output into an input.
+ */
+
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/expr.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/type.h>
+#include <tvm/tir/stmt_functor.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace tvm {
+namespace relax {
+
+/*!
+ * \brief Check that every element of the output buffer only reads the element of the input
+ * buffer at the same index, so that the output can be written into the input.
+ */
+bool IsInplaceSafe(const tir::PrimFunc& func, const tir::Buffer& input,
+                   const tir::Buffer& output) {
+  if (!StructuralEqual()(input->shape, output->shape) || input->dtype != output->dtype) {
+    return false;
+  }
+  int64_t num_loads = 0;
+  int64_t num_checked_loads = 0;
+  bool safe = true;
+  tir::PostOrderVisit(func->body, [&](const ObjectRef& obj) {
+    if (const auto* load = obj.as<tir::BufferLoadNode>()) {
+      if (load->buffer->data.same_as(input->data)) ++num_loads;
+    } else if (const auto* store = obj.as<tir::BufferStoreNode>()) {
+      if (store->buffer->data.same_as(input->data)) {
+        safe = false;
+        return;
+      }
+      tir::PostOrderVisit(store->value, [&](const ObjectRef& value) {
+        const auto* load = value.as<tir::BufferLoadNode>();
+        if (load == nullptr || !load->buffer->data.same_as(input->data)) return;
+        if (store->buffer->data.same_as(output->data) &&
+            StructuralEqual()(load->indices, store->indices)) {
+          ++num_checked_loads;
+        } else {
+          safe = false;
+        }
+      });
+    }
+  });
+  // the loads outside the stored values, e.g. in conditions, are not checked
+  return safe && num_loads == num_checked_loads;
+}
+
+Map<Var, Integer> CallTIRInplaceInputs(const IRModule& mod, const Function& fn) {
+  static const Op& call_tir_op = Op::Get("relax.call_tir");
+  // the vars bound to single-output call_tir, whose tensors are freshly allocated
+  std::unordered_map<const VarNode*, const CallNode*> call_tir_of;
+  PostOrderVisit(fn->body, [&](const Expr& expr) {
+    if (const auto* seq = expr.as<SeqExprNode>()) {
+      for (const BindingBlock& block : seq->blocks) {
+        for (const Binding& binding : block->bindings) {
+          const auto* var_binding = binding.as<VarBindingNode>();
+          if (var_binding == nullptr) continue;
+          const auto* call = var_binding->value.as<CallNode>();
+          if (call != nullptr && call->op == call_tir_op && call->shape_.defined() &&
+              call->shape_.value()->IsInstance<ShapeExprNode>()) {
+            call_tir_of[var_binding->var.get()] = call;
+          }
+        }
+      }
+    }
+  });
+  Map<Var, Array<Var>> users;
+  Array<Var> outputs;
+  std::tie(users, outputs) = FunctionUseDef(fn);
+
+  Map<Var, Integer> ret;
+  for (const auto& kv : call_tir_of) {
+    const CallNode* call = kv.second;
+    const auto* gvar = call->args[0].as<GlobalVarNode>();
+    const auto* args = call->args[1].as<TupleNode>();
+    if (gvar == nullptr || args == nullptr || !mod->ContainGlobalVar(gvar->name_hint)) continue;
+    const auto* func = mod->Lookup(gvar->name_hint).as<tir::PrimFuncNode>();
+    if (func == nullptr || func->params.size() <= args->fields.size()) continue;
+    const auto* out_type = call->checked_type_.as<DynTensorTypeNode>();
+    if (out_type == nullptr) continue;
+    tir::Buffer output = func->buffer_map.Get(func->params[args->fields.size()]).value();
+
+    for (size_t i = 0; i < args->fields.size(); ++i) {
+      const auto* arg = args->fields[i].as<VarNode>();
+      if (arg == nullptr || !call_tir_of.count(arg)) continue;
+      // the input must die at the call
+      Var arg_var = GetRef<Var>(arg);
+      Optional<Array<Var>> arg_users = users.Get(arg_var);
+      if (!arg_users.defined() || arg_users.value().size() != 1 ||
+          arg_users.value()[0].get() != kv.first ||
+          std::find(outputs.begin(), outputs.end(), arg_var) != outputs.end()) {
+        continue;
+      }
+      const auto* arg_type = arg->checked_type_.as<DynTensorTypeNode>();
+      if (arg_type == nullptr || arg_type->dtype != out_type->dtype || !arg->shape_.defined() ||
+          !StructuralEqual()(arg->shape_.value(), call->shape_.value())) {
+        continue;
+      }
+      Optional<tir::Buffer> input = func->buffer_map.Get(func->params[i]);
+      if (input.defined() && IsInplaceSafe(GetRef<tir::PrimFunc>(func), input.value(), output)) {
+        ret.Set(GetRef<Var>(kv.first), Integer(i));
+        break;
+      }
+    }
+  }
+  return ret;
+}
+
+TVM_REGISTER_GLOBAL("relax.analysis.call_tir_inplace_inputs").set_body_typed(CallTIRInplaceInputs);
+
+}  // namespace relax
+}  // namespace tvm
@@ -0,0 +1,99 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/analysis/liveness.cc
+ * \brief Implementation of the liveness analysis of the vars of a function.
+ */
+
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/expr_functor.h>
+
+namespace tvm {
+namespace relax {
+
+LivenessAnalysis::LivenessAnalysis(const Function& fn) {
+  auto add_var = [this](const VarNode* var, int pos) {
+    var2index_.emplace(var, static_cast<int>(vars_.size()));
+    vars_.push_back(var);
+    def_pos_.push_back(pos);
+  };
+  for (const Var& param : fn->params) {
+    add_var(param.get(), -1);
+  }
+  const auto* seq = fn->body.as<SeqExprNode>();
+  if (seq != nullptr) {
+    for (const BindingBlock& block : seq->blocks) {
+      for (const Binding& binding : block->bindings) {
+        const VarNode* var = nullptr;
+        if (const auto* var_binding = binding.as<VarBindingNode>()) {
+          var = var_binding->var.get();
+        } else if (const auto* match_shape = binding.as<MatchShapeNode>()) {
+          var = match_shape->var.get();
+        }
+        if (var != nullptr) add_var(var, static_cast<int>(bindings_.size()));
+        bindings_.push_back(binding);
+      }
+    }
+  }
+
+  last_use_.assign(vars_.size(), -1);
+  uses_.resize(vars_.size());
+  killed_at_.resize(bindings_.size() + 1);
+  auto add_uses = [this](const Expr& expr, int pos) {
+    PostOrderVisit(expr, [&](const ObjectRef& obj) {
+      const auto* var = obj.as<VarNode>();
+      if (var == nullptr) return;
+      int index = GetIndex(var);
+      // The positions are visited in increasing order, so the last one is the latest.
+      if (index < 0 || last_use_[index] == pos) return;
+      last_use_[index] = pos;
+      uses_[index].push_back(pos);
+    });
+  };
+  for (int pos = 0; pos < num_bindings(); ++pos) {
+    const Binding& binding = bindings_[pos];
+    if (const auto* var_binding = binding.as<VarBindingNode>()) {
+      add_uses(var_binding->value, pos);
+    } else if (const auto* match_shape = binding.as<MatchShapeNode>()) {
+      add_uses(match_shape->value, pos);
+    }
+  }
+  add_uses(seq != nullptr ? seq->body : fn->body, num_bindings());
+
+  for (int index = 0; index < num_vars(); ++index) {
+    if (last_use_[index] >= 0) killed_at_[last_use_[index]].push_back(index);
+  }
+}
+
+TVM_REGISTER_GLOBAL("relax.analysis.liveness_killed_vars").set_body_typed([](const Function& fn) {
+  LivenessAnalysis liveness(fn);
+  Array<Array<Var>> ret;
+  for (int pos = 0; pos <= liveness.num_bindings(); ++pos) {
+    Array<Var> killed;
+    for (int index : liveness.killed_at(pos)) {
+      killed.push_back(GetRef<Var>(liveness.var(index)));
+    }
+    ret.push_back(killed);
+  }
+  return ret;
+});
+
+}  // namespace relax
+}  // namespace tvm
@@ -71,8 +71,8 @@ std::pair<runtime::Map<Var, runtime::Array<Var>>, runtime::Array<Var>> FunctionU
     Array<Var> uses{};
     uses.reserve(kv.second.size());
     for (const auto& v : kv.second) {
-      if (nullptr == v &&
-          fn_outs.end() == std::find(fn_outs.begin(), fn_outs.end(), GetRef<Var>(kv.first))) {
+      // The set holds nullptr at most once, so each output is only appended once.
+      if (nullptr == v) {
         fn_outs.push_back(GetRef<Var>(kv.first));
       } else {
         uses.push_back(GetRef<Var>(v));
@@ -40,6 +40,8 @@
 #include <tvm/relax/expr_functor.h>
 #include <tvm/tir/expr_functor.h>
 
+#include <algorithm>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace tvm {
@@ -76,9 +78,30 @@ class WellFormedChecker : public relax::ExprVisitor {
 
   void RegisterGlobalVar(GlobalVar var) { global_var_set_.insert(var); }
 
+  /*!
+   * \brief Check a function of the IRModule.
+   * \param func The function to be checked.
+   * \param used_global_vars The GlobalVars the function refers to.
+   * \return Whether the function is well formed.
+   */
+  bool CheckFunction(const Function& func, Array<GlobalVar>* used_global_vars) {
+    bool prev_well_formed = well_formed;
+    well_formed = true;
+    // The checks of a function do not depend on the other functions, except for the GlobalVars
+    // defined in the IRModule, so that the result of a function can be cached.
+    dataflow_var_set_.clear();
+    used_global_vars_.clear();
+    VisitExpr(func);
+    bool func_well_formed = well_formed;
+    well_formed = prev_well_formed && func_well_formed;
+    *used_global_vars = Array<GlobalVar>(used_global_vars_.begin(), used_global_vars_.end());
+    return func_well_formed;
+  }
+
  private:
   void VisitExpr_(const GlobalVarNode* op) {
     GlobalVar var = GetRef<GlobalVar>(op);
+    used_global_vars_.insert(var);
     if (global_var_set_.count(var) == 0) {
       Malformed(Diagnostic::Error(var->span)
                 << "GlobalVar " << op->name_hint << " is not defined.");
@@ -284,6 +307,7 @@ class WellFormedChecker : public relax::ExprVisitor {
 
   bool is_dataflow_ = false;
   std::unordered_set<GlobalVar, ObjectPtrHash, ObjectPtrEqual> global_var_set_;
+  std::unordered_set<GlobalVar, ObjectPtrHash, ObjectPtrEqual> used_global_vars_;
   std::unordered_set<Var, ObjectPtrHash, ObjectPtrEqual> var_set_;
   std::unordered_set<DataflowVar, ObjectPtrHash, ObjectPtrEqual> dataflow_var_set_;
   PrimExprVisitor prim_expr_visitor_;
@@ -297,27 +321,54 @@ void PrimExprVisitor::VisitExpr_(const tir::VarNode* op) {
   }
 }
 
-bool WellFormed(const IRModule& m, Optional<DiagnosticContext> diag_ctx) {
+TVM_REGISTER_NODE_TYPE(WellFormedCacheNode);
+
+WellFormedCache WellFormedCache::Create() {
+  return WellFormedCache(make_object<WellFormedCacheNode>());
+}
+
+bool WellFormed(const IRModule& m, Optional<DiagnosticContext> diag_ctx,
+                Optional<WellFormedCache> cache) {
   WellFormedChecker well_formed_checker = WellFormedChecker(diag_ctx);
   for (const auto& it : m->functions) {
     // register GlobalVar in the IRModule first
     well_formed_checker.RegisterGlobalVar(it.first);
   }
 
+  std::unordered_map<Function, Array<GlobalVar>, ObjectPtrHash, ObjectPtrEqual> checked;
   for (const auto& it : m->functions) {
     // visit relax.Function
     if (auto* n = it.second.as<FunctionNode>()) {
       Function func = GetRef<Function>(n);
-      well_formed_checker.VisitExpr(func);
+      if (cache.defined()) {
+        auto cached = cache.value()->checked.find(func);
+        if (cached != cache.value()->checked.end() &&
+            std::all_of(cached->second.begin(), cached->second.end(),
+                        [&m](const GlobalVar& gv) { return m->functions.count(gv); })) {
+          checked.insert(*cached);
+          continue;
+        }
+      }
+      Array<GlobalVar> used_global_vars;
+      if (well_formed_checker.CheckFunction(func, &used_global_vars)) {
+        checked.emplace(func, used_global_vars);
+      }
     }
   }
+  if (cache.defined()) {
+    // Only keep the functions of m, so that the cache does not keep the previous IRModules alive.
+    cache.value()->checked = std::move(checked);
+  }
 
   return well_formed_checker.well_formed;
 }
 
-TVM_REGISTER_GLOBAL(("relax.analysis.well_formed")).set_body_typed([](IRModule m) {
-  return WellFormed(m);
-});
+TVM_REGISTER_GLOBAL("relax.analysis.WellFormedCache").set_body_typed(WellFormedCache::Create);
+
+TVM_REGISTER_GLOBAL(("relax.analysis.well_formed"))
+    .set_body_typed([](IRModule m, Optional<WellFormedCache> cache) {
+      return WellFormed(m, NullOpt, cache);
+    });
 
 }  // namespace relax
 }  // namespace tvm
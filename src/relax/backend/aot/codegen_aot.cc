@@ -0,0 +1,371 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/backend/aot/codegen_aot.cc
+ * \brief Lower a static-shape Relax function into the TIR main of the AOT executor.
+ *
+ *  The function is expected after CallTIRRewrite and VMMemoryLower. Each storage becomes an
+ *  Allocate of the main, each tensor a pointer into its storage, and each PrimFunc call a
+ *  tvm_call_cpacked of the kernel, so that the main runs the kernels without an interpreter.
+ */
+#include <tvm/driver/driver_api.h>
+#include <tvm/ir/tensor_type.h>
+#include <tvm/relax/attrs/memory.h>
+#include <tvm/relax/expr.h>
+#include <tvm/relax/type.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/target/target.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/function.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../../relay/backend/utils.h"
+#include "../../../target/metadata_module.h"
+
+namespace tvm {
+namespace relax {
+namespace relax_aot {
+
+using runtime::Module;
+
+/*! \brief Build the TIR main of the AOT executor from a Relax function. */
+class AOTMainBuilder {
+ public:
+  AOTMainBuilder(IRModule mod, String mod_name, Target host)
+      : mod_(std::move(mod)), mod_name_(std::move(mod_name)), host_(std::move(host)) {}
+
+  tir::PrimFunc Build(const Function& func) {
+    const auto* seq = func->body.as<SeqExprNode>();
+    CHECK(seq != nullptr) << "ValueError: The AOT executor of Relax expects the body of the "
+                             "function to be normalized into a SeqExpr";
+    for (const BindingBlock& block : seq->blocks) {
+      for (const Binding& binding : block->bindings) {
+        const auto* var_binding = binding.as<VarBindingNode>();
+        CHECK(var_binding != nullptr)
+            << "ValueError: The AOT executor of Relax does not support the binding " << binding
+            << ", the shapes must be static";
+        bound_[var_binding->var.get()] = var_binding->value;
+      }
+    }
+
+    for (const Var& param : func->params) {
+      std::string what = "the parameter " + param->name_hint();
+      const auto* type = param->checked_type_.as<DynTensorTypeNode>();
+      CHECK(type != nullptr && !type->IsUnknownDtype())
+          << "ValueError: The AOT executor of Relax only supports tensors of known dtypes, but "
+          << what << " has the type " << param->checked_type_;
+      tir::Var var = CreateIOVar(param->name_hint(), StaticShape(param->shape_, what), type->dtype);
+      inputs_.push_back(var);
+      tensors_[param.get()] = TensorValue{var, NullOpt, 0, {}, type->dtype};
+    }
+    // the outputs are computed in place by their kernels rather than copied
+    Expr result = Resolve(seq->body);
+    if (const auto* var = result.as<VarNode>()) {
+      auto it = bound_.find(var);
+      if (it != bound_.end() && it->second->IsInstance<TupleNode>()) result = it->second;
+    }
+    Array<Expr> outputs;
+    if (const auto* tuple = result.as<TupleNode>()) {
+      outputs = tuple->fields;
+    } else {
+      outputs.push_back(result);
+    }
+    for (size_t i = 0; i < outputs.size(); ++i) {
+      const auto* root = Resolve(outputs[i]).as<VarNode>();
+      CHECK(root != nullptr && IsAllocTensor(root))
+          << "ValueError: The AOT executor of Relax requires each output to be a tensor computed "
+             "by a kernel, but the output "
+          << i << " is " << outputs[i];
+      CHECK(!output_index_.count(root))
+          << "ValueError: The AOT executor of Relax does not support returning a tensor twice";
+      output_index_[root] = output_vars_.size();
+      std::string name = outputs.size() == 1 ? "output" : "output" + std::to_string(i);
+      output_names_.push_back(name);
+      const auto* alloc = bound_.at(root).as<CallNode>();
+      Array<PrimExpr> shape = StaticShape(alloc->args[1], "the output " + name);
+      DataType dtype = alloc->attrs.as<VMAllocTensorAttrs>()->dtype;
+      output_vars_.push_back(CreateIOVar(name, shape, dtype));
+    }
+
+    for (const BindingBlock& block : seq->blocks) {
+      for (const Binding& binding : block->bindings) {
+        const auto* var_binding = binding.as<VarBindingNode>();
+        VisitBinding(var_binding->var, var_binding->value);
+      }
+    }
+
+    tir::Stmt body = tir::SeqStmt(stmts_);
+    for (auto it = storage_order_.rbegin(); it != storage_order_.rend(); ++it) {
+      const StorageValue& storage = storages_.at(*it);
+      if (storage.used) {
+        body = tir::Allocate(storage.buffer->data, DataType::UInt(8), {storage.size},
+                             tir::const_true(), body);
+      }
+    }
+
+    Array<tir::Var> params = inputs_;
+    params.insert(params.end(), output_vars_.begin(), output_vars_.end());
+    Map<String, ObjectRef> dict_attrs;
+    dict_attrs.Set(tvm::attr::kGlobalSymbol,
+                   runtime::get_name_mangled(mod_name_, runtime::symbol::tvm_module_main));
+    dict_attrs.Set("runner_function", Bool(true));
+    dict_attrs.Set(tvm::attr::kTarget, host_);
+    return tir::PrimFunc(params, body, VoidType(), buffer_map_, NullOpt, DictAttrs(dict_attrs));
+  }
+
+  /*! \brief The metadata of the main, read by the AOT executor. */
+  relay::backend::ExecutorCodegenMetadata Metadata() const {
+    Array<TensorType> input_types;
+    for (const tir::Var& var : inputs_) {
+      input_types.push_back(TensorTypeOf(var));
+    }
+    Array<TensorType> output_types;
+    for (const tir::Var& var : output_vars_) {
+      output_types.push_back(TensorTypeOf(var));
+    }
+    return relay::backend::ExecutorCodegenMetadata(inputs_, input_types, output_names_,
+                                                   output_types, {}, {}, runtime::kTvmExecutorAot,
+                                                   mod_name_);
+  }
+
+ private:
+  /*! \brief A tensor, either a parameter of the main or a pointer into a storage. */
+  struct TensorValue {
+    /*! \brief The DLTensor handle, when the tensor is a parameter of the main. */
+    Optional<tir::Var> param;
+    /*! \brief The storage of the tensor otherwise. */
+    Optional<Var> storage;
+    /*! \brief The byte offset of the tensor in its storage. */
+    int64_t offset;
+    Array<PrimExpr> shape;
+    DataType dtype;
+  };
+
+  struct StorageValue {
+    tir::Buffer buffer;
+    PrimExpr size;
+    /*! \brief Whether a kernel accesses the storage, the unused ones are not allocated. */
+    bool used;
+  };
+
+  static Array<PrimExpr> StaticShape(const Optional<ObjectRef>& shape, const std::string& what) {
+    const auto* shape_expr = shape.as<ShapeExprNode>();
+    CHECK(shape_expr != nullptr) << "ValueError: The AOT executor of Relax requires static "
+                                    "shapes, but the shape of "
+                                 << what << " is unknown";
+    for (const PrimExpr& dim : shape_expr->values) {
+      CHECK(dim.as<IntImmNode>()) << "ValueError: The AOT executor of Relax requires static "
+                                     "shapes, but the shape of "
+                                  << what << " is " << shape_expr->values;
+    }
+    return shape_expr->values;
+  }
+
+  /*! \brief Create a parameter of the main, the DLTensor of an input or an output. */
+  tir::Var CreateIOVar(const std::string& name, Array<PrimExpr> shape, DataType dtype) {
+    tir::Var handle(name, DataType::Handle());
+    buffer_map_.Set(handle, tir::decl_buffer(shape, dtype, name));
+    return handle;
+  }
+
+  TensorType TensorTypeOf(const tir::Var& var) const {
+    tir::Buffer buffer = buffer_map_.at(var);
+    return TensorType(buffer->shape, buffer->dtype);
+  }
+
+  /*! \brief Resolve the aliases and the tuple items to the var bound to their tensor. */
+  Expr Resolve(const Expr& expr) const {
+    if (const auto* var = expr.as<VarNode>()) {
+      auto it = bound_.find(var);
+      if (it != bound_.end() && (it->second->IsInstance<VarNode>() ||
+                                 it->second->IsInstance<TupleGetItemNode>())) {
+        return Resolve(it->second);
+      }
+      return expr;
+    }
+    if (const auto* item = expr.as<TupleGetItemNode>()) {
+      const auto* tuple_var = Resolve(item->tuple).as<VarNode>();
+      if (tuple_var != nullptr && bound_.count(tuple_var)) {
+        if (const auto* tuple = bound_.at(tuple_var).as<TupleNode>()) {
+          return Resolve(tuple->fields[item->index]);
+        }
+      }
+    }
+    return expr;
+  }
+
+  bool IsAllocTensor(const VarNode* var) const {
+    static const Op& vm_alloc_tensor_op = Op::Get("relax.vm.builtin.alloc_tensor");
+    auto it = bound_.find(var);
+    if (it == bound_.end()) return false;
+    const auto* call = it->second.as<CallNode>();
+    return call != nullptr && call->op == vm_alloc_tensor_op;
+  }
+
+  void VisitBinding(const Var& var, const Expr& value) {
+    static const Op& vm_alloc_storage_op = Op::Get("relax.vm.builtin.alloc_storage");
+    static const Op& vm_alloc_tensor_op = Op::Get("relax.vm.builtin.alloc_tensor");
+    // the aliases and the tuples are resolved at their uses
+    if (value->IsInstance<VarNode>() || value->IsInstance<TupleNode>() ||
+        value->IsInstance<TupleGetItemNode>()) {
+      return;
+    }
+    const auto* call = value.as<CallNode>();
+    if (call != nullptr && call->op == vm_alloc_storage_op) {
+      const auto* attrs = call->attrs.as<VMAllocStorageAttrs>();
+      CHECK(attrs->runtime_device_index == 0)
+          << "ValueError: The AOT executor of Relax only runs on the host device, but the storage "
+          << var->name_hint() << " is on the device " << attrs->runtime_device_index;
+      Array<PrimExpr> size = StaticShape(call->args[0], "the storage " + var->name_hint());
+      tir::Buffer buffer = tir::decl_buffer(size, DataType::UInt(8), var->name_hint());
+      storages_[var.get()] = StorageValue{buffer, size[0], false};
+      storage_order_.push_back(var.get());
+      return;
+    }
+    if (call != nullptr && call->op == vm_alloc_tensor_op) {
+      const auto* attrs = call->attrs.as<VMAllocTensorAttrs>();
+      Array<PrimExpr> shape = StaticShape(call->args[1], "the tensor " + var->name_hint());
+      auto it = output_index_.find(var.get());
+      if (it != output_index_.end()) {
+        tir::Var output = output_vars_[it->second];
+        tensors_[var.get()] = TensorValue{output, NullOpt, 0, shape, attrs->dtype};
+      } else {
+        Var storage = Downcast<Var>(call->args[0]);
+        CHECK(storages_.count(storage.get()))
+            << "ValueError: The storage of the tensor " << var->name_hint() << " is not allocated";
+        tensors_[var.get()] = TensorValue{NullOpt, storage, attrs->offset, shape, attrs->dtype};
+      }
+      return;
+    }
+    if (call != nullptr && call->op->IsInstance<GlobalVarNode>()) {
+      GlobalVar gvar = Downcast<GlobalVar>(call->op);
+      const auto* prim_func = mod_->Lookup(gvar).as<tir::PrimFuncNode>();
+      CHECK(prim_func != nullptr) << "ValueError: The AOT executor of Relax can only call "
+                                     "PrimFuncs, but "
+                                  << gvar->name_hint << " is not one";
+      String symbol =
+          prim_func->GetAttr<String>(tvm::attr::kGlobalSymbol).value_or(gvar->name_hint);
+      Array<PrimExpr> args{tir::StringImm(symbol)};
+      for (const Expr& arg : call->args) {
+        args.push_back(MakeArg(arg, gvar));
+      }
+      // the resource handle of the kernel
+      args.push_back(tir::make_zero(DataType::Handle()));
+      tir::Call call_kernel(DataType::Int(32), tir::builtin::tvm_call_cpacked(), args);
+      stmts_.push_back(tir::Evaluate(
+          tir::Call(DataType::Int(32), tir::builtin::tvm_check_return(),
+                    {tir::make_const(DataType::Int(32), 0), tir::make_const(DataType::Int(32), -1),
+                     call_kernel})));
+      return;
+    }
+    LOG(FATAL) << "ValueError: The AOT executor of Relax only supports the kernels called by "
+                  "call_tir with static shapes, but "
+               << var->name_hint() << " is bound to " << value;
+  }
+
+  /*! \brief The DLTensor handle of an argument of a kernel. */
+  PrimExpr MakeArg(const Expr& arg, const GlobalVar& callee) {
+    const auto* var = Resolve(arg).as<VarNode>();
+    auto it = var != nullptr ? tensors_.find(var) : tensors_.end();
+    CHECK(it != tensors_.end()) << "ValueError: The AOT executor of Relax only passes tensors to "
+                                   "the kernels, but "
+                                << callee->name_hint << " is called with " << arg;
+    const TensorValue& tensor = it->second;
+    if (tensor.param.defined()) {
+      return tensor.param.value();
+    }
+    StorageValue& storage = storages_.at(tensor.storage.value().get());
+    storage.used = true;
+    PrimExpr data = storage.buffer->data;
+    if (tensor.offset != 0) {
+      PrimExpr offset = IntImm(DataType::Int(64), tensor.offset);
+      data = tir::Call(DataType::Handle(), tir::builtin::address_of(),
+                       {tir::BufferLoad(storage.buffer, {offset})});
+    }
+    // the tensor is stack allocated, LowerTVMBuiltin reuses the DLTensors across the calls
+    Array<PrimExpr> make_array_args{
+        data,
+        tir::Call(DataType::Handle(), tir::builtin::tvm_stack_make_shape(), tensor.shape),
+        tir::make_zero(DataType::Handle()),
+        IntImm(DataType::UInt(32), tensor.shape.size()),
+        tir::Cast(tensor.dtype, IntImm(DataType::Int(32), 0)),
+        IntImm(DataType::Int(64), 0)};
+    return tir::Call(DataType::Handle(), tir::builtin::tvm_stack_make_array(), make_array_args);
+  }
+
+  IRModule mod_;
+  String mod_name_;
+  Target host_;
+  /*! \brief The values bound to the vars of the function. */
+  std::unordered_map<const VarNode*, Expr> bound_;
+  std::unordered_map<const VarNode*, TensorValue> tensors_;
+  std::unordered_map<const VarNode*, StorageValue> storages_;
+  /*! \brief The storages in the order of their allocation. */
+  std::vector<const VarNode*> storage_order_;
+  /*! \brief The index of the output of each tensor returned by the function. */
+  std::unordered_map<const VarNode*, size_t> output_index_;
+  Array<tir::Var> inputs_;
+  Array<tir::Var> output_vars_;
+  Array<String> output_names_;
+  Map<tir::Var, tir::Buffer> buffer_map_;
+  std::vector<tir::Stmt> stmts_;
+};
+
+/*!
+ * \brief Compile a static-shape Relax function and its kernels for the AOT executor.
+ * \param mod The IRModule, after CallTIRRewrite and VMMemoryLower.
+ * \param target The target of the kernels, which must run on the CPU.
+ * \param mod_name The name of the module, which mangles the symbol of the main.
+ * \param func_name The name of the Relax function to run.
+ * \return The module with the kernels, the main and the metadata read by the AOT executor.
+ */
+Module AOTCodeGen(IRModule mod, Target target, String mod_name, String func_name) {
+  CHECK_EQ(target->GetTargetDeviceType(), kDLCPU)
+      << "ValueError: The AOT executor of Relax only runs on the CPU, but the target is "
+      << target->str();
+  Target host = target->GetHost().value_or(target);
+  CHECK(mod->ContainGlobalVar(func_name))
+      << "ValueError: The module has no function named " << func_name;
+  const auto* func = mod->Lookup(func_name).as<FunctionNode>();
+  CHECK(func != nullptr) << "ValueError: " << func_name << " is not a Relax function";
+
+  IRModule tir_mod;
+  for (const auto& kv : mod->functions) {
+    if (kv.second->IsInstance<tir::PrimFuncNode>()) {
+      tir_mod->Add(kv.first, kv.second);
+    }
+  }
+  AOTMainBuilder builder(mod, mod_name, host);
+  tir_mod->Add(GlobalVar(runtime::symbol::tvm_module_main), builder.Build(GetRef<Function>(func)));
+  Module lib = tvm::build(tir_mod, target, host);
+  return codegen::CreateMetadataModule({}, lib, {}, host, relay::Runtime::Create("cpp"),
+                                       relay::Executor::Create("aot"), builder.Metadata());
+}
+
+TVM_REGISTER_GLOBAL("relax.AOTCodeGen").set_body_typed(AOTCodeGen);
+
+}  // namespace relax_aot
+}  // namespace relax
+}  // namespace tvm
@@ -0,0 +1,151 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+/*!
+ * \file src/relax/backend/contrib/dnnl/codegen.cc
+ * \brief Implementation of the DNNL JSON serializer for Relax.
+ *
+ * The functions offloaded by python/tvm/relax/op/contrib/dnnl.py, in which MergeCompositeFunctions
+ * has merged the chains of consecutive composite functions, become graphs of the DNNL JSON
+ * runtime, shared with Relay. Each composite function becomes one "kernel" node:
+ *  - "dnnl.dense*" keeps its name, which the runtime parses for the bias and the post-ops, with
+ *    the inputs data, weight and bias if any;
+ *  - "dnnl.relu", "dnnl.add" and "dnnl.multiply" are named as the Relay ops the runtime expects.
+ * Within a graph, the runtime lets each primitive pick its preferred layouts for the intermediate
+ * tensors, so that the consecutive ops exchange them in the blocked layouts of oneDNN. The
+ * primitives are created once per graph, for its static shapes, and the structurally equal
+ * subgraphs, e.g. the repeated layers of a model, share one function and so one set of primitives.
+ */
+#include <tvm/ir/module.h>
+#include <tvm/relax/type.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../codegen_json/codegen_json.h"
+#include "../utils.h"
+
+namespace tvm {
+namespace relax {
+namespace contrib {
+
+using JSONGraphNode = tvm::runtime::json::JSONGraphNode;
+using JSONGraphNodeEntry = tvm::runtime::json::JSONGraphNodeEntry;
+using JSONSerializer = backend::contrib::JSONSerializer;
+
+class DNNLJSONSerializer : public JSONSerializer {
+ public:
+  DNNLJSONSerializer(const std::string& symbol, const Expr& expr) : JSONSerializer(symbol, expr) {}
+
+  using JSONSerializer::VisitExpr_;
+
+  std::vector<JSONGraphNodeEntry> VisitExpr_(const CallNode* call_node) final {
+    const auto* fn = call_node->op.as<FunctionNode>();
+    if (!fn) return JSONSerializer::VisitExpr_(call_node);
+    auto opt_composite = fn->GetAttr<String>(attr::kComposite);
+    ICHECK(opt_composite.defined());
+    std::string name = opt_composite.value();
+
+    // Find the op calls in the body of the composite function.
+    static const Op& matmul_op = Op::Get("relax.nn.matmul");
+    static const Op& add_op = Op::Get("relax.add");
+    const CallNode* matmul = nullptr;
+    const CallNode* add = nullptr;
+    const CallNode* first = nullptr;
+    Var matmul_var;
+    const auto* body = fn->body.as<SeqExprNode>();
+    ICHECK(body) << name << ": the composite function is expected to be a SeqExpr";
+    for (const BindingBlock& block : body->blocks) {
+      for (const Binding& binding : block->bindings) {
+        const auto* var_binding = binding.as<VarBindingNode>();
+        const auto* call = var_binding ? var_binding->value.as<CallNode>() : nullptr;
+        if (call == nullptr) continue;
+        if (first == nullptr) first = call;
+        if (call->op.same_as(matmul_op)) {
+          matmul = call;
+          matmul_var = var_binding->var;
+        } else if (call->op.same_as(add_op)) {
+          add = call;
+        }
+      }
+    }
+    ICHECK(first) << name << ": no op is found in the composite function";
+
+    // The parameters of the composite function are bound to the arguments of the call.
+    std::unordered_map<const Object*, Expr> args;
+    for (size_t i = 0; i < fn->params.size(); ++i) {
+      args[fn->params[i].get()] = call_node->args[i];
+    }
+    std::vector<JSONGraphNodeEntry> inputs;
+    auto add_input = [&](const Expr& expr) {
+      auto it = args.find(expr.get());
+      auto res = VisitExpr(it != args.end() ? it->second : expr);
+      inputs.insert(inputs.end(), res.begin(), res.end());
+    };
+    if (name.rfind("dnnl.dense", 0) == 0) {
+      ICHECK(matmul) << name << ": no matmul is found in the composite function";
+      add_input(matmul->args[0]);
+      add_input(matmul->args[1]);
+      if (add != nullptr) {
+        add_input(add->args[0].same_as(matmul_var) ? add->args[1] : add->args[0]);
+      }
+    } else {
+      static const std::unordered_map<std::string, std::string> op_names = {
+          {"dnnl.relu", "nn.relu"}, {"dnnl.add", "add"}, {"dnnl.multiply", "multiply"}};
+      auto it = op_names.find(name);
+      ICHECK(it != op_names.end()) << "Unsupported DNNL composite function: " << name;
+      name = it->second;
+      for (const Expr& arg : first->args) add_input(arg);
+    }
+
+    auto node = std::make_shared<JSONGraphNode>(name, /*op_type=*/"kernel", inputs,
+                                                /*num_output=*/1);
+    VLOG(1) << name << " has " << node->GetInputs().size() << " inputs";
+    return AddNode(node, GetRef<Expr>(call_node));
+  }
+};
+
+/*!
+ * \brief Create a runtime module for DNNL.
+ * \param ref The function to be offloaded.
+ * \return A runtime module.
+ */
+runtime::Module DNNLCompiler(const ObjectRef& ref) {
+  ICHECK(ref->IsInstance<FunctionNode>()) << "The input ref is expected to be a Relax function.";
+  Function func = Downcast<Function>(ref);
+  std::string func_name = backend::GetExtSymbol(func);
+
+  DNNLJSONSerializer serializer(func_name, func);
+  serializer.serialize();
+  std::string graph_json = serializer.GetJSON();
+  VLOG(1) << "DNNL JSON:" << std::endl << graph_json;
+  const auto* pf = runtime::Registry::Get("runtime.DNNLJSONRuntimeCreate");
+  ICHECK(pf != nullptr) << "Cannot find DNNL runtime module create function, please build "
+                        << "with USE_DNNL.";
+  return (*pf)(func_name, graph_json, serializer.GetParams());
+}
+
+TVM_REGISTER_GLOBAL("relax.ext.dnnl").set_body_typed(DNNLCompiler);
+
+}  // namespace contrib
+}  // namespace relax
+}  // namespace tvm
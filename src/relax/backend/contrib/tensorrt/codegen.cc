@@ -25,6 +25,7 @@
 // TODO(sunggg): add operator attribute when it's ready
 // #include <tvm/relax/attrs/nn.h>
 #include <tvm/relax/type.h>
+#include <tvm/tir/var.h>
 
 #include <memory>
 #include <string>
@@ -49,6 +50,12 @@ struct TensorRTCompilerConfigNode : public tvm::AttrsNode<TensorRTCompilerConfig
   bool remove_no_mac_subgraphs;
   bool use_fp16;
   bool use_uint8;
+  bool use_int8;
+  int num_calibration_batches;
+  String calibration_cache_dir;
+  Array<String> fp16_layers;
+  Array<String> fp32_layers;
+  Map<String, Integer> tir_var_upper_bound;
 
   TVM_DECLARE_ATTRS(TensorRTCompilerConfigNode, "relax.ext.attrs.TensorRTCompilerConfigNode") {
     TVM_ATTR_FIELD(tensorrt_version)
@@ -59,6 +66,28 @@ struct TensorRTCompilerConfigNode : public tvm::AttrsNode<TensorRTCompilerConfig
     TVM_ATTR_FIELD(remove_no_mac_subgraphs).set_default(false);
     TVM_ATTR_FIELD(use_fp16).set_default(false);
     TVM_ATTR_FIELD(use_uint8).set_default(false);
+    TVM_ATTR_FIELD(use_int8)
+        .describe("Whether to build int8 engines, calibrated on the inputs of the first runs.")
+        .set_default(false);
+    TVM_ATTR_FIELD(num_calibration_batches)
+        .describe("The runs whose inputs calibrate the int8 engines, before the engines are built. "
+                  "These runs do not compute the outputs.")
+        .set_default(0);
+    TVM_ATTR_FIELD(calibration_cache_dir)
+        .describe("The directory of the int8 calibration caches, one per offloaded function. The "
+                  "engines of a cached calibration are built without calibration runs.")
+        .set_default("");
+    TVM_ATTR_FIELD(fp16_layers)
+        .describe("The ops whose layers are computed in float16, e.g. to fall back from int8.")
+        .set_default(Array<String>());
+    TVM_ATTR_FIELD(fp32_layers)
+        .describe("The ops whose layers are computed in float32, e.g. to fall back from float16 "
+                  "or int8.")
+        .set_default(Array<String>());
+    TVM_ATTR_FIELD(tir_var_upper_bound)
+        .describe("The upper bounds of the shape variables of the offloaded functions, for "
+                  "the ones not annotated with tir_var_upper_bound.")
+        .set_default(Map<String, Integer>());
   }
 };
 
@@ -209,7 +238,9 @@ class CollectFromCompositeFunctionBody : public ExprVisitor {
 class TensorRTJSONSerializer : public JSONSerializer {
  public:
   TensorRTJSONSerializer(const std::string& symbol, const Expr& expr)
-      : JSONSerializer(symbol, expr) {}
+      : JSONSerializer(symbol, expr) {
+    CollectMaxInputShapes(Downcast<Function>(expr));
+  }
 
   using JSONSerializer::VisitExpr_;
 
@@ -238,9 +269,12 @@ class TensorRTJSONSerializer : public JSONSerializer {
     for (const auto& node : collector.args_) {
       inputs.emplace_back(node);
     }
+    // The composite functions created by FuseOpsByPattern are named by their patterns, e.g.
+    // "tensorrt.add". For the ones annotated by the op names, replace the "relax." prefix.
     // TODO(@sunggg): Revisit when we have op naming convention.
-    // Currently, simply remove "relax." prefix to make it work.
-    name = std::string("tensorrt.") + name.substr(6);
+    if (name.rfind("tensorrt.", 0) != 0) {
+      name = std::string("tensorrt.") + name.substr(6);
+    }
     // Create the final node.
     auto node = std::make_shared<JSONGraphNode>(name,
                                                 /*op_type=*/"kernel", inputs,
@@ -257,7 +291,7 @@ class TensorRTJSONSerializer : public JSONSerializer {
     return AddNode(node, GetRef<Expr>(call_node));
   }
 
-  static void SaveGlobalAttributes(std::shared_ptr<JSONGraphNode> node) {
+  void SaveGlobalAttributes(std::shared_ptr<JSONGraphNode> node) {
     auto ctx = transform::PassContext::Current();
     auto cfg = ctx->GetConfig<TensorRTCompilerConfig>("relax.ext.tensorrt.options");
     if (!cfg.defined()) {
@@ -284,7 +318,77 @@ class TensorRTJSONSerializer : public JSONSerializer {
     node->SetAttr("max_workspace_size", max_workspace_size_attr);
     node->SetAttr("use_fp16", use_fp16_attr);
     node->SetAttr("use_uint8", use_uint8_attr);
+    if (cfg.value()->use_int8) {
+      std::vector<std::string> use_int8 = {"1"};
+      std::vector<std::string> num_calibration_batches = {
+          std::to_string(cfg.value()->num_calibration_batches)};
+      std::vector<std::string> calibration_cache_dir = {cfg.value()->calibration_cache_dir};
+      std::vector<dmlc::any> use_int8_attr, num_calibration_batches_attr,
+          calibration_cache_dir_attr;
+      use_int8_attr.emplace_back(use_int8);
+      num_calibration_batches_attr.emplace_back(num_calibration_batches);
+      calibration_cache_dir_attr.emplace_back(calibration_cache_dir);
+      node->SetAttr("use_int8", use_int8_attr);
+      node->SetAttr("num_calibration_batches", num_calibration_batches_attr);
+      node->SetAttr("calibration_cache_dir", calibration_cache_dir_attr);
+    }
+    for (const auto& kv : {std::make_pair("fp16_layers", cfg.value()->fp16_layers),
+                           std::make_pair("fp32_layers", cfg.value()->fp32_layers)}) {
+      if (kv.second.empty()) continue;
+      std::vector<std::string> layers(kv.second.begin(), kv.second.end());
+      std::vector<dmlc::any> layers_attr;
+      layers_attr.emplace_back(layers);
+      node->SetAttr(kv.first, layers_attr);
+    }
+    if (!max_input_shapes_.empty()) {
+      std::vector<dmlc::any> max_input_shapes_attr;
+      max_input_shapes_attr.emplace_back(max_input_shapes_);
+      node->SetAttr("max_input_shapes", max_input_shapes_attr);
+    }
+  }
+
+ private:
+  /*!
+   * \brief Collect the largest shapes of the inputs of symbolic shapes, from the upper bounds of
+   * their shape variables, for the runtime to build engines of optimization profiles in the
+   * explicit batch mode. Each entry reads "<input name>_<index>=<dim>,<dim>,...", with -1 for the
+   * dimensions of no known upper bound.
+   */
+  void CollectMaxInputShapes(const Function& func) {
+    auto cfg = transform::PassContext::Current()->GetConfig<TensorRTCompilerConfig>(
+        "relax.ext.tensorrt.options");
+    Map<String, Integer> upper_bounds =
+        cfg.defined() ? cfg.value()->tir_var_upper_bound : Map<String, Integer>();
+    for (const auto& kv : func->GetAttr<Map<String, Integer>>(attr::kTIRVarUpperBound)
+                              .value_or(Map<String, Integer>())) {
+      upper_bounds.Set(kv.first, kv.second);
+    }
+    for (const Var& param : func->params) {
+      const auto* shape = param->shape_.as<ShapeExprNode>();
+      if (shape == nullptr) continue;
+      bool is_static = true;
+      std::string dims;
+      for (const PrimExpr& dim : shape->values) {
+        int64_t value = -1;
+        if (const auto* imm = dim.as<IntImmNode>()) {
+          value = imm->value;
+        } else {
+          is_static = false;
+          const auto* var = dim.as<tir::VarNode>();
+          if (var != nullptr && upper_bounds.count(var->name_hint)) {
+            value = upper_bounds[var->name_hint]->value;
+          }
+        }
+        dims += (dims.empty() ? "" : ",") + std::to_string(value);
+      }
+      if (!is_static) {
+        max_input_shapes_.push_back(param->name_hint() + "_0=" + dims);
+      }
+    }
   }
+
+  /*! \brief The largest shapes of the inputs of symbolic shapes. */
+  std::vector<std::string> max_input_shapes_;
 };
 
 void CollectFromCompositeFunctionBody::VisitExpr_(const ConstantNode* constant_node) {
@@ -18,6 +18,7 @@
  */
 
 #include <tvm/meta_schedule/extracted_task.h>
+#include <tvm/meta_schedule/tune_context.h>
 #include <tvm/relax/expr.h>
 #include <tvm/relax/expr_functor.h>
 #include <tvm/target/target.h>
@@ -57,10 +58,7 @@ class TaskExtractor : public ExprVisitor {
 
  private:
   explicit TaskExtractor(IRModule mod, Target target)
-      : mod_(std::move(mod)), target_(std::move(target)) {
-    normalize_mod_func_ = runtime::Registry::Get("tvm.meta_schedule.normalize_mod");
-    ICHECK(normalize_mod_func_) << "Normalization function is not found.";
-  }
+      : mod_(std::move(mod)), target_(std::move(target)) {}
 
   void VisitExpr_(const CallNode* call) final {
     static const Op& call_tir_op = Op::Get("relax.call_tir");
@@ -87,7 +85,7 @@ class TaskExtractor : public ExprVisitor {
       return;
     }
 
-    IRModule tir_mod = (*normalize_mod_func_)(func);
+    IRModule tir_mod = meta_schedule::NormalizeMod(func);
     ExtractedTask task(/*task_name=*/global_var->name_hint,  //
                        /*mod=*/tir_mod,                      //
                        /*target=*/target_,                   //
@@ -100,8 +98,8 @@ class TaskExtractor : public ExprVisitor {
   IRModule mod_;
   Target target_;
   Array<ExtractedTask> tasks_;
-  std::unordered_map<tir::PrimFunc, ExtractedTask, StructuralHash, StructuralEqual> func2task_;
-  const runtime::PackedFunc* normalize_mod_func_;
+  std::unordered_map<tir::PrimFunc, ExtractedTask, CachedStructuralHash, StructuralEqual>
+      func2task_;
 };
 
 TVM_REGISTER_GLOBAL("relax.backend.MetaScheduleExtractTask")
@@ -25,15 +25,21 @@
 #include "codegen_vm.h"
 
 #include <tvm/driver/driver_api.h>
+#include <tvm/ir/transform.h>
 #include <tvm/relax/attrs/memory.h>
 #include <tvm/relax/attrs/shape.h>
 #include <tvm/relax/expr_functor.h>
 #include <tvm/relax/op_attr_types.h>
+#include <tvm/support/parallel_for.h>
 #include <tvm/target/target.h>
+#include <tvm/tir/expr.h>
 #include <tvm/tir/function.h>
 
+#include <algorithm>
+#include <set>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "../../../target/metadata_module.h"
@@ -45,6 +51,11 @@ namespace relax_vm {
 
 using namespace relax;
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.VMCodeGen.num_streams", Integer);
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.VMCodeGen.fuse_instructions", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.VMCodeGen.allocate_registers", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.VMCodeGen.tail_calls", Bool);
+
 // Helper function to get the function name of the registered packed function implementation of
 // relax operator.
 FCallPacked GetPackedFuncName(const Call& call) {
@@ -63,10 +74,34 @@ FCallPacked GetPackedFuncName(const Call& call) {
  */
 class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
  public:
-  explicit CodeGenVM(ExecBuilderNode* builder) { builder_ = GetRef<ExecBuilder>(builder); }
+  explicit CodeGenVM(ExecBuilderNode* builder, IRModule mod, Array<runtime::Module> ext_libs = {})
+      : mod_(mod) {
+    builder_ = GetRef<ExecBuilder>(builder);
+    transform::PassContext pass_ctx = transform::PassContext::Current();
+    num_streams_ = pass_ctx->GetConfig("relax.VMCodeGen.num_streams", Integer(1)).value().IntValue();
+    ICHECK_GE(num_streams_, 1) << "relax.VMCodeGen.num_streams must be positive";
+    tail_calls_ = pass_ctx->GetConfig("relax.VMCodeGen.tail_calls", Bool(true)).value();
+    for (runtime::Module ext_lib : ext_libs) {
+      PackedFunc is_stream_ordered = ext_lib.GetFunction("is_stream_ordered");
+      PackedFunc get_symbol = ext_lib.GetFunction("get_symbol");
+      if (is_stream_ordered != nullptr && get_symbol != nullptr && is_stream_ordered()) {
+        std::string symbol = get_symbol();
+        stream_ordered_funcs_.insert(symbol);
+      }
+    }
+  }
 
  protected:
   size_t NewRegister() { return registers_num_++; }
+  /*! \brief Copy a register or constant argument into the dst register. */
+  void EmitMoveArg(Instruction::Arg arg, RegName dst) {
+    if (arg.kind() == Instruction::kConstIdx) {
+      builder_->EmitLoadConst(arg.value(), dst);
+    } else {
+      ICHECK_EQ(arg.kind(), Instruction::kRegister);
+      builder_->EmitMove(arg.value(), dst);
+    }
+  }
   Instruction::Arg VisitExpr_(const FunctionNode* func_node) {
     Optional<String> gsymbol = func_node->GetAttr<String>(tvm::attr::kGlobalSymbol);
     ICHECK(gsymbol.defined()) << "there should be no local functions in Relax VM codegen phase. "
@@ -78,32 +113,164 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
     }
 
     builder_->EmitFunction(gsymbol.value(), func_node->params.size(), param_names);
+    this->ResetStreams();
+    func_name_ = gsymbol.value();
+    func_start_instr_ = builder_->Get()->instr_offset.size();
+    param_registers_.clear();
 
     for (Var param : func_node->params) {
       Instruction::Arg reg = this->VisitExpr(param);
       this->var_register_map_.insert({param, reg.data});
+      param_registers_.push_back(reg.value());
+    }
+    Instruction::Arg ret;
+    // The streams are synchronized at the end of the sequences, which a loop would jump over.
+    if (tail_calls_ && num_streams_ == 1 && HasTailCall(func_node->body)) {
+      this->EmitTail(func_node->body);
+    } else {
+      ret = ExprFunctor::VisitExpr(func_node->body);
+      builder_->EmitRet(ret.data);
     }
-    Instruction::Arg ret = ExprFunctor::VisitExpr(func_node->body);
-    builder_->EmitRet(ret.data);
     registers_num_ = 0;
     return ret;
   }
 
+  /*! \brief Emit a binding of a sequence. */
+  void EmitBinding(const Binding& binding) {
+    ICHECK(binding->IsInstance<VarBindingNode>());
+    Expr value = Downcast<VarBinding>(binding)->value;
+    Var var = Downcast<VarBinding>(binding)->var;
+    if (num_streams_ > 1) {
+      this->AssignStream(var, value);
+    }
+    Instruction::Arg reg = this->VisitExpr(value);
+    this->var_register_map_.insert({var, reg.data});
+    this->RecordDevice(var, value);
+  }
+
   Instruction::Arg VisitExpr_(const SeqExprNode* op) {
     for (auto block : op->blocks) {
       for (Binding binding : block->bindings) {
-        ICHECK(binding->IsInstance<VarBindingNode>());
-        Expr value = Downcast<VarBinding>(binding)->value;
-        Var var = Downcast<VarBinding>(binding)->var;
-        Instruction::Arg reg = this->VisitExpr(value);
-        this->var_register_map_.insert({var, reg.data});
+        this->EmitBinding(binding);
       }
     }
+    if (num_streams_ > 1) {
+      this->SyncAllStreams();
+    }
 
     Instruction::Arg ret_reg = this->VisitExpr(op->body);
     return ret_reg;
   }
 
+  /*! \brief Whether a call is a call of the function being generated. */
+  bool IsSelfCall(const Expr& expr) {
+    const auto* call = expr.as<CallNode>();
+    if (call == nullptr) return false;
+    const auto* gvar = call->op.as<GlobalVarNode>();
+    return gvar != nullptr && gvar->name_hint == func_name_ &&
+           call->args.size() == param_registers_.size();
+  }
+
+  /*!
+   * \brief Get the binding whose value a sequence returns when it is its last one, the tail
+   * position of the sequence, or nullptr.
+   */
+  const VarBindingNode* TailBinding(const SeqExprNode* seq) {
+    if (seq->blocks.empty() || seq->blocks.back()->bindings.empty()) return nullptr;
+    const auto* last = seq->blocks.back()->bindings.back().as<VarBindingNode>();
+    if (last == nullptr || !seq->body.same_as(last->var)) return nullptr;
+    return last;
+  }
+
+  /*! \brief Whether a call is a call of a Relax function of the module. */
+  bool IsRelaxCall(const Expr& expr) {
+    const auto* call = expr.as<CallNode>();
+    if (call == nullptr) return false;
+    const auto* gvar = call->op.as<GlobalVarNode>();
+    return gvar != nullptr && mod_->ContainGlobalVar(gvar->name_hint) &&
+           mod_->Lookup(gvar->name_hint)->IsInstance<FunctionNode>();
+  }
+
+  /*! \brief Whether an expression returned by the function ends with a call of a Relax function. */
+  bool HasTailCall(const Expr& expr) {
+    if (IsRelaxCall(expr)) return true;
+    if (const auto* seq = expr.as<SeqExprNode>()) {
+      const VarBindingNode* tail = TailBinding(seq);
+      return tail != nullptr && HasTailCall(tail->value);
+    }
+    if (const auto* ife = expr.as<IfNode>()) {
+      return HasTailCall(ife->true_branch) || HasTailCall(ife->false_branch);
+    }
+    return false;
+  }
+
+  /*!
+   * \brief Emit an expression whose value the function returns, when it calls a Relax function in
+   * tail position. Every path ends with a Ret, with no Move merging the branches of an If, so
+   * that the VM runs the calls followed by a Ret in the frame of the caller. The calls of the
+   * function itself become a backward Goto to its first instruction after setting the parameters,
+   * so that a loop written as tail recursion runs in a single frame without any call.
+   */
+  void EmitTail(const Expr& expr) {
+    if (IsSelfCall(expr)) {
+      this->EmitLoopBack(Downcast<Call>(expr));
+      return;
+    }
+    if (const auto* seq = expr.as<SeqExprNode>()) {
+      const VarBindingNode* tail = TailBinding(seq);
+      if (tail != nullptr && HasTailCall(tail->value)) {
+        for (const BindingBlock& block : seq->blocks) {
+          for (const Binding& binding : block->bindings) {
+            if (binding.get() != tail) this->EmitBinding(binding);
+          }
+        }
+        this->EmitTail(tail->value);
+        return;
+      }
+    }
+    if (const auto* ife = expr.as<IfNode>()) {
+      if (HasTailCall(expr)) {
+        ObjectPtr<Executable> exec = builder_->Get();
+        Instruction::Arg cond_reg = this->VisitExpr(ife->cond);
+        size_t if_offset = exec->instr_offset.size();
+        builder_->EmitIf(cond_reg.value(), 3);
+        size_t num_instr = exec->instr_offset.size();
+        // Both branches return, so no Goto merges them.
+        this->EmitTail(ife->true_branch);
+        size_t false_offset = exec->instr_offset.size() - num_instr + 1;
+        this->EmitTail(ife->false_branch);
+        exec->SetInstructionData(if_offset, 2, static_cast<ExecWord>(false_offset));
+        return;
+      }
+    }
+    Instruction::Arg ret = this->VisitExpr(expr);
+    builder_->EmitRet(ret.data);
+  }
+
+  /*! \brief Emit a self tail call as the update of the parameters and a jump to the start. */
+  void EmitLoopBack(const Call& call) {
+    std::vector<Instruction::Arg> args = ConvertArgs(call);
+    // An argument read from a parameter is copied first, as the parameter may be assigned
+    // before it is read.
+    std::unordered_set<RegName> params(param_registers_.begin(), param_registers_.end());
+    for (size_t i = 0; i < args.size(); ++i) {
+      if (args[i].kind() == Instruction::kRegister && params.count(args[i].value()) &&
+          args[i].value() != param_registers_[i]) {
+        RegName copy = NewRegister();
+        builder_->EmitMove(args[i].value(), copy);
+        args[i] = Instruction::Arg(Instruction::kRegister, copy);
+      }
+    }
+    for (size_t i = 0; i < args.size(); ++i) {
+      if (args[i].kind() == Instruction::kRegister && args[i].value() == param_registers_[i]) {
+        continue;
+      }
+      EmitMoveArg(args[i], param_registers_[i]);
+    }
+    Index num_instrs = builder_->Get()->instr_offset.size();
+    builder_->EmitGoto(static_cast<Index>(func_start_instr_) - num_instrs);
+  }
+
   Instruction::Arg VisitExpr_(const CallNode* call_node) {
     if (call_node->op.as<OpNode>()) {
       // special case generate for the intrinsics whose attribute fields
@@ -120,6 +287,8 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
         return EmitAllocTensor(call);
       } else if (call_node->op == store_shape_op_ || call_node->op == load_shape_op_) {
         return EmitShape(call);
+      } else if (call_node->op == compute_shape_op_) {
+        return EmitComputeShape(call);
       } else if (call_node->op == call_tir_dyn_op_) {
         return EmitTirDynOp(call);
       } else if (call_node->op == make_closure_op_) {
@@ -170,7 +339,7 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
     // Reserve a register for return
     size_t merge_register = NewRegister();
     // Copy the output from true branch to merge register
-    builder_->EmitCall("vm.builtin.copy", {true_reg}, merge_register);
+    EmitMoveArg(true_reg, merge_register);
 
     // Record the offset of Goto instruction
     size_t goto_offset = exec_->instr_offset.size();
@@ -182,7 +351,7 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
 
     Instruction::Arg false_reg = this->VisitExpr(ife->false_branch);
     // Copy the output data of false branch to merge register
-    builder_->EmitCall("vm.builtin.copy", {false_reg}, merge_register);
+    EmitMoveArg(false_reg, merge_register);
 
     // Update the offsets of the If instruction emitted above
     // Jump to the behind of the next goto instruction
@@ -209,9 +378,7 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
     Index index = this->builder_->EmitConstant(constant_data);
 
     size_t dst_register = NewRegister();
-    std::vector<Instruction::Arg> args;
-    args.push_back(Instruction::Arg(Instruction::kConstIdx, index));
-    builder_->EmitCall("vm.builtin.copy", args, dst_register);
+    builder_->EmitLoadConst(index, dst_register);
     return Instruction::Arg(Instruction::kRegister, dst_register);
   }
 
@@ -237,24 +404,18 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
       args.push_back(this->VisitExpr(arg));
     }
     size_t dst_register = NewRegister();
-    builder_->EmitCall("runtime.Tuple", args, dst_register);
+    builder_->EmitMakeTuple(args, dst_register);
 
     return Instruction::Arg(Instruction::kRegister, dst_register);
   }
 
   Instruction::Arg VisitExpr_(const TupleGetItemNode* op) {
     TupleGetItem expr = GetRef<TupleGetItem>(op);
-    std::vector<Instruction::Arg> args = {this->VisitExpr(expr->tuple)};
-
-    std::vector<int64_t> tuple_index = {expr->index};
-    auto shape_tuple = ShapeTuple(tuple_index);
-    TVMRetValue shape_tuple_value;
-    shape_tuple_value = shape_tuple;
-    Index index = builder_->EmitConstant(shape_tuple_value);
-    args.push_back(Instruction::Arg(Instruction::kConstIdx, index));
+    Instruction::Arg tuple = this->VisitExpr(expr->tuple);
+    ICHECK_EQ(tuple.kind(), Instruction::kRegister);
 
     size_t dst_register = NewRegister();
-    builder_->EmitCall("vm.runtime.TupleGetItem", args, dst_register);
+    builder_->EmitGetTupleItem(tuple.value(), expr->index, dst_register);
 
     return Instruction::Arg(Instruction::kRegister, dst_register);
   }
@@ -279,7 +440,19 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
     args.push_back(Instruction::Arg(Instruction::kConstIdx, index));
 
     size_t dst_register = NewRegister();
-    builder_->EmitCall("vm.builtin.alloc_storage", args, dst_register);
+    if (!alloc_attrs->storage_scope.empty() && alloc_attrs->storage_scope != "global") {
+      TVMRetValue scope;
+      scope = alloc_attrs->storage_scope;
+      args.push_back(Instruction::Arg(Instruction::kConstIdx, builder_->EmitConstant(scope)));
+      Index slot = alloc_attrs->persistent ? static_storage_count_++ : -1;
+      args.push_back(Instruction::Arg(Instruction::kImmediate, slot));
+      builder_->EmitCall("vm.builtin.alloc_scoped_storage", args, dst_register);
+    } else if (alloc_attrs->persistent) {
+      args.push_back(Instruction::Arg(Instruction::kImmediate, static_storage_count_++));
+      builder_->EmitCall("vm.builtin.alloc_static_storage", args, dst_register);
+    } else {
+      builder_->EmitCall("vm.builtin.alloc_storage", args, dst_register);
+    }
     return Instruction::Arg(Instruction::kRegister, dst_register);
   }
 
@@ -321,6 +494,21 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
     for (Integer ind : shape_attrs->indices) {
       indices_vec.push_back(ind.IntValue());
     }
+
+    // The shape heap is manipulated natively by the VM when the operands are in registers.
+    bool native = std::all_of(args.begin(), args.end(), [](Instruction::Arg arg) {
+      return arg.kind() == Instruction::kRegister && arg.value() != Instruction::kVMRegister;
+    });
+    if (native && call_node->op == store_shape_op_) {
+      builder_->EmitStoreShape(args[0].value(), args[1].value(), indices_vec);
+      return Instruction::Arg(Instruction::kRegister, Instruction::kVoidArg);
+    }
+    if (native && call_node->op == load_shape_op_) {
+      size_t dst_register = NewRegister();
+      builder_->EmitLoadShape(args[0].value(), indices_vec, dst_register);
+      return Instruction::Arg(Instruction::kRegister, dst_register);
+    }
+
     ShapeTuple indices = ShapeTuple(indices_vec);
     TVMRetValue indices_const;
     indices_const = indices;
@@ -336,6 +524,65 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
     return Instruction::Arg(Instruction::kRegister, dst_register);
   }
 
+  Instruction::Arg EmitComputeShape(const Call& call_node) {
+    ICHECK_EQ(call_node->args.size(), 1);
+    Instruction::Arg heap = ConvertArg(call_node->args[0]);
+    ICHECK_EQ(heap.kind(), Instruction::kRegister) << "The shape heap must be in a register";
+    auto compute_attrs = call_node->attrs.as<ComputeShapeAttrs>();
+    ICHECK(compute_attrs != nullptr) << "must be ComputeShapeAttrs";
+    ICHECK_EQ(compute_attrs->values.size(), compute_attrs->indices.size());
+
+    std::vector<ExecWord> program;
+    for (size_t i = 0; i < compute_attrs->values.size(); ++i) {
+      CompileShapeArith(compute_attrs->values[i], &program);
+      program.push_back(static_cast<ExecWord>(ShapeOp::kStore));
+      program.push_back(compute_attrs->indices[i].IntValue());
+    }
+    builder_->EmitComputeShape(heap.value(), program);
+    return Instruction::Arg(Instruction::kRegister, Instruction::kVoidArg);
+  }
+
+  /*! \brief Append the postfix program that pushes the value of \p expr, see vm::ShapeOp. */
+  void CompileShapeArith(const PrimExpr& expr, std::vector<ExecWord>* program) {
+    auto emit = [program](ShapeOp op, ExecWord operand) {
+      program->push_back(static_cast<ExecWord>(op));
+      program->push_back(operand);
+    };
+    auto emit_binary = [&](const PrimExpr& a, const PrimExpr& b, ShapeOp op) {
+      CompileShapeArith(a, program);
+      CompileShapeArith(b, program);
+      emit(op, 0);
+    };
+    if (const auto* imm = expr.as<IntImmNode>()) {
+      emit(ShapeOp::kImm, imm->value);
+    } else if (const auto* load = expr.as<tir::BufferLoadNode>()) {
+      ICHECK_EQ(load->indices.size(), 1);
+      emit(ShapeOp::kLoad, Downcast<IntImm>(load->indices[0])->value);
+    } else if (const auto* cast = expr.as<tir::CastNode>()) {
+      CompileShapeArith(cast->value, program);
+    } else if (const auto* op = expr.as<tir::AddNode>()) {
+      emit_binary(op->a, op->b, ShapeOp::kAdd);
+    } else if (const auto* op = expr.as<tir::SubNode>()) {
+      emit_binary(op->a, op->b, ShapeOp::kSub);
+    } else if (const auto* op = expr.as<tir::MulNode>()) {
+      emit_binary(op->a, op->b, ShapeOp::kMul);
+    } else if (const auto* op = expr.as<tir::DivNode>()) {
+      emit_binary(op->a, op->b, ShapeOp::kDiv);
+    } else if (const auto* op = expr.as<tir::ModNode>()) {
+      emit_binary(op->a, op->b, ShapeOp::kMod);
+    } else if (const auto* op = expr.as<tir::FloorDivNode>()) {
+      emit_binary(op->a, op->b, ShapeOp::kFloorDiv);
+    } else if (const auto* op = expr.as<tir::FloorModNode>()) {
+      emit_binary(op->a, op->b, ShapeOp::kFloorMod);
+    } else if (const auto* op = expr.as<tir::MinNode>()) {
+      emit_binary(op->a, op->b, ShapeOp::kMin);
+    } else if (const auto* op = expr.as<tir::MaxNode>()) {
+      emit_binary(op->a, op->b, ShapeOp::kMax);
+    } else {
+      LOG(FATAL) << "Unsupported shape expression for the VM: " << expr;
+    }
+  }
+
   Instruction::Arg EmitTirDynOp(const Call& call_node) {
     ICHECK(call_node->args.size() == 2);
     ICHECK(call_node->args[0]->IsInstance<GlobalVarNode>());
@@ -345,13 +592,13 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
     auto tir_args = Downcast<Tuple>(call_node->args[1]);
     auto func_name = gv->name_hint;
 
-    TVMRetValue func_name_constant;
-    func_name_constant = func_name;
-    auto func_name_index = builder_->EmitConstant(func_name_constant);
+    // Pass the kernel as an index into the function table, which the VM resolves once at load
+    // time, so that no name lookup happens per launch.
+    Index func_idx = builder_->DeclarePackedFunc(func_name);
 
     std::vector<Instruction::Arg> args;
     args.push_back(Instruction::Arg(Instruction::kVMRegister));
-    args.push_back(Instruction::Arg(Instruction::kConstIdx, func_name_index));
+    args.push_back(Instruction::Arg(Instruction::kImmediate, func_idx));
     for (Expr arg : tir_args->fields) {
       args.push_back(ConvertArg(arg));
     }
@@ -383,6 +630,13 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
       args.push_back(EmitConstantFromValue(unique_attrs->dim));
       return;
     }
+    if (call_node->op == quantize_op_ || call_node->op == dequantize_op_) {
+      auto quantize_attrs = call_node->attrs.as<QuantizeAttrs>();
+      args.push_back(EmitConstantFromValue(quantize_attrs->scale));
+      args.push_back(EmitConstantFromValue(quantize_attrs->zero_point));
+      args.push_back(EmitConstantFromValue(runtime::DLDataType2String(quantize_attrs->out_dtype)));
+      return;
+    }
     if (call_node->op == print_op_) {
       auto print_attrs = call_node->attrs.as<PrintAttrs>();
       // format string is the first argument
@@ -395,6 +649,25 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
       args.insert(args.begin() + 1, EmitConstantFromValue(assert_attrs->format));
       return;
     }
+    if (const auto* ccl_attrs = call_node->attrs.as<CCLAttrs>()) {
+      // the communicator is looked up on the VM, passed before the tensor
+      args.insert(args.begin(), Instruction::Arg(Instruction::kRegister, Instruction::kVMRegister));
+      if (call_node->op == ccl_allreduce_op_ || call_node->op == ccl_reduce_scatter_op_) {
+        args.push_back(EmitConstantFromValue(ccl_attrs->op_type));
+      }
+      return;
+    }
+    if (call_node->op == param_load_op_) {
+      auto param_load_attrs = call_node->attrs.as<ParamLoadAttrs>();
+      // the param store is looked up on the VM, the name of the param is the only other argument
+      args.push_back(Instruction::Arg(Instruction::kRegister, Instruction::kVMRegister));
+      args.push_back(EmitConstantFromValue(param_load_attrs->name));
+      return;
+    }
+    if (const auto* prefetch_attrs = call_node->attrs.as<PrefetchAttrs>()) {
+      args.push_back(EmitConstantFromValue(prefetch_attrs->scope));
+      return;
+    }
     LOG(FATAL) << "Support for attributes of Op " << call_node->op
                << " has not been implemented yet.";
     return;
@@ -463,6 +736,201 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
     return Instruction::Arg(Instruction::kRegister, dst_register);
   }
 
+  /*! \brief Reset the stream assignment state at the start of a function. */
+  void ResetStreams() {
+    curr_stream_ = 0;
+    next_stream_ = 0;
+    var_stream_.clear();
+    unwritten_tensors_.clear();
+    pending_streams_.clear();
+    tensor_storage_.clear();
+    storage_streams_.clear();
+    stream_tensors_.clear();
+    stream_tensor_set_.clear();
+    this->MarkStreamsStale();
+  }
+
+  /*!
+   * \brief Mark the streams as behind the default stream, which the inputs of the function and
+   * the storage released so far may have been used on.
+   */
+  void MarkStreamsStale() {
+    stale_streams_.clear();
+    for (int64_t stream = 1; stream < num_streams_; ++stream) {
+      stale_streams_.insert(stream);
+    }
+  }
+
+  /*! \brief Emit the instruction that makes the following calls run on the given stream. */
+  void SwitchStream(int64_t stream) {
+    if (stream == curr_stream_) return;
+    builder_->EmitCall("vm.builtin.set_stream",
+                       {Instruction::Arg(Instruction::kVMRegister),
+                        Instruction::Arg(Instruction::kImmediate, stream)},
+                       Instruction::kVoidArg);
+    curr_stream_ = stream;
+  }
+
+  /*! \brief Emit the instruction that makes \p dst wait for the work submitted to \p src. */
+  void SyncStream(int64_t src, int64_t dst) {
+    builder_->EmitCall("vm.builtin.sync_stream",
+                       {Instruction::Arg(Instruction::kVMRegister),
+                        Instruction::Arg(Instruction::kImmediate, src),
+                        Instruction::Arg(Instruction::kImmediate, dst)},
+                       Instruction::kVoidArg);
+  }
+
+  /*!
+   * \brief Synchronize all the streams with the default stream and switch back to it.
+   *
+   * The tensors the kernels used since the last join are passed to the join, so that their
+   * registers, and with them the storage, are only released after it. Otherwise the storage
+   * could go back to the allocator and be handed to a kernel while a kernel of another stream
+   * still uses it.
+   */
+  void SyncAllStreams() {
+    if (!pending_streams_.empty()) {
+      std::vector<Instruction::Arg> args = {
+          Instruction::Arg(Instruction::kVMRegister),
+          Instruction::Arg(Instruction::kImmediate, static_cast<Index>(pending_streams_.size()))};
+      for (int64_t stream : pending_streams_) {
+        args.push_back(Instruction::Arg(Instruction::kImmediate, stream));
+      }
+      for (const Var& tensor : stream_tensors_) {
+        args.push_back(this->VisitExpr(tensor));
+      }
+      builder_->EmitCall("vm.builtin.join_streams", args, Instruction::kVoidArg);
+      curr_stream_ = 0;
+      this->MarkStreamsStale();
+    }
+    pending_streams_.clear();
+    storage_streams_.clear();
+    stream_tensors_.clear();
+    stream_tensor_set_.clear();
+    for (auto& kv : var_stream_) {
+      kv.second = 0;
+    }
+    SwitchStream(0);
+  }
+
+  /*!
+   * \brief Whether the call launches a TIR kernel, or enqueues the work of an external module or
+   * of a TStreamOrdered operator, e.g. a collective, on the current stream as a kernel.
+   */
+  bool IsKernelCall(const CallNode* call) const {
+    if (call->op == call_tir_dyn_op_) return true;
+    if (const auto* op = call->op.as<OpNode>()) {
+      static const auto& stream_ordered_map = Op::GetAttrMap<TStreamOrdered>("TStreamOrdered");
+      return stream_ordered_map.get(GetRef<Op>(op), Bool(false))->value;
+    }
+    if (const auto* extern_func = call->op.as<ExternFuncNode>()) {
+      return stream_ordered_funcs_.count(extern_func->global_symbol);
+    }
+    if (const auto* gvar = call->op.as<GlobalVarNode>()) {
+      // the relax functions are in the module, the PrimFuncs are compiled separately
+      return !mod_->ContainGlobalVar(gvar->name_hint);
+    }
+    return false;
+  }
+
+  /*!
+   * \brief Assign the binding to a stream before it is emitted.
+   *
+   * Kernels that depend on the output of another kernel run on the stream of that kernel,
+   * while kernels without such dependencies start a new chain on the next stream in
+   * round-robin order. Cross-stream dataflow edges are synchronized right before the
+   * consumer, and any other instruction runs on the default stream after the work it
+   * depends on. Kernels write their results to the tensors passed as arguments, which are
+   * recognized as the allocated tensors that no kernel has written yet.
+   */
+  void AssignStream(const Var& var, const Expr& value) {
+    const auto* call = value.as<CallNode>();
+    if (call == nullptr) {
+      this->SyncAllStreams();
+      return;
+    }
+    if (call->op == alloc_tensor_op_) {
+      unwritten_tensors_.insert(var);
+      if (const auto* storage = call->args[0].as<VarNode>()) {
+        tensor_storage_[var] = GetRef<Var>(storage);
+      }
+      return;
+    }
+    if (call->op == alloc_storage_op_ || call->op == store_shape_op_ ||
+        call->op == load_shape_op_ || call->op == compute_shape_op_) {
+      return;
+    }
+    if (const auto* gvar = call->op.as<GlobalVarNode>()) {
+      if (mod_->ContainGlobalVar(gvar->name_hint)) {
+        // the callee manages the streams itself
+        this->SyncAllStreams();
+        return;
+      }
+    }
+
+    std::vector<Var> tensor_args;
+    Array<Expr> args = call->op == call_tir_dyn_op_ ? Downcast<Tuple>(call->args[1])->fields
+                                                    : call->args;
+    for (const Expr& arg : args) {
+      if (const auto* var_node = arg.as<VarNode>()) {
+        tensor_args.push_back(GetRef<Var>(var_node));
+      }
+    }
+    std::vector<int64_t> deps;
+    for (const Var& arg : tensor_args) {
+      auto it = var_stream_.find(arg);
+      if (it != var_stream_.end() &&
+          std::find(deps.begin(), deps.end(), it->second) == deps.end()) {
+        deps.push_back(it->second);
+      }
+    }
+
+    int64_t target = 0;
+    if (IsKernelCall(call)) {
+      target = deps.empty() ? (next_stream_++ % num_streams_) : deps[0];
+    }
+    // A tensor planned into a storage shared with earlier tensors is written after the kernels
+    // of other streams that used those tensors are done.
+    std::vector<int64_t> waits = deps;
+    for (const Var& arg : tensor_args) {
+      auto it = tensor_storage_.find(arg);
+      if (it == tensor_storage_.end() || !unwritten_tensors_.count(arg)) continue;
+      for (int64_t stream : storage_streams_[it->second]) {
+        if (std::find(waits.begin(), waits.end(), stream) == waits.end()) {
+          waits.push_back(stream);
+        }
+      }
+    }
+    // The first kernel of a stream since the last join waits for the default stream.
+    if (target != 0 && stale_streams_.erase(target) &&
+        std::find(waits.begin(), waits.end(), 0) == waits.end()) {
+      waits.push_back(0);
+    }
+    for (int64_t wait : waits) {
+      if (wait != target) {
+        SyncStream(wait, target);
+      }
+    }
+    SwitchStream(target);
+    if (target != 0) {
+      pending_streams_.insert(target);
+    }
+
+    for (const Var& arg : tensor_args) {
+      if (unwritten_tensors_.erase(arg)) {
+        var_stream_[arg] = target;
+      }
+      auto it = tensor_storage_.find(arg);
+      if (it != tensor_storage_.end()) {
+        storage_streams_[it->second].insert(target);
+      }
+      if (var_register_map_.count(arg) && stream_tensor_set_.insert(arg).second) {
+        stream_tensors_.push_back(arg);
+      }
+    }
+    var_stream_[var] = target;
+  }
+
   bool IsConstantShape(ShapeExpr shape) const {
     for (PrimExpr e : shape->values) {
       if (!e->IsInstance<IntImmNode>()) {
@@ -472,7 +940,38 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
     return true;
   }
 
-  Instruction::Arg ConvertArg(Expr arg) {
+  /*!
+   * \brief Record the VM device a bound var lives on, so that the constants that are used
+   *  together with it can be placed on the same device.
+   */
+  void RecordDevice(const Var& var, const Expr& value) {
+    if (const auto* call = value.as<CallNode>()) {
+      if (call->op == alloc_storage_op_) {
+        auto alloc_attrs = call->attrs.as<VMAllocStorageAttrs>();
+        ICHECK(alloc_attrs != nullptr) << "must be VMAllocStorageAttrs";
+        var_device_[var] = alloc_attrs->runtime_device_index;
+      } else if (call->op == alloc_tensor_op_ && call->args[0]->IsInstance<VarNode>()) {
+        auto it = var_device_.find(Downcast<Var>(call->args[0]));
+        if (it != var_device_.end()) var_device_[var] = it->second;
+      }
+    } else if (const auto* alias = value.as<VarNode>()) {
+      auto it = var_device_.find(GetRef<Var>(alias));
+      if (it != var_device_.end()) var_device_[var] = it->second;
+    }
+  }
+
+  /*! \brief The device of the first argument of the call allocated on a known device. */
+  Index CallDevice(const Call& call) {
+    for (const Expr& arg : call->args) {
+      if (const auto* var = arg.as<VarNode>()) {
+        auto it = var_device_.find(GetRef<Var>(var));
+        if (it != var_device_.end()) return it->second;
+      }
+    }
+    return 0;
+  }
+
+  Instruction::Arg ConvertArg(Expr arg, Index const_device = 0) {
     if (arg->IsInstance<VarNode>()) {
       Var var = Downcast<Var>(arg);
       auto reg = this->var_register_map_.find(Downcast<Var>(arg));
@@ -490,12 +989,12 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
       auto shape_tuple = ShapeTuple(shape);
       TVMRetValue shape_tuple_value;
       shape_tuple_value = shape_tuple;
-      Index index = builder_->EmitConstant(shape_tuple_value);
+      Index index = builder_->EmitConstant(shape_tuple_value, -1);
       return Instruction::Arg(Instruction::kConstIdx, index);
     } else if (arg->IsInstance<ConstantNode>()) {
       TVMRetValue constant_data;
       constant_data = Downcast<Constant>(arg)->data;
-      Index index = builder_->EmitConstant(constant_data);
+      Index index = builder_->EmitConstant(constant_data, const_device);
       return Instruction::Arg(Instruction::kConstIdx, index);
     } else {
       LOG(FATAL) << "CodeGenVM does not support this argument type:\n" << arg->GetTypeKey();
@@ -505,42 +1004,97 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
 
   std::vector<Instruction::Arg> ConvertArgs(const Call& call) {
     std::vector<Instruction::Arg> ret;
+    Index device = CallDevice(call);
     for (size_t i = 0; i < call->args.size(); ++i) {
-      ret.push_back(ConvertArg(call->args[i]));
+      ret.push_back(ConvertArg(call->args[i], device));
     }
     return ret;
   }
 
+  /*! \brief The module containing the relax functions. */
+  IRModule mod_;
+  /*! \brief The number of streams kernels are distributed on, 1 disables the assignment. */
+  int64_t num_streams_;
+  /*! \brief The stream the emitted instructions run on. */
+  int64_t curr_stream_ = 0;
+  /*! \brief The stream an independent chain of kernels is assigned to next. */
+  int64_t next_stream_ = 0;
+  /*! \brief Map from tensor var to the stream where the tensor is produced. */
+  std::unordered_map<Var, int64_t, ObjectPtrHash, ObjectPtrEqual> var_stream_;
+  /*! \brief Allocated tensors that have not been written by a kernel yet. */
+  std::unordered_set<Var, ObjectPtrHash, ObjectPtrEqual> unwritten_tensors_;
+  /*! \brief Streams with work not synchronized with the default stream yet. */
+  std::set<int64_t> pending_streams_;
+  /*! \brief Streams that have not waited for the default stream since the last join. */
+  std::set<int64_t> stale_streams_;
+  /*! \brief Map from allocated tensor var to the storage var it is allocated from. */
+  std::unordered_map<Var, Var, ObjectPtrHash, ObjectPtrEqual> tensor_storage_;
+  /*! \brief Map from storage var to the streams that used its tensors since the last join. */
+  std::unordered_map<Var, std::set<int64_t>, ObjectPtrHash, ObjectPtrEqual> storage_streams_;
+  /*! \brief The tensors the kernels used since the last join, kept alive until the join. */
+  std::vector<Var> stream_tensors_;
+  /*! \brief The set of the tensors in stream_tensors_. */
+  std::unordered_set<Var, ObjectPtrHash, ObjectPtrEqual> stream_tensor_set_;
+  /*! \brief The functions of the external modules that only enqueue their work on the stream. */
+  std::unordered_set<std::string> stream_ordered_funcs_;
   /*! \brief A counter for naming local functions. */
   size_t local_func_counter_ = 0;
+  /*! \brief Whether the tail calls are emitted for the VM to reuse the frame, see EmitTail. */
+  bool tail_calls_ = true;
+  /*! \brief The name of the function being generated. */
+  std::string func_name_;
+  /*! \brief The first instruction of the function being generated. */
+  size_t func_start_instr_ = 0;
+  /*! \brief The registers of the parameters of the function being generated. */
+  std::vector<RegName> param_registers_;
+  /*! \brief The number of storages kept by the VM across calls, used as their slots. */
+  int64_t static_storage_count_ = 0;
   /*! \brief Internal ExecBuilder. */
   relax::ExecBuilder builder_;
   /*! \brief Total number of virtual registers allocated. */
   size_t registers_num_ = 0;
   /*! \brief Map from var to register number. */
   std::unordered_map<Var, RegName, ObjectPtrHash, ObjectPtrEqual> var_register_map_;
+  /*! \brief Map from var to the index of the VM device its storage is allocated on. */
+  std::unordered_map<Var, Index, ObjectPtrHash, ObjectPtrEqual> var_device_;
   /*! \brief Cache ops that need to be frequently used later to reduce lookup overhead. */
   const Op& alloc_storage_op_ = Op::Get("relax.vm.builtin.alloc_storage");
   const Op& alloc_tensor_op_ = Op::Get("relax.vm.builtin.alloc_tensor");
   const Op& store_shape_op_ = Op::Get("relax.vm.builtin.store_shape");
   const Op& load_shape_op_ = Op::Get("relax.vm.builtin.load_shape");
+  const Op& compute_shape_op_ = Op::Get("relax.vm.builtin.compute_shape");
   const Op& call_tir_dyn_op_ = Op::Get("relax.vm.call_tir_dyn");
   const Op& unique_op_ = Op::Get("relax.unique");
   const Op& print_op_ = Op::Get("relax.print");
+  const Op& quantize_op_ = Op::Get("relax.quantize");
+  const Op& dequantize_op_ = Op::Get("relax.dequantize");
   const Op& assert_op_ = Op::Get("relax.assert_op");
+  const Op& param_load_op_ = Op::Get("relax.param_load");
+  const Op& ccl_allreduce_op_ = Op::Get("relax.ccl.allreduce");
+  const Op& ccl_reduce_scatter_op_ = Op::Get("relax.ccl.reduce_scatter");
   const Op& make_closure_op_ = Op::Get("relax.make_closure");
   const Op& invoke_closure_op_ = Op::Get("relax.invoke_closure");
 };
 
-void VMCodeGen::CodeGen(IRModule rx_mod) {
+void VMCodeGen::CodeGen(IRModule rx_mod, Array<runtime::Module> ext_libs) {
   builder_ = relax::ExecBuilderNode::Create();
-  CodeGenVM codegen(builder_.operator->());
+  CodeGenVM codegen(builder_.operator->(), rx_mod, ext_libs);
   for (auto& p : rx_mod->functions) {
     codegen.VisitExpr(p.second);
   }
 }
 
-ObjectPtr<Executable> VMCodeGen::GetExec() { return builder_->Get(); }
+ObjectPtr<Executable> VMCodeGen::GetExec() {
+  ObjectPtr<Executable> exec = builder_->Get();
+  transform::PassContext pass_ctx = transform::PassContext::Current();
+  if (pass_ctx->GetConfig("relax.VMCodeGen.fuse_instructions", Bool(true)).value()) {
+    builder_->FuseInstructions();
+  }
+  if (pass_ctx->GetConfig("relax.VMCodeGen.allocate_registers", Bool(true)).value()) {
+    builder_->AllocateRegisters();
+  }
+  return exec;
+}
 
 /*!
  * \brief Create the Relax VM executable from an IRModule of Relax function(s) and, possibly, a
@@ -552,7 +1106,7 @@ ObjectPtr<Executable> VMCodeGen::GetExec() { return builder_->Get(); }
 Module CodeGen(IRModule mod, Optional<Module> lib, Array<Module> ext_libs, Target target,
                Map<String, runtime::NDArray> params) {
   VMCodeGen codegen;
-  codegen.CodeGen(mod);
+  codegen.CodeGen(mod, ext_libs);
   ObjectPtr<Executable> executable = codegen.GetExec();
   if (!lib.defined()) {
     lib = codegen::CSourceModuleCreate(";", "", Array<String>{});
@@ -576,6 +1130,50 @@ Module CodeGen(IRModule mod, Optional<Module> lib, Array<Module> ext_libs, Targe
 
 TVM_REGISTER_GLOBAL("relax.VMCodeGen").set_body_typed(CodeGen);
 
+/*!
+ * \brief Build the PrimFuncs of an IRModule in shards, which are lowered and compiled in parallel.
+ * \param tir_mod The IRModule containing the PrimFuncs.
+ * \param target The target, with its host.
+ * \param num_shards The number of shards.
+ * \return The runtime module of the first shard, importing the ones of the other shards.
+ */
+Module BuildTIRInShards(IRModule tir_mod, Target target, int num_shards) {
+  // Sort the functions by name, so that the shards do not depend on the hash map order.
+  std::vector<std::pair<GlobalVar, BaseFunc>> funcs(tir_mod->functions.begin(),
+                                                    tir_mod->functions.end());
+  std::sort(funcs.begin(), funcs.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.first->name_hint < rhs.first->name_hint;
+  });
+  num_shards = std::max(1, std::min(num_shards, static_cast<int>(funcs.size())));
+  DictAttrs attrs = tir_mod->attrs;
+  if (!tir_mod->GetAttr<relay::Runtime>(tvm::attr::kRuntime).defined()) {
+    attrs = WithAttr(tir_mod, tvm::attr::kRuntime, relay::Runtime::Create("cpp"))->attrs;
+  }
+  std::vector<IRModule> shards;
+  for (int i = 0; i < num_shards; ++i) {
+    Map<GlobalVar, BaseFunc> shard_funcs;
+    for (size_t j = funcs.size() * i / num_shards; j < funcs.size() * (i + 1) / num_shards; ++j) {
+      shard_funcs.Set(funcs[j].first, funcs[j].second);
+    }
+    shards.push_back(IRModule(shard_funcs, {}, {}, {}, attrs));
+  }
+
+  // The pass context is thread local, so the workers enter the one of the caller.
+  transform::PassContext pass_ctx = transform::PassContext::Current();
+  std::vector<Module> libs(num_shards);
+  support::parallel_for(0, num_shards, [&](int i) {
+    transform::PassContextThreadScope scope(pass_ctx);
+    IRModule lowered = LowerModule(shards[i]);
+    libs[i] = TIRToRuntime({{target, lowered}}, target->GetHost().value_or(Target()));
+  });
+  for (int i = 1; i < num_shards; ++i) {
+    libs[0].Import(libs[i]);
+  }
+  return libs[0];
+}
+
+TVM_REGISTER_GLOBAL("relax.VMBuildTIRInShards").set_body_typed(BuildTIRInShards);
+
 }  // namespace relax_vm
 }  // namespace relax
 }  // namespace tvm
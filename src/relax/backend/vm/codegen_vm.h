@@ -45,8 +45,10 @@ class VMCodeGen : public Object {
   /*!
    * \brief Compile the functions in a Module.
    * \param rx_mod Input IRModule that constains relax functions.
+   * \param ext_libs The external modules called by the functions, whose stream ordered functions
+   * are scheduled on the streams of the VM as the TIR kernels.
    */
-  void CodeGen(IRModule rx_mod);
+  void CodeGen(IRModule rx_mod, Array<runtime::Module> ext_libs = {});
   /*!
    * \brief Get the compiled executable.
    * \return The compiled executable.
@@ -0,0 +1,401 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/backend/vm/codegen_vm_cpp.cc
+ * \brief Compile the bytecode of a Relax VM executable into C++ source.
+ *
+ * Each Relax function becomes a PackedFunc of the generated source, which is compiled and linked
+ * with the kernels when the executable is exported. The VM calls it in place of interpreting the
+ * bytecode of the function: the registers are locals, the jumps are gotos, the shape heap
+ * instructions are native integer arithmetic, and the calls go to the entries of the function
+ * table of the VM without any dispatch, see tvm/runtime/relax_vm/compiled_function.h.
+ */
+
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/relax_vm/compiled_function.h>
+#include <tvm/runtime/relax_vm/executable.h>
+
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "../../../target/source/codegen_source_base.h"
+
+namespace tvm {
+namespace relax {
+namespace relax_vm {
+
+using namespace tvm::runtime::relax_vm;
+
+/*!
+ * \brief Translate the bytecode of the functions of an executable into C++ source.
+ */
+class CodeGenVMCpp {
+ public:
+  explicit CodeGenVMCpp(const Executable* exec) : exec_(exec) {}
+
+  /*!
+   * \brief Generate the source of all the functions of the executable.
+   * \param system_lib Whether to register the functions in the system library.
+   * \param symbols The symbols of the generated functions.
+   * \return The source.
+   */
+  std::string Generate(bool system_lib, Array<String>* symbols) {
+    std::vector<Index> starts;
+    for (const VMFunction& func : exec_->global_funcs) {
+      starts.push_back(func.start_instr);
+    }
+    starts.push_back(static_cast<Index>(exec_->instr_offset.size()));
+    std::sort(starts.begin(), starts.end());
+
+    os_ << "// Generated from the bytecode of a Relax VM executable.\n"
+        << "#include <tvm/runtime/relax_vm/compiled_function.h>\n\n"
+        << "namespace {\n"
+        << "using namespace tvm::runtime;\n"
+        << "using namespace tvm::runtime::relax_vm;\n";
+    std::unordered_set<std::string> seen;
+    std::vector<std::string> names;
+    for (const VMFunction& func : exec_->global_funcs) {
+      std::string symbol = CompiledFunctionSymbol(func.name);
+      CHECK(seen.insert(symbol).second)
+          << "ValueError: The functions of the executable are mangled to the same symbol "
+          << symbol;
+      // the function spans the instructions up to the start of the next one
+      Index end = *std::upper_bound(starts.begin(), starts.end(), func.start_instr);
+      GenerateFunction(func, end, symbol);
+      names.push_back(symbol);
+    }
+    os_ << "}  // namespace\n";
+    for (const std::string& symbol : names) {
+      os_ << "\nTVM_DLL_EXPORT_PACKED_FUNC(" << symbol << ", " << symbol << "_body);\n";
+      if (system_lib) {
+        os_ << "static int " << symbol << "_registered = TVMBackendRegisterSystemLibSymbol(\""
+            << symbol << "\", reinterpret_cast<void*>(" << symbol << "));\n";
+      }
+      symbols->push_back(symbol);
+    }
+    return os_.str();
+  }
+
+ private:
+  /*! \brief Generate the PackedFunc running the instructions [start_instr, end) of a function. */
+  void GenerateFunction(const VMFunction& func, Index end, const std::string& symbol) {
+    // the jump targets, relative to the start of the function
+    std::set<Index> labels;
+    Index max_num_args = 1;
+    for (Index pc = func.start_instr; pc < end; ++pc) {
+      Instruction instr = exec_->GetInstruction(pc);
+      if (instr.op == Opcode::Goto) {
+        labels.insert(pc - func.start_instr + instr.pc_offset);
+      } else if (instr.op == Opcode::If) {
+        labels.insert(pc - func.start_instr + instr.false_offset);
+      } else if (instr.op == Opcode::Call || instr.op == Opcode::LoadShapeCall) {
+        max_num_args = std::max(max_num_args, instr.num_args);
+      }
+    }
+
+    os_ << "\n// " << func.name << "\n"
+        << "void " << symbol << "_body(TVMArgs args, TVMRetValue* rv) {\n"
+        << "  ICHECK_EQ(args.size(), " << func.num_args + 1 << ") << \"ValueError: Invoking "
+        << "function " << func.name << " requires " << func.num_args << " inputs\";\n"
+        << "  CompiledFunctionContext* ctx = static_cast<CompiledFunctionContext*>("
+        << "args[0].operator void*());\n"
+        << "  TVMRetValue r[" << std::max<Index>(func.register_file_size, 1) << "];\n"
+        << "  TVMValue values[" << max_num_args << "];\n"
+        << "  int tcodes[" << max_num_args << "];\n"
+        << "  TVMArgsSetter setter(values, tcodes);\n";
+    for (Index i = 0; i < func.num_args; ++i) {
+      os_ << "  r[" << i << "] = args[" << i + 1 << "];\n";
+    }
+    for (Index pc = func.start_instr; pc < end; ++pc) {
+      Index local_pc = pc - func.start_instr;
+      if (labels.count(local_pc)) {
+        os_ << "L" << local_pc << ":;\n";
+      }
+      GenerateInstruction(exec_->GetInstruction(pc), local_pc);
+    }
+    // the jumps past the last instruction
+    for (Index label : labels) {
+      if (label >= end - func.start_instr) os_ << "L" << label << ":;\n";
+    }
+    os_ << "}\n";
+  }
+
+  void GenerateInstruction(const Instruction& instr, Index local_pc) {
+    switch (instr.op) {
+      case Opcode::Call: {
+        GenerateCall(instr);
+        break;
+      }
+      case Opcode::LoadShapeCall: {
+        // args[0]: the register of the loaded shape; args[1]: the heap; args[2]: the indices,
+        // which are a constant, so the loads are unrolled
+        ICHECK_EQ(instr.shape_args[2].kind(), Instruction::kConstIdx);
+        ShapeTuple indices =
+            exec_->constants[instr.shape_args[2].value()].AsObjectRef<ShapeTuple>();
+        GenerateLoadShape(instr.shape_args[1].value(),
+                          std::vector<ExecWord>(indices.begin(), indices.end()),
+                          instr.shape_args[0].value());
+        GenerateCall(instr);
+        break;
+      }
+      case Opcode::AllocStorageTensor: {
+        const Instruction::Arg* args = instr.alloc_args;
+        os_ << "  ctx->alloc_storage_tensor(ctx->vm, " << Value(args[0]) << ", "
+            << args[1].value() << ", " << Value(args[2]) << ", " << args[3].value() << ", "
+            << Value(args[4]) << ", " << Value(args[5]) << ", &" << Reg(instr.storage) << ", &"
+            << Reg(instr.dst) << ");\n";
+        break;
+      }
+      case Opcode::LoadShape: {
+        std::vector<ExecWord> indices(instr.heap_args, instr.heap_args + instr.heap_num_args);
+        GenerateLoadShape(instr.heap, indices, instr.dst);
+        break;
+      }
+      case Opcode::StoreShape: {
+        os_ << "  {\n"
+            << "    int64_t* heap = CompiledShapeHeap(" << Reg(instr.heap) << ", "
+            << HeapSize(instr.heap_args, instr.heap_num_args) << ");\n"
+            << "    ShapeTuple shape = " << Reg(instr.shape) << ".AsObjectRef<ShapeTuple>();\n"
+            << "    ICHECK_EQ(shape.size(), " << instr.heap_num_args << ");\n";
+        for (Index i = 0; i < instr.heap_num_args; ++i) {
+          os_ << "    heap[" << instr.heap_args[i] << "] = shape[" << i << "];\n";
+        }
+        os_ << "  }\n";
+        break;
+      }
+      case Opcode::ComputeShape: {
+        GenerateComputeShape(instr);
+        break;
+      }
+      case Opcode::Move: {
+        os_ << "  " << Reg(instr.dst) << " = " << Reg(instr.src) << ";\n";
+        break;
+      }
+      case Opcode::LoadConst: {
+        os_ << "  " << Reg(instr.dst) << " = *ctx->get_constant(ctx->vm, " << instr.const_idx
+            << ");\n";
+        break;
+      }
+      case Opcode::MakeTuple: {
+        os_ << "  " << Reg(instr.dst) << " = ADT::Tuple(std::vector<ObjectRef>{";
+        for (Index i = 0; i < instr.num_fields; ++i) {
+          os_ << (i == 0 ? "" : ", ") << Value(instr.fields[i]) << ".AsObjectRef<ObjectRef>()";
+        }
+        os_ << "});\n";
+        break;
+      }
+      case Opcode::GetTupleItem: {
+        os_ << "  {\n"
+            << "    ADT tuple = " << Reg(instr.tuple) << ".AsObjectRef<ADT>();\n"
+            << "    ICHECK_LT(" << instr.item_index << "U, tuple.size()) << \"IndexError: tuple "
+            << "index " << instr.item_index << " is out of range\";\n"
+            << "    " << Reg(instr.dst) << " = tuple[" << instr.item_index << "];\n"
+            << "  }\n";
+        break;
+      }
+      case Opcode::Kill: {
+        for (Index i = 0; i < instr.num_regs; ++i) {
+          os_ << "  " << Reg(instr.regs[i]) << " = TVMRetValue();\n";
+        }
+        break;
+      }
+      case Opcode::Ret: {
+        os_ << "  *rv = " << Reg(instr.result) << ";\n"
+            << "  return;\n";
+        break;
+      }
+      case Opcode::Goto: {
+        os_ << "  goto L" << local_pc + instr.pc_offset << ";\n";
+        break;
+      }
+      case Opcode::If: {
+        ICHECK_GT(instr.false_offset, 1);
+        os_ << "  if (ctx->load_scalar_int(ctx->vm, " << Reg(instr.cond) << ") == 0) goto L"
+            << local_pc + instr.false_offset << ";\n";
+        break;
+      }
+      default:
+        LOG(FATAL) << "ValueError: Cannot compile the opcode " << static_cast<int>(instr.op);
+    }
+  }
+
+  void GenerateCall(const Instruction& instr) {
+    os_ << "  {\n"
+        << "    // " << exec_->func_names[instr.func_idx] << "\n";
+    for (Index i = 0; i < instr.num_args; ++i) {
+      Instruction::Arg arg = instr.args[i];
+      os_ << "    setter(" << i << ", ";
+      if (arg.kind() == Instruction::kImmediate) {
+        os_ << "static_cast<int64_t>(" << arg.value() << "LL)";
+      } else if (arg.kind() == Instruction::kRegister && arg.value() == Instruction::kVMRegister) {
+        os_ << "ctx->vm";
+      } else {
+        os_ << Value(arg);
+      }
+      os_ << ");\n";
+    }
+    // the callee may read the registers it is passed after setting its return value
+    os_ << "    TVMRetValue ret;\n"
+        << "    ctx->get_func(ctx->vm, " << instr.func_idx << ")->CallPacked(TVMArgs(values, "
+        << "tcodes, " << instr.num_args << "), &ret);\n";
+    if (instr.dst != Instruction::kVoidArg) {
+      os_ << "    " << Reg(instr.dst) << " = std::move(ret);\n";
+    }
+    os_ << "  }\n";
+  }
+
+  void GenerateLoadShape(RegName heap, const std::vector<ExecWord>& indices, RegName dst) {
+    os_ << "  {\n"
+        << "    const int64_t* heap = CompiledShapeHeap(" << Reg(heap) << ", "
+        << HeapSize(indices.data(), indices.size()) << ");\n"
+        << "    " << Reg(dst) << " = ShapeTuple(std::vector<int64_t>{";
+    for (size_t i = 0; i < indices.size(); ++i) {
+      os_ << (i == 0 ? "" : ", ") << "heap[" << indices[i] << "]";
+    }
+    os_ << "});\n"
+        << "  }\n";
+  }
+
+  /*!
+   * \brief Unroll the stack program of a ComputeShape instruction into integer arithmetic, each
+   * loaded or computed value being a local.
+   */
+  void GenerateComputeShape(const Instruction& instr) {
+    std::vector<ExecWord> slots;
+    for (Index i = 0; i < instr.heap_num_args; i += 2) {
+      ShapeOp op = static_cast<ShapeOp>(instr.heap_args[i]);
+      if (op == ShapeOp::kLoad || op == ShapeOp::kStore) slots.push_back(instr.heap_args[i + 1]);
+    }
+    os_ << "  {\n"
+        << "    int64_t* heap = CompiledShapeHeap(" << Reg(instr.heap) << ", "
+        << HeapSize(slots.data(), slots.size()) << ");\n";
+    std::vector<std::string> stack;
+    int num_temps = 0;
+    auto new_temp = [&](const std::string& value) {
+      std::string temp = "t" + std::to_string(num_temps++);
+      os_ << "    const int64_t " << temp << " = " << value << ";\n";
+      stack.push_back(temp);
+    };
+    for (Index i = 0; i < instr.heap_num_args; i += 2) {
+      ShapeOp op = static_cast<ShapeOp>(instr.heap_args[i]);
+      ExecWord operand = instr.heap_args[i + 1];
+      if (op == ShapeOp::kLoad) {
+        new_temp("heap[" + std::to_string(operand) + "]");
+        continue;
+      } else if (op == ShapeOp::kImm) {
+        new_temp("static_cast<int64_t>(" + std::to_string(operand) + "LL)");
+        continue;
+      } else if (op == ShapeOp::kStore) {
+        ICHECK(!stack.empty()) << "Malformed shape program";
+        os_ << "    heap[" << operand << "] = " << stack.back() << ";\n";
+        stack.pop_back();
+        continue;
+      }
+      ICHECK_GE(stack.size(), 2) << "Malformed shape program";
+      std::string rhs = stack.back();
+      stack.pop_back();
+      std::string lhs = stack.back();
+      stack.pop_back();
+      switch (op) {
+        case ShapeOp::kAdd:
+          new_temp(lhs + " + " + rhs);
+          break;
+        case ShapeOp::kSub:
+          new_temp(lhs + " - " + rhs);
+          break;
+        case ShapeOp::kMul:
+          new_temp(lhs + " * " + rhs);
+          break;
+        case ShapeOp::kDiv:
+          new_temp("CompiledShapeDiv(" + lhs + ", " + rhs + ")");
+          break;
+        case ShapeOp::kMod:
+          new_temp("CompiledShapeMod(" + lhs + ", " + rhs + ")");
+          break;
+        case ShapeOp::kFloorDiv:
+          new_temp("CompiledShapeFloorDiv(" + lhs + ", " + rhs + ")");
+          break;
+        case ShapeOp::kFloorMod:
+          new_temp("CompiledShapeFloorMod(" + lhs + ", " + rhs + ")");
+          break;
+        case ShapeOp::kMin:
+          new_temp(lhs + " < " + rhs + " ? " + lhs + " : " + rhs);
+          break;
+        case ShapeOp::kMax:
+          new_temp(lhs + " > " + rhs + " ? " + lhs + " : " + rhs);
+          break;
+        default:
+          LOG(FATAL) << "ValueError: Unknown shape operation: " << static_cast<int>(op);
+      }
+    }
+    os_ << "  }\n";
+  }
+
+  /*! \brief The number of heap slots needed by a set of accesses. */
+  static Index HeapSize(const ExecWord* indices, size_t num_indices) {
+    ExecWord size = 0;
+    for (size_t i = 0; i < num_indices; ++i) {
+      ICHECK_GE(indices[i], 0) << "Negative shape heap index";
+      size = std::max(size, indices[i] + 1);
+    }
+    return size;
+  }
+
+  static std::string Reg(RegName reg) { return "r[" + std::to_string(reg) + "]"; }
+
+  /*! \brief The expression of the value of a register or constant argument. */
+  static std::string Value(Instruction::Arg arg) {
+    if (arg.kind() == Instruction::kConstIdx) {
+      return "(*ctx->get_constant(ctx->vm, " + std::to_string(arg.value()) + "))";
+    }
+    ICHECK_EQ(arg.kind(), Instruction::kRegister);
+    return Reg(arg.value());
+  }
+
+  /*! \brief The executable. */
+  const Executable* exec_;
+  /*! \brief The generated source. */
+  std::ostringstream os_;
+};
+
+/*!
+ * \brief Compile the bytecode of the Relax functions of an executable into a C++ source module.
+ * \param exec_mod The executable.
+ * \param system_lib Whether to register the compiled functions in the system library.
+ * \return The source module, to be imported by the kernel library of the executable.
+ */
+runtime::Module CompileBytecode(runtime::Module exec_mod, bool system_lib) {
+  CHECK_EQ(exec_mod->type_key(), std::string("relax.Executable"))
+      << "ValueError: Expect a Relax VM executable, but gets " << exec_mod->type_key();
+  const Executable* exec = static_cast<const Executable*>(exec_mod.operator->());
+  Array<String> symbols;
+  std::string code = CodeGenVMCpp(exec).Generate(system_lib, &symbols);
+  return codegen::CSourceModuleCreate(code, "cc", symbols, {});
+}
+
+TVM_REGISTER_GLOBAL("relax.VMCompileBytecode").set_body_typed(CompileBytecode);
+
+}  // namespace relax_vm
+}  // namespace relax
+}  // namespace tvm
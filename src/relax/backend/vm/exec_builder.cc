@@ -22,6 +22,9 @@
  */
 #include <tvm/relax/exec_builder.h>
 
+#include <algorithm>
+#include <functional>
+#include <queue>
 #include <sstream>
 
 namespace tvm {
@@ -37,9 +40,10 @@ ExecBuilder ExecBuilderNode::Create() {
   return ret;
 }
 
-vm::Index ExecBuilderNode::EmitConstant(TVMRetValue obj) {
+vm::Index ExecBuilderNode::EmitConstant(TVMRetValue obj, vm::Index device_index) {
   vm::Index idx = exec->constants.size();
   exec->constants.push_back(obj);
+  exec->constant_devices.push_back(device_index);
   return vm::Instruction::Arg(vm::Instruction::kConstIdx, idx).data;
 }
 
@@ -60,13 +64,20 @@ void ExecBuilderNode::EmitFunction(std::string func_name, int64_t num_inputs,
   exec->global_funcs.push_back(vmfunc);
 }
 
+vm::Index ExecBuilderNode::DeclarePackedFunc(const std::string& func) {
+  auto it = exec->func2idx.find(func);
+  if (it != exec->func2idx.end()) {
+    return it->second;
+  }
+  Index func_idx = exec->func_names.size();
+  exec->func2idx[func] = func_idx;
+  exec->func_names.push_back(func);
+  return func_idx;
+}
+
 void ExecBuilderNode::EmitCall(std::string func, std::vector<Instruction::Arg> args, RegName dst) {
   // store function
-  if (exec->func2idx.find(func) == exec->func2idx.end()) {
-    exec->func2idx[func] = exec->func_names.size();
-    exec->func_names.push_back(func);
-  }
-  Index func_idx = exec->func2idx[func];
+  Index func_idx = this->DeclarePackedFunc(func);
   // store instruction
   exec->instr_offset.push_back(exec->instr_data.size());
   exec->instr_data.push_back(static_cast<ExecWord>(Opcode::Call));
@@ -97,6 +108,78 @@ void ExecBuilderNode::EmitIf(vm::RegName cond, vm::Index false_offset) {
   exec->instr_data.push_back(false_offset);
 }
 
+void ExecBuilderNode::EmitLoadShape(RegName heap, std::vector<Index> indices, RegName dst) {
+  exec->instr_offset.push_back(exec->instr_data.size());
+  exec->instr_data.push_back(static_cast<ExecWord>(Opcode::LoadShape));
+  exec->instr_data.push_back(dst);
+  exec->instr_data.push_back(heap);
+  exec->instr_data.push_back(Instruction::kVoidArg);
+  exec->instr_data.push_back(indices.size());
+  exec->instr_data.insert(exec->instr_data.end(), indices.begin(), indices.end());
+}
+
+void ExecBuilderNode::EmitStoreShape(RegName shape, RegName heap, std::vector<Index> indices) {
+  exec->instr_offset.push_back(exec->instr_data.size());
+  exec->instr_data.push_back(static_cast<ExecWord>(Opcode::StoreShape));
+  exec->instr_data.push_back(Instruction::kVoidArg);
+  exec->instr_data.push_back(heap);
+  exec->instr_data.push_back(shape);
+  exec->instr_data.push_back(indices.size());
+  exec->instr_data.insert(exec->instr_data.end(), indices.begin(), indices.end());
+}
+
+void ExecBuilderNode::EmitComputeShape(RegName heap, std::vector<ExecWord> program) {
+  ICHECK_EQ(program.size() % 2, 0) << "The shape program must be (operation, operand) pairs";
+  exec->instr_offset.push_back(exec->instr_data.size());
+  exec->instr_data.push_back(static_cast<ExecWord>(Opcode::ComputeShape));
+  exec->instr_data.push_back(Instruction::kVoidArg);
+  exec->instr_data.push_back(heap);
+  exec->instr_data.push_back(Instruction::kVoidArg);
+  exec->instr_data.push_back(program.size());
+  exec->instr_data.insert(exec->instr_data.end(), program.begin(), program.end());
+}
+
+void ExecBuilderNode::EmitMove(RegName src, RegName dst) {
+  exec->instr_offset.push_back(exec->instr_data.size());
+  exec->instr_data.push_back(static_cast<ExecWord>(Opcode::Move));
+  exec->instr_data.push_back(dst);
+  exec->instr_data.push_back(src);
+}
+
+void ExecBuilderNode::EmitLoadConst(Index const_idx, RegName dst) {
+  exec->instr_offset.push_back(exec->instr_data.size());
+  exec->instr_data.push_back(static_cast<ExecWord>(Opcode::LoadConst));
+  exec->instr_data.push_back(dst);
+  // EmitConstant returns the index tagged as a constant argument
+  exec->instr_data.push_back(Instruction::Arg(const_idx).value());
+}
+
+void ExecBuilderNode::EmitMakeTuple(std::vector<Instruction::Arg> fields, RegName dst) {
+  exec->instr_offset.push_back(exec->instr_data.size());
+  exec->instr_data.push_back(static_cast<ExecWord>(Opcode::MakeTuple));
+  exec->instr_data.push_back(dst);
+  exec->instr_data.push_back(fields.size());
+  for (Instruction::Arg field : fields) {
+    ICHECK_NE(field.kind(), Instruction::kImmediate) << "A tuple field cannot be an immediate";
+    exec->instr_data.push_back(field.data);
+  }
+}
+
+void ExecBuilderNode::EmitGetTupleItem(RegName tuple, Index index, RegName dst) {
+  exec->instr_offset.push_back(exec->instr_data.size());
+  exec->instr_data.push_back(static_cast<ExecWord>(Opcode::GetTupleItem));
+  exec->instr_data.push_back(dst);
+  exec->instr_data.push_back(tuple);
+  exec->instr_data.push_back(index);
+}
+
+void ExecBuilderNode::EmitKill(std::vector<RegName> regs) {
+  exec->instr_offset.push_back(exec->instr_data.size());
+  exec->instr_data.push_back(static_cast<ExecWord>(Opcode::Kill));
+  exec->instr_data.push_back(regs.size());
+  exec->instr_data.insert(exec->instr_data.end(), regs.begin(), regs.end());
+}
+
 void ExecBuilderNode::CheckExecutable() {
   for (auto it = exec->global_funcs.cbegin(); it != exec->global_funcs.cend(); ++it) {
     Index num_inputs = it->num_args;
@@ -146,6 +229,57 @@ void ExecBuilderNode::CheckExecutable() {
           arg_registers.emplace(instr.cond);
           break;
         }
+        case Opcode::LoadShape:
+        case Opcode::StoreShape:
+        case Opcode::ComputeShape: {
+          std::vector<RegName> uses{instr.heap};
+          if (instr.op == Opcode::StoreShape) uses.push_back(instr.shape);
+          for (RegName reg : uses) {
+            if (reg >= num_inputs && dst_registers.find(reg) == dst_registers.end()) {
+              LOG(FATAL) << "register r(" << reg << ") in VM function \"" << it->name
+                         << "\" is used as input while the number of inputs is only "
+                         << num_inputs << ".\n";
+            }
+            arg_registers.emplace(reg);
+          }
+          if (instr.dst != Instruction::kVoidArg) {
+            dst_registers.emplace(instr.dst);
+          }
+          break;
+        }
+        case Opcode::Move:
+        case Opcode::LoadConst:
+        case Opcode::MakeTuple:
+        case Opcode::GetTupleItem: {
+          std::vector<RegName> uses;
+          if (instr.op == Opcode::Move) uses.push_back(instr.src);
+          if (instr.op == Opcode::GetTupleItem) uses.push_back(instr.tuple);
+          if (instr.op == Opcode::MakeTuple) {
+            for (Index i = 0; i < instr.num_fields; ++i) {
+              if (instr.fields[i].kind() == Instruction::kRegister) {
+                uses.push_back(instr.fields[i].value());
+              }
+            }
+          }
+          for (RegName reg : uses) {
+            if (reg >= num_inputs && dst_registers.find(reg) == dst_registers.end()) {
+              LOG(FATAL) << "register r(" << reg << ") in VM function \"" << it->name
+                         << "\" is used as input while the number of inputs is only "
+                         << num_inputs << ".\n";
+            }
+            arg_registers.emplace(reg);
+          }
+          dst_registers.emplace(instr.dst);
+          break;
+        }
+        case Opcode::Kill: {
+          break;
+        }
+        case Opcode::AllocStorageTensor:
+        case Opcode::LoadShapeCall: {
+          // fused after the registers are checked and formalized
+          break;
+        }
         default:
           LOG(FATAL) << "should never hit this case: " << static_cast<int>(instr.op);
           break;
@@ -199,6 +333,64 @@ void ExecBuilderNode::Formalize() {
         case Opcode::If: {
           break;
         }
+        case Opcode::LoadShape:
+        case Opcode::StoreShape:
+        case Opcode::ComputeShape: {
+          // the heap, shape and dst registers are at offset 2, 3 and 1 of the instruction
+          Index offset = this->exec->instr_offset[idx];
+          for (Index pos : {2, 3}) {
+            RegName reg = this->exec->instr_data[offset + pos];
+            if (register_map.find(reg) != register_map.end()) {
+              this->exec->instr_data[offset + pos] = register_map[reg];
+            }
+          }
+          if (instr.dst != Instruction::kVoidArg && instr.dst >= num_inputs &&
+              register_map.find(instr.dst) == register_map.end()) {
+            this->exec->instr_data[offset + 1] = register_idx;
+            register_map[instr.dst] = register_idx++;
+          }
+          break;
+        }
+        case Opcode::Move:
+        case Opcode::LoadConst:
+        case Opcode::MakeTuple:
+        case Opcode::GetTupleItem: {
+          // the dst register is at offset 1, followed by the source or tuple register at
+          // offset 2, or by the number of fields at offset 2 and the fields
+          Index offset = this->exec->instr_offset[idx];
+          std::vector<Index> positions;
+          if (instr.op == Opcode::Move || instr.op == Opcode::GetTupleItem) {
+            positions.push_back(2);
+          } else if (instr.op == Opcode::MakeTuple) {
+            for (Index i = 0; i < instr.num_fields; ++i) {
+              if (instr.fields[i].kind() == Instruction::kRegister) positions.push_back(3 + i);
+            }
+          }
+          for (Index pos : positions) {
+            Instruction::Arg arg(this->exec->instr_data[offset + pos]);
+            if (register_map.find(arg.value()) != register_map.end()) {
+              this->exec->instr_data[offset + pos] = register_map[arg.value()];
+            }
+          }
+          if (instr.dst >= num_inputs && register_map.find(instr.dst) == register_map.end()) {
+            this->exec->instr_data[offset + 1] = register_idx;
+            register_map[instr.dst] = register_idx++;
+          }
+          break;
+        }
+        case Opcode::Kill: {
+          Index offset = this->exec->instr_offset[idx];
+          for (Index i = 0; i < instr.num_regs; ++i) {
+            if (register_map.find(instr.regs[i]) != register_map.end()) {
+              this->exec->instr_data[offset + 2 + i] = register_map[instr.regs[i]];
+            }
+          }
+          break;
+        }
+        case Opcode::AllocStorageTensor:
+        case Opcode::LoadShapeCall: {
+          break;
+        }
         default:
           LOG(FATAL) << "should never hit this case: " << static_cast<int>(instr.op);
           break;
@@ -208,13 +400,316 @@ void ExecBuilderNode::Formalize() {
   }
 }
 
+void ExecBuilderNode::FuseInstructions() {
+  auto lookup = [this](const std::string& name) -> Index {
+    auto it = exec->func2idx.find(name);
+    return it == exec->func2idx.end() ? -1 : it->second;
+  };
+  Index alloc_storage_idx = lookup("vm.builtin.alloc_storage");
+  Index alloc_tensor_idx = lookup("vm.builtin.alloc_tensor");
+  Index load_shape_idx = lookup("vm.builtin.load_shape");
+
+  size_t num_instrs = exec->instr_offset.size();
+  // An instruction that starts a function or is jumped to cannot be fused into its predecessor.
+  std::vector<bool> is_entry(num_instrs + 1, false);
+  for (const VMFunction& func : exec->global_funcs) {
+    is_entry[func.start_instr] = true;
+  }
+  for (size_t i = 0; i < num_instrs; ++i) {
+    Instruction instr = exec->GetInstruction(i);
+    if (instr.op == Opcode::Goto) {
+      is_entry[i + instr.pc_offset] = true;
+    } else if (instr.op == Opcode::If) {
+      is_entry[i + 1] = true;
+      is_entry[i + instr.false_offset] = true;
+    }
+  }
+
+  auto is_call_to = [](const Instruction& instr, Index func_idx) {
+    return func_idx != -1 && instr.op == Opcode::Call && instr.func_idx == func_idx;
+  };
+  auto is_register = [](Instruction::Arg arg) {
+    return arg.kind() == Instruction::kRegister && arg.value() != Instruction::kVMRegister;
+  };
+  // alloc_storage(vm, size, device_index, dtype_hint) -> alloc_tensor(storage, offset, shape, dtype)
+  auto can_fuse_alloc = [&](size_t i) {
+    if (i + 1 >= num_instrs || is_entry[i + 1]) return false;
+    Instruction storage = exec->GetInstruction(i);
+    Instruction tensor = exec->GetInstruction(i + 1);
+    if (!is_call_to(storage, alloc_storage_idx) || !is_call_to(tensor, alloc_tensor_idx) ||
+        storage.num_args != 4 || tensor.num_args != 4 || storage.dst == Instruction::kVoidArg) {
+      return false;
+    }
+    return storage.args[0].kind() == Instruction::kRegister &&
+           storage.args[0].value() == Instruction::kVMRegister &&
+           storage.args[1].kind() != Instruction::kImmediate &&
+           storage.args[2].kind() == Instruction::kImmediate &&
+           storage.args[3].kind() == Instruction::kConstIdx && is_register(tensor.args[0]) &&
+           tensor.args[0].value() == storage.dst &&
+           tensor.args[1].kind() == Instruction::kImmediate &&
+           tensor.args[2].kind() != Instruction::kImmediate &&
+           tensor.args[3].kind() == Instruction::kConstIdx;
+  };
+  // load_shape(heap, indices) -> a call that takes the loaded shape
+  auto can_fuse_load = [&](size_t i) {
+    if (i + 1 >= num_instrs || is_entry[i + 1]) return false;
+    Instruction load = exec->GetInstruction(i);
+    Instruction call = exec->GetInstruction(i + 1);
+    if (!is_call_to(load, load_shape_idx) || call.op != Opcode::Call || load.num_args != 2 ||
+        load.dst == Instruction::kVoidArg || !is_register(load.args[0]) ||
+        load.args[1].kind() != Instruction::kConstIdx) {
+      return false;
+    }
+    return std::any_of(call.args, call.args + call.num_args, [&](Instruction::Arg arg) {
+      return arg.kind() == Instruction::kRegister && arg.value() == load.dst;
+    });
+  };
+
+  std::vector<Index> new_index(num_instrs + 1);
+  std::vector<Index> instr_offset;
+  std::vector<ExecWord> instr_data;
+  for (size_t i = 0; i < num_instrs; ++i) {
+    new_index[i] = instr_offset.size();
+    instr_offset.push_back(instr_data.size());
+    Instruction instr = exec->GetInstruction(i);
+    if (can_fuse_alloc(i)) {
+      Instruction tensor = exec->GetInstruction(i + 1);
+      instr_data.push_back(static_cast<ExecWord>(Opcode::AllocStorageTensor));
+      instr_data.push_back(tensor.dst);
+      instr_data.push_back(instr.dst);
+      for (int j = 1; j < 4; ++j) instr_data.push_back(instr.args[j].data);
+      for (int j = 1; j < 4; ++j) instr_data.push_back(tensor.args[j].data);
+      new_index[i + 1] = new_index[i];
+      ++i;
+    } else if (!can_fuse_alloc(i + 1) && can_fuse_load(i)) {
+      // an alloc_storage consuming the shape is left to be fused with its alloc_tensor
+      Instruction call = exec->GetInstruction(i + 1);
+      instr_data.push_back(static_cast<ExecWord>(Opcode::LoadShapeCall));
+      instr_data.push_back(call.dst);
+      instr_data.push_back(call.func_idx);
+      instr_data.push_back(call.num_args);
+      for (Index j = 0; j < call.num_args; ++j) instr_data.push_back(call.args[j].data);
+      instr_data.push_back(Instruction::Arg(Instruction::kRegister, instr.dst).data);
+      instr_data.push_back(instr.args[0].data);
+      instr_data.push_back(instr.args[1].data);
+      new_index[i + 1] = new_index[i];
+      ++i;
+    } else {
+      size_t begin = exec->instr_offset[i];
+      size_t end = i + 1 < num_instrs ? exec->instr_offset[i + 1] : exec->instr_data.size();
+      instr_data.insert(instr_data.end(), exec->instr_data.begin() + begin,
+                        exec->instr_data.begin() + end);
+    }
+  }
+  new_index[num_instrs] = instr_offset.size();
+  this->ReplaceInstructions(new_index, std::move(instr_offset), std::move(instr_data));
+}
+
+void ExecBuilderNode::ReplaceInstructions(const std::vector<Index>& new_index,
+                                          std::vector<Index> instr_offset,
+                                          std::vector<ExecWord> instr_data) {
+  // Recompute the jump offsets and function entries in terms of the new instructions.
+  for (size_t i = 0; i + 1 < new_index.size(); ++i) {
+    Instruction instr = exec->GetInstruction(i);
+    if (instr.op == Opcode::Goto) {
+      instr_data[instr_offset[new_index[i]] + 1] = new_index[i + instr.pc_offset] - new_index[i];
+    } else if (instr.op == Opcode::If) {
+      instr_data[instr_offset[new_index[i]] + 2] =
+          new_index[i + instr.false_offset] - new_index[i];
+    }
+  }
+  for (VMFunction& func : exec->global_funcs) {
+    func.start_instr = new_index[func.start_instr];
+  }
+  exec->instr_offset = std::move(instr_offset);
+  exec->instr_data = std::move(instr_data);
+}
+
+/*!
+ * \brief Visit the register operands of an instruction in place.
+ * \param instr The instruction.
+ * \param words The words of the instruction in the instruction data.
+ * \param fvisit The visitor, called with the word holding each register and whether the register
+ *  is defined rather than used by the instruction.
+ */
+template <typename FVisit>
+void ForEachRegister(const Instruction& instr, ExecWord* words, FVisit fvisit) {
+  auto visit_reg = [&](ExecWord* word, bool is_def) {
+    if (*word != Instruction::kVoidArg) fvisit(word, is_def);
+  };
+  // a register argument is encoded as the register itself
+  auto visit_arg = [&](ExecWord* word, bool is_def) {
+    Instruction::Arg arg(*word);
+    if (arg.kind() == Instruction::kRegister && arg.value() != Instruction::kVMRegister) {
+      visit_reg(word, is_def);
+    }
+  };
+  switch (instr.op) {
+    case Opcode::Call:
+    case Opcode::LoadShapeCall: {
+      for (Index i = 0; i < instr.num_args; ++i) visit_arg(words + 4 + i, false);
+      if (instr.op == Opcode::LoadShapeCall) {
+        visit_arg(words + 4 + instr.num_args, true);
+        visit_arg(words + 5 + instr.num_args, false);
+      }
+      visit_reg(words + 1, true);
+      break;
+    }
+    case Opcode::Ret:
+    case Opcode::If: {
+      visit_reg(words + 1, false);
+      break;
+    }
+    case Opcode::Goto: {
+      break;
+    }
+    case Opcode::AllocStorageTensor: {
+      for (Index i = 0; i < Instruction::kNumAllocArgs; ++i) visit_arg(words + 3 + i, false);
+      visit_reg(words + 2, true);
+      visit_reg(words + 1, true);
+      break;
+    }
+    case Opcode::LoadShape:
+    case Opcode::StoreShape:
+    case Opcode::ComputeShape: {
+      visit_reg(words + 2, false);
+      visit_reg(words + 3, false);
+      visit_reg(words + 1, true);
+      break;
+    }
+    case Opcode::Move:
+    case Opcode::GetTupleItem: {
+      visit_reg(words + 2, false);
+      visit_reg(words + 1, true);
+      break;
+    }
+    case Opcode::LoadConst: {
+      visit_reg(words + 1, true);
+      break;
+    }
+    case Opcode::MakeTuple: {
+      for (Index i = 0; i < instr.num_fields; ++i) visit_arg(words + 3 + i, false);
+      visit_reg(words + 1, true);
+      break;
+    }
+    case Opcode::Kill: {
+      for (Index i = 0; i < instr.num_regs; ++i) visit_reg(words + 2 + i, false);
+      break;
+    }
+    default:
+      LOG(FATAL) << "should never hit this case: " << static_cast<int>(instr.op);
+  }
+}
+
+void ExecBuilderNode::AllocateRegisters() {
+  size_t num_instrs = exec->instr_offset.size();
+  auto words = [this](size_t i) { return exec->instr_data.data() + exec->instr_offset[i]; };
+  std::vector<size_t> starts;
+  for (const VMFunction& func : exec->global_funcs) {
+    starts.push_back(func.start_instr);
+  }
+  std::sort(starts.begin(), starts.end());
+  // the registers released after each instruction
+  std::vector<std::vector<RegName>> kills(num_instrs);
+
+  for (VMFunction& func : exec->global_funcs) {
+    size_t begin = func.start_instr;
+    auto next = std::upper_bound(starts.begin(), starts.end(), begin);
+    size_t end = next == starts.end() ? num_instrs : *next;
+    // When the jumps only go forward, every point a register is live at lies between the first
+    // instruction defining it and the last one using it, so these spans are its live range.
+    bool jumps_forward = true;
+    for (size_t i = begin; i < end; ++i) {
+      Instruction instr = exec->GetInstruction(i);
+      if ((instr.op == Opcode::Goto && instr.pc_offset <= 0) ||
+          (instr.op == Opcode::If && instr.false_offset <= 0)) {
+        jumps_forward = false;
+      }
+    }
+    if (!jumps_forward) continue;
+
+    // The inputs keep their registers, which are set by the caller.
+    Index num_inputs = func.num_args;
+    std::unordered_map<RegName, std::pair<size_t, size_t>> ranges;
+    for (size_t i = begin; i < end; ++i) {
+      ForEachRegister(exec->GetInstruction(i), words(i), [&](ExecWord* word, bool is_def) {
+        if (*word < num_inputs) return;
+        auto it = ranges.emplace(*word, std::make_pair(i, i)).first;
+        it->second.second = i;
+      });
+    }
+    std::vector<std::pair<size_t, RegName>> order;
+    for (const auto& kv : ranges) {
+      order.emplace_back(kv.second.first, kv.first);
+    }
+    std::sort(order.begin(), order.end());
+
+    // Linear scan: a register is reused once the live range holding it has ended, and not at the
+    // instruction it ends at, whose destination may then be released by the Kill after it.
+    using LiveRange = std::pair<size_t, RegName>;
+    std::priority_queue<LiveRange, std::vector<LiveRange>, std::greater<LiveRange>> active;
+    std::priority_queue<RegName, std::vector<RegName>, std::greater<RegName>> free_regs;
+    std::unordered_map<RegName, RegName> reg_map;
+    RegName num_regs = num_inputs;
+    for (const auto& item : order) {
+      size_t first = item.first;
+      size_t last = ranges[item.second].second;
+      while (!active.empty() && active.top().first < first) {
+        free_regs.push(active.top().second);
+        active.pop();
+      }
+      RegName reg = num_regs;
+      if (free_regs.empty()) {
+        ++num_regs;
+      } else {
+        reg = free_regs.top();
+        free_regs.pop();
+      }
+      reg_map[item.second] = reg;
+      active.emplace(last, reg);
+      // the frame is released on return, and a Kill after an If only runs on the true branch
+      if (exec->GetInstruction(last).op != Opcode::Ret) {
+        kills[last].push_back(reg);
+      }
+    }
+    for (size_t i = begin; i < end; ++i) {
+      ForEachRegister(exec->GetInstruction(i), words(i), [&](ExecWord* word, bool is_def) {
+        if (*word >= num_inputs) *word = reg_map.at(*word);
+      });
+    }
+    func.register_file_size = num_regs;
+  }
+
+  std::vector<Index> new_index(num_instrs + 1);
+  std::vector<Index> instr_offset;
+  std::vector<ExecWord> instr_data;
+  for (size_t i = 0; i < num_instrs; ++i) {
+    new_index[i] = instr_offset.size();
+    instr_offset.push_back(instr_data.size());
+    size_t begin = exec->instr_offset[i];
+    size_t end = i + 1 < num_instrs ? exec->instr_offset[i + 1] : exec->instr_data.size();
+    instr_data.insert(instr_data.end(), exec->instr_data.begin() + begin,
+                      exec->instr_data.begin() + end);
+    if (!kills[i].empty()) {
+      std::sort(kills[i].begin(), kills[i].end());
+      instr_offset.push_back(instr_data.size());
+      instr_data.push_back(static_cast<ExecWord>(Opcode::Kill));
+      instr_data.push_back(kills[i].size());
+      instr_data.insert(instr_data.end(), kills[i].begin(), kills[i].end());
+    }
+  }
+  new_index[num_instrs] = instr_offset.size();
+  this->ReplaceInstructions(new_index, std::move(instr_offset), std::move(instr_data));
+}
+
 TVM_REGISTER_GLOBAL("relax.ExecBuilderCreate").set_body_typed(ExecBuilderNode::Create);
 
 TVM_REGISTER_GLOBAL("relax.ExecBuilderEmitConstant").set_body([](TVMArgs args, TVMRetValue* ret) {
   ExecBuilder builder = args[0];
   TVMRetValue rt;
   rt = args[1];
-  *ret = builder->EmitConstant(rt);
+  vm::Index device_index = args.size() > 2 ? args[2].operator int64_t() : 0;
+  *ret = builder->EmitConstant(rt, device_index);
 });
 
 TVM_REGISTER_GLOBAL("relax.ExecBuilderFunction")
@@ -240,6 +735,69 @@ TVM_REGISTER_GLOBAL("relax.ExecBuilderEmitGoto")
 TVM_REGISTER_GLOBAL("relax.ExecBuilderEmitIf")
     .set_body_method<ExecBuilder>(&ExecBuilderNode::EmitIf);
 
+TVM_REGISTER_GLOBAL("relax.ExecBuilderEmitLoadShape")
+    .set_body_typed([](ExecBuilder builder, int64_t heap, Array<IntImm> indices, int64_t dst) {
+      std::vector<Index> indices_;
+      for (const IntImm& index : indices) {
+        indices_.push_back(index->value);
+      }
+      builder->EmitLoadShape(Instruction::Arg(heap).value(), indices_,
+                             Instruction::Arg(dst).value());
+    });
+
+TVM_REGISTER_GLOBAL("relax.ExecBuilderEmitStoreShape")
+    .set_body_typed([](ExecBuilder builder, int64_t shape, int64_t heap, Array<IntImm> indices) {
+      std::vector<Index> indices_;
+      for (const IntImm& index : indices) {
+        indices_.push_back(index->value);
+      }
+      builder->EmitStoreShape(Instruction::Arg(shape).value(), Instruction::Arg(heap).value(),
+                              indices_);
+    });
+
+TVM_REGISTER_GLOBAL("relax.ExecBuilderEmitComputeShape")
+    .set_body_typed([](ExecBuilder builder, int64_t heap, Array<IntImm> program) {
+      std::vector<ExecWord> program_;
+      for (const IntImm& word : program) {
+        program_.push_back(word->value);
+      }
+      builder->EmitComputeShape(Instruction::Arg(heap).value(), program_);
+    });
+
+TVM_REGISTER_GLOBAL("relax.ExecBuilderEmitMove")
+    .set_body_typed([](ExecBuilder builder, int64_t src, int64_t dst) {
+      builder->EmitMove(Instruction::Arg(src).value(), Instruction::Arg(dst).value());
+    });
+
+TVM_REGISTER_GLOBAL("relax.ExecBuilderEmitLoadConst")
+    .set_body_typed([](ExecBuilder builder, int64_t const_idx, int64_t dst) {
+      builder->EmitLoadConst(const_idx, Instruction::Arg(dst).value());
+    });
+
+TVM_REGISTER_GLOBAL("relax.ExecBuilderEmitMakeTuple")
+    .set_body_typed([](ExecBuilder builder, Array<IntImm> fields, int64_t dst) {
+      std::vector<Instruction::Arg> fields_;
+      for (const IntImm& field : fields) {
+        fields_.push_back(Instruction::Arg(field->value));
+      }
+      builder->EmitMakeTuple(fields_, Instruction::Arg(dst).value());
+    });
+
+TVM_REGISTER_GLOBAL("relax.ExecBuilderEmitGetTupleItem")
+    .set_body_typed([](ExecBuilder builder, int64_t tuple, int64_t index, int64_t dst) {
+      builder->EmitGetTupleItem(Instruction::Arg(tuple).value(), index,
+                                Instruction::Arg(dst).value());
+    });
+
+TVM_REGISTER_GLOBAL("relax.ExecBuilderEmitKill")
+    .set_body_typed([](ExecBuilder builder, Array<IntImm> regs) {
+      std::vector<RegName> regs_;
+      for (const IntImm& reg : regs) {
+        regs_.push_back(Instruction::Arg(reg->value).value());
+      }
+      builder->EmitKill(regs_);
+    });
+
 TVM_REGISTER_GLOBAL("relax.ExecBuilderR").set_body_typed([](ExecBuilder builder, int64_t value) {
   return Instruction::Arg(Instruction::kRegister, value).data;
 });
@@ -257,5 +815,11 @@ TVM_REGISTER_GLOBAL("relax.ExecBuilderGet").set_body_typed([](ExecBuilder builde
   return runtime::Module(p_exec);
 });
 
+TVM_REGISTER_GLOBAL("relax.ExecBuilderFuseInstructions")
+    .set_body_method<ExecBuilder>(&ExecBuilderNode::FuseInstructions);
+
+TVM_REGISTER_GLOBAL("relax.ExecBuilderAllocateRegisters")
+    .set_body_method<ExecBuilder>(&ExecBuilderNode::AllocateRegisters);
+
 }  // namespace relax
 }  // namespace tvm
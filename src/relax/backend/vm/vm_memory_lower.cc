@@ -20,17 +20,490 @@
  * \file src/relax/backend/vm/vm_memory_lower.cc
  * \brief Perform memory lowering. Lowers the relax.builtin.alloc_tensor intrinsic to VM intrinsics.
  */
+#include <tvm/arith/analyzer.h>
+#include <tvm/ir/memory_pools.h>
 #include <tvm/relax/attrs/memory.h>
 #include <tvm/relax/backend.h>
 #include <tvm/relax/expr_functor.h>
 #include <tvm/relax/type.h>
+#include <tvm/runtime/registry.h>
 #include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/usmp/utils.h>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "../../../relay/transforms/pattern_utils.h"
 
 namespace tvm {
 namespace relax {
 
+// ==================
+// StaticMemoryPlanner
+// Assign the tensors allocated by relax.builtin.alloc_tensor in a SeqExpr to shared storage.
+//
+// The bindings of the SeqExpr are numbered in order, and a tensor is live from its allocation
+// until the last binding that uses it or anything derived from it. Tensors that are live past
+// the block they are allocated in, are returned or do not have a bounded size are not planned.
+// The planned tensors of a block reuse storage tokens the same way as the graph memory planner
+// of relay, and all the tokens of a block on one device are laid out in a single arena with
+// 64-byte aligned offsets:
+//
+// x = relax.builtin.alloc_tensor((2, 3), relax.attrs.AllocTensorAttrs)
+// y = relax.builtin.alloc_tensor((2, 3), relax.attrs.AllocTensorAttrs)
+// -->
+// arena = relax.vm.builtin.alloc_storage((128,), relax.attrs.VMAllocStorageAttrs)
+// x = relax.vm.builtin.alloc_tensor(arena, (2, 3), relax.attrs.VMAllocTensorAttrs(offset=0))
+// y = relax.vm.builtin.alloc_tensor(arena, (2, 3), relax.attrs.VMAllocTensorAttrs(offset=64))
+//
+// The offsets can instead be assigned by one of the USMP algorithms, greedy_by_size,
+// greedy_by_conflicts, hill_climb or a custom tir.usmp.algo.<name>, selected by the
+// relax.VMMemoryLower.algorithm config. The tensors of a block on one device are then the
+// buffers of a single pool, conflicting with the tensors of overlapping lifetimes.
+//
+// With the relax.VMMemoryLower.fast_scope config, e.g. global.vtcm for the VTCM of Hexagon, the
+// hottest tensors of each block on a device, by uses per byte, are first placed in an arena of
+// that memory scope, first fit in the lifetimes and the offsets of the tensors placed before.
+// The fast arenas of a function stay within the relax.VMMemoryLower.fast_capacity bytes, and
+// are allocated for each call rather than kept by the VM, so that the scarce memory is only
+// held while the function runs.
+
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.VMMemoryLower.algorithm", String);
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.VMMemoryLower.fast_scope", String);
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.VMMemoryLower.fast_capacity", Integer);
+
+/*! \brief The default planning algorithm, reusing storage tokens as the graph memory planner. */
+constexpr const char* kStorageTokenAlgo = "storage_token";
+
+/*! \brief The arena that the planned tensors of a block on one device are allocated from. */
+struct StorageArena {
+  /*! \brief The device index of the arena. */
+  int64_t device_index;
+  /*! \brief The dtype hint of the arena storage. */
+  DataType dtype;
+  /*! \brief The size of the arena in bytes. */
+  int64_t size = 0;
+  /*! \brief The memory scope of the arena storage. */
+  String scope = "global";
+  /*! \brief The storage var of the arena, defined once the arena is emitted. */
+  Var storage;
+};
+
+/*! \brief The location a planned tensor is allocated at. */
+struct PlannedTensor {
+  /*! \brief The index of the arena in the planner. */
+  size_t arena;
+  /*! \brief The byte offset of the tensor in the arena. */
+  int64_t offset;
+};
+
+class StaticMemoryPlanner {
+ public:
+  /*!
+   * \param upper_bounds The upper bounds of the symbolic variables in the function.
+   * \param reuse Whether tensors with disjoint lifetimes can share storage tokens.
+   * \param algorithm The planning algorithm, kStorageTokenAlgo or the name of a USMP one.
+   * \param fast_scope The memory scope the hottest tensors are placed in, empty for none.
+   * \param fast_capacity The bytes of the fast memory scope available to the function.
+   */
+  StaticMemoryPlanner(Map<String, Integer> upper_bounds, bool reuse, String algorithm,
+                      String fast_scope = "", int64_t fast_capacity = 0)
+      : upper_bounds_(upper_bounds),
+        reuse_(reuse),
+        fast_scope_(fast_scope),
+        fast_capacity_(std::min<int64_t>(fast_capacity, std::numeric_limits<int>::max())) {
+    if (algorithm != kStorageTokenAlgo) {
+      usmp_algorithm_ = runtime::Registry::Get("tir.usmp.algo." + std::string(algorithm));
+      CHECK(usmp_algorithm_ != nullptr)
+          << "ValueError: Unknown memory planning algorithm " << algorithm
+          << ", expected " << kStorageTokenAlgo << " or a registered tir.usmp.algo.<name>";
+    }
+  }
+
+  /*! \brief Plan the allocations of the given SeqExpr. */
+  void Plan(const SeqExprNode* seq) {
+    std::vector<Candidate> candidates;
+    std::unordered_map<const VarNode*, std::vector<size_t>> aliases;
+    int64_t index = 0;
+
+    // Mark the candidates the expression refers to as used at the given binding.
+    auto use = [&](const Expr& expr, int64_t block) -> std::vector<size_t> {
+      std::vector<size_t> roots;
+      for (const VarNode* var : CollectVars(expr)) {
+        auto it = aliases.find(var);
+        if (it == aliases.end()) continue;
+        for (size_t root : it->second) {
+          Candidate& c = candidates[root];
+          if (c.last_use != index) ++c.num_uses;
+          c.last_use = index;
+          if (c.block != block) c.escaped = true;
+          roots.push_back(root);
+        }
+      }
+      return roots;
+    };
+
+    for (int64_t block = 0; block < static_cast<int64_t>(seq->blocks.size()); ++block) {
+      for (const Binding& binding : seq->blocks[block]->bindings) {
+        Var var;
+        Expr value;
+        if (const auto* var_binding = binding.as<VarBindingNode>()) {
+          var = var_binding->var;
+          value = var_binding->value;
+        } else if (const auto* match_shape = binding.as<MatchShapeNode>()) {
+          var = match_shape->var;
+          value = match_shape->value;
+        } else {
+          LOG(FATAL) << "Unsupported binding type " << binding->GetTypeKey();
+        }
+
+        int64_t size = 0;
+        const auto* call = value.as<CallNode>();
+        if (var.defined() && call != nullptr && call->op == alloc_tensor_op_ &&
+            AllocSize(call, &size)) {
+          const auto* attrs = call->attrs.as<AllocTensorAttrs>();
+          ICHECK(attrs != nullptr) << "must be AllocTensorAttrs";
+          aliases[var.get()] = {candidates.size()};
+          candidates.push_back(
+              {var.get(), block, index, index, size, attrs->runtime_device_index, attrs->dtype});
+        } else {
+          std::vector<size_t> roots = use(value, block);
+          if (var.defined() && !roots.empty()) {
+            // conservatively assume the result can refer to any of the tensors used
+            aliases[var.get()] = std::move(roots);
+          }
+        }
+        ++index;
+      }
+    }
+    for (size_t root : use(seq->body, -1)) {
+      candidates[root].escaped = true;
+    }
+
+    // Assign the candidates of each block to storage tokens and lay the tokens out in arenas.
+    size_t begin = 0;
+    while (begin < candidates.size()) {
+      size_t end = begin;
+      while (end < candidates.size() && candidates[end].block == candidates[begin].block) ++end;
+      if (!fast_scope_.empty() && fast_capacity_ > 0) {
+        AssignFast(&candidates, begin, end);
+      }
+      if (usmp_algorithm_ != nullptr) {
+        AssignBlockWithUSMP(candidates, begin, end);
+      } else {
+        AssignBlock(candidates, begin, end);
+      }
+      begin = end;
+    }
+  }
+
+  /*! \brief The planned location of the tensor bound to the var, or nullptr if not planned. */
+  const PlannedTensor* Find(const Var& var) const {
+    auto it = planned_.find(var.get());
+    return it == planned_.end() ? nullptr : &it->second;
+  }
+
+  /*! \brief The arena with the given index. */
+  StorageArena& arena(size_t index) { return arenas_[index]; }
+
+  /*! \brief The total bytes of the planned arenas in the global memory. */
+  int64_t arena_bytes() const {
+    int64_t total = 0;
+    for (const StorageArena& arena : arenas_) {
+      if (arena.scope == "global") total += arena.size;
+    }
+    return total;
+  }
+
+  /*! \brief The total bytes of the planned arenas in the fast memory scope. */
+  int64_t fast_arena_bytes() const { return fast_bytes_; }
+
+ private:
+  /*! \brief An alloc_tensor in the SeqExpr that can be planned. */
+  struct Candidate {
+    const VarNode* var;
+    int64_t block;
+    int64_t def;
+    int64_t last_use;
+    int64_t size;
+    int64_t device_index;
+    DataType dtype;
+    bool escaped = false;
+    /*! \brief The number of bindings using the tensor, its definition excluded. */
+    int64_t num_uses = 0;
+    /*! \brief Whether the tensor is placed in the fast memory scope. */
+    bool fast = false;
+  };
+
+  /*! \brief A storage token shared by tensors with disjoint lifetimes. */
+  struct Token {
+    int64_t device_index;
+    int64_t size;
+    std::vector<size_t> tensors;
+  };
+
+  static std::vector<const VarNode*> CollectVars(const Expr& expr) {
+    class VarCollector : public ExprVisitor {
+     public:
+      void VisitExpr_(const VarNode* op) final { vars.push_back(op); }
+      void VisitExpr_(const DataflowVarNode* op) final { vars.push_back(op); }
+      std::vector<const VarNode*> vars;
+    };
+    VarCollector collector;
+    collector.VisitExpr(expr);
+    return std::move(collector.vars);
+  }
+
+  /*! \brief Get the upper bound of the allocation size in bytes, returns false if unbounded. */
+  bool AllocSize(const CallNode* call, int64_t* size) {
+    const auto* shape = call->args[0].as<ShapeExprNode>();
+    const auto* attrs = call->attrs.as<AllocTensorAttrs>();
+    if (shape == nullptr || attrs == nullptr) return false;
+    int64_t elem_bytes = (attrs->dtype.bits() * attrs->dtype.lanes() + 7) / 8;
+    PrimExpr bytes = make_const(DataType::Int(64), elem_bytes);
+    for (const PrimExpr& dim : shape->values) {
+      bytes = bytes * cast(DataType::Int(64), dim);
+    }
+    bool bounded = true;
+    tir::PostOrderVisit(bytes, [&](const ObjectRef& obj) {
+      if (const auto* var = obj.as<tir::VarNode>()) {
+        if (bound_vars_.count(var)) return;
+        auto it = upper_bounds_.find(var->name_hint);
+        if (it == upper_bounds_.end()) {
+          bounded = false;
+          return;
+        }
+        analyzer_.Bind(GetRef<tir::Var>(var),
+                       Range::FromMinExtent(IntImm(var->dtype, 0),
+                                            IntImm(var->dtype, (*it).second->value + 1)));
+        bound_vars_.insert(var);
+      }
+    });
+    if (!bounded) return false;
+    arith::ConstIntBound bound = analyzer_.const_int_bound(bytes);
+    if (bound->max_value == arith::ConstIntBound::kPosInf || bound->max_value < 0) return false;
+    *size = bound->max_value;
+    return true;
+  }
+
+  void AssignBlock(const std::vector<Candidate>& candidates, size_t begin, size_t end) {
+    std::vector<Token> tokens;
+    std::vector<size_t> free_tokens;
+    std::unordered_map<size_t, size_t> token_of;
+    std::vector<size_t> live;
+    for (size_t i = begin; i < end; ++i) {
+      const Candidate& c = candidates[i];
+      if (c.escaped || c.fast) continue;
+      // release the tokens of the tensors that are dead before this allocation
+      for (auto it = live.begin(); it != live.end();) {
+        if (candidates[*it].last_use < c.def) {
+          if (reuse_) free_tokens.push_back(token_of[*it]);
+          it = live.erase(it);
+        } else {
+          ++it;
+        }
+      }
+      size_t token = Request(&tokens, &free_tokens, c);
+      tokens[token].tensors.push_back(i);
+      token_of[i] = token;
+      live.push_back(i);
+    }
+
+    // lay out the tokens of each device in an arena, offsets are stored as int attributes
+    std::unordered_map<int64_t, size_t> arena_of;
+    for (const Token& token : tokens) {
+      int64_t size = AlignUp(token.size);
+      auto it = arena_of.find(token.device_index);
+      if (it == arena_of.end() ||
+          arenas_[it->second].size + size > std::numeric_limits<int>::max()) {
+        StorageArena arena;
+        arena.device_index = token.device_index;
+        arena.dtype = candidates[token.tensors[0]].dtype;
+        it = arena_of.insert_or_assign(token.device_index, arenas_.size()).first;
+        arenas_.push_back(arena);
+      }
+      StorageArena& arena = arenas_[it->second];
+      for (size_t tensor : token.tensors) {
+        planned_[candidates[tensor].var] = {it->second, arena.size};
+      }
+      arena.size += size;
+    }
+  }
+
+  void AssignBlockWithUSMP(const std::vector<Candidate>& candidates, size_t begin, size_t end) {
+    // ordered by device, so that the arenas are emitted deterministically
+    std::map<int64_t, std::vector<size_t>> device_tensors;
+    for (size_t i = begin; i < end; ++i) {
+      if (!candidates[i].escaped && !candidates[i].fast) {
+        device_tensors[candidates[i].device_index].push_back(i);
+      }
+    }
+    for (const auto& kv : device_tensors) {
+      const std::vector<size_t>& tensors = kv.second;
+      PoolInfo pool = WorkspacePoolInfo("relax_arena", {});
+      std::vector<tir::usmp::BufferInfo> buffers;
+      for (size_t i : tensors) {
+        buffers.emplace_back(candidates[i].var->name_hint(),
+                             Integer(IntImm(DataType::Int(64), candidates[i].size)),
+                             Array<PoolInfo>{pool}, Integer(kAlignment));
+      }
+      // the memory pressure is the largest total size of the tensors live at a definition
+      int64_t memory_pressure = 0;
+      for (size_t a = 0; a < tensors.size(); ++a) {
+        const Candidate& ca = candidates[tensors[a]];
+        Array<ObjectRef> conflicts;
+        int64_t live_bytes = 0;
+        for (size_t b = 0; b < tensors.size(); ++b) {
+          const Candidate& cb = candidates[tensors[b]];
+          bool overlap = ca.def <= cb.last_use && cb.def <= ca.last_use;
+          if (a != b && (overlap || !reuse_)) conflicts.push_back(buffers[b]);
+          if (cb.def <= ca.def && ca.def <= cb.last_use) live_bytes += AlignUp(cb.size);
+        }
+        buffers[a]->SetConflicts(conflicts);
+        memory_pressure = std::max(memory_pressure, live_bytes);
+      }
+      Map<tir::usmp::BufferInfo, tir::usmp::PoolAllocation> allocations =
+          (*usmp_algorithm_)(Array<tir::usmp::BufferInfo>(buffers),
+                             Integer(IntImm(DataType::Int(64), memory_pressure)));
+
+      StorageArena arena;
+      arena.device_index = kv.first;
+      arena.dtype = candidates[tensors[0]].dtype;
+      for (size_t k = 0; k < tensors.size(); ++k) {
+        int64_t offset = allocations.at(buffers[k])->byte_offset->value;
+        arena.size = std::max(arena.size, offset + AlignUp(candidates[tensors[k]].size));
+      }
+      // offsets are stored as int attributes, larger arenas are left unplanned
+      if (arena.size > std::numeric_limits<int>::max()) continue;
+      for (size_t k = 0; k < tensors.size(); ++k) {
+        planned_[candidates[tensors[k]].var] = {arenas_.size(),
+                                                allocations.at(buffers[k])->byte_offset->value};
+      }
+      arenas_.push_back(arena);
+    }
+  }
+
+  /*!
+   * \brief Place the densest candidates of a block on each device in an arena of the fast
+   * memory scope, while the fast arenas of the function fit in the fast capacity.
+   */
+  void AssignFast(std::vector<Candidate>* candidates, size_t begin, size_t end) {
+    // ordered by device, so that the arenas are emitted deterministically; the host memory has
+    // no faster scope
+    std::map<int64_t, std::vector<size_t>> device_tensors;
+    for (size_t i = begin; i < end; ++i) {
+      const Candidate& c = (*candidates)[i];
+      if (!c.escaped && c.device_index >= 0) device_tensors[c.device_index].push_back(i);
+    }
+    for (auto& kv : device_tensors) {
+      std::vector<size_t>& tensors = kv.second;
+      auto density = [&](size_t i) {
+        const Candidate& c = (*candidates)[i];
+        return static_cast<double>(c.num_uses) / AlignUp(std::max<int64_t>(c.size, 1));
+      };
+      // the uses per byte, ties broken by the order of definition
+      std::stable_sort(tensors.begin(), tensors.end(),
+                       [&](size_t a, size_t b) { return density(a) > density(b); });
+      std::vector<std::pair<size_t, int64_t>> placed;
+      int64_t arena_size = 0;
+      for (size_t i : tensors) {
+        const Candidate& c = (*candidates)[i];
+        int64_t size = AlignUp(c.size);
+        // the address ranges taken by the placed tensors live with this one
+        std::vector<std::pair<int64_t, int64_t>> taken;
+        for (const auto& p : placed) {
+          const Candidate& other = (*candidates)[p.first];
+          if (!reuse_ || (c.def <= other.last_use && other.def <= c.last_use)) {
+            taken.emplace_back(p.second, p.second + AlignUp(other.size));
+          }
+        }
+        std::sort(taken.begin(), taken.end());
+        int64_t offset = 0;
+        for (const auto& range : taken) {
+          if (offset + size <= range.first) break;
+          offset = std::max(offset, range.second);
+        }
+        int64_t new_size = std::max(arena_size, offset + size);
+        if (fast_bytes_ + new_size > fast_capacity_) continue;
+        placed.emplace_back(i, offset);
+        arena_size = new_size;
+      }
+      if (placed.empty()) continue;
+      StorageArena arena;
+      arena.device_index = kv.first;
+      arena.dtype = (*candidates)[placed[0].first].dtype;
+      arena.size = arena_size;
+      arena.scope = fast_scope_;
+      for (const auto& p : placed) {
+        (*candidates)[p.first].fast = true;
+        planned_[(*candidates)[p.first].var] = {arenas_.size(), p.second};
+      }
+      arenas_.push_back(arena);
+      fast_bytes_ += arena_size;
+    }
+  }
+
+  static int64_t AlignUp(int64_t size) { return (size + kAlignment - 1) / kAlignment * kAlignment; }
+
+  /*! \brief Find a free token for the candidate, or create a new one. */
+  static size_t Request(std::vector<Token>* tokens, std::vector<size_t>* free_tokens,
+                        const Candidate& c) {
+    // prefer the smallest token that fits, then the largest token that can be grown,
+    // within the same match range as the graph memory planner
+    auto best = free_tokens->end();
+    for (auto it = free_tokens->begin(); it != free_tokens->end(); ++it) {
+      const Token& token = (*tokens)[*it];
+      if (token.device_index != c.device_index) continue;
+      if (token.size > c.size * kMatchRange || token.size * kMatchRange < c.size) continue;
+      if (best == free_tokens->end()) {
+        best = it;
+        continue;
+      }
+      const Token& curr = (*tokens)[*best];
+      bool fits = token.size >= c.size;
+      bool curr_fits = curr.size >= c.size;
+      if (fits ? (!curr_fits || token.size < curr.size) : (!curr_fits && token.size > curr.size)) {
+        best = it;
+      }
+    }
+    if (best != free_tokens->end()) {
+      size_t token = *best;
+      free_tokens->erase(best);
+      (*tokens)[token].size = std::max((*tokens)[token].size, c.size);
+      return token;
+    }
+    tokens->push_back({c.device_index, c.size, {}});
+    return tokens->size() - 1;
+  }
+
+  /*! \brief The alignment of the tensors in an arena, the same as the VM allocations. */
+  static constexpr int64_t kAlignment = 64;
+  /*! \brief The maximum size ratio between a tensor and the token it reuses. */
+  static constexpr int64_t kMatchRange = 16;
+
+  const Op& alloc_tensor_op_ = Op::Get("relax.builtin.alloc_tensor");
+  Map<String, Integer> upper_bounds_;
+  bool reuse_;
+  /*! \brief The USMP algorithm laying out the tensors, or nullptr for the storage tokens. */
+  const runtime::PackedFunc* usmp_algorithm_ = nullptr;
+  /*! \brief The memory scope of the hottest tensors, empty for none. */
+  String fast_scope_;
+  /*! \brief The bytes of the fast memory scope available to the function. */
+  int64_t fast_capacity_;
+  /*! \brief The bytes of the fast arenas planned so far. */
+  int64_t fast_bytes_ = 0;
+  arith::Analyzer analyzer_;
+  std::unordered_set<const tir::VarNode*> bound_vars_;
+  std::vector<StorageArena> arenas_;
+  std::unordered_map<const VarNode*, PlannedTensor> planned_;
+};
+
 // ==================
 // MemLowerMutator
 // Lower the relax.builtin.alloc_tensor op to VM builtin functions.
@@ -41,8 +514,24 @@ namespace relax {
 // relax.attrs.VMAllocStorageAttrs)
 // gv1 = relax.call_packed("relax.vm.builtin.alloc_tensor", gv0, (m, n),
 // relax.attrs.VMAllocTensorAttrs)
+//
+// When memory planning is enabled, the tensors planned by StaticMemoryPlanner are allocated
+// from the arena of their block instead.
 
 class VMMemLowerMutator : public ExprMutator {
+ public:
+  VMMemLowerMutator(Map<String, Integer> upper_bounds, bool plan_memory, bool reuse,
+                    String algorithm, String fast_scope, int64_t fast_capacity)
+      : plan_memory_(plan_memory),
+        planner_(upper_bounds, reuse, algorithm, fast_scope, fast_capacity) {}
+
+  /*! \brief The total bytes of the global arenas planned by the planner. */
+  int64_t arena_bytes() const { return planner_.arena_bytes(); }
+
+  /*! \brief The total bytes of the fast arenas planned by the planner. */
+  int64_t fast_arena_bytes() const { return planner_.fast_arena_bytes(); }
+
+ private:
   Expr ComputeStorageSize(const Expr& shape, const DataType& dtype) const {
     // Question: what if the dtype of tensor_type is unknown?
     // Symbolic/static shape case
@@ -68,6 +557,19 @@ class VMMemLowerMutator : public ExprMutator {
 
   using ExprMutator::VisitExpr_;
 
+  Expr VisitExpr_(const SeqExprNode* op) override {
+    if (plan_memory_) {
+      planner_.Plan(op);
+    }
+    return ExprMutator::VisitExpr_(op);
+  }
+
+  void VisitBinding_(const VarBindingNode* binding) override {
+    planned_ = plan_memory_ ? planner_.Find(binding->var) : nullptr;
+    ExprMutator::VisitBinding_(binding);
+    planned_ = nullptr;
+  }
+
   Expr VisitExpr_(const CallNode* call) override {
     // post-order mutation
     Expr expr = VisitExprPostOrder_(call);
@@ -77,7 +579,30 @@ class VMMemLowerMutator : public ExprMutator {
     static const Op& vm_alloc_storage_op = Op::Get("relax.vm.builtin.alloc_storage");
     static const Op& vm_alloc_tensor_op = Op::Get("relax.vm.builtin.alloc_tensor");
 
-    // TODO(@yuchen): memory planning
+    if (call->op == alloc_tensor_op && planned_ != nullptr) {
+      auto alloc_attrs = call->attrs.as<AllocTensorAttrs>();
+      StorageArena& arena = planner_.arena(planned_->arena);
+      if (!arena.storage.defined()) {
+        auto storage_attr = make_object<VMAllocStorageAttrs>();
+        storage_attr->dtype = arena.dtype;
+        storage_attr->runtime_device_index = arena.device_index;
+        // the planned tensors never outlive the call, so the arena can be kept by the VM,
+        // except in the fast memory that the other functions need too
+        storage_attr->persistent = arena.scope == "global";
+        storage_attr->storage_scope = arena.scope;
+        arena.storage = builder_->Emit(
+            Call(vm_alloc_storage_op, {ShapeExpr({IntImm(DataType::Int(64), arena.size)})},
+                 Attrs(storage_attr)),
+            "storage");
+      }
+      auto tensor_attr = make_object<VMAllocTensorAttrs>();
+      tensor_attr->offset = static_cast<int>(planned_->offset);
+      tensor_attr->dtype = alloc_attrs->dtype;
+      Var tensor = builder_->Emit(
+          Call(vm_alloc_tensor_op, {arena.storage, call->args[0]}, Attrs(tensor_attr)), "tensor");
+      return std::move(tensor);
+    }
+
     if (call->op == alloc_tensor_op) {
       ShapeExpr output_shape = Downcast<ShapeExpr>(call->args[0]);
       auto alloc_attrs = call->attrs.as<AllocTensorAttrs>();
@@ -101,15 +626,53 @@ class VMMemLowerMutator : public ExprMutator {
 
     return GetRef<Expr>(call);
   }
+
+  /*! \brief Whether to allocate the tensors from the arenas planned by the planner. */
+  bool plan_memory_;
+  /*! \brief The memory planner of the function. */
+  StaticMemoryPlanner planner_;
+  /*! \brief The planned location of the tensor bound by the binding being visited. */
+  const PlannedTensor* planned_ = nullptr;
 };
 
-Expr VMMemLower(const Expr& e) { return VMMemLowerMutator().VisitExpr(e); }
+Expr VMMemLower(const Function& f, bool plan_memory) {
+  // Tensors with disjoint lifetimes can only share storage when the kernels that access them
+  // are ordered, reuse is therefore disabled when VMCodeGen distributes kernels on streams.
+  Integer num_streams = PassContext::Current()
+                            ->GetConfig<Integer>("relax.VMCodeGen.num_streams", Integer(1))
+                            .value();
+  Map<String, Integer> upper_bounds =
+      f->GetAttr<Map<String, Integer>>(attr::kTIRVarUpperBound).value_or({});
+  String algorithm = PassContext::Current()
+                         ->GetConfig<String>("relax.VMMemoryLower.algorithm", kStorageTokenAlgo)
+                         .value();
+  String fast_scope =
+      PassContext::Current()->GetConfig<String>("relax.VMMemoryLower.fast_scope", "").value();
+  Integer fast_capacity = PassContext::Current()
+                              ->GetConfig<Integer>("relax.VMMemoryLower.fast_capacity", Integer(0))
+                              .value();
+  VMMemLowerMutator mutator(upper_bounds, plan_memory, num_streams->value <= 1, algorithm,
+                            fast_scope, fast_capacity->value);
+  Function func = Downcast<Function>(mutator.VisitExpr(f));
+  if (mutator.arena_bytes() > 0) {
+    // report the planned footprint, e.g. to size the memory of embedded targets
+    func = WithAttr(std::move(func), "planned_arena_bytes",
+                    IntImm(DataType::Int(64), mutator.arena_bytes()));
+  }
+  if (mutator.fast_arena_bytes() > 0) {
+    func = WithAttr(std::move(func), "planned_fast_arena_bytes",
+                    IntImm(DataType::Int(64), mutator.fast_arena_bytes()));
+  }
+  return std::move(func);
+}
 
 namespace transform {
 
-Pass VMMemoryLower() {
+Pass VMMemoryLower(bool plan_memory) {
   runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
-      [=](Function f, IRModule m, PassContext pc) { return Downcast<Function>(VMMemLower(f)); };
+      [=](Function f, IRModule m, PassContext pc) {
+        return Downcast<Function>(VMMemLower(f, plan_memory));
+      };
   return CreateFunctionPass(pass_func, 0, "VMMemoryLower", {});
 }
 
@@ -21,6 +21,7 @@
  * \brief Lower the shape expressions in relax to VM shape heap manipulations and generate related
  * TIR functions to do shape calculations.
  */
+#include <tvm/arith/analyzer.h>
 #include <tvm/relax/attrs/shape.h>
 #include <tvm/relax/backend.h>
 #include <tvm/relax/expr_functor.h>
@@ -29,22 +30,29 @@
 #include <tvm/tir/op.h>
 #include <tvm/tir/stmt_functor.h>
 
+#include <algorithm>
+#include <unordered_map>
+
 namespace tvm {
 namespace relax {
 
 class VMShapeLowerMutator : public ExprMutator {
  public:
+  using PrimExprSlotMap = std::unordered_map<PrimExpr, Integer, StructuralHash, StructuralEqual>;
+
   static DataType ShapeDType() { return DataType::Int(64); }
 
-  explicit VMShapeLowerMutator(IRModule mod) : ExprMutator(mod) {}
+  explicit VMShapeLowerMutator(IRModule mod, bool native_shape_arith)
+      : ExprMutator(mod), native_shape_arith_(native_shape_arith) {}
 
   IRModule Lower() {
     for (auto& p : builder_->GetContextIRModule()->functions) {
       Expr func = p.second;
       if (func->IsInstance<FunctionNode>()) {
         // prepare mapping and heap var
-        expr2slot_ = PrepareExpr2Slot(Downcast<Function>(func));
-        heap_size_ = IntImm(ShapeDType(), expr2slot_.size());
+        int num_slots = 0;
+        expr2slot_ = PrepareExpr2Slot(Downcast<Function>(func), &num_slots);
+        heap_size_ = IntImm(ShapeDType(), num_slots);
         DynTensorType heap_type(1, ShapeDType());
         shape_heap_ = Var("shape_heap", ShapeExpr({heap_size_}), heap_type);
 
@@ -70,10 +78,14 @@ class VMShapeLowerMutator : public ExprMutator {
     if (IsConstantShape(GetRef<ShapeExpr>(node))) {
       return ExprMutator::VisitExpr_(node);
     }
-    tir::PrimFunc func = CalculateShape(GetRef<ShapeExpr>(node));
-
-    GlobalVar shape_func_var = builder_->AddFunction(func, "shape_func");
-    builder_->Emit(Call(shape_func_var, {shape_heap_}), "_");
+    if (native_shape_arith_ && std::all_of(node->values.begin(), node->values.end(),
+                                           [this](const PrimExpr& e) { return IsVMArith(e); })) {
+      ComputeShape(GetRef<ShapeExpr>(node));
+    } else {
+      tir::PrimFunc func = CalculateShape(GetRef<ShapeExpr>(node));
+      GlobalVar shape_func_var = builder_->AddFunction(func, "shape_func");
+      builder_->Emit(Call(shape_func_var, {shape_heap_}), "_");
+    }
 
     // construct shape
     Array<Integer> indices;
@@ -158,6 +170,52 @@ class VMShapeLowerMutator : public ExprMutator {
     return tir::PrimFunc(params, body, ret_type, buffer_map);
   }
 
+  /*!
+   * \brief Whether the VM can compute an expression with its native shape arithmetic, i.e.
+   * the expression only consists of integer constants, variables on the heap, casts and
+   * arithmetic supported by vm::ShapeOp.
+   */
+  bool IsVMArith(const PrimExpr& e) const {
+    if (!e.dtype().is_int() && !e.dtype().is_uint()) return false;
+    if (e->IsInstance<IntImmNode>()) return true;
+    if (e->IsInstance<tir::VarNode>()) return expr2slot_.count(e) != 0;
+    if (const auto* cast = e.as<tir::CastNode>()) return IsVMArith(cast->value);
+#define TVM_RELAX_VM_ARITH_BINARY(Node)                       \
+  if (const auto* op = e.as<Node>()) {                        \
+    return IsVMArith(op->a) && IsVMArith(op->b);              \
+  }
+    TVM_RELAX_VM_ARITH_BINARY(tir::AddNode);
+    TVM_RELAX_VM_ARITH_BINARY(tir::SubNode);
+    TVM_RELAX_VM_ARITH_BINARY(tir::MulNode);
+    TVM_RELAX_VM_ARITH_BINARY(tir::DivNode);
+    TVM_RELAX_VM_ARITH_BINARY(tir::ModNode);
+    TVM_RELAX_VM_ARITH_BINARY(tir::FloorDivNode);
+    TVM_RELAX_VM_ARITH_BINARY(tir::FloorModNode);
+    TVM_RELAX_VM_ARITH_BINARY(tir::MinNode);
+    TVM_RELAX_VM_ARITH_BINARY(tir::MaxNode);
+#undef TVM_RELAX_VM_ARITH_BINARY
+    return false;
+  }
+
+  /*! \brief Compute the values of a shape on the heap with the VM's native shape arithmetic. */
+  void ComputeShape(ShapeExpr s) {
+    tir::Buffer buffer = tir::decl_buffer({heap_size_}, ShapeDType(), "H");
+    Array<PrimExpr> values;
+    Array<Integer> indices;
+    for (PrimExpr e : s->values) {
+      // the values of variables are already on the heap
+      if (e->IsInstance<tir::VarNode>()) continue;
+      values.push_back(tir::Substitute(e, BuildVarMapping(e, buffer)));
+      indices.push_back(expr2slot_.at(e));
+    }
+    if (values.empty()) return;
+    static const Op& compute_shape_op = Op::Get("relax.vm.builtin.compute_shape");
+    auto compute_shape_attr = make_object<ComputeShapeAttrs>();
+    compute_shape_attr->values = values;
+    compute_shape_attr->indices = indices;
+    builder_->Emit(Call(compute_shape_op, {shape_heap_}, Attrs(compute_shape_attr)), "_");
+  }
+
   Map<tir::Var, PrimExpr> BuildVarMapping(PrimExpr expr, tir::Buffer buffer) {
     Map<tir::Var, PrimExpr> ret;
     auto func = [&](const ObjectRef& e) {
@@ -171,10 +229,20 @@ class VMShapeLowerMutator : public ExprMutator {
     return ret;
   }
 
-  Map<PrimExpr, Integer> PrepareExpr2Slot(Function expr) const {
+  /*!
+   * \brief Assign the slots on the shape heap to the dimensions of the shapes in a function. The
+   *  structurally equal dimensions, and the dimensions simplified to the same canonical form,
+   *  share the same slot.
+   * \param expr The function.
+   * \param num_slots The number of slots assigned.
+   * \return The slot of each dimension, empty if the function only has static shapes.
+   */
+  PrimExprSlotMap PrepareExpr2Slot(Function expr, int* num_slots) const {
     int cnt = 0;
     bool is_dyn_shape = false;
-    Map<PrimExpr, Integer> ret;
+    PrimExprSlotMap ret;
+    PrimExprSlotMap canonical2slot;
+    arith::Analyzer analyzer;
     auto func = [&](const Expr& e) {
       if (e->IsInstance<ShapeExprNode>()) {
         ShapeExpr shape = Downcast<ShapeExpr>(e);
@@ -182,9 +250,16 @@ class VMShapeLowerMutator : public ExprMutator {
           if (!prim_e->IsInstance<IntImmNode>()) {
             is_dyn_shape = true;
           }
-          if (ret.count(prim_e) == 0) {
-            ret.Set(prim_e, cnt++);
+          if (ret.count(prim_e) != 0) continue;
+          PrimExpr canonical = prim_e;
+          if (!prim_e->IsInstance<IntImmNode>() && !prim_e->IsInstance<tir::VarNode>()) {
+            canonical = analyzer.Simplify(prim_e);
+          }
+          auto it = canonical2slot.find(canonical);
+          if (it == canonical2slot.end()) {
+            it = canonical2slot.emplace(canonical, cnt++).first;
           }
+          ret.emplace(prim_e, it->second);
         }
       }
     };
@@ -193,7 +268,9 @@ class VMShapeLowerMutator : public ExprMutator {
     // Avoid allocating shape heap and do shape computation for static-shape program
     if (!is_dyn_shape) {
       ret.clear();
+      cnt = 0;
     }
+    *num_slots = cnt;
     return ret;
   }
 
@@ -221,17 +298,21 @@ class VMShapeLowerMutator : public ExprMutator {
   }
 
  private:
+  /*! \brief Whether to compute shapes with VM instructions instead of TIR shape functions. */
+  bool native_shape_arith_;
   // function-wise members
   IntImm heap_size_;
   Var shape_heap_;
-  Map<PrimExpr, Integer> expr2slot_;
+  PrimExprSlotMap expr2slot_;
 };
 
 namespace transform {
 
-Pass VMShapeLower() {
+Pass VMShapeLower(bool native_shape_arith) {
   runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
-      [=](IRModule mod, PassContext pc) { return VMShapeLowerMutator(mod).Lower(); };
+      [=](IRModule mod, PassContext pc) {
+        return VMShapeLowerMutator(mod, native_shape_arith).Lower();
+      };
   return CreateModulePass(pass_func, 0, "VMShapeLower", {});
 }
 
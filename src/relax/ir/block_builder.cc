@@ -29,6 +29,8 @@
 #include <tvm/relay/op.h>
 #include <tvm/tir/function.h>
 
+#include <unordered_set>
+
 namespace tvm {
 namespace relax {
 
@@ -63,7 +65,15 @@ class BlockBuilderNode::ExprNormalizer : public ExprFunctor<Expr(const Expr&)> {
       ICHECK(post.as<VarNode>()) << "memoized expressions should map to variables";
       return post.value();
     }
-    return ExprFunctor::VisitExpr(expr);
+    // The expressions normalized before are left as they are, without traversing them again.
+    if (normalized_.count(expr)) {
+      return expr;
+    }
+    Expr normalized = ExprFunctor::VisitExpr(expr);
+    if (normalized->checked_type_.defined()) {
+      normalized_.insert(normalized);
+    }
+    return normalized;
   }
 
   Expr VisitExpr_(const TupleNode* op) final {
@@ -179,11 +189,7 @@ class BlockBuilderNode::ExprNormalizer : public ExprFunctor<Expr(const Expr&)> {
       unchanged = false;
     }
 
-    SeqExpr seq_expr;
-    if (unchanged) {
-      seq_expr = GetRef<SeqExpr>(op);
-    }
-    seq_expr = SeqExpr(new_blocks, new_body);
+    SeqExpr seq_expr = unchanged ? GetRef<SeqExpr>(op) : SeqExpr(new_blocks, new_body);
 
     // only do shape/type inference if the SeqExpr does not have shape/type
     if (seq_expr->shape_ && seq_expr->checked_type_.defined()) {
@@ -239,11 +245,8 @@ class BlockBuilderNode::ExprNormalizer : public ExprFunctor<Expr(const Expr&)> {
 
   Expr VisitExpr_(const TupleGetItemNode* op) final {
     Expr new_tuple = this->VisitExpr(op->tuple);
-    TupleGetItem node;
-    if (new_tuple.same_as(op->tuple)) {
-      node = GetRef<TupleGetItem>(op);
-    }
-    node = TupleGetItem(new_tuple, op->index);
+    TupleGetItem node = new_tuple.same_as(op->tuple) ? GetRef<TupleGetItem>(op)
+                                                     : TupleGetItem(new_tuple, op->index);
 
     // only do shape/type inference if the TupleGetItem does not have shape/type
     if (node->shape_ && node->checked_type_.defined()) {
@@ -529,6 +532,13 @@ class BlockBuilderNode::ExprNormalizer : public ExprFunctor<Expr(const Expr&)> {
   /*! \brief Memoization table for mapping expressions to their ANF variables. */
   ExprMemo expr_memo_;
 
+  /*!
+   * \brief The expressions known to be in normal form with their shape and type deduced, which
+   *  are the results of previous normalizations. It lives as long as the BlockBuilder, so that
+   *  the passes emitting the bindings of a large function do not renormalize its subtrees.
+   */
+  std::unordered_set<Expr, ObjectPtrHash, ObjectPtrEqual> normalized_;
+
   /*! \brief Operator to shape inference map. */
   tvm::OpAttrMap<FInferShape> op_map_infer_shape_ = Op::GetAttrMap<FInferShape>("FInferShape");
 
@@ -681,11 +691,13 @@ bool BlockBuilderNode::CanProveShapeEqual(const Expr& lhs, const Expr& rhs) {
     if (lhs_ndim != rhs_ndim) {
       return false;
     }
-    arith::Analyzer analyzer;
     for (size_t i = 0; i < lhs_ndim; ++i) {
       PrimExpr lhs_dim = lhs_shape->values[i];
       PrimExpr rhs_dim = rhs_shape->values[i];
-      if (!analyzer.CanProveEqual(lhs_dim, rhs_dim)) {
+      if (lhs_dim.same_as(rhs_dim)) {
+        continue;
+      }
+      if (!analyzer_.CanProveEqual(lhs_dim, rhs_dim)) {
         return false;
       }
     }
@@ -33,6 +33,7 @@
 #include <cstddef>
 #include <limits>
 #include <stack>
+#include <string>
 #include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
@@ -664,6 +665,77 @@ class MatcherUseDefAnalysis : public relax::ExprVisitor {
   }
 };
 
+/*!
+ * \brief The graph of the bindings of a DataflowBlock along with the graph of the patterns of a
+ *  context, built once to match the patterns many times.
+ */
+class MatcherGraph {
+ public:
+  explicit MatcherGraph(const PatternContext& ctx, const DataflowBlock& dfb)
+      : matcher(AnalyzeVar2Value(dfb)) {
+    // std::map<const VarNode*, std::set<const VarNode*>>
+    MatcherUseDefAnalysis ud_analysis;
+    ud_analysis.VisitBindingBlock_(dfb.get());
+    def2use = std::move(ud_analysis.def2use);
+    caller2callees = std::move(ud_analysis.caller2callees);
+
+    // First construct a graph of PNode and RNode.
+    var2node.reserve(dfb->bindings.size());
+
+    for (const auto& du : def2use) {
+      const VarNode* cur_var = du.first;
+      const std::set<const VarNode*>& uses = du.second;
+      RNode& cur_node = var2node[cur_var];
+      cur_node.ptr = cur_var;
+      for (const VarNode* use : uses) {
+        auto& use_node = var2node[use];
+        use_node.ptr = use;
+        cur_node.children.push_back(&use_node);
+        use_node.parents.push_back(&cur_node);
+      }
+    }
+
+    pattern2node.reserve(ctx->constraints.size());
+
+    for (const auto& def2use_pattern : ctx->constraints) {
+      const DFPatternNode* def_pattern = def2use_pattern.first.get();
+      const std::map<DFPattern, std::vector<PairCons>>& uses = def2use_pattern.second;
+      PNode& def_node = pattern2node[def_pattern];
+      def_node.ptr = def_pattern;
+      def_node.children.reserve(uses.size());
+      for (const auto& use : uses) {
+        const auto& cons = use.second;
+        const DFPatternNode* use_pattern = use.first.get();
+        PNode& use_node = pattern2node[use_pattern];
+        use_node.ptr = use_pattern;
+        use_node.parents.emplace_back(&def_node, std::ref(cons));
+        def_node.children.emplace_back(&use_node, std::ref(cons));
+      }
+    }
+  }
+
+  MatcherGraph(const MatcherGraph&) = delete;
+  MatcherGraph& operator=(const MatcherGraph&) = delete;
+
+  bool TryMatch(PNode* p, RNode* r) { return try_match(p, r, &matcher, def2use, caller2callees); }
+
+  /*! \brief Get the vars matched by the patterns. */
+  tvm::runtime::Map<DFPattern, Var> GetMatched() const {
+    tvm::runtime::Map<DFPattern, Var> ret;
+    for (const auto& ppair : pattern2node) {
+      ret.Set(GetRef<DFPattern>(ppair.first), GetRef<Var>(ppair.second.matched));
+    }
+    return ret;
+  }
+
+  DFPatternMatcher matcher;
+  std::map<const VarNode*, std::set<const VarNode*>> def2use;
+  // caller -> callee table.
+  std::map<const VarNode*, std::vector<const VarNode*>> caller2callees;
+  std::unordered_map<const VarNode*, RNode> var2node;
+  std::unordered_map<const DFPatternNode*, PNode> pattern2node;
+};
+
 tvm::runtime::Map<DFPattern, Var> MatchGraph(const PatternContext& ctx, const DataflowBlock& dfb,
                                              Optional<Var> start_hint, bool must_include_hint) {
   tvm::runtime::Map<DFPattern, Var> ret{};
@@ -672,59 +744,16 @@ tvm::runtime::Map<DFPattern, Var> MatchGraph(const PatternContext& ctx, const Da
   ICHECK(!must_include_hint || start_hint.defined())
       << "must_include_hint is only supported with start_hint.";
 
-  const auto var2val = AnalyzeVar2Value(dfb);
-  DFPatternMatcher matcher(var2val);
-
-  // std::map<const VarNode*, std::set<const VarNode*>>
-  MatcherUseDefAnalysis ud_analysis;
-  ud_analysis.VisitBindingBlock_(dfb.get());
-  const auto& def2use = ud_analysis.def2use;
-  const auto& caller2callees = ud_analysis.caller2callees;
-
-  // First construct a graph of PNode and RNode.
-  std::unordered_map<const VarNode*, RNode> var2node;
-  var2node.reserve(dfb->bindings.size());
-
-  for (const auto& du : def2use) {
-    const VarNode* cur_var = du.first;
-    const std::set<const VarNode*>& uses = du.second;
-    RNode& cur_node = var2node[cur_var];
-    cur_node.ptr = cur_var;
-    for (const VarNode* use : uses) {
-      auto& use_node = var2node[use];
-      use_node.ptr = use;
-      cur_node.children.push_back(&use_node);
-      use_node.parents.push_back(&cur_node);
-    }
-  }
-
-  std::unordered_map<const DFPatternNode*, PNode> pattern2node;
-  pattern2node.reserve(ctx->constraints.size());
-
-  for (const auto& def2use_pattern : ctx->constraints) {
-    const DFPatternNode* def_pattern = def2use_pattern.first.get();
-    const std::map<DFPattern, std::vector<PairCons>>& uses = def2use_pattern.second;
-    PNode& def_node = pattern2node[def_pattern];
-    def_node.ptr = def_pattern;
-    def_node.children.reserve(uses.size());
-    for (const auto& use : uses) {
-      const auto& cons = use.second;
-      const DFPatternNode* use_pattern = use.first.get();
-      PNode& use_node = pattern2node[use_pattern];
-      use_node.ptr = use_pattern;
-      use_node.parents.emplace_back(&def_node, std::ref(cons));
-      def_node.children.emplace_back(&use_node, std::ref(cons));
-    }
-  }
+  MatcherGraph graph(ctx, dfb);
+  auto& var2node = graph.var2node;
+  auto& pattern2node = graph.pattern2node;
 
   if (start_hint.defined()) {
     Var v = start_hint.value();
     auto rnode_ptr = var2node.find(v.get());
     for (auto& ppair : pattern2node) {
-      if (try_match(&ppair.second, &rnode_ptr->second, &matcher, def2use, caller2callees)) {
-        for (auto ppair : pattern2node)
-          ret.Set(GetRef<DFPattern>(ppair.first), GetRef<Var>(ppair.second.matched));
-        return ret;
+      if (graph.TryMatch(&ppair.second, &rnode_ptr->second)) {
+        return graph.GetMatched();
       }
     }
 
@@ -736,11 +765,8 @@ tvm::runtime::Map<DFPattern, Var> MatchGraph(const PatternContext& ctx, const Da
   if (!pnode_start->matched) {
     for (auto& rpair : var2node) {
       if (start_hint.defined() && start_hint.value().get() == rpair.first) continue;
-      if (try_match(pnode_start, &rpair.second, &matcher, def2use, caller2callees)) {
-        for (auto ppair : pattern2node)
-          ret.Set(GetRef<DFPattern>(ppair.first), GetRef<Var>(ppair.second.matched));
-
-        return ret;
+      if (graph.TryMatch(pnode_start, &rpair.second)) {
+        return graph.GetMatched();
       }
     }
   }
@@ -750,5 +776,146 @@ tvm::runtime::Map<DFPattern, Var> MatchGraph(const PatternContext& ctx, const Da
 
 TVM_REGISTER_GLOBAL("relax.dpl.match_dfb").set_body_typed(MatchGraph);
 
+/*!
+ * \brief Get the keys a binding value is indexed by: the name of the op of a call, and for a
+ *  call_tir, also the name of its callee.
+ */
+static std::vector<std::string> GetIndexKeys(const Expr& value) {
+  static const Op& call_tir_op = Op::Get("relax.call_tir");
+  const auto* call = value.as<CallNode>();
+  if (call == nullptr) return {};
+  const auto* op = call->op.as<OpNode>();
+  if (op == nullptr) return {};
+  std::vector<std::string> keys{op->name};
+  if (call->op.same_as(call_tir_op) && !call->args.empty()) {
+    if (const auto* gv = call->args[0].as<GlobalVarNode>()) {
+      keys.push_back(op->name + ":" + gv->name_hint);
+    }
+  }
+  return keys;
+}
+
+/*!
+ * \brief Get the key of the bindings a pattern can match, the most specific key of GetIndexKeys.
+ * \return The key, or NullOpt if the pattern may match any binding.
+ */
+static Optional<String> GetPatternIndexKey(const DFPatternNode* pattern) {
+  static const Op& call_tir_op = Op::Get("relax.call_tir");
+  if (!pattern->IsInstance<CallPatternNode>()) return NullOpt;
+  const auto* call = static_cast<const CallPatternNode*>(pattern);
+  const auto* op_pattern = call->op.as<ExprPatternNode>();
+  const auto* op = op_pattern ? op_pattern->expr.as<OpNode>() : nullptr;
+  if (op == nullptr) return NullOpt;
+  if (op_pattern->expr.same_as(call_tir_op) && !call->args.empty()) {
+    const auto* callee = call->args[0].as<GlobalVarPatternNode>();
+    if (callee != nullptr && !callee->name_hint().empty()) {
+      return String(op->name + ":" + callee->name_hint());
+    }
+  }
+  return String(op->name);
+}
+
+/*!
+ * \brief Find all the non-overlapping matches of the graph of patterns in a DataflowBlock, and
+ *  get the replacements of bindings produced by the rewriter of each match.
+ */
+static Map<Var, Expr> GetReplacements(const PatternContext& ctx, const PackedFunc& rewriter,
+                                      const DataflowBlock& dfb) {
+  // The marker of the vars of the block in a previous match, which cannot be matched again.
+  static const DFPattern used_marker = WildcardPattern();
+  Map<Var, Expr> replacements;
+  MatcherGraph graph(ctx, dfb);
+  if (graph.pattern2node.empty()) return replacements;
+
+  // Index the bindings once, in the order of the block.
+  std::vector<RNode*> all;
+  std::unordered_set<const RNode*> bound;
+  std::unordered_map<std::string, std::vector<RNode*>> index;
+  for (const Binding& binding : dfb->bindings) {
+    const auto* var_binding = binding.as<VarBindingNode>();
+    if (var_binding == nullptr) continue;
+    auto it = graph.var2node.find(var_binding->var.get());
+    if (it == graph.var2node.end()) continue;
+    all.push_back(&it->second);
+    bound.insert(&it->second);
+    for (const std::string& key : GetIndexKeys(var_binding->value)) {
+      index[key].push_back(&it->second);
+    }
+  }
+
+  // Start from the pattern with the fewest candidates.
+  static const std::vector<RNode*> none;
+  PNode* start = nullptr;
+  const std::vector<RNode*>* candidates = nullptr;
+  for (auto& ppair : graph.pattern2node) {
+    const std::vector<RNode*>* cur = &all;
+    if (Optional<String> key = GetPatternIndexKey(ppair.first)) {
+      auto it = index.find(key.value());
+      cur = it == index.end() ? &none : &it->second;
+    }
+    if (candidates == nullptr || cur->size() < candidates->size()) {
+      start = &ppair.second;
+      candidates = cur;
+    }
+  }
+
+  for (RNode* rnode : *candidates) {
+    if (rnode->matched != nullptr || !graph.TryMatch(start, rnode)) continue;
+    Map<DFPattern, Var> matched = graph.GetMatched();
+    for (auto& ppair : graph.pattern2node) {
+      RNode& matched_node = graph.var2node.at(ppair.second.matched);
+      ppair.second.matched = nullptr;
+      // The vars defined outside of the block, e.g. the params, can be shared by the matches.
+      matched_node.matched = bound.count(&matched_node) ? used_marker.get() : nullptr;
+    }
+    Optional<Map<Var, Expr>> rewritten = rewriter(matched);
+    if (!rewritten.defined()) continue;
+    for (const auto& kv : rewritten.value()) {
+      replacements.Set(kv.first, kv.second);
+    }
+  }
+  return replacements;
+}
+
+class BindingRewriter : public ExprMutator {
+ public:
+  explicit BindingRewriter(PatternContext ctx, PackedFunc rewriter)
+      : ctx_(std::move(ctx)), rewriter_(std::move(rewriter)) {}
+
+ private:
+  using ExprMutator::VisitBinding_;
+  using ExprMutator::VisitBindingBlock_;
+
+  BindingBlock VisitBindingBlock_(const DataflowBlockNode* block) final {
+    replacements_ = GetReplacements(ctx_, rewriter_, GetRef<DataflowBlock>(block));
+    BindingBlock ret = ExprMutator::VisitBindingBlock_(block);
+    replacements_ = {};
+    return ret;
+  }
+
+  void VisitBinding_(const VarBindingNode* binding) final {
+    Optional<Expr> replacement = replacements_.Get(binding->var);
+    if (!replacement.defined()) {
+      return ExprMutator::VisitBinding_(binding);
+    }
+    VarBinding rewritten(binding->var, replacement.value(), binding->span);
+    ExprMutator::VisitBinding_(rewritten.get());
+  }
+
+  /*! \brief The context of the graph of patterns. */
+  PatternContext ctx_;
+  /*! \brief The rewriter of each match. */
+  PackedFunc rewriter_;
+  /*! \brief The replacements of the bindings of the current block. */
+  Map<Var, Expr> replacements_;
+};
+
+Function RewriteBindings(const PatternContext& ctx, PackedFunc rewriter, Function f) {
+  ICHECK(ctx->allow_extern_use == PatternContextNode::kMay) << "Only kMay is supported yet.";
+  return Downcast<Function>(BindingRewriter(ctx, rewriter).VisitExpr(f));
+}
+
+TVM_REGISTER_GLOBAL("relax.dpl.rewrite_bindings").set_body_typed(RewriteBindings);
+
 }  // namespace relax
 }  // namespace tvm
@@ -17,6 +17,7 @@
  * under the License.
  */
 #include <tvm/relax/expr.h>
+#include <tvm/relax/object_pool.h>
 
 namespace tvm {
 
@@ -38,7 +39,7 @@ using tvm::runtime::Optional;
 TVM_REGISTER_NODE_TYPE(ShapeExprNode);
 
 ShapeExpr::ShapeExpr(Array<PrimExpr> values, Span span) {
-  ObjectPtr<ShapeExprNode> n = make_object<ShapeExprNode>();
+  ObjectPtr<ShapeExprNode> n = make_pooled_object<ShapeExprNode>();
   n->values = std::move(values);
   n->span = span;
   n->shape_ = NullOpt;
@@ -78,7 +79,7 @@ TVM_STATIC_IR_FUNCTOR(ReprPrinter, vtable)
 TVM_REGISTER_NODE_TYPE(VarNode);
 
 Var::Var(Id vid, Optional<Expr> shape_annotation, Optional<Type> type_annotation, Span span) {
-  ObjectPtr<VarNode> n = make_object<VarNode>();
+  ObjectPtr<VarNode> n = make_pooled_object<VarNode>();
   n->vid = std::move(vid);
   n->shape_ = std::move(shape_annotation);
   if (type_annotation) {
@@ -102,7 +103,7 @@ TVM_REGISTER_NODE_TYPE(DataflowVarNode);
 
 DataflowVar::DataflowVar(Id vid, Optional<Expr> shape_annotation, Optional<Type> type_annotation,
                          Span span) {
-  ObjectPtr<DataflowVarNode> n = make_object<DataflowVarNode>();
+  ObjectPtr<DataflowVarNode> n = make_pooled_object<DataflowVarNode>();
   n->vid = std::move(vid);
   n->shape_ = std::move(shape_annotation);
   if (type_annotation) {
@@ -129,7 +130,7 @@ TVM_REGISTER_NODE_TYPE(BindingNode);
 TVM_REGISTER_NODE_TYPE(MatchShapeNode);
 
 MatchShape::MatchShape(Expr value, Array<PrimExpr> pattern, Var var, Span span) {
-  ObjectPtr<MatchShapeNode> n = make_object<MatchShapeNode>();
+  ObjectPtr<MatchShapeNode> n = make_pooled_object<MatchShapeNode>();
   n->value = std::move(value);
   n->pattern = std::move(pattern);
   n->var = std::move(var);
@@ -145,7 +146,7 @@ TVM_REGISTER_GLOBAL("relax.MatchShape")
 TVM_REGISTER_NODE_TYPE(VarBindingNode);
 
 VarBinding::VarBinding(Var var, Expr value, Span span) {
-  ObjectPtr<VarBindingNode> n = make_object<VarBindingNode>();
+  ObjectPtr<VarBindingNode> n = make_pooled_object<VarBindingNode>();
   n->var = std::move(var);
   n->value = std::move(value);
   n->span = span;
@@ -185,7 +186,7 @@ TVM_REGISTER_GLOBAL("relax.DataflowBlock").set_body_typed([](Array<Binding> bind
 TVM_REGISTER_NODE_TYPE(SeqExprNode);
 
 SeqExpr::SeqExpr(Array<BindingBlock> blocks, Expr body, Span span) {
-  ObjectPtr<SeqExprNode> n = make_object<SeqExprNode>();
+  ObjectPtr<SeqExprNode> n = make_pooled_object<SeqExprNode>();
   n->blocks = std::move(blocks);
   n->body = std::move(body);
   n->span = span;
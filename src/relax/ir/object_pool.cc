@@ -0,0 +1,103 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/ir/object_pool.cc
+ * \brief The thread-local pools of the storage of the Relax IR nodes.
+ */
+#include <tvm/relax/object_pool.h>
+#include <tvm/runtime/logging.h>
+
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+/*! \brief The free storages of a thread, in size classes of kUnit bytes. */
+struct ObjectPool {
+  static constexpr size_t kUnit = alignof(std::max_align_t);
+  static constexpr size_t kNumSizeClasses = 32;
+
+  /*! \brief The number of scopes entered. */
+  int depth = 0;
+  /*! \brief The free storages of each size class. */
+  std::vector<void*> free_lists[kNumSizeClasses];
+
+  ~ObjectPool() {
+    for (std::vector<void*>& free_list : free_lists) {
+      for (void* ptr : free_list) {
+        ::operator delete(ptr);
+      }
+    }
+  }
+};
+
+/*!
+ * \brief The pool of the current thread, while it is in a scope. A plain pointer, so that it can
+ *  still be read by the nodes released at the exit of the thread.
+ */
+static thread_local ObjectPool* current_pool = nullptr;
+
+/*! \brief Get the size class of a size, kNumSizeClasses for the ones too large to be pooled. */
+static size_t GetSizeClass(size_t size) {
+  size_t size_class = (size + ObjectPool::kUnit - 1) / ObjectPool::kUnit;
+  return size_class < ObjectPool::kNumSizeClasses ? size_class : ObjectPool::kNumSizeClasses;
+}
+
+ObjectPoolScope::ObjectPoolScope() {
+  if (current_pool == nullptr) {
+    current_pool = new ObjectPool();
+  }
+  ++current_pool->depth;
+}
+
+ObjectPoolScope::~ObjectPoolScope() {
+  ICHECK(current_pool != nullptr && current_pool->depth > 0);
+  if (--current_pool->depth == 0) {
+    delete current_pool;
+    current_pool = nullptr;
+  }
+}
+
+void* ObjectPoolScope::Allocate(size_t size) {
+  size_t size_class = GetSizeClass(size);
+  if (current_pool != nullptr && size_class < ObjectPool::kNumSizeClasses) {
+    std::vector<void*>& free_list = current_pool->free_lists[size_class];
+    if (!free_list.empty()) {
+      void* ptr = free_list.back();
+      free_list.pop_back();
+      return ptr;
+    }
+  }
+  // The storage is allocated with the size of its class, to be reused by any size of the class.
+  return ::operator new(size_class < ObjectPool::kNumSizeClasses ? size_class * ObjectPool::kUnit
+                                                                 : size);
+}
+
+void ObjectPoolScope::Free(void* ptr, size_t size) {
+  size_t size_class = GetSizeClass(size);
+  if (current_pool != nullptr && size_class < ObjectPool::kNumSizeClasses) {
+    current_pool->free_lists[size_class].push_back(ptr);
+  } else {
+    ::operator delete(ptr);
+  }
+}
+
+}  // namespace relax
+}  // namespace tvm
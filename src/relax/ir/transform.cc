@@ -25,14 +25,27 @@
 #include <tvm/node/repr_printer.h>
 #include <tvm/relax/analysis.h>
 #include <tvm/relax/expr_functor.h>
+#include <tvm/relax/object_pool.h>
 #include <tvm/relax/transform.h>
 #include <tvm/relay/function.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/support/parallel_for.h>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
 namespace tvm {
 namespace relax {
 namespace transform {
 
 TVM_REGISTER_PASS_CONFIG_OPTION("relax.fallback_device_type", IntImm);
+// The number of threads the function passes process the functions of a module with, all the
+// hardware threads if non-positive. The pass functions must be thread-safe when it is not 1.
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.FunctionPass.num_threads", Integer);
+// Whether the function passes recycle the storage of the temporary Relax IR nodes they create,
+// see ObjectPoolScope.
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.FunctionPass.use_object_pool", Bool);
 
 // TODO(@yuchen): will need to dedup with FunctionPass in Relay when we upstream
 class FunctionPass;
@@ -144,8 +157,33 @@ IRModule FunctionPassNode::operator()(IRModule mod, const PassContext& pass_ctx)
     // only picks up relax::Function
     if (auto* n = it.second.as<FunctionNode>()) {
       Function func = GetRef<Function>(n);
-      auto updated_func = SkipFunction(func) ? func : pass_func(func, updated_mod, pass_ctx);
-      updates.push_back({it.first, updated_func});
+      if (!SkipFunction(func)) {
+        updates.push_back({it.first, func});
+      }
+    }
+  }
+
+  int num_threads =
+      pass_ctx->GetConfig<Integer>("relax.FunctionPass.num_threads", Integer(1)).value()->value;
+  if (num_threads <= 0) {
+    num_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  }
+  num_threads = std::min(num_threads, static_cast<int>(updates.size()));
+  bool use_object_pool =
+      pass_ctx->GetConfig<Bool>("relax.FunctionPass.use_object_pool", Bool(false)).value();
+  // The functions are only read by the pass functions, the results are merged in order below.
+  auto f_update = [&](int thread_id, int i) {
+    std::unique_ptr<ObjectPoolScope> pool_scope;
+    if (use_object_pool) pool_scope = std::make_unique<ObjectPoolScope>();
+    // The pass context is thread local, e.g. for the pass functions calling other passes.
+    PassContextThreadScope scope(pass_ctx);
+    updates[i].second = pass_func(updates[i].second, updated_mod, pass_ctx);
+  };
+  if (num_threads > 1) {
+    support::parallel_for_dynamic(0, updates.size(), num_threads, f_update);
+  } else {
+    for (size_t i = 0; i < updates.size(); ++i) {
+      f_update(0, i);
     }
   }
 
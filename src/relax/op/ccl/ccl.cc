@@ -0,0 +1,106 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file ccl.cc
+ * \brief collective communication operators.
+ *
+ * The operators run in the VM of each worker of a group executing the same program, e.g. the
+ * shards of a tensor parallel model, on the communicator set on the VM. They are called as
+ * packed functions that enqueue the communication on the current stream of the device, so the
+ * VM codegen overlaps them with the independent kernels when it distributes the kernels over
+ * several streams.
+ */
+
+#include "ccl.h"
+
+namespace tvm {
+namespace relax {
+
+TVM_REGISTER_NODE_TYPE(CCLAttrs);
+
+Expr MakeCCL(const char* op_name, Expr data, String op_type, int num_workers) {
+  auto attrs = make_object<CCLAttrs>();
+  attrs->op_type = op_type;
+  attrs->num_workers = num_workers;
+  const Op& op = Op::Get(op_name);
+  return Call(op, {data}, Attrs(attrs), {});
+}
+
+RELAY_REGISTER_OP("relax.ccl.allreduce")
+    .describe("Reduce the tensors of all the workers, each worker getting the result.")
+    .set_num_inputs(1)
+    .add_argument("data", "Tensor", "The input tensor.")
+    .set_attrs_type<CCLAttrs>()
+    .set_attr<FInferShape>("FInferShape", InferShapeAllReduce)
+    .set_attr<FInferType>("FInferType", InferTypeCCL)
+    .set_attr<FCallPacked>("FCallPacked", "vm.builtin.ccl.allreduce")
+    .set_attr<TStreamOrdered>("TStreamOrdered", Bool(true));
+
+TVM_REGISTER_GLOBAL("relax.op.ccl.allreduce").set_body_typed([](Expr data, String op_type) {
+  return MakeCCL("relax.ccl.allreduce", data, op_type, 1);
+});
+
+RELAY_REGISTER_OP("relax.ccl.allgather")
+    .describe("Concatenate the tensors of all the workers along the first axis, in rank order.")
+    .set_num_inputs(1)
+    .add_argument("data", "Tensor", "The input tensor.")
+    .set_attrs_type<CCLAttrs>()
+    .set_attr<FInferShape>("FInferShape", InferShapeCCL<true>)
+    .set_attr<FInferType>("FInferType", InferTypeCCL)
+    .set_attr<FCallPacked>("FCallPacked", "vm.builtin.ccl.allgather")
+    .set_attr<TStreamOrdered>("TStreamOrdered", Bool(true));
+
+TVM_REGISTER_GLOBAL("relax.op.ccl.allgather").set_body_typed([](Expr data, int num_workers) {
+  return MakeCCL("relax.ccl.allgather", data, "sum", num_workers);
+});
+
+RELAY_REGISTER_OP("relax.ccl.reduce_scatter")
+    .describe("Reduce the tensors of all the workers, each worker getting its chunk of the "
+              "result along the first axis.")
+    .set_num_inputs(1)
+    .add_argument("data", "Tensor", "The input tensor.")
+    .set_attrs_type<CCLAttrs>()
+    .set_attr<FInferShape>("FInferShape", InferShapeCCL<false>)
+    .set_attr<FInferType>("FInferType", InferTypeCCL)
+    .set_attr<FCallPacked>("FCallPacked", "vm.builtin.ccl.reduce_scatter")
+    .set_attr<TStreamOrdered>("TStreamOrdered", Bool(true));
+
+TVM_REGISTER_GLOBAL("relax.op.ccl.reduce_scatter")
+    .set_body_typed([](Expr data, int num_workers, String op_type) {
+      return MakeCCL("relax.ccl.reduce_scatter", data, op_type, num_workers);
+    });
+
+// The chunk is a view of the input, so no work is enqueued.
+RELAY_REGISTER_OP("relax.ccl.local_shard")
+    .describe("The chunk of the worker of a tensor replicated on all the workers, along the "
+              "first axis.")
+    .set_num_inputs(1)
+    .add_argument("data", "Tensor", "The input tensor.")
+    .set_attrs_type<CCLAttrs>()
+    .set_attr<FInferShape>("FInferShape", InferShapeCCL<false>)
+    .set_attr<FInferType>("FInferType", InferTypeCCL)
+    .set_attr<FCallPacked>("FCallPacked", "vm.builtin.ccl.local_shard");
+
+TVM_REGISTER_GLOBAL("relax.op.ccl.local_shard").set_body_typed([](Expr data, int num_workers) {
+  return MakeCCL("relax.ccl.local_shard", data, "sum", num_workers);
+});
+
+}  // namespace relax
+}  // namespace tvm
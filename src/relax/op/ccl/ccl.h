@@ -0,0 +1,98 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file ccl.h
+ * \brief shape and type deduction for the collective communication operators.
+ */
+
+#ifndef TVM_RELAX_OP_CCL_CCL_H_
+#define TVM_RELAX_OP_CCL_CCL_H_
+
+#include <tvm/relax/expr.h>
+#include <tvm/relax/type.h>
+#include <tvm/tir/op.h>
+
+#include "../op_common.h"
+
+namespace tvm {
+namespace relax {
+
+Optional<Expr> InferShapeAllReduce(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 1) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span) << "Collective op should have 1 argument");
+  }
+  Expr shape = call->args[0]->shape();
+  if (shape->IsInstance<ShapeExprNode>()) {
+    return shape;
+  }
+  return NullOpt;
+}
+
+/*!
+ * \brief The shape of the output of a collective, whose first axis is the one of the input
+ * multiplied (gather) or divided (scatter) by the number of workers.
+ */
+template <bool gather>
+Optional<Expr> InferShapeCCL(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 1) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span) << "Collective op should have 1 argument");
+  }
+  const auto* attrs = call->attrs.as<CCLAttrs>();
+  auto* shape = call->args[0]->shape().as<ShapeExprNode>();
+  if (!shape) {
+    return NullOpt;
+  }
+  if (shape->values.empty()) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "Collective op expects a tensor of at least one dimension");
+  }
+  Array<PrimExpr> output_shape = shape->values;
+  PrimExpr dim = output_shape[0];
+  if (gather) {
+    output_shape.Set(0, dim * attrs->num_workers);
+  } else {
+    const auto* dim_imm = dim.as<IntImmNode>();
+    if (dim_imm && dim_imm->value % attrs->num_workers != 0) {
+      diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                         << "The first dimension " << dim << " is not divisible by the "
+                         << attrs->num_workers << " workers");
+    }
+    output_shape.Set(0, floordiv(dim, attrs->num_workers));
+  }
+  return ShapeExpr(output_shape);
+}
+
+Type InferTypeCCL(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 1) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span) << "Collective op should have 1 argument");
+  }
+  auto* input_ty = call->args[0]->checked_type().as<DynTensorTypeNode>();
+  if (!input_ty) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "Input should be DynTensor, but got "
+                       << call->args[0]->checked_type()->GetTypeKey());
+  }
+  return GetRef<DynTensorType>(input_ty);
+}
+
+}  // namespace relax
+}  // namespace tvm
+
+#endif  // TVM_RELAX_OP_CCL_CCL_H_
@@ -0,0 +1,171 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file nn.cc
+ * \brief neural network operators.
+ *
+ * The operators share the names and the attributes of their Relay counterparts when those exist,
+ * so that they are lowered the same way, e.g. by LowerWithRelayOpStrategyPass.
+ */
+
+#include "nn.h"
+
+namespace tvm {
+namespace relax {
+
+RELAY_REGISTER_OP("relax.nn.matmul")
+    .describe("Multiply an input of shape [..., K] by a weight of shape [K, N], or [N, K] when "
+              "transpose_b is set.")
+    .set_num_inputs(2)
+    .add_argument("data", "Tensor", "The input tensor.")
+    .add_argument("weight", "Tensor", "The weight tensor.")
+    .set_attrs_type<relay::MatmulAttrs>()
+    .set_attr<FInferShape>("FInferShape", InferShapeMatmul)
+    .set_attr<FInferType>("FInferType", InferTypeMatmul)
+    .set_attr<TMixedPrecisionPolicy>("TMixedPrecisionPolicy", Integer(kMixedPrecisionAlways));
+
+Expr MakeMatmul(Expr data, Expr weight, bool transpose_b, DataType out_dtype) {
+  auto attrs = make_object<relay::MatmulAttrs>();
+  attrs->transpose_a = false;
+  attrs->transpose_b = transpose_b;
+  attrs->out_dtype = out_dtype;
+  static const Op& op = Op::Get("relax.nn.matmul");
+  return Call(op, {data, weight}, Attrs(attrs));
+}
+
+TVM_REGISTER_GLOBAL("relax.op.nn.matmul").set_body_typed(MakeMatmul);
+
+RELAY_REGISTER_OP("relax.nn.relu")
+    .describe("Elementwise rectified linear unit, max(x, 0).")
+    .set_num_inputs(1)
+    .add_argument("data", "Tensor", "The input tensor.")
+    .set_attr<FInferShape>("FInferShape", InferShapeUnaryElementwise)
+    .set_attr<FInferType>("FInferType", InferTypeUnaryElementwise)
+    .set_attr<TMixedPrecisionPolicy>("TMixedPrecisionPolicy", Integer(kMixedPrecisionFollow));
+
+TVM_REGISTER_GLOBAL("relax.op.nn.relu").set_body_typed([](Expr data) {
+  static const Op& op = Op::Get("relax.nn.relu");
+  return Call(op, {data}, Attrs(), {});
+});
+
+// Relay has no gelu operator to lower to, it runs as a packed function like unique.
+RELAY_REGISTER_OP("relax.nn.gelu")
+    .describe("Elementwise Gaussian error linear unit, in its tanh approximation.")
+    .set_num_inputs(1)
+    .add_argument("data", "Tensor", "The input tensor.")
+    .set_attr<FInferShape>("FInferShape", InferShapeUnaryElementwise)
+    .set_attr<FInferType>("FInferType", InferTypeUnaryElementwise)
+    .set_attr<FCallPacked>("FCallPacked", "relax.run.gelu")
+    .set_attr<TMixedPrecisionPolicy>("TMixedPrecisionPolicy", Integer(kMixedPrecisionFollow));
+
+TVM_REGISTER_GLOBAL("relax.op.nn.gelu").set_body_typed([](Expr data) {
+  static const Op& op = Op::Get("relax.nn.gelu");
+  return Call(op, {data}, Attrs(), {});
+});
+
+TVM_REGISTER_NODE_TYPE(AttentionAttrs);
+
+// Relay has no attention operator, it is lowered to the fused kernels of topi.nn.flash_attention.
+RELAY_REGISTER_OP("relax.nn.attention")
+    .describe(
+        "Scaled dot-product attention of a query of shape [batch, seq_len, num_heads, head_dim] "
+        "over a key and a value of shape [batch, kv_seq_len, num_heads, head_dim(_v)].")
+    .set_num_inputs(3)
+    .add_argument("query", "Tensor", "The query tensor.")
+    .add_argument("key", "Tensor", "The key tensor.")
+    .add_argument("value", "Tensor", "The value tensor.")
+    .set_attrs_type<AttentionAttrs>()
+    .set_attr<FInferShape>("FInferShape", InferShapeAttention)
+    .set_attr<FInferType>("FInferType", InferTypeAttention)
+    .set_attr<TMixedPrecisionPolicy>("TMixedPrecisionPolicy", Integer(kMixedPrecisionAlways));
+
+Expr MakeAttention(Expr query, Expr key, Expr value, double scale, bool causal) {
+  auto attrs = make_object<AttentionAttrs>();
+  attrs->scale = scale;
+  attrs->causal = causal;
+  static const Op& op = Op::Get("relax.nn.attention");
+  return Call(op, {query, key, value}, Attrs(attrs));
+}
+
+TVM_REGISTER_GLOBAL("relax.op.nn.attention").set_body_typed(MakeAttention);
+
+RELAY_REGISTER_OP("relax.nn.softmax")
+    .describe("Softmax over an axis.")
+    .set_num_inputs(1)
+    .add_argument("data", "Tensor", "The input tensor.")
+    .set_attrs_type<relay::SoftmaxAttrs>()
+    .set_attr<FInferShape>("FInferShape", InferShapeUnaryElementwise)
+    .set_attr<FInferType>("FInferType", InferTypeUnaryElementwise)
+    .set_attr<TMixedPrecisionPolicy>("TMixedPrecisionPolicy", Integer(kMixedPrecisionNever));
+
+TVM_REGISTER_GLOBAL("relax.op.nn.softmax").set_body_typed([](Expr data, int axis) {
+  auto attrs = make_object<relay::SoftmaxAttrs>();
+  attrs->axis = axis;
+  static const Op& op = Op::Get("relax.nn.softmax");
+  return Call(op, {data}, Attrs(attrs));
+});
+
+RELAY_REGISTER_OP("relax.nn.layer_norm")
+    .describe("Layer normalization over an axis, scaled by gamma and shifted by beta.")
+    .set_num_inputs(3)
+    .add_argument("data", "Tensor", "The input tensor.")
+    .add_argument("gamma", "Tensor", "The 1-D scale.")
+    .add_argument("beta", "Tensor", "The 1-D shift.")
+    .set_attrs_type<relay::LayerNormAttrs>()
+    .set_attr<FInferShape>("FInferShape", InferShapeNorm<relay::LayerNormAttrs>)
+    .set_attr<FInferType>("FInferType", InferTypeNorm)
+    .set_attr<TMixedPrecisionPolicy>("TMixedPrecisionPolicy", Integer(kMixedPrecisionNever));
+
+Expr MakeLayerNorm(Expr data, Expr gamma, Expr beta, int axis, double epsilon, bool center,
+                   bool scale) {
+  auto attrs = make_object<relay::LayerNormAttrs>();
+  attrs->axis = axis;
+  attrs->epsilon = epsilon;
+  attrs->center = center;
+  attrs->scale = scale;
+  static const Op& op = Op::Get("relax.nn.layer_norm");
+  return Call(op, {data, gamma, beta}, Attrs(attrs));
+}
+
+TVM_REGISTER_GLOBAL("relax.op.nn.layer_norm").set_body_typed(MakeLayerNorm);
+
+TVM_REGISTER_NODE_TYPE(RMSNormAttrs);
+
+RELAY_REGISTER_OP("relax.nn.rms_norm")
+    .describe("Root mean square normalization over an axis, scaled by a weight.")
+    .set_num_inputs(2)
+    .add_argument("data", "Tensor", "The input tensor.")
+    .add_argument("weight", "Tensor", "The 1-D scale.")
+    .set_attrs_type<RMSNormAttrs>()
+    .set_attr<FInferShape>("FInferShape", InferShapeNorm<RMSNormAttrs>)
+    .set_attr<FInferType>("FInferType", InferTypeNorm)
+    .set_attr<TMixedPrecisionPolicy>("TMixedPrecisionPolicy", Integer(kMixedPrecisionNever));
+
+TVM_REGISTER_GLOBAL("relax.op.nn.rms_norm")
+    .set_body_typed([](Expr data, Expr weight, int axis, double epsilon) {
+      auto attrs = make_object<RMSNormAttrs>();
+      attrs->axis = axis;
+      attrs->epsilon = epsilon;
+      static const Op& op = Op::Get("relax.nn.rms_norm");
+      return Call(op, {data, weight}, Attrs(attrs));
+    });
+
+}  // namespace relax
+}  // namespace tvm
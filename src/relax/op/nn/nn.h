@@ -0,0 +1,223 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file nn.h
+ * \brief shape and type deduction for neural network operators.
+ */
+
+#ifndef TVM_RELAX_OP_NN_NN_H_
+#define TVM_RELAX_OP_NN_NN_H_
+
+#include <tvm/relax/expr.h>
+#include <tvm/relax/type.h>
+#include <tvm/relay/attrs/nn.h>
+
+#include <vector>
+
+#include "../op_common.h"
+
+namespace tvm {
+namespace relax {
+
+Optional<Expr> InferShapeMatmul(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 2) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span) << "Matmul op should have 2 arguments");
+  }
+  const auto* attrs = call->attrs.as<relay::MatmulAttrs>();
+  auto* s0 = call->args[0]->shape().as<ShapeExprNode>();
+  auto* s1 = call->args[1]->shape().as<ShapeExprNode>();
+  if (!s0 || !s1) {
+    return NullOpt;
+  }
+  if (s0->values.empty() || s1->values.size() != 2) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "Matmul expects an input of shape [..., K] and a weight of shape [K, N], "
+                       << "or [N, K] when transposed");
+  }
+  PrimExpr k = s1->values[attrs->transpose_b ? 1 : 0];
+  PrimExpr n = s1->values[attrs->transpose_b ? 0 : 1];
+  if (!EqualCheck(s0->values.back(), k)) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "The reduction dimensions of matmul " << s0->values.back() << " and "
+                       << k << " must be equal");
+  }
+  std::vector<PrimExpr> output_shape(s0->values.begin(), s0->values.end() - 1);
+  output_shape.push_back(n);
+  return ShapeExpr(Array<PrimExpr>(output_shape));
+}
+
+Type InferTypeMatmul(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 2) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span) << "Matmul op should have 2 arguments");
+  }
+  auto* t0 = call->args[0]->checked_type().as<DynTensorTypeNode>();
+  auto* t1 = call->args[1]->checked_type().as<DynTensorTypeNode>();
+  if (!t0 || !t1) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "Both inputs of matmul should be DynTensor");
+  }
+  if (!t0->IsUnknownDtype() && !t1->IsUnknownDtype() && t0->dtype != t1->dtype) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "Data types " << t0->dtype << " and " << t1->dtype
+                       << " of matmul must be equal");
+  }
+  const auto* attrs = call->attrs.as<relay::MatmulAttrs>();
+  DataType output_dtype = attrs->out_dtype.bits() == 0 ? t0->dtype : attrs->out_dtype;
+  return DynTensorType(t0->ndim, output_dtype);
+}
+
+Optional<Expr> InferShapeUnaryElementwise(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 1) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span) << "Elementwise op should have 1 argument");
+  }
+  Expr shape = call->args[0]->shape();
+  if (shape->IsInstance<ShapeExprNode>()) {
+    return shape;
+  }
+  return NullOpt;
+}
+
+Type InferTypeUnaryElementwise(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 1) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span) << "Elementwise op should have 1 argument");
+  }
+  auto* input_ty = call->args[0]->checked_type().as<DynTensorTypeNode>();
+  if (!input_ty) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "Input should be DynTensor, but got "
+                       << call->args[0]->checked_type()->GetTypeKey());
+  }
+  return GetRef<DynTensorType>(input_ty);
+}
+
+Optional<Expr> InferShapeAttention(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 3) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span) << "Attention op should have 3 arguments");
+  }
+  auto* q = call->args[0]->shape().as<ShapeExprNode>();
+  auto* k = call->args[1]->shape().as<ShapeExprNode>();
+  auto* v = call->args[2]->shape().as<ShapeExprNode>();
+  if (!q || !k || !v) {
+    return NullOpt;
+  }
+  if (q->values.size() != 4 || k->values.size() != 4 || v->values.size() != 4) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "Attention expects the query, key and value of shape "
+                       << "[batch, seq_len, num_heads, head_dim]");
+  }
+  auto check_equal = [&](const PrimExpr& a, const PrimExpr& b, const char* what) {
+    if (!EqualCheck(a, b)) {
+      diag_ctx.EmitFatal(Diagnostic::Error(call->span) << "The " << what << " " << a << " and "
+                                                       << b << " of attention must be equal");
+    }
+  };
+  check_equal(q->values[0], k->values[0], "batch sizes of the query and the key");
+  check_equal(q->values[0], v->values[0], "batch sizes of the query and the value");
+  check_equal(q->values[2], k->values[2], "numbers of heads of the query and the key");
+  check_equal(q->values[2], v->values[2], "numbers of heads of the query and the value");
+  check_equal(q->values[3], k->values[3], "head dimensions of the query and the key");
+  check_equal(k->values[1], v->values[1], "sequence lengths of the key and the value");
+  return ShapeExpr({q->values[0], q->values[1], q->values[2], v->values[3]});
+}
+
+Type InferTypeAttention(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 3) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span) << "Attention op should have 3 arguments");
+  }
+  DataType dtype;
+  for (const Expr& arg : call->args) {
+    auto* ty = arg->checked_type().as<DynTensorTypeNode>();
+    if (!ty) {
+      diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                         << "The inputs of attention should be DynTensor");
+    }
+    if (!ty->IsUnknownNdim() && ty->ndim != 4) {
+      diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                         << "The inputs of attention should be 4-D, but got " << ty->ndim);
+    }
+    if (ty->IsUnknownDtype()) continue;
+    if (dtype.bits() != 0 && dtype != ty->dtype) {
+      diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                         << "Data types " << dtype << " and " << ty->dtype
+                         << " of attention must be equal");
+    }
+    dtype = ty->dtype;
+  }
+  return DynTensorType(4, dtype);
+}
+
+/*!
+ * \brief The shape of the normalizations over an axis, layer_norm and rms_norm, whose first
+ * argument is the data and the others are 1-D parameters of the size of the axis.
+ */
+template <typename AttrsType>
+Optional<Expr> InferShapeNorm(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.empty()) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span) << "Normalization op should have arguments");
+  }
+  auto* data = call->args[0]->shape().as<ShapeExprNode>();
+  if (!data) {
+    return NullOpt;
+  }
+  int ndim = data->values.size();
+  int axis = call->attrs.as<AttrsType>()->axis;
+  if (axis < -ndim || axis >= ndim) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "The axis " << axis << " of the normalization is out of range for "
+                       << ndim << "-D data");
+  }
+  PrimExpr size = data->values[axis < 0 ? axis + ndim : axis];
+  for (size_t i = 1; i < call->args.size(); ++i) {
+    auto* param = call->args[i]->shape().as<ShapeExprNode>();
+    if (!param) continue;
+    if (param->values.size() != 1 || !EqualCheck(param->values[0], size)) {
+      diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                         << "The parameters of the normalization should be of shape [" << size
+                         << "], but got " << GetRef<ShapeExpr>(param));
+    }
+  }
+  return GetRef<ShapeExpr>(data);
+}
+
+Type InferTypeNorm(const Call& call, DiagnosticContext diag_ctx) {
+  auto* data = call->args[0]->checked_type().as<DynTensorTypeNode>();
+  if (!data) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "The data of normalization should be DynTensor");
+  }
+  for (size_t i = 1; i < call->args.size(); ++i) {
+    auto* param = call->args[i]->checked_type().as<DynTensorTypeNode>();
+    if (!param) {
+      diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                         << "The parameters of normalization should be DynTensor");
+    }
+    if (!data->IsUnknownDtype() && !param->IsUnknownDtype() && data->dtype != param->dtype) {
+      diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                         << "Data types " << data->dtype << " and " << param->dtype
+                         << " of normalization must be equal");
+    }
+  }
+  return GetRef<DynTensorType>(data);
+}
+
+}  // namespace relax
+}  // namespace tvm
+
+#endif  // TVM_RELAX_OP_NN_NN_H_
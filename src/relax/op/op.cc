@@ -22,6 +22,8 @@
 #include <tvm/relax/utils.h>
 #include <tvm/relay/op.h>
 
+#include <unordered_map>
+
 #include "op_common.h"
 
 namespace tvm {
@@ -33,6 +35,7 @@ TVM_REGISTER_NODE_TYPE(MemAllocTensorAttrs);
 TVM_REGISTER_NODE_TYPE(VMAllocStorageAttrs);
 TVM_REGISTER_NODE_TYPE(VMAllocTensorAttrs);
 TVM_REGISTER_NODE_TYPE(ShapeHeapAttrs);
+TVM_REGISTER_NODE_TYPE(ComputeShapeAttrs);
 
 bool EqualConstInt(const PrimExpr& lhs, int64_t value) {
   if (const int64_t* pvalue = tir::as_const_int(lhs)) {
@@ -41,17 +44,44 @@ bool EqualConstInt(const PrimExpr& lhs, int64_t value) {
   return false;
 }
 
+/*!
+ * \brief The analyzer and the results of EqualCheck on the current thread. The ops of a function
+ *  usually share the same few symbolic dimensions, so the same differences are checked many times.
+ */
+struct EqualCheckCache {
+  /*! \brief The maximum number of cached results, beyond which the cache is cleared. */
+  static constexpr size_t kMaxSize = 4096;
+  /*! \brief The analyzer, without any bound so that its results hold in any context. */
+  arith::Analyzer analyzer;
+  /*! \brief Whether a symbolic difference is simplified to zero. */
+  std::unordered_map<PrimExpr, bool, StructuralHash, StructuralEqual> is_zero;
+
+  static EqualCheckCache* ThreadLocal() {
+    static thread_local EqualCheckCache inst;
+    return &inst;
+  }
+};
+
 bool EqualCheck(const PrimExpr& lhs, const PrimExpr& rhs) {
+  if (lhs.same_as(rhs)) {
+    return true;
+  }
   PrimExpr diff = lhs - rhs;
   if (const int64_t* pdiff = tir::as_const_int(diff)) {
     return pdiff[0] == 0;
   }
-  tvm::arith::Analyzer ana;
-  diff = ana.Simplify(diff);
-  if (const int64_t* pdiff = tir::as_const_int(diff)) {
-    return pdiff[0] == 0;
+  EqualCheckCache* cache = EqualCheckCache::ThreadLocal();
+  auto it = cache->is_zero.find(diff);
+  if (it != cache->is_zero.end()) {
+    return it->second;
   }
-  return false;
+  const int64_t* pdiff = tir::as_const_int(cache->analyzer.Simplify(diff));
+  bool is_zero = pdiff != nullptr && pdiff[0] == 0;
+  if (cache->is_zero.size() >= EqualCheckCache::kMaxSize) {
+    cache->is_zero.clear();
+  }
+  cache->is_zero.emplace(diff, is_zero);
+  return is_zero;
 }
 
 Type ReturnVoidType(const Call& call, DiagnosticContext diag_ctx) { return VoidType(); }
@@ -166,6 +196,99 @@ Expr MakeAssertOp(Expr condition, Array<Expr> vals, std::string format) {
 
 TVM_REGISTER_GLOBAL("relax.op.assert_op").set_body_typed(MakeAssertOp);
 
+// param_load
+
+TVM_REGISTER_NODE_TYPE(ParamLoadAttrs);
+
+Optional<Expr> InferShapeParamLoad(const Call& call, DiagnosticContext diag_ctx) {
+  return ShapeExpr(call->attrs.as<ParamLoadAttrs>()->shape);
+}
+
+Type InferTypeParamLoad(const Call& call, DiagnosticContext diag_ctx) {
+  auto attrs = call->attrs.as<ParamLoadAttrs>();
+  return DynTensorType(attrs->shape.size(), attrs->dtype);
+}
+
+RELAY_REGISTER_OP("relax.param_load")
+    .set_attrs_type<ParamLoadAttrs>()
+    .set_num_inputs(0)
+    .set_attr<FInferShape>("FInferShape", InferShapeParamLoad)
+    .set_attr<FInferType>("FInferType", InferTypeParamLoad)
+    .set_attr<FCallPacked>("FCallPacked", "vm.builtin.param_load");
+
+Expr MakeParamLoad(String name, Array<PrimExpr> shape, DataType dtype) {
+  auto attrs = make_object<ParamLoadAttrs>();
+  attrs->name = name;
+  attrs->shape = std::move(shape);
+  attrs->dtype = dtype;
+  static const Op& op = Op::Get("relax.param_load");
+  return Call(op, {}, Attrs(attrs));
+}
+
+TVM_REGISTER_GLOBAL("relax.op.param_load").set_body_typed(MakeParamLoad);
+
+// prefetch and prefetch_wait
+
+TVM_REGISTER_NODE_TYPE(PrefetchAttrs);
+
+Optional<Expr> InferShapePrefetch(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 1) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span) << "Prefetch op should have 1 argument");
+  }
+  Expr shape = call->args[0]->shape();
+  if (shape->IsInstance<ShapeExprNode>()) {
+    return shape;
+  }
+  return NullOpt;
+}
+
+Type InferTypePrefetch(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 1) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span) << "Prefetch op should have 1 argument");
+  }
+  auto* input_ty = call->args[0]->checked_type().as<DynTensorTypeNode>();
+  if (!input_ty) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "Input should be DynTensor, but got "
+                       << call->args[0]->checked_type()->GetTypeKey());
+  }
+  return GetRef<DynTensorType>(input_ty);
+}
+
+RELAY_REGISTER_OP("relax.prefetch")
+    .describe("Start copying a tensor to a memory scope of its device, e.g. by DMA to the VTCM "
+              "of Hexagon. The copy is only valid once passed through relax.prefetch_wait.")
+    .set_attrs_type<PrefetchAttrs>()
+    .set_num_inputs(1)
+    .add_argument("data", "Tensor", "The tensor to copy.")
+    .set_attr<FInferShape>("FInferShape", InferShapePrefetch)
+    .set_attr<FInferType>("FInferType", InferTypePrefetch)
+    .set_attr<FCallPacked>("FCallPacked", "vm.builtin.prefetch");
+
+Expr MakePrefetch(Expr data, String scope) {
+  auto attrs = make_object<PrefetchAttrs>();
+  attrs->scope = scope;
+  static const Op& op = Op::Get("relax.prefetch");
+  return Call(op, {data}, Attrs(attrs), {});
+}
+
+TVM_REGISTER_GLOBAL("relax.op.prefetch").set_body_typed(MakePrefetch);
+
+RELAY_REGISTER_OP("relax.prefetch_wait")
+    .describe("Wait for the copy started by relax.prefetch, returning the copied tensor.")
+    .set_num_inputs(1)
+    .add_argument("data", "Tensor", "The result of relax.prefetch.")
+    .set_attr<FInferShape>("FInferShape", InferShapePrefetch)
+    .set_attr<FInferType>("FInferType", InferTypePrefetch)
+    .set_attr<FCallPacked>("FCallPacked", "vm.builtin.prefetch_wait");
+
+Expr MakePrefetchWait(Expr data) {
+  static const Op& op = Op::Get("relax.prefetch_wait");
+  return Call(op, {data}, {}, {});
+}
+
+TVM_REGISTER_GLOBAL("relax.op.prefetch_wait").set_body_typed(MakePrefetchWait);
+
 // make_closure
 
 RELAY_REGISTER_OP("relax.make_closure")
@@ -408,6 +531,24 @@ Expr MakeLoadShape(Expr heap, Array<Integer> indices) {
 
 TVM_REGISTER_GLOBAL("relax.op.vm.builtin.load_shape").set_body_typed(MakeLoadShape);
 
+// vm compute_shape
+
+RELAY_REGISTER_OP("relax.vm.builtin.compute_shape")
+    .set_attrs_type<ComputeShapeAttrs>()
+    .set_num_inputs(1)
+    .add_argument("heap", "Expr", "The heap to compute the shape values on.")
+    .set_attr<FInferType>("FInferType", ReturnVoidType);
+
+Expr MakeComputeShape(Expr heap, Array<PrimExpr> values, Array<Integer> indices) {
+  auto attrs = make_object<ComputeShapeAttrs>();
+  attrs->values = std::move(values);
+  attrs->indices = std::move(indices);
+  static const Op& op = Op::Get("relax.vm.builtin.compute_shape");
+  return Call(op, {heap}, Attrs(attrs), {});
+}
+
+TVM_REGISTER_GLOBAL("relax.op.vm.builtin.compute_shape").set_body_typed(MakeComputeShape);
+
 // vm call_tir_dyn
 
 RELAY_REGISTER_OP("relax.vm.call_tir_dyn")
@@ -57,7 +57,9 @@ bool EqualCheck(const PrimExpr& lhs, const PrimExpr& rhs);
       .add_argument("lhs", "Tensor", "The left hand side tensor.")                \
       .add_argument("rhs", "Tensor", "The right hand side tensor.")               \
       .set_attr<FInferShape>("FInferShape", InferShapeBinaryBroadcast)            \
-      .set_attr<FInferType>("FInferType", InferTypeBinaryBroadcast)
+      .set_attr<FInferType>("FInferType", InferTypeBinaryBroadcast)               \
+      .set_attr<TMixedPrecisionPolicy>("TMixedPrecisionPolicy",                   \
+                                       Integer(kMixedPrecisionFollow))
 
 }  // namespace relax
 }  // namespace tvm
@@ -0,0 +1,83 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file quantize.cc
+ * \brief quantization operators.
+ */
+
+#include "quantize.h"
+
+namespace tvm {
+namespace relax {
+
+TVM_REGISTER_NODE_TYPE(QuantizeAttrs);
+
+RELAY_REGISTER_OP("relax.quantize")
+    .describe(
+        "Quantize a floating point tensor as `clip(round(data / scale) + zero_point)` in the "
+        "range of the output data type.")
+    .set_num_inputs(1)
+    .add_argument("data", "Tensor", "The input tensor")
+    .set_attrs_type<QuantizeAttrs>()
+    .set_attr<FInferShape>("FInferShape", InferShapeQuantize)
+    .set_attr<FInferType>("FInferType", InferTypeQuantize)
+    .set_attr<FCallPacked>("FCallPacked", "relax.run.quantize");
+
+Expr MakeQuantize(Expr data, double scale, int zero_point, DataType out_dtype) {
+  if (!out_dtype.is_int() && !out_dtype.is_uint()) {
+    LOG(FATAL) << "ValueError: quantize only supports integer output data types, but got "
+               << out_dtype;
+  }
+  auto attrs = make_object<QuantizeAttrs>();
+  attrs->scale = scale;
+  attrs->zero_point = zero_point;
+  attrs->out_dtype = out_dtype;
+  static const Op& op = Op::Get("relax.quantize");
+  return Call(op, {data}, Attrs(attrs));
+}
+
+TVM_REGISTER_GLOBAL("relax.op.quantize").set_body_typed(MakeQuantize);
+
+RELAY_REGISTER_OP("relax.dequantize")
+    .describe("Dequantize an integer tensor as `(data - zero_point) * scale`.")
+    .set_num_inputs(1)
+    .add_argument("data", "Tensor", "The input tensor")
+    .set_attrs_type<QuantizeAttrs>()
+    .set_attr<FInferShape>("FInferShape", InferShapeQuantize)
+    .set_attr<FInferType>("FInferType", InferTypeQuantize)
+    .set_attr<FCallPacked>("FCallPacked", "relax.run.dequantize");
+
+Expr MakeDequantize(Expr data, double scale, int zero_point, DataType out_dtype) {
+  if (!out_dtype.is_float()) {
+    LOG(FATAL) << "ValueError: dequantize only supports floating point output data types, but got "
+               << out_dtype;
+  }
+  auto attrs = make_object<QuantizeAttrs>();
+  attrs->scale = scale;
+  attrs->zero_point = zero_point;
+  attrs->out_dtype = out_dtype;
+  static const Op& op = Op::Get("relax.dequantize");
+  return Call(op, {data}, Attrs(attrs));
+}
+
+TVM_REGISTER_GLOBAL("relax.op.dequantize").set_body_typed(MakeDequantize);
+
+}  // namespace relax
+}  // namespace tvm
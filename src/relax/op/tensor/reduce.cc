@@ -0,0 +1,51 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file reduce.cc
+ * \brief reduction operators.
+ */
+
+#include "reduce.h"
+
+namespace tvm {
+namespace relax {
+
+RELAY_REGISTER_OP("relax.sum")
+    .describe("Sum of the elements over the given axes, all of them when no axis is given.")
+    .set_num_inputs(1)
+    .add_argument("data", "Tensor", "The input tensor.")
+    .set_attrs_type<relay::ReduceAttrs>()
+    .set_attr<FInferShape>("FInferShape", InferShapeReduce)
+    .set_attr<FInferType>("FInferType", InferTypeReduce)
+    .set_attr<TMixedPrecisionPolicy>("TMixedPrecisionPolicy", Integer(kMixedPrecisionNever));
+
+Expr MakeSum(Expr data, Array<Integer> axis, bool keepdims, bool exclude) {
+  auto attrs = make_object<relay::ReduceAttrs>();
+  attrs->axis = std::move(axis);
+  attrs->keepdims = keepdims;
+  attrs->exclude = exclude;
+  static const Op& op = Op::Get("relax.sum");
+  return Call(op, {data}, Attrs(attrs));
+}
+
+TVM_REGISTER_GLOBAL("relax.op.sum").set_body_typed(MakeSum);
+
+}  // namespace relax
+}  // namespace tvm
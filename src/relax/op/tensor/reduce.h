@@ -0,0 +1,109 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file reduce.h
+ * \brief shape and type deduction for reduction operators.
+ */
+
+#ifndef TVM_RELAX_OP_TENSOR_REDUCE_H_
+#define TVM_RELAX_OP_TENSOR_REDUCE_H_
+
+#include <tvm/relax/expr.h>
+#include <tvm/relax/type.h>
+#include <tvm/relay/attrs/reduce.h>
+
+#include <vector>
+
+#include "../op_common.h"
+
+namespace tvm {
+namespace relax {
+
+/*!
+ * \brief Whether each axis of an input of ndim dimensions is reduced, following the axis and the
+ * exclude attributes of relay::ReduceAttrs. No axis stands for all of them.
+ */
+inline std::vector<bool> ReducedAxes(const relay::ReduceAttrs* attrs, int ndim,
+                                     const Call& call, DiagnosticContext diag_ctx) {
+  std::vector<bool> reduced(ndim, !attrs->axis.defined() || attrs->axis.empty());
+  if (reduced.empty() || reduced[0]) {
+    return reduced;
+  }
+  for (const Integer& axis : attrs->axis) {
+    int64_t i = axis->value;
+    if (i < -ndim || i >= ndim) {
+      diag_ctx.EmitFatal(Diagnostic::Error(call->span) << "The axis " << i
+                                                       << " of the reduction is out of range for "
+                                                       << ndim << "-D data");
+    }
+    reduced[i < 0 ? i + ndim : i] = true;
+  }
+  if (attrs->exclude) {
+    reduced.flip();
+  }
+  return reduced;
+}
+
+Optional<Expr> InferShapeReduce(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 1) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span) << "Reduction op should have 1 argument");
+  }
+  auto* shape = call->args[0]->shape().as<ShapeExprNode>();
+  if (!shape) {
+    return NullOpt;
+  }
+  const auto* attrs = call->attrs.as<relay::ReduceAttrs>();
+  std::vector<bool> reduced = ReducedAxes(attrs, shape->values.size(), call, diag_ctx);
+  Array<PrimExpr> output_shape;
+  for (size_t i = 0; i < reduced.size(); ++i) {
+    if (!reduced[i]) {
+      output_shape.push_back(shape->values[i]);
+    } else if (attrs->keepdims) {
+      output_shape.push_back(IntImm(shape->values[i].dtype(), 1));
+    }
+  }
+  return ShapeExpr(output_shape);
+}
+
+Type InferTypeReduce(const Call& call, DiagnosticContext diag_ctx) {
+  if (call->args.size() != 1) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span) << "Reduction op should have 1 argument");
+  }
+  auto* input_ty = call->args[0]->checked_type().as<DynTensorTypeNode>();
+  if (!input_ty) {
+    diag_ctx.EmitFatal(Diagnostic::Error(call->span)
+                       << "Input should be DynTensor, but got "
+                       << call->args[0]->checked_type()->GetTypeKey());
+  }
+  const auto* attrs = call->attrs.as<relay::ReduceAttrs>();
+  if (input_ty->IsUnknownNdim() || attrs->keepdims) {
+    return GetRef<DynTensorType>(input_ty);
+  }
+  int num_kept = 0;
+  for (bool reduced : ReducedAxes(attrs, input_ty->ndim, call, diag_ctx)) {
+    num_kept += !reduced;
+  }
+  return DynTensorType(num_kept, input_ty->dtype);
+}
+
+}  // namespace relax
+}  // namespace tvm
+
+#endif  // TVM_RELAX_OP_TENSOR_REDUCE_H_
@@ -38,7 +38,8 @@ RELAY_REGISTER_OP("relax.unique")
     .set_attrs_type<UniqueAttrs>()
     .set_attr<FInferShape>("FInferShape", InferShapeUnique)
     .set_attr<FInferType>("FInferType", InferTypeUnique)
-    .set_attr<FCallPacked>("FCallPacked", "relax.run.unique");
+    .set_attr<FCallPacked>("FCallPacked", "relax.run.unique")
+    .set_attr<TMixedPrecisionPolicy>("TMixedPrecisionPolicy", Integer(kMixedPrecisionNever));
 
 Expr MakeUnique(Expr data, bool sorted, bool return_inverse, bool return_counts, int dim) {
   auto attrs = make_object<UniqueAttrs>();
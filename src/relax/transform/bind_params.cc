@@ -20,11 +20,14 @@
 #include <tvm/driver/driver_api.h>
 #include <tvm/relax/attrs/memory.h>
 #include <tvm/relax/expr_functor.h>
+#include <tvm/relax/op_attr_types.h>
 #include <tvm/relax/transform.h>
 #include <tvm/relax/type.h>
 #include <tvm/relay/interpreter.h>
 #include <tvm/tir/op.h>
 
+#include <string>
+#include <unordered_set>
 #include <utility>
 
 namespace tvm {
@@ -88,6 +91,78 @@ IRModule BindParam(IRModule m, String func_name, Map<String, runtime::NDArray> p
   return GetRef<IRModule>(new_module);
 }
 
+/*!
+ * \brief Load params of function from the param store of the VM by name, rather than taking
+ * them as inputs or embedding them as constants.
+ * \param func Relax function
+ * \param names The names of the params to load
+ * \return Function
+ */
+Function ExternalizeParamsByName(Function func, const Array<String>& names) {
+  std::unordered_set<std::string> name_set(names.begin(), names.end());
+  Array<Var> params;
+  Array<Binding> loads;
+  std::unordered_set<std::string> seen;
+  for (const Var& arg : func->params) {
+    const std::string& name = arg->name_hint();
+    if (!name_set.count(name)) {
+      params.push_back(arg);
+      continue;
+    }
+    if (!seen.insert(name).second) {
+      LOG(FATAL) << "ValueError: Multiple args in the function have name " << name;
+    }
+    const auto* type = arg->checked_type_.as<DynTensorTypeNode>();
+    const auto* shape = arg->shape_.as<ShapeExprNode>();
+    CHECK(type != nullptr && !type->IsUnknownDtype() && shape != nullptr)
+        << "ValueError: The param " << name << " must be a tensor of known shape and dtype";
+    for (const PrimExpr& dim : shape->values) {
+      CHECK(dim->IsInstance<IntImmNode>())
+          << "ValueError: The param " << name << " must have a static shape, got "
+          << GetRef<ShapeExpr>(shape);
+    }
+    // the param becomes a variable bound at the start of the function, so its uses are kept
+    static const Op& param_load_op = Op::Get("relax.param_load");
+    auto attrs = make_object<ParamLoadAttrs>();
+    attrs->name = name;
+    attrs->shape = shape->values;
+    attrs->dtype = type->dtype;
+    loads.push_back(VarBinding(arg, Call(param_load_op, {}, Attrs(attrs))));
+  }
+  if (loads.empty()) return func;
+
+  Array<BindingBlock> blocks = {BindingBlock(loads)};
+  Expr body = func->body;
+  if (const auto* seq = body.as<SeqExprNode>()) {
+    blocks.insert(blocks.end(), seq->blocks.begin(), seq->blocks.end());
+    body = seq->body;
+  }
+  return Function(params, SeqExpr(blocks, body), func->ret_type, func->ret_shape, func->attrs,
+                  func->span);
+}
+
+/*!
+ * \brief Externalize params of a specific function in a module
+ * \param m The module
+ * \param func_name The name of the specific function
+ * \param names The names of the params to load from the param store
+ * \return The module after externalizing the params.
+ */
+IRModule ExternalizeParam(IRModule m, String func_name, Array<String> names) {
+  IRModuleNode* new_module = m.CopyOnWrite();
+  Map<GlobalVar, BaseFunc> functions = m->functions;
+  for (const auto& func_pr : functions) {
+    if (const auto* relax_f = func_pr.second.as<FunctionNode>()) {
+      Optional<String> gsymbol = relax_f->GetAttr<String>(tvm::attr::kGlobalSymbol);
+      if (gsymbol.defined() && gsymbol.value() == func_name) {
+        Function f_after = ExternalizeParamsByName(GetRef<Function>(relax_f), names);
+        new_module->Update(func_pr.first, f_after);
+      }
+    }
+  }
+  return GetRef<IRModule>(new_module);
+}
+
 namespace transform {
 
 Pass BindParams(String func_name, Map<String, runtime::NDArray> params) {
@@ -98,6 +173,16 @@ Pass BindParams(String func_name, Map<String, runtime::NDArray> params) {
 
 TVM_REGISTER_GLOBAL("relax.transform.BindParams").set_body_typed(BindParams);
 
+Pass ExternalizeParams(String func_name, Array<String> names) {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
+      [=](IRModule mod, PassContext pc) {
+        return ExternalizeParam(std::move(mod), func_name, names);
+      };
+  return CreateModulePass(pass_func, 0, "ExternalizeParams", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.ExternalizeParams").set_body_typed(ExternalizeParams);
+
 }  // namespace transform
 
 }  // namespace relax
@@ -20,10 +20,12 @@
  * \file src/relax/transform/call_tir_rewrite.cc
  * \brief Perform explicit tensor allocation for call_tir.
  */
+#include <tvm/relax/analysis.h>
 #include <tvm/relax/attrs/memory.h>
 #include <tvm/relax/expr_functor.h>
 #include <tvm/relax/transform.h>
 #include <tvm/relax/type.h>
+#include <tvm/tir/function.h>
 #include <tvm/tir/op.h>
 
 #include "../../relay/transforms/pattern_utils.h"
@@ -39,10 +41,32 @@ namespace relax {
 // -->
 // gv0 = rx.call("relax.builtin.alloc_tensor", [n, m], dtype="float32")
 // rx.call_packed(func, x, gv0)
+//
+// When a binding is given an in-place input, no tensor is allocated and the input is passed
+// to the PrimFunc as the output:
+// lv0: Tensor(n, m) = rx.call_tir(func, (x), (n, m), dtype="float32")
+// -->
+// rx.call_packed(func, x, x)
+// lv0 = x
+//
+// The scratch buffers lifted into the trailing parameters of the PrimFunc by LiftTIRWorkspace
+// are allocated after the outputs and passed last.
 
 class CallTIRMutator : public ExprMutator {
  public:
+  explicit CallTIRMutator(Optional<IRModule> mod = NullOpt, Map<Var, Integer> inplace_inputs = {})
+      : mod_(std::move(mod)), inplace_inputs_(std::move(inplace_inputs)) {}
+
+  using ExprMutator::VisitBinding_;
   using ExprMutator::VisitExpr_;
+
+  void VisitBinding_(const VarBindingNode* binding) override {
+    Optional<Var> prev_var = binding_var_;
+    binding_var_ = binding->var;
+    ExprMutator::VisitBinding_(binding);
+    binding_var_ = prev_var;
+  }
+
   Expr VisitExpr_(const CallNode* call) override {
     // post-order mutation
     Expr expr = VisitExprPostOrder_(call);
@@ -54,7 +78,14 @@ class CallTIRMutator : public ExprMutator {
 
     if (call->op == call_tir_op) {
       Array<Expr> outs;
-      if (call->shape_) {
+      Optional<Integer> inplace_input;
+      if (binding_var_.defined() && call->args[1].as<TupleNode>()) {
+        inplace_input = inplace_inputs_.Get(binding_var_.value());
+      }
+      if (inplace_input.defined()) {
+        // write the output into the input, which dies at this call
+        outs.push_back(Downcast<Tuple>(call->args[1])->fields[inplace_input.value()->value]);
+      } else if (call->shape_) {
         if (call->shape_.value()->IsInstance<ShapeExprNode>()) {
           // single output case
           ShapeExpr output_shape = Downcast<ShapeExpr>(call->shape_.value());
@@ -108,6 +139,8 @@ class CallTIRMutator : public ExprMutator {
         args.insert(args.end(), outs.begin(), outs.end());
 
         if (call->args.size() == 3) {
+          Array<Expr> workspaces = EmitWorkspaces(call->args[0]);
+          args.insert(args.end(), workspaces.begin(), workspaces.end());
           builder_->Emit(Call(call->args[0], args), "_");
         } else {
           // unpack semantics
@@ -117,6 +150,8 @@ class CallTIRMutator : public ExprMutator {
       } else {
         args = outs;
         args.insert(args.begin(), call->args[1]);
+        Array<Expr> workspaces = EmitWorkspaces(call->args[0]);
+        args.insert(args.end(), workspaces.begin(), workspaces.end());
         builder_->Emit(Call(call->args[0], args), "_");
       }
 
@@ -128,15 +163,60 @@ class CallTIRMutator : public ExprMutator {
 
     return GetRef<Expr>(call);
   }
+
+ private:
+  /*! \brief Allocate the scratch buffers the callee PrimFunc takes after its outputs. */
+  Array<Expr> EmitWorkspaces(const Expr& callee) {
+    static const Op& alloc_tensor_op = Op::Get("relax.builtin.alloc_tensor");
+    Array<Expr> workspaces;
+    const auto* gvar = callee.as<GlobalVarNode>();
+    if (!mod_.defined() || gvar == nullptr || !mod_.value()->ContainGlobalVar(gvar->name_hint)) {
+      return workspaces;
+    }
+    const auto* func = mod_.value()->Lookup(gvar->name_hint).as<tir::PrimFuncNode>();
+    if (func == nullptr) return workspaces;
+    Optional<Integer> num_workspaces = func->GetAttr<Integer>(attr::kNumWorkspaces);
+    if (!num_workspaces.defined()) return workspaces;
+    size_t first = func->params.size() - num_workspaces.value()->value;
+    for (size_t i = first; i < func->params.size(); ++i) {
+      tir::Buffer buffer = func->buffer_map.Get(func->params[i]).value();
+      Array<PrimExpr> shape;
+      for (const PrimExpr& dim : buffer->shape) {
+        shape.push_back(IntImm(DataType::Int(64), Downcast<IntImm>(dim)->value));
+      }
+      auto alloc_tensor_attr = make_object<AllocTensorAttrs>();
+      alloc_tensor_attr->dtype = buffer->dtype;
+      alloc_tensor_attr->runtime_device_index = 0;
+      workspaces.push_back(builder_->Emit(
+          Call(alloc_tensor_op, {ShapeExpr(shape)}, Attrs(alloc_tensor_attr)),
+          "workspace"));
+    }
+    return workspaces;
+  }
+
+  /*! \brief The module of the PrimFuncs called, if known. */
+  Optional<IRModule> mod_;
+  /*! \brief The index of the input each call_tir binding writes its output into. */
+  Map<Var, Integer> inplace_inputs_;
+  /*! \brief The var of the binding being visited. */
+  Optional<Var> binding_var_;
 };
 
 Expr CallTIRRewrite(const Expr& e) { return CallTIRMutator().VisitExpr(e); }
 
+Function CallTIRRewrite(const IRModule& mod, const Function& f, bool inplace) {
+  Map<Var, Integer> inplace_inputs;
+  if (inplace) {
+    inplace_inputs = CallTIRInplaceInputs(mod, f);
+  }
+  return Downcast<Function>(CallTIRMutator(mod, inplace_inputs).VisitExpr(f));
+}
+
 namespace transform {
 
-Pass CallTIRRewrite() {
+Pass CallTIRRewrite(bool inplace) {
   runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
-      [=](Function f, IRModule m, PassContext pc) { return Downcast<Function>(CallTIRRewrite(f)); };
+      [=](Function f, IRModule m, PassContext pc) { return CallTIRRewrite(m, f, inplace); };
   return CreateFunctionPass(pass_func, 0, "CallTIRRewrite", {});
 }
 
@@ -0,0 +1,384 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/transform/combine_parallel_matmul.cc
+ * \brief Combine the matmuls of a DataflowBlock which share the same input into one wider matmul.
+ *
+ * For the call_tir bindings `y_i = matmul(x, w_i)` of a block, where the weights w_i are defined
+ * outside of the block, the pass emits
+ *
+ *     w = concat(w_0, ..., w_n)
+ *     y = matmul(x, w)
+ *     y_i = split_i(y)
+ *
+ * at the position of the first matmul. When the weights are constants, FoldConstant folds the
+ * concatenation at compile time.
+ */
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/dataflow_matcher.h>
+#include <tvm/relax/dataflow_pattern.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/transform.h>
+#include <tvm/te/operation.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/topi/transform.h>
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../../te/operation/create_primfunc.h"
+#include "utils.h"
+
+namespace tvm {
+namespace relax {
+
+std::unique_ptr<MatmulInfo> MatchMatmul(const tir::PrimFunc& func) {
+  if (func->params.size() != 3) return nullptr;
+  std::vector<tir::Buffer> buffers;
+  for (const tir::Var& param : func->params) {
+    auto it = func->buffer_map.find(param);
+    if (it == func->buffer_map.end()) return nullptr;
+    buffers.push_back((*it).second);
+  }
+  const tir::Buffer& a = buffers[0];
+  const tir::Buffer& w = buffers[1];
+  const tir::Buffer& c = buffers[2];
+  size_t ndim = c->shape.size();
+  if (ndim < 2 || a->shape.size() != ndim || w->shape.size() != 2 || a->dtype != c->dtype ||
+      w->dtype != c->dtype) {
+    return nullptr;
+  }
+  for (const tir::Buffer& buffer : buffers) {
+    for (const PrimExpr& extent : buffer->shape) {
+      if (!extent->IsInstance<IntImmNode>()) return nullptr;
+    }
+  }
+
+  // The function must consist of a single reduction block over the whole output.
+  std::vector<const tir::BlockRealizeNode*> realizes;
+  std::unordered_map<const tir::VarNode*, const tir::ForNode*> loops;
+  tir::PostOrderVisit(func->body, [&](const ObjectRef& obj) {
+    if (const auto* realize = obj.as<tir::BlockRealizeNode>()) {
+      if (!realize->block->iter_vars.empty()) realizes.push_back(realize);
+    } else if (const auto* loop = obj.as<tir::ForNode>()) {
+      loops[loop->loop_var.get()] = loop;
+    }
+  });
+  if (realizes.size() != 1) return nullptr;
+  const tir::BlockRealizeNode* realize = realizes[0];
+  const tir::BlockNode* block = realize->block.get();
+  if (!tir::is_one(realize->predicate) || !block->init.defined() ||
+      block->iter_vars.size() != ndim + 1) {
+    return nullptr;
+  }
+  Array<PrimExpr> extents = c->shape;
+  extents.push_back(a->shape[ndim - 1]);
+  Array<PrimExpr> spatial;
+  for (size_t i = 0; i <= ndim; ++i) {
+    const tir::IterVar& iter = block->iter_vars[i];
+    const auto* loop_var = realize->iter_values[i].as<tir::VarNode>();
+    tir::IterVarType iter_type = i < ndim ? tir::kDataPar : tir::kCommReduce;
+    if (iter->iter_type != iter_type || loop_var == nullptr || !loops.count(loop_var)) {
+      return nullptr;
+    }
+    const tir::ForNode* loop = loops.at(loop_var);
+    if (!tir::is_zero(iter->dom->min) || !tir::is_zero(loop->min) ||
+        !tir::is_const_int(iter->dom->extent, Downcast<IntImm>(extents[i])->value) ||
+        !tir::is_const_int(loop->extent, Downcast<IntImm>(extents[i])->value)) {
+      return nullptr;
+    }
+    if (i < ndim) spatial.push_back(iter->var);
+  }
+  tir::Var k = block->iter_vars[ndim]->var;
+  tir::Var j = block->iter_vars[ndim - 1]->var;
+
+  auto indices_equal = [](const Array<PrimExpr>& lhs, const Array<PrimExpr>& rhs) {
+    if (lhs.size() != rhs.size()) return false;
+    for (size_t i = 0; i < lhs.size(); ++i) {
+      if (!lhs[i].same_as(rhs[i])) return false;
+    }
+    return true;
+  };
+  const auto* init = block->init.as<tir::BufferStoreNode>();
+  if (init == nullptr || !init->buffer.same_as(c) || !tir::is_zero(init->value) ||
+      !indices_equal(init->indices, spatial)) {
+    return nullptr;
+  }
+  const auto* store = block->body.as<tir::BufferStoreNode>();
+  if (store == nullptr || !store->buffer.same_as(c) || !indices_equal(store->indices, spatial)) {
+    return nullptr;
+  }
+  const auto* add = store->value.as<tir::AddNode>();
+  if (add == nullptr) return nullptr;
+  const auto* acc = add->a.as<tir::BufferLoadNode>();
+  const auto* mul = add->b.as<tir::MulNode>();
+  if (acc == nullptr || !acc->buffer.same_as(c) || !indices_equal(acc->indices, spatial) ||
+      mul == nullptr) {
+    return nullptr;
+  }
+  const auto* load_a = mul->a.as<tir::BufferLoadNode>();
+  const auto* load_w = mul->b.as<tir::BufferLoadNode>();
+  if (load_a == nullptr || load_w == nullptr || !load_a->buffer.same_as(a) ||
+      !load_w->buffer.same_as(w)) {
+    return nullptr;
+  }
+  Array<PrimExpr> a_indices(spatial.begin(), spatial.end() - 1);
+  a_indices.push_back(k);
+  if (!indices_equal(load_a->indices, a_indices)) return nullptr;
+
+  auto info = std::make_unique<MatmulInfo>();
+  if (indices_equal(load_w->indices, {k, j})) {
+    info->weight_transposed = false;
+  } else if (indices_equal(load_w->indices, {j, k})) {
+    info->weight_transposed = true;
+  } else {
+    return nullptr;
+  }
+  auto to_int64 = [](const Array<PrimExpr>& shape) {
+    Array<PrimExpr> ret;
+    for (const PrimExpr& extent : shape) {
+      ret.push_back(IntImm(DataType::Int(64), Downcast<IntImm>(extent)->value));
+    }
+    return ret;
+  };
+  info->input_shape = to_int64(a->shape);
+  info->weight_shape = to_int64(w->shape);
+  info->dtype = c->dtype;
+  return info;
+}
+
+class ParallelMatmulCombiner : public ExprMutator {
+ public:
+  explicit ParallelMatmulCombiner(IRModule mod) : ExprMutator(mod), mod_(mod) {}
+
+  IRModule Transform() {
+    for (const auto& kv : mod_->functions) {
+      if (kv.second->IsInstance<relax::FunctionNode>()) {
+        builder_->UpdateFunction(kv.first, Downcast<Function>(VisitExpr(kv.second)));
+      }
+    }
+    return builder_->GetContextIRModule();
+  }
+
+ private:
+  using ExprMutator::VisitBindingBlock_;
+
+  /*! \brief A matmul binding of the block. */
+  struct Member {
+    const VarBindingNode* binding;
+    const MatmulInfo* info;
+    Expr input;
+    Expr weight;
+  };
+
+  BindingBlock VisitBindingBlock_(const DataflowBlockNode* block) final {
+    // Step 1. Group the matmuls of the block by their input.
+    std::unordered_set<const Object*> defined;
+    for (const Binding& binding : block->bindings) {
+      if (const auto* var_binding = binding.as<VarBindingNode>()) {
+        defined.insert(var_binding->var.get());
+      } else if (const auto* match_shape = binding.as<MatchShapeNode>()) {
+        defined.insert(match_shape->var.get());
+      }
+    }
+    static const DFPattern pattern = IsCallTIR("", TuplePattern({IsVar(""), Wildcard()}));
+    std::vector<std::vector<Member>> groups;
+    std::unordered_map<const Object*, size_t> input2group;
+    for (const Binding& binding : block->bindings) {
+      const auto* var_binding = binding.as<VarBindingNode>();
+      if (var_binding == nullptr || !MatchExpr(pattern, var_binding->value)) continue;
+      Call call = Downcast<Call>(var_binding->value);
+      const MatmulInfo* info = GetMatmulInfo(Downcast<GlobalVar>(call->args[0]));
+      Array<Expr> args = Downcast<Tuple>(call->args[1])->fields;
+      // The weights are concatenated where the first matmul is.
+      if (info == nullptr || (!args[1]->IsInstance<ConstantNode>() &&
+                              (!args[1]->IsInstance<VarNode>() || defined.count(args[1].get())))) {
+        continue;
+      }
+      auto it = input2group.find(args[0].get());
+      if (it != input2group.end()) {
+        const MatmulInfo* first = groups[it->second][0].info;
+        if (first->weight_transposed != info->weight_transposed ||
+            !StructuralEqual()(first->input_shape, info->input_shape) ||
+            first->dtype != info->dtype) {
+          continue;
+        }
+      } else {
+        it = input2group.emplace(args[0].get(), groups.size()).first;
+        groups.emplace_back();
+      }
+      groups[it->second].push_back({var_binding, info, args[0], args[1]});
+    }
+    std::unordered_map<const VarBindingNode*, const std::vector<Member>*> binding2group;
+    for (const std::vector<Member>& group : groups) {
+      if (group.size() < 2) continue;
+      for (const Member& member : group) {
+        binding2group[member.binding] = &group;
+      }
+    }
+    if (binding2group.empty()) {
+      return ExprMutator::VisitBindingBlock_(block);
+    }
+
+    // Step 2. Emit the combined matmul of each group at the position of its first matmul.
+    builder_->BeginDataflowBlock();
+    for (const Binding& binding : block->bindings) {
+      auto it = binding2group.find(binding.as<VarBindingNode>());
+      if (it == binding2group.end()) {
+        VisitBinding(binding);
+      } else if (it->second->front().binding == it->first) {
+        EmitCombined(*it->second);
+      }
+    }
+    return builder_->EndBlock();
+  }
+
+  void EmitCombined(const std::vector<Member>& group) {
+    const MatmulInfo* info = group[0].info;
+    int axis = info->weight_transposed ? 0 : 1;
+    int64_t k = Downcast<IntImm>(info->input_shape.back())->value;
+
+    // w = concat(w_0, ..., w_n)
+    Array<te::Tensor> weights;
+    Array<Expr> weight_args;
+    int64_t width = 0;
+    for (const Member& member : group) {
+      weights.push_back(te::placeholder(member.info->weight_shape, info->dtype, "w"));
+      weight_args.push_back(VisitExpr(member.weight));
+      width += Downcast<IntImm>(member.info->weight_shape[axis])->value;
+    }
+    te::Tensor concat = topi::concatenate(weights, axis);
+    Array<te::Tensor> concat_args = weights;
+    concat_args.push_back(concat);
+    Expr weight = EmitCallTIR(concat_args, weight_args, "concatenate");
+
+    // y = matmul(x, w)
+    te::Tensor x = te::placeholder(info->input_shape, info->dtype, "x");
+    te::Tensor w = te::placeholder(concat->shape, info->dtype, "w");
+    Array<PrimExpr> out_shape(info->input_shape.begin(), info->input_shape.end() - 1);
+    out_shape.push_back(IntImm(DataType::Int(64), width));
+    tir::IterVar rk = te::reduce_axis(Range(0, IntImm(DataType::Int(64), k)), "k");
+    bool transposed = info->weight_transposed;
+    te::Tensor y = te::compute(
+        out_shape,
+        [&](const Array<tir::Var>& i) {
+          Array<PrimExpr> x_indices(i.begin(), i.end() - 1);
+          x_indices.push_back(rk);
+          Array<PrimExpr> w_indices =
+              transposed ? Array<PrimExpr>{i.back(), rk} : Array<PrimExpr>{rk, i.back()};
+          return tvm::sum(x(x_indices) * w(w_indices), {rk});
+        },
+        "T_matmul");
+    Expr combined = EmitCallTIR({x, w, y}, {VisitExpr(group[0].input), weight}, "matmul");
+
+    // y_i = split_i(y)
+    int64_t offset = 0;
+    for (const Member& member : group) {
+      int64_t n = Downcast<IntImm>(member.info->weight_shape[axis])->value;
+      te::Tensor whole = te::placeholder(y->shape, info->dtype, "y");
+      Array<PrimExpr> part_shape = y->shape;
+      part_shape.Set(part_shape.size() - 1, IntImm(DataType::Int(64), n));
+      te::Tensor part = te::compute(
+          part_shape,
+          [&](const Array<tir::Var>& i) {
+            Array<PrimExpr> indices(i.begin(), i.end());
+            indices.Set(indices.size() - 1, i.back() + IntImm(i.back().dtype(), offset));
+            return whole(indices);
+          },
+          "T_split");
+      offset += n;
+      Call split = MakeCallTIR({whole, part}, {combined}, "split");
+      const Var& var = member.binding->var;
+      if (var->IsInstance<DataflowVarNode>()) {
+        var_remap_[var->vid] = builder_->Emit(split, var->name_hint());
+      } else {
+        builder_->EmitOutput(VarBinding(VisitVarDef(var), builder_->Normalize(split)));
+      }
+    }
+  }
+
+  /*!
+   * \brief Create a call_tir to the PrimFunc of a TE computation.
+   * \param tensors The input placeholders followed by the output of the computation.
+   * \param args The arguments of the call.
+   * \param name The name hint of the PrimFunc.
+   */
+  Call MakeCallTIR(const Array<te::Tensor>& tensors, const Array<Expr>& args,
+                   const String& name) {
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    tir::PrimFunc func = tir::CreatePrimFunc(tensors, NullOpt);
+    if (annotate_op_pattern_) {
+      func = WithAttr(std::move(func), "op_pattern",
+                      Integer(static_cast<int>(AnalyzeOpPatternKind(func))));
+    }
+    GlobalVar gv = builder_->AddFunction(func, name);
+    const te::Tensor& out = tensors.back();
+    return Call(call_tir_op, {gv, Tuple(args), ShapeExpr(out->shape)}, Attrs(),
+                {DynTensorType(out->shape.size(), out->dtype)});
+  }
+
+  Expr EmitCallTIR(const Array<te::Tensor>& tensors, const Array<Expr>& args,
+                   const String& name) {
+    return builder_->Emit(MakeCallTIR(tensors, args, name));
+  }
+
+  const MatmulInfo* GetMatmulInfo(const GlobalVar& gv) {
+    auto it = matmuls_.find(gv.get());
+    if (it == matmuls_.end()) {
+      std::unique_ptr<MatmulInfo> info;
+      if (auto* func = mod_->Lookup(gv).as<tir::PrimFuncNode>()) {
+        info = MatchMatmul(GetRef<tir::PrimFunc>(func));
+        // Keep the combined PrimFuncs annotated for FuseOps if the module already is.
+        if (info != nullptr && func->GetAttr<Integer>("op_pattern").defined()) {
+          annotate_op_pattern_ = true;
+        }
+      }
+      it = matmuls_.emplace(gv.get(), std::move(info)).first;
+    }
+    return it->second.get();
+  }
+
+  /*! \brief The IRModule containing the PrimFuncs. */
+  IRModule mod_;
+  /*! \brief The matmul information of each callee, nullptr if the callee is not a matmul. */
+  std::unordered_map<const GlobalVarNode*, std::unique_ptr<MatmulInfo>> matmuls_;
+  /*! \brief Whether to annotate the op pattern of the created PrimFuncs. */
+  bool annotate_op_pattern_ = false;
+};
+
+namespace transform {
+
+Pass CombineParallelMatmul() {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =  //
+      [=](IRModule m, PassContext pc) { return ParallelMatmulCombiner(m).Transform(); };
+  // The PrimFuncs of the combined matmuls are added to the module, so it is a module pass.
+  return CreateModulePass(/*pass_function=*/pass_func,          //
+                          /*opt_level=*/0,                      //
+                          /*pass_name=*/"CombineParallelMatmul",  //
+                          /*required=*/{});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.CombineParallelMatmul").set_body_typed(CombineParallelMatmul);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
@@ -0,0 +1,69 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/transform/dead_code_elimination.cc
+ * \brief Remove the bindings of DataflowBlocks whose vars are never used.
+ */
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/transform.h>
+
+namespace tvm {
+namespace relax {
+
+/*! \brief Count the bindings of a function, including the ones of its nested functions. */
+static size_t NumBindings(const Function& fn) {
+  size_t num_bindings = 0;
+  PostOrderVisit(fn, [&num_bindings](const Expr& e) {
+    if (const auto* seq = e.as<SeqExprNode>()) {
+      for (const BindingBlock& block : seq->blocks) {
+        num_bindings += block->bindings.size();
+      }
+    }
+  });
+  return num_bindings;
+}
+
+Function DeadCodeElimination(Function fn) {
+  // Removing a binding may leave the bindings it used unused in turn, so iterate to a fixpoint.
+  size_t num_bindings = NumBindings(fn);
+  while (true) {
+    Function updated = RemoveAllUnused(fn);
+    size_t num_updated = NumBindings(updated);
+    if (num_updated == num_bindings) return fn;
+    fn = updated;
+    num_bindings = num_updated;
+  }
+}
+
+namespace transform {
+
+Pass DeadCodeElimination() {
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) { return relax::DeadCodeElimination(f); };
+  return CreateFunctionPass(pass_func, 1, "DeadCodeElimination", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.DeadCodeElimination").set_body_typed(DeadCodeElimination);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
@@ -0,0 +1,251 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/relax/transform/devirtualize_closures.cc
+ * \brief Turn the invocations of the closures whose target is statically known into direct calls.
+ *
+ * LambdaLift lowers an inner function capturing variables into a global function taking the
+ * captured values as trailing parameters, and its uses into `relax.make_closure` and
+ * `relax.invoke_closure`, which allocate a VMClosure and dispatch through it at runtime. When
+ * the closure invoked is bound in the same function, either to `make_closure` or to the call of
+ * a lifted function that only returns a `make_closure` of its parameters, the invocation is
+ * rewritten into a direct call of the target with the captured values appended to the
+ * arguments. The closures left unused are removed afterwards.
+ */
+
+#include <tvm/relax/expr.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/transform.h>
+
+#include <unordered_map>
+#include <unordered_set>
+
+namespace tvm {
+namespace relax {
+
+/*! \brief A closure whose target is statically known. */
+struct KnownClosure {
+  /*! \brief The lifted function invoked by the closure. */
+  GlobalVar target;
+  /*! \brief The captured values, passed after the arguments of the invocation. */
+  Array<Expr> captures;
+};
+
+class ClosureDevirtualizer : public ExprMutator {
+ public:
+  explicit ClosureDevirtualizer(const IRModule& mod) : ExprMutator(mod), mod_(mod) {}
+
+  IRModule Run() {
+    for (const auto& kv : mod_->functions) {
+      if (const auto* func = kv.second.as<FunctionNode>()) {
+        Function updated = Downcast<Function>(VisitExpr(GetRef<Function>(func)));
+        updated = RemoveUnusedClosures(updated);
+        if (!updated.same_as(kv.second)) {
+          builder_->UpdateFunction(kv.first, updated);
+        }
+      }
+    }
+    return builder_->GetContextIRModule();
+  }
+
+  using ExprMutator::VisitExpr_;
+
+  Expr VisitExpr_(const CallNode* call_node) final {
+    Call call = Downcast<Call>(ExprMutator::VisitExpr_(call_node));
+    if (call->op == invoke_closure_op_) {
+      KnownClosure closure;
+      if (!ResolveClosure(call->args[0], &closure)) return std::move(call);
+      Array<Expr> args = Downcast<Tuple>(call->args[1])->fields;
+      for (const Expr& capture : closure.captures) {
+        args.push_back(capture);
+      }
+      return Call(closure.target, args);
+    }
+    if (call->op->IsInstance<VarNode>()) {
+      // A call through a variable bound to a global function.
+      Optional<GlobalVar> gv = ResolveGlobalVar(call->op);
+      if (gv.defined()) {
+        return Call(gv.value(), call->args, call->attrs, call->type_args);
+      }
+    }
+    return std::move(call);
+  }
+
+ private:
+  /*! \brief Follow the variables bound to variables, returning the value in the end. */
+  Expr LookThroughAliases(Expr expr) {
+    while (const auto* var = expr.as<VarNode>()) {
+      Optional<Expr> value = LookupBinding(GetRef<Var>(var));
+      if (!value.defined()) break;
+      expr = value.value();
+    }
+    return expr;
+  }
+
+  Optional<GlobalVar> ResolveGlobalVar(const Expr& expr) {
+    if (const auto* gv = LookThroughAliases(expr).as<GlobalVarNode>()) {
+      return GetRef<GlobalVar>(gv);
+    }
+    return NullOpt;
+  }
+
+  /*!
+   * \brief Get the `make_closure` returned by a global function, if it returns nothing else.
+   */
+  Optional<Call> ClosureReturnedBy(const GlobalVar& gv) {
+    auto it = mod_->functions.find(gv);
+    if (it == mod_->functions.end()) return NullOpt;
+    const auto* func = (*it).second.as<FunctionNode>();
+    if (func == nullptr) return NullOpt;
+    Expr body = func->body;
+    if (const auto* seq = body.as<SeqExprNode>()) {
+      if (!seq->blocks.empty()) return NullOpt;
+      body = seq->body;
+    }
+    const auto* call = body.as<CallNode>();
+    if (call == nullptr || call->op != make_closure_op_) return NullOpt;
+    return GetRef<Call>(call);
+  }
+
+  /*!
+   * \brief Resolve the closure held by an expression.
+   * \param expr The expression.
+   * \param closure The closure, set when its target is statically known.
+   * \return Whether the target of the closure is statically known.
+   */
+  bool ResolveClosure(const Expr& expr, KnownClosure* closure) {
+    const auto* call = LookThroughAliases(expr).as<CallNode>();
+    if (call == nullptr) return false;
+    if (call->op == make_closure_op_) {
+      const auto* target = call->args[0].as<GlobalVarNode>();
+      const auto* captures = call->args[1].as<TupleNode>();
+      if (target == nullptr || captures == nullptr) return false;
+      *closure = KnownClosure{GetRef<GlobalVar>(target), captures->fields};
+      return true;
+    }
+    // The call of a lifted function returning a closure of its parameters, e.g. the outer
+    // function of a curried function. The captures are the arguments of the call.
+    Optional<GlobalVar> factory = ResolveGlobalVar(call->op);
+    if (!factory.defined()) return false;
+    Optional<Call> make_closure = ClosureReturnedBy(factory.value());
+    if (!make_closure.defined()) return false;
+    const auto* target = make_closure.value()->args[0].as<GlobalVarNode>();
+    const auto* captures = make_closure.value()->args[1].as<TupleNode>();
+    if (target == nullptr || captures == nullptr) return false;
+    Function factory_func = Downcast<Function>(mod_->Lookup(factory.value()));
+    if (factory_func->params.size() != call->args.size()) return false;
+    Array<Expr> call_captures;
+    for (const Expr& capture : captures->fields) {
+      bool found = false;
+      for (size_t i = 0; i < factory_func->params.size(); ++i) {
+        if (capture.same_as(factory_func->params[i])) {
+          call_captures.push_back(call->args[i]);
+          found = true;
+          break;
+        }
+      }
+      if (!found) return false;
+    }
+    *closure = KnownClosure{GetRef<GlobalVar>(target), call_captures};
+    return true;
+  }
+
+  /*!
+   * \brief Whether a binding only builds a closure or aliases a value, so it can be dropped once
+   * unused.
+   */
+  bool IsClosureBinding(const Expr& value) {
+    if (value->IsInstance<VarNode>() || value->IsInstance<GlobalVarNode>()) return true;
+    const auto* call = value.as<CallNode>();
+    if (call == nullptr) return false;
+    if (call->op == make_closure_op_) return true;
+    Optional<GlobalVar> gv = ResolveGlobalVar(call->op);
+    return gv.defined() && ClosureReturnedBy(gv.value()).defined();
+  }
+
+  Function RemoveUnusedClosures(Function func);
+
+  IRModule mod_;
+  /*! \brief Cache ops that would be used later to reduce lookup overhead. */
+  const Op& make_closure_op_ = Op::Get("relax.make_closure");
+  const Op& invoke_closure_op_ = Op::Get("relax.invoke_closure");
+};
+
+/*! \brief Count the uses of the variables of a function. */
+class VarUseCounter : public ExprVisitor {
+ public:
+  void VisitExpr_(const VarNode* op) final { ++counts[op]; }
+  void VisitExpr_(const DataflowVarNode* op) final { ++counts[op]; }
+
+  std::unordered_map<const VarNode*, int> counts;
+};
+
+/*! \brief Remove the given bindings from a function. */
+class BindingRemover : public ExprMutator {
+ public:
+  explicit BindingRemover(std::unordered_set<const VarNode*> removed)
+      : removed_(std::move(removed)) {}
+
+  void VisitBinding_(const VarBindingNode* binding) final {
+    if (removed_.count(binding->var.get())) return;
+    ExprMutator::VisitBinding_(binding);
+  }
+
+ private:
+  std::unordered_set<const VarNode*> removed_;
+};
+
+Function ClosureDevirtualizer::RemoveUnusedClosures(Function func) {
+  // Removing a closure may leave the aliases it used unused in turn, so iterate to a fixpoint.
+  while (true) {
+    VarUseCounter counter;
+    counter.VisitExpr(func);
+    std::unordered_set<const VarNode*> removed;
+    PostOrderVisit(func, [&](const Expr& e) {
+      if (const auto* seq = e.as<SeqExprNode>()) {
+        for (const BindingBlock& block : seq->blocks) {
+          for (const Binding& binding : block->bindings) {
+            const auto* var_binding = binding.as<VarBindingNode>();
+            if (var_binding && !counter.counts.count(var_binding->var.get()) &&
+                IsClosureBinding(var_binding->value)) {
+              removed.insert(var_binding->var.get());
+            }
+          }
+        }
+      }
+    });
+    if (removed.empty()) return func;
+    func = Downcast<Function>(BindingRemover(std::move(removed)).VisitExpr(func));
+  }
+}
+
+namespace transform {
+
+Pass DevirtualizeClosures() {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
+      [=](IRModule m, PassContext pc) { return relax::ClosureDevirtualizer(m).Run(); };
+  return CreateModulePass(pass_func, 1, "DevirtualizeClosures", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.DevirtualizeClosures").set_body_typed(DevirtualizeClosures);
+
+}  // namespace transform
+}  // namespace relax
+}  // namespace tvm
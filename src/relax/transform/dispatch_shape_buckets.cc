@@ -0,0 +1,242 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/transform/dispatch_shape_buckets.cc
+ * \brief Dispatch the call_tir of a PrimFunc with symbolic shapes among its variants tuned for
+ *        buckets of shapes.
+ */
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/transform.h>
+#include <tvm/relax/type.h>
+#include <tvm/tir/function.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+class ShapeBucketDispatcher : public ExprMutator {
+ public:
+  ShapeBucketDispatcher(IRModule mod, Map<String, Array<Array<ObjectRef>>> buckets)
+      : ExprMutator(mod), mod_(mod), buckets_(std::move(buckets)) {}
+
+  IRModule Dispatch() {
+    for (const auto& kv : mod_->functions) {
+      if (const auto* func = kv.second.as<FunctionNode>()) {
+        builder_->UpdateFunction(kv.first, Downcast<Function>(VisitExpr(GetRef<Function>(func))));
+      }
+    }
+    return builder_->GetContextIRModule();
+  }
+
+ private:
+  using ExprMutator::VisitBinding_;
+
+  /*! \brief A tuned variant of a PrimFunc, and the predicate of its bucket of shapes. */
+  struct Variant {
+    GlobalVar predicate;
+    GlobalVar func;
+    /*! \brief Whether the variant still takes the packed ints of the call. */
+    bool takes_packed_ints;
+  };
+
+  void VisitBinding_(const VarBindingNode* binding) final {
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    Expr value = this->VisitExpr(binding->value);
+    const auto* call = value.as<CallNode>();
+    if (call == nullptr || !call->op.same_as(call_tir_op)) {
+      return EmitBinding(binding, value);
+    }
+    const std::vector<Variant>& variants = GetVariants(GetRef<Call>(call));
+    if (variants.empty()) return EmitBinding(binding, value);
+    Expr dispatch = EmitDispatch(GetRef<Call>(call), variants, 0);
+    Var new_var = this->VisitVarDef(binding->var);
+    builder_->Emit(VarBinding(new_var, dispatch));
+  }
+
+  void EmitBinding(const VarBindingNode* binding, const Expr& value) {
+    Var new_var = this->VisitVarDef(binding->var);
+    if (new_var.same_as(binding->var) && value.same_as(binding->value)) {
+      builder_->Emit(GetRef<VarBinding>(binding));
+      return;
+    }
+    Var temp = WithShapeAndType(new_var, value->shape_, value->checked_type_);
+    if (!temp.same_as(new_var)) {
+      new_var = temp;
+      this->var_remap_[binding->var->vid] = new_var;
+    }
+    builder_->Emit(VarBinding(new_var, value));
+  }
+
+  /*!
+   * \brief Emit the predicate of the i-th variant, and dispatch the call to it if the predicate
+   * holds, or to the next variants otherwise. The PrimFunc called originally is the last resort.
+   */
+  Expr EmitDispatch(const Call& call, const std::vector<Variant>& variants, size_t i) {
+    if (i == variants.size()) return call;
+    const Variant& variant = variants[i];
+    Expr inputs = call->args[1];
+    Call predicate_call(call->op, {variant.predicate, inputs, ShapeExpr(Array<PrimExpr>())},
+                        Attrs(), {DynTensorType(0, DataType::Bool())});
+    Var cond = builder_->Emit(predicate_call, "in_bucket");
+    Array<Expr> args = {variant.func, call->args[1], call->args[2]};
+    if (call->args.size() == 4 && variant.takes_packed_ints) args.push_back(call->args[3]);
+    Call variant_call(call->op, args, call->attrs, call->type_args, call->span);
+    SeqExpr true_branch = EmitBranch([&]() -> Expr { return variant_call; });
+    SeqExpr false_branch = EmitBranch([&]() { return EmitDispatch(call, variants, i + 1); });
+    If dispatch(cond, true_branch, false_branch, call->span);
+    UpdateShape(dispatch, call->shape_);
+    UpdateType(dispatch, call->checked_type_);
+    return dispatch;
+  }
+
+  /*! \brief Emit the expression in a new scope, as the body of a branch of an If. */
+  template <typename FEmit>
+  SeqExpr EmitBranch(FEmit f_emit) {
+    builder_->BeginBindingBlock();
+    Var result = builder_->Emit(f_emit());
+    return SeqExpr({builder_->EndBlock()}, result);
+  }
+
+  /*! \brief Get the variants of the PrimFunc called, adding them to the module the first time. */
+  const std::vector<Variant>& GetVariants(const Call& call) {
+    static const std::vector<Variant> none;
+    const auto* gv = call->args[0].as<GlobalVarNode>();
+    if (gv == nullptr) return none;
+    auto cached = variants_.find(gv->name_hint);
+    if (cached != variants_.end()) return cached->second;
+    Optional<Array<Array<ObjectRef>>> buckets = buckets_.Get(gv->name_hint);
+    if (!buckets.defined()) return none;
+    auto it = mod_->functions.find(GetRef<GlobalVar>(gv));
+    const auto* inputs = call->args[1].as<TupleNode>();
+    if (it == mod_->functions.end() || inputs == nullptr) return none;
+    const auto* func = (*it).second.as<tir::PrimFuncNode>();
+    if (func == nullptr) return none;
+    size_t num_inputs = inputs->fields.size();
+    size_t num_tensors = func->params.size();
+    if (call->args.size() == 4) {
+      num_tensors -= Downcast<ShapeExpr>(call->args[3])->values.size();
+    }
+
+    std::vector<Variant> variants;
+    for (size_t i = 0; i < buckets.value().size(); ++i) {
+      const Array<ObjectRef>& bucket = buckets.value()[i];
+      CHECK_EQ(bucket.size(), 2) << "ValueError: The bucket " << i << " of " << gv->name_hint
+                                 << " must be a pair of the shape ranges and the PrimFunc";
+      auto ranges = Downcast<Map<String, Array<Integer>>>(bucket[0]);
+      auto variant_func = Downcast<tir::PrimFunc>(bucket[1]);
+      CHECK_GE(variant_func->params.size(), num_tensors)
+          << "ValueError: The variant " << i << " of " << gv->name_hint << " takes "
+          << variant_func->params.size() << " parameters, but the call passes " << num_tensors
+          << " tensors";
+      std::string name = gv->name_hint + "_bucket" + std::to_string(i);
+      Variant variant;
+      tir::PrimFunc predicate =
+          MakePredicate(gv->name_hint, GetRef<tir::PrimFunc>(func), num_inputs, ranges);
+      variant.predicate = AddPrimFunc(predicate, name + "_cond");
+      variant.func = AddPrimFunc(variant_func, name);
+      variant.takes_packed_ints = variant_func->params.size() > num_tensors;
+      variants.push_back(variant);
+    }
+    return variants_.emplace(gv->name_hint, std::move(variants)).first->second;
+  }
+
+  /*!
+   * \brief Make the PrimFunc checking if the shapes of the inputs of a call fall in a bucket. It
+   * takes the same inputs as the PrimFunc called, and writes whether each symbolic shape var lies
+   * in its inclusive range to a boolean scalar.
+   */
+  static tir::PrimFunc MakePredicate(const String& func_name, const tir::PrimFunc& func,
+                                     size_t num_inputs, const Map<String, Array<Integer>>& ranges) {
+    CHECK_LE(num_inputs, func->params.size())
+        << "ValueError: " << func_name << " takes " << func->params.size()
+        << " parameters, but is called with " << num_inputs << " inputs";
+    Array<tir::Var> params;
+    Map<tir::Var, tir::Buffer> buffer_map;
+    std::unordered_map<std::string, tir::Var> shape_vars;
+    for (size_t i = 0; i < num_inputs; ++i) {
+      tir::Buffer buffer = func->buffer_map.at(func->params[i]);
+      for (const PrimExpr& dim : buffer->shape) {
+        if (const auto* var = dim.as<tir::VarNode>()) {
+          shape_vars.emplace(var->name_hint, GetRef<tir::Var>(var));
+        }
+      }
+      tir::Var param(func->params[i]->name_hint, func->params[i]->type_annotation);
+      params.push_back(param);
+      buffer_map.Set(param, tir::decl_buffer(buffer->shape, buffer->dtype, buffer->name));
+    }
+
+    PrimExpr cond = Bool(true);
+    for (const auto& kv : ranges) {
+      auto it = shape_vars.find(kv.first);
+      CHECK(it != shape_vars.end()) << "ValueError: The shape var " << kv.first
+                                    << " cannot be read from the shapes of the inputs of "
+                                    << func_name;
+      CHECK_EQ(kv.second.size(), 2) << "ValueError: The range of the shape var " << kv.first
+                                    << " must be a pair of its bounds, but gets " << kv.second;
+      const tir::Var& var = it->second;
+      cond = cond && tir::make_const(var->dtype, kv.second[0]->value) <= var &&
+             var <= tir::make_const(var->dtype, kv.second[1]->value);
+    }
+    tir::Var out("in_bucket", DataType::Handle());
+    tir::Buffer out_buffer = tir::decl_buffer(Array<PrimExpr>(), DataType::Bool(), "in_bucket");
+    params.push_back(out);
+    buffer_map.Set(out, out_buffer);
+    tir::Stmt body = tir::BufferStore(out_buffer, cond, Array<PrimExpr>());
+    tir::PrimFunc predicate(params, body, VoidType(), buffer_map);
+    return WithAttr(std::move(predicate), tir::attr::kNoAlias, Bool(true));
+  }
+
+  GlobalVar AddPrimFunc(tir::PrimFunc func, const std::string& name_hint) {
+    GlobalVar gv = builder_->AddFunction(func, name_hint);
+    builder_->UpdateFunction(gv, WithAttr(std::move(func), tvm::attr::kGlobalSymbol,
+                                          String(gv->name_hint)));
+    return gv;
+  }
+
+  /*! \brief The IRModule containing the PrimFuncs. */
+  IRModule mod_;
+  /*! \brief The shape ranges and the variant of each bucket, keyed by the PrimFunc name. */
+  Map<String, Array<Array<ObjectRef>>> buckets_;
+  /*! \brief The variants added to the module, keyed by the PrimFunc name. */
+  std::unordered_map<std::string, std::vector<Variant>> variants_;
+};
+
+namespace transform {
+
+Pass DispatchShapeBuckets(Map<String, Array<Array<ObjectRef>>> buckets) {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
+      [=](IRModule m, PassContext pc) { return ShapeBucketDispatcher(m, buckets).Dispatch(); };
+  // the If of the dispatch cannot be nested in a dataflow block
+  return tvm::transform::Sequential(
+      {ToNonDataflow(), CreateModulePass(pass_func, 0, "DispatchShapeBuckets", {})},
+      "DispatchShapeBuckets");
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.DispatchShapeBuckets").set_body_typed(DispatchShapeBuckets);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
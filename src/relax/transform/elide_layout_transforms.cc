@@ -0,0 +1,199 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/transform/elide_layout_transforms.cc
+ * \brief Cancel the pairs of adjacent layout transforms that undo each other.
+ *        A layout transform is a call_tir to a PrimFunc which only copies its input to its
+ *        output with the axes permuted, such as the NCHW <-> NHWC transposes emitted around
+ *        the operators that run in another layout.
+ */
+#include <tvm/arith/analyzer.h>
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/transform.h>
+#include <tvm/tir/stmt_functor.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+/*!
+ * \brief Get the axis permutation of a PrimFunc computing `B[v_0, ..., v_n] = A[v_p0, ..., v_pn]`
+ *  over the whole output, where p is a permutation.
+ * \param func The PrimFunc to be analyzed.
+ * \return The permutation p, or an empty vector if the PrimFunc is not such a layout transform.
+ */
+std::vector<int> GetAxisPermutation(const tir::PrimFunc& func) {
+  if (func->params.size() != 2) return {};
+  auto in_it = func->buffer_map.find(func->params[0]);
+  auto out_it = func->buffer_map.find(func->params[1]);
+  if (in_it == func->buffer_map.end() || out_it == func->buffer_map.end()) return {};
+  tir::Buffer in = (*in_it).second;
+  tir::Buffer out = (*out_it).second;
+  size_t ndim = out->shape.size();
+  if (in->dtype != out->dtype || in->shape.size() != ndim || ndim == 0) return {};
+
+  // The function must consist of a single store, in a spatial block over the whole output.
+  std::vector<const tir::BlockRealizeNode*> realizes;
+  std::unordered_map<const tir::VarNode*, const tir::ForNode*> loops;
+  int num_stores = 0;
+  tir::PostOrderVisit(func->body, [&](const ObjectRef& obj) {
+    if (const auto* realize = obj.as<tir::BlockRealizeNode>()) {
+      if (!realize->block->iter_vars.empty()) realizes.push_back(realize);
+    } else if (const auto* loop = obj.as<tir::ForNode>()) {
+      loops[loop->loop_var.get()] = loop;
+    } else if (obj->IsInstance<tir::BufferStoreNode>()) {
+      ++num_stores;
+    }
+  });
+  if (realizes.size() != 1 || num_stores != 1) return {};
+  const tir::BlockRealizeNode* realize = realizes[0];
+  const tir::BlockNode* block = realize->block.get();
+  if (!tir::is_one(realize->predicate) || block->init.defined() ||
+      block->iter_vars.size() != ndim) {
+    return {};
+  }
+  arith::Analyzer analyzer;
+  for (size_t i = 0; i < ndim; ++i) {
+    const tir::IterVar& iter = block->iter_vars[i];
+    const auto* loop_var = realize->iter_values[i].as<tir::VarNode>();
+    if (iter->iter_type != tir::kDataPar || loop_var == nullptr || !loops.count(loop_var)) {
+      return {};
+    }
+    const tir::ForNode* loop = loops.at(loop_var);
+    if (!tir::is_zero(iter->dom->min) || !tir::is_zero(loop->min) ||
+        !analyzer.CanProveEqual(iter->dom->extent, out->shape[i]) ||
+        !analyzer.CanProveEqual(loop->extent, out->shape[i])) {
+      return {};
+    }
+  }
+
+  const auto* store = block->body.as<tir::BufferStoreNode>();
+  if (store == nullptr || !store->buffer.same_as(out)) return {};
+  const auto* load = store->value.as<tir::BufferLoadNode>();
+  if (load == nullptr || !load->buffer.same_as(in)) return {};
+  for (size_t i = 0; i < ndim; ++i) {
+    if (!store->indices[i].same_as(block->iter_vars[i]->var)) return {};
+  }
+  std::vector<int> perm(ndim, -1);
+  std::vector<bool> used(ndim, false);
+  for (size_t k = 0; k < ndim; ++k) {
+    for (size_t i = 0; i < ndim; ++i) {
+      if (load->indices[k].same_as(block->iter_vars[i]->var)) {
+        perm[k] = i;
+      }
+    }
+    if (perm[k] < 0 || used[perm[k]] ||
+        !analyzer.CanProveEqual(in->shape[k], out->shape[perm[k]])) {
+      return {};
+    }
+    used[perm[k]] = true;
+  }
+  return perm;
+}
+
+class LayoutTransformElider : public ExprMutator {
+ public:
+  explicit LayoutTransformElider(IRModule mod) : ExprMutator(mod), mod_(mod) {}
+
+  /*! \brief Whether any pair of layout transforms has been cancelled. */
+  bool elided_ = false;
+
+ private:
+  using ExprMutator::VisitExpr_;
+
+  Expr VisitExpr_(const CallNode* op) final {
+    Call call = Downcast<Call>(ExprMutator::VisitExpr_(op));
+    Expr input;
+    const std::vector<int>* outer = MatchLayoutTransform(call, &input);
+    if (outer == nullptr || !input->IsInstance<VarNode>()) return std::move(call);
+
+    Optional<Expr> producer = LookupBinding(Downcast<Var>(input));
+    if (!producer.defined() || !producer.value()->IsInstance<CallNode>()) return std::move(call);
+    Expr source;
+    Call producer_call = Downcast<Call>(producer.value());
+    const std::vector<int>* inner = MatchLayoutTransform(producer_call, &source);
+    if (inner == nullptr || inner->size() != outer->size()) return std::move(call);
+    // A dataflow var must not escape its block through the output var of another block.
+    if (source->IsInstance<DataflowVarNode>() && !input->IsInstance<DataflowVarNode>()) {
+      return std::move(call);
+    }
+
+    // y[i] = x[i_{inner[k]}] and z[i] = y[i_{outer[k]}] give z[i] = x[i_{outer[inner[k]]}].
+    for (size_t k = 0; k < inner->size(); ++k) {
+      if ((*outer)[(*inner)[k]] != static_cast<int>(k)) return std::move(call);
+    }
+    elided_ = true;
+    return source;
+  }
+
+  /*!
+   * \brief Match a call_tir to a layout transform PrimFunc.
+   * \param call The call to be matched.
+   * \param input The input of the layout transform, set when the call matches.
+   * \return The axis permutation of the layout transform, nullptr if the call does not match.
+   */
+  const std::vector<int>* MatchLayoutTransform(const Call& call, Expr* input) {
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    if (!call->op.same_as(call_tir_op) || call->type_args.size() != 1) return nullptr;
+    const auto* gv = call->args[0].as<GlobalVarNode>();
+    const auto* args = call->args[1].as<TupleNode>();
+    if (gv == nullptr || args == nullptr || args->fields.size() != 1) return nullptr;
+
+    auto it = perms_.find(gv);
+    if (it == perms_.end()) {
+      std::vector<int> perm;
+      if (auto* func = mod_->Lookup(GetRef<GlobalVar>(gv)).as<tir::PrimFuncNode>()) {
+        perm = GetAxisPermutation(GetRef<tir::PrimFunc>(func));
+      }
+      it = perms_.emplace(gv, std::move(perm)).first;
+    }
+    if (it->second.empty()) return nullptr;
+    *input = args->fields[0];
+    return &it->second;
+  }
+
+  /*! \brief The IRModule containing the PrimFuncs. */
+  IRModule mod_;
+  /*! \brief The axis permutation of each callee, empty if the callee is not a layout transform. */
+  std::unordered_map<const GlobalVarNode*, std::vector<int>> perms_;
+};
+
+namespace transform {
+
+Pass ElideLayoutTransforms() {
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) {
+        LayoutTransformElider elider(m);
+        Function updated = Downcast<Function>(elider(f));
+        // The first transform of each cancelled pair is left unused.
+        return elider.elided_ ? RemoveAllUnused(updated) : f;
+      };
+  return CreateFunctionPass(pass_func, 0, "ElideLayoutTransforms", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.ElideLayoutTransforms").set_body_typed(ElideLayoutTransforms);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
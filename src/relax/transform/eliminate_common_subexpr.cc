@@ -0,0 +1,95 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/transform/eliminate_common_subexpr.cc
+ * \brief Eliminate the bindings of a DataflowBlock computing the same value as an earlier one.
+ *        Values are compared with structural equality, where vars only equal themselves, so
+ *        two calls are merged only when they have the same callee and the same arguments.
+ */
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/transform.h>
+
+#include <unordered_map>
+
+namespace tvm {
+namespace relax {
+
+class CommonSubexprEliminator : public ExprMutator {
+ public:
+  using ExprMutator::VisitBinding_;
+
+  BindingBlock VisitBindingBlock_(const DataflowBlockNode* block) final {
+    bound_.clear();
+    BindingBlock ret = ExprMutator::VisitBindingBlock_(block);
+    bound_.clear();
+    return ret;
+  }
+
+  void VisitBinding_(const VarBindingNode* binding) final {
+    if (!builder_->CurrentBlockIsDataFlow() || !IsCandidate(binding->value)) {
+      ExprMutator::VisitBinding_(binding);
+      return;
+    }
+    Expr new_value = VisitExpr(binding->value);
+    auto it = bound_.find(new_value);
+    if (it == bound_.end()) {
+      ExprMutator::VisitBinding_(binding);
+      bound_.emplace(new_value, Downcast<Var>(VisitExpr(binding->var)));
+    } else if (binding->var->IsInstance<DataflowVarNode>()) {
+      var_remap_[binding->var->vid] = it->second;
+    } else {
+      // The output var stays, bound to the var computing the same value.
+      builder_->EmitOutput(VarBinding(VisitVarDef(binding->var), it->second));
+    }
+  }
+
+ private:
+  /*!
+   * \brief Whether a bound value can be merged with an equal one. Calls of packed functions
+   *  are excluded since they may have side effects.
+   */
+  static bool IsCandidate(const Expr& value) {
+    if (const auto* call = value.as<CallNode>()) {
+      return !call->op->IsInstance<ExternFuncNode>();
+    }
+    return value->IsInstance<TupleGetItemNode>();
+  }
+
+  /*! \brief The vars bound to each value in the current DataflowBlock. */
+  std::unordered_map<Expr, Var, StructuralHash, StructuralEqual> bound_;
+};
+
+namespace transform {
+
+Pass EliminateCommonSubexpr() {
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) {
+        return Downcast<Function>(CommonSubexprEliminator()(f));
+      };
+  return CreateFunctionPass(pass_func, 1, "EliminateCommonSubexpr", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.EliminateCommonSubexpr")
+    .set_body_typed(EliminateCommonSubexpr);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
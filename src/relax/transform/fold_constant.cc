@@ -26,14 +26,111 @@
 #include <tvm/tir/function.h>
 #include <tvm/tir/op.h>
 
+#include <string>
+#include <unordered_set>
+
 namespace tvm {
 namespace relax {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.FoldConstant.batch_build", Bool);
+
 class ConstantFolder : public ExprMutator {
  public:
   explicit ConstantFolder(IRModule ctx_module) : ctx_module_(ctx_module) {}
 
+  /*!
+   * \brief Build all the PrimFuncs that the folding of func evaluates in a single LLVM module,
+   *  instead of one module per PrimFunc.
+   * \param func The function to be folded.
+   * \note If the batch fails to build, e.g. because one of the PrimFuncs is scheduled for GPU,
+   *  nothing is cached and each PrimFunc is built on its own when it is folded.
+   */
+  void BatchBuild(const Function& func) {
+    FoldableCallCollector collector(this);
+    collector(func);
+
+    Map<GlobalVar, BaseFunc> lowered;
+    std::vector<std::pair<tir::PrimFunc, std::string>> pending;
+    for (const tir::PrimFunc& prim_func : collector.prim_funcs_) {
+      std::string name = "tir_function_" + std::to_string(pending.size());
+      for (const auto& kv : LowerPrimFunc(prim_func, name)->functions) {
+        lowered.Set(kv.first, kv.second);
+      }
+      pending.emplace_back(prim_func, name);
+    }
+    // A single PrimFunc does not benefit from the batch.
+    if (pending.size() < 2) return;
+
+    Target eval_cpu_target{"llvm"};
+    try {
+      runtime::Module rt_module = build(IRModule(lowered), eval_cpu_target, eval_cpu_target);
+      for (const auto& kv : pending) {
+        PackedFunc build_func = rt_module.GetFunction(kv.second);
+        if (build_func != nullptr) {
+          func_build_cache_[kv.first] = build_func;
+        }
+      }
+    } catch (const tvm::Error& err) {
+      DLOG(WARNING) << "Batch build failure for " << pending.size()
+                    << " functions, building them one by one. Error message: " << err.what();
+    }
+  }
+
  private:
+  /*!
+   * \brief Collect the uncached PrimFuncs of the call_tir bindings whose arguments are constants,
+   *  or are folded from earlier bindings.
+   */
+  class FoldableCallCollector : public ExprVisitor {
+   public:
+    explicit FoldableCallCollector(ConstantFolder* folder) : folder_(folder) {}
+
+    void VisitBinding_(const VarBindingNode* binding) final {
+      if (IsFoldable(binding->value)) {
+        foldable_vars_.insert(binding->var.get());
+      }
+      ExprVisitor::VisitBinding_(binding);
+    }
+
+    /*! \brief The distinct PrimFuncs, in the order they are folded. */
+    std::vector<tir::PrimFunc> prim_funcs_;
+
+   private:
+    bool IsFoldableArg(const Expr& arg) const {
+      return arg->IsInstance<ConstantNode>() || foldable_vars_.count(arg.as<VarNode>());
+    }
+
+    bool IsFoldable(const Expr& value) {
+      static const Op& call_tir_op = Op::Get("relax.call_tir");
+      if (!value->IsInstance<CallNode>()) {
+        return IsFoldableArg(value);
+      }
+      Call call = Downcast<Call>(value);
+      if (!call->op.same_as(call_tir_op) || call->args.size() < 3 ||
+          call->type_args.size() != 1 || !MatchConstShape(call->args[2])) {
+        return false;
+      }
+      Optional<tir::PrimFunc> func = folder_->MatchPrimFunc(call->args[0]);
+      const auto* args = call->args[1].as<TupleNode>();
+      if (!func || !args) return false;
+      for (const Expr& arg : args->fields) {
+        if (!IsFoldableArg(arg)) return false;
+      }
+      if (!folder_->func_build_cache_.count(func.value()) && !seen_.count(func.value())) {
+        seen_.insert(func.value());
+        prim_funcs_.push_back(func.value());
+      }
+      return true;
+    }
+
+    /*! \brief The folder whose cache is filled. */
+    ConstantFolder* folder_;
+    /*! \brief The vars bound to values that fold to constants. */
+    std::unordered_set<const Object*> foldable_vars_;
+    /*! \brief The PrimFuncs already collected, via structural equality. */
+    std::unordered_set<tir::PrimFunc, CachedStructuralHash, StructuralEqual> seen_;
+  };
+
   /*!
    * \brief Pattern match expr to a constant shape and get runtime shape tuple from it.
    * \return The runtime shape tuple, or nullopt if it is not a constant shape.
@@ -197,7 +294,8 @@ class ConstantFolder : public ExprMutator {
   // the context module to lookup functions
   IRModule ctx_module_;
   // cache for function build, via structural equality
-  std::unordered_map<tir::PrimFunc, Optional<runtime::PackedFunc>, StructuralHash, StructuralEqual>
+  std::unordered_map<tir::PrimFunc, Optional<runtime::PackedFunc>, CachedStructuralHash,
+                     StructuralEqual>
       func_build_cache_;
 };
 
@@ -207,6 +305,9 @@ Pass FoldConstant() {
   runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
       [=](Function f, IRModule m, PassContext pc) {
         ConstantFolder folder(m);
+        if (pc->GetConfig<Bool>("relax.FoldConstant.batch_build", Bool(true)).value()) {
+          folder.BatchBuild(f);
+        }
         return Downcast<Function>(folder(f));
       };
   return CreateFunctionPass(pass_func, 0, "FoldConstant", {});
@@ -96,11 +96,16 @@ class GraphCreator : public ExprVisitor {
    * \return The created IndexedForwardGraph
    */
   static IndexedForwardGraph Create(IRModule mod, support::Arena* arena) {
-    // Since cross-function call is not supported yet, FuseOps only serves the entry function, whose
-    // name is "main".
-    auto relax_func = Downcast<Function>(mod->Lookup("main"));
+    // Every non-primitive Relax function of the module, including the lambdas lifted to the
+    // global scope, contributes a disjoint subgraph. The partitioner never groups nodes across
+    // them since there is no edge in between.
     GraphCreator creator(mod, arena);
-    creator(relax_func);
+    for (const auto& kv : mod->functions) {
+      const BaseFunc& func = kv.second;
+      if (func->IsInstance<relax::FunctionNode>() && !func->HasNonzeroAttr(attr::kPrimitive)) {
+        creator(Downcast<Function>(func));
+      }
+    }
 
     // The algorithm of the graph creator ensures that each created node will be added to the
     // post-dfs order and will be set its op pattern. Thus we check whether all these containers
@@ -542,10 +547,12 @@ class OperatorFusor : public ExprMutator {
    * \param mod The IRModule to be transformed
    * \param graph The indexed-forward graph of the input IRModule
    * \param groups The grouped result of the group partition on the input indexed-forward graph.
+   * \param fcheck_group The optional function deciding whether a group is worth fusing.
    */
   explicit OperatorFusor(IRModule mod, const IndexedForwardGraph& graph,
-                         const std::vector<GraphPartitioner::Group*>& groups)
-      : ExprMutator(mod), mod_(std::move(mod)) {
+                         const std::vector<GraphPartitioner::Group*>& groups,
+                         Optional<PackedFunc> fcheck_group)
+      : ExprMutator(mod), mod_(std::move(mod)), fcheck_group_(std::move(fcheck_group)) {
     for (int nid = 0; nid < static_cast<int>(graph.post_dfs_order.size()); ++nid) {
       GraphPartitioner::Group* group_root = groups[nid]->FindRoot();
       ICHECK(group_root != nullptr);
@@ -589,10 +596,19 @@ class OperatorFusor : public ExprMutator {
     // Step 2. Collect all group's boundary (i.e. the output vars for each group)
     CollectFuncBoundary(block->bindings);
 
-    // Step 3. Create the grouped function for each group.
+    // Step 3. Create the grouped function for each group, and drop the groups which are
+    // predicted to run slower than their unfused bindings.
+    std::vector<GraphPartitioner::Group*> rejected;
     for (auto& kv : group2func_) {
       FunctionCreator& creator = kv.second;
       creator.CreateFunction();
+      if (fcheck_group_.defined()) {
+        bool keep = fcheck_group_.value()(creator.function_, mod_);
+        if (!keep) rejected.push_back(kv.first);
+      }
+    }
+    for (GraphPartitioner::Group* group : rejected) {
+      group2func_.erase(group);
     }
 
     // Step 4. Start generating the new binding block.
@@ -605,10 +621,10 @@ class OperatorFusor : public ExprMutator {
     for (size_t i = 0; i < block->bindings.size(); ++i) {
       const Binding& binding = block->bindings[i];
 
-      // Case 1. If the binding is the only binding in its group, recurse into it and emit the
-      // transformed binding as usual.
+      // Case 1. If the binding is the only binding in its group, or its group is not fused,
+      // recurse into it and emit the transformed binding as usual.
       GraphPartitioner::Group* group = GetGroupFromBinding(binding);
-      if (group->num_nodes == 1) {
+      if (group->num_nodes == 1 || !group2func_.count(group)) {
         VisitBinding(binding);
         continue;
       }
@@ -627,7 +643,8 @@ class OperatorFusor : public ExprMutator {
       ICHECK(var_binding != nullptr) << "The last binding of a group whose size is larger than 1 "
                                         "is supposed to be a variable binding";
 
-      // Step a. Add the grouped function to the IRModule
+      // Step a. Add the grouped function to the IRModule. The builder deduplicates structurally
+      // equal functions, so identical groups of different functions share a single one.
       GlobalVar gv = builder_->AddFunction(func_info.function_, func_info.name_hint_);
 
       // Step b. Create the call to the deduplicated function, and then emit the call.
@@ -755,9 +772,15 @@ class OperatorFusor : public ExprMutator {
   std::unordered_map<const Object*, GraphPartitioner::Group*> obj2group_;
   /*! \brief Internal function information map. */
   std::unordered_map<GraphPartitioner::Group*, FunctionCreator> group2func_;
+  /*!
+   * \brief The function deciding whether to fuse a group, given its grouped function and the
+   * module, e.g. from the predictions of a cost model. All the groups are fused if undefined.
+   */
+  Optional<PackedFunc> fcheck_group_;
 };
 
-IRModule FuseOps(IRModule mod, int opt_level, size_t max_fuse_depth) {
+IRModule FuseOps(IRModule mod, int opt_level, size_t max_fuse_depth,
+                 Optional<PackedFunc> fcheck_group) {
   support::Arena arena;
 
   // Step 1. Create the indexed-forward graph according to the input IRModule.
@@ -769,19 +792,19 @@ IRModule FuseOps(IRModule mod, int opt_level, size_t max_fuse_depth) {
 
   // Step 3. Transform the IRModule by fusing the operators in accordance with the graph partition
   // results.
-  mod = OperatorFusor(mod, graph, groups).Transform();
+  mod = OperatorFusor(mod, graph, groups, fcheck_group).Transform();
 
   return mod;
 }
 
 namespace transform {
 
-Pass FuseOps(int fuse_opt_level) {
+Pass FuseOps(int fuse_opt_level, Optional<PackedFunc> fcheck_group) {
   runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =  //
       [=](IRModule m, PassContext pc) {
         int opt_level = fuse_opt_level == -1 ? pc->opt_level : fuse_opt_level;
         auto max_fuse_depth = pc->GetConfig("relax.FuseOps.max_depth", Integer(kMaxFusedOps));
-        return relax::FuseOps(m, opt_level, max_fuse_depth.value().IntValue());
+        return relax::FuseOps(m, opt_level, max_fuse_depth.value().IntValue(), fcheck_group);
       };
   return CreateModulePass(/*pass_function=*/pass_func,  //
                           /*opt_level=*/0,              //
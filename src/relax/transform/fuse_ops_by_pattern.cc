@@ -0,0 +1,353 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/transform/fuse_ops_by_pattern.cc
+ * \brief Group the bindings matching the patterns of external codegens into composite functions.
+ *        Each match becomes
+ *
+ *          @fused_tensorrt_add(x, y) attrs {"Codegen": "tensorrt", "global_symbol": ...}:
+ *            composite = fn(x, y) attrs {"Composite": "tensorrt.add"}: ...
+ *            return composite(x, y)
+ *
+ *        which RunCodegen hands to the codegen registered as "relax.ext.tensorrt".
+ */
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/dataflow_pattern.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/transform.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../ir/dataflow_matcher_impl.h"
+#include "utils.h"
+
+namespace tvm {
+namespace relax {
+
+Var OffloadedFunctionCreator::GetParam(const Var& var, Array<Var>* params,
+                                       Array<Expr>* arguments) {
+  auto it = var_remap_.find(var->vid);
+  if (it != var_remap_.end()) return it->second;
+  Var param = CreateParam(var);
+  var_remap_[var->vid] = param;
+  params->push_back(param);
+  arguments->push_back(var);
+  return param;
+}
+
+Var OffloadedFunctionCreator::CreateParam(const Var& var) {
+  Var param(var->name_hint(),          //
+            /*shape_annotation=*/NullOpt,  //
+            /*type_annotation=*/var->checked_type_);
+  param->shape_ = var->shape_;
+  return param;
+}
+
+Function OffloadedFunctionCreator::CreateFunction(const Array<Var>& params,
+                                                  const BindingBlock& block, const Var& output,
+                                                  const Map<String, ObjectRef>& attrs) {
+  Expr body = builder_->Normalize(SeqExpr({block}, output));
+  return Function(/*params=*/params,                   //
+                  /*body=*/body,                       //
+                  /*ret_type=*/body->checked_type_,    //
+                  /*ret_shape=*/RuntimeDepShape(),     //
+                  /*attrs=*/DictAttrs(attrs));
+}
+
+Map<String, ObjectRef> OffloadedFunctionAttrs(const String& codegen) {
+  Map<String, ObjectRef> attrs;
+  attrs.Set(attr::kCodegen, codegen);
+  attrs.Set(attr::kPrimitive, Integer(1));
+  return attrs;
+}
+
+bool IsGroupedOrOffloaded(const FunctionNode* func) {
+  return func->HasNonzeroAttr(attr::kPrimitive) || func->GetAttr<String>(attr::kCodegen).defined();
+}
+
+Var EmitOffloadedCall(const BlockBuilder& builder, const Function& func,
+                      const std::string& name_hint, const Array<Expr>& args, const Var& var) {
+  // The builder deduplicates structurally equal functions, so identical groups share one.
+  GlobalVar gv = builder->AddFunction(func, name_hint);
+  builder->UpdateFunction(gv, WithAttr(func, tvm::attr::kGlobalSymbol, String(gv->name_hint)));
+  return var->IsInstance<DataflowVarNode>() ? builder->Emit(Call(gv, args))
+                                            : builder->EmitOutput(Call(gv, args));
+}
+
+/*!
+ * \brief Create the function offloading a group of bindings, and the composite function it calls.
+ * \note A fresh creator is supposed to be used for each group.
+ */
+class CompositeFunctionCreator : public OffloadedFunctionCreator {
+ public:
+  /*!
+   * \brief Create the function offloading the bindings.
+   * \param bindings The bindings of the group in the order of the block, the last being the output.
+   * \param pattern_name The name of the pattern matched by the bindings.
+   * \param arguments The arguments to call the function on the caller side, set by this function.
+   * \return The function, with the attribute "Codegen" but without "global_symbol" yet.
+   */
+  Function Create(const std::vector<VarBinding>& bindings, const String& pattern_name,
+                  Array<Expr>* arguments) {
+    // Step 1. The vars used but not defined by the bindings become the parameters.
+    Array<Var> params;
+    std::unordered_set<const VarNode*> defined;
+    for (const VarBinding& binding : bindings) {
+      PostOrderVisit(binding->value, [&](const ObjectRef& obj) {
+        const auto* var = obj.as<VarNode>();
+        if (var == nullptr || defined.count(var)) return;
+        GetParam(GetRef<Var>(var), &params, arguments);
+      });
+      defined.insert(binding->var.get());
+    }
+
+    // Step 2. Create the composite function holding the bindings.
+    builder_->BeginDataflowBlock();
+    for (size_t i = 0; i + 1 < bindings.size(); ++i) {
+      VisitBinding(bindings[i]);
+    }
+    Var output = builder_->EmitOutput(VisitExpr(bindings.back()->value));
+    Map<String, ObjectRef> composite_attrs;
+    composite_attrs.Set(attr::kComposite, pattern_name);
+    composite_attrs.Set(attr::kPrimitive, Integer(1));
+    Function composite = CreateFunction(params, builder_->EndBlock(), output, composite_attrs);
+
+    // Step 3. Create the function calling the composite function.
+    Array<Var> outer_params;
+    for (const Var& param : params) {
+      outer_params.push_back(CreateParam(param));
+    }
+    builder_->BeginDataflowBlock();
+    Array<Expr> call_args(outer_params.begin(), outer_params.end());
+    output = builder_->EmitOutput(Call(composite, call_args));
+    std::string name = pattern_name;
+    return CreateFunction(outer_params, builder_->EndBlock(), output,
+                          OffloadedFunctionAttrs(name.substr(0, name.find('.'))));
+  }
+};
+
+/*!
+ * \brief The ExprMutator offloading the bindings of the dataflow blocks matching the patterns.
+ * \details For each dataflow block, the bindings are visited from the last to the first, and each
+ * one not grouped yet is matched against the patterns in order, so that a match grows from its
+ * output and takes in as many producers as its pattern describes. A match is grouped when
+ *  - none of its bindings is grouped yet,
+ *  - none of its bindings but the output is used outside of it, so that the block stays acyclic
+ *    and no computation is duplicated,
+ *  - and the check function, if any, accepts it.
+ * The bindings of a group are replaced by a call to its function at the position of its output.
+ */
+class PatternBasedFusor : public ExprMutator {
+ public:
+  explicit PatternBasedFusor(IRModule mod, Array<String> pattern_names, Array<DFPattern> patterns,
+                             Optional<PackedFunc> fcheck_group)
+      : ExprMutator(mod),
+        mod_(std::move(mod)),
+        pattern_names_(std::move(pattern_names)),
+        patterns_(std::move(patterns)),
+        fcheck_group_(std::move(fcheck_group)) {
+    ICHECK_EQ(pattern_names_.size(), patterns_.size())
+        << "The number of pattern names and patterns must be the same.";
+  }
+
+  IRModule Transform() {
+    for (const auto& kv : mod_->functions) {
+      const auto* func = kv.second.as<FunctionNode>();
+      // Skip the functions already grouped, and the ones to be offloaded.
+      if (func == nullptr || IsGroupedOrOffloaded(func)) continue;
+      builder_->UpdateFunction(kv.first, Downcast<Function>(VisitExpr(GetRef<Function>(func))));
+    }
+    return builder_->GetContextIRModule();
+  }
+
+ private:
+  /*! \brief A group of bindings matching a pattern. */
+  struct Group {
+    /*! \brief The function offloading the group. */
+    Function function{nullptr};
+    /*! \brief The arguments to call the function. */
+    Array<Expr> arguments;
+    /*! \brief The name hint of the function. */
+    std::string name_hint;
+  };
+
+  using ExprMutator::VisitBindingBlock_;
+
+  BindingBlock VisitBindingBlock_(const DataflowBlockNode* block) final {
+    std::unordered_map<size_t, Group> groups;
+    std::vector<bool> grouped(block->bindings.size(), false);
+    FindGroups(GetRef<DataflowBlock>(block), &groups, &grouped);
+    if (groups.empty()) return ExprMutator::VisitBindingBlock_(block);
+
+    builder_->BeginDataflowBlock();
+    for (size_t i = 0; i < block->bindings.size(); ++i) {
+      const Binding& binding = block->bindings[i];
+      auto it = groups.find(i);
+      if (it == groups.end()) {
+        // The bindings of a group but its output are emitted along with the output.
+        if (!grouped[i]) VisitBinding(binding);
+        continue;
+      }
+      const Group& group = it->second;
+      Array<Expr> args;
+      for (const Expr& arg : group.arguments) {
+        args.push_back(VisitExpr(arg));
+      }
+      const Var& var = Downcast<VarBinding>(binding)->var;
+      var_remap_[var->vid] =
+          EmitOffloadedCall(builder_, group.function, group.name_hint, args, var);
+    }
+    return builder_->EndBlock();
+  }
+
+  /*!
+   * \brief Find the groups of the bindings of a block matching the patterns.
+   * \param block The dataflow block.
+   * \param groups The groups found, keyed by the index of their output binding.
+   * \param grouped Whether each binding is in a group.
+   */
+  void FindGroups(const DataflowBlock& block, std::unordered_map<size_t, Group>* groups,
+                  std::vector<bool>* grouped) {
+    const Array<Binding>& bindings = block->bindings;
+    Map<Var, Expr> var2val = AnalyzeVar2Value(block);
+    // The index of the binding of each value, and the indices of the bindings using each var.
+    std::unordered_map<const Object*, size_t> value2index;
+    std::unordered_map<const VarNode*, std::vector<size_t>> var2users;
+    for (size_t i = 0; i < bindings.size(); ++i) {
+      Expr value;
+      if (const auto* var_binding = bindings[i].as<VarBindingNode>()) {
+        value = var_binding->value;
+        value2index[value.get()] = i;
+      } else {
+        const auto* match_shape = bindings[i].as<MatchShapeNode>();
+        ICHECK_NOTNULL(match_shape);
+        value = match_shape->value;
+      }
+      PostOrderVisit(value, [&](const ObjectRef& obj) {
+        if (const auto* var = obj.as<VarNode>()) var2users[var].push_back(i);
+      });
+    }
+
+    for (int i = static_cast<int>(bindings.size()) - 1; i >= 0; --i) {
+      const auto* root = bindings[i].as<VarBindingNode>();
+      if (root == nullptr || (*grouped)[i]) continue;
+      for (size_t k = 0; k < patterns_.size(); ++k) {
+        DFPatternMatcher matcher(var2val);
+        if (!matcher.Match(patterns_[k], root->value)) continue;
+
+        // The bindings of the match are those of the values matched by the non-leaf patterns.
+        std::vector<size_t> indices{static_cast<size_t>(i)};
+        for (const auto& kv : matcher.GetMemo()) {
+          if (!kv.first->IsInstance<CallPatternNode>() &&
+              !kv.first->IsInstance<TuplePatternNode>() &&
+              !kv.first->IsInstance<TupleGetItemPatternNode>()) {
+            continue;
+          }
+          for (const Expr& expr : kv.second) {
+            auto it = value2index.find(expr.get());
+            if (it != value2index.end()) indices.push_back(it->second);
+          }
+        }
+        std::sort(indices.begin(), indices.end());
+        indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+        if (!IsValidGroup(bindings, indices, var2users, *grouped)) continue;
+
+        std::vector<VarBinding> group_bindings;
+        for (size_t index : indices) {
+          group_bindings.push_back(Downcast<VarBinding>(bindings[index]));
+        }
+        Group group;
+        String pattern_name = pattern_names_[k];
+        group.function =
+            CompositeFunctionCreator().Create(group_bindings, pattern_name, &group.arguments);
+        if (fcheck_group_.defined()) {
+          bool accepted = fcheck_group_.value()(group.function, mod_);
+          if (!accepted) continue;
+        }
+        group.name_hint = "fused_" + std::string(pattern_name);
+        std::replace(group.name_hint.begin(), group.name_hint.end(), '.', '_');
+        for (size_t index : indices) {
+          (*grouped)[index] = true;
+        }
+        groups->emplace(i, std::move(group));
+        break;
+      }
+    }
+  }
+
+  /*!
+   * \brief Check whether the bindings of a match can be grouped, where the last binding is the
+   * output of the group.
+   */
+  static bool IsValidGroup(const Array<Binding>& bindings, const std::vector<size_t>& indices,
+                           const std::unordered_map<const VarNode*, std::vector<size_t>>& var2users,
+                           const std::vector<bool>& grouped) {
+    std::unordered_set<size_t> members(indices.begin(), indices.end());
+    for (size_t index : indices) {
+      const auto* binding = bindings[index].as<VarBindingNode>();
+      if (grouped[index] || binding == nullptr) return false;
+      if (index == indices.back()) continue;
+      const Var& var = binding->var;
+      // Only the output of the group can be used after the block.
+      if (!var->IsInstance<DataflowVarNode>()) return false;
+      auto it = var2users.find(var.get());
+      if (it == var2users.end()) continue;
+      for (size_t user : it->second) {
+        if (!members.count(user)) return false;
+      }
+    }
+    return true;
+  }
+
+  /*! \brief The IRModule. */
+  IRModule mod_;
+  /*! \brief The names of the patterns, prefixed by the names of their codegens. */
+  Array<String> pattern_names_;
+  /*! \brief The patterns, in the order of priority. */
+  Array<DFPattern> patterns_;
+  /*! \brief The function deciding whether to offload a match. All are offloaded if undefined. */
+  Optional<PackedFunc> fcheck_group_;
+};
+
+namespace transform {
+
+Pass FuseOpsByPattern(Array<String> pattern_names, Array<DFPattern> patterns,
+                      Optional<PackedFunc> fcheck_group) {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =  //
+      [=](IRModule m, PassContext pc) {
+        return PatternBasedFusor(m, pattern_names, patterns, fcheck_group).Transform();
+      };
+  return CreateModulePass(/*pass_function=*/pass_func,       //
+                          /*opt_level=*/0,                   //
+                          /*pass_name=*/"FuseOpsByPattern",  //
+                          /*required=*/{});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.FuseOpsByPattern").set_body_typed(FuseOpsByPattern);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
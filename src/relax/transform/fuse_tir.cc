@@ -712,6 +712,11 @@ Pass FuseTIR() {
 
 TVM_REGISTER_GLOBAL("relax.transform.FuseTIR").set_body_typed(FuseTIR);
 
+TVM_REGISTER_GLOBAL("relax.transform.FusedPrimFunc")
+    .set_body_typed([](IRModule mod, GlobalVar gv) {
+      return FusedTIRConstructor::GetFusedTIR(mod, gv);
+    });
+
 }  // namespace transform
 
 }  // namespace relax
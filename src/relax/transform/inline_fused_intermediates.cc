@@ -0,0 +1,106 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/transform/inline_fused_intermediates.cc
+ * \brief Inline the injective stages of the PrimFuncs fused by FuseTIR into their neighbours, so
+ *        that the intermediate buffers between them are not materialized.
+ */
+#include <tvm/relax/transform.h>
+#include <tvm/tir/function.h>
+#include <tvm/tir/schedule/state.h>
+#include <tvm/tir/stmt.h>
+
+#include "../../tir/schedule/analysis.h"
+#include "../../tir/schedule/primitive.h"
+
+namespace tvm {
+namespace relax {
+
+/*!
+ * \brief Inline one stage of the root block of the PrimFunc, if any can be.
+ * \return Whether a stage is inlined.
+ */
+bool InlineOneStage(const tir::ScheduleState& state, const tir::StmtSRef& root_sref) {
+  for (const tir::StmtSRef& block_sref : tir::GetChildBlockSRefOnSRefTree(state, root_sref)) {
+    // Inlining a producer into several consumers would compute it once per consumer.
+    const tir::BlockScope& scope = state->GetBlockScope(root_sref);
+    if (tir::GetConsumers(block_sref, scope).size() == 1 &&
+        tir::CanComputeInline(state, block_sref)) {
+      tir::ComputeInline(state, block_sref);
+      return true;
+    }
+    if (tir::CanReverseComputeInline(state, block_sref)) {
+      tir::ReverseComputeInline(state, block_sref);
+      return true;
+    }
+  }
+  return false;
+}
+
+/*!
+ * \brief Inline the stages of a fused PrimFunc writing to the buffers allocated by its root
+ * block. The injective producers with a single consumer, e.g. a dequantize feeding a matmul, are
+ * inlined into it. The injective consumers of complete blocks, e.g. the elementwise epilogues
+ * following the bias add of a matmul, are inlined into their producer.
+ */
+tir::PrimFunc InlineIntermediates(const GlobalVar& gvar, const tir::PrimFunc& func) {
+  const auto* realize = func->body.as<tir::BlockRealizeNode>();
+  if (realize == nullptr || realize->block->alloc_buffers.empty()) return func;
+  tir::ScheduleState state(IRModule({{gvar, func}}));
+  tir::StmtSRef root_sref = state->stmt2ref.at(realize->block.get());
+  bool inlined = false;
+  while (InlineOneStage(state, root_sref)) {
+    inlined = true;
+  }
+  if (!inlined) return func;
+  return Downcast<tir::PrimFunc>(state->mod->Lookup(gvar));
+}
+
+IRModule InlineFusedIntermediates(IRModule mod) {
+  Map<GlobalVar, tir::PrimFunc> updates;
+  for (const auto& kv : mod->functions) {
+    if (const auto* func = kv.second.as<tir::PrimFuncNode>()) {
+      tir::PrimFunc inlined = InlineIntermediates(kv.first, GetRef<tir::PrimFunc>(func));
+      if (!inlined.same_as(kv.second)) updates.Set(kv.first, inlined);
+    }
+  }
+  if (updates.empty()) return mod;
+  IRModuleNode* new_module = mod.CopyOnWrite();
+  for (const auto& kv : updates) {
+    new_module->Update(kv.first, kv.second);
+  }
+  return GetRef<IRModule>(new_module);
+}
+
+namespace transform {
+
+Pass InlineFusedIntermediates() {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
+      [=](IRModule m, PassContext pc) { return relax::InlineFusedIntermediates(std::move(m)); };
+  return CreateModulePass(pass_func, 0, "InlineFusedIntermediates", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.InlineFusedIntermediates")
+    .set_body_typed(InlineFusedIntermediates);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
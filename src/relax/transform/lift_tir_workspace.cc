@@ -0,0 +1,143 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/relax/transform/lift_tir_workspace.cc
+ * \brief Lift the scratch buffers of the PrimFuncs called by call_tir into their parameters.
+ */
+#include <tvm/relax/expr.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/transform.h>
+#include <tvm/tir/function.h>
+#include <tvm/tir/stmt.h>
+
+#include <string>
+#include <unordered_set>
+
+namespace tvm {
+namespace relax {
+
+/*! \brief Collect the PrimFuncs only referenced as the callee of a call_tir. */
+class WorkspaceCalleeCollector : public ExprVisitor {
+ public:
+  static std::unordered_set<std::string> Collect(const IRModule& mod) {
+    WorkspaceCalleeCollector collector;
+    for (const auto& kv : mod->functions) {
+      if (const auto* func = kv.second.as<FunctionNode>()) {
+        collector.VisitExpr(GetRef<Function>(func));
+      }
+    }
+    std::unordered_set<std::string> ret;
+    for (const std::string& name : collector.callees_) {
+      if (!collector.others_.count(name)) ret.insert(name);
+    }
+    return ret;
+  }
+
+  using ExprVisitor::VisitExpr_;
+
+  void VisitExpr_(const CallNode* call) final {
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    // the callee of call_tir with the unpacked shape argument takes the shape vars last
+    const auto* gvar = call->args.empty() ? nullptr : call->args[0].as<GlobalVarNode>();
+    if (call->op == call_tir_op && call->args.size() == 3 && gvar != nullptr) {
+      callees_.insert(gvar->name_hint);
+      for (size_t i = 1; i < call->args.size(); ++i) {
+        VisitExpr(call->args[i]);
+      }
+      return;
+    }
+    ExprVisitor::VisitExpr_(call);
+  }
+
+  void VisitExpr_(const GlobalVarNode* gvar) final { others_.insert(gvar->name_hint); }
+
+ private:
+  std::unordered_set<std::string> callees_;
+  std::unordered_set<std::string> others_;
+};
+
+/*! \brief Whether the buffer is a scratch buffer of static shape in the global memory. */
+bool IsLiftableWorkspace(const tir::Buffer& buffer) {
+  if (buffer.scope() != "global") return false;
+  for (const PrimExpr& dim : buffer->shape) {
+    if (!dim->IsInstance<IntImmNode>()) return false;
+  }
+  return true;
+}
+
+/*!
+ * \brief Append the scratch buffers allocated by the root block of the PrimFunc to its
+ * parameters, so that the caller allocates them with the other tensors it plans.
+ */
+tir::PrimFunc LiftWorkspace(tir::PrimFunc func) {
+  if (func->GetAttr<Integer>(attr::kNumWorkspaces).defined()) return func;
+  const auto* realize = func->body.as<tir::BlockRealizeNode>();
+  if (realize == nullptr) return func;
+  Array<tir::Buffer> kept;
+  Array<tir::Buffer> lifted;
+  for (const tir::Buffer& buffer : realize->block->alloc_buffers) {
+    if (IsLiftableWorkspace(buffer)) {
+      lifted.push_back(buffer);
+    } else {
+      kept.push_back(buffer);
+    }
+  }
+  if (lifted.empty()) return func;
+
+  tir::Block block = realize->block;
+  block.CopyOnWrite()->alloc_buffers = kept;
+  tir::BlockRealize new_realize = GetRef<tir::BlockRealize>(realize);
+  new_realize.CopyOnWrite()->block = block;
+  tir::PrimFuncNode* n = func.CopyOnWrite();
+  n->body = new_realize;
+  for (const tir::Buffer& buffer : lifted) {
+    tir::Var param(buffer->name + "_handle", DataType::Handle());
+    n->params.push_back(param);
+    n->buffer_map.Set(param, buffer);
+  }
+  return WithAttr(std::move(func), attr::kNumWorkspaces, Integer(lifted.size()));
+}
+
+IRModule LiftTIRWorkspace(IRModule mod) {
+  std::unordered_set<std::string> callees = WorkspaceCalleeCollector::Collect(mod);
+  IRModuleNode* new_module = mod.CopyOnWrite();
+  for (const std::string& name : callees) {
+    if (!new_module->ContainGlobalVar(name)) continue;
+    GlobalVar gvar = new_module->GetGlobalVar(name);
+    if (const auto* func = new_module->Lookup(gvar).as<tir::PrimFuncNode>()) {
+      new_module->Update(gvar, LiftWorkspace(GetRef<tir::PrimFunc>(func)));
+    }
+  }
+  return GetRef<IRModule>(new_module);
+}
+
+namespace transform {
+
+Pass LiftTIRWorkspace() {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
+      [=](IRModule m, PassContext pc) { return relax::LiftTIRWorkspace(std::move(m)); };
+  return CreateModulePass(pass_func, 0, "LiftTIRWorkspace", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.LiftTIRWorkspace").set_body_typed(LiftTIRWorkspace);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
@@ -0,0 +1,137 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/transform/localize_fused_intermediates.cc
+ * \brief Move the producers of the intermediate buffers of the PrimFuncs fused by FuseTIR under
+ *        the loops of their consumers, so that the buffers are only allocated for the region
+ *        live in an iteration.
+ */
+#include <tvm/relax/transform.h>
+#include <tvm/tir/function.h>
+#include <tvm/tir/schedule/schedule.h>
+#include <tvm/tir/stmt.h>
+
+#include <unordered_set>
+
+namespace tvm {
+namespace relax {
+
+/*! \brief The number of iterations of the loops around the block, or -1 if any is symbolic. */
+int64_t NumIterations(const tir::Schedule& sch, const tir::BlockRV& block_rv) {
+  int64_t num_iters = 1;
+  for (const tir::LoopRV& loop_rv : sch->GetLoops(block_rv)) {
+    const auto* extent = sch->Get(loop_rv)->extent.as<IntImmNode>();
+    if (extent == nullptr) return -1;
+    num_iters *= extent->value;
+  }
+  return num_iters;
+}
+
+/*!
+ * \brief Move the producer under the deepest loop of its consumer where it still computes each
+ * element once, i.e. where compute-at does not add iterations to the producer.
+ * \return The schedule after the move, or NullOpt if the producer cannot be moved.
+ */
+Optional<tir::Schedule> ComputeAtConsumer(const tir::Schedule& sch, const tir::BlockRV& producer,
+                                          const tir::BlockRV& consumer) {
+  int64_t num_iters = NumIterations(sch, producer);
+  if (num_iters == -1) return NullOpt;
+  Optional<tir::Schedule> moved = NullOpt;
+  for (const tir::LoopRV& loop_rv : sch->GetLoops(consumer)) {
+    tir::Schedule trial = sch->Copy();
+    try {
+      trial->ComputeAt(producer, loop_rv, /*preserve_unit_loops=*/true);
+    } catch (const tvm::runtime::Error& e) {
+      break;
+    }
+    if (NumIterations(trial, producer) != num_iters) break;
+    moved = trial;
+  }
+  return moved;
+}
+
+/*!
+ * \brief Move the producer of each buffer allocated by the root block of the PrimFunc under the
+ * loops of its single consumer. PlanAndUpdateBufferAllocationLocation then allocates the buffer
+ * in the loop, and CompactBufferAllocation shrinks it to the region of an iteration.
+ */
+tir::PrimFunc LocalizeIntermediates(const GlobalVar& gvar, const tir::PrimFunc& func) {
+  const auto* realize = func->body.as<tir::BlockRealizeNode>();
+  if (realize == nullptr || realize->block->alloc_buffers.empty()) return func;
+  std::unordered_set<const tir::BufferNode*> intermediates;
+  for (const tir::Buffer& buffer : realize->block->alloc_buffers) {
+    intermediates.insert(buffer.get());
+  }
+  tir::Schedule sch = tir::Schedule::Concrete(IRModule({{gvar, func}}), /*seed=*/-1,
+                                              /*debug_mask=*/0,
+                                              tir::ScheduleErrorRenderLevel::kNone);
+  tir::BlockRV root = sch->GetBlock(realize->block->name_hint, gvar->name_hint);
+  Array<tir::BlockRV> blocks = sch->GetChildBlocks(root);
+  bool moved = false;
+  // Visit the consumers before their producers, so that a producer follows its consumer moved
+  // under the loops of a later stage.
+  for (auto it = blocks.rbegin(); it != blocks.rend(); ++it) {
+    const tir::BlockRV& producer = *it;
+    tir::Block block = sch->Get(producer);
+    if (block->writes.size() != 1 || !intermediates.count(block->writes[0]->buffer.get())) {
+      continue;
+    }
+    Array<tir::BlockRV> consumers = sch->GetConsumers(producer);
+    if (consumers.size() != 1) continue;
+    if (Optional<tir::Schedule> new_sch = ComputeAtConsumer(sch, producer, consumers[0])) {
+      sch = new_sch.value();
+      moved = true;
+    }
+  }
+  if (!moved) return func;
+  return Downcast<tir::PrimFunc>(sch->mod()->Lookup(gvar));
+}
+
+IRModule LocalizeFusedIntermediates(IRModule mod) {
+  Map<GlobalVar, tir::PrimFunc> updates;
+  for (const auto& kv : mod->functions) {
+    if (const auto* func = kv.second.as<tir::PrimFuncNode>()) {
+      tir::PrimFunc localized = LocalizeIntermediates(kv.first, GetRef<tir::PrimFunc>(func));
+      if (!localized.same_as(kv.second)) updates.Set(kv.first, localized);
+    }
+  }
+  if (updates.empty()) return mod;
+  IRModuleNode* new_module = mod.CopyOnWrite();
+  for (const auto& kv : updates) {
+    new_module->Update(kv.first, kv.second);
+  }
+  return GetRef<IRModule>(new_module);
+}
+
+namespace transform {
+
+Pass LocalizeFusedIntermediates() {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
+      [=](IRModule m, PassContext pc) { return relax::LocalizeFusedIntermediates(std::move(m)); };
+  return CreateModulePass(pass_func, 0, "LocalizeFusedIntermediates", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.LocalizeFusedIntermediates")
+    .set_body_typed(LocalizeFusedIntermediates);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
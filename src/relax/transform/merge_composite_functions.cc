@@ -0,0 +1,279 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+/*!
+ * \file src/relax/transform/merge_composite_functions.cc
+ * \brief Merge the chains of functions offloaded to the same codegen by FuseOpsByPattern into one
+ *        function, so that the codegen sees the whole chain. In
+ *
+ *          lv0 = fused_dnnl_dense_bias(x, w, b)
+ *          lv1 = fused_dnnl_relu(lv0)
+ *
+ *        where lv0 is only used by lv1, both calls are replaced by a call to
+ *
+ *          @fused_dnnl_dense_bias_dnnl_relu(x, w, b) attrs {"Codegen": "dnnl", ...}:
+ *            lv0 = composite_dense_bias(x, w, b)
+ *            lv1 = composite_relu(lv0)
+ *            return lv1
+ *
+ *        so that the codegen can e.g. keep lv0 in its own layout, or in its own memory.
+ */
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/transform.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "utils.h"
+
+namespace tvm {
+namespace relax {
+
+/*! \brief A call to a function created by FuseOpsByPattern. */
+struct OffloadedCall {
+  /*! \brief The called function. */
+  GlobalVar gv;
+  /*! \brief The codegen of the function. */
+  String codegen;
+  /*! \brief The composite function it calls on all its params, in order. */
+  Function composite;
+  /*! \brief The arguments of the call. */
+  Array<Var> args;
+};
+
+/*!
+ * \brief Create the function offloading a chain of calls to functions of the same codegen.
+ * \note A fresh creator is supposed to be used for each chain.
+ */
+class MergedFunctionCreator : public OffloadedFunctionCreator {
+ public:
+  /*!
+   * \brief Create the function offloading the calls.
+   * \param calls The calls in the order of the block, the last being the output.
+   * \param vars The vars bound to the calls.
+   * \param arguments The arguments to call the function on the caller side, set by this function.
+   * \return The function, with the attribute "Codegen" but without "global_symbol" yet.
+   */
+  Function Create(const std::vector<OffloadedCall>& calls, const std::vector<Var>& vars,
+                  Array<Expr>* arguments) {
+    Array<Var> params;
+    builder_->BeginDataflowBlock();
+    Var output;
+    for (size_t i = 0; i < calls.size(); ++i) {
+      Array<Expr> args;
+      for (const Var& arg : calls[i].args) {
+        args.push_back(GetParam(arg, &params, arguments));
+      }
+      Call call(calls[i].composite, args);
+      if (i + 1 < calls.size()) {
+        var_remap_[vars[i]->vid] = builder_->Emit(call);
+      } else {
+        output = builder_->EmitOutput(call);
+      }
+    }
+    return CreateFunction(params, builder_->EndBlock(), output,
+                          OffloadedFunctionAttrs(calls[0].codegen));
+  }
+};
+
+/*!
+ * \brief The ExprMutator merging the chains of offloaded calls of the dataflow blocks.
+ * \details The bindings are visited in order, and an offloaded call joins the chains of its
+ * arguments that are offloaded calls to the same codegen and are used by it only, so that the
+ * intermediate results never escape a chain and the block stays acyclic. A merged chain is
+ * called at the position of its last call.
+ */
+class CompositeChainMerger : public ExprMutator {
+ public:
+  explicit CompositeChainMerger(IRModule mod) : ExprMutator(mod), mod_(std::move(mod)) {}
+
+  IRModule Transform() {
+    for (const auto& kv : mod_->functions) {
+      const auto* func = kv.second.as<FunctionNode>();
+      // Skip the functions already grouped, and the ones to be offloaded.
+      if (func == nullptr || IsGroupedOrOffloaded(func)) continue;
+      builder_->UpdateFunction(kv.first, Downcast<Function>(VisitExpr(GetRef<Function>(func))));
+    }
+    IRModule mod = builder_->GetContextIRModule();
+    if (merged_.empty()) return mod;
+
+    // Remove the functions whose calls were all merged.
+    std::unordered_set<const GlobalVarNode*> used;
+    for (const auto& kv : mod->functions) {
+      if (!kv.second->IsInstance<FunctionNode>()) continue;
+      PostOrderVisit(kv.second, [&](const ObjectRef& obj) {
+        if (const auto* gv = obj.as<GlobalVarNode>()) used.insert(gv);
+      });
+    }
+    for (const GlobalVar& gv : merged_) {
+      if (!used.count(gv.get()) && mod->ContainGlobalVar(gv->name_hint)) {
+        mod.CopyOnWrite()->Remove(gv);
+      }
+    }
+    return mod;
+  }
+
+ private:
+  using ExprMutator::VisitBindingBlock_;
+
+  BindingBlock VisitBindingBlock_(const DataflowBlockNode* block) final {
+    const Array<Binding>& bindings = block->bindings;
+    // The offloaded calls, and the indices of the bindings using each var.
+    std::unordered_map<size_t, OffloadedCall> calls;
+    std::unordered_map<const VarNode*, size_t> var2index;
+    std::unordered_map<const VarNode*, std::unordered_set<size_t>> var2users;
+    for (size_t i = 0; i < bindings.size(); ++i) {
+      Expr value;
+      if (const auto* var_binding = bindings[i].as<VarBindingNode>()) {
+        value = var_binding->value;
+        var2index[var_binding->var.get()] = i;
+        OffloadedCall call;
+        if (GetOffloadedCall(value, &call)) calls.emplace(i, std::move(call));
+      } else {
+        value = bindings[i].as<MatchShapeNode>()->value;
+      }
+      PostOrderVisit(value, [&](const ObjectRef& obj) {
+        if (const auto* var = obj.as<VarNode>()) var2users[var].insert(i);
+      });
+    }
+    if (calls.size() < 2) return ExprMutator::VisitBindingBlock_(block);
+
+    // The chain of each offloaded call, as the sorted indices of its calls.
+    std::unordered_map<size_t, std::shared_ptr<std::vector<size_t>>> chain_of;
+    for (size_t i = 0; i < bindings.size(); ++i) {
+      auto it = calls.find(i);
+      if (it == calls.end()) continue;
+      auto chain = std::make_shared<std::vector<size_t>>();
+      for (const Var& arg : it->second.args) {
+        auto producer = var2index.find(arg.get());
+        if (producer == var2index.end() || !calls.count(producer->second)) continue;
+        auto producer_chain = chain_of.at(producer->second);
+        if (producer_chain == chain ||
+            calls.at(producer->second).codegen != it->second.codegen ||
+            !arg->IsInstance<DataflowVarNode>() || var2users[arg.get()].size() != 1) {
+          continue;
+        }
+        chain->insert(chain->end(), producer_chain->begin(), producer_chain->end());
+        for (size_t index : *producer_chain) chain_of[index] = chain;
+      }
+      chain->push_back(i);
+      std::sort(chain->begin(), chain->end());
+      chain_of[i] = chain;
+    }
+
+    builder_->BeginDataflowBlock();
+    for (size_t i = 0; i < bindings.size(); ++i) {
+      auto it = chain_of.find(i);
+      if (it == chain_of.end() || it->second->size() == 1) {
+        VisitBinding(bindings[i]);
+        continue;
+      }
+      // The calls of a chain but the last are emitted along with the last.
+      const std::vector<size_t>& chain = *it->second;
+      if (chain.back() != i) continue;
+      std::vector<OffloadedCall> chain_calls;
+      std::vector<Var> chain_vars;
+      std::string name_hint = "fused";
+      for (size_t index : chain) {
+        chain_calls.push_back(calls.at(index));
+        chain_vars.push_back(Downcast<VarBinding>(bindings[index])->var);
+        std::string member = chain_calls.back().gv->name_hint;
+        name_hint += member.substr(member.rfind("fused", 0) == 0 ? 5 : 0);
+        merged_.push_back(chain_calls.back().gv);
+      }
+      Array<Expr> arguments;
+      Function func = MergedFunctionCreator().Create(chain_calls, chain_vars, &arguments);
+      Array<Expr> args;
+      for (const Expr& arg : arguments) {
+        args.push_back(VisitExpr(arg));
+      }
+      const Var& var = chain_vars.back();
+      var_remap_[var->vid] = EmitOffloadedCall(builder_, func, name_hint, args, var);
+    }
+    return builder_->EndBlock();
+  }
+
+  /*!
+   * \brief Check whether a value calls a function created by FuseOpsByPattern, i.e. a function
+   * with a codegen whose body only calls a composite function on all its params.
+   */
+  bool GetOffloadedCall(const Expr& value, OffloadedCall* offloaded) const {
+    const auto* call = value.as<CallNode>();
+    const auto* gv = call ? call->op.as<GlobalVarNode>() : nullptr;
+    if (gv == nullptr || !mod_->ContainGlobalVar(gv->name_hint)) return false;
+    const auto* func = mod_->Lookup(GetRef<GlobalVar>(gv)).as<FunctionNode>();
+    if (func == nullptr || !func->GetAttr<String>(attr::kCodegen).defined()) return false;
+    const auto* body = func->body.as<SeqExprNode>();
+    if (body == nullptr || body->blocks.size() != 1 || body->blocks[0]->bindings.size() != 1) {
+      return false;
+    }
+    const auto* binding = body->blocks[0]->bindings[0].as<VarBindingNode>();
+    const auto* inner = binding ? binding->value.as<CallNode>() : nullptr;
+    const auto* composite = inner ? inner->op.as<FunctionNode>() : nullptr;
+    if (composite == nullptr || !composite->GetAttr<String>(attr::kComposite).defined() ||
+        !body->body.same_as(binding->var) || inner->args.size() != func->params.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < func->params.size(); ++i) {
+      if (!inner->args[i].same_as(func->params[i])) return false;
+    }
+    Array<Var> args;
+    for (const Expr& arg : call->args) {
+      const auto* var = arg.as<VarNode>();
+      if (var == nullptr) return false;
+      args.push_back(GetRef<Var>(var));
+    }
+    offloaded->gv = GetRef<GlobalVar>(gv);
+    offloaded->codegen = func->GetAttr<String>(attr::kCodegen).value();
+    offloaded->composite = GetRef<Function>(composite);
+    offloaded->args = std::move(args);
+    return true;
+  }
+
+  /*! \brief The IRModule. */
+  IRModule mod_;
+  /*! \brief The functions of the merged calls, removed if no longer called. */
+  std::vector<GlobalVar> merged_;
+};
+
+namespace transform {
+
+Pass MergeCompositeFunctions() {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =  //
+      [=](IRModule m, PassContext pc) { return CompositeChainMerger(m).Transform(); };
+  return CreateModulePass(/*pass_function=*/pass_func,               //
+                          /*opt_level=*/0,                           //
+                          /*pass_name=*/"MergeCompositeFunctions",  //
+                          /*required=*/{});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.MergeCompositeFunctions")
+    .set_body_typed(MergeCompositeFunctions);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
@@ -22,10 +22,18 @@
  * \brief Pass for meta_schedule tuning
  */
 #include <tvm/meta_schedule/database.h>
+#include <tvm/meta_schedule/extracted_task.h>
+#include <tvm/meta_schedule/measure_callback.h>
+#include <tvm/meta_schedule/task_scheduler.h>
+#include <tvm/meta_schedule/tune_context.h>
 #include <tvm/relax/transform.h>
 #include <tvm/relax/tuning_api.h>
 #include <tvm/tir/transform.h>
 
+#include <algorithm>
+#include <thread>
+
+#include "../../meta_schedule/utils.h"
 #include "../../printer/text_printer.h"
 
 namespace tvm {
@@ -35,22 +43,28 @@ namespace transform {
 class MetaScheduleTuner {
  public:
   explicit MetaScheduleTuner(Target target, String work_dir, Integer max_trials_global,
-                             Map<String, runtime::NDArray> params = {})
+                             Map<String, runtime::NDArray> params = {},
+                             FloatImm max_tuning_time = FloatImm(DataType::Float(64), 0.0),
+                             Integer convergence_window = Integer(0),
+                             FloatImm convergence_threshold = FloatImm(DataType::Float(64), 0.0))
       : target_(target),
         work_dir_(work_dir),
         max_trials_global_(max_trials_global),
-        params_(params) {
+        params_(params),
+        max_tuning_time_(max_tuning_time),
+        convergence_window_(convergence_window),
+        convergence_threshold_(convergence_threshold) {
     candgen_func_ = runtime::Registry::Get("relax.tuning_api.default_generate_candidate");
     ICHECK(candgen_func_) << "Default candidate generation function is not found.";
-    normalize_mod_func_ = runtime::Registry::Get("tvm.meta_schedule.normalize_mod");
-    ICHECK(normalize_mod_func_) << "Normalization function is not found.";
   }
 
   // TODO(@sunggg): Currently, only supports basic arguments.
   IRModule TuneIRMod(IRModule mod, transform::PassContext ctx) {
     Trace trace = Downcast<Trace>(ctx->GetCurrentTrace());
     ctx->PopTrace();
-    Choice choice("tvm.meta_schedule.tune_relax", {params_, target_, work_dir_, max_trials_global_},
+    Choice choice("tvm.meta_schedule.tune_relax",
+                  {params_, target_, work_dir_, max_trials_global_, max_tuning_time_,
+                   convergence_window_, convergence_threshold_},
                   "relax.tuning_api.Choice.default_constr_func", {});
     Knob knob("meta_schedule.tune_irmod", {{"0", choice}});
     Array<Trace> candidates = (*candgen_func_)(Array<Knob>({knob}), trace);
@@ -65,7 +79,7 @@ class MetaScheduleTuner {
   tir::PrimFunc TuneTIR(tir::PrimFunc f, transform::PassContext ctx) {
     // TODO(@sunggg): Whenever we tune tir, assume we start a new trace w/o pushing to the trace
     // stack. Revisit later when we collect more usecases.
-    Trace trace = Trace((*normalize_mod_func_)(f), {}, {});
+    Trace trace = Trace(meta_schedule::NormalizeMod(f), {}, {});
 
     Choice choice("tvm.meta_schedule.tune_tir", {target_, work_dir_, max_trials_global_},
                   "relax.tuning_api.Choice.default_constr_func", {});
@@ -81,16 +95,125 @@ class MetaScheduleTuner {
   String work_dir_;
   Integer max_trials_global_;
   Map<String, runtime::NDArray> params_;
+  FloatImm max_tuning_time_;
+  Integer convergence_window_;
+  FloatImm convergence_threshold_;
   const runtime::PackedFunc* candgen_func_;
-  const runtime::PackedFunc* normalize_mod_func_;
 };
 
-Pass MetaScheduleApplyDatabase(Optional<String> work_dir) {
+/*!
+ * \brief Schedule a workload that has no tuning record in the database. The best traces of the
+ * nearest workloads, which differ only in shapes, are replayed with their sampling decisions
+ * adapted to the new extents. Otherwise a design space of the default schedule rules of the target
+ * is sampled, so that the kernel is at least parallelized and vectorized on CPU, or bound to
+ * threads on GPU.
+ * \param tir_mod The normalized workload.
+ * \param database The database to look up the nearest workloads in.
+ * \param target The target to schedule for.
+ * \return The schedule, or NullOpt if neither applies.
+ */
+static Optional<tir::Schedule> FallbackSchedule(const IRModule& tir_mod,
+                                                const meta_schedule::Database& database,
+                                                const Target& target) {
+  using namespace tvm::meta_schedule;  // NOLINT(build/namespaces)
+  constexpr int kNumNearest = 8;
+  constexpr int kMaxSampleTries = 16;
+  support::LinearCongruentialEngine::TRandState rand_state = 42;
+  Optional<TuneContext> ctx = NullOpt;
+  try {
+    ctx = TuneContext(tir_mod, target,
+                      SpaceGenerator::PostOrderApply(/*f_block_filter=*/nullptr,
+                                                     /*sch_rules=*/NullOpt,
+                                                     /*postprocs=*/NullOpt,
+                                                     /*mutator_probs=*/NullOpt),
+                      /*search_strategy=*/NullOpt, /*task_name=*/String("fallback"),
+                      /*num_threads=*/1, /*rand_state=*/rand_state, /*logger=*/nullptr);
+  } catch (const std::exception& e) {
+    // No default schedule rules for the target
+    return NullOpt;
+  }
+  SpaceGenerator space_generator = ctx.value()->space_generator.value();
+  ThreadedTraceApply pp(space_generator->postprocs.value_or({}));
+  auto f_apply = [&](const tir::Trace& trace) -> Optional<tir::Schedule> {
+    try {
+      return pp.Apply(tir_mod, trace, &rand_state);
+    } catch (const std::exception& e) {
+      // The trace does not apply to this workload
+      return NullOpt;
+    }
+  };
+  for (const TuningRecord& record : database->GetTopKNearest(tir_mod, kNumNearest)) {
+    if (Optional<tir::Schedule> sch = f_apply(record->trace)) {
+      return sch;
+    }
+  }
+  for (const tir::Schedule& design_space : space_generator->GenerateDesignSpace(tir_mod)) {
+    tir::Trace trace(design_space->trace().value()->insts, {});
+    for (int i = 0; i < kMaxSampleTries; ++i) {
+      if (Optional<tir::Schedule> sch = f_apply(trace)) {
+        return sch;
+      }
+    }
+  }
+  return NullOpt;
+}
+
+/*!
+ * \brief Replace every PrimFunc of the module that has a tuning record in the database with its
+ * best schedule.
+ * \param mod The module to be scheduled.
+ * \param database The database of tuning records.
+ * \param target The target to schedule for.
+ * \param enable_fallback Whether to schedule the PrimFuncs without a record with
+ * FallbackSchedule.
+ * \return The scheduled module.
+ */
+static IRModule ApplyDatabase(const IRModule& mod, const meta_schedule::Database& database,
+                              const Target& target, bool enable_fallback = false) {
+  Map<GlobalVar, BaseFunc> result;
+  for (const auto& iter : mod->functions) {
+    GlobalVar gv = iter.first;
+    BaseFunc base_func = iter.second;
+    if (const auto* prim_func_node = base_func.as<tir::PrimFuncNode>()) {
+      tir::PrimFunc prim_func = GetRef<tir::PrimFunc>(prim_func_node);
+      // Global symbol has to be defined.
+      Optional<String> gsymbol = prim_func->GetAttr<String>(tvm::attr::kGlobalSymbol);
+      ICHECK(gsymbol.defined());
+
+      IRModule tir_mod = meta_schedule::NormalizeMod(prim_func);
+      Optional<tir::Schedule> sch = database->QuerySchedule(tir_mod, target, gv->name_hint);
+      if (!sch.defined() && enable_fallback && target.defined()) {
+        if ((sch = FallbackSchedule(tir_mod, database, target))) {
+          LOG(WARNING) << "Tuning record is not found for primfunc: " << gsymbol.value()
+                       << ", using a fallback schedule";
+        }
+      }
+      if (sch.defined()) {
+        IRModule new_mod = sch.value()->mod();
+        ICHECK_EQ(new_mod->functions.size(), 1);
+        BaseFunc new_base_func = (*new_mod->functions.begin()).second;
+        ICHECK(new_base_func->IsInstance<tir::PrimFuncNode>());
+        tir::PrimFunc new_prim_func = Downcast<tir::PrimFunc>(new_base_func);
+        // copy the original attrs
+        new_prim_func = WithAttrs(std::move(new_prim_func), {prim_func->attrs->dict});
+        result.Set(gv, new_prim_func);
+        continue;
+      } else {
+        LOG(WARNING) << "Tuning record is not found for primfunc: " << gsymbol.value();
+      }
+    }
+    result.Set(gv, base_func);
+  }
+  return IRModule(result,       // functions
+                  {},           // type_definitions
+                  {},           // import_set
+                  {},           // map
+                  mod->attrs);  // attrs);
+}
+
+Pass MetaScheduleApplyDatabase(Optional<String> work_dir, Bool enable_fallback) {
   using tvm::meta_schedule::Database;
   Target target = Target::Current(false);
-  const runtime::PackedFunc* normalize_mod_func_ =
-      runtime::Registry::Get("tvm.meta_schedule.normalize_mod");
-  ICHECK(normalize_mod_func_) << "Normalization function is not found.";
 
   runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func = [=](IRModule mod,
                                                                             PassContext ctx) {
@@ -103,51 +226,25 @@ Pass MetaScheduleApplyDatabase(Optional<String> work_dir) {
       String path_tuning_record = work_dir.value() + "/database_tuning_record.json";
       LOG(WARNING) << "Creating JSONDatabase. Workload at: " << path_workload
                    << ", Tuning records at: " << path_tuning_record;
-      database = meta_schedule::Database::JSONDatabase(path_workload, path_tuning_record, true);
+      database = meta_schedule::Database::JSONDatabase(path_workload, path_tuning_record,
+                                                       /*allow_missing=*/true,
+                                                       /*concurrent=*/false);
     }
 
-    Map<GlobalVar, BaseFunc> result;
-    for (const auto& iter : mod->functions) {
-      GlobalVar gv = iter.first;
-      BaseFunc base_func = iter.second;
-      if (const auto* prim_func_node = base_func.as<tir::PrimFuncNode>()) {
-        tir::PrimFunc prim_func = GetRef<tir::PrimFunc>(prim_func_node);
-        // Global symbol has to be defined.
-        Optional<String> gsymbol = prim_func->GetAttr<String>(tvm::attr::kGlobalSymbol);
-        ICHECK(gsymbol.defined());
-
-        IRModule tir_mod = (*normalize_mod_func_)(prim_func);
-        if (Optional<tir::Schedule> sch = database->QuerySchedule(tir_mod, target, gv->name_hint)) {
-          IRModule new_mod = sch.value()->mod();
-          ICHECK_EQ(new_mod->functions.size(), 1);
-          BaseFunc new_base_func = (*new_mod->functions.begin()).second;
-          ICHECK(new_base_func->IsInstance<tir::PrimFuncNode>());
-          tir::PrimFunc new_prim_func = Downcast<tir::PrimFunc>(new_base_func);
-          // copy the original attrs
-          new_prim_func = WithAttrs(std::move(new_prim_func), {prim_func->attrs->dict});
-          result.Set(gv, new_prim_func);
-          continue;
-        } else {
-          LOG(WARNING) << "Tuning record is not found for primfunc: " << gsymbol.value();
-        }
-      }
-      result.Set(gv, base_func);
-    }
-    return IRModule(result,       // functions
-                    {},           // type_definitions
-                    {},           // import_set
-                    {},           // map
-                    mod->attrs);  // attrs);
+    return ApplyDatabase(mod, database, target, enable_fallback);
   };
   return CreateModulePass(pass_func, 0, "MetaScheduleApplyDatabase", {});
 }
 
 Pass MetaScheduleTuneIRMod(Map<String, runtime::NDArray> params, String work_dir,
-                           Integer max_trials_global) {
+                           Integer max_trials_global, FloatImm max_tuning_time,
+                           Integer convergence_window, FloatImm convergence_threshold) {
   Target target = Target::Current(false);
   runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func = [=](IRModule m,
                                                                             PassContext ctx) {
-    return MetaScheduleTuner(target, work_dir, max_trials_global, params).TuneIRMod(m, ctx);
+    return MetaScheduleTuner(target, work_dir, max_trials_global, params, max_tuning_time,
+                             convergence_window, convergence_threshold)
+        .TuneIRMod(m, ctx);
   };
   return CreateModulePass(/*pass function*/ pass_func, /*opt level*/ 0,
                           /*pass name*/ "MetaScheduleTuneIRModule",
@@ -167,10 +264,79 @@ Pass MetaScheduleTuneTIR(String work_dir, Integer max_trials_global) {
                                             /*traceable*/ true);
 }
 
+Pass MetaScheduleTune(String work_dir, Integer max_trials_global, Integer max_trials_per_task,
+                      Integer num_trials_per_iter, meta_schedule::Builder builder,
+                      meta_schedule::Runner runner, Optional<meta_schedule::CostModel> cost_model) {
+  using namespace tvm::meta_schedule;  // NOLINT(build/namespaces)
+  using TRandState = support::LinearCongruentialEngine::TRandState;
+  Target target = Target::Current(false);
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func = [=](IRModule mod,
+                                                                            PassContext ctx) {
+    static const runtime::PackedFunc* f_extract =
+        runtime::Registry::Get("relax.backend.MetaScheduleExtractTask");
+    ICHECK(f_extract) << "Task extraction function is not found.";
+    Array<ExtractedTask> extracted_tasks = (*f_extract)(mod, target);
+
+    TRandState rand_state = support::LinearCongruentialEngine::NormalizeSeed(-1);
+    int num_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    Array<TuneContext> tasks;
+    Array<FloatImm> task_weights;
+    for (const ExtractedTask& task : extracted_tasks) {
+      // Without a cost model, the evolutionary search has nothing to rank its population with.
+      SearchStrategy search_strategy =
+          cost_model.defined() ? SearchStrategy::EvolutionarySearch(/*population_size=*/512,
+                                                                    /*init_measured_ratio=*/0.2,
+                                                                    /*init_min_unmeasured=*/50,
+                                                                    /*genetic_num_iters=*/4,
+                                                                    /*genetic_mutate_prob=*/0.85,
+                                                                    /*genetic_max_fail_count=*/10,
+                                                                    /*eps_greedy=*/0.05)
+                               : SearchStrategy::ReplayTrace(/*max_fail_count=*/100);
+      tasks.push_back(TuneContext(/*mod=*/task->dispatched[0],
+                                  /*target=*/task->target,
+                                  /*space_generator=*/
+                                  SpaceGenerator::PostOrderApply(/*f_block_filter=*/nullptr,
+                                                                 /*sch_rules=*/NullOpt,
+                                                                 /*postprocs=*/NullOpt,
+                                                                 /*mutator_probs=*/NullOpt),
+                                  /*search_strategy=*/search_strategy,
+                                  /*task_name=*/task->task_name,
+                                  /*num_threads=*/num_threads,
+                                  /*rand_state=*/
+                                  support::LinearCongruentialEngine(&rand_state).ForkSeed(),
+                                  /*logger=*/nullptr));
+      task_weights.push_back(FloatImm(DataType::Float(64), task->weight));
+    }
+
+    Database database = Database::JSONDatabase(work_dir + "/database_workload.json",
+                                               work_dir + "/database_tuning_record.json",
+                                               /*allow_missing=*/true,
+                                               /*concurrent=*/false);
+    if (!tasks.empty()) {
+      TaskScheduler task_scheduler = TaskScheduler::GradientBased(
+          /*logger=*/nullptr, /*alpha=*/0.2, /*window_size=*/3,
+          /*seed=*/support::LinearCongruentialEngine(&rand_state).ForkSeed());
+      // `RemoveBuildArtifact` calls back into python, so clearing the artifacts is left to the
+      // builder.
+      task_scheduler->Tune(tasks, task_weights, max_trials_global.IntValue(),
+                           max_trials_per_task.IntValue(), num_trials_per_iter.IntValue(), builder,
+                           runner,
+                           /*measure_callbacks=*/
+                           {MeasureCallback::AddToDatabase(), MeasureCallback::UpdateCostModel()},
+                           database, cost_model);
+    }
+    return ApplyDatabase(mod, database, target);
+  };
+  return CreateModulePass(/*pass function*/ pass_func, /*opt level*/ 0,
+                          /*pass name*/ "MetaScheduleTune",
+                          /*required*/ {});
+}
+
 TVM_REGISTER_GLOBAL("relax.transform.MetaScheduleApplyDatabase")
     .set_body_typed(MetaScheduleApplyDatabase);
 TVM_REGISTER_GLOBAL("relax.transform.MetaScheduleTuneIRMod").set_body_typed(MetaScheduleTuneIRMod);
 TVM_REGISTER_GLOBAL("relax.transform.MetaScheduleTuneTIR").set_body_typed(MetaScheduleTuneTIR);
+TVM_REGISTER_GLOBAL("relax.transform.MetaScheduleTune").set_body_typed(MetaScheduleTune);
 }  // namespace transform
 }  // namespace relax
 }  // namespace tvm
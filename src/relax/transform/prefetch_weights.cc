@@ -0,0 +1,212 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/transform/prefetch_weights.cc
+ * \brief Prefetch the weights of the next kernel to a fast memory scope while the current
+ * kernel runs.
+ *
+ * In each binding block, the weights read by a call_tir, i.e. its constant arguments, the
+ * results of relax.param_load and the parameters named as weights, are copied by a
+ * relax.prefetch started right before the previous call_tir of the block, and read through a
+ * relax.prefetch_wait right before the call:
+ *
+ * lv0 = call_tir(f, (x, w0), ...)
+ * lv1 = call_tir(g, (lv0, w1), ...)
+ * -->
+ * w1_pf = prefetch(w1, scope="global.vtcm")
+ * lv0 = call_tir(f, (x, w0), ...)
+ * w1_ready = prefetch_wait(w1_pf)
+ * lv1 = call_tir(g, (lv0, w1_ready), ...)
+ *
+ * On Hexagon the copy is a DMA to the VTCM that overlaps with f, see vm.builtin.prefetch.
+ */
+#include <tvm/relax/expr.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/op_attr_types.h>
+#include <tvm/relax/transform.h>
+#include <tvm/relax/type.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+class WeightPrefetcher : public ExprMutator {
+ public:
+  WeightPrefetcher(String scope, Array<String> weight_params, int64_t max_bytes)
+      : scope_(scope), max_bytes_(max_bytes) {
+    for (const String& name : weight_params) weight_params_.insert(name);
+  }
+
+  using ExprMutator::VisitExpr_;
+
+  Expr VisitExpr_(const FunctionNode* func) final {
+    for (const Var& param : func->params) {
+      if (weight_params_.count(param->name_hint())) params_.insert(param.get());
+    }
+    return ExprMutator::VisitExpr_(func);
+  }
+
+  BindingBlock VisitBindingBlock_(const BindingBlockNode* block) final {
+    builder_->BeginBindingBlock();
+    RewriteBindings(block->bindings);
+    return builder_->EndBlock();
+  }
+
+  BindingBlock VisitBindingBlock_(const DataflowBlockNode* block) final {
+    builder_->BeginDataflowBlock();
+    RewriteBindings(block->bindings);
+    return builder_->EndBlock();
+  }
+
+ private:
+  /*! \brief The call_tir bound by the binding, or nullptr. */
+  static const CallNode* KernelCall(const Binding& binding) {
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    const auto* var_binding = binding.as<VarBindingNode>();
+    if (var_binding == nullptr) return nullptr;
+    const auto* call = var_binding->value.as<CallNode>();
+    if (call == nullptr || call->op != call_tir_op || !call->args[1]->IsInstance<TupleNode>()) {
+      return nullptr;
+    }
+    return call;
+  }
+
+  /*! \brief The static size of the tensor in bytes, or -1 if not static. */
+  static int64_t StaticBytes(const Expr& tensor) {
+    const auto* type = tensor->checked_type_.as<DynTensorTypeNode>();
+    const auto* shape = tensor->shape_.as<ShapeExprNode>();
+    if (type == nullptr || type->IsUnknownDtype() || shape == nullptr) return -1;
+    int64_t bytes = (type->dtype.bits() * type->dtype.lanes() + 7) / 8;
+    for (const PrimExpr& dim : shape->values) {
+      const auto* imm = dim.as<IntImmNode>();
+      if (imm == nullptr) return -1;
+      bytes *= imm->value;
+    }
+    return bytes;
+  }
+
+  void RewriteBindings(const Array<Binding>& bindings) {
+    static const Op& param_load_op = Op::Get("relax.param_load");
+    // the weights defined in the block, by the position of their binding
+    std::unordered_map<const Object*, size_t> loaded_at;
+    std::vector<size_t> kernels;
+    for (size_t i = 0; i < bindings.size(); ++i) {
+      if (const auto* binding = bindings[i].as<VarBindingNode>()) {
+        const auto* call = binding->value.as<CallNode>();
+        if (call != nullptr && call->op == param_load_op) loaded_at[binding->var.get()] = i;
+      }
+      if (KernelCall(bindings[i]) != nullptr) kernels.push_back(i);
+    }
+
+    // the weights of each kernel but the first, prefetched during the previous kernel
+    std::unordered_map<size_t, std::vector<Expr>> prefetch_before;
+    std::unordered_map<size_t, std::vector<Expr>> wait_before;
+    for (size_t k = 1; k < kernels.size(); ++k) {
+      int64_t total = 0;
+      std::unordered_set<const Object*> seen;
+      for (const Expr& arg : Downcast<Tuple>(KernelCall(bindings[kernels[k]])->args[1])->fields) {
+        bool is_weight = arg->IsInstance<ConstantNode>() || params_.count(arg.get());
+        auto it = loaded_at.find(arg.get());
+        // a loaded weight is only prefetched if it is loaded before the previous kernel
+        if (it != loaded_at.end() && it->second < kernels[k - 1]) is_weight = true;
+        if (!is_weight || !seen.insert(arg.get()).second) continue;
+        int64_t bytes = StaticBytes(arg);
+        if (bytes < 0 || (max_bytes_ > 0 && total + bytes > max_bytes_)) continue;
+        total += bytes;
+        prefetch_before[kernels[k - 1]].push_back(arg);
+        wait_before[kernels[k]].push_back(arg);
+      }
+    }
+
+    // the prefetches of a kernel are waited for before the ones of the next kernel start, so
+    // that the wait does not cover the copies overlapping the kernel
+    std::unordered_map<size_t, std::unordered_map<const Object*, Var>> prefetched;
+    for (size_t i = 0; i < bindings.size(); ++i) {
+      std::unordered_map<const Object*, Var> ready;
+      for (const Expr& weight : wait_before[i]) {
+        ready[weight.get()] =
+            builder_->Emit(MakePrefetchWait(prefetched[i].at(weight.get())), "prefetched");
+      }
+      auto next = std::upper_bound(kernels.begin(), kernels.end(), i);
+      for (const Expr& weight : prefetch_before[i]) {
+        prefetched[*next][weight.get()] =
+            builder_->Emit(MakePrefetch(VisitExpr(weight)), "prefetch");
+      }
+      if (ready.empty()) {
+        VisitBinding(bindings[i]);
+        continue;
+      }
+      const CallNode* call = KernelCall(bindings[i]);
+      Array<Expr> fields;
+      for (const Expr& arg : Downcast<Tuple>(call->args[1])->fields) {
+        auto ready_it = ready.find(arg.get());
+        fields.push_back(ready_it == ready.end() ? arg : Expr(ready_it->second));
+      }
+      Array<Expr> args = call->args;
+      args.Set(1, Tuple(fields));
+      Call new_call(call->op, args, call->attrs, call->type_args, call->span);
+      VisitBinding(VarBinding(bindings[i].as<VarBindingNode>()->var, new_call));
+    }
+  }
+
+  Expr MakePrefetch(Expr data) {
+    static const Op& op = Op::Get("relax.prefetch");
+    auto attrs = make_object<PrefetchAttrs>();
+    attrs->scope = scope_;
+    return Call(op, {data}, Attrs(attrs), {});
+  }
+
+  static Expr MakePrefetchWait(Expr data) {
+    static const Op& op = Op::Get("relax.prefetch_wait");
+    return Call(op, {data}, {}, {});
+  }
+
+  /*! \brief The memory scope of the prefetched weights. */
+  String scope_;
+  /*! \brief The names of the function parameters that are weights. */
+  std::unordered_set<std::string> weight_params_;
+  /*! \brief The bytes prefetched for a kernel at most, 0 for no limit. */
+  int64_t max_bytes_;
+  /*! \brief The parameters of the function that are weights. */
+  std::unordered_set<const Object*> params_;
+};
+
+namespace transform {
+
+Pass PrefetchWeights(String scope, Array<String> weight_params, int64_t max_bytes) {
+  runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
+      [=](Function f, IRModule m, PassContext pc) {
+        return Downcast<Function>(WeightPrefetcher(scope, weight_params, max_bytes).VisitExpr(f));
+      };
+  return CreateFunctionPass(pass_func, 0, "PrefetchWeights", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.PrefetchWeights").set_body_typed(PrefetchWeights);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
@@ -0,0 +1,349 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/transform/quantize.cc
+ * \brief The passes of the quantization flow.
+ *
+ * A model is quantized by inserting quantize/dequantize (QDQ) pairs around the tensors to be
+ * computed in integers, with non-positive scales. Calibration runs the function returned by
+ * ExposeQuantizeInputs on sample inputs and sets the scales from the observed ranges with
+ * BindQuantizeParams. FoldQDQ then replaces each
+ *
+ *     y = quantize(matmul(dequantize(a), dequantize(w)))
+ *
+ * with an integer matmul of a and w.
+ */
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/op_attr_types.h>
+#include <tvm/relax/transform.h>
+#include <tvm/te/operation.h>
+
+#include <unordered_map>
+#include <vector>
+
+#include "../../te/operation/create_primfunc.h"
+#include "utils.h"
+
+namespace tvm {
+namespace relax {
+
+/*! \brief Get the attributes of a quantize or dequantize call which is yet to be calibrated. */
+const QuantizeAttrs* GetUncalibratedAttrs(const Call& call, const Op& op) {
+  if (!call->op.same_as(op)) return nullptr;
+  const auto* attrs = call->attrs.as<QuantizeAttrs>();
+  return attrs->scale > 0 ? nullptr : attrs;
+}
+
+class QuantizeInputExposer : public ExprMutator {
+ public:
+  Function Expose(const Function& func) {
+    auto updated = Downcast<Function>(VisitExpr(func));
+    Array<BindingBlock> blocks;
+    Array<Expr> fields;
+    if (const auto* seq = updated->body.as<SeqExprNode>()) {
+      blocks = seq->blocks;
+      fields.push_back(seq->body);
+    } else {
+      fields.push_back(updated->body);
+    }
+    fields.insert(fields.end(), exposed_.begin(), exposed_.end());
+    Expr body = builder_->Normalize(SeqExpr(blocks, Tuple(fields)));
+    return Function(updated->params, body, body->checked_type_, RuntimeDepShape(),
+                    updated->attrs);
+  }
+
+ private:
+  using ExprMutator::VisitExpr_;
+
+  Expr VisitExpr_(const CallNode* op) final {
+    static const Op& quantize_op = Op::Get("relax.quantize");
+    Call call = Downcast<Call>(ExprMutator::VisitExpr_(op));
+    if (GetUncalibratedAttrs(call, quantize_op) == nullptr) return std::move(call);
+    const Expr& input = call->args[0];
+    // A dataflow var is only visible in its block, so it is exposed through an output var.
+    exposed_.push_back(input->IsInstance<DataflowVarNode>() ? builder_->EmitOutput(input) : input);
+    return std::move(call);
+  }
+
+  /*! \brief The inputs of the uncalibrated quantize ops. */
+  Array<Expr> exposed_;
+};
+
+class QuantizeParamsBinder : public ExprMutator {
+ public:
+  explicit QuantizeParamsBinder(Array<FloatImm> scales, Array<Integer> zero_points)
+      : scales_(scales), zero_points_(zero_points) {
+    ICHECK_EQ(scales.size(), zero_points.size())
+        << "There should be as many zero points as scales";
+  }
+
+  Function Bind(const Function& func) {
+    auto updated = Downcast<Function>(VisitExpr(func));
+    if (index_ != scales_.size()) {
+      LOG(FATAL) << "ValueError: " << scales_.size() << " scales are given, but the function has "
+                 << index_ << " quantize ops to be calibrated";
+    }
+    return updated;
+  }
+
+ private:
+  using ExprMutator::VisitExpr_;
+
+  Expr VisitExpr_(const CallNode* op) final {
+    static const Op& quantize_op = Op::Get("relax.quantize");
+    static const Op& dequantize_op = Op::Get("relax.dequantize");
+    Call call = Downcast<Call>(ExprMutator::VisitExpr_(op));
+    const QuantizeAttrs* attrs = GetUncalibratedAttrs(call, quantize_op);
+    if (attrs != nullptr) {
+      ICHECK_LT(index_, scales_.size()) << "ValueError: Not enough scales are given";
+      auto new_attrs = make_object<QuantizeAttrs>(*attrs);
+      new_attrs->scale = scales_[index_]->value;
+      new_attrs->zero_point = zero_points_[index_]->value;
+      ++index_;
+      return Call(call->op, call->args, Attrs(new_attrs), call->type_args, call->span);
+    }
+    attrs = GetUncalibratedAttrs(call, dequantize_op);
+    if (attrs != nullptr) {
+      // The producer has been calibrated right above, as it is visited first.
+      Optional<Expr> producer;
+      if (const auto* var = call->args[0].as<VarNode>()) {
+        producer = LookupBinding(GetRef<Var>(var));
+      }
+      const auto* quantize = producer.defined() ? producer.value().as<CallNode>() : nullptr;
+      if (quantize == nullptr || !quantize->op.same_as(quantize_op)) {
+        LOG(FATAL) << "ValueError: The dequantize of " << call->args[0]
+                   << " has no scale and its input is not produced by a quantize op";
+      }
+      auto new_attrs = make_object<QuantizeAttrs>(*attrs);
+      new_attrs->scale = quantize->attrs.as<QuantizeAttrs>()->scale;
+      new_attrs->zero_point = quantize->attrs.as<QuantizeAttrs>()->zero_point;
+      return Call(call->op, call->args, Attrs(new_attrs), call->type_args, call->span);
+    }
+    return std::move(call);
+  }
+
+  /*! \brief The scales of the uncalibrated quantize ops. */
+  Array<FloatImm> scales_;
+  /*! \brief The zero points of the uncalibrated quantize ops. */
+  Array<Integer> zero_points_;
+  /*! \brief The number of uncalibrated quantize ops visited so far. */
+  size_t index_ = 0;
+};
+
+class QDQFolder : public ExprMutator {
+ public:
+  explicit QDQFolder(IRModule mod) : ExprMutator(mod), mod_(mod) {}
+
+  IRModule Transform() {
+    for (const auto& kv : mod_->functions) {
+      if (kv.second->IsInstance<relax::FunctionNode>()) {
+        folded_ = false;
+        auto func = Downcast<Function>(VisitExpr(kv.second));
+        // The dequantize ops and the float matmuls of the folded patterns are left unused.
+        builder_->UpdateFunction(kv.first, folded_ ? RemoveAllUnused(func) : func);
+      }
+    }
+    return builder_->GetContextIRModule();
+  }
+
+ private:
+  using ExprMutator::VisitExpr_;
+
+  Expr VisitExpr_(const CallNode* op) final {
+    static const Op& quantize_op = Op::Get("relax.quantize");
+    static const Op& dequantize_op = Op::Get("relax.dequantize");
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    Call call = Downcast<Call>(ExprMutator::VisitExpr_(op));
+    if (!call->op.same_as(quantize_op) || GetUncalibratedAttrs(call, quantize_op) != nullptr) {
+      return std::move(call);
+    }
+    Optional<Call> matmul = LookupCall(call->args[0]);
+    if (!matmul.defined() || !matmul.value()->op.same_as(call_tir_op)) return std::move(call);
+    const auto* gv = matmul.value()->args[0].as<GlobalVarNode>();
+    const auto* args = matmul.value()->args[1].as<TupleNode>();
+    if (gv == nullptr || args == nullptr || args->fields.size() != 2) return std::move(call);
+    const MatmulInfo* info = GetMatmulInfo(GetRef<GlobalVar>(gv));
+    if (info == nullptr) return std::move(call);
+
+    // The inputs of the matmul must be dequantized from integer tensors.
+    Array<Expr> inputs;
+    std::vector<const QuantizeAttrs*> input_attrs;
+    for (const Expr& arg : args->fields) {
+      Optional<Call> dequantize = LookupCall(arg);
+      if (!dequantize.defined() || !dequantize.value()->op.same_as(dequantize_op) ||
+          GetUncalibratedAttrs(dequantize.value(), dequantize_op) != nullptr) {
+        return std::move(call);
+      }
+      Expr input = dequantize.value()->args[0];
+      const auto* type = input->checked_type().as<DynTensorTypeNode>();
+      if (type == nullptr || !(type->dtype.is_int() || type->dtype.is_uint()) ||
+          type->dtype.bits() > 16) {
+        return std::move(call);
+      }
+      inputs.push_back(input);
+      input_attrs.push_back(dequantize.value()->attrs.as<QuantizeAttrs>());
+    }
+    folded_ = true;
+    return MakeIntegerMatmul(info, inputs, input_attrs, call->attrs.as<QuantizeAttrs>());
+  }
+
+  /*!
+   * \brief Create the call_tir to the integer matmul which computes the quantized output from
+   *  the quantized input and weight.
+   */
+  Call MakeIntegerMatmul(const MatmulInfo* info, const Array<Expr>& inputs,
+                         const std::vector<const QuantizeAttrs*>& input_attrs,
+                         const QuantizeAttrs* out_attrs) {
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    DataType acc_dtype = DataType::Int(32);
+    auto dtype_of = [](const Expr& expr) {
+      return Downcast<DynTensorType>(expr->checked_type())->dtype;
+    };
+    te::Tensor x = te::placeholder(info->input_shape, dtype_of(inputs[0]), "x");
+    te::Tensor w = te::placeholder(info->weight_shape, dtype_of(inputs[1]), "w");
+    PrimExpr x_zero_point = IntImm(acc_dtype, input_attrs[0]->zero_point);
+    PrimExpr w_zero_point = IntImm(acc_dtype, input_attrs[1]->zero_point);
+    bool transposed = info->weight_transposed;
+    Array<PrimExpr> out_shape(info->input_shape.begin(), info->input_shape.end() - 1);
+    out_shape.push_back(info->weight_shape[transposed ? 0 : 1]);
+
+    // acc = sum_k (x[..., k] - x_zero_point) * (w[k, j] - w_zero_point)
+    PrimExpr zero = IntImm(DataType::Int(64), 0);
+    tir::IterVar rk = te::reduce_axis(Range(zero, info->input_shape.back()), "k");
+    te::Tensor acc = te::compute(
+        out_shape,
+        [&](const Array<tir::Var>& i) {
+          Array<PrimExpr> x_indices(i.begin(), i.end() - 1);
+          x_indices.push_back(rk);
+          Array<PrimExpr> w_indices =
+              transposed ? Array<PrimExpr>{i.back(), rk} : Array<PrimExpr>{rk, i.back()};
+          return tvm::sum((tvm::cast(acc_dtype, x(x_indices)) - x_zero_point) *
+                              (tvm::cast(acc_dtype, w(w_indices)) - w_zero_point),
+                          {rk});
+        },
+        "T_matmul");
+
+    // y = clip(round(acc * x_scale * w_scale / y_scale) + y_zero_point)
+    DataType out_dtype = out_attrs->out_dtype;
+    DataType real_dtype = DataType::Float(32);
+    double multiplier = input_attrs[0]->scale * input_attrs[1]->scale / out_attrs->scale;
+    PrimExpr lower = tvm::cast(real_dtype, tvm::min_value(out_dtype));
+    PrimExpr upper = tvm::cast(real_dtype, tvm::max_value(out_dtype));
+    te::Tensor y = te::compute(
+        out_shape,
+        [&](const Array<tir::Var>& i) {
+          PrimExpr real = tvm::cast(real_dtype, acc(Array<PrimExpr>(i.begin(), i.end())));
+          PrimExpr quantized = tvm::round(real * FloatImm(real_dtype, multiplier)) +
+                               FloatImm(real_dtype, out_attrs->zero_point);
+          return tvm::cast(out_dtype, tvm::max(tvm::min(quantized, upper), lower));
+        },
+        "T_requantize");
+
+    tir::PrimFunc func = tir::CreatePrimFunc({x, w, y}, NullOpt);
+    if (annotate_op_pattern_) {
+      func = WithAttr(std::move(func), "op_pattern",
+                      Integer(static_cast<int>(AnalyzeOpPatternKind(func))));
+    }
+    GlobalVar gv = builder_->AddFunction(func, "quantized_matmul");
+    return Call(call_tir_op, {gv, Tuple(inputs), ShapeExpr(out_shape)}, Attrs(),
+                {DynTensorType(out_shape.size(), out_dtype)});
+  }
+
+  /*! \brief Get the call bound to a var. */
+  Optional<Call> LookupCall(const Expr& expr) {
+    const auto* var = expr.as<VarNode>();
+    if (var == nullptr) return NullOpt;
+    Optional<Expr> value = LookupBinding(GetRef<Var>(var));
+    if (!value.defined() || !value.value()->IsInstance<CallNode>()) return NullOpt;
+    return Downcast<Call>(value.value());
+  }
+
+  const MatmulInfo* GetMatmulInfo(const GlobalVar& gv) {
+    auto it = matmuls_.find(gv.get());
+    if (it == matmuls_.end()) {
+      std::unique_ptr<MatmulInfo> info;
+      if (auto* func = mod_->Lookup(gv).as<tir::PrimFuncNode>()) {
+        info = MatchMatmul(GetRef<tir::PrimFunc>(func));
+        if (info != nullptr && !info->dtype.is_float()) {
+          info = nullptr;
+        }
+        // Keep the integer matmuls annotated for FuseOps if the module already is.
+        if (info != nullptr && func->GetAttr<Integer>("op_pattern").defined()) {
+          annotate_op_pattern_ = true;
+        }
+      }
+      it = matmuls_.emplace(gv.get(), std::move(info)).first;
+    }
+    return it->second.get();
+  }
+
+  /*! \brief The IRModule containing the PrimFuncs. */
+  IRModule mod_;
+  /*! \brief The matmul information of each callee, nullptr if the callee is not a float matmul. */
+  std::unordered_map<const GlobalVarNode*, std::unique_ptr<MatmulInfo>> matmuls_;
+  /*! \brief Whether to annotate the op pattern of the created PrimFuncs. */
+  bool annotate_op_pattern_ = false;
+  /*! \brief Whether any pattern of the current function has been folded. */
+  bool folded_ = false;
+};
+
+namespace transform {
+
+Pass ExposeQuantizeInputs(String func_name) {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
+      [=](IRModule m, PassContext pc) {
+        IRModuleNode* new_module = m.CopyOnWrite();
+        GlobalVar gv = m->GetGlobalVar(func_name);
+        new_module->Update(gv, QuantizeInputExposer().Expose(Downcast<Function>(m->Lookup(gv))));
+        return GetRef<IRModule>(new_module);
+      };
+  return CreateModulePass(pass_func, 0, "ExposeQuantizeInputs", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.ExposeQuantizeInputs").set_body_typed(ExposeQuantizeInputs);
+
+Pass BindQuantizeParams(String func_name, Array<FloatImm> scales, Array<Integer> zero_points) {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
+      [=](IRModule m, PassContext pc) {
+        IRModuleNode* new_module = m.CopyOnWrite();
+        GlobalVar gv = m->GetGlobalVar(func_name);
+        QuantizeParamsBinder binder(scales, zero_points);
+        new_module->Update(gv, binder.Bind(Downcast<Function>(m->Lookup(gv))));
+        return GetRef<IRModule>(new_module);
+      };
+  return CreateModulePass(pass_func, 0, "BindQuantizeParams", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.BindQuantizeParams").set_body_typed(BindQuantizeParams);
+
+Pass FoldQDQ() {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
+      [=](IRModule m, PassContext pc) { return QDQFolder(m).Transform(); };
+  // The PrimFuncs of the integer matmuls are added to the module, so it is a module pass.
+  return CreateModulePass(pass_func, 0, "FoldQDQ", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.FoldQDQ").set_body_typed(FoldQDQ);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
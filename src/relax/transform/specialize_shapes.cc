@@ -0,0 +1,235 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+/*!
+ * \file src/relax/transform/specialize_shapes.cc
+ * \brief Specialize a Relax function, and the PrimFuncs it calls, to the concrete shapes of its
+ *        inputs.
+ */
+#include <tvm/arith/analyzer.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/transform.h>
+#include <tvm/tir/function.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+/*!
+ * \brief Get the static shape of a shape expression.
+ * \return The dimensions, or NullOpt if the expression is not a ShapeExpr of constants.
+ */
+Optional<Array<PrimExpr>> GetStaticShape(const Optional<ObjectRef>& shape) {
+  const auto* expr = shape.as<ShapeExprNode>();
+  if (expr == nullptr) return NullOpt;
+  for (const PrimExpr& dim : expr->values) {
+    if (!dim->IsInstance<IntImmNode>()) return NullOpt;
+  }
+  return expr->values;
+}
+
+class ShapeSpecializer : public ExprMutator {
+ public:
+  ShapeSpecializer(IRModule mod, Map<tir::Var, PrimExpr> bindings)
+      : ExprMutator(mod), mod_(mod), bindings_(std::move(bindings)) {}
+
+  IRModule Specialize(const GlobalVar& gv, const Function& func) {
+    builder_->UpdateFunction(gv, Downcast<Function>(VisitExpr(func)));
+    return builder_->GetContextIRModule();
+  }
+
+ private:
+  using ExprMutator::VisitExpr_;
+
+  Expr VisitExpr_(const ShapeExprNode* op) final {
+    bool changed = false;
+    Array<PrimExpr> values = op->values.Map([&](const PrimExpr& dim) {
+      PrimExpr value = analyzer_.Simplify(tir::Substitute(dim, bindings_));
+      changed |= !value.same_as(dim);
+      return value;
+    });
+    if (!changed) return GetRef<Expr>(op);
+    return ShapeExpr(values, op->span);
+  }
+
+  Expr VisitExpr_(const CallNode* op) final {
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    Call call = Downcast<Call>(ExprMutator::VisitExpr_(op));
+    if (!call->op.same_as(call_tir_op)) return std::move(call);
+    Optional<GlobalVar> callee = SpecializeCallee(call);
+    if (!callee.defined()) return std::move(call);
+    // the packed ints, if any, are the parameters bound by the specialization
+    return Call(call->op, {callee.value(), call->args[1], call->args[2]}, call->attrs,
+                call->type_args, call->span);
+  }
+
+  /*!
+   * \brief Specialize the PrimFunc called by a call_tir to the static shapes of its arguments.
+   * \return The specialized PrimFunc, NullOpt if the call is left generic.
+   */
+  Optional<GlobalVar> SpecializeCallee(const Call& call) {
+    const auto* gv = call->args[0].as<GlobalVarNode>();
+    const auto* args = call->args[1].as<TupleNode>();
+    if (gv == nullptr || args == nullptr) return NullOpt;
+    auto it = mod_->functions.find(GetRef<GlobalVar>(gv));
+    if (it == mod_->functions.end()) return NullOpt;
+    const auto* func = (*it).second.as<tir::PrimFuncNode>();
+    if (func == nullptr) return NullOpt;
+
+    // the static shapes of the inputs then of the outputs, followed by the packed ints
+    std::vector<Array<PrimExpr>> shapes;
+    for (const Expr& arg : args->fields) {
+      Optional<Array<PrimExpr>> shape = GetStaticShape(arg->shape_);
+      if (!shape.defined()) return NullOpt;
+      shapes.push_back(shape.value());
+    }
+    Array<Expr> outputs;
+    if (const auto* tuple = call->args[2].as<TupleNode>()) {
+      outputs = tuple->fields;
+    } else {
+      outputs = {call->args[2]};
+    }
+    for (const Expr& output : outputs) {
+      Optional<Array<PrimExpr>> shape = GetStaticShape(output);
+      if (!shape.defined()) return NullOpt;
+      shapes.push_back(shape.value());
+    }
+    Array<PrimExpr> ints;
+    if (call->args.size() == 4) {
+      Optional<Array<PrimExpr>> values = GetStaticShape(call->args[3]);
+      if (!values.defined()) return NullOpt;
+      ints = values.value();
+    }
+    if (func->params.size() != shapes.size() + ints.size()) return NullOpt;
+
+    std::ostringstream key;
+    key << gv->name_hint;
+    Map<tir::Var, ObjectRef> param_map;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+      auto buffer_it = func->buffer_map.find(func->params[i]);
+      if (buffer_it == func->buffer_map.end()) return NullOpt;
+      tir::Buffer buffer = (*buffer_it).second;
+      if (buffer->shape.size() != shapes[i].size()) return NullOpt;
+      bool symbolic = false;
+      Array<PrimExpr> shape;
+      for (size_t k = 0; k < shapes[i].size(); ++k) {
+        const PrimExpr& dim = buffer->shape[k];
+        int64_t value = Downcast<IntImm>(shapes[i][k])->value;
+        key << (k == 0 ? ":" : "x") << value;
+        if (dim->IsInstance<tir::VarNode>()) {
+          shape.push_back(tir::make_const(dim->dtype, value));
+          symbolic = true;
+        } else {
+          shape.push_back(dim);
+        }
+      }
+      if (!symbolic) continue;
+      auto n = make_object<tir::BufferNode>(*buffer.get());
+      n->shape = shape;
+      param_map.Set(func->params[i], tir::Buffer(n));
+    }
+    for (size_t i = 0; i < ints.size(); ++i) {
+      const tir::Var& param = func->params[shapes.size() + i];
+      int64_t value = Downcast<IntImm>(ints[i])->value;
+      key << ":" << value;
+      param_map.Set(param, tir::make_const(param->dtype, value));
+    }
+    if (param_map.empty()) return NullOpt;
+
+    auto cached = specialized_.find(key.str());
+    if (cached != specialized_.end()) return cached->second;
+    tir::PrimFunc specialized = tir::Specialize(GetRef<tir::PrimFunc>(func), param_map);
+    GlobalVar new_gv = builder_->AddFunction(specialized, gv->name_hint + "_specialized");
+    if (specialized->GetAttr<String>(tvm::attr::kGlobalSymbol).defined()) {
+      builder_->UpdateFunction(
+          new_gv, WithAttr(std::move(specialized), tvm::attr::kGlobalSymbol, new_gv->name_hint));
+    }
+    specialized_.emplace(key.str(), new_gv);
+    return new_gv;
+  }
+
+  /*! \brief The IRModule containing the PrimFuncs. */
+  IRModule mod_;
+  /*! \brief The values of the symbolic shape vars. */
+  Map<tir::Var, PrimExpr> bindings_;
+  /*! \brief The specialized PrimFuncs, keyed by the callee and its static shapes. */
+  std::unordered_map<std::string, GlobalVar> specialized_;
+  arith::Analyzer analyzer_;
+};
+
+IRModule SpecializeShapes(IRModule mod, const String& func_name,
+                          const Array<runtime::ShapeTuple>& shapes) {
+  GlobalVar gv = mod->GetGlobalVar(func_name);
+  auto func = Downcast<Function>(mod->Lookup(gv));
+  CHECK_EQ(func->params.size(), shapes.size())
+      << "ValueError: " << func_name << " takes " << func->params.size() << " parameters, but "
+      << shapes.size() << " shapes are given";
+
+  // bind the symbolic vars of the parameter shapes to the given dimensions
+  Map<tir::Var, PrimExpr> bindings;
+  for (size_t i = 0; i < shapes.size(); ++i) {
+    const auto* shape = func->params[i]->shape_.as<ShapeExprNode>();
+    if (shape == nullptr) continue;
+    CHECK_EQ(shape->values.size(), shapes[i].size())
+        << "ValueError: The parameter " << func->params[i]->name_hint() << " of " << func_name
+        << " has " << shape->values.size() << " dimensions, but the given shape is "
+        << shapes[i];
+    for (size_t k = 0; k < shapes[i].size(); ++k) {
+      const PrimExpr& dim = shape->values[k];
+      PrimExpr value = tir::make_const(dim->dtype, shapes[i][k]);
+      if (const auto* var = dim.as<tir::VarNode>()) {
+        Optional<PrimExpr> bound = bindings.Get(GetRef<tir::Var>(var));
+        CHECK(!bound.defined() || Downcast<IntImm>(bound.value())->value == shapes[i][k])
+            << "ValueError: The shape var " << var->name_hint << " of " << func_name
+            << " is bound to both " << bound.value() << " and " << shapes[i][k];
+        bindings.Set(GetRef<tir::Var>(var), value);
+      } else if (const auto* imm = dim.as<IntImmNode>()) {
+        CHECK_EQ(imm->value, shapes[i][k])
+            << "ValueError: The parameter " << func->params[i]->name_hint() << " of "
+            << func_name << " has the shape " << GetRef<Expr>(shape) << ", but the given shape is "
+            << shapes[i];
+      }
+    }
+  }
+  return ShapeSpecializer(mod, bindings).Specialize(gv, func);
+}
+
+namespace transform {
+
+Pass SpecializeShapes(String func_name, Array<runtime::ShapeTuple> shapes) {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
+      [=](IRModule m, PassContext pc) {
+        return relax::SpecializeShapes(std::move(m), func_name, shapes);
+      };
+  return CreateModulePass(pass_func, 0, "SpecializeShapes", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.SpecializeShapes").set_body_typed(SpecializeShapes);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
@@ -0,0 +1,387 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/transform/to_mixed_precision.cc
+ * \brief Compute the float32 operators of the DataflowBlocks in a lower precision.
+ *
+ * Whether an operator is converted depends on its TMixedPrecisionPolicy attribute, and for a
+ * call_tir on the "mixed_precision_policy" attribute of its PrimFunc, which defaults to
+ *
+ *  - always for the matmul-like PrimFuncs (kOutEWiseFusable),
+ *  - follow for the elementwise, broadcast and injective PrimFuncs,
+ *  - never for the others, including the reductions.
+ *
+ * A converted binding `y = f(x)` becomes
+ *
+ *     x_low = cast(x)
+ *     y_low = f_low(x_low)
+ *     y = cast(y_low)
+ *
+ * where the consumers computed in the lower precision use y_low directly. The casts of the
+ * converted values are shared by their consumers, and the unused ones are removed, so the casts
+ * are only left at the boundaries of the lower precision regions.
+ */
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/op_attr_types.h>
+#include <tvm/relax/transform.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/topi/elemwise.h>
+
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+#include "../../support/scalars.h"
+#include "../../te/operation/create_primfunc.h"
+
+namespace tvm {
+namespace relax {
+
+/*! \brief Rewrite the values of a PrimFunc from one data type into another. */
+class PrimFuncDtypeRewriter : public tir::StmtExprMutator {
+ public:
+  explicit PrimFuncDtypeRewriter(DataType from, DataType to) : from_(from), to_(to) {}
+
+  tir::PrimFunc Rewrite(tir::PrimFunc func) {
+    Map<tir::Var, tir::Buffer> buffer_map;
+    for (const auto& kv : func->buffer_map) {
+      buffer_map.Set(kv.first, GetBuffer(kv.second));
+    }
+    tir::PrimFuncNode* n = func.CopyOnWrite();
+    n->buffer_map = std::move(buffer_map);
+    n->body = VisitStmt(n->body);
+    return func;
+  }
+
+ private:
+  using tir::StmtExprMutator::VisitExpr_;
+  using tir::StmtExprMutator::VisitStmt_;
+
+  tir::Buffer GetBuffer(const tir::Buffer& buffer) {
+    if (buffer->dtype != from_) return buffer;
+    auto it = buffer_remap_.find(buffer.get());
+    if (it == buffer_remap_.end()) {
+      auto n = make_object<tir::BufferNode>(*buffer.get());
+      n->dtype = to_;
+      n->data = tir::Var(buffer->data->name_hint, PointerType(PrimType(to_), buffer.scope()));
+      it = buffer_remap_.emplace(buffer.get(), tir::Buffer(n)).first;
+    }
+    return it->second;
+  }
+
+  Array<tir::BufferRegion> GetRegions(const Array<tir::BufferRegion>& regions) {
+    return regions.Map([this](const tir::BufferRegion& region) {
+      return tir::BufferRegion(GetBuffer(region->buffer), region->region);
+    });
+  }
+
+  tir::Stmt VisitStmt_(const tir::BlockNode* op) final {
+    auto block = Downcast<tir::Block>(tir::StmtExprMutator::VisitStmt_(op));
+    tir::BlockNode* n = block.CopyOnWrite();
+    n->alloc_buffers = n->alloc_buffers.Map([this](const tir::Buffer& b) { return GetBuffer(b); });
+    n->reads = GetRegions(n->reads);
+    n->writes = GetRegions(n->writes);
+    n->match_buffers = n->match_buffers.Map([this](const tir::MatchBufferRegion& match) {
+      return tir::MatchBufferRegion(GetBuffer(match->buffer),
+                                    tir::BufferRegion(GetBuffer(match->source->buffer),
+                                                      match->source->region));
+    });
+    return std::move(block);
+  }
+
+  tir::Stmt VisitStmt_(const tir::BufferStoreNode* op) final {
+    auto store = Downcast<tir::BufferStore>(tir::StmtExprMutator::VisitStmt_(op));
+    return tir::BufferStore(GetBuffer(store->buffer), store->value, store->indices, store->span);
+  }
+
+  PrimExpr VisitExpr_(const tir::BufferLoadNode* op) final {
+    auto load = Downcast<tir::BufferLoad>(tir::StmtExprMutator::VisitExpr_(op));
+    return tir::BufferLoad(GetBuffer(load->buffer), load->indices, load->span);
+  }
+
+  PrimExpr VisitExpr_(const tir::VarNode* op) final {
+    if (op->dtype != from_) return GetRef<PrimExpr>(op);
+    auto it = var_remap_.find(op);
+    if (it == var_remap_.end()) {
+      it = var_remap_.emplace(op, tir::Var(op->name_hint, to_)).first;
+    }
+    return it->second;
+  }
+
+  PrimExpr VisitExpr_(const FloatImmNode* op) final {
+    if (op->dtype != from_) return GetRef<PrimExpr>(op);
+    // The limits of the original type, e.g. the init of a max reduction, saturate to infinity.
+    double value = op->value;
+    if (to_.is_float16() && std::abs(value) > support::kMaxFloat16) {
+      value = value > 0 ? std::numeric_limits<double>::infinity()
+                        : -std::numeric_limits<double>::infinity();
+    }
+    return FloatImm(to_, value, op->span);
+  }
+
+  PrimExpr VisitExpr_(const tir::CastNode* op) final {
+    PrimExpr value = VisitExpr(op->value);
+    return tir::Cast(op->dtype == from_ ? to_ : op->dtype, value, op->span);
+  }
+
+  PrimExpr VisitExpr_(const tir::CallNode* op) final {
+    auto call = Downcast<tir::Call>(tir::StmtExprMutator::VisitExpr_(op));
+    if (call->dtype != from_) return std::move(call);
+    return tir::Call(to_, call->op, call->args, call->span);
+  }
+
+  /*! \brief The data type to be rewritten. */
+  DataType from_;
+  /*! \brief The data type it is rewritten into. */
+  DataType to_;
+  /*! \brief The rewritten buffers. */
+  std::unordered_map<const tir::BufferNode*, tir::Buffer> buffer_remap_;
+  /*! \brief The rewritten vars. */
+  std::unordered_map<const tir::VarNode*, tir::Var> var_remap_;
+};
+
+class MixedPrecisionRewriter : public ExprMutator {
+ public:
+  explicit MixedPrecisionRewriter(IRModule mod, DataType low_dtype)
+      : ExprMutator(mod),
+        mod_(mod),
+        low_dtype_(low_dtype),
+        suffix_("_" + runtime::DLDataType2String(low_dtype)) {}
+
+  IRModule Transform() {
+    for (const auto& kv : mod_->functions) {
+      if (kv.second->IsInstance<relax::FunctionNode>()) {
+        converted_ = false;
+        auto func = Downcast<Function>(VisitExpr(kv.second));
+        // The casts back to float32 of the values only used in the lower precision are unused.
+        builder_->UpdateFunction(kv.first, converted_ ? RemoveAllUnused(func) : func);
+      }
+    }
+    return builder_->GetContextIRModule();
+  }
+
+ private:
+  using ExprMutator::VisitBinding_;
+  using ExprMutator::VisitBindingBlock_;
+
+  BindingBlock VisitBindingBlock_(const DataflowBlockNode* block) final {
+    // The values in the lower precision are dataflow vars, only visible within their block.
+    low_.clear();
+    in_dataflow_ = true;
+    BindingBlock ret = ExprMutator::VisitBindingBlock_(block);
+    in_dataflow_ = false;
+    return ret;
+  }
+
+  void VisitBinding_(const VarBindingNode* binding) final {
+    Optional<Call> low_call;
+    if (in_dataflow_ && binding->value->IsInstance<CallNode>()) {
+      low_call = ConvertCall(Downcast<Call>(VisitExpr(binding->value)));
+    }
+    const auto* low_shape =
+        low_call.defined() ? low_call.value()->shape_.as<ShapeExprNode>() : nullptr;
+    if (low_shape == nullptr) {
+      ExprMutator::VisitBinding_(binding);
+      return;
+    }
+    const Var& var = binding->var;
+    Var low_var = builder_->Emit(low_call.value(), std::string(var->name_hint()) + suffix_);
+    Expr value = MakeCast(low_var, low_shape->values, low_dtype_, float_dtype_);
+    Var new_var;
+    if (var->IsInstance<DataflowVarNode>()) {
+      new_var = builder_->Emit(value, var->name_hint());
+      var_remap_[var->vid] = new_var;
+    } else {
+      new_var = builder_->EmitOutput(VarBinding(VisitVarDef(var), builder_->Normalize(value)));
+    }
+    low_[new_var.get()] = low_var;
+    converted_ = true;
+  }
+
+  /*!
+   * \brief Create the call computing the given call in the lower precision.
+   * \return The converted call, or NullOpt if the call is kept in float32.
+   */
+  Optional<Call> ConvertCall(const Call& call) {
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    static const auto& policy_map = Op::GetAttrMap<TMixedPrecisionPolicy>("TMixedPrecisionPolicy");
+    bool is_call_tir = call->op.same_as(call_tir_op);
+    Array<Expr> args = call->args;
+    if (is_call_tir) {
+      const auto* tuple = call->args[1].as<TupleNode>();
+      if (tuple == nullptr) return NullOpt;
+      args = tuple->fields;
+    }
+
+    int policy = kMixedPrecisionNever;
+    Optional<tir::PrimFunc> func;
+    if (is_call_tir) {
+      func = GetConvertiblePrimFunc(call, args);
+      if (func.defined()) policy = GetPolicy(func.value());
+    } else if (const auto* op = call->op.as<OpNode>()) {
+      policy = policy_map.get(GetRef<Op>(op), Integer(kMixedPrecisionNever))->value;
+    }
+    if (policy == kMixedPrecisionNever) return NullOpt;
+
+    bool any_float = false;
+    bool any_low = false;
+    for (const Expr& arg : args) {
+      if (IsFloat(arg)) {
+        any_float = true;
+        any_low |= low_.count(arg.get()) > 0;
+      }
+    }
+    if (!any_float || (policy == kMixedPrecisionFollow && !any_low)) return NullOpt;
+
+    Array<Expr> low_args;
+    for (const Expr& arg : args) {
+      if (!IsFloat(arg)) {
+        low_args.push_back(arg);
+        continue;
+      }
+      Optional<Expr> low_arg = GetLowPrecision(arg);
+      if (!low_arg.defined()) return NullOpt;
+      low_args.push_back(low_arg.value());
+    }
+
+    if (!is_call_tir) {
+      auto low_call = Downcast<Call>(builder_->Normalize(
+          Call(call->op, low_args, call->attrs, call->type_args, call->span)));
+      const auto* type = low_call->checked_type().as<DynTensorTypeNode>();
+      if (type == nullptr || type->dtype != low_dtype_) return NullOpt;
+      return low_call;
+    }
+    GlobalVar gv = GetLowPrecisionPrimFunc(Downcast<GlobalVar>(call->args[0]), func.value());
+    const auto* out_type = call->type_args[0].as<DynTensorTypeNode>();
+    return Downcast<Call>(builder_->Normalize(
+        Call(call_tir_op, {gv, Tuple(low_args), call->args[2]}, call->attrs,
+             {DynTensorType(out_type->ndim, low_dtype_, out_type->span)}, call->span)));
+  }
+
+  /*!
+   * \brief Get the PrimFunc of a call_tir if it can be computed in the lower precision, i.e. if
+   *  it writes a single float32 output and its float32 buffers are those of float32 arguments.
+   */
+  Optional<tir::PrimFunc> GetConvertiblePrimFunc(const Call& call, const Array<Expr>& args) {
+    const auto* gv = call->args[0].as<GlobalVarNode>();
+    if (gv == nullptr || call->type_args.size() != 1) return NullOpt;
+    const auto* out_type = call->type_args[0].as<DynTensorTypeNode>();
+    if (out_type == nullptr || out_type->dtype != float_dtype_) return NullOpt;
+    const auto* func = mod_->Lookup(GetRef<GlobalVar>(gv)).as<tir::PrimFuncNode>();
+    if (func == nullptr || func->params.size() != args.size() + 1) return NullOpt;
+    for (size_t i = 0; i < func->params.size(); ++i) {
+      auto it = func->buffer_map.find(func->params[i]);
+      if (it == func->buffer_map.end()) return NullOpt;
+      bool is_float = i < args.size() ? IsFloat(args[i]) : true;
+      if (((*it).second->dtype == float_dtype_) != is_float) return NullOpt;
+    }
+    return GetRef<tir::PrimFunc>(func);
+  }
+
+  /*! \brief Get the mixed precision policy of a PrimFunc. */
+  int GetPolicy(const tir::PrimFunc& func) {
+    if (Optional<Integer> policy = func->GetAttr<Integer>("mixed_precision_policy")) {
+      return policy.value()->value;
+    }
+    Optional<Integer> pattern = func->GetAttr<Integer>("op_pattern");
+    int kind = pattern.defined() ? pattern.value()->value
+                                 : static_cast<int>(AnalyzeOpPatternKind(func));
+    if (kind == relay::kOutEWiseFusable) return kMixedPrecisionAlways;
+    if (kind <= relay::kInjective) return kMixedPrecisionFollow;
+    return kMixedPrecisionNever;
+  }
+
+  /*! \brief Get the copy of a PrimFunc computing in the lower precision. */
+  GlobalVar GetLowPrecisionPrimFunc(const GlobalVar& gv, const tir::PrimFunc& func) {
+    auto it = low_funcs_.find(gv.get());
+    if (it == low_funcs_.end()) {
+      tir::PrimFunc low_func = PrimFuncDtypeRewriter(float_dtype_, low_dtype_).Rewrite(func);
+      GlobalVar low_gv = builder_->AddFunction(low_func, std::string(gv->name_hint) + suffix_);
+      it = low_funcs_.emplace(gv.get(), low_gv).first;
+    }
+    return it->second;
+  }
+
+  /*! \brief Get the value of a float32 expression in the lower precision, casting if needed. */
+  Optional<Expr> GetLowPrecision(const Expr& expr) {
+    auto it = low_.find(expr.get());
+    if (it != low_.end()) return it->second;
+    const auto* shape = expr->shape_.as<ShapeExprNode>();
+    if (shape == nullptr) return NullOpt;
+    Var low_var = builder_->Emit(MakeCast(expr, shape->values, float_dtype_, low_dtype_));
+    low_[expr.get()] = low_var;
+    return low_var;
+  }
+
+  /*! \brief Create a call_tir casting a tensor to another data type. */
+  Call MakeCast(const Expr& value, const Array<PrimExpr>& shape, DataType from, DataType to) {
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    te::Tensor x = te::placeholder(shape, from, "x");
+    te::Tensor y = topi::cast(x, to);
+    tir::PrimFunc func = tir::CreatePrimFunc({x, y}, NullOpt);
+    func = WithAttr(std::move(func), "op_pattern", Integer(static_cast<int>(relay::kElemWise)));
+    GlobalVar gv = builder_->AddFunction(func, "cast");
+    return Call(call_tir_op, {gv, Tuple({value}), ShapeExpr(shape)}, Attrs(),
+                {DynTensorType(shape.size(), to)});
+  }
+
+  bool IsFloat(const Expr& expr) {
+    const auto* type = expr->checked_type_.as<DynTensorTypeNode>();
+    return type != nullptr && type->dtype == float_dtype_;
+  }
+
+  /*! \brief The IRModule containing the PrimFuncs. */
+  IRModule mod_;
+  /*! \brief The data type of the converted values. */
+  DataType low_dtype_;
+  /*! \brief The data type the values are converted from. */
+  DataType float_dtype_ = DataType::Float(32);
+  /*! \brief The suffix of the names of the converted vars and PrimFuncs. */
+  std::string suffix_;
+  /*! \brief The value in the lower precision of each float32 value of the current block. */
+  std::unordered_map<const Object*, Expr> low_;
+  /*! \brief The lower precision copy of each PrimFunc. */
+  std::unordered_map<const GlobalVarNode*, GlobalVar> low_funcs_;
+  /*! \brief Whether the bindings being visited are in a DataflowBlock. */
+  bool in_dataflow_ = false;
+  /*! \brief Whether any binding of the current function has been converted. */
+  bool converted_ = false;
+};
+
+namespace transform {
+
+Pass ToMixedPrecision(DataType out_dtype) {
+  if (!out_dtype.is_float16() && !out_dtype.is_bfloat16()) {
+    LOG(FATAL) << "ValueError: ToMixedPrecision only supports float16 and bfloat16, but got "
+               << out_dtype;
+  }
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
+      [=](IRModule m, PassContext pc) { return MixedPrecisionRewriter(m, out_dtype).Transform(); };
+  // The PrimFuncs in the lower precision are added to the module, so it is a module pass.
+  return CreateModulePass(pass_func, 0, "ToMixedPrecision", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.ToMixedPrecision").set_body_typed(ToMixedPrecision);
+
+}  // namespace transform
+
+}  // namespace relax
+}  // namespace tvm
@@ -23,6 +23,7 @@
  */
 #include <tvm/relax/tuning_api.h>
 
+#include <memory>
 #include <set>
 #include <thread>
 #include <unordered_map>
@@ -115,6 +116,11 @@ class JSONDatabaseNode : public DatabaseNode {
   String path_tuning_record;
   /*! \brief The path to the measurement table */
   String path_measurement_record;
+  /*!
+   * \brief Whether the tables are shared with other processes. If so, every access locks the
+   * tables and first loads the lines appended by the other processes.
+   */
+  bool concurrent;
   /*! \brief All the workloads in the database */
   std::unordered_map<meta_schedule::Workload, int, meta_schedule::WorkloadHash,
                      meta_schedule::WorkloadEqual>
@@ -125,14 +131,27 @@ class JSONDatabaseNode : public DatabaseNode {
 
   /*! \brief Measurement logs in the database */
   std::unordered_map<std::string, Array<FloatImm>> measurement_records_;
+  /*! \brief The number of lines in the workload table, i.e. the index of the next workload */
+  int num_workloads_ = 0;
+  /*! \brief The number of bytes of the workload table already loaded, in concurrent mode */
+  int64_t workload_offset_ = 0;
+  /*! \brief The number of bytes of the tuning record table already loaded, in concurrent mode */
+  int64_t tuning_record_offset_ = 0;
+  /*! \brief The number of bytes of the measurement table already loaded, in concurrent mode */
+  int64_t measurement_record_offset_ = 0;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     v->Visit("path_workload", &path_workload);
     v->Visit("path_tuning_record", &path_tuning_record);
     v->Visit("path_measurement_record", &path_measurement_record);
+    v->Visit("concurrent", &concurrent);
     // `workloads2idx_` is not visited
     // `tuning_records_` is not visited
     // `measurement_records_` is not visited
+    // `num_workloads_` is not visited
+    // `workload_offset_` is not visited
+    // `tuning_record_offset_` is not visited
+    // `measurement_record_offset_` is not visited
   }
 
   static constexpr const char* _type_key = "relax.tuning_api.JSONDatabase";
@@ -140,50 +159,57 @@ class JSONDatabaseNode : public DatabaseNode {
 
  public:
   bool HasWorkload(const IRModule& mod) {
+    std::unique_ptr<meta_schedule::FileLock> lock = this->Sync();
     return workloads2idx_.find(meta_schedule::Workload(mod, tvm::StructuralHash()(mod))) !=
            workloads2idx_.end();
   }
 
   bool HasMeasurementRecord(const meta_schedule::Workload& workload, const Target& target) {
+    std::unique_ptr<meta_schedule::FileLock> lock = this->Sync();
     int workload_idx = this->workloads2idx_.at(workload);
     std::string key = get_database_key(workload_idx, target);
     return measurement_records_.count(key) > 0;
   }
 
   bool HasTuningRecord(const meta_schedule::Workload& workload, const Target& target) {
+    std::unique_ptr<meta_schedule::FileLock> lock = this->Sync();
     int workload_idx = this->workloads2idx_.at(workload);
     std::string key = get_database_key(workload_idx, target);
     return tuning_records_.count(key) > 0;
   }
 
   meta_schedule::Workload CommitWorkload(const IRModule& mod) {
+    std::unique_ptr<meta_schedule::FileLock> lock = this->Sync();
     // Try to insert `mod` into `workloads_`
     decltype(this->workloads2idx_)::iterator it;
     bool inserted = false;
-    std::tie(it, inserted) =
-        this->workloads2idx_.emplace(meta_schedule::Workload(mod, tvm::StructuralHash()(mod)), -1);
+    std::tie(it, inserted) = this->workloads2idx_.emplace(
+        meta_schedule::Workload(mod, tvm::StructuralHash()(mod)), -1);
     meta_schedule::Workload workload = it->first;
     // If `mod` is new in `workloads2idx_`, append it to the workload file
     if (inserted) {
-      it->second = static_cast<int>(this->workloads2idx_.size()) - 1;
-      meta_schedule::JSONFileAppendLine(this->path_workload,
-                                        meta_schedule::JSONDumps(workload->AsJSON()));
+      it->second = num_workloads_++;
+      std::string line = meta_schedule::JSONDumps(workload->AsJSON());
+      meta_schedule::JSONFileAppendLine(this->path_workload, line);
+      this->workload_offset_ += line.size() + 1;
     }
     return it->first;
   }
 
   void CommitMeasurementRecord(const meta_schedule::Workload& workload, const Target& target,
                                const Array<FloatImm>& run_secs) {
+    std::unique_ptr<meta_schedule::FileLock> lock = this->Sync();
     int workload_idx = this->workloads2idx_.at(workload);
     std::string key = get_database_key(workload_idx, target);
 
     if (measurement_records_[key].size() == 0) {
       measurement_records_[key] = run_secs;
-      meta_schedule::JSONFileAppendLine(this->path_measurement_record,
-                                        meta_schedule::JSONDumps(Array<ObjectRef>{
-                                            Integer(workload_idx), target->Export(),
-                                            run_secs  //
-                                        }));
+      std::string line = meta_schedule::JSONDumps(Array<ObjectRef>{
+          Integer(workload_idx), target->Export(),
+          run_secs  //
+      });
+      meta_schedule::JSONFileAppendLine(this->path_measurement_record, line);
+      this->measurement_record_offset_ += line.size() + 1;
     } else {
       LOG(WARNING) << "Measurement record for " << key
                    << " already exists. Use the existing one instead.";
@@ -192,14 +218,16 @@ class JSONDatabaseNode : public DatabaseNode {
 
   void CommitTuningRecord(const meta_schedule::Workload& workload, const Target& target,
                           const TuningRecord& record) {
+    std::unique_ptr<meta_schedule::FileLock> lock = this->Sync();
     int workload_idx = this->workloads2idx_.at(workload);
     // There may exist multiple tuning records (with different traces) for a single key pair.
     std::string key = get_database_key(workload_idx, target);
     this->tuning_records_[key].insert(record);
 
-    meta_schedule::JSONFileAppendLine(
-        this->path_tuning_record, meta_schedule::JSONDumps(Array<ObjectRef>{
-                                      Integer(workload_idx), target->Export(), record->AsJSON()}));
+    std::string line = meta_schedule::JSONDumps(
+        Array<ObjectRef>{Integer(workload_idx), target->Export(), record->AsJSON()});
+    meta_schedule::JSONFileAppendLine(this->path_tuning_record, line);
+    this->tuning_record_offset_ += line.size() + 1;
   }
 
   Array<TuningRecord> GetTopK(const meta_schedule::Workload& workload, const Target& target,
@@ -208,6 +236,7 @@ class JSONDatabaseNode : public DatabaseNode {
     if (top_k == 0) {
       return {};
     }
+    std::unique_ptr<meta_schedule::FileLock> lock = this->Sync();
     Array<TuningRecord> results;
     results.reserve(top_k);
     int counter = 0;
@@ -225,15 +254,72 @@ class JSONDatabaseNode : public DatabaseNode {
 
   Array<FloatImm> GetMeasurementRecord(const meta_schedule::Workload& workload,
                                        const Target target) {
+    std::unique_ptr<meta_schedule::FileLock> lock = this->Sync();
     int workload_idx = this->workloads2idx_.at(workload);
     return this->measurement_records_[get_database_key(workload_idx, target)];
   }
+
+  /*!
+   * \brief In concurrent mode, lock the tables and load the lines appended to them since the last
+   * access, which are committed by the other processes.
+   * \return The lock, or nullptr if the database is not concurrent.
+   */
+  std::unique_ptr<meta_schedule::FileLock> Sync() {
+    if (!concurrent) {
+      return nullptr;
+    }
+    auto lock = std::make_unique<meta_schedule::FileLock>(path_tuning_record + ".lock");
+    for (const std::string& line :
+         meta_schedule::JSONFileReadNewLines(path_workload, &workload_offset_)) {
+      meta_schedule::Workload workload =
+          meta_schedule::Workload::FromJSON(meta_schedule::JSONLoads(line));
+      workloads2idx_.emplace(workload, num_workloads_++);
+    }
+    // Both the tuning record and the measurement tables have lines of [workload, target, value]
+    auto f_parse = [](const std::string& line) -> std::pair<std::string, ObjectRef> {
+      ObjectRef json_obj = meta_schedule::JSONLoads(line);
+      const ArrayNode* arr = json_obj.as<ArrayNode>();
+      CHECK(arr && arr->size() == 3) << "ValueError: Unable to parse the JSON object: " << line;
+      int workload_idx = Downcast<Integer>(arr->at(0)).IntValue();
+      Target target(Downcast<Map<String, ObjectRef>>(arr->at(1)));
+      return {get_database_key(workload_idx, target), arr->at(2)};
+    };
+    for (const std::string& line :
+         meta_schedule::JSONFileReadNewLines(path_tuning_record, &tuning_record_offset_)) {
+      auto [key, json_record] = f_parse(line);
+      tuning_records_[key].insert(TuningRecord::FromJSON(json_record));
+    }
+    for (const std::string& line : meta_schedule::JSONFileReadNewLines(
+             path_measurement_record, &measurement_record_offset_)) {
+      auto [key, json_run_secs] = f_parse(line);
+      measurement_records_[key] = meta_schedule::AsFloatArray(json_run_secs);
+    }
+    return lock;
+  }
 };
 
 Database Database::JSONDatabase(String path_workload, String path_tuning_record,
-                                String path_measurement_record, bool allow_missing) {
+                                String path_measurement_record, bool allow_missing,
+                                bool concurrent) {
   int num_threads = std::thread::hardware_concurrency();
   ObjectPtr<JSONDatabaseNode> n = make_object<JSONDatabaseNode>();
+  n->path_workload = path_workload;
+  n->path_tuning_record = path_tuning_record;
+  n->path_measurement_record = path_measurement_record;
+  n->concurrent = concurrent;
+  if (concurrent) {
+    // The tables are loaded under the lock on the first access
+    for (const String& path : {path_workload, path_tuning_record, path_measurement_record}) {
+      std::ifstream is(path);
+      if (!is.good()) {
+        CHECK(allow_missing) << "ValueError: File doesn't exist: " << path;
+        std::ofstream os(path, std::ofstream::app);
+        CHECK(os.good()) << "ValueError: Cannot create new file: " << path;
+      }
+    }
+    n->Sync();
+    return Database(n);
+  }
   // Load `n->workloads2idx_` from `path_workload`
   std::vector<meta_schedule::Workload> workloads;
   {
@@ -247,6 +333,7 @@ Database Database::JSONDatabase(String path_workload, String path_tuning_record,
       n->workloads2idx_.emplace(workload, i);
       workloads.push_back(workload);
     }
+    n->num_workloads_ = n_objs;
   }
   // Load `n->tuning_records_` from `path_tuning_record`
   {
@@ -311,9 +398,6 @@ Database Database::JSONDatabase(String path_workload, String path_tuning_record,
     }
   }
 
-  n->path_workload = path_workload;
-  n->path_tuning_record = path_tuning_record;
-  n->path_measurement_record = path_measurement_record;
   return Database(n);
 }
 
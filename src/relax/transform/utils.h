@@ -0,0 +1,106 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/transform/utils.h
+ * \brief Utilities shared by the relax transformation passes.
+ */
+#ifndef TVM_RELAX_TRANSFORM_UTILS_H_
+#define TVM_RELAX_TRANSFORM_UTILS_H_
+
+#include <tvm/relax/block_builder.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/tir/function.h>
+
+#include <memory>
+#include <string>
+
+namespace tvm {
+namespace relax {
+
+/*! \brief The matmul computed by a PrimFunc. */
+struct MatmulInfo {
+  /*! \brief Whether the weight is [N, K] (dense) rather than [K, N]. */
+  bool weight_transposed;
+  /*! \brief The shape of the input, [..., K]. */
+  Array<PrimExpr> input_shape;
+  /*! \brief The shape of the weight. */
+  Array<PrimExpr> weight_shape;
+  /*! \brief The data type of the input, the weight and the output. */
+  DataType dtype;
+};
+
+/*!
+ * \brief Match a PrimFunc computing `C[..., j] = sum_k A[..., k] * W[k, j]` (or `W[j, k]`) with
+ *  static shapes and a single data type.
+ * \param func The PrimFunc to be analyzed.
+ * \return The matmul information, or nullptr if the PrimFunc is not such a matmul.
+ */
+std::unique_ptr<MatmulInfo> MatchMatmul(const tir::PrimFunc& func);
+
+/*!
+ * \brief The base of the mutators creating the functions offloaded to an external codegen from
+ *  bindings of the caller, used by FuseOpsByPattern and MergeCompositeFunctions.
+ * \note A fresh creator is supposed to be used for each function.
+ */
+class OffloadedFunctionCreator : public ExprMutator {
+ protected:
+  /*!
+   * \brief Get the var a var of the caller is remapped to in the function. The vars not bound in
+   *  the function yet become its parameters.
+   * \param var The var of the caller.
+   * \param params The parameters of the function, appended with the new parameter.
+   * \param arguments The arguments to call the function on the caller side, appended with the
+   *  var when it becomes a parameter.
+   * \return The var in the function.
+   */
+  Var GetParam(const Var& var, Array<Var>* params, Array<Expr>* arguments);
+
+  /*! \brief Create a parameter with the name, type and shape of a var. */
+  static Var CreateParam(const Var& var);
+
+  /*! \brief Create a function returning the output of a block, normalized by the builder. */
+  Function CreateFunction(const Array<Var>& params, const BindingBlock& block, const Var& output,
+                          const Map<String, ObjectRef>& attrs);
+};
+
+/*! \brief Get the attributes of a function offloaded to a codegen, "Codegen" and "Primitive". */
+Map<String, ObjectRef> OffloadedFunctionAttrs(const String& codegen);
+
+/*! \brief Whether a function is a grouped one, or one offloaded to a codegen. */
+bool IsGroupedOrOffloaded(const FunctionNode* func);
+
+/*!
+ * \brief Add an offloaded function to the module of the builder, named by its global symbol, and
+ *  emit the call to it in place of the binding of a var.
+ * \param builder The builder emitting the block of the caller.
+ * \param func The offloaded function.
+ * \param name_hint The name hint of the function.
+ * \param args The arguments of the call.
+ * \param var The var bound to the replaced binding.
+ * \return The var bound to the call, which is an output of the block when var is not a dataflow
+ *  var.
+ */
+Var EmitOffloadedCall(const BlockBuilder& builder, const Function& func,
+                      const std::string& name_hint, const Array<Expr>& args, const Var& var);
+
+}  // namespace relax
+}  // namespace tvm
+
+#endif  // TVM_RELAX_TRANSFORM_UTILS_H_
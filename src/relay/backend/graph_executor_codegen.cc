@@ -33,6 +33,7 @@
 #include <tvm/tir/analysis.h>
 #include <tvm/tir/function.h>
 
+#include <algorithm>
 #include <list>
 #include <string>
 #include <vector>
@@ -310,6 +311,9 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
       storage_ids.push_back(v);
     }
     node->attrs_["storage_id"] = std::move(storage_ids);
+    std::vector<int64_t> storage_offsets(storage_info->storage_offsets_in_bytes);
+    storage_offsets.resize(storage_info->storage_ids.size(), 0);
+    node->attrs_["storage_offset"] = std::move(storage_offsets);
     // type
     std::vector<int64_t> device_types;
     for (const auto& virtual_device : storage_info->virtual_devices) {
@@ -402,7 +406,11 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
     StorageInfo rit = GetStorageInfo(rhs);
     int64_t lhs_storage_id = lit->storage_ids[0];
     int64_t rhs_storage_id = rit->storage_ids[0];
-    return lhs_storage_id == rhs_storage_id;
+    const std::vector<int64_t>& lhs_offsets = lit->storage_offsets_in_bytes;
+    const std::vector<int64_t>& rhs_offsets = rit->storage_offsets_in_bytes;
+    int64_t lhs_offset = lhs_offsets.empty() ? 0 : lhs_offsets[0];
+    int64_t rhs_offset = rhs_offsets.empty() ? 0 : rhs_offsets[0];
+    return lhs_storage_id == rhs_storage_id && lhs_offset == rhs_offset;
   }
 
   std::vector<GraphNodeRef> GraphAddCallNode(const CallNode* call_node, GraphAttrs attrs) {
@@ -544,6 +552,7 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
     size_t num_entry = 0;
     ShapeVector shapes;
     std::vector<size_t> storage_ids;
+    std::vector<size_t> storage_offsets;
     std::vector<std::string> storage_scopes;
     std::vector<size_t> device_types;
     std::vector<std::string> dltypes;
@@ -561,6 +570,12 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
       shapes.insert(shapes.end(), shape_vec.begin(), shape_vec.end());
       dltypes.insert(dltypes.end(), dtype_vec.begin(), dtype_vec.end());
       storage_ids.insert(storage_ids.end(), storage_id.begin(), storage_id.end());
+      if (node->attrs_.count("storage_offset")) {
+        const auto& offset = dmlc::get<std::vector<int64_t>>(node->attrs_["storage_offset"]);
+        storage_offsets.insert(storage_offsets.end(), offset.begin(), offset.end());
+      } else {
+        storage_offsets.resize(storage_offsets.size() + storage_id.size(), 0);
+      }
       storage_scopes.insert(storage_scopes.end(), storage_scope.begin(), storage_scope.end());
       if (node->attrs_.count("device_index")) {
         const auto& dev_types = dmlc::get<std::vector<int64_t>>(node->attrs_["device_index"]);
@@ -589,6 +604,12 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
     attrs["shape"].emplace_back(shapes);
     attrs["storage_id"].emplace_back(std::string("list_int"));
     attrs["storage_id"].emplace_back(storage_ids);
+    // The offsets are only written when the planner packed tensors into arenas.
+    if (std::any_of(storage_offsets.begin(), storage_offsets.end(),
+                    [](size_t offset) { return offset != 0; })) {
+      attrs["storage_offset"].emplace_back(std::string("list_int"));
+      attrs["storage_offset"].emplace_back(storage_offsets);
+    }
     if (device_types.size()) {
       attrs["device_index"].emplace_back(std::string("list_int"));
       attrs["device_index"].emplace_back(device_types);
@@ -22,6 +22,7 @@
  * \brief Memory index assignment pass for executing
  *   the program in the graph executor.
  */
+#include <tvm/node/structural_equal.h>
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/attrs/annotation.h>
 #include <tvm/relay/attrs/call.h>
@@ -29,8 +30,14 @@
 #include <tvm/relay/expr_functor.h>
 #include <tvm/relay/transform.h>
 #include <tvm/runtime/container/array.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/tir/op.h>
 
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
 #include "../../runtime/texture.h"
 #include "../../support/arena.h"
 #include "../op/annotation/annotation.h"
@@ -42,6 +49,9 @@
 namespace tvm {
 namespace relay {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.GraphPlanMemory.inplace", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.GraphPlanMemory.arena", Bool);
+
 using TargetsMap = Map<Integer, Target>;
 using Texture2DShape = runtime::Texture2DShape<int64_t>;
 constexpr auto Is2DStorage = runtime::IsTextureStorage;
@@ -62,6 +72,8 @@ struct StorageToken {
   VirtualDevice virtual_device = VirtualDevice::FullyUnconstrained();
   /*! \brief The storage id */
   int64_t storage_id{-1};
+  /*! \brief The offset in bytes within the storage, when the tokens are packed into arenas. */
+  int64_t storage_offset{0};
 
   bool is_valid() const { return !virtual_device->IsFullyUnconstrained(); }
 
@@ -71,7 +83,8 @@ struct StorageToken {
 
   std::string ToString() const {
     std::ostringstream os;
-    os << "{storage_id: " << storage_id << ", max_bytes: " << max_bytes
+    os << "{storage_id: " << storage_id << ", storage_offset: " << storage_offset
+       << ", max_bytes: " << max_bytes
        << ", ttype: " << PrettyPrint(ttype) << ", virtual_device: " << virtual_device << "}";
     return os.str();
   }
@@ -254,8 +267,15 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
   StaticMemoryPlan Plan(const Function& func) {
     VLOG_CONTEXT << "StorageAllocator";
     VLOG(1) << "planning:" << std::endl << PrettyPrint(func);
+    transform::PassContext pass_ctx = transform::PassContext::Current();
+    inplace_ = pass_ctx->GetConfig<Bool>("relay.GraphPlanMemory.inplace", Bool(false)).value();
+    bool use_arena = pass_ctx->GetConfig<Bool>("relay.GraphPlanMemory.arena", Bool(false)).value();
+    allocator_.set_use_arena(use_arena);
     prototype_ = StorageAllocaInit(&arena_).GetInitTokenMap(func);
     this->Run(func);
+    if (use_arena) {
+      PackArenas();
+    }
 
     // The value of smap contains two integer arrays where the first array
     // contains the planned storage ids and the second holds the device types.
@@ -270,6 +290,8 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
       virtual_devices.reserve(kv.second.size());
       std::vector<int64_t> sid_sizes_byte;
       sid_sizes_byte.reserve(kv.second.size());
+      std::vector<int64_t> sid_offsets_byte;
+      sid_offsets_byte.reserve(kv.second.size());
 
       for (StorageToken* tok : kv.second) {
         VLOG(1) << "token: " << tok->ToString();
@@ -280,9 +302,14 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
         storage_ids.push_back(tok->storage_id);
         virtual_devices.push_back(tok->virtual_device);
         sid_sizes_byte.push_back(allocator_.GetMemorySize(tok));
+        sid_offsets_byte.push_back(tok->storage_offset);
       }
-      auto storage_info = backend::StorageInfo(std::move(storage_ids), std::move(virtual_devices),
-                                               std::move(sid_sizes_byte));
+      if (!use_arena) {
+        sid_offsets_byte.clear();
+      }
+      auto storage_info =
+          backend::StorageInfo(std::move(storage_ids), std::move(virtual_devices),
+                               std::move(sid_sizes_byte), std::move(sid_offsets_byte));
       smap.Set(GetRef<Expr>(kv.first), storage_info);
     }
     // Either all or none of the nodes should be annotated.
@@ -308,7 +335,11 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
     for (StorageToken* tok : it->second) {
       ICHECK(tok->virtual_device == virtual_device);
       if (can_realloc) {
-        tokens.push_back(allocator_.Request(tok));
+        StorageToken* allocated_tok = allocator_.Request(tok);
+        if (allocator_.InArena(allocated_tok)) {
+          lifetimes_[allocated_tok] = {step_, std::numeric_limits<int>::max()};
+        }
+        tokens.push_back(allocated_tok);
       } else {
         // Allocate a new token,
         StorageToken* allocated_tok = allocator_.Alloc(tok);
@@ -337,6 +368,111 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
     token_map_[op] = {input_token};
   }
 
+  /*!
+   * \brief Find an input the elementwise \p call_node may overwrite with its output: one of the
+   * same type, on the same device, whose storage is only read by this call.
+   * \return The token of the input, nullptr if there is none.
+   */
+  StorageToken* FindInplaceInput(const CallNode* call_node, const CallLoweredProps& props) {
+    if (!inplace_ || !props.lowered_func.defined() || !IsElemwiseOnly(props)) {
+      return nullptr;
+    }
+    if (!call_node->checked_type()->IsInstance<TensorTypeNode>()) {
+      return nullptr;
+    }
+    auto it = prototype_.find(call_node);
+    ICHECK(it != prototype_.end());
+    ICHECK_EQ(it->second.size(), 1U);
+    StorageToken* prototype = it->second[0];
+    if (TokenAllocator::Is2DStorage(prototype)) {
+      return nullptr;
+    }
+    for (const Expr& arg : props.arguments) {
+      const std::vector<StorageToken*>& tokens = GetToken(arg);
+      if (tokens.size() != 1) continue;
+      StorageToken* tok = tokens[0];
+      // The parameters, constants and outputs of the function are never released, so their
+      // counters stay above the single read of this call.
+      if (tok->ref_counter != 1 || !tok->is_compatible(*prototype) ||
+          TokenAllocator::Is2DStorage(tok)) {
+        continue;
+      }
+      if (StructuralEqual()(arg->checked_type(), call_node->checked_type())) {
+        return tok;
+      }
+    }
+    return nullptr;
+  }
+
+  /*!
+   * \brief Pack the tokens of each device into one storage, at offsets where the tokens alive at
+   * the same time do not overlap. The largest tokens are placed first, each at the lowest offset
+   * that fits, as the greedy by size algorithm of USMP.
+   */
+  void PackArenas() {
+    std::vector<std::vector<StorageToken*>> arenas;
+    for (StorageToken* tok : allocator_.tokens()) {
+      if (!lifetimes_.count(tok)) continue;
+      auto it = std::find_if(arenas.begin(), arenas.end(), [tok](const auto& arena) {
+        return arena[0]->is_compatible(*tok);
+      });
+      if (it == arenas.end()) {
+        arenas.push_back({tok});
+      } else {
+        it->push_back(tok);
+      }
+    }
+    for (const std::vector<StorageToken*>& arena : arenas) {
+      std::vector<StorageToken*> by_size = arena;
+      std::stable_sort(by_size.begin(), by_size.end(), [](StorageToken* a, StorageToken* b) {
+        return a->max_bytes > b->max_bytes;
+      });
+      std::vector<StorageToken*> placed;
+      for (StorageToken* tok : by_size) {
+        const std::pair<int, int>& lifetime = lifetimes_.at(tok);
+        std::vector<std::pair<int64_t, int64_t>> conflicts;
+        for (StorageToken* other : placed) {
+          const std::pair<int, int>& other_lifetime = lifetimes_.at(other);
+          if (lifetime.first <= other_lifetime.second && other_lifetime.first <= lifetime.second) {
+            conflicts.emplace_back(other->storage_offset,
+                                   other->storage_offset + static_cast<int64_t>(other->max_bytes));
+          }
+        }
+        std::sort(conflicts.begin(), conflicts.end());
+        int64_t offset = 0;
+        for (const auto& conflict : conflicts) {
+          if (offset + static_cast<int64_t>(tok->max_bytes) <= conflict.first) break;
+          offset = std::max(offset, RoundUpToAlignment(conflict.second));
+        }
+        tok->storage_offset = offset;
+        placed.push_back(tok);
+      }
+    }
+    // Renumber the storages, one per arena, in the order of their first allocation.
+    std::unordered_map<const StorageToken*, int64_t> arena_ids;
+    int64_t storage_id = 0;
+    for (StorageToken* tok : allocator_.tokens()) {
+      if (!lifetimes_.count(tok)) {
+        tok->storage_id = storage_id++;
+        continue;
+      }
+      auto it = std::find_if(arenas.begin(), arenas.end(), [tok](const auto& arena) {
+        return arena[0]->is_compatible(*tok);
+      });
+      const StorageToken* head = (*it)[0];
+      if (!arena_ids.count(head)) {
+        arena_ids[head] = storage_id++;
+      }
+      tok->storage_id = arena_ids.at(head);
+    }
+  }
+
+  /*! \brief Round \p bytes up to the alignment of the allocations of the runtime. */
+  static int64_t RoundUpToAlignment(int64_t bytes) {
+    int64_t alignment = runtime::kAllocAlignment;
+    return (bytes + alignment - 1) / alignment * alignment;
+  }
+
   using StorageAllocaBaseVisitor::DeviceAwareVisitExpr_;
 
   // The call map
@@ -365,6 +501,9 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
     if (call_lowered_props.lowered_func.defined() && IsReshapeOnly(call_lowered_props)) {
       ICHECK_EQ(call_lowered_props.arguments.size(), 1U);
       ReuseInputToken(call_node, args[0]);
+    } else if (StorageToken* input_token = FindInplaceInput(call_node, call_lowered_props)) {
+      // the elementwise output overwrites its dying input.
+      ReuseInputToken(call_node, input_token);
     } else {
       // create token for the call node.
       CreateToken(call_node, true);
@@ -373,10 +512,21 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
     // check if there is orphaned output that can be released immediately.
     for (StorageToken* tok : token_map_.at(call_node)) {
       allocator_.CheckForRelease(tok);
+      RecordRelease(tok);
     }
     for (StorageToken* tok : args) {
       tok->ref_counter -= 1;
       allocator_.CheckForRelease(tok);
+      RecordRelease(tok);
+    }
+    ++step_;
+  }
+
+  /*! \brief End the lifetime of \p tok at the current step if it was released. */
+  void RecordRelease(StorageToken* tok) {
+    auto it = lifetimes_.find(tok);
+    if (it != lifetimes_.end() && tok->ref_counter == 0) {
+      it->second.second = step_;
     }
   }
 
@@ -598,17 +748,34 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
   class TokenAllocator {
    public:
     StorageToken* Alloc(StorageToken* proto) {
+      tokens_.push_back(proto);
       return Is2DStorage(proto) ? token_2d_.Alloc(proto, storage_ids_++)
                                 : token_1d_.Alloc(proto, storage_ids_++);
     }
     StorageToken* Request(StorageToken* proto) {
+      // The tokens of the arenas are packed by their lifetimes once planned, rather than reused.
+      if (InArena(proto)) return this->Alloc(proto);
       StorageToken* token =
           Is2DStorage(proto) ? token_2d_.Request(proto) : token_1d_.Request(proto);
       return token ? token : this->Alloc(proto);
     }
     void CheckForRelease(StorageToken* tok) {
+      if (InArena(tok)) return;
       return Is2DStorage(tok) ? token_2d_.CheckForRelease(tok) : token_1d_.CheckForRelease(tok);
     }
+    /*!
+     * \brief Whether the requested tokens on the device of \p tok are packed into an arena. The
+     * offsets are folded into the data pointers by the runtime, so only the devices whose data
+     * are plain addresses have arenas.
+     */
+    bool InArena(StorageToken* tok) const {
+      if (!use_arena_ || Is2DStorage(tok)) return false;
+      DLDeviceType device_type = tok->virtual_device->device_type();
+      return device_type == kDLCPU || device_type == kDLCUDA;
+    }
+    void set_use_arena(bool use_arena) { use_arena_ = use_arena; }
+    /*! \return The allocated tokens, in the order of their allocation. */
+    const std::vector<StorageToken*>& tokens() const { return tokens_; }
 
     size_t GetMemorySize(StorageToken* tok) {
       // TODO(amalyshe): figure out who requries sizes and for what
@@ -623,6 +790,8 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
 
    private:
     int64_t storage_ids_{0};
+    bool use_arena_{false};
+    std::vector<StorageToken*> tokens_;
     TokenAllocator1D token_1d_;
     TokenAllocator2D token_2d_;
   };
@@ -640,6 +809,12 @@ class StorageAllocator : public StorageAllocaBaseVisitor {
   std::unordered_map<const ExprNode*, std::vector<StorageToken*>> prototype_;
   /*! \brief token allocator for optimizing 1d and 2d token alloc requests */
   TokenAllocator allocator_;
+  /*! \brief Whether the elementwise calls may overwrite their dying inputs. */
+  bool inplace_{false};
+  /*! \brief The index of the call being planned, which times the lifetimes of the tokens. */
+  int step_{0};
+  /*! \brief The first and last steps of the tokens packed into the arenas. */
+  std::unordered_map<const StorageToken*, std::pair<int, int>> lifetimes_;
 };
 
 StaticMemoryPlan GraphPlanMemory(const Function& func) { return StorageAllocator().Plan(func); }
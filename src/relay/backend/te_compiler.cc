@@ -93,6 +93,9 @@
 #include <tvm/ir/attrs.h>
 #include <tvm/ir/function.h>
 #include <tvm/ir/name_supply.h>
+#include <tvm/node/serialization.h>
+#include <tvm/node/structural_equal.h>
+#include <tvm/node/structural_hash.h>
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/attrs/annotation.h>
 #include <tvm/relay/attrs/call.h>
@@ -100,6 +103,7 @@
 #include <tvm/relay/expr.h>
 #include <tvm/relay/expr_functor.h>
 #include <tvm/relay/op.h>
+#include <tvm/relay/op_attr_types.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/te/schedule.h>
@@ -107,9 +111,16 @@
 #include <tvm/tir/transform.h>
 #include <tvm/topi/tags.h>
 
+#include <cstdio>
+#include <fstream>
 #include <functional>
+#include <iomanip>
+#include <iterator>
 #include <limits>
 #include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
 #include <tuple>
 #include <unordered_map>
 #include <utility>
@@ -118,6 +129,7 @@
 #include "../op/annotation/annotation.h"
 #include "../op/call/call.h"
 #include "../op/memory/device_copy.h"
+#include "../../support/utils.h"
 #include "../transforms/device_aware_visitors.h"
 #include "./te_compiler_cache.h"
 #include "./utils.h"
@@ -133,6 +145,96 @@ using namespace tvm::relay::transform;
 
 TVM_REGISTER_OBJECT_TYPE(TECompilerNode);
 
+/*!
+ * \brief Get the file caching the lowered kernel of a key across the compilations, keyed by
+ *  the structural hash of the primitive function, the target and the pass context.
+ * \return The path of the file, empty when "relay.backend.te_compiler_cache_dir" is not set, or
+ *  when the lowering depends on the tuning records or the custom passes which are not keyed.
+ */
+std::string LoweredKernelCachePath(const CCacheKey& key) {
+  PassContext ctx = PassContext::Current();
+  Optional<String> cache_dir = ctx->GetConfig<String>("relay.backend.te_compiler_cache_dir");
+  if (!cache_dir.defined() || cache_dir.value().empty()) return "";
+  if (backend::IsAutoSchedulerEnabled() || backend::IsMetaScheduleEnabled() ||
+      ctx->config.count("tir.add_lower_pass")) {
+    return "";
+  }
+  uint64_t hash = StructuralHash()(key->source_func);
+  hash = support::HashCombine(hash, StructuralHash()(String(key->target->str())));
+  hash = support::HashCombine(hash, StructuralHash()(key->virtual_device->memory_scope));
+  hash = support::HashCombine(hash, StructuralHash()(ctx->config));
+  hash = support::HashCombine(hash, ctx->opt_level);
+  std::ostringstream os;
+  os << cache_dir.value() << "/" << std::hex << std::setw(16) << std::setfill('0') << hash
+     << ".json";
+  return os.str();
+}
+
+/*!
+ * \brief Load the lowered kernel of a key cached by SaveLoweredKernel.
+ * \return The lowered kernel named by the global var supply, or null when the file is missing,
+ *  corrupted, or caches another function whose hash collides.
+ */
+CachedFunc LoadLoweredKernel(const std::string& path, const CCacheKey& key,
+                             GlobalVarSupply global_var_supply) {
+  std::ifstream is(path);
+  if (!is) return CachedFunc();
+  std::string json((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+  String name;
+  tir::PrimFunc prim_func;
+  try {
+    auto entry = Downcast<Array<ObjectRef>>(LoadJSON(json));
+    if (entry.size() != 4 || Downcast<String>(entry[1]) != key->target->str() ||
+        !StructuralEqual()(entry[0], key->source_func)) {
+      return CachedFunc();
+    }
+    name = Downcast<String>(entry[2]);
+    prim_func = Downcast<tir::PrimFunc>(entry[3]);
+  } catch (const Error& e) {
+    LOG(WARNING) << "Ignoring the corrupted lowered kernel cache " << path << ": " << e.what();
+    return CachedFunc();
+  }
+  VLOG(1) << "loaded the lowered kernel " << name << " from " << path;
+  GlobalVar prim_fn_var = global_var_supply->FreshGlobal(name);
+  prim_fn_var->checked_type_ = key->source_func->checked_type();
+  prim_func = WithAttr(std::move(prim_func), tvm::attr::kGlobalSymbol, prim_fn_var->name_hint);
+  IRModule funcs({}, {});
+  funcs->Add(prim_fn_var, prim_func);
+  return CachedFunc(key->target, prim_fn_var, {}, {}, te::Schedule{nullptr},
+                    tir::PrimFunc{nullptr}, {}, funcs);
+}
+
+/*!
+ * \brief Save the lowered kernel of a key for the later compilations, the kernels lowered to
+ *  several functions are not cached.
+ */
+void SaveLoweredKernel(const std::string& path, const CCacheKey& key, const CachedFunc& cfunc,
+                       const GlobalVarSupply& global_var_supply) {
+  if (cfunc->funcs->functions.size() != 1) return;
+  // cache the name before the module prefix, which the loading compilation adds back
+  std::string name = cfunc->prim_fn_var->name_hint;
+  std::string prefix = global_var_supply->name_supply_->prefix_;
+  if (!prefix.empty() && name.compare(0, prefix.size() + 1, prefix + "_") == 0) {
+    name = name.substr(prefix.size() + 1);
+  }
+  Array<ObjectRef> entry = {key->source_func, key->target->str(), String(name),
+                            cfunc->funcs->Lookup(cfunc->prim_fn_var)};
+  // write then rename, so that the concurrent compilations never read a partial file
+  std::string tmp_path = path + "." + std::to_string(std::random_device()()) + ".tmp";
+  {
+    std::ofstream os(tmp_path);
+    os << SaveJSON(entry);
+    if (!os) {
+      LOG(WARNING) << "Cannot write the lowered kernel cache " << tmp_path;
+      std::remove(tmp_path.c_str());
+      return;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+  }
+}
+
 class TECompilerImpl : public TECompilerNode {
  public:
   explicit TECompilerImpl(Optional<IRModule> opt_mod, Optional<String> opt_mod_name) {
@@ -392,6 +494,11 @@ class TECompilerImpl : public TECompilerNode {
     With<Target> target_scope(key->target);
 
     ICHECK(!value->cached_func.defined());
+    std::string kernel_cache_path = LoweredKernelCachePath(key);
+    if (!kernel_cache_path.empty()) {
+      value->cached_func = LoadLoweredKernel(kernel_cache_path, key, global_var_supply);
+      if (value->cached_func.defined()) return value;
+    }
     value->cached_func = PrimFuncFor(key->source_func, key->target, global_var_supply);
 
     if (value->cached_func->prim_func.defined()) {
@@ -461,6 +568,9 @@ class TECompilerImpl : public TECompilerNode {
       ICHECK(value->cached_func->funcs->Lookup(value->cached_func->prim_fn_var)
                  .as<tir::PrimFuncNode>());
     }
+    if (!kernel_cache_path.empty()) {
+      SaveLoweredKernel(kernel_cache_path, key, value->cached_func, global_var_supply);
+    }
     VLOG(1) << "lowered to name:" << std::endl
             << PrettyPrint(value->cached_func->prim_fn_var) << std::endl
             << "with definitions:" << std::endl
@@ -549,6 +659,7 @@ TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.use_auto_scheduler", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.use_meta_schedule", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.use_meta_schedule_dispatch", Integer);
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.tir_converter", String);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.te_compiler_cache_dir", String);
 
 TVM_REGISTER_GLOBAL("relay.backend._TECompilerGlobal").set_body_typed([]() {
   return TECompiler::Global();
@@ -584,6 +695,24 @@ TVM_REGISTER_GLOBAL("relay.backend._TECompilerListItems").set_body_typed([](TECo
 
 using AnalysisRemapping = std::unordered_map<Expr, Expr, ObjectHash, ObjectEqual>;
 
+/*!
+ * \brief Returns whether the primitive \p func only calls elementwise and broadcast operators, so
+ * that its output may be planned in place of an input of the same shape and type.
+ */
+bool IsElemwiseOnly(const Function& func) {
+  static auto fpattern = Op::GetAttrMap<TOpPattern>("TOpPattern");
+  bool elemwise_only = true;
+  PostOrderVisit(func->body, [&](const Expr& expr) {
+    if (const auto* call_node = expr.as<CallNode>()) {
+      const auto* op_node = call_node->op.as<OpNode>();
+      if (op_node == nullptr || fpattern.get(GetRef<Op>(op_node), kOpaque) > kBroadcast) {
+        elemwise_only = false;
+      }
+    }
+  });
+  return elemwise_only;
+}
+
 /*!
  * \brief Rewrites call expressions to Relay Functions marked as "primitive"
  * to calls to the corresponding TIR PrimFunc for the appropriate target.
@@ -745,6 +874,11 @@ class LowerTensorExprMutator : public DeviceAwareExprMutator {
     if (!opt_compiler && original_function->HasNonzeroAttr(attr::kReshapeOnly)) {
       call_lowered_attrs.metadata.Set(attr::kReshapeOnly, tvm::Integer(1));
     }
+    if (const auto* function_node = original_function.as<FunctionNode>()) {
+      if (!opt_compiler && IsElemwiseOnly(GetRef<Function>(function_node))) {
+        call_lowered_attrs.metadata.Set(attr::kElemwiseOnly, tvm::Integer(1));
+      }
+    }
 
     call_lowered_attrs.metadata.Set("relay_attrs", original_function->attrs);
     call_lowered_attrs.metadata.Set("all_prim_fn_vars", all_prim_fn_vars);
@@ -1031,8 +1165,12 @@ backend::FunctionInfo UpdateMainWorkspaceSize(const IRModule& mod, const Compila
         // that share the same storage id, because storage_id will
         // be shared between multiple tensors that are not live simultaneously.
         DLDeviceType device_type = virtual_devices[i]->device_type();
-        if (size_bytes > sid_workspace[device_type][storage_ids[i]]) {
-          sid_workspace[device_type][storage_ids[i]] = size_bytes;
+        // The tensors packed into one storage also extend it by their offsets.
+        int64_t end_bytes = size_bytes + (storage_info->storage_offsets_in_bytes.empty()
+                                              ? 0
+                                              : storage_info->storage_offsets_in_bytes[i]);
+        if (end_bytes > sid_workspace[device_type][storage_ids[i]]) {
+          sid_workspace[device_type][storage_ids[i]] = end_bytes;
         }
       }
     }
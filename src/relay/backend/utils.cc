@@ -54,18 +54,28 @@ TVM_STATIC_IR_FUNCTOR(ReprPrinter, vtable)
       for (auto bytes : node->storage_sizes_in_bytes) {
         p->stream << bytes << ",";
       }
+      if (!node->storage_offsets_in_bytes.empty()) {
+        p->stream << "], storage_offsets_in_bytes=[";
+        for (auto offset : node->storage_offsets_in_bytes) {
+          p->stream << offset << ",";
+        }
+      }
       p->stream << "])";
     });
 
 StorageInfo::StorageInfo(std::vector<int64_t> storage_ids,
                          std::vector<VirtualDevice> virtual_devices,
-                         std::vector<int64_t> storage_sizes_in_bytes) {
+                         std::vector<int64_t> storage_sizes_in_bytes,
+                         std::vector<int64_t> storage_offsets_in_bytes) {
   ICHECK_EQ(storage_ids.size(), virtual_devices.size());
   ICHECK_EQ(storage_ids.size(), storage_sizes_in_bytes.size());
+  ICHECK(storage_offsets_in_bytes.empty() ||
+         storage_ids.size() == storage_offsets_in_bytes.size());
   auto node = make_object<StorageInfoNode>();
   node->storage_ids = std::move(storage_ids);
   node->virtual_devices = std::move(virtual_devices);
   node->storage_sizes_in_bytes = std::move(storage_sizes_in_bytes);
+  node->storage_offsets_in_bytes = std::move(storage_offsets_in_bytes);
   data_ = std::move(node);
 }
 
@@ -117,6 +127,15 @@ TVM_REGISTER_GLOBAL("relay.ir.StorageInfoStorageSizes").set_body_typed([](Storag
   return storage_sizes_in_bytes;
 });
 
+TVM_REGISTER_GLOBAL("relay.ir.StorageInfoStorageOffsets").set_body_typed([](StorageInfo si) {
+  Array<tvm::Integer> storage_offsets_in_bytes;
+  for (size_t i = 0; i < si->storage_ids.size(); ++i) {
+    storage_offsets_in_bytes.push_back(
+        si->storage_offsets_in_bytes.empty() ? 0 : si->storage_offsets_in_bytes[i]);
+  }
+  return storage_offsets_in_bytes;
+});
+
 TVM_REGISTER_GLOBAL("relay.ir.StorageInfoVirtualDevices").set_body_typed([](StorageInfo si) {
   Array<VirtualDevice> virtual_devices;
   for (auto id : si->virtual_devices) {
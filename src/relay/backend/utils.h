@@ -210,6 +210,11 @@ class StorageInfoNode : public Object {
   std::vector<VirtualDevice> virtual_devices;
   /* \brief The sizes of each storage element, in bytes. */
   std::vector<int64_t> storage_sizes_in_bytes;
+  /*
+   * \brief The offsets of each storage element within its storage, in bytes. Empty when all the
+   * elements are at the start of their storages.
+   */
+  std::vector<int64_t> storage_offsets_in_bytes;
 
   // TODO(@jroesch): expose the fields
   void VisitAttrs(AttrVisitor* v) {}
@@ -222,7 +227,8 @@ class StorageInfoNode : public Object {
 class StorageInfo : public ObjectRef {
  public:
   StorageInfo(std::vector<int64_t> storage_ids, std::vector<VirtualDevice> virtual_devices,
-              std::vector<int64_t> storage_sizes_in_bytes);
+              std::vector<int64_t> storage_sizes_in_bytes,
+              std::vector<int64_t> storage_offsets_in_bytes = {});
   TVM_DEFINE_OBJECT_REF_METHODS(StorageInfo, ObjectRef, StorageInfoNode);
 };
 
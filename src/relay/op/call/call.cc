@@ -135,5 +135,12 @@ bool IsReshapeOnly(const CallLoweredProps& props) {
   return false;
 }
 
+bool IsElemwiseOnly(const CallLoweredProps& props) {
+  if (props.attrs.metadata.count(attr::kElemwiseOnly)) {
+    return Downcast<Integer>(props.attrs.metadata[attr::kElemwiseOnly])->value != 0;
+  }
+  return false;
+}
+
 }  // namespace relay
 }  // namespace tvm
@@ -192,6 +192,8 @@ void DeviceAPI::FreeWorkspace(Device dev, void* ptr) { FreeDataSpace(dev, ptr);
 
 TVMStreamHandle DeviceAPI::CreateStream(Device dev) { return nullptr; }
 
+TVMStreamHandle DeviceAPI::CreateCopyStream(Device dev) { return CreateStream(dev); }
+
 void DeviceAPI::FreeStream(Device dev, TVMStreamHandle stream) {}
 
 void DeviceAPI::SyncStreamFromTo(Device dev, TVMStreamHandle event_src, TVMStreamHandle event_dst) {
@@ -0,0 +1,115 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/contrib/amx/amx_config.cc
+ * \brief The configuration of the tiles of the x86 AMX extension, required before running the
+ *        kernels tensorized with the AMX intrinsics.
+ */
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/registry.h>
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__) && defined(__x86_64__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace tvm {
+namespace runtime {
+namespace amx {
+
+#if defined(__linux__) && defined(__x86_64__)
+/*! \brief The arch_prctl request of the permission to use an extended state component. */
+constexpr int kArchReqXcompPerm = 0x1023;
+/*! \brief The extended state component of the AMX tile data. */
+constexpr int kXFeatureXTileData = 18;
+#endif
+
+/*! \brief The number of the AMX tile registers. */
+constexpr int kNumTiles = 8;
+/*! \brief The maximum rows of a tile. */
+constexpr int kMaxRows = 16;
+/*! \brief The maximum bytes of a row of a tile. */
+constexpr int kMaxColsb = 64;
+
+/*!
+ * \brief Request the permission of the process to use the AMX tile data from the kernel, which
+ * Linux requires before the first tile instruction.
+ * \return Whether AMX can be used.
+ */
+bool InitAMX() {
+#if defined(__linux__) && defined(__x86_64__)
+  static bool enabled = syscall(SYS_arch_prctl, kArchReqXcompPerm, kXFeatureXTileData) == 0;
+  return enabled;
+#else
+  return false;
+#endif
+}
+
+/*!
+ * \brief Configure all the tiles of the calling thread with the same shape, in palette 1.
+ * \param rows The rows of each tile.
+ * \param colsb The bytes of each row of the tiles.
+ */
+void ConfigTiles(int rows, int colsb) {
+  CHECK(0 < rows && rows <= kMaxRows)
+      << "ValueError: The rows of an AMX tile must be in [1, " << kMaxRows << "], but gets "
+      << rows;
+  CHECK(0 < colsb && colsb <= kMaxColsb)
+      << "ValueError: The bytes of a row of an AMX tile must be in [1, " << kMaxColsb
+      << "], but gets " << colsb;
+  CHECK(InitAMX()) << "RuntimeError: AMX is not supported or not permitted on this machine";
+#if defined(__linux__) && defined(__x86_64__)
+  // The 64-byte layout read by ldtilecfg: the palette in byte 0, the 16-bit bytes per row of
+  // each tile from byte 16, and the 8-bit rows of each tile from byte 48.
+  alignas(64) uint8_t config[64];
+  std::memset(config, 0, sizeof(config));
+  config[0] = 1;
+  for (int i = 0; i < kNumTiles; ++i) {
+    uint16_t bytes = static_cast<uint16_t>(colsb);
+    std::memcpy(config + 16 + 2 * i, &bytes, sizeof(bytes));
+    config[48 + i] = static_cast<uint8_t>(rows);
+  }
+  // ldtilecfg (%rax), encoded so that the assembler needs no AMX support
+  asm volatile(".byte 0xc4, 0xe2, 0x78, 0x49, 0x00" : : "a"(config) : "memory");
+#endif
+}
+
+/*! \brief Release the tiles of the calling thread, returning them to the init state. */
+void ReleaseTiles() {
+#if defined(__linux__) && defined(__x86_64__)
+  if (InitAMX()) {
+    // tilerelease
+    asm volatile(".byte 0xc4, 0xe2, 0x78, 0x49, 0xc0" : : : "memory");
+  }
+#endif
+}
+
+TVM_REGISTER_GLOBAL("runtime.amx_init").set_body_typed(InitAMX);
+
+TVM_REGISTER_GLOBAL("runtime.amx_tileconfig").set_body_typed(ConfigTiles);
+
+TVM_REGISTER_GLOBAL("runtime.amx_tilerelease").set_body_typed(ReleaseTiles);
+
+}  // namespace amx
+}  // namespace runtime
+}  // namespace tvm
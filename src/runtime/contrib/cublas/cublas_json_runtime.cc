@@ -0,0 +1,260 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/contrib/cublas/cublas_json_runtime.cc
+ * \brief A simple JSON runtime running the matmuls offloaded by the Relax cuBLAS codegen with
+ * cuBLASLt, the bias and the activation being fused in the epilogue of each matmul.
+ *
+ * The matmul descriptors and the algorithm picked by the cuBLASLt heuristic are cached per
+ * problem shape, and all the matmuls share one workspace.
+ */
+
+#include <dmlc/parameter.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../../cuda/cuda_common.h"
+#include "../json/json_node.h"
+#include "../json/json_runtime.h"
+#include "cublas_utils.h"
+
+namespace tvm {
+namespace contrib {
+
+using namespace runtime;
+using namespace runtime::json;
+
+#if CUDART_VERSION >= 11040
+
+class CublasJSONRuntime : public JSONRuntimeBase {
+ public:
+  CublasJSONRuntime(const std::string& symbol_name, const std::string& graph_json,
+                    const Array<String> const_names)
+      : JSONRuntimeBase(symbol_name, graph_json, const_names) {}
+
+  ~CublasJSONRuntime() override {
+    for (auto& it : plans_) {
+      it.second.Destroy();
+    }
+    if (handle_ != nullptr) {
+      cublasLtDestroy(handle_);
+    }
+  }
+
+  const char* type_key() const override { return "cublas_json"; }
+
+  void Init(const Array<NDArray>& consts) override {
+    ICHECK_EQ(consts.size(), const_idx_.size())
+        << "The number of input constants must match the number of required.";
+    SetupConstants(consts);
+    for (const JSONGraphNodeEntry& output : outputs_) {
+      output_eids_.insert(EntryID(output));
+    }
+    workspace_size_ = dmlc::GetEnv("TVM_CUBLASLT_WORKSPACE_SIZE", size_t(32) << 20);
+    CHECK_CUBLAS_ERROR(cublasLtCreate(&handle_));
+  }
+
+  void Run() override {
+    auto stream = static_cast<cudaStream_t>(CUDAThreadEntry::ThreadLocal()->stream);
+    for (size_t nid = 0; nid < nodes_.size(); ++nid) {
+      const JSONGraphNode& node = nodes_[nid];
+      if (node.GetOpType() != "kernel") continue;
+      const std::vector<JSONGraphNodeEntry>& inputs = node.GetInputs();
+      ICHECK(inputs.size() == 2 || inputs.size() == 3)
+          << node.GetOpName() << ": expects the data, the weight and optionally the bias";
+      const DLTensor* data = data_entry_[EntryID(inputs[0])];
+      const DLTensor* weight = data_entry_[EntryID(inputs[1])];
+      const DLTensor* bias = inputs.size() == 3 ? data_entry_[EntryID(inputs[2])] : nullptr;
+      bool transpose_b = std::stoi(node.GetAttr<std::vector<std::string>>("transpose_b")[0]);
+      ICHECK_EQ(weight->ndim, 2);
+      int64_t k = data->shape[data->ndim - 1];
+      int64_t n = weight->shape[transpose_b ? 0 : 1];
+      int64_t m = 1;
+      for (int i = 0; i < data->ndim - 1; ++i) m *= data->shape[i];
+      ICHECK_EQ(weight->shape[transpose_b ? 1 : 0], k) << node.GetOpName() << ": shape mismatch";
+      const DLTensor* out = GetOrAllocateOutput(nid, data, n);
+
+      cublasLtEpilogue_t epilogue = GetEpilogue(node.GetOpName(), bias != nullptr);
+      const MatmulPlan& plan = GetOrCreatePlan(m, n, k, data->dtype, out->dtype, transpose_b,
+                                               epilogue);
+      if (bias != nullptr) {
+        ICHECK(bias->ndim == 1 && bias->shape[0] == n)
+            << node.GetOpName() << ": the bias is expected to be of shape [" << n << "]";
+        const void* bias_ptr = GetDataPtr(bias);
+        CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(
+            plan.desc, CUBLASLT_MATMUL_DESC_BIAS_POINTER, &bias_ptr, sizeof(bias_ptr)));
+      }
+      if (!workspace_.defined()) {
+        workspace_ = NDArray::Empty({static_cast<int64_t>(workspace_size_)}, DataType::UInt(8),
+                                    data->device);
+      }
+      // The scaling factors are of the compute type, float32 for all the supported dtypes.
+      float alpha = 1.0f;
+      float beta = 0.0f;
+      // In column major, the row major out = data * weight reads out^T = weight^T * data^T.
+      CHECK_CUBLAS_ERROR(cublasLtMatmul(handle_, plan.desc, &alpha, GetDataPtr(weight),
+                                        plan.a_desc, GetDataPtr(data), plan.b_desc, &beta,
+                                        GetDataPtr(out), plan.c_desc, GetDataPtr(out),
+                                        plan.c_desc, &plan.algo, workspace_->data,
+                                        workspace_size_, stream));
+    }
+  }
+
+ private:
+  /*! \brief The descriptors and the algorithm of the matmuls of one problem shape. */
+  struct MatmulPlan {
+    cublasLtMatmulDesc_t desc = nullptr;
+    cublasLtMatrixLayout_t a_desc = nullptr;
+    cublasLtMatrixLayout_t b_desc = nullptr;
+    cublasLtMatrixLayout_t c_desc = nullptr;
+    cublasLtMatmulAlgo_t algo;
+
+    void Destroy() {
+      if (desc) cublasLtMatmulDescDestroy(desc);
+      if (a_desc) cublasLtMatrixLayoutDestroy(a_desc);
+      if (b_desc) cublasLtMatrixLayoutDestroy(b_desc);
+      if (c_desc) cublasLtMatrixLayoutDestroy(c_desc);
+    }
+  };
+
+  static void* GetDataPtr(const DLTensor* tensor) {
+    return static_cast<char*>(tensor->data) + tensor->byte_offset;
+  }
+
+  /*! \brief Get the epilogue of a kernel from its pattern name, e.g. cublas.matmul_bias_relu. */
+  static cublasLtEpilogue_t GetEpilogue(const std::string& op_name, bool has_bias) {
+    auto ends_with = [&](const std::string& suffix) {
+      return op_name.size() >= suffix.size() &&
+             op_name.compare(op_name.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    ICHECK_EQ(op_name.rfind("cublas.matmul", 0), 0) << op_name << ": Unsupported operator";
+    if (ends_with("_relu")) {
+      return has_bias ? CUBLASLT_EPILOGUE_RELU_BIAS : CUBLASLT_EPILOGUE_RELU;
+    } else if (ends_with("_gelu")) {
+      return has_bias ? CUBLASLT_EPILOGUE_GELU_BIAS : CUBLASLT_EPILOGUE_GELU;
+    }
+    return has_bias ? CUBLASLT_EPILOGUE_BIAS : CUBLASLT_EPILOGUE_DEFAULT;
+  }
+
+  /*!
+   * \brief Get the plan of a matmul, creating the descriptors and querying the cuBLASLt
+   * heuristic on the first call of its shape.
+   */
+  const MatmulPlan& GetOrCreatePlan(int64_t m, int64_t n, int64_t k, DLDataType in_dtype,
+                                    DLDataType out_dtype, bool transpose_b,
+                                    cublasLtEpilogue_t epilogue) {
+    std::ostringstream os;
+    os << m << "_" << n << "_" << k << "_" << DLDataType2String(in_dtype) << "_"
+       << DLDataType2String(out_dtype) << "_" << transpose_b << "_" << epilogue;
+    std::string key = os.str();
+    auto it = plans_.find(key);
+    if (it != plans_.end()) return it->second;
+
+    ICHECK(TypeMatch(in_dtype, kDLFloat, 16) || TypeMatch(in_dtype, kDLFloat, 32))
+        << "cuBLASLt epilogues support float16 and float32 inputs, but got " << in_dtype;
+    ICHECK(TypeEqual(in_dtype, out_dtype) || TypeMatch(out_dtype, kDLFloat, 32))
+        << "Unsupported output type " << out_dtype << " for input type " << in_dtype;
+    cudaDataType_t in_type = GetCudaDataType(in_dtype);
+    cudaDataType_t out_type = GetCudaDataType(out_dtype);
+    MatmulPlan plan;
+    CHECK_CUBLAS_ERROR(cublasLtMatmulDescCreate(&plan.desc, CUBLAS_COMPUTE_32F, CUDA_R_32F));
+    cublasOperation_t op_a = transpose_b ? CUBLAS_OP_T : CUBLAS_OP_N;
+    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(plan.desc, CUBLASLT_MATMUL_DESC_TRANSA,
+                                                      &op_a, sizeof(op_a)));
+    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(plan.desc, CUBLASLT_MATMUL_DESC_EPILOGUE,
+                                                      &epilogue, sizeof(epilogue)));
+    // The weight of the column major problem is n x k, stored k x n when transposed.
+    CHECK_CUBLAS_ERROR(cublasLtMatrixLayoutCreate(&plan.a_desc, in_type, transpose_b ? k : n,
+                                                  transpose_b ? n : k, transpose_b ? k : n));
+    CHECK_CUBLAS_ERROR(cublasLtMatrixLayoutCreate(&plan.b_desc, in_type, k, m, k));
+    CHECK_CUBLAS_ERROR(cublasLtMatrixLayoutCreate(&plan.c_desc, out_type, n, m, n));
+
+    cublasLtMatmulPreference_t preference;
+    CHECK_CUBLAS_ERROR(cublasLtMatmulPreferenceCreate(&preference));
+    CHECK_CUBLAS_ERROR(cublasLtMatmulPreferenceSetAttribute(
+        preference, CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES, &workspace_size_,
+        sizeof(workspace_size_)));
+    cublasLtMatmulHeuristicResult_t result;
+    int num_results = 0;
+    CHECK_CUBLAS_ERROR(cublasLtMatmulAlgoGetHeuristic(handle_, plan.desc, plan.a_desc,
+                                                      plan.b_desc, plan.c_desc, plan.c_desc,
+                                                      preference, 1, &result, &num_results));
+    cublasLtMatmulPreferenceDestroy(preference);
+    if (num_results == 0) {
+      plan.Destroy();
+      LOG(FATAL) << "cuBLASLt finds no algorithm for the matmul " << key;
+    }
+    plan.algo = result.algo;
+    return plans_[key] = plan;
+  }
+
+  /*!
+   * \brief Get the output of a kernel, allocating it on the device of the input when it is an
+   * intermediate result of the function rather than one of its outputs.
+   */
+  const DLTensor* GetOrAllocateOutput(uint32_t nid, const DLTensor* data, int64_t n) {
+    uint32_t eid = EntryID(nid, 0);
+    if (output_eids_.count(eid)) return data_entry_[eid];
+    std::vector<int64_t> shape(data->shape, data->shape + data->ndim - 1);
+    shape.push_back(n);
+    NDArray& buffer = intermediates_[eid];
+    if (!buffer.defined() || buffer.Shape() != ShapeTuple(shape)) {
+      buffer = NDArray::Empty(shape, nodes_[nid].GetOpDataType()[0], data->device);
+    }
+    data_entry_[eid] = buffer.operator->();
+    return data_entry_[eid];
+  }
+
+  /*! \brief The cuBLASLt handle. */
+  cublasLtHandle_t handle_ = nullptr;
+  /*! \brief The plans of the matmuls, by problem shape, dtypes and epilogue. */
+  std::unordered_map<std::string, MatmulPlan> plans_;
+  /*! \brief The workspace shared by the matmuls, allocated on the first run. */
+  NDArray workspace_;
+  /*! \brief The size of the workspace, set by TVM_CUBLASLT_WORKSPACE_SIZE. */
+  size_t workspace_size_ = 0;
+  /*! \brief The entries of the outputs of the function, bound by the caller. */
+  std::unordered_set<uint32_t> output_eids_;
+  /*! \brief The buffers of the intermediate results, by entry. */
+  std::unordered_map<uint32_t, NDArray> intermediates_;
+};
+
+runtime::Module CublasJSONRuntimeCreate(String symbol_name, String graph_json,
+                                        const Array<String>& const_names) {
+  auto n = make_object<CublasJSONRuntime>(symbol_name, graph_json, const_names);
+  return runtime::Module(n);
+}
+
+TVM_REGISTER_GLOBAL("runtime.CublasJSONRuntimeCreate").set_body_typed(CublasJSONRuntimeCreate);
+
+TVM_REGISTER_GLOBAL("runtime.module.loadbinary_cublas_json")
+    .set_body_typed(JSONRuntimeBase::LoadFromBinary<CublasJSONRuntime>);
+
+#endif  // CUDART_VERSION >= 11040
+
+}  // namespace contrib
+}  // namespace tvm
@@ -64,6 +64,13 @@ void BackwardDataFindAlgo(int format, int dims, int groups, const int pad[], con
                           const int dilation[], const int dy_dim[], const int w_dim[],
                           const int dx_dim[], const std::string& data_dtype,
                           const std::string& conv_dtype, TVMRetValue* ret) {
+  std::string key = ConvAlgoKey("bwd_data", format, dims, groups, pad, stride, dilation,
+                                dy_dim, w_dim, dx_dim, data_dtype, conv_dtype);
+  int cached_algo;
+  if (CuDNNAlgoCache::Global()->Lookup(key, &cached_algo)) {
+    ret[0] = cached_algo;
+    return;
+  }
   CuDNNThreadEntry* entry_ptr = CuDNNThreadEntry::ThreadLocal();
   const int full_dims = dims + 2;
   std::vector<int64_t> dy_dim_int64(full_dims);
@@ -103,6 +110,7 @@ void BackwardDataFindAlgo(int format, int dims, int groups, const int pad[], con
               << ", Memory: " << perf_results[i].memory;
   }
 
+  CuDNNAlgoCache::Global()->Insert(key, best_algo);
   ret[0] = best_algo;
 }
 
@@ -140,6 +148,13 @@ void BackwardFilterFindAlgo(int format, int dims, int groups, const int pad[], c
                             const int dilation[], const int dy_dim[], const int x_dim[],
                             const int dw_dim[], const std::string& data_dtype,
                             const std::string& conv_dtype, TVMRetValue* ret) {
+  std::string key = ConvAlgoKey("bwd_filter", format, dims, groups, pad, stride, dilation,
+                                dy_dim, x_dim, dw_dim, data_dtype, conv_dtype);
+  int cached_algo;
+  if (CuDNNAlgoCache::Global()->Lookup(key, &cached_algo)) {
+    ret[0] = cached_algo;
+    return;
+  }
   CuDNNThreadEntry* entry_ptr = CuDNNThreadEntry::ThreadLocal();
   const int full_dims = dims + 2;
   std::vector<int64_t> x_dim_int64(full_dims);
@@ -180,6 +195,7 @@ void BackwardFilterFindAlgo(int format, int dims, int groups, const int pad[], c
               << ", Memory: " << perf_results[i].memory;
   }
 
+  CuDNNAlgoCache::Global()->Insert(key, best_algo);
   ret[0] = best_algo;
 }
 
@@ -23,10 +23,13 @@
 
 #include "cudnn_utils.h"
 
+#include <dmlc/parameter.h>
 #include <dmlc/thread_local.h>
 #include <tvm/runtime/data_type.h>
 #include <tvm/runtime/registry.h>
 
+#include <fstream>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -265,6 +268,67 @@ SoftmaxEntry::SoftmaxEntry() { CUDNN_CALL(cudnnCreateTensorDescriptor(&shape_des
 
 SoftmaxEntry::~SoftmaxEntry() { CUDNN_CALL(cudnnDestroyTensorDescriptor(shape_desc)); }
 
+// CuDNNAlgoCache
+
+CuDNNAlgoCache::CuDNNAlgoCache() : path_(dmlc::GetEnv("TVM_CUDNN_ALGO_CACHE", std::string())) {
+  if (path_.empty()) return;
+  // Each line reads "<key>\t<algo>", the last line of a key winning.
+  std::ifstream is(path_);
+  std::string line;
+  while (std::getline(is, line)) {
+    size_t pos = line.rfind('\t');
+    if (pos == std::string::npos) continue;
+    algos_[line.substr(0, pos)] = std::stoi(line.substr(pos + 1));
+  }
+}
+
+CuDNNAlgoCache* CuDNNAlgoCache::Global() {
+  static CuDNNAlgoCache* inst = new CuDNNAlgoCache();
+  return inst;
+}
+
+bool CuDNNAlgoCache::Lookup(const std::string& key, int* algo) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = algos_.find(key);
+  if (it == algos_.end()) return false;
+  *algo = it->second;
+  return true;
+}
+
+void CuDNNAlgoCache::Insert(const std::string& key, int algo) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  algos_[key] = algo;
+  if (path_.empty()) return;
+  std::ofstream os(path_, std::ios::app);
+  os << key << "\t" << algo << "\n";
+  if (!os.good()) LOG(WARNING) << "Failed to save the cuDNN algorithm to " << path_;
+}
+
+std::string ConvAlgoKey(const std::string& kind, int format, int dims, int groups, const int pad[],
+                        const int stride[], const int dilation[], const int a_dim[],
+                        const int b_dim[], const int c_dim[], const std::string& data_dtype,
+                        const std::string& conv_dtype) {
+  int device_id;
+  CUDA_CALL(cudaGetDevice(&device_id));
+  cudaDeviceProp prop;
+  CUDA_CALL(cudaGetDeviceProperties(&prop, device_id));
+  std::ostringstream os;
+  os << kind << ";gpu=" << prop.name << " sm" << prop.major << prop.minor
+     << ";cudnn=" << cudnnGetVersion() << ";format=" << format << ";groups=" << groups;
+  auto write = [&](const char* name, const int* values, int size) {
+    os << ";" << name << "=";
+    for (int i = 0; i < size; ++i) os << (i ? "," : "") << values[i];
+  };
+  write("pad", pad, dims);
+  write("stride", stride, dims);
+  write("dilation", dilation, dims);
+  write("a", a_dim, dims + 2);
+  write("b", b_dim, dims + 2);
+  write("c", c_dim, dims + 2);
+  os << ";dtype=" << data_dtype << ";conv_dtype=" << conv_dtype;
+  return os.str();
+}
+
 TVM_REGISTER_GLOBAL("tvm.contrib.cudnn.exists").set_body_typed([]() -> bool {
   return CuDNNThreadEntry::ThreadLocal(false)->exists();
 });
@@ -28,7 +28,9 @@
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/logging.h>
 
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 #include "../../cuda/cuda_common.h"
 
@@ -114,6 +116,45 @@ void SetConvDescriptors(CuDNNThreadEntry* entry_ptr, int format, int dims, int g
                         int64_t w_dim[], int64_t y_dim[], DLDataType data_dtype,
                         const std::string& conv_dtype);
 
+/*!
+ * \brief The algorithms chosen by the searches of cuDNN, by problem. When TVM_CUDNN_ALGO_CACHE
+ * names a file, they are persisted there, so that the later processes, e.g. the later builds of
+ * a model, do not run the searches of the same problems again.
+ */
+class CuDNNAlgoCache {
+ public:
+  static CuDNNAlgoCache* Global();
+
+  /*!
+   * \brief Look up the algorithm of a problem.
+   * \param key The key of the problem.
+   * \param algo Set to the algorithm, if found.
+   * \return Whether the algorithm was found.
+   */
+  bool Lookup(const std::string& key, int* algo);
+
+  /*! \brief Record the algorithm chosen for a problem, appending it to the file if any. */
+  void Insert(const std::string& key, int algo);
+
+ private:
+  CuDNNAlgoCache();
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, int> algos_;
+  /*! \brief The file of the cache, none if empty. */
+  std::string path_;
+};
+
+/*!
+ * \brief The key of the algorithm search of a convolution: the kind of search, the convolution,
+ * the dimensions of its three tensors, and the GPU with the version of cuDNN, on which the best
+ * algorithm depends as well.
+ */
+std::string ConvAlgoKey(const std::string& kind, int format, int dims, int groups, const int pad[],
+                        const int stride[], const int dilation[], const int a_dim[],
+                        const int b_dim[], const int c_dim[], const std::string& data_dtype,
+                        const std::string& conv_dtype);
+
 }  // namespace contrib
 }  // namespace tvm
 
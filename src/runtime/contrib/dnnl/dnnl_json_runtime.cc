@@ -26,6 +26,8 @@
 #include <tvm/runtime/registry.h>
 
 #include <cstddef>
+#include <memory>
+#include <mutex>
 #include <regex>
 #include <string>
 #include <vector>
@@ -73,29 +75,38 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
 
   /* Thread safe implementation of Run. Keep runtime instance immutable */
   void Run(const TVMArgs& args) const {
-    auto arg_data_provider = makeIODataProvider(args);
-    auto mem_solver = tensor_registry_.MakeSolver(arg_data_provider);
-    // Execute primitives one by one
-    for (const auto& act : net_) {
-      auto prim = std::get<0>(act);
-      auto arg_reqs = std::get<1>(act);
-
-      // Find proper dnnl::memory buffers
-      std::unordered_map<int, dnnl::memory> mem_args;
-      for (const auto& kvp : arg_reqs) mem_args[kvp.first] = mem_solver(kvp.second);
+    ExecutionContext ctx(tensor_registry_, net_, makeIODataProvider(args));
+    Execute(ctx);
+  }
 
-      // skip the reorder if src==dst to enable inplace operation
-      if (prim.get_kind() == dnnl::primitive::kind::reorder) {
-        const auto& mem_src = mem_args.at(DNNL_ARG_SRC);
-        const auto& mem_dst = mem_args.at(DNNL_ARG_DST);
-        if ((mem_src.get_desc() == mem_dst.get_desc()) &&
-            (mem_src.get_data_handle() == mem_dst.get_data_handle())) {
-          continue;
+  /*!
+   * Implementation of Run in bind-once mode. The memory objects of the previous run are kept,
+   * only rebinding the data of the moved inputs and outputs, until the shapes change.
+   */
+  void RunBound(const TVMArgs& args) {
+    std::lock_guard<std::mutex> guard(run_mutex_);
+    auto change = SetInputOutputBuffers(args);
+    if (!bound_ctx_ || change == BindingChange::kShape) {
+      auto provider = [this](uint32_t eid) -> const DLTensor* { return data_entry_[eid]; };
+      bound_ctx_ = std::make_unique<ExecutionContext>(tensor_registry_, net_, provider);
+      for (size_t i = 0; i < net_.size(); i++) {
+        for (const auto& kvp : std::get<1>(net_[i])) {
+          auto eid = tensor_registry_.ExtEid(kvp.second);
+          if (eid != TensorRequisite::kUndefinedTid) {
+            bound_ctx_->ext_mems[eid].push_back(bound_ctx_->mem_args[i].at(kvp.first));
+          }
+        }
+      }
+    } else if (change == BindingChange::kData) {
+      for (auto& kvp : bound_ctx_->ext_mems) {
+        void* data = data_entry_[kvp.first]->data;
+        ICHECK(data);
+        for (auto& mem : kvp.second) {
+          if (mem.get_data_handle() != data) mem.set_data_handle(data);
         }
       }
-
-      prim.execute(stream_, mem_args);
     }
+    Execute(*bound_ctx_);
   }
 
   /* Override GetFunction to reimplement Run method */
@@ -107,7 +118,11 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
         ICHECK_EQ(args.size(), input_var_eid_.size() + outputs_.size())
             << "Found mismatch in the number of provided data entries and required.";
 
-        Run(args);
+        if (bind_once_) {
+          RunBound(args);
+        } else {
+          Run(args);
+        }
       });
     } else {
       return JSONRuntimeBase::GetFunction(name, sptr_to_self);
@@ -133,6 +148,50 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
   }
 
  private:
+  /* The dnnl::memory arguments of all the primitives, resolved for a set of IO buffers */
+  struct ExecutionContext {
+    ExecutionContext(const TensorRegistry& registry, const TensorRegistry::ActionQue& net,
+                     const TensorRegistry::DLTensorProvider& provider)
+        : io_provider(provider), mem_solver(registry.MakeSolver(io_provider)) {
+      // Find proper dnnl::memory buffers
+      mem_args.resize(net.size());
+      for (size_t i = 0; i < net.size(); i++) {
+        for (const auto& kvp : std::get<1>(net[i])) mem_args[i][kvp.first] = mem_solver(kvp.second);
+      }
+    }
+    ExecutionContext(const ExecutionContext&) = delete;
+
+    /* Provider of the IO buffers, referred to by mem_solver */
+    TensorRegistry::DLTensorProvider io_provider;
+    /* Solver owning the intermediate memory objects */
+    TensorRegistry::MemSolver mem_solver;
+    /* The arguments of each action of net_ */
+    std::vector<std::unordered_map<int, dnnl::memory>> mem_args;
+    /* The memory objects wrapping each external eid, to rebind in bind-once mode */
+    std::unordered_map<uint32_t, std::vector<dnnl::memory>> ext_mems;
+  };
+
+  /* Execute the primitives of net_ with the memory objects of ctx */
+  void Execute(const ExecutionContext& ctx) const {
+    // Execute primitives one by one
+    for (size_t i = 0; i < net_.size(); i++) {
+      auto prim = std::get<0>(net_[i]);
+      const auto& mem_args = ctx.mem_args[i];
+
+      // skip the reorder if src==dst to enable inplace operation
+      if (prim.get_kind() == dnnl::primitive::kind::reorder) {
+        const auto& mem_src = mem_args.at(DNNL_ARG_SRC);
+        const auto& mem_dst = mem_args.at(DNNL_ARG_DST);
+        if ((mem_src.get_desc() == mem_dst.get_desc()) &&
+            (mem_src.get_data_handle() == mem_dst.get_data_handle())) {
+          continue;
+        }
+      }
+
+      prim.execute(stream_, mem_args);
+    }
+  }
+
   const std::map<std::string, dnnl::algorithm> elt_name2algo{
       {"abs", dnnl::algorithm::eltwise_abs},
       {"exp", dnnl::algorithm::eltwise_exp},
@@ -926,6 +985,10 @@ class DNNLJSONRuntime : public JSONRuntimeBase {
   uint32_t next_unique_eid_offset_;
   /* Map of Run arg idx to corresponding eid */
   std::vector<uint32_t> run_arg_eid_;
+  /* The execution context kept across the runs in bind-once mode */
+  std::unique_ptr<ExecutionContext> bound_ctx_;
+  /* Serializes the runs in bind-once mode, which share bound_ctx_ */
+  std::mutex run_mutex_;
 };
 
 runtime::Module DNNLJSONRuntimeCreate(String symbol_name, String graph_json,
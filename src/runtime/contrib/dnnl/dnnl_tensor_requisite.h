@@ -604,6 +604,16 @@ class TensorRegistry {
                          tmp_mem_collection_, tmp_mem_mapping_);
   }
 
+  /*!
+   * \brief Find the external buffer an ArgId refers to.
+   * \param ar the ArgId returned by Register()
+   * \return the eid of the input or output, or kUndefinedTid if ar is not an external buffer
+   */
+  uint32_t ExtEid(const ArgId& ar) const {
+    return ar.flag_ == EXT_EID ? ext_mem_collection_.at(ar.idx_).first
+                               : TensorRequisite::kUndefinedTid;
+  }
+
   void MarkInplace(const TensorRequisite& tr, const TensorRequisite& shared) {
     const auto tr_id = tr.eid();
     ICHECK(tr_id != TensorRequisite::kUndefinedTid);
@@ -25,9 +25,11 @@
 #ifndef TVM_RUNTIME_CONTRIB_JSON_JSON_RUNTIME_H_
 #define TVM_RUNTIME_CONTRIB_JSON_JSON_RUNTIME_H_
 
+#include <dmlc/parameter.h>
 #include <tvm/runtime/module.h>
 #include <tvm/runtime/ndarray.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <string>
 #include <tuple>
@@ -52,6 +54,7 @@ class JSONRuntimeBase : public ModuleNode {
                   const Array<String> const_names)
       : symbol_name_(symbol_name), graph_json_(graph_json), const_names_(const_names) {
     LoadGraph(graph_json_);
+    bind_once_ = dmlc::GetEnv("TVM_JSON_RUNTIME_BIND_ONCE", false);
   }
 
   ~JSONRuntimeBase() override = default;
@@ -64,6 +67,13 @@ class JSONRuntimeBase : public ModuleNode {
   /*! \brief Invoke the execution engine to inteprete a specific json runtime. */
   virtual void Run() = 0;
 
+  /*!
+   * \brief Whether Run only enqueues the work on the current stream of the device, returning
+   * before it completes. The callers then order the calls against each other with the streams,
+   * e.g. the Relax VM schedules them on its streams as the TIR kernels.
+   */
+  virtual bool IsStreamOrdered() const { return false; }
+
   /*!
    * \brief Get a packed function.
    * \param name The name/symbol of the function.
@@ -77,6 +87,9 @@ class JSONRuntimeBase : public ModuleNode {
     } else if (name == "get_const_vars") {
       return PackedFunc(
           [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->const_names_; });
+    } else if (name == "is_stream_ordered") {
+      return PackedFunc(
+          [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->IsStreamOrdered(); });
     } else if (this->symbol_name_ == name) {
       return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
         ICHECK(this->initialized_) << "The module has not been initialized";
@@ -143,15 +156,35 @@ class JSONRuntimeBase : public ModuleNode {
   std::string GetSource(const std::string& format = "json") override { return graph_json_; }
 
  protected:
+  /*! \brief How the input and output bindings of a run differ from those of the previous run. */
+  enum class BindingChange {
+    /*! \brief The same buffers of the same shapes are bound. */
+    kNone,
+    /*! \brief Some buffers moved, but all the shapes and dtypes are unchanged. */
+    kData,
+    /*! \brief Some shape or dtype changed, or there is no previous run to compare with. */
+    kShape,
+  };
+
   /*!
    * \brief Set up the input and output buffers by binding their DLTensor pointers to the
    * corresponding data entry.
    *
+   * The NDArrays are bound by reference, never copied. In bind-once mode, enabled by the
+   * TVM_JSON_RUNTIME_BIND_ONCE environment variable, the bindings are also compared with those
+   * of the previous run, so that a runtime can keep its execution context across the runs
+   * until the shapes change. Otherwise every run reports a kShape change.
+   *
    * \param args The packed args.
+   * \return The change of the bindings since the previous run.
    */
-  void SetInputOutputBuffers(const TVMArgs& args) {
+  BindingChange SetInputOutputBuffers(const TVMArgs& args) {
     ICHECK_EQ(args.size(), input_var_eid_.size() + outputs_.size())
         << "Found mismatch in the number of provided data entryies and required.";
+    BindingChange change = bind_once_ && bound_tensors_.size() == static_cast<size_t>(args.size())
+                               ? BindingChange::kNone
+                               : BindingChange::kShape;
+    bound_tensors_.resize(args.size());
 
     for (size_t i = 0; i < static_cast<size_t>(args.size()); i++) {
       auto eid = i < input_var_eid_.size() ? input_var_eid_[i]
@@ -170,7 +203,25 @@ class JSONRuntimeBase : public ModuleNode {
       // Assign input/output the NDArray pointers to data entry so that we can directly
       // read/write host buffers.
       data_entry_[eid] = arg;
+
+      if (bind_once_) {
+        BoundTensor& bound = bound_tensors_[i];
+        if (change != BindingChange::kShape &&
+            (bound.dtype != DataType(arg->dtype) ||
+             static_cast<int>(bound.shape.size()) != arg->ndim ||
+             !std::equal(bound.shape.begin(), bound.shape.end(), arg->shape))) {
+          change = BindingChange::kShape;
+        } else if (change == BindingChange::kNone &&
+                   (bound.data != arg->data || bound.byte_offset != arg->byte_offset)) {
+          change = BindingChange::kData;
+        }
+        bound.data = arg->data;
+        bound.byte_offset = arg->byte_offset;
+        bound.shape.assign(arg->shape, arg->shape + arg->ndim);
+        bound.dtype = DataType(arg->dtype);
+      }
     }
+    return change;
   }
 
   /*!
@@ -275,6 +326,17 @@ class JSONRuntimeBase : public ModuleNode {
   std::vector<uint32_t> const_idx_;
   /*! \brief Indicate if the engine has been initialized. */
   bool initialized_{false};
+  /*! \brief Whether the bindings are compared across runs, see SetInputOutputBuffers. */
+  bool bind_once_{false};
+  /*! \brief The input and output bound in the previous run, in bind-once mode. */
+  struct BoundTensor {
+    void* data{nullptr};
+    uint64_t byte_offset{0};
+    std::vector<int64_t> shape;
+    DataType dtype;
+  };
+  /*! \brief The bindings of the previous run, in the order of the packed args. */
+  std::vector<BoundTensor> bound_tensors_;
   /*! \brief Initializer mutex*/
   std::mutex initialize_mutex_;
 };
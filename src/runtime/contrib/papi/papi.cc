@@ -250,6 +250,18 @@ struct PAPIMetricCollectorNode final : public MetricCollectorNode {
             ObjectRef(make_object<CountNode>(end_values[i] - event_set_node->start_values[i]));
       }
     }
+    // Derive the instructions per cycle when both counters are measured.
+    auto GetCount = [&reported_metrics](const char* metric) -> int64_t {
+      auto it = reported_metrics.find(metric);
+      if (it == reported_metrics.end()) return -1;
+      return it->second.as<CountNode>()->value;
+    };
+    int64_t instructions = GetCount("perf::INSTRUCTIONS");
+    int64_t cycles = GetCount("perf::CYCLES");
+    if (instructions >= 0 && cycles > 0) {
+      reported_metrics["IPC"] =
+          ObjectRef(make_object<RatioNode>(static_cast<double>(instructions) / cycles));
+    }
     return reported_metrics;
   }
 
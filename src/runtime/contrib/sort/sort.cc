@@ -22,9 +22,14 @@
  */
 
 #include <dlpack/dlpack.h>
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/runtime/threading_backend.h>
 
 #include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "../../../../3rdparty/compiler-rt/builtin_fp16.h"
@@ -51,15 +56,89 @@ struct float16 {
   }
 };
 
+/*!
+ * \brief The type the elements of a dtype are compared as. The keys are decoded once per element
+ * when a row is loaded, rather than once per comparison.
+ */
+template <typename DataType>
+struct SortKey {
+  using Type = DataType;
+  static Type Get(DataType value) { return value; }
+};
+
 template <>
-bool CompareAscend(const std::pair<int64_t, float16>& lhs, const std::pair<int64_t, float16>& rhs) {
-  return lhs.second.to_float() < rhs.second.to_float();
+struct SortKey<float16> {
+  using Type = float;
+  static float Get(float16 value) { return value.to_float(); }
+};
+
+/*!
+ * \brief The strict weak order of the keys in which NaN is the greatest, so that the
+ * introsort-based selections of topk are well defined on any input.
+ */
+template <typename KeyType>
+inline bool KeyLess(KeyType lhs, KeyType rhs) {
+  if (std::is_floating_point<KeyType>::value) {
+    return lhs < rhs ||
+           (std::isnan(static_cast<double>(rhs)) && !std::isnan(static_cast<double>(lhs)));
+  }
+  return lhs < rhs;
 }
 
-template <>
-bool CompareDescend(const std::pair<int64_t, float16>& lhs,
-                    const std::pair<int64_t, float16>& rhs) {
-  return lhs.second.to_float() > rhs.second.to_float();
+/*! \brief The rows of a tensor sorted along an axis, the outer dims flattened. */
+struct SortRows {
+  SortRows(const DLTensor* input, int axis) : size(input->shape[axis]) {
+    for (int i = 0; i < input->ndim; ++i) {
+      if (i < axis) {
+        before *= input->shape[i];
+      } else if (i > axis) {
+        after *= input->shape[i];
+      }
+    }
+  }
+  /*! \brief The number of rows. */
+  int64_t Num() const { return before * after; }
+  /*! \brief The flat index of the first element of a row, the stride along the row being after. */
+  int64_t Base(int64_t row, int64_t row_size) const {
+    return (row / after) * row_size * after + row % after;
+  }
+
+  int64_t before = 1;
+  int64_t after = 1;
+  int64_t size;
+};
+
+/*! \brief The number of elements below which the rows are sorted on the calling thread. */
+constexpr int64_t kMinParallelSortElems = 1 << 14;
+
+/*!
+ * \brief Run fn(begin, end) over contiguous chunks of the rows [0, num_rows) on the runtime
+ * thread pool. The small problems run inline, as waking the pool would cost more.
+ */
+template <typename FRange>
+void ParallelForRows(int64_t num_rows, int64_t row_size, const FRange& fn) {
+  int num_tasks = static_cast<int>(
+      std::min<int64_t>(runtime::threading::MaxConcurrency(), num_rows));
+  if (num_tasks <= 1 || num_rows * row_size < kMinParallelSortElems) {
+    fn(0, num_rows);
+    return;
+  }
+  struct Task {
+    const FRange* fn;
+    int64_t num_rows;
+
+    static int Run(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+      const Task* task = static_cast<const Task*>(cdata);
+      int64_t chunk = (task->num_rows + penv->num_task - 1) / penv->num_task;
+      int64_t begin = std::min(task->num_rows, task_id * chunk);
+      int64_t end = std::min(task->num_rows, begin + chunk);
+      if (begin < end) (*task->fn)(begin, end);
+      return 0;
+    }
+  };
+  Task task{&fn, num_rows};
+  ICHECK_EQ(TVMBackendParallelLaunch(Task::Run, &task, num_tasks), 0)
+      << "TVMBackendParallelLaunch failed";
 }
 
 // Argsort implemented C library sort for nms.
@@ -79,9 +158,6 @@ TVM_REGISTER_GLOBAL("tvm.contrib.sort.argsort_nms").set_body([](TVMArgs args, TV
   auto dtype = input->dtype;
   auto data_ptr = static_cast<float*>(input->data);
   auto sort_num_ptr = static_cast<int32_t*>(sort_num->data);
-  std::vector<std::pair<int32_t, float>> sorter;
-  int64_t axis_mul_before = 1;
-  int64_t axis_mul_after = 1;
 
   if (axis < 0) {
     axis = input->ndim + axis;
@@ -98,19 +174,15 @@ TVM_REGISTER_GLOBAL("tvm.contrib.sort.argsort_nms").set_body([](TVMArgs args, TV
                                   "input ndim "
                                << input->ndim;
 
-  for (int i = 0; i < input->ndim; ++i) {
-    if (i < axis) {
-      axis_mul_before *= input->shape[i];
-    } else if (i > axis) {
-      axis_mul_after *= input->shape[i];
-    }
-  }
+  SortRows rows(input, axis);
+  int64_t axis_mul_after = rows.after;
 
-  for (int64_t i = 0; i < axis_mul_before; ++i) {
-    for (int64_t j = 0; j < axis_mul_after; ++j) {
+  ParallelForRows(rows.Num(), rows.size, [&](int64_t begin, int64_t end) {
+    std::vector<std::pair<int32_t, float>> sorter;
+    for (int64_t row = begin; row < end; ++row) {
       sorter.clear();
-      int32_t current_sort_num = *(sort_num_ptr + i * axis_mul_after + j);
-      int64_t base_idx = i * input->shape[axis] * axis_mul_after + j;
+      int32_t current_sort_num = sort_num_ptr[row];
+      int64_t base_idx = rows.Base(row, input->shape[axis]);
       for (int64_t k = 0; k < current_sort_num; ++k) {
         int64_t full_idx = base_idx + k * axis_mul_after;
         sorter.emplace_back(std::make_pair(k, *(data_ptr + full_idx)));
@@ -141,45 +213,41 @@ TVM_REGISTER_GLOBAL("tvm.contrib.sort.argsort_nms").set_body([](TVMArgs args, TV
             k < static_cast<int32_t>(sorter.size()) ? sorter[k].first : k;
       }
     }
-  }
+  });
 });
 
 template <typename DataType, typename OutType>
 void sort_impl(
     DLTensor* input, DLTensor* output, int32_t axis, bool is_ascend,
     std::function<void(OutType*, size_t, const std::pair<int64_t, DataType>&)> epilogue) {
+  using KeyType = typename SortKey<DataType>::Type;
   auto data_ptr = static_cast<DataType*>(input->data);
   auto out_ptr = static_cast<OutType*>(output->data);
-  std::vector<std::pair<int64_t, DataType>> sorter;
-
-  int axis_mul_before = 1;
-  int axis_mul_after = 1;
-  for (int i = 0; i < input->ndim; ++i) {
-    if (i < axis) {
-      axis_mul_before *= input->shape[i];
-    } else if (i > axis) {
-      axis_mul_after *= input->shape[i];
-    }
-  }
+  SortRows rows(input, axis);
+  int64_t axis_mul_after = rows.after;
 
-  for (int i = 0; i < axis_mul_before; ++i) {
-    for (int j = 0; j < axis_mul_after; ++j) {
+  ParallelForRows(rows.Num(), rows.size, [&](int64_t begin, int64_t end) {
+    std::vector<std::pair<int64_t, KeyType>> sorter;
+    sorter.reserve(rows.size);
+    for (int64_t row = begin; row < end; ++row) {
       sorter.clear();
-      int64_t base_idx = i * input->shape[axis] * axis_mul_after + j;
-      for (int64_t k = 0; k < input->shape[axis]; ++k) {
+      int64_t base_idx = rows.Base(row, rows.size);
+      for (int64_t k = 0; k < rows.size; ++k) {
         int64_t full_idx = base_idx + k * axis_mul_after;
-        sorter.emplace_back(std::make_pair(k, data_ptr[full_idx]));
+        sorter.emplace_back(k, SortKey<DataType>::Get(data_ptr[full_idx]));
       }
       if (is_ascend) {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<DataType>);
+        std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<KeyType>);
       } else {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<DataType>);
+        std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<KeyType>);
       }
-      for (int64_t k = 0; k < input->shape[axis]; ++k) {
-        epilogue(out_ptr, base_idx + k * axis_mul_after, sorter[k]);
+      for (int64_t k = 0; k < rows.size; ++k) {
+        int64_t src_idx = sorter[k].first;
+        epilogue(out_ptr, base_idx + k * axis_mul_after,
+                 std::make_pair(src_idx, data_ptr[base_idx + src_idx * axis_mul_after]));
       }
     }
-  }
+  });
 }
 
 template <typename DataType, typename OutType>
@@ -346,47 +414,52 @@ void topk(DLTensor* input, DLTensor* out_values, DLTensor* out_indices, int k, i
       (out_values == nullptr) ? nullptr : static_cast<DataType*>(out_values->data);
   IndicesType* indices_ptr =
       (out_indices == nullptr) ? nullptr : static_cast<IndicesType*>(out_indices->data);
-  std::vector<std::pair<int64_t, DataType>> sorter;
-
-  int axis_mul_before = 1;
-  int axis_mul_after = 1;
-  for (int i = 0; i < input->ndim; ++i) {
-    if (i < axis) {
-      axis_mul_before *= input->shape[i];
-    } else if (i > axis) {
-      axis_mul_after *= input->shape[i];
+  using KeyType = typename SortKey<DataType>::Type;
+  using KeyPair = std::pair<int64_t, KeyType>;
+
+  SortRows rows(input, axis);
+  int64_t axis_mul_after = rows.after;
+  int64_t out_size = k < 1 ? rows.size : k;
+  int64_t cnt = std::min(out_size, rows.size);
+  // The equal keys are ordered by their indices, so that the result is the one of a stable sort.
+  auto compare = [is_ascend](const KeyPair& lhs, const KeyPair& rhs) {
+    if (is_ascend ? KeyLess(lhs.second, rhs.second) : KeyLess(rhs.second, lhs.second)) {
+      return true;
     }
-  }
-  if (k < 1) {
-    k = input->shape[axis];
-  }
+    if (is_ascend ? KeyLess(rhs.second, lhs.second) : KeyLess(lhs.second, rhs.second)) {
+      return false;
+    }
+    return lhs.first < rhs.first;
+  };
 
-  for (int i = 0; i < axis_mul_before; ++i) {
-    for (int j = 0; j < axis_mul_after; ++j) {
+  ParallelForRows(rows.Num(), rows.size, [&](int64_t begin, int64_t end) {
+    std::vector<KeyPair> sorter;
+    sorter.reserve(rows.size);
+    for (int64_t row = begin; row < end; ++row) {
       sorter.clear();
-      int64_t src_base_idx = i * input->shape[axis] * axis_mul_after + j;
-      int64_t dst_base_idx = i * k * axis_mul_after + j;
-      for (int64_t kk = 0; kk < input->shape[axis]; ++kk) {
+      int64_t src_base_idx = rows.Base(row, rows.size);
+      int64_t dst_base_idx = rows.Base(row, out_size);
+      for (int64_t kk = 0; kk < rows.size; ++kk) {
         int64_t full_idx = src_base_idx + kk * axis_mul_after;
-        sorter.emplace_back(std::make_pair(kk, data_ptr[full_idx]));
+        sorter.emplace_back(kk, SortKey<DataType>::Get(data_ptr[full_idx]));
       }
-      if (is_ascend) {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareAscend<DataType>);
-      } else {
-        std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<DataType>);
+      // Only the top cnt elements are sorted, after selecting them in linear time.
+      if (cnt < rows.size) {
+        std::nth_element(sorter.begin(), sorter.begin() + cnt, sorter.end(), compare);
       }
-      int64_t cnt = k > 0 ? k : input->shape[axis];
+      std::sort(sorter.begin(), sorter.begin() + cnt, compare);
       for (int64_t kk = 0; kk < cnt; ++kk) {
+        int64_t src_idx = sorter[kk].first;
         if (indices_ptr != nullptr) {
-          indices_ptr[dst_base_idx + kk * axis_mul_after] =
-              static_cast<IndicesType>(sorter[kk].first);
+          indices_ptr[dst_base_idx + kk * axis_mul_after] = static_cast<IndicesType>(src_idx);
         }
         if (values_ptr != nullptr) {
-          values_ptr[dst_base_idx + kk * axis_mul_after] = static_cast<DataType>(sorter[kk].second);
+          values_ptr[dst_base_idx + kk * axis_mul_after] =
+              data_ptr[src_base_idx + src_idx * axis_mul_after];
         }
       }
     }
-  }
+  });
 }
 
 // Argsort implemented C library sort.
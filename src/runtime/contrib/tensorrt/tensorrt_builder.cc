@@ -152,7 +152,9 @@ void TensorRTBuilder::AddLayer(int nid, const JSONGraphNode& node) {
   }
 
   // Convert op to TRT.
+  int num_layers = network_->getNbLayers();
   converter.Convert(&params);
+  PinLayerPrecision(params.op_name, num_layers);
 
   // Get outputs.
   node_output_map_[nid] = {};
@@ -165,15 +167,50 @@ void TensorRTBuilder::AddLayer(int nid, const JSONGraphNode& node) {
   }
 }
 
+/*! \brief Whether an op is listed, by the name of its node with or without its prefix. */
+static bool IsListedOp(const std::string& op_name, const std::vector<std::string>& ops) {
+  for (const std::string& op : ops) {
+    if (op == op_name || "tensorrt." + op == op_name) return true;
+  }
+  return false;
+}
+
+void TensorRTBuilder::PinLayerPrecision(const std::string& op_name, int first_layer) {
+  nvinfer1::DataType precision;
+  if (IsListedOp(op_name, fp32_layers_)) {
+    precision = nvinfer1::DataType::kFLOAT;
+  } else if (IsListedOp(op_name, fp16_layers_)) {
+    precision = nvinfer1::DataType::kHALF;
+  } else {
+    return;
+  }
+  // An op can be converted to several layers, which all take its precision.
+  for (int i = first_layer; i < network_->getNbLayers(); ++i) {
+    nvinfer1::ILayer* layer = network_->getLayer(i);
+    layer->setPrecision(precision);
+    for (int j = 0; j < layer->getNbOutputs(); ++j) {
+      layer->setOutputType(j, precision);
+    }
+  }
+  has_layer_precisions_ = true;
+}
+
 TensorRTEngineAndContext TensorRTBuilder::BuildEngine() {
   // Process graph to create INetworkDefinition.
 // Build engine.
 #if TRT_VERSION_GE(6, 0, 1)
   config_ = builder_->createBuilderConfig();
   config_->setMaxWorkspaceSize(max_workspace_size_);
-  if (use_fp16_) {
+  if (use_fp16_ || !fp16_layers_.empty()) {
     config_->setFlag(nvinfer1::BuilderFlag::kFP16);
   }
+  if (has_layer_precisions_) {
+#if TRT_VERSION_GE(8, 2, 0)
+    config_->setFlag(nvinfer1::BuilderFlag::kOBEY_PRECISION_CONSTRAINTS);
+#else
+    config_->setFlag(nvinfer1::BuilderFlag::kSTRICT_TYPES);
+#endif
+  }
 
   if (use_int8_) {
     config_->setFlag(nvinfer1::BuilderFlag::kINT8);
@@ -187,6 +224,15 @@ TensorRTEngineAndContext TensorRTBuilder::BuildEngine() {
     auto profile = builder_->createOptimizationProfile();
     for (int i = 0; i < network_->getNbInputs(); ++i) {
       auto name = network_->getInput(i)->getName();
+      if (use_shape_range_ && shape_range_.min_shapes.count(name)) {
+        profile->setDimensions(name, nvinfer1::OptProfileSelector::kMIN,
+                               VectorToTrtDims(shape_range_.min_shapes.at(name)));
+        profile->setDimensions(name, nvinfer1::OptProfileSelector::kOPT,
+                               VectorToTrtDims(shape_range_.opt_shapes.at(name)));
+        profile->setDimensions(name, nvinfer1::OptProfileSelector::kMAX,
+                               VectorToTrtDims(shape_range_.max_shapes.at(name)));
+        continue;
+      }
       const uint32_t entry_id = entry_id_map_[name];
       std::vector<int64_t> shape(data_entry_[entry_id]->shape,
                                  data_entry_[entry_id]->shape + data_entry_[entry_id]->ndim);
@@ -27,6 +27,7 @@
 
 #include <tvm/runtime/ndarray.h>
 
+#include <map>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -54,6 +55,16 @@ struct TensorRTEngineAndContext {
   std::vector<std::string> outputs;
 };
 
+/*!
+ * \brief The range of the input shapes an engine of the explicit batch mode accepts, as the
+ * min/opt/max dimensions of the optimization profile of each network input, by input name.
+ */
+struct TensorRTShapeRange {
+  std::map<std::string, std::vector<int64_t>> min_shapes;
+  std::map<std::string, std::vector<int64_t>> opt_shapes;
+  std::map<std::string, std::vector<int64_t>> max_shapes;
+};
+
 /*!
  * \brief Converts a JSONRuntime graph into a TensorRT engine and execution context. Inputs,
  * constants, layers, and outputs can be added to construct the TensorRT network definition.
@@ -104,6 +115,29 @@ class TensorRTBuilder {
    */
   void AddOutput(const JSONGraphNodeEntry& entry, uint32_t entry_id);
 
+  /*!
+   * \brief Build the engine for a range of input shapes rather than for the current ones, in the
+   * explicit batch mode.
+   * \param shape_range The min/opt/max shapes of the inputs.
+   */
+  void SetShapeRange(const TensorRTShapeRange& shape_range) {
+    shape_range_ = shape_range;
+    use_shape_range_ = true;
+  }
+
+  /*!
+   * \brief Pin the precision of the layers of some ops, e.g. to fall back from int8 or float16
+   * for the ops sensitive to it. Must be set before the layers are added.
+   * \param fp16_layers The ops whose layers are computed in float16, by the names of their nodes
+   * with or without their "tensorrt." prefix.
+   * \param fp32_layers The ops whose layers are computed in float32.
+   */
+  void SetLayerPrecisions(const std::vector<std::string>& fp16_layers,
+                          const std::vector<std::string>& fp32_layers) {
+    fp16_layers_ = fp16_layers;
+    fp32_layers_ = fp32_layers;
+  }
+
   /*!
    * \brief Takes network definition and "compiles" a TensorRT engine which can be used for
    * inference. This step is time confusing.
@@ -121,6 +155,13 @@ class TensorRTBuilder {
   /*! \brief Clean up resources used to create engine. */
   void CleanUp();
 
+  /*!
+   * \brief Pin the precision of the layers of an op, if listed.
+   * \param op_name The name of the node of the op.
+   * \param first_layer The index of the first layer of the op in the network.
+   */
+  void PinLayerPrecision(const std::string& op_name, int first_layer);
+
   /*! \brief Maps a node to its outputs. */
   std::unordered_map<int, std::vector<TensorRTOpInput>> node_output_map_;
 
@@ -159,6 +200,19 @@ class TensorRTBuilder {
   /*! \brief Batch size to optimize for. */
   int batch_size_;
 
+  /*! \brief The range of input shapes of the optimization profile, if set. */
+  TensorRTShapeRange shape_range_;
+
+  /*! \brief Whether the optimization profile uses shape_range_. */
+  bool use_shape_range_ = false;
+
+  /*! \brief The ops whose layers are computed in float16 and in float32. */
+  std::vector<std::string> fp16_layers_;
+  std::vector<std::string> fp32_layers_;
+
+  /*! \brief Whether the precision of any layer is pinned. */
+  bool has_layer_precisions_ = false;
+
   /*! \brief Input names. */
   std::vector<std::string> network_input_names_;
 
@@ -23,6 +23,8 @@
 #ifndef TVM_RUNTIME_CONTRIB_TENSORRT_TENSORRT_CALIBRATOR_H_
 #define TVM_RUNTIME_CONTRIB_TENSORRT_TENSORRT_CALIBRATOR_H_
 
+#include <fstream>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -34,8 +36,30 @@ namespace runtime {
 
 class TensorRTCalibrator : public nvinfer1::IInt8EntropyCalibrator2 {
  public:
-  TensorRTCalibrator(int batch_size, const std::vector<std::string>& input_names)
-      : batch_size_(batch_size), num_batches_calibrated_(0), input_names_(input_names) {}
+  /*!
+   * \param batch_size The batch size of the calibration data.
+   * \param input_names The names of the inputs, in the order of the bindings.
+   * \param cache_path The file persisting the calibration cache, none if empty. An existing
+   * cache is read back instead of calibrating on the batch data.
+   */
+  TensorRTCalibrator(int batch_size, const std::vector<std::string>& input_names,
+                     const std::string& cache_path = "")
+      : batch_size_(batch_size),
+        num_batches_calibrated_(0),
+        input_names_(input_names),
+        cache_path_(cache_path) {
+    if (cache_path_.empty()) return;
+    std::ifstream cache_file(cache_path_, std::ios::binary);
+    if (cache_file.good()) {
+      std::ostringstream os;
+      os << cache_file.rdbuf();
+      calibration_cache_ = os.str();
+      LOG(INFO) << "Loaded the TensorRT calibration cache " << cache_path_;
+    }
+  }
+
+  /*! \brief Whether the calibration cache was loaded, so that no batch data is needed. */
+  bool HasCalibrationCache() const { return !calibration_cache_.empty(); }
 
   ~TensorRTCalibrator() {
     // Free calibration data
@@ -69,6 +93,8 @@ class TensorRTCalibrator : public nvinfer1::IInt8EntropyCalibrator2 {
    * calibrate with.
    */
   bool getBatch(void* bindings[], const char* names[], int nbBindings) noexcept override {
+    // Without batch data, the calibration relies on the cache only.
+    if (data_.empty()) return false;
     AllocateBuffersIfNotAllocated();
     CHECK_EQ(input_names_.size(), nbBindings);
     for (size_t i = 0; i < input_names_.size(); ++i) {
@@ -91,6 +117,14 @@ class TensorRTCalibrator : public nvinfer1::IInt8EntropyCalibrator2 {
 
   void writeCalibrationCache(const void* cache, size_t length) noexcept override {
     calibration_cache_.assign(static_cast<const char*>(cache), length);
+    if (cache_path_.empty()) return;
+    std::ofstream cache_file(cache_path_, std::ios::binary);
+    cache_file.write(calibration_cache_.data(), calibration_cache_.size());
+    if (cache_file.good()) {
+      LOG(INFO) << "Saved the TensorRT calibration cache " << cache_path_;
+    } else {
+      LOG(WARNING) << "Failed to save the TensorRT calibration cache " << cache_path_;
+    }
   }
 
  private:
@@ -112,6 +146,9 @@ class TensorRTCalibrator : public nvinfer1::IInt8EntropyCalibrator2 {
   /*! \brief Names of inputs */
   const std::vector<std::string> input_names_;
 
+  /*! \brief The file persisting the calibration cache, none if empty. */
+  const std::string cache_path_;
+
   /*! \brief Allocate device memory buffers. data_sizes_ must already have one
    * entry. */
   void AllocateBuffersIfNotAllocated() {
@@ -26,8 +26,10 @@
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
 #include <fstream>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -37,6 +39,7 @@
 #include "../json/json_runtime.h"
 
 #ifdef TVM_GRAPH_EXECUTOR_TENSORRT
+#include "../../cuda/cuda_common.h"
 #include "NvInfer.h"
 #include "tensorrt_builder.h"
 #include "tensorrt_calibrator.h"
@@ -73,21 +76,10 @@ class TensorRTRuntime : public JSONRuntimeBase {
         max_workspace_size_(size_t(1) << 30),
         max_batch_size_(-1),
         multi_engine_mode_(false),
-        use_fp16_(false) {
-    const bool use_int8 = dmlc::GetEnv("TVM_TENSORRT_USE_INT8", false);
+        use_fp16_(false),
+        use_int8_(false) {
     multi_engine_mode_ = dmlc::GetEnv("TVM_TENSORRT_MULTI_ENGINE", false);
-    num_calibration_batches_remaining_ = dmlc::GetEnv("TENSORRT_NUM_CALI_INT8", 0);
-    if (use_int8) {
-      ICHECK(num_calibration_batches_remaining_ != 0)
-          << "When using INT8 mode, "
-          << "environment variable TENSORRT_NUM_CALI_INT8"
-          << "must also be set to specify the number of "
-          << "calibration times";
-      LOG(INFO) << "settiing up " << num_calibration_batches_remaining_
-                << " sample data to calibrate data ... ";
-      ICHECK(multi_engine_mode_ == false) << "When using int8 mode, "
-                                          << "multi-engine is not allowed";
-    }
+    num_calibration_batches_remaining_ = 0;
   }
 
   /*!
@@ -97,6 +89,67 @@ class TensorRTRuntime : public JSONRuntimeBase {
    */
   const char* type_key() const final { return "tensorrt"; }
 
+  /*!
+   * \brief Save the module, with the TensorRT engines built so far as serialized plans, so that
+   * the module loaded from them deserializes the engines instead of building them again.
+   *
+   * \param stream The stream to save to.
+   */
+  void SaveToBinary(dmlc::Stream* stream) final {
+    JSONRuntimeBase::SaveToBinary(stream);
+    std::vector<SerializedEngine> engines = serialized_engines_;
+#ifdef TVM_GRAPH_EXECUTOR_TENSORRT
+    for (auto& it : trt_engine_cache_) {
+      SerializedEngine engine;
+      engine.key = GetSubgraphKey();
+      engine.batch_size = it.first.second;
+      nvinfer1::IHostMemory* plan = it.second.engine->serialize();
+      engine.plan = std::string(static_cast<const char*>(plan->data()), plan->size());
+      plan->destroy();
+      engine.inputs = it.second.inputs;
+      engine.outputs = it.second.outputs;
+      engines.push_back(std::move(engine));
+    }
+    for (auto& it : profile_engine_cache_) {
+      SerializedEngine engine;
+      engine.key = GetSubgraphKey();
+      engine.batch_size = -1;
+      engine.shape_range = it.first;
+      nvinfer1::IHostMemory* plan = it.second.engine->serialize();
+      engine.plan = std::string(static_cast<const char*>(plan->data()), plan->size());
+      plan->destroy();
+      engine.inputs = it.second.inputs;
+      engine.outputs = it.second.outputs;
+      engines.push_back(std::move(engine));
+    }
+#endif
+    stream->Write(static_cast<uint64_t>(engines.size()));
+    for (const SerializedEngine& engine : engines) {
+      stream->Write(engine.key);
+      stream->Write(engine.batch_size);
+      stream->Write(engine.plan);
+      stream->Write(engine.inputs);
+      stream->Write(engine.outputs);
+      stream->Write(engine.shape_range);
+    }
+  }
+
+  static Module LoadFromBinary(void* strm) {
+    Module mod = JSONRuntimeBase::LoadFromBinary<TensorRTRuntime>(strm);
+    auto* self = static_cast<TensorRTRuntime*>(mod.operator->());
+    dmlc::Stream* stream = static_cast<dmlc::Stream*>(strm);
+    uint64_t num_engines;
+    ICHECK(stream->Read(&num_engines)) << "Loading the number of TensorRT engines failed";
+    self->serialized_engines_.resize(num_engines);
+    for (SerializedEngine& engine : self->serialized_engines_) {
+      ICHECK(stream->Read(&engine.key) && stream->Read(&engine.batch_size) &&
+             stream->Read(&engine.plan) && stream->Read(&engine.inputs) &&
+             stream->Read(&engine.outputs) && stream->Read(&engine.shape_range))
+          << "Loading the serialized TensorRT engines failed";
+    }
+    return mod;
+  }
+
   /*!
    * \brief Initialize runtime. Create TensorRT layer from JSON
    * representation.
@@ -107,8 +160,14 @@ class TensorRTRuntime : public JSONRuntimeBase {
     ICHECK_EQ(consts.size(), const_idx_.size())
         << "The number of input constants must match the number of required.";
     LoadGlobalAttributes();
+    SetupInt8Calibration();
+    // The engines of optimization profiles are kept per range of input shapes, which does not
+    // mix with the calibration of int8 mode.
+    use_shape_profiles_ = !use_implicit_batch_ && !max_input_shapes_.empty() && !use_int8_;
     SetupConstants(consts);
-    GetCachedEnginesFromDisk();
+    if (!LoadSerializedEngines() && !use_shape_profiles_) {
+      GetCachedEnginesFromDisk();
+    }
   }
 
   void LoadGlobalAttributes() {
@@ -131,7 +190,72 @@ class TensorRTRuntime : public JSONRuntimeBase {
       if (nodes_[i].HasAttr("use_fp16")) {
         use_fp16_ = std::stoi(nodes_[i].GetAttr<std::vector<std::string>>("use_fp16")[0]);
       }
+      if (nodes_[i].HasAttr("use_int8")) {
+        use_int8_ = std::stoi(nodes_[i].GetAttr<std::vector<std::string>>("use_int8")[0]);
+        num_calibration_batches_remaining_ = std::stoi(
+            nodes_[i].GetAttr<std::vector<std::string>>("num_calibration_batches")[0]);
+        calibration_cache_dir_ =
+            nodes_[i].GetAttr<std::vector<std::string>>("calibration_cache_dir")[0];
+      }
+      if (nodes_[i].HasAttr("fp16_layers")) {
+        fp16_layers_ = nodes_[i].GetAttr<std::vector<std::string>>("fp16_layers");
+      }
+      if (nodes_[i].HasAttr("fp32_layers")) {
+        fp32_layers_ = nodes_[i].GetAttr<std::vector<std::string>>("fp32_layers");
+      }
+      if (nodes_[i].HasAttr("max_input_shapes")) {
+        // Each entry reads "<input name>=<dim>,<dim>,...", with -1 for the unbounded dimensions.
+        max_input_shapes_.clear();
+        for (const std::string& entry :
+             nodes_[i].GetAttr<std::vector<std::string>>("max_input_shapes")) {
+          size_t pos = entry.find('=');
+          ICHECK_NE(pos, std::string::npos) << "Invalid max input shape " << entry;
+          std::vector<int64_t>& shape = max_input_shapes_[entry.substr(0, pos)];
+          std::istringstream is(entry.substr(pos + 1));
+          std::string dim;
+          while (std::getline(is, dim, ',')) shape.push_back(std::stoll(dim));
+        }
+      }
+    }
+  }
+
+  /*!
+   * \brief Set up the int8 mode, enabled by the compiler config or by TVM_TENSORRT_USE_INT8, in
+   * which the engines are built after calibration runs, unless the calibration is cached. The
+   * environment variables override the compiler config.
+   */
+  void SetupInt8Calibration() {
+    use_int8_ = use_int8_ || dmlc::GetEnv("TVM_TENSORRT_USE_INT8", false);
+    if (!use_int8_) return;
+    const int env_num_batches = dmlc::GetEnv("TENSORRT_NUM_CALI_INT8", 0);
+    if (env_num_batches != 0) num_calibration_batches_remaining_ = env_num_batches;
+    calibration_cache_dir_ =
+        dmlc::GetEnv("TVM_TENSORRT_CALIBRATION_CACHE_DIR", calibration_cache_dir_);
+    ICHECK(!multi_engine_mode_) << "When using int8 mode, multi-engine is not allowed";
+    if (HasCalibrationCacheFile()) {
+      LOG(INFO) << "Calibrating " << symbol_name_ << " from the cache "
+                << GetCalibrationCachePath();
+      num_calibration_batches_remaining_ = 0;
+      return;
     }
+    ICHECK(num_calibration_batches_remaining_ != 0)
+        << "When using INT8 mode without a calibration cache, num_calibration_batches or the "
+        << "environment variable TENSORRT_NUM_CALI_INT8 must be set to specify the number of "
+        << "calibration runs";
+    LOG(INFO) << "Setting up " << num_calibration_batches_remaining_
+              << " runs of sample data to calibrate " << symbol_name_;
+  }
+
+  /*! \brief The file of the calibration cache of the function, none if empty. */
+  std::string GetCalibrationCachePath() const {
+    if (calibration_cache_dir_.empty()) return "";
+    return calibration_cache_dir_ + "/" + symbol_name_ + ".calib";
+  }
+
+  /*! \brief Whether the calibration of the function is cached on disk. */
+  bool HasCalibrationCacheFile() const {
+    std::string path = GetCalibrationCachePath();
+    return !path.empty() && std::ifstream(path, std::ios::binary).good();
   }
 
 #ifdef TVM_GRAPH_EXECUTOR_TENSORRT
@@ -146,6 +270,13 @@ class TensorRTRuntime : public JSONRuntimeBase {
       it.second.engine->destroy();
     }
     trt_engine_cache_.clear();
+    for (auto& it : profile_engine_cache_) {
+      VLOG(1) << "Destroying TensorRT engine for function '" << symbol_name_ << "' (shape range "
+              << it.first << ")";
+      it.second.context->destroy();
+      it.second.engine->destroy();
+    }
+    profile_engine_cache_.clear();
   }
 
   ~TensorRTRuntime() override {
@@ -154,7 +285,13 @@ class TensorRTRuntime : public JSONRuntimeBase {
     VLOG(1) << "Destroyed TensorRT runtime";
   }
 
-  /*! \brief Run inference using built engine. */
+  /*! \brief The engines are enqueued on the current CUDA stream. */
+  bool IsStreamOrdered() const override { return true; }
+
+  /*!
+   * \brief Run inference using built engine, enqueuing it on the current CUDA stream. Only the
+   * outputs copied back to a device other than CUDA wait for the engine.
+   */
   void Run() override {
     auto& engine_and_context = GetOrBuildEngine();
     int batch_size = GetBatchSize();
@@ -222,23 +359,31 @@ class TensorRTRuntime : public JSONRuntimeBase {
       }
     }
 
+    cudaStream_t stream = CUDAThreadEntry::ThreadLocal()->stream;
 #if TRT_VERSION_GE(6, 0, 1)
     if (use_implicit_batch_) {
-      ICHECK(context->execute(batch_size, bindings.data())) << "Running TensorRT failed.";
+      ICHECK(context->enqueue(batch_size, bindings.data(), stream, nullptr))
+          << "Running TensorRT failed.";
     } else {
-      ICHECK(context->executeV2(bindings.data())) << "Running TensorRT failed.";
+      ICHECK(context->enqueueV2(bindings.data(), stream, nullptr)) << "Running TensorRT failed.";
     }
 #else
-    ICHECK(context->execute(batch_size, bindings.data())) << "Running TensorRT failed.";
+    ICHECK(context->enqueue(batch_size, bindings.data(), stream, nullptr))
+        << "Running TensorRT failed.";
 #endif
 
     // Copy outputs from GPU buffers if needed.
+    bool synced = false;
     for (size_t i = 0; i < outputs_.size(); ++i) {
       uint32_t eid = EntryID(outputs_[i]);
       const std::string& name = engine_and_context.outputs[i];
       int binding_index = engine->getBindingIndex(name.c_str());
       ICHECK_NE(binding_index, -1);
       if (data_entry_[eid]->device.device_type != kDLCUDA) {
+        if (!synced) {
+          CUDA_CALL(cudaStreamSynchronize(stream));
+          synced = true;
+        }
         auto device_buffer = GetOrAllocateDeviceBuffer(eid, binding_index);
         device_buffer.CopyTo(const_cast<DLTensor*>(data_entry_[eid]));
       }
@@ -275,14 +420,14 @@ class TensorRTRuntime : public JSONRuntimeBase {
    * already built, do nothing.
    */
   TensorRTEngineAndContext& GetOrBuildEngine() {
+    if (use_shape_profiles_) return GetOrBuildProfileEngine();
     int batch_size = GetBatchSize();
     int compatible_engine_batch_size = -1;
     bool find_engine_flag = FindCompatibleEngine(batch_size, &compatible_engine_batch_size);
-    const bool use_int8 = (dmlc::GetEnv("TVM_TENSORRT_USE_INT8", 0) != 0);
     const bool int8_calibration_not_used_or_not_complete =
         (calibrator_ != nullptr && num_calibration_batches_remaining_ != 0);
     if (find_engine_flag &&
-        (!use_int8 || calibrator_ == nullptr || int8_calibration_not_used_or_not_complete)) {
+        (!use_int8_ || calibrator_ == nullptr || int8_calibration_not_used_or_not_complete)) {
       // A compatible engine already exists.
       return trt_engine_cache_.at(std::make_pair(symbol_name_, compatible_engine_batch_size));
     }
@@ -296,16 +441,20 @@ class TensorRTRuntime : public JSONRuntimeBase {
                << " with batch size " << batch_size;
 
     // Build engine.
+    if (use_int8_ && calibrator_ == nullptr && HasCalibrationCacheFile()) {
+      // The int8 engine is built from the cached calibration, without calibration runs.
+      calibrator_.reset(new TensorRTCalibrator(batch_size, {}, GetCalibrationCachePath()));
+    }
     if (calibrator_ != nullptr && num_calibration_batches_remaining_ == 0) {
       // Calibration complete and build int8 engine
-      BuildEngineFromJson(batch_size);
+      trt_engine_cache_[std::make_pair(symbol_name_, batch_size)] = BuildEngineFromJson(batch_size);
       calibrator_.reset(nullptr);
     } else {
       // Build new engine
-      BuildEngineFromJson(batch_size);
+      trt_engine_cache_[std::make_pair(symbol_name_, batch_size)] = BuildEngineFromJson(batch_size);
       TensorRTEngineAndContext& engine_and_context =
           trt_engine_cache_[std::make_pair(symbol_name_, batch_size)];
-      if (use_int8) {
+      if (use_int8_) {
         this->CreateInt8Calibrator(engine_and_context);
       }
     }
@@ -316,10 +465,95 @@ class TensorRTRuntime : public JSONRuntimeBase {
     return trt_engine_cache_.at(std::make_pair(symbol_name_, batch_size));
   }
 
-  void BuildEngineFromJson(int batch_size) {
+  /*!
+   * \brief Get the engine of the optimization profile covering the current input shapes. It is
+   * built on the first request in its range, unless it was cached on disk, and reused for all
+   * the others.
+   */
+  TensorRTEngineAndContext& GetOrBuildProfileEngine() {
+    TensorRTShapeRange shape_range = GetShapeRange();
+    std::string range_key = GetShapeRangeKey(shape_range);
+    auto it = profile_engine_cache_.find(range_key);
+    if (it != profile_engine_cache_.end()) return it->second;
+    if (!GetCachedProfileEngineFromDisk(range_key)) {
+      DLOG(INFO) << "Building new TensorRT engine for subgraph " << symbol_name_
+                 << " with shape range " << range_key;
+      profile_engine_cache_[range_key] = BuildEngineFromJson(GetBatchSize(), &shape_range);
+      VLOG(1) << "Finished building TensorRT engine for subgraph " << symbol_name_
+              << " with shape range " << range_key;
+      CacheProfileEngineToDisk(range_key);
+    }
+    return profile_engine_cache_.at(range_key);
+  }
+
+  /*!
+   * \brief Get the range of input shapes the engine running the current request is built for.
+   * The static dimensions are kept. A dynamic one ranges from 1 to the upper bound of its input
+   * when it is known, within the power of two bucket of its current extent otherwise.
+   */
+  TensorRTShapeRange GetShapeRange() {
+    TensorRTShapeRange shape_range;
+    for (size_t i = 0; i < input_nodes_.size(); ++i) {
+      auto nid = input_nodes_[i];
+      if (nodes_[nid].GetOpType() != "input") continue;
+      const auto& op_shapes = nodes_[nid].GetOpShape();
+      for (size_t j = 0; j < op_shapes.size(); ++j) {
+        const std::string name = nodes_[nid].GetOpName() + "_" + std::to_string(j);
+        const DLTensor* data = data_entry_[EntryID(nid, j)];
+        std::vector<int64_t> shape(data->shape, data->shape + data->ndim);
+        std::vector<int64_t> min_shape = shape;
+        std::vector<int64_t> max_shape = shape;
+        auto bound_it = max_input_shapes_.find(name);
+        for (size_t k = 0; k < shape.size() && k < op_shapes[j].size(); ++k) {
+          if (op_shapes[j][k] != -1) continue;
+          int64_t bound = -1;
+          if (bound_it != max_input_shapes_.end() && k < bound_it->second.size()) {
+            bound = bound_it->second[k];
+          }
+          if (bound > 0) {
+            ICHECK_LE(shape[k], bound) << "Dimension " << k << " of input " << name
+                                       << " exceeds its upper bound " << bound;
+            min_shape[k] = 1;
+            max_shape[k] = bound;
+          } else {
+            int64_t bucket = 1;
+            while (bucket < shape[k]) bucket <<= 1;
+            min_shape[k] = bucket / 2 + 1;
+            max_shape[k] = bucket;
+          }
+        }
+        shape_range.min_shapes[name] = min_shape;
+        shape_range.opt_shapes[name] = shape;
+        shape_range.max_shapes[name] = max_shape;
+      }
+    }
+    return shape_range;
+  }
+
+  /*! \brief The key of a range of input shapes, from its min and max shapes. */
+  static std::string GetShapeRangeKey(const TensorRTShapeRange& shape_range) {
+    std::ostringstream os;
+    for (const auto& it : shape_range.min_shapes) {
+      const std::vector<int64_t>& max_shape = shape_range.max_shapes.at(it.first);
+      os << it.first << ":";
+      for (size_t i = 0; i < it.second.size(); ++i) {
+        os << (i ? "," : "") << it.second[i];
+        if (max_shape[i] != it.second[i]) os << "-" << max_shape[i];
+      }
+      os << ";";
+    }
+    return os.str();
+  }
+
+  TensorRTEngineAndContext BuildEngineFromJson(int batch_size,
+                                               const TensorRTShapeRange* shape_range = nullptr) {
     const bool use_fp16 = dmlc::GetEnv("TVM_TENSORRT_USE_FP16", false) || use_fp16_;
     TensorRTBuilder builder(&logger_, data_entry_, max_workspace_size_, use_implicit_batch_,
                             use_fp16, batch_size, calibrator_.get());
+    if (shape_range != nullptr) {
+      builder.SetShapeRange(*shape_range);
+    }
+    builder.SetLayerPrecisions(fp16_layers_, fp32_layers_);
     for (size_t i = 0; i < input_nodes_.size(); ++i) {
       auto nid = input_nodes_[i];
       const auto& node = nodes_[nid];
@@ -345,8 +579,50 @@ class TensorRTRuntime : public JSONRuntimeBase {
       builder.AddOutput(outputs_[i], EntryID(outputs_[i]));
     }
 
-    TensorRTEngineAndContext engine_and_context = builder.BuildEngine();
-    trt_engine_cache_[std::make_pair(symbol_name_, batch_size)] = engine_and_context;
+    return builder.BuildEngine();
+  }
+
+  /*! \brief Deserialize a TensorRT engine and create its execution context. */
+  TensorRTEngineAndContext DeserializeEngine(const std::string& plan) {
+    nvinfer1::IRuntime* runtime = nvinfer1::createInferRuntime(logger_);
+    TensorRTEngineAndContext engine_and_context;
+    engine_and_context.engine = runtime->deserializeCudaEngine(&plan[0], plan.size(), nullptr);
+    engine_and_context.context = engine_and_context.engine->createExecutionContext();
+    return engine_and_context;
+  }
+
+  /*! \brief Deserialize the engines saved with the module, built with the same precision.
+   * \return Whether any engine was deserialized.
+   */
+  bool LoadSerializedEngines() {
+    bool loaded = false;
+    for (const SerializedEngine& engine : serialized_engines_) {
+      if (engine.key != GetSubgraphKey()) continue;
+      // the engines of optimization profiles are only used in the shape profile mode
+      if (use_shape_profiles_ || !engine.shape_range.empty()) {
+        if (!use_shape_profiles_ || engine.shape_range.empty()) continue;
+        TensorRTEngineAndContext engine_and_context = DeserializeEngine(engine.plan);
+        engine_and_context.inputs = engine.inputs;
+        engine_and_context.outputs = engine.outputs;
+        profile_engine_cache_[engine.shape_range] = engine_and_context;
+        loaded = true;
+        continue;
+      }
+      // in single engine mode, only the engine of the highest batch size is kept
+      if (engine.key != GetSubgraphKey() ||
+          (!multi_engine_mode_ && engine.batch_size <= max_batch_size_)) {
+        continue;
+      }
+      if (!multi_engine_mode_) DestroyEngines();
+      TensorRTEngineAndContext engine_and_context = DeserializeEngine(engine.plan);
+      engine_and_context.inputs = engine.inputs;
+      engine_and_context.outputs = engine.outputs;
+      trt_engine_cache_[std::make_pair(symbol_name_, engine.batch_size)] = engine_and_context;
+      max_batch_size_ = std::max(max_batch_size_, engine.batch_size);
+      loaded = true;
+    }
+    serialized_engines_.clear();
+    return loaded;
   }
 
   /*! \brief If TVM_TENSORRT_CACHE_DIR is set, will check that directory for
@@ -365,12 +641,7 @@ class TensorRTRuntime : public JSONRuntimeBase {
     infile.close();
     std::string serialized_engine;
     LoadBinaryFromFile(path, &serialized_engine);
-    // Deserialize engine
-    nvinfer1::IRuntime* runtime = nvinfer1::createInferRuntime(logger_);
-    TensorRTEngineAndContext engine_and_context;
-    engine_and_context.engine =
-        runtime->deserializeCudaEngine(&serialized_engine[0], serialized_engine.size(), nullptr);
-    engine_and_context.context = engine_and_context.engine->createExecutionContext();
+    TensorRTEngineAndContext engine_and_context = DeserializeEngine(serialized_engine);
     // Load metadata
     std::string meta_path = cache_dir + "/" + key + ".meta";
     std::string serialized_meta;
@@ -419,10 +690,79 @@ class TensorRTRuntime : public JSONRuntimeBase {
     SaveBinaryToFile(meta_path, os.str());
   }
 
+  /*! \brief The path, without extension, of the files caching the engine of a shape range. */
+  std::string GetProfileCachePath(const std::string& cache_dir, const std::string& range_key) {
+    std::ostringstream os;
+    os << cache_dir << "/" << GetSubgraphKey() << "_" << std::hex
+       << std::hash<std::string>()(range_key);
+    return os.str();
+  }
+
+  /*!
+   * \brief If TVM_TENSORRT_CACHE_DIR is set, look up the engine of a shape range in that
+   * directory and load it into profile_engine_cache_.
+   * \return Whether the engine was loaded.
+   */
+  bool GetCachedProfileEngineFromDisk(const std::string& range_key) {
+    std::string cache_dir = dmlc::GetEnv("TVM_TENSORRT_CACHE_DIR", std::string(""));
+    if (cache_dir.empty()) return false;
+    std::string path = GetProfileCachePath(cache_dir, range_key);
+    std::ifstream infile(path + ".meta", std::ios::binary);
+    if (!infile.good()) return false;
+    infile.close();
+    std::string serialized_meta;
+    LoadBinaryFromFile(path + ".meta", &serialized_meta);
+    std::istringstream is(serialized_meta);
+    dmlc::JSONReader reader(&is);
+    dmlc::JSONObjectReadHelper helper;
+    std::vector<std::string> inputs, outputs;
+    std::string shape_range;
+    helper.DeclareField("inputs", &inputs);
+    helper.DeclareField("outputs", &outputs);
+    helper.DeclareField("shape_range", &shape_range);
+    helper.ReadAllFields(&reader);
+    // the file names are hashed, the range is checked in case of collision
+    if (shape_range != range_key) return false;
+    LOG(INFO) << "Loading cached TensorRT engine from " << path << ".plan";
+    std::string serialized_engine;
+    LoadBinaryFromFile(path + ".plan", &serialized_engine);
+    TensorRTEngineAndContext engine_and_context = DeserializeEngine(serialized_engine);
+    engine_and_context.inputs = inputs;
+    engine_and_context.outputs = outputs;
+    profile_engine_cache_[range_key] = engine_and_context;
+    return true;
+  }
+
+  /*!
+   * \brief If TVM_TENSORRT_CACHE_DIR is set, save the engine of a shape range to that directory
+   * so it can be loaded later.
+   */
+  void CacheProfileEngineToDisk(const std::string& range_key) {
+    std::string cache_dir = dmlc::GetEnv("TVM_TENSORRT_CACHE_DIR", std::string(""));
+    if (cache_dir.empty()) return;
+    std::string path = GetProfileCachePath(cache_dir, range_key);
+    DLOG(INFO) << "Caching TensorRT engine to " << path << ".plan";
+    const TensorRTEngineAndContext& engine_and_context = profile_engine_cache_.at(range_key);
+    nvinfer1::IHostMemory* serialized_engine = engine_and_context.engine->serialize();
+    SaveBinaryToFile(path + ".plan",
+                     std::string(static_cast<const char*>(serialized_engine->data()),
+                                 serialized_engine->size()));
+    serialized_engine->destroy();
+    std::ostringstream os;
+    dmlc::JSONWriter writer(&os);
+    writer.BeginObject();
+    writer.WriteObjectKeyValue("inputs", engine_and_context.inputs);
+    writer.WriteObjectKeyValue("outputs", engine_and_context.outputs);
+    writer.WriteObjectKeyValue("shape_range", range_key);
+    writer.EndObject();
+    SaveBinaryToFile(path + ".meta", os.str());
+  }
+
   std::string GetSubgraphKey() {
     // Using this key will only allow a single model per TVM_TENSORRT_CACHE_DIR directory. We could
     // instead use a hash of graph_json and all weights to allow many models in the same directory,
     // but the cost of computing the hash is high.
+    if (use_int8_) return symbol_name_ + "_int8";
     return symbol_name_ + (dmlc::GetEnv("TVM_TENSORRT_USE_FP16", false) ? "_fp16" : "_fp32");
   }
 
@@ -431,12 +771,14 @@ class TensorRTRuntime : public JSONRuntimeBase {
     std::vector<int64_t> shape(data_entry_[entry_id]->shape,
                                data_entry_[entry_id]->shape + data_entry_[entry_id]->ndim);
     if (device_buffers_.count(binding_index)) {
-      // Buffer is already initialized.
-      if (shape[0] > device_buffers_[binding_index]->shape[0]) {
+      // Buffer is already initialized. Any dimension may vary with the optimization profiles.
+      const DLTensor* buffer = device_buffers_[binding_index].operator->();
+      std::vector<int64_t> buffer_shape(buffer->shape, buffer->shape + buffer->ndim);
+      if (GetDataSize(*data_entry_[entry_id]) > GetDataSize(*buffer)) {
         // Buffer is too small. Need to allocate bigger buffer.
         device_buffers_[binding_index] =
             runtime::NDArray::Empty(shape, data_entry_[entry_id]->dtype, {kDLCUDA, 0});
-      } else if (shape[0] < device_buffers_[binding_index]->shape[0]) {
+      } else if (shape != buffer_shape) {
         // Buffer is too large. Create view.
         return device_buffers_[binding_index].CreateView(shape, data_entry_[entry_id]->dtype);
       }
@@ -456,13 +798,17 @@ class TensorRTRuntime : public JSONRuntimeBase {
       input_names.push_back(ele);
     }
     const int batch_size = GetBatchSize();
-    calibrator_.reset(new TensorRTCalibrator(batch_size, input_names));
+    calibrator_.reset(new TensorRTCalibrator(batch_size, input_names, GetCalibrationCachePath()));
   }
 
   /*! \brief Map of function name and max batch size to TRT engine if built already. */
   std::unordered_map<std::pair<std::string, int>, TensorRTEngineAndContext, PairHash>
       trt_engine_cache_;
 
+  /*! \brief Map of the key of a range of input shapes to the TRT engine of its optimization
+   * profile, in the shape profile mode. */
+  std::unordered_map<std::string, TensorRTEngineAndContext> profile_engine_cache_;
+
   /*! \brief Calibrator for INT8 mode. */
   std::unique_ptr<TensorRTCalibrator> calibrator_;
 
@@ -488,9 +834,29 @@ class TensorRTRuntime : public JSONRuntimeBase {
 
   bool GetCachedEnginesFromDisk() { return false; }
 
+  // the serialized engines are kept to be saved again
+  bool LoadSerializedEngines() { return false; }
+
   void CacheEngineToDisk() {}
 #endif  // TVM_GRAPH_EXECUTOR_TENSORRT
 
+  /*! \brief A TensorRT engine saved with the module. */
+  struct SerializedEngine {
+    /*! \brief The subgraph key of the engine, telling its precision. */
+    std::string key;
+    int batch_size;
+    /*! \brief The serialized plan of the engine. */
+    std::string plan;
+    std::vector<std::string> inputs;
+    std::vector<std::string> outputs;
+    /*! \brief The key of the range of input shapes of the engine, empty for the engines built
+     * for a batch size. */
+    std::string shape_range;
+  };
+
+  /*! \brief The engines loaded with the module, not deserialized yet. */
+  std::vector<SerializedEngine> serialized_engines_;
+
   bool use_implicit_batch_;
 
   size_t max_workspace_size_;
@@ -511,6 +877,26 @@ class TensorRTRuntime : public JSONRuntimeBase {
 
   /*! \brief Use auto-conversion to fp16 */
   bool use_fp16_;
+
+  /*! \brief Whether the engines are built in int8 mode, from a calibration. */
+  bool use_int8_;
+
+  /*! \brief The directory of the calibration caches, none if empty. */
+  std::string calibration_cache_dir_;
+
+  /*! \brief The ops whose layers are computed in float16 and in float32. */
+  std::vector<std::string> fp16_layers_;
+  std::vector<std::string> fp32_layers_;
+
+  /*! \brief The upper bounds of the shapes of the inputs of symbolic shapes, by binding name, -1
+   * for the unbounded dimensions. */
+  std::unordered_map<std::string, std::vector<int64_t>> max_input_shapes_;
+
+  /*! \brief Whether to build an engine with an optimization profile per range of input shapes,
+   * in the explicit batch mode when the codegen recorded the max input shapes. Each range is
+   * built once, cached on disk with TVM_TENSORRT_CACHE_DIR, and selected by the input shapes of
+   * the requests. */
+  bool use_shape_profiles_ = false;
 };
 
 runtime::Module TensorRTRuntimeCreate(const String& symbol_name, const String& graph_json,
@@ -522,7 +908,7 @@ runtime::Module TensorRTRuntimeCreate(const String& symbol_name, const String& g
 TVM_REGISTER_GLOBAL("runtime.tensorrt_runtime_create").set_body_typed(TensorRTRuntimeCreate);
 
 TVM_REGISTER_GLOBAL("runtime.module.loadbinary_tensorrt")
-    .set_body_typed(JSONRuntimeBase::LoadFromBinary<TensorRTRuntime>);
+    .set_body_typed(TensorRTRuntime::LoadFromBinary);
 
 }  // namespace contrib
 }  // namespace runtime
@@ -0,0 +1,361 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+/*!
+ * \file topk.cu
+ * \brief The top-k and the top-p of the rows of a batch, for sampling over large vocabularies.
+ *
+ * Rather than sorting the whole rows, the k-th key of a row is found by a radix select, in one
+ * thread block per row. The keys are the values mapped to unsigned integers of the same order,
+ * and each of the 4 passes builds the histogram of a byte of the keys that share the bytes
+ * selected so far. The elements of greater keys and the first ones of the k-th key are then
+ * compacted in the order of the row, and only these k candidates are sorted, by a segmented
+ * radix sort. The top-p runs the same select over the softmax of the row, with histograms of
+ * the probabilities rather than of the counts, so that the nucleus needs no sort at all.
+ *
+ * Both take their outputs as arguments, so they can be called from Relax by call_tir on an
+ * extern function, the integer arguments being passed as tir_vars, or by call_packed in the
+ * destination passing style.
+ */
+
+#include <cub/cub.cuh>
+#include <cuda_fp16.h>
+#include <math_constants.h>
+#include <dlpack/dlpack.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/registry.h>
+
+#include <cfloat>
+#include <string>
+
+#include "../../cuda/cuda_common.h"
+
+namespace tvm {
+namespace contrib {
+
+using namespace runtime;
+
+/*! \brief The threads of the block of a row. */
+constexpr int kTopKBlockSize = 512;
+/*! \brief The bits of the keys selected by a pass of the radix select. */
+constexpr int kRadixBits = 8;
+constexpr int kRadixSize = 1 << kRadixBits;
+
+__device__ inline float ToFloat(float value) { return value; }
+__device__ inline float ToFloat(half value) { return __half2float(value); }
+
+/*!
+ * \brief Map a value to an unsigned key, greater for the values ranked first: the greatest
+ * values in descending order, the smallest in ascending order. NaN is the greatest value.
+ */
+__device__ inline uint32_t RankKey(float value, bool is_ascend) {
+  uint32_t bits = __float_as_uint(value);
+  uint32_t key = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+  return is_ascend ? ~key : key;
+}
+
+/*!
+ * \brief Select the greatest key of a row such that the elements of greater or equal keys
+ * weigh at least `target`, in a block.
+ * \param n The length of the row.
+ * \param target The weight to select.
+ * \param get_key The key of an element.
+ * \param get_weight The weight of an element, 1 to select by rank.
+ * \param remaining Set to the weight needed from the elements of the selected key, after the
+ * ones of greater keys.
+ * \return The selected key.
+ */
+template <typename WeightType, typename FKey, typename FWeight>
+__device__ uint32_t RadixSelect(int64_t n, WeightType target, FKey get_key, FWeight get_weight,
+                                WeightType* remaining) {
+  __shared__ WeightType hist[kRadixSize];
+  __shared__ uint32_t selected_prefix;
+  __shared__ WeightType selected_remaining;
+  uint32_t prefix = 0;
+  uint32_t mask = 0;
+  WeightType rem = target;
+  for (int shift = 32 - kRadixBits; shift >= 0; shift -= kRadixBits) {
+    for (int d = threadIdx.x; d < kRadixSize; d += blockDim.x) {
+      hist[d] = 0;
+    }
+    __syncthreads();
+    for (int64_t i = threadIdx.x; i < n; i += blockDim.x) {
+      uint32_t key = get_key(i);
+      if ((key & mask) == prefix) {
+        atomicAdd(&hist[(key >> shift) & (kRadixSize - 1)], get_weight(i));
+      }
+    }
+    __syncthreads();
+    if (threadIdx.x == 0) {
+      // The digits are scanned from the greatest, as the keys are ranked.
+      WeightType cum = 0;
+      int d = kRadixSize - 1;
+      for (; d > 0 && cum + hist[d] < rem; --d) {
+        cum += hist[d];
+      }
+      selected_prefix = prefix | (static_cast<uint32_t>(d) << shift);
+      selected_remaining = rem - cum;
+    }
+    __syncthreads();
+    prefix = selected_prefix;
+    rem = selected_remaining;
+    mask |= static_cast<uint32_t>(kRadixSize - 1) << shift;
+  }
+  *remaining = rem;
+  return prefix;
+}
+
+/*!
+ * \brief Compact the keys and the indices of the k ranked first elements of each row, in the
+ * order of the row: the ones of greater keys than the k-th key, then the first ones of the k-th
+ * key.
+ */
+template <typename DataType>
+__global__ void SelectTopKKernel(const DataType* data, int64_t n, int k, bool is_ascend,
+                                 uint32_t* cand_keys, int32_t* cand_indices) {
+  using BlockScan = cub::BlockScan<int, kTopKBlockSize>;
+  __shared__ typename BlockScan::TempStorage scan_storage;
+  const DataType* row = data + blockIdx.x * n;
+  auto get_key = [&](int64_t i) { return RankKey(ToFloat(row[i]), is_ascend); };
+  int num_equal = 0;
+  uint32_t kth_key = RadixSelect<int>(n, k, get_key, [](int64_t) { return 1; }, &num_equal);
+
+  uint32_t* out_keys = cand_keys + static_cast<int64_t>(blockIdx.x) * k;
+  int32_t* out_indices = cand_indices + static_cast<int64_t>(blockIdx.x) * k;
+  int num_greater = k - num_equal;
+  int greater_base = 0;
+  int equal_base = 0;
+  for (int64_t start = 0; start < n; start += kTopKBlockSize) {
+    int64_t i = start + threadIdx.x;
+    uint32_t key = i < n ? get_key(i) : 0;
+    int is_greater = i < n && key > kth_key;
+    int is_equal = i < n && key == kth_key;
+    int greater_pos, greater_count, equal_pos, equal_count;
+    BlockScan(scan_storage).ExclusiveSum(is_greater, greater_pos, greater_count);
+    __syncthreads();
+    BlockScan(scan_storage).ExclusiveSum(is_equal, equal_pos, equal_count);
+    __syncthreads();
+    if (is_greater) {
+      out_keys[greater_base + greater_pos] = key;
+      out_indices[greater_base + greater_pos] = static_cast<int32_t>(i);
+    } else if (is_equal && equal_base + equal_pos < num_equal) {
+      out_keys[num_greater + equal_base + equal_pos] = key;
+      out_indices[num_greater + equal_base + equal_pos] = static_cast<int32_t>(i);
+    }
+    greater_base += greater_count;
+    equal_base += equal_count;
+  }
+}
+
+__global__ void SegmentOffsetsKernel(int num_segments, int segment_size, int* offsets) {
+  int i = blockIdx.x * blockDim.x + threadIdx.x;
+  if (i <= num_segments) offsets[i] = i * segment_size;
+}
+
+template <typename DataType, typename IndicesType>
+__global__ void GatherTopKKernel(const DataType* data, int64_t n, int k, int64_t size,
+                                 const int32_t* sorted_indices, DataType* values_out,
+                                 IndicesType* indices_out) {
+  int64_t i = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+  if (i >= size) return;
+  int32_t index = sorted_indices[i];
+  values_out[i] = data[(i / k) * n + index];
+  indices_out[i] = static_cast<IndicesType>(index);
+}
+
+// Computes the k ranked first elements along axis -1, sorted, with their indices.
+template <typename DataType, typename IndicesType>
+void radix_topk(DLTensor* input, DLTensor* values_out, DLTensor* indices_out, int k,
+                bool is_ascend) {
+  int64_t n = input->shape[input->ndim - 1];
+  int64_t num_rows = 1;
+  for (int i = 0; i < input->ndim - 1; ++i) {
+    num_rows *= input->shape[i];
+  }
+  ICHECK_GE(k, 1) << "ValueError: topk needs k >= 1, but got " << k;
+  ICHECK_LE(k, n) << "ValueError: topk needs k <= " << n << ", the length of the last axis";
+  ICHECK_LT(n, int64_t(1) << 31) << "ValueError: topk supports rows of less than 2^31 elements";
+  ICHECK_EQ(values_out->shape[values_out->ndim - 1], k);
+  ICHECK_EQ(indices_out->shape[indices_out->ndim - 1], k);
+  if (num_rows == 0) return;
+
+  Device dev = input->device;
+  DeviceAPI* api = DeviceAPI::Get(dev);
+  cudaStream_t stream = CUDAThreadEntry::ThreadLocal()->stream;
+  int64_t size = num_rows * k;
+  ICHECK_LT(size, int64_t(1) << 31) << "ValueError: topk supports less than 2^31 outputs";
+  auto cand_keys = static_cast<uint32_t*>(api->AllocWorkspace(dev, size * sizeof(uint32_t)));
+  auto cand_indices = static_cast<int32_t*>(api->AllocWorkspace(dev, size * sizeof(int32_t)));
+  auto sorted_keys = static_cast<uint32_t*>(api->AllocWorkspace(dev, size * sizeof(uint32_t)));
+  auto sorted_indices = static_cast<int32_t*>(api->AllocWorkspace(dev, size * sizeof(int32_t)));
+  auto offsets = static_cast<int*>(api->AllocWorkspace(dev, (num_rows + 1) * sizeof(int)));
+
+  const DataType* data = static_cast<const DataType*>(input->data);
+  SelectTopKKernel<<<static_cast<unsigned>(num_rows), kTopKBlockSize, 0, stream>>>(
+      data, n, k, is_ascend, cand_keys, cand_indices);
+  SegmentOffsetsKernel<<<(num_rows + 256) / 256, 256, 0, stream>>>(num_rows, k, offsets);
+  // The keys are ranked in descending order in both orders, and the stable sort keeps the
+  // elements of equal values in the order of the row.
+  size_t temp_bytes = 0;
+  CUDA_CALL(cub::DeviceSegmentedRadixSort::SortPairsDescending(
+      nullptr, temp_bytes, cand_keys, sorted_keys, cand_indices, sorted_indices, size, num_rows,
+      offsets, offsets + 1, 0, 32, stream));
+  void* temp = api->AllocWorkspace(dev, temp_bytes);
+  CUDA_CALL(cub::DeviceSegmentedRadixSort::SortPairsDescending(
+      temp, temp_bytes, cand_keys, sorted_keys, cand_indices, sorted_indices, size, num_rows,
+      offsets, offsets + 1, 0, 32, stream));
+  GatherTopKKernel<<<(size + 255) / 256, 256, 0, stream>>>(
+      data, n, k, size, sorted_indices, static_cast<DataType*>(values_out->data),
+      static_cast<IndicesType*>(indices_out->data));
+  CUDA_CALL(cudaGetLastError());
+
+  api->FreeWorkspace(dev, temp);
+  api->FreeWorkspace(dev, offsets);
+  api->FreeWorkspace(dev, sorted_indices);
+  api->FreeWorkspace(dev, sorted_keys);
+  api->FreeWorkspace(dev, cand_indices);
+  api->FreeWorkspace(dev, cand_keys);
+}
+
+template <typename DataType>
+void radix_topk_common(DLTensor* input, DLTensor* values_out, DLTensor* indices_out, int k,
+                       bool is_ascend, const std::string& out_dtype) {
+  if (out_dtype == "int32") {
+    radix_topk<DataType, int32_t>(input, values_out, indices_out, k, is_ascend);
+  } else if (out_dtype == "int64") {
+    radix_topk<DataType, int64_t>(input, values_out, indices_out, k, is_ascend);
+  } else {
+    LOG(FATAL) << "Unsupported output dtype: " << out_dtype;
+  }
+}
+
+TVM_REGISTER_GLOBAL("tvm.contrib.thrust.radix_topk")
+    .set_body([](TVMArgs args, TVMRetValue* ret) {
+      ICHECK_GE(args.num_args, 5);
+      DLTensor* input = args[0];
+      DLTensor* values_out = args[1];
+      DLTensor* indices_out = args[2];
+      int k = args[3];
+      bool is_ascend = args[4];
+
+      auto data_dtype = DLDataType2String(input->dtype);
+      auto out_dtype = DLDataType2String(indices_out->dtype);
+      if (data_dtype == "float32") {
+        radix_topk_common<float>(input, values_out, indices_out, k, is_ascend, out_dtype);
+      } else if (data_dtype == "float16") {
+        radix_topk_common<half>(input, values_out, indices_out, k, is_ascend, out_dtype);
+      } else {
+        LOG(FATAL) << "Unsupported input dtype: " << data_dtype;
+      }
+    });
+
+/*!
+ * \brief The softmax of each row, restricted to its nucleus: the most probable elements whose
+ * probabilities sum to at least the top_p of the row, renormalized, the others being zero.
+ */
+template <typename DataType>
+__global__ void SoftmaxTopPKernel(const DataType* logits, int64_t n, const float* top_p,
+                                  float* probs_out) {
+  using BlockReduce = cub::BlockReduce<float, kTopKBlockSize>;
+  __shared__ typename BlockReduce::TempStorage reduce_storage;
+  __shared__ float row_max;
+  __shared__ float row_sum;
+  __shared__ float kept_sum;
+  const DataType* row = logits + blockIdx.x * n;
+  float* out = probs_out + blockIdx.x * n;
+
+  float local = -CUDART_INF_F;
+  for (int64_t i = threadIdx.x; i < n; i += blockDim.x) {
+    local = fmaxf(local, ToFloat(row[i]));
+  }
+  float reduced = BlockReduce(reduce_storage).Reduce(local, cub::Max());
+  if (threadIdx.x == 0) row_max = reduced;
+  __syncthreads();
+  local = 0;
+  for (int64_t i = threadIdx.x; i < n; i += blockDim.x) {
+    local += __expf(ToFloat(row[i]) - row_max);
+  }
+  reduced = BlockReduce(reduce_storage).Sum(local);
+  if (threadIdx.x == 0) row_sum = reduced;
+  __syncthreads();
+
+  auto get_key = [&](int64_t i) { return RankKey(ToFloat(row[i]), false); };
+  auto get_prob = [&](int64_t i) { return __expf(ToFloat(row[i]) - row_max) / row_sum; };
+  float p = top_p[blockIdx.x];
+  // The whole row is kept from a top_p of 1, also covering the rounding of the probabilities,
+  // and the most probable element at least.
+  uint32_t min_key = 0;
+  if (p < 1.0f) {
+    float remaining;
+    min_key = RadixSelect<float>(n, fmaxf(p, FLT_MIN), get_key, get_prob, &remaining);
+  }
+  local = 0;
+  for (int64_t i = threadIdx.x; i < n; i += blockDim.x) {
+    if (get_key(i) >= min_key) local += get_prob(i);
+  }
+  reduced = BlockReduce(reduce_storage).Sum(local);
+  if (threadIdx.x == 0) kept_sum = reduced;
+  __syncthreads();
+  for (int64_t i = threadIdx.x; i < n; i += blockDim.x) {
+    out[i] = get_key(i) >= min_key ? get_prob(i) / kept_sum : 0.0f;
+  }
+}
+
+TVM_REGISTER_GLOBAL("tvm.contrib.thrust.softmax_top_p")
+    .set_body([](TVMArgs args, TVMRetValue* ret) {
+      ICHECK_GE(args.num_args, 3);
+      DLTensor* logits = args[0];
+      DLTensor* top_p = args[1];
+      DLTensor* probs_out = args[2];
+
+      int64_t n = logits->shape[logits->ndim - 1];
+      int64_t num_rows = 1;
+      for (int i = 0; i < logits->ndim - 1; ++i) {
+        num_rows *= logits->shape[i];
+      }
+      auto data_dtype = DLDataType2String(logits->dtype);
+      ICHECK_EQ(DLDataType2String(top_p->dtype), "float32")
+          << "ValueError: softmax_top_p needs a float32 top_p";
+      ICHECK_EQ(DLDataType2String(probs_out->dtype), "float32")
+          << "ValueError: softmax_top_p needs a float32 output";
+      int64_t top_p_size = 1;
+      for (int i = 0; i < top_p->ndim; ++i) {
+        top_p_size *= top_p->shape[i];
+      }
+      ICHECK_EQ(top_p_size, num_rows) << "ValueError: softmax_top_p needs a top_p for each row";
+      if (num_rows == 0) return;
+
+      cudaStream_t stream = CUDAThreadEntry::ThreadLocal()->stream;
+      const float* p = static_cast<const float*>(top_p->data);
+      float* out = static_cast<float*>(probs_out->data);
+      if (data_dtype == "float32") {
+        SoftmaxTopPKernel<<<static_cast<unsigned>(num_rows), kTopKBlockSize, 0, stream>>>(
+            static_cast<const float*>(logits->data), n, p, out);
+      } else if (data_dtype == "float16") {
+        SoftmaxTopPKernel<<<static_cast<unsigned>(num_rows), kTopKBlockSize, 0, stream>>>(
+            static_cast<const half*>(logits->data), n, p, out);
+      } else {
+        LOG(FATAL) << "Unsupported input dtype: " << data_dtype;
+      }
+      CUDA_CALL(cudaGetLastError());
+    });
+
+}  // namespace contrib
+}  // namespace tvm
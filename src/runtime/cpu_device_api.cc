@@ -24,15 +24,22 @@
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/runtime/threading_backend.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <vector>
 
 #include "workspace_pool.h"
 
 #ifdef __ANDROID__
 #include <android/api-level.h>
 #endif
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 namespace tvm {
 namespace runtime {
@@ -46,6 +53,17 @@ class CPUDeviceAPI final : public DeviceAPI {
   }
   void* AllocDataSpace(Device dev, size_t nbytes, size_t alignment, DLDataType type_hint) final {
     void* ptr;
+#if defined(__linux__) && !defined(__ANDROID__) && defined(SYS_mbind)
+    int node = threading::PreferredNumaNode();
+    size_t page_size = sysconf(_SC_PAGESIZE);
+    if (node >= 0 && nbytes >= page_size) {
+      // Start at a page to place the pages only held by the allocation.
+      int ret = posix_memalign(&ptr, std::max(alignment, page_size), nbytes);
+      if (ret != 0) throw std::bad_alloc();
+      PlaceOnNumaNode(ptr, nbytes / page_size * page_size, node);
+      return ptr;
+    }
+#endif
 #if _MSC_VER
     ptr = _aligned_malloc(nbytes, alignment);
     if (ptr == nullptr) throw std::bad_alloc();
@@ -81,6 +99,23 @@ class CPUDeviceAPI final : public DeviceAPI {
   }
 
  protected:
+#if defined(__linux__) && !defined(__ANDROID__) && defined(SYS_mbind)
+  /*!
+   * \brief Prefer a NUMA node for the pages of a range, moving those already touched.
+   * \note The constants are the ones of numaif.h, which comes with libnuma rather than the libc.
+   */
+  static void PlaceOnNumaNode(void* ptr, size_t nbytes, int node) {
+    constexpr int kMPolPreferred = 1;
+    constexpr unsigned kMPolMFMove = 1 << 1;
+    constexpr size_t kBitsPerWord = 8 * sizeof(unsigned long);  // NOLINT(runtime/int)
+    std::vector<unsigned long> mask(node / kBitsPerWord + 1, 0);  // NOLINT(runtime/int)
+    mask[node / kBitsPerWord] |= 1UL << (node % kBitsPerWord);
+    // The placement is a hint, the allocation stays valid when it is not supported.
+    syscall(SYS_mbind, ptr, nbytes, kMPolPreferred, mask.data(), mask.size() * kBitsPerWord + 1,
+            kMPolMFMove);
+  }
+#endif
+
   void CopyDataFromTo(const void* from, size_t from_offset, void* to, size_t to_offset, size_t size,
                       Device dev_from, Device dev_to, DLDataType type_hint,
                       TVMStreamHandle stream) final {
@@ -104,5 +139,10 @@ TVM_REGISTER_GLOBAL("device_api.cpu").set_body([](TVMArgs args, TVMRetValue* rv)
   DeviceAPI* ptr = CPUDeviceAPI::Global();
   *rv = static_cast<void*>(ptr);
 });
+
+TVM_REGISTER_GLOBAL("device_api.cpu.workspace_pool").set_body([](TVMArgs args, TVMRetValue* rv) {
+  WorkspacePool* pool = dmlc::ThreadLocalStore<CPUWorkspacePool>::Get();
+  *rv = static_cast<void*>(pool);
+});
 }  // namespace runtime
 }  // namespace tvm
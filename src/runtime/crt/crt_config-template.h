@@ -60,4 +60,7 @@
 /*! \brief Enable checks to enforce the stack allocator with a FIFO ordering. Off by default */
 // #define TVM_CRT_STACK_ALLOCATOR_ENABLE_FIFO_CHECK
 
+/*! \brief The linker section TVM_CRT_DEFINE_STATIC_ARENA places the arena in. */
+// #define TVM_CRT_STATIC_ARENA_SECTION ".tvm_arena"
+
 #endif  // TVM_RUNTIME_CRT_CRT_CONFIG_TEMPLATE_H_
@@ -389,11 +389,16 @@ int JSONReader_ArrayLength(JSONReader* reader, size_t* num_elements) {
   int old_scope_counter_back = *reader->scope_counter_->back(reader->scope_counter_);
 
   typedef enum { kObject, kArray } item_type_t;
-  Seq* scopes;
-  tvm_crt_error_t err = SeqCreate(10, &scopes);
-  if (err != kTvmErrorNoError) {
-    return -1;
-  }
+  // The scopes live on the stack, as the arrays are measured throughout the loading.
+  uint32_t scopes_data[10];
+  Seq scopes_seq;
+  memset(&scopes_seq, 0, sizeof(Seq));
+  scopes_seq.data = scopes_data;
+  scopes_seq.allocated = sizeof(scopes_data) / sizeof(scopes_data[0]);
+  scopes_seq.push_back = SeqPush;
+  scopes_seq.back = SeqBack;
+  scopes_seq.pop_back = SeqPop;
+  Seq* scopes = &scopes_seq;
   item_type_t json_item_type = kArray;
   *num_elements = 0;
   for (;;) {
@@ -441,11 +446,6 @@ int JSONReader_ArrayLength(JSONReader* reader, size_t* num_elements) {
   reader->line_count_n_ = old_line_count_n_;
   reader->scope_counter_->push_back(reader->scope_counter_, old_scope_counter_back);
 
-  err = SeqRelease(scopes);
-  if (err != kTvmErrorNoError) {
-    return -1;
-  }
-
   return status;
 }
 
@@ -0,0 +1,167 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+// LINT_C_FILE
+
+/*!
+ * \file arena_allocator.c
+ * \brief Memory manager serving the CRT from one static arena, without any heap usage.
+ */
+
+#include <string.h>
+#include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/crt/arena_allocator.h>
+#include <tvm/runtime/crt/error_codes.h>
+
+/*!
+ * \brief The header placed before each allocation made after the arena is sealed, so that a
+ *  release knows the extent of the block and whether it is the last one.
+ */
+typedef struct ArenaBlock {
+  /*! \brief The block allocated before this one after the seal, NULL for the first one. */
+  struct ArenaBlock* prev;
+  /*! \brief The bytes of the block, the header included, 0 once it is released. */
+  size_t num_bytes;
+} ArenaBlock;
+
+/*! \brief The bytes of the header of a block, which keeps the allocations aligned. */
+#define ARENA_BLOCK_HEADER_BYTES                                             \
+  ((sizeof(ArenaBlock) + TVM_RUNTIME_ALLOC_ALIGNMENT_BYTES - 1) &            \
+   ~((size_t)TVM_RUNTIME_ALLOC_ALIGNMENT_BYTES - 1))
+
+typedef struct ArenaMemoryManager {
+  /*! \brief The interface, first so the manager can be cast from it. */
+  MemoryManagerInterface interface;
+  /*! \brief The first byte allocations are served from. */
+  uint8_t* begin;
+  /*! \brief The byte past the end of the arena. */
+  uint8_t* end;
+  /*! \brief The next allocation. */
+  uint8_t* next_alloc;
+  /*! \brief The end of the sealed allocations, NULL while the arena is not sealed. */
+  uint8_t* sealed_end;
+  /*! \brief The last block allocated after the seal, NULL when there is none. */
+  ArenaBlock* last_block;
+  /*! \brief The most bytes in use. */
+  size_t peak_bytes;
+} ArenaMemoryManager;
+
+static uint8_t* AlignUp(uint8_t* ptr) {
+  uintptr_t mask = TVM_RUNTIME_ALLOC_ALIGNMENT_BYTES - 1;
+  return (uint8_t*)(((uintptr_t)ptr + mask) & ~mask);
+}
+
+static tvm_crt_error_t ArenaMemoryManager_Allocate(MemoryManagerInterface* interface,
+                                                   size_t num_bytes, DLDevice dev,
+                                                   void** out_ptr) {
+  ArenaMemoryManager* mgr = (ArenaMemoryManager*)interface;
+  // An empty allocation gets no memory, so that it cannot alias the next allocation.
+  if (num_bytes == 0) {
+    *out_ptr = NULL;
+    return kTvmErrorNoError;
+  }
+  size_t header_bytes = mgr->sealed_end != NULL ? ARENA_BLOCK_HEADER_BYTES : 0;
+  size_t rounded_bytes = (num_bytes + TVM_RUNTIME_ALLOC_ALIGNMENT_BYTES - 1) &
+                         ~((size_t)TVM_RUNTIME_ALLOC_ALIGNMENT_BYTES - 1);
+  size_t block_bytes = rounded_bytes + header_bytes;
+  if (rounded_bytes < num_bytes || block_bytes < rounded_bytes ||
+      block_bytes > (size_t)(mgr->end - mgr->next_alloc)) {
+    return kTvmErrorPlatformNoMemory;
+  }
+  if (mgr->sealed_end != NULL) {
+    ArenaBlock* block = (ArenaBlock*)mgr->next_alloc;
+    block->prev = mgr->last_block;
+    block->num_bytes = block_bytes;
+    mgr->last_block = block;
+  }
+  *out_ptr = mgr->next_alloc + header_bytes;
+  mgr->next_alloc += block_bytes;
+  size_t used_bytes = mgr->next_alloc - mgr->begin;
+  if (used_bytes > mgr->peak_bytes) {
+    mgr->peak_bytes = used_bytes;
+  }
+  interface->vleak_size++;
+  return kTvmErrorNoError;
+}
+
+static tvm_crt_error_t ArenaMemoryManager_Free(MemoryManagerInterface* interface, void* ptr,
+                                               DLDevice dev) {
+  ArenaMemoryManager* mgr = (ArenaMemoryManager*)interface;
+  uint8_t* data = (uint8_t*)ptr;
+  if (data == NULL) {
+    return kTvmErrorNoError;
+  }
+  if (data < mgr->begin || data >= mgr->next_alloc) {
+    return kTvmErrorPlatformCheckFailure;
+  }
+  // The allocations made before the arena is sealed are never reused, so that the layout of
+  // the arena does not depend on the order they are released in.
+  if (mgr->sealed_end != NULL && data >= mgr->sealed_end + ARENA_BLOCK_HEADER_BYTES) {
+    ArenaBlock* block = (ArenaBlock*)(data - ARENA_BLOCK_HEADER_BYTES);
+    if (block->num_bytes == 0) {
+      return kTvmErrorPlatformCheckFailure;
+    }
+    block->num_bytes = 0;
+    // Only the last block gives its memory back, together with the blocks below it released
+    // before it; a block released out of order is reclaimed once the blocks above it are.
+    while (mgr->last_block != NULL && mgr->last_block->num_bytes == 0) {
+      mgr->next_alloc = (uint8_t*)mgr->last_block;
+      mgr->last_block = mgr->last_block->prev;
+    }
+  }
+  interface->vleak_size--;
+  return kTvmErrorNoError;
+}
+
+tvm_crt_error_t ArenaMemoryManagerCreate(MemoryManagerInterface** interface, uint8_t* arena,
+                                         size_t arena_size_bytes) {
+  uint8_t* aligned = AlignUp(arena);
+  uint8_t* begin = AlignUp(aligned + sizeof(ArenaMemoryManager));
+  if (begin > arena + arena_size_bytes) {
+    return kTvmErrorPlatformNoMemory;
+  }
+  ArenaMemoryManager* mgr = (ArenaMemoryManager*)aligned;
+  memset(mgr, 0, sizeof(ArenaMemoryManager));
+  mgr->interface.Allocate = ArenaMemoryManager_Allocate;
+  mgr->interface.Free = ArenaMemoryManager_Free;
+  mgr->begin = begin;
+  mgr->end = arena + arena_size_bytes;
+  mgr->next_alloc = begin;
+  mgr->sealed_end = NULL;
+  mgr->last_block = NULL;
+  mgr->peak_bytes = 0;
+  *interface = &mgr->interface;
+  return kTvmErrorNoError;
+}
+
+tvm_crt_error_t ArenaMemoryManager_Seal(MemoryManagerInterface* interface) {
+  ArenaMemoryManager* mgr = (ArenaMemoryManager*)interface;
+  mgr->sealed_end = mgr->next_alloc;
+  mgr->last_block = NULL;
+  return kTvmErrorNoError;
+}
+
+tvm_crt_error_t ArenaMemoryManager_GetUsage(MemoryManagerInterface* interface,
+                                            size_t* sealed_bytes, size_t* peak_bytes) {
+  ArenaMemoryManager* mgr = (ArenaMemoryManager*)interface;
+  uint8_t* sealed_end = mgr->sealed_end != NULL ? mgr->sealed_end : mgr->next_alloc;
+  *sealed_bytes = sealed_end - mgr->begin;
+  *peak_bytes = mgr->peak_bytes;
+  return kTvmErrorNoError;
+}
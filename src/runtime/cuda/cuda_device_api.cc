@@ -28,13 +28,146 @@
 #include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <limits>
+#include <unordered_map>
 
 #include "cuda_common.h"
 
 namespace tvm {
 namespace runtime {
 
+/*!
+ * \brief The page-locked buffers of a thread staging its copies between the pageable host memory
+ * and a GPU. The copy is split into chunks, so that the host fills or drains a buffer while the
+ * DMA engine copies from or to the other at the bandwidth of the page-locked memory.
+ */
+class PinnedStagingBuffers {
+ public:
+  /*! \brief The size of each buffer, 0 disables the staging. */
+  static std::atomic<size_t>& ChunkBytes() {
+    static std::atomic<size_t> chunk_bytes{4 << 20};
+    return chunk_bytes;
+  }
+
+  /*! \brief The minimum size of the copies to stage, smaller ones are left to the driver. */
+  static std::atomic<size_t>& MinBytes() {
+    static std::atomic<size_t> min_bytes{1 << 20};
+    return min_bytes;
+  }
+
+  /*! \brief The buffers of the calling thread for the copies with a device. */
+  static PinnedStagingBuffers* ThreadLocal(int device_id) {
+    thread_local std::unordered_map<int, PinnedStagingBuffers> buffers;
+    return &buffers[device_id];
+  }
+
+  /*!
+   * \brief Whether a copy of \p size bytes from or to \p host on \p stream is staged.
+   * \note The caller sets the device of the copy first.
+   */
+  static bool ShouldStage(const void* host, size_t size, cudaStream_t stream) {
+    if (ChunkBytes() == 0 || size < MinBytes()) return false;
+    // the host cannot wait for the events recorded on a stream being captured
+    cudaStreamCaptureStatus capture_status;
+    CUDA_CALL(cudaStreamIsCapturing(stream, &capture_status));
+    if (capture_status != cudaStreamCaptureStatusNone) return false;
+#if CUDART_VERSION >= 10000
+    cudaPointerAttributes attr;
+    if (cudaPointerGetAttributes(&attr, host) != cudaSuccess) {
+      // the runtimes before CUDA 11 fail on the memory unknown to CUDA
+      cudaGetLastError();
+      return true;
+    }
+    return attr.type == cudaMemoryTypeUnregistered;
+#else
+    return false;
+#endif
+  }
+
+  /*!
+   * \brief Copy from the host to the device. It returns once \p from has been read, while the
+   * last chunks may still be copied to the device in the order of \p stream.
+   */
+  void CopyToDevice(const void* from, void* to, size_t size, cudaStream_t stream) {
+    Reserve();
+    for (size_t offset = 0, i = 0; offset < size; offset += chunk_bytes_, ++i) {
+      Slot& slot = slots_[i % kNumSlots];
+      // the chunk staged last in the buffer has to be copied out first
+      CUDA_CALL(cudaEventSynchronize(slot.event));
+      size_t n = std::min(chunk_bytes_, size - offset);
+      std::memcpy(slot.data, static_cast<const char*>(from) + offset, n);
+      CUDA_CALL(cudaMemcpyAsync(static_cast<char*>(to) + offset, slot.data, n,
+                                cudaMemcpyHostToDevice, stream));
+      CUDA_CALL(cudaEventRecord(slot.event, stream));
+    }
+  }
+
+  /*! \brief Copy from the device to the host, and wait for the copy. */
+  void CopyToHost(const void* from, void* to, size_t size, cudaStream_t stream) {
+    Reserve();
+    size_t num_chunks = (size + chunk_bytes_ - 1) / chunk_bytes_;
+    auto drain = [&](size_t i) {
+      Slot& slot = slots_[i % kNumSlots];
+      size_t offset = i * chunk_bytes_;
+      CUDA_CALL(cudaEventSynchronize(slot.event));
+      size_t n = std::min(chunk_bytes_, size - offset);
+      std::memcpy(static_cast<char*>(to) + offset, slot.data, n);
+    };
+    for (size_t i = 0; i < num_chunks; ++i) {
+      Slot& slot = slots_[i % kNumSlots];
+      // an upload may still read from the buffer
+      CUDA_CALL(cudaEventSynchronize(slot.event));
+      size_t offset = i * chunk_bytes_;
+      CUDA_CALL(cudaMemcpyAsync(slot.data, static_cast<const char*>(from) + offset,
+                                std::min(chunk_bytes_, size - offset), cudaMemcpyDeviceToHost,
+                                stream));
+      CUDA_CALL(cudaEventRecord(slot.event, stream));
+      if (i > 0) drain(i - 1);
+    }
+    if (num_chunks > 0) drain(num_chunks - 1);
+  }
+
+  ~PinnedStagingBuffers() { Release(); }
+
+ private:
+  /*! \brief A staging buffer, and the event of the last copy from or to it. */
+  struct Slot {
+    void* data{nullptr};
+    cudaEvent_t event{nullptr};
+  };
+  static constexpr size_t kNumSlots = 2;
+
+  /*! \brief Allocate the buffers on the current device, in the configured size. */
+  void Reserve() {
+    size_t chunk_bytes = ChunkBytes();
+    if (chunk_bytes == chunk_bytes_) return;
+    Release();
+    for (Slot& slot : slots_) {
+      CUDA_CALL(cudaMallocHost(&slot.data, chunk_bytes));
+      CUDA_CALL(cudaEventCreateWithFlags(&slot.event, cudaEventDisableTiming));
+    }
+    chunk_bytes_ = chunk_bytes;
+  }
+
+  void Release() {
+    for (Slot& slot : slots_) {
+      if (slot.data == nullptr) continue;
+      CUDA_CALL(cudaEventSynchronize(slot.event));
+      CUDA_CALL(cudaEventDestroy(slot.event));
+      CUDA_CALL(cudaFreeHost(slot.data));
+      slot = Slot();
+    }
+    chunk_bytes_ = 0;
+  }
+
+  Slot slots_[kNumSlots];
+  /*! \brief The size of the allocated buffers. */
+  size_t chunk_bytes_{0};
+};
+
 class CUDADeviceAPI final : public DeviceAPI {
  public:
   void SetDevice(Device dev) final { CUDA_CALL(cudaSetDevice(dev.device_id)); }
@@ -144,6 +277,8 @@ class CUDADeviceAPI final : public DeviceAPI {
     from = static_cast<const char*>(from) + from_offset;
     to = static_cast<char*>(to) + to_offset;
 
+    // page-locked memory is copied by the DMA engine directly
+    bool pinned = dev_from.device_type == kDLCUDAHost || dev_to.device_type == kDLCUDAHost;
     if (dev_from.device_type == kDLCUDAHost) {
       dev_from.device_type = kDLCPU;
     }
@@ -167,10 +302,20 @@ class CUDADeviceAPI final : public DeviceAPI {
       }
     } else if (dev_from.device_type == kDLCUDA && dev_to.device_type == kDLCPU) {
       CUDA_CALL(cudaSetDevice(dev_from.device_id));
-      GPUCopy(from, to, size, cudaMemcpyDeviceToHost, cu_stream);
+      if (!pinned && PinnedStagingBuffers::ShouldStage(to, size, cu_stream)) {
+        auto* staging = PinnedStagingBuffers::ThreadLocal(dev_from.device_id);
+        staging->CopyToHost(from, to, size, cu_stream);
+      } else {
+        GPUCopy(from, to, size, cudaMemcpyDeviceToHost, cu_stream);
+      }
     } else if (dev_from.device_type == kDLCPU && dev_to.device_type == kDLCUDA) {
       CUDA_CALL(cudaSetDevice(dev_to.device_id));
-      GPUCopy(from, to, size, cudaMemcpyHostToDevice, cu_stream);
+      if (!pinned && PinnedStagingBuffers::ShouldStage(from, size, cu_stream)) {
+        auto* staging = PinnedStagingBuffers::ThreadLocal(dev_to.device_id);
+        staging->CopyToDevice(from, to, size, cu_stream);
+      } else {
+        GPUCopy(from, to, size, cudaMemcpyHostToDevice, cu_stream);
+      }
     } else {
       LOG(FATAL) << "expect copy from/to GPU or between GPU";
     }
@@ -184,8 +329,17 @@ class CUDADeviceAPI final : public DeviceAPI {
     return static_cast<TVMStreamHandle>(retval);
   }
 
+  TVMStreamHandle CreateCopyStream(Device dev) final {
+    CUDA_CALL(cudaSetDevice(dev.device_id));
+    cudaStream_t retval;
+    CUDA_CALL(cudaStreamCreateWithFlags(&retval, cudaStreamNonBlocking));
+    return static_cast<TVMStreamHandle>(retval);
+  }
+
   void FreeStream(Device dev, TVMStreamHandle stream) {
     CUDA_CALL(cudaSetDevice(dev.device_id));
+    // the workspace freed on the stream is reused on the others without waiting for it
+    CUDAThreadEntry::ThreadLocal()->pool.ReleaseStream(dev, stream);
     cudaStream_t cu_stream = static_cast<cudaStream_t>(stream);
     CUDA_CALL(cudaStreamDestroy(cu_stream));
   }
@@ -238,7 +392,9 @@ class CUDADeviceAPI final : public DeviceAPI {
 
 typedef dmlc::ThreadLocalStore<CUDAThreadEntry> CUDAThreadStore;
 
-CUDAThreadEntry::CUDAThreadEntry() : pool(kDLCUDA, CUDADeviceAPI::Global()) {}
+CUDAThreadEntry::CUDAThreadEntry()
+    : pool(kDLCUDA, CUDADeviceAPI::Global(),
+           [this]() { return static_cast<TVMStreamHandle>(this->stream); }) {}
 
 CUDAThreadEntry* CUDAThreadEntry::ThreadLocal() { return CUDAThreadStore::Get(); }
 
@@ -247,6 +403,53 @@ TVM_REGISTER_GLOBAL("device_api.cuda").set_body([](TVMArgs args, TVMRetValue* rv
   *rv = static_cast<void*>(ptr);
 });
 
+TVM_REGISTER_GLOBAL("runtime.config_cuda_pinned_staging")
+    .set_body_typed([](int64_t chunk_bytes, int64_t min_bytes) {
+      CHECK_GE(chunk_bytes, 0) << "ValueError: The size of the staging buffers must be positive, "
+                               << "or 0 to disable the staging, but gets " << chunk_bytes;
+      PinnedStagingBuffers::ChunkBytes() = static_cast<size_t>(chunk_bytes);
+      PinnedStagingBuffers::MinBytes() = static_cast<size_t>(std::max<int64_t>(min_bytes, 0));
+    });
+
+#if CUDART_VERSION >= 11020
+// Allocate from the memory pool of the device in the order of the stream of the calling thread,
+// so that growing or trimming the pool does not synchronize the device. See the
+// StreamOrderedAllocator of the Relax VM.
+TVM_REGISTER_GLOBAL("device_api.cuda.alloc_async")
+    .set_body_typed([](Device dev, int64_t nbytes, int64_t alignment) -> void* {
+      ICHECK_EQ(256 % alignment, 0) << "CUDA space is aligned at 256 bytes";
+      CUDA_CALL(cudaSetDevice(dev.device_id));
+      void* ret;
+      CUDA_CALL(cudaMallocAsync(&ret, nbytes, CUDAThreadEntry::ThreadLocal()->stream));
+      return ret;
+    });
+
+TVM_REGISTER_GLOBAL("device_api.cuda.free_async").set_body_typed([](Device dev, void* ptr) {
+  CUDA_CALL(cudaSetDevice(dev.device_id));
+  CUDA_CALL(cudaFreeAsync(ptr, CUDAThreadEntry::ThreadLocal()->stream));
+});
+
+TVM_REGISTER_GLOBAL("runtime.config_cuda_mem_pool")
+    .set_body_typed([](int device_id, int64_t release_threshold) {
+      int supported = 0;
+      CUDA_CALL(cudaDeviceGetAttribute(&supported, cudaDevAttrMemoryPoolsSupported, device_id));
+      CHECK(supported) << "ValueError: The CUDA device " << device_id
+                       << " does not support the stream ordered allocation";
+      cudaMemPool_t pool;
+      CUDA_CALL(cudaDeviceGetDefaultMemPool(&pool, device_id));
+      // the pool keeps up to the threshold of the freed memory at each synchronization, a
+      // negative threshold keeps all of it
+      uint64_t threshold = release_threshold < 0 ? std::numeric_limits<uint64_t>::max()
+                                                 : static_cast<uint64_t>(release_threshold);
+      CUDA_CALL(cudaMemPoolSetAttribute(pool, cudaMemPoolAttrReleaseThreshold, &threshold));
+    });
+#endif  // CUDART_VERSION >= 11020
+
+TVM_REGISTER_GLOBAL("device_api.cuda.workspace_pool").set_body([](TVMArgs args, TVMRetValue* rv) {
+  WorkspacePool* pool = &CUDAThreadEntry::ThreadLocal()->pool;
+  *rv = static_cast<void*>(pool);
+});
+
 TVM_REGISTER_GLOBAL("device_api.cuda_host").set_body([](TVMArgs args, TVMRetValue* rv) {
   DeviceAPI* ptr = CUDADeviceAPI::Global();
   *rv = static_cast<void*>(ptr);
@@ -300,5 +503,35 @@ TVM_DLL String GetCudaFreeMemory() {
 
 TVM_REGISTER_GLOBAL("runtime.GetCudaFreeMemory").set_body_typed(GetCudaFreeMemory);
 
+/*!
+ * \brief Overwrite the L2 cache of the device of the array arguments, or of the current device,
+ *  so that the next kernel reads its arguments from the device memory.
+ */
+static void CUDAFlushL2Cache(TVMArgs args) {
+  Device dev{kDLCUDA, 0};
+  CUDA_CALL(cudaGetDevice(&dev.device_id));
+  for (int i = 0; i < args.size(); ++i) {
+    if (args.type_codes[i] == kTVMDLTensorHandle || args.type_codes[i] == kTVMNDArrayHandle) {
+      dev = args[i].operator DLTensor*()->device;
+      break;
+    }
+  }
+  int l2_bytes = 0;
+  CUDA_CALL(cudaDeviceGetAttribute(&l2_bytes, cudaDevAttrL2CacheSize, dev.device_id));
+  if (l2_bytes <= 0) return;
+  CUDA_CALL(cudaSetDevice(dev.device_id));
+  // twice the cache, as its replacement policy is not strictly least recently used
+  size_t nbytes = 2 * static_cast<size_t>(l2_bytes);
+  // the workspace pool keeps the scratch buffer between the calls
+  WorkspacePool* pool = &CUDAThreadEntry::ThreadLocal()->pool;
+  void* scratch = pool->AllocWorkspace(dev, nbytes);
+  CUDA_CALL(cudaMemsetAsync(scratch, 0, nbytes, CUDAThreadEntry::ThreadLocal()->stream));
+  pool->FreeWorkspace(dev, scratch);
+}
+
+TVM_REGISTER_GLOBAL("cache_flush_cuda_l2").set_body([](TVMArgs args, TVMRetValue* rv) {
+  CUDAFlushL2Cache(args);
+});
+
 }  // namespace runtime
 }  // namespace tvm
@@ -36,6 +36,7 @@
 #include "../meta_data.h"
 #include "../pack_args.h"
 #include "../thread_storage_scope.h"
+#include "../trace.h"
 #include "cuda_common.h"
 
 namespace tvm {
@@ -162,6 +163,7 @@ class CUDAWrappedFunc {
   }
   // invoke the function with void arguments
   void operator()(TVMArgs args, TVMRetValue* rv, void** void_args) const {
+    TVM_TRACE_SCOPE("kernel", func_name_.c_str());
     int device_id;
     CUDA_CALL(cudaGetDevice(&device_id));
     ThreadWorkLoad wl = launch_param_config_.Extract(args);
@@ -28,8 +28,12 @@
 
 #include <chrono>
 #include <cmath>
+#include <limits>
+#include <mutex>
 #include <numeric>
 #include <sstream>
+#include <utility>
+#include <vector>
 
 #include "../../rpc/rpc_session.h"
 #include "../graph_executor.h"
@@ -330,31 +334,9 @@ class GraphExecutorDebug : public GraphExecutor {
     prof.Start();
     for (size_t i = 0; i < op_execs_.size(); ++i) {
       if (op_execs_[i]) {
-        // get argument shapes
-        std::vector<NDArray> shapes;
-        for (const auto& e : nodes_[i].inputs) {
-          uint32_t eid = entry_id(e);
-          shapes.push_back(data_entry_[eid]);
-        }
-        for (uint32_t j = 0; j < nodes_[i].param.num_outputs; ++j) {
-          uint32_t eid = entry_id(i, j);
-          shapes.push_back(data_entry_[eid]);
-        }
-
         uint32_t eid = entry_id(i, 0);
         const Device& dev = data_entry_[eid]->device;
-
-        std::unordered_map<std::string, ObjectRef> metrics;
-        for (auto p : nodes_[i].param.attrs) {
-          if (std::string(p.first).find("layout") != std::string::npos) {
-            metrics[p.first] = p.second;
-          }
-        }
-        if (nodes_[i].param.attrs.find("hash") != nodes_[i].param.attrs.end()) {
-          metrics["Hash"] = Downcast<String>(nodes_[i].param.attrs.at("hash"));
-        }
-        metrics["Argument Shapes"] = profiling::ShapeString(shapes);
-        prof.StartCall(nodes_[i].param.func_name, dev, metrics);
+        prof.StartCall(nodes_[i].param.func_name, dev, NodeMetrics(i));
         op_execs_[i]();
         prof.StopCall();
       }
@@ -363,8 +345,184 @@ class GraphExecutorDebug : public GraphExecutor {
     return prof.Report();
   }
 
+  /*!
+   * \brief Sample the runs of the graph to profile it while serving.
+   *
+   *  Every `interval`-th run times each node with the timer of its device, e.g. the CUDA
+   *  events, while the other runs are left untouched. The timers are only synchronized at the
+   *  next sampled run or when the report is taken, so the sampled run does not wait on the
+   *  device. Changing the interval keeps the collected samples.
+   * \param interval The number of runs per sampled run, 0 disables the sampling.
+   */
+  void SetSamplingInterval(int interval) {
+    CHECK_GE(interval, 0) << "ValueError: The sampling interval must be non-negative, got "
+                          << interval;
+    std::lock_guard<std::mutex> lock(sample_mutex_);
+    sample_interval_ = interval;
+    runs_since_sample_ = 0;
+  }
+
+  /*!
+   * \brief Run the graph, timing each node when the run is sampled. The sampled runs execute the
+   *  nodes sequentially even if the inter-op concurrency is enabled.
+   */
+  void RunSampled() {
+    {
+      std::lock_guard<std::mutex> lock(sample_mutex_);
+      if (sample_interval_ == 0 || ++runs_since_sample_ < sample_interval_) {
+        sample_pending_ = false;
+      } else {
+        runs_since_sample_ = 0;
+        sample_pending_ = true;
+        // The timers of the previous sample have long been stopped.
+        FoldSamples();
+      }
+    }
+    if (!sample_pending_) {
+      GraphExecutor::Run();
+      return;
+    }
+    std::vector<std::pair<size_t, Timer>> timers;
+    timers.reserve(op_execs_.size());
+    {
+      threading::ThreadPoolScope thread_pool(thread_pool_);
+      for (size_t i = 0; i < op_execs_.size(); ++i) {
+        if (op_execs_[i]) timers.emplace_back(i, RunOpHost(i));
+      }
+    }
+    std::lock_guard<std::mutex> lock(sample_mutex_);
+    pending_timers_.push_back(std::move(timers));
+    ++num_sampled_runs_;
+  }
+
+  /*!
+   * \brief Aggregate the samples into a report, which can be taken while the graph is running.
+   *
+   *  There is one call per node, whose duration is the total over the sampled runs and whose
+   *  count is the number of samples, along with the mean, min and max durations.
+   * \param reset Whether to drop the samples once reported.
+   * \return The report.
+   */
+  profiling::Report SampledReport(bool reset) {
+    std::lock_guard<std::mutex> lock(sample_mutex_);
+    FoldSamples();
+    double overall_us = 0;
+    for (const NodeSample& sample : node_samples_) {
+      overall_us += sample.total_us;
+    }
+    std::vector<Map<String, ObjectRef>> calls;
+    std::unordered_map<std::string, double> device_us;
+    for (size_t i = 0; i < node_samples_.size(); ++i) {
+      const NodeSample& sample = node_samples_[i];
+      if (sample.count == 0) continue;
+      std::string dev = profiling::DeviceString(data_entry_[entry_id(i, 0)]->device);
+      device_us[dev] += sample.total_us;
+      std::unordered_map<String, ObjectRef> row;
+      for (const auto& p : NodeMetrics(i)) {
+        row[p.first] = p.second;
+      }
+      row["Name"] = String(nodes_[i].param.func_name);
+      row["Device"] = String(dev);
+      row["Duration (us)"] = ObjectRef(make_object<profiling::DurationNode>(sample.total_us));
+      row["Count"] = ObjectRef(make_object<profiling::CountNode>(sample.count));
+      row["Mean (us)"] =
+          ObjectRef(make_object<profiling::DurationNode>(sample.total_us / sample.count));
+      row["Min (us)"] = ObjectRef(make_object<profiling::DurationNode>(sample.min_us));
+      row["Max (us)"] = ObjectRef(make_object<profiling::DurationNode>(sample.max_us));
+      row["Percent"] = ObjectRef(make_object<profiling::PercentNode>(
+          overall_us > 0 ? sample.total_us / overall_us * 100 : 0));
+      calls.push_back(row);
+    }
+    Map<String, Map<String, ObjectRef>> device_metrics;
+    for (const auto& p : device_us) {
+      ObjectRef duration = ObjectRef(make_object<profiling::DurationNode>(p.second));
+      ObjectRef count = ObjectRef(make_object<profiling::CountNode>(num_sampled_runs_));
+      device_metrics.Set(p.first, {{"Name", String("Total")},
+                                   {"Device", String(p.first)},
+                                   {"Duration (us)", duration},
+                                   {"Count", count}});
+    }
+    Map<String, ObjectRef> configuration = {
+        {"Executor", String("Graph")},
+        {"Sampling Interval", ObjectRef(make_object<profiling::CountNode>(sample_interval_))},
+        {"Sampled Runs", ObjectRef(make_object<profiling::CountNode>(num_sampled_runs_))}};
+    if (reset) {
+      node_samples_.clear();
+      num_sampled_runs_ = 0;
+    }
+    return profiling::Report(calls, device_metrics, configuration);
+  }
+
  private:
+  /*! \brief The aggregated durations of a node over the sampled runs. */
+  struct NodeSample {
+    int64_t count = 0;
+    double total_us = 0;
+    double min_us = std::numeric_limits<double>::infinity();
+    double max_us = 0;
+  };
+
+  /*!
+   * \brief The profiling metrics of a node, its argument shapes, layouts and hash.
+   * \param index The index of the node.
+   */
+  std::unordered_map<std::string, ObjectRef> NodeMetrics(size_t index) {
+    std::vector<NDArray> shapes;
+    for (const auto& e : nodes_[index].inputs) {
+      uint32_t eid = entry_id(e);
+      shapes.push_back(data_entry_[eid]);
+    }
+    for (uint32_t j = 0; j < nodes_[index].param.num_outputs; ++j) {
+      uint32_t eid = entry_id(index, j);
+      shapes.push_back(data_entry_[eid]);
+    }
+
+    std::unordered_map<std::string, ObjectRef> metrics;
+    for (auto p : nodes_[index].param.attrs) {
+      if (std::string(p.first).find("layout") != std::string::npos) {
+        metrics[p.first] = p.second;
+      }
+    }
+    if (nodes_[index].param.attrs.find("hash") != nodes_[index].param.attrs.end()) {
+      metrics["Hash"] = Downcast<String>(nodes_[index].param.attrs.at("hash"));
+    }
+    metrics["Argument Shapes"] = profiling::ShapeString(shapes);
+    return metrics;
+  }
+
+  /*! \brief Synchronize the pending timers into the node samples, under sample_mutex_. */
+  void FoldSamples() {
+    if (node_samples_.size() != op_execs_.size()) {
+      node_samples_.resize(op_execs_.size());
+    }
+    for (auto& timers : pending_timers_) {
+      for (auto& p : timers) {
+        double us = p.second->SyncAndGetElapsedNanos() / 1e3;
+        NodeSample& sample = node_samples_[p.first];
+        sample.count += 1;
+        sample.total_us += us;
+        sample.min_us = std::min(sample.min_us, us);
+        sample.max_us = std::max(sample.max_us, us);
+      }
+    }
+    pending_timers_.clear();
+  }
+
   int last_executed_node_ = -1;
+  /*! \brief Guards the sampling state against the concurrent reports. */
+  std::mutex sample_mutex_;
+  /*! \brief The number of runs per sampled run, 0 when the sampling is disabled. */
+  int sample_interval_ = 0;
+  /*! \brief The runs since the last sampled run. */
+  int runs_since_sample_ = 0;
+  /*! \brief Whether the current run is sampled, only touched by the running thread. */
+  bool sample_pending_ = false;
+  /*! \brief The number of sampled runs aggregated. */
+  int64_t num_sampled_runs_ = 0;
+  /*! \brief The timers of the sampled runs yet to be synchronized, per node index. */
+  std::vector<std::vector<std::pair<size_t, Timer>>> pending_timers_;
+  /*! \brief The aggregated samples per node index. */
+  std::vector<NodeSample> node_samples_;
 };
 
 /*!
@@ -448,6 +606,18 @@ PackedFunc GraphExecutorDebug::GetFunction(const std::string& name,
             return this->Profile({});
           }
         });
+  } else if (name == "run") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->RunSampled(); });
+  } else if (name == "set_sampling_interval") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->SetSamplingInterval(args[0]);
+    });
+  } else if (name == "sampled_report") {
+    return TypedPackedFunc<profiling::Report(bool)>(
+        [sptr_to_self, this](bool reset) { return this->SampledReport(reset); });
+  } else if (name == "sampled_report_rpc") {
+    return TypedPackedFunc<std::string(bool)>(
+        [sptr_to_self, this](bool reset) { return this->SampledReport(reset)->AsJSON(); });
   } else if (name == "profile_rpc") {
     // We cannot return a Report over RPC because TMV RPC mechanism only
     // supports a subset of Object classes. Instead we serialize it on the
@@ -31,12 +31,14 @@
 #include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/serializer.h>
+#include <tvm/runtime/threading_backend.h>
 
 #include <algorithm>
 #include <functional>
 #include <memory>
 #include <numeric>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -59,12 +61,128 @@ constexpr auto Is2DStorage = IsTextureStorage;
  * \brief Run all the operations one by one.
  */
 void GraphExecutor::Run() {
+  if (max_concurrency_ > 1) {
+    this->RunConcurrent();
+    return;
+  }
+  threading::ThreadPoolScope thread_pool(thread_pool_);
   // setup the array and requirements.
   for (size_t i = 0; i < op_execs_.size(); ++i) {
     if (op_execs_[i]) op_execs_[i]();
   }
 }
 
+GraphExecutor::~GraphExecutor() { this->SetMaxConcurrency(1); }
+
+void GraphExecutor::CaptureVulkanGraph() {
+  auto it = std::find_if(devices_.begin(), devices_.end(),
+                         [](const Device& dev) { return dev.device_type == kDLVulkan; });
+  CHECK(it != devices_.end()) << "ValueError: The graph has no Vulkan device to capture on";
+  CHECK_EQ(max_concurrency_, 1) << "ValueError: Cannot capture a Vulkan graph of concurrent "
+                                << "operations, as each thread launches on its own stream";
+  const PackedFunc* f_begin = Registry::Get("runtime.vulkan.graph.begin_capture");
+  const PackedFunc* f_end = Registry::Get("runtime.vulkan.graph.end_capture");
+  CHECK(f_begin != nullptr && f_end != nullptr)
+      << "Vulkan graph capture requires TVM to be built with Vulkan support";
+  vulkan_graph_ = ObjectRef();
+  // warm up, so that the lazy initialization happens outside of the capture
+  this->Run();
+  ObjectRef graph = (*f_begin)(*it);
+  this->Run();
+  (*f_end)(graph);
+  vulkan_graph_ = graph;
+}
+
+void GraphExecutor::RunVulkanGraph() {
+  CHECK(vulkan_graph_.defined()) << "ValueError: No Vulkan graph captured, "
+                                 << "use capture_vulkan_graph first";
+  static const PackedFunc* f_launch = Registry::Get("runtime.vulkan.graph.launch");
+  (*f_launch)(vulkan_graph_);
+}
+
+void GraphExecutor::SetMaxConcurrency(int max_concurrency) {
+  CHECK_GE(max_concurrency, 1) << "ValueError: The max concurrency must be positive, got "
+                               << max_concurrency;
+  {
+    std::lock_guard<std::mutex> lock(inter_op_mutex_);
+    inter_op_stop_ = true;
+  }
+  inter_op_cv_.notify_all();
+  for (std::thread& worker : inter_op_workers_) {
+    worker.join();
+  }
+  inter_op_workers_.clear();
+  inter_op_stop_ = false;
+  max_concurrency_ = max_concurrency;
+  // the calling thread of Run is the last one
+  for (int i = 1; i < max_concurrency; ++i) {
+    inter_op_workers_.emplace_back([this]() { this->InterOpWorkerLoop(); });
+  }
+}
+
+void GraphExecutor::RunConcurrent() {
+  std::unique_lock<std::mutex> lock(inter_op_mutex_);
+  inter_op_num_deps_ = op_num_deps_;
+  inter_op_num_pending_ = 0;
+  inter_op_error_ = nullptr;
+  for (uint32_t nid = 0; nid < op_execs_.size(); ++nid) {
+    if (!op_execs_[nid]) continue;
+    ++inter_op_num_pending_;
+    if (op_num_deps_[nid] == 0) inter_op_ready_.push_back(nid);
+  }
+  inter_op_cv_.notify_all();
+  while (inter_op_num_pending_ != 0 && !(inter_op_error_ && inter_op_num_running_ == 0)) {
+    if (inter_op_ready_.empty()) {
+      inter_op_cv_.wait(lock);
+    } else {
+      this->RunReadyOps(&lock);
+    }
+  }
+  if (inter_op_error_) {
+    std::exception_ptr error = inter_op_error_;
+    inter_op_error_ = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+
+void GraphExecutor::InterOpWorkerLoop() {
+  std::unique_lock<std::mutex> lock(inter_op_mutex_);
+  while (true) {
+    inter_op_cv_.wait(lock, [this]() { return inter_op_stop_ || !inter_op_ready_.empty(); });
+    if (inter_op_stop_) return;
+    this->RunReadyOps(&lock);
+  }
+}
+
+void GraphExecutor::RunReadyOps(std::unique_lock<std::mutex>* lock) {
+  threading::ThreadPoolScope thread_pool(thread_pool_);
+  while (!inter_op_ready_.empty()) {
+    uint32_t nid = inter_op_ready_.back();
+    inter_op_ready_.pop_back();
+    ++inter_op_num_running_;
+    lock->unlock();
+    std::exception_ptr error;
+    try {
+      op_execs_[nid]();
+    } catch (...) {
+      error = std::current_exception();
+    }
+    lock->lock();
+    --inter_op_num_running_;
+    --inter_op_num_pending_;
+    if (error) {
+      // the operations after a failed one never get ready, the run ends with the running ones
+      if (!inter_op_error_) inter_op_error_ = error;
+      inter_op_ready_.clear();
+    } else if (!inter_op_error_) {
+      for (uint32_t succ : op_successors_[nid]) {
+        if (--inter_op_num_deps_[succ] == 0) inter_op_ready_.push_back(succ);
+      }
+    }
+    inter_op_cv_.notify_all();
+  }
+}
+
 /*!
  * \brief Initialize the graph executor with graph and device.
  * \param graph_json The execution graph.
@@ -73,10 +191,11 @@ void GraphExecutor::Run() {
  * \param devs The devices of the host and devices where graph nodes will be
  * executed on.
  * \param lookup_linked_param_func Linked parameter lookup function. Default is nullptr.
+ * \param shared_params The params shared with other executors, by name.
  */
 void GraphExecutor::Init(const std::string& graph_json, tvm::runtime::Module module,
-                         const std::vector<Device>& devs,
-                         const PackedFunc lookup_linked_param_func) {
+                         const std::vector<Device>& devs, const PackedFunc lookup_linked_param_func,
+                         const std::unordered_map<std::string, NDArray>& shared_params) {
   std::istringstream is(graph_json);
   dmlc::JSONReader reader(&is);
   this->Load(&reader);
@@ -87,7 +206,7 @@ void GraphExecutor::Init(const std::string& graph_json, tvm::runtime::Module mod
     lookup_linked_param_ = PackedFunc(
         [this](TVMArgs args, TVMRetValue* rv) { this->DefaultLookupLinkedParam(args, rv); });
   }
-  this->SetupStorage();
+  this->SetupStorage(shared_params);
   this->SetupOpExecs();
   for (size_t i = 0; i < input_nodes_.size(); i++) {
     const uint32_t nid = input_nodes_[i];
@@ -353,13 +472,32 @@ void GraphExecutor::DefaultLookupLinkedParam(TVMArgs args, TVMRetValue* rv) {
   *rv = NDArray(GetObjectPtr<Object>(container));
 }
 
-void GraphExecutor::SetupStorage() {
+void GraphExecutor::SetupStorage(const std::unordered_map<std::string, NDArray>& shared_params) {
   // Grab saved optimization plan from graph.
   std::vector<DLDataType> vtype;
   for (const std::string& s_type : attrs_.dltype) {
     vtype.push_back(tvm::runtime::String2DLDataType(s_type));
   }
 
+  // The entries of the shared params, and the storages that only they are assigned to, which
+  // are not allocated.
+  std::unordered_map<size_t, NDArray> shared_entries;
+  for (uint32_t nid : input_nodes_) {
+    auto it = shared_params.find(nodes_[nid].name);
+    if (it != shared_params.end()) shared_entries[this->entry_id(nid, 0)] = it->second;
+  }
+  std::unordered_set<int> shared_storages;
+  for (const auto& kv : shared_entries) {
+    shared_storages.insert(attrs_.storage_id[kv.first]);
+  }
+  for (size_t i = 0; i < attrs_.storage_id.size(); ++i) {
+    if (!shared_entries.count(i)) shared_storages.erase(attrs_.storage_id[i]);
+  }
+
+  ICHECK(attrs_.storage_offset.empty() ||
+         attrs_.storage_offset.size() == attrs_.storage_id.size())
+      << "The graph must have one storage offset per entry";
+
   // Size and device type of each storage pool entry.
   std::vector<PoolEntry> pool_entry;
   // Find the maximum space size.
@@ -379,6 +517,7 @@ void GraphExecutor::SetupStorage() {
       ICHECK(pool_entry[sid].device_type == -1 || pool_entry[sid].device_type == device_type)
           << "The same pool entry cannot be assigned to multiple devices";
     }
+    if (shared_storages.count(storage_id)) continue;
     TVMRetValue lookup_rv;
     {
       std::vector<int64_t> shape_vec{attrs_.shape[i].begin(), attrs_.shape[i].end()};
@@ -395,6 +534,7 @@ void GraphExecutor::SetupStorage() {
     pool_entry[sid].scope = storage_scope;
 
     DLDataType t = vtype[i];
+    int64_t offset = attrs_.storage_offset.empty() ? 0 : attrs_.storage_offset[i];
     if (!details::Is2DStorage(storage_scope)) {
       size_t size = 1;
       for (int64_t sz : attrs_.shape[i]) {
@@ -403,9 +543,11 @@ void GraphExecutor::SetupStorage() {
       size_t bits = t.bits * t.lanes;
       ICHECK(bits % 8U == 0U || bits == 1U || bits == 4U);
       int64_t bytes = ((bits + 7U) / 8U) * size;
-      pool_entry[sid].shape[0] = std::max(pool_entry[sid].shape[0], bytes);
+      pool_entry[sid].shape[0] = std::max(pool_entry[sid].shape[0], offset + bytes);
       pool_entry[sid].dtype = DLDataType{kDLFloat, 32, 1};
     } else {
+      CHECK_EQ(offset, 0) << "ValueError: The 2d storage of entry " << i
+                          << " cannot be assigned at an offset";
       if (pool_entry[sid].shape.size() == 1) {
         pool_entry[sid].shape.resize(3, 0);
       }
@@ -426,7 +568,12 @@ void GraphExecutor::SetupStorage() {
   }
 
   // Allocate the space.
-  for (const auto& pit : pool_entry) {
+  for (size_t sid = 0; sid < pool_entry.size(); ++sid) {
+    const PoolEntry& pit = pool_entry[sid];
+    if (shared_storages.count(static_cast<int>(sid))) {
+      storage_pool_.push_back(NDArray());
+      continue;
+    }
     // This for loop is very fast since there are usually only a couple of
     // devices available on the same hardware.
     const auto& cit = std::find_if(devices_.begin(), devices_.end(), [&pit](const Device& d) {
@@ -456,7 +603,17 @@ void GraphExecutor::SetupStorage() {
   for (size_t i = 0; i < data_entry_.size(); ++i) {
     int storage_id = attrs_.storage_id[i];
     ICHECK_LT(static_cast<size_t>(storage_id), storage_pool_.size());
-    data_entry_[i] = storage_pool_[storage_id].CreateView(attrs_.shape[i], vtype[i]);
+    auto it = shared_entries.find(i);
+    if (it != shared_entries.end()) {
+      const NDArray& array = it->second;
+      CHECK(std::vector<int64_t>(array->shape, array->shape + array->ndim) == attrs_.shape[i] &&
+            TypeEqual(array->dtype, vtype[i]))
+          << "ValueError: The shared param of entry " << i << " does not match the graph";
+      data_entry_[i] = array;
+    } else {
+      uint64_t offset = attrs_.storage_offset.empty() ? 0 : attrs_.storage_offset[i];
+      data_entry_[i] = storage_pool_[storage_id].CreateView(attrs_.shape[i], vtype[i], offset);
+    }
 
     const DLTensor* tmp = data_entry_[i].operator->();
     data_alignment_[i] = details::GetDataAlignment(*tmp);
@@ -519,6 +676,43 @@ void GraphExecutor::SetupOpExecs() {
       }
     }
   }
+  this->SetupOpDependencies();
+}
+
+void GraphExecutor::SetupOpDependencies() {
+  op_successors_.assign(this->GetNumOfNodes(), {});
+  op_num_deps_.assign(this->GetNumOfNodes(), 0);
+  auto add_edge = [this](uint32_t from, uint32_t to) {
+    std::vector<uint32_t>& succ = op_successors_[from];
+    if (from == to || std::find(succ.begin(), succ.end(), to) != succ.end()) return;
+    succ.push_back(to);
+    ++op_num_deps_[to];
+  };
+  // The storages are reused by the entries of disjoint lifetimes in the topological order,
+  // an operation therefore runs after the last one writing a storage it reads or writes, and
+  // after the ones reading a storage it writes since then.
+  std::unordered_map<int, uint32_t> last_writer;
+  std::unordered_map<int, std::vector<uint32_t>> readers;
+  for (uint32_t nid = 0; nid < this->GetNumOfNodes(); ++nid) {
+    if (!op_execs_[nid]) continue;
+    const auto& inode = nodes_[nid];
+    for (const auto& e : inode.inputs) {
+      int sid = attrs_.storage_id[this->entry_id(e)];
+      auto it = last_writer.find(sid);
+      if (it != last_writer.end()) add_edge(it->second, nid);
+      readers[sid].push_back(nid);
+    }
+    for (uint32_t index = 0; index < inode.param.num_outputs; ++index) {
+      int sid = attrs_.storage_id[this->entry_id(nid, index)];
+      auto it = last_writer.find(sid);
+      if (it != last_writer.end()) add_edge(it->second, nid);
+      for (uint32_t reader : readers[sid]) {
+        add_edge(reader, nid);
+      }
+      readers[sid].clear();
+      last_writer[sid] = nid;
+    }
+  }
 }
 
 std::pair<std::function<void()>, std::shared_ptr<GraphExecutor::OpArgs>> GraphExecutor::CreateTVMOp(
@@ -532,6 +726,12 @@ std::pair<std::function<void()>, std::shared_ptr<GraphExecutor::OpArgs>> GraphEx
   for (size_t i = 0; i < arg_ptr->args.size(); ++i) {
     TVMValue v;
     DLTensor* t = &arg_ptr->args[i];
+    // The kernels expect the offset of an entry within its storage in the data pointer, as for
+    // the external tensors of SetInputZeroCopy.
+    if (t->byte_offset != 0) {
+      t->data = static_cast<char*>(t->data) + t->byte_offset;
+      t->byte_offset = 0;
+    }
     v.v_handle = t;
     arg_ptr->arg_values.push_back(v);
     arg_ptr->arg_tcodes.push_back(kTVMDLTensorHandle);
@@ -629,6 +829,20 @@ PackedFunc GraphExecutor::GetFunction(const std::string& name,
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->NumInputs(); });
   } else if (name == "run") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->Run(); });
+  } else if (name == "set_thread_pool") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->thread_pool_ = args[0].operator std::string();
+    });
+  } else if (name == "set_max_concurrency") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->SetMaxConcurrency(args[0]);
+    });
+  } else if (name == "capture_vulkan_graph") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->CaptureVulkanGraph(); });
+  } else if (name == "run_vulkan_graph") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->RunVulkanGraph(); });
   } else if (name == "run_from_inputs") {
     return PackedFunc(
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
@@ -31,8 +31,12 @@
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/packed_func.h>
 
+#include <condition_variable>
+#include <exception>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
 #include <unordered_set>
@@ -89,6 +93,31 @@ class TVM_DLL GraphExecutor : public ModuleNode {
   const char* type_key() const final { return "GraphExecutor"; }
   void Run();
 
+  ~GraphExecutor();
+
+  /*!
+   * \brief Set the maximum number of operations Run runs concurrently.
+   *
+   *  With more than one, the operations are dispatched onto max_concurrency - 1 worker threads
+   *  and the calling thread as soon as the operations they depend on, by their data or by the
+   *  storage they reuse, are done.
+   * \param max_concurrency The maximum number of concurrent operations, 1 to run them in order.
+   */
+  void SetMaxConcurrency(int max_concurrency);
+
+  /*!
+   * \brief Record the kernels launched by Run on the Vulkan device into a command graph.
+   *
+   *  The graph is run once before being captured, so that the pipelines are created outside of
+   *  the capture. RunVulkanGraph then replays the kernels with a single queue submission, on
+   *  the inputs copied in by set_input. Only graphs whose operators all run on the Vulkan
+   *  device, one at a time, can be captured.
+   */
+  void CaptureVulkanGraph();
+
+  /*! \brief Replay the command graph recorded by CaptureVulkanGraph. */
+  void RunVulkanGraph();
+
   /*!
    * \brief Initialize the graph executor with graph and device.
    * \param graph_json The execution graph.
@@ -99,10 +128,14 @@ class TVM_DLL GraphExecutor : public ModuleNode {
    * \param lookup_linked_param_func If given, a PackedFunc invoked to lookup linked parameters
    *  by storage_id. If not given, linked parameters are looked-up using an internal implementation,
    *  which is not compatible with RPCModules. Default is nullptr.
+   * \param shared_params The params shared with other executors, by name. Their storage is not
+   *  allocated, their entries are the given arrays, which must be on the devices of the entries
+   *  and must not be modified, e.g. by set_input, while they are shared.
    */
 
   void Init(const std::string& graph_json, tvm::runtime::Module module,
-            const std::vector<Device>& devs, const PackedFunc lookup_linked_param_func = nullptr);
+            const std::vector<Device>& devs, const PackedFunc lookup_linked_param_func = nullptr,
+            const std::unordered_map<std::string, NDArray>& shared_params = {});
 
   /*!
    * \brief Get the input index given the name of input.
@@ -303,6 +336,7 @@ class TVM_DLL GraphExecutor : public ModuleNode {
   struct GraphAttr {
     size_t storage_num_not_alloctaed{0};
     std::vector<int> storage_id;
+    std::vector<int64_t> storage_offset;
     std::vector<int> device_index;
     std::vector<std::string> dltype;
     std::vector<std::string> storage_scope;
@@ -331,6 +365,14 @@ class TVM_DLL GraphExecutor : public ModuleNode {
           reader->Read(&storage_id);
           ICHECK(!reader->NextArrayItem());
           bitmask |= 2;
+        } else if (key == "storage_offset") {
+          reader->BeginArray();
+          ICHECK(reader->NextArrayItem());
+          reader->Read(&type);
+          ICHECK_EQ(type, "list_int");
+          ICHECK(reader->NextArrayItem());
+          reader->Read(&storage_offset);
+          ICHECK(!reader->NextArrayItem());
         } else if (key == "storage_scope") {
           reader->BeginArray();
           ICHECK(reader->NextArrayItem());
@@ -411,8 +453,11 @@ class TVM_DLL GraphExecutor : public ModuleNode {
   void DefaultLookupLinkedParam(TVMArgs args, TVMRetValue* rv);
   /*! \brief Delete NDArray::Container with linked (i.e. static) data. */
   static void LinkedNDArrayDeleter(Object* container);
-  /*! \brief Setup the temporal storage */
-  void SetupStorage();
+  /*!
+   * \brief Setup the temporal storage
+   * \param shared_params The params whose entries are not allocated, see Init.
+   */
+  void SetupStorage(const std::unordered_map<std::string, NDArray>& shared_params = {});
   /*! \brief Setup the executors. */
   void SetupOpExecs();
   /*!
@@ -429,6 +474,17 @@ class TVM_DLL GraphExecutor : public ModuleNode {
    */
   std::pair<std::function<void()>, std::shared_ptr<OpArgs>> CreateTVMOp(
       const TVMOpParam& attrs, const std::vector<DLTensor>& args);
+  /*! \brief Compute the operations each operation must run after, see op_successors_. */
+  void SetupOpDependencies();
+  /*! \brief Run the operations concurrently, as their dependencies are done. */
+  void RunConcurrent();
+  /*! \brief The loop of the inter-op worker threads. */
+  void InterOpWorkerLoop();
+  /*!
+   * \brief Run the ready operations until there is none.
+   * \param lock The held lock of inter_op_mutex_, released while an operation runs.
+   */
+  void RunReadyOps(std::unique_lock<std::mutex>* lock);
   // Get node entry index.
   uint32_t entry_id(uint32_t nid, uint32_t index) const { return node_row_ptr_[nid] + index; }
   // Get node entry index.
@@ -469,6 +525,37 @@ class TVM_DLL GraphExecutor : public ModuleNode {
   std::vector<size_t> data_alignment_;
   /*! \brief Operator on each node. */
   std::vector<std::function<void()>> op_execs_;
+  /*! \brief The named thread pool running the parallel kernels, empty for the default pool. */
+  std::string thread_pool_;
+  /*! \brief The maximum number of operations run concurrently by Run. */
+  int max_concurrency_{1};
+  /*! \brief The Vulkan command graph recorded by CaptureVulkanGraph. */
+  ObjectRef vulkan_graph_;
+  /*!
+   * \brief The operations that run after each operation, as they read its outputs, or overwrite
+   *  the storage it reads or writes.
+   */
+  std::vector<std::vector<uint32_t>> op_successors_;
+  /*! \brief The number of operations each operation runs after. */
+  std::vector<uint32_t> op_num_deps_;
+  /*! \brief The inter-op worker threads. */
+  std::vector<std::thread> inter_op_workers_;
+  /*! \brief Guards the inter-op state below. */
+  std::mutex inter_op_mutex_;
+  /*! \brief Notified when operations become ready, the run is done or the workers stop. */
+  std::condition_variable inter_op_cv_;
+  /*! \brief The operations of the current run whose dependencies are done. */
+  std::vector<uint32_t> inter_op_ready_;
+  /*! \brief The remaining dependencies of each operation in the current run. */
+  std::vector<uint32_t> inter_op_num_deps_;
+  /*! \brief The operations of the current run that are not done. */
+  size_t inter_op_num_pending_{0};
+  /*! \brief The operations of the current run that are running. */
+  size_t inter_op_num_running_{0};
+  /*! \brief The first error of the current run, no operation is started after it. */
+  std::exception_ptr inter_op_error_;
+  /*! \brief Whether the worker threads are asked to exit. */
+  bool inter_op_stop_{false};
   /*! \brief Linked parameter lookup function. */
   PackedFunc lookup_linked_param_;
   /*! \brief Module's _lookup_linked_param function, used by DefaultLookupLinkedParam. */
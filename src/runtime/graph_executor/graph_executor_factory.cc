@@ -29,6 +29,7 @@
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
 #include <iterator>
 #include <vector>
 
@@ -93,6 +94,14 @@ PackedFunc GraphExecutorFactory::GetFunction(
       }
       *rv = this->CudaGraphExecutorCreate(devices);
     });
+  } else if (name == "shared_create") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      std::vector<Device> devices;
+      for (int i = 0; i < args.num_args; ++i) {
+        devices.emplace_back(args[i].operator Device());
+      }
+      *rv = this->SharedExecutorCreate(devices);
+    });
   } else {
     return PackedFunc();
   }
@@ -124,6 +133,33 @@ Module GraphExecutorFactory::ExecutorCreate(const std::vector<Device>& devs) {
   return Module(exec);
 }
 
+Module GraphExecutorFactory::SharedExecutorCreate(const std::vector<Device>& devs) {
+  std::unordered_map<std::string, NDArray> params;
+  {
+    std::lock_guard<std::mutex> lock(shared_params_mutex_);
+    auto it = std::find_if(shared_params_.begin(), shared_params_.end(),
+                           [&devs](const auto& entry) {
+                             return std::equal(entry.first.begin(), entry.first.end(),
+                                               devs.begin(), devs.end(), std::equal_to<Device>());
+                           });
+    if (it == shared_params_.end()) {
+      // The params are placed by a first executor, whose activations are released after.
+      Module first = this->ExecutorCreate(devs);
+      GraphExecutor* exec = const_cast<GraphExecutor*>(first.as<GraphExecutor>());
+      std::unordered_map<std::string, NDArray> placed;
+      for (const auto& kv : params_) {
+        int in_idx = exec->GetInputIndex(kv.first);
+        if (in_idx >= 0) placed[kv.first] = exec->GetInput(in_idx);
+      }
+      it = shared_params_.insert(shared_params_.end(), {devs, std::move(placed)});
+    }
+    params = it->second;
+  }
+  auto exec = make_object<GraphExecutor>();
+  exec->Init(this->graph_json_, this->imports_[0], devs, PackedFunc(), params);
+  return Module(exec);
+}
+
 Module GraphExecutorFactory::DebugExecutorCreate(const std::vector<Device>& devs) {
   const PackedFunc* pf = tvm::runtime::Registry::Get("tvm.graph_executor_debug.create");
   ICHECK(pf != nullptr) << "Cannot find function tvm.graph_executor_debug.create in registry. "
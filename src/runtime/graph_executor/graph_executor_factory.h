@@ -32,9 +32,11 @@
 
 #include <algorithm>
 #include <functional>
+#include <mutex>
 #include <numeric>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "./graph_executor.h"
@@ -97,6 +99,16 @@ class TVM_DLL GraphExecutorFactory : public runtime::ModuleNode {
    */
   Module CudaGraphExecutorCreate(const std::vector<Device>& devs);
 
+  /*!
+   * \brief Create an executor sharing the params of the other executors created by this
+   *  function on the same devices. The params are uploaded once per devices, an executor only
+   *  allocates the storage of its activations.
+   * \param devs The device of the host and devices where graph nodes will be
+   *  executed on.
+   * \return created executor module
+   */
+  Module SharedExecutorCreate(const std::vector<Device>& devs);
+
   /*!
    * \brief Set params.
    * \param graph_executor The graph executor we want to set the params into.
@@ -131,6 +143,11 @@ class TVM_DLL GraphExecutorFactory : public runtime::ModuleNode {
   std::unordered_map<std::string, tvm::runtime::NDArray> params_;
   /*! \brief module name */
   std::string module_name_;
+  /*! \brief The params on the devices of the executors created by SharedExecutorCreate. */
+  std::vector<std::pair<std::vector<Device>, std::unordered_map<std::string, NDArray>>>
+      shared_params_;
+  /*! \brief Guards shared_params_, as the executors may be created by several threads. */
+  std::mutex shared_params_mutex_;
 };
 
 }  // namespace runtime
@@ -45,6 +45,10 @@ HexagonDeviceAPI* HexagonDeviceAPI::Global() {
   return inst;
 }
 
+int HexagonDeviceAPI::ParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task) {
+  return Global()->ThreadManager()->ParallelLaunch(flambda, cdata, num_task);
+}
+
 void HexagonDeviceAPI::GetAttr(Device dev, DeviceAttrKind kind, TVMRetValue* rv) {
   if (kind == kExist) {
     *rv = 1;
@@ -21,6 +21,7 @@
 #define TVM_RUNTIME_HEXAGON_HEXAGON_DEVICE_API_H_
 
 #include <tvm/runtime/device_api.h>
+#include <tvm/runtime/threading_backend.h>
 
 #include <map>
 #include <memory>
@@ -64,6 +65,8 @@ class HexagonDeviceAPI final : public DeviceAPI {
 
     CHECK_EQ(runtime_threads, nullptr);
     runtime_threads = std::make_unique<HexagonThreadManager>(threads, stack_size, pipe_size);
+    // the parallel loops of the kernels fan out to the HVX threads of the thread manager
+    threading::SetDeviceParallelLauncher(ParallelLaunch);
 
     CHECK_EQ(runtime_dma, nullptr);
     runtime_dma = std::make_unique<HexagonUserDMA>();
@@ -75,6 +78,7 @@ class HexagonDeviceAPI final : public DeviceAPI {
     runtime_dma.reset();
 
     CHECK(runtime_threads) << "runtime_threads was not created in AcquireResources";
+    threading::SetDeviceParallelLauncher(nullptr);
     runtime_threads.reset();
 
     CHECK(runtime_hexbuffs) << "runtime_hexbuffs was not created in AcquireResources";
@@ -196,6 +200,9 @@ class HexagonDeviceAPI final : public DeviceAPI {
            (DLDeviceType(dev.device_type) == kDLCPU);
   }
 
+  //! \brief The parallel launch of the runtime, on the threads of the thread manager.
+  static int ParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task);
+
   //! \brief Manages RPC HexagonBuffer allocations
   // rpc_hexbuffs is used only in Alloc/FreeRpcBuffer.  It is static because it lives for the
   // lifetime of the static Device API.
@@ -216,7 +223,8 @@ class HexagonDeviceAPI final : public DeviceAPI {
   std::unique_ptr<HexagonThreadManager> runtime_threads;
   const unsigned threads{6};
   const unsigned pipe_size{1000};
-  const unsigned stack_size{0x4000};  // 16KB
+  // 64KB, as the workers of the thread pool, since the threads run the tasks of parallel kernels
+  const unsigned stack_size{0x10000};
 
   //! \brief User DMA manager
   std::unique_ptr<HexagonUserDMA> runtime_dma;
@@ -19,10 +19,27 @@
 
 #include "hexagon_thread_manager.h"
 
+extern "C" {
+#include <qurt_hvx.h>
+}
+
+#include <algorithm>
+
 namespace tvm {
 namespace runtime {
 namespace hexagon {
 
+namespace {
+//! \brief The stride of the barrier counters of the tasks, a cache line as in thread_pool.cc.
+constexpr int kSyncStride = 64 / sizeof(std::atomic<int>);
+
+//! \brief Whether the calling thread runs a task of a parallel launch.
+thread_local bool in_parallel_task = false;
+
+//! \brief The number of HVX contexts in 128B mode, at least 1.
+int NumHvxContexts() { return std::max((qurt_hvx_get_units() >> 8) & 0xFF, 1); }
+}  // namespace
+
 HexagonThreadManager::HexagonThreadManager(unsigned num_threads, unsigned thread_stack_size_bytes,
                                            unsigned thread_pipe_size_words) {
   // Note: could technically manage more software threads than allowable hardware threads, but there
@@ -211,6 +228,69 @@ void HexagonThreadManager::WaitOnThreads() {
   }
 }
 
+int HexagonThreadManager::ParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task) {
+  if (in_parallel_task) {
+    // the threads are busy with the outer launch
+    TVMParallelGroupEnv env{nullptr, 1};
+    return flambda(0, &env, cdata);
+  }
+  // a task per HVX context, one of which may be held by the calling thread
+  int max_tasks = std::min(NumHvxContexts(), static_cast<int>(nthreads_) + 1);
+  if (num_task <= 0 || num_task > max_tasks) num_task = max_tasks;
+
+  std::lock_guard<std::mutex> lock(launch_mutex_);
+  if (qurt_sem_get_val(&start_semaphore_) == 0) {
+    Start();
+  }
+  std::unique_ptr<std::atomic<int>[]> sync_counters(new std::atomic<int>[num_task * kSyncStride]);
+  for (int i = 0; i < num_task; ++i) {
+    sync_counters[i * kSyncStride].store(0, std::memory_order_relaxed);
+  }
+  ParallelLaunchState launch;
+  launch.flambda = flambda;
+  launch.cdata = cdata;
+  launch.env.sync_handle = sync_counters.get();
+  launch.env.num_task = num_task;
+  launch.num_pending.store(num_task - 1);
+  qurt_sem_init_val(&launch.done, 0);
+
+  std::vector<ParallelTask> tasks(num_task);
+  for (int i = 1; i < num_task; ++i) {
+    tasks[i] = {&launch, i};
+    TVMStreamHandle thread = reinterpret_cast<TVMStreamHandle>(i - 1);
+    while (!Dispatch(thread, thread_parallel_task, &tasks[i])) {
+    }
+  }
+  // the task 0 runs with the HVX context the calling thread may already hold
+  in_parallel_task = true;
+  int status = flambda(0, &launch.env, cdata);
+  in_parallel_task = false;
+  if (num_task > 1) {
+    qurt_sem_down(&launch.done);
+  }
+  qurt_sem_destroy(&launch.done);
+  return status != 0 ? status : launch.status.load();
+}
+
+void HexagonThreadManager::thread_parallel_task(void* arg) {
+  ParallelTask* task = static_cast<ParallelTask*>(arg);
+  ParallelLaunchState* launch = task->launch;
+  // the HVX context is only held while the task runs, leaving it to the other users in between
+  bool locked = qurt_hvx_lock(QURT_HVX_MODE_128B) == QURT_EOK;
+  in_parallel_task = true;
+  int status = launch->flambda(task->task_id, &launch->env, launch->cdata);
+  in_parallel_task = false;
+  if (locked) {
+    qurt_hvx_unlock();
+  }
+  if (status != 0) {
+    launch->status.store(status);
+  }
+  if (launch->num_pending.fetch_sub(1) == 1) {
+    qurt_sem_add(&launch->done, 1);
+  }
+}
+
 void HexagonThreadManager::CheckSemaphore(unsigned syncID) {
   if (semaphores_.find(syncID) == semaphores_.end()) {
     semaphores_[syncID] = reinterpret_cast<qurt_sem_t*>(malloc(sizeof(qurt_sem_t)));
@@ -20,11 +20,14 @@
 #ifndef TVM_RUNTIME_HEXAGON_HEXAGON_THREAD_MANAGER_H_
 #define TVM_RUNTIME_HEXAGON_HEXAGON_THREAD_MANAGER_H_
 
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/c_runtime_api.h>
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/packed_func.h>
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -118,6 +121,16 @@ class HexagonThreadManager {
   //! \brief Unblock threads to start execution if `Start` has not already been called; blocking
   //! call to wait until all threads have empty pipes.
   void WaitOnThreads();
+  /*!
+   * \brief Blocking run of the tasks of a parallel lambda, as `TVMBackendParallelLaunch`. The
+   * task 0 runs on the calling thread, the others on the spawned threads, each holding an HVX
+   * context while it runs. The launches of the tasks themselves run inline.
+   * \param flambda The parallel lambda.
+   * \param cdata The closure data of the lambda.
+   * \param num_task The number of tasks, 0 or more than the HVX contexts for one per context.
+   * \returns 0 when all the tasks succeed, the last non-zero status of a task otherwise.
+   */
+  int ParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task);
 
  private:
   struct ThreadContext {
@@ -148,6 +161,28 @@ class HexagonThreadManager {
   //! \brief Void function executed by each thread as `main`.
   static void thread_main(void* context);
 
+  //! \brief The state of a parallel launch shared by its tasks.
+  struct ParallelLaunchState {
+    FTVMParallelLambda flambda;
+    void* cdata;
+    TVMParallelGroupEnv env;
+    //! \brief The tasks dispatched to the threads and not finished yet.
+    std::atomic<int> num_pending{0};
+    //! \brief The last non-zero status of a dispatched task.
+    std::atomic<int> status{0};
+    //! \brief Signaled by the last dispatched task to finish.
+    qurt_sem_t done;
+  };
+
+  //! \brief A task of a parallel launch dispatched to a thread.
+  struct ParallelTask {
+    ParallelLaunchState* launch;
+    int task_id;
+  };
+
+  //! \brief Void function executed by a thread to run a task of a parallel launch.
+  static void thread_parallel_task(void* task);
+
   //! \brief Manages underlying HexagonBuffer allocations.
   HexagonBufferManager hexbuffs_;
 
@@ -177,6 +212,9 @@ class HexagonThreadManager {
   //! \brief Start semaphore created at time of construction; signled by `Start`.
   qurt_sem_t start_semaphore_;
 
+  //! \brief Serializes the parallel launches of several calling threads.
+  std::mutex launch_mutex_;
+
   /*!
    *\brief Encapsulate a void function pointer + arg pointer; sent via pipe to threads to execute.
    */
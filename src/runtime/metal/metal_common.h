@@ -35,6 +35,9 @@
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/packed_func.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -103,28 +106,121 @@ class AutoReleasePoolWrapper {
 
 /*!
  * \brief Structure for error handling in queues
+ *
+ * The kernel launches and the copies are encoded into one pending command buffer, sharing a
+ * compute encoder across the consecutive launches, rather than being committed one by one. The
+ * pending buffer is committed without waiting once it holds max_batched_launches launches,
+ * which can be set by the environment variable TVM_METAL_MAX_BATCHED_LAUNCHES, or on Commit.
+ * Synchronize commits it and waits for the last committed buffer, so that a whole function can
+ * run with a single commit and wait.
  */
 class Stream {
  public:
   explicit Stream(id<MTLDevice> device) : error_happened_(false) {
     queue_ = [device newCommandQueue];
+    if (const char* env = std::getenv("TVM_METAL_MAX_BATCHED_LAUNCHES")) {
+      max_batched_launches_ = std::max(std::atoi(env), 1);
+    }
+  }
+  ~Stream() {
+    // Wait for the completed handlers, which refer to the stream.
+    Synchronize();
+    [queue_ release];
+  }
+  /*!
+   * \brief Encodes a compute command into the pending command buffer.
+   * \param f The function which encodes the command with the shared compute encoder.
+   */
+  template <typename F>
+  void EncodeCompute(F f) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (compute_encoder_ == nil) {
+      compute_encoder_ = [[GetPendingCommandBuffer() computeCommandEncoder] retain];
+    }
+    f(compute_encoder_);
+    if (++num_pending_launches_ >= max_batched_launches_) CommitPending();
+  }
+  /*!
+   * \brief Encodes a blit command into the pending command buffer.
+   * \param f The function which encodes the command with a fresh blit encoder.
+   */
+  template <typename F>
+  void EncodeBlit(F f) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    EndComputeEncoding();
+    id<MTLBlitCommandEncoder> encoder = [GetPendingCommandBuffer() blitCommandEncoder];
+    f(encoder);
+    [encoder endEncoding];
+  }
+  /*! \brief Commits the pending command buffer, without waiting for its completion. */
+  void Commit() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CommitPending();
   }
-  ~Stream() { [queue_ release]; }
-  id<MTLCommandBuffer> GetCommandBuffer() {
-    id<MTLCommandBuffer> cb = [queue_ commandBuffer];
-    [cb addCompletedHandler:^(id<MTLCommandBuffer> buffer) {
-      if (buffer.status == MTLCommandBufferStatusError) SetErrorStatus();
-    }];
-    return cb;
+  /*! \brief Commits the pending command buffer and waits for all the committed ones. */
+  void Synchronize() {
+    id<MTLCommandBuffer> cb = nil;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      CommitPending();
+      cb = last_committed_;
+      last_committed_ = nil;
+    }
+    if (cb != nil) {
+      // The command buffers of a queue complete in the order of their commits.
+      [cb waitUntilCompleted];
+      [cb release];
+    }
+  }
+  /*! \brief Whether some commands are encoded but not yet committed. */
+  bool HasPendingCommands() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_ != nil;
   }
   bool HasErrorHappened() { return error_happened_; }
 
  private:
+  id<MTLCommandBuffer> GetPendingCommandBuffer() {
+    if (pending_ == nil) {
+      pending_ = [[queue_ commandBuffer] retain];
+      [pending_ addCompletedHandler:^(id<MTLCommandBuffer> buffer) {
+        if (buffer.status == MTLCommandBufferStatusError) SetErrorStatus();
+      }];
+    }
+    return pending_;
+  }
+  void EndComputeEncoding() {
+    if (compute_encoder_ == nil) return;
+    [compute_encoder_ endEncoding];
+    [compute_encoder_ release];
+    compute_encoder_ = nil;
+  }
+  void CommitPending() {
+    if (pending_ == nil) return;
+    EndComputeEncoding();
+    [pending_ commit];
+    if (last_committed_ != nil) [last_committed_ release];
+    last_committed_ = pending_;
+    pending_ = nil;
+    num_pending_launches_ = 0;
+  }
   void SetErrorStatus() { error_happened_ = true; }
   // Queue
   id<MTLCommandQueue> queue_;
+  // The command buffer being encoded, nil when there is nothing to commit
+  id<MTLCommandBuffer> pending_{nil};
+  // The compute encoder of the pending command buffer shared by the consecutive launches
+  id<MTLComputeCommandEncoder> compute_encoder_{nil};
+  // The last committed command buffer, nil once it has been waited for
+  id<MTLCommandBuffer> last_committed_{nil};
+  // The number of launches in the pending command buffer
+  int num_pending_launches_{0};
+  // The number of launches after which the pending command buffer is committed
+  int max_batched_launches_{64};
+  // Guards the pending command buffer and its encoder
+  std::mutex mutex_;
   // Check if error happened in one previous run
-  bool error_happened_;
+  std::atomic<bool> error_happened_;
 };
 
 /*!
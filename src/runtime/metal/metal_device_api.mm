@@ -196,6 +196,11 @@ void* MetalWorkspace::AllocDataSpace(Device device, size_t nbytes, size_t alignm
 
 void MetalWorkspace::FreeDataSpace(Device dev, void* ptr) {
   AUTORELEASEPOOL {
+    // the pending commands of the default stream may still use the buffer, commit them as the
+    // unbatched launches were.
+    if (static_cast<size_t>(dev.device_id) < default_streams_.size()) {
+      default_streams_[dev.device_id]->Commit();
+    }
     // MTLBuffer PurgeableState should be set to empty before manual
     // release in order to prevent memory leak
     [(id<MTLBuffer>)ptr setPurgeableState:MTLPurgeableStateEmpty];
@@ -221,35 +226,35 @@ void MetalWorkspace::CopyDataFromTo(const void* from, size_t from_offset, void*
     if (s->HasErrorHappened()) {
       LOG(FATAL) << "Error! Some problems on GPU happaned! Cannot copy data to current stream";
     }
-    id<MTLCommandBuffer> cb = s->GetCommandBuffer();
     int from_dev_type = static_cast<int>(dev_from.device_type);
     int to_dev_type = static_cast<int>(dev_to.device_type);
 
     if (from_dev_type == kDLMetal && to_dev_type == kDLMetal) {
       ICHECK_EQ(dev_from.device_id, dev_to.device_id) << "Metal disallow cross device copy.";
-      id<MTLBlitCommandEncoder> encoder = [cb blitCommandEncoder];
-      [encoder copyFromBuffer:(id<MTLBuffer>)(from)
-                 sourceOffset:from_offset
-                     toBuffer:(id<MTLBuffer>)(to)destinationOffset:to_offset
-                         size:size];
-      [encoder endEncoding];
-      [cb commit];
+      // The copy stays pending behind the kernels of the stream.
+      s->EncodeBlit([&](id<MTLBlitCommandEncoder> encoder) {
+        [encoder copyFromBuffer:(id<MTLBuffer>)(from)
+                   sourceOffset:from_offset
+                       toBuffer:(id<MTLBuffer>)(to)destinationOffset:to_offset
+                           size:size];
+      });
     } else if (from_dev_type == kDLMetal && to_dev_type == kDLCPU) {
       // copy to a local buffer before get into global buffer.
       id<MTLBuffer> from_buf = (id<MTLBuffer>)(from);
       if (from_buf.storageMode != MTLStorageModeShared) {
         id<MTLBuffer> temp = MetalThreadEntry::ThreadLocal()->GetTempBuffer(dev_from, size);
-        id<MTLBlitCommandEncoder> encoder = [cb blitCommandEncoder];
-        [encoder copyFromBuffer:from_buf
-                   sourceOffset:from_offset
-                       toBuffer:temp
-              destinationOffset:0
-                           size:size];
-        [encoder endEncoding];
-        [cb commit];
-        [cb waitUntilCompleted];
+        s->EncodeBlit([&](id<MTLBlitCommandEncoder> encoder) {
+          [encoder copyFromBuffer:from_buf
+                     sourceOffset:from_offset
+                         toBuffer:temp
+                destinationOffset:0
+                             size:size];
+        });
+        s->Synchronize();
         memcpy(static_cast<char*>(to) + to_offset, static_cast<char*>([temp contents]), size);
       } else {
+        // The pending kernels may write the buffer.
+        if (s->HasPendingCommands()) s->Synchronize();
         memcpy(static_cast<char*>(to) + to_offset,
                static_cast<char*>([from_buf contents]) + from_offset, size);
       }
@@ -258,16 +263,18 @@ void MetalWorkspace::CopyDataFromTo(const void* from, size_t from_offset, void*
       if (to_buf.storageMode != MTLStorageModeShared) {
         id<MTLBuffer> temp = MetalThreadEntry::ThreadLocal()->GetTempBuffer(dev_to, size);
         memcpy([temp contents], static_cast<const char*>(from) + from_offset, size);
-        id<MTLBlitCommandEncoder> encoder = [cb blitCommandEncoder];
-        [encoder copyFromBuffer:temp
-                   sourceOffset:0
-                       toBuffer:to_buf
-              destinationOffset:to_offset
-                           size:size];
-        [encoder endEncoding];
-        [cb commit];
-        [cb waitUntilCompleted];
+        s->EncodeBlit([&](id<MTLBlitCommandEncoder> encoder) {
+          [encoder copyFromBuffer:temp
+                     sourceOffset:0
+                         toBuffer:to_buf
+                destinationOffset:to_offset
+                             size:size];
+        });
+        // Keep the temp buffer alive until the copy completes.
+        s->Synchronize();
       } else {
+        // The pending kernels may read the buffer.
+        if (s->HasPendingCommands()) s->Synchronize();
         memcpy(static_cast<char*>([to_buf contents]) + to_offset,
                static_cast<const char*>(from) + from_offset, size);
       }
@@ -296,10 +303,8 @@ void MetalWorkspace::FreeStream(Device dev, TVMStreamHandle stream) {
 void MetalWorkspace::StreamSync(Device dev, TVMStreamHandle stream) {
   AUTORELEASEPOOL {
     Stream* s = CastStreamOrGetCurrent(stream, dev.device_id);
-    // commit an empty command buffer and wait until it completes.
-    id<MTLCommandBuffer> cb = s->GetCommandBuffer();
-    [cb commit];
-    [cb waitUntilCompleted];
+    // commit the pending command buffer and wait until all the committed ones complete.
+    s->Synchronize();
     if (s->HasErrorHappened()) {
       LOG(FATAL) << "Error! Some problems on GPU happaned!";
     }
@@ -27,6 +27,7 @@
 #include <array>
 #include <mutex>
 #include <string>
+#include <vector>
 #include "../file_utils.h"
 #include "../meta_data.h"
 #include "../pack_args.h"
@@ -205,24 +206,31 @@ class MetalWrappedFunc {
       int blockSize = wl.block_dim(0) * wl.block_dim(1) * wl.block_dim(2);
       auto maxTotalThreadsPerThreadgroup = scache_[device_id].maxTotalThreadsPerThreadgroup;
       CHECK_LE(blockSize, maxTotalThreadsPerThreadgroup);
-      id<MTLCommandBuffer> cb = stream->GetCommandBuffer();
-      id<MTLComputeCommandEncoder> encoder = [cb computeCommandEncoder];
-      [encoder setComputePipelineState:scache_[device_id]];
-      for (size_t i = 0; i < num_buffer_args_; ++i) {
-        void* buf = args[static_cast<int>(i)];
-        [encoder setBuffer:(id<MTLBuffer>)(buf) offset:0 atIndex:i];
-      }
-      if (num_pack_args_ != 0) {
-        [encoder setBytes:pack_args
-                   length:num_pack_args_ * sizeof(ArgUnion64)
-                  atIndex:num_buffer_args_];
-      }
-      // launch
-      MTLSize dimGrid = MTLSizeMake(wl.grid_dim(0), wl.grid_dim(1), wl.grid_dim(2));
-      MTLSize dimBlock = MTLSizeMake(wl.block_dim(0), wl.block_dim(1), wl.block_dim(2));
-      [encoder dispatchThreadgroups:dimGrid threadsPerThreadgroup:dimBlock];
-      [encoder endEncoding];
-      [cb commit];
+      id<MTLComputePipelineState> state = scache_[device_id];
+      // The launch is encoded into the pending command buffer of the stream, which is only
+      // committed by a sync or when enough launches are batched.
+      stream->EncodeCompute([&](id<MTLComputeCommandEncoder> encoder) {
+        [encoder setComputePipelineState:state];
+        if (num_buffer_args_ != 0) {
+          std::vector<id<MTLBuffer>> buffers(num_buffer_args_);
+          std::vector<NSUInteger> offsets(num_buffer_args_, 0);
+          for (size_t i = 0; i < num_buffer_args_; ++i) {
+            buffers[i] = (id<MTLBuffer>)(static_cast<void*>(args[static_cast<int>(i)]));
+          }
+          [encoder setBuffers:buffers.data()
+                      offsets:offsets.data()
+                    withRange:NSMakeRange(0, num_buffer_args_)];
+        }
+        if (num_pack_args_ != 0) {
+          [encoder setBytes:pack_args
+                     length:num_pack_args_ * sizeof(ArgUnion64)
+                    atIndex:num_buffer_args_];
+        }
+        // launch
+        MTLSize dimGrid = MTLSizeMake(wl.grid_dim(0), wl.grid_dim(1), wl.grid_dim(2));
+        MTLSize dimBlock = MTLSizeMake(wl.block_dim(0), wl.block_dim(1), wl.block_dim(2));
+        [encoder dispatchThreadgroups:dimGrid threadsPerThreadgroup:dimBlock];
+      });
     };
   }
 
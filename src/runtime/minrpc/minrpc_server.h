@@ -47,6 +47,14 @@
   if (!(cond)) this->ThrowError(RPCServerStatus::kCheckError);
 #endif
 
+#ifndef MINRPC_SEND_BUFFER_BYTES
+/*!
+ * \brief The bytes of the buffer coalescing the small writes of a response,
+ *  so that a response goes out in a few calls of PosixWrite. 0 writes them through.
+ */
+#define MINRPC_SEND_BUFFER_BYTES 256
+#endif
+
 namespace tvm {
 namespace runtime {
 
@@ -76,12 +84,12 @@ class MinRPCReturns : public MinRPCReturnInterface {
 
     uint64_t packet_nbytes = sizeof(code) + sizeof(num_args) + sizeof(tcode);
 
-    io_->MessageStart(packet_nbytes);
+    this->MessageStart(packet_nbytes);
     Write(packet_nbytes);
     Write(code);
     Write(num_args);
     Write(tcode);
-    io_->MessageDone();
+    this->MessageDone();
   }
 
   void ReturnHandle(void* handle) {
@@ -92,13 +100,13 @@ class MinRPCReturns : public MinRPCReturnInterface {
     uint64_t packet_nbytes =
         sizeof(code) + sizeof(num_args) + sizeof(tcode) + sizeof(encode_handle);
 
-    io_->MessageStart(packet_nbytes);
+    this->MessageStart(packet_nbytes);
     Write(packet_nbytes);
     Write(code);
     Write(num_args);
     Write(tcode);
     Write(encode_handle);
-    io_->MessageDone();
+    this->MessageDone();
   }
 
   void ReturnException(const char* msg) { RPCReference::ReturnException(msg, this); }
@@ -111,11 +119,11 @@ class MinRPCReturns : public MinRPCReturnInterface {
     RPCCode code = RPCCode::kCopyAck;
     uint64_t packet_nbytes = sizeof(code) + num_bytes;
 
-    io_->MessageStart(packet_nbytes);
+    this->MessageStart(packet_nbytes);
     Write(packet_nbytes);
     Write(code);
     WriteArray(data_ptr, num_bytes);
-    io_->MessageDone();
+    this->MessageDone();
   }
 
   void ReturnLastTVMError() {
@@ -125,7 +133,10 @@ class MinRPCReturns : public MinRPCReturnInterface {
 
   void MessageStart(uint64_t packet_nbytes) { io_->MessageStart(packet_nbytes); }
 
-  void MessageDone() { io_->MessageDone(); }
+  void MessageDone() {
+    FlushSendBuffer();
+    io_->MessageDone();
+  }
 
   void ThrowError(RPCServerStatus code, RPCCode info = RPCCode::kNone) {
     io_->Exit(static_cast<int>(code));
@@ -147,6 +158,29 @@ class MinRPCReturns : public MinRPCReturnInterface {
 
  private:
   void WriteRawBytes(const void* data, size_t size) {
+#if MINRPC_SEND_BUFFER_BYTES > 0
+    if (send_nbytes_ + size > MINRPC_SEND_BUFFER_BYTES) {
+      FlushSendBuffer();
+    }
+    // large arrays go out directly, after the bytes before them
+    if (size <= MINRPC_SEND_BUFFER_BYTES) {
+      memcpy(send_buffer_ + send_nbytes_, data, size);
+      send_nbytes_ += size;
+      return;
+    }
+#endif
+    WriteThrough(data, size);
+  }
+
+  void FlushSendBuffer() {
+#if MINRPC_SEND_BUFFER_BYTES > 0
+    size_t nbytes = send_nbytes_;
+    send_nbytes_ = 0;
+    WriteThrough(send_buffer_, nbytes);
+#endif
+  }
+
+  void WriteThrough(const void* data, size_t size) {
     const uint8_t* buf = static_cast<const uint8_t*>(data);
     size_t ndone = 0;
     while (ndone < size) {
@@ -160,6 +194,11 @@ class MinRPCReturns : public MinRPCReturnInterface {
   }
 
   TIOHandler* io_;
+#if MINRPC_SEND_BUFFER_BYTES > 0
+  /*! \brief The buffered bytes of the current response. */
+  uint8_t send_buffer_[MINRPC_SEND_BUFFER_BYTES];
+  size_t send_nbytes_{0};
+#endif
 };
 
 /*!
@@ -22,7 +22,9 @@
 
 #include <unistd.h>
 
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
 
 #include "minrpc_server.h"
 
@@ -41,7 +43,20 @@ class PosixIOHandler {
 
   void MessageDone() {}
 
-  ssize_t PosixRead(void* data, size_t size) { return read(read_fd_, data, size); }
+  ssize_t PosixRead(void* data, size_t size) {
+    // read ahead, as the server reads the fields of a packet one at a time
+    if (read_begin_ == read_end_) {
+      if (size >= sizeof(read_buffer_)) return read(read_fd_, data, size);
+      ssize_t ret = read(read_fd_, read_buffer_, sizeof(read_buffer_));
+      if (ret <= 0) return ret;
+      read_begin_ = 0;
+      read_end_ = static_cast<size_t>(ret);
+    }
+    size_t nbytes = std::min(size, read_end_ - read_begin_);
+    memcpy(data, read_buffer_ + read_begin_, nbytes);
+    read_begin_ += nbytes;
+    return static_cast<ssize_t>(nbytes);
+  }
 
   ssize_t PosixWrite(const void* data, size_t size) { return write(write_fd_, data, size); }
 
@@ -55,6 +70,9 @@ class PosixIOHandler {
  private:
   int read_fd_{0};
   int write_fd_{1};
+  char read_buffer_[4096];
+  size_t read_begin_{0};
+  size_t read_end_{0};
 };
 
 /*! \brief Type for the posix version of min rpc server. */
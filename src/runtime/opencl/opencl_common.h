@@ -373,6 +373,9 @@ struct BufferDescriptor {
   cl_mem buffer{nullptr};
   MemoryLayout layout{MemoryLayout::kBuffer1D};
 };
+
+std::string GetPlatformInfo(cl_platform_id pid, cl_platform_info param_name);
+std::string GetDeviceInfo(cl_device_id pid, cl_device_info param_name);
 }  // namespace cl
 
 // Module to support thread-safe multi-device execution.
@@ -411,6 +414,10 @@ class OpenCLModuleNode : public ModuleNode {
                           const std::string& func_name, const KTRefEntry& e);
 
  private:
+  // create the kernel of a built program in the thread local entry, under build_lock_
+  cl_kernel CreateKernel(cl::OpenCLThreadEntry* t, const std::string& func_name,
+                         const KTRefEntry& e);
+
   // The workspace, need to keep reference to use it in destructor.
   // In case of static destruction order problem.
   cl::OpenCLWorkspace* workspace_;
@@ -31,9 +31,6 @@ namespace tvm {
 namespace runtime {
 namespace cl {
 
-std::string GetPlatformInfo(cl_platform_id pid, cl_platform_info param_name);
-std::string GetDeviceInfo(cl_device_id pid, cl_device_info param_name);
-
 struct ImageInfo {
   size_t origin[3] = {};
   size_t region[3] = {};
@@ -23,8 +23,17 @@
 #include "opencl_module.h"
 
 #include <dmlc/memory_io.h>
+#include <dmlc/parameter.h>
 #include <tvm/runtime/registry.h>
 
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iterator>
+#include <mutex>
+#include <random>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -108,6 +117,90 @@ class OpenCLWrappedFunc {
   LaunchParamConfig launch_param_config_;
 };
 
+namespace {
+/*! \brief The directory of the program binary cache, empty to disable the cache. */
+std::string program_cache_dir = dmlc::GetEnv("TVM_OPENCL_CACHE_DIR", std::string());  // NOLINT(*)
+std::mutex program_cache_mutex;
+
+/*!
+ * \brief Get the file caching the binary of a program built from source on a device.
+ * \param key The key of the program, which holds the source and identifies the device and its
+ *  driver, since the binaries are only valid for the driver which built them.
+ * \return The path of the file, empty when the cache is disabled.
+ */
+std::string ProgramCachePath(const std::string& key) {
+  std::lock_guard<std::mutex> lock(program_cache_mutex);
+  if (program_cache_dir.empty()) return "";
+  std::ostringstream os;
+  os << program_cache_dir << "/" << std::hex << std::setw(16) << std::setfill('0')
+     << std::hash<std::string>()(key) << ".clbin";
+  return os.str();
+}
+
+/*!
+ * \brief Create and build a program from the binary cached by SaveProgramBinary.
+ * \return The built program, or null when the file is missing, caches another key whose hash
+ *  collides, or the driver rejects the binary.
+ */
+cl_program LoadProgramBinary(cl::OpenCLWorkspace* w, cl_device_id dev, const std::string& path,
+                             const std::string& key) {
+  std::ifstream is(path, std::ios::in | std::ios::binary);
+  if (!is) return nullptr;
+  std::string blob((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+  dmlc::MemoryStringStream strm(&blob);
+  std::string cached_key, binary;
+  if (!strm.Read(&cached_key) || cached_key != key || !strm.Read(&binary)) return nullptr;
+  const unsigned char* s = reinterpret_cast<const unsigned char*>(binary.data());
+  size_t len = binary.length();
+  cl_int err, status;
+  cl_program program = clCreateProgramWithBinary(w->context, 1, &dev, &len, &s, &status, &err);
+  if (err != CL_SUCCESS || status != CL_SUCCESS) {
+    if (program != nullptr) clReleaseProgram(program);
+    return nullptr;
+  }
+  // binaries still need to be built, which is cheap as they are already compiled
+  if (clBuildProgram(program, 1, &dev, nullptr, nullptr, nullptr) != CL_SUCCESS) {
+    clReleaseProgram(program);
+    return nullptr;
+  }
+  DLOG(INFO) << "loaded the OpenCL program binary from " << path;
+  return program;
+}
+
+/*! \brief Save the binary of a program built on a device for the later processes. */
+void SaveProgramBinary(cl_program program, const std::string& path, const std::string& key) {
+  size_t size;
+  if (clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(size), &size, nullptr) !=
+          CL_SUCCESS ||
+      size == 0) {
+    return;
+  }
+  std::string binary(size, '\0');
+  unsigned char* ptr = reinterpret_cast<unsigned char*>(&binary[0]);
+  if (clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(ptr), &ptr, nullptr) != CL_SUCCESS) {
+    return;
+  }
+  std::string blob;
+  dmlc::MemoryStringStream strm(&blob);
+  strm.Write(key);
+  strm.Write(binary);
+  // write then rename, so that the concurrent processes never read a partial file
+  std::string tmp_path = path + "." + std::to_string(std::random_device()()) + ".tmp";
+  {
+    std::ofstream os(tmp_path, std::ios::out | std::ios::binary);
+    os.write(blob.data(), blob.size());
+    if (!os) {
+      LOG(WARNING) << "Cannot write the OpenCL program cache " << tmp_path;
+      std::remove(tmp_path.c_str());
+      return;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+  }
+}
+}  // namespace
+
 OpenCLModuleNode::~OpenCLModuleNode() {
   {
     // free the kernel ids in global table.
@@ -219,8 +312,20 @@ cl_kernel OpenCLModuleNode::InstallKernel(cl::OpenCLWorkspace* w, cl::OpenCLThre
   std::lock_guard<std::mutex> lock(build_lock_);
   int device_id = t->device.device_id;
   if (programs_[func_name][device_id] == nullptr) {
+    std::string cache_key, cache_path;
     // create program
     if (fmt_ == "cl") {
+      cl_device_id dev = w->devices[device_id];
+      cache_key = w->platform_name + "\n" + cl::GetDeviceInfo(dev, CL_DEVICE_NAME) + "\n" +
+                  cl::GetDeviceInfo(dev, CL_DEVICE_VERSION) + "\n" +
+                  cl::GetDeviceInfo(dev, CL_DRIVER_VERSION) + "\n" + parsed_kernels_[func_name];
+      cache_path = ProgramCachePath(cache_key);
+      if (!cache_path.empty()) {
+        programs_[func_name][device_id] = LoadProgramBinary(w, dev, cache_path, cache_key);
+        if (programs_[func_name][device_id] != nullptr) {
+          return CreateKernel(t, func_name, e);
+        }
+      }
       const char* s = parsed_kernels_[func_name].c_str();
       size_t len = parsed_kernels_[func_name].length();
       cl_int err;
@@ -251,8 +356,16 @@ cl_kernel OpenCLModuleNode::InstallKernel(cl::OpenCLWorkspace* w, cl::OpenCLThre
                             &log[0], nullptr);
       LOG(FATAL) << "OpenCL build error for device=" << dev << "\n" << log;
     }
+    if (!cache_path.empty()) {
+      SaveProgramBinary(programs_[func_name][device_id], cache_path, cache_key);
+    }
   }
-  // build kernel
+  return CreateKernel(t, func_name, e);
+}
+
+cl_kernel OpenCLModuleNode::CreateKernel(cl::OpenCLThreadEntry* t, const std::string& func_name,
+                                         const KTRefEntry& e) {
+  int device_id = t->device.device_id;
   cl_int err;
   cl_kernel kernel = clCreateKernel(programs_[func_name][device_id], func_name.c_str(), &err);
   OPENCL_CHECK_ERROR(err);
@@ -291,6 +404,11 @@ Module OpenCLModuleLoadBinary(void* strm) {
   return OpenCLModuleCreate(data, fmt, fmap, std::string());
 }
 
+TVM_REGISTER_GLOBAL("runtime.opencl.set_program_cache_dir").set_body_typed([](std::string dir) {
+  std::lock_guard<std::mutex> lock(program_cache_mutex);
+  program_cache_dir = dir;
+});
+
 TVM_REGISTER_GLOBAL("runtime.module.loadfile_cl").set_body_typed(OpenCLModuleLoadFile);
 
 TVM_REGISTER_GLOBAL("runtime.module.loadfile_clbin").set_body_typed(OpenCLModuleLoadFile);
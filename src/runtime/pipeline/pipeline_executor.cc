@@ -85,6 +85,9 @@ PackedFunc PipelineExecutor::GetFunction(const std::string& name,
   } else if (name == "get_execute_count") {
     return PackedFunc(
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->GetExecutionCount(); });
+  } else if (name == "get_stage_statistics") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->GetStageStatistics(); });
   } else {
     LOG(FATAL) << "Unknown packed function: " << name;
     return PackedFunc();
@@ -236,6 +239,20 @@ std::pair<int, int> PipelineExecutor::GetInputIndex(const std::string& name) {
  * \brief Getting the count of running pipeline.
  */
 int PipelineExecutor::GetExecutionCount() { return runtimes_.back()->GetExecutionCount(); }
+/*!
+ * \brief Getting the statistics of each stage of the pipeline.
+ */
+std::string PipelineExecutor::GetStageStatistics() {
+  std::ostringstream os;
+  dmlc::JSONWriter writer(&os);
+  writer.BeginArray();
+  for (const auto& runtime : runtimes_) {
+    writer.WriteArraySeperator();
+    runtime->WriteStatistics(&writer);
+  }
+  writer.EndArray();
+  return os.str();
+}
 /*!
  * \brief Initialize the pipeline executor with a list of modules to be pipelined
  *  and config in JSON format.
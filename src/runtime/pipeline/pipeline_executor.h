@@ -99,6 +99,11 @@ class TVM_DLL PipelineExecutor : public ModuleNode {
    * \brief Getting the count of running pipeline.
    */
   int GetExecutionCount();
+  /*!
+   * \brief Getting the statistics of each stage of the pipeline.
+   * \return The statistics in the json form, a list of one object per stage.
+   */
+  std::string GetStageStatistics();
   /*!
    * \brief Use the parameters group name to get the specific backend runtime then use
    *  the param_key_name to set param data for the said backend runtime.
@@ -26,6 +26,7 @@
 #include <tvm/runtime/threading_backend.h>
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <functional>
 #include <limits>
@@ -326,6 +327,7 @@ class ConfigRuntime {
   ConfigRuntime& operator=(const ConfigRuntime& output) {
     output_binding_map_ = output.GetOutBindings();
     cpu_affinity_ = output.GetCPUAffinity();
+    queue_capacity_ = output.GetQueueCapacity();
     return *this;
   }
 
@@ -343,6 +345,13 @@ class ConfigRuntime {
    * \param Returning the cpu affinity in text form.
    */
   std::string GetCPUAffinity() const { return cpu_affinity_; }
+  /*!
+   * \brief Store the capacity of the queues forwarding the outputs.
+   * \param queue_capacity The capacity, 0 for the default one.
+   */
+  void StoreQueueCapacity(int queue_capacity) { queue_capacity_ = queue_capacity; }
+  /*!\brief Getting the capacity of the queues forwarding the outputs.*/
+  int GetQueueCapacity() const { return queue_capacity_; }
   /*!
    * \brief Enumerating the output configuration.
    * \param parse_function The callback function is used to parse the binding configeration.
@@ -414,6 +423,8 @@ class ConfigRuntime {
   std::unordered_map<int, ConfigBindings> output_binding_map_;
   /*!\brief The cpu affinity setting for the tvm thread pool.*/
   std::string cpu_affinity_;
+  /*!\brief The capacity of the queues forwarding the outputs, 0 for the default one.*/
+  int queue_capacity_ = 0;
 };
 
 /*!
@@ -434,6 +445,14 @@ class ConfigPipelineExecution {
     auto config_runtime = config->second;
     return config_runtime.GetCPUAffinity();
   }
+  /*!\brief Get the capacity of the queues forwarding the outputs of a runtime.*/
+  int GetQueueCapacity(int runtime_idx) {
+    auto config = config_.find(runtime_idx);
+    if (config == config_.end()) {
+      LOG(FATAL) << "Do not finding the runtime " << runtime_idx;
+    }
+    return config->second.GetQueueCapacity();
+  }
   /*!
    * \brief Enumerating the binding configuration for a specified runtime.
    * \param parse_function The callback function is used to parse the binding configuration.
@@ -504,6 +523,7 @@ class ConfigPipelineExecution {
       ConfigRuntime output;
       std::string dev;
       std::string cpu_affinity;
+      int queue_capacity = 0;
       while (reader->NextObjectItem(&key)) {
         if (key == "mod_idx") {
           reader->Read(&mod_idx);
@@ -513,6 +533,8 @@ class ConfigPipelineExecution {
           reader->Read(&output);
         } else if (key == "cpu_affinity") {
           reader->Read(&cpu_affinity);
+        } else if (key == "queue_capacity") {
+          reader->Read(&queue_capacity);
         } else {
           LOG(FATAL) << "do not support key " << key;
         }
@@ -522,6 +544,8 @@ class ConfigPipelineExecution {
       ICHECK(!output.Empty()) << "Invalid output binding result.";
       // Store the cpu affinity into the 'ConfigRuntime' structure.
       output.StoreCPUAffinity(cpu_affinity);
+      ICHECK_GE(queue_capacity, 0) << "ValueError: Invalid queue_capacity value " << queue_capacity;
+      output.StoreQueueCapacity(queue_capacity);
       // Build the mapping of mod_idx and "ConfigRuntime".
       config_[mod_idx] = output;
     }
@@ -722,6 +746,16 @@ class BasicRuntime {
   std::unordered_map<int, ForwardQueueMap> forward_queue_;
   /*!\brief The state of the pipeline.*/
   std::atomic<PipelineState> pipeline_state_{STOPPED};
+  /*!\brief The capacity of the forwarding queues of the outputs, 0 for the default one.*/
+  size_t output_queue_capacity_ = 0;
+  /*!\brief The nanoseconds spent waiting for room in the full forwarding queues.*/
+  std::atomic<uint64_t> blocked_ns_{0};
+  /*!\brief Get the nanoseconds elapsed since a time point.*/
+  static uint64_t ElapsedNanoseconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                                start)
+        .count();
+  }
   /*!
    * \brief Generate the ID of an input queue.
    * \param runtime_index The index of backend runtime.
@@ -749,14 +783,19 @@ class BasicRuntime {
                  << runtime_idx_;
     }
     auto forward_queue = forward_queue_map->at(queue_id);
-    // If the queue is full, keep try until the push get success or the pipeline run into
-    // a STOP state.
-    while (!forward_queue->Push<const DLTensor*>(data)) {
-      if (PipelineIsStop()) {
-        LOG(INFO) << "The forwarding process is stopped after the pipeline status is changed"
-                  << " into stop.";
-        return false;
+    // If the queue is full, the child is slower than this runtime, keep try until the push
+    // get success or the pipeline run into a STOP state.
+    if (!forward_queue->Push<const DLTensor*>(data)) {
+      auto start = std::chrono::steady_clock::now();
+      while (!forward_queue->Push<const DLTensor*>(data)) {
+        if (PipelineIsStop()) {
+          LOG(INFO) << "The forwarding process is stopped after the pipeline status is changed"
+                    << " into stop.";
+          return false;
+        }
+        std::this_thread::yield();
       }
+      blocked_ns_.fetch_add(ElapsedNanoseconds(start), std::memory_order_relaxed);
     }
     child_runtime->ParentNotify(child_input_index);
     return true;
@@ -778,7 +817,7 @@ class BasicRuntime {
                  << " is already created!";
       return;
     }
-    auto queue = std::make_shared<ForwardQueue>(queue_id);
+    auto queue = std::make_shared<ForwardQueue>(queue_id, output_queue_capacity_);
     queue_map[queue_id] = queue;
     // Use the created queue as the consumer queue for the input interface of this forwarding
     // pair.
@@ -811,6 +850,12 @@ class BackendRuntime : public BasicRuntime {
   std::thread thread_;
   /*!\brief The execution count of the 'RunPipeline' function. */
   uint32_t pipeline_execution_count_ = 0;
+  /*!\brief The time the pipeline started at.*/
+  std::chrono::steady_clock::time_point start_time_;
+  /*!\brief The nanoseconds spent running the module.*/
+  std::atomic<uint64_t> run_ns_{0};
+  /*!\brief The nanoseconds spent waiting for the forwarding data of the parents.*/
+  std::atomic<uint64_t> wait_ns_{0};
   /*!
    *\brief In order to transfer data from one backend runtime to another, we need a local
    * tensor variable as a medium. "input_tensor_local_copy_" is a map including
@@ -828,14 +873,18 @@ class BackendRuntime : public BasicRuntime {
   /*!\brief The worker thread is used to execute the runtimes in pipeline.*/
   void StartWorkThread() {
     SetPipelineState(RUNNING);
+    start_time_ = std::chrono::steady_clock::now();
     if (runtime_idx_ == 0) {
       this->SetCPUAffinity();
     } else {
       // Only launching the worker thread for the runtimes after the first runtime.
       thread_ = std::thread([&]() {
         this->SetCPUAffinity();
-        while (!this->WaitAndLoadPipelineData()) {
-          if (!this->RunPipeline()) {
+        while (true) {
+          auto start = std::chrono::steady_clock::now();
+          bool exit_notify = this->WaitAndLoadPipelineData();
+          wait_ns_.fetch_add(ElapsedNanoseconds(start), std::memory_order_relaxed);
+          if (exit_notify || !this->RunPipeline()) {
             break;
           }
         }
@@ -1005,6 +1054,25 @@ class BackendRuntime : public BasicRuntime {
    * \return The times of using pipeline function.
    */
   int GetExecutionCount() const { return pipeline_execution_count_; }
+  /*!
+   * \brief Writing the statistics of this runtime as a stage of the pipeline. The utilization
+   *  is the fraction of the time since the pipeline started spent running the module, the
+   *  waiting and blocked times tell whether the stage starves or its children are too slow.
+   * \param writer The json writer.
+   */
+  void WriteStatistics(dmlc::JSONWriter* writer) const {
+    uint64_t elapsed_ns = ElapsedNanoseconds(start_time_);
+    uint64_t run_ns = run_ns_.load(std::memory_order_relaxed);
+    writer->BeginObject();
+    writer->WriteObjectKeyValue("mod_idx", runtime_idx_);
+    writer->WriteObjectKeyValue("execution_count", GetExecutionCount());
+    writer->WriteObjectKeyValue("run_us", run_ns / 1000);
+    writer->WriteObjectKeyValue("wait_us", wait_ns_.load(std::memory_order_relaxed) / 1000);
+    writer->WriteObjectKeyValue("blocked_us", blocked_ns_.load(std::memory_order_relaxed) / 1000);
+    writer->WriteObjectKeyValue("utilization",
+                                elapsed_ns ? static_cast<double>(run_ns) / elapsed_ns : 0.0);
+    writer->EndObject();
+  }
   /*!
    * \brief Initializing data structures for the pipeline execution.
    * \param config The pipeline configueration.
@@ -1015,6 +1083,7 @@ class BackendRuntime : public BasicRuntime {
                           std::shared_ptr<BasicRuntime> global_runtime) {
     // Getting the current BackendRuntime's cpu affinity setting.
     cpu_affinity_ = config.GetCPUAffinity(runtime_idx_);
+    output_queue_capacity_ = config.GetQueueCapacity(runtime_idx_);
     // Getting the 'binding configuration' for each child runtime.
     config.VisitRuntimeOutputConfig(
         [&](int output_idx, int child_idx, std::string child_input_name) {
@@ -1095,7 +1164,9 @@ class BackendRuntime : public BasicRuntime {
    * \return Returning false if the forwarding function failed. Otherwise, returning true.;
    */
   bool RunPipeline() {
+    auto start = std::chrono::steady_clock::now();
     Run();
+    run_ns_.fetch_add(ElapsedNanoseconds(start), std::memory_order_relaxed);
     bool ret = ForwardingOutputDataToChildren();
     pipeline_execution_count_++;
     return ret;
@@ -18,6 +18,8 @@
  */
 #ifndef TVM_RUNTIME_PIPELINE_SPSC_QUEUE_H_
 #define TVM_RUNTIME_PIPELINE_SPSC_QUEUE_H_
+#include <dmlc/logging.h>
+
 #include <cstddef>
 #include <thread>
 /*!\brief A single producer and single consumer lock free queue.
@@ -25,7 +27,17 @@
 template <typename SlotType, typename IDType = int, int QueueLength = 1024>
 class SPSCLockFreeQueue {
  public:
-  explicit SPSCLockFreeQueue(IDType id) : id_(id) {}
+  /*!
+   * \brief Constructing the queue.
+   * \param id The ID of the queue.
+   * \param capacity The number of the data the queue can hold, 0 for the longest queue.
+   */
+  explicit SPSCLockFreeQueue(IDType id, size_t capacity = 0) : id_(id) {
+    ICHECK_LT(capacity, QueueLength) << "ValueError: The capacity of the queue must be less than "
+                                     << QueueLength << ", but got " << capacity;
+    // one slot is always left empty to tell the full queue from the empty one
+    if (capacity > 0) len_ = capacity + 1;
+  }
   /*A read barrier enforcing the CPU to performe the reads before this barrier.*/
   inline void read_barrier() { std::atomic_thread_fence(std::memory_order_acquire); }
   /*A write barrier enforcing the CPU to performe the writes before this barrier.*/
@@ -40,6 +52,13 @@ class SPSCLockFreeQueue {
     read_barrier();
     return head_ == tail_;
   }
+  /*!\brief The number of the data in the queue.*/
+  size_t Size() {
+    read_barrier();
+    return (tail_ + len_ - head_) % len_;
+  }
+  /*!\brief The number of the data the queue can hold.*/
+  size_t Capacity() const { return len_ - 1; }
   /*!
    * \brief Pushing the data into the queue. Only a single producer will call this function.
    * \param data The data which is pushed into the queue.
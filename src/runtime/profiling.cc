@@ -32,10 +32,12 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <iomanip>
 #include <iostream>
 #include <map>
 #include <numeric>
+#include <sstream>
 #include <thread>
 
 namespace tvm {
@@ -923,6 +925,116 @@ PackedFunc WrapTimeEvaluator(PackedFunc pf, Device dev, int number, int repeat,
   return PackedFunc(ftimer);
 }
 
+/*! \brief The median absolute deviations above the median of the warmup outliers. */
+constexpr double kWarmupOutlierDeviations = 3.0;
+/*! \brief The maximum number of runs of a repeat of the statistical time evaluator. */
+constexpr int64_t kMaxRunsPerRepeat = 1 << 30;
+
+/*!
+ * \brief The number of leading costs which are outliers of the others, at most half of them.
+ * \param costs The costs in the order of their measurement.
+ */
+static size_t CountWarmupOutliers(const std::vector<double>& costs) {
+  auto median_of = [](std::vector<double> values) {
+    auto mid = values.begin() + values.size() / 2;
+    std::nth_element(values.begin(), mid, values.end());
+    return *mid;
+  };
+  double median = median_of(costs);
+  std::vector<double> deviations;
+  for (double cost : costs) {
+    deviations.push_back(std::abs(cost - median));
+  }
+  // scaled to the standard deviation of normally distributed costs
+  double threshold = median + kWarmupOutlierDeviations * 1.4826 * median_of(deviations);
+  size_t num_outliers = 0;
+  while (num_outliers < costs.size() / 2 && costs[num_outliers] > threshold) {
+    ++num_outliers;
+  }
+  return num_outliers;
+}
+
+/*! \brief The standard error of the mean of the costs, relative to the mean. */
+static double RelativeStandardError(const double* costs, size_t n) {
+  double mean = std::accumulate(costs, costs + n, 0.0) / n;
+  if (mean <= 0.0) return 0.0;
+  double sum_squares = 0.0;
+  for (size_t i = 0; i < n; ++i) {
+    sum_squares += (costs[i] - mean) * (costs[i] - mean);
+  }
+  return std::sqrt(sum_squares / (n - 1) / n) / mean;
+}
+
+PackedFunc WrapStatisticalTimeEvaluator(PackedFunc pf, Device dev, int min_repeat, int max_repeat,
+                                        int min_repeat_ms, double max_relative_error,
+                                        int cooldown_interval_ms, int repeats_to_cooldown,
+                                        PackedFunc f_preproc) {
+  ICHECK(pf != nullptr);
+  CHECK_GE(min_repeat, 2) << "ValueError: Expect min_repeat to be at least 2, but gets "
+                          << min_repeat;
+  CHECK_GE(max_repeat, min_repeat) << "ValueError: Expect max_repeat to be at least min_repeat "
+                                   << min_repeat << ", but gets " << max_repeat;
+  CHECK_GT(max_relative_error, 0.0) << "ValueError: Expect a positive max_relative_error";
+  CHECK_GE(repeats_to_cooldown, 1) << "ValueError: Expect a positive repeats_to_cooldown";
+
+  auto ftimer = [pf, dev, min_repeat, max_repeat, min_repeat_ms, max_relative_error,
+                 cooldown_interval_ms, repeats_to_cooldown,
+                 f_preproc](TVMArgs args, TVMRetValue* rv) {
+    TVMRetValue temp;
+    // skip first time call, to activate lazy compilation components.
+    pf.CallPacked(args, &temp);
+    DeviceAPI::Get(dev)->StreamSync(dev, nullptr);
+
+    auto run_ms = [&](int64_t number) {
+      Timer t = Timer::Start(dev);
+      for (int64_t j = 0; j < number; ++j) {
+        pf.CallPacked(args, &temp);
+      }
+      t->Stop();
+      return t->SyncAndGetElapsedNanos() / 1e6;
+    };
+    // calibrate the runs of a repeat once, the repeats are only comparable with the same number
+    int64_t number = 1;
+    for (double duration_ms = run_ms(number);
+         duration_ms < min_repeat_ms && number < kMaxRunsPerRepeat; duration_ms = run_ms(number)) {
+      const double golden_ratio = 1.618;
+      double next = duration_ms > 0.0 ? std::max(min_repeat_ms / (duration_ms / number) + 1,
+                                                 number * golden_ratio)
+                                      : number * 10.0;
+      number = std::min(static_cast<int64_t>(next), kMaxRunsPerRepeat);
+    }
+
+    std::vector<double> costs;
+    size_t num_warmup = 0;
+    for (int i = 0; i < max_repeat; ++i) {
+      if (f_preproc != nullptr) {
+        f_preproc.CallPacked(args, &temp);
+      }
+      costs.push_back(run_ms(number) / 1e3 / number);
+      if (cooldown_interval_ms > 0 && (i % repeats_to_cooldown) == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(cooldown_interval_ms));
+      }
+      num_warmup = CountWarmupOutliers(costs);
+      size_t num_kept = costs.size() - num_warmup;
+      if (num_kept >= static_cast<size_t>(min_repeat) &&
+          RelativeStandardError(costs.data() + num_warmup, num_kept) <= max_relative_error) {
+        break;
+      }
+    }
+
+    std::ostringstream os;
+    for (size_t i = num_warmup; i < costs.size(); ++i) {
+      os.write(reinterpret_cast<const char*>(&costs[i]), sizeof(costs[i]));
+    }
+    std::string blob = os.str();
+    TVMByteArray arr;
+    arr.size = blob.length();
+    arr.data = blob.data();
+    *rv = arr;
+  };
+  return PackedFunc(ftimer);
+}
+
 TVM_REGISTER_GLOBAL("runtime.profiling.Report")
     .set_body_typed([](Array<Map<String, ObjectRef>> calls,
                        Map<String, Map<String, ObjectRef>> device_metrics,
@@ -27,9 +27,10 @@
 #include <tvm/runtime/registry.h>
 
 #include <array>
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <mutex>
-#include <unordered_map>
 
 #include "runtime_base.h"
 
@@ -37,24 +38,88 @@ namespace tvm {
 namespace runtime {
 
 struct Registry::Manager {
-  // map storing the functions.
-  // We deliberately used raw pointer.
+  /*!
+   * \brief A function registered under a name, or the removal of the name when the registry is
+   * null. An entry is immutable once published, and is replaced instead of updated.
+   */
+  struct Entry {
+    std::string name;
+    Registry* registry;
+  };
+
+  /*!
+   * \brief The open addressing hash table of the entries, with linear probing. A slot is never
+   * emptied, so that the lookups running concurrently with a registration always find the
+   * entries probed before.
+   */
+  struct Table {
+    explicit Table(size_t capacity)
+        : capacity(capacity), slots(new std::atomic<const Entry*>[capacity]) {
+      for (size_t i = 0; i < capacity; ++i) {
+        slots[i].store(nullptr, std::memory_order_relaxed);
+      }
+    }
+
+    /*! \brief The slot of the name, or the empty slot where it would be inserted. */
+    std::atomic<const Entry*>* Find(const std::string& name) const {
+      size_t mask = capacity - 1;
+      for (size_t i = std::hash<std::string>()(name) & mask;; i = (i + 1) & mask) {
+        const Entry* entry = slots[i].load(std::memory_order_acquire);
+        if (entry == nullptr || entry->name == name) return &slots[i];
+      }
+    }
+
+    /*! \brief The power-of-two number of slots, at least twice the number of used slots. */
+    size_t capacity;
+    /*! \brief The number of used slots, only accessed with the mutex held. */
+    size_t size{0};
+    std::unique_ptr<std::atomic<const Entry*>[]> slots;
+  };
+
+  // The table, the entries and the registries are deliberately leaked.
   // This is because PackedFunc can contain callbacks into the host language (Python) and the
   // resource can become invalid because of indeterministic order of destruction and forking.
-  // The resources will only be recycled during program exit.
-  std::unordered_map<std::string, Registry*> fmap;
-  // mutex
+  // The resources will only be recycled during program exit. Besides, a lookup may still read
+  // a table after it is grown, or an entry after it is replaced, since lookups take no lock.
+  // The tables double in size, so that the ones grown from take as much memory as the last one.
+  std::atomic<const Table*> table;
+  // mutex serializing the registrations and the removals
   std::mutex mutex;
 
-  Manager() {}
+  Manager() : table(new Table(1024)) {}
 
   static Manager* Global() {
     // We deliberately leak the Manager instance, to avoid leak sanitizers
-    // complaining about the entries in Manager::fmap being leaked at program
+    // complaining about the entries in Manager::table being leaked at program
     // exit.
     static Manager* inst = new Manager();
     return inst;
   }
+
+  /*! \brief Publish the entry of the name, either a new one or the replacement of the old one. */
+  void Publish(const std::string& name, Registry* registry) {
+    Table* t = const_cast<Table*>(table.load(std::memory_order_relaxed));
+    std::atomic<const Entry*>* slot = t->Find(name);
+    if (slot->load(std::memory_order_relaxed) == nullptr && (t->size + 1) * 2 > t->capacity) {
+      t = Grow(t);
+      slot = t->Find(name);
+    }
+    if (slot->load(std::memory_order_relaxed) == nullptr) ++t->size;
+    slot->store(new Entry{name, registry}, std::memory_order_release);
+  }
+
+  /*! \brief Copy the entries to a table of twice the capacity, and make the lookups use it. */
+  Table* Grow(const Table* old_table) {
+    Table* t = new Table(old_table->capacity * 2);
+    for (size_t i = 0; i < old_table->capacity; ++i) {
+      const Entry* entry = old_table->slots[i].load(std::memory_order_relaxed);
+      if (entry == nullptr || entry->registry == nullptr) continue;
+      t->Find(entry->name)->store(entry, std::memory_order_relaxed);
+      ++t->size;
+    }
+    table.store(t, std::memory_order_release);
+    return t;
+  }
 };
 
 Registry& Registry::set_body(PackedFunc f) {  // NOLINT(*)
@@ -65,40 +130,47 @@ Registry& Registry::set_body(PackedFunc f) {  // NOLINT(*)
 Registry& Registry::Register(const std::string& name, bool can_override) {  // NOLINT(*)
   Manager* m = Manager::Global();
   std::lock_guard<std::mutex> lock(m->mutex);
-  if (m->fmap.count(name)) {
+  const Manager::Entry* entry =
+      m->table.load(std::memory_order_relaxed)->Find(name)->load(std::memory_order_relaxed);
+  if (entry != nullptr && entry->registry != nullptr) {
     ICHECK(can_override) << "Global PackedFunc " << name << " is already registered";
   }
 
   Registry* r = new Registry();
   r->name_ = name;
-  m->fmap[name] = r;
+  m->Publish(name, r);
   return *r;
 }
 
 bool Registry::Remove(const std::string& name) {
   Manager* m = Manager::Global();
   std::lock_guard<std::mutex> lock(m->mutex);
-  auto it = m->fmap.find(name);
-  if (it == m->fmap.end()) return false;
-  m->fmap.erase(it);
+  const Manager::Entry* entry =
+      m->table.load(std::memory_order_relaxed)->Find(name)->load(std::memory_order_relaxed);
+  if (entry == nullptr || entry->registry == nullptr) return false;
+  m->Publish(name, nullptr);
   return true;
 }
 
 const PackedFunc* Registry::Get(const std::string& name) {
-  Manager* m = Manager::Global();
-  std::lock_guard<std::mutex> lock(m->mutex);
-  auto it = m->fmap.find(name);
-  if (it == m->fmap.end()) return nullptr;
-  return &(it->second->func_);
+  // The lookups take no lock, see Manager.
+  const Manager::Table* t = Manager::Global()->table.load(std::memory_order_acquire);
+  const Manager::Entry* entry = t->Find(name)->load(std::memory_order_acquire);
+  if (entry == nullptr || entry->registry == nullptr) return nullptr;
+  return &(entry->registry->func_);
 }
 
 std::vector<std::string> Registry::ListNames() {
   Manager* m = Manager::Global();
   std::lock_guard<std::mutex> lock(m->mutex);
+  const Manager::Table* t = m->table.load(std::memory_order_relaxed);
   std::vector<std::string> keys;
-  keys.reserve(m->fmap.size());
-  for (const auto& kv : m->fmap) {
-    keys.push_back(kv.first);
+  keys.reserve(t->size);
+  for (size_t i = 0; i < t->capacity; ++i) {
+    const Manager::Entry* entry = t->slots[i].load(std::memory_order_relaxed);
+    if (entry != nullptr && entry->registry != nullptr) {
+      keys.push_back(entry->name);
+    }
   }
   return keys;
 }
@@ -0,0 +1,243 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/runtime/relax_vm/best_fit_allocator.h
+ * \brief The allocator that serves requests with the best fitting cached block.
+ */
+#ifndef TVM_RUNTIME_RELAX_VM_BEST_FIT_ALLOCATOR_H_
+#define TVM_RUNTIME_RELAX_VM_BEST_FIT_ALLOCATOR_H_
+
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/relax_vm/memory_manager.h>
+
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*!
+ * \brief The allocator that caches freed blocks and serves each request with the smallest
+ * cached block that fits.
+ *
+ * Requests are rounded to size classes: multiples of the page size, and above kLargeSize
+ * multiples of 1/8 of the next power of two, so that requests of similar sizes, e.g. from
+ * dynamic sequence lengths, map to the same blocks. On devices where the buffers are plain
+ * pointers, a larger block is split to serve a smaller request, and neighboring free blocks
+ * of the same device allocation (a segment) are coalesced when freed. Once the reserved
+ * memory exceeds the high-water mark, the segments that are entirely free are released.
+ */
+class BestFitAllocator final : public Allocator {
+ public:
+  static constexpr size_t kDefaultPageSize = 4096;
+  static constexpr size_t kLargeSize = 1 << 20;
+
+  explicit BestFitAllocator(Device dev, size_t page_size = kDefaultPageSize)
+      : Allocator(kBestFit), page_size_(page_size), device_(dev) {
+    splittable_ = dev.device_type == kDLCPU || dev.device_type == kDLCUDA ||
+                  dev.device_type == kDLCUDAHost || dev.device_type == kDLCUDAManaged ||
+                  dev.device_type == kDLROCM || dev.device_type == kDLROCMHost;
+  }
+
+  ~BestFitAllocator() { ReleaseCached(); }
+
+  Buffer Alloc(size_t nbytes, size_t alignment, DLDataType type_hint) override {
+    std::lock_guard<std::mutex> lock(mu_);
+    ICHECK_LE(alignment, page_size_) << "BestFitAllocator only aligns the blocks to pages";
+    stats_.num_allocs++;
+    size_t size = RoundSize(nbytes);
+    Block* block = FindFree(size);
+    if (block != nullptr) {
+      stats_.num_cache_hits++;
+      free_blocks_.erase(block);
+      stats_.bytes_cached -= block->size;
+      if (splittable_ && block->size - size >= page_size_) {
+        Split(block, size);
+      }
+    } else {
+      if (high_water_mark_ != 0 && bytes_reserved_ + size > high_water_mark_) {
+        ReleaseCached();
+      }
+      void* data;
+      try {
+        data = DeviceAPI::Get(device_)->AllocDataSpace(device_, size, page_size_, type_hint);
+      } catch (InternalError& err) {
+        LOG(WARNING) << "BestFitAllocator got InternalError during allocation: " << err.message();
+        LOG(WARNING) << "Trying to release all cached memory and reallocate...";
+        ReleaseCached();
+        data = DeviceAPI::Get(device_)->AllocDataSpace(device_, size, page_size_, type_hint);
+      }
+      stats_.num_device_allocs++;
+      bytes_reserved_ += size;
+      block = new Block{data, size};
+    }
+    block->allocated = true;
+    allocated_blocks_[block->data] = block;
+    stats_.bytes_in_use += block->size;
+    stats_.peak_bytes_in_use = std::max(stats_.peak_bytes_in_use, stats_.bytes_in_use);
+
+    Buffer buf;
+    buf.device = device_;
+    buf.data = block->data;
+    buf.size = block->size;
+    DLOG(INFO) << "allocate " << block->size << " B, in use " << stats_.bytes_in_use << " B";
+    return buf;
+  }
+
+  void Free(const Buffer& buffer) override {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto it = allocated_blocks_.find(buffer.data);
+    ICHECK(it != allocated_blocks_.end()) << "The buffer is not allocated by the allocator";
+    Block* block = it->second;
+    allocated_blocks_.erase(it);
+    block->allocated = false;
+    stats_.bytes_in_use -= block->size;
+    stats_.bytes_cached += block->size;
+    if (block->next != nullptr && !block->next->allocated) {
+      Merge(block, block->next);
+    }
+    if (block->prev != nullptr && !block->prev->allocated) {
+      Block* prev = block->prev;
+      Merge(prev, block);
+      block = prev;
+    }
+    free_blocks_.insert(block);
+    if (high_water_mark_ != 0 && bytes_reserved_ > high_water_mark_) {
+      ReleaseCached();
+    }
+    DLOG(INFO) << "reclaim buffer " << buffer.size;
+  }
+
+  AllocatorStats Stats() const override {
+    std::lock_guard<std::mutex> lock(mu_);
+    AllocatorStats stats = stats_;
+    stats.largest_cached_block = free_blocks_.empty() ? 0 : (*free_blocks_.rbegin())->size;
+    return stats;
+  }
+
+  /*!
+   * \brief Set the high-water mark of the memory reserved from the device.
+   * \param bytes The high-water mark in bytes, 0 keeps all the freed blocks cached.
+   */
+  void SetHighWaterMark(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mu_);
+    high_water_mark_ = bytes;
+    if (high_water_mark_ != 0 && bytes_reserved_ > high_water_mark_) {
+      ReleaseCached();
+    }
+  }
+
+ private:
+  /*! \brief A block of a segment, the segment is the list of blocks linked by prev and next. */
+  struct Block {
+    void* data;
+    size_t size;
+    Block* prev{nullptr};
+    Block* next{nullptr};
+    bool allocated{false};
+  };
+
+  struct BlockLess {
+    bool operator()(const Block* a, const Block* b) const {
+      return a->size != b->size ? a->size < b->size : std::less<void*>()(a->data, b->data);
+    }
+  };
+
+  size_t RoundSize(size_t nbytes) const {
+    size_t size = std::max<size_t>((nbytes + page_size_ - 1) / page_size_, 1) * page_size_;
+    if (size <= kLargeSize) return size;
+    size_t step = 1;
+    while (step < size) step <<= 1;
+    step = std::max(step >> 3, page_size_);
+    return (size + step - 1) / step * step;
+  }
+
+  /*! \brief Find the smallest free block that can serve the request of the given size. */
+  Block* FindFree(size_t size) const {
+    Block key{nullptr, size};
+    auto it = free_blocks_.lower_bound(&key);
+    if (it == free_blocks_.end()) return nullptr;
+    // blocks that cannot be split are only reused when less than half of them is wasted
+    if (!splittable_ && (*it)->size / 2 > size) return nullptr;
+    return *it;
+  }
+
+  /*! \brief Split the block, leaving the first size bytes in the block. */
+  void Split(Block* block, size_t size) {
+    Block* rest = new Block{static_cast<char*>(block->data) + size, block->size - size};
+    rest->prev = block;
+    rest->next = block->next;
+    if (block->next != nullptr) block->next->prev = rest;
+    block->next = rest;
+    block->size = size;
+    free_blocks_.insert(rest);
+    stats_.bytes_cached += rest->size;
+  }
+
+  /*! \brief Merge the free block next into the free block before it. */
+  void Merge(Block* block, Block* next) {
+    // the set is ordered by size, erase the blocks before resizing
+    free_blocks_.erase(block);
+    free_blocks_.erase(next);
+    block->size += next->size;
+    block->next = next->next;
+    if (next->next != nullptr) next->next->prev = block;
+    delete next;
+  }
+
+  /*! \brief Release the segments that are entirely free to the device. */
+  void ReleaseCached() {
+    for (auto it = free_blocks_.begin(); it != free_blocks_.end();) {
+      Block* block = *it;
+      if (block->prev == nullptr && block->next == nullptr) {
+        DeviceAPI::Get(device_)->FreeDataSpace(device_, block->data);
+        stats_.num_device_frees++;
+        stats_.bytes_cached -= block->size;
+        bytes_reserved_ -= block->size;
+        it = free_blocks_.erase(it);
+        delete block;
+      } else {
+        ++it;
+      }
+    }
+    DLOG(INFO) << "release cached segments, reserved " << bytes_reserved_ << " B";
+  }
+
+  size_t page_size_;
+  bool splittable_;
+  Device device_;
+  /*! \brief The limit of the memory reserved from the device, 0 for no limit. */
+  size_t high_water_mark_{0};
+  size_t bytes_reserved_{0};
+  AllocatorStats stats_;
+  std::set<Block*, BlockLess> free_blocks_;
+  std::unordered_map<void*, Block*> allocated_blocks_;
+  mutable std::mutex mu_;
+};
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_RELAX_VM_BEST_FIT_ALLOCATOR_H_
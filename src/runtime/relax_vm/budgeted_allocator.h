@@ -0,0 +1,214 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file tvm/runtime/relax_vm/budgeted_allocator.h
+ * \brief The allocator that keeps the memory of a device within a budget.
+ */
+#ifndef TVM_RUNTIME_RELAX_VM_BUDGETED_ALLOCATOR_H_
+#define TVM_RUNTIME_RELAX_VM_BUDGETED_ALLOCATOR_H_
+
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/relax_vm/memory_manager.h>
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*!
+ * \brief The pooled allocator that keeps the reserved memory of a device within a budget.
+ *
+ * Freed buffers are cached by size. When a request would exceed the budget, the cached
+ * buffers are released least recently freed first. If the buffers in use still leave no
+ * room, the spill handler installed by the owner, e.g. the VM copying its intermediate
+ * tensors to the host, is asked to free the missing bytes before the request fails.
+ */
+class BudgetedAllocator final : public Allocator {
+ public:
+  static constexpr size_t kDefaultPageSize = 4096;
+
+  /*!
+   * \brief The handler that frees at least the given number of bytes in use, if it can.
+   * It is called by the thread allocating and may free buffers to the allocator.
+   */
+  using FSpill = std::function<void(size_t nbytes)>;
+
+  explicit BudgetedAllocator(Device dev, size_t page_size = kDefaultPageSize)
+      : Allocator(kBudgeted), page_size_(page_size), device_(dev) {}
+
+  ~BudgetedAllocator() {
+    std::lock_guard<std::recursive_mutex> lock(mu_);
+    while (!lru_.empty()) EvictOne();
+  }
+
+  Buffer Alloc(size_t nbytes, size_t alignment, DLDataType type_hint) override {
+    std::lock_guard<std::recursive_mutex> lock(mu_);
+    stats_.num_allocs++;
+    size_t size = ((nbytes + page_size_ - 1) / page_size_) * page_size_;
+    Buffer buf;
+    if (TakeCached(size, &buf)) return buf;
+    if (budget_ != 0) {
+      EvictUntilFits(size);
+      if (stats_.bytes_in_use + size > budget_ && spill_ != nullptr) {
+        spill_(stats_.bytes_in_use + size - budget_);
+        // the spilled buffers are freed to the cache, one of them may serve the request
+        if (TakeCached(size, &buf)) return buf;
+        EvictUntilFits(size);
+      }
+      if (stats_.bytes_in_use + size > budget_) {
+        LOG(FATAL) << "RuntimeError: Cannot allocate " << size << " bytes on "
+                   << runtime::DeviceName(device_.device_type) << "(" << device_.device_id
+                   << "), " << stats_.bytes_in_use << " bytes are in use out of the budget of "
+                   << budget_ << " bytes";
+      }
+    }
+    buf.device = device_;
+    buf.size = size;
+    try {
+      buf.data = DeviceAPI::Get(device_)->AllocDataSpace(device_, size, alignment, type_hint);
+    } catch (InternalError& err) {
+      LOG(WARNING) << "BudgetedAllocator got InternalError during allocation: " << err.message();
+      LOG(WARNING) << "Trying to release all cached memory and reallocate...";
+      while (!lru_.empty()) EvictOne();
+      buf.data = DeviceAPI::Get(device_)->AllocDataSpace(device_, size, alignment, type_hint);
+    }
+    stats_.num_device_allocs++;
+    AddInUse(size);
+    return buf;
+  }
+
+  void Free(const Buffer& buffer) override {
+    // the buffer of a spilled storage has already been freed
+    if (buffer.data == nullptr) return;
+    std::lock_guard<std::recursive_mutex> lock(mu_);
+    auto it = lru_.insert(lru_.end(), buffer);
+    by_size_[buffer.size].push_back(it);
+    stats_.bytes_in_use -= buffer.size;
+    stats_.bytes_cached += buffer.size;
+  }
+
+  AllocatorStats Stats() const override {
+    std::lock_guard<std::recursive_mutex> lock(mu_);
+    AllocatorStats stats = stats_;
+    stats.largest_cached_block = 0;
+    for (const Buffer& buf : lru_) {
+      stats.largest_cached_block = std::max(stats.largest_cached_block, buf.size);
+    }
+    stats.memory_budget = budget_;
+    return stats;
+  }
+
+  /*!
+   * \brief Set the bytes the buffers in use and cached can take, 0 for no budget.
+   * \note Only bounds later allocations, the buffers in use are kept.
+   */
+  void SetBudget(size_t budget) {
+    std::lock_guard<std::recursive_mutex> lock(mu_);
+    budget_ = budget;
+    if (budget_ != 0) EvictUntilFits(0);
+  }
+
+  /*! \brief The bytes the buffers in use and cached can take, 0 for no budget. */
+  size_t budget() const {
+    std::lock_guard<std::recursive_mutex> lock(mu_);
+    return budget_;
+  }
+
+  /*! \brief Install the handler called when the buffers in use exceed the budget. */
+  void SetSpillHandler(FSpill spill) {
+    std::lock_guard<std::recursive_mutex> lock(mu_);
+    spill_ = std::move(spill);
+  }
+
+  /*! \brief Count a buffer in use copied to the host and freed by the spill handler. */
+  void RecordSpill(size_t nbytes) {
+    std::lock_guard<std::recursive_mutex> lock(mu_);
+    stats_.num_spills++;
+    stats_.bytes_spilled += nbytes;
+  }
+
+  /*! \brief Count a spilled buffer copied back to the device. */
+  void RecordReload() {
+    std::lock_guard<std::recursive_mutex> lock(mu_);
+    stats_.num_reloads++;
+  }
+
+ private:
+  void AddInUse(size_t size) {
+    stats_.bytes_in_use += size;
+    stats_.peak_bytes_in_use = std::max(stats_.peak_bytes_in_use, stats_.bytes_in_use);
+  }
+
+  /*! \brief Take the most recently freed cached buffer of the size, if any. */
+  bool TakeCached(size_t size, Buffer* buf) {
+    auto it = by_size_.find(size);
+    if (it == by_size_.end() || it->second.empty()) return false;
+    *buf = *it->second.back();
+    lru_.erase(it->second.back());
+    it->second.pop_back();
+    stats_.num_cache_hits++;
+    stats_.bytes_cached -= buf->size;
+    AddInUse(buf->size);
+    return true;
+  }
+
+  /*! \brief Release cached buffers until a request of the size fits in the budget. */
+  void EvictUntilFits(size_t size) {
+    while (!lru_.empty() && stats_.bytes_in_use + stats_.bytes_cached + size > budget_) {
+      EvictOne();
+    }
+  }
+
+  /*! \brief Release the least recently freed cached buffer. */
+  void EvictOne() {
+    Buffer buf = lru_.front();
+    // the buffers of a size are freed in order, so the oldest one is the first of its size
+    by_size_[buf.size].pop_front();
+    lru_.pop_front();
+    DeviceAPI::Get(device_)->FreeDataSpace(device_, buf.data);
+    stats_.bytes_cached -= buf.size;
+    stats_.num_device_frees++;
+    stats_.num_evictions++;
+  }
+
+  size_t page_size_;
+  /*! \brief The budget in bytes, 0 for no budget. */
+  size_t budget_{0};
+  /*! \brief The cached buffers, the least recently freed first. */
+  std::list<Buffer> lru_;
+  /*! \brief The cached buffers of each size, the least recently freed first. */
+  std::unordered_map<size_t, std::deque<std::list<Buffer>::iterator>> by_size_;
+  FSpill spill_;
+  AllocatorStats stats_;
+  mutable std::recursive_mutex mu_;
+  Device device_;
+};
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_RELAX_VM_BUDGETED_ALLOCATOR_H_
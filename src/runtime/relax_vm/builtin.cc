@@ -31,12 +31,36 @@
 #include <tvm/runtime/relax_vm/memory_manager.h>
 #include <tvm/runtime/relax_vm/vm.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace tvm {
 namespace runtime {
 namespace relax_vm {
 
 using tvm::runtime::NDArray;
 
+/*!
+ * \brief Make a shape from its dimensions, without a temporary vector when it is stored inline.
+ * \param ndim The number of dimensions.
+ * \param f_dim The function giving the i-th dimension.
+ */
+template <typename FDim>
+inline ShapeTuple MakeShape(size_t ndim, FDim f_dim) {
+  if (ndim <= ShapeTupleObj::kMaxInlineDims) {
+    int64_t dims[ShapeTupleObj::kMaxInlineDims];
+    for (size_t i = 0; i < ndim; ++i) {
+      dims[i] = f_dim(i);
+    }
+    return ShapeTuple(dims, dims + ndim);
+  }
+  std::vector<int64_t> dims(ndim);
+  for (size_t i = 0; i < ndim; ++i) {
+    dims[i] = f_dim(i);
+  }
+  return ShapeTuple(std::move(dims));
+}
+
 TVM_REGISTER_GLOBAL("vm.builtin.shape_of").set_body_method(&NDArray::Shape);
 
 TVM_REGISTER_GLOBAL("vm.builtin.copy").set_body_typed([](NDArray src) { return src; });
@@ -44,7 +68,8 @@ TVM_REGISTER_GLOBAL("vm.builtin.copy").set_body_typed([](NDArray src) { return s
 TVM_REGISTER_GLOBAL("vm.builtin.alloc_shape_heap")
     .set_body_typed([](void* vm_ptr, ShapeTuple size) {
       VirtualMachine* vm = static_cast<VirtualMachine*>(vm_ptr);
-      return NDArray::Empty(size, DLDataType{kDLInt, 64, 1}, vm->devices[0]);
+      ICHECK_EQ(size.size(), 1);
+      return vm->AllocShapeHeap(size[0]);
     });
 
 TVM_REGISTER_GLOBAL("vm.builtin.alloc_closure").set_body([](TVMArgs args, TVMRetValue* rv) {
@@ -89,7 +114,7 @@ TVM_REGISTER_GLOBAL("vm.builtin.invoke_closure").set_body([](TVMArgs args, TVMRe
 
 TVM_REGISTER_GLOBAL("vm.builtin.store_shape")
     .set_body_typed([](ShapeTuple shape, NDArray heap, ShapeTuple indexes) {
-      int64_t* heap_data = reinterpret_cast<int64_t*>(heap.ToDLPack()->dl_tensor.data);
+      int64_t* heap_data = static_cast<int64_t*>(heap->data);
       for (size_t i = 0; i < indexes.size(); ++i) {
         int64_t heap_idx = indexes[i];
         ICHECK(heap_idx >= 0 && heap_idx < heap.Shape()[0]);
@@ -98,75 +123,124 @@ TVM_REGISTER_GLOBAL("vm.builtin.store_shape")
     });
 
 TVM_REGISTER_GLOBAL("vm.builtin.load_shape").set_body_typed([](NDArray heap, ShapeTuple indexes) {
-  int64_t* heap_data = reinterpret_cast<int64_t*>(heap.ToDLPack()->dl_tensor.data);
-  std::vector<int64_t> shape;
-  for (size_t i = 0; i < indexes.size(); ++i) {
+  const int64_t* heap_data = static_cast<const int64_t*>(heap->data);
+  int64_t heap_size = heap->shape[0];
+  return MakeShape(indexes.size(), [&](size_t i) {
     int64_t heap_idx = indexes[i];
-    ICHECK(heap_idx >= 0 && heap_idx < heap.Shape()[0]);
-    shape.push_back(heap_data[heap_idx]);
-  }
-  return ShapeTuple(shape);
+    ICHECK(heap_idx >= 0 && heap_idx < heap_size);
+    return heap_data[heap_idx];
+  });
 });
 
 TVM_REGISTER_GLOBAL("vm.builtin.alloc_storage")
     .set_body_typed([](void* vm_ptr, ShapeTuple buffer_size, Index device_index,
                        DLDataType dtype_hint) {
       ICHECK_EQ(buffer_size.size(), 1);
-      int alignment = runtime::kAllocAlignment;
       VirtualMachine* vm = static_cast<VirtualMachine*>(vm_ptr);
-      ICHECK_LT(device_index, vm->devices.size())
-          << "The device index is out of VM physical devices list";
+      return vm->AllocStorage(buffer_size[0], device_index, dtype_hint);
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.alloc_static_storage")
+    .set_body_typed([](void* vm_ptr, ShapeTuple buffer_size, Index device_index,
+                       DLDataType dtype_hint, Index slot) {
+      ICHECK_EQ(buffer_size.size(), 1);
+      VirtualMachine* vm = static_cast<VirtualMachine*>(vm_ptr);
+      return vm->AllocStaticStorage(buffer_size[0], device_index, dtype_hint, slot);
+    });
 
-      if (device_index == -1) {
-        // Allocate on host. Host is always the last element of vm->devices.
-        device_index = vm->devices.size() - 1;
+TVM_REGISTER_GLOBAL("vm.builtin.alloc_scoped_storage")
+    .set_body_typed([](void* vm_ptr, ShapeTuple buffer_size, Index device_index,
+                       DLDataType dtype_hint, String mem_scope, Index slot) {
+      // slot: the slot of the storage kept across calls, -1 for a storage of the call
+      ICHECK_EQ(buffer_size.size(), 1);
+      VirtualMachine* vm = static_cast<VirtualMachine*>(vm_ptr);
+      if (slot < 0) {
+        return vm->AllocStorage(buffer_size[0], device_index, dtype_hint, mem_scope);
       }
+      return vm->AllocStaticStorage(buffer_size[0], device_index, dtype_hint, slot, mem_scope);
+    });
 
-      int64_t size_imm = buffer_size[0];
+/*!
+ * \brief The DMA queue of the prefetches on Hexagon, apart from the low queue ids used by the
+ * asynchronous copies of the kernels.
+ */
+constexpr int kPrefetchDMAQueue = 16;
+/*! \brief The bytes of each DMA of a prefetch, within the 24-bit length of a descriptor. */
+constexpr int64_t kPrefetchDMABytes = 1 << 23;
 
-      auto storage_obj = runtime::SimpleObjAllocator().make_object<StorageObj>();
-      auto* alloc = vm->allocators[device_index];
-      ICHECK(alloc) << "Did you forget to init the VirtualMachine with devices?";
-      storage_obj->buffer = alloc->Alloc(size_imm, alignment, dtype_hint);
-      Storage storage(storage_obj);
-      return storage;
-    });
+TVM_REGISTER_GLOBAL("vm.builtin.prefetch").set_body_typed([](NDArray src, String scope) {
+  // the copy is flat, so that a scope with a layout of its own for the N-d tensors, as the 2-d
+  // VTCM allocations of Hexagon, still holds the bytes of the source
+  ICHECK(src.IsContiguous()) << "Only contiguous tensors can be prefetched";
+  int64_t nbytes = static_cast<int64_t>(GetDataSize(*src.operator->()));
+  NDArray dst = NDArray::Empty({nbytes}, DLDataType{kDLUInt, 8, 1}, src->device, scope)
+                    .CreateView(src.Shape(), src->dtype);
+  static const PackedFunc* dma_copy = Registry::Get("device_api.hexagon.dma_copy");
+  if (static_cast<int>(src->device.device_type) == kDLHexagon && dma_copy != nullptr) {
+    char* from = static_cast<char*>(src->data) + src->byte_offset;
+    char* to = static_cast<char*>(dst->data);
+    bool started = true;
+    for (int64_t offset = 0; offset < nbytes && started; offset += kPrefetchDMABytes) {
+      int size = static_cast<int>(std::min(kPrefetchDMABytes, nbytes - offset));
+      int ret = (*dma_copy)(kPrefetchDMAQueue, to + offset, from + offset, size);
+      started = ret == 0;
+    }
+    if (started) return dst;
+    // the addresses out of the reach of the DMA engine are copied synchronously
+    (*Registry::Get("device_api.hexagon.dma_wait"))(kPrefetchDMAQueue, 0);
+  }
+  dst.CopyFrom(src);
+  return dst;
+});
+
+TVM_REGISTER_GLOBAL("vm.builtin.prefetch_wait").set_body_typed([](NDArray dst) {
+  static const PackedFunc* dma_wait = Registry::Get("device_api.hexagon.dma_wait");
+  if (static_cast<int>(dst->device.device_type) == kDLHexagon && dma_wait != nullptr) {
+    // a kernel waits for all the prefetches of its weights, started before the previous kernel
+    (*dma_wait)(kPrefetchDMAQueue, 0);
+  }
+  return dst;
+});
 
 TVM_REGISTER_GLOBAL("vm.builtin.alloc_tensor").set_body_method<Storage>(&StorageObj::AllocNDArray);
 
 TVM_REGISTER_GLOBAL("vm.binary_broadcast_shape_infer")
     .set_body_typed([](ShapeTuple lhs_shape, ShapeTuple rhs_shape) {
-      std::vector<int64_t> output_shape;
       size_t ndim0 = lhs_shape.size();
       size_t ndim1 = rhs_shape.size();
-      size_t i = 1;
-      for (; i <= std::min(ndim0, ndim1); ++i) {
+      size_t max_ndim = std::max(ndim0, ndim1);
+      return MakeShape(max_ndim, [&](size_t j) {
+        // align the dimensions from the right
+        size_t i = max_ndim - j;
+        if (i > ndim0) return rhs_shape[ndim1 - i];
+        if (i > ndim1) return lhs_shape[ndim0 - i];
         int64_t lhs_dim = lhs_shape[ndim0 - i];
         int64_t rhs_dim = rhs_shape[ndim1 - i];
         ICHECK(lhs_dim == rhs_dim || lhs_dim == 1 || rhs_dim == 1);
-        output_shape.push_back(std::max(lhs_dim, rhs_dim));
-      }
-      size_t max_ndim = std::max(ndim0, ndim1);
-      ShapeTuple& longer_shape = (ndim0 > ndim1) ? lhs_shape : rhs_shape;
-      for (; i <= max_ndim; ++i) {
-        output_shape.push_back(longer_shape[max_ndim - i]);
-      }
-      return ShapeTuple(output_shape.rbegin(), output_shape.rend());
+        return std::max(lhs_dim, rhs_dim);
+      });
     });
 
 TVM_REGISTER_GLOBAL("vm.call_tir_dyn").set_body([](TVMArgs args, TVMRetValue* rv) {
+  // args[0]: vm; args[1]: kernel index in the function table, or kernel name;
+  // args[2, 3, ...]: tensor arguments; args[-1]: shape to unpack
   void* vm_ptr = args[0];
   VirtualMachine* vm = static_cast<VirtualMachine*>(vm_ptr);
-  runtime::String func_name = args[1];
 
   PackedFunc func{nullptr};
-  if (vm->lib.defined()) {
-    func = vm->lib.value()->GetFunction(func_name, true);
-  }
-  if (!func.defined()) {
-    const PackedFunc* p_func = Registry::Get(func_name);
-    CHECK(p_func != nullptr);
-    func = *(p_func);
+  if (args[1].type_code() == kDLInt) {
+    // fast path, the kernel is looked up by index and cached in the table on first use
+    func = vm->GetFuncFromTable(args[1].operator int64_t());
+  } else {
+    runtime::String func_name = args[1];
+    if (vm->lib.defined()) {
+      func = vm->lib.value()->GetFunction(func_name, true);
+    }
+    if (!func.defined()) {
+      const PackedFunc* p_func = Registry::Get(func_name);
+      CHECK(p_func != nullptr) << "Cannot find kernel " << func_name;
+      func = *(p_func);
+    }
   }
 
   ShapeTuple to_unpack = args[args.size() - 1];
@@ -186,6 +260,40 @@ TVM_REGISTER_GLOBAL("vm.call_tir_dyn").set_body([](TVMArgs args, TVMRetValue* rv
   func.CallPacked(func_args, rv);
 });
 
+TVM_REGISTER_GLOBAL("vm.builtin.set_stream").set_body_typed([](void* vm_ptr, int64_t stream_index) {
+  VirtualMachine* vm = static_cast<VirtualMachine*>(vm_ptr);
+  Device dev = vm->devices[0];
+  DeviceAPI::Get(dev)->SetStream(dev, vm->GetStream(stream_index));
+});
+
+TVM_REGISTER_GLOBAL("vm.builtin.sync_stream")
+    .set_body_typed([](void* vm_ptr, int64_t src_index, int64_t dst_index) {
+      VirtualMachine* vm = static_cast<VirtualMachine*>(vm_ptr);
+      Device dev = vm->devices[0];
+      DeviceAPI::Get(dev)->SyncStreamFromTo(dev, vm->GetStream(src_index),
+                                            vm->GetStream(dst_index));
+    });
+
+/*!
+ * \brief Make the default stream wait for the given streams and switch back to it.
+ * \param vm The VM.
+ * \param num_streams The number of the streams joined, followed by their indices.
+ * \note The remaining arguments are the tensors used on the streams, which the call refers to so
+ *  that they, and their storage, are only released after the join.
+ */
+TVM_REGISTER_GLOBAL("vm.builtin.join_streams").set_body([](TVMArgs args, TVMRetValue* rv) {
+  void* vm_ptr = args[0];
+  VirtualMachine* vm = static_cast<VirtualMachine*>(vm_ptr);
+  int64_t num_streams = args[1];
+  ICHECK_LE(2 + num_streams, args.size());
+  Device dev = vm->devices[0];
+  DeviceAPI* api = DeviceAPI::Get(dev);
+  for (int64_t i = 0; i < num_streams; ++i) {
+    api->SyncStreamFromTo(dev, vm->GetStream(args[2 + i]), vm->GetStream(0));
+  }
+  api->SetStream(dev, vm->GetStream(0));
+});
+
 TVM_REGISTER_GLOBAL("vm.runtime.TupleGetItem")
     .set_body_typed([](runtime::ADT adt, ShapeTuple index) {
       ICHECK_EQ(index.size(), 1);
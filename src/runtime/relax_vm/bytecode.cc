@@ -63,6 +63,106 @@ Instruction Instruction::If(RegName cond, Index false_offset) {
   instr.false_offset = false_offset;
   return instr;
 }
+
+Instruction Instruction::AllocStorageTensor(RegName storage, Instruction::Arg* alloc_args,
+                                            RegName dst) {
+  Instruction instr;
+  instr.op = Opcode::AllocStorageTensor;
+  instr.dst = dst;
+  instr.storage = storage;
+  instr.alloc_args = alloc_args;
+  return instr;
+}
+
+Instruction Instruction::LoadShapeCall(Index func_idx, Index num_args, Instruction::Arg* args,
+                                       Instruction::Arg* shape_args, RegName dst) {
+  Instruction instr;
+  instr.op = Opcode::LoadShapeCall;
+  instr.dst = dst;
+  instr.func_idx = func_idx;
+  instr.num_args = num_args;
+  instr.args = args;
+  instr.shape_args = shape_args;
+  return instr;
+}
+
+Instruction Instruction::LoadShape(RegName heap, Index num_indices, ExecWord* indices,
+                                   RegName dst) {
+  Instruction instr;
+  instr.op = Opcode::LoadShape;
+  instr.dst = dst;
+  instr.heap = heap;
+  instr.shape = Instruction::kVoidArg;
+  instr.heap_num_args = num_indices;
+  instr.heap_args = indices;
+  return instr;
+}
+
+Instruction Instruction::StoreShape(RegName shape, RegName heap, Index num_indices,
+                                    ExecWord* indices) {
+  Instruction instr;
+  instr.op = Opcode::StoreShape;
+  instr.dst = Instruction::kVoidArg;
+  instr.heap = heap;
+  instr.shape = shape;
+  instr.heap_num_args = num_indices;
+  instr.heap_args = indices;
+  return instr;
+}
+
+Instruction Instruction::ComputeShape(RegName heap, Index num_words, ExecWord* program) {
+  Instruction instr;
+  instr.op = Opcode::ComputeShape;
+  instr.dst = Instruction::kVoidArg;
+  instr.heap = heap;
+  instr.shape = Instruction::kVoidArg;
+  instr.heap_num_args = num_words;
+  instr.heap_args = program;
+  return instr;
+}
+
+Instruction Instruction::Move(RegName src, RegName dst) {
+  Instruction instr;
+  instr.op = Opcode::Move;
+  instr.dst = dst;
+  instr.src = src;
+  return instr;
+}
+
+Instruction Instruction::LoadConst(Index const_idx, RegName dst) {
+  Instruction instr;
+  instr.op = Opcode::LoadConst;
+  instr.dst = dst;
+  instr.const_idx = const_idx;
+  return instr;
+}
+
+Instruction Instruction::MakeTuple(Index num_fields, Arg* fields, RegName dst) {
+  Instruction instr;
+  instr.op = Opcode::MakeTuple;
+  instr.dst = dst;
+  instr.num_fields = num_fields;
+  instr.fields = fields;
+  return instr;
+}
+
+Instruction Instruction::GetTupleItem(RegName tuple, Index index, RegName dst) {
+  Instruction instr;
+  instr.op = Opcode::GetTupleItem;
+  instr.dst = dst;
+  instr.tuple = tuple;
+  instr.item_index = index;
+  return instr;
+}
+
+Instruction Instruction::Kill(Index num_regs, RegName* regs) {
+  Instruction instr;
+  instr.op = Opcode::Kill;
+  instr.dst = Instruction::kVoidArg;
+  instr.num_regs = num_regs;
+  instr.regs = regs;
+  return instr;
+}
 }  // namespace relax_vm
 }  // namespace runtime
 }  // namespace tvm
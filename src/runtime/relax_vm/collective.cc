@@ -0,0 +1,268 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/collective.cc
+ * \brief The collective builtins of the Relax VM, and a group of CPU communicators.
+ *
+ * The CPU group exchanges the tensors of the ranks running on the threads of one process
+ * through shared memory, the NCCL one in nccl/ covers the CUDA devices.
+ */
+#include "collective.h"
+
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/relax_vm/vm.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+TVM_REGISTER_OBJECT_TYPE(CommunicatorObj);
+
+/*! \brief The state shared by the CPU communicators of a group. */
+class CPUGroup {
+ public:
+  explicit CPUGroup(int world_size) : world_size_(world_size), sends_(world_size) {}
+
+  /*!
+   * \brief Run a collective: publish the input of the rank, run the computation of the rank once
+   * all the inputs are published, then wait for the other ranks to be done reading them.
+   */
+  template <typename F>
+  void Run(int rank, const DLTensor* send, const DLTensor* recv, F compute) {
+    CHECK(send->device.device_type == kDLCPU && recv->device.device_type == kDLCPU)
+        << "ValueError: The CPU communicators only support tensors on the CPU";
+    sends_[rank] = static_cast<const char*>(send->data) + send->byte_offset;
+    Barrier();
+    compute(sends_);
+    Barrier();
+  }
+
+ private:
+  void Barrier() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    int64_t generation = generation_;
+    if (++arrived_ == world_size_) {
+      arrived_ = 0;
+      ++generation_;
+      cv_.notify_all();
+    } else {
+      cv_.wait(lock, [&] { return generation_ != generation; });
+    }
+  }
+
+  int world_size_;
+  std::vector<const void*> sends_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  int arrived_{0};
+  int64_t generation_{0};
+};
+
+/*! \brief Reduce count elements of each input at the given element offset into out. */
+template <typename T>
+void ReduceElements(const std::vector<const void*>& ins, int64_t offset, int64_t count,
+                    ReduceKind op, void* out) {
+  T* dst = static_cast<T*>(out);
+  const T* first = static_cast<const T*>(ins[0]) + offset;
+  std::copy(first, first + count, dst);
+  for (size_t r = 1; r < ins.size(); ++r) {
+    const T* src = static_cast<const T*>(ins[r]) + offset;
+    for (int64_t i = 0; i < count; ++i) {
+      switch (op) {
+        case ReduceKind::kSum:
+          dst[i] += src[i];
+          break;
+        case ReduceKind::kProd:
+          dst[i] *= src[i];
+          break;
+        case ReduceKind::kMin:
+          dst[i] = std::min(dst[i], src[i]);
+          break;
+        case ReduceKind::kMax:
+          dst[i] = std::max(dst[i], src[i]);
+          break;
+      }
+    }
+  }
+}
+
+inline void* DataPtr(const DLTensor* tensor) {
+  return static_cast<char*>(tensor->data) + tensor->byte_offset;
+}
+
+inline int64_t NumElements(const DLTensor* tensor) {
+  int64_t size = 1;
+  for (int i = 0; i < tensor->ndim; ++i) size *= tensor->shape[i];
+  return size;
+}
+
+/*! \brief A communicator of a group of ranks on the threads of the process, on the CPU. */
+class CPUCommunicatorObj : public CommunicatorObj {
+ public:
+  std::shared_ptr<CPUGroup> group;
+
+  void AllReduce(const DLTensor* send, DLTensor* recv, ReduceKind op) final {
+    int64_t count = NumElements(send);
+    group->Run(rank, send, recv, [&](const std::vector<const void*>& ins) {
+      Reduce(send->dtype, ins, 0, count, op, DataPtr(recv));
+    });
+  }
+
+  void AllGather(const DLTensor* send, DLTensor* recv) final {
+    size_t nbytes = GetDataSize(*send);
+    group->Run(rank, send, recv, [&](const std::vector<const void*>& ins) {
+      for (int r = 0; r < world_size; ++r) {
+        std::memcpy(static_cast<char*>(DataPtr(recv)) + r * nbytes, ins[r], nbytes);
+      }
+    });
+  }
+
+  void ReduceScatter(const DLTensor* send, DLTensor* recv, ReduceKind op) final {
+    int64_t count = NumElements(recv);
+    group->Run(rank, send, recv, [&](const std::vector<const void*>& ins) {
+      Reduce(send->dtype, ins, rank * count, count, op, DataPtr(recv));
+    });
+  }
+
+  static constexpr const char* _type_key = "relax.vm.CPUCommunicator";
+  TVM_DECLARE_FINAL_OBJECT_INFO(CPUCommunicatorObj, CommunicatorObj);
+
+ private:
+  static void Reduce(DLDataType dtype, const std::vector<const void*>& ins, int64_t offset,
+                     int64_t count, ReduceKind op, void* out) {
+    CHECK_EQ(dtype.lanes, 1) << "ValueError: The collectives do not support vector types";
+    if (dtype.code == kDLFloat && dtype.bits == 32) {
+      ReduceElements<float>(ins, offset, count, op, out);
+    } else if (dtype.code == kDLFloat && dtype.bits == 64) {
+      ReduceElements<double>(ins, offset, count, op, out);
+    } else if (dtype.code == kDLInt && dtype.bits == 32) {
+      ReduceElements<int32_t>(ins, offset, count, op, out);
+    } else if (dtype.code == kDLInt && dtype.bits == 64) {
+      ReduceElements<int64_t>(ins, offset, count, op, out);
+    } else {
+      LOG(FATAL) << "ValueError: The CPU collectives do not support " << dtype;
+    }
+  }
+};
+
+TVM_REGISTER_OBJECT_TYPE(CPUCommunicatorObj);
+
+TVM_REGISTER_GLOBAL("vm.builtin.ccl.cpu_group").set_body_typed([](int world_size) {
+  CHECK_GT(world_size, 0) << "ValueError: A group needs at least one rank";
+  auto group = std::make_shared<CPUGroup>(world_size);
+  Array<Communicator> comms;
+  for (int rank = 0; rank < world_size; ++rank) {
+    auto n = make_object<CPUCommunicatorObj>();
+    n->rank = rank;
+    n->world_size = world_size;
+    n->device = Device{kDLCPU, 0};
+    n->group = group;
+    comms.push_back(Communicator(n));
+  }
+  return comms;
+});
+
+TVM_REGISTER_GLOBAL("vm.builtin.ccl.rank").set_body_typed([](Communicator comm) {
+  return comm->rank;
+});
+
+TVM_REGISTER_GLOBAL("vm.builtin.ccl.world_size").set_body_typed([](Communicator comm) {
+  return comm->world_size;
+});
+
+/*! \brief The communicator set on the VM. */
+inline CommunicatorObj* GetCommunicator(void* vm_ptr) {
+  VirtualMachine* vm = static_cast<VirtualMachine*>(vm_ptr);
+  CHECK(vm->communicator.defined())
+      << "ValueError: The executable calls collectives, but no communicator is set on the VM, "
+         "see set_communicator";
+  return static_cast<CommunicatorObj*>(const_cast<Object*>(vm->communicator.get()));
+}
+
+/*! \brief Allocate the output of a collective from the allocator of the device of the input. */
+NDArray AllocOutput(void* vm_ptr, const NDArray& data, int64_t dim0) {
+  VirtualMachine* vm = static_cast<VirtualMachine*>(vm_ptr);
+  CHECK(data.IsContiguous()) << "ValueError: The input of a collective must be contiguous";
+  std::vector<int64_t> shape(data->shape, data->shape + data->ndim);
+  shape[0] = dim0;
+  for (size_t i = 0; i < vm->devices.size(); ++i) {
+    if (vm->devices[i].device_type == data->device.device_type &&
+        vm->devices[i].device_id == data->device.device_id) {
+      return vm->allocators[i]->Empty(shape, data->dtype, data->device);
+    }
+  }
+  return NDArray::Empty(ShapeTuple(shape), data->dtype, data->device);
+}
+
+/*! \brief The first dimension of the chunk of a rank, checking that it divides the tensor. */
+inline int64_t ChunkDim(const CommunicatorObj* comm, const NDArray& data) {
+  CHECK_GE(data->ndim, 1) << "ValueError: A collective needs a tensor of at least one dimension";
+  CHECK_EQ(data->shape[0] % comm->world_size, 0)
+      << "ValueError: The first dimension " << data->shape[0] << " is not divisible by the "
+      << comm->world_size << " ranks";
+  return data->shape[0] / comm->world_size;
+}
+
+TVM_REGISTER_GLOBAL("vm.builtin.ccl.allreduce")
+    .set_body_typed([](void* vm_ptr, NDArray data, String op_type) {
+      CommunicatorObj* comm = GetCommunicator(vm_ptr);
+      NDArray out = AllocOutput(vm_ptr, data, data->shape[0]);
+      comm->AllReduce(data.operator->(), const_cast<DLTensor*>(out.operator->()),
+                      ParseReduceKind(op_type));
+      return out;
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.ccl.allgather").set_body_typed([](void* vm_ptr, NDArray data) {
+  CommunicatorObj* comm = GetCommunicator(vm_ptr);
+  NDArray out = AllocOutput(vm_ptr, data, data->shape[0] * comm->world_size);
+  comm->AllGather(data.operator->(), const_cast<DLTensor*>(out.operator->()));
+  return out;
+});
+
+TVM_REGISTER_GLOBAL("vm.builtin.ccl.reduce_scatter")
+    .set_body_typed([](void* vm_ptr, NDArray data, String op_type) {
+      CommunicatorObj* comm = GetCommunicator(vm_ptr);
+      NDArray out = AllocOutput(vm_ptr, data, ChunkDim(comm, data));
+      comm->ReduceScatter(data.operator->(), const_cast<DLTensor*>(out.operator->()),
+                          ParseReduceKind(op_type));
+      return out;
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.ccl.local_shard").set_body_typed([](void* vm_ptr, NDArray data) {
+  CommunicatorObj* comm = GetCommunicator(vm_ptr);
+  CHECK(data.IsContiguous()) << "ValueError: The input of local_shard must be contiguous";
+  int64_t dim0 = ChunkDim(comm, data);
+  std::vector<int64_t> shape(data->shape, data->shape + data->ndim);
+  shape[0] = dim0;
+  uint64_t chunk_bytes = GetDataSize(*data.operator->()) / comm->world_size;
+  return data.CreateView(ShapeTuple(shape), data->dtype, comm->rank * chunk_bytes);
+});
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,93 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/collective.h
+ * \brief The communicators of the collectives of the Relax VM.
+ *
+ * A group of VMs, one per device, runs the same program on the shards of a model, e.g. as split
+ * by the ShardTensorParallel pass, and each VM calls the collectives on the communicator of its
+ * rank set by set_communicator. The collectives work along the first axis of the tensors, which
+ * is contiguous.
+ */
+#ifndef TVM_RUNTIME_RELAX_VM_COLLECTIVE_H_
+#define TVM_RUNTIME_RELAX_VM_COLLECTIVE_H_
+
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/object.h>
+
+#include <string>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*! \brief The reduction of a collective. */
+enum class ReduceKind : int {
+  kSum = 0,
+  kProd = 1,
+  kMin = 2,
+  kMax = 3,
+};
+
+inline ReduceKind ParseReduceKind(const std::string& op_type) {
+  if (op_type == "sum") return ReduceKind::kSum;
+  if (op_type == "prod") return ReduceKind::kProd;
+  if (op_type == "min") return ReduceKind::kMin;
+  if (op_type == "max") return ReduceKind::kMax;
+  LOG(FATAL) << "ValueError: Unknown reduction of a collective: " << op_type;
+  return ReduceKind::kSum;
+}
+
+/*!
+ * \brief The communicator of a rank of a group. The collectives are enqueued on the current
+ * stream of the device, and every rank of the group must call them in the same order.
+ */
+class CommunicatorObj : public Object {
+ public:
+  /*! \brief The rank of the communicator in its group. */
+  int rank;
+  /*! \brief The number of ranks of the group. */
+  int world_size;
+  /*! \brief The device of the tensors of the rank. */
+  Device device;
+
+  /*! \brief Reduce send over the group into recv, of the same shape. */
+  virtual void AllReduce(const DLTensor* send, DLTensor* recv, ReduceKind op) = 0;
+  /*! \brief Concatenate send of the ranks in rank order into recv, world_size times larger. */
+  virtual void AllGather(const DLTensor* send, DLTensor* recv) = 0;
+  /*! \brief Reduce send over the group, recv getting the chunk of the rank of the result. */
+  virtual void ReduceScatter(const DLTensor* send, DLTensor* recv, ReduceKind op) = 0;
+
+  static constexpr const char* _type_key = "relax.vm.Communicator";
+  TVM_DECLARE_BASE_OBJECT_INFO(CommunicatorObj, Object);
+};
+
+/*! \brief Managed reference to CommunicatorObj. */
+class Communicator : public ObjectRef {
+ public:
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(Communicator, ObjectRef, CommunicatorObj);
+};
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_RELAX_VM_COLLECTIVE_H_
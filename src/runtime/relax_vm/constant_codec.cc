@@ -0,0 +1,202 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+/*!
+ * \file src/runtime/relax_vm/constant_codec.cc
+ */
+#include "constant_codec.h"
+
+#include <tvm/runtime/builtin_fp16.h>
+#include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/threading_backend.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include "../../support/lz.h"
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*! \brief The size of the independently compressed blocks of the lz codec. */
+constexpr size_t kLZBlockSize = 1 << 20;
+
+ConstantCodec ParseConstantCodec(const std::string& name) {
+  if (name == "none") return ConstantCodec::kNone;
+  if (name == "lz") return ConstantCodec::kLZ;
+  if (name == "fp16") return ConstantCodec::kFloat16;
+  LOG(FATAL) << "ValueError: Unknown constant codec " << name
+             << ", expected one of none, lz and fp16";
+  return ConstantCodec::kNone;
+}
+
+bool CanCompressConstant(const NDArray& arr, ConstantCodec codec) {
+  DLDataType dtype = arr->dtype;
+  switch (codec) {
+    case ConstantCodec::kLZ:
+      return dtype.bits % 8 == 0;
+    case ConstantCodec::kFloat16:
+      return dtype.code == kDLFloat && dtype.bits == 32;
+    default:
+      return false;
+  }
+}
+
+namespace {
+
+/*! \brief The header of a block of the lz codec. */
+struct LZBlockHeader {
+  uint32_t raw_size;
+  uint32_t stored_size;
+  /*! \brief Whether the block is compressed, or stored as it is when that is smaller. */
+  uint32_t compressed;
+};
+
+}  // namespace
+
+std::string CompressConstant(const NDArray& arr, ConstantCodec codec) {
+  ICHECK(CanCompressConstant(arr, codec));
+  size_t nbytes = GetDataSize(*arr.operator->());
+  std::vector<uint8_t> raw(nbytes);
+  arr.CopyToBytes(raw.data(), nbytes);
+  std::string out;
+  if (codec == ConstantCodec::kFloat16) {
+    size_t num_elems = nbytes / sizeof(float);
+    out.resize(num_elems * sizeof(uint16_t));
+    for (size_t i = 0; i < num_elems; ++i) {
+      float value;
+      std::memcpy(&value, &raw[i * sizeof(float)], sizeof(float));
+      uint16_t half = __gnu_f2h_ieee(value);
+      std::memcpy(&out[i * sizeof(uint16_t)], &half, sizeof(uint16_t));
+    }
+    return out;
+  }
+
+  size_t elem_bytes = std::max<size_t>(arr->dtype.bits * arr->dtype.lanes / 8, 1);
+  size_t block_size = std::max(kLZBlockSize / elem_bytes, size_t(1)) * elem_bytes;
+  std::vector<uint8_t> shuffled;
+  std::string block;
+  for (size_t begin = 0; begin < nbytes; begin += block_size) {
+    size_t size = std::min(block_size, nbytes - begin);
+    shuffled.resize(size);
+    support::ShuffleBytes(raw.data() + begin, size, elem_bytes, shuffled.data());
+    block.clear();
+    support::LZCompress(shuffled.data(), size, &block);
+    LZBlockHeader header;
+    header.raw_size = static_cast<uint32_t>(size);
+    header.compressed = block.size() < size;
+    header.stored_size = static_cast<uint32_t>(header.compressed ? block.size() : size);
+    out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (header.compressed) {
+      out.append(block);
+    } else {
+      out.append(reinterpret_cast<const char*>(shuffled.data()), size);
+    }
+  }
+  return out;
+}
+
+/*!
+ * \brief Decompress the contents of a constant into its CPU array.
+ * \return Whether the contents were well formed.
+ */
+bool DecompressConstant(const CompressedConstant& constant) {
+  const DLTensor* tensor = constant.array.operator->();
+  uint8_t* dst = static_cast<uint8_t*>(tensor->data) + tensor->byte_offset;
+  size_t nbytes = GetDataSize(*tensor);
+  const uint8_t* src = reinterpret_cast<const uint8_t*>(constant.payload.data());
+  size_t size = constant.payload.size();
+  if (constant.codec == ConstantCodec::kFloat16) {
+    if (size * 2 != nbytes) return false;
+    for (size_t i = 0; i < size / sizeof(uint16_t); ++i) {
+      uint16_t half;
+      std::memcpy(&half, src + i * sizeof(uint16_t), sizeof(uint16_t));
+      float value = __gnu_h2f_ieee(half);
+      std::memcpy(dst + i * sizeof(float), &value, sizeof(float));
+    }
+    return true;
+  }
+  if (constant.codec != ConstantCodec::kLZ) return false;
+
+  size_t elem_bytes = std::max<size_t>(tensor->dtype.bits * tensor->dtype.lanes / 8, 1);
+  std::vector<uint8_t> shuffled;
+  size_t pos = 0;
+  size_t written = 0;
+  while (pos < size) {
+    LZBlockHeader header;
+    if (size - pos < sizeof(header)) return false;
+    std::memcpy(&header, src + pos, sizeof(header));
+    pos += sizeof(header);
+    if (header.stored_size > size - pos || header.raw_size > nbytes - written ||
+        header.raw_size % elem_bytes != 0) {
+      return false;
+    }
+    shuffled.resize(header.raw_size);
+    if (header.compressed) {
+      if (!support::LZDecompress(src + pos, header.stored_size, shuffled.data(),
+                                 header.raw_size)) {
+        return false;
+      }
+    } else {
+      if (header.stored_size != header.raw_size) return false;
+      std::memcpy(shuffled.data(), src + pos, header.raw_size);
+    }
+    pos += header.stored_size;
+    support::UnshuffleBytes(shuffled.data(), header.raw_size, elem_bytes, dst + written);
+    written += header.raw_size;
+  }
+  return written == nbytes;
+}
+
+bool DecompressConstants(std::vector<CompressedConstant>* constants) {
+  if (constants->empty()) return true;
+  struct Task {
+    std::vector<CompressedConstant>* constants;
+    std::atomic<size_t> next{0};
+    std::atomic<bool> ok{true};
+
+    static int Run(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+      Task* task = static_cast<Task*>(cdata);
+      // the workers take the constants one at a time, as their sizes vary widely
+      for (size_t i = task->next++; i < task->constants->size(); i = task->next++) {
+        if (!DecompressConstant((*task->constants)[i])) task->ok = false;
+      }
+      return 0;
+    }
+  };
+  Task task;
+  task.constants = constants;
+  int num_tasks =
+      std::min<int>(threading::MaxConcurrency(), static_cast<int>(constants->size()));
+  if (num_tasks <= 1) {
+    Task::Run(0, nullptr, &task);
+  } else {
+    ICHECK_EQ(TVMBackendParallelLaunch(Task::Run, &task, num_tasks), 0)
+        << "TVMBackendParallelLaunch failed";
+  }
+  return task.ok;
+}
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
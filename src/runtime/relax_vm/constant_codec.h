@@ -0,0 +1,94 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+/*!
+ * \file src/runtime/relax_vm/constant_codec.h
+ * \brief The codecs compressing the NDArray constants saved in a Relax VM executable.
+ */
+#ifndef TVM_RUNTIME_RELAX_VM_CONSTANT_CODEC_H_
+#define TVM_RUNTIME_RELAX_VM_CONSTANT_CODEC_H_
+
+#include <tvm/runtime/ndarray.h>
+
+#include <string>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*! \brief The codecs of the NDArray constants, persisted in the executable. */
+enum class ConstantCodec : int {
+  /*! \brief The contents are saved as they are. */
+  kNone = 0,
+  /*!
+   * \brief Lossless. The bytes of the elements are grouped by their position in the element,
+   *  then LZ77 compressed by independent blocks.
+   */
+  kLZ = 1,
+  /*! \brief Lossy. The float32 elements are saved as float16 and widened back at load. */
+  kFloat16 = 2,
+};
+
+/*!
+ * \brief Get a codec by name.
+ * \param name The name of the codec, one of "none", "lz" and "fp16".
+ * \return The codec.
+ */
+ConstantCodec ParseConstantCodec(const std::string& name);
+
+/*!
+ * \brief Whether a codec applies to an NDArray constant.
+ * \param arr The constant.
+ * \param codec The codec.
+ * \return Whether the constant can be compressed by the codec.
+ */
+bool CanCompressConstant(const NDArray& arr, ConstantCodec codec);
+
+/*!
+ * \brief Compress the contents of an NDArray constant.
+ * \param arr The constant, on any device.
+ * \param codec The codec, which must apply to the constant.
+ * \return The compressed contents.
+ */
+std::string CompressConstant(const NDArray& arr, ConstantCodec codec);
+
+/*! \brief A constant whose contents are to be decompressed. */
+struct CompressedConstant {
+  /*! \brief The codec of the contents. */
+  ConstantCodec codec;
+  /*! \brief The compressed contents. */
+  std::string payload;
+  /*! \brief The CPU NDArray receiving the decompressed contents. */
+  NDArray array;
+};
+
+/*!
+ * \brief Decompress constants into their arrays, in parallel on the runtime thread pool.
+ * \param constants The constants.
+ * \return Whether all the contents were well formed.
+ */
+bool DecompressConstants(std::vector<CompressedConstant>* constants);
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_RELAX_VM_CONSTANT_CODEC_H_
@@ -0,0 +1,105 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/cuda/cuda_graph_builtin.cc
+ * \brief The CUDA graph capture and replay support of the Relax VM.
+ *
+ *  The kernels launched by a VM function are captured on a CUDA stream into a
+ *  CUDA graph, which can then be replayed with a single graph launch. Replaying
+ *  a graph only reruns the captured GPU work, so it only applies to static-shape
+ *  functions whose host side work (e.g. shape computation) does not change the result.
+ */
+
+#include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/registry.h>
+
+#include "../../cuda/cuda_common.h"
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*! \brief An object holding a CUDA graph captured from a VM function. */
+class CUDAGraphExecObj : public Object {
+ public:
+  /*! \brief The device where the graph is captured. */
+  Device device;
+  /*! \brief The stream on which the graph is captured and launched. */
+  TVMStreamHandle stream{nullptr};
+  /*! \brief The instantiated graph. */
+  cudaGraphExec_t graph_exec{nullptr};
+
+  ~CUDAGraphExecObj() {
+    if (graph_exec != nullptr) {
+      CUDA_CALL(cudaGraphExecDestroy(graph_exec));
+    }
+    if (stream != nullptr) {
+      TVMStreamFree(device.device_type, device.device_id, stream);
+    }
+  }
+
+  static constexpr const uint32_t _type_index = TypeIndex::kDynamic;
+  static constexpr const char* _type_key = "relax.vm.CUDAGraphExec";
+  TVM_DECLARE_FINAL_OBJECT_INFO(CUDAGraphExecObj, Object);
+};
+
+/*! \brief Reference to CUDAGraphExecObj. */
+class CUDAGraphExec : public ObjectRef {
+ public:
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(CUDAGraphExec, ObjectRef, CUDAGraphExecObj);
+};
+
+TVM_REGISTER_OBJECT_TYPE(CUDAGraphExecObj);
+
+TVM_REGISTER_GLOBAL("vm.builtin.cuda_graph.begin_capture").set_body_typed([](Device dev) {
+  ICHECK_EQ(dev.device_type, kDLCUDA) << "CUDA graph can only be captured on CUDA devices";
+  ObjectPtr<CUDAGraphExecObj> n = make_object<CUDAGraphExecObj>();
+  n->device = dev;
+  TVMStreamCreate(dev.device_type, dev.device_id, &n->stream);
+  // the kernels launched by the VM go to the current stream of the thread
+  TVMSetStream(dev.device_type, dev.device_id, n->stream);
+  CUDA_CALL(cudaStreamBeginCapture(static_cast<cudaStream_t>(n->stream),
+                                   cudaStreamCaptureModeGlobal));
+  return CUDAGraphExec(n);
+});
+
+TVM_REGISTER_GLOBAL("vm.builtin.cuda_graph.end_capture").set_body_typed([](CUDAGraphExec exec) {
+  cudaGraph_t graph;
+  CUDA_CALL(cudaStreamEndCapture(static_cast<cudaStream_t>(exec->stream), &graph));
+  TVMSetStream(exec->device.device_type, exec->device.device_id, nullptr);
+
+  size_t num_nodes = 0;
+  CUDA_CALL(cudaGraphGetNodes(graph, nullptr, &num_nodes));
+  DLOG(INFO) << "Num of nodes in the cuda graph created using stream capture API = " << num_nodes;
+
+  CUDA_CALL(cudaGraphInstantiate(&exec->graph_exec, graph, nullptr, nullptr, 0));
+  CUDA_CALL(cudaGraphDestroy(graph));
+});
+
+TVM_REGISTER_GLOBAL("vm.builtin.cuda_graph.launch").set_body_typed([](CUDAGraphExec exec) {
+  ICHECK(exec->graph_exec != nullptr) << "The CUDA graph capture is not finished yet";
+  cudaStream_t stream = static_cast<cudaStream_t>(exec->stream);
+  CUDA_CALL(cudaGraphLaunch(exec->graph_exec, stream));
+  CUDA_CALL(cudaStreamSynchronize(stream));
+});
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
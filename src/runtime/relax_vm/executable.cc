@@ -22,14 +22,25 @@
  */
 
 #include <dmlc/memory_io.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/relax_vm/executable.h>
 #include <tvm/runtime/relax_vm/vm.h>
 
+#include <cstring>
 #include <functional>
+#include <memory>
 #include <sstream>
 
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "../file_utils.h"
+#include "constant_codec.h"
 
 namespace tvm {
 namespace runtime {
@@ -37,6 +48,39 @@ namespace relax_vm {
 
 /*! \brief The magic number for the serialized VM bytecode file  */
 constexpr uint64_t kTVMVMBytecodeMagic = 0xD225DE2F4214151D;
+/*!
+ * \brief The magic number of the executable files whose NDArray constants are stored after the
+ * other sections, at the offset following the magic number.
+ */
+constexpr uint64_t kTVMVMMappableFileMagic = 0xD225DE2F4214151E;
+/*! \brief The alignment of the constant data in an executable file, to be mapped by pages. */
+constexpr uint64_t kConstantDataAlignment = 4096;
+/*! \brief The version of the section table layout following the header. */
+constexpr uint64_t kTVMVMSectionFormatVersion = 1;
+
+/*! \brief The sections of a serialized executable, in the order they are loaded. */
+enum SectionKind : uint64_t {
+  kGlobalSection = 0,
+  kConstantSection = 1,
+  kPackedFuncSection = 2,
+  kCodeSection = 3,
+  kNumSections = 4,
+};
+
+/*! \brief The names of the sections, indexed by SectionKind. */
+static const char* kSectionNames[] = {"global", "constant", "packed func names", "code"};
+
+/*!
+ * \brief An entry of the section table, locating a section from the start of the serialized
+ * executable so that it can be skipped, mapped or rewritten without parsing the others.
+ */
+struct SectionEntry {
+  uint64_t kind;
+  uint64_t offset;
+  uint64_t size;
+  /*! \brief The FNV-1a hash of the section contents. */
+  uint64_t checksum;
+};
 
 /*! \brief Possible types in the constant pool */
 enum ConstantType : int {
@@ -45,6 +89,10 @@ enum ConstantType : int {
   kShapeTuple = 2,
   kString = 3,
   kInt = 4,
+  /*! \brief An NDArray whose contents are stored out of the constant section. */
+  kExternalNDArray = 5,
+  /*! \brief An NDArray whose contents are compressed by a ConstantCodec. */
+  kCompressedNDArray = 6,
 };
 
 #define STREAM_CHECK(val, section)                                          \
@@ -69,6 +117,11 @@ PackedFunc Executable::GetFunction(const std::string& name, const ObjectPtr<Obje
   } else if (name == "as_python") {
     return PackedFunc(
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->AsPython(); });
+  } else if (name == "set_constant_codec") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      constant_codec = static_cast<int>(ParseConstantCodec(args[0]));
+      constant_codec_min_bytes = args[1];
+    });
   } else if (name == "vm_load_executable") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
       ObjectPtr<VirtualMachine> vm = make_object<VirtualMachine>();
@@ -183,6 +236,62 @@ Instruction Executable::GetInstruction(Index i) const {
       Index false_offset = instr_data[offset + 2];
       return Instruction::If(cond, false_offset);
     }
+    case Opcode::AllocStorageTensor: {
+      RegName dst = instr_data[offset + 1];
+      RegName storage = instr_data[offset + 2];
+      ExecWord* args = const_cast<ExecWord*>(&instr_data[offset + 3]);
+      return Instruction::AllocStorageTensor(storage, reinterpret_cast<Instruction::Arg*>(args),
+                                             dst);
+    }
+    case Opcode::LoadShapeCall: {
+      RegName dst = instr_data[offset + 1];
+      Index func_idx = instr_data[offset + 2];
+      Index num_args = instr_data[offset + 3];
+      ExecWord* args = const_cast<ExecWord*>(&instr_data[offset + 4]);
+      ExecWord* shape_args = args + num_args;
+      return Instruction::LoadShapeCall(func_idx, num_args,
+                                        reinterpret_cast<Instruction::Arg*>(args),
+                                        reinterpret_cast<Instruction::Arg*>(shape_args), dst);
+    }
+    case Opcode::LoadShape:
+    case Opcode::StoreShape:
+    case Opcode::ComputeShape: {
+      RegName dst = instr_data[offset + 1];
+      RegName heap = instr_data[offset + 2];
+      RegName shape = instr_data[offset + 3];
+      Index num_args = instr_data[offset + 4];
+      ExecWord* args = const_cast<ExecWord*>(&instr_data[offset + 5]);
+      if (op == Opcode::LoadShape) return Instruction::LoadShape(heap, num_args, args, dst);
+      if (op == Opcode::StoreShape) return Instruction::StoreShape(shape, heap, num_args, args);
+      return Instruction::ComputeShape(heap, num_args, args);
+    }
+    case Opcode::Move: {
+      RegName dst = instr_data[offset + 1];
+      RegName src = instr_data[offset + 2];
+      return Instruction::Move(src, dst);
+    }
+    case Opcode::LoadConst: {
+      RegName dst = instr_data[offset + 1];
+      Index const_idx = instr_data[offset + 2];
+      return Instruction::LoadConst(const_idx, dst);
+    }
+    case Opcode::MakeTuple: {
+      RegName dst = instr_data[offset + 1];
+      Index num_fields = instr_data[offset + 2];
+      ExecWord* fields = const_cast<ExecWord*>(&instr_data[offset + 3]);
+      return Instruction::MakeTuple(num_fields, reinterpret_cast<Instruction::Arg*>(fields), dst);
+    }
+    case Opcode::GetTupleItem: {
+      RegName dst = instr_data[offset + 1];
+      RegName tuple = instr_data[offset + 2];
+      Index index = instr_data[offset + 3];
+      return Instruction::GetTupleItem(tuple, index, dst);
+    }
+    case Opcode::Kill: {
+      Index num_regs = instr_data[offset + 1];
+      RegName* regs = const_cast<RegName*>(&instr_data[offset + 2]);
+      return Instruction::Kill(num_regs, regs);
+    }
     default:
       LOG(FATAL) << "should never hit this case: " << static_cast<int>(op);
       break;
@@ -209,76 +318,253 @@ void LoadHeader(dmlc::Stream* strm) {
   STREAM_CHECK(version == TVM_VERSION, "version");
 }
 
-void Executable::SaveToBinary(dmlc::Stream* stream) {
-  std::string code;
-  // Initialize the stream object.
-  dmlc::MemoryStringStream strm(&code);
-
-  // Save header
-  SaveHeader(&strm);
+uint64_t SectionChecksum(const char* data, size_t size) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ static_cast<uint8_t>(data[i])) * 0x100000001b3ULL;
+  }
+  return hash;
+}
 
-  // Global section.
-  SaveGlobalSection(&strm);
+/*!
+ * \brief Read the header and the section table of a serialized executable.
+ * \param data The serialized executable.
+ * \param size The size of the serialized executable.
+ * \return The section table, in the order of SectionKind, checked to fit in the data.
+ */
+std::vector<SectionEntry> LoadSectionTable(char* data, size_t size) {
+  dmlc::MemoryFixedSizeStream strm(data, size);
+  LoadHeader(&strm);
+  uint64_t format_version, num_sections;
+  STREAM_CHECK(strm.Read(&format_version) && format_version == kTVMVMSectionFormatVersion,
+               "section table");
+  STREAM_CHECK(strm.Read(&num_sections) && num_sections == kNumSections, "section table");
+  std::vector<SectionEntry> table(num_sections);
+  for (uint64_t i = 0; i < num_sections; ++i) {
+    SectionEntry& entry = table[i];
+    STREAM_CHECK(strm.Read(&entry.kind) && strm.Read(&entry.offset) && strm.Read(&entry.size) &&
+                     strm.Read(&entry.checksum),
+                 "section table");
+    STREAM_CHECK(entry.kind == i && entry.offset <= size && entry.size <= size - entry.offset,
+                 "section table");
+  }
+  return table;
+}
 
-  // Constant section.
-  SaveConstantSection(&strm);
+std::string Executable::SaveSections(std::string* constant_data) {
+  std::vector<std::string> sections(kNumSections);
+  {
+    dmlc::MemoryStringStream strm(&sections[kGlobalSection]);
+    SaveGlobalSection(&strm);
+  }
+  {
+    dmlc::MemoryStringStream strm(&sections[kConstantSection]);
+    SaveConstantSection(&strm, constant_data);
+  }
+  {
+    dmlc::MemoryStringStream strm(&sections[kPackedFuncSection]);
+    SavePackedFuncNames(&strm);
+  }
+  {
+    dmlc::MemoryStringStream strm(&sections[kCodeSection]);
+    SaveCodeSection(&strm);
+  }
 
-  // Packedfunc names section.
-  SavePackedFuncNames(&strm);
+  // header, format version, section table, sections
+  std::string code;
+  dmlc::MemoryStringStream strm(&code);
+  SaveHeader(&strm);
+  strm.Write(kTVMVMSectionFormatVersion);
+  strm.Write(static_cast<uint64_t>(kNumSections));
+  uint64_t offset = code.size() + sizeof(uint64_t) * 4 * kNumSections;
+  for (uint64_t i = 0; i < kNumSections; ++i) {
+    strm.Write(i);
+    strm.Write(offset);
+    strm.Write(static_cast<uint64_t>(sections[i].size()));
+    strm.Write(SectionChecksum(sections[i].data(), sections[i].size()));
+    offset += sections[i].size();
+  }
+  for (const std::string& section : sections) {
+    code.append(section);
+  }
+  return code;
+}
 
-  // Code section.
-  SaveCodeSection(&strm);
+ObjectPtr<Executable> Executable::LoadSections(
+    char* data, size_t size,
+    const std::function<NDArray(ShapeTuple, DLDataType, uint64_t)>& fload_data) {
+  std::vector<SectionEntry> table = LoadSectionTable(data, size);
+  for (const SectionEntry& entry : table) {
+    STREAM_CHECK(SectionChecksum(data + entry.offset, entry.size) == entry.checksum,
+                 kSectionNames[entry.kind]);
+  }
+  auto section_data = [&](SectionKind kind) { return data + table[kind].offset; };
 
-  stream->Write(code);
+  ObjectPtr<Executable> exec = make_object<Executable>();
+  dmlc::MemoryFixedSizeStream global(section_data(kGlobalSection), table[kGlobalSection].size);
+  exec->LoadGlobalSection(&global);
+  dmlc::MemoryFixedSizeStream constant(section_data(kConstantSection),
+                                       table[kConstantSection].size);
+  exec->LoadConstantSection(&constant, fload_data);
+  dmlc::MemoryFixedSizeStream packed_func(section_data(kPackedFuncSection),
+                                          table[kPackedFuncSection].size);
+  exec->LoadPackedFuncNames(&packed_func);
+  dmlc::MemoryFixedSizeStream code(section_data(kCodeSection), table[kCodeSection].size);
+  exec->LoadCodeSection(&code);
+  return exec;
 }
 
+void Executable::SaveToBinary(dmlc::Stream* stream) { stream->Write(SaveSections(nullptr)); }
+
 void Executable::SaveToFile(const std::string& file_name, const std::string& format) {
+  std::string constant_data;
+  std::string code = SaveSections(&constant_data);
+
+  // magic number, offset of the constant data, sections, padding, constant data
+  uint64_t data_offset = 2 * sizeof(uint64_t) + code.size();
+  data_offset = (data_offset + kConstantDataAlignment - 1) / kConstantDataAlignment *
+                kConstantDataAlignment;
   std::string data;
+  data.reserve(data_offset + constant_data.size());
   dmlc::MemoryStringStream writer(&data);
-  dmlc::SeekStream* strm = &writer;
-  Executable::SaveToBinary(strm);
+  writer.Write(kTVMVMMappableFileMagic);
+  writer.Write(data_offset);
+  writer.Write(code.data(), code.size());
+  data.resize(data_offset, '\0');
+  data.append(constant_data);
   runtime::SaveBinaryToFile(file_name, data);
 }
 
 Module Executable::LoadFromBinary(void* stream) {
   std::string code;
   static_cast<dmlc::Stream*>(stream)->Read(&code);
-  dmlc::MemoryStringStream strm(&code);
-
-  ObjectPtr<Executable> exec = make_object<Executable>();
+  return Module(LoadSections(&code[0], code.size()));
+}
 
-  // Load header.
-  LoadHeader(&strm);
+TVM_REGISTER_GLOBAL("runtime.module.loadbinary_relax.Executable")
+    .set_body_typed(Executable::LoadFromBinary);
 
-  // Global section.
-  exec->LoadGlobalSection(&strm);
+/*!
+ * \brief The contents of an executable file, memory mapped when the platform supports it.
+ *
+ * The mapping is private and writable, so the pages are shared with the page cache unless a
+ * kernel writes to a constant.
+ */
+class ExecutableFile {
+ public:
+  explicit ExecutableFile(const std::string& file_name) {
+#if !defined(_WIN32)
+    int fd = open(file_name.c_str(), O_RDONLY);
+    ICHECK_GE(fd, 0) << "Cannot open " << file_name;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void* ptr = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+      if (ptr != MAP_FAILED) {
+        data_ = static_cast<char*>(ptr);
+        size_ = st.st_size;
+        mapped_ = true;
+      }
+    }
+    close(fd);
+    if (mapped_) return;
+#endif
+    runtime::LoadBinaryFromFile(file_name, &buffer_);
+    data_ = &buffer_[0];
+    size_ = buffer_.size();
+  }
 
-  // Constant section.
-  exec->LoadConstantSection(&strm);
+  ~ExecutableFile() {
+#if !defined(_WIN32)
+    if (mapped_) munmap(data_, size_);
+#endif
+  }
 
-  // Packedfunc names section.
-  exec->LoadPackedFuncNames(&strm);
+  char* data() const { return data_; }
+  size_t size() const { return size_; }
 
-  // Code section.
-  exec->LoadCodeSection(&strm);
+ private:
+  char* data_{nullptr};
+  size_t size_{0};
+  bool mapped_{false};
+  std::string buffer_;
+};
 
-  return Module(exec);
+/*! \brief The deleter of an NDArray viewing the contents of an executable file. */
+static void ExecutableFileNDArrayDeleter(Object* obj) {
+  auto* ptr = static_cast<NDArray::Container*>(obj);
+  delete static_cast<std::shared_ptr<ExecutableFile>*>(ptr->manager_ctx);
+  delete ptr;
 }
 
-TVM_REGISTER_GLOBAL("runtime.module.loadbinary_relax.Executable")
-    .set_body_typed(Executable::LoadFromBinary);
-
 Module Executable::LoadFromFile(const std::string& file_name) {
-  std::string data;
-  runtime::LoadBinaryFromFile(file_name, &data);
-  dmlc::MemoryStringStream reader(&data);
-  dmlc::Stream* strm = &reader;
-  return Executable::LoadFromBinary(reinterpret_cast<void*>(strm));
+  auto file = std::make_shared<ExecutableFile>(file_name);
+  uint64_t magic = 0;
+  if (file->size() >= sizeof(magic)) {
+    std::memcpy(&magic, file->data(), sizeof(magic));
+  }
+  if (magic != kTVMVMMappableFileMagic) {
+    // a file saved by SaveToBinary, with the constant data in the constant section
+    dmlc::MemoryFixedSizeStream reader(file->data(), file->size());
+    dmlc::Stream* strm = &reader;
+    return Executable::LoadFromBinary(reinterpret_cast<void*>(strm));
+  }
+
+  dmlc::MemoryFixedSizeStream strm(file->data(), file->size());
+  uint64_t data_offset;
+  STREAM_CHECK(strm.Read(&magic) && strm.Read(&data_offset), "header");
+  STREAM_CHECK(data_offset >= 2 * sizeof(uint64_t) && data_offset <= file->size(), "header");
+  char* data = file->data() + data_offset;
+  size_t data_size = file->size() - data_offset;
+  auto fload_data = [&](ShapeTuple shape, DLDataType dtype, uint64_t offset) -> NDArray {
+    Device cpu{kDLCPU, 0};
+    NDArray::Container* container = new NDArray::Container(nullptr, shape, dtype, cpu);
+    size_t nbytes = GetDataSize(container->dl_tensor);
+    STREAM_CHECK(offset + nbytes <= data_size, "constant");
+    char* ptr = data + offset;
+    if (reinterpret_cast<uintptr_t>(ptr) % kAllocAlignment != 0) {
+      // the contents are not mapped, copy them to an aligned array
+      delete container;
+      NDArray arr = NDArray::Empty(shape, dtype, cpu);
+      arr.CopyFromBytes(ptr, nbytes);
+      return arr;
+    }
+    container->SetDeleter(ExecutableFileNDArrayDeleter);
+    container->manager_ctx = new std::shared_ptr<ExecutableFile>(file);
+    container->dl_tensor.data = ptr;
+    return NDArray(GetObjectPtr<Object>(container));
+  };
+
+  char* code = file->data() + 2 * sizeof(uint64_t);
+  return Module(LoadSections(code, data_offset - 2 * sizeof(uint64_t), fload_data));
 }
 
 TVM_REGISTER_GLOBAL("runtime.module.loadfile_relax.Executable")
     .set_body_typed(Executable::LoadFromFile);
 
+String Executable::SectionTable(const std::string& file_name) {
+  ExecutableFile file(file_name);
+  uint64_t magic = 0;
+  if (file.size() >= sizeof(magic)) {
+    std::memcpy(&magic, file.data(), sizeof(magic));
+  }
+  // the sections follow the constant data offset, or the length of the binary string
+  uint64_t base = magic == kTVMVMMappableFileMagic ? 2 * sizeof(uint64_t) : sizeof(uint64_t);
+  STREAM_CHECK(file.size() >= base, "header");
+  std::vector<SectionEntry> table = LoadSectionTable(file.data() + base, file.size() - base);
+  std::ostringstream os;
+  os << "[";
+  for (size_t i = 0; i < table.size(); ++i) {
+    os << (i == 0 ? "" : ", ") << "{\"name\": \"" << kSectionNames[table[i].kind]
+       << "\", \"offset\": " << base + table[i].offset << ", \"size\": " << table[i].size
+       << ", \"checksum\": " << table[i].checksum << "}";
+  }
+  os << "]";
+  return os.str();
+}
+
+TVM_REGISTER_GLOBAL("runtime.relax_vm.ExecutableSectionTable")
+    .set_body_typed(Executable::SectionTable);
+
 void SerializeVMFunc(const VMFunction& func, dmlc::Stream* strm) {
   strm->Write(func.name);
   strm->Write(func.start_instr);
@@ -304,10 +590,33 @@ void Executable::SaveGlobalSection(dmlc::Stream* strm) {
   }
 }
 
-void Executable::SaveConstantSection(dmlc::Stream* strm) {
+void Executable::SaveConstantSection(dmlc::Stream* strm, std::string* data) {
   strm->Write(static_cast<uint64_t>(this->constants.size()));
+  auto codec = static_cast<ConstantCodec>(constant_codec);
+  auto compressed = [&](const runtime::NDArray& arr) {
+    return codec != ConstantCodec::kNone &&
+           GetDataSize(*arr.operator->()) >= static_cast<size_t>(constant_codec_min_bytes) &&
+           CanCompressConstant(arr, codec);
+  };
   for (const auto& it : this->constants) {
-    if (it.IsObjectRef<runtime::NDArray>()) {
+    if (it.IsObjectRef<runtime::NDArray>() && compressed(it.operator runtime::NDArray())) {
+      runtime::NDArray arr = it.operator runtime::NDArray();
+      strm->Write(ConstantType::kCompressedNDArray);
+      strm->Write(constant_codec);
+      strm->Write(std::vector<int64_t>(arr.Shape().begin(), arr.Shape().end()));
+      strm->Write(arr->dtype);
+      strm->Write(CompressConstant(arr, codec));
+    } else if (it.IsObjectRef<runtime::NDArray>() && data != nullptr) {
+      runtime::NDArray arr = it.operator runtime::NDArray();
+      uint64_t offset = (data->size() + kAllocAlignment - 1) / kAllocAlignment * kAllocAlignment;
+      size_t nbytes = GetDataSize(*arr.operator->());
+      data->resize(offset + nbytes, '\0');
+      arr.CopyToBytes(&(*data)[offset], nbytes);
+      strm->Write(ConstantType::kExternalNDArray);
+      strm->Write(std::vector<int64_t>(arr.Shape().begin(), arr.Shape().end()));
+      strm->Write(arr->dtype);
+      strm->Write(offset);
+    } else if (it.IsObjectRef<runtime::NDArray>()) {
       strm->Write(ConstantType::kNDArray);
       runtime::SaveDLTensor(strm, it.operator DLTensor*());
     } else if (it.IsObjectRef<ShapeTuple>()) {
@@ -337,6 +646,9 @@ void Executable::SaveConstantSection(dmlc::Stream* strm) {
       }
     }
   }
+  std::vector<Index> devices = constant_devices;
+  devices.resize(constants.size(), 0);
+  strm->Write(devices);
 }
 
 void Executable::SavePackedFuncNames(dmlc::Stream* strm) { strm->Write(func_names); }
@@ -359,7 +671,9 @@ void Executable::LoadGlobalSection(dmlc::Stream* strm) {
   }
 }
 
-void Executable::LoadConstantSection(dmlc::Stream* strm) {
+void Executable::LoadConstantSection(
+    dmlc::Stream* strm,
+    const std::function<NDArray(ShapeTuple, DLDataType, uint64_t)>& fload_data) {
   uint64_t sz;
   // Load the number of constants.
   STREAM_CHECK(strm->Read(&sz, sizeof(sz)), "constant");
@@ -367,6 +681,7 @@ void Executable::LoadConstantSection(dmlc::Stream* strm) {
   size_t size = static_cast<size_t>(sz);
   runtime::NDArray ndarray;
   DLDataType dtype;
+  std::vector<CompressedConstant> compressed;
   // Load each of the constants.
   for (size_t i = 0; i < size; i++) {
     int constant_type;
@@ -376,6 +691,27 @@ void Executable::LoadConstantSection(dmlc::Stream* strm) {
       TVMRetValue cell;
       cell = ndarray;
       this->constants.push_back(cell);
+    } else if (constant_type == ConstantType::kExternalNDArray) {
+      std::vector<int64_t> shape;
+      uint64_t offset;
+      STREAM_CHECK(strm->Read(&shape) && strm->Read(&dtype) && strm->Read(&offset), "constant");
+      STREAM_CHECK(fload_data != nullptr, "constant");
+      TVMRetValue cell;
+      cell = fload_data(ShapeTuple(shape), dtype, offset);
+      this->constants.push_back(cell);
+    } else if (constant_type == ConstantType::kCompressedNDArray) {
+      int codec;
+      std::vector<int64_t> shape;
+      std::string payload;
+      STREAM_CHECK(strm->Read(&codec) && strm->Read(&shape) && strm->Read(&dtype) &&
+                       strm->Read(&payload),
+                   "constant");
+      // decompressed after all the constants are read
+      NDArray arr = NDArray::Empty(ShapeTuple(shape), dtype, Device{kDLCPU, 0});
+      compressed.push_back({static_cast<ConstantCodec>(codec), std::move(payload), arr});
+      TVMRetValue cell;
+      cell = arr;
+      this->constants.push_back(cell);
     } else if (constant_type == ConstantType::kShapeTuple) {
       uint64_t size;
       strm->Read(&size);
@@ -412,6 +748,9 @@ void Executable::LoadConstantSection(dmlc::Stream* strm) {
                  << ArgTypeCode2Str(constant_type) << " when loading the VM constant pool.";
     }
   }
+  STREAM_CHECK(strm->Read(&constant_devices), "constant");
+  STREAM_CHECK(constant_devices.size() == constants.size(), "constant");
+  STREAM_CHECK(DecompressConstants(&compressed), "constant");
 }
 
 void Executable::LoadPackedFuncNames(dmlc::Stream* strm) {
@@ -482,6 +821,34 @@ std::string InstrArgToPyStr(Instruction::Arg arg) {
   }
 }
 
+std::string WordToStr(ExecWord word) { return std::to_string(word); }
+
+std::string HeapArgsToStr(const Instruction& instr) {
+  return StrJoin<ExecWord>(instr.heap_args, 0, instr.heap_num_args, ", ", WordToStr);
+}
+
+std::string ShapeProgramToStr(const ExecWord* program, Index num_words) {
+  static const char* op_names[] = {"load", "imm", "store", "add",     "sub",     "mul",
+                                   "div",  "mod", "floordiv", "floormod", "min", "max"};
+  constexpr ExecWord num_ops = sizeof(op_names) / sizeof(op_names[0]);
+  // every op is followed by its operand, the unused ones included
+  ICHECK_EQ(num_words % 2, 0) << "Malformed shape program of " << num_words << " words";
+  std::ostringstream oss;
+  for (Index i = 0; i < num_words; i += 2) {
+    if (i != 0) oss << " ";
+    ICHECK(program[i] >= 0 && program[i] < num_ops)
+        << "Malformed shape program, unknown op " << program[i];
+    ShapeOp op = static_cast<ShapeOp>(program[i]);
+    oss << op_names[program[i]];
+    if (op == ShapeOp::kLoad || op == ShapeOp::kStore) {
+      oss << " h[" << program[i + 1] << "]";
+    } else if (op == ShapeOp::kImm) {
+      oss << " " << program[i + 1];
+    }
+  }
+  return oss.str();
+}
+
 String Executable::AsText() const {
   // print the text format
   std::ostringstream os;
@@ -517,6 +884,68 @@ String Executable::AsText() const {
              << instr.false_offset << "\n";
           break;
         }
+        case Opcode::AllocStorageTensor: {
+          os << std::setw(6) << std::left << "alloc" << std::setw(16) << std::left
+             << "storage+tensor"
+             << " in: " << std::setw(12) << std::left
+             << StrJoin<Instruction::Arg>(instr.alloc_args, 0, Instruction::kNumAllocArgs, ", ",
+                                          InstrArgToStr)
+             << " dst: " << RegNameToStr(instr.storage) << ", " << RegNameToStr(instr.dst)
+             << "\n";
+          break;
+        }
+        case Opcode::LoadShapeCall: {
+          os << std::setw(6) << std::left << "call" << std::setw(16) << std::left
+             << this->func_names[instr.func_idx] << " in: " << std::setw(12) << std::left
+             << StrJoin<Instruction::Arg>(instr.args, 0, instr.num_args, ", ", InstrArgToStr)
+             << " dst: " << RegNameToStr(instr.dst)
+             << " load: " << InstrArgToStr(instr.shape_args[0]) << " = "
+             << StrJoin<Instruction::Arg>(instr.shape_args, 1, Instruction::kNumShapeArgs - 1, ", ",
+                                          InstrArgToStr)
+             << "\n";
+          break;
+        }
+        case Opcode::LoadShape: {
+          os << std::setw(6) << std::left << "load" << RegNameToStr(instr.heap) << "["
+             << HeapArgsToStr(instr) << "] dst: " << RegNameToStr(instr.dst) << "\n";
+          break;
+        }
+        case Opcode::StoreShape: {
+          os << std::setw(6) << std::left << "store" << RegNameToStr(instr.shape) << " to "
+             << RegNameToStr(instr.heap) << "[" << HeapArgsToStr(instr) << "]\n";
+          break;
+        }
+        case Opcode::ComputeShape: {
+          os << std::setw(6) << std::left << "shape" << RegNameToStr(instr.heap) << ": "
+             << ShapeProgramToStr(instr.heap_args, instr.heap_num_args) << "\n";
+          break;
+        }
+        case Opcode::Move: {
+          os << std::setw(6) << std::left << "move" << RegNameToStr(instr.src)
+             << " dst: " << RegNameToStr(instr.dst) << "\n";
+          break;
+        }
+        case Opcode::LoadConst: {
+          os << std::setw(6) << std::left << "const"
+             << "c[" << instr.const_idx << "] dst: " << RegNameToStr(instr.dst) << "\n";
+          break;
+        }
+        case Opcode::MakeTuple: {
+          os << std::setw(6) << std::left << "tuple"
+             << StrJoin<Instruction::Arg>(instr.fields, 0, instr.num_fields, ", ", InstrArgToStr)
+             << " dst: " << RegNameToStr(instr.dst) << "\n";
+          break;
+        }
+        case Opcode::GetTupleItem: {
+          os << std::setw(6) << std::left << "item" << RegNameToStr(instr.tuple) << "["
+             << instr.item_index << "] dst: " << RegNameToStr(instr.dst) << "\n";
+          break;
+        }
+        case Opcode::Kill: {
+          os << std::setw(6) << std::left << "kill"
+             << StrJoin<RegName>(instr.regs, 0, instr.num_regs, ", ", RegNameToStr) << "\n";
+          break;
+        }
         default:
           LOG(FATAL) << "should never hit this case: " << static_cast<int>(instr.op);
           break;
@@ -539,6 +968,17 @@ String Executable::AsPython() const {
     if ((fidx + 1) < global_funcs.size()) {
       end_instr = global_funcs[fidx + 1].start_instr;
     }
+    // Fused instructions are printed as the calls they fuse, so jump offsets are recounted.
+    auto unfused_offset = [this](size_t idx, Index offset) {
+      size_t begin = offset > 0 ? idx : idx + offset;
+      size_t end = offset > 0 ? idx + offset : idx;
+      Index count = 0;
+      for (size_t i = begin; i < end; ++i) {
+        Opcode op = this->GetInstruction(i).op;
+        count += (op == Opcode::AllocStorageTensor || op == Opcode::LoadShapeCall) ? 2 : 1;
+      }
+      return offset > 0 ? count : -count;
+    };
     for (size_t idx = start_instr; idx < end_instr; ++idx) {
       Instruction instr = this->GetInstruction(idx);
       switch (instr.op) {
@@ -555,11 +995,74 @@ String Executable::AsPython() const {
           break;
         }
         case Opcode::Goto: {
-          os << "    ib.emit_goto(" << instr.pc_offset << ")\n";
+          os << "    ib.emit_goto(" << unfused_offset(idx, instr.pc_offset) << ")\n";
           break;
         }
         case Opcode::If: {
-          os << "    ib.emit_if(ib.r(" << instr.cond << "), " << instr.false_offset << ")\n";
+          os << "    ib.emit_if(ib.r(" << instr.cond << "), "
+             << unfused_offset(idx, instr.false_offset) << ")\n";
+          break;
+        }
+        case Opcode::AllocStorageTensor: {
+          os << "    ib.emit_call(\"vm.builtin.alloc_storage\", args=[ib.r(vm), "
+             << StrJoin<Instruction::Arg>(instr.alloc_args, 0, 3, ", ", InstrArgToPyStr)
+             << "], dst=ib.r(" << instr.storage << "))\n";
+          os << "    ib.emit_call(\"vm.builtin.alloc_tensor\", args=[ib.r(" << instr.storage
+             << "), " << StrJoin<Instruction::Arg>(instr.alloc_args, 3, 3, ", ", InstrArgToPyStr)
+             << "], dst=ib.r(" << instr.dst << "))\n";
+          break;
+        }
+        case Opcode::LoadShapeCall: {
+          os << "    ib.emit_call(\"vm.builtin.load_shape\", args=["
+             << StrJoin<Instruction::Arg>(instr.shape_args, 1, 2, ", ", InstrArgToPyStr)
+             << "], dst=" << InstrArgToPyStr(instr.shape_args[0]) << ")\n";
+          os << "    ib.emit_call(\"" << this->func_names[instr.func_idx] << "\", args=["
+             << StrJoin<Instruction::Arg>(instr.args, 0, instr.num_args, ", ", InstrArgToPyStr)
+             << "]";
+          if (instr.dst != Instruction::kVoidArg) os << ", dst=ib.r(" << instr.dst << ")";
+          os << ")\n";
+          break;
+        }
+        case Opcode::LoadShape: {
+          os << "    ib.emit_load_shape(ib.r(" << instr.heap << "), [" << HeapArgsToStr(instr)
+             << "], dst=ib.r(" << instr.dst << "))\n";
+          break;
+        }
+        case Opcode::StoreShape: {
+          os << "    ib.emit_store_shape(ib.r(" << instr.shape << "), ib.r(" << instr.heap << "), ["
+             << HeapArgsToStr(instr) << "])\n";
+          break;
+        }
+        case Opcode::ComputeShape: {
+          os << "    ib.emit_compute_shape(ib.r(" << instr.heap << "), [" << HeapArgsToStr(instr)
+             << "])\n";
+          break;
+        }
+        case Opcode::Move: {
+          os << "    ib.emit_move(ib.r(" << instr.src << "), dst=ib.r(" << instr.dst << "))\n";
+          break;
+        }
+        case Opcode::LoadConst: {
+          os << "    ib.emit_load_const(ib.c(" << instr.const_idx << "), dst=ib.r(" << instr.dst
+             << "))\n";
+          break;
+        }
+        case Opcode::MakeTuple: {
+          os << "    ib.emit_make_tuple(["
+             << StrJoin<Instruction::Arg>(instr.fields, 0, instr.num_fields, ", ", InstrArgToPyStr)
+             << "], dst=ib.r(" << instr.dst << "))\n";
+          break;
+        }
+        case Opcode::GetTupleItem: {
+          os << "    ib.emit_get_tuple_item(ib.r(" << instr.tuple << "), " << instr.item_index
+             << ", dst=ib.r(" << instr.dst << "))\n";
+          break;
+        }
+        case Opcode::Kill: {
+          os << "    ib.emit_kill(["
+             << StrJoin<RegName>(instr.regs, 0, instr.num_regs, ", ",
+                                 [](RegName reg) { return "ib.r(" + std::to_string(reg) + ")"; })
+             << "])\n";
           break;
         }
         default:
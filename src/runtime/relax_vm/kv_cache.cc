@@ -0,0 +1,271 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/kv_cache.cc
+ * \brief A paged cache of the keys and values of the attention layers, for the autoregressive
+ * decoding in the VM.
+ *
+ * The cache holds a pool of pages, a tensor of shape (num_pages, 2, page_size, num_heads,
+ * head_dim) whose second axis is the key and the value, allocated once. A sequence is a list of
+ * pages of the pool filled in order, so appending the keys and the values of a step copies only
+ * the new tokens, and the sequences of a batch share the pool. The pages of a released sequence
+ * go back to the free list.
+ *
+ * The builtins are called from Relax with call_packed. The page tables of a batch of sequences
+ * let a paged attention kernel read the pool in place, view gathers a sequence into contiguous
+ * tensors for the kernels that do not.
+ */
+#include <tvm/runtime/container/adt.h>
+#include <tvm/runtime/container/shape_tuple.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/object.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*! \brief Print the shape of an array as (d0, d1, ...). */
+static std::string ShapeToStr(const NDArray& arr) {
+  std::ostringstream os;
+  os << "(";
+  for (int i = 0; i < arr->ndim; ++i) {
+    os << (i == 0 ? "" : ", ") << arr->shape[i];
+  }
+  os << ")";
+  return os.str();
+}
+
+/*! \brief A paged cache of keys and values. */
+class PagedKVCacheObj : public Object {
+ public:
+  /*! \brief The pool of pages, (num_pages, 2, page_size, num_heads, head_dim). */
+  NDArray pool;
+  /*! \brief The pages not held by a sequence, the last one is taken first. */
+  std::vector<int32_t> free_pages;
+
+  /*! \brief A sequence of the cache. */
+  struct Sequence {
+    /*! \brief The pages of the sequence, in order. */
+    std::vector<int32_t> pages;
+    /*! \brief The number of tokens of the sequence. */
+    int64_t length = 0;
+  };
+  /*! \brief The sequences by id. */
+  std::unordered_map<int64_t, Sequence> seqs;
+
+  int64_t page_size() const { return pool->shape[2]; }
+
+  /*! \brief The bytes of the keys or the values of a token. */
+  int64_t token_bytes() const {
+    return pool->shape[3] * pool->shape[4] * ((pool->dtype.bits * pool->dtype.lanes + 7) / 8);
+  }
+
+  /*! \brief The byte offset of the key (kv = 0) or the value (kv = 1) of a token in the pool. */
+  int64_t TokenOffset(int32_t page, int kv, int64_t slot) const {
+    return ((static_cast<int64_t>(page) * 2 + kv) * page_size() + slot) * token_bytes();
+  }
+
+  const Sequence& GetSequence(int64_t seq_id) const {
+    auto it = seqs.find(seq_id);
+    CHECK(it != seqs.end()) << "ValueError: The sequence " << seq_id << " is not in the cache";
+    return it->second;
+  }
+
+  /*!
+   * \brief Append the keys and the values of new tokens to a sequence, creating it if needed.
+   * \param seq_id The id of the sequence.
+   * \param keys The keys, (num_tokens, num_heads, head_dim).
+   * \param values The values, of the shape of the keys.
+   */
+  void Append(int64_t seq_id, NDArray keys, NDArray values) {
+    for (const NDArray& arr : {keys, values}) {
+      CHECK(arr->ndim == 3 && arr->shape[0] == keys->shape[0])
+          << "ValueError: The keys and the values must be (num_tokens, num_heads, head_dim), got "
+          << ShapeToStr(keys) << " and " << ShapeToStr(values);
+      CHECK(arr->shape[1] == pool->shape[3] && arr->shape[2] == pool->shape[4])
+          << "ValueError: The keys and the values must have " << pool->shape[3] << " heads of "
+          << pool->shape[4] << " elements, as the pool";
+      CHECK(arr.DataType() == pool.DataType())
+          << "ValueError: The keys and the values must have the dtype of the pool";
+    }
+    Sequence& seq = seqs[seq_id];
+    int64_t num_tokens = keys->shape[0];
+    int64_t num_new_pages =
+        (seq.length + num_tokens + page_size() - 1) / page_size() - seq.pages.size();
+    CHECK_LE(num_new_pages, static_cast<int64_t>(free_pages.size()))
+        << "ValueError: The cache is out of pages, appending " << num_tokens
+        << " tokens to the sequence " << seq_id << " needs " << num_new_pages << " pages and "
+        << free_pages.size() << " are free";
+    for (int64_t i = 0; i < num_new_pages; ++i) {
+      seq.pages.push_back(free_pages.back());
+      free_pages.pop_back();
+    }
+    // copy the runs of tokens falling in the same page
+    ShapeTuple token_shape = pool.Shape();
+    for (int64_t begin = 0; begin < num_tokens;) {
+      int64_t pos = seq.length + begin;
+      int64_t slot = pos % page_size();
+      int64_t count = std::min(num_tokens - begin, page_size() - slot);
+      ShapeTuple shape{count, token_shape[3], token_shape[4]};
+      int32_t page = seq.pages[pos / page_size()];
+      for (int kv = 0; kv < 2; ++kv) {
+        NDArray src = kv == 0 ? keys : values;
+        NDArray src_view = src.CreateView(shape, src.DataType(), begin * token_bytes());
+        pool.CreateView(shape, pool.DataType(), TokenOffset(page, kv, slot)).CopyFrom(src_view);
+      }
+      begin += count;
+    }
+    seq.length += num_tokens;
+  }
+
+  /*! \brief Gather the keys (kv = 0) or the values (kv = 1) of a sequence. */
+  NDArray Gather(int64_t seq_id, int kv) {
+    const Sequence& seq = GetSequence(seq_id);
+    NDArray out = NDArray::Empty({seq.length, pool->shape[3], pool->shape[4]}, pool.DataType(),
+                                 pool->device);
+    for (int64_t begin = 0; begin < seq.length; begin += page_size()) {
+      int64_t count = std::min(seq.length - begin, page_size());
+      ShapeTuple shape{count, pool->shape[3], pool->shape[4]};
+      int32_t page = seq.pages[begin / page_size()];
+      out.CreateView(shape, out.DataType(), begin * token_bytes())
+          .CopyFrom(pool.CreateView(shape, pool.DataType(), TokenOffset(page, kv, 0)));
+    }
+    return out;
+  }
+
+  /*! \brief Release a sequence, returning its pages to the free list. */
+  void Release(int64_t seq_id) {
+    const Sequence& seq = GetSequence(seq_id);
+    free_pages.insert(free_pages.end(), seq.pages.rbegin(), seq.pages.rend());
+    seqs.erase(seq_id);
+  }
+
+  static constexpr const char* _type_key = "relax.vm.PagedKVCache";
+  TVM_DECLARE_FINAL_OBJECT_INFO(PagedKVCacheObj, Object);
+};
+
+/*! \brief Managed reference to PagedKVCacheObj. */
+class PagedKVCache : public ObjectRef {
+ public:
+  /*!
+   * \brief Create a cache over a pool of pages.
+   * \param pool The pool, (num_pages, 2, page_size, num_heads, head_dim), whose content is
+   * ignored.
+   */
+  explicit PagedKVCache(NDArray pool) {
+    CHECK_EQ(pool->ndim, 5)
+        << "ValueError: The pool must be (num_pages, 2, page_size, num_heads, head_dim), got "
+        << ShapeToStr(pool);
+    CHECK_EQ(pool->shape[1], 2) << "ValueError: The second axis of the pool must be 2, for the "
+                                   "keys and the values";
+    CHECK(pool.IsContiguous()) << "ValueError: The pool must be contiguous";
+    auto n = make_object<PagedKVCacheObj>();
+    n->pool = pool;
+    for (int32_t page = static_cast<int32_t>(pool->shape[0]) - 1; page >= 0; --page) {
+      n->free_pages.push_back(page);
+    }
+    data_ = std::move(n);
+  }
+
+  TVM_DEFINE_MUTABLE_NOTNULLABLE_OBJECT_REF_METHODS(PagedKVCache, ObjectRef, PagedKVCacheObj);
+};
+
+TVM_REGISTER_OBJECT_TYPE(PagedKVCacheObj);
+
+/*!
+ * \brief The id of a sequence, passed as a shape of one element as the index of
+ * vm.runtime.TupleGetItem, since Relax has no integer immediates.
+ */
+inline int64_t SeqId(const ShapeTuple& seq_id) {
+  CHECK_EQ(seq_id.size(), 1) << "ValueError: The id of a sequence must be a shape of one element";
+  return seq_id[0];
+}
+
+TVM_REGISTER_GLOBAL("vm.builtin.paged_kv_cache_create").set_body_typed([](NDArray pool) {
+  return PagedKVCache(pool);
+});
+
+// The cache is returned to thread it through the dataflow of the Relax function.
+TVM_REGISTER_GLOBAL("vm.builtin.paged_kv_cache_append")
+    .set_body_typed([](PagedKVCache cache, ShapeTuple seq_id, NDArray keys, NDArray values) {
+      cache->Append(SeqId(seq_id), keys, values);
+      return cache;
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.paged_kv_cache_view")
+    .set_body_typed([](PagedKVCache cache, ShapeTuple seq_id) {
+      return ADT::Tuple(cache->Gather(SeqId(seq_id), 0), cache->Gather(SeqId(seq_id), 1));
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.paged_kv_cache_release")
+    .set_body_typed([](PagedKVCache cache, ShapeTuple seq_id) {
+      cache->Release(SeqId(seq_id));
+      return cache;
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.paged_kv_cache_length")
+    .set_body_typed([](PagedKVCache cache, ShapeTuple seq_id) {
+      return cache->GetSequence(SeqId(seq_id)).length;
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.paged_kv_cache_num_free_pages")
+    .set_body_typed([](PagedKVCache cache) {
+      return static_cast<int64_t>(cache->free_pages.size());
+    });
+
+/*!
+ * \brief The pages of a batch of sequences, for a paged attention kernel. Returns the pool, the
+ * page tables, an int32 tensor of (batch, max_num_pages) padded with -1, and the lengths, an
+ * int32 tensor of (batch,), the tensors on the device of the pool.
+ */
+TVM_REGISTER_GLOBAL("vm.builtin.paged_kv_cache_page_tables")
+    .set_body_typed([](PagedKVCache cache, ShapeTuple seq_ids) {
+      int64_t batch = seq_ids.size();
+      size_t max_pages = 0;
+      for (int64_t seq_id : seq_ids) {
+        max_pages = std::max(max_pages, cache->GetSequence(seq_id).pages.size());
+      }
+      std::vector<int32_t> tables(batch * max_pages, -1);
+      std::vector<int32_t> lengths(batch);
+      for (int64_t b = 0; b < batch; ++b) {
+        const PagedKVCacheObj::Sequence& seq = cache->GetSequence(seq_ids[b]);
+        std::copy(seq.pages.begin(), seq.pages.end(), tables.begin() + b * max_pages);
+        lengths[b] = static_cast<int32_t>(seq.length);
+      }
+      DLDevice dev = cache->pool->device;
+      NDArray tables_arr =
+          NDArray::Empty({batch, static_cast<int64_t>(max_pages)}, DataType::Int(32), dev);
+      NDArray lengths_arr = NDArray::Empty({batch}, DataType::Int(32), dev);
+      tables_arr.CopyFromBytes(tables.data(), tables.size() * sizeof(int32_t));
+      lengths_arr.CopyFromBytes(lengths.data(), lengths.size() * sizeof(int32_t));
+      return ADT::Tuple(cache->pool, tables_arr, lengths_arr);
+    });
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
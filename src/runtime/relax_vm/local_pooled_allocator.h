@@ -0,0 +1,189 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/runtime/relax_vm/local_pooled_allocator.h
+ * \brief The pooled allocator owned by a single VM, without locks on allocation.
+ */
+#ifndef TVM_RUNTIME_RELAX_VM_LOCAL_POOLED_ALLOCATOR_H_
+#define TVM_RUNTIME_RELAX_VM_LOCAL_POOLED_ALLOCATOR_H_
+
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/relax_vm/memory_manager.h>
+
+#include <algorithm>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*!
+ * \brief The pooled allocator owned by a VM instance.
+ *
+ * Alloc is only called by the VM that owns the allocator, and a VM is used by one thread
+ * at a time, so the pool is accessed without a lock. The buffers can be freed from any
+ * thread, e.g. when an output array is released by the caller, so Free pushes them onto a
+ * lock-free stack that Alloc takes over whenever the pool misses. Only the owner takes the
+ * stack as a whole, which keeps the stack free of the ABA problem.
+ *
+ * The storages allocated from the allocator keep it alive, so that outputs can outlive the VM.
+ */
+class LocalPooledAllocator final : public Allocator {
+ public:
+  static constexpr size_t kDefaultPageSize = 4096;
+
+  explicit LocalPooledAllocator(Device dev, size_t page_size = kDefaultPageSize)
+      : Allocator(kLocalPooled), page_size_(page_size), device_(dev) {}
+
+  ~LocalPooledAllocator() {
+    TakeFreed();
+    ReleaseAll();
+  }
+
+  Buffer Alloc(size_t nbytes, size_t alignment, DLDataType type_hint) override {
+    num_allocs_.fetch_add(1, std::memory_order_relaxed);
+    size_t size = ((nbytes + page_size_ - 1) / page_size_) * page_size_;
+    Buffer buf;
+    if (PopCached(size, &buf) || (TakeFreed() && PopCached(size, &buf))) {
+      num_cache_hits_.fetch_add(1, std::memory_order_relaxed);
+      bytes_cached_.fetch_sub(size, std::memory_order_relaxed);
+      AddInUse(size);
+      return buf;
+    }
+    buf.device = device_;
+    buf.size = size;
+    try {
+      buf.data =
+          runtime::DeviceAPI::Get(device_)->AllocDataSpace(device_, size, alignment, type_hint);
+    } catch (InternalError& err) {
+      LOG(WARNING) << "LocalPooledAllocator got InternalError during allocation: "
+                   << err.message();
+      LOG(WARNING) << "Trying to release all unused memory and reallocate...";
+      TakeFreed();
+      ReleaseAll();
+      buf.data =
+          runtime::DeviceAPI::Get(device_)->AllocDataSpace(device_, size, alignment, type_hint);
+    }
+    num_device_allocs_.fetch_add(1, std::memory_order_relaxed);
+    AddInUse(size);
+    DLOG(INFO) << "allocate " << size << " B";
+    return buf;
+  }
+
+  void Free(const Buffer& buffer) override {
+    FreeNode* node = new FreeNode{buffer, freed_.load(std::memory_order_relaxed)};
+    while (!freed_.compare_exchange_weak(node->next, node, std::memory_order_release,
+                                         std::memory_order_relaxed)) {
+    }
+    bytes_in_use_.fetch_sub(buffer.size, std::memory_order_relaxed);
+    bytes_cached_.fetch_add(buffer.size, std::memory_order_relaxed);
+    DLOG(INFO) << "reclaim buffer " << buffer.size;
+  }
+
+  /*! \note Like Alloc, only the owner of the allocator can query the counters. */
+  AllocatorStats Stats() const override {
+    AllocatorStats stats;
+    stats.bytes_in_use = bytes_in_use_.load(std::memory_order_relaxed);
+    stats.bytes_cached = bytes_cached_.load(std::memory_order_relaxed);
+    stats.peak_bytes_in_use = peak_bytes_in_use_.load(std::memory_order_relaxed);
+    stats.num_allocs = num_allocs_.load(std::memory_order_relaxed);
+    stats.num_cache_hits = num_cache_hits_.load(std::memory_order_relaxed);
+    stats.num_device_allocs = num_device_allocs_.load(std::memory_order_relaxed);
+    stats.num_device_frees = num_device_frees_.load(std::memory_order_relaxed);
+    for (const auto& it : memory_pool_) {
+      if (!it.second.empty()) {
+        stats.largest_cached_block = std::max(stats.largest_cached_block, it.first);
+      }
+    }
+    // the freed nodes are only deleted by the owner, so the stack can be walked here
+    for (FreeNode* node = freed_.load(std::memory_order_acquire); node; node = node->next) {
+      stats.largest_cached_block = std::max(stats.largest_cached_block, node->buffer.size);
+    }
+    return stats;
+  }
+
+ private:
+  struct FreeNode {
+    Buffer buffer;
+    FreeNode* next;
+  };
+
+  bool PopCached(size_t size, Buffer* buf) {
+    auto it = memory_pool_.find(size);
+    if (it == memory_pool_.end() || it->second.empty()) return false;
+    *buf = it->second.back();
+    it->second.pop_back();
+    return true;
+  }
+
+  /*! \brief Move the buffers freed since the last call into the pool. */
+  bool TakeFreed() {
+    FreeNode* node = freed_.exchange(nullptr, std::memory_order_acquire);
+    bool taken = node != nullptr;
+    while (node != nullptr) {
+      memory_pool_[node->buffer.size].push_back(node->buffer);
+      FreeNode* next = node->next;
+      delete node;
+      node = next;
+    }
+    return taken;
+  }
+
+  void AddInUse(size_t size) {
+    size_t used = bytes_in_use_.fetch_add(size, std::memory_order_relaxed) + size;
+    if (used > peak_bytes_in_use_.load(std::memory_order_relaxed)) {
+      peak_bytes_in_use_.store(used, std::memory_order_relaxed);
+    }
+  }
+
+  void ReleaseAll() {
+    for (auto const& it : memory_pool_) {
+      for (auto const& buf : it.second) {
+        runtime::DeviceAPI::Get(buf.device)->FreeDataSpace(buf.device, buf.data);
+        num_device_frees_.fetch_add(1, std::memory_order_relaxed);
+        bytes_cached_.fetch_sub(buf.size, std::memory_order_relaxed);
+      }
+    }
+    memory_pool_.clear();
+    DLOG(INFO) << "release all buffers";
+  }
+
+  size_t page_size_;
+  Device device_;
+  /*! \brief The cached buffers, only accessed by the owner. */
+  std::unordered_map<size_t, std::vector<Buffer>> memory_pool_;
+  /*! \brief The buffers freed but not moved into the pool yet. */
+  std::atomic<FreeNode*> freed_{nullptr};
+  std::atomic<size_t> bytes_in_use_{0};
+  std::atomic<size_t> bytes_cached_{0};
+  std::atomic<size_t> peak_bytes_in_use_{0};
+  std::atomic<size_t> num_allocs_{0};
+  std::atomic<size_t> num_cache_hits_{0};
+  std::atomic<size_t> num_device_allocs_{0};
+  std::atomic<size_t> num_device_frees_{0};
+};
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_RELAX_VM_LOCAL_POOLED_ALLOCATOR_H_
@@ -21,13 +21,19 @@
  * \file tvm/runtime/relax_vm/memory_manager.cc
  * \brief Allocate and manage memory for the Relay VM.
  */
+#include <tvm/runtime/registry.h>
 #include <tvm/runtime/relax_vm/memory_manager.h>
 
 #include <memory>
+#include <sstream>
 #include <utility>
 
+#include "best_fit_allocator.h"
+#include "budgeted_allocator.h"
+#include "local_pooled_allocator.h"
 #include "naive_allocator.h"
 #include "pooled_allocator.h"
+#include "stream_ordered_allocator.h"
 
 namespace tvm {
 namespace runtime {
@@ -76,14 +82,76 @@ inline size_t GetDataAlignment(const DLTensor& arr) {
   return align;
 }
 
+/*! \brief The allocator that makes the storage objects with the headers of a HeaderPool. */
+class PooledStorageAllocator : public ObjAllocatorBase<PooledStorageAllocator> {
+ public:
+  explicit PooledStorageAllocator(HeaderPool* pool) : pool_(pool) {}
+
+  template <typename T>
+  class Handler {
+   public:
+    static T* New(PooledStorageAllocator* alloc) {
+      HeaderPool* pool = alloc->pool_;
+      T* ptr = new (pool->storages_.Pop()) T();
+      ptr->header_pool = pool;
+      pool->IncRef();
+      return ptr;
+    }
+
+    static Object::FDeleter Deleter() { return Deleter_; }
+
+   private:
+    static void Deleter_(Object* objptr) {
+      T* tptr = static_cast<T*>(objptr);
+      HeaderPool* pool = tptr->header_pool;
+      tptr->T::~T();
+      pool->storages_.Push(tptr);
+      pool->DecRef();
+    }
+  };
+
+ private:
+  HeaderPool* pool_;
+};
+
+HeaderPool::HeaderPool()
+    : storages_(sizeof(StorageObj)), containers_(sizeof(runtime::NDArray::Container)) {}
+
+ObjectPtr<StorageObj> HeaderPool::MakeStorage() {
+  return PooledStorageAllocator(this).make_object<StorageObj>();
+}
+
+runtime::NDArray::Container* HeaderPool::MakeContainer(StorageObj* storage, ShapeTuple shape,
+                                                       DLDataType dtype) {
+  auto* container = new (containers_.Pop())
+      runtime::NDArray::Container(nullptr, std::move(shape), dtype, storage->buffer.device);
+  container->SetDeleter(HeaderPool::ContainerDeleter);
+  IncRef();
+  return container;
+}
+
+void HeaderPool::ContainerDeleter(Object* obj) {
+  auto* ptr = static_cast<runtime::NDArray::Container*>(obj);
+  StorageObj* storage = reinterpret_cast<StorageObj*>(ptr->manager_ctx);
+  // the header of the storage may be recycled below, get the pool of the array first
+  HeaderPool* pool = storage->header_pool;
+  ptr->runtime::NDArray::Container::~Container();
+  pool->containers_.Push(ptr);
+  storage->DecRef();
+  pool->DecRef();
+}
+
 runtime::NDArray StorageObj::AllocNDArray(uint64_t offset, ShapeTuple shape, DLDataType dtype) {
   VerifyDataType(dtype);
 
   // critical zone: allocate header, cannot throw
-  runtime::NDArray::Container* container =
-      new runtime::NDArray::Container(nullptr, shape, dtype, this->buffer.device);
-
-  container->SetDeleter(StorageObj::Deleter);
+  runtime::NDArray::Container* container;
+  if (header_pool != nullptr) {
+    container = header_pool->MakeContainer(this, shape, dtype);
+  } else {
+    container = new runtime::NDArray::Container(nullptr, shape, dtype, this->buffer.device);
+    container->SetDeleter(StorageObj::Deleter);
+  }
   size_t needed_size = runtime::GetDataSize(container->dl_tensor);
   this->IncRef();
   // The manager context pointer must continue to point to the storage object
@@ -117,27 +185,61 @@ MemoryManager* MemoryManager::Global() {
   return inst;
 }
 
+std::unique_ptr<Allocator> MemoryManager::CreateAllocator(Device dev, AllocatorType type) {
+  std::unique_ptr<Allocator> alloc;
+  switch (type) {
+    case kNaive: {
+      DLOG(INFO) << "New naive allocator for " << runtime::DeviceName(dev.device_type) << "("
+                 << dev.device_id << ")";
+      alloc.reset(new NaiveAllocator(dev));
+      break;
+    }
+    case kPooled: {
+      DLOG(INFO) << "New pooled allocator for " << runtime::DeviceName(dev.device_type) << "("
+                 << dev.device_id << ")";
+      alloc.reset(new PooledAllocator(dev));
+      break;
+    }
+    case kBestFit: {
+      DLOG(INFO) << "New best-fit allocator for " << runtime::DeviceName(dev.device_type) << "("
+                 << dev.device_id << ")";
+      alloc.reset(new BestFitAllocator(dev));
+      break;
+    }
+    case kLocalPooled: {
+      DLOG(INFO) << "New local pooled allocator for " << runtime::DeviceName(dev.device_type)
+                 << "(" << dev.device_id << ")";
+      alloc.reset(new LocalPooledAllocator(dev));
+      break;
+    }
+    case kBudgeted: {
+      DLOG(INFO) << "New budgeted allocator for " << runtime::DeviceName(dev.device_type) << "("
+                 << dev.device_id << ")";
+      alloc.reset(new BudgetedAllocator(dev));
+      break;
+    }
+    case kStreamOrdered: {
+      DLOG(INFO) << "New stream ordered allocator for " << runtime::DeviceName(dev.device_type)
+                 << "(" << dev.device_id << ")";
+      alloc.reset(new StreamOrderedAllocator(dev));
+      break;
+    }
+    case kScoped:
+      LOG(FATAL) << "The scoped allocator is created by the VM with its memory scope";
+    default:
+      LOG(FATAL) << "Unknown allocator type: " << type;
+  }
+  return alloc;
+}
+
 Allocator* MemoryManager::GetOrCreateAllocator(Device dev, AllocatorType type) {
+  ICHECK(type != kLocalPooled && type != kBudgeted && type != kStreamOrdered && type != kScoped)
+      << "The local pooled, budgeted, stream ordered and scoped allocators are owned by a VM, "
+      << "use CreateAllocator instead";
   MemoryManager* m = MemoryManager::Global();
   std::lock_guard<std::mutex> lock(m->mutex_);
   if (m->allocators_.find(dev) == m->allocators_.end()) {
-    std::unique_ptr<Allocator> alloc;
-    switch (type) {
-      case kNaive: {
-        DLOG(INFO) << "New naive allocator for " << runtime::DeviceName(dev.device_type) << "("
-                   << dev.device_id << ")";
-        alloc.reset(new NaiveAllocator(dev));
-        break;
-      }
-      case kPooled: {
-        DLOG(INFO) << "New pooled allocator for " << runtime::DeviceName(dev.device_type) << "("
-                   << dev.device_id << ")";
-        alloc.reset(new PooledAllocator(dev));
-        break;
-      }
-      default:
-        LOG(FATAL) << "Unknown allocator type: " << type;
-    }
+    std::unique_ptr<Allocator> alloc = CreateAllocator(dev, type);
     auto ret = alloc.get();
     m->allocators_.emplace(dev, std::move(alloc));
     return ret;
@@ -176,6 +278,40 @@ runtime::NDArray Allocator::Empty(std::vector<int64_t> shape, DLDataType dtype,
   return runtime::NDArray(runtime::GetObjectPtr<Object>(container));
 }
 
+std::string AllocatorStatsToJSON(const AllocatorStats& stats) {
+  double hit_rate =
+      stats.num_allocs == 0 ? 0.0 : static_cast<double>(stats.num_cache_hits) / stats.num_allocs;
+  // the share of the cached memory that cannot serve a request as large as all of it
+  double fragmentation =
+      stats.bytes_cached == 0
+          ? 0.0
+          : 1.0 - static_cast<double>(stats.largest_cached_block) / stats.bytes_cached;
+  std::ostringstream os;
+  os << "{\"bytes_in_use\": " << stats.bytes_in_use << ", \"bytes_cached\": " << stats.bytes_cached
+     << ", \"bytes_reserved\": " << stats.bytes_in_use + stats.bytes_cached
+     << ", \"peak_bytes_in_use\": " << stats.peak_bytes_in_use
+     << ", \"largest_cached_block\": " << stats.largest_cached_block
+     << ", \"num_allocs\": " << stats.num_allocs << ", \"num_cache_hits\": " << stats.num_cache_hits
+     << ", \"num_device_allocs\": " << stats.num_device_allocs
+     << ", \"num_device_frees\": " << stats.num_device_frees
+     << ", \"memory_budget\": " << stats.memory_budget
+     << ", \"num_evictions\": " << stats.num_evictions << ", \"num_spills\": " << stats.num_spills
+     << ", \"bytes_spilled\": " << stats.bytes_spilled << ", \"num_reloads\": " << stats.num_reloads
+     << ", \"hit_rate\": " << hit_rate << ", \"fragmentation\": " << fragmentation << "}";
+  return os.str();
+}
+
+TVM_REGISTER_GLOBAL("vm.memory_stats").set_body_typed([](Device dev) -> String {
+  return AllocatorStatsToJSON(MemoryManager::GetAllocator(dev)->Stats());
+});
+
+TVM_REGISTER_GLOBAL("vm.set_memory_high_water_mark").set_body_typed([](Device dev, int64_t bytes) {
+  Allocator* alloc = MemoryManager::GetAllocator(dev);
+  ICHECK_EQ(alloc->type(), kBestFit) << "Only the best-fit allocator supports a high-water mark";
+  ICHECK_GE(bytes, 0);
+  static_cast<BestFitAllocator*>(alloc)->SetHighWaterMark(bytes);
+});
+
 }  // namespace relax_vm
 }  // namespace runtime
 }  // namespace tvm
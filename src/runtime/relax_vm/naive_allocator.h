@@ -43,6 +43,11 @@ class NaiveAllocator final : public Allocator {
     buf.data =
         runtime::DeviceAPI::Get(device_)->AllocDataSpace(device_, nbytes, alignment, type_hint);
     used_memory_.fetch_add(nbytes, std::memory_order_relaxed);
+    num_allocs_.fetch_add(1, std::memory_order_relaxed);
+    size_t used = used_memory_.load(std::memory_order_relaxed);
+    size_t peak = peak_memory_.load(std::memory_order_relaxed);
+    while (used > peak && !peak_memory_.compare_exchange_weak(peak, used)) {
+    }
     DLOG(INFO) << "allocate " << nbytes << " B, used memory " << used_memory_ << " B";
     return buf;
   }
@@ -50,11 +55,25 @@ class NaiveAllocator final : public Allocator {
   void Free(const Buffer& buffer) override {
     runtime::DeviceAPI::Get(device_)->FreeDataSpace(buffer.device, buffer.data);
     used_memory_.fetch_sub(buffer.size, std::memory_order_relaxed);
+    num_frees_.fetch_add(1, std::memory_order_relaxed);
     DLOG(INFO) << "free " << buffer.size << " B, used memory " << used_memory_ << " B";
   }
 
+  AllocatorStats Stats() const override {
+    AllocatorStats stats;
+    stats.bytes_in_use = used_memory_.load(std::memory_order_relaxed);
+    stats.peak_bytes_in_use = peak_memory_.load(std::memory_order_relaxed);
+    stats.num_allocs = num_allocs_.load(std::memory_order_relaxed);
+    stats.num_device_allocs = stats.num_allocs;
+    stats.num_device_frees = num_frees_.load(std::memory_order_relaxed);
+    return stats;
+  }
+
  private:
   std::atomic<size_t> used_memory_;
+  std::atomic<size_t> peak_memory_{0};
+  std::atomic<size_t> num_allocs_{0};
+  std::atomic<size_t> num_frees_{0};
   Device device_;
 };
 
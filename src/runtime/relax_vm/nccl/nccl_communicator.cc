@@ -0,0 +1,170 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/nccl/nccl_communicator.cc
+ * \brief The NCCL communicators of the collectives of the Relax VM, on CUDA devices.
+ *
+ * The collectives are enqueued on the current CUDA stream of the calling thread, i.e. the stream
+ * chosen by the VM with vm.builtin.set_stream, so they overlap with the kernels of the other
+ * streams.
+ */
+#include <nccl.h>
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/container/shape_tuple.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../../cuda/cuda_common.h"
+#include "../collective.h"
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+#define NCCL_CALL(cmd)                                                                         \
+  {                                                                                            \
+    ncclResult_t r = (cmd);                                                                    \
+    CHECK_EQ(r, ncclSuccess) << "NCCL: " #cmd " failed with error: " << ncclGetErrorString(r); \
+  }
+
+inline ncclDataType_t ToNCCLDataType(DLDataType dtype) {
+  CHECK_EQ(dtype.lanes, 1) << "ValueError: The collectives do not support vector types";
+  if (dtype.code == kDLFloat && dtype.bits == 16) return ncclFloat16;
+  if (dtype.code == kDLFloat && dtype.bits == 32) return ncclFloat32;
+  if (dtype.code == kDLFloat && dtype.bits == 64) return ncclFloat64;
+#if NCCL_VERSION_CODE >= 21000
+  if (dtype.code == kDLBfloat && dtype.bits == 16) return ncclBfloat16;
+#endif
+  if (dtype.code == kDLInt && dtype.bits == 8) return ncclInt8;
+  if (dtype.code == kDLInt && dtype.bits == 32) return ncclInt32;
+  if (dtype.code == kDLInt && dtype.bits == 64) return ncclInt64;
+  if (dtype.code == kDLUInt && dtype.bits == 8) return ncclUint8;
+  LOG(FATAL) << "ValueError: NCCL does not support " << dtype;
+  return ncclFloat32;
+}
+
+inline ncclRedOp_t ToNCCLRedOp(ReduceKind op) {
+  switch (op) {
+    case ReduceKind::kSum:
+      return ncclSum;
+    case ReduceKind::kProd:
+      return ncclProd;
+    case ReduceKind::kMin:
+      return ncclMin;
+    case ReduceKind::kMax:
+      return ncclMax;
+  }
+  return ncclSum;
+}
+
+inline void* DataPtr(const DLTensor* tensor) {
+  return static_cast<char*>(tensor->data) + tensor->byte_offset;
+}
+
+inline size_t NumElements(const DLTensor* tensor) {
+  size_t size = 1;
+  for (int i = 0; i < tensor->ndim; ++i) size *= tensor->shape[i];
+  return size;
+}
+
+/*! \brief A communicator of a NCCL group. */
+class NCCLCommunicatorObj : public CommunicatorObj {
+ public:
+  ncclComm_t comm{nullptr};
+
+  ~NCCLCommunicatorObj() {
+    if (comm != nullptr) ncclCommDestroy(comm);
+  }
+
+  void AllReduce(const DLTensor* send, DLTensor* recv, ReduceKind op) final {
+    NCCL_CALL(ncclAllReduce(DataPtr(send), DataPtr(recv), NumElements(send),
+                            ToNCCLDataType(send->dtype), ToNCCLRedOp(op), comm, Stream()));
+  }
+
+  void AllGather(const DLTensor* send, DLTensor* recv) final {
+    NCCL_CALL(ncclAllGather(DataPtr(send), DataPtr(recv), NumElements(send),
+                            ToNCCLDataType(send->dtype), comm, Stream()));
+  }
+
+  void ReduceScatter(const DLTensor* send, DLTensor* recv, ReduceKind op) final {
+    NCCL_CALL(ncclReduceScatter(DataPtr(send), DataPtr(recv), NumElements(recv),
+                                ToNCCLDataType(send->dtype), ToNCCLRedOp(op), comm, Stream()));
+  }
+
+  static constexpr const char* _type_key = "relax.vm.NCCLCommunicator";
+  TVM_DECLARE_FINAL_OBJECT_INFO(NCCLCommunicatorObj, CommunicatorObj);
+
+ private:
+  cudaStream_t Stream() const { return CUDAThreadEntry::ThreadLocal()->stream; }
+};
+
+TVM_REGISTER_OBJECT_TYPE(NCCLCommunicatorObj);
+
+Communicator MakeNCCLCommunicator(ncclComm_t comm, int rank, int world_size, int device_id) {
+  auto n = make_object<NCCLCommunicatorObj>();
+  n->comm = comm;
+  n->rank = rank;
+  n->world_size = world_size;
+  n->device = Device{kDLCUDA, device_id};
+  return Communicator(n);
+}
+
+// A group of the devices of the process, the rank of a device being its index in the list.
+TVM_REGISTER_GLOBAL("vm.builtin.ccl.nccl_group").set_body_typed([](ShapeTuple device_ids) {
+  int world_size = static_cast<int>(device_ids.size());
+  CHECK_GT(world_size, 0) << "ValueError: A group needs at least one rank";
+  std::vector<int> devs(device_ids.begin(), device_ids.end());
+  std::vector<ncclComm_t> comms(world_size);
+  NCCL_CALL(ncclCommInitAll(comms.data(), world_size, devs.data()));
+  Array<Communicator> result;
+  for (int rank = 0; rank < world_size; ++rank) {
+    result.push_back(MakeNCCLCommunicator(comms[rank], rank, world_size, devs[rank]));
+  }
+  return result;
+});
+
+// The id shared by the processes of a group, created by one of them and sent to the others.
+TVM_REGISTER_GLOBAL("vm.builtin.ccl.nccl_unique_id").set_body([](TVMArgs args, TVMRetValue* rv) {
+  ncclUniqueId id;
+  NCCL_CALL(ncclGetUniqueId(&id));
+  std::string bytes(id.internal, NCCL_UNIQUE_ID_BYTES);
+  TVMByteArray arr{bytes.data(), bytes.size()};
+  *rv = arr;
+});
+
+// The communicator of the rank of a process in a group spanning several processes.
+TVM_REGISTER_GLOBAL("vm.builtin.ccl.nccl_communicator")
+    .set_body_typed([](std::string unique_id, int world_size, int rank, int device_id) {
+      CHECK_EQ(unique_id.size(), NCCL_UNIQUE_ID_BYTES)
+          << "ValueError: The unique id must be the one of nccl_unique_id";
+      ncclUniqueId id;
+      std::copy(unique_id.begin(), unique_id.end(), id.internal);
+      CUDA_CALL(cudaSetDevice(device_id));
+      ncclComm_t comm;
+      NCCL_CALL(ncclCommInitRank(&comm, world_size, id, rank));
+      return MakeNCCLCommunicator(comm, rank, world_size, device_id);
+    });
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
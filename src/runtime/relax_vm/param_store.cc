@@ -0,0 +1,291 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/param_store.cc
+ * \brief A store of the params of a model kept out of the executable, loaded lazily by the VM.
+ *
+ * The params are saved by tvm.relax.param_store.save_params as a directory holding a manifest,
+ * params.json, and shard files concatenating the raw bytes of the params at aligned offsets.
+ * The manifest records the shard, the offset, the shape and the dtype of each param, so the
+ * executable only carries their names, see the relax.param_load op.
+ *
+ * A shard is memory mapped when one of its params is first loaded, and unmapped once all its
+ * params are on the device. The params are copied to the device straight from the page cache,
+ * so the host memory held is bounded by the shards being read rather than by the model. The
+ * device copies are kept until released.
+ */
+#include <dmlc/json.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/object.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/relax_vm/vm.h>
+
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "../file_utils.h"
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*! \brief The contents of a shard, memory mapped read-only when the platform supports it. */
+class ShardFile {
+ public:
+  explicit ShardFile(const std::string& file_name) {
+#if !defined(_WIN32)
+    int fd = open(file_name.c_str(), O_RDONLY);
+    CHECK_GE(fd, 0) << "ValueError: Cannot open the shard " << file_name;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void* ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+      if (ptr != MAP_FAILED) {
+        // the params of a shard are usually loaded in order
+        madvise(ptr, st.st_size, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(ptr);
+        size_ = st.st_size;
+        mapped_ = true;
+      }
+    }
+    close(fd);
+    if (mapped_) return;
+#endif
+    LoadBinaryFromFile(file_name, &buffer_);
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+  }
+
+  ~ShardFile() {
+#if !defined(_WIN32)
+    if (mapped_) munmap(const_cast<char*>(data_), size_);
+#endif
+  }
+
+  const char* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  const char* data_{nullptr};
+  size_t size_{0};
+  bool mapped_{false};
+  std::string buffer_;
+};
+
+/*! \brief A store of params loaded lazily from shards to a device. */
+class ParamStoreObj : public Object {
+ public:
+  /*! \brief The record of a param in the manifest. */
+  struct ParamInfo {
+    std::string name;
+    int64_t shard;
+    int64_t offset;
+    int64_t nbytes;
+    std::vector<int64_t> shape;
+    std::string dtype;
+
+    void Load(dmlc::JSONReader* reader) {
+      dmlc::JSONObjectReadHelper helper;
+      helper.DeclareField("name", &name);
+      helper.DeclareField("shard", &shard);
+      helper.DeclareField("offset", &offset);
+      helper.DeclareField("nbytes", &nbytes);
+      helper.DeclareField("shape", &shape);
+      helper.DeclareField("dtype", &dtype);
+      helper.ReadAllFields(reader);
+    }
+  };
+
+  /*! \brief The directory of the store. */
+  std::string path;
+  /*! \brief The device the params are loaded to. */
+  Device device;
+  /*! \brief The file names of the shards, relative to the directory. */
+  std::vector<std::string> shard_files;
+  /*! \brief The params, in the order of the manifest. */
+  std::vector<ParamInfo> params;
+  /*! \brief The index of each param by name. */
+  std::unordered_map<std::string, size_t> index;
+
+  /*! \brief Get a param on the device, loading it on first use. */
+  NDArray Get(const std::string& name) {
+    auto it = index.find(name);
+    CHECK(it != index.end()) << "ValueError: The param store " << path << " has no param " << name;
+    std::lock_guard<std::mutex> lock(mutex_);
+    return Load(it->second);
+  }
+
+  /*! \brief Load all the params of a shard to the device, e.g. ahead of their first use. */
+  void LoadShard(int64_t shard) {
+    CHECK(shard >= 0 && shard < static_cast<int64_t>(shard_files.size()))
+        << "ValueError: The param store " << path << " has no shard " << shard;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < params.size(); ++i) {
+      if (params[i].shard == shard) Load(i);
+    }
+  }
+
+  /*! \brief Drop the device copy of a param held by the store, it is loaded again on next use. */
+  void Release(const std::string& name) {
+    auto it = index.find(name);
+    CHECK(it != index.end()) << "ValueError: The param store " << path << " has no param " << name;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (resident_[it->second].defined()) {
+      resident_[it->second] = NDArray();
+      ++num_pending_[params[it->second].shard];
+    }
+  }
+
+  /*! \return The number of params held on the device. */
+  int64_t NumResident() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t num = 0;
+    for (const NDArray& param : resident_) num += param.defined();
+    return num;
+  }
+
+  /*! \return The number of shards currently mapped. */
+  int64_t NumMappedShards() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t num = 0;
+    for (const auto& shard : shards_) num += shard != nullptr;
+    return num;
+  }
+
+  /*! \brief Set up the state of the loads once the manifest is read. */
+  void Init() {
+    resident_.resize(params.size());
+    shards_.resize(shard_files.size());
+    num_pending_.assign(shard_files.size(), 0);
+    for (const ParamInfo& param : params) ++num_pending_[param.shard];
+  }
+
+  static constexpr const char* _type_key = "relax.vm.ParamStore";
+  TVM_DECLARE_FINAL_OBJECT_INFO(ParamStoreObj, Object);
+
+ private:
+  /*! \brief Load a param if it is not resident, with the mutex held. */
+  NDArray Load(size_t i) {
+    if (resident_[i].defined()) return resident_[i];
+    const ParamInfo& param = params[i];
+    std::unique_ptr<ShardFile>& shard = shards_[param.shard];
+    if (shard == nullptr) {
+      shard = std::make_unique<ShardFile>(path + "/" + shard_files[param.shard]);
+    }
+    CHECK_LE(param.offset + param.nbytes, static_cast<int64_t>(shard->size()))
+        << "ValueError: The param " << param.name << " is out of the bounds of its shard "
+        << shard_files[param.shard];
+    NDArray arr = NDArray::Empty(ShapeTuple(param.shape), String2DLDataType(param.dtype), device);
+    arr.CopyFromBytes(shard->data() + param.offset, param.nbytes);
+    resident_[i] = arr;
+    if (--num_pending_[param.shard] == 0) {
+      // the whole shard is on the device, so its pages are not needed anymore
+      shard.reset();
+    }
+    return arr;
+  }
+
+  /*! \brief Guards the loads, the store is shared by the sessions of a VM. */
+  std::mutex mutex_;
+  /*! \brief The device copy of each param, undefined until loaded. */
+  std::vector<NDArray> resident_;
+  /*! \brief The mapped shards, null when none of their params is being loaded. */
+  std::vector<std::unique_ptr<ShardFile>> shards_;
+  /*! \brief The number of params of each shard that are not resident. */
+  std::vector<int64_t> num_pending_;
+};
+
+/*! \brief Managed reference to ParamStoreObj. */
+class ParamStore : public ObjectRef {
+ public:
+  /*!
+   * \brief Open a param store, reading its manifest. No param is loaded yet.
+   * \param path The directory of the store.
+   * \param device The device to load the params to.
+   */
+  ParamStore(const std::string& path, Device device) {
+    auto n = make_object<ParamStoreObj>();
+    n->path = path;
+    n->device = device;
+    std::string manifest;
+    LoadBinaryFromFile(path + "/params.json", &manifest);
+    std::istringstream is(manifest);
+    dmlc::JSONReader reader(&is);
+    dmlc::JSONObjectReadHelper helper;
+    helper.DeclareField("shards", &n->shard_files);
+    helper.DeclareField("params", &n->params);
+    helper.ReadAllFields(&reader);
+    for (size_t i = 0; i < n->params.size(); ++i) {
+      const ParamStoreObj::ParamInfo& param = n->params[i];
+      CHECK(param.shard >= 0 && param.shard < static_cast<int64_t>(n->shard_files.size()))
+          << "ValueError: The param " << param.name << " refers to an unknown shard "
+          << param.shard;
+      CHECK(n->index.emplace(param.name, i).second)
+          << "ValueError: The param " << param.name << " appears twice in " << path;
+    }
+    n->Init();
+    data_ = std::move(n);
+  }
+
+  TVM_DEFINE_MUTABLE_NOTNULLABLE_OBJECT_REF_METHODS(ParamStore, ObjectRef, ParamStoreObj);
+};
+
+TVM_REGISTER_OBJECT_TYPE(ParamStoreObj);
+
+TVM_REGISTER_GLOBAL("vm.builtin.param_store_create")
+    .set_body_typed([](String path, int device_type, int device_id) {
+      Device device{static_cast<DLDeviceType>(device_type), device_id};
+      return ParamStore(path, device);
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.param_load").set_body_typed([](void* vm_ptr, String name) {
+  VirtualMachine* vm = static_cast<VirtualMachine*>(vm_ptr);
+  CHECK(vm->param_store.defined())
+      << "ValueError: The executable loads the param " << name
+      << " from a param store, but none is set on the VM, see set_param_store";
+  return Downcast<ParamStore>(vm->param_store)->Get(name);
+});
+
+TVM_REGISTER_GLOBAL("vm.builtin.param_store_load_shard")
+    .set_body_typed([](ParamStore store, int64_t shard) { store->LoadShard(shard); });
+
+TVM_REGISTER_GLOBAL("vm.builtin.param_store_release")
+    .set_body_typed([](ParamStore store, String name) { store->Release(name); });
+
+TVM_REGISTER_GLOBAL("vm.builtin.param_store_num_resident")
+    .set_body_typed([](ParamStore store) { return store->NumResident(); });
+
+TVM_REGISTER_GLOBAL("vm.builtin.param_store_num_mapped_shards")
+    .set_body_typed([](ParamStore store) { return store->NumMappedShards(); });
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
@@ -26,6 +26,7 @@
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/relax_vm/memory_manager.h>
 
+#include <algorithm>
 #include <atomic>
 #include <mutex>
 #include <unordered_map>
@@ -46,12 +47,16 @@ class PooledAllocator final : public Allocator {
 
   Buffer Alloc(size_t nbytes, size_t alignment, DLDataType type_hint) override {
     std::lock_guard<std::recursive_mutex> lock(mu_);
+    stats_.num_allocs++;
     size_t size = ((nbytes + page_size_ - 1) / page_size_) * page_size_;
     auto&& it = memory_pool_.find(size);
     if (it != memory_pool_.end() && !it->second.empty()) {
       auto&& pool = it->second;
       auto ret = pool.back();
       pool.pop_back();
+      stats_.num_cache_hits++;
+      stats_.bytes_cached -= ret.size;
+      AddInUse(ret.size);
       return ret;
     }
     Buffer buf;
@@ -69,6 +74,8 @@ class PooledAllocator final : public Allocator {
     }
 
     used_memory_.fetch_add(size, std::memory_order_relaxed);
+    stats_.num_device_allocs++;
+    AddInUse(size);
     DLOG(INFO) << "allocate " << size << " B, used memory " << used_memory_ << " B";
     return buf;
   }
@@ -79,20 +86,41 @@ class PooledAllocator final : public Allocator {
       memory_pool_.emplace(buffer.size, std::vector<Buffer>{});
     }
     memory_pool_.at(buffer.size).push_back(buffer);
+    stats_.bytes_in_use -= buffer.size;
+    stats_.bytes_cached += buffer.size;
     DLOG(INFO) << "reclaim buffer " << buffer.size;
   }
 
+  AllocatorStats Stats() const override {
+    std::lock_guard<std::recursive_mutex> lock(mu_);
+    AllocatorStats stats = stats_;
+    stats.largest_cached_block = 0;
+    for (const auto& it : memory_pool_) {
+      if (!it.second.empty()) {
+        stats.largest_cached_block = std::max(stats.largest_cached_block, it.first);
+      }
+    }
+    return stats;
+  }
+
  private:
+  void AddInUse(size_t size) {
+    stats_.bytes_in_use += size;
+    stats_.peak_bytes_in_use = std::max(stats_.peak_bytes_in_use, stats_.bytes_in_use);
+  }
+
   void ReleaseAll() {
     std::lock_guard<std::recursive_mutex> lock(mu_);
     for (auto const& it : memory_pool_) {
       auto const& pool = it.second;
       for (auto const& buf : pool) {
         runtime::DeviceAPI::Get(buf.device)->FreeDataSpace(buf.device, buf.data);
+        stats_.num_device_frees++;
       }
     }
     memory_pool_.clear();
-    used_memory_ = 0;
+    used_memory_ = stats_.bytes_in_use;
+    stats_.bytes_cached = 0;
     DLOG(INFO) << "release all buffers";
   }
 
@@ -100,7 +128,8 @@ class PooledAllocator final : public Allocator {
   size_t page_size_;
   std::atomic<size_t> used_memory_;
   std::unordered_map<size_t, std::vector<Buffer> > memory_pool_;
-  std::recursive_mutex mu_;
+  AllocatorStats stats_;
+  mutable std::recursive_mutex mu_;
   Device device_;
 };
 
@@ -0,0 +1,98 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/runtime/relax_vm/scoped_allocator.h
+ * \brief The allocator of a memory scope of a device other than its global memory, e.g. the
+ * VTCM of Hexagon.
+ */
+#ifndef TVM_RUNTIME_RELAX_VM_SCOPED_ALLOCATOR_H_
+#define TVM_RUNTIME_RELAX_VM_SCOPED_ALLOCATOR_H_
+
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/relax_vm/memory_manager.h>
+
+#include <atomic>
+#include <string>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*!
+ * \brief Allocates the buffers of a memory scope from the device API, without caching them.
+ * The buffers are flat, so that a storage can hold the tensors of any shape, and the scoped
+ * memories being small, the storages allocated from it are expected to be the arenas of the
+ * memory planning, which the VM keeps across calls.
+ */
+class ScopedAllocator final : public Allocator {
+ public:
+  ScopedAllocator(Device dev, std::string mem_scope)
+      : Allocator(kScoped), device_(dev), mem_scope_(std::move(mem_scope)) {}
+
+  Buffer Alloc(size_t nbytes, size_t alignment, DLDataType type_hint) override {
+    Buffer buf;
+    buf.device = device_;
+    buf.size = nbytes;
+    int64_t shape = static_cast<int64_t>(nbytes);
+    buf.data = runtime::DeviceAPI::Get(device_)->AllocDataSpace(
+        device_, 1, &shape, DLDataType{kDLUInt, 8, 1}, String(mem_scope_));
+    size_t used = used_memory_.fetch_add(nbytes, std::memory_order_relaxed) + nbytes;
+    num_allocs_.fetch_add(1, std::memory_order_relaxed);
+    size_t peak = peak_memory_.load(std::memory_order_relaxed);
+    while (used > peak && !peak_memory_.compare_exchange_weak(peak, used)) {
+    }
+    DLOG(INFO) << "allocate " << nbytes << " B in " << mem_scope_;
+    return buf;
+  }
+
+  void Free(const Buffer& buffer) override {
+    runtime::DeviceAPI::Get(device_)->FreeDataSpace(buffer.device, buffer.data);
+    used_memory_.fetch_sub(buffer.size, std::memory_order_relaxed);
+    num_frees_.fetch_add(1, std::memory_order_relaxed);
+    DLOG(INFO) << "free " << buffer.size << " B in " << mem_scope_;
+  }
+
+  AllocatorStats Stats() const override {
+    AllocatorStats stats;
+    stats.bytes_in_use = used_memory_.load(std::memory_order_relaxed);
+    stats.peak_bytes_in_use = peak_memory_.load(std::memory_order_relaxed);
+    stats.num_allocs = num_allocs_.load(std::memory_order_relaxed);
+    stats.num_device_allocs = stats.num_allocs;
+    stats.num_device_frees = num_frees_.load(std::memory_order_relaxed);
+    return stats;
+  }
+
+  /*! \brief The memory scope of the buffers. */
+  const std::string& mem_scope() const { return mem_scope_; }
+
+ private:
+  Device device_;
+  std::string mem_scope_;
+  std::atomic<size_t> used_memory_{0};
+  std::atomic<size_t> peak_memory_{0};
+  std::atomic<size_t> num_allocs_{0};
+  std::atomic<size_t> num_frees_{0};
+};
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_RELAX_VM_SCOPED_ALLOCATOR_H_
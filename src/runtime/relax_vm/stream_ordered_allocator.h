@@ -0,0 +1,105 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/runtime/relax_vm/stream_ordered_allocator.h
+ * \brief The allocator leaving the caching of the memory to the stream ordered allocation of the
+ * device, e.g. cudaMallocAsync.
+ */
+#ifndef TVM_RUNTIME_RELAX_VM_STREAM_ORDERED_ALLOCATOR_H_
+#define TVM_RUNTIME_RELAX_VM_STREAM_ORDERED_ALLOCATOR_H_
+
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/relax_vm/memory_manager.h>
+
+#include <atomic>
+#include <string>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*!
+ * \brief The allocator allocating and freeing in the order of the stream of the calling thread.
+ *
+ * The memory pool of the device caches the freed memory, and the allocations missing the pool
+ * grow it without synchronizing the device, unlike the allocations of the device API. The pool
+ * keeps the freed memory up to its release threshold, see runtime.config_cuda_mem_pool. The
+ * memory must only be used on the stream it is allocated on.
+ */
+class StreamOrderedAllocator final : public Allocator {
+ public:
+  explicit StreamOrderedAllocator(Device dev) : Allocator(kStreamOrdered), device_(dev) {
+    std::string prefix = "device_api." + std::string(runtime::DeviceName(dev.device_type));
+    alloc_async_ = Registry::Get(prefix + ".alloc_async");
+    free_async_ = Registry::Get(prefix + ".free_async");
+    CHECK(alloc_async_ != nullptr && free_async_ != nullptr)
+        << "ValueError: The stream ordered allocator is not supported on "
+        << runtime::DeviceName(dev.device_type)
+        << ", which needs TVM built with CUDA 11.2 or later";
+  }
+
+  Buffer Alloc(size_t nbytes, size_t alignment, DLDataType type_hint) override {
+    Buffer buf;
+    buf.device = device_;
+    buf.size = nbytes;
+    buf.data = (*alloc_async_)(device_, static_cast<int64_t>(nbytes),
+                               static_cast<int64_t>(alignment))
+                   .operator void*();
+    size_t used = used_memory_.fetch_add(nbytes, std::memory_order_relaxed) + nbytes;
+    num_allocs_.fetch_add(1, std::memory_order_relaxed);
+    size_t peak = peak_memory_.load(std::memory_order_relaxed);
+    while (used > peak && !peak_memory_.compare_exchange_weak(peak, used)) {
+    }
+    return buf;
+  }
+
+  void Free(const Buffer& buffer) override {
+    (*free_async_)(buffer.device, buffer.data);
+    used_memory_.fetch_sub(buffer.size, std::memory_order_relaxed);
+    num_frees_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  AllocatorStats Stats() const override {
+    // the caching of the pool is not visible to the allocator
+    AllocatorStats stats;
+    stats.bytes_in_use = used_memory_.load(std::memory_order_relaxed);
+    stats.peak_bytes_in_use = peak_memory_.load(std::memory_order_relaxed);
+    stats.num_allocs = num_allocs_.load(std::memory_order_relaxed);
+    stats.num_device_allocs = stats.num_allocs;
+    stats.num_device_frees = num_frees_.load(std::memory_order_relaxed);
+    return stats;
+  }
+
+ private:
+  Device device_;
+  const PackedFunc* alloc_async_{nullptr};
+  const PackedFunc* free_async_{nullptr};
+  std::atomic<size_t> used_memory_{0};
+  std::atomic<size_t> peak_memory_{0};
+  std::atomic<size_t> num_allocs_{0};
+  std::atomic<size_t> num_frees_{0};
+};
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_RELAX_VM_STREAM_ORDERED_ALLOCATOR_H_
@@ -22,8 +22,25 @@
  */
 
 #include <tvm/runtime/container/adt.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/relax_vm/vm.h>
+#include <tvm/runtime/threading_backend.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "../trace.h"
+#include "budgeted_allocator.h"
+#include "scoped_allocator.h"
 
 namespace tvm {
 namespace runtime {
@@ -40,6 +57,208 @@ inline TVMRetValue CopyConstantTo(TVMRetValue src, const DLDevice& dev) {
   return ret;
 }
 
+/*!
+ * \brief Get the shape signature of the arguments of a call, the dimensions of each argument
+ *  separated by commas, empty for the arguments which are not NDArrays.
+ */
+static std::string ShapeSignature(const Array<ShapeTuple>& shapes) {
+  std::ostringstream os;
+  for (size_t i = 0; i < shapes.size(); ++i) {
+    if (i != 0) os << ",";
+    for (size_t k = 0; k < shapes[i].size(); ++k) {
+      os << (k == 0 ? "" : "x") << shapes[i][k];
+    }
+  }
+  return os.str();
+}
+
+/*! \brief The fingerprint of the contents of a constant on the CPU. */
+static size_t ConstantFingerprint(const NDArray& host) {
+  size_t nbytes = GetDataSize(*host.operator->());
+  const char* data = static_cast<const char*>(host->data) + host->byte_offset;
+  return std::hash<std::string_view>()(std::string_view(data, nbytes));
+}
+
+/*! \brief Whether two constants on the CPU have the same type, shape and contents. */
+static bool ConstantEqual(const NDArray& lhs, const NDArray& rhs) {
+  ShapeTuple lhs_shape = lhs.Shape(), rhs_shape = rhs.Shape();
+  if (!runtime::TypeEqual(lhs->dtype, rhs->dtype) || lhs_shape.size() != rhs_shape.size() ||
+      !std::equal(lhs_shape.begin(), lhs_shape.end(), rhs_shape.begin())) {
+    return false;
+  }
+  return std::memcmp(static_cast<const char*>(lhs->data) + lhs->byte_offset,
+                     static_cast<const char*>(rhs->data) + rhs->byte_offset,
+                     GetDataSize(*lhs.operator->())) == 0;
+}
+
+/*!
+ * \brief The process-wide cache of the device copies of the NDArray constants, keyed by their
+ *  contents and their device, for the constant pools enabling sharing.
+ */
+class SharedConstantCache {
+ public:
+  static SharedConstantCache* Global() {
+    static SharedConstantCache* inst = new SharedConstantCache();
+    return inst;
+  }
+
+  /*!
+   * \brief Get the device copy of a host constant, copying it on the first acquisition.
+   * \param host The constant, on the CPU.
+   * \param dev The device.
+   * \return The device copy, to be released once unused.
+   */
+  NDArray Acquire(const NDArray& host, Device dev) {
+    size_t hash = ConstantFingerprint(host);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto range = entries_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      Entry& entry = it->second;
+      if (entry.device->device.device_type == dev.device_type &&
+          entry.device->device.device_id == dev.device_id && ConstantEqual(entry.host, host)) {
+        ++entry.use_count;
+        return entry.device;
+      }
+    }
+    NDArray device = host.CopyTo(dev);
+    entries_.emplace(hash, Entry{host, device, 1});
+    return device;
+  }
+
+  /*!
+   * \brief Release a device copy given by Acquire, freeing it with its last use.
+   * \param device The device copy.
+   */
+  void Release(const NDArray& device) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+      if (it->second.device.same_as(device)) {
+        if (--it->second.use_count == 0) entries_.erase(it);
+        return;
+      }
+    }
+  }
+
+  /*! \return The number of the cached copies, their uses and their bytes, as a JSON string. */
+  std::string Stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t num_uses = 0;
+    size_t nbytes = 0;
+    for (const auto& kv : entries_) {
+      num_uses += kv.second.use_count;
+      nbytes += GetDataSize(*kv.second.device.operator->());
+    }
+    std::ostringstream os;
+    os << "{\"num_constants\": " << entries_.size() << ", \"num_uses\": " << num_uses
+       << ", \"bytes\": " << nbytes << "}";
+    return os.str();
+  }
+
+ private:
+  struct Entry {
+    /*! \brief The host constant, to compare the contents of the constants of equal hashes. */
+    NDArray host;
+    NDArray device;
+    int64_t use_count;
+  };
+  std::mutex mutex_;
+  std::unordered_multimap<size_t, Entry> entries_;
+};
+
+TVM_REGISTER_GLOBAL("runtime.relax_vm.SharedConstantStats").set_body_typed([]() {
+  return String(SharedConstantCache::Global()->Stats());
+});
+
+ConstantPool::~ConstantPool() {
+  for (Index index : shared_) {
+    SharedConstantCache::Global()->Release(values_[index].operator NDArray());
+  }
+}
+
+void ConstantPool::Upload(Index index) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (resident_[index].load(std::memory_order_relaxed)) return;
+  NDArray host = values_[index].operator NDArray();
+  const Device& dev = devices_[index];
+  if (share_ && host->device.device_type == kDLCPU &&
+      (dev.device_type != kDLCPU || dev.device_id != host->device.device_id)) {
+    values_[index] = SharedConstantCache::Global()->Acquire(host, dev);
+    shared_.push_back(index);
+  } else {
+    values_[index] = CopyConstantTo(values_[index], dev);
+  }
+  resident_[index].store(true, std::memory_order_release);
+}
+
+void ConstantPool::Localize() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ICHECK(!share_) << "ValueError: Cannot localize the constants shared with the other VMs";
+  for (size_t i = 0; i < values_.size(); ++i) {
+    if (values_[i].type_code() != kTVMNDArrayHandle || devices_[i].device_type != kDLCPU) {
+      continue;
+    }
+    NDArray value = values_[i].operator NDArray();
+    NDArray local = NDArray::Empty(value.Shape(), value.DataType(), devices_[i]);
+    local.CopyFrom(value);
+    values_[i] = local;
+    resident_[i].store(true, std::memory_order_release);
+  }
+}
+
+std::pair<size_t, size_t> ConstantPool::ReuseResident(ConstantPool* prev) {
+  std::scoped_lock lock(mutex_, prev->mutex_);
+  ICHECK_EQ(share_, prev->share_) << "Cannot reuse the constants of a pool shared differently";
+  auto on_cpu = [](const TVMRetValue& value) {
+    return value.type_code() == kTVMNDArrayHandle &&
+           value.operator NDArray()->device.device_type == kDLCPU;
+  };
+  std::unordered_multimap<size_t, Index> prev_constants;
+  for (size_t j = 0; j < prev->values_.size(); ++j) {
+    if (on_cpu(prev->hosts_[j]) && prev->resident_[j].load(std::memory_order_acquire)) {
+      prev_constants.emplace(ConstantFingerprint(prev->hosts_[j].operator NDArray()), j);
+    }
+  }
+  std::unordered_set<Index> prev_shared(prev->shared_.begin(), prev->shared_.end());
+  size_t num_reused = 0, nbytes = 0;
+  for (size_t i = 0; i < values_.size(); ++i) {
+    if (!on_cpu(hosts_[i]) || resident_[i].load(std::memory_order_relaxed)) continue;
+    NDArray host = hosts_[i].operator NDArray();
+    auto range = prev_constants.equal_range(ConstantFingerprint(host));
+    for (auto it = range.first; it != range.second; ++it) {
+      Index j = it->second;
+      const Device& prev_dev = prev->devices_[j];
+      if (prev_dev.device_type != devices_[i].device_type ||
+          prev_dev.device_id != devices_[i].device_id ||
+          !ConstantEqual(prev->hosts_[j].operator NDArray(), host)) {
+        continue;
+      }
+      if (prev_shared.count(j)) {
+        // a use of its own of the shared copy, found in the cache while prev holds it
+        values_[i] = SharedConstantCache::Global()->Acquire(host, devices_[i]);
+        shared_.push_back(i);
+      } else {
+        values_[i] = prev->values_[j];
+      }
+      resident_[i].store(true, std::memory_order_release);
+      ++num_reused;
+      nbytes += GetDataSize(*host.operator->());
+      break;
+    }
+  }
+  return {num_reused, nbytes};
+}
+
+std::pair<size_t, size_t> ConstantPool::UploadAll() {
+  size_t num_uploaded = 0, nbytes = 0;
+  for (size_t i = 0; i < values_.size(); ++i) {
+    if (resident_[i].load(std::memory_order_acquire)) continue;
+    Upload(i);
+    ++num_uploaded;
+    nbytes += GetDataSize(*hosts_[i].operator NDArray().operator->());
+  }
+  return {num_uploaded, nbytes};
+}
+
 VMFunction VirtualMachine::LookupVMFunction(const std::string& func_name) {
   ICHECK(exec_) << "The executable is not created yet.";
   const auto& m = this->exec_->global_map;
@@ -98,17 +317,247 @@ PackedFunc VirtualMachine::GetFunction(const std::string& name,
         alloc_types.push_back(AllocatorType(type));
       }
       this->Init(devices, alloc_types);
-
-      // Copy NDArray constants to the devices
-      // TODO(tvm-team): support multiple devices
-      this->constants.reserve(exec_->constants.size());
-      for (const auto& constant : exec_->constants) {
-        if (constant.type_code() != kTVMNDArrayHandle) {
-          this->constants.push_back(constant);
-        } else {
-          this->constants.push_back(CopyConstantTo(constant, devices[0]));
+      this->constants = this->CreateConstantPool(*exec_);
+    });
+  } else if (name == "hot_reload") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      // args[0]: the new executable; args[1]: whether all its constants are uploaded first
+      Module exec_mod = args[0];
+      CHECK_EQ(exec_mod->type_key(), std::string("relax.Executable"))
+          << "ValueError: Cannot reload the VM from a module of type " << exec_mod->type_key();
+      auto* exec = static_cast<Executable*>(exec_mod.operator->());
+      bool upload_constants = args.size() > 1 ? args[1].operator bool() : true;
+      *rv = String(this->HotReload(GetObjectPtr<Executable>(exec), upload_constants));
+    });
+  } else if (name == "invoke_batched") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      // args[0]: function name; args[1]: the batch axis of the arguments; args[2]: the batch
+      // axis of each output tensor, -1 when it is not batched, or empty when all the outputs
+      // are batched along args[1]; args[3:]: the arguments of each request, one after another
+      constexpr int kFirstArg = 3;
+      std::string func_name = args[0];
+      int batch_axis = args[1];
+      ShapeTuple output_axes = args[2];
+      const auto& m = exec_->global_map;
+      if (m.find(func_name) == m.end()) {
+        LOG(FATAL) << "ValueError: Unknown function: " << func_name;
+      }
+      Index gf_idx = m.at(func_name);
+      size_t num_args = exec_->global_funcs[gf_idx].num_args;
+      ICHECK_GT(num_args, 0) << "ValueError: Cannot batch calls of " << func_name
+                             << " which takes no arguments";
+      ICHECK_EQ((args.size() - kFirstArg) % num_args, 0)
+          << "ValueError: The number of arguments is not a multiple of the arity of "
+          << func_name;
+      std::vector<std::vector<RegType>> requests((args.size() - kFirstArg) / num_args);
+      // The arguments passed as the same tensor to every request are not batched. They are
+      // compared before they are copied to the device, which gives each request its own copy.
+      std::vector<bool> batched(num_args, false);
+      for (size_t i = 1; i < requests.size(); ++i) {
+        for (size_t j = 0; j < num_args; ++j) {
+          if (args.values[kFirstArg + i * num_args + j].v_handle !=
+              args.values[kFirstArg + j].v_handle) {
+            batched[j] = true;
+          }
         }
       }
+      for (size_t i = 0; i < requests.size(); ++i) {
+        requests[i].resize(num_args);
+        for (size_t j = 0; j < num_args; ++j) {
+          TVMArgValue arg = args[kFirstArg + i * num_args + j];
+          CHECK(arg.type_code() == kTVMNDArrayHandle || arg.type_code() == kTVMDLTensorHandle)
+              << "ValueError: Batched calls only take tensor arguments, but argument " << j
+              << " of request " << i << " is a " << ArgTypeCode2Str(arg.type_code());
+          SetInputTensorWithIndex(requests[i], arg, j, devices[0]);
+        }
+      }
+      *rv = this->InvokeBatched(gf_idx, requests, batched, batch_axis,
+                                std::vector<int64_t>(output_axes.begin(), output_axes.end()));
+    });
+  } else if (name == "capture_cuda_graph") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      std::string func_name = args[0];
+      this->CaptureCUDAGraph(func_name);
+    });
+  } else if (name == "run_cuda_graph") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      std::string func_name = args[0];
+      this->RunCUDAGraph(func_name);
+    });
+  } else if (name == "create_session") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      *rv = Module(this->CreateSession());
+    });
+  } else if (name == "memory_stats") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      int64_t device_index = args[0];
+      ICHECK_GE(device_index, 0);
+      ICHECK_LT(device_index, static_cast<int64_t>(allocators.size()));
+      *rv = String(AllocatorStatsToJSON(allocators[device_index]->Stats()));
+    });
+  } else if (name == "func_table_stats") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      *rv = String(this->FuncTableStats());
+    });
+  } else if (name == "share_constants") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      ICHECK(this->constants) << "The VM is not initialized yet.";
+      this->constants->EnableSharing();
+    });
+  } else if (name == "localize_constants") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      ICHECK(this->constants) << "The VM is not initialized yet.";
+      this->constants->Localize();
+    });
+  } else if (name == "set_shape_specialization") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      // args[0]: the threshold of the hot signatures; args[1]: the callback compiling them
+      std::lock_guard<std::mutex> lock(specialization_mutex_);
+      specialization_threshold_ = args[0];
+      specialization_callback_ = args.size() > 1 ? args[1].operator PackedFunc() : PackedFunc();
+      specialize_shapes_ = specialization_threshold_ > 0 || !specializations_.empty();
+    });
+  } else if (name == "add_specialization") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      // args[0]: function name; args[1]: the argument shapes; args[2]: the variant
+      std::string func_name = args[0];
+      Array<ShapeTuple> shapes = args[1];
+      ICHECK(exec_->global_map.count(func_name))
+          << "ValueError: Unknown function: " << func_name;
+      std::lock_guard<std::mutex> lock(specialization_mutex_);
+      specializations_[func_name][ShapeSignature(shapes)].func = args[2].operator PackedFunc();
+      specialize_shapes_ = true;
+    });
+  } else if (name == "specialization_stats") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      *rv = String(this->SpecializationStats());
+    });
+  } else if (name == "set_storage_recording") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      record_storage_ = args[0];
+    });
+  } else if (name == "recorded_storage") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      // args[0]: device index; returns the sizes of the buffers recorded, largest first
+      size_t device_index = static_cast<int64_t>(args[0]);
+      std::vector<int64_t> sizes;
+      if (device_index < recorded_buffers_.size()) {
+        for (const auto& kv : recorded_buffers_[device_index]) {
+          sizes.push_back(kv.second);
+        }
+      }
+      std::sort(sizes.begin(), sizes.end(), std::greater<int64_t>());
+      *rv = ShapeTuple(sizes);
+    });
+  } else if (name == "preload_functions") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      std::vector<std::string> func_names;
+      for (int i = 0; i < args.size(); ++i) {
+        func_names.push_back(args[i].operator std::string());
+      }
+      this->PreloadFunctions(func_names);
+    });
+  } else if (name == "reserve_storage") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      // args[0]: device index; args[1]: the sizes of the buffers
+      ShapeTuple sizes = args[1];
+      this->ReserveStorage(args[0], std::vector<int64_t>(sizes.begin(), sizes.end()));
+    });
+  } else if (name == "set_param_store") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->param_store = args[0];
+    });
+  } else if (name == "set_communicator") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->communicator = args[0];
+    });
+  } else if (name == "set_memory_budget") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->SetMemoryBudget(args[0], args[1], args[2]);
+    });
+  } else if (name == "set_dispatch_mode") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      int mode = args[0];
+      ICHECK(mode == static_cast<int>(DispatchMode::kSwitch) ||
+             mode == static_cast<int>(DispatchMode::kThreaded))
+          << "ValueError: Unknown dispatch mode: " << mode;
+      dispatch_mode_ = static_cast<DispatchMode>(mode);
+    });
+  } else if (name == "set_unchecked_kernels") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      unchecked_kernels_ = args[0];
+      // resolve the kernels again through the new entries
+      this->InitFuncTable();
+    });
+  } else if (name == "set_async_input_copy") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      bool enable = args[0];
+      ICHECK(!devices.empty()) << "The VirtualMachine is not initialized with devices yet.";
+      if (enable && input_copy_stream_ == nullptr) {
+        // null on the devices without streams, where the inputs are still copied synchronously
+        input_copy_stream_ = DeviceAPI::Get(devices[0])->CreateCopyStream(devices[0]);
+      } else if (!enable && input_copy_stream_ != nullptr) {
+        DeviceAPI::Get(devices[0])->StreamSync(devices[0], input_copy_stream_);
+        DeviceAPI::Get(devices[0])->FreeStream(devices[0], input_copy_stream_);
+        input_copy_stream_ = nullptr;
+      }
+    });
+  } else if (name == "profile") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      std::string func_name = args[0];
+      auto it = exec_->global_map.find(func_name);
+      if (it == exec_->global_map.end()) {
+        LOG(FATAL) << "ValueError: Unknown function: " << func_name;
+      }
+      // The collectors are null when profiling over RPC, which cannot send arrays.
+      std::vector<profiling::MetricCollector> collectors;
+      if (args[1].type_code() != kTVMNullptr) {
+        Array<profiling::MetricCollector> array = args[1];
+        for (const profiling::MetricCollector& collector : array) {
+          collectors.push_back(collector);
+        }
+      }
+      std::vector<RegType> inputs(args.size() - 2);
+      for (int i = 2; i < args.size(); ++i) {
+        SetInputTensorWithIndex(inputs, args[i], i - 2, devices[0]);
+      }
+      // the host is also the last device, and may be listed twice
+      std::vector<Device> profiled_devices;
+      std::unordered_set<Device> seen;
+      for (const Device& dev : devices) {
+        if (seen.insert(dev).second) profiled_devices.push_back(dev);
+      }
+      prof_ = profiling::Profiler(profiled_devices, collectors,
+                                  {{String("Executor"), String("Relax VM")}});
+      // warm up, so that the first time costs of the kernels are not reported
+      this->Invoke(it->second, inputs);
+      prof_->Start();
+      this->Invoke(it->second, inputs);
+      prof_->Stop();
+      profiling::Report report = prof_->Report();
+      prof_ = std::nullopt;  // releases the hardware counters
+      *rv = report;
+    });
+  } else if (name == "profile_rpc") {
+    // A Report cannot be returned over RPC, it is serialized here and deserialized by the client.
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      // the arguments of profile, with null collectors after the function name
+      std::vector<TVMValue> values(args.num_args + 1);
+      std::vector<int> tcodes(args.num_args + 1);
+      values[1].v_handle = nullptr;
+      tcodes[1] = kTVMNullptr;
+      for (int i = 0; i < args.num_args; ++i) {
+        values[i + (i > 0)] = args.values[i];
+        tcodes[i + (i > 0)] = args.type_codes[i];
+      }
+      TVMRetValue report;
+      GetFunction("profile", sptr_to_self)
+          .CallPacked(TVMArgs(values.data(), tcodes.data(), values.size()), &report);
+      *rv = report.AsObjectRef<profiling::Report>()->AsJSON();
+    });
+  } else if (name == "set_thread_pool") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      thread_pool_ = args[0].operator std::string();
     });
   } else if (name == "save_function") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
@@ -180,6 +629,7 @@ PackedFunc VirtualMachine::GetFunction(const std::string& name,
                    << "; use `set_input` first.";
         return;
       }
+      if (input_copy_stream_ != nullptr) this->WaitForUploadedInputs();
       outputs_[func_name] = this->Invoke(gf_idx, inputs_[func_name]);
     });
   } else if (name == "get_output_arity") {
@@ -211,6 +661,10 @@ PackedFunc VirtualMachine::GetFunction(const std::string& name,
   } else if (name == "set_input") {
     return PackedFunc(
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { SetInput(args[0], args, 1); });
+  } else if (name == "set_input_borrowed") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      SetInput(args[0], args, 1, /*borrow=*/true);
+    });
   } else if (name == "get_function_arity") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
       std::string func_name = args[0];
@@ -238,17 +692,34 @@ PackedFunc VirtualMachine::GetFunction(const std::string& name,
   const auto& m = exec_->global_map;
   if (m.find(name) != m.end()) {
     Index gf_idx = m.at(name);
-    return PackedFunc([sptr_to_self, this, gf_idx, name](TVMArgs args, TVMRetValue* rv) {
+    int64_t version = program_version_;
+    return PackedFunc([sptr_to_self, this, gf_idx, version, name](TVMArgs args,
+                                                                  TVMRetValue* rv) {
+      Index func_idx = gf_idx;
+      if (version != program_version_) {
+        // looked up before a hot reload, it calls the function of the same name of the new one
+        auto it = exec_->global_map.find(name);
+        CHECK(it != exec_->global_map.end())
+            << "ValueError: The reloaded executable has no function " << name;
+        func_idx = it->second;
+      }
       if (inputs_.count(name)) {
         LOG(FATAL) << "ValueError: If inputs have been set, `invoke_stateful`"
                    << " must be used to invoke a function!";
         return;
       } else {
+        if (specialize_shapes_) {
+          PackedFunc variant = this->LookupSpecialization(name, args);
+          if (variant != nullptr) {
+            variant.CallPacked(args, rv);
+            return;
+          }
+        }
         std::vector<RegType> inputs(args.size());
         for (int i = 0; i < args.size(); ++i) {
           inputs[i] = args[i];
         }
-        *rv = this->Invoke(gf_idx, inputs);
+        *rv = this->Invoke(func_idx, inputs);
       }
     });
   } else {
@@ -257,21 +728,179 @@ PackedFunc VirtualMachine::GetFunction(const std::string& name,
   }
 }
 
+/*! \brief Decode the instruction stream once so that the dispatch loop reads a flat array. */
+static std::vector<Instruction> DecodeInstructions(const Executable& exec) {
+  std::vector<Instruction> instrs;
+  instrs.reserve(exec.instr_offset.size());
+  for (size_t i = 0; i < exec.instr_offset.size(); ++i) {
+    instrs.push_back(exec.GetInstruction(i));
+  }
+  return instrs;
+}
+
 void VirtualMachine::LoadExecutable(ObjectPtr<Executable> exec) {
   this->exec_ = exec;
   CHECK_LE(exec_->imports().size(), 1);
   this->lib = exec_->imports().empty() ? Optional<Module>(NullOpt) : exec_->imports()[0];
+  this->instrs_ = DecodeInstructions(*exec_);
+  this->InitFuncTable();
+}
+
+std::shared_ptr<ConstantPool> VirtualMachine::CreateConstantPool(const Executable& exec) const {
+  // Place the NDArray constants on the devices they are used on, -1 being the host which is
+  // always the last device.
+  size_t num_constants = exec.constants.size();
+  std::vector<Device> constant_devices;
+  constant_devices.reserve(num_constants);
+  for (size_t i = 0; i < num_constants; ++i) {
+    Index device_index = i < exec.constant_devices.size() ? exec.constant_devices[i] : 0;
+    if (device_index < 0) {
+      device_index = static_cast<Index>(devices.size()) - 1;
+    } else if (device_index >= static_cast<Index>(devices.size())) {
+      device_index = 0;
+    }
+    constant_devices.push_back(devices[device_index]);
+  }
+  return std::make_shared<ConstantPool>(exec.constants, std::move(constant_devices));
+}
+
+std::string VirtualMachine::HotReload(ObjectPtr<Executable> exec, bool upload_constants) {
+  ICHECK(exec_ && constants) << "The VM must be initialized before it is reloaded.";
+  CHECK_LE(exec->imports().size(), 1);
+  // Prepare the new program without holding the lock, the sessions being created meanwhile
+  // from the previous one.
+  std::vector<Instruction> instrs = DecodeInstructions(*exec);
+  std::shared_ptr<ConstantPool> pool = CreateConstantPool(*exec);
+  if (constants->sharing()) {
+    pool->EnableSharing();
+  }
+  auto [num_reused, reused_bytes] = pool->ReuseResident(constants.get());
+  std::pair<size_t, size_t> uploaded{0, 0};
+  if (upload_constants) {
+    uploaded = pool->UploadAll();
+  }
+
+  std::lock_guard<std::mutex> lock(program_mutex_);
+  this->exec_ = exec;
+  this->lib = exec_->imports().empty() ? Optional<Module>(NullOpt) : exec_->imports()[0];
+  this->instrs_ = std::move(instrs);
+  this->constants = std::move(pool);
+  ++program_version_;
+  this->InitFuncTable();
+  // The state kept for the functions of the previous program.
+  inputs_.clear();
+  outputs_.clear();
+  static_storages_.clear();
+  cuda_graphs_.clear();
+  saved_closures_.clear();
+  {
+    std::lock_guard<std::mutex> specialization_lock(specialization_mutex_);
+    specializations_.clear();
+    specialize_shapes_ = specialization_threshold_ > 0;
+  }
+
+  std::ostringstream os;
+  os << "{\"num_constants\": " << exec_->constants.size() << ", \"num_reused\": " << num_reused
+     << ", \"reused_bytes\": " << reused_bytes << ", \"num_uploaded\": " << uploaded.first
+     << ", \"uploaded_bytes\": " << uploaded.second << "}";
+  return os.str();
+}
+
+VirtualMachine::~VirtualMachine() {
+  for (const std::shared_ptr<Allocator>& alloc : owned_allocators) {
+    // the allocator outlives the VM when its storages do
+    if (alloc != nullptr && alloc->type() == kBudgeted) {
+      static_cast<BudgetedAllocator*>(alloc.get())->SetSpillHandler(nullptr);
+    }
+  }
+  spilled_.clear();
+  if (header_pool_ != nullptr) {
+    header_pool_->DecRef();
+  }
+  for (size_t i = 1; i < streams_.size(); ++i) {
+    if (streams_[i] != nullptr) {
+      DeviceAPI::Get(devices[0])->FreeStream(devices[0], streams_[i]);
+    }
+  }
+  if (input_copy_stream_ != nullptr) {
+    DeviceAPI::Get(devices[0])->FreeStream(devices[0], input_copy_stream_);
+  }
+}
+
+TVMStreamHandle VirtualMachine::GetStream(int64_t stream_index) {
+  ICHECK_GE(stream_index, 0);
+  ICHECK(!devices.empty()) << "The VirtualMachine is not initialized with devices yet.";
+  if (static_cast<size_t>(stream_index) >= streams_.size()) {
+    streams_.resize(stream_index + 1, nullptr);
+  }
+  if (stream_index != 0 && streams_[stream_index] == nullptr) {
+    streams_[stream_index] = DeviceAPI::Get(devices[0])->CreateStream(devices[0]);
+  }
+  return streams_[stream_index];
+}
+
+ObjectPtr<VirtualMachine> VirtualMachine::CreateSession() const {
+  std::lock_guard<std::mutex> lock(program_mutex_);
+  ICHECK(exec_) << "The executable is not created yet.";
+  ICHECK(!devices.empty()) << "The VirtualMachine must be initialized before creating sessions.";
+  ObjectPtr<VirtualMachine> sess = make_object<VirtualMachine>();
+  sess->exec_ = exec_;
+  sess->lib = lib;
+  sess->devices = devices;
+  sess->allocators = allocators;
+  sess->owned_allocators = owned_allocators;
+  sess->header_pool_ = HeaderPool::Create();
+  sess->spill_thresholds_.assign(devices.size(), -1);
+  for (size_t i = 0; i < owned_allocators.size(); ++i) {
+    if (owned_allocators[i] != nullptr) {
+      // the session allocates on its own thread, so it cannot share the allocator of the VM
+      AllocatorType type = owned_allocators[i]->type();
+      sess->owned_allocators[i] = MemoryManager::CreateAllocator(devices[i], type);
+      sess->allocators[i] = sess->owned_allocators[i].get();
+      if (type == kBudgeted) {
+        // each session gets a budget of its own, as large as the one of the VM
+        size_t budget = static_cast<BudgetedAllocator*>(owned_allocators[i].get())->budget();
+        sess->SetMemoryBudget(i, budget, spill_thresholds_[i]);
+      }
+    }
+  }
+  sess->instrs_ = instrs_;
+  sess->dispatch_mode_ = dispatch_mode_;
+  sess->thread_pool_ = thread_pool_;
+  sess->unchecked_kernels_ = unchecked_kernels_;
+  if (input_copy_stream_ != nullptr) {
+    sess->input_copy_stream_ = DeviceAPI::Get(devices[0])->CreateCopyStream(devices[0]);
+  }
+  // The pool is shared, so a constant is copied to its device once for all the sessions.
+  sess->constants = constants;
+  sess->param_store = param_store;
+  // Relax functions in the function table call back into the session that owns it.
+  sess->InitFuncTable();
+  return sess;
 }
 
 RegType VirtualMachine::Invoke(Index gf_idx, const std::vector<RegType>& args) {
+  // Only the outermost call attaches the thread to the pool, the nested calls run in its scope.
+  threading::ThreadPoolScope thread_pool(invoke_depth_ == 0 ? thread_pool_ : std::string());
+  ++invoke_depth_;
+  struct DepthGuard {
+    int* depth;
+    ~DepthGuard() { --*depth; }
+  } depth_guard{&invoke_depth_};
+  // The profiler times the calls of the dispatch loop, so it always runs the bytecode.
+  if (static_cast<size_t>(gf_idx) < compiled_funcs_.size() &&
+      compiled_funcs_[gf_idx] != nullptr && !prof_) {
+    return this->InvokeCompiled(gf_idx, args);
+  }
   const VMFunction& gfunc = exec_->global_funcs[gf_idx];
   // Get the curr instr which might be a potential caller.
-  Instruction curr_instr = exec_->GetInstruction(pc_);
+  bool from_call = static_cast<size_t>(pc_) < instrs_.size() &&
+                   (instrs_[pc_].op == Opcode::Call || instrs_[pc_].op == Opcode::LoadShapeCall);
   PushFrame(this->pc_, gfunc);
   // Get new frame and set the caller info.
   VMFrame* curr_frame = frames_.back().get();
-  if (curr_instr.op == Opcode::Call) {
-    curr_frame->caller_return_register = curr_instr.dst;
+  if (from_call) {
+    curr_frame->caller_return_register = instrs_[pc_].dst;
   }
 
   // load arguments to the register file
@@ -287,6 +916,23 @@ RegType VirtualMachine::Invoke(Index gf_idx, const std::vector<RegType>& args) {
   return return_value_;
 }
 
+RegType VirtualMachine::InvokeCompiled(Index gf_idx, const std::vector<RegType>& args) {
+  const VMFunction& gfunc = exec_->global_funcs[gf_idx];
+  ICHECK_EQ(static_cast<size_t>(gfunc.num_args), args.size())
+      << "ValueError: Invoking function " << gfunc.name << " requires " << gfunc.num_args
+      << " inputs but only " << args.size() << " inputs are provided.";
+  std::vector<TVMValue> values(args.size() + 1);
+  std::vector<int> tcodes(args.size() + 1);
+  runtime::TVMArgsSetter setter(values.data(), tcodes.data());
+  setter(0, static_cast<void*>(&compiled_ctx_));
+  for (size_t i = 0; i < args.size(); ++i) {
+    setter(i + 1, args[i]);
+  }
+  TVMRetValue ret;
+  compiled_funcs_[gf_idx].CallPacked(TVMArgs(values.data(), tcodes.data(), values.size()), &ret);
+  return ret;
+}
+
 void VirtualMachine::Init(const std::vector<Device>& devices,
                           const std::vector<AllocatorType>& alloc_types) {
   // TODO(@yuchen): support multi-device heterogeneous execution
@@ -296,48 +942,385 @@ void VirtualMachine::Init(const std::vector<Device>& devices,
 
   this->devices.reserve(devices.size());
   this->allocators.reserve(alloc_types.size());
+  this->owned_allocators.reserve(alloc_types.size());
+  if (this->header_pool_ == nullptr) {
+    this->header_pool_ = HeaderPool::Create();
+  }
+  this->spill_thresholds_.assign(devices.size(), -1);
   for (size_t i = 0; i < devices.size(); i++) {
-    auto alloc = MemoryManager::GetOrCreateAllocator(devices[i], alloc_types[i]);
+    std::shared_ptr<Allocator> owned;
+    Allocator* alloc;
+    if (alloc_types[i] == kLocalPooled || alloc_types[i] == kBudgeted ||
+        alloc_types[i] == kStreamOrdered) {
+      owned = MemoryManager::CreateAllocator(devices[i], alloc_types[i]);
+      alloc = owned.get();
+    } else {
+      alloc = MemoryManager::GetOrCreateAllocator(devices[i], alloc_types[i]);
+    }
     this->devices.push_back(devices[i]);
     this->allocators.push_back(alloc);
+    this->owned_allocators.push_back(std::move(owned));
   }
 }
 
-void VirtualMachine::PrepareFuncTable(Index func_index) {
-  // fast path, function already in cache;
+void VirtualMachine::SetMemoryBudget(Index device_index, int64_t budget, int64_t spill_threshold) {
+  ICHECK_GE(device_index, 0);
+  ICHECK_LT(device_index, static_cast<Index>(devices.size()))
+      << "The device index is out of VM physical devices list";
+  ICHECK_GE(budget, 0);
+  Allocator* alloc = allocators[device_index];
+  ICHECK_EQ(alloc->type(), kBudgeted) << "Only the budgeted allocator supports a memory budget";
+  auto* budgeted = static_cast<BudgetedAllocator*>(alloc);
+  budgeted->SetBudget(budget);
+  if (devices[device_index].device_type == kDLCPU) {
+    // spilling to the host does not free any memory of the host
+    spill_threshold = -1;
+  }
+  spill_thresholds_[device_index] = spill_threshold;
+  if (spill_threshold < 0) {
+    budgeted->SetSpillHandler(nullptr);
+  } else {
+    budgeted->SetSpillHandler(
+        [this, device_index](size_t nbytes) { this->SpillStorages(device_index, nbytes); });
+  }
+}
 
-  if (static_cast<Index>(func_table_.size()) > func_index && func_table_[func_index] != nullptr)
-    return;
+/*! \brief The device of the host memory the storages of a device are spilled to. */
+inline Device SpillDevice(Device dev) {
+  if (dev.device_type == kDLCUDA) return Device{kDLCUDAHost, 0};
+  if (dev.device_type == kDLROCM) return Device{kDLROCMHost, 0};
+  return Device{kDLCPU, 0};
+}
 
-  if (static_cast<Index>(func_table_.size()) <= func_index) {
-    func_table_.resize(func_index + 1, nullptr);
+/*! \brief Copy the bytes of a buffer between a device and the host, and wait for the copy. */
+inline void CopyBytes(void* from, Device from_dev, void* to, Device to_dev, size_t nbytes,
+                      Device dev) {
+  int64_t shape = static_cast<int64_t>(nbytes);
+  DLTensor from_tensor{from, from_dev, 1, DLDataType{kDLUInt, 8, 1}, &shape, nullptr, 0};
+  DLTensor to_tensor{to, to_dev, 1, DLDataType{kDLUInt, 8, 1}, &shape, nullptr, 0};
+  NDArray::CopyFromTo(&from_tensor, &to_tensor);
+  DeviceAPI::Get(dev)->StreamSync(dev, nullptr);
+}
+
+void VirtualMachine::SpillStorages(Index device_index, size_t nbytes) {
+  Device dev = devices[device_index];
+  Allocator* alloc = allocators[device_index];
+  size_t threshold = static_cast<size_t>(spill_thresholds_[device_index]);
+  // the arguments of the running instruction are in use
+  std::unordered_set<const Object*> pinned;
+  if (!frames_.empty() && static_cast<size_t>(pc_) < instrs_.size()) {
+    const Instruction& instr = instrs_[pc_];
+    const std::vector<RegType>& regs = frames_.back()->register_file;
+    auto pin = [&](Instruction::Arg arg) {
+      if (arg.kind() == Instruction::kRegister && arg.value() >= 0 &&
+          arg.value() < static_cast<Index>(regs.size()) &&
+          (regs[arg.value()].type_code() == kTVMNDArrayHandle ||
+           regs[arg.value()].type_code() == kTVMObjectHandle)) {
+        pinned.insert(regs[arg.value()].AsObjectRef<ObjectRef>().get());
+      }
+    };
+    if (instr.op == Opcode::Call || instr.op == Opcode::LoadShapeCall) {
+      for (Index i = 0; i < instr.num_args; ++i) pin(instr.args[i]);
+    }
+  }
+  // count the references of the objects held by the registers, in the order of definition
+  std::vector<ObjectRef> objects;
+  std::unordered_map<const Object*, int64_t> num_regs;
+  for (const std::unique_ptr<VMFrame>& frame : frames_) {
+    for (const RegType& reg : frame->register_file) {
+      if (reg.type_code() != kTVMNDArrayHandle && reg.type_code() != kTVMObjectHandle) continue;
+      ObjectRef obj = reg.AsObjectRef<ObjectRef>();
+      if (num_regs[obj.get()]++ == 0) objects.push_back(obj);
+    }
+  }
+  std::unordered_map<const Object*, std::shared_ptr<SpilledStorage>> candidates;
+  std::vector<std::shared_ptr<SpilledStorage>> order;
+  for (const ObjectRef& obj : objects) {
+    const auto* storage = obj.as<StorageObj>();
+    if (storage == nullptr || storage->buffer.data == nullptr || storage->allocator.get() != alloc ||
+        storage->buffer.size < threshold || pinned.count(storage) || spilled_.count(storage)) {
+      continue;
+    }
+    auto spill = std::make_shared<SpilledStorage>();
+    spill->storage = Downcast<Storage>(obj);
+    candidates[storage] = spill;
+    order.push_back(spill);
+  }
+  for (const ObjectRef& obj : objects) {
+    const auto* tensor = obj.as<NDArray::Container>();
+    if (tensor == nullptr) continue;
+    auto it = candidates.find(static_cast<const Object*>(tensor->manager_ctx));
+    if (it == candidates.end()) continue;
+    // a view held outside the registers, or in use, keeps its storage on the device
+    if (obj.use_count() - 1 != num_regs[tensor] || pinned.count(tensor)) {
+      candidates.erase(it);
+      continue;
+    }
+    const auto* base = static_cast<const uint8_t*>(it->second->storage->buffer.data);
+    size_t offset = static_cast<const uint8_t*>(tensor->dl_tensor.data) - base;
+    it->second->views.emplace_back(Downcast<NDArray>(obj), offset);
   }
 
-  const std::string& func_name = exec_->func_names[func_index];
+  size_t freed = 0;
+  for (const std::shared_ptr<SpilledStorage>& spill : order) {
+    if (freed >= nbytes) break;
+    StorageObj* storage = spill->storage.operator->();
+    // besides the registers and the views, only referenced by objects and spill
+    if (!candidates.count(storage) ||
+        spill->storage.use_count() - 2 !=
+            num_regs[storage] + static_cast<int64_t>(spill->views.size())) {
+      continue;
+    }
+    for (size_t i = 0; i < streams_.size(); ++i) {
+      DeviceAPI::Get(dev)->StreamSync(dev, streams_[i]);
+    }
+    Buffer buffer = storage->buffer;
+    spill->host = NDArray::Empty({static_cast<int64_t>(buffer.size)}, DLDataType{kDLUInt, 8, 1},
+                                 SpillDevice(dev));
+    CopyBytes(buffer.data, dev, spill->host->data, spill->host->device, buffer.size, dev);
+    storage->buffer.data = nullptr;
+    for (auto& view : spill->views) {
+      const_cast<DLTensor*>(view.first.operator->())->data = nullptr;
+      spilled_[view.first.get()] = spill;
+    }
+    spilled_[storage] = spill;
+    alloc->Free(buffer);
+    static_cast<BudgetedAllocator*>(alloc)->RecordSpill(buffer.size);
+    freed += buffer.size;
+  }
+}
 
-  // lookup function and populate
-  PackedFunc func{nullptr};
+void VirtualMachine::ReloadSpilled(const RegType& reg) {
+  if (reg.type_code() != kTVMNDArrayHandle && reg.type_code() != kTVMObjectHandle) return;
+  auto it = spilled_.find(reg.AsObjectRef<ObjectRef>().get());
+  if (it == spilled_.end()) return;
+  std::shared_ptr<SpilledStorage> spill = it->second;
+  spilled_.erase(spill->storage.get());
+  for (const auto& view : spill->views) {
+    spilled_.erase(view.first.get());
+  }
+  StorageObj* storage = spill->storage.operator->();
+  size_t size = static_cast<size_t>(spill->host->shape[0]);
+  // the allocation may spill other storages, but not the one being reloaded
+  Buffer buffer = storage->allocator->Alloc(size, kAllocAlignment, DLDataType{kDLUInt, 8, 1});
+  CopyBytes(spill->host->data, spill->host->device, buffer.data, buffer.device, size,
+            buffer.device);
+  storage->buffer = buffer;
+  for (const auto& view : spill->views) {
+    const_cast<DLTensor*>(view.first.operator->())->data =
+        static_cast<uint8_t*>(buffer.data) + view.second;
+  }
+  static_cast<BudgetedAllocator*>(storage->allocator.get())->RecordReload();
+}
+
+void VirtualMachine::PruneSpilled() {
+  for (auto it = spilled_.begin(); it != spilled_.end();) {
+    const SpilledStorage& spill = *it->second;
+    // only referenced by the record
+    bool unused = spill.storage.use_count() == 1 + static_cast<int64_t>(spill.views.size());
+    for (const auto& view : spill.views) {
+      unused = unused && view.first.use_count() == 1;
+    }
+    it = unused ? spilled_.erase(it) : std::next(it);
+  }
+}
+
+void VirtualMachine::InitFuncTable() {
+  func_table_.assign(exec_->func_names.size(), nullptr);
+  func_table_vm_funcs_.assign(exec_->func_names.size(), -1);
+  func_resolve_seconds_ = 0;
+  // The Relax functions compiled by relax.vm.build(exec_mode="compiled") are exported with the
+  // kernels, and are only found once the library is loaded back.
+  compiled_funcs_.assign(exec_->global_funcs.size(), nullptr);
   if (this->lib.defined()) {
-    func = this->lib.value()->GetFunction(func_name, true);
+    for (size_t i = 0; i < exec_->global_funcs.size(); ++i) {
+      compiled_funcs_[i] =
+          this->lib.value()->GetFunction(CompiledFunctionSymbol(exec_->global_funcs[i].name), true);
+    }
   }
-  if (!func.defined()) {
-    const PackedFunc* p_func = Registry::Get(func_name);
-    if (p_func == nullptr) {
-      const auto& m = exec_->global_map;
-      ICHECK(m.find(func_name) != m.end())
-          << "Error: Cannot find function " << func_name
-          << " in either Relax VM kernel library, or in TVM runtime PackedFunc registry, or in "
-             "global Relax functions of the VM executable";
-      func = this->GetFunction(func_name, GetObjectPtr<Object>(this));
+  compiled_ctx_.vm = this;
+  compiled_ctx_.get_func = [](void* vm_ptr, int64_t func_idx) {
+    return &static_cast<VirtualMachine*>(vm_ptr)->GetFuncFromTable(func_idx);
+  };
+  compiled_ctx_.get_constant = [](void* vm_ptr, int64_t const_idx) {
+    return &static_cast<VirtualMachine*>(vm_ptr)->constants->Get(const_idx);
+  };
+  compiled_ctx_.alloc_storage_tensor = [](void* vm_ptr, const TVMRetValue& size,
+                                          int64_t device_index, const TVMRetValue& dtype_hint,
+                                          int64_t offset, const TVMRetValue& shape,
+                                          const TVMRetValue& dtype, TVMRetValue* storage,
+                                          TVMRetValue* tensor) {
+    ShapeTuple buffer_size = size.AsObjectRef<ShapeTuple>();
+    ICHECK_EQ(buffer_size.size(), 1);
+    Storage fresh = static_cast<VirtualMachine*>(vm_ptr)->AllocStorage(buffer_size[0],
+                                                                       device_index, dtype_hint);
+    *tensor = fresh->AllocNDArray(offset, shape.AsObjectRef<ShapeTuple>(), dtype);
+    *storage = fresh;
+  };
+  compiled_ctx_.load_scalar_int = [](void* vm_ptr, const TVMRetValue& cond) {
+    return static_cast<VirtualMachine*>(vm_ptr)->ScalarToInt(cond);
+  };
+}
+
+std::string VirtualMachine::FuncTableStats() const {
+  std::ostringstream os;
+  Index num_resolved = 0;
+  os << "{\"resolved\": [";
+  for (size_t i = 0; i < func_table_.size(); ++i) {
+    if (func_table_[i] == nullptr) continue;
+    os << (num_resolved++ == 0 ? "" : ", ") << "\"" << exec_->func_names[i] << "\"";
+  }
+  os << "], \"num_functions\": " << exec_->func_names.size()
+     << ", \"num_resolved\": " << num_resolved
+     << ", \"resolve_time_ms\": " << func_resolve_seconds_ * 1e3 << ", \"num_compiled\": "
+     << std::count_if(compiled_funcs_.begin(), compiled_funcs_.end(),
+                      [](const PackedFunc& f) { return f != nullptr; })
+     << "}";
+  return os.str();
+}
+
+Array<ShapeTuple> ArgumentShapes(TVMArgs args) {
+  Array<ShapeTuple> shapes;
+  for (int i = 0; i < args.size(); ++i) {
+    if (args[i].type_code() == kTVMNDArrayHandle) {
+      shapes.push_back(args[i].operator NDArray().Shape());
     } else {
-      func = *(p_func);
+      shapes.push_back(ShapeTuple());
     }
   }
+  return shapes;
+}
+
+PackedFunc VirtualMachine::LookupSpecialization(const std::string& func_name, TVMArgs args) {
+  Array<ShapeTuple> shapes = ArgumentShapes(args);
+  PackedFunc callback;
+  {
+    std::lock_guard<std::mutex> lock(specialization_mutex_);
+    ShapeSpecialization& entry = specializations_[func_name][ShapeSignature(shapes)];
+    ++entry.num_calls;
+    if (entry.func != nullptr) return entry.func;
+    if (entry.num_calls == specialization_threshold_) callback = specialization_callback_;
+  }
+  // the callback may add the specialization right away
+  if (callback != nullptr) callback(String(func_name), shapes);
+  return nullptr;
+}
+
+std::string VirtualMachine::SpecializationStats() {
+  std::lock_guard<std::mutex> lock(specialization_mutex_);
+  std::ostringstream os;
+  os << "{";
+  bool first_func = true;
+  for (const auto& func : specializations_) {
+    os << (first_func ? "" : ", ") << "\"" << func.first << "\": {";
+    first_func = false;
+    bool first = true;
+    for (const auto& kv : func.second) {
+      os << (first ? "" : ", ") << "\"" << kv.first << "\": {\"calls\": " << kv.second.num_calls
+         << ", \"specialized\": " << (kv.second.func != nullptr ? "true" : "false") << "}";
+      first = false;
+    }
+    os << "}";
+  }
+  os << "}";
+  return os.str();
+}
+
+void VirtualMachine::PreloadFunctions(const std::vector<std::string>& func_names) {
+  ICHECK(exec_) << "The executable is not created yet.";
+  std::unordered_map<std::string, Index> func_index;
+  for (size_t i = 0; i < exec_->func_names.size(); ++i) {
+    func_index.emplace(exec_->func_names[i], i);
+  }
+  for (const std::string& name : func_names) {
+    auto it = func_index.find(name);
+    if (it != func_index.end()) this->PrepareFuncTable(it->second);
+  }
+}
+
+void VirtualMachine::ReserveStorage(Index device_index, const std::vector<int64_t>& sizes) {
+  ICHECK(device_index >= 0 && device_index < static_cast<Index>(allocators.size()))
+      << "IndexError: device index " << device_index << " is out of the VM devices range";
+  Allocator* alloc = allocators[device_index];
+  std::vector<Buffer> buffers;
+  buffers.reserve(sizes.size());
+  for (int64_t size : sizes) {
+    buffers.push_back(alloc->Alloc(size, kAllocAlignment, DLDataType{kDLUInt, 8, 1}));
+  }
+  for (const Buffer& buffer : buffers) {
+    alloc->Free(buffer);
+  }
+}
+
+PackedFunc VirtualMachine::ResolvePackedFunc(const std::string& func_name, Index* gf_idx) {
+  if (gf_idx != nullptr) *gf_idx = -1;
+  PackedFunc func{nullptr};
+  if (this->lib.defined() && unchecked_kernels_) {
+    func = this->lib.value()->GetFunction(func_name + symbol::tvm_unchecked_suffix, true);
+  }
+  if (this->lib.defined() && !func.defined()) {
+    func = this->lib.value()->GetFunction(func_name, true);
+  }
+  if (func.defined()) {
+    return func;
+  }
+  const PackedFunc* p_func = Registry::Get(func_name);
+  if (p_func != nullptr) {
+    return *(p_func);
+  }
+  const auto& m = exec_->global_map;
+  auto it = m.find(func_name);
+  if (it != m.end()) {
+    if (gf_idx != nullptr) *gf_idx = it->second;
+    // Capture the raw pointer: the table is owned by the VM itself.
+    Index func_idx = it->second;
+    return PackedFunc([this, func_idx](TVMArgs args, TVMRetValue* rv) {
+      std::vector<RegType> inputs(args.size());
+      for (int i = 0; i < args.size(); ++i) {
+        inputs[i] = args[i];
+      }
+      *rv = this->Invoke(func_idx, inputs);
+    });
+  }
+  return func;
+}
+
+void VirtualMachine::PrepareFuncTable(Index func_index) {
+  // fast path, function already in cache;
+  if (static_cast<Index>(func_table_.size()) > func_index && func_table_[func_index] != nullptr)
+    return;
+
+  if (static_cast<Index>(func_table_.size()) <= func_index) {
+    func_table_.resize(func_index + 1, nullptr);
+  }
+  if (static_cast<Index>(func_table_vm_funcs_.size()) <= func_index) {
+    func_table_vm_funcs_.resize(func_index + 1, -1);
+  }
+
+  // slow path, the function is called for the first time.
+  const std::string& func_name = exec_->func_names[func_index];
+  auto start = std::chrono::steady_clock::now();
+  PackedFunc func = this->ResolvePackedFunc(func_name, &func_table_vm_funcs_[func_index]);
+  func_resolve_seconds_ +=
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  ICHECK(func.defined())
+      << "Error: Cannot find function " << func_name
+      << " in either Relax VM kernel library, or in TVM runtime PackedFunc registry, or in "
+         "global Relax functions of the VM executable";
   func_table_[func_index] = func;
 }
 
+const PackedFunc& VirtualMachine::GetFuncFromTable(Index func_idx) {
+  ICHECK(exec_) << "The executable is not created yet.";
+  ICHECK_LT(static_cast<size_t>(func_idx), exec_->func_names.size())
+      << "IndexError: function index " << func_idx << " is out of the function table range";
+  this->PrepareFuncTable(func_idx);
+  return func_table_[func_idx];
+}
+
 void VirtualMachine::RunInstrCall(VMFrame* curr_frame, Instruction instr) {
   DLOG(INFO) << "\n  pc = " << pc_ << ", execute: " << exec_->func_names[instr.func_idx];
+  TVM_TRACE_SCOPE("vm", exec_->func_names[instr.func_idx].c_str());
 
   // Use the call arg stack from the current frame to increase reuse
   // and avoid re-allocation
@@ -366,7 +1349,7 @@ void VirtualMachine::RunInstrCall(VMFrame* curr_frame, Instruction instr) {
         break;
       }
       case Instruction::kConstIdx: {
-        setter(i, this->constants[arg.value()]);
+        setter(i, this->constants->Get(arg.value()));
         break;
       }
       default: {
@@ -378,7 +1361,19 @@ void VirtualMachine::RunInstrCall(VMFrame* curr_frame, Instruction instr) {
   TVMRetValue ret;
   // prepare and invoke
   this->PrepareFuncTable(instr.func_idx);
+  bool profile_call = prof_ && prof_->IsRunning();
+  if (profile_call) {
+    // The device of the first tensor argument is used for synchronization.
+    std::vector<NDArray> arrays;
+    for (int i = 0; i < args.size(); ++i) {
+      if (args[i].type_code() == kTVMNDArrayHandle) arrays.push_back(args[i]);
+    }
+    Device dev = arrays.empty() ? devices.back() : arrays[0]->device;
+    prof_->StartCall(exec_->func_names[instr.func_idx], dev,
+                     {{"Argument Shapes", profiling::ShapeString(arrays)}});
+  }
   func_table_[instr.func_idx].CallPacked(args, &ret);
+  if (profile_call) prof_->StopCall();
 
   // save the return value to the register
   if (instr.dst != Instruction::kVoidArg) {
@@ -388,10 +1383,317 @@ void VirtualMachine::RunInstrCall(VMFrame* curr_frame, Instruction instr) {
   pc_++;
 }
 
-int64_t VirtualMachine::LoadScalarInt(RegName reg) const {
-  int64_t result = 0;
+bool VirtualMachine::RunInstrTailCall(VMFrame* curr_frame, const Instruction& instr) {
+  // The result of the call must be returned right away, so nothing of the caller runs after it
+  // but the Kill instructions, which release registers the callee releases as well.
+  size_t next = pc_ + 1;
+  while (next < instrs_.size() && instrs_[next].op == Opcode::Kill) ++next;
+  if (next >= instrs_.size() || instrs_[next].op != Opcode::Ret ||
+      instrs_[next].result != instr.dst) {
+    return false;
+  }
+  // The profiler times each call, so it sees the calls as they are written.
+  if (prof_) return false;
+  this->PrepareFuncTable(instr.func_idx);
+  Index gf_idx = func_table_vm_funcs_[instr.func_idx];
+  if (gf_idx < 0) return false;
+  if (static_cast<size_t>(gf_idx) < compiled_funcs_.size() && compiled_funcs_[gf_idx] != nullptr) {
+    return false;
+  }
+  const VMFunction& gfunc = exec_->global_funcs[gf_idx];
+  ICHECK_EQ(gfunc.num_args, instr.num_args)
+      << "ValueError: Invoking function " << gfunc.name << " requires " << gfunc.num_args
+      << " inputs but only " << instr.num_args << " inputs are provided.";
+  DLOG(INFO) << "\n  pc = " << pc_ << ", tail call: " << gfunc.name;
+  // Read the arguments before the registers they are read from are released.
+  std::vector<RegType>& args = tail_call_args_;
+  args.resize(instr.num_args);
+  for (Index i = 0; i < instr.num_args; ++i) {
+    Instruction::Arg arg = instr.args[i];
+    if (arg.kind() == Instruction::kImmediate) {
+      args[i] = arg.value();
+    } else {
+      ICHECK(arg.kind() != Instruction::kRegister || arg.value() != Instruction::kVMRegister)
+          << "The VM register cannot be passed to a Relax function";
+      args[i] = ReadArg(curr_frame, arg);
+    }
+  }
+  // The frame keeps its return pc and the register of the caller, which the callee returns to.
+  curr_frame->Clear();
+  curr_frame->register_file.resize(gfunc.register_file_size);
+  if (!spilled_.empty()) {
+    PruneSpilled();
+  }
+  for (Index i = 0; i < instr.num_args; ++i) {
+    WriteRegister(curr_frame, i, std::move(args[i]));
+  }
+  args.clear();
+  pc_ = gfunc.start_instr;
+  return true;
+}
+
+inline RegType VirtualMachine::ReadArg(VMFrame* curr_frame, Instruction::Arg arg) {
+  if (arg.kind() == Instruction::kConstIdx) {
+    return this->constants->Get(arg.value());
+  }
+  return ReadRegister(curr_frame, arg.value());
+}
+
+Storage VirtualMachine::AllocStorage(int64_t size, Index device_index, DLDataType dtype_hint,
+                                     const std::string& mem_scope) {
+  TVM_TRACE_SCOPE("alloc", "VirtualMachine::AllocStorage");
+  ICHECK_LT(device_index, static_cast<Index>(devices.size()))
+      << "The device index is out of VM physical devices list";
+  if (device_index == -1) {
+    // Allocate on host. Host is always the last element of devices.
+    device_index = devices.size() - 1;
+  }
+  auto storage_obj = header_pool_->MakeStorage();
+  if (!mem_scope.empty() && mem_scope != "global") {
+    std::shared_ptr<Allocator>& scoped = scoped_allocators_[{device_index, mem_scope}];
+    if (scoped == nullptr) {
+      scoped = std::make_shared<ScopedAllocator>(devices[device_index], mem_scope);
+    }
+    storage_obj->buffer = scoped->Alloc(size, kAllocAlignment, dtype_hint);
+    storage_obj->allocator = scoped;
+    // the scoped buffers are not cached, so they are not recorded for a warmup either
+    Storage storage(storage_obj);
+    if (retained_storage != nullptr) {
+      retained_storage->push_back(storage);
+    }
+    return storage;
+  }
+  Allocator* alloc = allocators[device_index];
+  ICHECK(alloc) << "Did you forget to init the VirtualMachine with devices?";
+  storage_obj->buffer = alloc->Alloc(size, kAllocAlignment, dtype_hint);
+  storage_obj->allocator = owned_allocators[device_index];
+  if (record_storage_) {
+    recorded_buffers_.resize(devices.size());
+    size_t& recorded = recorded_buffers_[device_index][storage_obj->buffer.data];
+    recorded = std::max(recorded, storage_obj->buffer.size);
+  }
+  Storage storage(storage_obj);
+  if (retained_storage != nullptr) {
+    retained_storage->push_back(storage);
+  }
+  return storage;
+}
+
+Storage VirtualMachine::AllocStaticStorage(int64_t size, Index device_index, DLDataType dtype_hint,
+                                           Index slot, const std::string& mem_scope) {
+  ICHECK_GE(slot, 0);
+  if (static_cast<size_t>(slot) >= static_storages_.size()) {
+    static_storages_.resize(slot + 1);
+  }
+  Storage& storage = static_storages_[slot];
+  if (storage.defined() && storage.use_count() == 1 &&
+      static_cast<int64_t>(storage->buffer.size) >= size) {
+    if (retained_storage != nullptr) {
+      retained_storage->push_back(storage);
+    }
+    return storage;
+  }
+  Storage fresh = AllocStorage(size, device_index, dtype_hint, mem_scope);
+  if (!storage.defined() || storage.use_count() == 1) {
+    storage = fresh;
+  }
+  return fresh;
+}
+
+void VirtualMachine::RunInstrAllocStorageTensor(VMFrame* curr_frame, const Instruction& instr) {
+  const Instruction::Arg* args = instr.alloc_args;
+  ShapeTuple size = ReadArg(curr_frame, args[0]).AsObjectRef<ShapeTuple>();
+  ICHECK_EQ(size.size(), 1);
+  Storage storage = AllocStorage(size[0], args[1].value(), ReadArg(curr_frame, args[2]));
+  ShapeTuple shape = ReadArg(curr_frame, args[4]).AsObjectRef<ShapeTuple>();
+  NDArray tensor = storage->AllocNDArray(args[3].value(), shape, ReadArg(curr_frame, args[5]));
+  RegType storage_reg, tensor_reg;
+  storage_reg = storage;
+  tensor_reg = tensor;
+  WriteRegister(curr_frame, instr.storage, storage_reg);
+  WriteRegister(curr_frame, instr.dst, tensor_reg);
+  pc_++;
+}
+
+void VirtualMachine::RunInstrLoadShapeCall(VMFrame* curr_frame, const Instruction& instr) {
+  NDArray heap = ReadRegister(curr_frame, instr.shape_args[1].value()).AsObjectRef<NDArray>();
+  ShapeTuple indexes = ReadArg(curr_frame, instr.shape_args[2]).AsObjectRef<ShapeTuple>();
+  const int64_t* heap_data = static_cast<const int64_t*>(heap->data);
+  int64_t heap_size = heap->shape[0];
+  std::vector<int64_t> shape(indexes.size());
+  for (size_t i = 0; i < indexes.size(); ++i) {
+    ICHECK(indexes[i] >= 0 && indexes[i] < heap_size);
+    shape[i] = heap_data[indexes[i]];
+  }
+  RegType shape_reg;
+  shape_reg = ShapeTuple(shape);
+  WriteRegister(curr_frame, instr.shape_args[0].value(), shape_reg);
+  this->RunInstrCall(curr_frame, instr);
+}
+
+NDArray VirtualMachine::AllocShapeHeap(int64_t size) {
+  if (frames_.empty()) {
+    // called by a compiled function, which has no frame to keep the heap with
+    return NDArray::Empty({size}, DLDataType{kDLInt, 64, 1}, devices.back());
+  }
+  VMFrame* frame = frames_.back().get();
+  if (!frame->shape_heap.defined() || frame->shape_heap->shape[0] != size) {
+    // The shape values are computed by the VM, so the heap always lives on the host,
+    // which is the last element of devices.
+    frame->shape_heap = NDArray::Empty({size}, DLDataType{kDLInt, 64, 1}, devices.back());
+  }
+  return frame->shape_heap;
+}
+
+/*! \brief Get the slots of a shape heap held by a register. */
+inline int64_t* ShapeHeapData(const RegType& heap, int64_t* heap_size) {
+  DLTensor* tensor = heap;
+  *heap_size = tensor->shape[0];
+  return reinterpret_cast<int64_t*>(static_cast<char*>(tensor->data) + tensor->byte_offset);
+}
+
+void VirtualMachine::RunInstrLoadShape(VMFrame* curr_frame, const Instruction& instr) {
+  int64_t heap_size;
+  const int64_t* heap = ShapeHeapData(curr_frame->register_file[instr.heap], &heap_size);
+  std::vector<ShapeTuple::index_type> shape(instr.heap_num_args);
+  for (Index i = 0; i < instr.heap_num_args; ++i) {
+    ExecWord heap_idx = instr.heap_args[i];
+    ICHECK(heap_idx >= 0 && heap_idx < heap_size);
+    shape[i] = heap[heap_idx];
+  }
+  RegType shape_reg;
+  shape_reg = ShapeTuple(std::move(shape));
+  WriteRegister(curr_frame, instr.dst, shape_reg);
+  pc_++;
+}
+
+void VirtualMachine::RunInstrStoreShape(VMFrame* curr_frame, const Instruction& instr) {
+  int64_t heap_size;
+  int64_t* heap = ShapeHeapData(curr_frame->register_file[instr.heap], &heap_size);
+  ShapeTuple shape = curr_frame->register_file[instr.shape].AsObjectRef<ShapeTuple>();
+  ICHECK_EQ(static_cast<Index>(shape.size()), instr.heap_num_args);
+  for (Index i = 0; i < instr.heap_num_args; ++i) {
+    ExecWord heap_idx = instr.heap_args[i];
+    ICHECK(heap_idx >= 0 && heap_idx < heap_size);
+    heap[heap_idx] = shape[i];
+  }
+  pc_++;
+}
+
+/*! \brief Floor division of integers, rounding towards negative infinity. */
+inline int64_t FloorDiv(int64_t a, int64_t b) {
+  int64_t q = a / b;
+  return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+}
+
+void VirtualMachine::RunInstrComputeShape(VMFrame* curr_frame, const Instruction& instr) {
+  int64_t heap_size;
+  int64_t* heap = ShapeHeapData(curr_frame->register_file[instr.heap], &heap_size);
+  std::vector<int64_t>& stack = curr_frame->shape_stack;
+  stack.clear();
+  for (Index i = 0; i < instr.heap_num_args; i += 2) {
+    ShapeOp op = static_cast<ShapeOp>(instr.heap_args[i]);
+    ExecWord operand = instr.heap_args[i + 1];
+    switch (op) {
+      case ShapeOp::kLoad: {
+        ICHECK(operand >= 0 && operand < heap_size);
+        stack.push_back(heap[operand]);
+        continue;
+      }
+      case ShapeOp::kImm: {
+        stack.push_back(operand);
+        continue;
+      }
+      case ShapeOp::kStore: {
+        ICHECK(operand >= 0 && operand < heap_size);
+        ICHECK(!stack.empty());
+        heap[operand] = stack.back();
+        stack.pop_back();
+        continue;
+      }
+      default:
+        break;
+    }
+    ICHECK_GE(stack.size(), 2) << "Malformed shape program";
+    int64_t rhs = stack.back();
+    stack.pop_back();
+    int64_t& lhs = stack.back();
+    switch (op) {
+      case ShapeOp::kAdd:
+        lhs += rhs;
+        break;
+      case ShapeOp::kSub:
+        lhs -= rhs;
+        break;
+      case ShapeOp::kMul:
+        lhs *= rhs;
+        break;
+      case ShapeOp::kDiv:
+        ICHECK_NE(rhs, 0) << "Division by zero in shape computation";
+        lhs /= rhs;
+        break;
+      case ShapeOp::kMod:
+        ICHECK_NE(rhs, 0) << "Division by zero in shape computation";
+        lhs %= rhs;
+        break;
+      case ShapeOp::kFloorDiv:
+        ICHECK_NE(rhs, 0) << "Division by zero in shape computation";
+        lhs = FloorDiv(lhs, rhs);
+        break;
+      case ShapeOp::kFloorMod:
+        ICHECK_NE(rhs, 0) << "Division by zero in shape computation";
+        lhs = lhs - FloorDiv(lhs, rhs) * rhs;
+        break;
+      case ShapeOp::kMin:
+        lhs = std::min(lhs, rhs);
+        break;
+      case ShapeOp::kMax:
+        lhs = std::max(lhs, rhs);
+        break;
+      default:
+        LOG(FATAL) << "ValueError: Unknown shape operation: " << static_cast<int>(op);
+    }
+  }
+  pc_++;
+}
+
+void VirtualMachine::RunInstrMakeTuple(VMFrame* curr_frame, const Instruction& instr) {
+  std::vector<ObjectRef> fields;
+  fields.reserve(instr.num_fields);
+  for (Index i = 0; i < instr.num_fields; ++i) {
+    fields.push_back(ReadArg(curr_frame, instr.fields[i]).AsObjectRef<ObjectRef>());
+  }
+  RegType tuple;
+  tuple = ADT::Tuple(fields);
+  WriteRegister(curr_frame, instr.dst, tuple);
+  pc_++;
+}
+
+void VirtualMachine::RunInstrGetTupleItem(VMFrame* curr_frame, const Instruction& instr) {
+  ADT tuple = ReadRegister(curr_frame, instr.tuple).AsObjectRef<ADT>();
+  ICHECK(instr.item_index >= 0 && static_cast<size_t>(instr.item_index) < tuple.size())
+      << "IndexError: tuple index " << instr.item_index << " is out of range";
+  RegType item;
+  item = tuple[instr.item_index];
+  WriteRegister(curr_frame, instr.dst, item);
+  pc_++;
+}
+
+void VirtualMachine::RunInstrKill(VMFrame* curr_frame, const Instruction& instr) {
+  // Release the values so that the tensors go back to their allocators as soon as they are dead.
+  for (Index i = 0; i < instr.num_regs; ++i) {
+    curr_frame->register_file[instr.regs[i]] = RegType();
+  }
+  pc_++;
+}
+
+int64_t VirtualMachine::LoadScalarInt(RegName reg) {
   VMFrame* curr_frame = frames_.back().get();
-  const RegType& obj = ReadRegister(curr_frame, reg);
+  return ScalarToInt(ReadRegister(curr_frame, reg));
+}
+
+int64_t VirtualMachine::ScalarToInt(const RegType& obj) {
+  int64_t result = 0;
   NDArray ndarray = obj.operator tvm::runtime::NDArray();
   NDArray ndarray_host = ndarray.CopyTo(devices[0]);
 
@@ -423,14 +1725,62 @@ int64_t VirtualMachine::LoadScalarInt(RegName reg) const {
 }
 
 void VirtualMachine::RunLoop() {
+  if (dispatch_mode_ == DispatchMode::kThreaded) {
+    this->RunLoopThreaded();
+    return;
+  }
   VMFrame* curr_frame = frames_.back().get();
 
   while (true) {
-    ICHECK_LT(static_cast<size_t>(pc_), exec_->instr_offset.size()) << "run into invalide section";
-    Instruction instr = exec_->GetInstruction(pc_);
+    ICHECK_LT(static_cast<size_t>(pc_), instrs_.size()) << "run into invalide section";
+    const Instruction& instr = instrs_[pc_];
     switch (instr.op) {
       case Opcode::Call: {
-        this->RunInstrCall(curr_frame, instr);
+        if (!this->RunInstrTailCall(curr_frame, instr)) {
+          this->RunInstrCall(curr_frame, instr);
+        }
+        break;
+      }
+      case Opcode::AllocStorageTensor: {
+        this->RunInstrAllocStorageTensor(curr_frame, instr);
+        break;
+      }
+      case Opcode::LoadShapeCall: {
+        this->RunInstrLoadShapeCall(curr_frame, instr);
+        break;
+      }
+      case Opcode::LoadShape: {
+        this->RunInstrLoadShape(curr_frame, instr);
+        break;
+      }
+      case Opcode::StoreShape: {
+        this->RunInstrStoreShape(curr_frame, instr);
+        break;
+      }
+      case Opcode::ComputeShape: {
+        this->RunInstrComputeShape(curr_frame, instr);
+        break;
+      }
+      case Opcode::Move: {
+        WriteRegister(curr_frame, instr.dst, ReadRegister(curr_frame, instr.src));
+        pc_++;
+        break;
+      }
+      case Opcode::LoadConst: {
+        WriteRegister(curr_frame, instr.dst, this->constants->Get(instr.const_idx));
+        pc_++;
+        break;
+      }
+      case Opcode::MakeTuple: {
+        this->RunInstrMakeTuple(curr_frame, instr);
+        break;
+      }
+      case Opcode::GetTupleItem: {
+        this->RunInstrGetTupleItem(curr_frame, instr);
+        break;
+      }
+      case Opcode::Kill: {
+        this->RunInstrKill(curr_frame, instr);
         break;
       }
       case Opcode::Ret: {
@@ -468,13 +1818,133 @@ void VirtualMachine::RunLoop() {
   }
 }
 
+void VirtualMachine::RunLoopThreaded() {
+#if defined(__GNUC__) || defined(__clang__)
+  // Indexed by the value of Opcode, the opcodes are validated when decoded at load time.
+  static void* dispatch_table[] = {nullptr,
+                                   &&op_call,
+                                   &&op_ret,
+                                   &&op_goto,
+                                   &&op_if,
+                                   &&op_alloc_storage_tensor,
+                                   &&op_load_shape_call,
+                                   &&op_load_shape,
+                                   &&op_store_shape,
+                                   &&op_compute_shape,
+                                   &&op_move,
+                                   &&op_load_const,
+                                   &&op_make_tuple,
+                                   &&op_get_tuple_item,
+                                   &&op_kill};
+  VMFrame* curr_frame = frames_.back().get();
+  const Instruction* instrs = instrs_.data();
+
+#define TVM_RELAX_VM_DISPATCH()                                                                \
+  DCHECK_LT(static_cast<size_t>(pc_), instrs_.size()) << "run into invalide section";         \
+  goto* dispatch_table[static_cast<int>(instrs[pc_].op)]
+
+  TVM_RELAX_VM_DISPATCH();
+op_call : {
+  if (!this->RunInstrTailCall(curr_frame, instrs[pc_])) {
+    this->RunInstrCall(curr_frame, instrs[pc_]);
+  }
+  TVM_RELAX_VM_DISPATCH();
+}
+op_alloc_storage_tensor : {
+  this->RunInstrAllocStorageTensor(curr_frame, instrs[pc_]);
+  TVM_RELAX_VM_DISPATCH();
+}
+op_load_shape_call : {
+  this->RunInstrLoadShapeCall(curr_frame, instrs[pc_]);
+  TVM_RELAX_VM_DISPATCH();
+}
+op_load_shape : {
+  this->RunInstrLoadShape(curr_frame, instrs[pc_]);
+  TVM_RELAX_VM_DISPATCH();
+}
+op_store_shape : {
+  this->RunInstrStoreShape(curr_frame, instrs[pc_]);
+  TVM_RELAX_VM_DISPATCH();
+}
+op_compute_shape : {
+  this->RunInstrComputeShape(curr_frame, instrs[pc_]);
+  TVM_RELAX_VM_DISPATCH();
+}
+op_move : {
+  WriteRegister(curr_frame, instrs[pc_].dst, ReadRegister(curr_frame, instrs[pc_].src));
+  pc_++;
+  TVM_RELAX_VM_DISPATCH();
+}
+op_load_const : {
+  WriteRegister(curr_frame, instrs[pc_].dst, this->constants->Get(instrs[pc_].const_idx));
+  pc_++;
+  TVM_RELAX_VM_DISPATCH();
+}
+op_make_tuple : {
+  this->RunInstrMakeTuple(curr_frame, instrs[pc_]);
+  TVM_RELAX_VM_DISPATCH();
+}
+op_get_tuple_item : {
+  this->RunInstrGetTupleItem(curr_frame, instrs[pc_]);
+  TVM_RELAX_VM_DISPATCH();
+}
+op_kill : {
+  this->RunInstrKill(curr_frame, instrs[pc_]);
+  TVM_RELAX_VM_DISPATCH();
+}
+op_goto : {
+  pc_ += instrs[pc_].pc_offset;
+  TVM_RELAX_VM_DISPATCH();
+}
+op_if : {
+  const Instruction& instr = instrs[pc_];
+  int64_t cond_val = LoadScalarInt(instr.cond);
+  if (cond_val != 0) {
+    pc_++;
+  } else {
+    ICHECK_GT(instr.false_offset, 1);
+    pc_ += instr.false_offset;
+  }
+  TVM_RELAX_VM_DISPATCH();
+}
+op_ret : {
+  return_value_ = ReadRegister(curr_frame, instrs[pc_].result);
+  RegName caller_return_register = curr_frame->caller_return_register;
+  PopFrame();
+  if (frames_.size() != 0) {
+    // return from a local call.
+    WriteRegister(frames_.back().get(), caller_return_register, return_value_);
+  }
+  return;
+}
+#undef TVM_RELAX_VM_DISPATCH
+#else
+  // computed goto is not available, use the switch based dispatch loop.
+  dispatch_mode_ = DispatchMode::kSwitch;
+  this->RunLoop();
+#endif
+}
+
 void VirtualMachine::PushFrame(Index ret_pc, const VMFunction& vm_func) {
-  frames_.emplace_back(std::make_unique<VMFrame>(ret_pc, vm_func.register_file_size));
+  if (frame_pool_.empty()) {
+    frames_.emplace_back(std::make_unique<VMFrame>(ret_pc, vm_func.register_file_size));
+  } else {
+    // reuse a released frame together with its register file storage
+    frames_.emplace_back(std::move(frame_pool_.back()));
+    frame_pool_.pop_back();
+    frames_.back()->Reset(ret_pc, vm_func.register_file_size);
+  }
 }
 
 void VirtualMachine::PopFrame() {
   ICHECK_GT(frames_.size(), 0);
   pc_ = frames_.back()->return_pc;
+  // release the register values so that the objects are freed as in a fresh frame
+  frames_.back()->Clear();
+  if (!spilled_.empty()) {
+    PruneSpilled();
+  }
+  frame_pool_.emplace_back(std::move(frames_.back()));
   frames_.pop_back();
 }
 
@@ -482,11 +1952,41 @@ inline void VirtualMachine::WriteRegister(VMFrame* frame, Index r, const RegType
   frame->register_file[r] = val;
 }
 
-inline RegType VirtualMachine::ReadRegister(VMFrame* frame, Index r) const {
+inline RegType VirtualMachine::ReadRegister(VMFrame* frame, Index r) {
+  if (!spilled_.empty()) {
+    ReloadSpilled(frame->register_file[r]);
+  }
   return frame->register_file[r];
 }
 
-void VirtualMachine::SetInput(std::string func_name, TVMArgs args, int offset) {
+/*! \brief Whether two tensors are the same view of the same memory. */
+inline bool IsSameTensorView(const DLTensor* lhs, const DLTensor* rhs) {
+  return lhs->data == rhs->data && lhs->byte_offset == rhs->byte_offset &&
+         lhs->device.device_type == rhs->device.device_type &&
+         lhs->device.device_id == rhs->device.device_id && lhs->ndim == rhs->ndim &&
+         lhs->dtype.code == rhs->dtype.code && lhs->dtype.bits == rhs->dtype.bits &&
+         lhs->dtype.lanes == rhs->dtype.lanes &&
+         std::equal(lhs->shape, lhs->shape + lhs->ndim, rhs->shape);
+}
+
+/*!
+ * \brief Whether \p bound, the argument bound by a previous SetInput, still binds \p arg.
+ * Only a binding that borrows the memory of \p arg qualifies: a copied input has to be copied
+ * again since the caller may have updated the source buffer in the meantime.
+ */
+inline bool IsBoundTo(const RegType& bound, const TVMArgValue& arg) {
+  if (bound.type_code() != kTVMNDArrayHandle) return false;
+  NDArray bound_arr = bound.AsObjectRef<NDArray>();
+  if (arg.type_code() == kTVMDLTensorHandle) {
+    return IsSameTensorView(bound_arr.operator->(), arg.operator DLTensor*());
+  }
+  if (arg.type_code() == kTVMNDArrayHandle) {
+    return arg.AsObjectRef<NDArray>().same_as(bound_arr);
+  }
+  return false;
+}
+
+void VirtualMachine::SetInput(std::string func_name, TVMArgs args, int offset, bool borrow) {
   const auto& m = exec_->global_map;
   if (m.find(func_name) != m.end()) {
     Index gf_idx = m.at(func_name);
@@ -494,17 +1994,282 @@ void VirtualMachine::SetInput(std::string func_name, TVMArgs args, int offset) {
     size_t params_num = vm_func.num_args;
     ICHECK_EQ(args.size() - offset, params_num)
         << "The number of provided parameters doesn't match the number of arguments for";
-    std::vector<RegType> func_args(params_num);
+    auto set_arg = [&](std::vector<RegType>& func_args, int i, bool upload = false) {
+      if (borrow) {
+        BorrowInputTensorWithIndex(func_args, args[i], i - offset, devices[0]);
+      } else if (upload) {
+        UploadInputTensorWithIndex(func_args, args[i], i - offset, devices[0]);
+      } else {
+        SetInputTensorWithIndex(func_args, args[i], i - offset, devices[0]);
+      }
+    };
+    std::vector<RegType>& func_args = inputs_[func_name];
+    func_args.resize(params_num);
     for (int i = offset; i < args.size(); ++i) {
-      int index = i - offset;
-      SetInputTensorWithIndex(func_args, args[i], index, devices[0]);
+      if (IsBoundTo(func_args[i - offset], args[i])) continue;
+      set_arg(func_args, i, input_copy_stream_ != nullptr);
     }
-    inputs_.emplace(func_name, func_args);
   } else {
     LOG(FATAL) << "ValueError: Unknown function: " << func_name;
   }
 }
 
+/*!
+ * \brief Create a view of rows [begin, begin + size) of a compact tensor, without copying.
+ */
+inline NDArray SliceLeadingDim(NDArray arr, int64_t begin, int64_t size) {
+  std::vector<int64_t> shape(arr.Shape().begin(), arr.Shape().end());
+  int64_t row_bytes = static_cast<int64_t>(GetDataSize(*arr.operator->())) / shape[0];
+  shape[0] = size;
+  NDArray view = arr.CreateView(shape, arr->dtype);
+  const_cast<DLTensor*>(view.operator->())->byte_offset += begin * row_bytes;
+  return view;
+}
+
+/*!
+ * \brief Copy the slices [src_begin, src_begin + size) of src along an axis to the slices
+ *  [dst_begin, dst_begin + size) of dst, two compact tensors which only differ in that axis.
+ */
+void CopyAlongAxis(const NDArray& src, int64_t src_begin, NDArray dst, int64_t dst_begin,
+                   int64_t size, int axis) {
+  int64_t outer = 1;
+  int64_t inner_bytes = (src->dtype.bits * src->dtype.lanes + 7) / 8;
+  for (int k = 0; k < axis; ++k) outer *= src->shape[k];
+  for (int k = axis + 1; k < src->ndim; ++k) inner_bytes *= src->shape[k];
+  // each of the outer slices is a contiguous run of bytes in both tensors
+  int64_t num_bytes = size * inner_bytes;
+  for (int64_t i = 0; i < outer; ++i) {
+    DLTensor from = *src.operator->();
+    DLTensor to = *dst.operator->();
+    for (DLTensor* t : {&from, &to}) {
+      t->ndim = 1;
+      t->shape = &num_bytes;
+      t->strides = nullptr;
+      t->dtype = DLDataType{kDLUInt, 8, 1};
+    }
+    from.byte_offset += (i * src->shape[axis] + src_begin) * inner_bytes;
+    to.byte_offset += (i * dst->shape[axis] + dst_begin) * inner_bytes;
+    NDArray::CopyFromTo(&from, &to);
+  }
+}
+
+/*!
+ * \brief Split the output of a batched call into the output of a request.
+ * \param out The output, or a field of it.
+ * \param output_axes The batch axis of each tensor of the output in depth-first order, -1 for
+ *  the tensors shared by all the requests. Empty when all the tensors are batched along axis.
+ * \param axis The batch axis of the tensors when output_axes is empty.
+ * \param leaf The index of the next tensor in depth-first order, advanced by the call.
+ */
+ObjectRef SplitBatchedOutput(const ObjectRef& out, const std::vector<int64_t>& output_axes,
+                             int axis, size_t* leaf, const std::vector<int64_t>& batch_sizes,
+                             int64_t total, size_t index) {
+  if (const auto* adt = out.as<ADTObj>()) {
+    std::vector<ObjectRef> fields;
+    for (size_t i = 0; i < adt->size; ++i) {
+      fields.push_back(
+          SplitBatchedOutput((*adt)[i], output_axes, axis, leaf, batch_sizes, total, index));
+    }
+    return ADT(adt->tag, fields.begin(), fields.end());
+  }
+  const auto* nd = out.as<NDArray::ContainerType>();
+  CHECK(nd != nullptr) << "ValueError: The outputs of a batched call must be tensors or tuples "
+                       << "of them, but output " << *leaf << " is a " << out->GetTypeKey();
+  if (!output_axes.empty()) {
+    CHECK_LT(*leaf, output_axes.size())
+        << "ValueError: The batched call has more output tensors than the " << output_axes.size()
+        << " output batch axes given";
+    axis = output_axes[*leaf];
+  }
+  size_t out_index = (*leaf)++;
+  if (axis < 0) return out;
+  CHECK(axis < nd->dl_tensor.ndim && nd->dl_tensor.shape[axis] == total)
+      << "ValueError: Output " << out_index << " of the batched call is not batched along axis "
+      << axis << ", whose extent must be the total batch size " << total;
+  int64_t begin = 0;
+  for (size_t i = 0; i < index; ++i) {
+    begin += batch_sizes[i];
+  }
+  NDArray arr = Downcast<NDArray>(out);
+  if (axis == 0) {
+    return SliceLeadingDim(arr, begin, batch_sizes[index]);
+  }
+  std::vector<int64_t> shape(arr.Shape().begin(), arr.Shape().end());
+  shape[axis] = batch_sizes[index];
+  NDArray part = NDArray::Empty(shape, arr->dtype, arr->device);
+  CopyAlongAxis(arr, begin, part, 0, batch_sizes[index], axis);
+  return part;
+}
+
+RegType VirtualMachine::InvokeBatched(Index gf_idx,
+                                      const std::vector<std::vector<RegType>>& requests,
+                                      const std::vector<bool>& batched, int batch_axis,
+                                      const std::vector<int64_t>& output_axes) {
+  ICHECK(!requests.empty());
+  CHECK_GE(batch_axis, 0) << "ValueError: The batch axis must be non-negative, but got "
+                          << batch_axis;
+  size_t num_args = requests[0].size();
+  for (size_t i = 0; i < requests.size(); ++i) {
+    for (size_t j = 0; j < num_args; ++j) {
+      CHECK_EQ(requests[i][j].type_code(), kTVMNDArrayHandle)
+          << "ValueError: Batched calls only take tensor arguments, but argument " << j
+          << " of request " << i << " is a " << ArgTypeCode2Str(requests[i][j].type_code());
+    }
+  }
+  RegType ret;
+  if (requests.size() == 1) {
+    ret = ADT::Tuple(
+        std::vector<ObjectRef>{this->Invoke(gf_idx, requests[0]).AsObjectRef<ObjectRef>()});
+    return ret;
+  }
+
+  ICHECK_EQ(batched.size(), num_args);
+  auto first_batched = std::find(batched.begin(), batched.end(), true);
+  ICHECK(first_batched != batched.end())
+      << "ValueError: all the requests have the same arguments, there is nothing to batch";
+  size_t batch_arg = first_batched - batched.begin();
+
+  std::vector<int64_t> batch_sizes;
+  int64_t total = 0;
+  for (const auto& request : requests) {
+    NDArray arr = request[batch_arg].AsObjectRef<NDArray>();
+    CHECK_LT(batch_axis, arr->ndim)
+        << "ValueError: The batched argument " << batch_arg << " has no batch axis " << batch_axis;
+    batch_sizes.push_back(arr->shape[batch_axis]);
+    total += arr->shape[batch_axis];
+  }
+
+  std::vector<RegType> args(num_args);
+  for (size_t j = 0; j < num_args; ++j) {
+    if (!batched[j]) {
+      args[j] = requests[0][j];
+      continue;
+    }
+    NDArray first = requests[0][j].AsObjectRef<NDArray>();
+    CHECK_LT(batch_axis, first->ndim)
+        << "ValueError: The batched argument " << j << " has no batch axis " << batch_axis;
+    std::vector<int64_t> shape(first.Shape().begin(), first.Shape().end());
+    shape[batch_axis] = total;
+    NDArray concat = NDArray::Empty(shape, first->dtype, devices[0]);
+    int64_t begin = 0;
+    for (size_t i = 0; i < requests.size(); ++i) {
+      NDArray arr = requests[i][j].AsObjectRef<NDArray>();
+      ICHECK_EQ(arr->ndim, first->ndim);
+      CHECK_EQ(arr->shape[batch_axis], batch_sizes[i])
+          << "ValueError: the batched arguments of request " << i
+          << " have different extents along the batch axis";
+      for (int k = 0; k < arr->ndim; ++k) {
+        CHECK(k == batch_axis || arr->shape[k] == first->shape[k])
+            << "ValueError: the batched arguments can only differ in the batch axis";
+      }
+      if (batch_axis == 0) {
+        NDArray dst = SliceLeadingDim(concat, begin, batch_sizes[i]);
+        dst.CopyFrom(arr);
+      } else {
+        CopyAlongAxis(arr, 0, concat, begin, batch_sizes[i], batch_axis);
+      }
+      begin += batch_sizes[i];
+    }
+    args[j] = concat;
+  }
+
+  ObjectRef out = this->Invoke(gf_idx, args).AsObjectRef<ObjectRef>();
+  std::vector<ObjectRef> outputs;
+  for (size_t i = 0; i < requests.size(); ++i) {
+    size_t leaf = 0;
+    outputs.push_back(
+        SplitBatchedOutput(out, output_axes, batch_axis, &leaf, batch_sizes, total, i));
+    CHECK(output_axes.empty() || leaf == output_axes.size())
+        << "ValueError: The batched call has " << leaf << " output tensors, but "
+        << output_axes.size() << " output batch axes are given";
+  }
+  ret = ADT(0, outputs.begin(), outputs.end());
+  return ret;
+}
+
+/*! \brief The shape signature of the tensor inputs of a captured graph. */
+static std::string GraphInputSignature(const std::vector<RegType>& inputs) {
+  Array<ShapeTuple> shapes;
+  for (const RegType& arg : inputs) {
+    ICHECK(arg.IsObjectRef<NDArray>()) << "CUDA graph capture only supports tensor inputs";
+    shapes.push_back(arg.AsObjectRef<NDArray>().Shape());
+  }
+  return ShapeSignature(shapes);
+}
+
+void VirtualMachine::CaptureCUDAGraph(const std::string& func_name) {
+  const auto& m = exec_->global_map;
+  if (m.find(func_name) == m.end()) {
+    LOG(FATAL) << "ValueError: Unknown function: " << func_name;
+  }
+  Index gf_idx = m.at(func_name);
+  if (!inputs_.count(func_name)) {
+    LOG(FATAL) << "ValueError: No inputs set for CUDA graph capture of " << func_name
+               << "; use `set_input` first.";
+  }
+  // Vulkan records the launches into a command buffer, which is replayed like a CUDA graph.
+  bool vulkan = devices[0].device_type == kDLVulkan;
+  std::string prefix = vulkan ? "runtime.vulkan.graph." : "vm.builtin.cuda_graph.";
+  const PackedFunc* f_begin = Registry::Get(prefix + "begin_capture");
+  const PackedFunc* f_end = Registry::Get(prefix + "end_capture");
+  const PackedFunc* f_launch = Registry::Get(prefix + "launch");
+  ICHECK(f_begin != nullptr && f_end != nullptr && f_launch != nullptr)
+      << (vulkan ? "Vulkan" : "CUDA") << " graph capture requires TVM to be built with "
+      << (vulkan ? "Vulkan" : "CUDA") << " support";
+  if (input_copy_stream_ != nullptr) this->WaitForUploadedInputs();
+  std::string signature = GraphInputSignature(inputs_[func_name]);
+
+  // The graph reads from the memory of the inputs at capture time, so it owns copies of them
+  // which the replays with new inputs are copied into.
+  CapturedGraph graph;
+  for (const RegType& arg : inputs_[func_name]) {
+    NDArray src = arg.AsObjectRef<NDArray>();
+    NDArray dst = NDArray::Empty(src.Shape(), src->dtype, src->device);
+    dst.CopyFrom(src);
+    RegType input;
+    input = dst;
+    graph.inputs.push_back(input);
+  }
+
+  // warm up, so that lazy initialization and memory pool growth happen outside of the capture
+  this->Invoke(gf_idx, graph.inputs);
+
+  this->retained_storage = &graph.storage;
+  ObjectRef graph_exec = (*f_begin)(devices[0]);
+  graph.outputs = this->Invoke(gf_idx, graph.inputs);
+  (*f_end)(graph_exec);
+  this->retained_storage = nullptr;
+  graph.graph_exec = graph_exec;
+  graph.f_launch = f_launch;
+  outputs_[func_name] = graph.outputs;
+  cuda_graphs_[func_name][signature] = std::move(graph);
+}
+
+void VirtualMachine::RunCUDAGraph(const std::string& func_name) {
+  if (!inputs_.count(func_name)) {
+    LOG(FATAL) << "ValueError: No inputs set for CUDA graph replay of " << func_name
+               << "; use `set_input` first.";
+  }
+  std::vector<RegType>& func_args = inputs_[func_name];
+  auto& graphs = cuda_graphs_[func_name];
+  auto it = graphs.find(GraphInputSignature(func_args));
+  if (it == graphs.end()) {
+    // the first run with the shapes of the inputs captures a graph for them
+    this->CaptureCUDAGraph(func_name);
+    return;
+  }
+  if (input_copy_stream_ != nullptr) this->WaitForUploadedInputs();
+  CapturedGraph& graph = it->second;
+  for (size_t i = 0; i < func_args.size(); ++i) {
+    NDArray dst = graph.inputs[i].AsObjectRef<NDArray>();
+    NDArray src = func_args[i].AsObjectRef<NDArray>();
+    if (!src.same_as(dst)) dst.CopyFrom(src);
+  }
+  // the outputs saved at capture time are updated in place by the replay
+  (*graph.f_launch)(graph.graph_exec);
+  outputs_[func_name] = graph.outputs;
+}
+
 inline ObjectRef CopyTo(ObjectRef src, const DLDevice& dev) {
   if (src->IsInstance<NDArray::ContainerType>()) {
     auto nd_array = Downcast<NDArray>(src);
@@ -541,6 +2306,90 @@ void VirtualMachine::SetInputTensorWithIndex(std::vector<RegType>& func_args,
   }
 }
 
+void VirtualMachine::UploadInputTensorWithIndex(std::vector<RegType>& func_args,
+                                                const TVMArgValue& inp_tensor, int index,
+                                                Device dev) {
+  const DLTensor* src = nullptr;
+  if (inp_tensor.type_code() == kTVMDLTensorHandle) {
+    src = inp_tensor.operator DLTensor*();
+  } else if (inp_tensor.type_code() == kTVMNDArrayHandle) {
+    src = inp_tensor.AsObjectRef<NDArray>().operator->();
+  }
+  if (src == nullptr ||
+      (src->device.device_type == dev.device_type && src->device.device_id == dev.device_id)) {
+    SetInputTensorWithIndex(func_args, inp_tensor, index, dev);
+    return;
+  }
+  ICHECK(IsContiguous(*src)) << "ValueError: Cannot upload the non-contiguous input " << index;
+  // The arguments drop the previous input here, and the buffers are only reused after the
+  // stateful calls reading them ran, see WaitForUploadedInputs.
+  func_args[index] = RegType();
+  NDArray dst;
+  for (UploadBuffer& buffer : upload_buffers_) {
+    const DLTensor* arr = buffer.array.operator->();
+    if (buffer.array.use_count() == 1 && buffer.epoch + 2 <= upload_epoch_ &&
+        arr->device.device_type == dev.device_type && arr->device.device_id == dev.device_id &&
+        DataType(arr->dtype) == DataType(src->dtype) && arr->ndim == src->ndim &&
+        std::equal(arr->shape, arr->shape + arr->ndim, src->shape)) {
+      buffer.epoch = upload_epoch_;
+      dst = buffer.array;
+      break;
+    }
+  }
+  if (!dst.defined()) {
+    dst = NDArray::Empty(ShapeTuple(src->shape, src->shape + src->ndim), src->dtype, dev);
+    upload_buffers_.push_back(UploadBuffer{dst, upload_epoch_});
+  }
+  NDArray::CopyFromTo(src, const_cast<DLTensor*>(dst.operator->()), input_copy_stream_);
+  func_args[index] = dst;
+}
+
+void VirtualMachine::WaitForUploadedInputs() {
+  Device dev = devices[0];
+  DeviceAPI* api = DeviceAPI::Get(dev);
+  // The call runs on the default stream after the uploads. An upload for the call k + 1 then
+  // only waits for the calls up to k - 1, so it overlaps the call k, and may reuse the buffers
+  // of the inputs of the call k - 1.
+  api->SyncStreamFromTo(dev, input_copy_stream_, nullptr);
+  api->SyncStreamFromTo(dev, nullptr, input_copy_stream_);
+  ++upload_epoch_;
+  // the buffers of the inputs of another shape are not reused by the steady uploads
+  auto unused = [this](const UploadBuffer& buffer) {
+    return buffer.array.use_count() == 1 && buffer.epoch + 3 <= upload_epoch_;
+  };
+  upload_buffers_.erase(std::remove_if(upload_buffers_.begin(), upload_buffers_.end(), unused),
+                        upload_buffers_.end());
+}
+
+/*! \brief Whether memory on device \p src can be read directly by kernels running on \p dev. */
+inline bool IsAddressableFrom(Device src, Device dev) {
+  if (src.device_type == dev.device_type && src.device_id == dev.device_id) return true;
+  // Page-locked host memory is mapped into the address space of the GPU.
+  return (src.device_type == kDLCUDAHost && dev.device_type == kDLCUDA) ||
+         (src.device_type == kDLROCMHost && dev.device_type == kDLROCM);
+}
+
+void VirtualMachine::BorrowInputTensorWithIndex(std::vector<RegType>& func_args,
+                                                const TVMArgValue& inp_tensor, int index,
+                                                Device dev) {
+  if (inp_tensor.type_code() == kTVMDLTensorHandle) {
+    DLTensor* tensor = inp_tensor;
+    ICHECK(IsAddressableFrom(tensor->device, dev))
+        << "ValueError: Cannot borrow input " << index << " on device " << tensor->device
+        << " for a function running on " << dev;
+    func_args[index] = NDArray::FromExternalDLTensor(*tensor);
+  } else if (inp_tensor.type_code() == kTVMNDArrayHandle) {
+    NDArray arr = inp_tensor;
+    ICHECK(IsAddressableFrom(arr->device, dev))
+        << "ValueError: Cannot borrow input " << index << " on device " << arr->device
+        << " for a function running on " << dev;
+    func_args[index] = arr;
+  } else {
+    // Shapes, tuples and other non-tensor arguments have no memory to borrow.
+    func_args[index] = CopyTo(inp_tensor, dev);
+  }
+}
+
 }  // namespace relax_vm
 }  // namespace runtime
 }  // namespace tvm
@@ -241,5 +241,35 @@ TVM_REGISTER_GLOBAL("profiling.timer.rocm").set_body_typed([](Device dev) {
   return Timer(make_object<ROCMTimerNode>());
 });
 
+/*!
+ * \brief Overwrite the L2 cache of the device of the array arguments, or of the current device,
+ *  so that the next kernel reads its arguments from the device memory.
+ */
+static void ROCMFlushL2Cache(TVMArgs args) {
+  Device dev{kDLROCM, 0};
+  ROCM_CALL(hipGetDevice(&dev.device_id));
+  for (int i = 0; i < args.size(); ++i) {
+    if (args.type_codes[i] == kTVMDLTensorHandle || args.type_codes[i] == kTVMNDArrayHandle) {
+      dev = args[i].operator DLTensor*()->device;
+      break;
+    }
+  }
+  int l2_bytes = 0;
+  ROCM_CALL(hipDeviceGetAttribute(&l2_bytes, hipDeviceAttributeL2CacheSize, dev.device_id));
+  if (l2_bytes <= 0) return;
+  ROCM_CALL(hipSetDevice(dev.device_id));
+  // twice the cache, as its replacement policy is not strictly least recently used
+  size_t nbytes = 2 * static_cast<size_t>(l2_bytes);
+  // the workspace pool keeps the scratch buffer between the calls
+  WorkspacePool* pool = &ROCMThreadEntry::ThreadLocal()->pool;
+  void* scratch = pool->AllocWorkspace(dev, nbytes);
+  ROCM_CALL(hipMemsetAsync(scratch, 0, nbytes, ROCMThreadEntry::ThreadLocal()->stream));
+  pool->FreeWorkspace(dev, scratch);
+}
+
+TVM_REGISTER_GLOBAL("cache_flush_rocm_l2").set_body([](TVMArgs args, TVMRetValue* rv) {
+  ROCMFlushL2Cache(args);
+});
+
 }  // namespace runtime
 }  // namespace tvm
@@ -39,6 +39,7 @@
 #include <vector>
 
 #include "../../support/arena.h"
+#include "../../support/lz.h"
 #include "../../support/ring_buffer.h"
 #include "../object_internal.h"
 #include "rpc_local_session.h"
@@ -46,6 +47,12 @@
 namespace tvm {
 namespace runtime {
 
+/*!
+ * \brief The maximum bytes of the data of the returns of the submitted requests in flight, which
+ *  the channel buffers while the client writes the next requests.
+ */
+constexpr uint64_t kRPCMaxPendingDataBytes = 1 << 16;
+
 /*!
  * Event-driven state-machine based handlers for RPCEndpoint.
  *
@@ -666,6 +673,7 @@ void RPCEndpoint::Init() {
   // Quick function to for syscall remote.
   syscall_remote_ = PackedFunc([this](TVMArgs all_args, TVMRetValue* rv) {
     std::lock_guard<std::mutex> lock(mutex_);
+    ReceiveSubmitted(num_submitted_);
     RPCCode code = static_cast<RPCCode>(all_args[0].operator int());
     TVMArgs args(all_args.values + 1, all_args.type_codes + 1, all_args.num_args - 1);
 
@@ -710,6 +718,11 @@ RPCEndpoint::~RPCEndpoint() { this->Shutdown(); }
 
 void RPCEndpoint::Shutdown() {
   if (channel_ != nullptr) {
+    // the callbacks of the submitted requests may refer to buffers released after the shutdown
+    try {
+      ReceiveSubmitted(num_submitted_);
+    } catch (const Error& e) {
+    }
     RPCCode code = RPCCode::kShutdown;
     uint64_t packet_nbytes = sizeof(code);
 
@@ -781,12 +794,8 @@ void RPCEndpoint::InitRemoteSession(TVMArgs args) {
   ICHECK(code == RPCCode::kReturn) << "code=" << static_cast<int>(code);
 }
 
-// Get remote function with name
-void RPCEndpoint::CallFunc(RPCSession::PackedFuncHandle h, const TVMValue* arg_values,
-                           const int* arg_type_codes, int num_args,
-                           RPCSession::FEncodeReturn encode_return) {
-  std::lock_guard<std::mutex> lock(mutex_);
-
+void RPCEndpoint::SendCallFunc(RPCSession::PackedFuncHandle h, const TVMValue* arg_values,
+                               const int* arg_type_codes, int num_args) {
   handler_->ValidateArguments(arg_values, arg_type_codes, num_args);
   RPCCode code = RPCCode::kCallFunc;
   uint64_t handle = reinterpret_cast<uint64_t>(h);
@@ -799,20 +808,22 @@ void RPCEndpoint::CallFunc(RPCSession::PackedFuncHandle h, const TVMValue* arg_v
   handler_->Write(code);
   handler_->Write(handle);
   handler_->SendPackedSeq(arg_values, arg_type_codes, num_args, true);
-
-  code = HandleUntilReturnEvent(true, encode_return);
-  ICHECK(code == RPCCode::kReturn) << "code=" << RPCCodeToString(code);
 }
 
-void RPCEndpoint::CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes) {
+// Get remote function with name
+void RPCEndpoint::CallFunc(RPCSession::PackedFuncHandle h, const TVMValue* arg_values,
+                           const int* arg_type_codes, int num_args,
+                           RPCSession::FEncodeReturn encode_return) {
   std::lock_guard<std::mutex> lock(mutex_);
-  RPCCode code = RPCCode::kCopyToRemote;
+  ReceiveSubmitted(num_submitted_);
 
-  uint64_t tensor_total_size_bytes = static_cast<uint64_t>(GetDataSize(*to));
-  ICHECK_LE(to->byte_offset + nbytes, tensor_total_size_bytes)
-      << "CopyToRemote: overflow in tensor size: (byte_offset=" << to->byte_offset
-      << ", nbytes=" << nbytes << ", tensor_total_size=" << tensor_total_size_bytes << ")";
+  SendCallFunc(h, arg_values, arg_type_codes, num_args);
+  RPCCode code = HandleUntilReturnEvent(true, encode_return);
+  ICHECK(code == RPCCode::kReturn) << "code=" << RPCCodeToString(code);
+}
 
+void RPCEndpoint::SendCopyToRemote(const char* from_bytes, DLTensor* to, uint64_t nbytes) {
+  RPCCode code = RPCCode::kCopyToRemote;
   uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(to, code, nbytes);
   uint64_t packet_nbytes = overhead + nbytes;
 
@@ -820,19 +831,34 @@ void RPCEndpoint::CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes)
   handler_->Write(code);
   RPCReference::SendDLTensor(handler_, to);
   handler_->Write(nbytes);
-  handler_->WriteArray(reinterpret_cast<char*>(from_bytes), nbytes);
-  ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kReturn);
+  handler_->WriteArray(from_bytes, nbytes);
 }
 
-void RPCEndpoint::CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  RPCCode code = RPCCode::kCopyFromRemote;
+void RPCEndpoint::SendCompressedCopyToRemote(RPCSession::PackedFuncHandle fdecompress,
+                                             DLTensor* to, const std::string& payload,
+                                             uint64_t nbytes, int elem_bytes) {
+  TVMValue values[4];
+  int tcodes[4];
+  TVMByteArray bytes{payload.data(), payload.size()};
+  TVMArgsSetter setter(values, tcodes);
+  setter(0, to);
+  setter(1, bytes);
+  setter(2, static_cast<int64_t>(nbytes));
+  setter(3, elem_bytes);
 
-  uint64_t tensor_total_size_bytes = static_cast<uint64_t>(GetDataSize(*from));
-  ICHECK_LE(from->byte_offset + nbytes, tensor_total_size_bytes)
-      << "CopyFromRemote: overflow in tensor size: (byte_offset=" << from->byte_offset
-      << ", nbytes=" << nbytes << ", tensor_total_size=" << tensor_total_size_bytes << ")";
+  RPCCode code = RPCCode::kCallFunc;
+  uint64_t handle = reinterpret_cast<uint64_t>(fdecompress);
+  uint64_t packet_nbytes = sizeof(code) + sizeof(handle) +
+                           handler_->PackedSeqGetNumBytes(values, tcodes, 4, true);
 
+  handler_->Write(packet_nbytes);
+  handler_->Write(code);
+  handler_->Write(handle);
+  handler_->SendPackedSeq(values, tcodes, 4, true);
+}
+
+void RPCEndpoint::SendCopyFromRemote(DLTensor* from, uint64_t nbytes) {
+  RPCCode code = RPCCode::kCopyFromRemote;
   uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(from, code, nbytes);
   uint64_t packet_nbytes = overhead;
 
@@ -840,10 +866,236 @@ void RPCEndpoint::CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes
   handler_->Write(code);
   RPCReference::SendDLTensor(handler_, from);
   handler_->Write(nbytes);
-  ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kCopyAck);
+}
+
+void RPCEndpoint::CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes,
+                               uint64_t block_bytes, int window,
+                               RPCSession::PackedFuncHandle fdecompress) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ReceiveSubmitted(num_submitted_);
+
+  uint64_t tensor_total_size_bytes = static_cast<uint64_t>(GetDataSize(*to));
+  ICHECK_LE(to->byte_offset + nbytes, tensor_total_size_bytes)
+      << "CopyToRemote: overflow in tensor size: (byte_offset=" << to->byte_offset
+      << ", nbytes=" << nbytes << ", tensor_total_size=" << tensor_total_size_bytes << ")";
+  ICHECK_GE(window, 1) << "CopyToRemote: Invalid window " << window;
+
+  int elem_bytes = std::max((to->dtype.bits * to->dtype.lanes + 7) / 8, 1);
+  if (block_bytes == 0 || block_bytes > nbytes) block_bytes = std::max<uint64_t>(nbytes, 1);
+  // the compressed blocks are shuffled by elements, so they hold whole elements
+  if (fdecompress != nullptr && block_bytes >= static_cast<uint64_t>(elem_bytes)) {
+    block_bytes -= block_bytes % elem_bytes;
+  }
+  const char* from = static_cast<const char*>(from_bytes);
+  uint64_t base_offset = to->byte_offset;
+  std::vector<uint8_t> shuffled;
+  std::string payload;
+  int in_flight = 0;
+  for (uint64_t begin = 0; begin < nbytes; begin += block_bytes) {
+    uint64_t size = std::min(block_bytes, nbytes - begin);
+    to->byte_offset = base_offset + begin;
+    payload.clear();
+    if (fdecompress != nullptr && size % elem_bytes == 0) {
+      shuffled.resize(size);
+      support::ShuffleBytes(reinterpret_cast<const uint8_t*>(from + begin), size, elem_bytes,
+                            shuffled.data());
+      support::LZCompress(shuffled.data(), size, &payload);
+    }
+    if (!payload.empty() && payload.size() < size) {
+      SendCompressedCopyToRemote(fdecompress, to, payload, size, elem_bytes);
+    } else {
+      SendCopyToRemote(from + begin, to, size);
+    }
+    // both the copy and the call are replied by a return
+    if (++in_flight == window) {
+      ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kReturn);
+      --in_flight;
+    }
+  }
+  for (; in_flight > 0; --in_flight) {
+    ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kReturn);
+  }
+  to->byte_offset = base_offset;
+}
+
+void RPCEndpoint::CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes,
+                                 uint64_t block_bytes, int window) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ReceiveSubmitted(num_submitted_);
+
+  uint64_t tensor_total_size_bytes = static_cast<uint64_t>(GetDataSize(*from));
+  ICHECK_LE(from->byte_offset + nbytes, tensor_total_size_bytes)
+      << "CopyFromRemote: overflow in tensor size: (byte_offset=" << from->byte_offset
+      << ", nbytes=" << nbytes << ", tensor_total_size=" << tensor_total_size_bytes << ")";
+  ICHECK_GE(window, 1) << "CopyFromRemote: Invalid window " << window;
+
+  if (block_bytes == 0 || block_bytes > nbytes) block_bytes = std::max<uint64_t>(nbytes, 1);
+  char* to = static_cast<char*>(to_bytes);
+  uint64_t base_offset = from->byte_offset;
+  uint64_t requested = 0;
+  for (uint64_t begin = 0; begin < nbytes; begin += block_bytes) {
+    // keep the requests of the next blocks in flight while receiving this one
+    while (requested < nbytes && requested < begin + window * block_bytes) {
+      from->byte_offset = base_offset + requested;
+      SendCopyFromRemote(from, std::min(block_bytes, nbytes - requested));
+      requested += block_bytes;
+    }
+    ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kCopyAck);
+    handler_->ReadArray(to + begin, std::min(block_bytes, nbytes - begin));
+    handler_->FinishCopyAck();
+  }
+  from->byte_offset = base_offset;
+}
 
-  handler_->ReadArray(reinterpret_cast<char*>(to_bytes), nbytes);
-  handler_->FinishCopyAck();
+void RPCEndpoint::FlushWriter() {
+  CHECK(channel_) << "Expected connection to server " << name_
+                  << " to be active, but the connection was previously closed";
+  while (writer_.bytes_available() != 0) {
+    writer_.ReadWithCallback(
+        [this](const void* data, size_t size) { return channel_->Send(data, size); },
+        writer_.bytes_available());
+  }
+}
+
+void RPCEndpoint::PushPendingReturn(PendingReturn ret) {
+  // The server blocks on sending the data of the returns which are not received, and then
+  // stops reading the requests. Bound the data in flight by what the channel can buffer.
+  while (!pending_returns_.empty() &&
+         pending_data_bytes_ + ret.data_bytes > kRPCMaxPendingDataBytes) {
+    ReceivePendingReturn();
+  }
+  pending_data_bytes_ += ret.data_bytes;
+  pending_returns_.push_back(std::move(ret));
+}
+
+void RPCEndpoint::ReceivePendingReturn() {
+  PendingReturn ret = std::move(pending_returns_.front());
+  pending_returns_.pop_front();
+  pending_data_bytes_ -= ret.data_bytes;
+  SubmittedRequest* request = ret.request.get();
+  try {
+    ret.receive();
+  } catch (const std::exception& e) {
+    // an exception of the remote leaves the handler ready for the next return
+    if (request->error.empty()) request->error = e.what();
+  }
+  if (!ret.last) return;
+  num_completed_ = ret.ticket;
+  if (request->completed) return;
+  request->completed = true;
+  TVMValue value;
+  int tcode;
+  if (!request->error.empty()) {
+    value.v_str = request->error.c_str();
+    tcode = kTVMStr;
+    request->on_complete(RPCCode::kException, TVMArgs(&value, &tcode, 1));
+  } else {
+    value.v_handle = nullptr;
+    tcode = kTVMNullptr;
+    request->on_complete(RPCCode::kReturn, TVMArgs(&value, &tcode, 1));
+  }
+}
+
+void RPCEndpoint::ReceiveSubmitted(uint64_t ticket) {
+  while (num_completed_ < ticket && !pending_returns_.empty()) {
+    ReceivePendingReturn();
+  }
+}
+
+uint64_t RPCEndpoint::SubmitCallFunc(RPCSession::PackedFuncHandle h, const TVMValue* arg_values,
+                                     const int* arg_type_codes, int num_args,
+                                     RPCSession::FAsyncCallback on_complete) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto request = std::make_shared<SubmittedRequest>();
+  request->on_complete = std::move(on_complete);
+  uint64_t ticket = ++num_submitted_;
+  auto receive = [this, request]() {
+    RPCCode code = HandleUntilReturnEvent(true, [request](TVMArgs args) {
+      request->completed = true;
+      request->on_complete(RPCCode::kReturn, args);
+    });
+    ICHECK(code == RPCCode::kReturn) << "code=" << RPCCodeToString(code);
+  };
+  PushPendingReturn({ticket, true, 0, receive, request});
+  SendCallFunc(h, arg_values, arg_type_codes, num_args);
+  FlushWriter();
+  return ticket;
+}
+
+uint64_t RPCEndpoint::SubmitCopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes,
+                                         uint64_t block_bytes,
+                                         RPCSession::FAsyncCallback on_complete) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint64_t tensor_total_size_bytes = static_cast<uint64_t>(GetDataSize(*to));
+  ICHECK_LE(to->byte_offset + nbytes, tensor_total_size_bytes)
+      << "CopyToRemote: overflow in tensor size: (byte_offset=" << to->byte_offset
+      << ", nbytes=" << nbytes << ", tensor_total_size=" << tensor_total_size_bytes << ")";
+  auto request = std::make_shared<SubmittedRequest>();
+  request->on_complete = std::move(on_complete);
+  uint64_t ticket = ++num_submitted_;
+  if (nbytes == 0) {
+    PushPendingReturn({ticket, true, 0, []() {}, request});
+    return ticket;
+  }
+
+  if (block_bytes == 0 || block_bytes > nbytes) block_bytes = nbytes;
+  const char* from = static_cast<const char*>(from_bytes);
+  uint64_t base_offset = to->byte_offset;
+  auto receive = [this]() {
+    ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kReturn);
+  };
+  for (uint64_t begin = 0; begin < nbytes; begin += block_bytes) {
+    uint64_t size = std::min(block_bytes, nbytes - begin);
+    PushPendingReturn({ticket, begin + size == nbytes, 0, receive, request});
+    to->byte_offset = base_offset + begin;
+    SendCopyToRemote(from + begin, to, size);
+    FlushWriter();
+  }
+  to->byte_offset = base_offset;
+  return ticket;
+}
+
+uint64_t RPCEndpoint::SubmitCopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes,
+                                           uint64_t block_bytes,
+                                           RPCSession::FAsyncCallback on_complete) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint64_t tensor_total_size_bytes = static_cast<uint64_t>(GetDataSize(*from));
+  ICHECK_LE(from->byte_offset + nbytes, tensor_total_size_bytes)
+      << "CopyFromRemote: overflow in tensor size: (byte_offset=" << from->byte_offset
+      << ", nbytes=" << nbytes << ", tensor_total_size=" << tensor_total_size_bytes << ")";
+  auto request = std::make_shared<SubmittedRequest>();
+  request->on_complete = std::move(on_complete);
+  uint64_t ticket = ++num_submitted_;
+  if (nbytes == 0) {
+    PushPendingReturn({ticket, true, 0, []() {}, request});
+    return ticket;
+  }
+
+  // a block is returned at once, so that it must fit in the data in flight
+  if (block_bytes == 0 || block_bytes > kRPCMaxPendingDataBytes) {
+    block_bytes = kRPCMaxPendingDataBytes;
+  }
+  char* to = static_cast<char*>(to_bytes);
+  uint64_t base_offset = from->byte_offset;
+  for (uint64_t begin = 0; begin < nbytes; begin += block_bytes) {
+    uint64_t size = std::min(block_bytes, nbytes - begin);
+    auto receive = [this, to, begin, size]() {
+      ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kCopyAck);
+      handler_->ReadArray(to + begin, size);
+      handler_->FinishCopyAck();
+    };
+    PushPendingReturn({ticket, begin + size == nbytes, size, receive, request});
+    from->byte_offset = base_offset + begin;
+    SendCopyFromRemote(from, size);
+    FlushWriter();
+  }
+  from->byte_offset = base_offset;
+  return ticket;
+}
+
+void RPCEndpoint::WaitSubmitted(uint64_t ticket) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ReceiveSubmitted(ticket);
 }
 
 // SysCallEventHandler functions
@@ -1013,57 +1265,54 @@ class RPCClientSession : public RPCSession, public DeviceAPI {
   }
 
   void CopyToRemote(void* local_from_bytes, DLTensor* remote_to, uint64_t nbytes) final {
-    RPCCode code = RPCCode::kCopyToRemote;
-    uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(remote_to, code, nbytes);
-    uint64_t rpc_max_size = GetRPCMaxTransferSize();
-    ICHECK_GT(rpc_max_size, overhead) << "CopyToRemote: Invalid block size!";
-    const uint64_t block_size = rpc_max_size - overhead;
-    uint64_t block_count = 0;
-    const uint64_t num_blocks = nbytes / block_size;
-    void* from_bytes;
-
-    for (block_count = 0; block_count < num_blocks; block_count++) {
-      remote_to->byte_offset = block_count * block_size;
-      from_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_from_bytes) + block_count * block_size));
-      endpoint_->CopyToRemote(from_bytes, remote_to, block_size);
-    }
-
-    const uint64_t remainder_bytes = nbytes % block_size;
-    if (remainder_bytes != 0) {
-      remote_to->byte_offset = block_count * block_size;
-      from_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_from_bytes) + block_count * block_size));
-      endpoint_->CopyToRemote(from_bytes, remote_to, remainder_bytes);
+    uint64_t block_size = GetCopyBlockSize(remote_to, RPCCode::kCopyToRemote, nbytes);
+    PackedFuncHandle fdecompress = nullptr;
+    if (compress_copy_) {
+      // negotiated once, the remotes without the function get the blocks as they are
+      if (!fdecompress_queried_) {
+        fdecompress_ = GetFunction("tvm.rpc.server.CopyCompressedToRemote");
+        fdecompress_queried_ = true;
+      }
+      fdecompress = fdecompress_;
     }
+    endpoint_->CopyToRemote(local_from_bytes, remote_to, nbytes, block_size, copy_window_,
+                            fdecompress);
   }
 
   void CopyFromRemote(DLTensor* remote_from, void* local_to_bytes, uint64_t nbytes) final {
-    RPCCode code = RPCCode::kCopyFromRemote;
-    uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(remote_from, code, nbytes);
-    uint64_t rpc_max_size = GetRPCMaxTransferSize();
-    ICHECK_GT(rpc_max_size, overhead) << "CopyFromRemote: Invalid block size!";
-    const uint64_t block_size = rpc_max_size - overhead;
-    uint64_t block_count = 0;
-    const uint64_t num_blocks = nbytes / block_size;
-    void* to_bytes;
-
-    for (block_count = 0; block_count < num_blocks; block_count++) {
-      remote_from->byte_offset = block_count * block_size;
-      to_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_to_bytes) + block_count * block_size));
-      endpoint_->CopyFromRemote(remote_from, to_bytes, block_size);
-    }
+    uint64_t block_size = GetCopyBlockSize(remote_from, RPCCode::kCopyFromRemote, nbytes);
+    endpoint_->CopyFromRemote(remote_from, local_to_bytes, nbytes, block_size, copy_window_);
+  }
 
-    const uint64_t remainder_bytes = nbytes % block_size;
-    if (remainder_bytes != 0) {
-      remote_from->byte_offset = block_count * block_size;
-      to_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_to_bytes) + block_count * block_size));
-      endpoint_->CopyFromRemote(remote_from, to_bytes, remainder_bytes);
-    }
+  void SetCopyOptions(int window, uint64_t block_bytes, bool compress) final {
+    CHECK_GE(window, 1) << "ValueError: The copy window must be positive, but gets " << window;
+    copy_window_ = window;
+    copy_block_bytes_ = block_bytes;
+    compress_copy_ = compress;
+  }
+
+  uint64_t SubmitCallFunc(PackedFuncHandle func, const TVMValue* arg_values,
+                          const int* arg_type_codes, int num_args,
+                          FAsyncCallback on_complete) final {
+    return endpoint_->SubmitCallFunc(func, arg_values, arg_type_codes, num_args, on_complete);
   }
 
+  uint64_t SubmitCopyToRemote(void* local_from_bytes, DLTensor* remote_to, uint64_t nbytes,
+                              FAsyncCallback on_complete) final {
+    uint64_t block_size = GetCopyBlockSize(remote_to, RPCCode::kCopyToRemote, nbytes);
+    return endpoint_->SubmitCopyToRemote(local_from_bytes, remote_to, nbytes, block_size,
+                                         on_complete);
+  }
+
+  uint64_t SubmitCopyFromRemote(DLTensor* remote_from, void* local_to_bytes, uint64_t nbytes,
+                                FAsyncCallback on_complete) final {
+    uint64_t block_size = GetCopyBlockSize(remote_from, RPCCode::kCopyFromRemote, nbytes);
+    return endpoint_->SubmitCopyFromRemote(remote_from, local_to_bytes, nbytes, block_size,
+                                           on_complete);
+  }
+
+  void WaitSubmitted(uint64_t ticket) final { endpoint_->WaitSubmitted(ticket); }
+
   void FreeHandle(void* handle, int type_code) final {
     endpoint_->SysCallRemote(RPCCode::kFreeHandle, handle, type_code);
   }
@@ -1153,8 +1402,28 @@ class RPCClientSession : public RPCSession, public DeviceAPI {
     return (uint64_t)rpc_chunk_max_size_bytes_;
   }
 
+  /*! \brief Get the bytes of the data of each packet of a copy. */
+  uint64_t GetCopyBlockSize(DLTensor* remote_tensor, RPCCode code, uint64_t nbytes) {
+    uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(remote_tensor, code, nbytes);
+    uint64_t rpc_max_size = GetRPCMaxTransferSize();
+    ICHECK_GT(rpc_max_size, overhead) << RPCCodeToString(code) << ": Invalid block size!";
+    uint64_t block_size = rpc_max_size - overhead;
+    if (copy_block_bytes_ != 0) block_size = std::min(block_size, copy_block_bytes_);
+    return block_size;
+  }
+
   std::shared_ptr<RPCEndpoint> endpoint_;
   int64_t rpc_chunk_max_size_bytes_ = -1;
+  /*! \brief The number of blocks of a copy in flight. */
+  int copy_window_{1};
+  /*! \brief The maximum bytes of a block of a copy, 0 for the maximum transfer size. */
+  uint64_t copy_block_bytes_{0};
+  /*! \brief Whether the uploaded blocks are compressed. */
+  bool compress_copy_{false};
+  /*! \brief Whether the remote function decompressing the blocks was looked up. */
+  bool fdecompress_queried_{false};
+  /*! \brief The remote function decompressing the blocks, null if the remote lacks it. */
+  PackedFuncHandle fdecompress_{nullptr};
 };
 
 std::shared_ptr<RPCSession> CreateClientSession(std::shared_ptr<RPCEndpoint> endpoint) {
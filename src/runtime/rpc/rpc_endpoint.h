@@ -26,6 +26,8 @@
 
 #include <tvm/runtime/packed_func.h>
 
+#include <deque>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -142,26 +144,71 @@ class RPCEndpoint {
                 const int* arg_type_codes, int num_args, RPCSession::FEncodeReturn encode_return);
   /*!
    * \brief Copy bytes into remote array content.
-   * \param from The source host data.
-   * \param from_offset The byte offeset in the from.
-   * \param to The target array.
-   * \param to_offset The byte offset in the to.
+   * \param from_bytes The source host data.
+   * \param to The target array, starting at its byte_offset.
    * \param nbytes The size of the memory in bytes.
-   * \param dev_to The target device.
-   * \param type_hint Hint of content data type.
+   * \param block_bytes The maximum bytes of each packet of data, 0 for a single packet.
+   * \param window The number of packets sent before waiting for the first of them.
+   * \param fdecompress The remote function copying a compressed block into an array, null to
+   *        send the blocks as they are.
    */
-  void CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes);
+  void CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes, uint64_t block_bytes = 0,
+                    int window = 1, RPCSession::PackedFuncHandle fdecompress = nullptr);
   /*!
    * \brief Copy bytes from remote array content.
-   * \param from The source host data.
-   * \param from_offset The byte offeset in the from.
-   * \param to The target array.
-   * \param to_offset The byte offset in the to.
+   * \param from The source array, starting at its byte_offset.
+   * \param to_bytes The target host data.
    * \param nbytes The size of the memory in bytes.
-   * \param dev_from The source device.
-   * \param type_hint Hint of content data type.
+   * \param block_bytes The maximum bytes of each packet of data, 0 for a single packet.
+   * \param window The number of packets requested before receiving the first of them.
    */
-  void CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes);
+  void CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes, uint64_t block_bytes = 0,
+                      int window = 1);
+
+  /*!
+   * \brief Send a call into remote function, without waiting for its return.
+   *
+   *  The server handles the requests in order, so that their returns are received in order,
+   *  by WaitSubmitted or before the next synchronous request.
+   *
+   * \param handle The function handle
+   * \param arg_values The argument values.
+   * \param arg_type_codes the type codes of the argument.
+   * \param num_args Number of arguments.
+   * \param on_complete The callback of the return value or exception, called once the return
+   *        is received.
+   * \return The ticket of the request.
+   */
+  uint64_t SubmitCallFunc(RPCSession::PackedFuncHandle handle, const TVMValue* arg_values,
+                          const int* arg_type_codes, int num_args,
+                          RPCSession::FAsyncCallback on_complete);
+  /*!
+   * \brief Send a copy of bytes into remote array content, without waiting for its return.
+   * \param from_bytes The source host data, only read before the function returns.
+   * \param to The target array, starting at its byte_offset.
+   * \param nbytes The size of the memory in bytes.
+   * \param block_bytes The maximum bytes of each packet of data, 0 for a single packet.
+   * \param on_complete The callback called once the last block is acknowledged.
+   * \return The ticket of the request.
+   */
+  uint64_t SubmitCopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes,
+                              uint64_t block_bytes, RPCSession::FAsyncCallback on_complete);
+  /*!
+   * \brief Request a copy of bytes from remote array content, without waiting for its data.
+   * \param from The source array, starting at its byte_offset.
+   * \param to_bytes The target host data, written until on_complete is called.
+   * \param nbytes The size of the memory in bytes.
+   * \param block_bytes The maximum bytes of each packet of data, 0 for a single packet.
+   * \param on_complete The callback called once the last block is received.
+   * \return The ticket of the request.
+   */
+  uint64_t SubmitCopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes,
+                                uint64_t block_bytes, RPCSession::FAsyncCallback on_complete);
+  /*!
+   * \brief Receive the returns of the submitted requests, until the request of ticket completes.
+   * \param ticket The ticket of the request.
+   */
+  void WaitSubmitted(uint64_t ticket);
 
   /*!
    * \brief Call a remote defined system function with arguments.
@@ -189,6 +236,43 @@ class RPCEndpoint {
   // Handle events until receives a return
   // Also flushes channels so that the function advances.
   RPCCode HandleUntilReturnEvent(bool client_mode, RPCSession::FEncodeReturn setreturn);
+  // Write the packets of a block of the copies, without waiting for their replies.
+  void SendCopyToRemote(const char* from_bytes, DLTensor* to, uint64_t nbytes);
+  void SendCompressedCopyToRemote(RPCSession::PackedFuncHandle fdecompress, DLTensor* to,
+                                  const std::string& payload, uint64_t nbytes, int elem_bytes);
+  void SendCopyFromRemote(DLTensor* from, uint64_t nbytes);
+  void SendCallFunc(RPCSession::PackedFuncHandle h, const TVMValue* arg_values,
+                    const int* arg_type_codes, int num_args);
+  // Write the buffered packets to the channel.
+  void FlushWriter();
+  /*! \brief The state of a submitted request. */
+  struct SubmittedRequest {
+    /*! \brief The callback of the request. */
+    RPCSession::FAsyncCallback on_complete;
+    /*! \brief Whether the callback was called. */
+    bool completed{false};
+    /*! \brief The first error of the returns of the request. */
+    std::string error;
+  };
+  /*! \brief A return of a submitted request to receive. */
+  struct PendingReturn {
+    /*! \brief The ticket of the request. */
+    uint64_t ticket;
+    /*! \brief Whether it is the last return of the request. */
+    bool last;
+    /*! \brief The bytes of data of the return, received after it. */
+    uint64_t data_bytes;
+    /*! \brief Receive the return. */
+    std::function<void()> receive;
+    /*! \brief The request, shared by its returns. */
+    std::shared_ptr<SubmittedRequest> request;
+  };
+  // Send a return of a submitted request, receiving the earlier returns to bound their data.
+  void PushPendingReturn(PendingReturn ret);
+  // Receive the first pending return.
+  void ReceivePendingReturn();
+  // Receive the pending returns until the request of the ticket completes.
+  void ReceiveSubmitted(uint64_t ticket);
   // Initalization
   void Init();
   // Internal channel.
@@ -208,6 +292,14 @@ class RPCEndpoint {
   std::string remote_key_;
   // Invoked when the RPC session is terminated
   TypedPackedFunc<void()> fcleanup_;
+  // The returns of the submitted requests, in the order of the requests.
+  std::deque<PendingReturn> pending_returns_;
+  // The bytes of the data of the pending returns.
+  uint64_t pending_data_bytes_{0};
+  // The ticket of the last submitted request.
+  uint64_t num_submitted_{0};
+  // The ticket of the last completed request.
+  uint64_t num_completed_{0};
 };
 
 /*!
@@ -23,10 +23,15 @@
  */
 #include "rpc_local_session.h"
 
+#include <dmlc/endian.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/registry.h>
 
 #include <memory>
+#include <string>
+#include <vector>
+
+#include "../../support/lz.h"
 
 namespace tvm {
 namespace runtime {
@@ -92,36 +97,68 @@ void LocalSession::CallFunc(RPCSession::PackedFuncHandle func, const TVMValue* a
   this->EncodeReturn(std::move(rv), encode_return);
 }
 
+namespace {
+
+/*!
+ * \brief View the range of bytes of a tensor copied by an RPC transfer, and the host data, as
+ *  flat arrays of bytes. The transfers of large tensors are split in blocks of bytes.
+ */
+void MakeByteViews(const DLTensor* tensor, void* host_bytes, int64_t* nbytes,
+                   DLTensor* tensor_view, DLTensor* host_view) {
+  *tensor_view = *tensor;
+  tensor_view->ndim = 1;
+  tensor_view->shape = nbytes;
+  tensor_view->dtype = DLDataType{kDLUInt, 8, 1};
+  tensor_view->strides = nullptr;
+  *host_view = *tensor_view;
+  host_view->data = host_bytes;
+  host_view->device = {kDLCPU, 0};
+  host_view->byte_offset = 0;
+}
+
+}  // namespace
+
 void LocalSession::CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes) {
-  ICHECK_EQ(nbytes, GetDataSize(*to));
+  ICHECK_LE(nbytes, GetDataSize(*to));
+  int64_t num_bytes = static_cast<int64_t>(nbytes);
   DLTensor from;
-  from.data = from_bytes;
-  from.device = {kDLCPU, 0};
-  from.ndim = to->ndim;
-  from.shape = to->shape;
-  from.dtype = to->dtype;
-  from.strides = nullptr;
-  from.byte_offset = 0;
+  DLTensor to_view = *to;
+  if (nbytes == GetDataSize(*to)) {
+    from.data = from_bytes;
+    from.device = {kDLCPU, 0};
+    from.ndim = to->ndim;
+    from.shape = to->shape;
+    from.dtype = to->dtype;
+    from.strides = nullptr;
+    from.byte_offset = 0;
+  } else {
+    MakeByteViews(to, from_bytes, &num_bytes, &to_view, &from);
+  }
   Device dev_to = to->device;
-  this->GetDeviceAPI(dev_to)->CopyDataFromTo(&from, to, nullptr);
+  this->GetDeviceAPI(dev_to)->CopyDataFromTo(&from, &to_view, nullptr);
   // Copy can happen asynchrously
   // synchronize to make sure that copy is completed
   this->GetDeviceAPI(dev_to)->StreamSync(dev_to, nullptr);
 }
 
 void LocalSession::CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes) {
-  ICHECK_EQ(nbytes, GetDataSize(*from));
+  ICHECK_LE(nbytes, GetDataSize(*from));
+  int64_t num_bytes = static_cast<int64_t>(nbytes);
   DLTensor to;
-  to.data = to_bytes;
-  to.device = {kDLCPU, 0};
-  to.ndim = from->ndim;
-  to.shape = from->shape;
-  to.dtype = from->dtype;
-  to.strides = nullptr;
-  to.byte_offset = 0;
-
+  DLTensor from_view = *from;
+  if (nbytes == GetDataSize(*from)) {
+    to.data = to_bytes;
+    to.device = {kDLCPU, 0};
+    to.ndim = from->ndim;
+    to.shape = from->shape;
+    to.dtype = from->dtype;
+    to.strides = nullptr;
+    to.byte_offset = 0;
+  } else {
+    MakeByteViews(from, to_bytes, &num_bytes, &from_view, &to);
+  }
   Device dev_from = from->device;
-  this->GetDeviceAPI(dev_from)->CopyDataFromTo(from, &to, nullptr);
+  this->GetDeviceAPI(dev_from)->CopyDataFromTo(&from_view, &to, nullptr);
   // Copy can happen asynchrously
   // synchronize to make sure that copy is completed
   this->GetDeviceAPI(dev_from)->StreamSync(dev_from, nullptr);
@@ -142,5 +179,20 @@ TVM_REGISTER_GLOBAL("rpc.LocalSession").set_body_typed([]() {
   return CreateRPCSessionModule(std::make_shared<LocalSession>());
 });
 
+// Copy a block compressed by the client into a remote array, see RPCEndpoint::CopyToRemote.
+TVM_REGISTER_GLOBAL("tvm.rpc.server.CopyCompressedToRemote")
+    .set_body_typed([](DLTensor* to, std::string payload, int64_t nbytes, int elem_bytes) {
+      std::vector<uint8_t> shuffled(nbytes);
+      std::vector<uint8_t> data(nbytes);
+      CHECK(support::LZDecompress(reinterpret_cast<const uint8_t*>(payload.data()),
+                                  payload.size(), shuffled.data(), nbytes))
+          << "ValueError: The compressed block of " << nbytes << " bytes is malformed";
+      support::UnshuffleBytes(shuffled.data(), nbytes, elem_bytes, data.data());
+      if (!DMLC_IO_NO_ENDIAN_SWAP) {
+        dmlc::ByteSwap(data.data(), elem_bytes, nbytes / elem_bytes);
+      }
+      LocalSession().CopyToRemote(data.data(), to, nbytes);
+    });
+
 }  // namespace runtime
 }  // namespace tvm
@@ -21,15 +21,23 @@
  * \file rpc_module.cc
  * \brief RPC runtime module.
  */
+#include <dmlc/json.h>
 #include <tvm/runtime/container/string.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
 
+#include <atomic>
 #include <chrono>
 #include <cstring>
 #include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
 #include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #if defined(_M_X64) || defined(__x86_64__)
 #include <immintrin.h>
 #endif
@@ -78,6 +86,41 @@ NDArray NDArrayFromRemoteOpaqueHandle(std::shared_ptr<RPCSession> sess, void* ha
   return NDArray(GetObjectPtr<Object>(data));
 }
 
+class RPCWrappedFunc;
+
+/*!
+ * \brief The table of the PackedFuncs wrapping the remote functions, to submit their calls.
+ */
+class RPCWrappedFuncTable {
+ public:
+  static RPCWrappedFuncTable* Global() {
+    // released after the functions held by the static objects
+    static RPCWrappedFuncTable* inst = new RPCWrappedFuncTable();
+    return inst;
+  }
+
+  void Insert(const Object* func, RPCWrappedFunc* wf) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    table_[func] = wf;
+  }
+
+  void Erase(const Object* func) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    table_.erase(func);
+  }
+
+  /*! \return The wrapped function of func, nullptr if func does not wrap a remote function. */
+  RPCWrappedFunc* Find(const Object* func) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = table_.find(func);
+    return it == table_.end() ? nullptr : it->second;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<const Object*, RPCWrappedFunc*> table_;
+};
+
 /*!
  * \brief A wrapped remote function as a PackedFunc.
  */
@@ -86,6 +129,58 @@ class RPCWrappedFunc : public Object {
   RPCWrappedFunc(void* handle, std::shared_ptr<RPCSession> sess) : handle_(handle), sess_(sess) {}
 
   void operator()(TVMArgs args, TVMRetValue* rv) const {
+    auto set_return = [this, rv](TVMArgs args) { WrapRemoteReturnToValue(sess_, args, rv); };
+    PackRemoteArgs(args, [&](const TVMValue* values, const int* type_codes, int num_args) {
+      sess_->CallFunc(handle_, values, type_codes, num_args, set_return);
+    });
+  }
+
+  /*!
+   * \brief Submit a call of the function, without waiting for its return.
+   * \param args The arguments.
+   * \param on_complete The callback of the encoded return value or exception.
+   * \return The ticket of the request.
+   */
+  uint64_t Submit(TVMArgs args, RPCSession::FAsyncCallback on_complete) const {
+    uint64_t ticket = 0;
+    PackRemoteArgs(args, [&](const TVMValue* values, const int* type_codes, int num_args) {
+      ticket = sess_->SubmitCallFunc(handle_, values, type_codes, num_args, on_complete);
+    });
+    return ticket;
+  }
+
+  ~RPCWrappedFunc() {
+    RPCWrappedFuncTable::Global()->Erase(self_);
+    try {
+      sess_->FreeHandle(handle_, kTVMPackedFuncHandle);
+    } catch (const Error& e) {
+      // fault tolerance to remote close
+    }
+  }
+
+  const std::shared_ptr<RPCSession>& sess() const { return sess_; }
+
+  /*!
+   * \brief Wrap a remote function as a PackedFunc.
+   * \param handle The remote function handle.
+   * \param sess The session of the function.
+   */
+  static PackedFunc Wrap(void* handle, std::shared_ptr<RPCSession> sess) {
+    auto wf = std::make_shared<RPCWrappedFunc>(handle, sess);
+    PackedFunc func([wf](TVMArgs args, TVMRetValue* rv) { return wf->operator()(args, rv); });
+    wf->self_ = func.get();
+    RPCWrappedFuncTable::Global()->Insert(func.get(), wf.get());
+    return func;
+  }
+
+  // wrap a remote return via Set
+  static void WrapRemoteReturnToValue(const std::shared_ptr<RPCSession>& sess, TVMArgs args,
+                                      TVMRetValue* rv);
+
+ private:
+  // translate the arguments to their remote variant, and pass them to fcall.
+  template <typename FCall>
+  void PackRemoteArgs(TVMArgs args, FCall fcall) const {
     std::vector<TVMValue> values(args.values, args.values + args.size());
     std::vector<int> type_codes(args.type_codes, args.type_codes + args.size());
     std::vector<std::unique_ptr<DLTensor>> temp_dltensors;
@@ -125,28 +220,18 @@ class RPCWrappedFunc : public Object {
         }
       }
     }
-    auto set_return = [this, rv](TVMArgs args) { this->WrapRemoteReturnToValue(args, rv); };
-    sess_->CallFunc(handle_, values.data(), type_codes.data(), args.size(), set_return);
-  }
-
-  ~RPCWrappedFunc() {
-    try {
-      sess_->FreeHandle(handle_, kTVMPackedFuncHandle);
-    } catch (const Error& e) {
-      // fault tolerance to remote close
-    }
+    fcall(values.data(), type_codes.data(), args.size());
   }
 
- private:
   // remote function handle
   void* handle_{nullptr};
   // pointer to the session.
   std::shared_ptr<RPCSession> sess_;
+  // the PackedFunc wrapping the function.
+  const Object* self_{nullptr};
 
   // unwrap a remote value to the underlying handle.
   void* UnwrapRemoteValueToHandle(const TVMArgValue& arg) const;
-  // wrap a remote return via Set
-  void WrapRemoteReturnToValue(TVMArgs args, TVMRetValue* rv) const;
 
   // remove a remote session mask
   Device RemoveSessMask(Device dev) const {
@@ -217,6 +302,24 @@ class RPCModuleNode final : public ModuleNode {
     }
   }
 
+  PackedFunc GetStatisticalTimeEvaluator(const std::string& name, Device dev, int min_repeat,
+                                         int max_repeat, int min_repeat_ms,
+                                         double max_relative_error, int cooldown_interval_ms,
+                                         int repeats_to_cooldown,
+                                         const std::string& f_preproc_name) {
+    InitRemoteFunc(&remote_get_statistical_time_evaluator_,
+                   "runtime.RPCStatisticalTimeEvaluator");
+    ICHECK_EQ(GetRPCSessionIndex(dev), sess_->table_index())
+        << "ValueError: Need to pass the matched remote device to RPCModule.GetTimeEvaluator";
+    dev = RemoveRPCSessionMask(dev);
+    Optional<Module> mod;
+    if (module_handle_ != nullptr) mod = GetRef<Module>(this);
+    return remote_get_statistical_time_evaluator_(
+        mod, name, static_cast<int>(dev.device_type), dev.device_id, min_repeat, max_repeat,
+        min_repeat_ms, max_relative_error, cooldown_interval_ms, repeats_to_cooldown,
+        f_preproc_name);
+  }
+
   Module LoadModule(std::string name) {
     InitRemoteFunc(&remote_load_module_, "tvm.rpc.server.load_module");
     return remote_load_module_(name);
@@ -242,8 +345,7 @@ class RPCModuleNode final : public ModuleNode {
 
   PackedFunc WrapRemoteFunc(RPCSession::PackedFuncHandle handle) {
     if (handle == nullptr) return PackedFunc();
-    auto wf = std::make_shared<RPCWrappedFunc>(handle, sess_);
-    return PackedFunc([wf](TVMArgs args, TVMRetValue* rv) { return wf->operator()(args, rv); });
+    return RPCWrappedFunc::Wrap(handle, sess_);
   }
 
   // The module handle
@@ -254,6 +356,10 @@ class RPCModuleNode final : public ModuleNode {
   TypedPackedFunc<PackedFunc(Optional<Module>, std::string, int, int, int, int, int, int, int, int,
                              std::string)>
       remote_get_time_evaluator_;
+  // remote function to get the statistical time evaluator
+  TypedPackedFunc<PackedFunc(Optional<Module>, std::string, int, int, int, int, int, double, int,
+                             int, std::string)>
+      remote_get_statistical_time_evaluator_;
   // remote function getter for modules.
   TypedPackedFunc<PackedFunc(Module, std::string, bool)> remote_mod_get_function_;
   // remote function getter for load module
@@ -278,26 +384,26 @@ void* RPCWrappedFunc::UnwrapRemoteValueToHandle(const TVMArgValue& arg) const {
   }
 }
 
-void RPCWrappedFunc::WrapRemoteReturnToValue(TVMArgs args, TVMRetValue* rv) const {
+void RPCWrappedFunc::WrapRemoteReturnToValue(const std::shared_ptr<RPCSession>& sess,
+                                             TVMArgs args, TVMRetValue* rv) {
   int tcode = args[0];
 
   if (tcode == kTVMNullptr) return;
   if (tcode == kTVMPackedFuncHandle) {
     ICHECK_EQ(args.size(), 2);
     void* handle = args[1];
-    auto wf = std::make_shared<RPCWrappedFunc>(handle, sess_);
-    *rv = PackedFunc([wf](TVMArgs args, TVMRetValue* rv) { return wf->operator()(args, rv); });
+    *rv = RPCWrappedFunc::Wrap(handle, sess);
   } else if (tcode == kTVMModuleHandle) {
     ICHECK_EQ(args.size(), 2);
     void* handle = args[1];
-    auto n = make_object<RPCModuleNode>(handle, sess_);
+    auto n = make_object<RPCModuleNode>(handle, sess);
     *rv = Module(n);
   } else if (tcode == kTVMDLTensorHandle || tcode == kTVMNDArrayHandle) {
     ICHECK_EQ(args.size(), 3);
     DLTensor* tensor = args[1];
     void* nd_handle = args[2];
-    *rv = NDArrayFromRemoteOpaqueHandle(sess_, tensor->data, tensor,
-                                        AddRPCSessionMask(tensor->device, sess_->table_index()),
+    *rv = NDArrayFromRemoteOpaqueHandle(sess, tensor->data, tensor,
+                                        AddRPCSessionMask(tensor->device, sess->table_index()),
                                         nd_handle);
   } else {
     ICHECK_EQ(args.size(), 2);
@@ -368,6 +474,29 @@ inline void CPUCacheFlush(int begin_index, const TVMArgs& args) {
   }
 }
 
+// Get the function to time, from the local module or the global registry.
+static PackedFunc GetTimedFunction(const Optional<Module>& opt_mod, const std::string& name) {
+  if (opt_mod.defined()) {
+    PackedFunc pf = opt_mod.value().GetFunction(name, true);
+    CHECK(pf != nullptr) << "Cannot find " << name << " in the global registry";
+    return pf;
+  }
+  auto* pf = runtime::Registry::Get(name);
+  ICHECK(pf != nullptr) << "Cannot find " << name << " in the global function";
+  return *pf;
+}
+
+static PackedFunc GetPreprocFunction(const std::string& f_preproc_name) {
+  if (f_preproc_name.empty()) return PackedFunc();
+  auto* pf_preproc = runtime::Registry::Get(f_preproc_name);
+  ICHECK(pf_preproc != nullptr) << "Cannot find " << f_preproc_name << " in the global function";
+  return *pf_preproc;
+}
+
+static bool IsRPCModule(const Optional<Module>& opt_mod) {
+  return opt_mod.defined() && std::string(opt_mod.value()->type_key()) == "rpc";
+}
+
 TVM_REGISTER_GLOBAL("runtime.RPCTimeEvaluator")
     .set_body_typed([](Optional<Module> opt_mod, std::string name, int device_type, int device_id,
                        int number, int repeat, int min_repeat_ms, int limit_zero_time_iterations,
@@ -376,48 +505,146 @@ TVM_REGISTER_GLOBAL("runtime.RPCTimeEvaluator")
       Device dev;
       dev.device_type = static_cast<DLDeviceType>(device_type);
       dev.device_id = device_id;
-      if (opt_mod.defined()) {
-        Module m = opt_mod.value();
-        std::string tkey = m->type_key();
-        if (tkey == "rpc") {
-          return static_cast<RPCModuleNode*>(m.operator->())
-              ->GetTimeEvaluator(name, dev, number, repeat, min_repeat_ms,
-                                 limit_zero_time_iterations, cooldown_interval_ms,
-                                 repeats_to_cooldown, f_preproc_name);
-        } else {
-          PackedFunc f_preproc;
-          if (!f_preproc_name.empty()) {
-            auto* pf_preproc = runtime::Registry::Get(f_preproc_name);
-            ICHECK(pf_preproc != nullptr)
-                << "Cannot find " << f_preproc_name << " in the global function";
-            f_preproc = *pf_preproc;
-          }
-          PackedFunc pf = m.GetFunction(name, true);
-          CHECK(pf != nullptr) << "Cannot find " << name << " in the global registry";
-          return profiling::WrapTimeEvaluator(pf, dev, number, repeat, min_repeat_ms,
-                                              limit_zero_time_iterations, cooldown_interval_ms,
-                                              repeats_to_cooldown, f_preproc);
-        }
-      } else {
-        auto* pf = runtime::Registry::Get(name);
-        ICHECK(pf != nullptr) << "Cannot find " << name << " in the global function";
-        PackedFunc f_preproc;
-        if (!f_preproc_name.empty()) {
-          auto* pf_preproc = runtime::Registry::Get(f_preproc_name);
-          ICHECK(pf_preproc != nullptr)
-              << "Cannot find " << f_preproc_name << " in the global function";
-          f_preproc = *pf_preproc;
-        }
-        return profiling::WrapTimeEvaluator(*pf, dev, number, repeat, min_repeat_ms,
-                                            limit_zero_time_iterations, cooldown_interval_ms,
-                                            repeats_to_cooldown, f_preproc);
+      if (IsRPCModule(opt_mod)) {
+        return static_cast<RPCModuleNode*>(opt_mod.value().operator->())
+            ->GetTimeEvaluator(name, dev, number, repeat, min_repeat_ms,
+                               limit_zero_time_iterations, cooldown_interval_ms,
+                               repeats_to_cooldown, f_preproc_name);
+      }
+      return profiling::WrapTimeEvaluator(GetTimedFunction(opt_mod, name), dev, number, repeat,
+                                          min_repeat_ms, limit_zero_time_iterations,
+                                          cooldown_interval_ms, repeats_to_cooldown,
+                                          GetPreprocFunction(f_preproc_name));
+    });
+
+TVM_REGISTER_GLOBAL("runtime.RPCStatisticalTimeEvaluator")
+    .set_body_typed([](Optional<Module> opt_mod, std::string name, int device_type, int device_id,
+                       int min_repeat, int max_repeat, int min_repeat_ms,
+                       double max_relative_error, int cooldown_interval_ms,
+                       int repeats_to_cooldown, std::string f_preproc_name) {
+      Device dev;
+      dev.device_type = static_cast<DLDeviceType>(device_type);
+      dev.device_id = device_id;
+      if (IsRPCModule(opt_mod)) {
+        return static_cast<RPCModuleNode*>(opt_mod.value().operator->())
+            ->GetStatisticalTimeEvaluator(name, dev, min_repeat, max_repeat, min_repeat_ms,
+                                          max_relative_error, cooldown_interval_ms,
+                                          repeats_to_cooldown, f_preproc_name);
       }
+      return profiling::WrapStatisticalTimeEvaluator(
+          GetTimedFunction(opt_mod, name), dev, min_repeat, max_repeat, min_repeat_ms,
+          max_relative_error, cooldown_interval_ms, repeats_to_cooldown,
+          GetPreprocFunction(f_preproc_name));
     });
 
 TVM_REGISTER_GLOBAL("cache_flush_cpu_non_first_arg").set_body([](TVMArgs args, TVMRetValue* rv) {
   CPUCacheFlush(1, args);
 });
 
+/*!
+ * \brief Measure the main function of the uploaded modules back to back, so that the
+ *  measurement of a batch of candidates costs a single round trip.
+ * \param specs The JSON list of the candidates, each one as
+ *  [remote path, [["TENSOR", dtype, shape], ...]].
+ * \param f_preproc_name The function run before each repeat, e.g. to flush the caches, empty for
+ *  none.
+ * \param cache_arguments Whether to take the arguments from the argument cache of the server,
+ *  instead of allocating and filling them for each candidate.
+ * \return The JSON list of the costs in seconds of each candidate, or of its error message.
+ */
+std::string BatchMeasure(std::string specs, int device_type, int device_id, int number,
+                         int repeat, int min_repeat_ms, std::string f_preproc_name,
+                         int alloc_repeat, bool cache_arguments) {
+  Device dev{static_cast<DLDeviceType>(device_type), device_id};
+  const PackedFunc* f_load = runtime::Registry::Get("tvm.rpc.server.load_module");
+  ICHECK(f_load != nullptr) << "Cannot find tvm.rpc.server.load_module in the global function";
+  const PackedFunc* f_random_fill =
+      runtime::Registry::Get("tvm.contrib.random.random_fill_for_measure");
+  CHECK(f_random_fill != nullptr) << "ValueError: Cannot find "
+                                  << "tvm.contrib.random.random_fill_for_measure, please make "
+                                  << "sure USE_RANDOM is ON on the RPC server";
+  PackedFunc f_preproc = GetPreprocFunction(f_preproc_name);
+
+  std::istringstream is(specs);
+  dmlc::JSONReader reader(&is);
+  std::ostringstream os;
+  os.precision(17);
+  dmlc::JSONWriter writer(&os);
+  writer.BeginArray(false);
+  reader.BeginArray();
+  while (reader.NextArrayItem()) {
+    std::string path;
+    reader.BeginArray();
+    ICHECK(reader.NextArrayItem());
+    reader.Read(&path);
+    ICHECK(reader.NextArrayItem());
+    // Parse the whole spec before running, so that an error leaves the reader consistent.
+    std::vector<std::pair<DLDataType, ShapeTuple>> args_info;
+    reader.BeginArray();
+    while (reader.NextArrayItem()) {
+      std::string kind, dtype;
+      std::vector<int64_t> shape;
+      reader.BeginArray();
+      ICHECK(reader.NextArrayItem());
+      reader.Read(&kind);
+      ICHECK(reader.NextArrayItem());
+      reader.Read(&dtype);
+      ICHECK(reader.NextArrayItem());
+      reader.Read(&shape);
+      ICHECK(!reader.NextArrayItem());
+      CHECK_EQ(kind, "TENSOR") << "ValueError: Unsupported argument kind " << kind;
+      args_info.emplace_back(String2DLDataType(dtype), ShapeTuple(shape));
+    }
+    ICHECK(!reader.NextArrayItem());
+    try {
+      Module mod = (*f_load)(path);
+      PackedFunc pf = mod.GetFunction(symbol::tvm_module_main, true);
+      CHECK(pf != nullptr) << "Cannot find the main function of " << path;
+      PackedFunc evaluator =
+          profiling::WrapTimeEvaluator(pf, dev, number, repeat, min_repeat_ms,
+                                       /*limit_zero_time_iterations=*/100,
+                                       /*cooldown_interval_ms=*/0, /*repeats_to_cooldown=*/1,
+                                       f_preproc);
+      std::vector<double> costs;
+      // the number of arguments of each type and shape, the slot of the next cached one
+      std::unordered_map<std::string, int> slots;
+      for (int i = 0; i < alloc_repeat; ++i) {
+        std::vector<NDArray> args;
+        std::vector<TVMValue> values(args_info.size());
+        std::vector<int> codes(args_info.size());
+        TVMArgsSetter setter(values.data(), codes.data());
+        for (const auto& info : args_info) {
+          NDArray arr;
+          if (cache_arguments) {
+            std::ostringstream key;
+            key << info.first;
+            for (int64_t dim : info.second) key << ":" << dim;
+            arr = RPCGetCachedArgument(dev, info.first, info.second, slots[key.str()]++);
+          } else {
+            arr = NDArray::Empty(info.second, info.first, dev);
+            (*f_random_fill)(arr);
+          }
+          setter(args.size(), arr);
+          args.push_back(arr);
+        }
+        DeviceAPI::Get(dev)->StreamSync(dev, nullptr);
+        TVMRetValue rv;
+        evaluator.CallPacked(TVMArgs(values.data(), codes.data(), values.size()), &rv);
+        std::string blob = rv;
+        const double* results = reinterpret_cast<const double*>(blob.data());
+        costs.insert(costs.end(), results, results + blob.size() / sizeof(double));
+      }
+      writer.WriteArrayItem(costs);
+    } catch (const std::exception& err) {
+      writer.WriteArrayItem(std::string(err.what()));
+    }
+  }
+  writer.EndArray();
+  return os.str();
+}
+
+TVM_REGISTER_GLOBAL("tvm.rpc.server.BatchMeasure").set_body_typed(BatchMeasure);
+
 // server function registration.
 TVM_REGISTER_GLOBAL("tvm.rpc.server.ImportModule").set_body_typed([](Module parent, Module child) {
   parent->Import(child);
@@ -448,6 +675,126 @@ TVM_REGISTER_GLOBAL("rpc.SessTableIndex").set_body([](TVMArgs args, TVMRetValue*
   *rv = static_cast<RPCModuleNode*>(m.operator->())->sess()->table_index();
 });
 
+TVM_REGISTER_GLOBAL("rpc.SessSetCopyOptions")
+    .set_body_typed([](Module m, int window, int64_t block_bytes, bool compress) {
+      std::string tkey = m->type_key();
+      ICHECK_EQ(tkey, "rpc");
+      CHECK_GE(block_bytes, 0) << "ValueError: The copy block bytes must be non-negative";
+      static_cast<RPCModuleNode*>(m.operator->())
+          ->sess()
+          ->SetCopyOptions(window, static_cast<uint64_t>(block_bytes), compress);
+    });
+
+/*! \brief The state of a submitted request, set by the callback of the request. */
+struct RPCFutureState {
+  /*! \brief The session of the request. */
+  std::shared_ptr<RPCSession> sess;
+  /*! \brief The ticket of the request. */
+  uint64_t ticket{0};
+  /*! \brief Whether the request completed. */
+  std::atomic<bool> completed{false};
+  /*! \brief The error of the request, empty if it succeeded. */
+  std::string error;
+  /*! \brief The return value of the call. */
+  TVMRetValue value;
+  /*! \brief The remote array of the copy. */
+  NDArray remote_array;
+};
+
+/*!
+ * \brief Make the callback of a submitted request.
+ *
+ *  The callback runs while the session receives the returns, where releasing a remote object
+ *  would call back into the session. It only refers to the state weakly, and the return value
+ *  of a call whose future was released is dropped without being wrapped.
+ *
+ * \param state The state of the request.
+ * \param local_array The local array written by the request, kept alive until it completes.
+ * \param has_return Whether the request returns a value.
+ */
+static RPCSession::FAsyncCallback MakeFutureCallback(const std::shared_ptr<RPCFutureState>& state,
+                                                     NDArray local_array, bool has_return) {
+  std::weak_ptr<RPCFutureState> weak_state = state;
+  return [weak_state, local_array, has_return](RPCCode status, TVMArgs args) {
+    std::shared_ptr<RPCFutureState> state = weak_state.lock();
+    if (state == nullptr) return;
+    if (status == RPCCode::kException) {
+      state->error = args[0].operator std::string();
+    } else if (has_return) {
+      RPCWrappedFunc::WrapRemoteReturnToValue(state->sess, args, &state->value);
+    }
+    state->completed = true;
+  };
+}
+
+/*!
+ * \brief Make the future of a submitted request.
+ * \return The function taking whether to wait, which returns the result of the request if it
+ *  waits, and whether the request completed otherwise.
+ */
+static PackedFunc MakeFuture(std::shared_ptr<RPCFutureState> state) {
+  return PackedFunc([state](TVMArgs args, TVMRetValue* rv) {
+    bool wait = args[0];
+    if (!wait) {
+      *rv = state->completed.load();
+      return;
+    }
+    if (!state->completed) state->sess->WaitSubmitted(state->ticket);
+    ICHECK(state->completed) << "The submitted request is not completed after waiting for it";
+    if (!state->error.empty()) throw Error(state->error);
+    *rv = state->value;
+  });
+}
+
+static PackedFunc SubmitCopy(NDArray local, NDArray remote, bool to_remote) {
+  CHECK(IsRPCSessionDevice(remote->device)) << "ValueError: Expect a remote array, but gets "
+                                            << remote->device;
+  CHECK_EQ(local->device.device_type, kDLCPU) << "ValueError: Expect a local cpu array";
+  CHECK(local.IsContiguous() && remote.IsContiguous())
+      << "ValueError: Can only copy between contiguous arrays";
+  size_t nbytes = GetDataSize(*local.operator->());
+  CHECK_EQ(nbytes, GetDataSize(*remote.operator->()))
+      << "ValueError: Cannot copy between arrays of different sizes";
+  auto state = std::make_shared<RPCFutureState>();
+  state->sess = RPCSession::Get(GetRPCSessionIndex(remote->device));
+  CHECK(state->sess != nullptr) << "ValueError: The session of the remote array was closed";
+  state->remote_array = remote;
+
+  DLTensor remote_tensor = *remote.operator->();
+  remote_tensor.device = RemoveRPCSessionMask(remote->device);
+  remote_tensor.data = static_cast<RemoteSpace*>(remote->data)->data;
+  void* local_bytes = static_cast<char*>(local->data) + local->byte_offset;
+  auto on_complete = MakeFutureCallback(state, local, false);
+  if (to_remote) {
+    state->ticket =
+        state->sess->SubmitCopyToRemote(local_bytes, &remote_tensor, nbytes, on_complete);
+  } else {
+    state->ticket =
+        state->sess->SubmitCopyFromRemote(&remote_tensor, local_bytes, nbytes, on_complete);
+  }
+  return MakeFuture(state);
+}
+
+TVM_REGISTER_GLOBAL("rpc.SessSubmitCall").set_body([](TVMArgs args, TVMRetValue* rv) {
+  CHECK_GE(args.size(), 1) << "ValueError: Expect the function to submit";
+  PackedFunc func = args[0];
+  RPCWrappedFunc* wf = RPCWrappedFuncTable::Global()->Find(func.get());
+  CHECK(wf != nullptr) << "ValueError: Can only submit the calls of remote functions";
+  auto state = std::make_shared<RPCFutureState>();
+  state->sess = wf->sess();
+  state->ticket = wf->Submit(TVMArgs(args.values + 1, args.type_codes + 1, args.size() - 1),
+                             MakeFutureCallback(state, NDArray(), true));
+  *rv = MakeFuture(state);
+});
+
+TVM_REGISTER_GLOBAL("rpc.SessSubmitCopyToRemote")
+    .set_body_typed([](NDArray local, NDArray remote) { return SubmitCopy(local, remote, true); });
+
+TVM_REGISTER_GLOBAL("rpc.SessSubmitCopyFromRemote")
+    .set_body_typed([](NDArray remote, NDArray local) {
+      return SubmitCopy(local, remote, false);
+    });
+
 TVM_REGISTER_GLOBAL("tvm.rpc.NDArrayFromRemoteOpaqueHandle")
     .set_body_typed([](Module mod, void* remote_array, DLTensor* template_tensor, Device dev,
                        void* ndarray_handle) -> NDArray {
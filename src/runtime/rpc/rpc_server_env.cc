@@ -21,9 +21,17 @@
  * \file rpc_server_env.cc
  * \brief Server environment of the RPC.
  */
+#include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/registry.h>
 
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "../file_utils.h"
+#include "rpc_session.h"
 
 namespace tvm {
 namespace runtime {
@@ -57,5 +65,82 @@ TVM_REGISTER_GLOBAL("tvm.rpc.server.remove").set_body([](TVMArgs args, TVMRetVal
   RemoveFile(file_name);
 });
 
+/*!
+ * \brief The randomly filled arguments of the measurements. The server process keeps them
+ *  alive, so that the candidates of the same shapes reuse them instead of allocating and
+ *  filling their arguments again.
+ */
+class RPCArgumentCache {
+ public:
+  static RPCArgumentCache* Global() {
+    static RPCArgumentCache* inst = new RPCArgumentCache();
+    return inst;
+  }
+
+  NDArray Get(Device dev, DLDataType dtype, ShapeTuple shape, int slot) {
+    std::ostringstream os;
+    os << dev.device_type << ":" << dev.device_id << ":" << DLDataType2String(dtype) << ":"
+       << slot;
+    for (int64_t dim : shape) os << ":" << dim;
+    std::string key = os.str();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = arrays_.find(key);
+    if (it != arrays_.end()) return it->second;
+    const PackedFunc* f_random_fill =
+        runtime::Registry::Get("tvm.contrib.random.random_fill_for_measure");
+    CHECK(f_random_fill != nullptr) << "ValueError: Cannot find "
+                                    << "tvm.contrib.random.random_fill_for_measure, please make "
+                                    << "sure USE_RANDOM is ON on the RPC server";
+    NDArray arr = NDArray::Empty(shape, dtype, dev);
+    (*f_random_fill)(arr);
+    nbytes_ += GetDataSize(*arr.operator->());
+    arrays_.emplace(key, arr);
+    return arr;
+  }
+
+  int64_t Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t nbytes = nbytes_;
+    arrays_.clear();
+    nbytes_ = 0;
+    return nbytes;
+  }
+
+  int64_t nbytes() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return nbytes_;
+  }
+
+ private:
+  std::mutex mutex_;
+  /*! \brief The arrays by their device, type, slot and shape. */
+  std::unordered_map<std::string, NDArray> arrays_;
+  /*! \brief The bytes of the arrays. */
+  int64_t nbytes_{0};
+};
+
+NDArray RPCGetCachedArgument(Device dev, DLDataType dtype, ShapeTuple shape, int slot) {
+  return RPCArgumentCache::Global()->Get(dev, dtype, shape, slot);
+}
+
+// The shape is passed as the trailing arguments, as the RPC does not transfer objects.
+TVM_REGISTER_GLOBAL("tvm.rpc.server.GetCachedArgument")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      Device dev = args[0];
+      DLDataType dtype = String2DLDataType(args[1].operator std::string());
+      int slot = args[2];
+      std::vector<int64_t> shape;
+      for (int i = 3; i < args.size(); ++i) shape.push_back(args[i].operator int64_t());
+      *rv = RPCGetCachedArgument(dev, dtype, ShapeTuple(shape), slot);
+    });
+
+TVM_REGISTER_GLOBAL("tvm.rpc.server.ArgumentCacheBytes").set_body_typed([]() {
+  return RPCArgumentCache::Global()->nbytes();
+});
+
+TVM_REGISTER_GLOBAL("tvm.rpc.server.ClearArgumentCache").set_body_typed([]() {
+  return RPCArgumentCache::Global()->Clear();
+});
+
 }  // namespace runtime
 }  // namespace tvm
@@ -176,6 +176,63 @@ class RPCSession {
    */
   virtual bool IsLocalSession() const = 0;
 
+  /*!
+   * \brief Configure the bulk transfers of CopyToRemote and CopyFromRemote.
+   *
+   * The tensors are transferred by blocks. Keeping several blocks in flight hides the round
+   * trip of each block on high latency links.
+   *
+   * \param window The number of blocks in flight, 1 to wait for each block.
+   * \param block_bytes The maximum bytes of a block, 0 for the maximum transfer size.
+   * \param compress Whether to compress the uploaded blocks, when the remote supports it.
+   * \note Only the sessions transferring through a channel are configured, the others ignore it.
+   */
+  virtual void SetCopyOptions(int window, uint64_t block_bytes, bool compress) {}
+  // Pipelined variant of API
+  // The requests are sent without waiting for their returns, which the session receives in
+  // order when waiting for a ticket, or before its next synchronous request.
+  //
+  // The sessions without a channel complete the requests before returning, with the ticket 0.
+  /*!
+   * \brief Submit a call of func.
+   * \param func The function handle.
+   * \param arg_values The argument values.
+   * \param arg_type_codes the type codes of the argument.
+   * \param num_args Number of arguments.
+   * \param on_complete The callback to pass the return value or exception.
+   * \return The ticket of the request.
+   * \note The arguments only need to stay alive until the function returns.
+   */
+  virtual uint64_t SubmitCallFunc(PackedFuncHandle func, const TVMValue* arg_values,
+                                  const int* arg_type_codes, int num_args,
+                                  FAsyncCallback on_complete);
+  /*!
+   * \brief Submit a CopyToRemote.
+   * \param local_from_bytes The source host data.
+   * \param remote_to The target array.
+   * \param nbytes The size of the memory in bytes.
+   * \param on_complete The callback to signal copy complete.
+   * \return The ticket of the request.
+   */
+  virtual uint64_t SubmitCopyToRemote(void* local_from_bytes, DLTensor* remote_to,
+                                      uint64_t nbytes, FAsyncCallback on_complete);
+  /*!
+   * \brief Submit a CopyFromRemote.
+   * \param remote_from The source array.
+   * \param local_to_bytes The target host data.
+   * \param nbytes The size of the memory in bytes.
+   * \param on_complete The callback to signal copy complete.
+   * \return The ticket of the request.
+   * \note local_to_bytes must stay alive until on_complete is called.
+   */
+  virtual uint64_t SubmitCopyFromRemote(DLTensor* remote_from, void* local_to_bytes,
+                                        uint64_t nbytes, FAsyncCallback on_complete);
+  /*!
+   * \brief Receive the returns of the submitted requests, until the request of ticket completes.
+   * \param ticket The ticket of the request.
+   */
+  virtual void WaitSubmitted(uint64_t ticket) {}
+
   // Asynchrous variant of API
   // These APIs are used by the RPC server to allow sessions that
   // have special implementations for the async functions.
@@ -301,6 +358,18 @@ Module CreateRPCSessionModule(std::shared_ptr<RPCSession> sess);
  */
 std::shared_ptr<RPCSession> RPCModuleGetSession(Module mod);
 
+/*!
+ * \brief Get a randomly filled array of the argument cache of the server, which keeps the
+ *  arguments of the measurements alive across the candidates of the same shapes.
+ * \param dev The device of the array.
+ * \param dtype The data type of the array.
+ * \param shape The shape of the array.
+ * \param slot The index of the array among the arrays of the same device, type and shape,
+ *  so that the distinct arguments of a call do not alias.
+ * \return The cached array, allocated and filled on its first use.
+ */
+NDArray RPCGetCachedArgument(Device dev, DLDataType dtype, ShapeTuple shape, int slot);
+
 }  // namespace runtime
 }  // namespace tvm
 #endif  // TVM_RUNTIME_RPC_RPC_SESSION_H_
@@ -0,0 +1,278 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file rpc_shm_impl.cc
+ * \brief Shared memory RPC channel, between a client and a server process on the same host.
+ *
+ *  The client maps a memfd holding two single producer single consumer rings, one per
+ *  direction, and passes it to the server process it spawns. The bytes of the messages, the
+ *  arrays included, are copied into the rings instead of going through the socket calls, and
+ *  the waiting side sleeps on a futex of its ring.
+ */
+// Linux only, as the memfd and the futex are linux specific.
+#if defined(__linux__) || defined(__ANDROID__)
+
+#include <errno.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <tvm/runtime/registry.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rpc_endpoint.h"
+#include "rpc_local_session.h"
+
+namespace tvm {
+namespace runtime {
+
+/*! \brief The magic number of the shared memory region. */
+constexpr uint64_t kRPCSharedMemoryMagic = 0x54564D53484D5250;  // "TVMSHMRP"
+/*! \brief The number of polls of a ring before sleeping on its futex. */
+constexpr int kRPCSharedMemorySpins = 1 << 12;
+
+/*! \brief A ring of bytes in the shared memory, its data follows the header of the region. */
+struct alignas(64) SharedMemoryRing {
+  /*! \brief The bytes written by the producer. */
+  std::atomic<uint64_t> head{0};
+  /*! \brief The bytes read by the consumer. */
+  alignas(64) std::atomic<uint64_t> tail{0};
+  /*! \brief Whether the producer closed the ring. */
+  std::atomic<uint32_t> closed{0};
+  /*! \brief The futex word, bumped on each move of the head or the tail. */
+  std::atomic<uint32_t> seq{0};
+};
+
+/*! \brief The header of the shared memory region. */
+struct SharedMemoryHeader {
+  uint64_t magic;
+  /*! \brief The bytes of the data of each ring. */
+  uint64_t capacity;
+  /*! \brief The ring from the client to the server, and the ring back. */
+  SharedMemoryRing rings[2];
+};
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(int), "futex word must be an int");
+
+class SharedMemoryChannel final : public RPCChannel {
+ public:
+  /*!
+   * \param base The mapped region.
+   * \param region_bytes The bytes of the region.
+   * \param is_client Whether it is the channel of the client, which sends on the first ring.
+   * \param peer_pid The server process of the client, or -1 for the server.
+   */
+  SharedMemoryChannel(void* base, size_t region_bytes, bool is_client, pid_t peer_pid)
+      : base_(base), region_bytes_(region_bytes), peer_pid_(peer_pid) {
+    header_ = static_cast<SharedMemoryHeader*>(base);
+    char* data = static_cast<char*>(base) + sizeof(SharedMemoryHeader);
+    int send = is_client ? 0 : 1;
+    send_ = &header_->rings[send];
+    recv_ = &header_->rings[1 - send];
+    send_data_ = data + send * header_->capacity;
+    recv_data_ = data + (1 - send) * header_->capacity;
+  }
+
+  ~SharedMemoryChannel() {
+    send_->closed.store(1, std::memory_order_release);
+    Notify(send_);
+    munmap(base_, region_bytes_);
+    if (peer_pid_ > 0) {
+      // let the server clean up its work dir on the close, before killing it
+      for (int i = 0; i < 100 && PeerAlive(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+      if (!peer_exited_) {
+        kill(peer_pid_, SIGKILL);
+        waitpid(peer_pid_, nullptr, 0);
+      }
+    }
+  }
+
+  size_t Send(const void* data, size_t size) final {
+    const uint64_t capacity = header_->capacity;
+    uint64_t head = send_->head.load(std::memory_order_relaxed);
+    bool has_room = Wait(send_, [&]() {
+      return head - send_->tail.load(std::memory_order_acquire) < capacity;
+    });
+    if (!has_room) {
+      LOG(FATAL) << "The RPC server process exited";
+    }
+    uint64_t tail = send_->tail.load(std::memory_order_acquire);
+    size_t n = std::min<uint64_t>(size, capacity - (head - tail));
+    size_t offset = head % capacity;
+    size_t first = std::min<size_t>(n, capacity - offset);
+    std::memcpy(send_data_ + offset, data, first);
+    std::memcpy(send_data_, static_cast<const char*>(data) + first, n - first);
+    send_->head.store(head + n, std::memory_order_release);
+    Notify(send_);
+    return n;
+  }
+
+  size_t Recv(void* data, size_t size) final {
+    const uint64_t capacity = header_->capacity;
+    uint64_t tail = recv_->tail.load(std::memory_order_relaxed);
+    bool has_data = Wait(recv_, [&]() {
+      return recv_->head.load(std::memory_order_acquire) != tail ||
+             recv_->closed.load(std::memory_order_acquire);
+    });
+    uint64_t head = recv_->head.load(std::memory_order_acquire);
+    // the peer closed the channel or exited, after its last bytes are read
+    if (!has_data || head == tail) return 0;
+    size_t n = std::min<uint64_t>(size, head - tail);
+    size_t offset = tail % capacity;
+    size_t first = std::min<size_t>(n, capacity - offset);
+    std::memcpy(data, recv_data_ + offset, first);
+    std::memcpy(static_cast<char*>(data) + first, recv_data_, n - first);
+    recv_->tail.store(tail + n, std::memory_order_release);
+    Notify(recv_);
+    return n;
+  }
+
+ private:
+  /*!
+   * \brief Wait until the condition holds, polling the ring before sleeping on its futex.
+   * \return Whether the condition holds, false if the peer exited before.
+   */
+  template <typename FCond>
+  bool Wait(SharedMemoryRing* ring, FCond cond) {
+    for (int i = 0; i < kRPCSharedMemorySpins; ++i) {
+      if (cond()) return true;
+    }
+    while (true) {
+      uint32_t seq = ring->seq.load(std::memory_order_acquire);
+      if (cond()) return true;
+      if (!PeerAlive()) return cond();
+      // wake up periodically to check that the peer is alive
+      timespec timeout{0, 10 * 1000 * 1000};
+      syscall(SYS_futex, reinterpret_cast<int*>(&ring->seq), FUTEX_WAIT, seq, &timeout, nullptr,
+              0);
+    }
+  }
+
+  void Notify(SharedMemoryRing* ring) {
+    ring->seq.fetch_add(1, std::memory_order_release);
+    syscall(SYS_futex, reinterpret_cast<int*>(&ring->seq), FUTEX_WAKE, INT_MAX, nullptr,
+            nullptr, 0);
+  }
+
+  bool PeerAlive() {
+    // the server is killed with its client, see CreateSharedMemoryClient
+    if (peer_pid_ <= 0) return true;
+    // reaps the exited server, which must not be killed after
+    peer_exited_ = peer_exited_ || waitpid(peer_pid_, nullptr, WNOHANG) != 0;
+    return !peer_exited_;
+  }
+
+  void* base_;
+  size_t region_bytes_;
+  pid_t peer_pid_;
+  bool peer_exited_{false};
+  SharedMemoryHeader* header_;
+  SharedMemoryRing* send_;
+  SharedMemoryRing* recv_;
+  char* send_data_;
+  char* recv_data_;
+};
+
+Module CreateSharedMemoryClient(uint64_t ring_bytes, std::vector<std::string> cmd) {
+  CHECK_GT(ring_bytes, 0) << "ValueError: The bytes of the rings must be positive";
+  size_t region_bytes = sizeof(SharedMemoryHeader) + 2 * ring_bytes;
+  int fd = static_cast<int>(syscall(SYS_memfd_create, "tvm_rpc", 0));
+  CHECK_GE(fd, 0) << "Cannot create the shared memory of the RPC: " << strerror(errno);
+  CHECK_EQ(ftruncate(fd, region_bytes), 0)
+      << "Cannot allocate the shared memory of the RPC: " << strerror(errno);
+  void* base = mmap(nullptr, region_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  CHECK(base != MAP_FAILED) << "Cannot map the shared memory of the RPC: " << strerror(errno);
+  auto* header = new (base) SharedMemoryHeader();
+  header->magic = kRPCSharedMemoryMagic;
+  header->capacity = ring_bytes;
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    // child process, killed with its parent
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+    std::string sfd = std::to_string(fd);
+    std::vector<char*> argv;
+    for (auto& str : cmd) {
+      argv.push_back(dmlc::BeginPtr(str));
+    }
+    argv.push_back(dmlc::BeginPtr(sfd));
+    argv.push_back(nullptr);
+    execvp(argv[0], &argv[0]);
+    _exit(127);
+  }
+  // parent process
+  close(fd);
+  CHECK_GT(pid, 0) << "Cannot fork the RPC server: " << strerror(errno);
+
+  auto endpt = RPCEndpoint::Create(
+      std::make_unique<SharedMemoryChannel>(base, region_bytes, true, pid), "shm", "shm");
+  endpt->InitRemoteSession(TVMArgs(nullptr, nullptr, 0));
+  return CreateRPCSessionModule(CreateClientSession(endpt));
+}
+
+void SharedMemoryServerLoop(int fd) {
+  struct stat st;
+  CHECK_EQ(fstat(fd, &st), 0) << "Cannot stat the shared memory of the RPC: " << strerror(errno);
+  size_t region_bytes = static_cast<size_t>(st.st_size);
+  CHECK_GE(region_bytes, sizeof(SharedMemoryHeader)) << "Invalid shared memory of the RPC";
+  void* base = mmap(nullptr, region_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  CHECK(base != MAP_FAILED) << "Cannot map the shared memory of the RPC: " << strerror(errno);
+  close(fd);
+  const auto* header = static_cast<const SharedMemoryHeader*>(base);
+  CHECK(header->magic == kRPCSharedMemoryMagic &&
+        sizeof(SharedMemoryHeader) + 2 * header->capacity == region_bytes)
+      << "Invalid shared memory of the RPC";
+  RPCEndpoint::Create(std::make_unique<SharedMemoryChannel>(base, region_bytes, false, -1),
+                      "SharedMemoryServerLoop", "")
+      ->ServerLoop();
+}
+
+TVM_REGISTER_GLOBAL("rpc.CreateSharedMemoryClient").set_body([](TVMArgs args, TVMRetValue* rv) {
+  uint64_t ring_bytes = args[0].operator int64_t();
+  std::vector<std::string> cmd;
+  for (int i = 1; i < args.size(); ++i) {
+    cmd.push_back(args[i].operator std::string());
+  }
+  *rv = CreateSharedMemoryClient(ring_bytes, cmd);
+});
+
+TVM_REGISTER_GLOBAL("rpc.SharedMemoryServerLoop").set_body_typed(SharedMemoryServerLoop);
+
+}  // namespace runtime
+}  // namespace tvm
+#endif
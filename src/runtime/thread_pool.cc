@@ -25,6 +25,7 @@
 #include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/c_runtime_api.h>
 #include <tvm/runtime/container/array.h>
+#include <tvm/runtime/container/shape_tuple.h>
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
@@ -41,9 +42,11 @@
 #include <sstream>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "../support/utils.h"
+#include "trace.h"
 const constexpr int kL1CacheBytes = 64;
 
 namespace tvm {
@@ -128,8 +131,10 @@ class ParallelLauncher {
   // Local env
   TVMParallelGroupEnv env;
   // Whether this thread is worker of the pool.
-  // used to prevent recursive launch.
+  // used to run the nested launch inline.
   bool is_worker{false};
+  // Whether this thread is running the task 0 of a launch of its own.
+  bool in_launch{false};
 
  private:
   // The pending jobs.
@@ -267,6 +272,18 @@ class ThreadPool {
     Init();
   }
 
+  /*!
+   * \brief Create a pool shared by the threads attached to it, with a worker on each CPU. The
+   *  launching threads only wait, so that the tasks only run on the CPUs of the pool.
+   * \param cpus The CPUs of the workers.
+   */
+  explicit ThreadPool(const std::vector<unsigned int>& cpus)
+      : num_workers_(cpus.size()), exclude_worker0_(false), shared_(true) {
+    Init();
+    num_workers_used_ =
+        threads_->Configure(threading::ThreadGroup::kSpecifyOneCorePerThread, 0, false, cpus);
+  }
+
   ~ThreadPool() {
     for (std::unique_ptr<SpscTaskQueue>& q : queues_) {
       q->SignalForKill();
@@ -286,8 +303,14 @@ class ThreadPool {
 
   int Launch(FTVMParallelLambda flambda, void* cdata, int num_task, int need_sync) {
     ParallelLauncher* launcher = ParallelLauncher::ThreadLocal();
-    ICHECK(!launcher->is_worker)
-        << "Cannot launch parallel job inside worker, consider fuse then parallel";
+    // The nested launch runs inline as a single task, rather than oversubscribing the cores
+    // whose workers are all taken by the enclosing launch.
+    if (launcher->is_worker || launcher->in_launch) {
+      return RunInline(flambda, cdata);
+    }
+    // The queues of the workers take a single producer at a time.
+    std::unique_lock<std::mutex> lock(launch_mutex_, std::defer_lock);
+    if (shared_) lock.lock();
     if (num_task == 0) {
       num_task = num_workers_used_;
     }
@@ -307,11 +330,13 @@ class ThreadPool {
     // use the main thread to run task 0
     if (exclude_worker0_) {
       TVMParallelGroupEnv* penv = &(tsk.launcher->env);
+      launcher->in_launch = true;
       if ((*tsk.launcher->flambda)(0, penv, cdata) == 0) {
         tsk.launcher->SignalJobFinish();
       } else {
         tsk.launcher->SignalJobError(tsk.task_id);
       }
+      launcher->in_launch = false;
     }
     int res = launcher->WaitForJobs();
     return res;
@@ -319,6 +344,29 @@ class ThreadPool {
 
   static ThreadPool* ThreadLocal() { return dmlc::ThreadLocalStore<ThreadPool>::Get(); }
 
+  /*! \return The named pool attached to the calling thread, nullptr if none. */
+  static ThreadPool* Attached() { return AttachedPool()->get(); }
+
+  /*! \return The storage of the named pool attached to the calling thread. */
+  static std::shared_ptr<ThreadPool>* AttachedPool() {
+    static thread_local std::shared_ptr<ThreadPool> pool;
+    return &pool;
+  }
+
+  /*!
+   * \brief Run the job as a single task on the calling thread.
+   * \param flambda The parallel function to be launched.
+   * \param cdata The closure data.
+   * \return 0 when no error is thrown, -1 when failure happens.
+   */
+  static int RunInline(FTVMParallelLambda flambda, void* cdata) {
+    std::atomic<int32_t> sync_counter{0};
+    TVMParallelGroupEnv env;
+    env.num_task = 1;
+    env.sync_handle = &sync_counter;
+    return (*flambda)(0, &env, cdata) == 0 ? 0 : -1;
+  }
+
   void UpdateWorkerConfiguration(threading::ThreadGroup::AffinityMode mode, int nthreads,
                                  const std::vector<unsigned int>& cpus) {
     // this will also reset the affinity of the ThreadGroup
@@ -369,6 +417,10 @@ class ThreadPool {
   int num_workers_used_;
   // if or not to exclude worker 0 and use main to run task 0
   bool exclude_worker0_{true};
+  // whether the pool is named and shared by the threads attached to it
+  bool shared_{false};
+  // serializes the launches of the threads sharing the pool
+  std::mutex launch_mutex_;
   std::vector<std::unique_ptr<SpscTaskQueue>> queues_;
   std::unique_ptr<tvm::runtime::threading::ThreadGroup> threads_;
 };
@@ -396,6 +448,87 @@ TVM_REGISTER_GLOBAL("runtime.NumThreads").set_body_typed([]() -> int32_t {
   return threading::NumThreads();
 });
 
+/*! \brief The named thread pools, and the name of the pool attached to each thread. */
+class ThreadPoolRegistry {
+ public:
+  static ThreadPoolRegistry* Global() {
+    // NOTE: explicitly use new to avoid exit-time destruction of the workers
+    static ThreadPoolRegistry* inst = new ThreadPoolRegistry();
+    return inst;
+  }
+
+  void Create(const std::string& name, const std::vector<unsigned int>& cpus) {
+    CHECK(!name.empty()) << "ValueError: The name of a thread pool cannot be empty";
+    CHECK(!cpus.empty()) << "ValueError: The thread pool " << name << " has no CPU";
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK(!pools_.count(name)) << "ValueError: The thread pool " << name << " already exists";
+    pools_[name] = std::make_shared<ThreadPool>(cpus);
+  }
+
+  void Destroy(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK(pools_.erase(name)) << "ValueError: Unknown thread pool " << name;
+  }
+
+  std::string Attach(const std::string& name) {
+    std::shared_ptr<ThreadPool> pool;
+    if (!name.empty()) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = pools_.find(name);
+      CHECK(it != pools_.end()) << "ValueError: Unknown thread pool " << name;
+      pool = it->second;
+    }
+    // The attached thread holds the pool, which outlives its destruction until detached.
+    *ThreadPool::AttachedPool() = std::move(pool);
+    std::string prev = std::move(attached_name_);
+    attached_name_ = name;
+    return prev;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<ThreadPool>> pools_;
+  static thread_local std::string attached_name_;
+};
+
+thread_local std::string ThreadPoolRegistry::attached_name_;
+
+TVM_REGISTER_GLOBAL("runtime.CreateThreadPool").set_body_typed([](String name, ShapeTuple cpus) {
+  threading::CreateThreadPool(name, std::vector<unsigned int>(cpus.begin(), cpus.end()));
+});
+
+TVM_REGISTER_GLOBAL("runtime.DestroyThreadPool").set_body_typed([](String name) {
+  threading::DestroyThreadPool(name);
+});
+
+TVM_REGISTER_GLOBAL("runtime.AttachThreadPool").set_body_typed([](String name) {
+  return String(threading::AttachThreadPool(name));
+});
+
+TVM_REGISTER_GLOBAL("runtime.NumaNodeCpus").set_body_typed([]() {
+  Array<ShapeTuple> nodes;
+  for (const std::vector<unsigned int>& cpus : threading::NumaNodeCpus()) {
+    nodes.push_back(ShapeTuple(cpus.begin(), cpus.end()));
+  }
+  return nodes;
+});
+
+/*!
+ * \brief Restrict the thread pool of the calling thread to the CPUs of a NUMA node, and place the
+ *  CPU memory it allocates on the node. args[0] is the node, args[1] the number of threads.
+ */
+TVM_REGISTER_GLOBAL("runtime.config_threadpool_numa_node").set_body_typed([](int node,
+                                                                             int nthreads) {
+  std::vector<std::vector<unsigned int>> nodes = threading::NumaNodeCpus();
+  CHECK(node >= 0 && node < static_cast<int>(nodes.size()))
+      << "ValueError: The NUMA node " << node << " is out of the " << nodes.size()
+      << " nodes of the system";
+  CHECK(!nodes[node].empty()) << "ValueError: The NUMA node " << node << " has no CPU";
+  threading::Configure(threading::ThreadGroup::kSpecifyThreadShareAllCore, nthreads,
+                       nodes[node]);
+  threading::SetPreferredNumaNode(nodes.size() > 1 ? node : -1);
+});
+
 namespace threading {
 
 #if TVM_THREADPOOL_USE_OPENMP
@@ -467,19 +600,39 @@ TVM_DLL void Configure(tvm::runtime::threading::ThreadGroup::AffinityMode mode,
 #endif
 }
 int32_t NumThreads() { return tvm::runtime::ThreadPool::ThreadLocal()->NumThreads(); }
+
+void CreateThreadPool(const std::string& name, const std::vector<unsigned int>& cpus) {
+  ThreadPoolRegistry::Global()->Create(name, cpus);
+}
+
+void DestroyThreadPool(const std::string& name) { ThreadPoolRegistry::Global()->Destroy(name); }
+
+std::string AttachThreadPool(const std::string& name) {
+  return ThreadPoolRegistry::Global()->Attach(name);
+}
+
+/*! \brief The parallel launch of the device runtime, nullptr for the thread pool. */
+std::atomic<DeviceParallelLauncher> device_parallel_launcher{nullptr};
+
+void SetDeviceParallelLauncher(DeviceParallelLauncher launcher) {
+  device_parallel_launcher.store(launcher, std::memory_order_release);
+}
 }  // namespace threading
 }  // namespace runtime
 }  // namespace tvm
 
 int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task) {
+  TVM_TRACE_SCOPE("parallel", "TVMBackendParallelLaunch");
+  if (tvm::runtime::ThreadPool* pool = tvm::runtime::ThreadPool::Attached()) {
+    return pool->Launch(flambda, cdata, num_task, 1);
+  }
+  using tvm::runtime::threading::device_parallel_launcher;
+  if (auto launcher = device_parallel_launcher.load(std::memory_order_acquire)) {
+    return launcher(flambda, cdata, num_task);
+  }
   int num_workers = tvm::runtime::threading::MaxConcurrency();
   if (num_workers == 1) {
-    std::atomic<int32_t> sync_counter{0};
-    TVMParallelGroupEnv env;
-    env.num_task = 1;
-    env.sync_handle = &sync_counter;
-    (*flambda)(0, &env, cdata);
-    return 0;
+    return tvm::runtime::ThreadPool::RunInline(flambda, cdata);
   } else {
 #if !TVM_THREADPOOL_USE_OPENMP
     int res = tvm::runtime::ThreadPool::ThreadLocal()->Launch(flambda, cdata, num_task, 1);
@@ -43,6 +43,7 @@ extern "C" {
 #define HEXAGON_STACK_ALIGNMENT 32
 #endif
 #include <algorithm>
+#include <string>
 #include <thread>
 #define CURRENT_THREAD_HANDLE (static_cast<std::thread::native_handle_type>(0))
 namespace tvm {
@@ -411,6 +412,58 @@ int MaxConcurrency() {
   return std::max(max_concurrency, 1);
 }
 
+#if defined(__linux__)
+namespace {
+/*!
+ * \brief Parse a list of CPUs in the format of the sysfs, e.g. "0-3,8,10-11".
+ */
+std::vector<unsigned int> ParseCpuList(const std::string& list) {
+  std::vector<unsigned int> cpus;
+  std::istringstream is(list);
+  std::string range;
+  while (std::getline(is, range, ',')) {
+    if (range.empty()) continue;
+    size_t dash = range.find('-');
+    unsigned int begin = std::stoul(range.substr(0, dash));
+    unsigned int end = dash == std::string::npos ? begin : std::stoul(range.substr(dash + 1));
+    for (unsigned int cpu = begin; cpu <= end; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+}  // namespace
+#endif
+
+std::vector<std::vector<unsigned int>> NumaNodeCpus() {
+  std::vector<std::vector<unsigned int>> nodes;
+#if defined(__linux__)
+  for (int node = 0;; ++node) {
+    std::ifstream ifs("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    if (ifs.fail()) break;
+    // the list of a node without CPUs is empty
+    std::string list;
+    std::getline(ifs, list);
+    nodes.push_back(ParseCpuList(list));
+  }
+#endif
+  if (nodes.empty()) {
+    std::vector<unsigned int> cpus(std::max(std::thread::hardware_concurrency(), 1U));
+    for (size_t i = 0; i < cpus.size(); ++i) {
+      cpus[i] = i;
+    }
+    nodes.push_back(std::move(cpus));
+  }
+  return nodes;
+}
+
+// The NUMA node preferred by the CPU allocations of each thread.
+thread_local int preferred_numa_node = -1;
+
+void SetPreferredNumaNode(int node) { preferred_numa_node = node; }
+
+int PreferredNumaNode() { return preferred_numa_node; }
+
 }  // namespace threading
 }  // namespace runtime
 }  // namespace tvm
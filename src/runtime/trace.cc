@@ -0,0 +1,176 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file trace.cc
+ * \brief The buffers of the spans of the runtime tracing.
+ */
+#include "trace.h"
+
+#include <tvm/runtime/container/string.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace trace {
+
+std::atomic<bool> enabled{false};
+
+/*!
+ * \brief The latest spans of a thread, in a ring written by the thread only. The spans being
+ * overwritten while the ring is read may be torn, so they are read after the tracing stops.
+ */
+class ThreadBuffer {
+ public:
+  ThreadBuffer(size_t capacity, int tid) : events_(capacity), tid_(tid) {}
+
+  void Push(const char* category, const char* name, int64_t begin_ns, int64_t end_ns) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    Event& event = events_[head % events_.size()];
+    event.begin_ns = begin_ns;
+    event.duration_ns = end_ns - begin_ns;
+    event.category = category;
+    std::strncpy(event.name, name, Event::kMaxNameLength);
+    event.name[Event::kMaxNameLength] = '\0';
+    head_.store(head + 1, std::memory_order_release);
+  }
+
+  /*! \brief The spans in the ring, from the oldest. */
+  std::vector<Event> Snapshot() const {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t num_events = std::min<uint64_t>(head, events_.size());
+    std::vector<Event> events;
+    events.reserve(num_events);
+    for (uint64_t i = head - num_events; i < head; ++i) {
+      events.push_back(events_[i % events_.size()]);
+    }
+    return events;
+  }
+
+  int tid() const { return tid_; }
+
+ private:
+  std::vector<Event> events_;
+  /*! \brief The number of spans pushed. */
+  std::atomic<uint64_t> head_{0};
+  int tid_;
+};
+
+class TraceRegistry {
+ public:
+  static TraceRegistry* Global() {
+    // NOTE: explicitly use new to avoid exit-time destruction of global state
+    static auto* inst = new TraceRegistry();
+    return inst;
+  }
+
+  /*! \brief The buffer of the calling thread in the current trace. */
+  ThreadBuffer* ThreadLocal() {
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    thread_local uint64_t buffer_generation = 0;
+    uint64_t generation = generation_.load(std::memory_order_acquire);
+    if (buffer == nullptr || buffer_generation != generation) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      buffer = std::make_shared<ThreadBuffer>(capacity_, static_cast<int>(buffers_.size()));
+      buffers_.push_back(buffer);
+      buffer_generation = generation_.load(std::memory_order_relaxed);
+    }
+    return buffer.get();
+  }
+
+  void Start(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffers_.clear();
+    capacity_ = capacity;
+    generation_.fetch_add(1, std::memory_order_release);
+    enabled.store(true, std::memory_order_relaxed);
+  }
+
+  void Stop() { enabled.store(false, std::memory_order_relaxed); }
+
+  /*! \brief The spans of all the threads, in the JSON object format of Chrome traces. */
+  std::string Dump() {
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      buffers = buffers_;
+    }
+    std::ostringstream os;
+    os << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+    bool first = true;
+    for (const std::shared_ptr<ThreadBuffer>& buffer : buffers) {
+      for (const Event& event : buffer->Snapshot()) {
+        os << (first ? "\n" : ",\n") << "{\"name\": \"";
+        for (const char* c = event.name; *c != '\0'; ++c) {
+          if (*c == '"' || *c == '\\') os << '\\';
+          os << *c;
+        }
+        // the timestamps of Chrome traces are in microseconds
+        os << "\", \"cat\": \"" << event.category << "\", \"ph\": \"X\", \"ts\": "
+           << event.begin_ns / 1000 << "." << (event.begin_ns % 1000) / 100
+           << ", \"dur\": " << event.duration_ns / 1000 << "." << (event.duration_ns % 1000) / 100
+           << ", \"pid\": 0, \"tid\": " << buffer->tid() << "}";
+        first = false;
+      }
+    }
+    os << "\n]}";
+    return os.str();
+  }
+
+ private:
+  std::mutex mutex_;
+  /*! \brief The buffers of the threads in the current trace, alive after the threads exit. */
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+  /*! \brief The number of spans kept by each thread. */
+  size_t capacity_{1 << 16};
+  /*! \brief The number of traces started, the buffers of the previous ones are dropped. */
+  std::atomic<uint64_t> generation_{0};
+};
+
+void Record(const char* category, const char* name, int64_t begin_ns, int64_t end_ns) {
+  TraceRegistry::Global()->ThreadLocal()->Push(category, name, begin_ns, end_ns);
+}
+
+TVM_REGISTER_GLOBAL("runtime.trace.Start").set_body_typed([](int64_t capacity) {
+  CHECK_GT(capacity, 0) << "ValueError: The spans kept by each thread must be positive, but gets "
+                        << capacity;
+  if (!TVM_RUNTIME_TRACE) {
+    LOG(WARNING) << "The runtime is built without USE_RUNTIME_TRACE, so no span is recorded";
+  }
+  TraceRegistry::Global()->Start(static_cast<size_t>(capacity));
+});
+
+TVM_REGISTER_GLOBAL("runtime.trace.Stop").set_body_typed([]() { TraceRegistry::Global()->Stop(); });
+
+TVM_REGISTER_GLOBAL("runtime.trace.Dump").set_body_typed([]() {
+  return String(TraceRegistry::Global()->Dump());
+});
+
+}  // namespace trace
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,107 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file trace.h
+ * \brief The process-wide tracing of the runtime, recording the spans of the calls of the VM,
+ *        the kernel launches, the allocations and the copies in Chrome trace format.
+ */
+#ifndef TVM_RUNTIME_TRACE_H_
+#define TVM_RUNTIME_TRACE_H_
+
+#include <tvm/runtime/object.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#ifndef TVM_RUNTIME_TRACE
+#define TVM_RUNTIME_TRACE 1
+#endif
+
+namespace tvm {
+namespace runtime {
+namespace trace {
+
+/*! \brief A span recorded by the tracing. */
+struct Event {
+  /*! \brief The maximum length of the name, longer names are truncated. */
+  static constexpr size_t kMaxNameLength = 47;
+  int64_t begin_ns;
+  int64_t duration_ns;
+  /*! \brief The category, a string literal. */
+  const char* category;
+  char name[kMaxNameLength + 1];
+};
+
+/*! \brief Whether the spans are recorded, set by `runtime.trace.Start` and `runtime.trace.Stop`. */
+extern std::atomic<bool> enabled;
+
+/*! \brief The timestamp of the spans. */
+inline int64_t NowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/*!
+ * \brief Record a span in the buffer of the calling thread, which keeps the latest spans.
+ * \param category The category, a string literal.
+ * \param name The name, copied.
+ * \param begin_ns The beginning of the span.
+ * \param end_ns The end of the span.
+ */
+void Record(const char* category, const char* name, int64_t begin_ns, int64_t end_ns);
+
+/*! \brief Record the span of a scope, when the tracing is enabled at the beginning of the scope. */
+class Scope {
+ public:
+  Scope(const char* category, const char* name) {
+    if (enabled.load(std::memory_order_relaxed)) {
+      category_ = category;
+      name_ = name;
+      begin_ns_ = NowNanos();
+    }
+  }
+  ~Scope() {
+    if (category_ != nullptr) Record(category_, name_, begin_ns_, NowNanos());
+  }
+
+ private:
+  const char* category_{nullptr};
+  const char* name_{nullptr};
+  int64_t begin_ns_{0};
+};
+
+}  // namespace trace
+}  // namespace runtime
+}  // namespace tvm
+
+/*!
+ * \brief Record the span of the enclosing scope, unless the runtime is built without
+ * USE_RUNTIME_TRACE, where the arguments are not evaluated.
+ */
+#if TVM_RUNTIME_TRACE
+#define TVM_TRACE_SCOPE(category, name) \
+  ::tvm::runtime::trace::Scope TVM_STR_CONCAT(__tvm_trace_scope_, __COUNTER__)(category, name)
+#else
+#define TVM_TRACE_SCOPE(category, name)
+#endif
+
+#endif  // TVM_RUNTIME_TRACE_H_
@@ -0,0 +1,75 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file runtime/vm/best_fit_allocator.h
+ * \brief The size class allocator of the Relax VM, for the Relay VM.
+ */
+#ifndef TVM_RUNTIME_VM_BEST_FIT_ALLOCATOR_H_
+#define TVM_RUNTIME_VM_BEST_FIT_ALLOCATOR_H_
+
+#include <tvm/runtime/vm/memory_manager.h>
+
+#include "../relax_vm/best_fit_allocator.h"
+
+namespace tvm {
+namespace runtime {
+namespace vm {
+
+/*!
+ * \brief The allocator serving each request with the best fitting cached block of its size
+ * class, which the Relax VM uses too. Unlike the pooled allocator keyed on the exact page
+ * rounded sizes, it reuses the blocks of similar sizes under dynamic shapes.
+ */
+class BestFitAllocator final : public Allocator {
+ public:
+  explicit BestFitAllocator(Device dev) : Allocator(kBestFit), impl_(dev) {}
+
+  Buffer Alloc(size_t nbytes, size_t alignment, DLDataType type_hint) override {
+    relax_vm::Buffer buf = impl_.Alloc(nbytes, alignment, type_hint);
+    Buffer ret;
+    ret.data = buf.data;
+    ret.size = buf.size;
+    ret.device = buf.device;
+    return ret;
+  }
+
+  void Free(const Buffer& buffer) override {
+    relax_vm::Buffer buf;
+    buf.data = buffer.data;
+    buf.size = buffer.size;
+    buf.device = buffer.device;
+    impl_.Free(buf);
+  }
+
+  size_t UsedMemory() const override {
+    // as the pooled allocator, count the cached blocks reserved from the device
+    relax_vm::AllocatorStats stats = impl_.Stats();
+    return stats.bytes_in_use + stats.bytes_cached;
+  }
+
+ private:
+  relax_vm::BestFitAllocator impl_;
+};
+
+}  // namespace vm
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_VM_BEST_FIT_ALLOCATOR_H_
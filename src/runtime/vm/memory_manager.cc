@@ -26,6 +26,7 @@
 #include <memory>
 #include <utility>
 
+#include "best_fit_allocator.h"
 #include "naive_allocator.h"
 #include "pooled_allocator.h"
 
@@ -130,6 +131,12 @@ Allocator* MemoryManager::GetOrCreateAllocator(Device dev, AllocatorType type) {
         alloc.reset(new PooledAllocator(dev));
         break;
       }
+      case kBestFit: {
+        VLOG(1) << "New best fit allocator for " << DeviceName(dev.device_type) << "("
+                << dev.device_id << ")";
+        alloc.reset(new BestFitAllocator(dev));
+        break;
+      }
       default:
         LOG(FATAL) << "Unknown allocator type: " << type;
     }
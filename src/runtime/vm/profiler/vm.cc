@@ -42,6 +42,36 @@ namespace tvm {
 namespace runtime {
 namespace vm {
 
+/*!
+ * \brief Add the total durations of the allocations, of the kernels and of the other VM
+ *  instructions to the configuration of a report, so that the allocation overhead is visible
+ *  without summing the rows.
+ */
+static profiling::Report AddDurationsByKind(const profiling::Report& report) {
+  double alloc_us = 0, kernel_us = 0, other_us = 0;
+  for (const auto& call : report->calls) {
+    auto it = call.find("Duration (us)");
+    if (it == call.end()) continue;
+    double us = (*it).second.as<profiling::DurationNode>()->microseconds;
+    std::string name = Downcast<String>(call["Name"]);
+    if (name.rfind("VM::Alloc", 0) == 0) {
+      alloc_us += us;
+    } else if (name.rfind("VM::", 0) == 0) {
+      other_us += us;
+    } else {
+      kernel_us += us;
+    }
+  }
+  Map<String, ObjectRef> configuration = report->configuration;
+  configuration.Set("Allocation Duration (us)",
+                    ObjectRef(make_object<profiling::DurationNode>(alloc_us)));
+  configuration.Set("Kernel Duration (us)",
+                    ObjectRef(make_object<profiling::DurationNode>(kernel_us)));
+  configuration.Set("Other VM Duration (us)",
+                    ObjectRef(make_object<profiling::DurationNode>(other_us)));
+  return profiling::Report(report->calls, report->device_metrics, configuration);
+}
+
 PackedFunc VirtualMachineDebug::GetFunction(const std::string& name,
                                             const ObjectPtr<Object>& sptr_to_self) {
   if (name == "profile") {
@@ -74,7 +104,7 @@ PackedFunc VirtualMachineDebug::GetFunction(const std::string& name,
           prof_.operator*().Stop();
           auto report = prof_.operator*().Report();
           prof_ = std::nullopt;  // releases hardware counters
-          return report;
+          return AddDurationsByKind(report);
         });
   } else if (name == "profile_rpc") {
     // We cannot return a Report over RPC because TVM RPC mechanism only
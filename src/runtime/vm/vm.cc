@@ -396,17 +396,32 @@ inline Allocator* VirtualMachine::GetAllocator(Index device_index) const {
 }
 
 void VirtualMachine::PushFrame(Index arg_count, Index ret_pc, const VMFunction& vm_func) {
-  auto frame = VMFrame(ret_pc, func_index_, arg_count, code_, vm_func.register_file_size);
-  frames_.push_back(frame);
+  if (frame_pool_.empty()) {
+    frames_.emplace_back(ret_pc, func_index_, arg_count, code_, vm_func.register_file_size);
+    return;
+  }
+  // reuse a popped frame together with the storage of its register file
+  frames_.push_back(std::move(frame_pool_.back()));
+  frame_pool_.pop_back();
+  VMFrame& frame = frames_.back();
+  frame.pc = ret_pc;
+  frame.func_index = func_index_;
+  frame.args = arg_count;
+  frame.code = code_;
+  frame.register_file.resize(vm_func.register_file_size);
+  frame.caller_return_register = 0;
 }
 
 Index VirtualMachine::PopFrame() {
   ICHECK_GT(frames_.size(), 0);
-  const VMFrame& fr = frames_.back();
+  VMFrame& fr = frames_.back();
   func_index_ = fr.func_index;
   code_ = fr.code;
   pc_ = fr.pc;
   auto call_stack_size = frames_.size();
+  // release the register values so that the objects are freed as with a fresh frame
+  std::fill(fr.register_file.begin(), fr.register_file.end(), ObjectRef());
+  frame_pool_.push_back(std::move(fr));
   frames_.pop_back();
   return call_stack_size;
 }
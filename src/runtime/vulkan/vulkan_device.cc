@@ -70,6 +70,10 @@ VulkanDeviceProperties::VulkanDeviceProperties(const VulkanInstance& instance,
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_16BIT_STORAGE_FEATURES};
   VkPhysicalDeviceShaderFloat16Int8Features float16_int8 = {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES};
+#ifdef VK_KHR_cooperative_matrix
+  VkPhysicalDeviceCooperativeMatrixFeaturesKHR cooperative_matrix = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_COOPERATIVE_MATRIX_FEATURES_KHR};
+#endif
 
   // Set up linked list for feature query
   {
@@ -86,6 +90,12 @@ VulkanDeviceProperties::VulkanDeviceProperties(const VulkanInstance& instance,
       *pp_next = &float16_int8;
       pp_next = &float16_int8.pNext;
     }
+#ifdef VK_KHR_cooperative_matrix
+    if (device.HasExtension("VK_KHR_cooperative_matrix")) {
+      *pp_next = &cooperative_matrix;
+      pp_next = &cooperative_matrix.pNext;
+    }
+#endif
   }
 
   if (instance.HasExtension("VK_KHR_get_physical_device_properties2")) {
@@ -133,6 +143,9 @@ VulkanDeviceProperties::VulkanDeviceProperties(const VulkanInstance& instance,
       !support::BoolEnvironmentVar("TVM_VULKAN_DISABLE_DEDICATED_ALLOCATION");
 
   supports_integer_dot_product = device.HasExtension("VK_KHR_shader_integer_dot_product");
+#ifdef VK_KHR_cooperative_matrix
+  supports_cooperative_matrix = cooperative_matrix.cooperativeMatrix;
+#endif
 
   // The check of VK_SHADER_STAGE_COMPUTE_BIT isn't technically
   // needed, since it will be set so long at least one queue has
@@ -435,7 +448,8 @@ std::vector<const char*> VulkanDevice::SelectEnabledExtensions() const {
                                                "VK_KHR_get_memory_requirements2",
                                                "VK_KHR_dedicated_allocation",
                                                "VK_KHR_spirv_1_4",
-                                               "VK_KHR_shader_integer_dot_product"};
+                                               "VK_KHR_shader_integer_dot_product",
+                                               "VK_KHR_cooperative_matrix"};
 
   uint32_t device_extension_prop_count;
   VULKAN_CALL(vkEnumerateDeviceExtensionProperties(physical_device_, nullptr,
@@ -461,6 +475,10 @@ void VulkanDevice::CreateVkDevice(const VulkanInstance& instance) {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_16BIT_STORAGE_FEATURES};
   VkPhysicalDeviceShaderFloat16Int8Features float16_int8 = {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES};
+#ifdef VK_KHR_cooperative_matrix
+  VkPhysicalDeviceCooperativeMatrixFeaturesKHR cooperative_matrix = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_COOPERATIVE_MATRIX_FEATURES_KHR};
+#endif
 
   void** pp_next = &enabled_features.pNext;
   bool needs_float16_int8 = false;
@@ -497,6 +515,13 @@ void VulkanDevice::CreateVkDevice(const VulkanInstance& instance) {
     *pp_next = &float16_int8;
     pp_next = &float16_int8.pNext;
   }
+#ifdef VK_KHR_cooperative_matrix
+  if (device_properties.supports_cooperative_matrix) {
+    cooperative_matrix.cooperativeMatrix = true;
+    *pp_next = &cooperative_matrix;
+    pp_next = &cooperative_matrix.pNext;
+  }
+#endif
 
   float priority = 1.0f;
 
@@ -240,6 +240,9 @@ void VulkanDeviceAPI::GetTargetProperty(Device dev, const std::string& property,
   if (property == "supports_integer_dot_product") {
     *rv = prop.supports_integer_dot_product;
   }
+  if (property == "supports_cooperative_matrix") {
+    *rv = prop.supports_cooperative_matrix;
+  }
 
   if (property == "device_name") {
     *rv = prop.device_name;
@@ -447,6 +450,58 @@ TVM_REGISTER_GLOBAL("device_api.vulkan.get_target_property")
       return rv;
     });
 
+/*!
+ * \brief An object holding a command graph captured on the Vulkan stream of a device.
+ *
+ *  The kernels launched on the calling thread between graph.begin_capture and
+ *  graph.end_capture are recorded once, and graph.launch replays them with a single queue
+ *  submission. Like a CUDA graph, the replay only reruns the device work, with the buffers and
+ *  the scalar arguments of capture time.
+ */
+class VulkanCommandGraphObj : public Object {
+ public:
+  /*! \brief The device where the graph is captured. */
+  Device device;
+  /*! \brief The captured graph, null until the capture ends. */
+  std::shared_ptr<VulkanCommandGraph> graph;
+
+  static constexpr const uint32_t _type_index = TypeIndex::kDynamic;
+  static constexpr const char* _type_key = "runtime.vulkan.CommandGraph";
+  TVM_DECLARE_FINAL_OBJECT_INFO(VulkanCommandGraphObj, Object);
+};
+
+/*! \brief Reference to VulkanCommandGraphObj. */
+class VulkanCommandGraphRef : public ObjectRef {
+ public:
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(VulkanCommandGraphRef, ObjectRef, VulkanCommandGraphObj);
+};
+
+TVM_REGISTER_OBJECT_TYPE(VulkanCommandGraphObj);
+
+TVM_REGISTER_GLOBAL("runtime.vulkan.graph.begin_capture").set_body_typed([](Device dev) {
+  ICHECK_EQ(dev.device_type, kDLVulkan) << "A Vulkan graph can only be captured on Vulkan devices";
+  ObjectPtr<VulkanCommandGraphObj> n = make_object<VulkanCommandGraphObj>();
+  n->device = dev;
+  // the kernels are launched on the active device of the thread
+  VulkanDeviceAPI::Global()->SetDevice(dev);
+  VulkanDeviceAPI::Global()->device(dev.device_id).ThreadLocalStream().BeginCapture();
+  return VulkanCommandGraphRef(n);
+});
+
+TVM_REGISTER_GLOBAL("runtime.vulkan.graph.end_capture")
+    .set_body_typed([](VulkanCommandGraphRef graph) {
+      VulkanStream& stream =
+          VulkanDeviceAPI::Global()->device(graph->device.device_id).ThreadLocalStream();
+      graph->graph = stream.EndCapture();
+    });
+
+TVM_REGISTER_GLOBAL("runtime.vulkan.graph.launch").set_body_typed([](VulkanCommandGraphRef graph) {
+  ICHECK(graph->graph != nullptr) << "The Vulkan graph capture is not finished yet";
+  // the work queued before the replay runs first
+  VulkanDeviceAPI::Global()->device(graph->device.device_id).ThreadLocalStream().Synchronize();
+  graph->graph->Launch();
+});
+
 }  // namespace vulkan
 }  // namespace runtime
 }  // namespace tvm
@@ -19,6 +19,8 @@
 
 #include "vulkan_stream.h"
 
+#include <algorithm>
+
 #include "../../support/utils.h"
 #include "vulkan_device.h"
 
@@ -26,8 +28,131 @@ namespace tvm {
 namespace runtime {
 namespace vulkan {
 
+namespace {
+// The number of descriptor sets, and the storage buffers per set, that a pool is sized for.
+constexpr uint32_t kDescriptorSetsPerPool = 128;
+constexpr uint32_t kStorageBuffersPerSet = 8;
+
+// Submit the command buffer to the queue of the device, and wait for it to finish.
+void SubmitAndWait(const VulkanDevice* device, VkCommandBuffer cmd_buffer, VkFence fence) {
+  VkSubmitInfo cb_submit;
+  cb_submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  cb_submit.pNext = nullptr;
+  cb_submit.waitSemaphoreCount = 0;
+  cb_submit.pWaitSemaphores = nullptr;
+  cb_submit.pWaitDstStageMask = 0;
+  cb_submit.commandBufferCount = 1;
+  cb_submit.pCommandBuffers = &cmd_buffer;
+  cb_submit.signalSemaphoreCount = 0;
+  cb_submit.pSignalSemaphores = nullptr;
+
+  device->QueueSubmit(cb_submit, fence);
+
+  uint64_t timeout = 1UL << 30UL;
+  VkResult res;
+  do {
+    res = vkWaitForFences(*device, 1, &fence, 0, timeout);
+  } while (res == VK_TIMEOUT);
+  VULKAN_CHECK_ERROR(res);
+  VULKAN_CALL(vkResetFences(*device, 1, &fence));
+}
+}  // namespace
+
+VulkanDescriptorPools::~VulkanDescriptorPools() {
+  for (VkDescriptorPool pool : pools_) {
+    vkDestroyDescriptorPool(*device_, pool, nullptr);
+  }
+}
+
+VkDescriptorPool VulkanDescriptorPools::CreatePool(uint32_t num_storage_buffers,
+                                                   uint32_t num_uniform_buffers) {
+  std::vector<VkDescriptorPoolSize> pool_sizes;
+  VkDescriptorPoolSize storage_size;
+  storage_size.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  storage_size.descriptorCount =
+      std::max(num_storage_buffers, kDescriptorSetsPerPool * kStorageBuffersPerSet);
+  pool_sizes.push_back(storage_size);
+  VkDescriptorPoolSize uniform_size;
+  uniform_size.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+  uniform_size.descriptorCount = std::max(num_uniform_buffers, kDescriptorSetsPerPool);
+  pool_sizes.push_back(uniform_size);
+
+  VkDescriptorPoolCreateInfo descrip_pool_cinfo;
+  descrip_pool_cinfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+  descrip_pool_cinfo.pNext = nullptr;
+  descrip_pool_cinfo.flags = 0;
+  descrip_pool_cinfo.maxSets = kDescriptorSetsPerPool;
+  descrip_pool_cinfo.poolSizeCount = pool_sizes.size();
+  descrip_pool_cinfo.pPoolSizes = pool_sizes.data();
+  VkDescriptorPool pool;
+  VULKAN_CALL(vkCreateDescriptorPool(*device_, &descrip_pool_cinfo, nullptr, &pool));
+  return pool;
+}
+
+VkDescriptorSet VulkanDescriptorPools::Allocate(VkDescriptorSetLayout layout,
+                                                uint32_t num_storage_buffers,
+                                                uint32_t num_uniform_buffers) {
+  VkDescriptorSetAllocateInfo alloc_info;
+  alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  alloc_info.pNext = nullptr;
+  alloc_info.descriptorSetCount = 1;
+  alloc_info.pSetLayouts = &layout;
+  VkDescriptorSet descriptor_set;
+  for (; current_pool_ < pools_.size(); ++current_pool_) {
+    alloc_info.descriptorPool = pools_[current_pool_];
+    VkResult res = vkAllocateDescriptorSets(*device_, &alloc_info, &descriptor_set);
+    if (res == VK_SUCCESS) return descriptor_set;
+    // The pool is full, move on to the next one.
+    if (res != VK_ERROR_OUT_OF_POOL_MEMORY && res != VK_ERROR_FRAGMENTED_POOL) {
+      VULKAN_CHECK_ERROR(res);
+    }
+  }
+  pools_.push_back(CreatePool(num_storage_buffers, num_uniform_buffers));
+  alloc_info.descriptorPool = pools_.back();
+  VULKAN_CALL(vkAllocateDescriptorSets(*device_, &alloc_info, &descriptor_set));
+  return descriptor_set;
+}
+
+void VulkanDescriptorPools::Reset() {
+  for (size_t i = 0; i < pools_.size() && i <= current_pool_; ++i) {
+    VULKAN_CALL(vkResetDescriptorPool(*device_, pools_[i], 0));
+  }
+  current_pool_ = 0;
+}
+
+VulkanCommandGraph::VulkanCommandGraph(const VulkanDevice* device)
+    : device_(device), descriptor_pools_(device) {
+  VkCommandPoolCreateInfo cmd_pool_cinfo;
+  cmd_pool_cinfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+  cmd_pool_cinfo.pNext = nullptr;
+  cmd_pool_cinfo.flags = 0;
+  cmd_pool_cinfo.queueFamilyIndex = device_->queue_family_index;
+  VULKAN_CALL(vkCreateCommandPool(*device_, &cmd_pool_cinfo, nullptr, &cmd_pool_));
+
+  VkCommandBufferAllocateInfo buffer_alloc_info;
+  buffer_alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+  buffer_alloc_info.pNext = nullptr;
+  buffer_alloc_info.commandPool = cmd_pool_;
+  buffer_alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  buffer_alloc_info.commandBufferCount = 1;
+  VULKAN_CALL(vkAllocateCommandBuffers(*device_, &buffer_alloc_info, &cmd_buffer_));
+
+  VkFenceCreateInfo fence_cinfo;
+  fence_cinfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+  fence_cinfo.pNext = nullptr;
+  fence_cinfo.flags = 0;
+  VULKAN_CALL(vkCreateFence(*device_, &fence_cinfo, nullptr, &fence_));
+}
+
+VulkanCommandGraph::~VulkanCommandGraph() {
+  vkDestroyFence(*device_, fence_, nullptr);
+  vkDestroyCommandPool(*device_, cmd_pool_, nullptr);
+}
+
+void VulkanCommandGraph::Launch() { SubmitAndWait(device_, cmd_buffer_, fence_); }
+
 VulkanStream::VulkanStream(const VulkanDevice* device)
-    : device_(device), state_(new VulkanStreamState()) {
+    : device_(device), state_(new VulkanStreamState()), descriptor_pools_(device) {
   // create command pool
   VkCommandPoolCreateInfo cmd_pool_cinfo;
   cmd_pool_cinfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
@@ -72,89 +197,51 @@ VulkanStream::~VulkanStream() {
 }
 
 void VulkanStream::Launch(const std::function<void(VulkanStreamState*)>& kernel) {
-  if (device_->UseImmediate()) {
-    kernel(state_.get());
-  } else {
-    deferred_kernels_.push_back(kernel);
-  }
+  kernel(state_.get());
 }
 
-void VulkanStream::LaunchDeferred(const std::function<void()>& deferred_initializer,
-                                  const std::function<void(VulkanStreamState*)>& deferred_kernel,
-                                  const VulkanStreamToken& deferred_token) {
-  ICHECK(!device_->UseImmediate());
-
-  // If the new kernel uses the same descriptor set as one of the
-  // kernels already in the command buffer, we need to synchronize
-  // first.
-  if (std::any_of(deferred_tokens_[deferred_token.descriptor_set_].begin(),
-                  deferred_tokens_[deferred_token.descriptor_set_].end(),
-                  [&](const VulkanStreamToken& token) {
-                    DCHECK(token.descriptor_set_ == deferred_token.descriptor_set_);
-                    return token.descriptor_set_ == deferred_token.descriptor_set_ &&
-                           token.buffers_ != deferred_token.buffers_;
-                  })) {
-    Synchronize();
-  }
+VkDescriptorSet VulkanStream::AllocateDescriptorSet(VkDescriptorSetLayout layout,
+                                                    uint32_t num_storage_buffers,
+                                                    uint32_t num_uniform_buffers) {
+  VulkanDescriptorPools& pools = capture_ ? capture_->descriptor_pools_ : descriptor_pools_;
+  return pools.Allocate(layout, num_storage_buffers, num_uniform_buffers);
+}
 
-  // If the new kernel uses the same buffers in the same descriptor
-  // set as an already-queued kernel, we don't need to initialize it
-  // again.  Since every VulkanWrappedFunc owns a single descriptor
-  // set, unless the same function is called with the same buffer
-  // arguments, deferred_initializer() will always be called.
-  if (!std::any_of(deferred_tokens_[deferred_token.descriptor_set_].begin(),
-                   deferred_tokens_[deferred_token.descriptor_set_].end(),
-                   [&](const VulkanStreamToken& token) {
-                     DCHECK(token.descriptor_set_ == deferred_token.descriptor_set_);
-                     return token.descriptor_set_ == deferred_token.descriptor_set_ &&
-                            token.buffers_ == deferred_token.buffers_;
-                   })) {
-    deferred_initializer();
-  }
+void VulkanStream::BeginCapture() {
+  ICHECK(!IsCapturing()) << "The Vulkan stream is already capturing a command graph";
+  Synchronize();
+  capture_ = std::make_shared<VulkanCommandGraph>(device_);
 
-  // Save the kernel itself to be called later.
-  deferred_kernels_.push_back(deferred_kernel);
-  deferred_tokens_[deferred_token.descriptor_set_].push_back(deferred_token);
+  VkCommandBufferBeginInfo cb_begin;
+  cb_begin.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  cb_begin.pNext = nullptr;
+  cb_begin.flags = 0;
+  cb_begin.pInheritanceInfo = 0;
+  VULKAN_CALL(vkBeginCommandBuffer(capture_->cmd_buffer_, &cb_begin));
+  stream_cmd_buffer_ = state_->cmd_buffer_;
+  state_->cmd_buffer_ = capture_->cmd_buffer_;
 }
 
-void VulkanStream::Synchronize() {
-  if (!device_->UseImmediate()) {
-    for (const auto& deferred_kernel : deferred_kernels_) {
-      deferred_kernel(state_.get());
-    }
-    deferred_kernels_.clear();
-    deferred_tokens_.clear();
-  } else {
-    DCHECK_EQ(deferred_kernels_.size(), 0);
-    DCHECK_EQ(deferred_tokens_.size(), 0);
-  }
+std::shared_ptr<VulkanCommandGraph> VulkanStream::EndCapture() {
+  ICHECK(IsCapturing()) << "The Vulkan stream is not capturing a command graph";
+  VULKAN_CALL(vkEndCommandBuffer(capture_->cmd_buffer_));
+  state_->cmd_buffer_ = stream_cmd_buffer_;
+  stream_cmd_buffer_ = VK_NULL_HANDLE;
+  return std::move(capture_);
+}
 
+void VulkanStream::Synchronize() {
+  ICHECK(!IsCapturing()) << "Cannot synchronize a Vulkan stream while capturing a command graph, "
+                         << "the captured work can only run on the device";
   VULKAN_CALL(vkEndCommandBuffer(state_->cmd_buffer_));
-  VkSubmitInfo cb_submit;
-  cb_submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-  cb_submit.pNext = nullptr;
-  cb_submit.waitSemaphoreCount = 0;
-  cb_submit.pWaitSemaphores = nullptr;
-  cb_submit.pWaitDstStageMask = 0;
-  cb_submit.commandBufferCount = 1;
-  cb_submit.pCommandBuffers = &(state_->cmd_buffer_);
-  cb_submit.signalSemaphoreCount = 0;
-  cb_submit.pSignalSemaphores = nullptr;
 
   if (profiler_) {
     profiler_->capture();
   }
 
-  device_->QueueSubmit(cb_submit, state_->fence_);
-
-  uint64_t timeout = 1UL << 30UL;
-  VkResult res;
-  do {
-    res = vkWaitForFences(*device_, 1, &(state_->fence_), 0, timeout);
-  } while (res == VK_TIMEOUT);
-  VULKAN_CHECK_ERROR(res);
+  SubmitAndWait(device_, state_->cmd_buffer_, state_->fence_);
   VULKAN_CALL(vkResetCommandBuffer(state_->cmd_buffer_, 0));
-  VULKAN_CALL(vkResetFences(*device_, 1, &(state_->fence_)));
+  descriptor_pools_.Reset();
 
   // Re-initialize the command buffer
   VkCommandBufferBeginInfo cb_begin;
@@ -22,7 +22,6 @@
 
 #include <functional>
 #include <memory>
-#include <unordered_map>
 #include <vector>
 
 #include "vulkan_amdrgp.h"
@@ -40,21 +39,77 @@ class VulkanStreamState {
   VkFence fence_;
 };
 
-// Used to identify state that should only be used once-per-stream.
-struct VulkanStreamToken {
-  VkDescriptorSet descriptor_set_{VK_NULL_HANDLE};
-  std::vector<VkBuffer> buffers_;
+/*!
+ * \brief The descriptor pools from which the descriptor sets of the kernels recorded into a
+ *  command buffer are allocated.
+ *
+ *  Every launch takes a fresh descriptor set, so the sets never need to be updated while a
+ *  command buffer that binds them is pending. They are all recycled at once by Reset, after
+ *  the command buffer has finished.
+ */
+class VulkanDescriptorPools {
+ public:
+  explicit VulkanDescriptorPools(const VulkanDevice* device) : device_(device) {}
+
+  ~VulkanDescriptorPools();
+
+  /*!
+   * \brief Allocate a descriptor set, creating another pool when the current ones are full.
+   *
+   * \param layout The layout of the descriptor set.
+   *
+   * \param num_storage_buffers The number of storage buffers in the layout.
+   *
+   * \param num_uniform_buffers The number of uniform buffers in the layout.
+   */
+  VkDescriptorSet Allocate(VkDescriptorSetLayout layout, uint32_t num_storage_buffers,
+                           uint32_t num_uniform_buffers);
+
+  /*! \brief Return all the allocated descriptor sets to the pools. */
+  void Reset();
+
+ private:
+  VkDescriptorPool CreatePool(uint32_t num_storage_buffers, uint32_t num_uniform_buffers);
+
+  const VulkanDevice* device_;
+  std::vector<VkDescriptorPool> pools_;
+  // The index of the pool currently allocated from.
+  size_t current_pool_{0};
+};
+
+/*!
+ * \brief A command buffer recorded once by VulkanStream::BeginCapture and
+ *  VulkanStream::EndCapture, which can be replayed without recording the commands again.
+ *
+ *  This is the Vulkan analog of a CUDA graph. The replay reads and writes the buffers that
+ *  were bound at capture time, with the scalar arguments of capture time.
+ */
+class VulkanCommandGraph {
+ public:
+  explicit VulkanCommandGraph(const VulkanDevice* device);
+
+  ~VulkanCommandGraph();
+
+  /*! \brief Submit the recorded commands to the queue, and wait for them to finish. */
+  void Launch();
+
+ private:
+  friend class VulkanStream;
+
+  const VulkanDevice* device_;
+  VkCommandPool cmd_pool_{VK_NULL_HANDLE};
+  VkCommandBuffer cmd_buffer_{VK_NULL_HANDLE};
+  VkFence fence_{VK_NULL_HANDLE};
+  // The descriptor sets bound by the recorded commands, kept for as long as the graph.
+  VulkanDescriptorPools descriptor_pools_;
 };
 
 /*!
  *  \brief Wrapper around a vulkan command buffer
  *
- *  The VulkanStream collects commands into a VkCommandBuffer.  When a
- *  newly submitted command requires resources reserved by an
- *  already-submitted command, all of the queued commands are
- *  submitted to the GPU, and the CPU waits for all queued commands to
- *  finish.  The queued commands can also be explicitly pushed/waited
- *  on by calling VulkanStream::Synchronize.
+ *  The VulkanStream collects commands into a VkCommandBuffer.  The
+ *  queued commands are submitted to the GPU, and waited on by the
+ *  CPU, by calling VulkanStream::Synchronize.
  *
  *  Currently, there exists one VulkanStream for each GPU device, for
  *  each CPU thread.  Each time a VulkanWrappedFunc is called, it is
@@ -70,35 +125,42 @@ class VulkanStream {
 
   /*! \brief Push the kernel onto the stream's command buffer.
    *
-   * If device.UseImmediate() is true, the kernel is executed
-   * immediately to update the command buffer.  Otherwise, it is added
-   * to the list of deferred updates to be pushed onto the command
-   * buffer.
-   *
-   * Assumes that there are no descriptor sets or buffers accessed by this kernel.
+   * The kernel is executed immediately to update the command buffer.
    *
    */
   void Launch(const std::function<void(VulkanStreamState*)>& kernel);
 
-  /*! \brief Push the kernel onto the stream's command buffer.
+  /*! \brief Allocate a descriptor set for a kernel pushed onto the command buffer.
    *
-   * Can only be called if device.UseImmediate() is false.  The
-   * kernel is delayed, and isn't pushed to the command buffer until
-   * all kernels are collected.
+   * Only needed if device.UseImmediate() is false, i.e. push
+   * descriptors are not supported.  The set stays valid until the
+   * next Synchronize, or for as long as the captured command graph
+   * when capturing.
    *
-   * \param deferred_initializer Updates the descriptor set.  Only
-   * called if the deferred_token has differences from
+   * \param layout The layout of the descriptor set.
    *
-   * \param deferred_kernel Submits updates to the command buffer.
+   * \param num_storage_buffers The number of storage buffers in the layout.
+   *
+   * \param num_uniform_buffers The number of uniform buffers in the layout.
+   */
+  VkDescriptorSet AllocateDescriptorSet(VkDescriptorSetLayout layout, uint32_t num_storage_buffers,
+                                        uint32_t num_uniform_buffers);
+
+  /*! \brief Begin recording the launches into a command graph rather than the stream.
    *
-   * \param deferred_token Indicates which descriptor set and buffers
-   * are accessed by this kernel.  No two kernels in the command
-   * buffer can use the same descriptor set.
+   * The commands already queued are synchronized first.  The stream
+   * cannot be synchronized until EndCapture.
+   */
+  void BeginCapture();
+
+  /*! \brief End the recording started by BeginCapture.
    *
+   * \return The command graph, which replays the recorded launches.
    */
-  void LaunchDeferred(const std::function<void()>& deferred_initializer,
-                      const std::function<void(VulkanStreamState*)>& deferred_kernel,
-                      const VulkanStreamToken& deferred_token);
+  std::shared_ptr<VulkanCommandGraph> EndCapture();
+
+  /*! \brief Whether the launches are recorded into a command graph. */
+  bool IsCapturing() const { return capture_ != nullptr; }
 
   // reset profiler state
   void ProfilerReset() {
@@ -120,10 +182,12 @@ class VulkanStream {
  private:
   const VulkanDevice* device_;
   std::unique_ptr<VulkanStreamState> state_;
-  // An index of deferred tokens, allowing us to efficiently detect duplicated
-  // deferred_initializer blocks.
-  std::unordered_map<VkDescriptorSet, std::vector<VulkanStreamToken>> deferred_tokens_;
-  std::vector<std::function<void(VulkanStreamState*)>> deferred_kernels_;
+  // The descriptor sets of the kernels in the command buffer.
+  VulkanDescriptorPools descriptor_pools_;
+  // The command graph being captured, if any.
+  std::shared_ptr<VulkanCommandGraph> capture_;
+  // The command buffer of the stream, while the one of the command graph is recorded.
+  VkCommandBuffer stream_cmd_buffer_{VK_NULL_HANDLE};
   VkCommandPool cmd_pool_;
   VulkanStreamProfiler* profiler_ = nullptr;
 };
@@ -62,6 +62,11 @@ void VulkanWrappedFunc::operator()(TVMArgs args, TVMRetValue* rv,
     descriptor_buffers[i] = binfo;
   }
   const size_t nbytes_scalars = num_pack_args_ * sizeof(ArgUnion64);
+  // The uniform buffer of the thread is rewritten by every launch, so a replayed command graph
+  // would read the scalars of the last launch.
+  ICHECK(!pipeline->use_ubo || !device.ThreadLocalStream().IsCapturing())
+      << "Cannot capture " << func_name_ << " into a Vulkan command graph, as it passes its "
+      << "scalar arguments through a uniform buffer rather than push constants";
   if (pipeline->use_ubo) {
     auto& ubo = device.ThreadLocalUniformBuffer(nbytes_scalars);
     VkDescriptorBufferInfo binfo;
@@ -111,48 +116,44 @@ void VulkanWrappedFunc::operator()(TVMArgs args, TVMRetValue* rv,
     return;
   }
 
-  // Otherwise, the more expensive deferred path.
-  std::vector<ArgUnion64> pack_args_storage(pack_args, pack_args + num_pack_args_);
-  const auto& deferred_initializer = [&device, pipeline, descriptor_buffers]() {
-    std::vector<VkWriteDescriptorSet> write_descriptor_sets;
-    write_descriptor_sets.resize(descriptor_buffers.size());
-    for (size_t i = 0; i < write_descriptor_sets.size(); i++) {
-      write_descriptor_sets[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-      write_descriptor_sets[i].pNext = 0;
-      write_descriptor_sets[i].dstSet = pipeline->descriptor_set;
-      write_descriptor_sets[i].dstBinding = i;
-      write_descriptor_sets[i].dstArrayElement = 0;
-      write_descriptor_sets[i].descriptorCount = 1;
-      write_descriptor_sets[i].pImageInfo = 0;
-      write_descriptor_sets[i].pBufferInfo = &(descriptor_buffers[i]);
-      write_descriptor_sets[i].pTexelBufferView = 0;
-
-      if (pipeline->use_ubo && i == write_descriptor_sets.size() - 1) {
-        // The last binding is for UBO
-        write_descriptor_sets[i].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-      } else {
-        write_descriptor_sets[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-      }
+  // Otherwise, bind a descriptor set from the pools of the stream, which is fresh for this launch.
+  VulkanStream& stream = device.ThreadLocalStream();
+  VkDescriptorSet descriptor_set = stream.AllocateDescriptorSet(
+      pipeline->descriptor_set_layout, num_buffer_args_, pipeline->use_ubo ? 1 : 0);
+  std::vector<VkWriteDescriptorSet> write_descriptor_sets;
+  write_descriptor_sets.resize(descriptor_buffers.size());
+  for (size_t i = 0; i < write_descriptor_sets.size(); i++) {
+    write_descriptor_sets[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write_descriptor_sets[i].pNext = 0;
+    write_descriptor_sets[i].dstSet = descriptor_set;
+    write_descriptor_sets[i].dstBinding = i;
+    write_descriptor_sets[i].dstArrayElement = 0;
+    write_descriptor_sets[i].descriptorCount = 1;
+    write_descriptor_sets[i].pImageInfo = 0;
+    write_descriptor_sets[i].pBufferInfo = &(descriptor_buffers[i]);
+    write_descriptor_sets[i].pTexelBufferView = 0;
+
+    if (pipeline->use_ubo && i == write_descriptor_sets.size() - 1) {
+      // The last binding is for UBO
+      write_descriptor_sets[i].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    } else {
+      write_descriptor_sets[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
     }
-    vkUpdateDescriptorSets(device, write_descriptor_sets.size(), write_descriptor_sets.data(), 0,
-                           0);
-  };
-  const auto& deferred_kernel = [this, pipeline, wl, pack_args_storage, nbytes_scalars,
-                                 device_id](VulkanStreamState* state) {
-    auto& device = VulkanDeviceAPI::Global()->device(device_id);
+  }
+  vkUpdateDescriptorSets(device, write_descriptor_sets.size(), write_descriptor_sets.data(), 0, 0);
 
+  // Can safely capture by reference as this lambda is immediately executed on the calling thread.
+  stream.Launch([&](VulkanStreamState* state) {
     vkCmdBindPipeline(state->cmd_buffer_, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->pipeline);
     vkCmdBindDescriptorSets(state->cmd_buffer_, VK_PIPELINE_BIND_POINT_COMPUTE,
-                            pipeline->pipeline_layout, 0, 1, &(pipeline->descriptor_set), 0,
-                            nullptr);
+                            pipeline->pipeline_layout, 0, 1, &descriptor_set, 0, nullptr);
 
     if (pipeline->use_ubo) {
       auto& ubo = device.ThreadLocalUniformBuffer(nbytes_scalars);
-      memcpy(ubo.host_addr, pack_args_storage.data(), nbytes_scalars);
+      memcpy(ubo.host_addr, pack_args, nbytes_scalars);
     } else if (num_pack_args_ > 0) {
       vkCmdPushConstants(state->cmd_buffer_, pipeline->pipeline_layout, VK_SHADER_STAGE_COMPUTE_BIT,
-                         0, pack_args_storage.size() * sizeof(ArgUnion64),
-                         pack_args_storage.data());
+                         0, num_pack_args_ * sizeof(ArgUnion64), pack_args);
     }
 
     vkCmdDispatch(state->cmd_buffer_, wl.grid_dim(0), wl.grid_dim(1), wl.grid_dim(2));
@@ -165,14 +166,7 @@ void VulkanWrappedFunc::operator()(TVMArgs args, TVMRetValue* rv,
     vkCmdPipelineBarrier(state->cmd_buffer_, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                          VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
                          1, &barrier_info, 0, nullptr, 0, nullptr);
-  };
-  VulkanStreamToken deferred_token;
-  deferred_token.descriptor_set_ = pipeline->descriptor_set;
-  deferred_token.buffers_.resize(descriptor_buffers.size());
-  for (size_t i = 0; i < descriptor_buffers.size(); ++i) {
-    deferred_token.buffers_[i] = descriptor_buffers[i].buffer;
-  }
-  device.ThreadLocalStream().LaunchDeferred(deferred_initializer, deferred_kernel, deferred_token);
+  });
 
   if (device.UseDebugUtilsLabel()) {
     VkDebugUtilsLabelEXT dispatch_label = {VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT,
@@ -198,7 +192,6 @@ VulkanModuleNode::~VulkanModuleNode() {
       }
       vkDestroyPipeline(device, pe->pipeline, nullptr);
       vkDestroyPipelineLayout(device, pe->pipeline_layout, nullptr);
-      vkDestroyDescriptorPool(device, pe->descriptor_pool, nullptr);
       vkDestroyDescriptorSetLayout(device, pe->descriptor_set_layout, nullptr);
       vkDestroyShaderModule(device, pe->shader, nullptr);
     }
@@ -246,24 +239,10 @@ std::shared_ptr<VulkanPipeline> VulkanModuleNode::GetPipeline(size_t device_id,
   }
   std::vector<VkDescriptorSetLayoutBinding> arg_binding;
   std::vector<VkDescriptorUpdateTemplateEntryKHR> arg_template;
-  std::vector<VkDescriptorPoolSize> descriptor_set_pool_sizes;
   uint32_t num_pod = 0, num_buffer = 0;
 
-  auto push_arg_info = [&arg_binding, &arg_template, &descriptor_set_pool_sizes](
-                           uint32_t binding, VkDescriptorType desc_type) {
-    {
-      auto result = std::find_if(descriptor_set_pool_sizes.begin(), descriptor_set_pool_sizes.end(),
-                                 [&](const auto& psize) { return psize.type == desc_type; });
-      if (result == descriptor_set_pool_sizes.end()) {
-        VkDescriptorPoolSize new_size;
-        new_size.type = desc_type;
-        new_size.descriptorCount = 1;
-        descriptor_set_pool_sizes.push_back(new_size);
-      } else {
-        result->descriptorCount++;
-      }
-    }
-
+  auto push_arg_info = [&arg_binding, &arg_template](uint32_t binding,
+                                                     VkDescriptorType desc_type) {
     {
       VkDescriptorSetLayoutBinding bd;
       bd.binding = binding;
@@ -319,26 +298,6 @@ std::shared_ptr<VulkanPipeline> VulkanModuleNode::GetPipeline(size_t device_id,
         vkCreateDescriptorSetLayout(device, &descrip_cinfo, nullptr, &(pe->descriptor_set_layout)));
   }
 
-  if (!device.UseImmediate()) {
-    VkDescriptorPoolCreateInfo descrip_pool_cinfo;
-    descrip_pool_cinfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    descrip_pool_cinfo.pNext = nullptr;
-    descrip_pool_cinfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-    descrip_pool_cinfo.maxSets = 1;
-    descrip_pool_cinfo.poolSizeCount = descriptor_set_pool_sizes.size();
-    descrip_pool_cinfo.pPoolSizes = descriptor_set_pool_sizes.data();
-    VULKAN_CALL(
-        vkCreateDescriptorPool(device, &descrip_pool_cinfo, nullptr, &(pe->descriptor_pool)));
-
-    VkDescriptorSetAllocateInfo alloc_info;
-    alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    alloc_info.pNext = nullptr;
-    alloc_info.descriptorPool = pe->descriptor_pool;
-    alloc_info.descriptorSetCount = 1;
-    alloc_info.pSetLayouts = &(pe->descriptor_set_layout);
-    VULKAN_CALL(vkAllocateDescriptorSets(device, &alloc_info, &(pe->descriptor_set)));
-  }
-
   VkPushConstantRange crange;
   crange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
   crange.offset = 0;
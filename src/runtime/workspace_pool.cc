@@ -23,13 +23,37 @@
  */
 #include "workspace_pool.h"
 
+#include <tvm/runtime/container/string.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <sstream>
+#include <string>
 
 namespace tvm {
 namespace runtime {
 
 // page size.
 constexpr size_t kWorkspacePageSize = 4 << 10;
+// the sizes up to it are rounded to pages, the larger ones to four classes per power of two.
+constexpr size_t kWorkspacePageClassBytes = 64 << 10;
+
+/*! \brief The maximum bytes cached by each pool of a device, negative for no limit. */
+static std::atomic<int64_t> max_cached_bytes{-1};
+
+/*! \brief Round a size up to its size class, which wastes at most a quarter of it. */
+inline size_t SizeClass(size_t nbytes) {
+  if (nbytes <= kWorkspacePageClassBytes) {
+    nbytes = (nbytes + (kWorkspacePageSize - 1)) / kWorkspacePageSize * kWorkspacePageSize;
+    return nbytes == 0 ? kWorkspacePageSize : nbytes;
+  }
+  size_t base = kWorkspacePageClassBytes;
+  while (base * 2 < nbytes) base *= 2;
+  size_t step = base / 4;
+  return (nbytes + (step - 1)) / step * step;
+}
 
 class WorkspacePool::Pool {
  public:
@@ -39,53 +63,50 @@ class WorkspacePool::Pool {
     Entry e;
     e.data = nullptr;
     e.size = 0;
+    e.stream = nullptr;
     free_list_.push_back(e);
     allocated_.push_back(e);
   }
   // allocate from pool
-  void* Alloc(Device dev, DeviceAPI* device, size_t nbytes) {
-    // Allocate align to page.
-    nbytes = (nbytes + (kWorkspacePageSize - 1)) / kWorkspacePageSize * kWorkspacePageSize;
-    if (nbytes == 0) nbytes = kWorkspacePageSize;
+  void* Alloc(Device dev, DeviceAPI* device, size_t nbytes, TVMStreamHandle stream) {
+    nbytes = SizeClass(nbytes);
     Entry e;
-    DLDataType type;
-    type.code = kDLUInt;
-    type.bits = 8;
-    type.lanes = 1;
-    if (free_list_.size() == 2) {
-      e = free_list_.back();
-      free_list_.pop_back();
-      if (e.size < nbytes) {
-        // resize the page
-        device->FreeDataSpace(dev, e.data);
-        e.data = device->AllocDataSpace(dev, nbytes, kTempAllocaAlignment, type);
-        e.size = nbytes;
+    // find smallest fit
+    auto it = std::lower_bound(free_list_.begin() + 1, free_list_.end(), nbytes,
+                               [](const Entry& e, size_t nbytes) { return e.size < nbytes; });
+    if (it != free_list_.end()) {
+      e = *it;
+      free_list_.erase(it);
+      stats_.bytes_cached -= e.size;
+      ++stats_.num_hits;
+      if (e.stream != stream) {
+        // the kernels queued on the stream the page was freed on may still use it
+        device->SyncStreamFromTo(dev, e.stream, stream);
+        e.stream = stream;
       }
-    } else if (free_list_.size() == 1) {
-      e.data = device->AllocDataSpace(dev, nbytes, kTempAllocaAlignment, type);
-      e.size = nbytes;
     } else {
-      if (free_list_.back().size >= nbytes) {
-        // find smallest fit
-        auto it = free_list_.end() - 2;
-        for (; it->size >= nbytes; --it) {
-        }
-        e = *(it + 1);
-        free_list_.erase(it + 1);
-      } else {
-        // resize the page
+      if (free_list_.size() > 1) {
+        // resize the largest page, so that the pool converges to the sizes in use
         e = free_list_.back();
         free_list_.pop_back();
-        device->FreeDataSpace(dev, e.data);
-        e.data = device->AllocDataSpace(dev, nbytes, kTempAllocaAlignment, type);
-        e.size = nbytes;
+        stats_.bytes_cached -= e.size;
+        ReleaseEntry(dev, device, e);
       }
+      DLDataType type;
+      type.code = kDLUInt;
+      type.bits = 8;
+      type.lanes = 1;
+      e.data = device->AllocDataSpace(dev, nbytes, kTempAllocaAlignment, type);
+      e.size = nbytes;
+      e.stream = stream;
+      ++stats_.num_misses;
     }
+    stats_.bytes_in_use += e.size;
     allocated_.push_back(e);
     return e.data;
   }
   // free resource back to pool
-  void Free(void* data) {
+  void Free(Device dev, DeviceAPI* device, void* data, TVMStreamHandle stream) {
     Entry e;
     if (allocated_.back().data == data) {
       // quick path, last allocated.
@@ -99,18 +120,38 @@ class WorkspacePool::Pool {
       e = allocated_[index];
       allocated_.erase(allocated_.begin() + index);
     }
-    if (free_list_.back().size < e.size) {
-      free_list_.push_back(e);
-    } else if (free_list_.size() == 2) {
-      free_list_.push_back(free_list_.back());
-      free_list_[1] = e;
-    } else {
-      size_t i = free_list_.size() - 1;
-      free_list_.resize(free_list_.size() + 1);
-      for (; e.size < free_list_[i].size; --i) {
-        free_list_[i + 1] = free_list_[i];
+    stats_.bytes_in_use -= e.size;
+    e.stream = stream;
+    auto it = std::upper_bound(free_list_.begin() + 1, free_list_.end(), e.size,
+                               [](size_t nbytes, const Entry& e) { return nbytes < e.size; });
+    free_list_.insert(it, e);
+    stats_.bytes_cached += e.size;
+    int64_t limit = max_cached_bytes.load(std::memory_order_relaxed);
+    while (limit >= 0 && stats_.bytes_cached > limit && free_list_.size() > 1) {
+      Entry largest = free_list_.back();
+      free_list_.pop_back();
+      stats_.bytes_cached -= largest.size;
+      ReleaseEntry(dev, device, largest);
+    }
+  }
+  // return the cached pages to the device
+  void Trim(Device dev, DeviceAPI* device) {
+    for (size_t i = 1; i < free_list_.size(); ++i) {
+      ReleaseEntry(dev, device, free_list_[i]);
+    }
+    free_list_.resize(1);
+    stats_.bytes_cached = 0;
+  }
+  // make the pages freed on a stream reusable on the others
+  void ReleaseStream(Device dev, DeviceAPI* device, TVMStreamHandle stream) {
+    bool synced = false;
+    for (size_t i = 1; i < free_list_.size(); ++i) {
+      if (free_list_[i].stream != stream) continue;
+      if (!synced) {
+        device->StreamSync(dev, stream);
+        synced = true;
       }
-      free_list_[i + 1] = e;
+      free_list_[i].stream = nullptr;
     }
   }
   // Release all resources
@@ -121,20 +162,33 @@ class WorkspacePool::Pool {
     free_list_.clear();
   }
 
+  const Stats& stats() const { return stats_; }
+
  private:
   /*! \brief a single entry in the pool */
   struct Entry {
     void* data;
     size_t size;
+    /*! \brief The stream it was freed on, whose kernels may still use it. */
+    TVMStreamHandle stream;
   };
+
+  void ReleaseEntry(Device dev, DeviceAPI* device, const Entry& e) {
+    device->FreeDataSpace(dev, e.data);
+    ++stats_.num_releases;
+  }
+
   /*! \brief List of free items, sorted from small to big size */
   std::vector<Entry> free_list_;
   /*! \brief List of allocated items */
   std::vector<Entry> allocated_;
+  /*! \brief The counters of the pool. */
+  Stats stats_;
 };
 
-WorkspacePool::WorkspacePool(DLDeviceType device_type, DeviceAPI* device)
-    : device_type_(device_type), device_(device) {}
+WorkspacePool::WorkspacePool(DLDeviceType device_type, DeviceAPI* device,
+                             std::function<TVMStreamHandle()> current_stream)
+    : device_type_(device_type), device_(device), current_stream_(std::move(current_stream)) {}
 
 WorkspacePool::~WorkspacePool() {
   for (size_t i = 0; i < array_.size(); ++i) {
@@ -155,13 +209,65 @@ void* WorkspacePool::AllocWorkspace(Device dev, size_t size) {
   if (array_[dev.device_id] == nullptr) {
     array_[dev.device_id] = new Pool();
   }
-  return array_[dev.device_id]->Alloc(dev, device_, size);
+  TVMStreamHandle stream = current_stream_ != nullptr ? current_stream_() : nullptr;
+  return array_[dev.device_id]->Alloc(dev, device_, size, stream);
 }
 
 void WorkspacePool::FreeWorkspace(Device dev, void* ptr) {
   ICHECK(static_cast<size_t>(dev.device_id) < array_.size() && array_[dev.device_id] != nullptr);
-  array_[dev.device_id]->Free(ptr);
+  TVMStreamHandle stream = current_stream_ != nullptr ? current_stream_() : nullptr;
+  array_[dev.device_id]->Free(dev, device_, ptr, stream);
+}
+
+void WorkspacePool::Trim(Device dev) {
+  if (static_cast<size_t>(dev.device_id) < array_.size() && array_[dev.device_id] != nullptr) {
+    array_[dev.device_id]->Trim(dev, device_);
+  }
+}
+
+WorkspacePool::Stats WorkspacePool::GetStats(Device dev) const {
+  if (static_cast<size_t>(dev.device_id) < array_.size() && array_[dev.device_id] != nullptr) {
+    return array_[dev.device_id]->stats();
+  }
+  return Stats();
 }
 
+void WorkspacePool::ReleaseStream(Device dev, TVMStreamHandle stream) {
+  if (static_cast<size_t>(dev.device_id) < array_.size() && array_[dev.device_id] != nullptr) {
+    array_[dev.device_id]->ReleaseStream(dev, device_, stream);
+  }
+}
+
+void WorkspacePool::SetMaxCachedBytes(int64_t max_bytes) { max_cached_bytes = max_bytes; }
+
+WorkspacePool* WorkspacePool::ThreadLocal(Device dev) {
+  std::string name = "device_api." + std::string(DeviceName(dev.device_type)) + ".workspace_pool";
+  const PackedFunc* f = Registry::Get(name);
+  if (f == nullptr) return nullptr;
+  void* pool = (*f)();
+  return static_cast<WorkspacePool*>(pool);
+}
+
+TVM_REGISTER_GLOBAL("runtime.config_workspace_pool").set_body_typed([](int64_t max_cached_bytes) {
+  WorkspacePool::SetMaxCachedBytes(max_cached_bytes);
+});
+
+TVM_REGISTER_GLOBAL("runtime.workspace_pool_stats").set_body_typed([](Device dev) {
+  WorkspacePool* pool = WorkspacePool::ThreadLocal(dev);
+  CHECK(pool != nullptr) << "ValueError: The device " << dev << " has no workspace pool";
+  WorkspacePool::Stats stats = pool->GetStats(dev);
+  std::ostringstream os;
+  os << "{\"num_hits\": " << stats.num_hits << ", \"num_misses\": " << stats.num_misses
+     << ", \"num_releases\": " << stats.num_releases << ", \"bytes_in_use\": " << stats.bytes_in_use
+     << ", \"bytes_cached\": " << stats.bytes_cached << "}";
+  return String(os.str());
+});
+
+TVM_REGISTER_GLOBAL("runtime.trim_workspace_pool").set_body_typed([](Device dev) {
+  WorkspacePool* pool = WorkspacePool::ThreadLocal(dev);
+  CHECK(pool != nullptr) << "ValueError: The device " << dev << " has no workspace pool";
+  pool->Trim(dev);
+});
+
 }  // namespace runtime
 }  // namespace tvm
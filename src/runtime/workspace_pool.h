@@ -26,6 +26,7 @@
 
 #include <tvm/runtime/device_api.h>
 
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -41,15 +42,35 @@ namespace runtime {
  *  - Only a few allocation will happen, and space will be released after use.
  *  - The release order is usually in reverse order of allocate
  *  - Repeative pattern of same allocations over different runs.
+ *
+ *  The sizes are rounded up to size classes, so that the varying sizes of dynamic shapes reuse
+ *  the same pages. A page is freed on the current stream, and reused on another stream only
+ *  after the stream waits for the work queued on the first one.
  */
 class TVM_DLL WorkspacePool {
  public:
+  /*! \brief The counters of the pool of a device. */
+  struct Stats {
+    /*! \brief The allocations served by a cached page. */
+    int64_t num_hits{0};
+    /*! \brief The allocations of new device memory. */
+    int64_t num_misses{0};
+    /*! \brief The pages returned to the device. */
+    int64_t num_releases{0};
+    /*! \brief The bytes of the pages allocated from the pool. */
+    int64_t bytes_in_use{0};
+    /*! \brief The bytes of the cached pages. */
+    int64_t bytes_cached{0};
+  };
   /*!
    * \brief Create pool with specific device type and device.
    * \param device_type The device type.
    * \param device_api The device API.
+   * \param current_stream The current stream of the thread owning the pool, null if the device
+   * has no streams.
    */
-  WorkspacePool(DLDeviceType device_type, DeviceAPI* device_api);
+  WorkspacePool(DLDeviceType device_type, DeviceAPI* device_api,
+                std::function<TVMStreamHandle()> current_stream = nullptr);
   /*! \brief destructor */
   ~WorkspacePool();
   /*!
@@ -65,6 +86,36 @@ class TVM_DLL WorkspacePool {
    * \param ptr The pointer to be freed.
    */
   void FreeWorkspace(Device dev, void* ptr);
+  /*!
+   * \brief Return the cached pages of a device to the device.
+   * \param dev The device.
+   */
+  void Trim(Device dev);
+  /*!
+   * \brief Get the counters of the pool of a device.
+   * \param dev The device.
+   */
+  Stats GetStats(Device dev) const;
+  /*!
+   * \brief Make the cached pages freed on a stream reusable on the others, before the stream is
+   * destroyed.
+   * \param dev The device of the stream.
+   * \param stream The stream.
+   */
+  void ReleaseStream(Device dev, TVMStreamHandle stream);
+  /*!
+   * \brief Set the maximum bytes cached by each pool of a device, the largest pages beyond it
+   * are returned to the device when they are freed.
+   * \param max_cached_bytes The maximum bytes, negative for no limit.
+   */
+  static void SetMaxCachedBytes(int64_t max_cached_bytes);
+  /*!
+   * \brief Get the pool of the calling thread of a device, registered by its device API as
+   * `device_api.<device name>.workspace_pool`.
+   * \param dev The device.
+   * \return The pool, or nullptr if the device API has no pool.
+   */
+  static WorkspacePool* ThreadLocal(Device dev);
 
  private:
   class Pool;
@@ -74,6 +125,8 @@ class TVM_DLL WorkspacePool {
   DLDeviceType device_type_;
   /*! \brief The device API */
   DeviceAPI* device_;
+  /*! \brief The current stream of the thread owning the pool. */
+  std::function<TVMStreamHandle()> current_stream_;
 };
 
 }  // namespace runtime
@@ -28,8 +28,10 @@
 #include <tvm/te/tensor.h>
 #include <tvm/tir/expr.h>
 
+#include <atomic>
 #include <chrono>
 #include <thread>
+#include <vector>
 
 namespace tvm {
 // Attrs used to python API
@@ -92,6 +94,46 @@ TVM_REGISTER_GLOBAL("testing.run_check_signal").set_body_typed([](int nsec) {
   LOG(INFO) << "Function finished without catching signal";
 });
 
+TVM_REGISTER_GLOBAL("testing.registry_lookup_throughput")
+    .set_body_typed([](String name, int num_threads, int num_lookups) {
+      // The lookups of the global function per second by all the threads, as the serving
+      // threads of the VM do when they resolve the functions they call.
+      std::vector<std::thread> threads;
+      std::atomic<int64_t> num_found{0};
+      auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&]() {
+          int64_t found = 0;
+          for (int j = 0; j < num_lookups; ++j) {
+            found += runtime::Registry::Get(name) != nullptr;
+          }
+          num_found.fetch_add(found, std::memory_order_relaxed);
+        });
+      }
+      for (std::thread& thread : threads) {
+        thread.join();
+      }
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      ICHECK_EQ(num_found.load(), static_cast<int64_t>(num_threads) * num_lookups)
+          << "ValueError: The global function " << name << " is not registered";
+      return static_cast<double>(num_found.load()) / elapsed.count();
+    });
+
+TVM_REGISTER_GLOBAL("testing.packed_call_latency").set_body([](TVMArgs args, TVMRetValue* rv) {
+  // args[0]: the number of calls; args[1]: the function; args[2:]: its arguments. The
+  // nanoseconds per call of the function from C++, as the VM calls its builtins.
+  int num_calls = args[0];
+  PackedFunc func = args[1];
+  TVMArgs func_args(args.values + 2, args.type_codes + 2, args.num_args - 2);
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_calls; ++i) {
+    TVMRetValue ret;
+    func.CallPacked(func_args, &ret);
+  }
+  std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  *rv = elapsed.count() / num_calls;
+});
+
 TVM_REGISTER_GLOBAL("testing.identity_cpp").set_body([](TVMArgs args, TVMRetValue* ret) {
   const auto* identity_func = tvm::runtime::Registry::Get("testing.identity_py");
   ICHECK(identity_func != nullptr)
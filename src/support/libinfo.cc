@@ -111,6 +111,10 @@
 #define TVM_INFO_USE_RTTI "NOT-FOUND"
 #endif
 
+#ifndef TVM_INFO_USE_RUNTIME_TRACE
+#define TVM_INFO_USE_RUNTIME_TRACE "NOT-FOUND"
+#endif
+
 #ifndef TVM_INFO_USE_MSVC_MT
 #define TVM_INFO_USE_MSVC_MT "NOT-FOUND"
 #endif
@@ -167,6 +171,10 @@
 #define TVM_INFO_USE_CURAND "NOT-FOUND"
 #endif
 
+#ifndef TVM_INFO_USE_NCCL
+#define TVM_INFO_USE_NCCL "NOT-FOUND"
+#endif
+
 #ifndef TVM_INFO_USE_MIOPEN
 #define TVM_INFO_USE_MIOPEN "NOT-FOUND"
 #endif
@@ -215,6 +223,10 @@
 #define TVM_INFO_USE_ARM_COMPUTE_LIB "NOT-FOUND"
 #endif
 
+#ifndef TVM_INFO_USE_AMX
+#define TVM_INFO_USE_AMX "NOT-FOUND"
+#endif
+
 #ifndef TVM_INFO_USE_ARM_COMPUTE_LIB_GRAPH_EXECUTOR
 #define TVM_INFO_USE_ARM_COMPUTE_LIB_GRAPH_EXECUTOR "NOT-FOUND"
 #endif
@@ -256,6 +268,7 @@ TVM_DLL Map<String, String> GetLibInfo() {
       {"SUMMARIZE", TVM_INFO_SUMMARIZE},
       {"TVM_CXX_COMPILER_PATH", TVM_CXX_COMPILER_PATH},
       {"USE_ALTERNATIVE_LINKER", TVM_INFO_USE_ALTERNATIVE_LINKER},
+      {"USE_AMX", TVM_INFO_USE_AMX},
       {"USE_AOT_EXECUTOR", TVM_INFO_USE_AOT_EXECUTOR},
       {"USE_ARM_COMPUTE_LIB_GRAPH_EXECUTOR", TVM_INFO_USE_ARM_COMPUTE_LIB_GRAPH_EXECUTOR},
       {"USE_ARM_COMPUTE_LIB", TVM_INFO_USE_ARM_COMPUTE_LIB},
@@ -304,8 +317,10 @@ TVM_DLL Map<String, String> GetLibInfo() {
       {"USE_ROCM", TVM_INFO_USE_ROCM},
       {"USE_RPC", TVM_INFO_USE_RPC},
       {"USE_RTTI", TVM_INFO_USE_RTTI},
+      {"USE_RUNTIME_TRACE", TVM_INFO_USE_RUNTIME_TRACE},
       {"USE_RUST_EXT", TVM_INFO_USE_RUST_EXT},
       {"USE_SORT", TVM_INFO_USE_SORT},
+      {"USE_SPIRV_KHR_COOPERATIVE_MATRIX", TVM_INFO_USE_SPIRV_KHR_COOPERATIVE_MATRIX},
       {"USE_SPIRV_KHR_INTEGER_DOT_PRODUCT", TVM_INFO_USE_SPIRV_KHR_INTEGER_DOT_PRODUCT},
       {"USE_STACKVM_RUNTIME", TVM_INFO_USE_STACKVM_RUNTIME},
       {"USE_TARGET_ONNX", TVM_INFO_USE_TARGET_ONNX},
@@ -317,6 +332,7 @@ TVM_DLL Map<String, String> GetLibInfo() {
       {"USE_THREADS", TVM_INFO_USE_THREADS},
       {"USE_THRUST", TVM_INFO_USE_THRUST},
       {"USE_CURAND", TVM_INFO_USE_CURAND},
+      {"USE_NCCL", TVM_INFO_USE_NCCL},
       {"USE_VITIS_AI", TVM_INFO_USE_VITIS_AI},
       {"USE_VULKAN", TVM_INFO_USE_VULKAN},
       {"USE_CLML", TVM_INFO_USE_CLML},
@@ -0,0 +1,162 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file lz.h
+ * \brief A small LZ77 codec of byte blocks, with the byte shuffle of the elements of arrays
+ *        that makes their contents compressible.
+ */
+#ifndef TVM_SUPPORT_LZ_H_
+#define TVM_SUPPORT_LZ_H_
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace tvm {
+namespace support {
+
+/*! \brief The minimum length of the matches of the lz codec. */
+constexpr size_t kLZMinMatch = 4;
+/*! \brief The number of bits of the hash of the match candidates of the lz codec. */
+constexpr int kLZHashBits = 16;
+
+inline void LZWriteVarint(std::string* out, uint64_t value) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+inline bool LZReadVarint(const uint8_t* data, size_t size, size_t* pos, uint64_t* value) {
+  *value = 0;
+  for (int shift = 0; shift < 64 && *pos < size; shift += 7) {
+    uint8_t byte = data[(*pos)++];
+    *value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) return true;
+  }
+  return false;
+}
+
+inline uint32_t LZHash(const uint8_t* ptr) {
+  uint32_t word;
+  std::memcpy(&word, ptr, sizeof(word));
+  return (word * 2654435761U) >> (32 - kLZHashBits);
+}
+
+/*!
+ * \brief Compress a block as a sequence of (literal length, literals, match length, match
+ *  offset) tokens, the last one having a match length of 0.
+ * \param src The block.
+ * \param size The bytes of the block.
+ * \param out The string the compressed block is appended to.
+ */
+inline void LZCompress(const uint8_t* src, size_t size, std::string* out) {
+  std::vector<int64_t> table(1 << kLZHashBits, -1);
+  size_t anchor = 0;
+  size_t i = 0;
+  while (i + kLZMinMatch <= size) {
+    uint32_t hash = LZHash(src + i);
+    int64_t candidate = table[hash];
+    table[hash] = i;
+    if (candidate < 0 || std::memcmp(src + candidate, src + i, kLZMinMatch) != 0) {
+      ++i;
+      continue;
+    }
+    size_t length = kLZMinMatch;
+    while (i + length < size && src[candidate + length] == src[i + length]) ++length;
+    LZWriteVarint(out, i - anchor);
+    out->append(reinterpret_cast<const char*>(src + anchor), i - anchor);
+    LZWriteVarint(out, length);
+    LZWriteVarint(out, i - candidate);
+    i += length;
+    anchor = i;
+  }
+  LZWriteVarint(out, size - anchor);
+  out->append(reinterpret_cast<const char*>(src + anchor), size - anchor);
+  LZWriteVarint(out, 0);
+}
+
+/*!
+ * \brief Decompress a block compressed by LZCompress.
+ * \param src The compressed block.
+ * \param size The bytes of the compressed block.
+ * \param dst The buffer of the decompressed block.
+ * \param dst_size The bytes of the decompressed block.
+ * \return Whether the block was well formed, and decompressed to exactly dst_size bytes.
+ */
+inline bool LZDecompress(const uint8_t* src, size_t size, uint8_t* dst, size_t dst_size) {
+  size_t pos = 0;
+  size_t written = 0;
+  while (true) {
+    uint64_t num_literals, length, offset;
+    if (!LZReadVarint(src, size, &pos, &num_literals) || num_literals > size - pos ||
+        num_literals > dst_size - written) {
+      return false;
+    }
+    std::memcpy(dst + written, src + pos, num_literals);
+    pos += num_literals;
+    written += num_literals;
+    if (!LZReadVarint(src, size, &pos, &length)) return false;
+    if (length == 0) break;
+    if (!LZReadVarint(src, size, &pos, &offset) || offset == 0 || offset > written ||
+        length > dst_size - written) {
+      return false;
+    }
+    // the match may overlap the bytes it produces
+    for (uint64_t k = 0; k < length; ++k) {
+      dst[written + k] = dst[written - offset + k];
+    }
+    written += length;
+  }
+  return pos == size && written == dst_size;
+}
+
+/*!
+ * \brief Group the bytes of the elements of an array by their position in the element.
+ * \param src The elements.
+ * \param size The bytes of the elements, a multiple of elem_bytes.
+ * \param elem_bytes The bytes of an element.
+ * \param dst The buffer of the shuffled bytes.
+ */
+inline void ShuffleBytes(const uint8_t* src, size_t size, size_t elem_bytes, uint8_t* dst) {
+  size_t num_elems = size / elem_bytes;
+  for (size_t k = 0; k < num_elems; ++k) {
+    for (size_t b = 0; b < elem_bytes; ++b) {
+      dst[b * num_elems + k] = src[k * elem_bytes + b];
+    }
+  }
+}
+
+/*! \brief The inverse of ShuffleBytes. */
+inline void UnshuffleBytes(const uint8_t* src, size_t size, size_t elem_bytes, uint8_t* dst) {
+  size_t num_elems = size / elem_bytes;
+  for (size_t k = 0; k < num_elems; ++k) {
+    for (size_t b = 0; b < elem_bytes; ++b) {
+      dst[k * elem_bytes + b] = src[b * num_elems + k];
+    }
+  }
+}
+
+}  // namespace support
+}  // namespace tvm
+
+#endif  // TVM_SUPPORT_LZ_H_
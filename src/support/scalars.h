@@ -65,6 +65,12 @@ FloatImm ValueToFloatImm(double value, int width);
 // See https://en.wikipedia.org/wiki/Half-precision_floating-point_format
 constexpr double kMaxFloat16 = 65504.0;
 
+// 2^8 * (1 + 6/8)
+constexpr double kMaxE4M3 = 448.0;
+
+// 2^15 * (1 + 3/4)
+constexpr double kMaxE5M2 = 57344.0;
+
 }  // namespace support
 }  // namespace tvm
 
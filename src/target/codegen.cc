@@ -40,6 +40,9 @@
 namespace tvm {
 namespace codegen {
 
+// Embed the linked parameters as raw byte blobs rather than element-wise initializers.
+TVM_REGISTER_PASS_CONFIG_OPTION("codegen.link_params_as_blob", Bool);
+
 runtime::Module Build(IRModule mod, Target target) {
   if (transform::PassContext::Current()
           ->GetConfig<Bool>("tir.disable_assert", Bool(false))
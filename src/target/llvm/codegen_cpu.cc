@@ -665,7 +665,8 @@ void CodeGenCPU::UnpackClosureData(TypedPointer cdata, const Array<Var>& vfields
   }
 }
 
-void CodeGenCPU::CreateParallelLaunch(const Stmt& body, int num_task, std::string name) {
+void CodeGenCPU::CreateParallelLaunch(const Stmt& body, int num_task, std::string name,
+                                      Optional<Var> chunk_counter) {
   // closure data
   llvm::Function* f =
       llvm::Function::Create(ftype_tvm_parallel_lambda_, llvm::Function::PrivateLinkage,
@@ -674,6 +675,7 @@ void CodeGenCPU::CreateParallelLaunch(const Stmt& body, int num_task, std::strin
 
   // allocate and setup the closure, call the closure.
   Array<Var> vfields = tir::UndefinedVars(body, {});
+  if (chunk_counter.defined()) vfields.push_back(chunk_counter.value());
   uint64_t nbytes;
   TypedPointer cdata = PackClosureData(vfields, &nbytes, "closure_" + name);
 #if TVM_LLVM_VERSION >= 90
@@ -706,6 +708,7 @@ void CodeGenCPU::CreateParallelLaunch(const Stmt& body, int num_task, std::strin
       builder_->CreateInBoundsGEP(t_tvm_parallel_group_env_, penv, {ConstInt32(0), ConstInt32(1)}),
       "num_task");
   par_env.penv = penv;
+  if (chunk_counter.defined()) par_env.chunk_counter = chunk_counter.value();
   auto new_analyzer = std::make_unique<arith::Analyzer>();
   std::swap(function_, f);
   std::swap(parallel_env_, par_env);
@@ -1523,10 +1526,37 @@ void CodeGenCPU::VisitStmt_(const ForNode* op) {
   if (op->kind == ForKind::kSerial || op->kind == ForKind::kUnrolled) {
     CodeGenLLVM::VisitStmt_(op);
   } else if (op->kind == ForKind::kParallel) {
+    int64_t chunk_size = 0;
+    if (Optional<ObjectRef> annotation = op->annotations.Get(tir::attr::parallel_chunk_size)) {
+      const auto* chunk = annotation.as<IntImmNode>();
+      CHECK(chunk != nullptr && chunk->value > 0)
+          << "ValueError: The annotation " << tir::attr::parallel_chunk_size << " of loop "
+          << op->loop_var << " must be a positive integer, but gets " << annotation.value();
+      chunk_size = chunk->value;
+    }
     if (parallel_env_.penv == nullptr) {
+      // The dynamically scheduled loop launches with a fresh counter of its iterations.
+      Optional<Var> chunk_counter = NullOpt;
+      if (chunk_size != 0) {
+        Var counter("chunk_counter", DataType::Handle());
+        llvm::Type* t = GetLLVMType(op->extent);
+        llvm::AllocaInst* alloca = WithFunctionEntry([&]() { return builder_->CreateAlloca(t); });
+        builder_->CreateStore(llvm::ConstantInt::get(t, 0), alloca);
+        var_map_[counter.get()] = builder_->CreatePointerCast(alloca, t_void_p_);
+        chunk_counter = counter;
+      }
       CreateParallelLaunch(For(op->loop_var, op->min, op->extent, op->kind, op->body,
                                op->thread_binding, op->annotations),
-                           0, std::string("loop_parallel_") + op->loop_var->name_hint.c_str());
+                           0, std::string("loop_parallel_") + op->loop_var->name_hint.c_str(),
+                           chunk_counter);
+      if (chunk_counter.defined()) var_map_.erase(chunk_counter.value().get());
+    } else if (chunk_size != 0 && parallel_env_.chunk_counter.defined()) {
+      ICHECK(!parallel_env_.in_parallel_loop)
+          << "Nested parallel loop is not supported by threadpool, try fuse them instead";
+      parallel_env_.in_parallel_loop = true;
+      CreateChunkedParallelFor(op, chunk_size);
+      parallel_env_.in_parallel_loop = false;
+      ++parallel_env_.parallel_loop_count;
     } else {
       // already in parallel env.
       ICHECK(parallel_env_.task_id.defined());
@@ -1556,6 +1586,38 @@ void CodeGenCPU::VisitStmt_(const ForNode* op) {
   }
 }
 
+void CodeGenCPU::CreateChunkedParallelFor(const ForNode* op, int64_t chunk_size) {
+  DataType t = op->extent.dtype();
+  llvm::Type* llvm_t = GetLLVMType(op->extent);
+  llvm::Value* counter =
+      builder_->CreatePointerCast(MakeValue(parallel_env_.chunk_counter), llvm_t->getPointerTo());
+  llvm::Value* extent = MakeValue(op->extent);
+  llvm::Value* chunk = llvm::ConstantInt::getSigned(llvm_t, chunk_size);
+  std::string loop_var_name = op->loop_var->name_hint;
+  llvm::LLVMContext* ctx = llvm_target_->GetContext();
+  auto* chunk_begin = llvm::BasicBlock::Create(*ctx, "chunk_begin_" + loop_var_name, function_);
+  auto* chunk_body = llvm::BasicBlock::Create(*ctx, "chunk_body_" + loop_var_name, function_);
+  auto* chunk_end = llvm::BasicBlock::Create(*ctx, "chunk_end_" + loop_var_name, function_);
+  builder_->CreateBr(chunk_begin);
+  // Grab the next chunk, until the counter runs past the extent.
+  builder_->SetInsertPoint(chunk_begin);
+#if TVM_LLVM_VERSION >= 130
+  llvm::Value* begin =
+      builder_->CreateAtomicRMW(llvm::AtomicRMWInst::Add, counter, chunk, llvm::MaybeAlign(),
+                                llvm::AtomicOrdering::Monotonic);
+#else
+  llvm::Value* begin = builder_->CreateAtomicRMW(llvm::AtomicRMWInst::Add, counter, chunk,
+                                                 llvm::AtomicOrdering::Monotonic);
+#endif
+  builder_->CreateCondBr(CreateLT(t, begin, extent), chunk_body, chunk_end, md_very_likely_branch_);
+  builder_->SetInsertPoint(chunk_body);
+  llvm::Value* end = CreateAdd(t, begin, chunk);
+  end = builder_->CreateSelect(CreateLT(t, end, extent), end, extent);
+  CreateSerialFor(begin, end, llvm::ConstantInt::getSigned(llvm_t, 1), op->loop_var, op->body);
+  builder_->CreateBr(chunk_begin);
+  builder_->SetInsertPoint(chunk_end);
+}
+
 TVM_REGISTER_GLOBAL("tvm.codegen.llvm.target_cpu")
     .set_body([](const TVMArgs& targs, TVMRetValue* rv) {
       *rv = static_cast<void*>(new CodeGenCPU());
@@ -125,6 +125,8 @@ class CodeGenCPU : public CodeGenLLVM {
     bool in_parallel_loop{false};
     int parallel_loop_count{0};
     llvm::Value* penv{nullptr};
+    // The iteration counter shared by the tasks of a dynamically scheduled loop
+    Var chunk_counter;
   };
   // Get runtime functions
   void InitGlobalContext(bool dynamic_lookup);
@@ -157,7 +159,10 @@ class CodeGenCPU : public CodeGenLLVM {
   // Create static initialization
   void CreateStaticInit(const std::string& init_fname, const Stmt& body);
   // Create parallel launch
-  void CreateParallelLaunch(const Stmt& body, int num_task, std::string name = "");
+  void CreateParallelLaunch(const Stmt& body, int num_task, std::string name = "",
+                            Optional<Var> chunk_counter = NullOpt);
+  // Create the dynamically scheduled parallel loop, grabbing chunks from the shared counter.
+  void CreateChunkedParallelFor(const ForNode* op, int64_t chunk_size);
   // Create a new compute scope.
   void CreateComputeScope(const AttrStmtNode* op);
   // Check if the call to packed function is successful
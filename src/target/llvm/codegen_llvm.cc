@@ -77,6 +77,7 @@
 #include <llvm/Transforms/IPO.h>
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
 #include <llvm/Transforms/Utils/ModuleUtils.h>
+#include <tvm/ir/transform.h>
 #include <tvm/runtime/c_runtime_api.h>
 #include <tvm/runtime/crt/error_codes.h>
 #include <tvm/runtime/device_api.h>
@@ -731,7 +732,8 @@ llvm::Value* CodeGenLLVM::CreateVecConcat(std::vector<llvm::Value*> vecs) {
 }
 
 void CodeGenLLVM::CreateSerialFor(llvm::Value* begin, llvm::Value* end, llvm::Value* stride,
-                                  const Var& loop_var, const Stmt& body) {
+                                  const Var& loop_var, const Stmt& body,
+                                  bool scalable_vectorize) {
   llvm::BasicBlock* pre_block = builder_->GetInsertBlock();
   std::string loop_var_name = loop_var->name_hint;
   llvm::LLVMContext* ctx = llvm_target_->GetContext();
@@ -752,7 +754,24 @@ void CodeGenLLVM::CreateSerialFor(llvm::Value* begin, llvm::Value* end, llvm::Va
   var_map_.erase(loop_var.get());
   llvm::Value* loop_next = CreateAdd(loop_var.dtype(), loop_value, stride);
   loop_value->addIncoming(loop_next, builder_->GetInsertBlock());
-  builder_->CreateBr(for_begin);
+  llvm::BranchInst* latch = builder_->CreateBr(for_begin);
+  if (scalable_vectorize) {
+    // The loop id is a distinct node referring to itself, followed by the loop properties.
+    auto f_flag = [ctx](const char* name) -> llvm::Metadata* {
+      llvm::Metadata* flag[] = {llvm::MDString::get(*ctx, name),
+                                llvm::ConstantAsMetadata::get(llvm::ConstantInt::getTrue(*ctx))};
+      return llvm::MDNode::get(*ctx, flag);
+    };
+    std::vector<llvm::Metadata*> properties{nullptr, f_flag("llvm.loop.vectorize.enable")};
+#if TVM_LLVM_VERSION >= 120
+    properties.push_back(f_flag("llvm.loop.vectorize.scalable.enable"));
+#endif
+    // Fold the tail into predicated vector iterations rather than a scalar epilogue.
+    properties.push_back(f_flag("llvm.loop.vectorize.predicate.enable"));
+    llvm::MDNode* loop_id = llvm::MDNode::getDistinct(*ctx, properties);
+    loop_id->replaceOperandWith(0, loop_id);
+    latch->setMetadata(llvm::LLVMContext::MD_loop, loop_id);
+  }
   builder_->SetInsertPoint(for_end);
 }
 
@@ -1205,6 +1224,16 @@ llvm::Value* CodeGenLLVM::CreateIntrinsic(const CallNode* op) {
 #else
               << llvm::Intrinsic::getName(id, {});
 #endif
+    // The pointers of the buffers are typed by their elements, while intrinsics such as the AMX
+    // tile loads take a pointer to bytes.
+    llvm::FunctionType* ftype = f->getFunctionType();
+    for (size_t i = 0; i < arg_value.size() && i < ftype->getNumParams(); ++i) {
+      llvm::Type* param_type = ftype->getParamType(i);
+      if (arg_value[i]->getType() != param_type && param_type->isPointerTy() &&
+          arg_value[i]->getType()->isPointerTy()) {
+        arg_value[i] = builder_->CreatePointerCast(arg_value[i], param_type);
+      }
+    }
     return builder_->CreateCall(f, arg_value);
   } else if (op->op.same_as(builtin::bitwise_and())) {
     return builder_->CreateAnd(MakeValue(op->args[0]), MakeValue(op->args[1]));
@@ -1314,6 +1343,33 @@ llvm::Value* CodeGenLLVM::CreateIntrinsic(const CallNode* op) {
       indices.push_back(i);
     }
     return builder_->CreateShuffleVector(v0, v1, indices);
+  } else if (op->op.same_as(builtin::masked_load())) {
+    ICHECK_EQ(op->args.size(), 2U);
+    llvm::Type* type = DTypeToLLVMType(op->dtype);
+    llvm::Value* addr = MakeValue(op->args[0]);
+    unsigned addrspace = llvm::dyn_cast<llvm::PointerType>(addr->getType())->getAddressSpace();
+    addr = builder_->CreatePointerCast(addr, type->getPointerTo(addrspace));
+    llvm::Value* mask = MakeValue(op->args[1]);
+#if TVM_LLVM_VERSION >= 130
+    return builder_->CreateMaskedLoad(type, addr, llvm::Align(op->dtype.bytes()), mask);
+#elif TVM_LLVM_VERSION >= 110
+    return builder_->CreateMaskedLoad(addr, llvm::Align(op->dtype.bytes()), mask);
+#else
+    return builder_->CreateMaskedLoad(addr, op->dtype.bytes(), mask);
+#endif
+  } else if (op->op.same_as(builtin::masked_store())) {
+    ICHECK_EQ(op->args.size(), 3U);
+    DataType value_dtype = op->args[1].dtype();
+    llvm::Value* value = MakeValue(op->args[1]);
+    llvm::Value* addr = MakeValue(op->args[0]);
+    unsigned addrspace = llvm::dyn_cast<llvm::PointerType>(addr->getType())->getAddressSpace();
+    addr = builder_->CreatePointerCast(addr, value->getType()->getPointerTo(addrspace));
+    llvm::Value* mask = MakeValue(op->args[2]);
+#if TVM_LLVM_VERSION >= 110
+    return builder_->CreateMaskedStore(value, addr, llvm::Align(value_dtype.bytes()), mask);
+#else
+    return builder_->CreateMaskedStore(value, addr, value_dtype.bytes(), mask);
+#endif
   } else if (op->op.same_as(builtin::atomic_add())) {
     // TODO(masahi): Support atomic for CPU backend
     LOG(FATAL) << "CPU backend does not support atomic add yet.";
@@ -1732,8 +1788,11 @@ void CodeGenLLVM::VisitStmt_(const ForNode* op) {
   } else {
     ICHECK(op->kind == ForKind::kSerial);
   }
+  const auto* scalable = op->annotations.Get(tir::attr::scalable_vectorize).as<IntImmNode>();
+  bool scalable_vectorize = scalable != nullptr && scalable->value != 0;
   CreateSerialFor(MakeValue(op->min), MakeValue(op->extent),
-                  llvm::ConstantInt::getSigned(GetLLVMType(op->extent), 1), op->loop_var, op->body);
+                  llvm::ConstantInt::getSigned(GetLLVMType(op->extent), 1), op->loop_var, op->body,
+                  scalable_vectorize);
 }
 
 void CodeGenLLVM::VisitStmt_(const WhileNode* op) {
@@ -1775,10 +1834,22 @@ void CodeGenLLVM::VisitStmt_(const IfThenElseNode* op) {
 
 void CodeGenLLVM::VisitStmt_(const AllocateConstNode* op) {
   auto data = op->data.value();
-  auto array = NDArrayToLLVMArray(llvm_target_->GetContext(), data);
+  bool as_blob = transform::PassContext::Current()
+                     ->GetConfig<Bool>("codegen.link_params_as_blob", Bool(false))
+                     .value();
+  llvm::Constant* array = as_blob ? NDArrayToLLVMBlob(llvm_target_->GetContext(), data)
+                                  : NDArrayToLLVMArray(llvm_target_->GetContext(), data);
   std::string symbol_name = op->buffer_var->name_hint;
   llvm::GlobalVariable* param_symbol = new llvm::GlobalVariable(
       *module_, array->getType(), true, llvm::GlobalValue::InternalLinkage, array, symbol_name);
+  if (as_blob) {
+    // The bytes of the blob carry no alignment of their own, align them as the allocations.
+#if TVM_LLVM_VERSION >= 100
+    param_symbol->setAlignment(llvm::Align(runtime::kAllocAlignment));
+#else
+    param_symbol->setAlignment(runtime::kAllocAlignment);
+#endif
+  }
 
   var_map_[op->buffer_var.operator->()] = param_symbol;
   this->VisitStmt(op->body);
@@ -25,6 +25,7 @@
 #include "codegen_params.h"
 
 #include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/StringRef.h>
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/DerivedTypes.h>
 #include <llvm/IR/LLVMContext.h>
@@ -176,6 +177,14 @@ llvm::ConstantArray* NDArrayToLLVMArray(llvm::LLVMContext* ctx, ::tvm::runtime::
       llvm::ArrayType::get(element_type, num_elements), llvm::ArrayRef<llvm::Constant*>(elements)));
 }
 
+llvm::Constant* NDArrayToLLVMBlob(llvm::LLVMContext* ctx, ::tvm::runtime::NDArray arr) {
+  CHECK(arr.IsContiguous()) << "CodegenParams: only support contiguous arrays";
+  CHECK_EQ(arr->device.device_type, kDLCPU) << "CodegenParams: only support CPU arrays";
+  size_t num_bytes = runtime::GetDataSize(*arr.operator->());
+  llvm::StringRef data(static_cast<const char*>(arr->data) + arr->byte_offset, num_bytes);
+  return llvm::ConstantDataArray::getString(*ctx, data, false);
+}
+
 }  // namespace codegen
 }  // namespace tvm
 
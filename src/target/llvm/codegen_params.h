@@ -27,6 +27,7 @@
 #include <tvm/runtime/ndarray.h>
 
 namespace llvm {
+class Constant;
 class ConstantArray;
 class LLVMContext;
 }  // namespace llvm
@@ -45,6 +46,18 @@ namespace codegen {
  */
 llvm::ConstantArray* NDArrayToLLVMArray(llvm::LLVMContext* ctx, tvm::runtime::NDArray arr);
 
+/*!
+ * \brief Convert an NDArray to an LLVM array of bytes holding its raw data.
+ *
+ * Unlike NDArrayToLLVMArray, no constant is created per element, the data is copied as a blob the
+ * way CodeGenBlob embeds the device modules, so the cost is independent of the number of elements.
+ *
+ * \param ctx LLVM context used to create the byte type.
+ * \param arr NDArray to convert.
+ * \return LLVM array of i8 containing the array data.
+ */
+llvm::Constant* NDArrayToLLVMBlob(llvm::LLVMContext* ctx, tvm::runtime::NDArray arr);
+
 }  // namespace codegen
 }  // namespace tvm
 
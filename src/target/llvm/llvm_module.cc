@@ -48,6 +48,7 @@
 #include <llvm/Target/TargetOptions.h>
 #include <llvm/Transforms/Utils/Cloning.h>
 #include <tvm/ir/module.h>
+#include <tvm/ir/transform.h>
 #include <tvm/relay/runtime.h>
 #include <tvm/runtime/container/array.h>
 #include <tvm/runtime/container/string.h>
@@ -57,16 +58,22 @@
 #include <tvm/runtime/object.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/support/parallel_for.h>
 #include <tvm/support/with.h>
 #include <tvm/target/codegen.h>
 #include <tvm/target/target.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/stmt_functor.h>
 
 #include <algorithm>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <numeric>
 #include <sstream>
 #include <string>
 #include <system_error>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -104,6 +111,13 @@ class LLVMModuleNode final : public runtime::ModuleNode {
 
   bool ImplementsFunction(const String& name, bool query_imports) final;
 
+  /*!
+   * \brief Add another shard of the same build. This module imports it, provides its functions,
+   *  and is the environment its packed calls are looked up from.
+   * \param shard The LLVM module of the shard.
+   */
+  void AddShard(runtime::Module shard);
+
  private:
   void LazyInitJIT();
   bool IsCompatibleWithHost(const llvm::TargetMachine* tm) const;
@@ -123,6 +137,10 @@ class LLVMModuleNode final : public runtime::ModuleNode {
   std::unique_ptr<llvm::Module> module_owning_ptr_;
   /* \brief names of the functions declared in this module */
   Array<String> function_names_;
+  /* \brief The other shards of a sharded build, when this module is the first one. */
+  std::vector<runtime::Module> shards_;
+  /* \brief The first shard of a sharded build, when this module is another one. */
+  runtime::ModuleNode* env_module_{nullptr};
 };
 
 LLVMModuleNode::~LLVMModuleNode() {
@@ -164,7 +182,17 @@ PackedFunc LLVMModuleNode::GetFunction(const std::string& name,
   } else {
     faddr = reinterpret_cast<TVMBackendPackedCFunc>(GetFunctionAddr(name, *llvm_target));
   }
-  if (faddr == nullptr) return PackedFunc();
+  if (faddr == nullptr) {
+    // The functions of the other shards keep this module, their environment, alive.
+    for (runtime::Module& shard : shards_) {
+      PackedFunc pf = shard.GetFunction(name);
+      if (pf != nullptr) {
+        return PackedFunc(
+            [pf, sptr_to_self](TVMArgs args, TVMRetValue* rv) { pf.CallPacked(args, rv); });
+      }
+    }
+    return PackedFunc();
+  }
   return WrapPackedFunc(faddr, sptr_to_self);
 }
 
@@ -347,7 +375,20 @@ void LLVMModuleNode::LoadIR(const std::string& file_name) {
 }
 
 bool LLVMModuleNode::ImplementsFunction(const String& name, bool query_imports) {
-  return std::find(function_names_.begin(), function_names_.end(), name) != function_names_.end();
+  if (std::find(function_names_.begin(), function_names_.end(), name) != function_names_.end()) {
+    return true;
+  }
+  return std::any_of(shards_.begin(), shards_.end(), [&name](const runtime::Module& shard) {
+    return shard->ImplementsFunction(name, false);
+  });
+}
+
+void LLVMModuleNode::AddShard(runtime::Module shard) {
+  auto* node = static_cast<LLVMModuleNode*>(shard.operator->());
+  ICHECK(node->ee_ == nullptr) << "The shards must be added before their JIT is initialized";
+  node->env_module_ = this;
+  this->Import(shard);
+  shards_.push_back(shard);
 }
 
 void LLVMModuleNode::LazyInitJIT() {
@@ -377,7 +418,7 @@ void LLVMModuleNode::LazyInitJIT() {
 
   if (void** ctx_addr =
           reinterpret_cast<void**>(GetGlobalAddr(runtime::symbol::tvm_module_ctx, *llvm_target))) {
-    *ctx_addr = this;
+    *ctx_addr = env_module_ != nullptr ? env_module_ : this;
   }
   runtime::InitContextFunctions(
       [this, &llvm_target](const char* name) { return GetGlobalAddr(name, *llvm_target); });
@@ -420,12 +461,141 @@ void* LLVMModuleNode::GetFunctionAddr(const std::string& name,
   }
 }
 
-TVM_REGISTER_GLOBAL("target.build.llvm")
-    .set_body_typed([](IRModule mod, Target target) -> runtime::Module {
-      auto n = make_object<LLVMModuleNode>();
-      n->Init(mod, target);
-      return runtime::Module(n);
+TVM_REGISTER_PASS_CONFIG_OPTION("codegen.llvm.num_shards", Integer);
+
+/*!
+ * \brief Partition the PrimFuncs of \p mod into at most \p num_shards modules of balanced sizes.
+ *  The functions that refer to each other by symbol, e.g. through tvm_call_cpacked, stay in the
+ *  same module, so that the symbols of each shard resolve within it.
+ */
+std::vector<IRModule> PartitionIntoShards(const IRModule& mod, int num_shards) {
+  std::vector<std::pair<GlobalVar, PrimFunc>> funcs;
+  for (const auto& kv : mod->functions) {
+    if (const auto* prim_func = kv.second.as<PrimFuncNode>()) {
+      funcs.emplace_back(kv.first, GetRef<PrimFunc>(prim_func));
+    }
+  }
+  // The iteration order of the functions is not deterministic.
+  std::sort(funcs.begin(), funcs.end(), [](const auto& a, const auto& b) {
+    return a.first->name_hint < b.first->name_hint;
+  });
+  std::unordered_map<std::string, size_t> symbol_index;
+  for (size_t i = 0; i < funcs.size(); ++i) {
+    symbol_index[funcs[i].first->name_hint] = i;
+    if (auto global_symbol = funcs[i].second->GetAttr<String>(tvm::attr::kGlobalSymbol)) {
+      symbol_index[global_symbol.value()] = i;
+    }
+  }
+
+  std::vector<size_t> parent(funcs.size());
+  std::iota(parent.begin(), parent.end(), 0);
+  std::function<size_t(size_t)> find_root = [&](size_t i) {
+    return parent[i] == i ? i : parent[i] = find_root(parent[i]);
+  };
+  std::vector<int64_t> sizes(funcs.size(), 0);
+  for (size_t i = 0; i < funcs.size(); ++i) {
+    tir::PostOrderVisit(funcs[i].second->body, [&](const ObjectRef& node) {
+      ++sizes[i];
+      const auto* call = node.as<tir::CallNode>();
+      if (call == nullptr) return;
+      std::string callee;
+      if (const auto* gvar = call->op.as<GlobalVarNode>()) {
+        callee = gvar->name_hint;
+      } else if (!call->args.empty() &&
+                 (call->op.same_as(tir::builtin::tvm_call_packed_lowered()) ||
+                  call->op.same_as(tir::builtin::tvm_call_cpacked_lowered()) ||
+                  call->op.same_as(tir::builtin::tvm_call_packed()) ||
+                  call->op.same_as(tir::builtin::tvm_call_cpacked()) ||
+                  call->op.same_as(tir::builtin::call_extern()) ||
+                  call->op.same_as(tir::builtin::call_pure_extern()))) {
+        if (const auto* name = call->args[0].as<StringImmNode>()) {
+          callee = name->value;
+        }
+      }
+      auto it = symbol_index.find(callee);
+      if (it != symbol_index.end()) {
+        parent[find_root(i)] = find_root(it->second);
+      }
     });
+  }
+
+  // Place the largest groups of functions first, each into the smallest shard so far.
+  std::vector<std::vector<size_t>> groups;
+  std::unordered_map<size_t, size_t> group_of_root;
+  std::vector<int64_t> group_sizes;
+  for (size_t i = 0; i < funcs.size(); ++i) {
+    size_t root = find_root(i);
+    if (!group_of_root.count(root)) {
+      group_of_root[root] = groups.size();
+      groups.emplace_back();
+      group_sizes.push_back(0);
+    }
+    groups[group_of_root[root]].push_back(i);
+    group_sizes[group_of_root[root]] += sizes[i];
+  }
+  std::vector<size_t> order(groups.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](size_t a, size_t b) { return group_sizes[a] > group_sizes[b]; });
+  size_t num_modules = std::min(groups.size(), static_cast<size_t>(num_shards));
+  std::vector<Map<GlobalVar, BaseFunc>> shard_funcs(num_modules);
+  std::vector<int64_t> shard_sizes(num_modules, 0);
+  for (size_t group : order) {
+    size_t shard = std::min_element(shard_sizes.begin(), shard_sizes.end()) - shard_sizes.begin();
+    shard_sizes[shard] += group_sizes[group];
+    for (size_t i : groups[group]) {
+      shard_funcs[shard].Set(funcs[i].first, funcs[i].second);
+    }
+  }
+  std::vector<IRModule> shards;
+  for (const auto& functions : shard_funcs) {
+    shards.push_back(IRModule(functions, {}, {}, {}, mod->attrs));
+  }
+  return shards;
+}
+
+/*!
+ * \brief Build \p mod, sharded by the codegen.llvm.num_shards option of the pass context.
+ *
+ *  Each shard is generated and optimized on its own thread with its own LLVMContext. The first
+ *  shard imports the others, so that they are linked together by export_library, and provides
+ *  their functions when JIT compiled.
+ */
+runtime::Module BuildLLVM(IRModule mod, Target target) {
+  int num_shards = transform::PassContext::Current()
+                       ->GetConfig<Integer>("codegen.llvm.num_shards", Integer(1))
+                       .value()
+                       ->value;
+  CHECK_GE(num_shards, 1) << "ValueError: The number of LLVM shards must be positive, got "
+                          << num_shards;
+  relay::Runtime runtime =
+      mod->GetAttr<relay::Runtime>(tvm::attr::kRuntime).value_or(relay::Runtime::Create("cpp"));
+  // The system library and the C runtime register all the functions in one startup function, and
+  // the command line options of LLVM are global to the process.
+  bool shardable = num_shards > 1 && runtime->name != "crt" &&
+                   !runtime->GetAttr<Bool>("system-lib").value_or(Bool(false)) &&
+                   !target->GetAttr<Array<String>>("cl-opt").defined();
+  std::vector<IRModule> shards;
+  if (shardable) {
+    shards = PartitionIntoShards(mod, num_shards);
+  }
+  if (shards.size() <= 1) {
+    auto n = make_object<LLVMModuleNode>();
+    n->Init(mod, target);
+    return runtime::Module(n);
+  }
+  std::vector<ObjectPtr<LLVMModuleNode>> nodes(shards.size());
+  support::parallel_for(0, static_cast<int>(shards.size()), [&](int i) {
+    nodes[i] = make_object<LLVMModuleNode>();
+    nodes[i]->Init(shards[i], target);
+  });
+  for (size_t i = 1; i < nodes.size(); ++i) {
+    nodes[0]->AddShard(runtime::Module(nodes[i]));
+  }
+  return runtime::Module(nodes[0]);
+}
+
+TVM_REGISTER_GLOBAL("target.build.llvm").set_body_typed(BuildLLVM);
 
 TVM_REGISTER_GLOBAL("codegen.LLVMModuleCreate")
     .set_body_typed([](std::string target_str, std::string module_name) -> runtime::Module {
@@ -27,12 +27,27 @@
 #include <sys/stat.h>
 #endif
 #include <cuda_runtime.h>
+#include <dmlc/memory_io.h>
 #include <nvrtc.h>
+#include <tvm/ir/transform.h>
+#include <tvm/node/structural_hash.h>
+#include <tvm/support/parallel_for.h>
 
+#include <algorithm>
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "../../runtime/cuda/cuda_common.h"
 #include "../../runtime/cuda/cuda_module.h"
+#include "../../support/utils.h"
 #include "../build_common.h"
 #include "../source/codegen_cuda.h"
 
@@ -78,10 +93,8 @@ std::string FindCUDAIncludePath() {
   return cuda_include_path;
 }
 
-std::string NVRTCCompile(const std::string& code, bool include_path = false) {
-  std::vector<std::string> compile_params;
-  std::vector<const char*> param_cstrings{};
-  nvrtcProgram prog;
+/*! \brief The compute capability of the device 0, which NVRTC compiles for. */
+std::string NVRTCComputeCapability() {
   std::string cc = "30";
   int major, minor;
   cudaError_t e1 = cudaDeviceGetAttribute(&major, cudaDevAttrComputeCapabilityMajor, 0);
@@ -93,8 +106,15 @@ std::string NVRTCCompile(const std::string& code, bool include_path = false) {
     LOG(WARNING) << "cannot detect compute capability from your device, "
                  << "fall back to compute_30.";
   }
+  return cc;
+}
+
+std::string NVRTCCompile(const std::string& code, bool include_path = false) {
+  std::vector<std::string> compile_params;
+  std::vector<const char*> param_cstrings{};
+  nvrtcProgram prog;
 
-  compile_params.push_back("-arch=compute_" + cc);
+  compile_params.push_back("-arch=compute_" + NVRTCComputeCapability());
 
   if (include_path) {
     std::string include_option = "--include-path=" + FindCUDAIncludePath();
@@ -125,43 +145,179 @@ std::string NVRTCCompile(const std::string& code, bool include_path = false) {
   return ptx;
 }
 
-runtime::Module BuildCUDA(IRModule mod, Target target) {
+/*! \brief A unit of CUDA source compiled on its own, and the PTX or cubin it compiles to. */
+struct CUDACompileUnit {
+  /*! \brief The kernels of the unit. */
+  IRModule mod;
+  /*! \brief The CUDA source of the unit. */
+  std::string code;
+  /*! \brief Whether NVRTC needs the include path of CUDA to compile the source. */
+  bool need_include_path{false};
+  /*! \brief The compiled PTX or cubin. */
+  std::string data;
+  /*! \brief The format of the data, "ptx" or "cubin". */
+  std::string fmt;
+};
+
+/*!
+ * \brief Get the file caching the compiled CUDA source across the compilations, keyed by the
+ *  hash of the source, the target and the compiler.
+ * \return The path of the file, empty when "cuda.kernel_cache_dir" is not set.
+ */
+std::string CUDAKernelCachePath(const transform::PassContext& ctx, const std::string& key) {
+  Optional<String> cache_dir = ctx->GetConfig<String>("cuda.kernel_cache_dir");
+  if (!cache_dir.defined() || cache_dir.value().empty()) return "";
+  uint64_t hash = StructuralHash()(String(key));
+  std::ostringstream os;
+  os << cache_dir.value() << "/" << std::hex << std::setw(16) << std::setfill('0') << hash
+     << ".cuda_kernel";
+  return os.str();
+}
+
+/*!
+ * \brief Load a unit compiled by SaveCUDAKernel.
+ * \return Whether the file exists and caches the same key, rather than another one whose hash
+ *  collides.
+ */
+bool LoadCUDAKernel(const std::string& path, const std::string& key, CUDACompileUnit* unit) {
+  std::ifstream is(path, std::ios::in | std::ios::binary);
+  if (!is) return false;
+  std::string blob((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+  dmlc::MemoryStringStream strm(&blob);
+  std::string cached_key, fmt, data;
+  if (!strm.Read(&cached_key) || cached_key != key || !strm.Read(&fmt) || !strm.Read(&data)) {
+    return false;
+  }
+  VLOG(1) << "loaded the compiled CUDA kernels from " << path;
+  unit->fmt = std::move(fmt);
+  unit->data = std::move(data);
+  return true;
+}
+
+/*! \brief Save a compiled unit for the later compilations. */
+void SaveCUDAKernel(const std::string& path, const std::string& key,
+                    const CUDACompileUnit& unit) {
+  std::string blob;
+  dmlc::MemoryStringStream strm(&blob);
+  strm.Write(key);
+  strm.Write(unit.fmt);
+  strm.Write(unit.data);
+  // write then rename, so that the concurrent compilations never read a partial file
+  std::string tmp_path = path + "." + std::to_string(std::random_device()()) + ".tmp";
+  {
+    std::ofstream os(tmp_path, std::ios::out | std::ios::binary);
+    os.write(blob.data(), blob.size());
+    if (!os) {
+      LOG(WARNING) << "Cannot write the CUDA kernel cache " << tmp_path;
+      std::remove(tmp_path.c_str());
+      return;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+  }
+}
+
+/*!
+ * \brief Compile a unit with tvm_callback_cuda_compile when it is registered, with NVRTC
+ *  otherwise, through the disk cache of "cuda.kernel_cache_dir".
+ */
+void CompileCUDAUnit(const transform::PassContext& ctx, const Target& target,
+                     CUDACompileUnit* unit) {
   using tvm::runtime::Registry;
-  bool output_ssa = false;
-  CodeGenCUDA cg;
-  cg.Init(output_ssa);
+  const auto* f_compile = Registry::Get("tvm_callback_cuda_compile");
+  // The flags of the callback are not known here, its PTX and cubin depend on the target only.
+  std::string compiler = f_compile != nullptr
+                             ? "tvm_callback_cuda_compile"
+                             : "nvrtc -arch=compute_" + NVRTCComputeCapability() +
+                                   (unit->need_include_path ? " -I" : "");
+  std::string key = compiler + "\n" + target->str() + "\n" + unit->code;
+  std::string cache_path = CUDAKernelCachePath(ctx, key);
+  if (!cache_path.empty() && LoadCUDAKernel(cache_path, key, unit)) return;
 
+  // The target scope is thread local, enter it on the thread compiling the unit.
+  const auto* f_enter = Registry::Get("target.TargetEnterScope");
+  (*f_enter)(target);
+  unit->fmt = "ptx";
+  if (f_compile != nullptr) {
+    unit->data = (*f_compile)(unit->code).operator std::string();
+    // Dirty matching to check PTX vs cubin.
+    // TODO(tqchen) more reliable checks
+    if (unit->data[0] != '/') unit->fmt = "cubin";
+  } else {
+    unit->data = NVRTCCompile(unit->code, unit->need_include_path);
+  }
+  const auto* f_exit = Registry::Get("target.TargetExitScope");
+  (*f_exit)(target);
+  if (!cache_path.empty()) {
+    SaveCUDAKernel(cache_path, key, *unit);
+  }
+}
+
+runtime::Module BuildCUDA(IRModule mod, Target target) {
+  using tvm::runtime::Registry;
+  transform::PassContext ctx = transform::PassContext::Current();
+  bool per_kernel = ctx->GetConfig<Bool>("cuda.compile_per_kernel", Bool(false)).value();
+  std::vector<std::pair<GlobalVar, PrimFunc>> funcs;
   for (auto kv : mod->functions) {
     ICHECK(kv.second->IsInstance<PrimFuncNode>()) << "CodeGenCUDA: Can only take PrimFunc";
     auto f = Downcast<PrimFunc>(kv.second);
     auto calling_conv = f->GetAttr<Integer>(tvm::attr::kCallingConv);
     ICHECK(calling_conv == CallingConv::kDeviceKernelLaunch)
         << "CodeGenCUDA: expect calling_conv equals CallingConv::kDeviceKernelLaunch";
-    cg.AddFunction(f);
+    funcs.emplace_back(kv.first, f);
   }
 
-  std::string code = cg.Finish();
+  std::vector<CUDACompileUnit> units;
+  if (per_kernel && funcs.size() > 1) {
+    // The iteration order of the functions is not deterministic.
+    std::sort(funcs.begin(), funcs.end(), [](const auto& a, const auto& b) {
+      return a.first->name_hint < b.first->name_hint;
+    });
+    for (const auto& kv : funcs) {
+      Map<GlobalVar, BaseFunc> functions;
+      functions.Set(kv.first, kv.second);
+      CUDACompileUnit unit;
+      unit.mod = IRModule(functions, {}, {}, {}, mod->attrs);
+      units.push_back(std::move(unit));
+    }
+  } else {
+    CUDACompileUnit unit;
+    unit.mod = mod;
+    units.push_back(std::move(unit));
+  }
 
-  if (const auto* f = Registry::Get("tvm_callback_cuda_postproc")) {
-    code = (*f)(code).operator std::string();
+  for (CUDACompileUnit& unit : units) {
+    bool output_ssa = false;
+    CodeGenCUDA cg;
+    cg.Init(output_ssa);
+    for (auto kv : unit.mod->functions) {
+      cg.AddFunction(Downcast<PrimFunc>(kv.second));
+    }
+    unit.code = cg.Finish();
+    unit.need_include_path = cg.need_include_path();
+    if (const auto* f = Registry::Get("tvm_callback_cuda_postproc")) {
+      unit.code = (*f)(unit.code).operator std::string();
+    }
   }
-  std::string fmt = "ptx";
-  std::string ptx;
-  const auto* f_enter = Registry::Get("target.TargetEnterScope");
-  (*f_enter)(target);
-  if (const auto* f = Registry::Get("tvm_callback_cuda_compile")) {
-    ptx = (*f)(code).operator std::string();
-    // Dirty matching to check PTX vs cubin.
-    // TODO(tqchen) more reliable checks
-    if (ptx[0] != '/') fmt = "cubin";
-  } else {
-    ptx = NVRTCCompile(code, cg.need_include_path());
+  // nvcc runs in its own process and NVRTC is thread safe, so the units compile concurrently.
+  support::parallel_for(0, static_cast<int>(units.size()),
+                        [&](int i) { CompileCUDAUnit(ctx, target, &units[i]); });
+
+  // The first unit imports the others, the host module finds their kernels among its imports.
+  std::vector<runtime::Module> modules;
+  for (const CUDACompileUnit& unit : units) {
+    modules.push_back(CUDAModuleCreate(unit.data, unit.fmt, ExtractFuncInfo(unit.mod), unit.code));
   }
-  const auto* f_exit = Registry::Get("target.TargetExitScope");
-  (*f_exit)(target);
-  return CUDAModuleCreate(ptx, fmt, ExtractFuncInfo(mod), code);
+  for (size_t i = 1; i < modules.size(); ++i) {
+    modules[0].Import(modules[i]);
+  }
+  return modules[0];
 }
 
+TVM_REGISTER_PASS_CONFIG_OPTION("cuda.compile_per_kernel", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("cuda.kernel_cache_dir", String);
+
 TVM_REGISTER_GLOBAL("target.build.cuda").set_body_typed(BuildCUDA);
 }  // namespace codegen
 }  // namespace tvm
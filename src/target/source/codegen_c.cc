@@ -23,6 +23,7 @@
 #include "codegen_c.h"
 
 #include <tvm/arith/analyzer.h>
+#include <tvm/ir/transform.h>
 
 #include <cctype>
 #include <iomanip>
@@ -645,16 +646,35 @@ void CodeGenC::VisitStmt_(const AllocateConstNode* op) {
               << "#endif\n"
               << "static const ";
 
-  PrintType(data.DataType(), decl_stream);
-
-  // Allocate the global static variable
-  decl_stream << " __attribute__((section(\".rodata.tvm\"), "
-              << "aligned(" << constants_byte_alignment_->value << "))) " << symbol_name << "["
-              << num_elements << "] = {\n";
-  NDArrayDataToC(data, 4, decl_stream);
+  bool as_blob = transform::PassContext::Current()
+                     ->GetConfig<Bool>("codegen.link_params_as_blob", Bool(false))
+                     .value();
+  if (as_blob) {
+    // The raw bytes as a string literal, with room for its terminating NUL in C++, accessed
+    // through a pointer of the element type.
+    size_t num_bytes = runtime::GetDataSize(*data.operator->());
+    decl_stream << "unsigned char __attribute__((section(\".rodata.tvm\"), "
+                << "aligned(" << constants_byte_alignment_->value << "))) " << symbol_name
+                << "_bytes[" << num_bytes + 1 << "] =\n";
+    NDArrayDataToCString(data, 4, decl_stream);
+    decl_stream << ";\n"
+                << "static const ";
+    PrintType(data.DataType(), decl_stream);
+    decl_stream << "* const " << symbol_name << " = (const ";
+    PrintType(data.DataType(), decl_stream);
+    decl_stream << "*)" << symbol_name << "_bytes;\n";
+  } else {
+    PrintType(data.DataType(), decl_stream);
+
+    // Allocate the global static variable
+    decl_stream << " __attribute__((section(\".rodata.tvm\"), "
+                << "aligned(" << constants_byte_alignment_->value << "))) " << symbol_name << "["
+                << num_elements << "] = {\n";
+    NDArrayDataToC(data, 4, decl_stream);
+    decl_stream << "};\n";
+  }
 
-  decl_stream << "};\n"
-              << "#ifdef __cplusplus\n"
+  decl_stream << "#ifdef __cplusplus\n"
               << "}  // extern \"C\"\n"
               << "#endif\n";
   var_idmap_[op->buffer_var.operator->()] = symbol_name;
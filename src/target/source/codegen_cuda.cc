@@ -442,6 +442,19 @@ void CodeGenCUDA::PrintVecElemLoad(const std::string& vec, DataType t, int i,
     return;
   }
 
+  if (t.bits() == 4 && (t.is_int() || t.is_uint())) {
+    // The 4-bit lanes are packed in an int16_t or an int, see PrintType. Extracting them one by
+    // one lets a cast unpack the packed weights without going through the memory.
+    ICHECK((t.lanes() == 4 || t.lanes() == 8) && i >= 0 && i < t.lanes())
+        << "Cannot access lane " << i << " of " << t;
+    if (t.is_int()) {
+      os << "(((int)((uint)(" << vec << ") << " << 28 - i * 4 << ")) >> 28)";
+    } else {
+      os << "(((uint)(" << vec << ") >> " << i * 4 << ") & 0xF)";
+    }
+    return;
+  }
+
   static const char access[] = {'x', 'y', 'z', 'w'};
   ICHECK(i >= 0 && i < (t.bits() == 8 ? 16 : (t.bits() == 16 || t.bits() == 32) ? 8 : 4));
   if (t.bits() == 8 && (t.is_int() || t.is_uint())) {
@@ -25,6 +25,7 @@
 
 #include <dlpack/dlpack.h>
 
+#include <algorithm>
 #include <cmath>
 #include <iomanip>
 #include <memory>
@@ -247,5 +248,32 @@ void NDArrayDataToC(::tvm::runtime::NDArray arr, int indent_chars, std::ostream&
   os.flags(old_fmtflags);
 }
 
+void NDArrayDataToCString(::tvm::runtime::NDArray arr, int indent_chars, std::ostream& os,
+                          const std::string& eol) {
+  CHECK(arr.IsContiguous()) << "CodegenParams: only support contiguous arrays";
+  size_t num_bytes = runtime::GetDataSize(*arr.operator->());
+  const uint8_t* data = static_cast<const uint8_t*>(arr->data) + arr->byte_offset;
+  // Each byte is a 4-char octal escape, the row is enclosed in quotes.
+  size_t bytes_per_row = ComputeNumElementsPerRow(4, indent_chars + 2);
+  std::string indent_str(indent_chars, ' ');
+  static const char* kDigits = "01234567";
+
+  if (num_bytes == 0) {
+    os << indent_str << "\"\"" << eol;
+    return;
+  }
+  for (size_t i = 0; i < num_bytes; i += bytes_per_row) {
+    std::string row = indent_str + "\"";
+    for (size_t j = i; j < std::min(num_bytes, i + bytes_per_row); ++j) {
+      row.push_back('\\');
+      row.push_back(kDigits[(data[j] >> 6) & 7]);
+      row.push_back(kDigits[(data[j] >> 3) & 7]);
+      row.push_back(kDigits[data[j] & 7]);
+    }
+    row.push_back('"');
+    os << row << eol;
+  }
+}
+
 }  // namespace codegen
 }  // namespace tvm
@@ -48,6 +48,22 @@ namespace codegen {
 void NDArrayDataToC(::tvm::runtime::NDArray arr, int indent_chars, std::ostream& os,
                     const std::string& eol = "\n");
 
+/*!
+ * \brief Write the raw bytes of arr to os as an indented C string literal.
+ *
+ * The bytes are written as octal escapes split over several adjacent literals, which C compilers
+ * scan much faster than the list of NDArrayDataToC, so that the time to compile the parameters
+ * does not grow with their number of elements. For the uint8_t NDArray [0, 1, 2], and
+ * indent_chars = 4, the following output is produced:
+ *     "\000\001\002"
+ *
+ * \param arr The array to generate
+ * \param indent_chars Number of chars to indent
+ * \param os Output stream where the array data should be written.
+ */
+void NDArrayDataToCString(::tvm::runtime::NDArray arr, int indent_chars, std::ostream& os,
+                          const std::string& eol = "\n");
+
 }  // namespace codegen
 }  // namespace tvm
 
@@ -43,7 +43,7 @@ struct CUDAMath {
         case 16: {
           if (name == "fabs") {
             return "__habs";
-          } else if (name == "round") {
+          } else if (name == "round" || name == "nearbyint") {
             return "hrint";
           } else {
             return "h" + name;
@@ -148,6 +148,9 @@ TVM_REGISTER_OP("tir.fabs")
 TVM_REGISTER_OP("tir.round")
     .set_attr<FLowerIntrinsic>("cuda.FLowerIntrinsic", DispatchPureExtern<CUDAMath>);
 
+TVM_REGISTER_OP("tir.nearbyint")
+    .set_attr<FLowerIntrinsic>("cuda.FLowerIntrinsic", DispatchPureExtern<CUDAMath>);
+
 TVM_REGISTER_OP("tir.exp").set_attr<FLowerIntrinsic>("cuda.FLowerIntrinsic",
                                                      DispatchPureExtern<CUDAFastMath>);
 
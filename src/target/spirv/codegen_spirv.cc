@@ -27,6 +27,8 @@
 #include <tvm/tir/expr.h>
 #include <tvm/tir/op.h>
 
+#include <array>
+#include <sstream>
 #include <string>
 
 #include "../../runtime/pack_args.h"
@@ -37,7 +39,9 @@
 namespace tvm {
 namespace codegen {
 
-CodeGenSPIRV::CodeGenSPIRV(Target target) : spirv_support_(target) {}
+CodeGenSPIRV::CodeGenSPIRV(Target target)
+    : spirv_support_(target),
+      warp_size_(target->GetAttr<Integer>("thread_warp_size", 1).value().IntValue()) {}
 
 runtime::VulkanShader CodeGenSPIRV::BuildFunction(const PrimFunc& f, const std::string& name) {
   this->InitFuncState();
@@ -126,6 +130,9 @@ void CodeGenSPIRV::InitFuncState() {
   std::fill(workgroup_size_, workgroup_size_ + 3, 1);
   var_map_.clear();
   storage_info_.clear();
+  fragment_shapes_.clear();
+  fragment_layouts_.clear();
+  fragment_info_.clear();
   analyzer_.reset(new arith::Analyzer());
   builder_.reset(new spirv::IRBuilder(spirv_support_));
   builder_->InitHeader();
@@ -183,6 +190,153 @@ spirv::Value CodeGenSPIRV::CreateStorageSync(const CallNode* op) {
   return value;
 }
 
+spirv::Value CodeGenSPIRV::CreateWarpShuffle(const CallNode* op) {
+  ICHECK_EQ(op->args.size(), 5U);
+  // The mask is implied by the active invocations of the subgroup, and the shuffles span
+  // the whole subgroup.
+  const auto* width = op->args[3].as<IntImmNode>();
+  ICHECK(width && width->value == warp_size_)
+      << "Vulkan only supports warp shuffles over the whole subgroup of " << warp_size_
+      << " invocations, but got a width of " << op->args[3];
+  spv::Op spv_op;
+  if (op->op.same_as(builtin::tvm_warp_shuffle())) {
+    spv_op = spv::OpGroupNonUniformShuffle;
+  } else if (op->op.same_as(builtin::tvm_warp_shuffle_up())) {
+    spv_op = spv::OpGroupNonUniformShuffleUp;
+  } else {
+    spv_op = spv::OpGroupNonUniformShuffleDown;
+  }
+  return builder_->SubgroupShuffle(spv_op, MakeValue(op->args[1]), MakeValue(op->args[2]));
+}
+
+// Parse the "m, n, k" of a fragment_shape attribute.
+static std::array<uint32_t, 3> ParseFragmentShape(const std::string& shape) {
+  std::array<uint32_t, 3> dims;
+  char sep0 = 0, sep1 = 0;
+  std::istringstream is(shape);
+  is >> dims[0] >> sep0 >> dims[1] >> sep1 >> dims[2];
+  ICHECK(is && sep0 == ',' && sep1 == ',') << "Invalid fragment shape \"" << shape << "\"";
+  return dims;
+}
+
+void CodeGenSPIRV::AllocateFragment(const AllocateNode* op, const std::string& scope) {
+  const VarNode* buffer = op->buffer_var.get();
+  auto it = fragment_shapes_.find(buffer);
+  ICHECK(it != fragment_shapes_.end())
+      << "The wmma fragment " << buffer->name_hint << " has no fragment_shape";
+  std::array<uint32_t, 3> mnk = ParseFragmentShape(it->second);
+  uint32_t rows, cols;
+  spirv::CooperativeMatrixUse use;
+  if (scope == "wmma.matrix_a") {
+    rows = mnk[0], cols = mnk[2], use = spirv::CooperativeMatrixUse::kMatrixA;
+  } else if (scope == "wmma.matrix_b") {
+    rows = mnk[2], cols = mnk[1], use = spirv::CooperativeMatrixUse::kMatrixB;
+  } else {
+    ICHECK_EQ(scope, "wmma.accumulator") << "Unknown wmma scope " << scope;
+    rows = mnk[0], cols = mnk[1], use = spirv::CooperativeMatrixUse::kAccumulator;
+  }
+  size_t constant_size = op->ConstantAllocationSize();
+  ICHECK_EQ(constant_size % (rows * cols), 0U)
+      << "The wmma fragment " << buffer->name_hint << " of " << constant_size
+      << " elements is not made of " << rows << "x" << cols << " matrices";
+
+  FragmentInfo& info = fragment_info_[buffer];
+  info.matrix_type = builder_->GetCooperativeMatrixType(op->dtype, rows, cols, use);
+  info.matrices = builder_->AllocateCooperativeMatrices(
+      info.matrix_type, static_cast<uint32_t>(constant_size / (rows * cols)));
+  builder_->SetName(info.matrices, buffer->name_hint);
+}
+
+spirv::Value CodeGenSPIRV::GetFragmentMatrix(const PrimExpr& buffer_var, const PrimExpr& index,
+                                             spirv::SType* matrix_type) {
+  const auto* buffer = buffer_var.as<VarNode>();
+  ICHECK(buffer) << "Expected the data of a wmma fragment, but got " << buffer_var;
+  auto it = fragment_info_.find(buffer);
+  ICHECK(it != fragment_info_.end()) << "Cannot find the wmma fragment " << buffer->name_hint;
+  *matrix_type = it->second.matrix_type;
+  return builder_->CooperativeMatrixAccess(it->second.matrix_type, it->second.matrices,
+                                           MakeValue(analyzer_->Simplify(index)));
+}
+
+spirv::Value CodeGenSPIRV::GetElementPtr(const PrimExpr& ptr) {
+  const auto* call = ptr.as<CallNode>();
+  ICHECK(call) << "Expected tvm_access_ptr or address_of, but got " << ptr;
+  Var buffer_var;
+  PrimExpr index;
+  DataType element_type;
+  if (call->op.same_as(builtin::tvm_access_ptr())) {
+    ICHECK_EQ(call->args.size(), 5U);
+    element_type = call->args[0].dtype();
+    buffer_var = Downcast<Var>(call->args[1]);
+    index = call->args[2];
+  } else {
+    ICHECK(call->op.same_as(builtin::address_of()))
+        << "Expected tvm_access_ptr or address_of, but got " << ptr;
+    const auto* load = call->args[0].as<BufferLoadNode>();
+    ICHECK(load && load->indices.size() == 1) << "address_of expects a flat BufferLoad";
+    element_type = load->dtype;
+    buffer_var = load->buffer->data;
+    index = load->indices[0];
+  }
+  ICHECK_EQ(element_type.lanes(), 1)
+      << "The cooperative matrices can only access buffers of scalars";
+  auto it = storage_info_.find(buffer_var.get());
+  ICHECK(it != storage_info_.end());
+  StorageInfo& info = it->second;
+  if (!info.element_type_known) {
+    info.SetContentType(element_type, buffer_var->name_hint);
+  }
+  info.CheckContentType(element_type);
+  spirv::SType content_type = builder_->GetSType(element_type);
+  spirv::Value buffer = MakeValue(buffer_var);
+  spirv::SType ptr_type = builder_->GetPointerType(content_type, buffer.stype.storage_class);
+  return builder_->StructArrayAccess(ptr_type, buffer, MakeValue(analyzer_->Simplify(index)));
+}
+
+spirv::Value CodeGenSPIRV::CreateCooperativeMatrixOp(const CallNode* op) {
+  spirv::SType matrix_type;
+  auto is_col_major = [](const PrimExpr& layout) {
+    const auto* str = layout.as<StringImmNode>();
+    ICHECK(str && (str->value == "row_major" || str->value == "col_major"))
+        << "Invalid wmma layout " << layout;
+    return str->value == "col_major";
+  };
+  if (op->op.same_as(builtin::tvm_fill_fragment())) {
+    ICHECK_EQ(op->args.size(), 6U);
+    spirv::Value dst = GetFragmentMatrix(op->args[0], op->args[4], &matrix_type);
+    spirv::Value value =
+        builder_->Cast(builder_->GetSType(matrix_type.type), MakeValue(op->args[5]));
+    // A cooperative matrix is constructed from the one value of all its elements.
+    builder_->MakeInst(spv::OpStore, dst,
+                       builder_->MakeValue(spv::OpCompositeConstruct, matrix_type, value));
+  } else if (op->op.same_as(builtin::tvm_load_matrix_sync())) {
+    ICHECK_EQ(op->args.size(), 8U);
+    spirv::Value dst = GetFragmentMatrix(op->args[0], op->args[4], &matrix_type);
+    spirv::Value matrix =
+        builder_->CooperativeMatrixLoad(matrix_type, GetElementPtr(op->args[5]),
+                                        MakeValue(op->args[6]), is_col_major(op->args[7]));
+    builder_->MakeInst(spv::OpStore, dst, matrix);
+  } else if (op->op.same_as(builtin::tvm_store_matrix_sync())) {
+    ICHECK_EQ(op->args.size(), 8U);
+    spirv::Value src = GetFragmentMatrix(op->args[0], op->args[4], &matrix_type);
+    spirv::Value matrix = builder_->MakeValue(spv::OpLoad, matrix_type, src);
+    builder_->CooperativeMatrixStore(GetElementPtr(op->args[5]), matrix, MakeValue(op->args[6]),
+                                     is_col_major(op->args[7]));
+  } else {
+    ICHECK(op->op.same_as(builtin::tvm_mma_sync()));
+    ICHECK_EQ(op->args.size(), 8U);
+    std::array<spirv::Value, 3> inputs;
+    for (int i = 0; i < 3; ++i) {
+      spirv::Value src = GetFragmentMatrix(op->args[i * 2 + 2], op->args[i * 2 + 3], &matrix_type);
+      inputs[i] = builder_->MakeValue(spv::OpLoad, matrix_type, src);
+    }
+    spirv::Value dst = GetFragmentMatrix(op->args[0], op->args[1], &matrix_type);
+    builder_->MakeInst(spv::OpStore, dst,
+                       builder_->CooperativeMatrixMulAdd(inputs[0], inputs[1], inputs[2]));
+  }
+  return spirv::Value();
+}
+
 spirv::Value CodeGenSPIRV::VisitExpr_(const VarNode* op) {
   auto it = var_map_.find(op);
   ICHECK(it != var_map_.end()) << "cannot find variable " << op->name_hint;
@@ -350,6 +504,18 @@ spirv::Value CodeGenSPIRV::VisitExpr_(const CallNode* op) {
     return builder_->UIntImm(builder_->GetSType(op->dtype), val);
   } else if (op->op.same_as(builtin::tvm_storage_sync())) {
     return this->CreateStorageSync(op);
+  } else if (op->op.same_as(builtin::tvm_warp_shuffle()) ||
+             op->op.same_as(builtin::tvm_warp_shuffle_up()) ||
+             op->op.same_as(builtin::tvm_warp_shuffle_down())) {
+    return this->CreateWarpShuffle(op);
+  } else if (op->op.same_as(builtin::tvm_warp_activemask())) {
+    // The subgroup shuffles ignore the mask, see CreateWarpShuffle.
+    return builder_->UIntImm(builder_->GetSType(op->dtype), 0xFFFFFFFFU);
+  } else if (op->op.same_as(builtin::tvm_fill_fragment()) ||
+             op->op.same_as(builtin::tvm_load_matrix_sync()) ||
+             op->op.same_as(builtin::tvm_store_matrix_sync()) ||
+             op->op.same_as(builtin::tvm_mma_sync())) {
+    return this->CreateCooperativeMatrixOp(op);
   } else if (op->op.same_as(builtin::if_then_else())) {
     ICHECK_EQ(op->args.size(), 3U);
     spirv::Value cond = MakeValue(op->args[0]);
@@ -659,8 +825,16 @@ void CodeGenSPIRV::VisitStmt_(const AllocateNode* op) {
   size_t constant_size = op->ConstantAllocationSize();
   ICHECK_GT(constant_size, 0) << "Can only handle constant size stack allocation in GPU";
 
+  std::string scope = GetPtrStorageScope(op->buffer_var);
+  if (scope.find("wmma.") == 0) {
+    // The wmma fragments are not addressable, they are arrays of cooperative matrices.
+    AllocateFragment(op, scope);
+    this->VisitStmt(op->body);
+    return;
+  }
+
   spirv::Value buf;
-  auto storage_scope = runtime::StorageScope::Create(GetPtrStorageScope(op->buffer_var));
+  auto storage_scope = runtime::StorageScope::Create(scope);
   spirv::SType etype = builder_->GetSType(op->dtype);
   if (storage_scope.rank == runtime::StorageRank::kLocal) {
     buf =
@@ -703,6 +877,16 @@ void CodeGenSPIRV::VisitStmt_(const AttrStmtNode* op) {
     const VarNode* v = op->node.as<VarNode>();
     ICHECK(v);
     storage_info_[v].is_volatile = true;
+  } else if (op->attr_key == tir::attr::fragment_shape) {
+    const VarNode* buffer = op->node.as<VarNode>();
+    const StringImmNode* shape_str = op->value.as<StringImmNode>();
+    ICHECK(buffer && shape_str);
+    fragment_shapes_[buffer] = shape_str->value;
+  } else if (op->attr_key == tir::attr::fragment_layout) {
+    const VarNode* buffer = op->node.as<VarNode>();
+    const StringImmNode* layout_str = op->value.as<StringImmNode>();
+    ICHECK(buffer && layout_str);
+    fragment_layouts_[buffer] = layout_str->value;
   }
   this->VisitStmt(op->body);
 }
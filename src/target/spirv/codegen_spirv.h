@@ -171,12 +171,30 @@ class CodeGenSPIRV : public ExprFunctor<spirv::Value(const PrimExpr&)>,
       element_type_known = true;
     }
   };
+  /*! \brief The cooperative matrices backing a wmma fragment buffer */
+  struct FragmentInfo {
+    /*! \brief The type of each matrix */
+    spirv::SType matrix_type;
+    /*! \brief The pointer to the array of matrices */
+    spirv::Value matrices;
+  };
   // Reset the state so it works for a new function.
   void InitFuncState();
   // Get the thread index
   spirv::Value GetThreadIndex(const IterVar& iv, const PrimExpr& extent);
 
   spirv::Value CreateStorageSync(const CallNode* op);
+  // Lower the subgroup shuffles of the warp intrinsics
+  spirv::Value CreateWarpShuffle(const CallNode* op);
+  // Lower the wmma intrinsics to cooperative matrix operations
+  spirv::Value CreateCooperativeMatrixOp(const CallNode* op);
+  // Allocate the cooperative matrices of a wmma fragment buffer
+  void AllocateFragment(const AllocateNode* op, const std::string& scope);
+  // Get the pointer to the index-th matrix of a wmma fragment buffer
+  spirv::Value GetFragmentMatrix(const PrimExpr& buffer_var, const PrimExpr& index,
+                                 spirv::SType* matrix_type);
+  // Get the pointer to the element addressed by tvm_access_ptr or address_of
+  spirv::Value GetElementPtr(const PrimExpr& ptr);
   void Scalarize(const PrimExpr& e, std::function<void(int i, spirv::Value v)> f);
 
   // SPIRV-related capabilities of the target
@@ -188,6 +206,9 @@ class CodeGenSPIRV : public ExprFunctor<spirv::Value(const PrimExpr&)>,
   // Work group size of three
   uint32_t workgroup_size_[3];
 
+  // The subgroup size the kernels are built for
+  int warp_size_{1};
+
   // Likely branch
   uint32_t weight_likely_branch_{128};
 
@@ -215,6 +236,13 @@ class CodeGenSPIRV : public ExprFunctor<spirv::Value(const PrimExpr&)>,
   // binding of let variables. Enables duplicate var defs that map to same value
   std::unordered_map<Var, const LetNode*, ObjectPtrHash, ObjectPtrEqual> let_binding_;
 
+  // The shape and the layout of the wmma fragments
+  std::unordered_map<const VarNode*, std::string> fragment_shapes_;
+  std::unordered_map<const VarNode*, std::string> fragment_layouts_;
+
+  // The cooperative matrices of the wmma fragments
+  std::unordered_map<const VarNode*, FragmentInfo> fragment_info_;
+
   // Running total of the number of bytes of shared memory used.
   // Checked against the max_shared_memory_per_group
   size_t shared_memory_bytes_used_{0};
@@ -38,8 +38,9 @@ void IRBuilder::InitHeader() {
   header_.push_back(spv::MagicNumber);
 
   // Target SPIR-V version 1.0.  Additional functionality will be
-  // enabled through extensions.
-  header_.push_back(0x10000);
+  // enabled through extensions.  The instructions that are only core
+  // in a later version raise spirv_version_, set during Finalize.
+  header_.push_back(spirv_version_);
 
   // generator: set to 0, unknown
   header_.push_back(0U);
@@ -83,8 +84,10 @@ void IRBuilder::InitPreDefs() {
 
 std::vector<uint32_t> IRBuilder::Finalize() {
   std::vector<uint32_t> data;
-  // Index for upper bound of id numbers.
+  // Index for the version and the upper bound of id numbers.
+  const int kVersionLoc = 1;
   const int kBoundLoc = 3;
+  header_[kVersionLoc] = spirv_version_;
   header_[kBoundLoc] = id_counter_;
   data.insert(data.end(), header_.begin(), header_.end());
   for (const auto& capability : capabilities_used_) {
@@ -641,6 +644,144 @@ Value IRBuilder::CallKHRIntegerDotProduct(const SType& ret_type, const std::vect
   return val;
 }
 
+Value IRBuilder::SubgroupShuffle(spv::Op op, Value value, Value index) {
+  // The non-uniform group instructions are core in SPIR-V 1.3, provided by Vulkan 1.1.
+  ICHECK_GE(spirv_support_.vulkan_api_version, VK_API_VERSION_1_1)
+      << "Vulkan target does not support subgroup operations, which need Vulkan 1.1.  "
+      << "Please add -vulkan_api_version=1.1 to the target, "
+      << "or query all device parameters by adding -from_device=0.";
+  uint32_t feature = 0;
+  if (op == spv::OpGroupNonUniformShuffle) {
+    feature = VK_SUBGROUP_FEATURE_SHUFFLE_BIT;
+    capabilities_used_.insert(spv::CapabilityGroupNonUniformShuffle);
+  } else {
+    ICHECK(op == spv::OpGroupNonUniformShuffleUp || op == spv::OpGroupNonUniformShuffleDown)
+        << "Unsupported subgroup shuffle " << op;
+    feature = VK_SUBGROUP_FEATURE_SHUFFLE_RELATIVE_BIT;
+    capabilities_used_.insert(spv::CapabilityGroupNonUniformShuffleRelative);
+  }
+  ICHECK(spirv_support_.supported_subgroup_operations & feature)
+      << "Vulkan target does not support the subgroup shuffle operations.  "
+      << "If your device supports them, "
+      << "please either add -supported_subgroup_operations=NBITS to the target, "
+      << "or query all device parameters by adding -from_device=0.";
+  capabilities_used_.insert(spv::CapabilityGroupNonUniform);
+  spirv_version_ = std::max(spirv_version_, 0x10300U);
+
+  // The invocation id and the delta are unsigned.
+  if (index.stype.id != t_uint32_.id) {
+    index = Cast(t_uint32_, index);
+  }
+  Value scope = UIntImm(t_uint32_, spv::ScopeSubgroup);
+  return MakeValue(op, value.stype, scope, value, index);
+}
+
+SType IRBuilder::GetCooperativeMatrixType(const DataType& dtype, uint32_t rows, uint32_t cols,
+                                          CooperativeMatrixUse use) {
+  SType elem_type = GetSType(dtype);
+  auto key = std::make_tuple(elem_type.id, rows, cols, static_cast<uint32_t>(use));
+  auto it = cooperative_matrix_type_tbl_.find(key);
+  if (it != cooperative_matrix_type_tbl_.end()) {
+    return it->second;
+  }
+  SType t;
+#ifdef TVM_SPIRV_KHR_COOPERATIVE_MATRIX
+  ICHECK(spirv_support_.supports_cooperative_matrix)
+      << "Vulkan target does not support cooperative matrix capability.  "
+      << "If your device supports cooperative matrix operations, "
+      << "please either add -supports_cooperative_matrix=1 to the target, "
+      << "or query all device parameters by adding -from_device=0.";
+  capabilities_used_.insert(spv::CapabilityCooperativeMatrixKHR);
+  extensions_used_.insert("SPV_KHR_cooperative_matrix");
+  spirv_version_ = std::max(spirv_version_, 0x10300U);
+
+  t.id = id_counter_++;
+  t.type = dtype;
+  t.element_type_id = elem_type.id;
+  ib_.Begin(spv::OpTypeCooperativeMatrixKHR)
+      .AddSeq(t, elem_type, UIntImm(t_uint32_, spv::ScopeSubgroup), UIntImm(t_uint32_, rows),
+              UIntImm(t_uint32_, cols), UIntImm(t_uint32_, static_cast<uint32_t>(use)))
+      .Commit(&global_);
+#else
+  LOG(FATAL) << "Please turn on USE_SPIRV_KHR_COOPERATIVE_MATRIX in config.cmake";
+#endif
+  cooperative_matrix_type_tbl_[key] = t;
+  return t;
+}
+
+Value IRBuilder::AllocateCooperativeMatrices(const SType& matrix_type, uint32_t num_matrices) {
+  ICHECK_NE(num_matrices, 0U);
+  auto key = std::make_pair(matrix_type.id, num_matrices);
+  auto it = cooperative_matrix_array_tbl_.find(key);
+  SType arr_type;
+  if (it != cooperative_matrix_array_tbl_.end()) {
+    arr_type = it->second;
+  } else {
+    // The cooperative matrices have no size, the array is neither decorated with a stride
+    // nor wrapped in a struct, as they only live in the function storage.
+    arr_type.id = id_counter_++;
+    arr_type.type = DataType::Handle();
+    arr_type.element_type_id = matrix_type.id;
+    Value length = UIntImm(t_uint32_, num_matrices);
+    ib_.Begin(spv::OpTypeArray).AddSeq(arr_type, matrix_type, length).Commit(&global_);
+    cooperative_matrix_array_tbl_[key] = arr_type;
+  }
+  SType ptr_type = GetPointerType(arr_type, spv::StorageClassFunction);
+  Value val = NewValue(ptr_type, kNormal);
+  ib_.Begin(spv::OpVariable)
+      .AddSeq(ptr_type, val, spv::StorageClassFunction)
+      .Commit(&func_header_);
+  return val;
+}
+
+Value IRBuilder::CooperativeMatrixAccess(const SType& matrix_type, Value matrices, Value index) {
+  SType ptr_type = GetPointerType(matrix_type, spv::StorageClassFunction);
+  return MakeValue(spv::OpInBoundsAccessChain, ptr_type, matrices, index);
+}
+
+Value IRBuilder::CooperativeMatrixLoad(const SType& matrix_type, Value ptr, Value stride,
+                                       bool col_major) {
+#ifdef TVM_SPIRV_KHR_COOPERATIVE_MATRIX
+  Value layout = UIntImm(t_uint32_, col_major ? spv::CooperativeMatrixLayoutColumnMajorKHR
+                                              : spv::CooperativeMatrixLayoutRowMajorKHR);
+  return MakeValue(spv::OpCooperativeMatrixLoadKHR, matrix_type, ptr, layout, stride);
+#else
+  LOG(FATAL) << "Please turn on USE_SPIRV_KHR_COOPERATIVE_MATRIX in config.cmake";
+  return Value();
+#endif
+}
+
+void IRBuilder::CooperativeMatrixStore(Value ptr, Value matrix, Value stride, bool col_major) {
+#ifdef TVM_SPIRV_KHR_COOPERATIVE_MATRIX
+  Value layout = UIntImm(t_uint32_, col_major ? spv::CooperativeMatrixLayoutColumnMajorKHR
+                                              : spv::CooperativeMatrixLayoutRowMajorKHR);
+  MakeInst(spv::OpCooperativeMatrixStoreKHR, ptr, matrix, layout, stride);
+#else
+  LOG(FATAL) << "Please turn on USE_SPIRV_KHR_COOPERATIVE_MATRIX in config.cmake";
+#endif
+}
+
+Value IRBuilder::CooperativeMatrixMulAdd(Value a, Value b, Value c) {
+#ifdef TVM_SPIRV_KHR_COOPERATIVE_MATRIX
+  // The signedness of the integer matrices is given by the operands, not by their types.
+  uint32_t operands = spv::CooperativeMatrixOperandsMaskNone;
+  if (a.stype.type.is_int()) {
+    operands |= spv::CooperativeMatrixOperandsMatrixASignedComponentsKHRMask;
+  }
+  if (b.stype.type.is_int()) {
+    operands |= spv::CooperativeMatrixOperandsMatrixBSignedComponentsKHRMask;
+  }
+  if (c.stype.type.is_int()) {
+    operands |= spv::CooperativeMatrixOperandsMatrixCSignedComponentsKHRMask |
+                spv::CooperativeMatrixOperandsMatrixResultSignedComponentsKHRMask;
+  }
+  return MakeValue(spv::OpCooperativeMatrixMulAddKHR, c.stype, a, b, c, operands);
+#else
+  LOG(FATAL) << "Please turn on USE_SPIRV_KHR_COOPERATIVE_MATRIX in config.cmake";
+  return Value();
+#endif
+}
+
 Value IRBuilder::Concat(const std::vector<Value>& vec) {
   bool is_const = vec[0].flag == kConstant;
   DataType etype = vec[0].stype.type;
@@ -68,6 +68,12 @@ enum ValueKind {
   kUniformPtr
 };
 
+/*!
+ * \brief The role of a cooperative matrix in a multiply-add, valued as
+ * spv::CooperativeMatrixUse.
+ */
+enum class CooperativeMatrixUse : uint32_t { kMatrixA = 0, kMatrixB = 1, kAccumulator = 2 };
+
 /*! \brief Represent the SPIRV Value */
 struct Value {
   /*! \brief The Id to represent value */
@@ -431,6 +437,69 @@ class IRBuilder {
   Value CallKHRIntegerDotProduct(const SType& ret_type, const std::vector<Value>& args,
                                  const DataType& dtype);
 
+  /*!
+   * \brief Read a value of another invocation of the subgroup.
+   *
+   * \param op The shuffle, one of spv::OpGroupNonUniformShuffle,
+   *   spv::OpGroupNonUniformShuffleUp and spv::OpGroupNonUniformShuffleDown.
+   * \param value The value to read.
+   * \param index The invocation to read for spv::OpGroupNonUniformShuffle,
+   *   its distance to the current invocation otherwise.
+   * \return The value of the other invocation.
+   */
+  Value SubgroupShuffle(spv::Op op, Value value, Value index);
+
+  /*!
+   * \brief Get the type of a cooperative matrix of the subgroup.
+   * \param dtype The data type of the elements.
+   * \param rows The number of rows.
+   * \param cols The number of columns.
+   * \param use The role of the matrix in the multiply-add.
+   * \return The corresponding spirv type.
+   */
+  SType GetCooperativeMatrixType(const DataType& dtype, uint32_t rows, uint32_t cols,
+                                 CooperativeMatrixUse use);
+  /*!
+   * \brief Allocate an array of cooperative matrices in the function storage.
+   * \param matrix_type The type of the matrices.
+   * \param num_matrices The number of matrices.
+   * \return The pointer to the array.
+   */
+  Value AllocateCooperativeMatrices(const SType& matrix_type, uint32_t num_matrices);
+  /*!
+   * \brief Get the pointer to a matrix of an array of AllocateCooperativeMatrices.
+   * \param matrix_type The type of the matrices.
+   * \param matrices The pointer to the array.
+   * \param index The index of the matrix.
+   * \return The pointer to the matrix.
+   */
+  Value CooperativeMatrixAccess(const SType& matrix_type, Value matrices, Value index);
+  /*!
+   * \brief Load a cooperative matrix from memory.
+   * \param matrix_type The type of the matrix.
+   * \param ptr The pointer to the first element.
+   * \param stride The distance in elements between the rows, or the columns if col_major.
+   * \param col_major Whether the matrix is stored column by column.
+   * \return The loaded matrix.
+   */
+  Value CooperativeMatrixLoad(const SType& matrix_type, Value ptr, Value stride, bool col_major);
+  /*!
+   * \brief Store a cooperative matrix to memory.
+   * \param ptr The pointer to the first element.
+   * \param matrix The matrix to store.
+   * \param stride The distance in elements between the rows, or the columns if col_major.
+   * \param col_major Whether the matrix is stored column by column.
+   */
+  void CooperativeMatrixStore(Value ptr, Value matrix, Value stride, bool col_major);
+  /*!
+   * \brief Compute a * b + c on cooperative matrices.
+   * \param a The matrix of use kMatrixA.
+   * \param b The matrix of use kMatrixB.
+   * \param c The matrix of use kAccumulator, also the type of the result.
+   * \return The result.
+   */
+  Value CooperativeMatrixMulAdd(Value a, Value b, Value c);
+
   /*!
    * \brief Build vector by concatenating components
    *
@@ -705,6 +774,13 @@ class IRBuilder {
   std::map<std::pair<uint32_t, uint64_t>, Value> const_tbl_;
   /*! \brief map from name of a ExtInstImport to its value */
   std::map<std::string, Value> ext_inst_tbl_;
+  /*! \brief map from (element type, rows, columns, use) to the cooperative matrix type */
+  std::map<std::tuple<uint32_t, uint32_t, uint32_t, uint32_t>, SType> cooperative_matrix_type_tbl_;
+  /*! \brief map from (cooperative matrix type, length) to the array type */
+  std::map<std::pair<uint32_t, uint32_t>, SType> cooperative_matrix_array_tbl_;
+
+  /*! \brief The SPIR-V version of the module, raised by the instructions that need it. */
+  uint32_t spirv_version_{0x10000};
 
   /*! \brief Header segment
    *
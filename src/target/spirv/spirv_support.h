@@ -276,6 +276,22 @@ struct SPIRVSupport {
    * attempting to perform integer dot product.
    */
   bool supports_integer_dot_product{false};
+
+  /*!
+   * \brief Whether the driver supports the cooperative matrix operations.
+   *
+   * Vulkan extension: VK_KHR_cooperative_matrix
+   * Vulkan struct: VkPhysicalDeviceCooperativeMatrixFeaturesKHR
+   * Device property: cooperativeMatrix
+   * SPV Extension name: SPV_KHR_cooperative_matrix
+   * SPV Capability: spv::CapabilityCooperativeMatrixKHR
+   *
+   * If support is present, the wmma fragments and intrinsics are
+   * lowered to cooperative matrices, which run on the matrix units of
+   * the device.  If support is not present, codegen will throw
+   * exception on attempting to use a wmma fragment.
+   */
+  bool supports_cooperative_matrix{false};
 };
 
 }  // namespace codegen
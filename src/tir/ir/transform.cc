@@ -23,12 +23,20 @@
  */
 #include <tvm/node/repr_printer.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/support/parallel_for.h>
 #include <tvm/tir/transform.h>
 
+#include <algorithm>
+#include <thread>
+
 namespace tvm {
 namespace tir {
 namespace transform {
 
+// The number of threads the PrimFunc passes process the functions of a module with, all the
+// hardware threads if non-positive. The pass functions must be thread-safe when it is not 1.
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.PrimFuncPass.num_threads", Integer);
+
 /*!
  * \brief Function level pass that applies transformations to all
  *        TIR functions within the module.
@@ -53,6 +61,17 @@ class PrimFuncPassNode : public PassNode {
    */
   IRModule operator()(IRModule mod, const PassContext& pass_ctx) const final;
 
+  /*!
+   * \brief Run the pass function on the functions of a module concurrently.
+   *
+   * \param mod The module that an optimization pass is applied on.
+   * \param pass_ctx The context that an optimization pass executes on.
+   * \param num_threads The number of threads, or non-positive for all the hardware threads.
+   *
+   * \return Return the updated module.
+   */
+  IRModule RunInParallel(IRModule mod, const PassContext& pass_ctx, int num_threads) const;
+
   /*!
    * \brief Get the pass information/meta data.
    */
@@ -88,6 +107,11 @@ PrimFuncPass::PrimFuncPass(
 // Perform Module -> Module optimizations at the PrimFunc level.
 IRModule PrimFuncPassNode::operator()(IRModule mod, const PassContext& pass_ctx) const {
   ICHECK(mod.defined());
+  int num_threads =
+      pass_ctx->GetConfig<Integer>("tir.PrimFuncPass.num_threads", Integer(1)).value()->value;
+  if (num_threads != 1) {
+    return RunInParallel(mod, pass_ctx, num_threads);
+  }
   std::vector<ObjectRef> deleted_list;
   IRModuleNode* mod_ptr = mod.CopyOnWrite();
   auto* func_dict = mod_ptr->functions.CopyOnWrite();
@@ -113,6 +137,36 @@ IRModule PrimFuncPassNode::operator()(IRModule mod, const PassContext& pass_ctx)
   return mod;
 }
 
+IRModule PrimFuncPassNode::RunInParallel(IRModule mod, const PassContext& pass_ctx,
+                                         int num_threads) const {
+  std::vector<std::pair<GlobalVar, PrimFunc>> updates;
+  for (const auto& kv : mod->functions) {
+    if (const auto* func = kv.second.as<PrimFuncNode>()) {
+      updates.push_back({kv.first, GetRef<PrimFunc>(func)});
+    }
+  }
+  if (num_threads <= 0) {
+    num_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  }
+  num_threads = std::max(1, std::min(num_threads, static_cast<int>(updates.size())));
+  // Unlike the sequential loop, the functions stay in the module while the pass functions run,
+  // which only read the module. The results are merged in order once all of them are done.
+  support::parallel_for_dynamic(0, updates.size(), num_threads, [&](int thread_id, int i) {
+    // The pass context is thread local, e.g. for the pass functions calling other passes.
+    PassContextThreadScope scope(pass_ctx);
+    updates[i].second = pass_func(updates[i].second, mod, pass_ctx);
+  });
+  IRModuleNode* mod_ptr = mod.CopyOnWrite();
+  for (const auto& pair : updates) {
+    if (pair.second.defined()) {
+      mod_ptr->Update(pair.first, pair.second);
+    } else {
+      mod_ptr->Remove(pair.first);
+    }
+  }
+  return mod;
+}
+
 Pass CreatePrimFuncPass(
     const runtime::TypedPackedFunc<PrimFunc(PrimFunc, IRModule, PassContext)>& pass_func,
     int opt_level, String name, tvm::Array<String> required, bool traceable) {
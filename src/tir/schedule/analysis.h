@@ -744,7 +744,8 @@ class TensorizeInfoNode : public Object {
   /*! \brief Maps loops in an intrinsic description to its index, outer to inner */
   Map<tir::For, Integer> desc_loop_indexer;
   /*! \brief Optional padded extents of the block iters when padding is needed to match the
-   * intrinsic description
+   * intrinsic description. Block iters with dynamic extents are padded to a multiple of the
+   * given factor, in the same way as PadEinsum.
    */
   Optional<Array<Integer>> block_iter_paddings;
 
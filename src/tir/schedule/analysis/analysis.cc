@@ -1825,7 +1825,17 @@ Optional<TensorizeInfo> GetTensorizeLoopMapping(const tir::ScheduleState& self,
 
       // Check divisibility
       if (!int_block_extent) {
-        return NullOpt;
+        if (analyzer.CanProve(floormod(block_loops[i]->extent, int_desc_extent->value) == 0)) {
+          // The dynamic extent is a multiple of the desc loop, no padding is needed.
+        } else if (allow_padding) {
+          // The remainder is only known at runtime. The padding of a dynamic extent is the factor
+          // that the extent is rounded up to.
+          block_index_to_padding[current_block_ind] = int_desc_extent->value;
+        } else {
+          return NullOpt;
+        }
+        ret->loop_map.Set(block_loop_sref, GetRef<tir::For>(desc_loop));
+        break;
       }
       int64_t remainder = int_block_extent->value % int_desc_extent->value;
       if (remainder != 0) {
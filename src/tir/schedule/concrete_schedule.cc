@@ -496,6 +496,14 @@ LoopRV ConcreteScheduleNode::AddUnitLoop(const LoopRV& loop_rv) {
   return result;
 }
 
+void ConcreteScheduleNode::SetRaggedExtent(const LoopRV& loop_rv, const LoopRV& outer_loop_rv,
+                                           const String& indptr) {
+  TVM_TIR_SCHEDULE_BEGIN();
+  tir::SetRaggedExtent(state_, this->GetSRef(loop_rv), this->GetSRef(outer_loop_rv), indptr);
+  TVM_TIR_SCHEDULE_END("set-ragged-extent", this->error_render_level_);
+  this->state_->DebugVerify();
+}
+
 /******** Schedule: Manipulate ForKind ********/
 
 void ConcreteScheduleNode::Parallel(const LoopRV& loop_rv) {
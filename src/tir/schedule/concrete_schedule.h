@@ -106,6 +106,8 @@ class ConcreteScheduleNode : public ScheduleNode {
   void Reorder(const Array<LoopRV>& ordered_loop_rvs) override;
   LoopRV AddUnitLoop(const BlockRV& block_rv) override;
   LoopRV AddUnitLoop(const LoopRV& loop_rv) override;
+  void SetRaggedExtent(const LoopRV& loop_rv, const LoopRV& outer_loop_rv,
+                       const String& indptr) override;
   /******** Schedule: Manipulate ForKind ********/
   void Parallel(const LoopRV& loop_rv) override;
   void Vectorize(const LoopRV& loop_rv) override;
@@ -199,6 +199,18 @@ TVM_DLL void Reorder(ScheduleState self, const Array<StmtSRef>& ordered_loop_sre
  */
 TVM_DLL StmtSRef AddUnitLoop(ScheduleState self, StmtSRef sref);
 
+/*!
+ * \brief Bound the iterations of a loop by the length of a ragged row, read from the prefix sum
+ * of the row lengths at the iteration of an outer loop, i.e. indptr[i + 1] - indptr[i]. The loop
+ * still iterates over its whole domain in the schedule, and the bound is applied when lowered.
+ * \param self The state of the schedule
+ * \param loop_sref The loop over the ragged dimension, whose min is zero
+ * \param outer_loop_sref The ancestor loop over the rows
+ * \param indptr The name of the 1-D integer buffer parameter holding the prefix sum
+ */
+TVM_DLL void SetRaggedExtent(ScheduleState self, const StmtSRef& loop_sref,
+                             const StmtSRef& outer_loop_sref, const String& indptr);
+
 /******** Schedule: Manipulate ForKind ********/
 /*!
  * \brief Parallelize the input loop. It requires:
@@ -519,7 +531,8 @@ TVM_DLL StmtSRef DecomposePadding(ScheduleState self, const StmtSRef& block_sref
  * \brief Pad the computation of Einsum.
  * \param self The state of the schedule
  * \param block_sref The block sref that matches the Einsum pattern.
- * \param padding The padding for each block iter.
+ * \param padding The padding for each block iter. For a block iter with a non-constant extent,
+ * it is the factor that the extent is rounded up to.
  */
 TVM_DLL void PadEinsum(ScheduleState self, const StmtSRef& block_sref,
                        const Array<Integer>& padding);
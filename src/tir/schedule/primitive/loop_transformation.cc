@@ -753,6 +753,61 @@ StmtSRef AddUnitLoop(ScheduleState self, StmtSRef sref) {
   return self->stmt2ref.at(creator.new_loop_.get());
 }
 
+class RaggedExtentError : public ScheduleError {
+ public:
+  explicit RaggedExtentError(IRModule mod, For loop, String reason)
+      : mod_(std::move(mod)), loop_(std::move(loop)), reason_(std::move(reason)) {}
+
+  String FastErrorString() const final {
+    return "ScheduleError: The ragged extent cannot be set on the loop";
+  }
+
+  String DetailRenderTemplate() const final {
+    return "The ragged extent cannot be set on the loop {0}, because " + reason_;
+  }
+
+  IRModule mod() const final { return mod_; }
+  Array<ObjectRef> LocationsOfInterest() const final { return {loop_}; }
+
+  IRModule mod_;
+  For loop_;
+  String reason_;
+};
+
+void SetRaggedExtent(ScheduleState self, const StmtSRef& loop_sref,
+                     const StmtSRef& outer_loop_sref, const String& indptr) {
+  const ForNode* loop = TVM_SREF_TO_FOR(loop_sref);
+  const ForNode* outer_loop = TVM_SREF_TO_FOR(outer_loop_sref);
+  if (!is_zero(loop->min)) {
+    throw RaggedExtentError(self->mod, GetRef<For>(loop), "its min is not zero");
+  }
+  bool is_ancestor = false;
+  for (const StmtSRefNode* p = loop_sref->parent; p != nullptr && !is_ancestor; p = p->parent) {
+    is_ancestor = p == outer_loop_sref.get();
+  }
+  if (!is_ancestor) {
+    throw RaggedExtentError(self->mod, GetRef<For>(loop),
+                            "the outer loop " + outer_loop->loop_var->name_hint +
+                                " is not its ancestor");
+  }
+  const PrimFuncNode* func =
+      GetRootPrimFunc(self->mod, GetSRefTreeRoot(loop_sref)->stmt, /*result_g_var=*/nullptr);
+  Optional<Buffer> indptr_buffer = NullOpt;
+  for (const auto& kv : func->buffer_map) {
+    if (kv.second->name == indptr) indptr_buffer = kv.second;
+  }
+  if (!indptr_buffer.defined() || indptr_buffer.value()->shape.size() != 1 ||
+      !indptr_buffer.value()->dtype.is_int()) {
+    throw RaggedExtentError(self->mod, GetRef<For>(loop),
+                            "the indptr " + indptr + " is not a 1-D integer buffer parameter");
+  }
+  // The extent is read when the loop is lowered, see tir.transform.FlattenBuffer
+  const Var& i = outer_loop->loop_var;
+  PrimExpr extent = BufferLoad(indptr_buffer.value(), {i + make_const(i.dtype(), 1)}) -
+                    BufferLoad(indptr_buffer.value(), {i});
+  Annotate(self, loop_sref, attr::ragged_extent, cast(loop->loop_var.dtype(), extent));
+}
+
 /******** InstructionKind Registration ********/
 
 struct SplitTraits : public UnpackedInstTraits<SplitTraits> {
@@ -892,10 +947,38 @@ struct AddUnitLoopTraits : public UnpackedInstTraits<AddUnitLoopTraits> {
   friend struct ::tvm::tir::UnpackedInstTraits;
 };
 
+struct SetRaggedExtentTraits : public UnpackedInstTraits<SetRaggedExtentTraits> {
+  static constexpr const char* kName = "SetRaggedExtent";
+  static constexpr bool kIsPure = false;
+
+ private:
+  static constexpr size_t kNumInputs = 2;
+  static constexpr size_t kNumAttrs = 1;
+  static constexpr size_t kNumDecisions = 0;
+
+  static void UnpackedApplyToSchedule(Schedule sch, LoopRV loop_rv, LoopRV outer_loop_rv,
+                                      String indptr) {
+    return sch->SetRaggedExtent(loop_rv, outer_loop_rv, indptr);
+  }
+
+  static String UnpackedAsPython(Array<String> outputs, String loop_rv, String outer_loop_rv,
+                                 String indptr) {
+    PythonAPICall py("set_ragged_extent");
+    py.Input("loop", loop_rv);
+    py.Input("outer_loop", outer_loop_rv);
+    py.Input("indptr", indptr);
+    return py.Str();
+  }
+
+  template <typename>
+  friend struct ::tvm::tir::UnpackedInstTraits;
+};
+
 TVM_REGISTER_INST_KIND_TRAITS(SplitTraits);
 TVM_REGISTER_INST_KIND_TRAITS(FuseTraits);
 TVM_REGISTER_INST_KIND_TRAITS(ReorderTraits);
 TVM_REGISTER_INST_KIND_TRAITS(AddUnitLoopTraits);
+TVM_REGISTER_INST_KIND_TRAITS(SetRaggedExtentTraits);
 
 }  // namespace tir
 }  // namespace tvm
@@ -37,7 +37,10 @@ class InvalidPaddingError : public ScheduleError {
   String DetailRenderTemplate() const final {
     std::ostringstream os;
     os << "The padding for the block {0} are invalid. It should be a list of "
-       << block_->iter_vars.size() << " non-negative integers. Got " << padding_;
+       << block_->iter_vars.size()
+       << " non-negative integers, where the elements for block iters with non-constant extents "
+          "are the factors that the extents are rounded up to. Got "
+       << padding_;
     return os.str();
   }
 
@@ -364,8 +367,16 @@ void PadEinsum(ScheduleState self, const StmtSRef& block_sref, const Array<Integ
   // Convert the input padding array to a map from variables to the padded extents
   for (int i = 0, n = padding.size(); i < n; ++i) {
     const IterVar& iter = block->iter_vars[i];
-    PrimExpr new_extent =
-        IntImm(iter->var->dtype, Downcast<Integer>(iter->dom->extent)->value + padding[i]->value);
+    PrimExpr new_extent;
+    if (const auto* int_extent = iter->dom->extent.as<IntImmNode>()) {
+      new_extent = IntImm(iter->var->dtype, int_extent->value + padding[i]->value);
+    } else if (padding[i]->value == 0) {
+      new_extent = iter->dom->extent;
+    } else {
+      // The extent is only known at runtime, round it up to a multiple of the padding instead.
+      PrimExpr factor = IntImm(iter->var->dtype, padding[i]->value);
+      new_extent = analyzer.Simplify(ceildiv(iter->dom->extent, factor) * factor);
+    }
     padded_iter_extents.Set(iter->var, new_extent);
     padded_iter_extents.Set(Downcast<Var>(realize->iter_values[i]), new_extent);
   }
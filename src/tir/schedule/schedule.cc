@@ -167,6 +167,8 @@ TVM_REGISTER_GLOBAL("tir.schedule.ScheduleAddUnitLoop")
         throw;
       }
     });
+TVM_REGISTER_GLOBAL("tir.schedule.ScheduleSetRaggedExtent")
+    .set_body_method<Schedule>(&ScheduleNode::SetRaggedExtent);
 /******** (FFI) Manipulate ForKind ********/
 TVM_REGISTER_GLOBAL("tir.schedule.ScheduleParallel")
     .set_body_method<Schedule>(&ScheduleNode::Parallel);
@@ -238,6 +238,17 @@ LoopRV TracedScheduleNode::AddUnitLoop(const LoopRV& loop_rv) {
   return result;
 }
 
+void TracedScheduleNode::SetRaggedExtent(const LoopRV& loop_rv, const LoopRV& outer_loop_rv,
+                                         const String& indptr) {
+  ConcreteScheduleNode::SetRaggedExtent(loop_rv, outer_loop_rv, indptr);
+
+  static const InstructionKind& kind = InstructionKind::Get("SetRaggedExtent");
+  trace_->Append(/*inst=*/Instruction(/*kind=*/kind,
+                                      /*inputs=*/{loop_rv, outer_loop_rv},
+                                      /*attrs=*/{indptr},
+                                      /*outputs=*/{}));
+}
+
 /******** Schedule: Manipulate ForKind ********/
 
 void TracedScheduleNode::Parallel(const LoopRV& loop_rv) {
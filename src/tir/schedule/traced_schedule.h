@@ -66,6 +66,8 @@ class TracedScheduleNode : public ConcreteScheduleNode {
   void Reorder(const Array<LoopRV>& ordered_loop_rvs) final;
   LoopRV AddUnitLoop(const BlockRV& block_rv) final;
   LoopRV AddUnitLoop(const LoopRV& loop_rv) final;
+  void SetRaggedExtent(const LoopRV& loop_rv, const LoopRV& outer_loop_rv,
+                       const String& indptr) final;
   /******** Schedule: Manipulate ForKind ********/
   void Parallel(const LoopRV& loop_rv) final;
   void Vectorize(const LoopRV& loop_rv) final;
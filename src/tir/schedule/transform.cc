@@ -321,11 +321,15 @@ Optional<LoopRV> TileWithTensorIntrin(const tir::Schedule& sch, const tir::Block
     PrimExpr desc_extent = analyzer.Simplify(desc_loop->extent);
     const auto* int_block_extent = block_extent.as<IntImmNode>();
     const auto* int_desc_extent = desc_extent.as<IntImmNode>();
-    ICHECK(int_block_extent != nullptr && int_desc_extent != nullptr);
-    // Check divisibility
-    int64_t total = int_block_extent->value;
+    ICHECK(int_desc_extent != nullptr);
+    // Check divisibility. A dynamic extent has been padded to a multiple of the desc loop.
     int64_t inner = int_desc_extent->value;
-    ICHECK_EQ(total % inner, 0);
+    if (int_block_extent != nullptr) {
+      ICHECK_EQ(int_block_extent->value % inner, 0);
+    } else {
+      ICHECK(analyzer.CanProve(floormod(block_extent, inner) == 0))
+          << "The extent " << block_extent << " is not a multiple of " << inner;
+    }
     // Do the split. Leave the outer extent as NullOpt (unspecified) so that the split factors
     // can be used for different extents (needed during tuning).
     Array<LoopRV> split = sch->Split(loop2rv.at(block_loop_sref), {NullOpt, Integer(inner)});
@@ -48,7 +48,7 @@ namespace tir {
 
 // cache_ is a static variable of the class ComputationsDoneBy, and C++ requires to define here
 // such static attribute, otherwise it causes a linking error.
-ComputationCache ComputationsDoneBy::cache_;
+thread_local ComputationCache ComputationsDoneBy::cache_;
 
 /* ********************************** Class ComputationsDoneBy **********************************
 *********************************************************************************************** */
@@ -111,8 +111,9 @@ class ComputationsDoneBy : public StmtExprVisitor {
   std::function<bool(const PrimExpr&)> can_contain_computations_;
   // The object being constructed and "returned" by the VisitExpr()/VisitStmt() methods
   ComputationTable table_of_computations_;
-  // Cache for preventing to compute repeatedly the computations done by the same stmt or expr
-  static ComputationCache cache_;
+  // Cache for preventing to compute repeatedly the computations done by the same stmt or expr,
+  // one per thread as the PrimFunc passes may run on the functions of a module in parallel
+  static thread_local ComputationCache cache_;
 };
 
 /*!
@@ -82,6 +82,19 @@ class BufferFlattener : public StmtExprMutator {
     return StmtExprMutator::VisitStmt_(block.get());
   }
 
+  Stmt VisitStmt_(const ForNode* op) final {
+    For loop = Downcast<For>(StmtExprMutator::VisitStmt_(op));
+    Optional<ObjectRef> ragged_extent = loop->annotations.Get(attr::ragged_extent);
+    if (!ragged_extent.defined()) return std::move(loop);
+    // Skip the iterations beyond the length of the ragged row, whose reads of the prefix sum of
+    // the lengths are flattened as the other loads.
+    PrimExpr extent = VisitExpr(Downcast<PrimExpr>(ragged_extent.value()));
+    auto* n = loop.CopyOnWrite();
+    n->extent = min(n->extent, extent);
+    n->annotations.erase(attr::ragged_extent);
+    return std::move(loop);
+  }
+
   Stmt VisitStmt_(const AllocateNode* op) final {
     Allocate alloc = Downcast<Allocate>(StmtExprMutator::VisitStmt_(op));
     // TODO(Lunderberg): Move the handling of boolean into a
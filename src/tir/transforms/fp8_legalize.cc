@@ -0,0 +1,385 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file fp8_legalize.cc
+ * \brief legalize the e4m3 and e5m2 float8 types by computing in fp32 and storing as uint8
+ */
+
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace tvm {
+namespace tir {
+
+/*! \brief The layout of a float8 format. */
+struct FP8Format {
+  /*! \brief The number of mantissa bits. */
+  int mantissa_bits;
+  /*! \brief The exponent bias. */
+  int bias;
+  /*! \brief The code of the largest finite magnitude, which the overflows saturate to. */
+  uint32_t max_code;
+
+  explicit FP8Format(DataType dtype) {
+    ICHECK(dtype.is_float8());
+    if (dtype.is_e4m3_float8()) {
+      mantissa_bits = 3, bias = 7, max_code = 0x7E;
+    } else {
+      mantissa_bits = 2, bias = 15, max_code = 0x7B;
+    }
+  }
+};
+
+/*!
+ * \brief Promote the float8 Ops to fp32, casting the results back to float8.
+ *
+ * Unlike BF16Legalize, the casts between consecutive Ops are not eliminated, as the rounding to
+ * float8 between them is too large to drop.
+ */
+class FP8PromoteRewriter : public StmtExprMutator {
+ public:
+  Stmt operator()(Stmt s) { return VisitStmt(s); }
+
+#define DEFINE_FP8_PROMOTE(OP, FUNC, CAST_BACK)                                              \
+  PrimExpr VisitExpr_(const OP* op) final {                                                  \
+    return Promote(                                                                          \
+        op, [](PrimExpr a, PrimExpr b, Span span) { return FUNC(a, b, span); }, CAST_BACK);  \
+  }
+
+  DEFINE_FP8_PROMOTE(AddNode, add, true)
+  DEFINE_FP8_PROMOTE(SubNode, sub, true)
+  DEFINE_FP8_PROMOTE(MulNode, mul, true)
+  DEFINE_FP8_PROMOTE(DivNode, div, true)
+  DEFINE_FP8_PROMOTE(MinNode, min, true)
+  DEFINE_FP8_PROMOTE(MaxNode, max, true)
+  DEFINE_FP8_PROMOTE(LTNode, less, false)
+  DEFINE_FP8_PROMOTE(LENode, less_equal, false)
+  DEFINE_FP8_PROMOTE(GTNode, greater, false)
+  DEFINE_FP8_PROMOTE(GENode, greater_equal, false)
+  DEFINE_FP8_PROMOTE(EQNode, equal, false)
+  DEFINE_FP8_PROMOTE(NENode, not_equal, false)
+
+#undef DEFINE_FP8_PROMOTE
+
+  PrimExpr VisitExpr_(const CallNode* op) final {
+    Array<PrimExpr> args;
+    for (const PrimExpr& arg : op->args) {
+      PrimExpr x = this->VisitExpr(arg);
+      args.push_back(ToFloat32(x));
+    }
+    if (op->dtype.is_float8()) {
+      PrimExpr result_fp32 = Call(DataType::Float(32, op->dtype.lanes()), op->op, args, op->span);
+      return Cast(op->dtype, result_fp32, op->span);
+    }
+    return Call(op->dtype, op->op, args, op->span);
+  }
+
+ private:
+  static PrimExpr ToFloat32(const PrimExpr& x) {
+    return x.dtype().is_float8() ? Cast(DataType::Float(32, x.dtype().lanes()), x) : x;
+  }
+
+  template <typename T, typename FBinary>
+  PrimExpr Promote(const T* op, FBinary fbinary, bool cast_back) {
+    PrimExpr a = this->VisitExpr(op->a);
+    PrimExpr b = this->VisitExpr(op->b);
+    if (!a.dtype().is_float8() && !b.dtype().is_float8()) {
+      if (a.same_as(op->a) && b.same_as(op->b)) return GetRef<PrimExpr>(op);
+      return fbinary(a, b, op->span);
+    }
+    DataType fp8_dtype = a.dtype().is_float8() ? a.dtype() : b.dtype();
+    PrimExpr result = fbinary(ToFloat32(a), ToFloat32(b), op->span);
+    return cast_back ? Cast(fp8_dtype, result) : result;
+  }
+};
+
+/*!
+ * \brief Encode a float as float8, rounding to the nearest even and saturating the overflows, as
+ * the casts lowered by FP8LowerRewriter.
+ */
+uint8_t FloatToFP8(float value, const FP8Format& format) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  uint32_t sign = (bits >> 24) & 0x80;
+  if (std::isnan(value)) return static_cast<uint8_t>(sign | 0x7F);
+  uint32_t abs_bits = bits & 0x7FFFFFFF;
+  uint32_t code;
+  int shift = 23 - format.mantissa_bits;
+  if (abs_bits < static_cast<uint32_t>(128 - format.bias) << 23) {
+    // subnormal, in units of the smallest subnormal
+    float scale = std::ldexp(1.0f, format.bias - 1 + format.mantissa_bits);
+    code = static_cast<uint32_t>(std::nearbyint(std::fabs(value) * scale));
+  } else {
+    uint32_t rebiased = abs_bits - (static_cast<uint32_t>(127 - format.bias) << 23);
+    uint32_t rounding_bias = ((rebiased >> shift) & 1) + (1U << (shift - 1)) - 1;
+    code = (rebiased + rounding_bias) >> shift;
+  }
+  return static_cast<uint8_t>(sign | std::min(code, format.max_code));
+}
+
+/*!
+ * \brief Lower the float8 types to uint8, the casts between float8 and fp32 to bit manipulations
+ * and the float8 FloatImm to uint8.
+ */
+class FP8LowerRewriter : public StmtExprMutator {
+ public:
+  using StmtExprMutator::operator();
+
+  PrimExpr VisitExpr_(const CastNode* op) final {
+    PrimExpr op_val = this->VisitExpr(op->value);
+    int lanes = op->dtype.lanes();
+    DataType float32_dtype = DataType::Float(32, lanes);
+    if (op->value->dtype.is_float8()) {
+      PrimExpr float32_v = Decode(op_val, FP8Format(op->value->dtype));
+      if (op->dtype.is_float8()) {
+        return Encode(float32_v, FP8Format(op->dtype));
+      }
+      return op->dtype == float32_dtype ? float32_v : Cast(op->dtype, float32_v);
+    } else if (op->dtype.is_float8()) {
+      PrimExpr float32_v = op_val.dtype() == float32_dtype ? op_val : Cast(float32_dtype, op_val);
+      return Encode(float32_v, FP8Format(op->dtype));
+    }
+    if (op->value.same_as(op_val)) return GetRef<PrimExpr>(op);
+    return Cast(op->dtype, op_val);
+  }
+
+  PrimExpr VisitExpr_(const FloatImmNode* op) final {
+    if (op->dtype.is_float8()) {
+      return IntImm(DataType::UInt(8), FloatToFP8(static_cast<float>(op->value),
+                                                  FP8Format(op->dtype)));
+    }
+    return StmtExprMutator::VisitExpr_(op);
+  }
+
+  PrimExpr VisitExpr_(const VarNode* op) final {
+    auto it = var_remap_.find(GetRef<Var>(op));
+    if (it != var_remap_.end()) return it->second;
+    return GetRef<PrimExpr>(op);
+  }
+
+  Stmt VisitStmt_(const AllocateNode* op) final {
+    if (op->dtype.is_float8()) {
+      DataType dtype = DataType::UInt(8, op->dtype.lanes());
+      Var buffer_var = Var(op->buffer_var->name_hint, PointerType(PrimType(dtype)));
+      var_remap_[op->buffer_var] = buffer_var;
+      return VisitStmt(Allocate(buffer_var, dtype, op->extents, op->condition, op->body));
+    }
+    return StmtExprMutator::VisitStmt_(op);
+  }
+
+  Stmt VisitStmt_(const BufferStoreNode* op) final {
+    Stmt ret = StmtExprMutator::VisitStmt_(op);
+    op = ret.as<BufferStoreNode>();
+    Buffer new_buf = GetRemappedBuffer(op->buffer);
+    if (new_buf.same_as(op->buffer)) return ret;
+    return BufferStore(new_buf, op->value, op->indices);
+  }
+
+  PrimExpr VisitExpr_(const BufferLoadNode* op) final {
+    PrimExpr ret = StmtExprMutator::VisitExpr_(op);
+    op = ret.as<BufferLoadNode>();
+    Buffer new_buf = GetRemappedBuffer(op->buffer);
+    if (new_buf.same_as(op->buffer)) return ret;
+    return BufferLoad(new_buf, op->indices);
+  }
+
+  Stmt VisitStmt_(const AttrStmtNode* op) final {
+    Stmt ret = StmtExprMutator::VisitStmt_(op);
+    op = ret.as<AttrStmtNode>();
+    if (auto* buffer = op->node.as<BufferNode>()) {
+      auto it = buffer_remap_.find(GetRef<Buffer>(buffer));
+      if (it != buffer_remap_.end()) {
+        return AttrStmt(it->second, op->attr_key, op->value, op->body);
+      }
+    } else if (auto* var = op->node.as<VarNode>()) {
+      auto it = var_remap_.find(GetRef<Var>(var));
+      if (it != var_remap_.end()) {
+        return AttrStmt(it->second, op->attr_key, op->value, op->body);
+      }
+    }
+    return ret;
+  }
+
+  Stmt VisitStmt_(const BufferRealizeNode* op) final {
+    Stmt ret = StmtExprMutator::VisitStmt_(op);
+    op = ret.as<BufferRealizeNode>();
+    Buffer new_buf = GetRemappedBuffer(op->buffer);
+    if (new_buf.same_as(op->buffer)) return ret;
+    return BufferRealize(new_buf, op->bounds, op->condition, op->body);
+  }
+
+  void AlterBuffers(PrimFuncNode* op) {
+    // As BF16LowerRewriter::AlterBuffers, the data of the parameters are replaced, so the
+    // preflattened buffer map is updated too.
+    Map<Var, Buffer> new_buffer_map;
+    for (const auto& kv : op->buffer_map) {
+      const Buffer& buf = kv.second;
+      if (buf->dtype.is_float8()) {
+        DataType dtype = DataType::UInt(8, buf->dtype.lanes());
+        Var buffer_var = Var(buf->data->name_hint, PointerType(PrimType(dtype)));
+        Buffer new_buf = Buffer(buffer_var, dtype, buf->shape, buf->strides, buf->elem_offset,
+                                buf->name, buf->data_alignment, buf->offset_factor,
+                                buf->buffer_type);
+        buffer_remap_[buf] = new_buf;
+        var_remap_[buf->data] = buffer_var;
+        new_buffer_map.Set(kv.first, new_buf);
+      } else {
+        new_buffer_map.Set(kv.first, buf);
+      }
+    }
+    Map<Var, Buffer> new_preflattened_buffer_map;
+    for (const auto& kv : op->preflattened_buffer_map) {
+      const Buffer& buf = kv.second;
+      if (buf->dtype.is_float8()) {
+        auto it = new_buffer_map.find(kv.first);
+        ICHECK(it != new_buffer_map.end())
+            << "PrimFunc parameter " << kv.first->name_hint
+            << " is associated with the pre-flattened buffer " << buf->name
+            << ", but isn't associated with any post-flatten buffer.";
+        DataType dtype = DataType::UInt(8, buf->dtype.lanes());
+        Buffer new_buf = Buffer((*it).second->data, dtype, buf->shape, buf->strides,
+                                buf->elem_offset, buf->name, buf->data_alignment,
+                                buf->offset_factor, buf->buffer_type);
+        buffer_remap_[buf] = new_buf;
+        new_preflattened_buffer_map.Set(kv.first, new_buf);
+      } else {
+        new_preflattened_buffer_map.Set(kv.first, buf);
+      }
+    }
+    if (!buffer_remap_.empty()) {
+      op->buffer_map = new_buffer_map;
+      op->preflattened_buffer_map = new_preflattened_buffer_map;
+    }
+  }
+
+ private:
+  /*! \brief Decode the uint8 bits of a float8 to fp32. */
+  static PrimExpr Decode(const PrimExpr& bits, const FP8Format& format) {
+    int lanes = bits.dtype().lanes();
+    DataType uint32_dtype = DataType::UInt(32, lanes);
+    DataType float32_dtype = DataType::Float(32, lanes);
+    auto u32 = [&](uint64_t value) { return make_const(uint32_dtype, value); };
+    int m = format.mantissa_bits;
+    PrimExpr u = Cast(uint32_dtype, bits);
+    PrimExpr magnitude = u & 0x7F;
+    // the normals move their exponent and mantissa into fp32 and are rebiased, while the
+    // subnormals are scaled from their integer mantissa, which works with the fp32 denormals
+    // flushed to zero
+    PrimExpr normal = (magnitude << (23 - m)) + u32(static_cast<uint64_t>(127 - format.bias) << 23);
+    PrimExpr subnormal = Call(uint32_dtype, builtin::reinterpret(),
+                              {Cast(float32_dtype, magnitude) *
+                               make_const(float32_dtype, std::ldexp(1.0, 1 - format.bias - m))});
+    PrimExpr result = Select(magnitude < (1 << m), subnormal, normal);
+    if (format.bias == 15) {
+      // e5m2 keeps the infinities and the NaNs of IEEE 754
+      result = Select(magnitude >= 0x7C, u32(0x7F800000) | ((magnitude & 0x3) << 21), result);
+    } else {
+      // e4m3 has no infinities, and a single NaN magnitude
+      result = Select(magnitude == 0x7F, u32(0x7FC00000), result);
+    }
+    return Call(float32_dtype, builtin::reinterpret(), {result | ((u & 0x80) << 24)});
+  }
+
+  /*!
+   * \brief Encode fp32 to the uint8 bits of a float8, rounding to the nearest even and saturating
+   * the overflows, as FloatToFP8.
+   */
+  static PrimExpr Encode(const PrimExpr& value, const FP8Format& format) {
+    int lanes = value.dtype().lanes();
+    DataType uint32_dtype = DataType::UInt(32, lanes);
+    DataType float32_dtype = DataType::Float(32, lanes);
+    auto u32 = [&](uint64_t v) { return make_const(uint32_dtype, v); };
+    int m = format.mantissa_bits;
+    int shift = 23 - m;
+    PrimExpr bits = Call(uint32_dtype, builtin::reinterpret(), {value});
+    PrimExpr abs_bits = bits & 0x7FFFFFFF;
+    PrimExpr subnormal = Cast(
+        uint32_dtype,
+        nearbyint(Call(float32_dtype, builtin::reinterpret(), {abs_bits}) *
+                  make_const(float32_dtype, std::ldexp(1.0, format.bias - 1 + m))));
+    PrimExpr rebiased = abs_bits - u32(static_cast<uint64_t>(127 - format.bias) << 23);
+    PrimExpr rounding_bias = ((rebiased >> shift) & 1) + u32((1U << (shift - 1)) - 1);
+    PrimExpr normal = min((rebiased + rounding_bias) >> shift, u32(format.max_code));
+    PrimExpr code =
+        Select(abs_bits < u32(static_cast<uint64_t>(128 - format.bias) << 23), subnormal, normal);
+    code = Select(abs_bits > u32(0x7F800000), u32(0x7F), code);
+    return Cast(DataType::UInt(8, lanes), code | ((bits >> 24) & 0x80));
+  }
+
+  Buffer GetRemappedBuffer(Buffer buf) {
+    auto buf_it = buffer_remap_.find(buf);
+    if (buf_it != buffer_remap_.end()) return buf_it->second;
+    Buffer new_buf = buf;
+    auto var_it = var_remap_.find(buf->data);
+    if (var_it != var_remap_.end()) {
+      DataType dtype = buf->dtype.is_float8() ? DataType::UInt(8, buf->dtype.lanes()) : buf->dtype;
+      new_buf = Buffer(var_it->second, dtype, buf->shape, buf->strides, buf->elem_offset, buf->name,
+                       buf->data_alignment, buf->offset_factor, buf->buffer_type,
+                       buf->axis_separators, buf->span);
+    }
+    buffer_remap_[buf] = new_buf;
+    return new_buf;
+  }
+
+  std::unordered_map<Buffer, Buffer, ObjectPtrHash, ObjectPtrEqual> buffer_remap_;
+  std::unordered_map<Var, Var, ObjectPtrHash, ObjectPtrEqual> var_remap_;
+};
+
+namespace transform {
+
+Pass FP8Promote() {
+  auto pass_func = [](PrimFunc f, IRModule m, PassContext ctx) {
+    auto* n = f.CopyOnWrite();
+    n->body = FP8PromoteRewriter()(std::move(n->body));
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.FP8Promote", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.FP8Promote").set_body_typed(FP8Promote);
+
+Pass FP8TypeLowering() {
+  auto pass_func = [](PrimFunc f, IRModule m, PassContext ctx) {
+    auto* n = f.CopyOnWrite();
+    FP8LowerRewriter lowerer;
+    lowerer.AlterBuffers(n);
+    n->body = lowerer(std::move(n->body));
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.FP8TypeLowering", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.FP8TypeLowering").set_body_typed(FP8TypeLowering);
+
+Pass FP8Legalize() { return Sequential({FP8Promote(), FP8TypeLowering()}, "tir.FP8Legalize"); }
+
+TVM_REGISTER_GLOBAL("tir.transform.FP8Legalize").set_body_typed(FP8Legalize);
+
+}  // namespace transform
+}  // namespace tir
+}  // namespace tvm
@@ -0,0 +1,174 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file inject_software_prefetch.cc
+ * \brief Prefetch the global memory read by the future iterations of the loops annotated with
+ *        a software prefetch distance.
+ */
+#include <tvm/arith/analyzer.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/expr.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <unordered_set>
+#include <vector>
+
+#include "../../arith/ir_mutator_with_analyzer.h"
+#include "ir_utils.h"
+
+namespace tvm {
+namespace tir {
+
+/*!
+ * \brief Collect the distinct loads of global buffers whose address depends on the loop var, and
+ * can be computed ahead at the beginning of the loop body.
+ */
+class PrefetchLoadCollector : public StmtExprVisitor {
+ public:
+  static std::vector<BufferLoad> Collect(const Var& loop_var, const Stmt& body) {
+    PrefetchLoadCollector collector(loop_var);
+    collector(body);
+    return std::move(collector.loads_);
+  }
+
+ private:
+  explicit PrefetchLoadCollector(Var loop_var) : loop_var_(std::move(loop_var)) {}
+
+  void VisitStmt_(const ForNode* op) final {
+    inner_vars_.insert(op->loop_var.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const LetStmtNode* op) final {
+    inner_vars_.insert(op->var.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitStmt_(const AllocateNode* op) final {
+    inner_vars_.insert(op->buffer_var.get());
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitExpr_(const LetNode* op) final {
+    inner_vars_.insert(op->var.get());
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const BufferLoadNode* op) final {
+    StmtExprVisitor::VisitExpr_(op);
+    if (op->indices.size() != 1 || inner_vars_.count(op->buffer->data.get())) return;
+    String scope = GetPtrStorageScope(op->buffer->data);
+    if (scope != "global" && scope != "") return;
+    PrimExpr index = op->indices[0];
+    if (const auto* ramp = index.as<RampNode>()) index = ramp->base;
+    if (index.dtype().lanes() != 1 || !UsesVar(index, [this](const VarNode* v) {
+          return v == loop_var_.get();
+        })) {
+      return;
+    }
+    bool has_load = false;
+    PostOrderVisit(index, [&has_load](const ObjectRef& node) {
+      has_load = has_load || node->IsInstance<BufferLoadNode>();
+    });
+    if (has_load || UsesVar(index, [this](const VarNode* v) { return inner_vars_.count(v); })) {
+      return;
+    }
+    BufferLoad load(op->buffer, {index});
+    for (const BufferLoad& other : loads_) {
+      if (other->buffer->data.same_as(load->buffer->data) &&
+          ExprDeepEqual()(other->indices[0], index)) {
+        return;
+      }
+    }
+    loads_.push_back(load);
+  }
+
+  /*! \brief The annotated loop var. */
+  Var loop_var_;
+  /*! \brief The vars defined inside the loop body, unavailable at its beginning. */
+  std::unordered_set<const VarNode*> inner_vars_;
+  /*! \brief The loads to prefetch. */
+  std::vector<BufferLoad> loads_;
+};
+
+class SoftwarePrefetchInjector : public arith::IRMutatorWithAnalyzer {
+ public:
+  static Stmt Inject(Stmt stmt) {
+    arith::Analyzer analyzer;
+    SoftwarePrefetchInjector injector(&analyzer);
+    return injector(std::move(stmt));
+  }
+
+ private:
+  using IRMutatorWithAnalyzer::IRMutatorWithAnalyzer;
+  using IRMutatorWithAnalyzer::VisitStmt_;
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    For loop = Downcast<For>(IRMutatorWithAnalyzer::VisitStmt_(op));
+    Optional<ObjectRef> annotation = loop->annotations.Get(attr::software_prefetch_distance);
+    if (!annotation.defined()) return std::move(loop);
+    const auto* distance = annotation.as<IntImmNode>();
+    CHECK(distance != nullptr && distance->value > 0)
+        << "ValueError: The annotation " << attr::software_prefetch_distance << " of loop "
+        << loop->loop_var << " must be a positive integer, but gets " << annotation.value();
+
+    // Prefetch the data of the iteration `distance` ahead, clamped to the last iteration.
+    PrimExpr last = loop->min + loop->extent - 1;
+    PrimExpr ahead =
+        min(loop->loop_var + make_const(loop->loop_var.dtype(), distance->value), last);
+    Array<Stmt> seq;
+    for (const BufferLoad& load : PrefetchLoadCollector::Collect(loop->loop_var, loop->body)) {
+      PrimExpr index = Substitute(load->indices[0], {{loop->loop_var, ahead}});
+      BufferLoad future(load->buffer, {analyzer_->Simplify(index)});
+      PrimExpr address = Call(DataType::Handle(), builtin::address_of(), {future});
+      PrimExpr prefetch = Call(load->buffer->dtype, builtin::prefetch(), {address, 0, 3, 1});
+      seq.push_back(Evaluate(prefetch));
+    }
+    auto* n = loop.CopyOnWrite();
+    n->annotations.erase(attr::software_prefetch_distance);
+    if (!seq.empty()) {
+      seq.push_back(n->body);
+      n->body = SeqStmt(seq);
+    }
+    return std::move(loop);
+  }
+};
+
+namespace transform {
+
+Pass InjectSoftwarePrefetch() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    auto* n = f.CopyOnWrite();
+    n->body = SoftwarePrefetchInjector::Inject(std::move(n->body));
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.InjectSoftwarePrefetch", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.InjectSoftwarePrefetch").set_body_typed(InjectSoftwarePrefetch);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
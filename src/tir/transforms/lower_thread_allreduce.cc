@@ -29,6 +29,7 @@
 #include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/transform.h>
 
+#include <string>
 #include <unordered_set>
 
 #include "../../runtime/thread_storage_scope.h"
@@ -670,11 +671,21 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
   // Also, the warp/wavefront size differs (64 on rocm, 32 on cuda).
   bool is_warp_reduction(const std::vector<DataType>& types, int group_extent, int reduce_extent,
                          int contiguous_reduce_extent) const {
-    // Only cuda target supports warp reductions.
-    if ((target_->kind->name != "cuda") && (target_->kind->name != "rocm")) return false;
+    // Only cuda, rocm and vulkan targets support warp reductions.
+    const std::string& kind = target_->kind->name;
+    if (kind != "cuda" && kind != "rocm" && kind != "vulkan") return false;
 
-    // rocm only supports 32 bit operands for shuffling at the moment
-    if ((target_->kind->name == "rocm") &&
+    // vulkan needs the shuffle and relative shuffle subgroup operations, see
+    // VkSubgroupFeatureFlagBits.
+    if (kind == "vulkan") {
+      constexpr int64_t kSubgroupShuffleBits = 0x10 | 0x20;
+      int64_t subgroup_ops =
+          target_->GetAttr<Integer>("supported_subgroup_operations", 0).value().IntValue();
+      if ((subgroup_ops & kSubgroupShuffleBits) != kSubgroupShuffleBits) return false;
+    }
+
+    // rocm and vulkan only support 32 bit operands for shuffling at the moment
+    if ((kind == "rocm" || kind == "vulkan") &&
         (std::any_of(types.begin(), types.end(), [](DataType ty) {
           if (ty.is_vector()) return true;
           return ty.bits() != 32;
@@ -701,9 +712,9 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
     }
 
     // whether reduce_extent and group_extent are vaild for warp reduction.
-    if (target_->kind->name == "rocm") {
+    if (kind == "rocm") {
       return reduce_extent == warp_size_;
-    } else {  // target_->kind->name == "cuda"
+    } else {  // kind == "cuda" || kind == "vulkan"
       if (reduce_extent == 1) {
         return false;  // no need to warp reduce
       } else {
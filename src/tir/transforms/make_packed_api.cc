@@ -139,7 +139,15 @@ inline Stmt MakeAssertEQ(PrimExpr lhs, PrimExpr rhs, std::string msg) {
   return AssertStmt(lhs == rhs, tvm::tir::StringImm(msg), Evaluate(0));
 }
 
-PrimFunc MakePackedAPI(PrimFunc&& func) {
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.make_unchecked_api", Bool);
+
+/*!
+ * \brief Make the packed API of a PrimFunc.
+ * \param func The PrimFunc.
+ * \param checked Whether the number, the type codes and the DLTensor fields of the arguments are
+ *  asserted, or trusted from the caller.
+ */
+PrimFunc MakePackedAPI(PrimFunc&& func, bool checked = true) {
   auto global_symbol = func->GetAttr<String>(tvm::attr::kGlobalSymbol);
   ICHECK(global_symbol) << "MakePackedAPI: Expect PrimFunc to have the global_symbol attribute";
 
@@ -283,8 +291,17 @@ PrimFunc MakePackedAPI(PrimFunc&& func) {
   std::ostringstream num_args_error;
   num_args_error << name_hint << ": num_args should be " << num_args;
   std::vector<Stmt> arg_assert = {MakeAssertEQ(v_num_packed_args, num_args, num_args_error.str())};
-  func_ptr->body =
-      MergeNest({arg_assert, seq_init, binder.init_nest(), seq_check, binder.asserts()}, body);
+  if (checked) {
+    func_ptr->body =
+        MergeNest({arg_assert, seq_init, binder.init_nest(), seq_check, binder.asserts()}, body);
+  } else {
+    // Keep the device context of the checks, and only elide the assertions.
+    std::vector<Stmt> seq_context;
+    for (const Stmt& stmt : seq_check) {
+      if (!stmt->IsInstance<AssertStmtNode>()) seq_context.push_back(stmt);
+    }
+    func_ptr->body = MergeNest({seq_init, binder.init_nest(), seq_context}, body);
+  }
   func_ptr->params = args;
 
   Array<Var> undefined = UndefinedVars(func_ptr->body, func_ptr->params);
@@ -311,12 +328,23 @@ Pass MakePackedAPI() {
   auto pass_func = [](IRModule m, PassContext ctx) {
     IRModuleNode* mptr = m.CopyOnWrite();
     std::vector<std::pair<GlobalVar, PrimFunc>> updates;
+    bool make_unchecked = ctx->GetConfig<Bool>("tir.make_unchecked_api", Bool(false)).value();
 
     for (const auto& kv : mptr->functions) {
       if (auto* n = kv.second.as<PrimFuncNode>()) {
         PrimFunc func = GetRef<PrimFunc>(n);
         if (func->GetAttr<Integer>(tvm::attr::kCallingConv, Integer(CallingConv::kDefault)) ==
             CallingConv::kDefault) {
+          if (make_unchecked) {
+            // The unchecked entry, generated alongside, trusts the arguments of the caller.
+            String symbol = func->GetAttr<String>(tvm::attr::kGlobalSymbol).value_or("");
+            ICHECK(!symbol.empty()) << "MakePackedAPI: Expect PrimFunc to have the global_symbol "
+                                    << "attribute";
+            String unchecked_symbol = std::string(symbol) + runtime::symbol::tvm_unchecked_suffix;
+            PrimFunc unchecked = WithAttr(func, tvm::attr::kGlobalSymbol, unchecked_symbol);
+            updates.push_back({GlobalVar(unchecked_symbol), MakePackedAPI(std::move(unchecked),
+                                                                          /*checked=*/false)});
+          }
           auto updated_func = MakePackedAPI(std::move(func));
           updates.push_back({kv.first, updated_func});
         }
@@ -39,6 +39,7 @@ using namespace tir;
 struct SimplifyConfigNode : public tvm::AttrsNode<SimplifyConfigNode> {
   bool transitively_prove_inequalities;
   bool convert_boolean_to_and_of_ors;
+  bool enable_simplify_cache;
 
   TVM_DECLARE_ATTRS(SimplifyConfigNode, "tir.transform.SimplifyConfig") {
     TVM_ATTR_FIELD(transitively_prove_inequalities)
@@ -49,6 +50,10 @@ struct SimplifyConfigNode : public tvm::AttrsNode<SimplifyConfigNode> {
     TVM_ATTR_FIELD(convert_boolean_to_and_of_ors)
         .describe("If true, simplify conditionals into an AND of ORs")
         .set_default(false);
+
+    TVM_ATTR_FIELD(enable_simplify_cache)
+        .describe("If true, memoize the simplified expressions within each PrimFunc")
+        .set_default(false);
   }
 
   RewriteSimplifier::Extension GetEnabledExtensions() const {
@@ -199,6 +204,7 @@ Pass Simplify() {
     auto cfg = ctx->GetConfig<arith::SimplifyConfig>("tir.Simplify")
                    .value_or(AttrsWithDefaultValues<arith::SimplifyConfig>());
     analyzer.rewrite_simplify.SetEnabledExtensions(cfg->GetEnabledExtensions());
+    analyzer.EnableSimplifyCache(cfg->enable_simplify_cache);
 
     auto* n = f.CopyOnWrite();
     n->body = arith::StmtSimplifier(&analyzer).Simplify(std::move(n->body));
@@ -38,6 +38,24 @@
 namespace tvm {
 namespace tir {
 
+struct VectorizeLoopConfigNode : public tvm::AttrsNode<VectorizeLoopConfigNode> {
+  bool enable_predication;
+
+  TVM_DECLARE_ATTRS(VectorizeLoopConfigNode, "tir.transform.VectorizeLoopConfig") {
+    TVM_ATTR_FIELD(enable_predication)
+        .describe("Lower the stores guarded by a vector condition to masked loads and stores")
+        .set_default(false);
+  }
+};
+
+class VectorizeLoopConfig : public Attrs {
+ public:
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(VectorizeLoopConfig, Attrs, VectorizeLoopConfigNode);
+};
+
+TVM_REGISTER_NODE_TYPE(VectorizeLoopConfigNode);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.VectorizeLoop", VectorizeLoopConfig);
+
 inline PrimExpr BroadcastTo(PrimExpr e, int lanes) {
   if (e.dtype().lanes() == lanes) return e;
   if (const BroadcastNode* op = e.as<BroadcastNode>()) {
@@ -159,7 +177,8 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   using ExprFunctor::VisitExpr;
   using StmtMutator::operator();
 
-  Vectorizer(Var var, int var_lanes) : var_(var), var_lanes_(var_lanes) {
+  Vectorizer(Var var, int var_lanes, bool enable_predication = false)
+      : var_(var), var_lanes_(var_lanes), enable_predication_(enable_predication) {
     ramp_ = Ramp(IntImm(var->dtype, 0), IntImm(var->dtype, 1), var_lanes);
   }
 
@@ -168,6 +187,11 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
     Stmt ret = StmtMutator::VisitStmt(stmt);
     if (need_scalarize_) {
       need_scalarize_ = false;
+      // A part of a predicated statement cannot be scalarized alone, as it would drop the mask.
+      if (mask_.defined()) {
+        predication_failed_ = true;
+        return stmt;
+      }
       return Scalarize(stmt);
     } else {
       return ret;
@@ -386,6 +410,14 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
       writer->indices = indices;
       writer->LegalizeDType();
     }
+    if (mask_.defined()) {
+      Optional<PrimExpr> address = GetMaskedAddress(load->buffer, load->indices);
+      if (!address.defined() || load->dtype.lanes() != mask_.dtype().lanes()) {
+        predication_failed_ = true;
+        return std::move(load);
+      }
+      return Call(load->dtype, builtin::masked_load(), {address.value(), mask_});
+    }
 
     return std::move(load);
   }
@@ -460,6 +492,15 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
       writer->indices = indices;
       writer->value = BroadcastTo(value, total_lanes);
     }
+    if (mask_.defined()) {
+      Optional<PrimExpr> address = GetMaskedAddress(store->buffer, store->indices);
+      if (!address.defined() || store->value.dtype().lanes() != mask_.dtype().lanes()) {
+        predication_failed_ = true;
+        return std::move(store);
+      }
+      return Evaluate(
+          Call(DataType::Void(), builtin::masked_store(), {address.value(), store->value, mask_}));
+    }
 
     return std::move(store);
   }
@@ -468,6 +509,10 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
     if (op->kind == ForKind::kVectorized) {
       LOG(WARNING) << "Detect vectorize inside vectorized loop, ignoring...";
     }
+    if (mask_.defined()) {
+      predication_failed_ = true;
+      return GetRef<Stmt>(op);
+    }
     ICHECK(is_zero(op->min));
     ICHECK(!op->extent.dtype().is_vector());
     PrimExpr extent = this->VisitExpr(op->extent);
@@ -487,6 +532,22 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
     ICHECK(!op->condition.dtype().is_vector());
     PrimExpr condition = this->VisitExpr(op->condition);
     if (condition.dtype().is_vector()) {
+      if (mask_.defined()) {
+        predication_failed_ = true;
+        return GetRef<Stmt>(op);
+      }
+      if (enable_predication_ && !op->else_case.defined() && !need_scalarize_) {
+        // Mask the loads and the stores of the then case by the condition, e.g. the tail
+        // predicate `i0 * lanes + i1 < n` of a loop with symbolic extent split by the lanes.
+        mask_ = condition;
+        if (const auto* call = condition.as<CallNode>()) {
+          if (call->op.same_as(builtin::likely())) mask_ = call->args[0];
+        }
+        Stmt then_case = this->VisitStmt(op->then_case);
+        mask_ = PrimExpr();
+        if (!predication_failed_) return then_case;
+        predication_failed_ = false;
+      }
       return Scalarize(GetRef<Stmt>(op));
     }
     Stmt then_case = this->VisitStmt(op->then_case);
@@ -526,8 +587,21 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
       }
     }
   }
+  // Evaluate
+  Stmt VisitStmt_(const EvaluateNode* op) final {
+    if (mask_.defined()) {
+      // The side effects of the call cannot be masked
+      predication_failed_ = true;
+      return GetRef<Stmt>(op);
+    }
+    return StmtMutator::VisitStmt_(op);
+  }
   // Allocate
   Stmt VisitStmt_(const AllocateNode* op) final {
+    if (mask_.defined()) {
+      predication_failed_ = true;
+      return GetRef<Stmt>(op);
+    }
     // Mutate the condition
     PrimExpr condition = this->VisitExpr(op->condition);
     if (condition.dtype().is_vector()) {
@@ -589,11 +663,29 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   PrimExpr ramp_;
   // flag to mark requirment of scalarization.
   bool need_scalarize_{false};
+  // whether the stores guarded by a vector condition can be masked.
+  bool enable_predication_;
+  // the mask of the predicated statement being vectorized, undefined outside of it.
+  PrimExpr mask_;
+  // flag to mark that the predicated statement cannot be masked.
+  bool predication_failed_{false};
   // Let binding
   std::unordered_map<Var, PrimExpr, ObjectPtrHash, ObjectPtrEqual> let_binding_;
   // vectorizable property
   OpAttrMap<TVectorizable> op_vectorizable_ = Op::GetAttrMap<TVectorizable>("TVectorizable");
 
+  // The address of the first element of a masked access, which must be contiguous in the last
+  // index. Returns NullOpt for the other accesses, including the uniform ones.
+  Optional<PrimExpr> GetMaskedAddress(const Buffer& buffer, Array<PrimExpr> indices) {
+    if (buffer->dtype.lanes() != 1) return NullOpt;
+    for (size_t i = 0; i + 1 < indices.size(); ++i) {
+      if (indices[i].dtype().is_vector()) return NullOpt;
+    }
+    const auto* ramp = indices[indices.size() - 1].as<RampNode>();
+    if (ramp == nullptr || !is_one(ramp->stride)) return NullOpt;
+    indices.Set(indices.size() - 1, ramp->base);
+    return Call(DataType::Handle(), builtin::address_of(), {BufferLoad(buffer, indices)});
+  }
   // mutate array, with given lane requirement
   // when finished, p_lane updates the lane requirement.
   Array<PrimExpr> MutateArray(Array<PrimExpr> arr, int* p_lanes) {
@@ -656,6 +748,9 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
 
 class LoopVectorizer : public StmtMutator {
  public:
+  explicit LoopVectorizer(bool enable_predication = false)
+      : enable_predication_(enable_predication) {}
+
   Stmt VisitStmt_(const ForNode* op) final {
     if (op->kind == ForKind::kVectorized) {
       ICHECK(is_zero(op->min));
@@ -663,11 +758,15 @@ class LoopVectorizer : public StmtMutator {
       if (!extent_as_int || extent_as_int->value < 1) {
         LOG(FATAL) << "Failed to vectorize loop with extent " << op->extent;
       }
-      return Vectorizer(op->loop_var, static_cast<int>(extent_as_int->value))(op->body);
+      return Vectorizer(op->loop_var, static_cast<int>(extent_as_int->value),
+                        enable_predication_)(op->body);
     } else {
       return StmtMutator::VisitStmt_(op);
     }
   }
+
+ private:
+  bool enable_predication_;
 };
 
 Stmt VectorizeLoop(Stmt stmt) { return LoopVectorizer()(std::move(stmt)); }
@@ -694,7 +793,11 @@ Pass VectorizeLoop(bool enable_vectorize) {
   auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
     auto* n = f.CopyOnWrite();
     if (enable_vectorize) {
-      n->body = LoopVectorizer()(std::move(n->body));
+      auto cfg = ctx->GetConfig<VectorizeLoopConfig>("tir.VectorizeLoop");
+      if (!cfg.defined()) {
+        cfg = AttrsWithDefaultValues<VectorizeLoopConfig>();
+      }
+      n->body = LoopVectorizer(cfg.value()->enable_predication)(std::move(n->body));
     } else {
       n->body = VectorizeSkipper()(std::move(n->body));
     }
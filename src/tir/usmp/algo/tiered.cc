@@ -0,0 +1,142 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tir/analysis/usmp/algo/tiered.cc
+ * \brief This source contains the tiered_by_access algorithm for planning memory for USMP,
+ * which places the hot buffers in the fast pools of a memory hierarchy, e.g. the SRAM rather
+ * than the DDR.
+ *
+ * The BufferInfo objects are sorted by their density of accesses, the bytes accessed per byte
+ * of size as estimated by extract_buffer_info, and placed in that order. Each buffer lands in
+ * the candidate pool of the lowest access time that still fits it, adhering to the size_hint
+ * constraint, so that the small and hot buffers fill the fast pools first. The access time of a
+ * pool is estimated from its read and write bandwidths and its clock frequency.
+ */
+
+#include <tvm/tir/usmp/algo/greedy.h>
+#include <tvm/tir/usmp/algorithms.h>
+#include <tvm/tir/usmp/utils.h>
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace tir {
+namespace usmp {
+namespace algo {
+
+/*!
+ * \brief The estimated cycles to access a byte of a pool, the mean over the read and the write
+ * bandwidths that are known. The pools of unknown bandwidths are the slowest.
+ */
+static double CyclesPerByte(const PoolInfo& pool) {
+  double cycles = 0;
+  int num_known = 0;
+  for (const Integer& bandwidth :
+       {pool->read_bandwidth_bytes_per_cycle, pool->write_bandwidth_bytes_per_cycle}) {
+    if (bandwidth.defined() && bandwidth->value > 0) {
+      cycles += 1.0 / bandwidth->value;
+      ++num_known;
+    }
+  }
+  return num_known ? cycles / num_known : std::numeric_limits<double>::infinity();
+}
+
+/*!
+ * \brief This class implements the Tiered by access algorithm. Please refer to main
+ * documentation of the file for more details.
+ */
+class TieredAccess : public GreedyBase {
+ public:
+  TieredAccess() {}
+  Map<BufferInfo, PoolAllocation> PlanMemory(const Array<BufferInfo>& buffer_info_arr) {
+    std::vector<BufferInfo> buffer_info_vec(buffer_info_arr.begin(), buffer_info_arr.end());
+    auto density = [](const BufferInfo& buffer_info) {
+      int64_t size_bytes = std::max<int64_t>(buffer_info->size_bytes->value, 1);
+      return static_cast<double>(buffer_info->access_bytes) / size_bytes;
+    };
+    std::sort(buffer_info_vec.begin(), buffer_info_vec.end(),
+              [&](const BufferInfo& a, const BufferInfo& b) {
+                double density_a = density(a);
+                double density_b = density(b);
+                if (density_a == density_b) {
+                  if (a->size_bytes->value == b->size_bytes->value) {
+                    return std::string(a->name_hint->data) > std::string(b->name_hint->data);
+                  }
+                  return a->size_bytes->value > b->size_bytes->value;
+                }
+                return density_a > density_b;
+              });
+    return PostSortAllocation(buffer_info_vec);
+  }
+
+ protected:
+  /*!
+   * \brief Selects the pool of the lowest access time among the candidates with room for the
+   * buffer, the first one in the order of the candidates on ties.
+   */
+  PoolInfo SelectPlacementPool(
+      const BufferInfo& buf_info,
+      const std::unordered_map<PoolInfo, size_t, ObjectPtrHash, ObjectPtrEqual>& pool_offsets)
+      override {
+    // The times are compared in seconds when the clocks of all the pools are known, in cycles
+    // otherwise.
+    bool known_clocks = true;
+    for (const auto& pool_info : buf_info->pool_candidates) {
+      known_clocks = known_clocks && pool_info->clock_frequency_hz.defined() &&
+                     pool_info->clock_frequency_hz->value > 0;
+    }
+    PoolInfo selected_pool;
+    double selected_time = 0;
+    for (const auto& pool_info : buf_info->pool_candidates) {
+      if (!pool_offsets.count(pool_info)) continue;
+      double time = CyclesPerByte(pool_info);
+      if (known_clocks) {
+        time /= pool_info->clock_frequency_hz->value;
+      }
+      if (!selected_pool.defined() || time < selected_time) {
+        selected_pool = pool_info;
+        selected_time = time;
+      }
+    }
+    if (selected_pool.defined()) {
+      return selected_pool;
+    }
+    return GreedyBase::SelectPlacementPool(buf_info, pool_offsets);
+  }
+};
+
+Map<BufferInfo, PoolAllocation> TieredByAccess(const Array<BufferInfo>& buffer_info_arr,
+                                               const Integer& memory_pressure) {
+  return TieredAccess().PlanMemory(buffer_info_arr);
+}
+
+TVM_REGISTER_GLOBAL("tir.usmp.algo.tiered_by_access")
+    .set_body_typed([](Array<BufferInfo> buffer_info_arr, Integer memory_pressure) {
+      return TieredByAccess(buffer_info_arr, memory_pressure);
+    });
+
+}  // namespace algo
+}  // namespace usmp
+}  // namespace tir
+}  // namespace tvm
@@ -34,7 +34,9 @@
 #include <tvm/tir/usmp/analysis.h>
 #include <tvm/tir/usmp/utils.h>
 
+#include <limits>
 #include <stack>
+#include <unordered_map>
 
 #include "../../../runtime/thread_storage_scope.h"
 
@@ -80,6 +82,7 @@ class BufferInfoExtractor : public StmtExprVisitor {
   void VisitStmt_(const BufferStoreNode* op) override;
   void VisitStmt_(const ForNode* op) override;
 
+  void RecordAccess(const Buffer& buffer);
   void UpdateAliases(const Array<PrimExpr>& args, const PrimFunc& func);
   void RecordAllocateNodeInfo(const AllocateNode* op);
   void RecordAllocateConstNodeInfo(const AllocateConstNode* op);
@@ -130,6 +133,15 @@ class BufferInfoExtractor : public StmtExprVisitor {
    * \brief Indicates a count of stmts visited so far to use as a metric of liveness
    */
   int current_stmt_idx_ = 0;
+  /*!
+   * \brief The product of the constant extents of the loops around the visited stmt, which
+   * weights its accesses to the buffers.
+   */
+  int64_t loop_trip_count_ = 1;
+  /*!
+   * \brief The bytes accessed from each allocate, see BufferInfoNode::access_bytes.
+   */
+  std::unordered_map<Stmt, int64_t, ObjectPtrHash, ObjectPtrEqual> access_bytes_;
   /*!
    * \brief This structure is supposed to contain information around the scope
    * the visitor is currently in.
@@ -361,8 +373,17 @@ void BufferInfoExtractor::VisitStmt_(const ForNode* op) {
   }
   Call current_call = scope_stack_.top().call;
   PrimFunc current_primfunc = scope_stack_.top().func;
+  int64_t outer_trip_count = loop_trip_count_;
+  if (const auto* extent = op->extent.as<IntImmNode>()) {
+    if (extent->value > 0) {
+      loop_trip_count_ = loop_trip_count_ > std::numeric_limits<int64_t>::max() / extent->value
+                             ? std::numeric_limits<int64_t>::max()
+                             : loop_trip_count_ * extent->value;
+    }
+  }
   scope_stack_.push(si);
   StmtExprVisitor::VisitStmt_(op);
+  loop_trip_count_ = outer_trip_count;
   // Extending the liveness to beginning of for-loop next and end of the current for-loop
   for (const Allocate& allocate : scope_stack_.top().allocate_nodes) {
     AllocateInfo ai = allocate_infos[allocate->buffer_var];
@@ -384,12 +405,27 @@ void BufferInfoExtractor::VisitStmt_(const ForNode* op) {
   scope_stack_.pop();
 }
 
+void BufferInfoExtractor::RecordAccess(const Buffer& buffer) {
+  auto it = allocate_infos.find(buffer->data);
+  if (it == allocate_infos.end()) return;
+  int64_t bytes = buffer->dtype.bytes() * buffer->dtype.lanes();
+  int64_t& access_bytes = access_bytes_[it->second.Allocate];
+  int64_t max_bytes = std::numeric_limits<int64_t>::max();
+  if (loop_trip_count_ > (max_bytes - access_bytes) / bytes) {
+    access_bytes = max_bytes;
+  } else {
+    access_bytes += loop_trip_count_ * bytes;
+  }
+}
+
 void BufferInfoExtractor::VisitExpr_(const BufferLoadNode* op) {
+  RecordAccess(op->buffer);
   this->VisitExpr(op->buffer->data);
   StmtExprVisitor::VisitExpr_(op);
 }
 
 void BufferInfoExtractor::VisitStmt_(const BufferStoreNode* op) {
+  RecordAccess(op->buffer);
   this->VisitExpr(op->buffer->data);
   StmtExprVisitor::VisitStmt_(op);
 }
@@ -506,6 +542,12 @@ void BufferInfoExtractor::VisitExpr_(const CallNode* op) {
 
 BufferInfoAnalysis BufferInfoExtractor::operator()(const PrimFunc& main_func) {
   VisitPrimFunc(main_func, Call());
+  for (const auto& kv : buffer_info_map_) {
+    auto it = access_bytes_.find(kv.second);
+    if (it != access_bytes_.end()) {
+      kv.first->access_bytes = it->second;
+    }
+  }
 
   // Create a vector of liveness events
   // associated with each BufferNodes.
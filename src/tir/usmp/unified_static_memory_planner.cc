@@ -52,7 +52,8 @@ static std::unordered_map<String, std::function<Map<BufferInfo, PoolAllocation>(
                                       const Array<BufferInfo>&, const Integer&)>>
     algorithms{{"greedy_by_size", algo::GreedyBySize},
                {"greedy_by_conflicts", algo::GreedyByConflicts},
-               {"hill_climb", algo::HillClimb}};
+               {"hill_climb", algo::HillClimb},
+               {"tiered_by_access", algo::TieredByAccess}};
 
 IRModule PlanMemory(const IRModule& mod, String algo, bool use_workspace_io,
                     Optional<String> opt_custom_algo) {
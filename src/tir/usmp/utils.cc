@@ -54,11 +54,12 @@ void BufferInfoNode::SetConflicts(Array<ObjectRef> conflicting_buffer_info_objs)
 TVM_REGISTER_NODE_TYPE(BufferInfoNode);
 TVM_REGISTER_GLOBAL("tir.usmp.BufferInfo")
     .set_body_typed([](String name_hint, Integer size_bytes, Array<PoolInfo> pool_candidates,
-                       Integer alignment) {
-      if (!alignment.defined()) {
-        return BufferInfo(name_hint, size_bytes, pool_candidates);
-      }
-      return BufferInfo(name_hint, size_bytes, pool_candidates, alignment);
+                       Integer alignment, int64_t access_bytes) {
+      BufferInfo buffer_info = alignment.defined()
+                                   ? BufferInfo(name_hint, size_bytes, pool_candidates, alignment)
+                                   : BufferInfo(name_hint, size_bytes, pool_candidates);
+      buffer_info->access_bytes = access_bytes;
+      return buffer_info;
     });
 TVM_REGISTER_GLOBAL("tir.usmp.BufferInfoSetConflicts")
     .set_body_method<BufferInfo>(&BufferInfoNode::SetConflicts);
@@ -74,7 +75,8 @@ TVM_STATIC_IR_FUNCTOR(ReprPrinter, vtable)
                 << "name_hint=" << node->name_hint << ",\n  size_bytes=" << node->size_bytes
                 << ",\n  pool_candidates=" << node->pool_candidates
                 << ",\n  alignment=" << node->alignment << ",\n  kind=" << toString[node->kind]
-                << ",\n  conflicts=" << node->conflicts.size() << ")";
+                << ",\n  conflicts=" << node->conflicts.size()
+                << ",\n  access_bytes=" << node->access_bytes << ")";
     });
 
 BufferInfoAnalysis::BufferInfoAnalysis(Map<BufferInfo, tir::Stmt> buffer_info_stmts,
@@ -23,6 +23,12 @@
  */
 #include <tvm/topi/broadcast.h>
 #include <tvm/topi/einsum.h>
+#include <tvm/topi/reduction.h>
+#include <tvm/topi/transform.h>
+
+#include <array>
+#include <unordered_map>
+#include <utility>
 
 namespace tvm {
 namespace topi {
@@ -323,13 +329,383 @@ class EinsumBuilder {
   Optional<Array<PrimExpr>> ellipsis_shape_;
 };
 
+/*! \brief The set of the labels of a subscript. */
+using LabelSet = std::bitset<LABELRANGE>;
+
+static LabelSet ToLabelSet(const EinsumEquation::Subscript& subscript) {
+  LabelSet labels;
+  for (auto label : subscript) {
+    labels.set(static_cast<unsigned char>(label));
+  }
+  return labels;
+}
+
+/*!
+ * \brief Collect the extent of each label of an Einstein summation that can be decomposed into
+ * pairwise contractions.
+ * \return Whether the summation can be decomposed, i.e. it has at least two operands, no
+ * ellipsis, no label repeated in a subscript and the same constant extent for all the
+ * occurrences of a label.
+ */
+static bool GetPairwiseLabelExtents(const EinsumEquation& equation,
+                                    const Array<Array<PrimExpr>>& input_shapes,
+                                    std::unordered_map<EinsumEquation::Label, int64_t>* extents) {
+  if (equation.inputs.size() < 2 || equation.inputs.size() != input_shapes.size()) {
+    return false;
+  }
+  auto is_decomposable = [](const EinsumEquation::Subscript& subscript) {
+    LabelSet labels = ToLabelSet(subscript);
+    return !labels.test(static_cast<unsigned char>(EinsumEquation::kEllipsis)) &&
+           labels.count() == subscript.size();
+  };
+  for (size_t i = 0; i < equation.inputs.size(); ++i) {
+    const EinsumEquation::Subscript& subscript = equation.inputs[i];
+    if (!is_decomposable(subscript) || subscript.size() != input_shapes[i].size()) {
+      return false;
+    }
+    for (size_t j = 0; j < subscript.size(); ++j) {
+      const auto* extent = input_shapes[i][j].as<IntImmNode>();
+      if (extent == nullptr) {
+        return false;
+      }
+      auto it = extents->emplace(subscript[j], extent->value).first;
+      if (it->second != extent->value) {
+        return false;
+      }
+    }
+  }
+  if (!is_decomposable(equation.output)) {
+    return false;
+  }
+  for (auto label : equation.output) {
+    if (!extents->count(label)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*!
+ * \brief The search of the order of the pairwise contractions of an Einstein summation.
+ *
+ * The cost of a contraction is its number of multiply-adds, the product of the extents of the
+ * labels of the pair. The result of a contraction keeps the labels of the pair that another
+ * operand or the output still refers to.
+ */
+class ContractionPathFinder {
+ public:
+  using Path = std::vector<std::pair<int, int>>;
+
+  ContractionPathFinder(const EinsumEquation& equation,
+                        const std::unordered_map<EinsumEquation::Label, int64_t>& extents)
+      : output_(ToLabelSet(equation.output)) {
+    extents_.fill(1.0);
+    for (const auto& kv : extents) {
+      extents_[static_cast<unsigned char>(kv.first)] = static_cast<double>(kv.second);
+    }
+    for (const EinsumEquation::Subscript& subscript : equation.inputs) {
+      operands_.push_back(ToLabelSet(subscript));
+    }
+  }
+
+  /*!
+   * \brief Contract first the pair of the smallest result relative to the size of the pair, the
+   * fewest multiply-adds on ties.
+   */
+  Path Greedy() const {
+    std::vector<LabelSet> operands = operands_;
+    Path path;
+    while (operands.size() > 1) {
+      std::pair<int, int> best_pair{-1, -1};
+      double best_removed = 0, best_cost = 0;
+      for (int i = 0, n = operands.size(); i < n; ++i) {
+        for (int j = i + 1; j < n; ++j) {
+          double removed = Size(ResultLabels(operands, i, j)) - Size(operands[i]) -
+                           Size(operands[j]);
+          double cost = Size(operands[i] | operands[j]);
+          if (best_pair.first < 0 || removed < best_removed ||
+              (removed == best_removed && cost < best_cost)) {
+            best_pair = {i, j};
+            best_removed = removed;
+            best_cost = cost;
+          }
+        }
+      }
+      Contract(&operands, best_pair.first, best_pair.second);
+      path.push_back(best_pair);
+    }
+    return path;
+  }
+
+  /*! \brief Search all the orders for the fewest multiply-adds, bounded by the greedy order. */
+  Path Optimal() const {
+    Path greedy = Greedy();
+    if (operands_.size() > kMaxOptimalOperands) {
+      return greedy;
+    }
+    Path best_path = greedy;
+    double best_cost = Cost(greedy);
+    Path path;
+    Search(operands_, 0, &path, &best_cost, &best_path);
+    return best_path;
+  }
+
+ private:
+  /*! \brief The most operands searched exhaustively. */
+  static constexpr size_t kMaxOptimalOperands = 6;
+
+  double Size(const LabelSet& labels) const {
+    double size = 1;
+    for (size_t label = 0; label < labels.size(); ++label) {
+      if (labels.test(label)) size *= extents_[label];
+    }
+    return size;
+  }
+
+  LabelSet ResultLabels(const std::vector<LabelSet>& operands, int i, int j) const {
+    LabelSet needed = output_;
+    for (int k = 0, n = operands.size(); k < n; ++k) {
+      if (k != i && k != j) needed |= operands[k];
+    }
+    return (operands[i] | operands[j]) & needed;
+  }
+
+  /*! \brief Replace the pair by the result of their contraction at the end of the operands. */
+  void Contract(std::vector<LabelSet>* operands, int i, int j) const {
+    LabelSet result = ResultLabels(*operands, i, j);
+    operands->erase(operands->begin() + j);
+    operands->erase(operands->begin() + i);
+    operands->push_back(result);
+  }
+
+  double Cost(const Path& path) const {
+    std::vector<LabelSet> operands = operands_;
+    double cost = 0;
+    for (const auto& pair : path) {
+      cost += Size(operands[pair.first] | operands[pair.second]);
+      Contract(&operands, pair.first, pair.second);
+    }
+    return cost;
+  }
+
+  void Search(const std::vector<LabelSet>& operands, double cost, Path* path, double* best_cost,
+              Path* best_path) const {
+    if (operands.size() == 1) {
+      if (cost < *best_cost) {
+        *best_cost = cost;
+        *best_path = *path;
+      }
+      return;
+    }
+    for (int i = 0, n = operands.size(); i < n; ++i) {
+      for (int j = i + 1; j < n; ++j) {
+        double step_cost = cost + Size(operands[i] | operands[j]);
+        if (step_cost >= *best_cost) continue;
+        std::vector<LabelSet> next = operands;
+        Contract(&next, i, j);
+        path->emplace_back(i, j);
+        Search(next, step_cost, path, best_cost, best_path);
+        path->pop_back();
+      }
+    }
+  }
+
+  /*! \brief The labels of the output. */
+  LabelSet output_;
+  /*! \brief The labels of the operands. */
+  std::vector<LabelSet> operands_;
+  /*! \brief The extent of each label, 1 for the labels not in the summation. */
+  std::array<double, LABELRANGE> extents_;
+};
+
+/*!
+ * \brief Find the pairwise contractions of an Einstein summation.
+ * \return The path, empty if the summation is not decomposable.
+ */
+static ContractionPathFinder::Path FindContractionPath(const EinsumEquation& equation,
+                                                       const Array<Array<PrimExpr>>& input_shapes,
+                                                       const std::string& optimize) {
+  CHECK(optimize == "none" || optimize == "greedy" || optimize == "optimal")
+      << "ValueError: The einsum optimization must be none, greedy or optimal, but got "
+      << optimize;
+  std::unordered_map<EinsumEquation::Label, int64_t> extents;
+  if (optimize == "none" || !GetPairwiseLabelExtents(equation, input_shapes, &extents)) {
+    return {};
+  }
+  ContractionPathFinder finder(equation, extents);
+  return optimize == "greedy" ? finder.Greedy() : finder.Optimal();
+}
+
+Array<Array<Integer>> EinsumContractionPath(const std::string& subscripts_str,
+                                            const Array<Array<PrimExpr>>& input_shapes,
+                                            const std::string& optimize) {
+  EinsumEquation equation = EinsumEquation::FromString(subscripts_str);
+  Array<Array<Integer>> path;
+  for (const auto& pair : FindContractionPath(equation, input_shapes, optimize)) {
+    path.push_back({Integer(pair.first), Integer(pair.second)});
+  }
+  return path;
+}
+
+/*!
+ * \brief Contract a pair of operands as a batched matmul.
+ *
+ * The labels of a single operand that the result does not keep are summed first. The labels of
+ * the result in both operands are the batch axes, the other labels in both operands the reduction
+ * axes, the labels of the result in a single operand the rows or the columns. The operands are
+ * transposed and reshaped to [batch, rows, reduction] and [batch, reduction, columns], and the
+ * product back to the result.
+ */
+static Tensor ContractPair(Tensor lhs, EinsumEquation::Subscript lhs_subscript, Tensor rhs,
+                           EinsumEquation::Subscript rhs_subscript,
+                           const EinsumEquation::Subscript& result_subscript,
+                           const std::string& name, const std::string& tag) {
+  LabelSet result_labels = ToLabelSet(result_subscript);
+  auto sum_unused = [&](Tensor* operand, EinsumEquation::Subscript* subscript,
+                        const EinsumEquation::Subscript& other) {
+    LabelSet used = result_labels | ToLabelSet(other);
+    Array<Integer> axes;
+    EinsumEquation::Subscript kept;
+    for (int i = 0, n = subscript->size(); i < n; ++i) {
+      if (used.test(static_cast<unsigned char>((*subscript)[i]))) {
+        kept.push_back((*subscript)[i]);
+      } else {
+        axes.push_back(i);
+      }
+    }
+    if (!axes.empty()) {
+      *operand = topi::sum(*operand, axes);
+      *subscript = std::move(kept);
+    }
+  };
+  sum_unused(&lhs, &lhs_subscript, rhs_subscript);
+  sum_unused(&rhs, &rhs_subscript, lhs_subscript);
+
+  LabelSet lhs_labels = ToLabelSet(lhs_subscript);
+  LabelSet rhs_labels = ToLabelSet(rhs_subscript);
+  EinsumEquation::Subscript batch, rows, columns, reduction;
+  for (auto label : result_subscript) {
+    bool in_lhs = lhs_labels.test(static_cast<unsigned char>(label));
+    bool in_rhs = rhs_labels.test(static_cast<unsigned char>(label));
+    (in_lhs && in_rhs ? batch : in_lhs ? rows : columns).push_back(label);
+  }
+  for (auto label : lhs_subscript) {
+    if (rhs_labels.test(static_cast<unsigned char>(label)) &&
+        !result_labels.test(static_cast<unsigned char>(label))) {
+      reduction.push_back(label);
+    }
+  }
+
+  std::unordered_map<EinsumEquation::Label, PrimExpr> extents;
+  for (int i = 0, n = lhs_subscript.size(); i < n; ++i) extents[lhs_subscript[i]] = lhs->shape[i];
+  for (int i = 0, n = rhs_subscript.size(); i < n; ++i) extents[rhs_subscript[i]] = rhs->shape[i];
+  auto extent_of = [&](const EinsumEquation::Subscript& labels) {
+    PrimExpr extent = Integer(1);
+    for (auto label : labels) extent = extent * extents.at(label);
+    return extent;
+  };
+  // Transpose an operand to the given order of its labels, then reshape it to the given shape.
+  auto to_layout = [&](const Tensor& operand, const EinsumEquation::Subscript& from,
+                       const std::vector<EinsumEquation::Subscript>& groups) {
+    EinsumEquation::Subscript to;
+    Array<PrimExpr> shape;
+    for (const auto& group : groups) {
+      to.insert(to.end(), group.begin(), group.end());
+      shape.push_back(extent_of(group));
+    }
+    Tensor result = operand;
+    if (to != from) {
+      Array<Integer> axes;
+      for (auto label : to) {
+        axes.push_back(static_cast<int>(std::find(from.begin(), from.end(), label) - from.begin()));
+      }
+      result = topi::transpose(result, axes, name + "_transpose");
+    }
+    return topi::reshape(result, shape, name + "_reshape");
+  };
+  Tensor a = to_layout(lhs, lhs_subscript, {batch, rows, reduction});
+  Tensor b = to_layout(rhs, rhs_subscript, {batch, reduction, columns});
+
+  IterVar k = reduce_axis(Range(0, a->shape[2]), "k");
+  Tensor product = te::compute(
+      {a->shape[0], a->shape[1], b->shape[2]},
+      [&](const Var& n, const Var& i, const Var& j) {
+        return tvm::sum(a(n, i, k->var) * b(n, k->var, j), {k});
+      },
+      name + "_matmul", tag);
+
+  // Reshape the product back to the labels of the result, in their order.
+  EinsumEquation::Subscript product_subscript;
+  Array<PrimExpr> product_shape;
+  for (const auto& group : {batch, rows, columns}) {
+    for (auto label : group) {
+      product_subscript.push_back(label);
+      product_shape.push_back(extents.at(label));
+    }
+  }
+  if (product_subscript == result_subscript) {
+    return topi::reshape(product, product_shape, name);
+  }
+  Tensor result = topi::reshape(product, product_shape, name + "_reshape");
+  Array<Integer> axes;
+  for (auto label : result_subscript) {
+    axes.push_back(static_cast<int>(
+        std::find(product_subscript.begin(), product_subscript.end(), label) -
+        product_subscript.begin()));
+  }
+  return topi::transpose(result, axes, name);
+}
+
+/*! \brief Compute an Einstein summation as the pairwise contractions of a path. */
+static Tensor ContractPairwise(const EinsumEquation& equation, const Array<Tensor>& inputs,
+                               const ContractionPathFinder::Path& path, const std::string& name,
+                               const std::string& tag) {
+  std::vector<EinsumEquation::Subscript> subscripts = equation.inputs;
+  std::vector<Tensor> operands(inputs.begin(), inputs.end());
+  for (size_t step = 0; step < path.size(); ++step) {
+    int i = path[step].first, j = path[step].second;
+    EinsumEquation::Subscript result_subscript;
+    if (step + 1 == path.size()) {
+      result_subscript = equation.output;
+    } else {
+      // Keep the labels still referred to, in their order in the pair.
+      LabelSet needed = ToLabelSet(equation.output);
+      for (int k = 0, n = subscripts.size(); k < n; ++k) {
+        if (k != i && k != j) needed |= ToLabelSet(subscripts[k]);
+      }
+      for (const auto* subscript : {&subscripts[i], &subscripts[j]}) {
+        for (auto label : *subscript) {
+          if (needed.test(static_cast<unsigned char>(label))) {
+            result_subscript.push_back(label);
+            needed.reset(static_cast<unsigned char>(label));
+          }
+        }
+      }
+    }
+    std::string step_name = step + 1 == path.size() ? name : name + "_" + std::to_string(step);
+    Tensor result = ContractPair(operands[i], subscripts[i], operands[j], subscripts[j],
+                                 result_subscript, step_name, tag);
+    for (int k : {j, i}) {
+      operands.erase(operands.begin() + k);
+      subscripts.erase(subscripts.begin() + k);
+    }
+    operands.push_back(result);
+    subscripts.push_back(result_subscript);
+  }
+  return operands[0];
+}
+
 Tensor einsum(const std::string& subscripts_str, const Array<Tensor> inputs, std::string name,
-              std::string tag) {
+              std::string tag, std::string optimize) {
   EinsumEquation equation = EinsumEquation::FromString(subscripts_str);
   Array<Array<PrimExpr>> input_shapes;
   for (const Tensor& input : inputs) {
     input_shapes.push_back(input->shape);
   }
+  ContractionPathFinder::Path path = FindContractionPath(equation, input_shapes, optimize);
+  if (!path.empty()) {
+    return ContractPairwise(equation, inputs, path, name, tag);
+  }
   EinsumBuilder einsum_builder = EinsumBuilder(equation, input_shapes);
   auto output_shape = einsum_builder.InferShape();
   return te::compute(
@@ -346,8 +722,14 @@ Array<PrimExpr> InferEinsumShape(const std::string& subscripts,
 }
 
 TVM_REGISTER_GLOBAL("topi.einsum").set_body([](TVMArgs args, TVMRetValue* rv) {
-  *rv = einsum(args[0], args[1]);
+  if (args.size() > 2) {
+    *rv = einsum(args[0], args[1], "T_einsum", kEinsum, args[2]);
+  } else {
+    *rv = einsum(args[0], args[1]);
+  }
 });
 
+TVM_REGISTER_GLOBAL("topi.einsum_path").set_body_typed(EinsumContractionPath);
+
 }  // namespace topi
 }  // namespace tvm
@@ -20,6 +20,8 @@
 #include <gtest/gtest.h>
 #include <tvm/runtime/logging.h>
 
+#include <atomic>
+
 #include "../src/runtime/hexagon/hexagon_thread_manager.h"
 
 using namespace tvm::runtime;
@@ -322,3 +324,39 @@ TEST_F(HexagonThreadManagerTest, dispatch_writes) {
     CHECK_EQ(array[i], truth[i]);
   }
 }
+
+struct ParallelRecord {
+  std::atomic<int> ran{0};
+  std::atomic<int> after_barrier{0};
+  int num_task{0};
+};
+
+int record_task(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+  ParallelRecord* record = static_cast<ParallelRecord*>(cdata);
+  record->ran.fetch_add(1 << task_id);
+  record->num_task = penv->num_task;
+  TVMBackendParallelBarrier(task_id, penv);
+  // every task has run its first half once past the barrier
+  if (record->ran.load() == (1 << penv->num_task) - 1) record->after_barrier.fetch_add(1);
+  return 0;
+}
+
+TEST_F(HexagonThreadManagerTest, parallel_launch) {
+  ParallelRecord record;
+  CHECK_EQ(htm->ParallelLaunch(record_task, &record, 0), 0);
+  CHECK_GE(record.num_task, 1);
+  CHECK_LE(record.num_task, threads + 1);
+  CHECK_EQ(record.ran.load(), (1 << record.num_task) - 1);
+  CHECK_EQ(record.after_barrier.load(), record.num_task);
+}
+
+int nested_launch(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+  // the nested launch runs inline, as a single task
+  ParallelRecord inner;
+  HexagonThreadManager* htm = static_cast<HexagonThreadManager*>(cdata);
+  return htm->ParallelLaunch(record_task, &inner, 4) == 0 && inner.num_task == 1 ? 0 : -1;
+}
+
+TEST_F(HexagonThreadManagerTest, parallel_launch_nested) {
+  CHECK_EQ(htm->ParallelLaunch(nested_launch, htm, 2), 0);
+}
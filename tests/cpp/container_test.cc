@@ -22,6 +22,7 @@
 #include <tvm/runtime/container/adt.h>
 #include <tvm/runtime/container/array.h>
 #include <tvm/runtime/container/map.h>
+#include <tvm/runtime/container/shape_tuple.h>
 #include <tvm/runtime/container/string.h>
 #include <tvm/tir/function.h>
 #include <tvm/tir/op.h>
@@ -853,3 +854,20 @@ TEST(Optional, PackedCall) {
   test_ffi(s, static_cast<int>(kTVMObjectHandle));
   test_ffi(String(s), static_cast<int>(kTVMObjectRValueRefArg));
 }
+
+TEST(ShapeTuple, InlineStorage) {
+  std::vector<ShapeTuple::index_type> dims = {1, 2, 3, 4, 5, 6, 7, 8};
+  for (size_t ndim = 0; ndim <= dims.size(); ++ndim) {
+    ShapeTuple from_vector(std::vector<ShapeTuple::index_type>(dims.begin(), dims.begin() + ndim));
+    ShapeTuple from_iter(dims.begin(), dims.begin() + ndim);
+    ICHECK_EQ(from_vector.size(), ndim);
+    ICHECK_EQ(from_iter.size(), ndim);
+    for (size_t i = 0; i < ndim; ++i) {
+      ICHECK_EQ(from_vector[i], dims[i]);
+      ICHECK_EQ(from_iter[i], dims[i]);
+    }
+    ShapeTuple copy = from_vector;
+    ICHECK(copy.same_as(from_vector));
+  }
+  ICHECK_EQ(ShapeTuple().size(), 0);
+}
@@ -24,6 +24,11 @@
 #include <tvm/tir/expr.h>
 #include <tvm/tir/transform.h>
 
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
 TEST(PackedFunc, Basic) {
   using namespace tvm;
   using namespace tvm::tir;
@@ -307,3 +312,40 @@ TEST(TypedPackedFunc, RValue) {
     tf(1, true);
   }
 }
+
+TEST(Registry, ConcurrentLookup) {
+  using namespace tvm::runtime;
+  Registry::Register("test.registry.concurrent.0").set_body_typed([]() { return 0; });
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  std::atomic<int> num_missing{0};
+  for (int i = 0; i < 4; ++i) {
+    readers.emplace_back([&]() {
+      while (!done.load()) {
+        if (Registry::Get("test.registry.concurrent.0") == nullptr) ++num_missing;
+      }
+    });
+  }
+  // Register enough functions to grow the table while the readers look up.
+  for (int i = 1; i <= 4096; ++i) {
+    std::string name = "test.registry.concurrent." + std::to_string(i);
+    Registry::Register(name).set_body_typed([i]() { return i; });
+    ICHECK(Registry::Get(name) != nullptr);
+  }
+  done = true;
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+  ICHECK_EQ(num_missing.load(), 0);
+  int ret = (*Registry::Get("test.registry.concurrent.4096"))();
+  ICHECK_EQ(ret, 4096);
+  for (int i = 0; i <= 4096; ++i) {
+    ICHECK(Registry::Remove("test.registry.concurrent." + std::to_string(i)));
+  }
+  ICHECK(Registry::Get("test.registry.concurrent.0") == nullptr);
+  ICHECK(!Registry::Remove("test.registry.concurrent.0"));
+  Registry::Register("test.registry.concurrent.0").set_body_typed([]() { return 1; });
+  ret = (*Registry::Get("test.registry.concurrent.0"))();
+  ICHECK_EQ(ret, 1);
+  Registry::Remove("test.registry.concurrent.0");
+}
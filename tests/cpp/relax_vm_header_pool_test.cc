@@ -0,0 +1,75 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/runtime/relax_vm/memory_manager.h>
+
+using namespace tvm::runtime;
+using namespace tvm::runtime::relax_vm;
+
+namespace {
+
+Storage MakePooledStorage(HeaderPool* pool, size_t nbytes) {
+  Device dev{kDLCPU, 0};
+  DLDataType dtype{kDLFloat, 32, 1};
+  ObjectPtr<StorageObj> storage_obj = pool->MakeStorage();
+  storage_obj->buffer = MemoryManager::GetOrCreateAllocator(dev, kNaive)->Alloc(nbytes, 64, dtype);
+  return Storage(storage_obj);
+}
+
+}  // namespace
+
+TEST(RelaxVMHeaderPool, ReuseHeaders) {
+  HeaderPool* pool = HeaderPool::Create();
+  DLDataType dtype{kDLFloat, 32, 1};
+
+  const Object* storage_header;
+  const Object* array_header;
+  {
+    Storage storage = MakePooledStorage(pool, 64);
+    NDArray arr = storage->AllocNDArray(0, ShapeTuple({4, 4}), dtype);
+    storage_header = storage.get();
+    array_header = arr.get();
+  }
+  {
+    Storage storage = MakePooledStorage(pool, 64);
+    NDArray arr = storage->AllocNDArray(0, ShapeTuple({2, 8}), dtype);
+    EXPECT_EQ(storage.get(), storage_header);
+    EXPECT_EQ(arr.get(), array_header);
+    EXPECT_EQ(arr.Shape()[0], 2);
+    EXPECT_EQ(arr.Shape()[1], 8);
+  }
+  pool->DecRef();
+}
+
+TEST(RelaxVMHeaderPool, ArrayOutlivesStorageAndPool) {
+  HeaderPool* pool = HeaderPool::Create();
+  DLDataType dtype{kDLFloat, 32, 1};
+
+  NDArray arr;
+  {
+    Storage storage = MakePooledStorage(pool, 64);
+    arr = storage->AllocNDArray(0, ShapeTuple({16}), dtype);
+  }
+  // the array keeps both its storage and the pool alive
+  pool->DecRef();
+  static_cast<float*>(arr->data)[15] = 1.0f;
+  EXPECT_EQ(static_cast<float*>(arr->data)[15], 1.0f);
+  arr = NDArray();
+}
@@ -0,0 +1,74 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include <tvm/runtime/device_api.h>
+
+#include "../../../src/runtime/workspace_pool.h"
+
+namespace tvm {
+namespace runtime {
+namespace {
+
+TEST(WorkspacePool, SizeClassReuse) {
+  Device dev{kDLCPU, 0};
+  WorkspacePool pool(kDLCPU, DeviceAPI::Get(dev));
+  // the sizes of dynamic shapes within a size class share a page
+  void* a = pool.AllocWorkspace(dev, 100000);
+  pool.FreeWorkspace(dev, a);
+  void* b = pool.AllocWorkspace(dev, 110000);
+  EXPECT_EQ(a, b);
+  WorkspacePool::Stats stats = pool.GetStats(dev);
+  EXPECT_EQ(stats.num_misses, 1);
+  EXPECT_EQ(stats.num_hits, 1);
+  EXPECT_GE(stats.bytes_in_use, 110000);
+  EXPECT_EQ(stats.bytes_cached, 0);
+
+  void* c = pool.AllocWorkspace(dev, 4096);
+  pool.FreeWorkspace(dev, b);
+  pool.FreeWorkspace(dev, c);
+  stats = pool.GetStats(dev);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_GT(stats.bytes_cached, 0);
+
+  pool.Trim(dev);
+  stats = pool.GetStats(dev);
+  EXPECT_EQ(stats.bytes_cached, 0);
+  EXPECT_EQ(stats.num_releases, 2);
+}
+
+TEST(WorkspacePool, MaxCachedBytes) {
+  Device dev{kDLCPU, 0};
+  WorkspacePool pool(kDLCPU, DeviceAPI::Get(dev));
+  WorkspacePool::SetMaxCachedBytes(8192);
+  void* a = pool.AllocWorkspace(dev, 4096);
+  void* b = pool.AllocWorkspace(dev, 1 << 20);
+  pool.FreeWorkspace(dev, b);
+  pool.FreeWorkspace(dev, a);
+  WorkspacePool::SetMaxCachedBytes(-1);
+  // the largest page is returned to the device
+  WorkspacePool::Stats stats = pool.GetStats(dev);
+  EXPECT_EQ(stats.num_releases, 1);
+  EXPECT_EQ(stats.bytes_cached, 4096);
+}
+
+}  // namespace
+}  // namespace runtime
+}  // namespace tvm
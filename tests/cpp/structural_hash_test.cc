@@ -0,0 +1,59 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/node/structural_equal.h>
+#include <tvm/node/structural_hash.h>
+#include <tvm/tir/op.h>
+
+#include <unordered_set>
+
+TEST(CachedStructuralHash, Basic) {
+  using namespace tvm;
+  using namespace tvm::tir;
+  Var x("x");
+  PrimExpr a = max(x + 1, 100);
+  PrimExpr b = max(x + 1, 100);
+  PrimExpr c = max(x + 2, 100);
+
+  CachedStructuralHash hash;
+  size_t hashed_value;
+  ICHECK(!hash.Lookup(a, &hashed_value));
+  ICHECK_EQ(hash(a), StructuralHash()(a));
+  ICHECK(hash.Lookup(a, &hashed_value));
+  ICHECK_EQ(hashed_value, StructuralHash()(a));
+  ICHECK_EQ(hash(a), hash(b));
+  ICHECK_NE(hash(a), hash(c));
+  // The copies of a hasher share its cache, the other hashers do not.
+  ICHECK(CachedStructuralHash(hash).Lookup(b, &hashed_value));
+  ICHECK(!CachedStructuralHash().Lookup(a, &hashed_value));
+}
+
+TEST(CachedStructuralHash, Container) {
+  using namespace tvm;
+  using namespace tvm::tir;
+  Var x("x");
+  std::unordered_set<PrimExpr, CachedStructuralHash, StructuralEqual> seen;
+  seen.insert(x + 1);
+  seen.insert(x + 1);
+  seen.insert(x + 2);
+  ICHECK_EQ(seen.size(), 2);
+  size_t hashed_value;
+  ICHECK(seen.hash_function().Lookup(*seen.begin(), &hashed_value));
+}
@@ -124,6 +124,46 @@ TEST(ThreadingBackend, TVMBackendParallelLaunch) {
   EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
 }
 
+static FTVMParallelLambda nested_launch_task_id = [](int task_id, TVMParallelGroupEnv* penv,
+                                                     void* cdata) -> int {
+  auto* data = reinterpret_cast<std::atomic<size_t>*>(cdata);
+  // The nested launch runs inline on the thread of the task, rather than failing.
+  std::atomic<size_t> acc(0);
+  int ret = TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0);
+  EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+  data->fetch_add(1, std::memory_order_relaxed);
+  return ret;
+};
+
+TEST(ThreadingBackend, TVMBackendParallelLaunchNested) {
+  std::atomic<size_t> num_task(0);
+  EXPECT_EQ(TVMBackendParallelLaunch(nested_launch_task_id, &num_task, 0), 0);
+  EXPECT_GE(num_task.load(std::memory_order_relaxed), 1);
+}
+
+static FTVMParallelLambda count_num_task = [](int task_id, TVMParallelGroupEnv* penv,
+                                              void* cdata) -> int {
+  reinterpret_cast<std::atomic<int>*>(cdata)->store(penv->num_task);
+  return 0;
+};
+
+TEST(ThreadingBackend, NamedThreadPool) {
+  tvm::runtime::threading::CreateThreadPool("test_pool", {0, 0});
+  std::atomic<int> num_task(0);
+  {
+    tvm::runtime::threading::ThreadPoolScope scope("test_pool");
+    // The launches run on the two workers of the pool.
+    EXPECT_EQ(TVMBackendParallelLaunch(count_num_task, &num_task, 0), 0);
+    EXPECT_EQ(num_task.load(), 2);
+    std::atomic<size_t> acc(0);
+    EXPECT_EQ(TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0), 0);
+    EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+  }
+  EXPECT_EQ(tvm::runtime::threading::AttachThreadPool(""), "");
+  tvm::runtime::threading::DestroyThreadPool("test_pool");
+  EXPECT_ANY_THROW(tvm::runtime::threading::AttachThreadPool("test_pool"));
+}
+
 TEST(ThreadingBackend, TVMBackendParallelLaunchMultipleThreads) {
   // TODO(tulloch) use parameterised tests when available.
   size_t num_jobs_per_thread = 3;
@@ -0,0 +1,227 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+/*!
+ * \file relax_vm_bench.cc
+ * \brief Microbenchmarks of the instruction dispatch and the builtins of the Relax VM.
+ *
+ * Each benchmark builds an executable with the ExecBuilder whose function repeats the measured
+ * instruction, and reports the time per instruction as time_per_instr. The heap allocations are
+ * counted by replacing the global operator new, and reported per call of the function as
+ * allocs_per_call.
+ */
+#include <benchmark/benchmark.h>
+#include <tvm/relax/exec_builder.h>
+#include <tvm/runtime/container/shape_tuple.h>
+#include <tvm/runtime/memory.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/relax_vm/memory_manager.h>
+#include <tvm/runtime/relax_vm/vm.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+std::atomic<int64_t> num_allocs{0};
+}  // namespace
+
+void* operator new(size_t size) {
+  num_allocs.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) return ptr;
+  throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+
+namespace tvm {
+namespace relax {
+namespace {
+
+using vm::Instruction;
+using Arg = vm::Instruction::Arg;
+
+TVM_REGISTER_GLOBAL("bench.vm.identity")
+    .set_body([](runtime::TVMArgs args, runtime::TVMRetValue* rv) { *rv = args[0]; });
+
+TVM_REGISTER_GLOBAL("bench.vm.noop")
+    .set_body([](runtime::TVMArgs args, runtime::TVMRetValue* rv) {});
+
+/*! \brief The number of repeated instructions of the functions of the benchmarks. */
+constexpr int64_t kNumInstrs = 100;
+
+/*! \brief Load the executable in a VM on the CPU. */
+runtime::Module LoadVM(const ExecBuilder& builder, runtime::relax_vm::AllocatorType alloc_type,
+                       runtime::relax_vm::DispatchMode mode) {
+  runtime::Module exec(builder->Get());
+  runtime::Module vm = exec.GetFunction("vm_load_executable")();
+  vm.GetFunction("vm_initialization")(static_cast<int>(kDLCPU), 0, static_cast<int>(alloc_type));
+  vm.GetFunction("set_dispatch_mode")(static_cast<int>(mode));
+  return vm;
+}
+
+runtime::NDArray MakeInput() {
+  return runtime::NDArray::Empty(runtime::ShapeTuple({1}), DLDataType{kDLFloat, 32, 1},
+                                 Device{kDLCPU, 0});
+}
+
+/*! \brief Call main in the benchmark loop, reporting the counters of num_instrs instructions. */
+void RunMain(benchmark::State& state, runtime::Module vm, int64_t num_instrs) {
+  runtime::PackedFunc main = vm.GetFunction("main");
+  runtime::NDArray x = MakeInput();
+  main(x);
+  int64_t allocs_before = num_allocs.load();
+  for (auto _ : state) {
+    main(x);
+  }
+  state.counters["time_per_instr"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * num_instrs),
+      benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+  state.counters["allocs_per_call"] =
+      benchmark::Counter(static_cast<double>(num_allocs.load() - allocs_before),
+                         benchmark::Counter::kAvgIterations);
+}
+
+/*! \brief A chain of calls to an identity function, mostly the cost of the dispatch loop. */
+void RunLoopDispatch(benchmark::State& state) {
+  int64_t num_instrs = state.range(0);
+  ExecBuilder builder = ExecBuilderNode::Create();
+  builder->EmitFunction("main", 1, {"x"});
+  for (int64_t i = 0; i < num_instrs; ++i) {
+    builder->EmitCall("bench.vm.identity", {Arg(Instruction::kRegister, i)}, i + 1);
+  }
+  builder->EmitRet(num_instrs);
+  auto mode = static_cast<runtime::relax_vm::DispatchMode>(state.range(1));
+  RunMain(state, LoadVM(builder, runtime::relax_vm::kPooled, mode), num_instrs);
+}
+BENCHMARK(RunLoopDispatch)
+    ->ArgNames({"instrs", "threaded"})
+    ->Args({1000, static_cast<int>(runtime::relax_vm::DispatchMode::kSwitch)})
+    ->Args({1000, static_cast<int>(runtime::relax_vm::DispatchMode::kThreaded)});
+
+/*! \brief Calls of a no-op function with a number of register arguments, the argument setup. */
+void RunInstrCall(benchmark::State& state) {
+  int64_t num_args = state.range(0);
+  ExecBuilder builder = ExecBuilderNode::Create();
+  builder->EmitFunction("main", 1, {"x"});
+  std::vector<Arg> args(num_args, Arg(Instruction::kRegister, 0));
+  for (int64_t i = 0; i < kNumInstrs; ++i) {
+    builder->EmitCall("bench.vm.noop", args, Instruction::kVoidArg);
+  }
+  builder->EmitRet(0);
+  RunMain(state,
+          LoadVM(builder, runtime::relax_vm::kPooled, runtime::relax_vm::DispatchMode::kSwitch),
+          kNumInstrs);
+}
+BENCHMARK(RunInstrCall)->ArgName("args")->Arg(0)->Arg(1)->Arg(4)->Arg(8);
+
+/*! \brief Allocate a storage and a tensor in it, per allocator. */
+void AllocStorageTensor(benchmark::State& state) {
+  ExecBuilder builder = ExecBuilderNode::Create();
+  builder->EmitFunction("main", 1, {"x"});
+  runtime::TVMRetValue size, shape, dtype;
+  size = runtime::ShapeTuple({4096});
+  shape = runtime::ShapeTuple({1024});
+  dtype = DLDataType{kDLFloat, 32, 1};
+  Arg size_arg(Instruction::kConstIdx, builder->EmitConstant(size));
+  Arg shape_arg(Instruction::kConstIdx, builder->EmitConstant(shape));
+  Arg dtype_arg(Instruction::kConstIdx, builder->EmitConstant(dtype));
+  for (int64_t i = 0; i < kNumInstrs; ++i) {
+    builder->EmitCall("vm.builtin.alloc_storage",
+                      {Arg(Instruction::kVMRegister), size_arg, Arg(Instruction::kImmediate, 0),
+                       dtype_arg},
+                      1);
+    builder->EmitCall("vm.builtin.alloc_tensor",
+                      {Arg(Instruction::kRegister, 1), Arg(Instruction::kImmediate, 0), shape_arg,
+                       dtype_arg},
+                      2);
+  }
+  builder->EmitRet(2);
+  auto alloc_type = static_cast<runtime::relax_vm::AllocatorType>(state.range(0));
+  RunMain(state, LoadVM(builder, alloc_type, runtime::relax_vm::DispatchMode::kSwitch),
+          2 * kNumInstrs);
+}
+BENCHMARK(AllocStorageTensor)
+    ->ArgName("allocator")
+    ->Arg(runtime::relax_vm::kNaive)
+    ->Arg(runtime::relax_vm::kPooled);
+
+/*! \brief Store the shape of the input in the shape heap and load it back. */
+void StoreLoadShape(benchmark::State& state) {
+  ExecBuilder builder = ExecBuilderNode::Create();
+  builder->EmitFunction("main", 1, {"x"});
+  runtime::TVMRetValue heap_size;
+  heap_size = runtime::ShapeTuple({2});
+  builder->EmitCall("vm.builtin.alloc_shape_heap",
+                    {Arg(Instruction::kVMRegister),
+                     Arg(Instruction::kConstIdx, builder->EmitConstant(heap_size))},
+                    1);
+  builder->EmitCall("vm.builtin.shape_of", {Arg(Instruction::kRegister, 0)}, 2);
+  for (int64_t i = 0; i < kNumInstrs; ++i) {
+    builder->EmitStoreShape(2, 1, {0});
+    builder->EmitLoadShape(1, {0}, 3);
+  }
+  builder->EmitRet(3);
+  RunMain(state,
+          LoadVM(builder, runtime::relax_vm::kPooled, runtime::relax_vm::DispatchMode::kSwitch),
+          2 * kNumInstrs);
+}
+BENCHMARK(StoreLoadShape);
+
+/*! \brief Invoke a closure of a Relax function returning its argument. */
+void InvokeClosure(benchmark::State& state) {
+  ExecBuilder builder = ExecBuilderNode::Create();
+  builder->EmitFunction("callee", 1, {"x"});
+  builder->EmitRet(0);
+  builder->EmitFunction("main", 1, {"x"});
+  runtime::TVMRetValue callee;
+  callee = runtime::String("callee");
+  builder->EmitCall("vm.builtin.alloc_closure",
+                    {Arg(Instruction::kConstIdx, builder->EmitConstant(callee))}, 1);
+  for (int64_t i = 0; i < kNumInstrs; ++i) {
+    builder->EmitCall("vm.builtin.invoke_closure",
+                      {Arg(Instruction::kVMRegister), Arg(Instruction::kRegister, 1),
+                       Arg(Instruction::kRegister, 0)},
+                      2);
+  }
+  builder->EmitRet(2);
+  RunMain(state,
+          LoadVM(builder, runtime::relax_vm::kPooled, runtime::relax_vm::DispatchMode::kSwitch),
+          kNumInstrs);
+}
+BENCHMARK(InvokeClosure);
+
+}  // namespace
+}  // namespace relax
+}  // namespace tvm
+
+BENCHMARK_MAIN();
@@ -0,0 +1,148 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "../../src/runtime/crt/memory/arena_allocator.c"
+
+#include <gtest/gtest.h>
+#include <tvm/runtime/crt/arena_allocator.h>
+
+static const DLDevice kCPU = {kDLCPU, 0};
+
+/*
+ * Tests the allocations are aligned and never reused before the arena is sealed.
+ */
+TEST(ArenaAllocatorTest, AllocateBeforeSeal) {
+  TVM_CRT_DEFINE_STATIC_ARENA(arena, 1024);
+  MemoryManagerInterface* mgr = NULL;
+  ASSERT_EQ(ArenaMemoryManagerCreate(&mgr, arena, sizeof(arena)), kTvmErrorNoError);
+
+  void* a = NULL;
+  void* b = NULL;
+  ASSERT_EQ(mgr->Allocate(mgr, 1, kCPU, &a), kTvmErrorNoError);
+  ASSERT_EQ(mgr->Allocate(mgr, 20, kCPU, &b), kTvmErrorNoError);
+  EXPECT_EQ((uintptr_t)a % TVM_RUNTIME_ALLOC_ALIGNMENT_BYTES, 0);
+  EXPECT_EQ((uint8_t*)b - (uint8_t*)a, TVM_RUNTIME_ALLOC_ALIGNMENT_BYTES);
+
+  // Releasing the last allocation does not make its memory available again.
+  ASSERT_EQ(mgr->Free(mgr, b, kCPU), kTvmErrorNoError);
+  void* c = NULL;
+  ASSERT_EQ(mgr->Allocate(mgr, 4, kCPU, &c), kTvmErrorNoError);
+  EXPECT_EQ((uint8_t*)c - (uint8_t*)b, 2 * TVM_RUNTIME_ALLOC_ALIGNMENT_BYTES);
+  EXPECT_EQ(mgr->vleak_size, 2);
+
+  size_t sealed_bytes = 0;
+  size_t peak_bytes = 0;
+  ASSERT_EQ(ArenaMemoryManager_GetUsage(mgr, &sealed_bytes, &peak_bytes), kTvmErrorNoError);
+  EXPECT_EQ(sealed_bytes, 4 * TVM_RUNTIME_ALLOC_ALIGNMENT_BYTES);
+  EXPECT_EQ(peak_bytes, 4 * TVM_RUNTIME_ALLOC_ALIGNMENT_BYTES);
+}
+
+/*
+ * Tests the allocations after the arena is sealed are released in LIFO order.
+ */
+TEST(ArenaAllocatorTest, AllocateAfterSeal) {
+  TVM_CRT_DEFINE_STATIC_ARENA(arena, 1024);
+  MemoryManagerInterface* mgr = NULL;
+  ASSERT_EQ(ArenaMemoryManagerCreate(&mgr, arena, sizeof(arena)), kTvmErrorNoError);
+
+  void* state = NULL;
+  ASSERT_EQ(mgr->Allocate(mgr, 32, kCPU, &state), kTvmErrorNoError);
+  ASSERT_EQ(ArenaMemoryManager_Seal(mgr), kTvmErrorNoError);
+
+  for (int i = 0; i < 3; ++i) {
+    void* outer = NULL;
+    void* inner = NULL;
+    ASSERT_EQ(mgr->Allocate(mgr, 64, kCPU, &outer), kTvmErrorNoError);
+    ASSERT_EQ(mgr->Allocate(mgr, 16, kCPU, &inner), kTvmErrorNoError);
+    EXPECT_EQ((uint8_t*)outer, (uint8_t*)state + 32 + ARENA_BLOCK_HEADER_BYTES);
+    ASSERT_EQ(mgr->Free(mgr, inner, kCPU), kTvmErrorNoError);
+    ASSERT_EQ(mgr->Free(mgr, outer, kCPU), kTvmErrorNoError);
+  }
+
+  size_t sealed_bytes = 0;
+  size_t peak_bytes = 0;
+  ASSERT_EQ(ArenaMemoryManager_GetUsage(mgr, &sealed_bytes, &peak_bytes), kTvmErrorNoError);
+  EXPECT_EQ(sealed_bytes, 32);
+  EXPECT_EQ(peak_bytes, 32 + 64 + 16 + 2 * ARENA_BLOCK_HEADER_BYTES);
+}
+
+/*
+ * Tests a block released out of LIFO order is not reused while the blocks above it are live.
+ */
+TEST(ArenaAllocatorTest, FreeOutOfOrder) {
+  TVM_CRT_DEFINE_STATIC_ARENA(arena, 1024);
+  MemoryManagerInterface* mgr = NULL;
+  ASSERT_EQ(ArenaMemoryManagerCreate(&mgr, arena, sizeof(arena)), kTvmErrorNoError);
+  ASSERT_EQ(ArenaMemoryManager_Seal(mgr), kTvmErrorNoError);
+
+  void* a = NULL;
+  void* b = NULL;
+  ASSERT_EQ(mgr->Allocate(mgr, 32, kCPU, &a), kTvmErrorNoError);
+  ASSERT_EQ(mgr->Allocate(mgr, 32, kCPU, &b), kTvmErrorNoError);
+  ASSERT_EQ(mgr->Free(mgr, a, kCPU), kTvmErrorNoError);
+
+  // b is still live, so the next block is placed above it.
+  void* c = NULL;
+  ASSERT_EQ(mgr->Allocate(mgr, 16, kCPU, &c), kTvmErrorNoError);
+  EXPECT_EQ((uint8_t*)c, (uint8_t*)b + 32 + ARENA_BLOCK_HEADER_BYTES);
+  EXPECT_EQ(mgr->Free(mgr, a, kCPU), kTvmErrorPlatformCheckFailure);
+
+  // Releasing the blocks above a reclaims a as well.
+  ASSERT_EQ(mgr->Free(mgr, c, kCPU), kTvmErrorNoError);
+  ASSERT_EQ(mgr->Free(mgr, b, kCPU), kTvmErrorNoError);
+  void* d = NULL;
+  ASSERT_EQ(mgr->Allocate(mgr, 16, kCPU, &d), kTvmErrorNoError);
+  EXPECT_EQ(d, a);
+  ASSERT_EQ(mgr->Free(mgr, d, kCPU), kTvmErrorNoError);
+  EXPECT_EQ(mgr->vleak_size, 0);
+}
+
+/*
+ * Tests an empty allocation yields NULL and does not alias the next allocation.
+ */
+TEST(ArenaAllocatorTest, AllocateZeroBytes) {
+  TVM_CRT_DEFINE_STATIC_ARENA(arena, 1024);
+  MemoryManagerInterface* mgr = NULL;
+  ASSERT_EQ(ArenaMemoryManagerCreate(&mgr, arena, sizeof(arena)), kTvmErrorNoError);
+  ASSERT_EQ(ArenaMemoryManager_Seal(mgr), kTvmErrorNoError);
+
+  void* empty = &arena;
+  void* a = NULL;
+  ASSERT_EQ(mgr->Allocate(mgr, 0, kCPU, &empty), kTvmErrorNoError);
+  EXPECT_EQ(empty, nullptr);
+  ASSERT_EQ(mgr->Allocate(mgr, 16, kCPU, &a), kTvmErrorNoError);
+  EXPECT_NE(a, nullptr);
+  ASSERT_EQ(mgr->Free(mgr, empty, kCPU), kTvmErrorNoError);
+  ASSERT_EQ(mgr->Free(mgr, a, kCPU), kTvmErrorNoError);
+  EXPECT_EQ(mgr->vleak_size, 0);
+}
+
+/*
+ * Tests an allocation that does not fit fails rather than using the heap.
+ */
+TEST(ArenaAllocatorTest, OutOfMemory) {
+  TVM_CRT_DEFINE_STATIC_ARENA(arena, 256);
+  MemoryManagerInterface* mgr = NULL;
+  ASSERT_EQ(ArenaMemoryManagerCreate(&mgr, arena, sizeof(arena)), kTvmErrorNoError);
+
+  void* ptr = NULL;
+  EXPECT_EQ(mgr->Allocate(mgr, 256, kCPU, &ptr), kTvmErrorPlatformNoMemory);
+  ASSERT_EQ(mgr->Allocate(mgr, 64, kCPU, &ptr), kTvmErrorNoError);
+  EXPECT_EQ(mgr->vleak_size, 1);
+}
@@ -60,6 +60,21 @@ def test_fp16_conversion():
         tvm.testing.assert_allclose(expected, real)
 
 
+@tvm.testing.requires_cuda
+def test_cuda_pinned_staging():
+    # chunks that do not divide the copies, with the copies of the pageable memory all staged
+    tvm.runtime.config_cuda_pinned_staging(4096, 0)
+    try:
+        x = np.random.rand(10000).astype("float32")
+        y = tvm.nd.array(x, device=tvm.cuda())
+        np.testing.assert_equal(x, y.numpy())
+        # the page-locked memory is copied directly
+        z = y.copyto(tvm.runtime.device(3, 0))
+        np.testing.assert_equal(x, z.numpy())
+    finally:
+        tvm.runtime.config_cuda_pinned_staging()
+
+
 def test_dtype():
     dtype = tvm.DataType("handle")
     assert dtype.type_code == tvm.DataTypeCode.HANDLE
@@ -970,6 +970,28 @@ def test_dense_pattern(run_module, dtype="float32"):
     run_and_verify_func(config, run_module=run_module, dtype=dtype)
 
 
+def test_dense_bind_once(run_module, monkeypatch, dtype="float32"):
+    # Keep the execution context of the DNNL runtime across the runs, rebinding the moved buffers.
+    monkeypatch.setenv("TVM_JSON_RUNTIME_BIND_ONCE", "1")
+    x_shape = (1, 16)
+    k_shape = (32, 16)
+    dense, dic, param_lst = get_dense(x_shape, k_shape, dtype=dtype)
+    dense_mod = partition_for_dnnl(tvm.IRModule.from_expr(dense), alter_layout=False)
+    check_dnnl_used(dense_mod)
+    kernel = np.random.uniform(-1, 1, k_shape).astype(dtype)
+    for mode in ["graph", "vm"]:
+        with tvm.transform.PassContext(opt_level=3):
+            func = relay.create_executor(
+                mode, mod=dense_mod, device=tvm.cpu(), target="llvm"
+            ).evaluate()
+        if not run_module:
+            continue
+        for _ in range(3):
+            x = np.random.uniform(-1, 1, x_shape).astype(dtype)
+            out = func(x=x, kernel=kernel)
+            tvm.testing.assert_allclose(out.numpy(), x @ kernel.T, rtol=1e-5, atol=1e-5)
+
+
 def test_pool2d(run_module, dtype="float32"):
     def get_graph(
         op,
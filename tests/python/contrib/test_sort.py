@@ -91,6 +91,35 @@ def test_sort_np():
     tvm.testing.assert_allclose(c.numpy(), np_out, rtol=1e-5)
 
 
+def test_topk_np():
+    # large enough rows to be split across the thread pool, with ties ordered by index
+    dshape = (64, 1024)
+    k = 10
+    data = te.placeholder(dshape, name="data")
+    out = te.extern(
+        [(dshape[0], k), (dshape[0], k)],
+        [data],
+        lambda ins, outs: tvm.tir.call_packed(
+            "tvm.contrib.sort.topk", ins[0], outs[0], outs[1], k, 1, "both", False
+        ),
+        dtype=["float32", "int32"],
+        name="topk_tensor",
+    )
+
+    dev = tvm.cpu(0)
+    s = te.create_schedule(out[0].op)
+    f = tvm.build(s, [data, out[0], out[1]], "llvm")
+
+    np_data = np.random.randint(0, 100, size=dshape).astype(data.dtype)
+    np_indices = np.argsort(-np_data, axis=1, kind="stable")[:, :k]
+    a = tvm.nd.array(np_data, dev)
+    values = tvm.nd.array(np.zeros((dshape[0], k), dtype="float32"), dev)
+    indices = tvm.nd.array(np.zeros((dshape[0], k), dtype="int32"), dev)
+    f(a, values, indices)
+    tvm.testing.assert_allclose(indices.numpy(), np_indices)
+    tvm.testing.assert_allclose(values.numpy(), np.take_along_axis(np_data, np_indices, axis=1))
+
+
 def test_sort_by_key_gpu():
     size = 6
     keys = te.placeholder((size,), name="keys", dtype="int32")
@@ -126,4 +155,5 @@ def test_sort_by_key_gpu():
 if __name__ == "__main__":
     test_sort()
     test_sort_np()
+    test_topk_np()
     test_sort_by_key_gpu()
@@ -136,7 +136,65 @@ def test_inclusive_scan():
                 tvm.testing.assert_allclose(values_out.numpy(), ref_values_out, rtol=1e-5)
 
 
+def _require_thrust_func(name):
+    if not tvm.testing.device_enabled("cuda"):
+        print("Skip because cuda is not enabled")
+        return None
+    return tvm.get_global_func(name, allow_missing=True)
+
+
+def test_radix_topk():
+    topk = _require_thrust_func("tvm.contrib.thrust.radix_topk")
+    if topk is None:
+        print("skip because thrust is not enabled...")
+        return
+
+    dev = tvm.cuda(0)
+    batch, vocab, k = 4, 32000, 50
+    # The repeated values check that equal values keep the order of the row.
+    data_np = np.random.randint(0, 1000, size=(batch, vocab)).astype("float32")
+    for dtype in ["float32", "float16"]:
+        for is_ascend in [False, True]:
+            data = tvm.nd.array(data_np.astype(dtype), dev)
+            values = tvm.nd.empty((batch, k), dtype, dev)
+            indices = tvm.nd.empty((batch, k), "int32", dev)
+            topk(data, values, indices, k, is_ascend)
+
+            keys = data_np if is_ascend else -data_np
+            ref_indices = np.argsort(keys, axis=-1, kind="stable")[:, :k]
+            ref_values = np.take_along_axis(data_np, ref_indices, axis=-1)
+            tvm.testing.assert_allclose(indices.numpy(), ref_indices)
+            tvm.testing.assert_allclose(values.numpy().astype("float32"), ref_values)
+
+
+def test_softmax_top_p():
+    softmax_top_p = _require_thrust_func("tvm.contrib.thrust.softmax_top_p")
+    if softmax_top_p is None:
+        print("skip because thrust is not enabled...")
+        return
+
+    dev = tvm.cuda(0)
+    batch, vocab = 3, 32000
+    logits_np = np.random.normal(scale=4.0, size=(batch, vocab)).astype("float32")
+    top_p_np = np.array([0.1, 0.9, 1.0], "float32")
+    probs = tvm.nd.empty((batch, vocab), "float32", dev)
+    softmax_top_p(tvm.nd.array(logits_np, dev), tvm.nd.array(top_p_np, dev), probs)
+
+    exp = np.exp(logits_np - logits_np.max(axis=-1, keepdims=True))
+    ref_probs = exp / exp.sum(axis=-1, keepdims=True)
+    for i in range(batch):
+        order = np.argsort(-ref_probs[i], kind="stable")
+        cum = np.cumsum(ref_probs[i][order])
+        # The nucleus is the smallest prefix of the ranked elements reaching top_p.
+        num_kept = min(int(np.searchsorted(cum, top_p_np[i] - 1e-6)) + 1, vocab)
+        ref = np.zeros(vocab, "float32")
+        ref[order[:num_kept]] = ref_probs[i][order[:num_kept]] / cum[num_kept - 1]
+        tvm.testing.assert_allclose(probs.numpy()[i], ref, rtol=1e-4, atol=1e-6)
+
+
 if __name__ == "__main__":
     test_stable_sort_by_key()
     test_exclusive_scan()
     test_inclusive_scan()
+    test_radix_topk()
+    test_softmax_top_p()
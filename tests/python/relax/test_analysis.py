@@ -24,6 +24,7 @@ from tvm import tir
 from tvm import relax as rx
 from tvm.relax.analysis import (
     udchain,
+    liveness_killed_vars,
     remove_all_unused,
     name_to_binding,
     shape_vars,
@@ -110,6 +111,26 @@ def test_use_def():
     assert set(udc[gv0]) == set()
 
 
+def test_liveness_killed_vars():
+    x = rx.Var("x", [4], rx.DynTensorType(ndim=1, dtype="float32"))
+    y = rx.Var("y", [4], rx.DynTensorType(ndim=1, dtype="float32"))
+    ib = rx.BlockBuilder()
+    with ib.function("func", [x, y]):
+        with ib.dataflow():
+            lv0 = ib.emit(rx.op.add(x, y))
+            lv1 = ib.emit(rx.op.multiply(lv0, y))
+            lv2 = ib.emit(rx.op.add(lv1, lv1))
+            gv0 = ib.emit_output(rx.op.add(lv2, y))
+        ib.emit_func_output(gv0)
+    killed = liveness_killed_vars(ib.get()["func"])
+    assert len(killed) == 5
+    assert set(killed[0]) == {x}
+    assert set(killed[1]) == {lv0}
+    assert set(killed[2]) == {lv1}
+    assert set(killed[3]) == {y, lv2}
+    assert set(killed[4]) == {gv0}
+
+
 def test_chained_remove_all_unused():
     @tvm.script.ir_module
     class IdentityUnused:
@@ -0,0 +1,105 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+from __future__ import annotations  # must import to defer parsing of annotations
+import numpy as np
+import tvm
+import tvm.script
+import tvm.testing
+from tvm import relax, tir, topi
+from tvm.script import relax as R, tir as T
+
+
+@tvm.script.ir_module
+class ThreeKernels:
+    @T.prim_func
+    def add_one(a: T.handle, b: T.handle) -> None:
+        T.func_attr({"global_symbol": "add_one"})
+        A = T.match_buffer(a, (32, 16), "float32")
+        B = T.match_buffer(b, (32, 16), "float32")
+        for i, j in T.grid(32, 16):
+            with T.block("B"):
+                vi, vj = T.axis.remap("SS", [i, j])
+                B[vi, vj] = A[vi, vj] + T.float32(1)
+
+    @T.prim_func
+    def mul(a: T.handle, b: T.handle, c: T.handle) -> None:
+        T.func_attr({"global_symbol": "mul"})
+        A = T.match_buffer(a, (32, 16), "float32")
+        B = T.match_buffer(b, (32, 16), "float32")
+        C = T.match_buffer(c, (32, 16), "float32")
+        for i, j in T.grid(32, 16):
+            with T.block("C"):
+                vi, vj = T.axis.remap("SS", [i, j])
+                C[vi, vj] = A[vi, vj] * B[vi, vj]
+
+    @R.function
+    def main(x: Tensor((32, 16), "float32"), y: Tensor((32, 16), "float32")):
+        lv0 = R.call_tir(add_one, (x,), (32, 16), dtype="float32")
+        lv1 = R.call_tir(mul, (lv0, y), (32, 16), dtype="float32")
+        lv2 = R.call_tir(add_one, (lv1,), (32, 16), dtype="float32")
+        return (lv2, lv0)
+
+
+def test_footprint_before_and_after_lowering():
+    footprint = relax.analysis.estimate_footprint(ThreeKernels)
+    # the three outputs of 2048 bytes are live at the last kernel
+    assert footprint.peak_bytes == 3 * 2048
+    assert footprint.flops == 3 * 32 * 16
+    assert footprint.num_kernel_launches == 3
+    assert footprint.num_unbounded_allocs == 0
+
+    seq = tvm.transform.Sequential(
+        [
+            relax.transform.ToNonDataflow(),
+            relax.transform.CallTIRRewrite(),
+            relax.transform.VMMemoryLower(plan_memory=True),
+        ]
+    )
+    lowered = relax.analysis.estimate_footprint(seq(ThreeKernels))
+    assert lowered.peak_bytes == 3 * 2048
+    assert lowered.flops == footprint.flops
+    assert lowered.num_kernel_launches == 3
+
+
+def build_dynamic(upper_bound=None):
+    n = tir.Var("n", "int64")
+    x = relax.Var("x", [n, 4], relax.DynTensorType(2, "float32"))
+    c = relax.const(np.ones((4,), "float32"))
+    bb = relax.BlockBuilder()
+    attrs = {"tir_var_upper_bound": {"n": upper_bound}} if upper_bound else None
+    with bb.function("main", [x], attrs):
+        gv = bb.emit_te(topi.add, x, c)
+        bb.emit_func_output(gv)
+    return bb.get()
+
+
+def test_footprint_dynamic_shapes():
+    footprint = relax.analysis.estimate_footprint(build_dynamic())
+    assert footprint.num_unbounded_allocs == 1
+    assert footprint.peak_bytes == 0
+    # the loops of the kernel are of a symbolic extent
+    assert footprint.num_kernel_launches == 1
+    assert footprint.num_unestimated_kernels == 1
+    assert {k: int(v) for k, v in footprint.constant_bytes.items()} == {"cpu(0)": 16}
+
+    footprint = relax.analysis.estimate_footprint(build_dynamic(upper_bound=32))
+    assert footprint.num_unbounded_allocs == 0
+    assert footprint.peak_bytes == 32 * 4 * 4
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,85 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+from __future__ import annotations  # must import to defer parsing of annotations
+import numpy as np
+import pytest
+import tvm
+import tvm.script
+import tvm.testing
+from tvm import relax
+from tvm.runtime.executor import AotModule
+from tvm.script import relax as R, tir as T
+
+
+@tvm.script.ir_module
+class TestAOTModule:
+    @T.prim_func
+    def add_one(a: T.handle, b: T.handle) -> None:
+        T.func_attr({"global_symbol": "add_one"})
+        A = T.match_buffer(a, (32, 16), "float32")
+        B = T.match_buffer(b, (32, 16), "float32")
+        for i, j in T.grid(32, 16):
+            with T.block("B"):
+                vi, vj = T.axis.remap("SS", [i, j])
+                B[vi, vj] = A[vi, vj] + T.float32(1)
+
+    @T.prim_func
+    def mul(a: T.handle, b: T.handle, c: T.handle) -> None:
+        T.func_attr({"global_symbol": "mul"})
+        A = T.match_buffer(a, (32, 16), "float32")
+        B = T.match_buffer(b, (32, 16), "float32")
+        C = T.match_buffer(c, (32, 16), "float32")
+        for i, j in T.grid(32, 16):
+            with T.block("C"):
+                vi, vj = T.axis.remap("SS", [i, j])
+                C[vi, vj] = A[vi, vj] * B[vi, vj]
+
+    @R.function
+    def main(x: Tensor((32, 16), "float32"), y: Tensor((32, 16), "float32")):
+        lv0 = R.call_tir(add_one, (x,), (32, 16), dtype="float32")
+        lv1 = R.call_tir(mul, (lv0, y), (32, 16), dtype="float32")
+        lv2 = R.call_tir(add_one, (lv1,), (32, 16), dtype="float32")
+        return (lv2, lv0)
+
+
+@tvm.testing.requires_llvm
+def test_aot_build():
+    factory = relax.aot.build(TestAOTModule, "llvm")
+    executor = AotModule(factory["default"](tvm.cpu()))
+    x_np = np.random.rand(32, 16).astype(np.float32)
+    y_np = np.random.rand(32, 16).astype(np.float32)
+    executor.set_input("x", x_np)
+    executor.set_input("y", y_np)
+    executor.run()
+    tvm.testing.assert_allclose(executor.get_output(0).numpy(), (x_np + 1) * y_np + 1, rtol=1e-6)
+    tvm.testing.assert_allclose(executor.get_output(1).numpy(), x_np + 1, rtol=1e-6)
+
+
+@tvm.testing.requires_llvm
+def test_aot_build_returning_input():
+    @tvm.script.ir_module
+    class Identity:
+        @R.function
+        def main(x: Tensor((32, 16), "float32")):
+            return x
+
+    with pytest.raises(tvm.TVMError, match="computed by a kernel"):
+        relax.aot.build(Identity, "llvm")
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -228,6 +228,79 @@ def test_meta_schedule_extract_tasks():
         assert task.task_name in expected_weights
         assert expected_weights[task.task_name] == task.weight
 
+    # Weighted by the share of the measured time, summed over the deduplicated kernels
+    profile = {"add1": 1.0, "add2": 6.0, "add3": 1.0, "multiply1": 2.0}
+    tasks = ms.relax_integration.extract_tasks(
+        Module, Target("llvm --num-cores=16"), profile=profile
+    )
+    expected_weights = {"add1": 200, "add2": 600, "multiply1": 200}
+    for task in tasks:
+        assert expected_weights[task.task_name] == task.weight
+
+
+def test_meta_schedule_retuning_service():
+    @tvm.script.ir_module
+    class Module:
+        @T.prim_func
+        def add(A: T.Buffer[(128, 128), "float32"], B: T.Buffer[(128, 128), "float32"]):
+            for i, j in T.grid(128, 128):
+                with T.block("add"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = A[vi, vj] + 1.0
+
+        @T.prim_func
+        def multiply(A: T.Buffer[(128, 128), "float32"], B: T.Buffer[(128, 128), "float32"]):
+            for i, j in T.grid(128, 128):
+                with T.block("multiply"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = A[vi, vj] * 2.0
+
+        @R.function
+        def main(x: Tensor((128, 128), "float32")) -> Tensor(_, "float32"):
+            with R.dataflow():
+                lv0 = R.call_tir(add, (x,), (128, 128), dtype="float32")
+                gv = R.call_tir(multiply, (lv0,), (128, 128), dtype="float32")
+                relax.output(gv)
+            return gv
+
+    from tvm.meta_schedule.testing.dummy_object import (  # pylint: disable=import-outside-toplevel
+        DummyBuilder,
+        DummyRunner,
+    )
+
+    with tempfile.TemporaryDirectory() as work_dir:
+        service = ms.RetuningService(
+            Module,
+            Target("llvm --num-cores=16"),
+            work_dir,
+            # 128 * 128 FLOP in 1 us is 16.384 GFLOPS
+            peak_gflops=20.0,
+            min_samples=2,
+            max_trials_per_task=2,
+            num_trials_per_iter=2,
+            builder=DummyBuilder(),
+            runner=DummyRunner(),
+            cost_model="random",
+            measure_callbacks=[ms.measure_callback.AddToDatabase()],
+        )
+        service.record("add", 1e-6)
+        service.record("multiply", 1e-6)
+        # Not judged before `min_samples` calls
+        assert service.process() == 0
+        # `add` runs at 82% of the roofline, `multiply` at 8%
+        service.record("add", 1e-6)
+        service.record("multiply", 19e-6)
+        assert service.efficiency("multiply") == pytest.approx(0.08192)
+        assert service.process() == 1
+        # Queued once only
+        service.record("multiply", 1e-3)
+        assert service.process() == 0
+
+        records = ms.database.JSONDatabase(work_dir=work_dir).get_all_tuning_records()
+        assert records
+        for record in records:
+            tvm.ir.assert_structural_equal(record.workload.mod, service.tasks[1].dispatched[0])
+
 
 if __name__ == "__main__":
     pytest.main([__file__])
@@ -342,6 +342,22 @@ def test_normalize():
     assert add_call.shape[1] == n
 
 
+def test_normalize_normalized():
+    x = rx.Var("x", [16], rx.DynTensorType(1, "float32"))
+    bb = rx.BlockBuilder()
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            lv0 = bb.emit(rx.op.add(x, x))
+            gv = bb.emit_output(rx.op.multiply(lv0, x))
+        bb.emit_func_output(gv)
+    seq = bb.get()["main"].body
+
+    # A normalized expression is returned as it is, and not traversed again.
+    bb = rx.BlockBuilder()
+    assert bb.normalize(seq).same_as(seq)
+    assert bb.normalize(seq).same_as(seq)
+
+
 def test_call_te():
     bb = rx.BlockBuilder()
     dtype = rx.DynTensorType(ndim=2, dtype="float32")
@@ -0,0 +1,91 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.relax.op.contrib.cublas import partition_for_cublas
+
+
+def get_module(m, k, n, dtype, activation=None, with_bias=True):
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [m, k], relax.DynTensorType(2, dtype))
+    w = relax.Var("w", [n, k], relax.DynTensorType(2, dtype))
+    b = relax.Var("b", [n], relax.DynTensorType(1, dtype))
+    with bb.function("main", [x, w, b]):
+        with bb.dataflow():
+            out = bb.emit(relax.op.nn.matmul(x, w, transpose_b=True))
+            if with_bias:
+                out = bb.emit(relax.op.add(out, b))
+            if activation is not None:
+                out = bb.emit(activation(out))
+            gv = bb.emit_output(out)
+        bb.emit_func_output(gv)
+    return bb.get()
+
+
+@pytest.mark.parametrize(
+    "activation, with_bias, composite_name",
+    [
+        (None, False, "cublas.matmul"),
+        (None, True, "cublas.matmul_bias"),
+        (relax.op.nn.relu, False, "cublas.matmul_relu"),
+        (relax.op.nn.gelu, True, "cublas.matmul_bias_gelu"),
+    ],
+)
+def test_partition_for_cublas(activation, with_bias, composite_name):
+    mod = partition_for_cublas(get_module(32, 64, 16, "float16", activation, with_bias))
+    bindings = mod["main"].body.blocks[0].bindings
+    assert len(bindings) == 1
+    func = mod[bindings[0].value.op]
+    assert func.attrs["Codegen"] == "cublas"
+    composite = func.body.blocks[0].bindings[0].value.op
+    assert composite.attrs["Composite"] == composite_name
+
+
+def test_partition_for_cublas_unsupported_dtype():
+    mod = get_module(32, 64, 16, "float64", relax.op.nn.relu)
+    tvm.ir.assert_structural_equal(partition_for_cublas(mod), mod)
+
+
+@tvm.testing.requires_cublas
+@pytest.mark.skipif(
+    not tvm.get_global_func("runtime.CublasJSONRuntimeCreate", True),
+    reason="cuBLASLt runtime not available",
+)
+@pytest.mark.parametrize("dtype", ["float16", "float32"])
+def test_cublas_matmul_bias_relu(dtype):
+    m, k, n = 32, 64, 16
+    mod = partition_for_cublas(get_module(m, k, n, dtype, relax.op.nn.relu))
+    mod = relax.transform.RunCodegen()(mod)
+    ex = relax.vm.build(mod, "cuda")
+    dev = tvm.cuda()
+    vm = relax.VirtualMachine(ex, dev)
+
+    x = np.random.uniform(-1, 1, (m, k)).astype(dtype)
+    w = np.random.uniform(-1, 1, (n, k)).astype(dtype)
+    b = np.random.uniform(-1, 1, (n,)).astype(dtype)
+    ref = np.maximum(x.astype("float32") @ w.astype("float32").T + b, 0)
+    # the second call reuses the algorithm and the workspace of the first one
+    for _ in range(2):
+        out = vm["main"](tvm.nd.array(x, dev), tvm.nd.array(w, dev), tvm.nd.array(b, dev))
+        tvm.testing.assert_allclose(out.numpy().astype("float32"), ref, rtol=1e-2, atol=1e-2)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
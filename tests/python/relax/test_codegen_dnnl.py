@@ -0,0 +1,86 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.relax.op.contrib.dnnl import partition_for_dnnl
+
+
+def get_module(m, k, n, dtype="float32"):
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [m, k], relax.DynTensorType(2, dtype))
+    w0 = relax.Var("w0", [n, k], relax.DynTensorType(2, dtype))
+    b0 = relax.Var("b0", [n], relax.DynTensorType(1, dtype))
+    w1 = relax.Var("w1", [n, n], relax.DynTensorType(2, dtype))
+    with bb.function("main", [x, w0, b0, w1]):
+        with bb.dataflow():
+            lv0 = bb.emit(relax.op.nn.matmul(x, w0, transpose_b=True))
+            lv1 = bb.emit(relax.op.add(lv0, b0))
+            lv2 = bb.emit(relax.op.nn.relu(lv1))
+            lv3 = bb.emit(relax.op.nn.matmul(lv2, w1, transpose_b=True))
+            gv = bb.emit_output(relax.op.multiply(lv3, lv3))
+        bb.emit_func_output(gv)
+    return bb.get()
+
+
+def test_partition_for_dnnl():
+    mod = partition_for_dnnl(get_module(8, 32, 16))
+    bindings = mod["main"].body.blocks[0].bindings
+    # The consecutive offloaded ops are merged into a single subgraph.
+    assert len(bindings) == 1
+    func = mod[bindings[0].value.op]
+    assert func.attrs["Codegen"] == "dnnl"
+    composites = [b.value.op.attrs["Composite"] for b in func.body.blocks[0].bindings]
+    assert composites == ["dnnl.dense_bias_relu", "dnnl.dense", "dnnl.multiply"]
+
+
+def test_partition_for_dnnl_unsupported():
+    m = tvm.tir.Var("m", "int64")
+    mod = get_module(m, 32, 16)
+    # The primitives are created for static shapes only.
+    tvm.ir.assert_structural_equal(partition_for_dnnl(mod), mod)
+    mod = get_module(8, 32, 16, "float64")
+    tvm.ir.assert_structural_equal(partition_for_dnnl(mod), mod)
+
+
+@tvm.testing.requires_llvm
+@pytest.mark.skipif(
+    not tvm.get_global_func("runtime.DNNLJSONRuntimeCreate", True),
+    reason="DNNL runtime not available",
+)
+def test_dnnl_dense_chain():
+    m, k, n = 8, 32, 16
+    mod = partition_for_dnnl(get_module(m, k, n))
+    mod = relax.transform.RunCodegen()(mod)
+    ex = relax.vm.build(mod, "llvm")
+    dev = tvm.cpu()
+    vm = relax.VirtualMachine(ex, dev)
+
+    x = np.random.uniform(-1, 1, (m, k)).astype("float32")
+    w0 = np.random.uniform(-1, 1, (n, k)).astype("float32")
+    b0 = np.random.uniform(-1, 1, (n,)).astype("float32")
+    w1 = np.random.uniform(-1, 1, (n, n)).astype("float32")
+    lv3 = np.maximum(x @ w0.T + b0, 0) @ w1.T
+    args = [tvm.nd.array(arr, dev) for arr in [x, w0, b0, w1]]
+    out = vm["main"](*args)
+    tvm.testing.assert_allclose(out.numpy(), lv3 * lv3, rtol=1e-4, atol=1e-4)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -838,3 +838,25 @@ def test_incremental_solving_counter():
             # total constraint: relu >> sigmoid >> neg
             sigmoid >> neg
             assert not ctx1.match_dfb(simple_chain.body.blocks[0])
+
+
+def test_rewrite_bindings_all_matches():
+    with PatternContext() as ctx:
+        chain = is_call_tir("conv1x1") >> is_call_tir("bias_add") >> is_call_tir("my_relu")
+
+    matches = []
+
+    def rewriter(matched):
+        matches.append(matched[chain[0]])
+        # Skip the relu of each CBR.
+        return {matched[chain[2]]: matched[chain[1]]}
+
+    rewritten = ctx.rewrite_bindings(rewriter, CBRx2["main"])
+    dfb = CBRx2["main"].body.blocks[0]
+    assert list(matches) == [dfb.bindings[0].var, dfb.bindings[3].var]
+
+    new_bindings = rewritten.body.blocks[0].bindings
+    assert len(new_bindings) == len(dfb.bindings)
+    assert new_bindings[2].value.same_as(new_bindings[1].var)
+    assert new_bindings[5].value.same_as(new_bindings[4].var)
+    assert isinstance(new_bindings[6].value, rx.Call)
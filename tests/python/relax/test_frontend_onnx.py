@@ -0,0 +1,99 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.relax.testing import transform
+
+onnx = pytest.importorskip("onnx")
+from onnx import TensorProto, helper, numpy_helper  # pylint: disable=wrong-import-position
+
+from tvm.relax.frontend import from_onnx  # pylint: disable=wrong-import-position
+
+
+def make_model(weight):
+    """x: (batch, seq, 8) @ weight + 1, relu, reshaped to (batch, seq * 4, 2) from its Shape,
+    then softmax."""
+    nodes = [
+        helper.make_node("MatMul", ["x", "w"], ["mm"]),
+        helper.make_node("Add", ["mm", "one"], ["add"]),
+        helper.make_node("Relu", ["add"], ["relu"]),
+        helper.make_node("Shape", ["x"], ["shape"]),
+        helper.make_node("Gather", ["shape", "zero"], ["batch"], axis=0),
+        helper.make_node("Unsqueeze", ["batch", "axes"], ["batch1"]),
+        helper.make_node("Concat", ["batch1", "rest"], ["new_shape"], axis=0),
+        helper.make_node("Reshape", ["relu", "new_shape"], ["reshaped"]),
+        helper.make_node("Softmax", ["reshaped"], ["y"], axis=-1),
+    ]
+    inits = [
+        numpy_helper.from_array(weight, "w"),
+        numpy_helper.from_array(np.array(1.0, "float32"), "one"),
+        numpy_helper.from_array(np.array(0, "int64"), "zero"),
+        numpy_helper.from_array(np.array([0], "int64"), "axes"),
+        numpy_helper.from_array(np.array([-1, 2], "int64"), "rest"),
+    ]
+    graph = helper.make_graph(
+        nodes,
+        "test",
+        [helper.make_tensor_value_info("x", TensorProto.FLOAT, ["batch", "seq", 8])],
+        [helper.make_tensor_value_info("y", TensorProto.FLOAT, None)],
+        inits,
+    )
+    return helper.make_model(graph, opset_imports=[helper.make_opsetid("", 13)])
+
+
+def test_symbolic_shape():
+    mod = from_onnx(make_model(np.random.rand(8, 8).astype("float32")))
+    x = mod["main"].params[0]
+    batch, seq, _ = x.shape
+    assert isinstance(batch, tvm.tir.Var) and batch.name == "batch"
+    out_shape = mod["main"].body.body.shape
+    tvm.ir.assert_structural_equal(out_shape[0], batch)
+    # the reshape is not folded to static dims
+    assert "seq" in str(out_shape[1])
+
+
+@tvm.testing.requires_llvm
+def test_run():
+    weight = np.random.rand(8, 8).astype("float32")
+    mod = from_onnx(make_model(weight))
+    target = tvm.target.Target("llvm")
+    mod = transform.LowerWithRelayOpStrategyPass(target)(mod)
+    vm = relax.VirtualMachine(relax.vm.build(mod, target), tvm.cpu())
+    for batch, seq in [(2, 3), (1, 5)]:
+        x = np.random.rand(batch, seq, 8).astype("float32")
+        out = vm["main"](tvm.nd.array(x)).numpy()
+        ref = np.maximum(x @ weight + 1, 0).reshape(batch, -1, 2)
+        ref = np.exp(ref - ref.max(-1, keepdims=True))
+        tvm.testing.assert_allclose(out, ref / ref.sum(-1, keepdims=True), rtol=1e-5, atol=1e-5)
+
+
+def test_unsupported_op():
+    graph = helper.make_graph(
+        [helper.make_node("NonMaxSuppression", ["x"], ["y"])],
+        "test",
+        [helper.make_tensor_value_info("x", TensorProto.FLOAT, [1, 4])],
+        [helper.make_tensor_value_info("y", TensorProto.INT64, None)],
+    )
+    with pytest.raises(ValueError, match="NonMaxSuppression"):
+        from_onnx(helper.make_model(graph))
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
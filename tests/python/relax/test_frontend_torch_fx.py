@@ -0,0 +1,105 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.relax.testing import transform
+
+torch = pytest.importorskip("torch")
+from torch import nn  # pylint: disable=wrong-import-position
+
+from tvm.relax.frontend import from_fx  # pylint: disable=wrong-import-position
+
+
+class Block(nn.Module):
+    def __init__(self):
+        super().__init__()
+        self.linear = nn.Linear(16, 32)
+        self.norm = nn.LayerNorm(32)
+
+    def forward(self, x):
+        y = torch.relu(self.linear(x)) * 2.0
+        y = self.norm(y)
+        # (batch, seq, 32) -> (batch, seq * 2, 16), from the sizes of the input
+        y = y.view(x.size(0), -1, 16)
+        return torch.softmax(y.sum(-1), dim=-1)
+
+
+class ConvNet(nn.Module):
+    def __init__(self):
+        super().__init__()
+        self.conv = nn.Conv2d(3, 4, 3, padding=1)
+        self.bn = nn.BatchNorm2d(4)
+        self.pool = nn.AdaptiveAvgPool2d(1)
+
+    def forward(self, x):
+        return torch.flatten(self.pool(nn.functional.relu(self.bn(self.conv(x)))), 1)
+
+
+def run(mod, *inputs):
+    target = tvm.target.Target("llvm")
+    mod = transform.LowerWithRelayOpStrategyPass(target)(mod)
+    vm = relax.VirtualMachine(relax.vm.build(mod, target), tvm.cpu())
+    return vm["main"](*[tvm.nd.array(x) for x in inputs]).numpy()
+
+
+def test_symbolic_shape():
+    mod = from_fx(Block().eval(), [(("batch", "seq", 16), "float32")])
+    batch, seq, _ = mod["main"].params[0].shape
+    out_shape = mod["main"].body.body.shape
+    tvm.ir.assert_structural_equal(out_shape[0], batch)
+    assert "seq" in str(out_shape[1])
+
+
+@tvm.testing.requires_llvm
+def test_block():
+    model = Block().eval()
+    mod = from_fx(model, [(("batch", "seq", 16), "float32")])
+    for shape in [(2, 3, 16), (1, 7, 16)]:
+        x = np.random.rand(*shape).astype("float32")
+        with torch.no_grad():
+            ref = model(torch.from_numpy(x)).numpy()
+        tvm.testing.assert_allclose(run(mod, x), ref, rtol=1e-4, atol=1e-5)
+
+
+@tvm.testing.requires_llvm
+def test_conv_net():
+    model = ConvNet().eval()
+    mod = from_fx(model, [(("batch", 3, 8, 8), "float32")])
+    x = np.random.rand(2, 3, 8, 8).astype("float32")
+    with torch.no_grad():
+        ref = model(torch.from_numpy(x)).numpy()
+    tvm.testing.assert_allclose(run(mod, x), ref, rtol=1e-4, atol=1e-5)
+
+
+def test_unsupported_module():
+    class Model(nn.Module):
+        def __init__(self):
+            super().__init__()
+            self.rnn = nn.GRUCell(4, 4)
+
+        def forward(self, x):
+            return self.rnn(x)
+
+    with pytest.raises(ValueError, match="GRUCell"):
+        from_fx(Model(), [((1, 4), "float32")])
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,85 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+import numpy as np
+import pytest
+import tvm
+import tvm.testing
+from tvm import relax, tir
+from tvm.relax.testing import transform
+
+
+def attention_ref(q, k, v, causal):
+    seq_len, kv_len = q.shape[1], k.shape[1]
+    scores = np.einsum("bshd,bthd->bhst", q, k) / np.sqrt(q.shape[3])
+    if causal:
+        i = np.arange(seq_len)[:, None]
+        j = np.arange(kv_len)[None, :]
+        scores = np.where(j <= i + kv_len - seq_len, scores, -np.inf)
+    scores = np.exp(scores - scores.max(axis=-1, keepdims=True))
+    return np.einsum("bhst,bthd->bshd", scores / scores.sum(axis=-1, keepdims=True), v)
+
+
+def build_attention(causal):
+    n = tir.Var("n", "int64")
+    ttype = relax.DynTensorType(4, "float32")
+    q = relax.Var("q", [2, n, 4, 16], ttype)
+    k = relax.Var("k", [2, n, 4, 16], ttype)
+    v = relax.Var("v", [2, n, 4, 8], ttype)
+    bb = relax.BlockBuilder()
+    with bb.function("main", [q, k, v]):
+        with bb.dataflow():
+            out = bb.emit(relax.op.nn.attention(q, k, v, causal=causal))
+            gv = bb.emit_output(out)
+        bb.emit_func_output(gv)
+    return bb.get(), out
+
+
+def test_attention_infer_shape():
+    mod, out = build_attention(causal=False)
+    assert mod
+    assert out.checked_type.ndim == 4
+    assert out.shape[1].same_as(mod["main"].params[0].shape[1])
+    assert int(out.shape[3]) == 8
+
+
+def test_attention_mismatched_heads():
+    ttype = relax.DynTensorType(4, "float32")
+    q = relax.Var("q", [2, 8, 4, 16], ttype)
+    k = relax.Var("k", [2, 8, 2, 16], ttype)
+    bb = relax.BlockBuilder()
+    with pytest.raises(tvm.TVMError):
+        with bb.function("main", [q, k]):
+            bb.emit_func_output(bb.emit(relax.op.nn.attention(q, k, k)))
+
+
+@tvm.testing.requires_llvm
+@pytest.mark.parametrize("causal", [False, True])
+def test_attention_lowering_cpu(causal):
+    mod, _ = build_attention(causal)
+    target = tvm.target.Target("llvm")
+    mod = transform.LowerWithRelayOpStrategyPass(target)(mod)
+    vm = relax.VirtualMachine(relax.vm.build(mod, target), tvm.cpu())
+    # 37 is not a multiple of the tiles of keys
+    q, k = np.random.rand(2, 2, 37, 4, 16).astype("float32")
+    v = np.random.rand(2, 37, 4, 8).astype("float32")
+    out = vm["main"](*[tvm.nd.array(x) for x in (q, k, v)])
+    tvm.testing.assert_allclose(out.numpy(), attention_ref(q, k, v, causal), rtol=1e-5, atol=1e-5)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
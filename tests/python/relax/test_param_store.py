@@ -0,0 +1,110 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+from __future__ import annotations  # must import to defer parsing of annotations
+import numpy as np
+import pytest
+import tvm
+import tvm.script
+import tvm.testing
+from tvm import relax
+from tvm.contrib import utils
+from tvm.relax.param_store import load_manifest, open_params, save_params
+from tvm.script import relax as R, tir as T
+
+
+@tvm.script.ir_module
+class Linear:
+    @T.prim_func
+    def tir_matmul(x: T.handle, y: T.handle, z: T.handle) -> None:
+        T.func_attr({"global_symbol": "tir_matmul"})
+        A = T.match_buffer(x, (16, 16))
+        B = T.match_buffer(y, (16, 16))
+        C = T.match_buffer(z, (16, 16))
+        for i, j, k in T.grid(16, 16, 16):
+            with T.block("matmul"):
+                vi, vj, vk = T.axis.remap("SSR", [i, j, k])
+                with T.init():
+                    C[vi, vj] = T.float32(0)
+                C[vi, vj] = C[vi, vj] + A[vi, vk] * B[vk, vj]
+
+    @R.function
+    def main(
+        x: Tensor((16, 16), "float32"),
+        w0: Tensor((16, 16), "float32"),
+        w1: Tensor((16, 16), "float32"),
+    ) -> Tensor((16, 16), "float32"):
+        gv0 = R.call_tir(tir_matmul, (x, w0), (16, 16), dtype="float32")
+        gv1 = R.call_tir(tir_matmul, (gv0, w1), (16, 16), dtype="float32")
+        return gv1
+
+
+def test_save_params_shards():
+    temp = utils.tempdir()
+    params = {
+        "a": np.arange(10, dtype="float32"),
+        "b": np.ones((3, 5), dtype="int8"),
+        "c": np.zeros((4, 4), dtype="float16"),
+    }
+    shards = save_params(params, temp.path, shard_bytes=64)
+    records = load_manifest(temp.path)
+    assert len(shards) == 2
+    assert [records[name]["shard"] for name in params] == [0, 0, 1]
+    assert records["b"]["offset"] == 64
+    assert records["b"]["shape"] == [3, 5] and records["b"]["dtype"] == "int8"
+
+
+def test_externalize_params():
+    mod = relax.transform.ExternalizeParams("main", ["w0", "w1"])(Linear)
+    assert [p.name_hint for p in mod["main"].params] == ["x"]
+    loads = mod["main"].body.blocks[0].bindings
+    assert [b.value.attrs.name for b in loads] == ["w0", "w1"]
+    assert loads[0].value.op == tvm.ir.Op.get("relax.param_load")
+
+
+@tvm.testing.requires_llvm
+def test_vm_param_store():
+    temp = utils.tempdir()
+    x_np = np.random.rand(16, 16).astype("float32")
+    w0_np = np.random.rand(16, 16).astype("float32")
+    w1_np = np.random.rand(16, 16).astype("float32")
+    # one param per shard
+    save_params({"w0": w0_np, "w1": w1_np}, temp.path, shard_bytes=1024)
+
+    mod = relax.transform.ExternalizeParams("main", ["w0", "w1"])(Linear)
+    ex = relax.vm.build(mod, "llvm")
+    assert "param_load" in ex.as_text()
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    with pytest.raises(tvm.TVMError, match="none is set on the VM"):
+        vm["main"](tvm.nd.array(x_np))
+
+    store = open_params(temp.path)
+    assert store.num_resident == 0
+    vm.set_param_store(store)
+    res = vm["main"](tvm.nd.array(x_np))
+    tvm.testing.assert_allclose(res.numpy(), x_np @ w0_np @ w1_np, rtol=1e-5)
+    assert store.num_resident == 2
+    # the shards are unmapped once their params are on the device
+    assert store.num_mapped_shards == 0
+
+    store.release("w1")
+    assert store.num_resident == 1
+    res = vm["main"](tvm.nd.array(x_np))
+    tvm.testing.assert_allclose(res.numpy(), x_np @ w0_np @ w1_np, rtol=1e-5)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
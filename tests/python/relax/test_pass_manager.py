@@ -137,6 +137,33 @@ def test_function_pass():
     check_equal(After, Expected)
 
 
+def test_function_pass_num_threads():
+    bb = relax.BlockBuilder()
+    for i in range(16):
+        x = relax.Var("x", [4, i + 1], relax.DynTensorType(2, "float32"))
+        with bb.function("func{}".format(i), [x]):
+            with bb.dataflow():
+                lv0 = bb.emit_te(tvm.topi.exp, x)
+                lv1 = bb.emit_te(tvm.topi.exp, x)
+                gv = bb.emit_output(relax.Tuple([lv0, lv1]))
+            bb.emit_func_output(gv)
+    mod = bb.get()
+
+    seq = tvm.transform.Sequential(
+        [relax.transform.AnnotateTIROpPattern(), relax.transform.EliminateCommonSubexpr()]
+    )
+    expected = seq(mod)
+    config = {"relax.FunctionPass.num_threads": 4, "tir.PrimFuncPass.num_threads": 0}
+    with tvm.transform.PassContext(config=config):
+        after = seq(mod)
+    assert_structural_equal(after, expected)
+
+    config = {"relax.FunctionPass.num_threads": 4, "relax.FunctionPass.use_object_pool": True}
+    with tvm.transform.PassContext(config=config):
+        after = seq(mod)
+    assert_structural_equal(after, expected)
+
+
 def test_dataflowblock_class_pass():
     @relax.transform.dataflowblock_pass(opt_level=1)
     class TestReplaceBinding:
@@ -329,6 +329,38 @@ def test_class_irmodule():
     check_roundtrip(my_module)
 
 
+def test_print_irmodule_in_parallel():
+    @tvm.script.ir_module
+    class MyModule:
+        @T.prim_func
+        def add(a: T.handle, b: T.handle) -> None:
+            A = T.match_buffer(a, (16,))
+            B = T.match_buffer(b, (16,))
+            for i in T.serial(16):
+                with T.block():
+                    vi = T.axis.remap("S", [i])
+                    B[vi] = A[vi] + 1.0
+
+        @T.prim_func
+        def mul(a: T.handle, b: T.handle) -> None:
+            A = T.match_buffer(a, (16,))
+            B = T.match_buffer(b, (16,))
+            for i in T.serial(16):
+                with T.block():
+                    vi = T.axis.remap("S", [i])
+                    B[vi] = A[vi] * 2.0
+
+        @R.function
+        def f(x: Tensor((16,), "float32")) -> Tensor:
+            y = relax.call_tir(add, (x,), (16,), dtype="float32")
+            z = relax.call_tir(mul, (y,), (16,), dtype="float32")
+            return z
+
+    text = R.parser.astext(MyModule, show_meta_data=True)
+    assert R.parser.astext(MyModule, show_meta_data=True, num_threads=4) == text
+    assert R.parser.astext(MyModule, show_meta_data=True, num_threads=-1) == text
+    check_roundtrip(MyModule)
+
 def test_tir_max():
     @R.function
     def tir_max(x: Tensor((m, n), "float32")):
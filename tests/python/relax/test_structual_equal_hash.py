@@ -36,6 +36,8 @@ def _check_equal(x, y):
 def _check_save_roundtrip(x):
     y = tvm.ir.load_json(tvm.ir.save_json(x))
     _check_equal(x, y)
+    z = tvm.ir.load_binary(tvm.ir.save_binary(x))
+    _check_equal(x, z)
 
 
 def test_var_binding():
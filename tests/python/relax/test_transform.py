@@ -322,6 +322,102 @@ def test_call_tir_rewrite():
     assert s2.op.global_symbol == "test.op.identity"
 
 
+def test_call_tir_rewrite_inplace():
+    @tvm.script.ir_module
+    class TestCallTIRInplace:
+        @T.prim_func
+        def exp(x: T.handle, y: T.handle) -> None:
+            A = T.match_buffer(x, (2, 2))
+            B = T.match_buffer(y, (2, 2))
+            for i, j in T.grid(2, 2):
+                with T.block("exp"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = T.exp(A[vi, vj])
+
+        @T.prim_func
+        def transpose(x: T.handle, y: T.handle) -> None:
+            A = T.match_buffer(x, (2, 2))
+            B = T.match_buffer(y, (2, 2))
+            for i, j in T.grid(2, 2):
+                with T.block("transpose"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = A[vj, vi]
+
+        @T.prim_func
+        def add(x: T.handle, y: T.handle, z: T.handle) -> None:
+            A = T.match_buffer(x, (2, 2))
+            B = T.match_buffer(y, (2, 2))
+            C = T.match_buffer(z, (2, 2))
+            for i, j in T.grid(2, 2):
+                with T.block("add"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    C[vi, vj] = A[vi, vj] + B[vi, vj]
+
+        @R.function
+        def foo(x: Tensor((2, 2), "float32")):
+            a = relax.call_tir(exp, (x,), (2, 2), dtype="float32")
+            b = relax.call_tir(exp, (a,), (2, 2), dtype="float32")
+            c = relax.call_tir(transpose, (b,), (2, 2), dtype="float32")
+            d = relax.call_tir(exp, (c,), (2, 2), dtype="float32")
+            e = relax.call_tir(add, (c, d), (2, 2), dtype="float32")
+            return e
+
+    mod = TestCallTIRInplace
+    inplace = relax.analysis.call_tir_inplace_inputs(mod, mod["foo"])
+    # the param x, the transposed b and the twice used c are not written in place
+    assert {v.name_hint: i for v, i in inplace.items()} == {"b": 0, "e": 1}
+
+    def num_allocs(func):
+        return len(
+            [
+                b
+                for b in func.body.blocks[0].bindings
+                if isinstance(b.value, relax.Call)
+                and isinstance(b.value.op, tvm.ir.Op)
+                and b.value.op.name == "relax.builtin.alloc_tensor"
+            ]
+        )
+
+    assert num_allocs(relax.transform.CallTIRRewrite()(mod)["foo"]) == 5
+    assert num_allocs(relax.transform.CallTIRRewrite(inplace=True)(mod)["foo"]) == 3
+
+
+def test_lift_tir_workspace():
+    @tvm.script.ir_module
+    class TestLiftWorkspace:
+        @T.prim_func
+        def exp_twice(x: T.handle, y: T.handle) -> None:
+            A = T.match_buffer(x, (2, 2))
+            B = T.match_buffer(y, (2, 2))
+            C = T.alloc_buffer((2, 2))
+            for i, j in T.grid(2, 2):
+                with T.block("exp0"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    C[vi, vj] = T.exp(A[vi, vj])
+            for i, j in T.grid(2, 2):
+                with T.block("exp1"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = T.exp(C[vi, vj])
+
+        @R.function
+        def foo(x: Tensor((2, 2), "float32")):
+            gv0 = relax.call_tir(exp_twice, (x,), (2, 2), dtype="float32")
+            return gv0
+
+    mod = relax.transform.LiftTIRWorkspace()(TestLiftWorkspace)
+    func = mod["exp_twice"]
+    assert len(func.params) == 3
+    assert int(func.attrs["num_workspaces"]) == 1
+    assert len(func.body.block.alloc_buffers) == 0
+
+    # the output and the workspace are allocated by the caller
+    bindings = relax.transform.CallTIRRewrite()(mod)["foo"].body.blocks[0].bindings
+    out, workspace, call = [b.var for b in bindings[:2]] + [bindings[2].value]
+    assert bindings[1].value.op.name == "relax.builtin.alloc_tensor"
+    assert [int(v) for v in bindings[1].value.args[0].values] == [2, 2]
+    assert call.args[1].same_as(out) and call.args[2].same_as(workspace)
+
+
 def test_vm_memory_lower():
     @tvm.script.ir_module
     class TestVMMemoryLower:
@@ -355,6 +451,186 @@ def test_vm_memory_lower():
     assert s4.op.global_symbol == "test.op.identity"
 
 
+def test_vm_memory_lower_plan_memory():
+    @tvm.script.ir_module
+    class TestVMMemoryPlan:
+        @R.function
+        def foo(x: Tensor((2, 3), "float32")) -> Tensor:
+            a = relax.builtin.alloc_tensor((2, 3), runtime_device_index=0, dtype="float32")
+            _ = relax.call_packed(
+                "test.op.identity", x, a, type_args=(Tensor(rank=2, dtype="float32"))
+            )
+            b = relax.builtin.alloc_tensor((2, 3), runtime_device_index=0, dtype="float32")
+            _1 = relax.call_packed(
+                "test.op.identity", a, b, type_args=(Tensor(rank=2, dtype="float32"))
+            )
+            c = relax.builtin.alloc_tensor((2, 3), runtime_device_index=0, dtype="float32")
+            _2 = relax.call_packed(
+                "test.op.identity", b, c, type_args=(Tensor(rank=2, dtype="float32"))
+            )
+            d = relax.builtin.alloc_tensor((2, 3), runtime_device_index=0, dtype="float32")
+            _3 = relax.call_packed(
+                "test.op.identity", c, d, type_args=(Tensor(rank=2, dtype="float32"))
+            )
+            return d
+
+    new_mod = relax.transform.VMMemoryLower(plan_memory=True)(TestVMMemoryPlan)
+    bindings = new_mod["foo"].body.blocks[0].bindings
+    calls = [
+        b.value
+        for b in bindings
+        if isinstance(b.value, relax.Call) and isinstance(b.value.op, tvm.ir.Op)
+    ]
+    storages = [c for c in calls if c.op.name == "relax.vm.builtin.alloc_storage"]
+    tensors = [c for c in calls if c.op.name == "relax.vm.builtin.alloc_tensor"]
+
+    # a, b and c share one arena of two tokens, c reuses the storage of a
+    assert len(storages) == 2
+    assert [int(v) for v in storages[0].args[0].values] == [128]
+    assert storages[0].attrs.persistent and not storages[1].attrs.persistent
+    arena = bindings[0].var
+    assert [t.args[0] for t in tensors[:3]] == [arena] * 3
+    assert [t.attrs.offset for t in tensors[:3]] == [0, 64, 0]
+    # the returned tensor keeps its own storage
+    assert not tensors[3].args[0].same_as(arena)
+    assert tensors[3].attrs.offset == 0
+
+
+@pytest.mark.parametrize("algorithm", ["greedy_by_size", "greedy_by_conflicts", "hill_climb"])
+def test_vm_memory_lower_plan_memory_usmp(algorithm):
+    @tvm.script.ir_module
+    class TestVMMemoryPlanUSMP:
+        @R.function
+        def foo(x: Tensor((2, 3), "float32")) -> Tensor:
+            a = relax.builtin.alloc_tensor((2, 3), runtime_device_index=0, dtype="float32")
+            _ = relax.call_packed(
+                "test.op.identity", x, a, type_args=(Tensor(rank=2, dtype="float32"))
+            )
+            b = relax.builtin.alloc_tensor((4, 8), runtime_device_index=0, dtype="float32")
+            _1 = relax.call_packed(
+                "test.op.identity", a, b, type_args=(Tensor(rank=2, dtype="float32"))
+            )
+            c = relax.builtin.alloc_tensor((2, 3), runtime_device_index=0, dtype="float32")
+            _2 = relax.call_packed(
+                "test.op.identity", b, c, type_args=(Tensor(rank=2, dtype="float32"))
+            )
+            d = relax.builtin.alloc_tensor((2, 3), runtime_device_index=0, dtype="float32")
+            _3 = relax.call_packed(
+                "test.op.identity", c, d, type_args=(Tensor(rank=2, dtype="float32"))
+            )
+            return d
+
+    with tvm.transform.PassContext(config={"relax.VMMemoryLower.algorithm": algorithm}):
+        new_mod = relax.transform.VMMemoryLower(plan_memory=True)(TestVMMemoryPlanUSMP)
+    func = new_mod["foo"]
+    calls = [
+        b.value
+        for b in func.body.blocks[0].bindings
+        if isinstance(b.value, relax.Call) and isinstance(b.value.op, tvm.ir.Op)
+    ]
+    storages = [c for c in calls if c.op.name == "relax.vm.builtin.alloc_storage"]
+    offsets = [c.attrs.offset for c in calls if c.op.name == "relax.vm.builtin.alloc_tensor"]
+    # b conflicts with a and c, which do not conflict with each other
+    assert offsets[0] == offsets[2] and offsets[1] != offsets[0]
+    assert int(storages[0].args[0].values[0]) == 128 + 64
+
+
+def test_vm_memory_lower_plan_memory_fast_scope():
+    @tvm.script.ir_module
+    class TestVMMemoryPlanFast:
+        @R.function
+        def foo(x: Tensor((2, 3), "float32")) -> Tensor:
+            a = relax.builtin.alloc_tensor((2, 3), runtime_device_index=0, dtype="float32")
+            _ = relax.call_packed(
+                "test.op.identity", x, a, type_args=(Tensor(rank=2, dtype="float32"))
+            )
+            b = relax.builtin.alloc_tensor((4, 8), runtime_device_index=0, dtype="float32")
+            _1 = relax.call_packed(
+                "test.op.identity", a, b, type_args=(Tensor(rank=2, dtype="float32"))
+            )
+            c = relax.builtin.alloc_tensor((2, 3), runtime_device_index=0, dtype="float32")
+            _2 = relax.call_packed(
+                "test.op.identity", b, c, type_args=(Tensor(rank=2, dtype="float32"))
+            )
+            d = relax.builtin.alloc_tensor((2, 3), runtime_device_index=0, dtype="float32")
+            _3 = relax.call_packed(
+                "test.op.identity", c, d, type_args=(Tensor(rank=2, dtype="float32"))
+            )
+            return d
+
+    config = {
+        "relax.VMMemoryLower.fast_scope": "global.vtcm",
+        "relax.VMMemoryLower.fast_capacity": 128,
+    }
+    with tvm.transform.PassContext(config=config):
+        new_mod = relax.transform.VMMemoryLower(plan_memory=True)(TestVMMemoryPlanFast)
+    func = new_mod["foo"]
+    calls = [
+        b.value
+        for b in func.body.blocks[0].bindings
+        if isinstance(b.value, relax.Call) and isinstance(b.value.op, tvm.ir.Op)
+    ]
+    storages = [c for c in calls if c.op.name == "relax.vm.builtin.alloc_storage"]
+    tensors = [c for c in calls if c.op.name == "relax.vm.builtin.alloc_tensor"]
+    # a and c, the densest tensors, share the fast arena, b does not fit next to them
+    fast = storages[0]
+    assert fast.attrs.storage_scope == "global.vtcm" and not fast.attrs.persistent
+    assert int(fast.args[0].values[0]) == 64
+    assert tensors[0].args[0].same_as(tensors[2].args[0])
+    assert not tensors[1].args[0].same_as(tensors[0].args[0])
+    assert storages[1].attrs.storage_scope == "global"
+    assert int(func.attrs["planned_fast_arena_bytes"]) == 64
+    assert int(func.attrs["planned_arena_bytes"]) == 128 + 64
+
+
+def test_vm_memory_lower_plan_memory_unknown_algorithm():
+    @tvm.script.ir_module
+    class TestVMMemoryPlanUnknown:
+        @R.function
+        def foo(x: Tensor((2, 3), "float32")) -> Tensor:
+            return x
+
+    with tvm.transform.PassContext(config={"relax.VMMemoryLower.algorithm": "unknown"}):
+        with pytest.raises(tvm.TVMError):
+            relax.transform.VMMemoryLower(plan_memory=True)(TestVMMemoryPlanUnknown)
+
+
+def test_vm_memory_lower_plan_memory_upper_bound():
+    @tvm.script.ir_module
+    class TestVMMemoryPlanDynamic:
+        @R.function
+        def foo(x: Tensor((n, 4), "float32")) -> Tensor:
+            a = relax.builtin.alloc_tensor((n, 4), runtime_device_index=0, dtype="float32")
+            _ = relax.call_packed(
+                "test.op.identity", x, a, type_args=(Tensor(rank=2, dtype="float32"))
+            )
+            b = relax.builtin.alloc_tensor((n, 4), runtime_device_index=0, dtype="float32")
+            _1 = relax.call_packed(
+                "test.op.identity", a, b, type_args=(Tensor(rank=2, dtype="float32"))
+            )
+            return b
+
+    def storage_sizes(mod):
+        bindings = mod["foo"].body.blocks[0].bindings
+        return [
+            b.value.args[0].values[0]
+            for b in bindings
+            if isinstance(b.value, relax.Call)
+            and isinstance(b.value.op, tvm.ir.Op)
+            and b.value.op.name == "relax.vm.builtin.alloc_storage"
+        ]
+
+    # without upper bounds the symbolic allocation is not planned
+    sizes = storage_sizes(relax.transform.VMMemoryLower(plan_memory=True)(TestVMMemoryPlanDynamic))
+    assert len(sizes) == 2 and not isinstance(sizes[0], tvm.tir.IntImm)
+
+    mod = tvm.IRModule(
+        {"foo": TestVMMemoryPlanDynamic["foo"].with_attr("tir_var_upper_bound", {"n": 10})}
+    )
+    sizes = storage_sizes(relax.transform.VMMemoryLower(plan_memory=True)(mod))
+    assert isinstance(sizes[0], tvm.tir.IntImm) and sizes[0].value == 192
+
+
 def test_vm_shape_lowering():
     @tvm.script.ir_module
     class TestVMShapeLower:
@@ -391,6 +667,40 @@ def test_vm_shape_lowering():
     assert s5.op.name == "relax.vm.builtin.load_shape"
 
 
+def test_vm_shape_lowering_shared_slots():
+    @tvm.script.ir_module
+    class TestVMShapeLower:
+        @R.function
+        def foo(x: Tensor(_, "float32")):
+            relax.match_shape(x, (n,))
+            return (n * 2, 2 * n)
+
+    # n * 2 and 2 * n have the same canonical form, so they share a slot of the shape heap
+    func = relax.transform.VMShapeLower()(TestVMShapeLower)["foo"]
+    s1 = func.body.blocks[0].bindings[0].value
+    assert s1.op.global_symbol == "vm.builtin.alloc_shape_heap"
+    assert s1.args[0].values[0] == 2
+
+def test_vm_shape_lowering_native_arith():
+    @tvm.script.ir_module
+    class TestVMShapeLower:
+        @R.function
+        def foo(x: Tensor(_, "float32")):
+            relax.match_shape(x, (n, m))
+            return (n * 2, m * 3)
+
+    mod = TestVMShapeLower
+
+    new_mod = relax.transform.VMShapeLower(native_shape_arith=True)(mod)
+    assert "shape_func" not in [gv.name_hint for gv in new_mod.get_global_vars()]
+    func = new_mod["foo"]
+    s4 = func.body.blocks[2].bindings[0].value
+    assert s4.op.name == "relax.vm.builtin.compute_shape"
+    assert [int(i) for i in s4.attrs.indices] == [2, 3]
+    s5 = func.body.blocks[2].bindings[1].value
+    assert s5.op.name == "relax.vm.builtin.load_shape"
+
+
 def test_vm_static_shape_lowering():
     @tvm.script.ir_module
     class TestVMStaticShapeLower:
@@ -66,6 +66,15 @@ def check_roundtrip(exec0, dev, inputs, expected):
     check_executable(exec1, dev, inputs, expected)
 
 
+def check_engine_roundtrip(exec0, dev, inputs, expected):
+    # the engines built by the first run are saved with the executable
+    check_executable(exec0, dev, inputs, expected)
+    exec0.mod.export_library("exec.so")
+    exec1 = relax.vm.Executable(tvm.runtime.load_module("exec.so"))
+    os.remove("exec.so")
+    check_executable(exec1, dev, inputs, expected)
+
+
 def gen_ground_truth(mod, target, dev, inputs):
     # Lower and run tuning
     # Since there is no default schedule for GPU in MS yet, this is necessary
@@ -138,6 +147,7 @@ def test_single_annot_func():
 
     # Sanity check for the correctness and rountrip
     check_roundtrip(ex0, dev, inputs, expected)
+    check_engine_roundtrip(ex0, dev, inputs, expected)
 
     # If the annotation does not match with the target codegen, do not perform the codegen process.
     new_mod = relax.transform.RunCodegen(target_codegens=["INVALID_CODEGEN"])(mod)
@@ -215,6 +225,150 @@ def test_mix_use_tensorrt_and_tvm():
     check_roundtrip(ex0, dev, inputs, expected)
 
 
+@tvm.testing.requires_gpu
+def test_overlap_tensorrt_and_tvm():
+    @tvm.script.ir_module
+    class InputModule:
+        @R.function
+        def byoc_func(
+            x: Tensor((16, 16), "float32"), y: Tensor((16, 16), "float32")
+        ) -> Tensor((16, 16), "float32"):
+            z1 = relax.multiply(x, y)
+            z2 = relax.add(z1, z1)
+            return z2
+
+        @R.function
+        def main(
+            x: Tensor((16, 16), "float32"), y: Tensor((16, 16), "float32")
+        ) -> Tensor((16, 16), "float32"):
+            lv0 = byoc_func(x, y)
+            lv1 = R.multiply(x, x)
+            lv2 = R.add(lv0, lv1)
+            return lv2
+
+    mod = InputModule
+    np0 = np.random.rand(16, 16).astype(np.float32)
+    np1 = np.random.rand(16, 16).astype(np.float32)
+    inputs = [tvm.nd.array(np0, dev), tvm.nd.array(np1, dev)]
+    expected = tvm.nd.array(np0 * np1 * 2 + np0 * np0)
+
+    new_byoc_func = mod["byoc_func"].with_attr("Codegen", "tensorrt")
+    new_byoc_func = new_byoc_func.with_attr("global_symbol", "trt_byoc_func")
+    mod["byoc_func"] = new_byoc_func
+
+    with tempfile.TemporaryDirectory() as work_dir:
+        with target, tvm.transform.PassContext(trace=Trace(mod), opt_level=3):
+            seq = tvm.transform.Sequential(
+                [
+                    relax.transform.RunCodegen(),
+                    relax.transform.RemoveUnusedFunctions(),
+                    transform.LowerWithRelayOpStrategyPass(target),
+                    relax.transform.MetaScheduleTuneIRMod(
+                        params={}, work_dir=work_dir, max_trials_global=8
+                    ),
+                    relax.transform.MetaScheduleApplyDatabase(work_dir),
+                ]
+            )
+            new_mod = seq(mod)
+    assert new_mod.attrs["external_mods"][0]["is_stream_ordered"]()
+    # the engine and the kernel do not depend on each other, so they start on different streams
+    with transform.PassContext(opt_level=0, config={"relax.VMCodeGen.num_streams": 2}):
+        ex0 = relax.vm.build(new_mod, target, params={})
+    text = ex0.as_text()
+    assert "vm.builtin.set_stream" in text
+    assert "vm.builtin.sync_stream" in text
+    check_executable(ex0, dev, inputs, expected)
+
+
+@tvm.testing.requires_gpu
+def test_dynamic_shape_profiles():
+    n = tvm.tir.Var("n", "int64")
+    x = relax.Var("x", [n, 16], relax.DynTensorType(2, "float32"))
+    y = relax.Var("y", [n, 16], relax.DynTensorType(2, "float32"))
+    bb = relax.BlockBuilder()
+    with bb.function("byoc_func", [x, y]):
+        z1 = bb.emit(relax.op.multiply(x, y))
+        z2 = bb.emit(relax.op.add(z1, z1))
+        z3 = bb.emit(relax.op.add(z1, z2))
+        bb.emit_func_output(z3)
+    x = relax.Var("x", [n, 16], relax.DynTensorType(2, "float32"))
+    y = relax.Var("y", [n, 16], relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x, y]):
+        out = bb.emit(relax.Call(bb.get().get_global_var("byoc_func"), [x, y]))
+        bb.emit_func_output(out)
+    mod = bb.get()
+    mod["byoc_func"] = (
+        mod["byoc_func"]
+        .with_attr("Codegen", "tensorrt")
+        .with_attr("global_symbol", "trt_byoc_func")
+        .with_attr("tir_var_upper_bound", {"n": 64})
+    )
+
+    # the engine is built once for n in [1, 64] and selected for every request in the range
+    with tempfile.TemporaryDirectory() as cache_dir:
+        os.environ["TVM_TENSORRT_CACHE_DIR"] = cache_dir
+        try:
+            with tvm.transform.PassContext(
+                config={"relax.ext.tensorrt.options": {"use_implicit_batch": False}}
+            ):
+                new_mod = relax.transform.RunCodegen()(mod)
+            ex0 = relax.vm.build(new_mod, target, params={})
+            for num_rows in [8, 13, 64]:
+                np0 = np.random.rand(num_rows, 16).astype(np.float32)
+                np1 = np.random.rand(num_rows, 16).astype(np.float32)
+                inputs = [tvm.nd.array(np0, dev), tvm.nd.array(np1, dev)]
+                check_executable(ex0, dev, inputs, tvm.nd.array(np0 * np1 * 3))
+            assert len([f for f in os.listdir(cache_dir) if f.endswith(".plan")]) == 1
+        finally:
+            del os.environ["TVM_TENSORRT_CACHE_DIR"]
+
+
+@tvm.testing.requires_gpu
+def test_int8_calibration_cache():
+    from tvm.relax.op.contrib.tensorrt import calibrate_int8
+
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [16, 16], relax.DynTensorType(2, "float32"))
+    y = relax.Var("y", [16, 16], relax.DynTensorType(2, "float32"))
+    with bb.function("byoc_func", [x, y]):
+        z = bb.emit(relax.op.add(x, y))
+        bb.emit_func_output(bb.emit(relax.op.multiply(z, y)))
+    with bb.function("main", [x, y]):
+        out = bb.emit(relax.Call(bb.get().get_global_var("byoc_func"), [x, y]))
+        bb.emit_func_output(out)
+    mod = bb.get()
+    mod["byoc_func"] = (
+        mod["byoc_func"]
+        .with_attr("Codegen", "tensorrt")
+        .with_attr("global_symbol", "trt_int8_func")
+    )
+
+    def make_inputs():
+        np0 = np.random.rand(16, 16).astype(np.float32)
+        np1 = np.random.rand(16, 16).astype(np.float32)
+        return [tvm.nd.array(np0, dev), tvm.nd.array(np1, dev)], (np0 + np1) * np1
+
+    with tempfile.TemporaryDirectory() as cache_dir:
+        options = {
+            "use_int8": True,
+            "num_calibration_batches": 4,
+            "calibration_cache_dir": cache_dir,
+            # the multiply stays in float32, the add runs in int8
+            "fp32_layers": ["multiply"],
+        }
+        for calibrated in [False, True]:
+            with tvm.transform.PassContext(config={"relax.ext.tensorrt.options": options}):
+                new_mod = relax.transform.RunCodegen()(mod)
+            vm = relax.VirtualMachine(relax.vm.build(new_mod, target, params={}), dev)
+            if not calibrated:
+                calibrate_int8(vm, "main", [make_inputs()[0] for _ in range(4)])
+            # a later build reuses the cached calibration, without calibration runs
+            assert os.path.exists(os.path.join(cache_dir, "trt_int8_func.calib"))
+            inputs, expected = make_inputs()
+            out = vm["main"](*inputs)
+            tvm.testing.assert_allclose(out.numpy(), expected, atol=0.1, rtol=0.1)
+
+
 # TODO(@sunggg):  test with more complex patterns (e.g., multiple annots, mixed codegens, different ops, const binding)
 
 if __name__ == "__main__":
@@ -0,0 +1,87 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import sys
+
+import numpy as np
+import pytest
+import tvm
+import tvm.testing
+from tvm import relax, topi
+
+
+def _num_call_tir(func, name):
+    calls = []
+
+    def fvisit(e):
+        if isinstance(e, relax.Call) and e.op == tvm.ir.Op.get("relax.call_tir"):
+            if e.args[0].name_hint.startswith(name):
+                calls.append(e)
+
+    relax.analysis.post_order_visit(func.body, fvisit)
+    return len(calls)
+
+
+def test_combine_dense():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [4, 16], relax.DynTensorType(2, "float32"))
+    wq = relax.Var("wq", [8, 16], relax.DynTensorType(2, "float32"))
+    wk = relax.Var("wk", [8, 16], relax.DynTensorType(2, "float32"))
+    wv = relax.Var("wv", [4, 16], relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x, wq, wk, wv]):
+        with bb.dataflow():
+            q = bb.emit_te(topi.nn.dense, x, wq)
+            k = bb.emit_te(topi.nn.dense, x, wk)
+            v = bb.emit_te(topi.nn.dense, x, wv)
+            gv = bb.emit_output(relax.Tuple([q, k, v]))
+        bb.emit_func_output(gv)
+    mod = bb.get()
+
+    after = relax.transform.CombineParallelMatmul()(mod)
+    assert _num_call_tir(after["main"], "dense") == 0
+    assert _num_call_tir(after["main"], "matmul") == 1
+    assert _num_call_tir(after["main"], "split") == 3
+
+    inputs = [
+        tvm.nd.array(np.random.rand(*shape).astype("float32"))
+        for shape in [(4, 16), (8, 16), (8, 16), (4, 16)]
+    ]
+    results = []
+    for m in [mod, after]:
+        vm = relax.VirtualMachine(relax.vm.build(m, "llvm"), tvm.cpu())
+        results.append(vm["main"](*inputs))
+    for expected, actual in zip(*results):
+        tvm.testing.assert_allclose(actual.numpy(), expected.numpy(), rtol=1e-5, atol=1e-5)
+
+
+def test_keep_matmuls_of_different_inputs():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [4, 16], relax.DynTensorType(2, "float32"))
+    y = relax.Var("y", [4, 16], relax.DynTensorType(2, "float32"))
+    w = relax.Var("w", [8, 16], relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x, y, w]):
+        with bb.dataflow():
+            lv0 = bb.emit_te(topi.nn.dense, x, w)
+            lv1 = bb.emit_te(topi.nn.dense, y, w)
+            gv = bb.emit_output(relax.Tuple([lv0, lv1]))
+        bb.emit_func_output(gv)
+    mod = bb.get()
+    after = relax.transform.CombineParallelMatmul()(mod)
+    tvm.ir.assert_structural_equal(after["main"], mod["main"])
+
+
+if __name__ == "__main__":
+    sys.exit(pytest.main([__file__] + sys.argv[1:]))
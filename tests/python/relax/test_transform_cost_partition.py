@@ -0,0 +1,97 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.relax.op.contrib import cublas, dnnl
+
+
+def get_module(m=8, k=32, n=16):
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [m, k], relax.DynTensorType(2, "float32"))
+    w0 = relax.Var("w0", [n, k], relax.DynTensorType(2, "float32"))
+    b0 = relax.Var("b0", [n], relax.DynTensorType(1, "float32"))
+    w1 = relax.Var("w1", [n, n], relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x, w0, b0, w1]):
+        with bb.dataflow():
+            lv0 = bb.emit(relax.op.nn.matmul(x, w0, transpose_b=True))
+            lv1 = bb.emit(relax.op.add(lv0, b0))
+            lv2 = bb.emit(relax.op.nn.relu(lv1))
+            lv3 = bb.emit(relax.op.nn.matmul(lv2, w1, transpose_b=True))
+            gv = bb.emit_output(relax.op.multiply(lv3, lv3))
+        bb.emit_func_output(gv)
+    return bb.get()
+
+
+def mock_estimator(offload_costs, matmul_cost, ewise_cost):
+    """A flat cost by codegen for the offloaded candidates, a cost by op for the native ones."""
+
+    def estimate(mod, target):
+        for func in mod.functions.values():
+            if func.attrs is not None and "Codegen" in func.attrs:
+                return offload_costs[func.attrs["Codegen"]]
+        matmul_op = tvm.ir.Op.get("relax.nn.matmul")
+        bindings = mod["main"].body.blocks[0].bindings
+        return sum(matmul_cost if b.value.op == matmul_op else ewise_cost for b in bindings)
+
+    return estimate
+
+
+def get_offloaded(mod):
+    """The codegen and the composites of each call of main, or the op when not offloaded."""
+    calls = []
+    for binding in mod["main"].body.blocks[0].bindings:
+        call = binding.value
+        if isinstance(call.op, tvm.ir.Op):
+            calls.append(call.op.name)
+            continue
+        func = mod[call.op]
+        composites = [b.value.op.attrs["Composite"] for b in func.body.blocks[0].bindings]
+        calls.append((func.attrs["Codegen"], composites))
+    return calls
+
+
+def test_small_ops_stay_native():
+    backends = [relax.transform.OffloadBackend(dnnl.get_patterns(), dnnl.check_op)]
+    # The call overhead of the codegen outweighs the native elementwise ops, not the matmuls.
+    estimator = mock_estimator({"dnnl": 1.0}, matmul_cost=5.0, ewise_cost=0.1)
+    mod = relax.transform.CostAwarePartition(backends, estimator=estimator)(get_module())
+    assert get_offloaded(mod) == [
+        ("dnnl", ["dnnl.dense_bias_relu", "dnnl.dense"]),
+        "relax.multiply",
+    ]
+
+
+def test_fastest_backend():
+    backends = [
+        relax.transform.OffloadBackend(dnnl.get_patterns(), dnnl.check_op),
+        relax.transform.OffloadBackend(cublas.get_patterns(), cublas.check_matmul, "cuda"),
+    ]
+    # cuBLAS is faster on the matmuls, although DNNL comes first in the order of priority.
+    estimator = mock_estimator({"dnnl": 2.0, "cublas": 1.0}, matmul_cost=5.0, ewise_cost=3.0)
+    mod = relax.transform.CostAwarePartition(backends, estimator=estimator, merge=False)(
+        get_module()
+    )
+    assert get_offloaded(mod) == [
+        ("cublas", ["cublas.matmul_bias_relu"]),
+        ("cublas", ["cublas.matmul"]),
+        ("dnnl", ["dnnl.multiply"]),
+    ]
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,79 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import sys
+
+import pytest
+import tvm
+from tvm import relax, topi
+
+
+def test_eliminate_common_subexpr():
+    def before():
+        bb = relax.BlockBuilder()
+        x = relax.Var("x", [4, 4], relax.DynTensorType(2, "float32"))
+        with bb.function("main", [x]):
+            with bb.dataflow():
+                lv0 = bb.emit_te(topi.cast, x, "float16")
+                lv1 = bb.emit_te(topi.cast, x, "float16")
+                lv2 = bb.emit_te(topi.add, lv0, lv1)
+                gv = bb.emit_output(bb.call_te(topi.cast, x, "float16"))
+            bb.emit_func_output(relax.Tuple([lv2, gv]))
+        return bb.get()
+
+    def expected():
+        bb = relax.BlockBuilder()
+        x = relax.Var("x", [4, 4], relax.DynTensorType(2, "float32"))
+        with bb.function("main", [x]):
+            with bb.dataflow():
+                lv0 = bb.emit_te(topi.cast, x, "float16")
+                lv2 = bb.emit_te(topi.add, lv0, lv0)
+                gv = bb.emit_output(lv0)
+            bb.emit_func_output(relax.Tuple([lv2, gv]))
+        return bb.get()
+
+    after = relax.transform.EliminateCommonSubexpr()(before())
+    tvm.ir.assert_structural_equal(after["main"], expected()["main"])
+
+
+def test_dead_code_elimination():
+    def before():
+        bb = relax.BlockBuilder()
+        x = relax.Var("x", [4, 4], relax.DynTensorType(2, "float32"))
+        with bb.function("main", [x]):
+            with bb.dataflow():
+                # lv1 is unused, which leaves lv0 unused once it is removed
+                lv0 = bb.emit_te(topi.exp, x)
+                bb.emit_te(topi.negative, lv0)
+                gv = bb.emit_output(bb.call_te(topi.add, x, x))
+            bb.emit_func_output(gv)
+        return bb.get()
+
+    def expected():
+        bb = relax.BlockBuilder()
+        x = relax.Var("x", [4, 4], relax.DynTensorType(2, "float32"))
+        with bb.function("main", [x]):
+            with bb.dataflow():
+                gv = bb.emit_output(bb.call_te(topi.add, x, x))
+            bb.emit_func_output(gv)
+        return bb.get()
+
+    after = relax.transform.DeadCodeElimination()(before())
+    tvm.ir.assert_structural_equal(after["main"], expected()["main"])
+
+
+if __name__ == "__main__":
+    sys.exit(pytest.main([__file__] + sys.argv[1:]))
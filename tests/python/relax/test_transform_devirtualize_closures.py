@@ -0,0 +1,123 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+from __future__ import annotations
+import tvm
+import tvm.script
+import tvm.testing
+from tvm import relax
+from tvm.relax import transform
+from tvm.script import relax as R
+
+
+def _called_ops(func):
+    ops = []
+
+    def fvisit(e):
+        if isinstance(e, relax.Call):
+            ops.append(e.op)
+
+    relax.analysis.post_order_visit(func.body, fvisit)
+    return ops
+
+
+def test_recursive_closure():
+    @tvm.script.ir_module
+    class Before:
+        @R.function
+        def main(x: Tensor((2, 3), "float32")) -> Tensor:
+            @R.function
+            def while_loop(
+                i: Tensor((), "int32"), s: Tensor((2, 3), "float32")
+            ) -> Tensor((2, 3), "float32"):
+                cond: Tensor((), "bool") = relax.call_packed(
+                    "test.vm.less", i, relax.const(10), type_args=(Tensor(ndim=0, dtype="bool"))
+                )
+                c: Tensor((), "int32") = relax.const(1, dtype="int32")
+                if cond:
+                    new_i: Tensor((), "int32") = relax.add(i, c)
+                    new_s: Tensor((2, 3), "float32") = relax.add(s, x)
+                    r: Tensor((2, 3), "float32") = while_loop(new_i, new_s)
+                else:
+                    r: Tensor((2, 3), "float32") = s
+                return r
+
+            gv: Tensor((2, 3), "float32") = while_loop(relax.const(0), x)
+            return gv
+
+    lifted = transform.LambdaLift()(Before)
+    after = transform.DevirtualizeClosures()(lifted)
+    ops = _called_ops(after["main"])
+    assert ops == [after.get_global_var("lifted_func_0")]
+    bindings = after["main"].body.blocks[0].bindings
+    assert len(bindings) == 1
+    call = bindings[0].value
+    # The captured x is passed after the arguments of the invocation.
+    assert len(call.args) == 3
+    assert call.args[1].same_as(after["main"].params[0])
+    assert call.args[2].same_as(after["main"].params[0])
+    tvm.ir.assert_structural_equal(after["lifted_func_0"], lifted["lifted_func_0"])
+
+
+def test_curried_closure():
+    @tvm.script.ir_module
+    class Before:
+        @R.function
+        def main(
+            x: Tensor((2, 3), "float32"), y: Tensor((2, 3), "float32")
+        ) -> Tensor((2, 3), "float32"):
+            @R.function
+            def outer_func(c1: Tensor((2, 3), "float32")):
+                @R.function
+                def inner_func(x1: Tensor((2, 3), "float32")):
+                    s: Tensor((2, 3), "float32") = relax.add(x1, c1)
+                    return s
+
+                return inner_func
+
+            in_call = outer_func(x)
+            res = in_call(y)
+            return res
+
+    lifted = transform.LambdaLift()(Before)
+    closure_ops = [tvm.ir.Op.get("relax.make_closure"), tvm.ir.Op.get("relax.invoke_closure")]
+    assert any(op in closure_ops for op in _called_ops(lifted["main"]))
+
+    after = transform.DevirtualizeClosures()(lifted)
+    x, y = after["main"].params
+    bindings = after["main"].body.blocks[0].bindings
+    # The closure and its factory call are removed, only the direct call remains.
+    assert len(bindings) == 1
+    call = bindings[0].value
+    assert call.op.same_as(after.get_global_var("lifted_func_1"))
+    assert call.args[0].same_as(y)
+    assert call.args[1].same_as(x)
+
+
+def test_unknown_closure_kept():
+    @tvm.script.ir_module
+    class Before:
+        @R.function
+        def main(f: Object, x: Tensor((2, 3), "float32")):
+            res = relax.invoke_closure(f, (x,), type_args=(Tensor(ndim=2, dtype="float32")))
+            return res
+
+    after = transform.DevirtualizeClosures()(Before)
+    tvm.ir.assert_structural_equal(after, Before)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,70 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import sys
+
+import pytest
+import tvm
+from tvm import relax, topi
+
+
+def test_elide_inverse_transposes():
+    def before():
+        bb = relax.BlockBuilder()
+        x = relax.Var("x", [1, 3, 8, 8], relax.DynTensorType(4, "float32"))
+        with bb.function("main", [x]):
+            with bb.dataflow():
+                # NCHW -> NHWC, an op in NHWC, then back to NCHW for the next op
+                lv0 = bb.emit_te(topi.transpose, x, [0, 2, 3, 1])
+                lv1 = bb.emit_te(topi.exp, lv0)
+                lv2 = bb.emit_te(topi.transpose, lv1, [0, 3, 1, 2])
+                # the next op wants NHWC again, which cancels with the previous transpose
+                lv3 = bb.emit_te(topi.transpose, lv2, [0, 2, 3, 1])
+                gv = bb.emit_output(bb.call_te(topi.negative, lv3))
+            bb.emit_func_output(gv)
+        return bb.get()
+
+    def expected():
+        bb = relax.BlockBuilder()
+        x = relax.Var("x", [1, 3, 8, 8], relax.DynTensorType(4, "float32"))
+        with bb.function("main", [x]):
+            with bb.dataflow():
+                lv0 = bb.emit_te(topi.transpose, x, [0, 2, 3, 1])
+                lv1 = bb.emit_te(topi.exp, lv0)
+                lv3 = bb.emit(lv1)
+                gv = bb.emit_output(bb.call_te(topi.negative, lv3))
+            bb.emit_func_output(gv)
+        return bb.get()
+
+    after = relax.transform.ElideLayoutTransforms()(before())
+    tvm.ir.assert_structural_equal(after["main"], expected()["main"])
+
+
+def test_keep_non_inverse_transposes():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [2, 3, 4], relax.DynTensorType(3, "float32"))
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            lv0 = bb.emit_te(topi.transpose, x, [1, 2, 0])
+            gv = bb.emit_output(bb.call_te(topi.transpose, lv0, [1, 2, 0]))
+        bb.emit_func_output(gv)
+    mod = bb.get()
+    after = relax.transform.ElideLayoutTransforms()(mod)
+    tvm.ir.assert_structural_equal(after, mod)
+
+
+if __name__ == "__main__":
+    sys.exit(pytest.main([__file__] + sys.argv[1:]))
@@ -182,7 +182,8 @@ def test_dataflow_fold():
     tvm.ir.assert_structural_equal(after, expected)
 
 
-def test_fold_mixed_case():
+@pytest.mark.parametrize("batch_build", [True, False])
+def test_fold_mixed_case(batch_build):
     @tvm.script.ir_module
     class Module:
         # TIR function can handle different cases.
@@ -245,7 +246,9 @@ def test_fold_mixed_case():
 
     before = gen_mod(Module, "before", {"c0": c0_np})
     expected = gen_mod(Module, "expected", {"c0": c0_np, "c1": c1_np, "c2": c2_np})
-    after = relax.transform.FoldConstant()(before)
+    # addone and sub are built in a single module in batch mode
+    with tvm.transform.PassContext(config={"relax.FoldConstant.batch_build": batch_build}):
+        after = relax.transform.FoldConstant()(before)
     tvm.ir.assert_structural_equal(after, expected)
 
 
@@ -773,5 +773,62 @@ def test_softmax():
     _check(before(), expected())
 
 
+def test_fuse_multiple_functions():
+    """Every Relax function gets fused, and identical groups share one grouped function."""
+
+    def before():
+        bb = relax.BlockBuilder()
+        for name in ["prefill", "decode"]:
+            x = relax.Var("x", [10, 20], relax.DynTensorType(2, "float32"))
+            with bb.function(name, [x]):
+                with bb.dataflow():
+                    lv0 = bb.emit_te(topi.exp, x)
+                    gv = bb.emit_output(bb.call_te(topi.squeeze, lv0))
+                bb.emit_func_output(gv)
+        return bb.get()
+
+    def expected():
+        bb = relax.BlockBuilder()
+        x = relax.Var("x", [10, 20], relax.DynTensorType(2, "float32"))
+        with bb.function("fused_exp_squeeze", [x], attrs={"Primitive": 1}):
+            with bb.dataflow():
+                lv0 = bb.emit_te(topi.exp, x)
+                gv = bb.emit_output(bb.call_te(topi.squeeze, lv0))
+            bb.emit_func_output(gv)
+        fused_exp_squeeze = bb.get().get_global_var("fused_exp_squeeze")
+
+        for name in ["prefill", "decode"]:
+            x = relax.Var("x", [10, 20], relax.DynTensorType(2, "float32"))
+            with bb.function(name, [x]):
+                with bb.dataflow():
+                    gv = bb.emit_output(relax.Call(fused_exp_squeeze, [x]))
+                bb.emit_func_output(gv)
+        return bb.get()
+
+    _check(before(), expected())
+
+
+def test_fuse_check_group():
+    """The groups rejected by the check stay unfused."""
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [10, 20], relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            lv0 = bb.emit_te(topi.exp, x)
+            gv = bb.emit_output(bb.call_te(topi.squeeze, lv0))
+        bb.emit_func_output(gv)
+    mod = relax.transform.AnnotateTIROpPattern()(bb.get())
+
+    checked = []
+
+    def fcheck_group(func, _mod):
+        checked.append(func.attrs["global_symbol"])
+        return False
+
+    after = relax.transform.FuseOps(fcheck_group=fcheck_group)(mod)
+    assert checked == ["fused_exp_squeeze"]
+    tvm.ir.assert_structural_equal(after, mod)
+
+
 if __name__ == "__main__":
     sys.exit(pytest.main([__file__] + sys.argv[1:]))
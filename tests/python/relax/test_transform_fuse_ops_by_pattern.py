@@ -0,0 +1,93 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import pytest
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.relax.dpl import is_op, wildcard
+
+
+def get_module():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [16, 16], relax.DynTensorType(2, "float32"))
+    y = relax.Var("y", [16, 16], relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x, y]):
+        with bb.dataflow():
+            lv0 = bb.emit(relax.op.multiply(x, y))
+            lv1 = bb.emit(relax.op.add(lv0, y))
+            lv2 = bb.emit(relax.op.multiply(lv1, lv1))
+            gv = bb.emit_output(relax.op.add(lv2, x))
+        bb.emit_func_output(gv)
+    return bb.get()
+
+
+multiply_add = is_op("relax.add")(is_op("relax.multiply")(wildcard(), wildcard()), wildcard())
+
+
+def test_fuse_by_pattern():
+    mod = relax.transform.FuseOpsByPattern([("tensorrt.multiply_add", multiply_add)])(get_module())
+    assert relax.analysis.well_formed(mod)
+
+    bindings = mod["main"].body.blocks[0].bindings
+    assert len(bindings) == 2
+    for binding in bindings:
+        gv = binding.value.op
+        assert isinstance(gv, relax.GlobalVar)
+        func = mod[gv]
+        assert func.attrs["Codegen"] == "tensorrt"
+        assert func.attrs["global_symbol"] == gv.name_hint
+        composite = func.body.blocks[0].bindings[0].value.op
+        assert isinstance(composite, relax.Function)
+        assert composite.attrs["Composite"] == "tensorrt.multiply_add"
+        assert len(composite.body.blocks[0].bindings) == 2
+    # The second match takes in the output of the first one.
+    assert bindings[1].value.args[0].same_as(bindings[0].var)
+
+
+def test_fuse_by_pattern_check():
+    mod = get_module()
+    checked = []
+
+    def fcheck_group(func, _mod):
+        checked.append(func)
+        return False
+
+    new_mod = relax.transform.FuseOpsByPattern(
+        [("tensorrt.multiply_add", multiply_add)], fcheck_group
+    )(mod)
+    assert len(checked) == 2
+    tvm.ir.assert_structural_equal(new_mod, mod)
+
+
+def test_fuse_by_pattern_shared_producer():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [16, 16], relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            lv0 = bb.emit(relax.op.multiply(x, x))
+            lv1 = bb.emit(relax.op.add(lv0, x))
+            gv = bb.emit_output(relax.op.add(lv0, lv1))
+        bb.emit_func_output(gv)
+    mod = bb.get()
+
+    # lv0 is also used by gv, so grouping it with lv1 would duplicate it.
+    new_mod = relax.transform.FuseOpsByPattern([("tensorrt.multiply_add", multiply_add)])(mod)
+    tvm.ir.assert_structural_equal(new_mod, mod)
+
+
+if __name__ == "__main__":
+    pytest.main([__file__])
@@ -0,0 +1,136 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.relax.testing import transform
+
+
+def build_mlp():
+    x = relax.Var("x", [4, 8], relax.DynTensorType(2, "float32"))
+    w1 = relax.Var("w1", [8, 16], relax.DynTensorType(2, "float32"))
+    b1 = relax.Var("b1", [16], relax.DynTensorType(1, "float32"))
+    w2 = relax.Var("w2", [16, 4], relax.DynTensorType(2, "float32"))
+    bb = relax.BlockBuilder()
+    with bb.function("main", [x, w1, b1, w2]):
+        with bb.dataflow():
+            lv0 = bb.emit(relax.op.nn.matmul(x, w1))
+            lv1 = bb.emit(relax.op.add(lv0, b1))
+            lv2 = bb.emit(relax.op.nn.relu(lv1))
+            lv3 = bb.emit(relax.op.nn.matmul(lv2, w2))
+            lv4 = bb.emit(relax.op.multiply(lv3, lv3))
+            gv = bb.emit_output(relax.op.sum(lv4))
+        bb.emit_func_output(gv)
+    return bb.get(), (lv2, lv3)
+
+
+def test_plan_checkpoints():
+    mod, (lv2, lv3) = build_mlp()
+    func = mod["main"]
+    required = func.params[1:]
+    kept, recomputed = relax.transform.plan_checkpoints(func, required, None)
+    assert [v.same_as(u) for v, u in zip(kept, [lv2, lv3])] == [True, True]
+    assert not recomputed
+    # the relu output is the cheapest to recompute per byte
+    kept, recomputed = relax.transform.plan_checkpoints(func, required, 256)
+    assert len(kept) == 1 and kept[0].same_as(lv3)
+    assert len(recomputed) == 1 and recomputed[0].same_as(lv2)
+    kept, recomputed = relax.transform.plan_checkpoints(func, required, 0)
+    assert not kept and len(recomputed) == 2
+
+
+def test_gradient_unsupported_op():
+    x = relax.Var("x", [4, 8], relax.DynTensorType(2, "float32"))
+    bb = relax.BlockBuilder()
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            lv0 = bb.emit(relax.op.nn.softmax(x))
+            gv = bb.emit_output(relax.op.unique(lv0))
+        bb.emit_func_output(gv)
+    with pytest.raises(ValueError, match="no gradient"):
+        relax.transform.Gradient("main")(bb.get())
+
+
+def run_adjoint(mod, args):
+    target = tvm.target.Target("llvm")
+    mod = transform.LowerWithRelayOpStrategyPass(target)(mod)
+    vm = relax.VirtualMachine(relax.vm.build(mod, target), tvm.cpu())
+    return vm["main_adjoint"](*[tvm.nd.array(a) for a in args])
+
+
+@tvm.testing.requires_llvm
+@pytest.mark.parametrize("memory_budget", [None, 0])
+def test_gradient_mlp(memory_budget):
+    mod, _ = build_mlp()
+    mod = relax.transform.Gradient("main", ["w1", "b1", "w2"], memory_budget)(mod)
+    x, w1, b1, w2 = [
+        np.random.uniform(-1, 1, shape).astype("float32")
+        for shape in [(4, 8), (8, 16), (16,), (16, 4)]
+    ]
+    loss, grads = run_adjoint(mod, [x, w1, b1, w2])
+
+    z = x @ w1 + b1
+    h = np.maximum(z, 0)
+    y = h @ w2
+    dy = 2 * y
+    dz = (dy @ w2.T) * (z > 0)
+    tvm.testing.assert_allclose(loss.numpy(), np.sum(y * y), rtol=1e-5)
+    tvm.testing.assert_allclose(grads[0].numpy(), x.T @ dz, rtol=1e-4, atol=1e-5)
+    tvm.testing.assert_allclose(grads[1].numpy(), dz.sum(0), rtol=1e-4, atol=1e-5)
+    tvm.testing.assert_allclose(grads[2].numpy(), h.T @ dy, rtol=1e-4, atol=1e-5)
+
+
+def build_update(optimizer, shape):
+    w = relax.Var("w", shape, relax.DynTensorType(len(shape), "float32"))
+    mod = optimizer.add_update_function(tvm.IRModule(), [w])
+    target = tvm.target.Target("llvm")
+    return relax.VirtualMachine(relax.vm.build(mod, target), tvm.cpu())
+
+
+@tvm.testing.requires_llvm
+def test_sgd_momentum_update():
+    opt = relax.optimizer.SGD(0.1, momentum=0.9, weight_decay=0.01)
+    vm = build_update(opt, [8])
+    w, g = np.random.rand(8).astype("float32"), np.random.rand(8).astype("float32")
+    (v,) = opt.init_states([w])
+    v = v + 1
+    (new_w,), (new_v,) = vm["update"](*[tvm.nd.array(a) for a in [w, g, v]])
+    expected_v = 0.9 * v + g + 0.01 * w
+    tvm.testing.assert_allclose(new_v.numpy(), expected_v, rtol=1e-5)
+    tvm.testing.assert_allclose(new_w.numpy(), w - 0.1 * expected_v, rtol=1e-5)
+
+
+@tvm.testing.requires_llvm
+def test_adam_update():
+    opt = relax.optimizer.Adam(lr=0.01, weight_decay=0.1)
+    vm = build_update(opt, [4, 4])
+    w, g = np.random.rand(4, 4).astype("float32"), np.random.rand(4, 4).astype("float32")
+    states = opt.init_states([w])
+    (new_w,), (m, v, step) = vm["update"](*[tvm.nd.array(a) for a in [w, g] + states])
+    expected_m, expected_v = 0.1 * g, 0.001 * g * g
+    m_hat, v_hat = expected_m / 0.1, expected_v / 0.001
+    expected_w = w - 0.01 * (m_hat / (np.sqrt(v_hat) + 1e-8) + 0.1 * w)
+    assert step.numpy() == 1
+    tvm.testing.assert_allclose(m.numpy(), expected_m, rtol=1e-5)
+    tvm.testing.assert_allclose(v.numpy(), expected_v, rtol=1e-5)
+    tvm.testing.assert_allclose(new_w.numpy(), expected_w, rtol=1e-4)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,98 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+import tvm.testing
+from tvm import relax, te, tir, topi
+
+
+def _dequantize(w, scale):
+    return te.compute(w.shape, lambda i, j: w[i, j].astype("float32") * scale, name="dequantize")
+
+
+def _fused_module(emit_body):
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [16, 32], relax.DynTensorType(2, "float32"))
+    w = relax.Var("w", [32, 8], relax.DynTensorType(2, "int8"))
+    with bb.function("fused", [x, w], attrs={"Primitive": True}):
+        with bb.dataflow():
+            gv = bb.emit_output(emit_body(bb, x, w))
+        bb.emit_func_output(gv)
+    fused = bb.get().get_global_var("fused")
+
+    x = relax.Var("x", [16, 32], relax.DynTensorType(2, "float32"))
+    w = relax.Var("w", [32, 8], relax.DynTensorType(2, "int8"))
+    with bb.function("main", [x, w]):
+        with bb.dataflow():
+            gv = bb.emit_output(relax.Call(fused, [x, w]))
+        bb.emit_func_output(gv)
+    return relax.transform.FuseTIR()(bb.get())
+
+
+def _fused_prim_func(mod):
+    funcs = [func for func in mod.functions.values() if isinstance(func, tir.PrimFunc)]
+    assert len(funcs) == 1
+    return funcs[0]
+
+
+def _block_names(func):
+    names = []
+
+    def fvisit(node):
+        if isinstance(node, tir.Block) and node.name_hint != "root":
+            names.append(node.name_hint)
+
+    tir.stmt_functor.post_order_visit(func.body, fvisit)
+    return names
+
+
+def test_inline_prologue_and_epilogue():
+    def emit_body(bb, x, w):
+        lv0 = bb.emit_te(_dequantize, w, 0.5)
+        lv1 = bb.emit_te(topi.nn.matmul, x, lv0)
+        lv2 = bb.emit_te(topi.add, lv1, 1.0)
+        return bb.call_te(topi.nn.relu, lv2)
+
+    before = _fused_prim_func(_fused_module(emit_body))
+    assert len(before.body.block.alloc_buffers) == 3
+    after = _fused_prim_func(relax.transform.InlineFusedIntermediates()(_fused_module(emit_body)))
+    # The dequantize and the add are inlined, only the output of the matmul is materialized
+    assert len(after.body.block.alloc_buffers) == 1
+    assert len(_block_names(after)) == 2
+    assert not any(name.startswith("dequantize") for name in _block_names(after))
+
+
+def test_keep_producer_of_several_consumers():
+    def emit_body(bb, x, w):
+        lv0 = bb.emit_te(_dequantize, w, 0.5)
+        lv1 = bb.emit_te(topi.nn.matmul, x, lv0)
+        lv2 = bb.emit_te(topi.nn.matmul, x, lv0)
+        return bb.call_te(topi.add, lv1, lv2)
+
+    after = _fused_prim_func(relax.transform.InlineFusedIntermediates()(_fused_module(emit_body)))
+    assert any(name.startswith("dequantize") for name in _block_names(after))
+
+
+def test_no_intermediate():
+    def emit_body(bb, x, w):  # pylint: disable=unused-argument
+        return bb.call_te(topi.nn.relu, x)
+
+    mod = _fused_module(emit_body)
+    tvm.ir.assert_structural_equal(relax.transform.InlineFusedIntermediates()(mod), mod)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,100 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+import tvm
+import tvm.testing
+from tvm import relax, tir
+from tvm.relax.transform import LegalizeReductions
+
+
+def build(op, *arg_shapes):
+    n = tir.Var("n", "int64")
+    shapes = [[n if d == "n" else d for d in shape] for shape in arg_shapes]
+    args = [
+        relax.Var("x%d" % i, shape, relax.DynTensorType(len(shape), "float32"))
+        for i, shape in enumerate(shapes)
+    ]
+    bb = relax.BlockBuilder()
+    with bb.function("main", args):
+        with bb.dataflow():
+            gv = bb.emit_output(op(*args))
+        bb.emit_func_output(gv)
+    return bb.get(), gv
+
+
+def softmax_ref(x):
+    e = np.exp(x - x.max(axis=1, keepdims=True))
+    return e / e.sum(axis=1, keepdims=True)
+
+
+def layer_norm_ref(x, gamma, beta):
+    mean = x.mean(axis=-1, keepdims=True)
+    var = x.var(axis=-1, keepdims=True)
+    return (x - mean) / np.sqrt(var + 1e-5) * gamma + beta
+
+
+def rms_norm_ref(x, weight):
+    return x / np.sqrt((x * x).mean(axis=-1, keepdims=True) + 1e-5) * weight
+
+
+CASES = {
+    "softmax": (lambda x: relax.op.nn.softmax(x, axis=1), [("n", 7, 16)], softmax_ref),
+    "layer_norm": (relax.op.nn.layer_norm, [("n", 64), (64,), (64,)], layer_norm_ref),
+    "rms_norm": (relax.op.nn.rms_norm, [("n", 64), (64,)], rms_norm_ref),
+    "sum": (
+        lambda x: relax.op.sum(x, axis=[0, 2], keepdims=True),
+        [(3, "n", 16)],
+        lambda x: x.sum(axis=(0, 2), keepdims=True),
+    ),
+}
+
+
+def test_infer_shape():
+    _, out = build(*CASES["sum"][:2])
+    assert [str(d) for d in out.shape] == ["1", "n", "1"]
+    _, out = build(lambda x: relax.op.sum(x, axis=1, exclude=True), (3, "n", 16))
+    assert [str(d) for d in out.shape] == ["n"]
+    with pytest.raises(tvm.TVMError):
+        build(relax.op.nn.rms_norm, ("n", 64), (32,))
+
+
+@pytest.mark.parametrize("name", list(CASES))
+def test_gpu_schedule(name):
+    mod, _ = build(*CASES[name][:2])
+    mod = LegalizeReductions(tvm.target.Target("cuda"))(mod)
+    funcs = [f for f in mod.functions.values() if isinstance(f, tir.PrimFunc)]
+    assert len(funcs) == 1
+    script = funcs[0].script()
+    assert "blockIdx.x" in script and "threadIdx.x" in script
+
+
+@tvm.testing.requires_llvm
+@pytest.mark.parametrize("name", list(CASES))
+def test_legalize_cpu(name):
+    op, shapes, ref = CASES[name]
+    mod, _ = build(op, *shapes)
+    target = tvm.target.Target("llvm")
+    mod = LegalizeReductions(target)(mod)
+    vm = relax.VirtualMachine(relax.vm.build(mod, target), tvm.cpu())
+    inputs = [np.random.rand(*[5 if d == "n" else d for d in s]).astype("float32") for s in shapes]
+    out = vm["main"](*[tvm.nd.array(x) for x in inputs])
+    tvm.testing.assert_allclose(out.numpy(), ref(*inputs), rtol=1e-5, atol=1e-5)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,87 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relax, tir, topi
+
+
+def _fused_module():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [64, 128], relax.DynTensorType(2, "float32"))
+    with bb.function("fused_max_subtract_exp", [x], attrs={"Primitive": True}):
+        with bb.dataflow():
+            lv0 = bb.emit_te(topi.max, x, axis=1, keepdims=True)
+            lv1 = bb.emit_te(topi.subtract, x, lv0)
+            gv = bb.emit_output(bb.call_te(topi.exp, lv1))
+        bb.emit_func_output(gv)
+    fused = bb.get().get_global_var("fused_max_subtract_exp")
+
+    x = relax.Var("x", [64, 128], relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            gv = bb.emit_output(relax.Call(fused, [x]))
+        bb.emit_func_output(gv)
+    return relax.transform.FuseTIR()(bb.get())
+
+
+def _prim_func(mod):
+    funcs = [func for func in mod.functions.values() if isinstance(func, tir.PrimFunc)]
+    assert len(funcs) == 1
+    return funcs[0]
+
+
+def _allocated_sizes(func):
+    mod = tvm.IRModule({"main": func})
+    mod = tvm.tir.transform.PlanAndUpdateBufferAllocationLocation()(mod)
+    mod = tvm.tir.transform.CompactBufferAllocation()(mod)
+    sizes = []
+
+    def fvisit(node):
+        if isinstance(node, tir.Block):
+            for buffer in node.alloc_buffers:
+                sizes.append(int(np.prod([int(dim) for dim in buffer.shape])))
+
+    tir.stmt_functor.post_order_visit(mod["main"].body, fvisit)
+    return sorted(sizes)
+
+
+def test_localize_row_reduction():
+    before = _prim_func(_fused_module())
+    after = _prim_func(relax.transform.LocalizeFusedIntermediates()(_fused_module()))
+    assert _allocated_sizes(before) == [64, 64 * 128]
+    # The max of a row is computed under the row loop, the subtract under the element loop
+    assert _allocated_sizes(after) == [1, 1]
+
+
+@tvm.testing.requires_llvm
+def test_localize_numerics():
+    x_np = np.random.rand(64, 128).astype("float32")
+    results = []
+    for mod in [_fused_module(), relax.transform.LocalizeFusedIntermediates()(_fused_module())]:
+        func = _prim_func(mod).with_attr("global_symbol", "main")
+        f = tvm.build(func, target="llvm")
+        out = tvm.nd.empty((64, 128), "float32")
+        f(tvm.nd.array(x_np), out)
+        results.append(out.numpy())
+    tvm.testing.assert_allclose(results[0], results[1], rtol=1e-6)
+    tvm.testing.assert_allclose(results[1], np.exp(x_np - x_np.max(axis=1, keepdims=True)))
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,80 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.relax.dpl import is_op, wildcard
+
+
+multiply_add = is_op("relax.add")(is_op("relax.multiply")(wildcard(), wildcard()), wildcard())
+
+
+def fuse_and_merge(mod):
+    mod = relax.transform.FuseOpsByPattern([("tensorrt.multiply_add", multiply_add)])(mod)
+    return relax.transform.MergeCompositeFunctions()(mod)
+
+
+def test_merge_chain():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [16, 16], relax.DynTensorType(2, "float32"))
+    y = relax.Var("y", [16, 16], relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x, y]):
+        with bb.dataflow():
+            lv0 = bb.emit(relax.op.multiply(x, y))
+            lv1 = bb.emit(relax.op.add(lv0, y))
+            lv2 = bb.emit(relax.op.multiply(lv1, lv1))
+            gv = bb.emit_output(relax.op.add(lv2, x))
+        bb.emit_func_output(gv)
+    mod = fuse_and_merge(bb.get())
+    assert relax.analysis.well_formed(mod)
+
+    bindings = mod["main"].body.blocks[0].bindings
+    assert len(bindings) == 1
+    gv = bindings[0].value.op
+    func = mod[gv]
+    assert func.attrs["Codegen"] == "tensorrt"
+    assert func.attrs["global_symbol"] == gv.name_hint
+    assert len(func.params) == 2
+    inner = func.body.blocks[0].bindings
+    assert len(inner) == 2
+    for binding in inner:
+        assert binding.value.op.attrs["Composite"] == "tensorrt.multiply_add"
+    # The second composite function takes in the output of the first one.
+    assert inner[1].value.args[0].same_as(inner[0].var)
+    # The functions of the merged calls are removed.
+    assert len([gv for gv in mod.get_global_vars() if gv.name_hint != "main"]) == 1
+
+
+def test_merge_escaping_intermediate():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [16, 16], relax.DynTensorType(2, "float32"))
+    y = relax.Var("y", [16, 16], relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x, y]):
+        with bb.dataflow():
+            lv0 = bb.emit(relax.op.multiply(x, y))
+            lv1 = bb.emit(relax.op.add(lv0, y))
+            lv2 = bb.emit(relax.op.multiply(lv1, y))
+            lv3 = bb.emit(relax.op.add(lv2, x))
+            gv = bb.emit_output(relax.op.add(lv3, lv1))
+        bb.emit_func_output(gv)
+    mod = relax.transform.FuseOpsByPattern([("tensorrt.multiply_add", multiply_add)])(bb.get())
+    # lv1 is also used outside of the chain, so the calls are kept apart.
+    tvm.ir.assert_structural_equal(relax.transform.MergeCompositeFunctions()(mod), mod)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -113,5 +113,37 @@ def test_ms_tuning_primfunc():
             assert not tvm.ir.structural_equal(mod, out_mod)
 
 
+def test_ms_apply_database_fallback():
+    mod = InputModule
+    with tempfile.TemporaryDirectory() as work_dir:
+        with target, transform.PassContext(opt_level=0):
+            application_pass = relax.transform.MetaScheduleApplyDatabase(
+                work_dir, enable_fallback=False
+            )
+            tvm.ir.assert_structural_equal(mod, application_pass(mod))
+            # Without any record, the kernels still get a default schedule of the target
+            out_mod = relax.transform.MetaScheduleApplyDatabase(work_dir)(mod)
+            for gv in ["tir_matmul", "tir_relu"]:
+                assert not tvm.ir.structural_equal(mod[gv], out_mod[gv])
+
+
+def test_ms_tuning_native():
+    mod = InputModule
+    with tempfile.TemporaryDirectory() as work_dir:
+        with target, transform.PassContext(opt_level=0):
+            tuning_pass = relax.transform.MetaScheduleTune(
+                work_dir=work_dir,
+                max_trials_global=4,
+                builder=ms.builder.LocalBuilder(),
+                runner=ms.runner.LocalRunner(),
+                num_trials_per_iter=2,
+            )
+            out_mod = tuning_pass(mod)
+            assert not tvm.ir.structural_equal(mod, out_mod)
+            # The records are kept in the work directory, as with `MetaScheduleTuneIRMod`.
+            application_pass = relax.transform.MetaScheduleApplyDatabase(work_dir)
+            tvm.ir.assert_structural_equal(application_pass(mod), out_mod)
+
+
 if __name__ == "__main__":
     pytest.main([__file__])
@@ -0,0 +1,78 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import tvm
+import tvm.testing
+from tvm import relax, topi
+
+
+def build_two_kernels():
+    x = relax.Var("x", [4, 4], relax.DynTensorType(2, "float32"))
+    w0 = relax.Var("w0", [4, 4], relax.DynTensorType(2, "float32"))
+    w1 = relax.Var("w1", [4, 4], relax.DynTensorType(2, "float32"))
+    bb = relax.BlockBuilder()
+    with bb.function("main", [x, w0, w1]):
+        with bb.dataflow():
+            lv0 = bb.emit_te(topi.add, x, w0)
+            lv1 = bb.emit_te(topi.multiply, lv0, w1)
+            gv = bb.emit_output(lv1)
+        bb.emit_func_output(gv)
+    return bb.get()
+
+
+def op_names(func):
+    names = []
+    for binding in func.body.blocks[0].bindings:
+        value = binding.value
+        if isinstance(value, relax.Call) and isinstance(value.op, tvm.ir.Op):
+            names.append(value.op.name)
+    return names
+
+
+def test_prefetch_next_kernel_weights():
+    mod = relax.transform.PrefetchWeights(weight_params=["w0", "w1"])(build_two_kernels())
+    func = mod["main"]
+    # w0 is read by the first kernel, which has no previous kernel to overlap with
+    assert op_names(func) == [
+        "relax.prefetch",
+        "relax.call_tir",
+        "relax.prefetch_wait",
+        "relax.call_tir",
+    ]
+    bindings = func.body.blocks[0].bindings
+    assert bindings[0].value.args[0].same_as(func.params[2])
+    assert bindings[0].value.attrs.scope == "global.vtcm"
+    assert bindings[3].value.args[1].fields[1].same_as(bindings[2].var)
+
+
+def test_prefetch_max_bytes():
+    mod = relax.transform.PrefetchWeights(weight_params=["w1"], max_bytes=32)(build_two_kernels())
+    assert "relax.prefetch" not in op_names(mod["main"])
+
+
+@tvm.testing.requires_llvm
+def test_prefetch_vm_global_scope():
+    # without a DMA engine, the prefetch is a synchronous copy
+    mod = relax.transform.PrefetchWeights("global", ["w1"])(build_two_kernels())
+    vm = relax.VirtualMachine(relax.vm.build(mod, "llvm"), tvm.cpu())
+    x, w0, w1 = [np.random.rand(4, 4).astype("float32") for _ in range(3)]
+    out = vm["main"](tvm.nd.array(x), tvm.nd.array(w0), tvm.nd.array(w1))
+    tvm.testing.assert_allclose(out.numpy(), (x + w0) * w1, rtol=1e-6)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
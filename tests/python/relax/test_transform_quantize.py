@@ -0,0 +1,126 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import tvm
+import tvm.testing
+from tvm import relax, topi
+
+
+def _num_call_tir(func, name):
+    calls = []
+
+    def fvisit(e):
+        if isinstance(e, relax.Call) and e.op == tvm.ir.Op.get("relax.call_tir"):
+            if e.args[0].name_hint.startswith(name):
+                calls.append(e)
+
+    relax.analysis.post_order_visit(func.body, fvisit)
+    return len(calls)
+
+
+def _quantize_attrs(func):
+    attrs = []
+
+    def fvisit(e):
+        if isinstance(e, relax.Call) and e.op.name in ["relax.quantize", "relax.dequantize"]:
+            attrs.append(e.attrs)
+
+    relax.analysis.post_order_visit(func.body, fvisit)
+    return attrs
+
+
+def _qdq_dense():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [4, 16], relax.DynTensorType(2, "float32"))
+    w = relax.Var("w", [8, 16], relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x, w]):
+        with bb.dataflow():
+            qx = bb.emit(relax.op.quantize(x))
+            qw = bb.emit(relax.op.quantize(w))
+            dx = bb.emit(relax.op.dequantize(qx))
+            dw = bb.emit(relax.op.dequantize(qw))
+            y = bb.emit_te(topi.nn.dense, dx, dw)
+            qy = bb.emit(relax.op.quantize(y))
+            gv = bb.emit_output(relax.op.dequantize(qy))
+        bb.emit_func_output(gv)
+    return bb.get()
+
+
+def _run(mod, inputs):
+    vm = relax.VirtualMachine(relax.vm.build(mod, "llvm"), tvm.cpu())
+    return vm["main"](*inputs).numpy()
+
+
+def test_quantize_dequantize():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [8], relax.DynTensorType(1, "float32"))
+    with bb.function("main", [x]):
+        q = bb.emit(relax.op.quantize(x, scale=0.5, zero_point=3, out_dtype="int8"))
+        gv = bb.emit(relax.op.dequantize(q, scale=0.5, zero_point=3))
+        bb.emit_func_output(relax.Tuple([q, gv]))
+    data = np.array([-100, -2, -0.6, 0, 0.3, 1, 2.2, 100], "float32")
+    vm = relax.VirtualMachine(relax.vm.build(bb.get(), "llvm"), tvm.cpu())
+    q, dq = vm["main"](tvm.nd.array(data))
+    expected = np.clip(np.round(data / 0.5) + 3, -128, 127)
+    np.testing.assert_array_equal(q.numpy(), expected.astype("int8"))
+    np.testing.assert_allclose(dq.numpy(), (expected - 3) * 0.5)
+
+
+def test_calibrate():
+    mod = _qdq_dense()
+    dataset = [
+        [np.random.uniform(-1, 1, shape).astype("float32") for shape in [(4, 16), (8, 16)]]
+        for _ in range(4)
+    ]
+    after = relax.transform.Calibrate(dataset)(mod)
+    attrs = _quantize_attrs(after["main"])
+    assert len(attrs) == 6
+    assert all(attr.scale > 0 for attr in attrs)
+    # Each dequantize takes the parameters of the quantize producing its input.
+    qx, qw, dx, dw, qy, dy = attrs
+    for q, dq in [(qx, dx), (qw, dw), (qy, dy)]:
+        assert q.scale == dq.scale and q.zero_point == dq.zero_point
+
+    # The calibrated ranges cover the sample inputs.
+    low = min(float(sample[0].min()) for sample in dataset)
+    assert abs(qx.scale * (-128 - qx.zero_point) - min(low, 0.0)) < qx.scale
+
+
+def test_fold_qdq():
+    mod = _qdq_dense()
+    mod = relax.transform.BindQuantizeParams([0.01, 0.01, 0.05], [0, 0, 0])(mod)
+    after = relax.transform.FoldQDQ()(mod)
+    assert _num_call_tir(after["main"], "dense") == 0
+    assert _num_call_tir(after["main"], "quantized_matmul") == 1
+    assert len(_quantize_attrs(after["main"])) == 3
+
+    inputs = [
+        tvm.nd.array(np.random.uniform(-1, 1, shape).astype("float32"))
+        for shape in [(4, 16), (8, 16)]
+    ]
+    # The folded matmul may round differently only at the halfway points.
+    tvm.testing.assert_allclose(_run(after, inputs), _run(mod, inputs), atol=0.05 + 1e-5)
+
+
+def test_keep_uncalibrated_qdq():
+    mod = _qdq_dense()
+    after = relax.transform.FoldQDQ()(mod)
+    tvm.ir.assert_structural_equal(after, mod)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,101 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.relax.expr_functor import PyExprVisitor, visitor
+from tvm.relax.testing import transform
+
+
+def build_mlp(column_only=False):
+    x = relax.Var("x", [4, 16], relax.DynTensorType(2, "float32"))
+    w1 = relax.Var("w1", [16, 32], relax.DynTensorType(2, "float32"))
+    w2 = relax.Var("w2", [32, 16], relax.DynTensorType(2, "float32"))
+    bb = relax.BlockBuilder()
+    with bb.function("main", [x, w1, w2]):
+        with bb.dataflow():
+            lv0 = bb.emit(relax.op.nn.matmul(x, w1))
+            lv1 = bb.emit(relax.op.nn.relu(lv0))
+            out = lv1 if column_only else bb.emit(relax.op.nn.matmul(lv1, w2))
+            gv = bb.emit_output(out)
+        bb.emit_func_output(gv)
+    return bb.get()
+
+
+def count_ops(func):
+    counts = {}
+
+    @visitor
+    class Counter(PyExprVisitor):
+        def visit_call_(self, call):
+            if isinstance(call.op, tvm.ir.Op):
+                counts[call.op.name] = counts.get(call.op.name, 0) + 1
+            super().visit_call_(call)
+
+    Counter().visit_expr(func)
+    return counts
+
+
+def test_shard_mlp_column_then_row():
+    sharding = {"w1": 1, "w2": 0}
+    mod = relax.transform.ShardTensorParallel("main", 2, sharding)(build_mlp())
+    func = mod["main"]
+    assert [list(p.shape) for p in func.params] == [[4, 16], [16, 16], [16, 16]]
+    counts = count_ops(func)
+    assert counts.get("relax.ccl.allreduce") == 1
+    assert "relax.ccl.allgather" not in counts
+    assert "relax.ccl.local_shard" not in counts
+
+
+def test_shard_column_only_gathers():
+    mod = relax.transform.ShardTensorParallel("main", 2, {"w1": 1})(build_mlp(column_only=True))
+    counts = count_ops(mod["main"])
+    assert counts.get("relax.ccl.allgather") == 1
+    assert "relax.ccl.allreduce" not in counts
+
+
+def test_shard_params():
+    w = np.arange(32, dtype="float32").reshape(4, 8)
+    shards = relax.transform.shard_params({"w": w, "b": w}, 2, {"w": 1})
+    np.testing.assert_equal(shards[1]["w"], w[:, 4:])
+    np.testing.assert_equal(shards[1]["b"], w)
+
+
+@tvm.testing.requires_llvm
+def test_tensor_parallel_cpu():
+    sharding = {"w1": 1, "w2": 0}
+    mod = relax.transform.ShardTensorParallel("main", 2, sharding)(build_mlp())
+    target = tvm.target.Target("llvm")
+    mod = transform.LowerWithRelayOpStrategyPass(target)(mod)
+    tp_vm = relax.tensor_parallel.TensorParallelVM(
+        relax.vm.build(mod, target), [tvm.cpu(), tvm.cpu()]
+    )
+
+    x = np.random.rand(4, 16).astype("float32")
+    params = {
+        "w1": np.random.rand(16, 32).astype("float32"),
+        "w2": np.random.rand(32, 16).astype("float32"),
+    }
+    outputs = tp_vm.run("main", [x], tp_vm.shard_args(params, ["w1", "w2"], sharding))
+    expected = np.maximum(x @ params["w1"], 0) @ params["w2"]
+    for out in outputs:
+        tvm.testing.assert_allclose(out.numpy(), expected, rtol=1e-5)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
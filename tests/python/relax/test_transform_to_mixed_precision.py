@@ -0,0 +1,102 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import tvm
+import tvm.testing
+from tvm import relax, topi
+
+
+def _callees(func):
+    names = []
+
+    def fvisit(e):
+        if isinstance(e, relax.Call) and e.op == tvm.ir.Op.get("relax.call_tir"):
+            name = e.args[0].name_hint
+            names.append("cast" if name.startswith("cast") else name)
+
+    relax.analysis.post_order_visit(func.body, fvisit)
+    return names
+
+
+def _dense_exp_sum(w_value=None):
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [4, 16], relax.DynTensorType(2, "float32"))
+    params = [x]
+    if w_value is None:
+        w = relax.Var("w", [8, 16], relax.DynTensorType(2, "float32"))
+        params.append(w)
+    else:
+        w = relax.const(w_value)
+    with bb.function("main", params):
+        with bb.dataflow():
+            lv0 = bb.emit_te(topi.nn.dense, x, w)
+            lv1 = bb.emit_te(topi.exp, lv0)
+            lv2 = bb.emit_te(topi.sum, lv1, axis=1)
+            gv = bb.emit_output(lv2)
+        bb.emit_func_output(gv)
+    return bb.get()
+
+
+def test_convert_dense_and_follow():
+    mod = _dense_exp_sum()
+    after = relax.transform.ToMixedPrecision()(mod)
+    # x and w are cast down, dense and exp run in float16 and exp is cast back for sum.
+    assert sorted(_callees(after["main"])) == sorted(
+        ["cast", "cast", "dense_float16", "exp_float16", "cast", "sum"]
+    )
+    assert after["dense_float16"].buffer_map[after["dense_float16"].params[0]].dtype == "float16"
+    assert after["main"].ret_type.dtype == "float32"
+
+    inputs = [
+        tvm.nd.array(np.random.uniform(-0.2, 0.2, shape).astype("float32"))
+        for shape in [(4, 16), (8, 16)]
+    ]
+    results = []
+    for m in [mod, after]:
+        vm = relax.VirtualMachine(relax.vm.build(m, "llvm"), tvm.cpu())
+        results.append(vm["main"](*inputs).numpy())
+    tvm.testing.assert_allclose(results[1], results[0], rtol=1e-2, atol=1e-2)
+
+
+def test_keep_reduction_only():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [4, 16], relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            lv0 = bb.emit_te(topi.exp, x)
+            lv1 = bb.emit_te(topi.sum, lv0, axis=1)
+            gv = bb.emit_output(lv1)
+        bb.emit_func_output(gv)
+    mod = bb.get()
+    # exp has no converted input to follow.
+    after = relax.transform.ToMixedPrecision()(mod)
+    tvm.ir.assert_structural_equal(after, mod)
+
+
+def test_fold_weight_cast():
+    w = np.random.uniform(-0.2, 0.2, (8, 16)).astype("float32")
+    mod = _dense_exp_sum(w)
+    after = relax.transform.ToMixedPrecision()(mod)
+    after = relax.transform.FoldConstant()(after)
+    # Only the casts of x and of the output of exp are left.
+    assert sorted(_callees(after["main"])) == sorted(
+        ["cast", "dense_float16", "exp_float16", "cast", "sum"]
+    )
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
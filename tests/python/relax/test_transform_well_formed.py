@@ -116,6 +116,32 @@ def test_global_var():
     assert not rx.analysis.well_formed(mod)
 
 
+def test_well_formed_cache():
+    def build_caller(callee):
+        gv0 = rx.Var("gv0", [m, n], type_anno)
+        call_node = rx.Call(
+            op=tvm.ir.Op.get("relax.call_tir"),
+            args=[callee, rx.Tuple([x]), rx.ShapeExpr([m, n])],
+        )
+        return build_function([rx.BindingBlock([rx.VarBinding(gv0, call_node)])])
+
+    gv0 = rx.Var("gv0", [m, n], type_anno)
+    callee = build_function([rx.BindingBlock([rx.VarBinding(gv0, rx.op.add(x, x))])])
+    callee_gv = rx.GlobalVar("callee")
+    caller_gv = rx.GlobalVar("caller")
+    caller = build_caller(callee_gv)
+    cache = rx.analysis.WellFormedCache()
+    assert rx.analysis.well_formed(tvm.IRModule({caller_gv: caller, callee_gv: callee}), cache)
+    assert rx.analysis.well_formed(tvm.IRModule({caller_gv: caller, callee_gv: callee}), cache)
+    # The cached caller refers to a GlobalVar that is no longer defined.
+    assert not rx.analysis.well_formed(tvm.IRModule({caller_gv: caller}), cache)
+    # A changed function is checked again.
+    malformed = build_caller(rx.GlobalVar("undefined"))
+    assert not rx.analysis.well_formed(
+        tvm.IRModule({caller_gv: malformed, callee_gv: callee}), cache
+    )
+    assert rx.analysis.well_formed(tvm.IRModule({caller_gv: caller, callee_gv: callee}), cache)
+
 def test_symbolic_var():
     # Error: Symbolic Var new_s is not defined
     new_s = tir.Var("new_s", "int32")
@@ -30,6 +30,7 @@ from tvm.ir.transform import PassContext
 from tvm.ir.module import IRModule
 from tvm.script import tir as T, relax as R
 from tvm import relax
+from tvm.meta_schedule.builder import BuilderResult
 from tvm.relax.expr import Expr, DataflowBlock, Function
 from tvm.relax.transform.tuning_api import (
     Choice,
@@ -328,11 +329,13 @@ def test_trace_wrapper():
     assert isinstance(get_trace(mod["addone"]), Trace)
 
 
-def create_tmp_database(tmpdir: str) -> JSONDatabase:
+def create_tmp_database(tmpdir: str, concurrent: bool = False) -> JSONDatabase:
     path_workload = osp.join(tmpdir, "workloads.json")
     path_tuning_record = osp.join(tmpdir, "tuning_records.json")
     path_measurement_record = osp.join(tmpdir, "measurement_records.json")
-    return JSONDatabase(path_workload, path_tuning_record, path_measurement_record)
+    return JSONDatabase(
+        path_workload, path_tuning_record, path_measurement_record, concurrent=concurrent
+    )
 
 
 def test_database():
@@ -382,6 +385,31 @@ def test_database():
         assert len(new_tuning_records) == 0
 
 
+def test_database_concurrent():
+    mod1, mod2 = setup_test_const_folding()
+    knob = Knob("test", {"noapply": Choice()})
+    target = tvm.target.Target("llvm")
+    with tempfile.TemporaryDirectory() as tmpdir:
+        db_1 = create_tmp_database(tmpdir, concurrent=True)
+        db_2 = create_tmp_database(tmpdir, concurrent=True)
+        db_1.commit_measurement_record(db_1.commit_workload(mod1), target, [1.0])
+        # The workloads committed by either database keep a consistent index in the tables
+        workload2 = db_2.commit_workload(mod2)
+        db_2.commit_measurement_record(workload2, target, [2.0])
+        record = TuningRecord(Trace(mod2, [knob], ["noapply"]), [2.0])
+        db_2.commit_tuning_record(workload2, target, record)
+        # The measurement committed by the other process is not measured again
+        assert db_2.has_measurement_record(db_2.commit_workload(mod1), target)
+        for database in [db_1, db_2, create_tmp_database(tmpdir)]:
+            for mod, run_secs in [(mod1, [1.0]), (mod2, [2.0])]:
+                workload = database.commit_workload(mod)
+                measured = database.get_measurement_record(workload, target)
+                assert [float(x) for x in measured] == run_secs
+            assert len(database.get_top_k(database.commit_workload(mod2), target, top_k=5)) == 1
+        with open(osp.join(tmpdir, "workloads.json")) as f:
+            assert len(f.readlines()) == 2
+
+
 def test_default_functions():
     mod = setup_test()
     assert isinstance(mod, tvm.IRModule)
@@ -449,6 +477,121 @@ def test_default_functions():
 
 
 # TODO(sunggg): Do we need to serialize pass context as well?
+def test_default_evaluate_batch():
+    class MockBuilder:
+        """Builder that records the size of each batch and fails every build."""
+
+        def __init__(self):
+            self.batch_sizes = []
+
+        def build(self, build_inputs):
+            self.batch_sizes.append(len(build_inputs))
+            return [BuilderResult(None, "mock build error") for _ in build_inputs]
+
+    class MockRunner:
+        def run(self, runner_inputs):
+            raise AssertionError("Failed builds should never reach the runner")
+
+    mod = setup_test()
+    choices = {"apply": Choice("testing.apply_fold_constant"), "noapply": Choice()}
+    knob = Knob("TestKnob", choices)
+    trace = Trace(mod)
+    with tempfile.TemporaryDirectory() as tmpdir:
+        database = create_tmp_database(tmpdir)
+        with transform.PassContext(trace=trace, tuning_api_database=database):
+            candidates = default_generate_candidate([knob, knob], trace)
+            builder = MockBuilder()
+            default_evaluate(candidates, "llvm", builder=builder, runner=MockRunner())
+            # All the candidates are built in a single batch, where the candidates producing the
+            # same IRModule are only built once.
+            num_unique_mods = len({tvm.ir.structural_hash(c.out_mod) for c in candidates})
+            assert builder.batch_sizes == [num_unique_mods]
+            assert num_unique_mods < len(candidates)
+            assert all(c.perf == 1e100 for c in candidates)
+            assert PassContext.current().num_evals == len(candidates)
+
+
+@pytest.mark.parametrize("strategy", ["greedy", "evolutionary"])
+def test_search_strategies(strategy):
+    # Three knobs with three identical choices each, the best decisions are ("2", "0", "1").
+    knobs = [Knob(f"Knob{i}", {str(d): Choice() for d in range(3)}) for i in range(3)]
+    target_decisions = [2, 0, 1]
+
+    def mock_evaluate(candidates, target_str, params, builder, runner):
+        for candidate in candidates:
+            decisions = [int(d) for d in candidate.decisions]
+            candidate.set_perf(float(sum(abs(a - b) for a, b in zip(decisions, target_decisions))))
+        PassContext.current().inc_num_evals(len(candidates))
+
+    trace = Trace(setup_test())
+    with transform.PassContext(trace=trace):
+        if strategy == "greedy":
+            best = relax.transform.tuning_api.greedy_search(
+                knobs, trace, "llvm", f_evaluate=mock_evaluate
+            )
+        else:
+            best = relax.transform.tuning_api.evolutionary_search(
+                knobs,
+                trace,
+                "llvm",
+                population_size=6,
+                num_generations=8,
+                seed=0,
+                f_evaluate=mock_evaluate,
+            )
+        if strategy == "greedy":
+            # Coordinate descent is exact on a separable objective, with far fewer evaluations
+            # than the 27 combinations of the exhaustive enumeration
+            assert [str(d) for d in best.decisions] == ["2", "0", "1"]
+            assert PassContext.current().num_evals < 27
+        else:
+            assert best.perf <= 1.0
+            assert PassContext.current().num_evals <= 27
+
+    # The budget bounds the number of evaluations
+    with transform.PassContext(trace=trace, num_evals=0):
+        relax.transform.tuning_api.greedy_search(
+            knobs, trace, "llvm", max_evals=4, f_evaluate=mock_evaluate
+        )
+        assert PassContext.current().num_evals == 4
+
+
+def test_graph_tune():
+    @tvm.meta_schedule.utils.derived_object
+    class ConstantModel(tvm.meta_schedule.cost_model.PyCostModel):
+        def load(self, path):
+            pass
+
+        def save(self, path):
+            pass
+
+        def update(self, context, candidates, results):
+            pass
+
+        def predict(self, context, candidates):
+            return np.ones(len(candidates))
+
+    mod, _ = setup_test_const_folding()
+    estimator = relax.transform.tuning_api.KernelCostEstimator(
+        "llvm --num-cores=16", peak_gflops=1.0, cost_model=ConstantModel(), num_samples=2
+    )
+    # With a perfect score, a kernel runs at the peak throughput
+    tasks = tvm.meta_schedule.relax_integration.extract_tasks(mod, estimator.target)
+    assert len(tasks) == 1
+    assert isclose(estimator(mod), tvm.tir.analysis.estimate_tir_flops(tasks[0].mod) / 1e9)
+
+    # Folding the constant removes the only kernel
+    knob = Knob("fold", {"noapply": Choice(), "apply": Choice("testing.apply_fold_constant")})
+    for strategy in ["exhaustive", "greedy", "evolutionary"]:
+        with transform.PassContext(trace=Trace(mod), num_evals=0):
+            best = relax.transform.tuning_api.graph_tune(
+                mod, [knob], estimator, strategy=strategy, seed=0
+            )
+            assert [str(d) for d in best.decisions] == ["apply"]
+            assert best.perf == 0.0
+            assert PassContext.current().num_evals == 2
+
+
 def test_pass_context():
     before, expected = setup_test_const_folding()
     HeuristicPass = relax.transform.FoldConstant
@@ -15,11 +15,14 @@
 # specific language governing permissions and limitations
 # under the License.
 from __future__ import annotations  # must import to defer parsing of annotations
+import json
 import os
+import re
 from typing import Any, Callable, List, Tuple
 
 import sys
 import tempfile
+import threading
 import numpy as np
 import pytest
 import tvm
@@ -130,6 +133,24 @@ def test_vm_multiple_func():
     tvm.testing.assert_allclose(mul_res.numpy(), a.numpy() * b.numpy(), rtol=1e-7, atol=1e-7)
 
 
+def test_vm_lazy_func_table():
+    ib = relax.ExecBuilder()
+    with ib.function("func0", num_inputs=2):
+        ib.emit_call("test.vm.add", args=[ib.r(0), ib.r(1)], dst=ib.r(2))
+        ib.emit_ret(ib.r(2))
+    with ib.function("func1", num_inputs=2):
+        ib.emit_call("test.vm.mul", args=[ib.r(0), ib.r(1)], dst=ib.r(2))
+        ib.emit_ret(ib.r(2))
+    vm = relax.VirtualMachine(ib.get(), tvm.cpu())
+    stats = vm.func_table_stats()
+    assert stats["num_functions"] == 2 and stats["num_resolved"] == 0
+
+    a = tvm.nd.array(np.random.rand(4))
+    vm["func1"](a, a)
+    stats = vm.func_table_stats()
+    assert stats["num_resolved"] == 1 and stats["resolved"] == ["test.vm.mul"]
+
+
 def test_vm_exec_serialize_export_library():
     @tvm.script.ir_module
     class TestVMMove:
@@ -152,6 +173,161 @@ def test_vm_exec_serialize_export_library():
     assert ex.as_text() == loaded_exec.as_text()
 
 
+def test_vm_exec_save_load_file_constants():
+    ib = relax.ExecBuilder()
+    c0 = np.random.rand(3, 5).astype("float32")
+    c1 = np.random.rand(3, 5).astype("float64")
+    with ib.function("main", num_inputs=1):
+        ib.emit_call("test.vm.add", args=[ib.r(0), tvm.nd.array(c0)], dst=ib.r(1))
+        ib.emit_call("test.vm.add", args=[ib.r(1), tvm.nd.array(c1)], dst=ib.r(2))
+        ib.emit_ret(ib.r(2))
+    ex = ib.get()
+
+    temp_dir = utils.tempdir()
+    path_exec = temp_dir.relpath("exec.relax")
+    ex.mod.save(path_exec)
+    # the constant data follows the page of the sections, each aligned to 64 bytes
+    assert os.path.getsize(path_exec) == 4096 + 64 + c1.nbytes
+    loaded = relax.vm.Executable(tvm.get_global_func("relax.ExecutableLoadFromFile")(path_exec))
+    assert ex.as_text() == loaded.as_text()
+
+    inp = tvm.nd.array(np.random.rand(3, 5).astype("float64"))
+    vm = relax.VirtualMachine(loaded, tvm.cpu())
+    res = vm["main"](inp)
+    tvm.testing.assert_allclose(res.numpy(), inp.numpy() + c0 + c1, rtol=1e-7, atol=1e-7)
+
+
+def test_vm_exec_section_table():
+    ib = relax.ExecBuilder()
+    with ib.function("main", num_inputs=1):
+        ib.emit_call("test.vm.add", args=[ib.r(0), ib.r(0)], dst=ib.r(1))
+        ib.emit_ret(ib.r(1))
+    ex = ib.get()
+
+    temp_dir = utils.tempdir()
+    path_exec = temp_dir.relpath("exec.relax")
+    ex.mod.save(path_exec)
+    table = relax.vm.Executable.section_table(path_exec)
+    assert [s["name"] for s in table] == ["global", "constant", "packed func names", "code"]
+    code = [s for s in table if s["name"] == "code"][0]
+
+    # corrupting a section fails its checksum
+    with open(path_exec, "rb") as f:
+        data = bytearray(f.read())
+    data[code["offset"] + code["size"] - 1] ^= 0xFF
+    with open(path_exec, "wb") as f:
+        f.write(data)
+    with pytest.raises(tvm.TVMError):
+        tvm.get_global_func("relax.ExecutableLoadFromFile")(path_exec)
+
+
+@pytest.mark.parametrize("codec", ["lz", "fp16"])
+def test_vm_exec_constant_codec(codec):
+    ib = relax.ExecBuilder()
+    # repeated rows, well compressed by the lossless codec
+    c0 = np.tile(np.random.rand(1, 256).astype("float32"), (64, 1))
+    with ib.function("main", num_inputs=1):
+        ib.emit_call("test.vm.add", args=[ib.r(0), tvm.nd.array(c0)], dst=ib.r(1))
+        ib.emit_ret(ib.r(1))
+    ex = ib.get()
+    ex.set_constant_codec(codec, min_bytes=1024)
+
+    temp_dir = utils.tempdir()
+    path_exec = temp_dir.relpath("exec.relax")
+    ex.mod.save(path_exec)
+    assert os.path.getsize(path_exec) < c0.nbytes
+    loaded = relax.vm.Executable(tvm.get_global_func("relax.ExecutableLoadFromFile")(path_exec))
+
+    inp = tvm.nd.array(np.random.rand(64, 256).astype("float32"))
+    vm = relax.VirtualMachine(loaded, tvm.cpu())
+    res = vm["main"](inp)
+    tol = 1e-7 if codec == "lz" else 1e-3
+    tvm.testing.assert_allclose(res.numpy(), inp.numpy() + c0, rtol=tol, atol=tol)
+
+
+def test_vm_constant_devices():
+    ib = relax.ExecBuilder()
+    c0 = np.random.rand(3, 5).astype("float32")
+    c1 = np.random.rand(3, 5).astype("float32")
+    with ib.function("main", num_inputs=1):
+        # one constant placed on the host, one on the first device
+        ib.emit_call(
+            "test.vm.add", args=[ib.r(0), ib.emit_constant(tvm.nd.array(c0), -1)], dst=ib.r(1)
+        )
+        ib.emit_call("test.vm.add", args=[ib.r(1), ib.emit_constant(tvm.nd.array(c1))], dst=ib.r(2))
+        ib.emit_ret(ib.r(2))
+    ex = ib.get()
+
+    temp_dir = utils.tempdir()
+    path_exec = temp_dir.relpath("exec.so")
+    ex.mod.export_library(path_exec)
+    loaded = relax.vm.Executable(tvm.runtime.load_module(path_exec))
+
+    inp = tvm.nd.array(np.random.rand(3, 5).astype("float32"))
+    vm = relax.VirtualMachine(loaded, tvm.cpu())
+    sess = vm.create_session()
+    for machine in [vm, sess]:
+        res = machine["main"](inp)
+        tvm.testing.assert_allclose(res.numpy(), inp.numpy() + c0 + c1, rtol=1e-7, atol=1e-7)
+
+
+@tvm.testing.requires_gpu
+def test_vm_share_constants():
+    c0 = np.random.rand(3, 5).astype("float32")
+
+    def build():
+        ib = relax.ExecBuilder()
+        with ib.function("main", num_inputs=1):
+            ib.emit_call("test.vm.add", args=[ib.r(0), tvm.nd.array(c0)], dst=ib.r(1))
+            ib.emit_ret(ib.r(1))
+        return ib.get()
+
+    dev = tvm.cuda()
+    base = relax.vm.shared_constant_stats()
+    inp = tvm.nd.array(np.random.rand(3, 5).astype("float32"), dev)
+    vms = [relax.VirtualMachine(build(), dev, share_constants=True) for _ in range(2)]
+    for vm in vms:
+        vm["main"](inp)
+    stats = relax.vm.shared_constant_stats()
+    assert stats["num_constants"] == base["num_constants"] + 1
+    assert stats["num_uses"] == base["num_uses"] + 2
+
+    del vms, vm
+    assert relax.vm.shared_constant_stats()["num_constants"] == base["num_constants"]
+
+
+def test_vm_localize_constants():
+    c0 = np.random.rand(3, 5).astype("float32")
+    ib = relax.ExecBuilder()
+    with ib.function("main", num_inputs=1):
+        ib.emit_call("test.vm.add", args=[ib.r(0), tvm.nd.array(c0)], dst=ib.r(1))
+        ib.emit_ret(ib.r(1))
+    ex = ib.get()
+
+    def serve(node, results):
+        tvm.runtime.config_threadpool_numa_node(node)
+        vm = relax.VirtualMachine(ex, tvm.cpu(), localize_constants=True)
+        inp = tvm.nd.array(np.random.rand(3, 5).astype("float32"))
+        results[node] = (inp.numpy(), vm["main"](inp).numpy())
+
+    nodes = tvm.runtime.numa_node_cpus()
+    assert sorted(sum(nodes, [])) == sorted(set(sum(nodes, [])))
+    results = {}
+    # one serving thread per node, as the thread pools are per thread
+    threads = [
+        threading.Thread(target=serve, args=(node, results))
+        for node, cpus in enumerate(nodes)
+        if cpus
+    ]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    assert len(results) == len(threads)
+    for inp, res in results.values():
+        tvm.testing.assert_allclose(res, inp + c0, rtol=1e-7, atol=1e-7)
+
+
 def test_vm_checker():
     ib = relax.ExecBuilder()
     with pytest.raises(TVMError):
@@ -240,6 +416,111 @@ def test_vm_storage():
     assert res.shape == shape
 
 
+def test_vm_fuse_instructions():
+    dtype = tvm.DataType("float32")
+
+    def build(fuse_instructions):
+        ib = relax.ExecBuilder()
+        with ib.function("main", num_inputs=2):
+            ib.emit_if(ib.r(0), 4)
+            ib.emit_call(
+                "vm.builtin.alloc_storage",
+                args=[ib.vm_state(), (96,), ib.imm(0), dtype],
+                dst=ib.r(2),
+            )
+            ib.emit_call(
+                "vm.builtin.alloc_tensor", args=[ib.r(2), ib.imm(0), (4, 6), dtype], dst=ib.r(3)
+            )
+            ib.emit_goto(3)
+            ib.emit_call("vm.builtin.load_shape", args=[ib.r(1), (0, 1)], dst=ib.r(4))
+            ib.emit_call("test.vm.move", args=[ib.r(4)], dst=ib.r(3))
+            ib.emit_ret(ib.r(3))
+        return ib.get(fuse_instructions=fuse_instructions)
+
+    heap = tvm.nd.array(np.array([2, 3], dtype="int64"))
+    for fuse_instructions in [False, True]:
+        ex = build(fuse_instructions)
+        text = ex.as_text()
+        assert ("storage+tensor" in text) == fuse_instructions
+        assert ("vm.builtin.load_shape" in text) != fuse_instructions
+        vm = relax.VirtualMachine(ex, tvm.cpu())
+        assert vm["main"](tvm.nd.array(1), heap).shape == (4, 6)
+        assert list(vm["main"](tvm.nd.array(0), heap)) == [2, 3]
+
+
+def test_vm_allocate_registers():
+    def build(allocate_registers):
+        ib = relax.ExecBuilder()
+        with ib.function("main", num_inputs=2):
+            ib.emit_call("test.vm.add", args=[ib.r(0), ib.r(0)], dst=ib.r(2))
+            ib.emit_call("test.vm.add", args=[ib.r(2), ib.r(2)], dst=ib.r(3))
+            ib.emit_if(ib.r(1), 3)
+            ib.emit_call("test.vm.add", args=[ib.r(3), ib.r(3)], dst=ib.r(4))
+            ib.emit_goto(2)
+            ib.emit_call("test.vm.mul", args=[ib.r(3), ib.r(3)], dst=ib.r(4))
+            ib.emit_call("test.vm.add", args=[ib.r(4), ib.r(0)], dst=ib.r(5))
+            ib.emit_ret(ib.r(5))
+        return ib.get(allocate_registers=allocate_registers)
+
+    x = tvm.nd.array(np.array([1.0, 2.0], dtype="float32"))
+    for allocate_registers in [False, True]:
+        ex = build(allocate_registers)
+        text = ex.as_text()
+        assert ("kill" in text) == allocate_registers
+        # %2 and %3 are dead once %4 and %5 are defined
+        assert ("%5" in text) != allocate_registers
+        vm = relax.VirtualMachine(ex, tvm.cpu())
+        res = vm["main"](x, tvm.nd.array(1))
+        tvm.testing.assert_allclose(res.numpy(), x.numpy() * 8 + x.numpy())
+        res = vm["main"](x, tvm.nd.array(0))
+        tvm.testing.assert_allclose(res.numpy(), (x.numpy() * 4) ** 2 + x.numpy())
+
+
+def test_vm_shape_heap_instructions():
+    ib = relax.ExecBuilder()
+    op = relax.exec_builder.ShapeOp
+    with ib.function("main", num_inputs=1):
+        ib.emit_call("vm.builtin.shape_of", args=[ib.r(0)], dst=ib.r(1))
+        ib.emit_call("vm.builtin.alloc_shape_heap", args=[ib.vm_state(), (4,)], dst=ib.r(2))
+        ib.emit_store_shape(ib.r(1), ib.r(2), [0, 1])
+        # h[2] = h[0] * 2 + 1, h[3] = floordiv(h[1] - 7, 2)
+        ib.emit_compute_shape(
+            ib.r(2),
+            [op.LOAD, 0, op.IMM, 2, op.MUL, 0, op.IMM, 1, op.ADD, 0, op.STORE, 2]
+            + [op.LOAD, 1, op.IMM, 7, op.SUB, 0, op.IMM, 2, op.FLOOR_DIV, 0, op.STORE, 3],
+        )
+        ib.emit_load_shape(ib.r(2), [2, 3], dst=ib.r(3))
+        ib.emit_ret(ib.r(3))
+    ex = ib.get()
+    assert "vm.builtin.store_shape" not in ex.as_text()
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    res = vm["main"](tvm.nd.array(np.zeros((5, 4), dtype="float32")))
+    assert list(res) == [11, -2]
+
+
+def test_vm_register_instructions():
+    ib = relax.ExecBuilder()
+    const = tvm.nd.array(np.arange(4, dtype="float32"))
+    with ib.function("main", num_inputs=1):
+        ib.emit_load_const(const, dst=ib.r(1))
+        ib.emit_make_tuple([ib.r(0), ib.r(1), ib.c(ib.emit_constant((2, 3)))], dst=ib.r(2))
+        ib.emit_get_tuple_item(ib.r(2), 1, dst=ib.r(3))
+        ib.emit_move(ib.r(3), dst=ib.r(4))
+        ib.emit_make_tuple([ib.r(4), ib.r(2)], dst=ib.r(5))
+        ib.emit_ret(ib.r(5))
+    ex = ib.get()
+    text = ex.as_text()
+    assert "call" not in text
+    assert "move" in text and "tuple" in text and "item" in text
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    inp = tvm.nd.array(np.random.rand(2, 3).astype("float32"))
+    res, (res0, res1, res2) = vm["main"](inp)
+    tvm.testing.assert_allclose(res.numpy(), const.numpy())
+    tvm.testing.assert_allclose(res0.numpy(), inp.numpy())
+    tvm.testing.assert_allclose(res1.numpy(), const.numpy())
+    assert list(res2) == [2, 3]
+
+
 def test_vm_copy():
     @tvm.script.ir_module
     class TestVMMove:
@@ -306,6 +587,34 @@ def test_vm_if():
     tvm.testing.assert_allclose(res.numpy(), a.numpy() + b.numpy(), rtol=1e-7, atol=1e-7)
 
 
+@pytest.mark.parametrize("dispatch_mode", ["switch", "threaded"])
+def test_vm_dispatch_mode(dispatch_mode):
+    ib = relax.ExecBuilder()
+    with ib.function("main", num_inputs=3):
+        ib.emit_if(ib.r(0), 3)
+        ib.emit_call("test.vm.add", args=[ib.r(1), ib.r(2)], dst=ib.r(3))
+        ib.emit_goto(2)
+        ib.emit_call("test.vm.mul", args=[ib.r(1), ib.r(2)], dst=ib.r(3))
+        ib.emit_ret(ib.r(3))
+    ex = ib.get()
+    vm = relax.VirtualMachine(ex, tvm.cpu(), dispatch_mode=dispatch_mode)
+    a = tvm.nd.array(np.random.rand(4))
+    b = tvm.nd.array(np.random.rand(4))
+    res = vm["main"](tvm.nd.array(False), a, b)
+    tvm.testing.assert_allclose(res.numpy(), a.numpy() * b.numpy(), rtol=1e-7, atol=1e-7)
+    res = vm["main"](tvm.nd.array(1), a, b)
+    tvm.testing.assert_allclose(res.numpy(), a.numpy() + b.numpy(), rtol=1e-7, atol=1e-7)
+
+
+def test_vm_invalid_dispatch_mode():
+    ib = relax.ExecBuilder()
+    with ib.function("main", num_inputs=0):
+        ib.emit_call("test.vm.identity", args=[], dst=ib.r(0))
+        ib.emit_ret(ib.r(0))
+    with pytest.raises(ValueError):
+        relax.VirtualMachine(ib.get(), tvm.cpu(), dispatch_mode="unknown")
+
+
 def test_vm_compile_if():
     @tvm.script.ir_module
     class TestVMCompileIf:
@@ -458,6 +767,85 @@ def test_vm_compile_e2e():
     tvm.testing.assert_allclose(res.numpy(), np.tile(inp.numpy(), (1, 2)), rtol=1e-7, atol=1e-7)
 
 
+def test_vm_build_cache():
+    def get_mod(unary):
+        bb = relax.BlockBuilder()
+        x = relax.Var("x", [4, 8], relax.DynTensorType(2, "float32"))
+        with bb.function("main", [x]):
+            with bb.dataflow():
+                lv0 = bb.emit_te(topi.add, x, x)
+                lv1 = bb.emit_te(unary, lv0)
+                gv = bb.emit_output(lv1)
+            bb.emit_func_output(gv)
+        return bb.get()
+
+    cache_dir = utils.tempdir().relpath("cache")
+    inp = tvm.nd.array(np.random.rand(4, 8).astype(np.float32))
+    results = []
+    cached = []
+    for unary in [topi.exp, topi.exp, topi.sqrt]:
+        ex = relax.vm.build(get_mod(unary), "llvm", cache_dir=cache_dir)
+        results.append(relax.VirtualMachine(ex, tvm.cpu())["main"](inp).numpy())
+        cached.append(set(os.listdir(cache_dir)))
+
+    # The second build reuses all the kernels, the third one only compiles sqrt.
+    assert cached[0] == cached[1]
+    assert cached[0] < cached[2]
+    tvm.testing.assert_allclose(results[1], np.exp(inp.numpy() * 2), rtol=1e-6, atol=1e-6)
+    tvm.testing.assert_allclose(results[2], np.sqrt(inp.numpy() * 2), rtol=1e-6, atol=1e-6)
+
+    # The executable linking the cached kernels can still be exported.
+    path_exec = utils.tempdir().relpath("exec.so")
+    ex.mod.export_library(path_exec)
+    loaded = relax.vm.Executable(tvm.runtime.load_module(path_exec))
+    res = relax.VirtualMachine(loaded, tvm.cpu())["main"](inp)
+    tvm.testing.assert_allclose(res.numpy(), results[2], rtol=1e-6, atol=1e-6)
+
+    # The kernels built in another pass context are cached separately.
+    with tvm.transform.PassContext(opt_level=0):
+        relax.vm.build(get_mod(topi.sqrt), "llvm", cache_dir=cache_dir)
+    assert cached[2] < set(os.listdir(cache_dir))
+
+    # A kernel whose saved key does not match is rebuilt.
+    key_paths = [os.path.join(cache_dir, name) for name in cached[2] if name.endswith(".key")]
+    for key_path in key_paths:
+        with open(key_path) as key_file:
+            key = json.load(key_file)
+        with open(key_path, "w") as key_file:
+            json.dump(dict(key, target="llvm -mcpu=other"), key_file)
+    ex = relax.vm.build(get_mod(topi.sqrt), "llvm", cache_dir=cache_dir)
+    for key_path in key_paths:
+        with open(key_path) as key_file:
+            assert json.load(key_file)["target"] != "llvm -mcpu=other"
+    res = relax.VirtualMachine(ex, tvm.cpu())["main"](inp)
+    tvm.testing.assert_allclose(res.numpy(), results[2], rtol=1e-6, atol=1e-6)
+
+
+def test_vm_build_tir_in_shards():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [4, 8], relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            lv0 = bb.emit_te(topi.add, x, x)
+            lv1 = bb.emit_te(topi.exp, lv0)
+            lv2 = bb.emit_te(topi.multiply, lv1, x)
+            gv = bb.emit_output(lv2)
+        bb.emit_func_output(gv)
+    mod = bb.get()
+
+    inp = tvm.nd.array(np.random.rand(4, 8).astype(np.float32))
+    expected = np.exp(inp.numpy() * 2) * inp.numpy()
+    ex = relax.vm.build(mod, "llvm", num_tir_shards=2)
+    res = relax.VirtualMachine(ex, tvm.cpu())["main"](inp)
+    tvm.testing.assert_allclose(res.numpy(), expected, rtol=1e-6, atol=1e-6)
+
+    path_exec = utils.tempdir().relpath("exec.so")
+    ex.mod.export_library(path_exec)
+    loaded = relax.vm.Executable(tvm.runtime.load_module(path_exec))
+    res = relax.VirtualMachine(loaded, tvm.cpu())["main"](inp)
+    tvm.testing.assert_allclose(res.numpy(), expected, rtol=1e-6, atol=1e-6)
+
+
 def test_vm_compile_e2e_func_param_with_shape():
     @tvm.script.ir_module
     class TestVMCompileE2E2:
@@ -496,6 +884,299 @@ def test_vm_compile_e2e_func_param_with_shape():
     tvm.testing.assert_allclose(res.numpy(), expected, rtol=1e-6, atol=1e-6)
 
 
+def test_vm_compiled_exec_mode():
+    @tvm.script.ir_module
+    class TestVMCompiled:
+        @T.prim_func
+        def tir_matmul(x: T.handle, y: T.handle, z: T.handle) -> None:
+            T.func_attr({"global_symbol": "tir_matmul"})
+            m = T.var("int32")
+            n = T.var("int32")
+            k = T.var("int32")
+            A = T.match_buffer(x, (m, n))
+            B = T.match_buffer(y, (n, k))
+            C = T.match_buffer(z, (m, k))
+
+            for i, j, k in T.grid(m, k, n):
+                with T.block("matmul"):
+                    vi, vj, vk = T.axis.remap("SSR", [i, j, k])
+                    with T.init():
+                        C[vi, vj] = T.float32(0)
+                    C[vi, vj] = C[vi, vj] + A[vi, vk] * B[vk, vj]
+
+        @R.function
+        def func(x: Tensor((m, n), "float32"), w: Tensor((n, k), "float32")) -> Tensor:
+            gv0 = R.call_tir(tir_matmul, (x, w), (m, k), dtype="float32")
+            gv1 = R.call_tir(tir_matmul, (gv0, w), (m, k), dtype="float32")
+            return gv1
+
+    target = tvm.target.Target("llvm", host="llvm")
+    ex = relax.vm.build(TestVMCompiled, target, exec_mode="compiled")
+    path_exec = utils.tempdir().relpath("exec.so")
+    ex.mod.export_library(path_exec)
+    loaded = relax.vm.Executable(tvm.runtime.load_module(path_exec))
+    vm = relax.VirtualMachine(loaded, tvm.cpu())
+    assert vm.func_table_stats()["num_compiled"] == 1
+
+    # the shapes are still computed at runtime
+    for m in [4, 7]:
+        data = tvm.nd.array(np.random.rand(m, 16).astype(np.float32))
+        weight = tvm.nd.array(np.random.rand(16, 16).astype(np.float32))
+        res = vm["func"](data, weight)
+        expected = np.dot(np.dot(data.numpy(), weight.numpy()), weight.numpy())
+        tvm.testing.assert_allclose(res.numpy(), expected, rtol=1e-5, atol=1e-5)
+
+    with pytest.raises(ValueError):
+        relax.vm.build(TestVMCompiled, target, exec_mode="unknown")
+
+
+def test_vm_codegen_multi_stream():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [4, 8], relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x]):
+        with bb.dataflow():
+            lv0 = bb.emit_te(topi.nn.relu, x)
+            lv1 = bb.emit_te(topi.negative, x)
+            lv2 = bb.emit_te(topi.add, lv0, lv1)
+            gv = bb.emit_output(lv2)
+        bb.emit_func_output(gv)
+    mod = bb.get()
+
+    target = tvm.target.Target("llvm", host="llvm")
+    with tvm.transform.PassContext(config={"relax.VMCodeGen.num_streams": 2}):
+        ex = relax.vm.build(mod, target)
+    text = ex.as_text()
+    assert "vm.builtin.set_stream" in text
+    assert "vm.builtin.sync_stream" in text
+
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    inp = tvm.nd.array(np.random.rand(4, 8).astype(np.float32))
+    res = vm["main"](inp)
+    expected = np.maximum(inp.numpy(), 0) - inp.numpy()
+    tvm.testing.assert_allclose(res.numpy(), expected, rtol=1e-6, atol=1e-6)
+
+    assert "vm.builtin.join_streams" in text
+
+
+@tvm.testing.requires_cuda
+def test_vm_multi_stream_pooled_storage():
+    @tvm.script.ir_module
+    class TestVMMultiStream:
+        @T.prim_func
+        def add_one(a: T.handle, b: T.handle) -> None:
+            T.func_attr({"global_symbol": "add_one"})
+            A = T.match_buffer(a, (1 << 20,), "float32")
+            B = T.match_buffer(b, (1 << 20,), "float32")
+            for i0 in T.thread_binding(1 << 12, thread="blockIdx.x"):
+                for i1 in T.thread_binding(256, thread="threadIdx.x"):
+                    with T.block("B"):
+                        vi = T.axis.spatial(1 << 20, i0 * 256 + i1)
+                        B[vi] = A[vi] + T.float32(1)
+
+        @T.prim_func
+        def add(a: T.handle, b: T.handle, c: T.handle) -> None:
+            T.func_attr({"global_symbol": "add"})
+            A = T.match_buffer(a, (1 << 20,), "float32")
+            B = T.match_buffer(b, (1 << 20,), "float32")
+            C = T.match_buffer(c, (1 << 20,), "float32")
+            for i0 in T.thread_binding(1 << 12, thread="blockIdx.x"):
+                for i1 in T.thread_binding(256, thread="threadIdx.x"):
+                    with T.block("C"):
+                        vi = T.axis.spatial(1 << 20, i0 * 256 + i1)
+                        C[vi] = A[vi] + B[vi]
+
+        @R.function
+        def main(x: Tensor((1 << 20,), "float32")):
+            a0 = R.call_tir(add_one, (x,), (1 << 20,), dtype="float32")
+            b0 = R.call_tir(add_one, (x,), (1 << 20,), dtype="float32")
+            a1 = R.call_tir(add_one, (a0,), (1 << 20,), dtype="float32")
+            b1 = R.call_tir(add_one, (b0,), (1 << 20,), dtype="float32")
+            c = R.call_tir(add, (a1, b1), (1 << 20,), dtype="float32")
+            return c
+
+    target = tvm.target.Target("cuda", host="llvm")
+    with tvm.transform.PassContext(config={"relax.VMCodeGen.num_streams": 2}):
+        ex = relax.vm.build(TestVMMultiStream, target)
+    assert "vm.builtin.join_streams" in ex.as_text()
+
+    # the storage freed by one call is handed to the kernels of the next one on either stream
+    dev = tvm.cuda()
+    vm = relax.VirtualMachine(ex, dev, memory_cfg={dev: "pooled"})
+    for _ in range(10):
+        x_np = np.random.rand(1 << 20).astype(np.float32)
+        res = vm["main"](tvm.nd.array(x_np, dev))
+        tvm.testing.assert_allclose(res.numpy(), 2 * x_np + 4, rtol=1e-6, atol=1e-6)
+        del res
+
+
+def test_vm_invoke_batched():
+    bb = relax.BlockBuilder()
+    n = tir.Var("n", "int64")
+    x = relax.Var("x", [n, 4], relax.DynTensorType(2, "float32"))
+    w = relax.Var("w", [4, 4], relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x, w]):
+        gv = bb.emit_te(topi.nn.matmul, x, w)
+        bb.emit_func_output(gv)
+    mod = bb.get()
+
+    target = tvm.target.Target("llvm", host="llvm")
+    ex = relax.vm.build(mod, target)
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    weight = tvm.nd.array(np.random.rand(4, 4).astype(np.float32))
+    inputs = [tvm.nd.array(np.random.rand(b, 4).astype(np.float32)) for b in [1, 3, 2]]
+    outputs = vm.invoke_batched("main", [[inp, weight] for inp in inputs])
+    assert len(outputs) == len(inputs)
+    for inp, out in zip(inputs, outputs):
+        expected = np.matmul(inp.numpy(), weight.numpy())
+        tvm.testing.assert_allclose(out.numpy(), expected, rtol=1e-6, atol=1e-6)
+
+    with pytest.raises(TypeError):
+        vm.invoke_batched("main", [[inp, 1.0] for inp in inputs])
+    # the output is not batched along axis 1, whose extent is fixed
+    with pytest.raises(ValueError):
+        vm.invoke_batched("main", [[inp, weight] for inp in inputs], output_batch_axes=[1])
+    # an output that is not batched is shared by all the requests
+    outputs = vm.invoke_batched("main", [[inp, weight] for inp in inputs], output_batch_axes=[None])
+    total = np.matmul(np.concatenate([inp.numpy() for inp in inputs]), weight.numpy())
+    for out in outputs:
+        tvm.testing.assert_allclose(out.numpy(), total, rtol=1e-6, atol=1e-6)
+
+    # a weight converted for each request is still shared
+    weight_np = weight.numpy()
+    outputs = vm.invoke_batched("main", [[inp.numpy(), weight_np] for inp in inputs])
+    for inp, out in zip(inputs, outputs):
+        expected = np.matmul(inp.numpy(), weight_np)
+        tvm.testing.assert_allclose(out.numpy(), expected, rtol=1e-6, atol=1e-6)
+
+
+def test_vm_invoke_batched_axis():
+    bb = relax.BlockBuilder()
+    n = tir.Var("n", "int64")
+    x = relax.Var("x", [4, n], relax.DynTensorType(2, "float32"))
+    w = relax.Var("w", [4, 4], relax.DynTensorType(2, "float32"))
+    with bb.function("main", [w, x]):
+        gv = bb.emit_te(topi.nn.matmul, w, x)
+        bb.emit_func_output(gv)
+    mod = bb.get()
+
+    target = tvm.target.Target("llvm", host="llvm")
+    ex = relax.vm.build(mod, target)
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    weight = tvm.nd.array(np.random.rand(4, 4).astype(np.float32))
+    inputs = [tvm.nd.array(np.random.rand(4, b).astype(np.float32)) for b in [1, 3, 2]]
+    outputs = vm.invoke_batched("main", [[weight, inp] for inp in inputs], batch_axis=1)
+    assert len(outputs) == len(inputs)
+    for inp, out in zip(inputs, outputs):
+        expected = np.matmul(weight.numpy(), inp.numpy())
+        tvm.testing.assert_allclose(out.numpy(), expected, rtol=1e-6, atol=1e-6)
+
+
+def test_vm_set_input_borrowed():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [4, 4], relax.DynTensorType(2, "float32"))
+    y = relax.Var("y", [4, 4], relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x, y]):
+        gv = bb.emit_te(topi.add, x, y)
+        bb.emit_func_output(gv)
+    mod = bb.get()
+
+    target = tvm.target.Target("llvm", host="llvm")
+    ex = relax.vm.build(mod, target)
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    a = tvm.nd.array(np.random.rand(4, 4).astype(np.float32))
+    b = tvm.nd.array(np.random.rand(4, 4).astype(np.float32))
+    vm.set_input_borrowed("main", a, b)
+    vm.invoke_stateful("main")
+    tvm.testing.assert_allclose(vm.get_outputs("main").numpy(), a.numpy() + b.numpy(), rtol=1e-6)
+
+    # The function reads the borrowed memory, so in-place updates are visible without
+    # binding the inputs again.
+    a.copyfrom(np.ones((4, 4), dtype="float32"))
+    vm.invoke_stateful("main")
+    tvm.testing.assert_allclose(vm.get_outputs("main").numpy(), a.numpy() + b.numpy(), rtol=1e-6)
+
+    # Rebinding the same buffers keeps the binding, and a new buffer replaces it.
+    c = tvm.nd.array(np.random.rand(4, 4).astype(np.float32))
+    vm.set_input_borrowed("main", a, c)
+    vm.invoke_stateful("main")
+    tvm.testing.assert_allclose(vm.get_outputs("main").numpy(), a.numpy() + c.numpy(), rtol=1e-6)
+
+
+def test_vm_best_fit_allocator():
+    bb = relax.BlockBuilder()
+    n = tir.Var("n", "int64")
+    x = relax.Var("x", [n, 64], relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x]):
+        gv = bb.emit_te(topi.add, x, x)
+        bb.emit_func_output(gv)
+    mod = bb.get()
+
+    target = tvm.target.Target("llvm", host="llvm")
+    ex = relax.vm.build(mod, target)
+    # use a device id that no other test has created an allocator for
+    dev = tvm.cpu(3)
+    vm = relax.VirtualMachine(ex, dev, memory_cfg="best_fit")
+    for rows in [256, 250, 128]:
+        data = tvm.nd.array(np.random.rand(rows, 64).astype(np.float32), dev)
+        res = vm["main"](data)
+        tvm.testing.assert_allclose(res.numpy(), data.numpy() * 2, rtol=1e-6)
+        del res
+
+    stats = vm.memory_stats()[dev]
+    # the outputs of similar sizes reuse the first block, the smaller one splits it
+    assert stats["num_device_allocs"] == 1
+    assert stats["num_cache_hits"] == 2
+    assert stats["bytes_in_use"] == 0
+    assert stats["bytes_cached"] == 256 * 64 * 4
+    assert stats["fragmentation"] == 0.0
+
+    tvm.get_global_func("vm.set_memory_high_water_mark")(dev, 1)
+    stats = vm.memory_stats()[dev]
+    assert stats["bytes_cached"] == 0
+    assert stats["num_device_frees"] == 1
+
+
+@tvm.testing.requires_cuda
+def test_vm_stream_ordered_allocator():
+    @tvm.script.ir_module
+    class TestVMStreamOrdered:
+        @T.prim_func
+        def add_one(a: T.handle, b: T.handle) -> None:
+            T.func_attr({"global_symbol": "add_one"})
+            A = T.match_buffer(a, (1024,), "float32")
+            B = T.match_buffer(b, (1024,), "float32")
+            for i0 in T.thread_binding(8, thread="blockIdx.x"):
+                for i1 in T.thread_binding(128, thread="threadIdx.x"):
+                    with T.block("B"):
+                        vi = T.axis.spatial(1024, i0 * 128 + i1)
+                        B[vi] = A[vi] + T.float32(1)
+
+        @R.function
+        def main(x: Tensor((1024,), "float32")):
+            y = R.call_tir(add_one, (x,), (1024,), dtype="float32")
+            z = R.call_tir(add_one, (y,), (1024,), dtype="float32")
+            return z
+
+    target = tvm.target.Target("cuda", host="llvm")
+    ex = relax.vm.build(TestVMStreamOrdered, target)
+    dev = tvm.cuda()
+    # keep the freed memory in the pool across the synchronizations
+    tvm.runtime.config_cuda_mem_pool(-1)
+    try:
+        vm = relax.VirtualMachine(ex, dev, memory_cfg={dev: "stream_ordered"})
+        for _ in range(3):
+            x_np = np.random.rand(1024).astype(np.float32)
+            res = vm["main"](tvm.nd.array(x_np, dev))
+            tvm.testing.assert_allclose(res.numpy(), x_np + 2, rtol=1e-7, atol=1e-7)
+            del res
+        stats = vm.memory_stats()[dev]
+        # the pool of the device caches the memory, not the allocator
+        assert stats["num_allocs"] == stats["num_device_allocs"]
+        assert stats["bytes_cached"] == 0
+    finally:
+        tvm.runtime.config_cuda_mem_pool()
+
+
 def test_vm_emit_te_extern():
     if not tvm.get_global_func("tvm.contrib.cblas.matmul", True):
         print("skip because extern function is not available")
@@ -674,6 +1355,142 @@ def test_vm_emit_te_constant_param_gpu():
     tvm.testing.assert_allclose(add_res.numpy(), x_np + c_np, rtol=1e-7, atol=1e-7)
 
 
+@tvm.testing.requires_cuda
+def test_vm_cuda_graph():
+    @tvm.script.ir_module
+    class TestVMCUDAGraph:
+        @T.prim_func
+        def add_one(a: T.handle, b: T.handle) -> None:
+            T.func_attr({"global_symbol": "add_one"})
+            A = T.match_buffer(a, (1024,), "float32")
+            B = T.match_buffer(b, (1024,), "float32")
+            for i0 in T.thread_binding(8, thread="blockIdx.x"):
+                for i1 in T.thread_binding(128, thread="threadIdx.x"):
+                    with T.block("B"):
+                        vi = T.axis.spatial(1024, i0 * 128 + i1)
+                        B[vi] = A[vi] + T.float32(1)
+
+        @R.function
+        def main(x: Tensor((1024,), "float32")):
+            y = R.call_tir(add_one, (x,), (1024,), dtype="float32")
+            z = R.call_tir(add_one, (y,), (1024,), dtype="float32")
+            return z
+
+    target = tvm.target.Target("cuda", host="llvm")
+    ex = relax.vm.build(TestVMCUDAGraph, target)
+    dev = tvm.cuda()
+    vm = relax.VirtualMachine(ex, dev)
+    x_np = np.random.rand(1024).astype(np.float32)
+    vm.set_input("main", tvm.nd.array(x_np, dev))
+    vm.capture_cuda_graph("main")
+    tvm.testing.assert_allclose(vm.get_outputs("main").numpy(), x_np + 2, rtol=1e-7, atol=1e-7)
+
+    x_np = np.random.rand(1024).astype(np.float32)
+    vm.set_input("main", tvm.nd.array(x_np, dev))
+    vm.run_cuda_graph("main")
+    tvm.testing.assert_allclose(vm.get_outputs("main").numpy(), x_np + 2, rtol=1e-7, atol=1e-7)
+
+
+@tvm.testing.requires_cuda
+def test_vm_cuda_graph_dynamic_shape():
+    @tvm.script.ir_module
+    class TestVMCUDAGraphDynamic:
+        @T.prim_func
+        def add_one(a: T.handle, b: T.handle) -> None:
+            T.func_attr({"global_symbol": "add_one"})
+            n = T.var("int32")
+            A = T.match_buffer(a, (n, 128), "float32")
+            B = T.match_buffer(b, (n, 128), "float32")
+            for i0 in T.thread_binding(n, thread="blockIdx.x"):
+                for i1 in T.thread_binding(128, thread="threadIdx.x"):
+                    with T.block("B"):
+                        vi, vj = T.axis.remap("SS", [i0, i1])
+                        B[vi, vj] = A[vi, vj] + T.float32(1)
+
+        @R.function
+        def main(x: Tensor((n, 128), "float32")):
+            y = R.call_tir(add_one, (x,), (n, 128), dtype="float32")
+            return y
+
+    target = tvm.target.Target("cuda", host="llvm")
+    ex = relax.vm.build(TestVMCUDAGraphDynamic, target)
+    dev = tvm.cuda()
+    vm = relax.VirtualMachine(ex, dev)
+    # each shape is captured on its first run and replayed afterwards
+    for n in [4, 8, 4, 8]:
+        x_np = np.random.rand(n, 128).astype(np.float32)
+        vm.set_input("main", tvm.nd.array(x_np, dev))
+        vm.run_cuda_graph("main")
+        tvm.testing.assert_allclose(vm.get_outputs("main").numpy(), x_np + 1, rtol=1e-7, atol=1e-7)
+
+
+@tvm.testing.requires_cuda
+def test_vm_async_input_copy():
+    @tvm.script.ir_module
+    class TestVMAsyncInput:
+        @T.prim_func
+        def add_one(a: T.handle, b: T.handle) -> None:
+            T.func_attr({"global_symbol": "add_one"})
+            A = T.match_buffer(a, (1024,), "float32")
+            B = T.match_buffer(b, (1024,), "float32")
+            for i0 in T.thread_binding(8, thread="blockIdx.x"):
+                for i1 in T.thread_binding(128, thread="threadIdx.x"):
+                    with T.block("B"):
+                        vi = T.axis.spatial(1024, i0 * 128 + i1)
+                        B[vi] = A[vi] + T.float32(1)
+
+        @R.function
+        def main(x: Tensor((1024,), "float32")):
+            y = R.call_tir(add_one, (x,), (1024,), dtype="float32")
+            return y
+
+    target = tvm.target.Target("cuda", host="llvm")
+    ex = relax.vm.build(TestVMAsyncInput, target)
+    vm = relax.VirtualMachine(ex, tvm.cuda(), async_input_copy=True)
+    # stage the uploads in chunks smaller than the inputs
+    tvm.runtime.config_cuda_pinned_staging(1024, 0)
+    try:
+        inputs = [np.random.rand(1024).astype(np.float32) for _ in range(4)]
+        outputs = []
+        for x_np in inputs:
+            # the upload of the next input overlaps the call on the previous one
+            vm.set_input("main", tvm.nd.array(x_np))
+            vm.invoke_stateful("main")
+            outputs.append(vm.get_outputs("main"))
+        for x_np, out in zip(inputs, outputs):
+            tvm.testing.assert_allclose(out.numpy(), x_np + 1, rtol=1e-7, atol=1e-7)
+    finally:
+        tvm.runtime.config_cuda_pinned_staging()
+
+
+def test_vm_unchecked_kernels():
+    @tvm.script.ir_module
+    class TestVMUnchecked:
+        @T.prim_func
+        def add_one(a: T.handle, b: T.handle) -> None:
+            T.func_attr({"global_symbol": "add_one"})
+            A = T.match_buffer(a, (1024,), "float32")
+            B = T.match_buffer(b, (1024,), "float32")
+            for i in range(1024):
+                with T.block("B"):
+                    vi = T.axis.spatial(1024, i)
+                    B[vi] = A[vi] + T.float32(1)
+
+        @R.function
+        def main(x: Tensor((1024,), "float32")):
+            y = R.call_tir(add_one, (x,), (1024,), dtype="float32")
+            return y
+
+    with tvm.transform.PassContext(config={"tir.make_unchecked_api": True}):
+        ex = relax.vm.build(TestVMUnchecked, "llvm")
+    assert ex.mod.implements_function("add_one_unchecked", query_imports=True)
+    x_np = np.random.rand(1024).astype(np.float32)
+    for unchecked in [False, True]:
+        vm = relax.VirtualMachine(ex, tvm.cpu(), unchecked_kernels=unchecked)
+        res = vm["main"](tvm.nd.array(x_np))
+        tvm.testing.assert_allclose(res.numpy(), x_np + 1, rtol=1e-7, atol=1e-7)
+
+
 def test_vm_relax_symbolic_shape():
     bb = relax.BlockBuilder()
     n = tir.Var("n", "int64")
@@ -742,6 +1559,384 @@ def test_vm_relax_dyn_tir_shape():
     tvm.testing.assert_allclose(res.numpy(), inp2.numpy(), rtol=1e-7, atol=1e-7)
 
 
+def test_vm_profile():
+    @tvm.script.ir_module
+    class TestVMProfile:
+        @T.prim_func
+        def add_one(a: T.handle, b: T.handle) -> None:
+            T.func_attr({"global_symbol": "add_one"})
+            A = T.match_buffer(a, (1024,), "float32")
+            B = T.match_buffer(b, (1024,), "float32")
+            for i in T.serial(1024):
+                with T.block("B"):
+                    vi = T.axis.spatial(1024, i)
+                    B[vi] = A[vi] + T.float32(1)
+
+        @R.function
+        def main(x: Tensor((1024,), "float32")):
+            y = R.call_tir(add_one, (x,), (1024,), dtype="float32")
+            z = R.call_tir(add_one, (y,), (1024,), dtype="float32")
+            return z
+
+    ex = relax.vm.build(TestVMProfile, tvm.target.Target("llvm", host="llvm"))
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    x = tvm.nd.array(np.random.rand(1024).astype(np.float32))
+    report = vm.profile("main", x)
+    assert report.configuration["Executor"] == "Relax VM"
+    calls = [call for call in report.calls if call["Name"] == "add_one"]
+    assert len(calls) == 2
+    assert calls[0]["Argument Shapes"] == "float32[1024], float32[1024]"
+    assert "add_one" in report.table(aggregate=True)
+    # the inputs of the profiled function are not consumed by profiling
+    tvm.testing.assert_allclose(vm["main"](x).numpy(), x.numpy() + 2, rtol=1e-7, atol=1e-7)
+
+
+def test_vm_call_tir_dyn_func_table():
+    bb = relax.BlockBuilder()
+    n = tir.Var("n", "int64")
+
+    def te_func(A):
+        C = te.compute((n + 1), lambda i: A[i])
+        return C
+
+    with bb.function("rx_func"):
+        x = nn.Placeholder((n,), dtype="float32", name="x")
+        y = nn.Placeholder((n + 1,), dtype="float32", name="y")
+
+        x1 = bb.emit_te(te_func, y)
+        bb.emit_func_output(x1, params=[x, y])
+
+    mod = bb.get()
+
+    target = tvm.target.Target("llvm", host="llvm")
+    ex = relax.vm.build(mod, target)
+    # the kernel is referenced through the function table instead of a string constant
+    assert "te_func" in ex.stats().split("Packed functions")[1]
+
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    inp = tvm.nd.array(np.random.rand(2).astype(np.float32))
+    inp2 = tvm.nd.array(np.random.rand(3).astype(np.float32))
+    for _ in range(2):
+        res = vm["rx_func"](inp, inp2)
+        tvm.testing.assert_allclose(res.numpy(), inp2.numpy(), rtol=1e-7, atol=1e-7)
+
+
+def test_vm_sessions():
+    @tvm.script.ir_module
+    class TestVMSessions:
+        @R.function
+        def main(x: Tensor((3, 4), "float32")):
+            c = relax.const(np.ones((3, 4), dtype="float32"))
+            y = relax.call_packed("test.vm.add", x, c, type_args=(Tensor(ndim=2, dtype="float32")))
+            return y
+
+    target = tvm.target.Target("llvm", host="llvm")
+    ex = relax.vm.build(TestVMSessions, target)
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    sessions = [vm.create_session() for _ in range(4)]
+    inputs = [tvm.nd.array(np.random.rand(3, 4).astype(np.float32)) for _ in sessions]
+    results = [None] * len(sessions)
+
+    def run(i):
+        for _ in range(10):
+            results[i] = sessions[i]["main"](inputs[i])
+
+    threads = [threading.Thread(target=run, args=(i,)) for i in range(len(sessions))]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    for inp, res in zip(inputs, results):
+        tvm.testing.assert_allclose(res.numpy(), inp.numpy() + 1, rtol=1e-7, atol=1e-7)
+
+
+def test_vm_hot_reload():
+    c0 = np.random.rand(3, 5).astype("float32")
+
+    def build(c1):
+        ib = relax.ExecBuilder()
+        with ib.function("main", num_inputs=1):
+            ib.emit_call("test.vm.add", args=[ib.r(0), tvm.nd.array(c0)], dst=ib.r(1))
+            ib.emit_call("test.vm.add", args=[ib.r(1), tvm.nd.array(c1)], dst=ib.r(2))
+            ib.emit_ret(ib.r(2))
+        return ib.get()
+
+    ones = np.ones((3, 5), "float32")
+    inp = tvm.nd.array(np.random.rand(3, 5).astype("float32"))
+    vm = relax.VirtualMachine(build(ones), tvm.cpu())
+    main = vm["main"]
+    main(inp)
+    old_session = vm.create_session()
+
+    stats = vm.hot_reload(build(ones * 2))
+    assert stats["num_constants"] == 2
+    # c0 is unchanged by the rebuild, c1 is uploaded before the swap.
+    assert stats["num_reused"] == 1 and stats["reused_bytes"] == c0.nbytes
+    assert stats["num_uploaded"] == 1
+
+    expected = inp.numpy() + c0
+    # A function looked up before the reload calls the new program.
+    tvm.testing.assert_allclose(main(inp).numpy(), expected + 2, rtol=1e-7, atol=1e-7)
+    new_session = vm.create_session()
+    tvm.testing.assert_allclose(new_session["main"](inp).numpy(), expected + 2, rtol=1e-7)
+    # The sessions created before the reload keep running the previous program.
+    tvm.testing.assert_allclose(old_session["main"](inp).numpy(), expected + 1, rtol=1e-7)
+
+
+def test_vm_local_pooled_allocator():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [3, 4], relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x]):
+        gv = bb.emit_te(topi.add, x, x)
+        bb.emit_func_output(gv)
+    mod = bb.get()
+
+    target = tvm.target.Target("llvm", host="llvm")
+    ex = relax.vm.build(mod, target)
+    vm = relax.VirtualMachine(ex, tvm.cpu(), memory_cfg="local_pooled")
+    sessions = [vm.create_session() for _ in range(4)]
+    inputs = [tvm.nd.array(np.random.rand(3, 4).astype(np.float32)) for _ in sessions]
+    results = [None] * len(sessions)
+
+    def run(i):
+        for _ in range(10):
+            results[i] = sessions[i]["main"](inputs[i])
+
+    threads = [threading.Thread(target=run, args=(i,)) for i in range(len(sessions))]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+
+    for session in sessions:
+        stats = session.memory_stats()[tvm.cpu()]
+        # each session allocates from its own pool, which only holds the result of the last
+        # call and the one returned before it
+        assert stats["num_allocs"] == 10
+        assert stats["num_device_allocs"] == 2
+    assert vm.memory_stats()[tvm.cpu()]["num_allocs"] == 0
+
+    # the results keep the allocators of the sessions alive
+    del vm, sessions
+    for inp, res in zip(inputs, results):
+        tvm.testing.assert_allclose(res.numpy(), inp.numpy() * 2, rtol=1e-7, atol=1e-7)
+
+
+def test_vm_budgeted_allocator():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [3, 4], relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x]):
+        gv = bb.emit_te(topi.add, x, x)
+        bb.emit_func_output(gv)
+    mod = bb.get()
+
+    target = tvm.target.Target("llvm", host="llvm")
+    ex = relax.vm.build(mod, target)
+    vm = relax.VirtualMachine(ex, tvm.cpu(), memory_cfg="budgeted")
+    vm.set_memory_budget(tvm.cpu(), 8192)
+    inp = tvm.nd.array(np.random.rand(3, 4).astype(np.float32))
+
+    # each result takes a page, two of them fill the budget
+    res0 = vm["main"](inp)
+    res1 = vm["main"](inp)
+    with pytest.raises(tvm.TVMError):
+        vm["main"](inp)
+    tvm.testing.assert_allclose(res1.numpy(), inp.numpy() * 2, rtol=1e-7, atol=1e-7)
+
+    # shrinking the budget releases the cached pages beyond it
+    del res0, res1
+    vm.set_memory_budget(tvm.cpu(), 4096)
+    stats = vm.memory_stats()[tvm.cpu()]
+    assert stats["memory_budget"] == 4096
+    assert stats["num_evictions"] == 1
+    assert stats["bytes_cached"] == 4096
+    res = vm["main"](inp)
+    assert vm.memory_stats()[tvm.cpu()]["num_device_allocs"] == 2
+    tvm.testing.assert_allclose(res.numpy(), inp.numpy() * 2, rtol=1e-7, atol=1e-7)
+
+
+@tvm.testing.requires_cuda
+def test_vm_budgeted_allocator_spill():
+    dtype = tvm.DataType("float32")
+    shape = (1024,)
+    ib = relax.ExecBuilder()
+    with ib.function("main", num_inputs=1):
+        # each storage takes a page, the third one exceeds the budget of two
+        for storage, tensor in [(1, 2), (3, 4), (5, 6)]:
+            ib.emit_call(
+                "vm.builtin.alloc_storage",
+                args=[ib.vm_state(), (4096,), ib.imm(0), dtype],
+                dst=ib.r(storage),
+            )
+            ib.emit_call(
+                "vm.builtin.alloc_tensor",
+                args=[ib.r(storage), ib.imm(0), shape, dtype],
+                dst=ib.r(tensor),
+            )
+            if tensor != 6:
+                ib.emit_call("test.vm.identity", args=[ib.r(0), ib.r(tensor)])
+        # the first two tensors are spilled in turn and reloaded when they are read
+        ib.emit_call("test.vm.identity", args=[ib.r(2), ib.r(6)])
+        ib.emit_call("test.vm.add", args=[ib.r(4), ib.r(6)], dst=ib.r(7))
+        ib.emit_ret(ib.r(7))
+    ex = ib.get()
+
+    dev = tvm.cuda()
+    vm = relax.VirtualMachine(ex, dev, memory_cfg="budgeted")
+    vm.set_memory_budget(dev, 8192, spill_threshold=0)
+    x_np = np.random.rand(*shape).astype(np.float32)
+    res = vm["main"](tvm.nd.array(x_np, dev))
+    tvm.testing.assert_allclose(res.numpy(), x_np * 2, rtol=1e-7, atol=1e-7)
+    stats = vm.memory_stats()[dev]
+    assert stats["num_spills"] >= 2
+    assert stats["num_reloads"] == 2
+    assert stats["peak_bytes_in_use"] <= 8192
+
+
+def test_vm_shape_specialization():
+    @tvm.script.ir_module
+    class TestVMShapeSpecialization:
+        @T.prim_func
+        def add(a: T.handle, b: T.handle):
+            T.func_attr({"global_symbol": "add"})
+            n = T.var("int32")
+            A = T.match_buffer(a, (n, 4), "float32")
+            B = T.match_buffer(b, (n, 4), "float32")
+            for i, j in T.grid(n, 4):
+                with T.block("add"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = A[vi, vj] + A[vi, vj]
+
+        @R.function
+        def main(x: Tensor((n, 4), "float32")):
+            gv = R.call_tir(add, (x,), (n, 4), dtype="float32")
+            return gv
+
+    mod = TestVMShapeSpecialization
+    spec_mod = relax.transform.SpecializeShapes("main", [[8, 4]])(mod)
+    assert "add_specialized" in [gv.name_hint for gv in spec_mod.get_global_vars()]
+
+    target = tvm.target.Target("llvm", host="llvm")
+    vm = relax.VirtualMachine(relax.vm.build(mod, target), tvm.cpu())
+    vm.enable_shape_specialization(mod, target, threshold=2, background=False)
+    inp = tvm.nd.array(np.random.rand(8, 4).astype(np.float32))
+    for _ in range(3):
+        res = vm["main"](inp)
+        tvm.testing.assert_allclose(res.numpy(), inp.numpy() * 2, rtol=1e-7, atol=1e-7)
+    stats = vm.specialization_stats()["main"]["8x4"]
+    assert stats["calls"] == 3 and stats["specialized"]
+
+
+def test_vm_dispatch_shape_buckets():
+    @tvm.script.ir_module
+    class TestVMShapeBuckets:
+        @T.prim_func
+        def add(a: T.handle, b: T.handle):
+            T.func_attr({"global_symbol": "add"})
+            n = T.var("int32")
+            A = T.match_buffer(a, (n, 4), "float32")
+            B = T.match_buffer(b, (n, 4), "float32")
+            for i, j in T.grid(n, 4):
+                with T.block("add"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = A[vi, vj] + A[vi, vj]
+
+        @R.function
+        def main(x: Tensor((n, 4), "float32")):
+            gv = R.call_tir(add, (x,), (n, 4), dtype="float32")
+            return gv
+
+    @T.prim_func
+    def add_small(a: T.handle, b: T.handle):
+        n = T.var("int32")
+        A = T.match_buffer(a, (n, 4), "float32")
+        B = T.match_buffer(b, (n, 4), "float32")
+        for i, j in T.grid(n, 4):
+            with T.block("add"):
+                vi, vj = T.axis.remap("SS", [i, j])
+                B[vi, vj] = A[vi, vj] * T.float32(3)
+
+    @T.prim_func
+    def add_16(A: T.Buffer[(16, 4), "float32"], B: T.Buffer[(16, 4), "float32"]):
+        for i, j in T.grid(16, 4):
+            with T.block("add"):
+                vi, vj = T.axis.remap("SS", [i, j])
+                B[vi, vj] = A[vi, vj] * T.float32(4)
+
+    # the variants compute different results to tell which one runs
+    mod = relax.transform.DispatchShapeBuckets(
+        {"add": [({"n": (1, 8)}, add_small), ({"n": 16}, add_16)]}
+    )(TestVMShapeBuckets)
+    names = [gv.name_hint for gv in mod.get_global_vars()]
+    for name in ["add_bucket0", "add_bucket0_cond", "add_bucket1", "add_bucket1_cond"]:
+        assert name in names
+
+    target = tvm.target.Target("llvm", host="llvm")
+    vm = relax.VirtualMachine(relax.vm.build(mod, target), tvm.cpu())
+    for n, scale in [(4, 3), (8, 3), (16, 4), (12, 2)]:
+        inp = tvm.nd.array(np.random.rand(n, 4).astype(np.float32))
+        res = vm["main"](inp)
+        tvm.testing.assert_allclose(res.numpy(), inp.numpy() * scale, rtol=1e-6, atol=1e-6)
+    with pytest.raises(tvm.TVMError):
+        relax.transform.DispatchShapeBuckets({"add": [({"m": 4}, add_16)]})(TestVMShapeBuckets)
+
+
+def test_vm_runtime_profile():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", [3, 4], relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x]):
+        gv = bb.emit_te(topi.add, x, x)
+        bb.emit_func_output(gv)
+    mod = bb.get()
+
+    target = tvm.target.Target("llvm", host="llvm")
+    ex = relax.vm.build(mod, target)
+    inp = tvm.nd.array(np.random.rand(3, 4).astype(np.float32))
+    vm = relax.VirtualMachine(ex, tvm.cpu(), memory_cfg="local_pooled")
+    vm.warmup("main", inp)
+    profile = vm.runtime_profile()
+    assert "add" in profile["functions"]
+    assert len(profile["devices"][0]["storage"]) > 0
+
+    from tvm.contrib import utils
+
+    path = utils.tempdir().relpath("exec.profile.json")
+    vm.save_runtime_profile(path)
+    new_vm = relax.VirtualMachine(ex, tvm.cpu(), memory_cfg="local_pooled")
+    new_vm.load_runtime_profile(path)
+    assert "add" in new_vm.func_table_stats()["resolved"]
+    num_allocs = new_vm.memory_stats()[tvm.cpu()]["num_device_allocs"]
+    assert num_allocs == len(profile["devices"][0]["storage"])
+    res = new_vm["main"](inp)
+    assert new_vm.memory_stats()[tvm.cpu()]["num_device_allocs"] == num_allocs
+    tvm.testing.assert_allclose(res.numpy(), inp.numpy() * 2, rtol=1e-7, atol=1e-7)
+
+
+def test_vm_static_storage_upper_bound():
+    bb = relax.BlockBuilder()
+    n = tir.Var("n", "int64")
+    x = relax.Var("x", [n, 16], relax.DynTensorType(2, "float32"))
+    with bb.function("main", [x]):
+        y = bb.emit_te(topi.add, x, x)
+        z = bb.emit_te(topi.multiply, y, y)
+        bb.emit_func_output(z)
+    mod = bb.get()
+    mod["main"] = mod["main"].with_attr("tir_var_upper_bound", {"n": 64})
+
+    target = tvm.target.Target("llvm", host="llvm")
+    ex = relax.vm.build(mod, target)
+    assert "vm.builtin.alloc_static_storage" in ex.as_text()
+    vm = relax.VirtualMachine(ex, tvm.cpu(), memory_cfg="local_pooled")
+    for rows in [64, 7, 33]:
+        data = tvm.nd.array(np.random.rand(rows, 16).astype(np.float32))
+        res = vm["main"](data)
+        tvm.testing.assert_allclose(res.numpy(), (data.numpy() * 2) ** 2, rtol=1e-6)
+
+    # the storage of y is sized for the upper bound and only allocated by the first call,
+    # every call then allocates its output
+    assert vm.memory_stats()[tvm.cpu()]["num_allocs"] == 4
+
+
 def test_vm_tuple():
     bb = relax.BlockBuilder()
     n = tir.Var("n", "int64")
@@ -972,6 +2167,79 @@ def test_recursion():
     tvm.testing.assert_allclose(res.numpy(), np.power(2.0, recursion_runs), rtol=1e-7, atol=1e-7)
 
 
+def test_tail_recursion_loop():
+    @tvm.script.ir_module
+    class TestVMTailRecursion:
+        @R.function
+        def loop(n: Tensor((1,), "float32"), acc: Tensor((1,), "float32")) -> Tensor:
+            cond = relax.call_packed(
+                "test.vm.equal_zero", n, type_args=(Tensor(ndim=1, dtype="float32"))
+            )
+            if cond:
+                res = acc
+            else:
+                new_acc = relax.call_packed(
+                    "test.vm.add", acc, n, type_args=(Tensor(ndim=1, dtype="float32"))
+                )
+                new_n = relax.call_packed(
+                    "test.vm.subtract_one", n, type_args=(Tensor(ndim=1, dtype="float32"))
+                )
+                res = loop(new_n, new_acc)
+            return res
+
+    target = tvm.target.Target("llvm", host="llvm")
+    ex = relax.vm.build(TestVMTailRecursion, target)
+    # The self tail call is a backward jump rather than a call.
+    assert re.search(r"goto\s+-\d+", ex.as_text())
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    num_iters = 1000
+    n = tvm.nd.array(np.array([num_iters], "float32"))
+    res = vm["loop"](n, tvm.nd.array(np.zeros(1, "float32")))
+    tvm.testing.assert_allclose(res.numpy(), [num_iters * (num_iters + 1) / 2])
+
+
+def test_mutual_tail_calls():
+    @tvm.script.ir_module
+    class TestVMMutualRecursion:
+        @R.function
+        def is_even(n: Tensor((1,), "float32")) -> Tensor:
+            cond = relax.call_packed(
+                "test.vm.equal_zero", n, type_args=(Tensor(ndim=1, dtype="float32"))
+            )
+            if cond:
+                res = relax.const(1.0)
+            else:
+                gv0 = relax.call_packed(
+                    "test.vm.subtract_one", n, type_args=(Tensor(ndim=1, dtype="float32"))
+                )
+                res = is_odd(gv0)
+            return res
+
+        @R.function
+        def is_odd(n: Tensor((1,), "float32")) -> Tensor:
+            cond = relax.call_packed(
+                "test.vm.equal_zero", n, type_args=(Tensor(ndim=1, dtype="float32"))
+            )
+            if cond:
+                res = relax.const(0.0)
+            else:
+                gv0 = relax.call_packed(
+                    "test.vm.subtract_one", n, type_args=(Tensor(ndim=1, dtype="float32"))
+                )
+                res = is_even(gv0)
+            return res
+
+    target = tvm.target.Target("llvm", host="llvm")
+    # With tail calls, the branches return the calls directly and the VM reuses the frame.
+    for tail_calls in [True, False]:
+        with tvm.transform.PassContext(config={"relax.VMCodeGen.tail_calls": tail_calls}):
+            ex = relax.vm.build(TestVMMutualRecursion, target)
+        vm = relax.VirtualMachine(ex, tvm.cpu())
+        for n in [0, 7, 500]:
+            res = vm["is_even"](tvm.nd.array(np.array([n], "float32")))
+            tvm.testing.assert_allclose(res.numpy(), 1.0 if n % 2 == 0 else 0.0)
+
+
 def test_vm_closure():
     @tvm.script.ir_module
     class TestClosure:
@@ -1227,6 +2495,24 @@ def test_save_function_time_evaluator():
     run_on_rpc(TestVMSetInput, save_function_time_evaluator_trial)
 
 
+def profile_trial(vm: relax.VirtualMachine, device: tvm.runtime.Device) -> None:
+    a = tvm.nd.array(np.random.rand(32, 32).astype("float32"), device)
+    b = tvm.nd.array(np.random.rand(32, 32).astype("float32"), device)
+    report = vm.profile("main", a, b)
+    assert report.configuration["Executor"] == "Relax VM"
+    assert len(report.calls) > 0
+    durations = report.diff(report)
+    assert durations and all(before == after for before, after in durations.values())
+
+
+def test_profile():
+    profile_trial(*make_vm(TestVMSetInput))
+
+
+def test_profile_rpc():
+    run_on_rpc(TestVMSetInput, profile_trial)
+
+
 # if you set an input, you should not be able to call statelessly
 @pytest.mark.xfail()
 def test_set_input_stateless_failure():
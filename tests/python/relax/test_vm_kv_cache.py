@@ -0,0 +1,91 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+from __future__ import annotations  # must import to defer parsing of annotations
+
+import numpy as np
+import pytest
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.runtime import ShapeTuple
+from tvm.script import relax as R
+
+
+def _builtin(name):
+    return tvm.get_global_func("vm.builtin.paged_kv_cache_" + name)
+
+
+def _create(num_pages=4, page_size=4, num_heads=2, head_dim=3):
+    pool = tvm.nd.empty((num_pages, 2, page_size, num_heads, head_dim), "float32")
+    return _builtin("create")(pool)
+
+
+def test_append_view_release():
+    cache = _create()
+    keys = [np.random.rand(n, 2, 3).astype("float32") for n in (5, 1, 2)]
+    values = [np.random.rand(n, 2, 3).astype("float32") for n in (5, 1, 2)]
+    for k, v in zip(keys, values):
+        _builtin("append")(cache, ShapeTuple([7]), tvm.nd.array(k), tvm.nd.array(v))
+    _builtin("append")(cache, ShapeTuple([8]), tvm.nd.array(keys[1]), tvm.nd.array(values[1]))
+    assert _builtin("length")(cache, ShapeTuple([7])) == 8
+    assert _builtin("num_free_pages")(cache) == 1
+
+    k, v = _builtin("view")(cache, ShapeTuple([7]))
+    tvm.testing.assert_allclose(k.numpy(), np.concatenate(keys))
+    tvm.testing.assert_allclose(v.numpy(), np.concatenate(values))
+
+    pool, tables, lengths = _builtin("page_tables")(cache, ShapeTuple([7, 8]))
+    assert tables.numpy().tolist() == [[0, 1], [2, -1]]
+    assert lengths.numpy().tolist() == [8, 1]
+    tvm.testing.assert_allclose(pool.numpy()[2, 0, 0], keys[1][0])
+
+    _builtin("release")(cache, ShapeTuple([7]))
+    assert _builtin("num_free_pages")(cache) == 3
+    with pytest.raises(tvm.TVMError, match="not in the cache"):
+        _builtin("view")(cache, ShapeTuple([7]))
+
+
+def test_out_of_pages():
+    cache = _create(num_pages=1)
+    keys = tvm.nd.array(np.zeros((5, 2, 3), "float32"))
+    with pytest.raises(tvm.TVMError, match="out of pages"):
+        _builtin("append")(cache, ShapeTuple([0]), keys, keys)
+
+
+@tvm.testing.requires_llvm
+def test_call_packed():
+    @tvm.script.ir_module
+    class Decode:
+        @R.function
+        def main(cache: Object, k: Tensor((1, 2, 3), "float32"), v: Tensor((1, 2, 3), "float32")):
+            cache1 = R.call_packed(
+                "vm.builtin.paged_kv_cache_append", cache, (0,), k, v, type_args=(Object)
+            )
+            kv = R.call_packed("vm.builtin.paged_kv_cache_view", cache1, (0,), type_args=(Object))
+            return kv
+
+    vm = relax.VirtualMachine(relax.vm.build(Decode, "llvm"), tvm.cpu())
+    cache = _create()
+    steps = [np.random.rand(1, 2, 3).astype("float32") for _ in range(6)]
+    for step in steps:
+        k, v = vm["main"](cache, tvm.nd.array(step), tvm.nd.array(step * 2))
+    tvm.testing.assert_allclose(k.numpy(), np.concatenate(steps))
+    tvm.testing.assert_allclose(v.numpy(), np.concatenate(steps) * 2)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -324,6 +324,61 @@ def test_reshape_nop():
     tvm.testing.assert_allclose(gmod.get_output(2).numpy(), z2_np)
 
 
+def _build_graph(mod, config):
+    with tvm.transform.PassContext(opt_level=0, config=config):
+        lib = relay.build(mod, "llvm")
+    return lib, json.loads(lib.get_graph_json())
+
+
+@tvm.testing.requires_llvm
+def test_plan_memory_inplace():
+    x = relay.var("x", shape=(10,))
+    z = x
+    for _ in range(4):
+        z = relay.exp(z)
+    mod = tvm.IRModule.from_expr(relay.Function([x], z))
+
+    _, graph_json = _build_graph(mod, {})
+    assert len(set(graph_json["attrs"]["storage_id"][1])) == 3
+
+    # every exp but the first one overwrites its input, the input of the graph is kept
+    lib, graph_json = _build_graph(mod, {"relay.GraphPlanMemory.inplace": True})
+    assert tuple(graph_json["attrs"]["storage_id"][1]) == (0, 1, 1, 1, 1)
+
+    x_data = np.random.rand(10).astype("float32")
+    gmod = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+    gmod.set_input(x=x_data)
+    gmod.run()
+    tvm.testing.assert_allclose(gmod.get_output(0).numpy(), np.exp(np.exp(np.exp(np.exp(x_data)))))
+    tvm.testing.assert_allclose(x_data, gmod.get_input(0).numpy())
+
+
+@tvm.testing.requires_llvm
+def test_plan_memory_arena():
+    x = relay.var("x", shape=(10,))
+    a = relay.exp(x)
+    b = relay.exp(a)
+    c = relay.exp(b)
+    z = relay.add(a, c)
+    mod = tvm.IRModule.from_expr(relay.Function([x], z))
+
+    lib, graph_json = _build_graph(mod, {"relay.GraphPlanMemory.arena": True})
+    # the input keeps its storage, all the other entries are packed into one arena
+    storage_ids = graph_json["attrs"]["storage_id"][1]
+    offsets = graph_json["attrs"]["storage_offset"][1]
+    assert tuple(storage_ids) == (0, 1, 1, 1, 1)
+    assert all(offset % 64 == 0 for offset in offsets)
+    # a is alive with b and c, so they are at other offsets, and c is the input of z
+    assert len({offsets[1], offsets[2], offsets[3], offsets[4]}) == 3
+
+    x_data = np.random.rand(10).astype("float32")
+    gmod = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+    gmod.set_input(x=x_data)
+    gmod.run()
+    a_np = np.exp(x_data)
+    tvm.testing.assert_allclose(gmod.get_output(0).numpy(), a_np + np.exp(np.exp(a_np)), rtol=1e-5)
+
+
 @tvm.testing.uses_gpu
 def test_gru_like():
     def unit(rnn_dim):
@@ -59,6 +59,39 @@ def test_pass_timing_instrument():
     assert profiles == ""
 
 
+
+def test_pass_timing_instrument_export():
+    import json
+
+    pass_timing = PassTimingInstrument(count_nodes=True)
+    with tvm.transform.PassContext(instruments=[pass_timing]):
+        mod = get_test_model()
+        with tvm.ir.instrument.pass_profile_scope("scope"):
+            mod = tvm.relay.transform.InferType()(mod)
+        mod = tvm.relay.transform.ToANormalForm()(mod)
+
+        rows = pass_timing.render_csv().strip().split("\n")
+        trace = json.loads(pass_timing.render_chrome_trace())
+
+    header = rows[0].split(",")
+    assert header[:3] == ["name", "depth", "parent"]
+    fields = {}
+    for row in rows[1:]:
+        fields.setdefault(row.split(",")[0], dict(zip(header, row.split(","))))
+    assert fields["scope"]["depth"] == "0"
+    assert fields["scope"]["nodes_before"] == "-1"
+    assert fields["InferType"]["parent"] == "scope"
+    assert int(fields["InferType"]["nodes_before"]) > 0
+    # A-normal form binds every intermediate to a let, so the module grows.
+    assert int(fields["ToANormalForm"]["nodes_after"]) > int(
+        fields["ToANormalForm"]["nodes_before"]
+    )
+    names = [event["name"] for event in trace["traceEvents"]]
+    assert names[0] == "scope"
+    assert "ToANormalForm" in names
+    assert all(event["ph"] == "X" for event in trace["traceEvents"])
+
+
 instrument_definition_type = tvm.testing.parameter("decorator", "subclass")
 
 
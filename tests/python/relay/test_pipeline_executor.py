@@ -265,6 +265,7 @@ def get_manual_conf(mods, target):
     pipe_config1 = {
         "mod_idx": 0,
         "cpu_affinity": "0",
+        "queue_capacity": 0,
         "output": [
             {"output_idx": 0, "dependencies": [{"mod_idx": 1, "input_name": "data_n_0"}]},
             {"output_idx": 1, "dependencies": [{"mod_idx": 2, "input_name": "data_n_2"}]},
@@ -284,6 +285,7 @@ def get_manual_conf(mods, target):
     pipe_config2 = {
         "mod_idx": 1,
         "cpu_affinity": "0",
+        "queue_capacity": 0,
         "output": [
             {"output_idx": 0, "dependencies": [{"mod_idx": 2, "input_name": "data_n_1"}]},
         ],
@@ -302,6 +304,7 @@ def get_manual_conf(mods, target):
     pipe_config3 = {
         "mod_idx": 2,
         "cpu_affinity": "0",
+        "queue_capacity": 2,
         "output": [{"output_idx": 0, "dependencies": [{"global_output_index": 0}]}],
     }
     mod_config[mods[2]] = {
@@ -524,6 +527,8 @@ def test_pipeline():
             pipe_config[mod3].target = "llvm"
             pipe_config[mod3].dev = tvm.cpu(0)
             pipe_config[mod3].cpu_affinity = "0"
+            # The outputs are read after all the runs, the last stage blocks on a full queue.
+            pipe_config[mod3].queue_capacity = 2
             # Checking the configuration of modules dependency.
             mconfig = pipe_config.get_config()
             assert mconfig["module_connection"] == get_manual_conf([mod1, mod2, mod3], target)
@@ -616,6 +621,12 @@ def test_pipeline():
 
                     assert pipeline_module_test.num_executing_pipeline == round + 1
 
+            statistics = pipeline_module_test.get_stage_statistics()
+            assert [stage["mod_idx"] for stage in statistics] == [0, 1, 2]
+            # The first stage runs in the calling thread.
+            assert statistics[0]["execution_count"] == len(datas)
+            assert all(0 <= stage["utilization"] <= 1 for stage in statistics)
+
             # Reset the cpu affinity after a test.
             reset_cpu_affinity(affinity)
 
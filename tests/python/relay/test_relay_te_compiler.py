@@ -21,6 +21,7 @@ import tvm.testing
 from tvm import relay
 from tvm import autotvm
 from tvm import topi
+from tvm.contrib import graph_executor, utils
 from tvm.relay.backend import te_compiler
 from tvm.relay.testing import run_infer_type
 from tvm.relay.testing.temp_op_attr import TempOpAttr
@@ -284,6 +285,31 @@ def test_compile_propogate_hash():
         assert "hash" in f.attrs.keys()
 
 
+
+def test_compile_kernel_cache_dir():
+    x = relay.var("x", shape=(4, 8))
+    y = relay.nn.relu(relay.add(x, relay.const(1.0)))
+    mod = tvm.IRModule.from_expr(relay.Function([x], relay.exp(y)))
+    cache_dir = utils.tempdir()
+    data = np.random.uniform(-1, 1, size=(4, 8)).astype("float32")
+
+    def build_and_run():
+        config = {"relay.backend.te_compiler_cache_dir": cache_dir.temp_dir}
+        with tvm.transform.PassContext(opt_level=3, config=config):
+            lib = relay.build(mod, "llvm")
+        module = graph_executor.GraphModule(lib["default"](tvm.cpu()))
+        module.run(x=data)
+        return module.get_output(0).numpy()
+
+    expected = np.exp(np.maximum(data + 1, 0))
+    tvm.testing.assert_allclose(build_and_run(), expected, rtol=1e-5)
+    cached = sorted(cache_dir.listdir())
+    assert cached and all(name.endswith(".json") for name in cached)
+    # the second build loads the lowered kernels instead of lowering them again
+    tvm.testing.assert_allclose(build_and_run(), expected, rtol=1e-5)
+    assert sorted(cache_dir.listdir()) == cached
+
+
 if __name__ == "__main__":
     test_get_valid_implementations()
     test_select_implementation()
@@ -293,3 +319,4 @@ if __name__ == "__main__":
     test_compile_tuple_dup()
     test_compile_full()
     test_compile_nhwc_pack()
+    test_compile_kernel_cache_dir()
@@ -242,6 +242,27 @@ def test_count_loop(target, dev):
     check_result(target, dev, [i_data], i_data, mod)
 
 
+def test_recursion_best_fit_allocator():
+    mod = tvm.IRModule({})
+    sum_up = relay.GlobalVar("sum_up")
+    i = relay.var("i", shape=[], dtype="int32")
+    sb = ScopeBuilder()
+    with sb.if_scope(relay.equal(i, relay.const(0, dtype="int32"))):
+        sb.ret(i)
+    with sb.else_scope():
+        one_less = relay.subtract(i, relay.const(1, dtype="int32"))
+        sb.ret(relay.add(relay.Call(sum_up, [one_less]), i))
+    mod[sum_up] = relay.Function([i], sb.get(), ret_type=relay.TensorType([], "int32"))
+    iarg = relay.var("i", shape=[], dtype="int32")
+    mod["main"] = relay.Function([iarg], sum_up(iarg))
+    exe = relay.vm.compile(mod, target="llvm")
+    vm = runtime.vm.VirtualMachine(exe, tvm.cpu(), memory_cfg="best_fit")
+    # the frames popped by the first calls are reused by the later ones
+    for n in [10, 3, 20]:
+        result = vm.invoke("main", np.array(n, dtype="int32"))
+        assert result.numpy() == n * (n + 1) // 2
+
+
 def test_sum_loop(target, dev):
     mod = tvm.IRModule({})
     sum_up = relay.GlobalVar("sum_up")
@@ -42,7 +42,7 @@ def with_tvm(lam, *args):
     return out_nd.numpy()
 
 
-def verify_einsum(subscripts, shapes):
+def verify_einsum(subscripts, shapes, optimize=False):
     ops = []
     for shape in shapes:
         tmp = np.random.uniform(low=-1.0, high=1.0, size=shape).astype(np.float32)
@@ -51,11 +51,15 @@ def verify_einsum(subscripts, shapes):
     c1 = np.einsum(subscripts, *ops)
 
     if len(ops) == 1:
-        c2 = with_tvm(lambda A: topi.einsum(subscripts, A), *ops)
+        c2 = with_tvm(lambda A: topi.einsum(subscripts, A, optimize=optimize), *ops)
     elif len(ops) == 2:
-        c2 = with_tvm(lambda A, B: topi.einsum(subscripts, A, B), *ops)
+        c2 = with_tvm(lambda A, B: topi.einsum(subscripts, A, B, optimize=optimize), *ops)
     elif len(ops) == 3:
-        c2 = with_tvm(lambda A, B, C: topi.einsum(subscripts, A, B, C), *ops)
+        c2 = with_tvm(lambda A, B, C: topi.einsum(subscripts, A, B, C, optimize=optimize), *ops)
+    elif len(ops) == 4:
+        c2 = with_tvm(
+            lambda A, B, C, D: topi.einsum(subscripts, A, B, C, D, optimize=optimize), *ops
+        )
 
     tvm.testing.assert_allclose(c1, c2, rtol=1e-5, atol=1e-5)
 
@@ -82,5 +86,36 @@ def test_einsum(equation, inputs):
     verify_einsum(equation, inputs)
 
 
+@pytest.mark.parametrize("optimize", ["greedy", "optimal"])
+@pytest.mark.parametrize(
+    "equation,inputs",
+    [
+        ("ij,jk->ik", [(2, 3), (3, 4)]),
+        ("ij,jk,km->im", [(2, 3), (3, 4), (4, 5)]),
+        ("bij,bjk->bki", [(2, 3, 4), (2, 4, 5)]),
+        ("ijk,jil->kl", [(3, 4, 5), (4, 3, 2)]),
+        ("ab,bc,cd,de->ea", [(4, 8), (8, 2), (2, 8), (8, 3)]),
+        ("ij,j,kl->ikl", [(3, 4), (4,), (5, 2)]),
+        ("ij,ik->", [(3, 4), (3, 5)]),
+        ("...ij,...jk->...ik", [(2, 3, 4), (2, 4, 5)]),
+    ],
+)
+def test_einsum_optimize(equation, inputs, optimize):
+    verify_einsum(equation, inputs, optimize)
+
+
+def test_einsum_path():
+    A = te.placeholder((10, 2), name="A")
+    B = te.placeholder((2, 100), name="B")
+    C = te.placeholder((100, 3), name="C")
+    for optimize in ["greedy", "optimal"]:
+        assert topi.einsum_path("ij,jk,kl->il", A, B, C, optimize=optimize) == [(1, 2), (0, 1)]
+    # An ellipsis is not contracted pairwise.
+    assert topi.einsum_path("...j,jk->...k", A, B) == []
+
+    out = topi.einsum("ij,jk->ik", A, B, optimize=True)
+    assert out.op.input_tensors[0].op.name == "T_einsum_matmul"
+
+
 if __name__ == "__main__":
     tvm.testing.main()
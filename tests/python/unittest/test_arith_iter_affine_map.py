@@ -112,6 +112,28 @@ def test_trivial():
     assert_iter_sum_failure([x, z], dom_map, check_level="bijective")
 
 
+def test_trivial_fast_path():
+    x = tvm.tir.Var("x", "int32")
+    y = tvm.tir.Var("y", "int32")
+    z = tvm.tir.Var("z", "int32")
+    dom_map = var_dom([(x, 3), (y, 4), (z, 1)])
+    # x + 0 is not of the pattern of the fast path, and goes through the general algorithm
+    for check_level in ["surjective", "bijective"]:
+        for simplify_trivial_iterators in [True, False]:
+            fast, slow = [
+                tvm.arith.detect_iter_map(
+                    indices,
+                    dom_map,
+                    check_level=check_level,
+                    simplify_trivial_iterators=simplify_trivial_iterators,
+                )
+                for indices in [[x, y, z, 3], [tvm.tir.Add(x, 0), y, z, 3]]
+            ]
+            assert len(fast.indices) == 4
+            tvm.ir.assert_structural_equal(fast.indices, slow.indices)
+            tvm.ir.assert_structural_equal(fast.padding_predicate, slow.padding_predicate)
+
+
 def test_fuse():
     x = tvm.tir.Var("x", "int32")
     y = tvm.tir.Var("y", "int32")
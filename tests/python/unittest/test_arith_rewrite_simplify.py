@@ -1002,5 +1002,28 @@ def test_if_then_else_simplify():
     ck.verify(z, tvm.tir.if_then_else(tvm.tir.LT(2, x), 1, 0))
 
 
+def test_simplify_cache():
+    x, y = te.var("x"), te.var("y")
+    ana = tvm.arith.Analyzer()
+    ana.enable_simplify_cache()
+    expr = tvm.te.max(x, 0)
+    tvm.ir.assert_structural_equal(ana.simplify(expr), expr)
+    tvm.ir.assert_structural_equal(ana.simplify(tvm.te.max(x, 0)), expr)
+    assert ana.simplify_cache_stats()["num_hits"] == 1
+    # a constraint scope does not see the results of the enclosing one, and restores them
+    with ana.constraint_scope(x >= 0):
+        tvm.ir.assert_structural_equal(ana.simplify(expr), x)
+    tvm.ir.assert_structural_equal(ana.simplify(expr), expr)
+    assert ana.simplify_cache_stats()["num_hits"] == 2
+    # binding a var drops the results
+    tvm.ir.assert_structural_equal(ana.simplify(x + y), x + y)
+    ana.bind(y, 3)
+    tvm.ir.assert_structural_equal(ana.simplify(x + y), x + 3)
+    with ana.constraint_scope(x >= 0):
+        ana.bind(x, y)
+    tvm.ir.assert_structural_equal(ana.simplify(tvm.te.max(x, 0)), tvm.tir.IntImm("int32", 3))
+    assert ana.simplify_cache_stats()["num_invalidations"] >= 1
+
+
 if __name__ == "__main__":
     pytest.main([__file__])
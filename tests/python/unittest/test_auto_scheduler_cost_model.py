@@ -79,6 +79,26 @@ def test_xgb_model():
     model.load(tmpfile)
 
 
+def test_batched_python_model():
+    task, inputs, _ = get_sample_records(10)
+    states = [x.state for x in inputs]
+
+    class RowCountModel(auto_scheduler.cost_model.PythonBasedModel):
+        def update(self, inputs, results):
+            pass
+
+        def predict_features(self, features, row_offsets):
+            feature_len = auto_scheduler.feature.DEFAULT_FEATURE_VEC_LEN
+            assert features.shape == (row_offsets[-1], feature_len)
+            return np.diff(row_offsets).astype("float32")
+
+    # The C++ side extracts the features and calls predict_features once for all the states.
+    scores = auto_scheduler._ffi_api.CostModelPredict(RowCountModel(), task, states)
+    features = auto_scheduler.feature.get_per_store_features_from_states(states, task)
+    assert [x.value for x in scores] == [float(len(x)) for x in features]
+
+
 if __name__ == "__main__":
     test_random_model()
     test_xgb_model()
+    test_batched_python_model()
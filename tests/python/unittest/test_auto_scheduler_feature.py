@@ -20,6 +20,8 @@
 import math
 import tempfile
 
+import numpy as np
+
 import tvm
 from tvm import te, auto_scheduler, relay
 from tvm.script import tir as T
@@ -92,6 +94,24 @@ def test_cpu_matmul():
     assert fequal(fea_dict["parallel_prod"], math.log2((512 * 512 / 16 / 8) + 1))
 
 
+def test_cpu_matmul_flatten():
+    dag = auto_scheduler.ComputeDAG(matmul_auto_scheduler_test(64, 64, 64))
+    s0 = dag.get_init_state()
+    s1 = dag.get_init_state()
+    C = s1.stage_ops[2]
+    i, j, k = s1[C].iters
+    s1.split(C, i, [16])
+
+    target = tvm.target.Target("llvm")
+    task = auto_scheduler.SearchTask(compute_dag=dag, workload_key="test", target=target)
+    features = auto_scheduler.feature.get_per_store_features_from_states([s0, s1], task)
+    flat, row_offsets = auto_scheduler.feature.get_per_store_features_from_states_flatten(
+        [s0, s1], task
+    )
+    assert list(row_offsets) == [0, len(features[0]), len(features[0]) + len(features[1])]
+    np.testing.assert_allclose(flat, np.concatenate(features), rtol=1e-6)
+
+
 def test_cpu_fusion():
     def fusion_test(N, M):
         A = te.placeholder((N, M), name="A")
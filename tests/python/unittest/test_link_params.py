@@ -23,6 +23,7 @@ from contextlib import redirect_stderr
 from io import StringIO
 
 import numpy as np
+import pytest
 import tvm
 import tvm.relay
 import tvm.testing
@@ -328,6 +329,40 @@ def test_c_link_params(linkable_dtype):
         np.testing.assert_allclose(unlinked_output.numpy(), linked_output.numpy())
 
 
+@pytest.mark.parametrize("target", [pytest.param("llvm", marks=tvm.testing.requires_llvm), "c"])
+def test_link_params_as_blob(target):
+    temp_dir = utils.tempdir()
+    mod, param_init = _make_mod_and_params("float32")
+    rand_input = _make_random_tensor("float32", INPUT_SHAPE)
+    config = {"tir.disable_vectorize": True}
+
+    def _run(lib, name, **params):
+        # Need a unique name per library to avoid dlopen caching the lib load.
+        lib_path = temp_dir.relpath(f"test-{target}-{name}.so")
+        lib.export_library(lib_path)
+        lib_mod = tvm.runtime.load_module(lib_path)
+        graph_rt = tvm.contrib.graph_executor.GraphModule(lib_mod["default"](tvm.cpu(0)))
+        graph_rt.set_input("rand_input", rand_input, **params)
+        graph_rt.run()
+        return graph_rt.get_output(0).numpy()
+
+    executor = Executor("graph", {"link-params": True})
+    with tvm.transform.PassContext(
+        opt_level=3, config={**config, "codegen.link_params_as_blob": True}
+    ):
+        lib = tvm.relay.build(mod, target, executor=executor, params=param_init)
+    assert len(lib.params.keys()) == 0  # NOTE: params became tir.constants
+    if target == "c":
+        src = lib.lib.get_source()
+        assert re.search(r"unsigned char .* [a-zA-Z_0-9]*constant_\d+_bytes\[\d+\] =$", src, re.M)
+    linked_output = _run(lib, "blob")
+
+    with tvm.transform.PassContext(opt_level=3, config=config):
+        lib = tvm.relay.build(mod, target, params=param_init)
+    unlinked_output = _run(lib, "unlinked", **lib.params)
+    np.testing.assert_allclose(unlinked_output, linked_output)
+
+
 @tvm.testing.requires_micro
 def test_crt_link_params(linkable_dtype):
     from tvm import micro
@@ -26,6 +26,7 @@ from typing import List
 import numpy as np
 import tvm
 import tvm.testing
+from tvm import meta_schedule as ms
 from tvm.meta_schedule.cost_model import PyCostModel, RandomModel, XGBModel
 from tvm.meta_schedule.cost_model.xgb_model import PackSum, _get_custom_call_back
 from tvm.meta_schedule.feature_extractor import RandomFeatureExtractor
@@ -231,6 +232,37 @@ def test_meta_schedule_xgb_model_reupdate():
     model.predict(TuneContext(), [_dummy_candidate() for i in range(predict_sample_count)])
 
 
+def test_meta_schedule_xgb_model_pretrain():
+    database = ms.database.MemoryDatabase()
+    workload = database.commit_workload(Matmul)
+    trace = Schedule(Matmul).trace
+    num_records = 20
+    for i in range(num_records):
+        database.commit_tuning_record(
+            ms.database.TuningRecord(
+                trace,
+                workload,
+                [float(i + 1)],
+                tvm.target.Target("llvm"),
+                ms.arg_info.ArgInfo.from_prim_func(func=Matmul["main"]),
+            )
+        )
+    model = XGBModel(extractor=RandomFeatureExtractor(), num_warmup_samples=10)
+    model.pretrain(database, max_records_per_workload=15)
+    assert model.data_size == 15
+    assert model.booster is not None
+    group = list(model.data.values())[0]
+    assert group.min_cost == 1.0
+    # The pre-trained data is fine-tuned with the results measured afterwards.
+    model.update(
+        TuneContext(),
+        [_dummy_candidate() for i in range(10)],
+        [_dummy_result() for i in range(10)],
+    )
+    assert model.data_size == 25
+    model.predict(TuneContext(), [_dummy_candidate() for i in range(10)])
+
+
 def xgb_version_check():
 
     # pylint: disable=import-outside-toplevel
@@ -25,7 +25,8 @@ import tvm.testing
 from tvm.target import Target
 from tvm import meta_schedule as ms
 from tvm.meta_schedule.database import TuningRecord, Workload
-from tvm import tir
+from tvm import te, tir
+from tvm.meta_schedule.testing import te_workload
 from tvm.ir.module import IRModule
 from tvm.script import tir as T
 from tvm.tir import Schedule
@@ -413,6 +414,120 @@ def test_meta_schedule_database_reload():
             _equal_record(ret[1], records[2])
 
 
+def test_meta_schedule_indexed_database():
+    mod: IRModule = Matmul
+    with tempfile.TemporaryDirectory() as tmpdir:
+        # Records written by JSONDatabase are indexed when the table is first opened.
+        json_database = _create_tmp_database(tmpdir)
+        token = json_database.commit_workload(mod)
+        trace = _create_schedule(mod, _schedule_matmul).trace
+        records = [
+            ms.database.TuningRecord(
+                trace,
+                token,
+                run_secs,
+                tvm.target.Target(target),
+                ms.arg_info.ArgInfo.from_prim_func(func=mod["main"]),
+            )
+            for run_secs, target in [
+                ([7.0, 8.0, 9.0], "llvm"),
+                ([1.0, 2.0, 3.0], "llvm"),
+                ([4.0, 5.0, 6.0], "llvm -num-cores=4"),
+            ]
+        ]
+        for record in records[:2]:
+            json_database.commit_tuning_record(record)
+        database = ms.database.IndexedDatabase(
+            path_workload=json_database.path_workload,
+            path_tuning_record=json_database.path_tuning_record,
+        )
+        assert len(database) == 2
+        database.commit_tuning_record(records[2])
+        # The appended record is in the table, readable by JSONDatabase, and in the index.
+        reloaded = ms.database.JSONDatabase(
+            path_workload=json_database.path_workload,
+            path_tuning_record=json_database.path_tuning_record,
+        )
+        assert len(reloaded) == 3
+        database = ms.database.IndexedDatabase(
+            path_workload=json_database.path_workload,
+            path_tuning_record=json_database.path_tuning_record,
+        )
+        assert len(database) == 3
+        token = database.commit_workload(mod)
+        ret = database.get_top_k(token, 2)
+        assert len(ret) == 2
+        _equal_record(ret[0], records[1])
+        _equal_record(ret[1], records[2])
+        _equal_record(database.get_all_tuning_records()[2], records[0])
+        ret = database.query_tuning_record(mod, tvm.target.Target("llvm -num-cores=4"), "main")
+        _equal_record(ret, records[2])
+        ret = database.query_tuning_record(mod, tvm.target.Target("cuda"), "main")
+        _equal_record(ret, records[1])
+
+
+def test_meta_schedule_database_concurrent():
+    def _commit(database, mod: IRModule, run_sec: float):
+        database.commit_tuning_record(
+            ms.database.TuningRecord(
+                Schedule(mod).trace,
+                database.commit_workload(mod),
+                [run_sec],
+                tvm.target.Target("llvm"),
+                ms.arg_info.ArgInfo.from_prim_func(func=mod["main"]),
+            )
+        )
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        db_1 = ms.database.JSONDatabase(work_dir=tmpdir, concurrent=True)
+        db_2 = ms.database.JSONDatabase(work_dir=tmpdir, concurrent=True)
+        _commit(db_1, Matmul, 1.0)
+        # The workloads committed by either database keep a consistent index in the tables
+        _commit(db_2, MatmulRelu, 2.0)
+        _commit(db_1, Matmul, 3.0)
+        for database in [db_1, db_2, ms.database.JSONDatabase(work_dir=tmpdir)]:
+            assert len(database) == 3
+            for mod, run_secs in [(Matmul, [1.0, 3.0]), (MatmulRelu, [2.0])]:
+                records = database.get_top_k(database.commit_workload(mod), 5)
+                assert [float(record.run_secs[0]) for record in records] == run_secs
+                assert tvm.ir.structural_equal(records[0].workload.mod, mod)
+
+
+def test_meta_schedule_database_nearest():
+    def _matmul(n: int) -> IRModule:
+        func = te.create_prim_func(te_workload.matmul(n, n, n))
+        return IRModule({"main": func.with_attr("global_symbol", "main")})
+
+    def _tile(sch: Schedule):
+        i, _, _ = sch.get_loops(sch.get_block("C"))
+        sch.split(i, factors=sch.sample_perfect_tile(i, n=2))
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        for database in [
+            _create_tmp_database(tmpdir),
+            ms.database.IndexedDatabase(work_dir=tmpdir),
+        ]:
+            for n, run_secs in [(128, [2.0]), (130, [1.0]), (256, [3.0])]:
+                mod = _matmul(n)
+                database.commit_tuning_record(
+                    TuningRecord(
+                        _create_schedule(mod, _tile).trace,
+                        database.commit_workload(mod),
+                        run_secs,
+                        Target("llvm"),
+                        ms.arg_info.ArgInfo.from_prim_func(func=mod["main"]),
+                    )
+                )
+            database.commit_workload(MatmulRelu)
+            ret = database.get_top_k_nearest(_matmul(250), 2)
+            # The records of the closest shapes come first, regardless of their running time.
+            assert [float(record.run_secs[0]) for record in ret] == [3.0, 1.0]
+            assert len(database.get_top_k_nearest(_matmul(128), 5)) == 2
+            assert not database.get_top_k_nearest(MatmulRelu, 5)
+            sch = Schedule(_matmul(250))
+            ret[0].trace.apply_to_schedule(sch, remove_postproc=False)
+
+
 def test_meta_schedule_database_union():
     mod: IRModule = Matmul
     target = tvm.target.Target("llvm")
@@ -1610,5 +1610,33 @@ def test_negative_extent():
     assert named_features["B0.unique_bytes"] == 0
 
 
+def test_extract_batch():
+    def _create_schedule(n):
+        def _create():
+            sch = tir.Schedule(matmul, debug_mask="all")
+            i, _, _ = sch.get_loops(sch.get_block("C"))
+            sch.split(i, factors=[None, n])
+            return sch
+
+        return _create
+
+    extractor = ms.feature_extractor.PerStoreFeature()
+    context = _make_context(tvm.target.Target("llvm"))
+    candidates = [_make_candidate(_create_schedule(n)) for n in [4, 8, 16]]
+    candidates.append(_make_candidate(lambda: tir.Schedule(LayoutTransform)))
+    features, row_offsets = extractor.extract_batch(context, candidates)
+    expected = extractor.extract_from(context, candidates)
+    row_offsets = row_offsets.numpy()
+    assert features.dtype == "float32"
+    assert features.shape == (sum(x.shape[0] for x in expected), N_FEATURES)
+    assert row_offsets.tolist()[-1] == features.shape[0]
+    for i, feature in enumerate(expected):
+        assert_allclose(
+            actual=features.numpy()[row_offsets[i] : row_offsets[i + 1]],
+            desired=feature.numpy(),
+            rtol=1e-6,
+        )
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -161,6 +161,32 @@ def test_vectorize_inner_loop():
     tvm.ir.assert_structural_equal(sch.mod["main"], after_matmul_vectorize)
 
 
+def test_scalable_vectorize_symbolic_extent():
+    @T.prim_func
+    def add_one(a: T.handle, b: T.handle) -> None:
+        T.func_attr({"global_symbol": "main"})
+        n = T.var("int32")
+        A = T.match_buffer(a, [n], dtype="float32")
+        B = T.match_buffer(b, [n], dtype="float32")
+        with T.block("root"):
+            T.block_attr(
+                {"meta_schedule.vectorize": 64, "meta_schedule.scalable_vectorize": 1}
+            )
+            for i in T.serial(n):
+                with T.block("add"):
+                    vi = T.axis.spatial(n, i)
+                    B[vi] = A[vi] + T.float32(1)
+
+    sch = Schedule(add_one)
+    assert RewriteParallelVectorizeUnroll().apply(sch)
+    (loop,) = sch.get_loops(sch.get_block("add"))
+    loop = sch.get(loop)
+    assert loop.kind == tvm.tir.ForKind.SERIAL
+    assert loop.annotations["scalable_vectorize"] == 1
+    assert "meta_schedule.scalable_vectorize" not in sch.get(sch.get_block("root")).annotations
+
+
 if __name__ == "__main__":
     test_meta_schedule_postproc_rewrite_parallel_unroll_vectorize()
     test_vectorize_inner_loop()
+    test_scalable_vectorize_symbolic_extent()
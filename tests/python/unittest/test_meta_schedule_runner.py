@@ -19,12 +19,14 @@
 import itertools
 import sys
 import time
+from types import SimpleNamespace
 from typing import Any, List
 
 import numpy as np
 import pytest
 import tvm
 import tvm.testing
+from tvm import meta_schedule as ms
 from tvm._ffi import register_func
 from tvm.meta_schedule.arg_info import TensorInfo
 from tvm.meta_schedule.builder import BuilderInput, LocalBuilder
@@ -47,6 +49,7 @@ from tvm.meta_schedule.runner.rpc_runner import (
 from tvm.meta_schedule.runner.rpc_runner import (
     default_alloc_argument as rpc_default_alloc_argument,
 )
+from tvm.meta_schedule.runner.utils import cache_flush_preproc, run_evaluator_common
 from tvm.meta_schedule.testing.local_rpc import LocalRPC
 from tvm.meta_schedule.utils import (
     derived_object,
@@ -56,7 +59,7 @@ from tvm.rpc import RPCSession
 from tvm.runtime import Device, Module
 from tvm.script import tir as T
 from tvm.target import Target
-from tvm.tir import FloatImm
+from tvm.tir import FloatImm, Schedule
 
 MATMUL_N = 16
 MATMUL_M = 32
@@ -295,6 +298,61 @@ def test_meta_schedule_rpc_multiple_runs():
         _clean_build(builder_result.artifact_path)
 
 
+@pytest.mark.parametrize("cache_arguments", [False, True])
+def test_meta_schedule_rpc_batched_runs(cache_arguments):
+    """Test meta schedule rpc runner measuring the candidates by batches"""
+    mods = [MatmulModule, MatmulReluModule, BatchMatmulModule]
+    builder = LocalBuilder()
+    builder_results = builder.build([BuilderInput(mod, Target("llvm")) for mod in mods])
+    for builder_result in builder_results:
+        assert builder_result.error_msg is None
+    matmul_args = [TensorInfo("float32", (MATMUL_N, MATMUL_N)) for _ in range(3)]
+    batch_matmul_args = [TensorInfo("float32", [16, MATMUL_M, MATMUL_M]) for _ in range(3)]
+    runner_inputs = [
+        RunnerInput(builder_result.artifact_path, "llvm", args_info)
+        for builder_result, args_info in zip(
+            builder_results, [matmul_args, matmul_args, batch_matmul_args]
+        )
+    ]
+
+    with LocalRPC() as rpc:
+        rpc_config = RPCConfig(
+            tracker_host=rpc.tracker_host,
+            tracker_port=rpc.tracker_port,
+            tracker_key=rpc.tracker_key,
+            session_priority=1,
+            session_timeout_sec=100,
+        )
+        evaluator_config = EvaluatorConfig(
+            number=1,
+            repeat=2,
+            min_repeat_ms=0,
+            enable_cpu_cache_flush=True,
+        )
+        runner = RPCRunner(
+            rpc_config,
+            evaluator_config,
+            alloc_repeat=2,
+            batch_size=2,
+            cache_arguments=cache_arguments,
+        )
+        runner_futures = runner.run(runner_inputs)
+        runner_results = [runner_future.result() for runner_future in runner_futures]
+
+    assert len(runner_results) == 3
+    for runner_result in runner_results:
+        assert runner_result.error_msg is None
+        # alloc_repeat * repeat costs
+        assert len(runner_result.run_secs) == 4
+        for result in runner_result.run_secs:
+            if isinstance(result, FloatImm):
+                result = result.value
+            assert result >= 0.0
+
+    for builder_result in builder_results:
+        _clean_build(builder_result.artifact_path)
+
+
 def test_meta_schedule_local_multiple_runs():
     """Test meta schedule local runner for multiple runs"""
     # Build the module
@@ -889,5 +947,60 @@ def test_meta_schedule_local_runner_add_test():
     _clean_build(builder_result.artifact_path)
 
 
+def test_meta_schedule_runner_adaptive_evaluator():
+    class FakeModule:
+        entry_name = "main"
+
+        def __init__(self, costs: List[float]):
+            self.costs = iter(costs)
+
+        def time_evaluator(self, repeat: int, max_repeat=None, **_kwargs):
+            if max_repeat is not None:
+                # the statistical mode, here precise enough after its minimal repeats
+                results = list(itertools.islice(self.costs, max(repeat, 2)))
+                return lambda *_args: SimpleNamespace(results=results)
+            assert repeat == 1
+            return lambda *_args: SimpleNamespace(results=[next(self.costs)])
+
+    class FakeDevice:
+        device_type = 1
+
+        def sync(self):
+            pass
+
+    def _measure(costs: List[float], best_cost=None) -> List[float]:
+        evaluator_config = EvaluatorConfig(
+            number=1, repeat=1, min_repeat_ms=0, max_repeat=10, best_cost=best_cost
+        )
+        return run_evaluator_common(FakeModule(costs), FakeDevice(), evaluator_config, [[]])
+
+    # Precise enough after the minimal two repeats
+    assert _measure([1.0] * 10) == [1.0, 1.0]
+    # Statistically slower than the best candidate
+    assert _measure([2.0, 2.01] * 5, best_cost=1.0) == [2.0, 2.01]
+    # Noisy and close to the best candidate: measured up to `max_repeat`
+    assert len(_measure([1.0, 1.5] * 5, best_cost=1.2)) == 10
+    record = ms.database.TuningRecord(
+        Schedule(MatmulModule).trace,
+        ms.database.Workload(MatmulModule),
+        [1.0, 1.5],
+    )
+    assert record.run_secs_variance() == pytest.approx(0.125)
+
+
+
+def test_meta_schedule_runner_cache_flush_preproc():
+    cpu_flush = EvaluatorConfig(enable_cpu_cache_flush=True)
+    gpu_flush = EvaluatorConfig(enable_gpu_cache_flush=True)
+    assert cache_flush_preproc(cpu_flush, tvm.cpu()) == "cache_flush_cpu_non_first_arg"
+    assert cache_flush_preproc(gpu_flush, tvm.cpu()) == ""
+    assert cache_flush_preproc(cpu_flush, tvm.cuda()) == ""
+    assert cache_flush_preproc(gpu_flush, tvm.cuda()) == "cache_flush_cuda_l2"
+    assert cache_flush_preproc(gpu_flush, tvm.rocm()) == "cache_flush_rocm_l2"
+    # the remote devices are flushed on the server
+    remote_cuda = tvm.cuda()
+    remote_cuda.device_type += tvm.rpc.base.RPC_SESS_MASK
+    assert cache_flush_preproc(gpu_flush, remote_cuda) == "cache_flush_cuda_l2"
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -964,6 +964,32 @@ def test_padded_matmul_relu():
     )
 
 
+def test_padded_matmul_dynamic_m():
+    @T.prim_func
+    def matmul_dynamic_m(a: T.handle, b: T.handle, c: T.handle) -> None:
+        m = T.var("int32")
+        A = T.match_buffer(a, (m, 128), "float16")
+        B = T.match_buffer(b, (128, 128), "float16")
+        C = T.match_buffer(c, (m, 128), "float32")
+        for i, j, k in T.grid(m, 128, 128):
+            with T.block("C"):
+                vi, vj, vk = T.axis.remap("SSR", [i, j, k])
+                with T.init():
+                    C[vi, vj] = T.float32(0)
+                C[vi, vj] = C[vi, vj] + T.cast(A[vi, vk], "float32") * T.cast(B[vk, vj], "float32")
+
+    (sch,) = generate_design_space(
+        kind="cuda",
+        mod=matmul_dynamic_m,
+        target=tvm.target.Target("cuda"),
+        types=None,
+        sch_rules=[multi_level_tiling_tensor_core(write_reuse_scope="shared")],
+    )
+    # The dynamic extent is padded to a multiple of the intrinsic shape and then tensorized
+    assert any(inst.kind.name == "PadEinsum" for inst in sch.trace.insts)
+    assert "meta_schedule.auto_tensorize" in sch.mod.script()
+
+
 def test_conv_1x1():
     # fmt: off
     @T.prim_func
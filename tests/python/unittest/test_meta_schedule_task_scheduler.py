@@ -15,7 +15,10 @@
 # specific language governing permissions and limitations
 # under the License.
 """ Test Meta Schedule Task Scheduler """
+import json
+import os.path as osp
 import random
+import tempfile
 import weakref
 from typing import Set
 
@@ -174,6 +177,155 @@ def test_meta_schedule_task_scheduler_single():
     assert len(database) == max_trials_per_task
 
 
+def test_meta_schedule_task_scheduler_pipeline():
+    @ms.utils.derived_object
+    class CountingBuilder(ms.builder.PyBuilder):
+        def __init__(self):
+            super().__init__()
+            self.batch_sizes = []
+
+        def build(self, build_inputs):
+            self.batch_sizes.append(len(build_inputs))
+            return DummyBuilder().build(build_inputs)
+
+    max_trials_per_task = 10
+    builder = CountingBuilder()
+    database = ms.database.MemoryDatabase()
+    round_robin = ms.task_scheduler.RoundRobin()
+    round_robin.set_pipeline(4, max_unmeasured_candidates=4)
+    assert round_robin.pipeline_chunk_size == 4
+    round_robin.tune(
+        [
+            ms.TuneContext(
+                MatmulModule,
+                target=tvm.target.Target("llvm"),
+                space_generator=_schedule_matmul,
+                search_strategy=ms.search_strategy.ReplayTrace(),
+                task_name="Test",
+                rand_state=42,
+            )
+        ],
+        [1.0],
+        max_trials_global=max_trials_per_task,
+        max_trials_per_task=max_trials_per_task,
+        num_trials_per_iter=10,
+        builder=builder,
+        runner=DummyRunner(),
+        database=database,
+        measure_callbacks=[ms.measure_callback.AddToDatabase()],
+        cost_model=None,
+    )
+    assert builder.batch_sizes == [4, 4, 2]
+    assert len(database) == max_trials_per_task
+
+
+def test_meta_schedule_task_scheduler_measure_cache():
+    @ms.utils.derived_object
+    class CountingBuilder(ms.builder.PyBuilder):
+        def __init__(self):
+            super().__init__()
+            self.num_built = 0
+
+        def build(self, build_inputs):
+            self.num_built += len(build_inputs)
+            return DummyBuilder().build(build_inputs)
+
+    def _tune(cache_path: str) -> CountingBuilder:
+        builder = CountingBuilder()
+        database = ms.database.MemoryDatabase()
+        round_robin = ms.task_scheduler.RoundRobin()
+        round_robin.set_measure_cache(cache_path)
+        round_robin.tune(
+            [
+                ms.TuneContext(
+                    MatmulModule,
+                    target=tvm.target.Target("llvm"),
+                    space_generator=_schedule_matmul,
+                    search_strategy=ms.search_strategy.ReplayTrace(),
+                    task_name="Test",
+                    rand_state=42,
+                )
+            ],
+            [1.0],
+            max_trials_global=10,
+            max_trials_per_task=10,
+            num_trials_per_iter=10,
+            builder=builder,
+            runner=DummyRunner(),
+            database=database,
+            measure_callbacks=[ms.measure_callback.AddToDatabase()],
+            cost_model=None,
+        )
+        assert len(database) == 10
+        return builder
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        cache_path = osp.join(tmpdir, "measure_cache.json")
+        assert _tune(cache_path).num_built == 10
+        assert osp.exists(cache_path)
+        # The same candidates are proposed again in the next session, and come from the cache
+        assert _tune(cache_path).num_built == 0
+
+
+def test_meta_schedule_task_scheduler_stopping():
+    @ms.utils.derived_object
+    class ConstantRunnerFuture(ms.runner.PyRunnerFuture):
+        def done(self) -> bool:
+            return True
+
+        def result(self) -> ms.runner.RunnerResult:
+            return ms.runner.RunnerResult([1.0], None)
+
+    @ms.utils.derived_object
+    class ConstantRunner(ms.runner.PyRunner):
+        def run(self, runner_inputs):
+            return [ConstantRunnerFuture() for _ in runner_inputs]
+
+    def _tune(log_path: str, max_tuning_time_sec: float, convergence_window: int):
+        database = ms.database.MemoryDatabase()
+        round_robin = ms.task_scheduler.RoundRobin()
+        round_robin.set_stopping(
+            max_tuning_time_sec=max_tuning_time_sec,
+            convergence_window=convergence_window,
+            convergence_threshold=0.0,
+            log_path=log_path,
+        )
+        round_robin.tune(
+            [
+                ms.TuneContext(
+                    MatmulModule,
+                    target=tvm.target.Target("llvm"),
+                    space_generator=_schedule_matmul,
+                    search_strategy=ms.search_strategy.ReplayTrace(),
+                    task_name="Test",
+                    rand_state=42,
+                )
+            ],
+            [1.0],
+            max_trials_global=20,
+            max_trials_per_task=20,
+            num_trials_per_iter=2,
+            builder=DummyBuilder(),
+            runner=ConstantRunner(),
+            database=database,
+            measure_callbacks=[ms.measure_callback.AddToDatabase()],
+            cost_model=None,
+        )
+        with open(log_path, "r", encoding="utf-8") as log_file:
+            decisions = [json.loads(line) for line in log_file]
+        return len(database), decisions
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        # The latency never improves, so the task stops once the window is filled
+        num_records, decisions = _tune(osp.join(tmpdir, "converged.json"), 0.0, 3)
+        assert num_records == 4
+        assert [d[:3] for d in decisions] == [["Test", "converged", 4]]
+        # The budget is spent before the first batch
+        num_records, decisions = _tune(osp.join(tmpdir, "time_budget.json"), 1e-9, 0)
+        assert num_records == 0
+        assert [d[:2] for d in decisions] == [["*", "time_budget"]]
+
+
 def test_meta_schedule_task_scheduler_multiple():
     num_trials_per_iter = 6
     max_trials_per_task = 101
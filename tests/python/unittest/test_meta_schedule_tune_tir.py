@@ -23,6 +23,8 @@ import pytest
 import tvm
 import tvm.testing
 from tvm import meta_schedule as ms
+from tvm import te
+from tvm.meta_schedule.testing import te_workload
 from tvm.meta_schedule.testing.custom_builder_runner import run_module_via_rpc
 from tvm.meta_schedule.testing.local_rpc import LocalRPC
 from tvm.script import tir as T
@@ -178,8 +180,113 @@ def test_tune_block_cpu():
         sch.trace.show()
 
 
+def _dynamic_matmul() -> tvm.tir.PrimFunc:
+    n = te.var("n")
+    return te.create_prim_func(te_workload.matmul(n, 64, 64))
+
+
+def test_sample_shape_values():
+    samples = ms.tir_integration.sample_shape_values({"n": (1, 1024)}, 5)
+    assert samples == [{"n": 1}, {"n": 6}, {"n": 32}, {"n": 181}, {"n": 1024}]
+    assert ms.tir_integration.sample_shape_values({"n": (4, 5)}, 4) == [{"n": 4}, {"n": 5}]
+
+
+def test_specialize_shape_vars():
+    mod = ms.tir_integration.specialize_shape_vars(_dynamic_matmul(), {"n": 32})
+    tvm.ir.assert_structural_equal(
+        mod["main"].with_attr("global_symbol", "main"),
+        te.create_prim_func(te_workload.matmul(32, 64, 64)).with_attr("global_symbol", "main"),
+    )
+    with pytest.raises(ValueError):
+        ms.tir_integration.specialize_shape_vars(_dynamic_matmul(), {"m": 32})
+
+
+def test_compile_tir_dynamic():
+    func = _dynamic_matmul()
+    target = Target("llvm")
+    samples = [{"n": 64}, {"n": 512}]
+    database = ms.database.MemoryDatabase()
+    traces = []
+    for factor, run_secs in [(16, [1.0, 3.0]), (32, [2.0, 1.0])]:
+        for values, sec in zip(samples, run_secs):
+            mod = ms.tir_integration.specialize_shape_vars(func, values)
+            sch = Schedule(mod)
+            i, _, _ = sch.get_loops(sch.get_block("C"))
+            sch.split(i, factors=[None, factor])
+            database.commit_tuning_record(
+                ms.database.TuningRecord(
+                    sch.trace,
+                    database.commit_workload(mod),
+                    [sec],
+                    target,
+                    ms.arg_info.ArgInfo.from_prim_func(mod["main"]),
+                )
+            )
+        traces.append(str(sch.trace))
+    # A single schedule: the one with the smallest total slowdown over the samples
+    dispatch = ms.tir_integration.compile_tir_dynamic(database, func, target, samples)
+    assert [values for values, _ in dispatch] == samples
+    assert [str(sch.trace) for _, sch in dispatch] == [traces[1], traces[1]]
+    # A dispatch set: each sample gets its own best schedule
+    dispatch = ms.tir_integration.compile_tir_dynamic(
+        database, func, target, samples, max_dispatch=2
+    )
+    assert [str(sch.trace) for _, sch in dispatch] == traces
+    # The frequency of the samples decides which schedule is robust
+    dispatch = ms.tir_integration.compile_tir_dynamic(
+        database, func, target, samples, sample_weights=[10.0, 1.0]
+    )
+    assert [str(sch.trace) for _, sch in dispatch] == [traces[0], traces[0]]
+
+
+@tvm.testing.requires_llvm
+def test_tune_dynamic_matmul_cpu():
+    func = _dynamic_matmul()
+    samples = ms.tir_integration.sample_shape_values({"n": (16, 128)}, 2)
+    with tempfile.TemporaryDirectory() as work_dir:
+        target = Target("llvm --num-cores=16")
+        database = ms.tir_integration.tune_tir_dynamic(
+            mod=func,
+            target=target,
+            work_dir=work_dir,
+            max_trials_global=16,
+            shape_samples=samples,
+            num_trials_per_iter=8,
+            num_cross_candidates=2,
+        )
+        dispatch = ms.tir_integration.compile_tir_dynamic(database, func, target, samples)
+        assert len(dispatch) == 2
+        assert str(dispatch[0][1].trace) == str(dispatch[1][1].trace)
+
+
+@tvm.testing.requires_llvm
+def test_tune_tasks_distributed_cpu():
+    target = Target("llvm --num-cores=16")
+    tasks = [
+        ms.ExtractedTask(name, tvm.IRModule({"main": func}), target, [], weight)
+        for name, func, weight in [("matmul", matmul, 2), ("two_step", two_step, 1)]
+    ]
+    with tempfile.TemporaryDirectory() as work_dir:
+        database = ms.tune_tasks_distributed(
+            tasks=tasks,
+            work_dir=work_dir,
+            max_trials_global=32,
+            num_trials_per_iter=8,
+            num_workers=2,
+            seed=0,
+        )
+        for task in tasks:
+            assert database.has_workload(task.mod)
+            assert ms.tir_integration.compile_tir(database, task.mod, target) is not None
+
+
 if __name__ == """__main__""":
     test_tune_matmul_cpu()
     test_tune_matmul_cuda()
     test_tune_run_module_via_rpc()
     test_tune_block_cpu()
+    test_sample_shape_values()
+    test_specialize_shape_vars()
+    test_compile_tir_dynamic()
+    test_tune_dynamic_matmul_cpu()
+    test_tune_tasks_distributed_cpu()
@@ -0,0 +1,72 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+
+pytest.importorskip("tvm.micro")
+
+import tvm
+import tvm.micro as micro
+import tvm.testing
+from tvm import relay
+from tvm.relay.backend import Executor, Runtime
+
+
+def _build(executor, runtime=Runtime("crt", {"system-lib": True})):
+    x = relay.var("x", shape=(2, 8), dtype="float32")
+    y = relay.var("y", shape=(2, 8), dtype="float32")
+    func = relay.Function([x, y], relay.add(x, y))
+    params = {"y": np.ones((2, 8), dtype="float32")}
+    with tvm.transform.PassContext(opt_level=3, config={"tir.disable_vectorize": True}):
+        return relay.build(
+            tvm.IRModule.from_expr(func),
+            tvm.target.target.micro("host"),
+            executor=executor,
+            runtime=runtime,
+            params=params,
+        )
+
+
+@tvm.testing.requires_micro
+def test_plan_static_arena():
+    report = micro.plan_static_arena(_build(Executor("graph")))
+    # x, the parameter and the output, each with its shape and its 64 bytes of data.
+    assert report.storage_bytes == 3 * (16 + 64)
+    # The names of the parameters, then the shape and the data of the parameter.
+    assert report.params_bytes == 240 + 16 + 64
+    assert report.workspace_bytes == 0
+    assert report.total_bytes == report.state_bytes + report.storage_bytes + report.params_bytes
+    assert f"#define TVM_CRT_STATIC_ARENA_SIZE_BYTES {report.total_bytes}\n" in report.to_c_header()
+
+
+@tvm.testing.requires_micro
+def test_plan_static_arena_pointer_size():
+    factory = _build(Executor("graph"))
+    report_32 = micro.plan_static_arena(factory, pointer_bytes=4)
+    report_64 = micro.plan_static_arena(factory, pointer_bytes=8)
+    assert report_32.state_bytes < report_64.state_bytes
+    assert report_32.storage_bytes == report_64.storage_bytes
+
+
+@tvm.testing.requires_micro
+def test_plan_static_arena_aot():
+    with pytest.raises(ValueError, match="graph executor"):
+        micro.plan_static_arena(_build(Executor("aot"), Runtime("crt")))
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
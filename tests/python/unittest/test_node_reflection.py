@@ -195,5 +195,26 @@ def test_alloc_const():
     np.testing.assert_array_equal(np_data, alloc_const2.data.numpy())
 
 
+def test_binary_roundtrip():
+    dev = tvm.cpu(0)
+    dtype = "float32"
+    shape = (16,)
+    buf = tvm.tir.decl_buffer(shape, dtype)
+    np_data = np.random.rand(*shape).astype(dtype)
+    data = tvm.nd.array(np_data, device=dev)
+    body = tvm.tir.Evaluate(tvm.tir.const(1.5, "float64") + tvm.tir.const(-3, "int64"))
+    alloc_const = tvm.tir.AllocateConst(buf.data, dtype, shape, data, body)
+    blob = tvm.ir.save_binary({"x": alloc_const, "y": [tvm.runtime.String("abc"), None]})
+    assert isinstance(blob, bytearray)
+    loaded = tvm.ir.load_binary(blob)
+    tvm.ir.assert_structural_equal(loaded["x"], alloc_const)
+    np.testing.assert_array_equal(np_data, loaded["x"].data.numpy())
+    assert loaded["y"][0] == "abc"
+    assert loaded["y"][1] is None
+
+    with pytest.raises(tvm.error.TVMError):
+        tvm.ir.load_binary(blob[: len(blob) // 2])
+
+
 if __name__ == "__main__":
     tvm.testing.main()
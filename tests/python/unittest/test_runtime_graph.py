@@ -138,6 +138,50 @@ def test_load_unexpected_params():
     rt_mod.load_params(runtime.save_param_dict(new_params))
 
 
+@tvm.testing.requires_llvm
+def test_graph_max_concurrency():
+    # two branches, whose intermediates reuse the storages of each other
+    x = relay.var("x", shape=(16, 16))
+    branches = []
+    for i in range(2):
+        y = relay.nn.relu(relay.add(x, relay.const(float(i))))
+        branches.append(relay.exp(relay.multiply(y, relay.const(0.5))))
+    func = relay.Function([x], relay.concatenate(branches, axis=0))
+    with tvm.transform.PassContext(opt_level=0):
+        lib = relay.build(func, target="llvm")
+
+    a = np.random.uniform(-1, 1, size=(16, 16)).astype("float32")
+    mod = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+    mod.run(x=a)
+    expected = mod.get_output(0).numpy()
+    for max_concurrency in [4, 2, 1]:
+        mod.set_max_concurrency(max_concurrency)
+        for _ in range(10):
+            mod.run(x=a)
+            np.testing.assert_equal(mod.get_output(0).numpy(), expected)
+
+
+@tvm.testing.requires_llvm
+def test_graph_create_shared():
+    x = relay.var("x", shape=(1, 10))
+    w = relay.var("w", shape=(10, 10))
+    func = relay.Function([x, w], relay.nn.relu(relay.nn.dense(x, w)))
+    w_np = np.random.uniform(-1, 1, size=(10, 10)).astype("float32")
+    lib = relay.build(func, target="llvm", params={"w": w_np})
+
+    mods = [graph_executor.create_shared(lib, tvm.cpu(0)) for _ in range(3)]
+    # the params are the same arrays, not copies
+    w_ptrs = {mod.get_input(mod.get_input_index("w")).handle.contents.data for mod in mods}
+    assert len(w_ptrs) == 1
+    for mod in mods:
+        a = np.random.uniform(size=(1, 10)).astype("float32")
+        mod.run(x=a)
+        expected = np.maximum(a @ w_np.T, 0)
+        tvm.testing.assert_allclose(mod.get_output(0).numpy(), expected, rtol=1e-5)
+
+
 if __name__ == "__main__":
     test_graph_simple()
     test_load_unexpected_params()
+    test_graph_max_concurrency()
+    test_graph_create_shared()
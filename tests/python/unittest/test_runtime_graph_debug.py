@@ -275,5 +275,32 @@ def test_run_single_node(graph, n, A, myadd):
         mod.run_individual_node(2)
 
 
+@tvm.testing.requires_llvm
+@pytest.mark.skipif(
+    tvm.support.libinfo()["USE_PROFILER"] != "ON", reason="TVM was not built with profiler support"
+)
+def test_sampled_profiling(graph, n, A, mlib):
+    mod = debug_executor.create(graph, mlib, tvm.cpu(0))
+    a = np.random.uniform(size=(n,)).astype(A.dtype)
+    mod.set_input(x=a)
+
+    mod.set_sampling_interval(4)
+    for _ in range(8):
+        mod.module["run"]()
+    tvm.testing.assert_allclose(mod.get_output(0).numpy(), a + 1)
+
+    report = mod.sampled_report(reset=True)
+    assert len(report.calls) == 1
+    assert report.calls[0]["Name"] == "myadd"
+    assert report.calls[0]["Count"].value == 2
+    assert report.configuration["Sampled Runs"].value == 2
+    assert len(report.csv()) > 0
+
+    # the samples are dropped and the disabled sampling does not collect more
+    mod.set_sampling_interval(0)
+    mod.module["run"]()
+    assert len(mod.sampled_report().calls) == 0
+
+
 if __name__ == "__main__":
     tvm.testing.main()
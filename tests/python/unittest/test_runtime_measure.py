@@ -57,6 +57,30 @@ def test_min_repeat_ms():
     assert ct > 10 + 2
 
 
+def test_statistical_time_evaluator():
+    num_calls = [0]
+
+    @tvm.register_func("testing.measure_slow_start", override=True)
+    def slow_start():
+        """the first repeat is a warmup outlier"""
+        num_calls[0] += 1
+        time.sleep(0.05 if num_calls[0] <= 3 else 0.002)
+
+    X = te.compute((), lambda: tvm.tir.call_packed("testing.measure_slow_start"))
+    s = te.create_schedule(X.op)
+    func = tvm.build(s, [X])
+
+    x = tvm.nd.empty((), dtype="int32")
+    ftimer = func.time_evaluator(
+        func.entry_name, tvm.cpu(), repeat=3, max_repeat=20, max_relative_error=0.2
+    )
+    result = ftimer(x)
+    assert 3 <= len(result.results) <= 20
+    assert max(result.results) < 0.04
+    low, high = result.confidence_interval
+    assert low <= result.mean <= high
+
+
 def test_benchmark_result():
     r = BenchmarkResult([1, 2, 2, 5])
     assert r.mean == 2.5
@@ -66,6 +90,15 @@ def test_benchmark_result():
     assert r.std == 1.5
 
 
+def test_benchmark_result_statistics():
+    r = BenchmarkResult([1, 2, 2, 5])
+    assert abs(r.p90 - 4.1) < 1e-9
+    low, high = r.confidence_interval
+    assert low < r.mean < high
+
+
 if __name__ == "__main__":
     test_min_repeat_ms()
+    test_statistical_time_evaluator()
     test_benchmark_result()
+    test_benchmark_result_statistics()
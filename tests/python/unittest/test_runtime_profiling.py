@@ -71,6 +71,8 @@ def test_vm(target, dev):
     assert "AllocTensorReg" in str(report)
     assert "AllocStorage" in str(report)
     assert report.configuration["Executor"] == "VM"
+    assert "Allocation Duration (us)" in report.configuration
+    assert "Kernel Duration (us)" in report.configuration
 
     csv = read_csv(report)
     assert "Hash" in csv.keys()
@@ -263,5 +265,35 @@ def test_profile_function(target, dev):
     assert report[metric].value > 0
 
 
+@pytest.mark.skipif(
+    tvm.support.libinfo().get("USE_RUNTIME_TRACE", "ON") in ["OFF", "0"],
+    reason="runtime tracing not built",
+)
+def test_runtime_trace():
+    tvm.runtime.profiling.start_trace()
+    a = tvm.nd.array(np.ones((16, 16), dtype="float32"))
+    b = tvm.nd.empty((16, 16), "float32")
+    a.copyto(b)
+    tvm.runtime.profiling.stop_trace()
+    # the spans after the trace stopped are not recorded
+    tvm.nd.empty((16, 16), "float32")
+
+    events = json.loads(tvm.runtime.profiling.dump_trace())["traceEvents"]
+    names = [event["name"] for event in events]
+    assert names.count("NDArray::Empty") == 2
+    assert "NDArray::CopyFromTo" in names
+    for event in events:
+        assert event["ph"] == "X"
+        assert event["dur"] >= 0
+
+    # starting again drops the spans recorded so far
+    tvm.runtime.profiling.start_trace(capacity=1)
+    tvm.nd.empty((4,), "float32")
+    tvm.nd.empty((4,), "float32")
+    tvm.runtime.profiling.stop_trace()
+    events = json.loads(tvm.runtime.profiling.dump_trace())["traceEvents"]
+    assert len(events) == 1
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -176,6 +176,99 @@ def test_rpc_large_array():
     check_remote()
 
 
+@tvm.testing.requires_rpc
+@pytest.mark.parametrize("compress", [False, True])
+def test_rpc_windowed_copy(compress):
+    server = rpc.Server()
+    remote = rpc.connect("127.0.0.1", server.port)
+    # blocks not a multiple of the elements, and a remainder block
+    remote.set_copy_options(window=3, block_bytes=1001, compress=compress)
+    dev = remote.cpu(0)
+    for a_np in [
+        np.random.uniform(size=(257, 33)).astype("float32"),
+        np.zeros((4096,), dtype="int8"),
+        np.arange(10, dtype="int64"),
+    ]:
+        a = tvm.nd.array(a_np, dev)
+        np.testing.assert_equal(a.numpy(), a_np)
+    # the windowed copies keep the replies of the later calls in order
+    assert remote.get_function("rpc.test.addone")(10) == 11
+
+
+@tvm.testing.requires_rpc
+@pytest.mark.skipif(not sys.platform.startswith("linux"), reason="shared memory is linux only")
+def test_rpc_shared_memory_session():
+    # a ring smaller than the arrays, which wrap around it
+    remote = rpc.SharedMemorySession(ring_bytes=4093)
+    dev = remote.cpu(0)
+    assert remote.get_function("testing.echo")("xyz") == "xyz"
+    for a_np in [
+        np.random.uniform(size=(257, 33)).astype("float32"),
+        np.arange(10, dtype="int64"),
+    ]:
+        a = tvm.nd.array(a_np, dev)
+        np.testing.assert_equal(a.numpy(), a_np)
+    with pytest.raises(ValueError):
+        rpc.SharedMemorySession(ring_bytes=0)
+
+
+@tvm.testing.requires_rpc
+@pytest.mark.skipif(
+    tvm.get_global_func("tvm.contrib.random.random_fill_for_measure", True) is None,
+    reason="USE_RANDOM is not ON",
+)
+def test_rpc_argument_cache():
+    server = rpc.Server()
+    remote = rpc.connect("127.0.0.1", server.port)
+    dev = remote.cpu(0)
+    f_get = remote.get_function("tvm.rpc.server.GetCachedArgument")
+    f_clear = remote.get_function("tvm.rpc.server.ClearArgumentCache")
+    a = f_get(dev, "float32", 0, 16, 8)
+    assert a.shape == (16, 8) and a.dtype == "float32"
+    # the same slot keeps the same contents, the next slot is another array
+    np.testing.assert_equal(f_get(dev, "float32", 0, 16, 8).numpy(), a.numpy())
+    b = f_get(dev, "float32", 1, 16, 8)
+    assert not np.array_equal(a.numpy(), b.numpy())
+    assert remote.get_function("tvm.rpc.server.ArgumentCacheBytes")() == 2 * 16 * 8 * 4
+    assert f_clear() == 2 * 16 * 8 * 4
+    assert f_clear() == 0
+
+
+@tvm.testing.requires_rpc
+def test_rpc_submit():
+    def check(remote):
+        dev = remote.cpu(0)
+        fecho = remote.get_function("testing.echo")
+        futures = [remote.submit(fecho, i) for i in range(8)]
+        raise_err = remote.get_function("testing.test_raise_error_callback")("RuntimeError")
+        ferr = remote.submit(raise_err)
+        fafter = remote.submit(fecho, "xyz")
+        a_np = np.random.uniform(size=(1000, 33)).astype("float32")
+        a = tvm.nd.empty(a_np.shape, "float32", dev)
+        fcopy_to = remote.submit_copy_to(a_np, a)
+        b = tvm.nd.empty(a_np.shape, "float32")
+        fcopy_from = remote.submit_copy_from(a, b)
+        assert [f.result() for f in futures] == list(range(8))
+        with pytest.raises(RuntimeError):
+            ferr.result()
+        # the requests after a failed one still complete
+        assert fafter.result() == "xyz"
+        assert fcopy_to.result() is None
+        fcopy_from.result()
+        assert fcopy_from.done()
+        np.testing.assert_equal(b.numpy(), a_np)
+        # a synchronous request receives the returns of the submitted ones
+        fnext = remote.submit(fecho, 1)
+        assert fecho(2) == 2
+        assert fnext.done() and fnext.result() == 1
+        with pytest.raises(ValueError):
+            remote.submit(lambda: None)
+
+    server = rpc.Server()
+    check(rpc.connect("127.0.0.1", server.port))
+    check(rpc.LocalSession())
+
+
 @tvm.testing.requires_rpc
 def test_rpc_echo():
     def check(remote):
@@ -512,6 +605,58 @@ def test_rpc_tracker_register():
     tracker.terminate()
 
 
+@tvm.testing.requires_rpc
+def test_rpc_tracker_tags():
+    tracker = Tracker(port=9000, port_end=10000)
+    device_key = "test_device"
+    servers = [
+        rpc.Server(
+            host="127.0.0.1",
+            port=9000,
+            port_end=10000,
+            key=device_key,
+            tracker_addr=("127.0.0.1", tracker.port),
+            tags=tags,
+        )
+        for tags in [{"gpu": "t4", "memory_gb": 16}, {"gpu": "a100", "memory_gb": 80}]
+    ]
+    time.sleep(1)
+    client = rpc.connect_tracker("127.0.0.1", tracker.port)
+
+    def sessions(summary):
+        return {
+            info["tags"]["gpu"]: info["sessions"]
+            for info in summary["server_info"]
+            if info["key"] == "server:%s" % device_key
+        }
+
+    remote = client.request(device_key, requirements={"memory_gb": 32})
+    summary = client.summary()
+    assert summary["queue_info"][device_key]["free"] == 1
+    assert sessions(summary) == {"t4": 0, "a100": 1}
+    assert "a100" in client.text_summary()
+
+    # the a100 is busy, the other request is served by the t4 meanwhile
+    remote_t4 = client.request_and_run(device_key, lambda sess: sess, requirements={"gpu": "t4"})
+    assert sessions(client.summary()) == {"t4": 1, "a100": 1}
+
+    del remote, remote_t4
+    for server in servers:
+        server.terminate()
+    tracker.terminate()
+
+
+def test_rpc_tracker_match_tags():
+    from tvm.rpc.tracker import match_tags
+
+    tags = {"gpu": "a100", "memory_gb": 80}
+    assert match_tags(tags, None)
+    assert match_tags(tags, {"gpu": "a100", "memory_gb": 40})
+    assert not match_tags(tags, {"memory_gb": 96})
+    assert not match_tags(tags, {"gpu": "t4"})
+    assert not match_tags(tags, {"arch": "sm_80"})
+
+
 def _target(host, port, device_key, timeout):
     client = rpc.connect_tracker(host, port)
     remote = client.request(device_key, session_timeout=timeout)
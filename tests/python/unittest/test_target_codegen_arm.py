@@ -16,6 +16,7 @@
 # under the License.
 import tvm
 from tvm import te
+from tvm.script import tir as T
 import re
 import os
 import ctypes
@@ -98,6 +99,25 @@ def test_vmlal_s16():
     check_broadcast_correct_assembly(64)
 
 
+
+def test_scalable_vectorize():
+    target = "llvm -mtriple=aarch64-linux-gnu -mattr=+sve"
+
+    @T.prim_func
+    def add_one(a: T.handle, b: T.handle) -> None:
+        T.func_attr({"global_symbol": "main", "tir.noalias": True})
+        n = T.var("int32")
+        A = T.match_buffer(a, [n], dtype="float32")
+        B = T.match_buffer(b, [n], dtype="float32")
+        for i in T.serial(n, annotations={"scalable_vectorize": 1}):
+            B[i] = A[i] + T.float32(1)
+
+    f = tvm.build(add_one, target=target)
+    # The LLVM loop vectorizer picks lanes as multiples of vscale
+    assert "vscale" in f.get_source("ll")
+
+
 if __name__ == "__main__":
     test_popcount()
     test_vmlal_s16()
+    test_scalable_vectorize()
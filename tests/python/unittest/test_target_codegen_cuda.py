@@ -21,6 +21,7 @@ import tvm
 from tvm import te
 import numpy as np
 from tvm import topi
+from tvm.contrib import utils
 from tvm.contrib.nvcc import have_fp16, have_int8, have_bf16
 import tvm.testing
 import pytest
@@ -1044,5 +1045,43 @@ def test_try_unaligned_vector_load():
     assert np.allclose(c, expected), f"expected={expected}\nactual={c}"
 
 
+
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+def test_compile_per_kernel_with_cache():
+    def lower(name, fcompute):
+        A = te.placeholder((64,), name="A")
+        B = te.compute((64,), lambda i: fcompute(A[i]), name="B")
+        s = te.create_schedule(B.op)
+        bx, tx = s[B].split(B.op.axis[0], factor=32)
+        s[B].bind(bx, te.thread_axis("blockIdx.x"))
+        s[B].bind(tx, te.thread_axis("threadIdx.x"))
+        return tvm.lower(s, [A, B], name=name)
+
+    mod = lower("add_one", lambda x: x + 1.0)
+    mod.update(lower("mul_two", lambda x: x * 2.0))
+    cache_dir = utils.tempdir()
+    config = {"cuda.compile_per_kernel": True, "cuda.kernel_cache_dir": cache_dir.temp_dir}
+
+    def build_and_check():
+        with tvm.transform.PassContext(config=config):
+            f = tvm.build(mod, target=tvm.target.Target("cuda", host="llvm"))
+        assert len(f.imported_modules[0].imported_modules) == 1
+        dev = tvm.cuda(0)
+        a_np = np.random.uniform(size=64).astype("float32")
+        a = tvm.nd.array(a_np, dev)
+        b = tvm.nd.empty((64,), "float32", dev)
+        f["add_one"](a, b)
+        tvm.testing.assert_allclose(b.numpy(), a_np + 1.0)
+        f["mul_two"](a, b)
+        tvm.testing.assert_allclose(b.numpy(), a_np * 2.0)
+
+    build_and_check()
+    cached = sorted(cache_dir.listdir())
+    assert len(cached) == 2
+    build_and_check()
+    assert sorted(cache_dir.listdir()) == cached
+
+
 if __name__ == "__main__":
     pytest.main([__file__])
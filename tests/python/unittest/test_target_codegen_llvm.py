@@ -151,6 +151,25 @@ def test_llvm_persist_parallel():
     check_llvm()
 
 
+@tvm.testing.requires_llvm
+def test_llvm_parallel_dynamic_chunk():
+    @T.prim_func
+    def func(A: T.Buffer[(100, 16), "float32"], B: T.Buffer[(100,), "float32"]):
+        for i in T.parallel(100, annotations={"parallel_chunk_size": 3}):
+            B[i] = T.float32(0)
+            # the work of the iterations is uneven
+            for j in T.serial(i % 16 + 1):
+                B[i] = B[i] + A[i, j]
+
+    f = tvm.build(func, target="llvm")
+    assert "atomicrmw add" in f.get_source("ll")
+    a = np.random.uniform(size=(100, 16)).astype("float32")
+    b = tvm.nd.empty((100,), "float32")
+    f(tvm.nd.array(a), b)
+    expected = [a[i, : i % 16 + 1].sum() for i in range(100)]
+    tvm.testing.assert_allclose(b.numpy(), expected, rtol=1e-5)
+
+
 @tvm.testing.requires_llvm
 def test_llvm_flip_pipeline():
     def check_llvm(nn, base):
@@ -749,6 +768,32 @@ def test_llvm_bf16():
     dotest(False)
 
 
+@tvm.testing.requires_llvm
+def test_llvm_int4_unpack():
+    # the packed int4 lanes of each uint32 are unpacked by a vector cast
+    n = 16
+    A = te.placeholder((n,), dtype="uint32", name="A")
+
+    def do_unpack(ins, outs):
+        ib = tvm.tir.ir_builder.create()
+        a = ib.buffer_ptr(ins[0])
+        b = ib.buffer_ptr(outs[0])
+        with ib.for_range(0, n, name="i") as i:
+            packed = tvm.tir.reinterpret("int4x8", a[i])
+            b[tvm.tir.Ramp(i * 8, 1, 8)] = packed.astype("int32x8")
+        return ib.get()
+
+    B = te.extern((n * 8,), [A], do_unpack, dtype="int32", name="B")
+    s = te.create_schedule(B.op)
+    f = tvm.build(s, [A, B], "llvm")
+    a_np = np.random.randint(0, 2**32, size=n, dtype="uint64").astype("uint32")
+    b = tvm.nd.empty((n * 8,), "int32")
+    f(tvm.nd.array(a_np), b)
+    nibbles = (a_np[:, None] >> (4 * np.arange(8, dtype="uint32"))) & 0xF
+    expected = np.where(nibbles >= 8, nibbles.astype("int32") - 16, nibbles.astype("int32"))
+    tvm.testing.assert_allclose(b.numpy(), expected.reshape(-1))
+
+
 @tvm.testing.requires_llvm
 def test_llvm_crt_static_lib():
     A = te.placeholder((32,), dtype="bfloat16")
@@ -978,5 +1023,50 @@ def test_llvm_target_attributes():
         assert n in functions_with_target
 
 
+
+@tvm.testing.requires_llvm
+def test_llvm_sharded_codegen():
+    @tvm.script.ir_module
+    class Module:
+        @T.prim_func
+        def add_one(A: T.Buffer[(16,), "float32"], B: T.Buffer[(16,), "float32"]) -> None:
+            T.func_attr({"global_symbol": "add_one", "tir.noalias": True})
+            for i in T.serial(16):
+                B[i] = A[i] + T.float32(1)
+
+        @T.prim_func
+        def mul_two(A: T.Buffer[(16,), "float32"], B: T.Buffer[(16,), "float32"]) -> None:
+            T.func_attr({"global_symbol": "mul_two", "tir.noalias": True})
+            for i in T.serial(16):
+                B[i] = A[i] * T.float32(2)
+
+        @T.prim_func
+        def sub_three(A: T.Buffer[(16,), "float32"], B: T.Buffer[(16,), "float32"]) -> None:
+            T.func_attr({"global_symbol": "sub_three", "tir.noalias": True})
+            for i in T.serial(16):
+                B[i] = A[i] - T.float32(3)
+
+    with tvm.transform.PassContext(config={"codegen.llvm.num_shards": 2}):
+        lib = tvm.build(Module, target="llvm")
+    assert len(lib.imported_modules) == 1
+    assert lib.imported_modules[0].type_key == "llvm"
+
+    def check(lib):
+        a_np = np.random.uniform(size=16).astype("float32")
+        a = tvm.nd.array(a_np)
+        b = tvm.nd.empty((16,), "float32")
+        expected = {"add_one": a_np + 1, "mul_two": a_np * 2, "sub_three": a_np - 3}
+        for name, b_np in expected.items():
+            assert lib.implements_function(name)
+            lib[name](a, b)
+            tvm.testing.assert_allclose(b.numpy(), b_np)
+
+    check(lib)
+    temp = utils.tempdir()
+    path = temp.relpath("sharded.so")
+    lib.export_library(path)
+    check(tvm.runtime.load_module(path))
+
+
 if __name__ == "__main__":
     tvm.testing.main()
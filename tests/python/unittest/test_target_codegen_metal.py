@@ -76,6 +76,32 @@ def test_metal_erf():
     check_erf(dev, 1, "float16")
 
 
+@tvm.testing.requires_gpu
+@tvm.testing.requires_metal
+def test_metal_batched_launches():
+    target = "metal"
+    n = 1024
+    A = te.placeholder((n,), name="A", dtype="float32")
+    B = te.compute((n,), lambda i: A[i] + 1.0, name="B")
+    s = te.create_schedule(B.op)
+    xo, xi = s[B].split(B.op.axis[0], factor=64)
+    s[B].bind(xo, bx)
+    s[B].bind(xi, tx)
+    fun = tvm.build(s, [A, B], target)
+
+    dev = tvm.device(target, 0)
+    a_np = np.random.uniform(size=n).astype(A.dtype)
+    a = tvm.nd.array(a_np, dev)
+    b = tvm.nd.empty((n,), B.dtype, dev)
+    # The launches and the device copies in between are batched into a few command buffers,
+    # and the sync waits for all of them.
+    for _ in range(100):
+        fun(a, b)
+        b.copyto(a)
+    dev.sync()
+    tvm.testing.assert_allclose(a.numpy(), a_np + 100, rtol=1e-5)
+
+
 if __name__ == "__main__":
     test_metal_inf_nan()
     test_metal_erf()
@@ -14,8 +14,10 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import numpy as np
 import tvm
 from tvm import te
+from tvm.contrib import utils
 import tvm.testing
 import re
 
@@ -184,9 +186,37 @@ def test_opencl_type_casting():
     check_type_casting(dev, 16, "float32")
 
 
+
+@tvm.testing.requires_gpu
+@tvm.testing.requires_opencl
+def test_opencl_program_cache():
+    n = 64
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: A[i] * 2.0 + 1.0, name="B")
+    s = te.create_schedule(B.op)
+    s[B].bind(s[B].op.axis[0], te.thread_axis("threadIdx.x"))
+    dev = tvm.device(target, 0)
+    cache_dir = utils.tempdir()
+    set_cache_dir = tvm.get_global_func("runtime.opencl.set_program_cache_dir")
+    set_cache_dir(cache_dir.temp_dir)
+    try:
+        for _ in range(2):
+            # a new module builds its programs again, from the cache after the first one
+            fun = tvm.build(s, [A, B], target)
+            a_np = np.random.uniform(size=n).astype("float32")
+            a = tvm.nd.array(a_np, dev)
+            b = tvm.nd.empty((n,), "float32", dev)
+            fun(a, b)
+            tvm.testing.assert_allclose(b.numpy(), a_np * 2.0 + 1.0, rtol=1e-6)
+            assert len([f for f in cache_dir.listdir() if f.endswith(".clbin")]) == 1
+    finally:
+        set_cache_dir("")
+
+
 if __name__ == "__main__":
     test_opencl_ternary_expression()
     test_opencl_inf_nan()
     test_opencl_max()
     test_opencl_erf()
     test_opencl_type_casting()
+    test_opencl_program_cache()
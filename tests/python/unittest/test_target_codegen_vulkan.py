@@ -27,6 +27,7 @@ import pytest
 import tvm
 import tvm.testing
 from tvm import relay, te
+from tvm.contrib import graph_executor
 from tvm.topi.math import cast
 
 
@@ -558,5 +559,49 @@ def test_shared_mem_alloc(target, dev):
         tvm.build(s, [Out], target)
 
 
+
+@pytest.mark.parametrize("subgroup_operations, expect_shuffle", [(48, True), (1, False)])
+def test_vulkan_subgroup_allreduce(subgroup_operations, expect_shuffle):
+    n = 32
+    A = te.placeholder((4, n), name="A")
+    k = te.reduce_axis((0, n), name="k")
+    B = te.compute((4,), lambda i: te.sum(A[i, k], axis=k), name="B")
+    s = te.create_schedule(B.op)
+    s[B].bind(B.op.axis[0], te.thread_axis("blockIdx.x"))
+    s[B].bind(k, te.thread_axis("threadIdx.x"))
+    mod = tvm.lower(s, [A, B])
+
+    target = tvm.target.Target(
+        f"vulkan -supported_subgroup_operations={subgroup_operations} -thread_warp_size={n}"
+    )
+    mod = tvm.tir.transform.Apply(lambda f: f.with_attr("target", target))(mod)
+    mod = tvm.tir.transform.LowerThreadAllreduce()(mod)
+    assert ("tvm_warp_shuffle_down" in mod.script()) == expect_shuffle
+
+
+@tvm.testing.parametrize_targets("vulkan")
+def test_vulkan_graph_replay(target, dev):
+    x = relay.var("x", shape=(64,), dtype="float32")
+    y = relay.exp(relay.add(x, relay.const(1.0))) * relay.const(2.0)
+    mod = tvm.IRModule.from_expr(relay.Function([x], relay.nn.relu(y)))
+    with tvm.transform.PassContext(opt_level=0):
+        lib = relay.build(mod, target=tvm.target.Target(target, host="llvm"))
+    gmod = graph_executor.GraphModule(lib["default"](dev))
+
+    def ref(x_np):
+        return np.maximum(np.exp(x_np + 1.0) * 2.0, 0)
+
+    x_np = np.random.uniform(-1, 1, size=64).astype("float32")
+    gmod.set_input("x", x_np)
+    gmod.capture_vulkan_graph()
+    tvm.testing.assert_allclose(gmod.get_output(0).numpy(), ref(x_np), rtol=1e-5)
+
+    for _ in range(3):
+        x_np = np.random.uniform(-1, 1, size=64).astype("float32")
+        gmod.set_input("x", x_np)
+        gmod.run_vulkan_graph()
+        tvm.testing.assert_allclose(gmod.get_output(0).numpy(), ref(x_np), rtol=1e-5)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
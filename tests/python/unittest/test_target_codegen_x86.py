@@ -107,5 +107,38 @@ def test_fp16_fp32_conversions(feature_string):
     np.testing.assert_allclose(out.asnumpy(), expected, rtol=1e-3)
 
 
+@tvm.testing.requires_llvm
+@pytest.mark.skipif(llvm_version < 12, reason=f"Requires LLVM 12+, got {llvm_version}")
+def test_amx_tensorize():
+    from tvm.tir.tensor_intrin.x86 import AMX_DOT_16x16x64_I8I8I32_INTRIN
+
+    m, n, k = 32, 32, 128
+    X = te.placeholder((m, k), name="X", dtype="int8")
+    W = te.placeholder((n // 16, k // 4, 16, 4), name="packedW", dtype="int8")
+    ak = te.reduce_axis((0, k), name="k")
+    C = te.compute(
+        (m, n),
+        lambda i, j: te.sum(
+            X[i, ak].astype("int32") * W[j // 16, ak // 4, j % 16, ak % 4].astype("int32"),
+            axis=ak,
+        ),
+        name="compute",
+    )
+    sch = tvm.tir.Schedule(te.create_prim_func([X, W, C]))
+    block = sch.get_block("compute")
+    i, j, k = sch.get_loops(block)
+    io, ii = sch.split(i, factors=[None, 16])
+    jo, ji = sch.split(j, factors=[None, 16])
+    ko, ki = sch.split(k, factors=[None, 64])
+    sch.reorder(io, jo, ko, ii, ji, ki)
+    sch.decompose_reduction(block, ko)
+    sch.tensorize(ii, AMX_DOT_16x16x64_I8I8I32_INTRIN)
+
+    f = tvm.build(sch.mod, target="llvm -mcpu=sapphirerapids")
+    llvm_ir = f.get_source("ll")
+    for intrin in ["tileloadd64", "tdpbssd", "tilestored64"]:
+        assert f"llvm.x86.{intrin}" in llvm_ir
+
+
 if __name__ == "__main__":
     test_fp16_to_fp32()
@@ -99,6 +99,35 @@ def matmul_expected(
             C[i, j] = C_shared_padded[i, j]
 
 
+@T.prim_func
+def matmul_dynamic_before(a: T.handle, b: T.handle, c: T.handle) -> None:
+    n = T.var("int32")
+    A = T.match_buffer(a, (n, 127), "float32")
+    B = T.match_buffer(b, (127, 127), "float32")
+    C = T.match_buffer(c, (n, 127), "float32")
+    A_shared = T.alloc_buffer((n, 127), "float32", scope="shared")
+    B_shared = T.alloc_buffer((127, 127), "float32", scope="shared")
+    C_shared = T.alloc_buffer((n, 127), "float32", scope="shared")
+    for i0, i1 in T.grid(n, 127):
+        with T.block("A"):
+            i, j = T.axis.remap("SS", [i0, i1])
+            A_shared[i, j] = A[i, j]
+    for i0, i1 in T.grid(127, 127):
+        with T.block("B"):
+            i, j = T.axis.remap("SS", [i0, i1])
+            B_shared[i, j] = B[i, j]
+    for i0, i1, i2 in T.grid(n, 127, 127):
+        with T.block("C_shared"):
+            i, j, k = T.axis.remap("SSR", [i0, i1, i2])
+            with T.init():
+                C_shared[i, j] = T.float32(0)
+            C_shared[i, j] = C_shared[i, j] + A_shared[i, k] * B_shared[k, j]
+    for i0, i1 in T.grid(n, 127):
+        with T.block("C"):
+            i, j = T.axis.remap("SS", [i0, i1])
+            C[i, j] = C_shared[i, j]
+
+
 # pylint: enable=no-member,invalid-name,unused-variable,unexpected-keyword-arg
 
 
@@ -110,6 +139,21 @@ def test_pad_matmul():
     verify_trace_roundtrip(sch, mod=matmul_before)
 
 
+def test_pad_matmul_dynamic():
+    sch = tir.Schedule(matmul_dynamic_before, debug_mask="all")
+    C = sch.get_block("C_shared")
+    # The dynamic extent is rounded up to a multiple of 16, the static ones are padded by 1
+    sch.pad_einsum(C, [16, 1, 1])
+    n = matmul_dynamic_before.buffer_map[matmul_dynamic_before.params[0]].shape[0]
+    analyzer = tvm.arith.Analyzer()
+    block = sch.get(C)
+    out_shape = block.writes[0].buffer.shape
+    assert analyzer.can_prove_equal(out_shape[0], (n + 15) // 16 * 16)
+    assert analyzer.can_prove_equal(out_shape[1], 128)
+    assert analyzer.can_prove_equal(block.iter_vars[0].dom.extent, (n + 15) // 16 * 16)
+    verify_trace_roundtrip(sch, mod=matmul_dynamic_before)
+
+
 def test_pad_matmul_error_non_intermediate_buffer():
     func = te.create_prim_func(te_workload.matmul(128, 127, 127))
     sch = tir.Schedule(func, debug_mask="all")
@@ -0,0 +1,95 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-function-docstring,missing-module-docstring
+import numpy as np
+import pytest
+import tvm
+import tvm.testing
+from tvm import tir
+from tvm.script import tir as T
+from tvm.tir.schedule.testing import verify_trace_roundtrip
+
+# fmt: off
+# pylint: disable=no-member,invalid-name,unused-variable,unexpected-keyword-arg
+
+@T.prim_func
+def padded_scale(
+    A: T.Buffer[(4, 16), "float32"],
+    indptr: T.Buffer[(5,), "int32"],
+    B: T.Buffer[(4, 16), "float32"],
+) -> None:
+    for i, j in T.grid(4, 16):
+        with T.block("B"):
+            vi, vj = T.axis.remap("SS", [i, j])
+            B[vi, vj] = A[vi, vj] * 2.0
+
+# pylint: enable=no-member,invalid-name,unused-variable,unexpected-keyword-arg
+# fmt: on
+
+
+def test_set_ragged_extent():
+    sch = tir.Schedule(padded_scale, debug_mask="all")
+    i, j = sch.get_loops(sch.get_block("B"))
+    sch.set_ragged_extent(j, i, "indptr")
+    loop = sch.get(j)
+    indptr = padded_scale.buffer_map[padded_scale.params[1]]
+    i_var = sch.get(i).loop_var
+    expected = indptr[i_var + 1] - indptr[i_var]
+    tvm.ir.assert_structural_equal(loop.annotations["ragged_extent"], expected)
+    verify_trace_roundtrip(sch=sch, mod=padded_scale)
+
+
+def test_set_ragged_extent_lowered():
+    sch = tir.Schedule(padded_scale)
+    i, j = sch.get_loops(sch.get_block("B"))
+    sch.set_ragged_extent(j, i, "indptr")
+    mod = tvm.lower(sch.mod)
+    inner = mod["main"].body
+    while not isinstance(inner, tir.For) or isinstance(inner.body, tir.For):
+        inner = inner.body
+    assert "ragged_extent" not in inner.annotations
+    assert not isinstance(inner.extent, tir.IntImm)
+
+
+def test_set_ragged_extent_error():
+    sch = tir.Schedule(padded_scale, debug_mask="all")
+    i, j = sch.get_loops(sch.get_block("B"))
+    with pytest.raises(tir.ScheduleError):
+        sch.set_ragged_extent(i, j, "indptr")
+    with pytest.raises(tir.ScheduleError):
+        sch.set_ragged_extent(j, i, "A")
+    with pytest.raises(tir.ScheduleError):
+        sch.set_ragged_extent(j, i, "offsets")
+
+
+@tvm.testing.requires_llvm
+def test_set_ragged_extent_build():
+    sch = tir.Schedule(padded_scale)
+    i, j = sch.get_loops(sch.get_block("B"))
+    sch.set_ragged_extent(j, i, "indptr")
+    f = tvm.build(sch.mod, target="llvm")
+    lengths = np.array([3, 16, 0, 7], dtype="int32")
+    indptr = np.concatenate([[0], np.cumsum(lengths)]).astype("int32")
+    a = np.random.rand(4, 16).astype("float32")
+    b = tvm.nd.array(np.zeros((4, 16), dtype="float32"))
+    f(tvm.nd.array(a), tvm.nd.array(indptr), b)
+    mask = np.arange(16)[None, :] < lengths[:, None]
+    tvm.testing.assert_allclose(b.numpy(), np.where(mask, a * 2.0, 0.0))
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
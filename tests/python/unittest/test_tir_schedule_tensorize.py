@@ -29,7 +29,11 @@ from tvm.tir.tensor_intrin.arm_cpu import (
     ARM_DOT_4x4_i8_SDOT_INTRIN,
 )
 from tvm.tir.tensor_intrin.rocm import AMDGPU_SDOT4_INTRIN
-from tvm.tir.tensor_intrin.x86 import VNNI_DOT_16x4_INTRIN
+from tvm.tir.tensor_intrin.x86 import (
+    AMX_DOT_16x16x32_BF16_INTRIN,
+    AMX_DOT_16x16x64_I8I8I32_INTRIN,
+    VNNI_DOT_16x4_INTRIN,
+)
 
 # fmt: off
 # pylint: disable=no-member,invalid-name,unused-variable,line-too-long,redefined-outer-name,unexpected-keyword-arg,too-many-nested-blocks
@@ -578,6 +582,51 @@ def test_tensorize_vnni():
     verify_trace_roundtrip(sch=sch, mod=func)
 
 
+def get_matmul_amx_packed(m, n, k, in_dtype, out_dtype, pack):
+    X = te.placeholder((m, k), name="X", dtype=in_dtype)
+    packed_W = te.placeholder((n // 16, k // pack, 16, pack), name="packedW", dtype=in_dtype)
+
+    ak = te.reduce_axis((0, k), name="k")
+    matmul = te.compute(
+        (m, n),
+        lambda i, j: te.sum(
+            X[i, ak].astype(out_dtype)
+            * packed_W[
+                tvm.tir.indexdiv(j, 16), tvm.tir.indexdiv(ak, pack), j % 16, ak % pack
+            ].astype(out_dtype),
+            axis=ak,
+        ),
+        name="compute",
+    )
+
+    return te.create_prim_func([X, packed_W, matmul])
+
+
+def _schedule_amx(func, k_dim, intrin):
+    sch = tir.Schedule(func, debug_mask="all")
+    block = sch.get_block("compute")
+    i, j, k = sch.get_loops(block)
+
+    io, ii = sch.split(i, factors=[None, 16])
+    jo, ji = sch.split(j, factors=[None, 16])
+    ko, ki = sch.split(k, factors=[None, k_dim])
+    sch.reorder(io, jo, ko, ii, ji, ki)
+
+    sch.decompose_reduction(block, ko)
+    sch.tensorize(ii, intrin)
+    return sch
+
+
+def test_tensorize_amx():
+    func = get_matmul_amx_packed(64, 64, 128, "int8", "int32", 4)
+    sch = _schedule_amx(func, 64, AMX_DOT_16x16x64_I8I8I32_INTRIN)
+    verify_trace_roundtrip(sch=sch, mod=func)
+
+    func = get_matmul_amx_packed(64, 64, 64, "bfloat16", "float32", 2)
+    sch = _schedule_amx(func, 32, AMX_DOT_16x16x32_BF16_INTRIN)
+    verify_trace_roundtrip(sch=sch, mod=func)
+
+
 def test_tensorize_arm_dot():
     m, n, k = 128, 128, 128
 
@@ -0,0 +1,124 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm import te
+
+fp8_dtype = tvm.testing.parameter("e4m3_float8", "e5m2_float8")
+
+
+def np_fp8_format(dtype):
+    """The mantissa bits, the bias and the largest finite code of a float8 format"""
+    return (3, 7, 0x7E) if dtype == "e4m3_float8" else (2, 15, 0x7B)
+
+
+def np_fp82np_float(codes, dtype):
+    """Decode the uint8 codes of a float8 to float32"""
+    m, bias, _ = np_fp8_format(dtype)
+    codes = codes.astype("int64")
+    exp = (codes >> m) & ((1 << (7 - m)) - 1)
+    man = codes & ((1 << m) - 1)
+    value = np.where(
+        exp == 0, man * 2.0 ** (1 - bias - m), (1 + man / 2.0**m) * 2.0 ** (exp - bias)
+    )
+    if dtype == "e4m3_float8":
+        value = np.where((codes & 0x7F) == 0x7F, np.nan, value)
+    else:
+        value = np.where(exp == 31, np.where(man == 0, np.inf, np.nan), value)
+    return np.where(codes & 0x80, -value, value).astype("float32")
+
+
+def np_float2np_fp8(values, dtype):
+    """Encode float32 to the uint8 codes of a float8, rounding to the nearest even"""
+    _, _, max_code = np_fp8_format(dtype)
+    finite = np.arange(max_code + 1)
+    table = np_fp82np_float(finite, dtype)
+    abs_values = np.minimum(np.abs(values), table[-1])
+    hi = np.minimum(np.searchsorted(table, abs_values), max_code)
+    lo = np.maximum(hi - 1, 0)
+    d_lo = abs_values - table[lo]
+    d_hi = table[hi] - abs_values
+    code = np.where((d_lo < d_hi) | ((d_lo == d_hi) & (lo % 2 == 0)), lo, hi)
+    return (code | np.where(values < 0, 0x80, 0)).astype("uint8")
+
+
+def test_fp8_dtype():
+    for dtype in ["e4m3_float8", "e5m2_float8", "e4m3_float8x4"]:
+        assert str(tvm.runtime.DataType(dtype)) == dtype
+        assert str(tvm.tir.const(1.0, dtype.split("x")[0]).dtype) == dtype.split("x")[0]
+
+
+def build_casts(dtype, vectorize):
+    A = te.placeholder((256,), dtype=dtype, name="A")
+    B = te.compute((256,), lambda i: A[i].astype("float32"), name="B")
+    C = te.compute((256,), lambda i: B[i].astype(dtype), name="C")
+    s = te.create_schedule(C.op)
+    if vectorize:
+        for tensor in [B, C]:
+            _, inner = s[tensor].split(tensor.op.axis[0], factor=8)
+            s[tensor].vectorize(inner)
+    return tvm.build(s, [A, B, C], "llvm")
+
+
+@tvm.testing.requires_llvm
+@pytest.mark.parametrize("vectorize", [False, True])
+def test_fp8_cast_round_trip(fp8_dtype, vectorize):
+    f = build_casts(fp8_dtype, vectorize)
+    codes = np.arange(256, dtype="uint8")
+    a = tvm.nd.array(codes)
+    b = tvm.nd.empty((256,), "float32")
+    c = tvm.nd.empty((256,), "uint8")
+    f(a, b, c)
+    decoded = np_fp82np_float(codes, fp8_dtype)
+    np.testing.assert_array_equal(b.numpy(), decoded)
+
+    # the NaNs are canonicalized and the infinities saturate
+    _, _, max_code = np_fp8_format(fp8_dtype)
+    sign = codes & 0x80
+    expected = np.where(np.isnan(decoded), sign | 0x7F, codes)
+    expected = np.where(np.isinf(decoded), sign | max_code, expected)
+    np.testing.assert_array_equal(c.numpy(), expected)
+
+
+@tvm.testing.requires_llvm
+def test_fp8_cast_rounding(fp8_dtype):
+    _, _, max_code = np_fp8_format(fp8_dtype)
+    max_value = np_fp82np_float(np.array([max_code]), fp8_dtype)[0]
+    np.random.seed(0)
+    values = np.concatenate(
+        [
+            np.random.uniform(-1.5 * max_value, 1.5 * max_value, 512),
+            np.random.uniform(-1, 1, 512) * 2.0 ** -np.random.randint(0, 20, 512),
+        ]
+    ).astype("float32")
+
+    A = te.placeholder(values.shape, dtype="float32", name="A")
+    B = te.compute(values.shape, lambda i: A[i].astype(fp8_dtype), name="B")
+    s = te.create_schedule(B.op)
+    _, inner = s[B].split(B.op.axis[0], factor=4)
+    s[B].vectorize(inner)
+    f = tvm.build(s, [A, B], "llvm")
+    b = tvm.nd.empty(values.shape, "uint8")
+    f(tvm.nd.array(values), b)
+    np.testing.assert_array_equal(b.numpy(), np_float2np_fp8(values, fp8_dtype))
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,111 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-function-docstring,missing-module-docstring
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm import tir
+from tvm.script import tir as T
+
+
+@T.prim_func
+def elementwise_reduce(a: T.handle, b: T.handle, c: T.handle) -> None:
+    A = T.match_buffer(a, (128, 64), "float32")
+    B = T.match_buffer(b, (64,), "float32")
+    C = T.match_buffer(c, (128,), "float32")
+    for i in T.serial(128):
+        for k in T.serial(64):
+            with T.block("C"):
+                vi, vk = T.axis.remap("SR", [i, k])
+                with T.init():
+                    C[vi] = T.float32(0)
+                C[vi] = C[vi] + A[vi, vk] * B[vk]
+
+
+def _prefetches(func):
+    prefetches = []
+
+    def fvisit(node):
+        if isinstance(node, tir.Call) and node.op.same_as(tvm.ir.Op.get("tir.prefetch")):
+            prefetches.append(node.args[0].args[0])
+
+    tir.stmt_functor.post_order_visit(func.body, fvisit)
+    return prefetches
+
+
+def _lower(sch):
+    mod = tvm.tir.transform.LowerOpaqueBlock()(sch.mod)
+    mod = tvm.tir.transform.FlattenBuffer()(mod)
+    return tvm.tir.transform.InjectSoftwarePrefetch()(mod)
+
+
+def test_prefetch_outer_loop():
+    sch = tir.Schedule(elementwise_reduce)
+    i, _ = sch.get_loops(sch.get_block("C"))
+    sch.annotate(i, "software_prefetch_distance", 4)
+    func = _lower(sch)["main"]
+    prefetches = _prefetches(func)
+    # A[i, k] depends on the inner loop var, B[k] does not depend on i
+    assert len(prefetches) == 1
+    assert prefetches[0].buffer.name == "C"
+    i_var = func.body.loop_var
+    tvm.ir.assert_structural_equal(prefetches[0].indices[0], T.min(i_var + 4, 127))
+    assert "software_prefetch_distance" not in func.body.annotations
+
+
+def test_prefetch_inner_loop():
+    sch = tir.Schedule(elementwise_reduce)
+    _, k = sch.get_loops(sch.get_block("C"))
+    sch.annotate(k, "software_prefetch_distance", 8)
+    func = _lower(sch)["main"]
+    prefetches = _prefetches(func)
+    assert sorted(load.buffer.name for load in prefetches) == ["A", "B"]
+
+
+def test_no_annotation():
+    mod = tvm.IRModule({"main": elementwise_reduce})
+    mod = tvm.tir.transform.FlattenBuffer()(tvm.tir.transform.LowerOpaqueBlock()(mod))
+    after = tvm.tir.transform.InjectSoftwarePrefetch()(mod)
+    tvm.ir.assert_structural_equal(mod, after)
+
+
+def test_invalid_distance():
+    sch = tir.Schedule(elementwise_reduce)
+    i, _ = sch.get_loops(sch.get_block("C"))
+    sch.annotate(i, "software_prefetch_distance", 0)
+    with pytest.raises(tvm.TVMError):
+        _lower(sch)
+
+
+@tvm.testing.requires_llvm
+def test_prefetch_build():
+    sch = tir.Schedule(elementwise_reduce)
+    i, k = sch.get_loops(sch.get_block("C"))
+    sch.annotate(i, "software_prefetch_distance", 2)
+    sch.annotate(k, "software_prefetch_distance", 16)
+    f = tvm.build(sch.mod, target="llvm")
+    a = np.random.rand(128, 64).astype("float32")
+    b = np.random.rand(64).astype("float32")
+    c = tvm.nd.empty((128,), "float32")
+    f(tvm.nd.array(a), tvm.nd.array(b), c)
+    tvm.testing.assert_allclose(c.numpy(), a @ b, rtol=1e-5)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
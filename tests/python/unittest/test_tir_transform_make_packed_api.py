@@ -147,5 +147,35 @@ def test_device_api_context_implicit_resource_handle():
     assert call_extern.args[2] == device_context_in_resource_handle
 
 
+def test_unchecked_api():
+    n = te.size_var("n")
+    A = te.placeholder((n,), name="A")
+    B = te.compute(A.shape, lambda i: A[i] + 1, name="B")
+    s = te.create_schedule(B.op)
+    mod = schedule_to_module(s, [A, B])
+    mod = tvm.tir.transform.StorageFlatten(64)(mod)
+    mod = tvm.tir.transform.Apply(
+        lambda f: f.with_attr({"target": tvm.target.Target("llvm"), "global_symbol": "main"})
+    )(mod)
+
+    def num_asserts(func):
+        asserts = []
+        tvm.tir.stmt_functor.post_order_visit(
+            func.body, lambda n: asserts.append(n) if isinstance(n, tvm.tir.AssertStmt) else None
+        )
+        return len(asserts)
+
+    with tvm.transform.PassContext(config={"tir.make_unchecked_api": True}):
+        mod = tvm.tir.transform.MakePackedAPI()(mod)
+    checked, unchecked = mod["main"], mod["main_unchecked"]
+    assert unchecked.attrs["global_symbol"] == "main_unchecked"
+    assert len(unchecked.params) == len(checked.params)
+    assert num_asserts(checked) > 0
+    assert num_asserts(unchecked) == 0
+
+    # the shape var is still read from the DLTensor
+    assert _find_assignment(unchecked.body, "n") is not None
+
+
 if __name__ == "__main__":
     test_makeapi()
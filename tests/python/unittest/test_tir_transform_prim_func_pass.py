@@ -63,6 +63,44 @@ def test_cow_pass():
     assert func_hash == mod["main"].__hash__()
 
 
+def _many_kernels(num_kernels):
+    funcs = {}
+    for i in range(num_kernels):
+        n = 16 * (i + 1)
+        A = te.placeholder((n, n), name="A")
+        B = te.compute((n, n), lambda x, y: A[x, y] * (i + 1) + A[y, x] * (i + 1), name="B")
+        funcs[f"kernel_{i}"] = te.create_prim_func([A, B]).with_attr("global_symbol", f"k{i}")
+    return tvm.IRModule(funcs)
+
+
+def test_parallel_lowering_is_deterministic():
+    mod = _many_kernels(12)
+    config = {"tir.enable_equiv_terms_in_cse_tir": True}
+    with tvm.transform.PassContext(config=config):
+        expected = tvm.lower(mod)
+    for num_threads in [2, 4, 0]:
+        config["tir.PrimFuncPass.num_threads"] = num_threads
+        with tvm.transform.PassContext(config=config):
+            lowered = tvm.lower(mod)
+        assert list(lowered.get_global_vars()) == list(expected.get_global_vars())
+        tvm.ir.assert_structural_equal(lowered, expected)
+
+
+def test_parallel_pass_context_is_current():
+    seen = []
+
+    @tvm.tir.transform.prim_func_pass(opt_level=0)
+    def record_config(func, mod, ctx):
+        seen.append(tvm.transform.PassContext.current().config.get("tir.PrimFuncPass.num_threads"))
+        return func
+
+    with tvm.transform.PassContext(config={"tir.PrimFuncPass.num_threads": 4}):
+        record_config(_many_kernels(8))
+    assert [int(v) for v in seen] == [4] * 8
+
+
 if __name__ == "__main__":
     test_cow_pass()
     test_prim_func_pass()
+    test_parallel_lowering_is_deterministic()
+    test_parallel_pass_context_is_current()
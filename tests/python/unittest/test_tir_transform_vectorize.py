@@ -14,7 +14,10 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import numpy as np
+
 import tvm
+import tvm.testing
 from tvm import te
 
 
@@ -226,6 +229,66 @@ def test_vectorize_dtype_mismatch():
     tvm.lower(s, [A], "llvm", simple_mode=True)
 
 
+def _masked_tail_mod():
+    n = te.var("n")
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, tvm.tir.indexdiv(n + 3, 4), name="i0") as i0:
+        with ib.for_range(0, 4, kind="vectorize", name="i1") as i1:
+            with ib.if_scope(i0 * 4 + i1 < n):
+                B[i0 * 4 + i1] = A[i0 * 4 + i1] + 1.0
+    return tvm.IRModule.from_expr(tvm.tir.PrimFunc([A, B, n], ib.get()))
+
+
+def test_vectorize_masked_tail():
+    mod = _masked_tail_mod()
+    with tvm.transform.PassContext(config={"tir.VectorizeLoop": {"enable_predication": True}}):
+        stmt = tvm.tir.transform.VectorizeLoop()(mod)["main"].body
+    assert isinstance(stmt.body, tvm.tir.Evaluate)
+    store = stmt.body.value
+    assert store.op.same_as(tvm.ir.Op.get("tir.masked_store"))
+    assert store.args[2].dtype == "boolx4"
+    load = store.args[1].a
+    assert load.op.same_as(tvm.ir.Op.get("tir.masked_load"))
+    assert load.dtype == "float32x4"
+
+    # Scalarized by default
+    stmt = tvm.tir.transform.VectorizeLoop()(mod)["main"].body
+    assert isinstance(stmt.body, tvm.tir.For)
+
+
+def test_vectorize_masked_tail_fallback():
+    n = te.var("n")
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    with ib.for_range(0, 4, kind="vectorize") as i:
+        with ib.if_scope(i < n):
+            # The uniform store cannot be masked
+            A[0] = A[i] + 1
+    mod = tvm.IRModule.from_expr(tvm.tir.PrimFunc([A, n], ib.get()))
+    with tvm.transform.PassContext(config={"tir.VectorizeLoop": {"enable_predication": True}}):
+        stmt = tvm.tir.transform.VectorizeLoop()(mod)["main"].body
+    assert isinstance(stmt, tvm.tir.For)
+
+
+@tvm.testing.requires_llvm
+def test_vectorize_masked_tail_build():
+    n = te.var("n")
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: A[i] + 1.0, name="B")
+    s = te.create_schedule(B.op)
+    _, inner = s[B].split(B.op.axis[0], factor=8)
+    s[B].vectorize(inner)
+    with tvm.transform.PassContext(config={"tir.VectorizeLoop": {"enable_predication": True}}):
+        f = tvm.build(s, [A, B], "llvm")
+    for size in [5, 16, 21]:
+        a = tvm.nd.array(np.random.rand(size).astype("float32"))
+        b = tvm.nd.array(np.zeros(size, dtype="float32"))
+        f(a, b)
+        tvm.testing.assert_allclose(b.numpy(), a.numpy() + 1.0)
+
+
 if __name__ == "__main__":
     test_vectorize_vector()
     test_vectorize_with_if()
@@ -236,3 +299,5 @@ if __name__ == "__main__":
     test_vectorize_let()
     test_vectorize_while_fail()
     test_vectorize_dtype_mismatch()
+    test_vectorize_masked_tail()
+    test_vectorize_masked_tail_fallback()
@@ -124,7 +124,9 @@ def test_no_pool_error():
         buffer_pool_allocations = fusmp_algo(buffer_info_arr, 0)
 
 
-@pytest.mark.parametrize("algorithm", ["greedy_by_size", "greedy_by_conflicts", "hill_climb"])
+@pytest.mark.parametrize(
+    "algorithm", ["greedy_by_size", "greedy_by_conflicts", "hill_climb", "tiered_by_access"]
+)
 def test_name_based_ordering(algorithm):
     """This checks when the size and conlicts are same a stable result is generated"""
 
@@ -161,7 +163,12 @@ def test_name_based_ordering(algorithm):
 
 @pytest.mark.parametrize(
     ["algorithm", "workspace_size"],
-    [("greedy_by_size", 140), ("greedy_by_conflicts", 140), ("hill_climb", 140)],
+    [
+        ("greedy_by_size", 140),
+        ("greedy_by_conflicts", 140),
+        ("hill_climb", 140),
+        ("tiered_by_access", 140),
+    ],
 )
 def test_linear(algorithm, workspace_size):
     """
@@ -685,6 +692,40 @@ def test_resnet_subgraph(algorithm, workspace_size):
     _check_max_workspace_size(buffer_pool_allocations, global_workspace_pool, workspace_size)
 
 
+def test_tiered_by_access():
+    """The hot buffers are placed in the pool of the highest bandwidth, whatever the order of
+    the candidates, and the cold ones spill to the slow pool"""
+    target = Target("c")
+    slow_pool = WorkspacePoolInfo(
+        "slow_memory",
+        [target],
+        PoolInfoProperties(read_bandwidth_bytes_per_cycle=1, write_bandwidth_bytes_per_cycle=1),
+    )
+    fast_pool = WorkspacePoolInfo(
+        "fast_memory",
+        [target],
+        PoolInfoProperties(
+            size_hint_bytes=40, read_bandwidth_bytes_per_cycle=8, write_bandwidth_bytes_per_cycle=8
+        ),
+    )
+    pools = [slow_pool, fast_pool]
+    bi_cold = usmp_utils.BufferInfo("bi_cold", 20, pools, access_bytes=20)
+    bi_hot = usmp_utils.BufferInfo("bi_hot", 10, pools, access_bytes=1000)
+    bi_warm = usmp_utils.BufferInfo("bi_warm", 20, pools, access_bytes=400)
+    bi_cold.set_conflicts([bi_hot, bi_warm])
+    bi_hot.set_conflicts([bi_cold, bi_warm])
+    bi_warm.set_conflicts([bi_cold, bi_hot])
+
+    fusmp_algo = tvm.get_global_func("tir.usmp.algo.tiered_by_access")
+    buffer_pool_allocations = fusmp_algo([bi_cold, bi_hot, bi_warm], 0)
+    assert buffer_pool_allocations[bi_hot].pool_info == fast_pool
+    assert buffer_pool_allocations[bi_hot].byte_offset == 0
+    assert buffer_pool_allocations[bi_warm].pool_info == fast_pool
+    assert buffer_pool_allocations[bi_warm].byte_offset == 16
+    assert buffer_pool_allocations[bi_cold].pool_info == slow_pool
+    assert buffer_pool_allocations[bi_cold].byte_offset == 0
+
+
 def test_custom_algo():
     target = Target("c")
     global_workspace_pool = WorkspacePoolInfo(
@@ -202,6 +202,9 @@ def test_linear():
     assert buffer_info_map["tensor_2"].size_bytes == 200704
     assert buffer_info_map["sid_9"].size_bytes == 301056
 
+    # check the accesses, weighted by the extents of their loops
+    assert buffer_info_map["Conv2dOutput_7"].access_bytes == 12544 * 64 * (1 + 2 * 147 + 1) * 4
+
     # check_pool_candidates
     assert [
         pool_info.pool_name for pool_info in list(buffer_info_map["sid_8"].pool_candidates)
@@ -35,7 +35,11 @@ function __wasmLibStart(wasmInstance) {
 
 __wasmLib.start = __wasmLibStart;
 
-var Module = {
-    "instantiateWasm": __wasmLibInstantiateWasm,
-    "wasmLibraryProvider": __wasmLib
-};
+// The pthread workers instantiate the module the main thread sent them
+// through the Module they set up themselves.
+if (typeof Module === "undefined" || !Module["ENVIRONMENT_IS_PTHREAD"]) {
+    var Module = {
+        "instantiateWasm": __wasmLibInstantiateWasm,
+        "wasmLibraryProvider": __wasmLib
+    };
+}
@@ -43,6 +43,14 @@
 #include "src/runtime/object.cc"
 #include "src/runtime/profiling.cc"
 #include "src/runtime/registry.cc"
+#include "src/runtime/relax_vm/builtin.cc"
+#include "src/runtime/relax_vm/bytecode.cc"
+#include "src/runtime/relax_vm/constant_codec.cc"
+#include "src/runtime/relax_vm/executable.cc"
+#include "src/runtime/relax_vm/kv_cache.cc"
+#include "src/runtime/relax_vm/memory_manager.cc"
+#include "src/runtime/relax_vm/param_store.cc"
+#include "src/runtime/relax_vm/vm.cc"
 #include "src/runtime/rpc/rpc_channel.cc"
 #include "src/runtime/rpc/rpc_endpoint.cc"
 #include "src/runtime/rpc/rpc_event_impl.cc"
@@ -50,10 +58,16 @@
 #include "src/runtime/rpc/rpc_module.cc"
 #include "src/runtime/rpc/rpc_session.cc"
 #include "src/runtime/system_library.cc"
+#include "src/runtime/trace.cc"
 #include "src/runtime/workspace_pool.cc"
 
 // --- Implementations of backend and wasm runtime API. ---
 
+#ifdef __EMSCRIPTEN_PTHREADS__
+// The parallel loops run on a thread pool of web workers sharing the memory.
+#include "src/runtime/thread_pool.cc"
+#include "src/runtime/threading_backend.cc"
+#else
 int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task) {
   TVMParallelGroupEnv env;
   env.num_task = 1;
@@ -62,6 +76,7 @@ int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_ta
 }
 
 int TVMBackendParallelBarrier(int task_id, TVMParallelGroupEnv* penv) { return 0; }
+#endif
 
 // --- Environment PackedFuncs for testing ---
 namespace tvm {
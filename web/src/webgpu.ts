@@ -24,6 +24,12 @@ import { Memory } from "./memory";
 /** A pointer to points to the raw address space. */
 export type GPUPointer = number;
 
+/**
+ * The number of dispatches recorded in the pending command encoder
+ * before it is submitted without waiting for a sync point.
+ */
+const kMaxPendingDispatches = 128;
+
 /**
  * DetectGPU device in the environment.
  */
@@ -55,6 +61,11 @@ export class WebGPUContext {
   private bufferTableFreeId: Array<number> = [];
   private pendingRead: Promise<void> = Promise.resolve();
   private numPendingReads = 0;
+  // The encoder and the compute pass the dispatches are batched into.
+  private pendingEncoder?: GPUCommandEncoder;
+  private pendingCompute?: GPUComputePassEncoder;
+  private numPendingDispatches = 0;
+  private flushScheduled = false;
 
   constructor(memory: Memory, device: GPUDevice) {
     this.memory = memory;
@@ -65,6 +76,7 @@ export class WebGPUContext {
    * Wait for all pending GPU tasks to complete
    */
   async sync(): Promise<void> {
+    this.flushCommands();
     const fence = this.device.defaultQueue.createFence();
     this.device.defaultQueue.signal(fence, 1);
     if (this.numPendingReads != 0) {
@@ -75,6 +87,42 @@ export class WebGPUContext {
     }
   }
 
+  /**
+   * Submit the dispatches recorded since the last submission.
+   *
+   * The kernels of a function are recorded into a single compute pass
+   * rather than submitted one by one, the pass is submitted before the
+   * commands that depend on it, at sync points, when it grows past
+   * kMaxPendingDispatches, or once the current task yields.
+   */
+  flushCommands(): void {
+    if (this.pendingEncoder === undefined) return;
+    (this.pendingCompute as GPUComputePassEncoder).endPass();
+    const command = this.pendingEncoder.finish();
+    this.pendingEncoder = undefined;
+    this.pendingCompute = undefined;
+    this.numPendingDispatches = 0;
+    this.device.defaultQueue.submit([command]);
+  }
+
+  /**
+   * Get the compute pass to record a dispatch into.
+   */
+  private getComputePass(): GPUComputePassEncoder {
+    if (this.pendingEncoder === undefined) {
+      this.pendingEncoder = this.device.createCommandEncoder();
+      this.pendingCompute = this.pendingEncoder.beginComputePass();
+      if (!this.flushScheduled) {
+        this.flushScheduled = true;
+        Promise.resolve().then(() => {
+          this.flushScheduled = false;
+          this.flushCommands();
+        });
+      }
+    }
+    return this.pendingCompute as GPUComputePassEncoder;
+  }
+
   /**
    * Create a PackedFunc that runs the given shader
    *
@@ -130,8 +178,7 @@ export class WebGPUContext {
     }
 
     const submitShader = (...args: Array<GPUPointer | number>): void => {
-      const commandEncoder = this.device.createCommandEncoder();
-      const compute = commandEncoder.beginComputePass();
+      const compute = this.getComputePass();
       compute.setPipeline(pipeline);
       const bindGroupEntries: Array<GPUBindGroupEntry> = [];
       assert(args.length == layoutEntries.length + dispatchToDim.length);
@@ -154,9 +201,10 @@ export class WebGPUContext {
         wl[dispatchToDim[i]] = args[layoutEntries.length + i];
       }
       compute.dispatch(wl[0], wl[1], wl[2]);
-      compute.endPass();
-      const command = commandEncoder.finish();
-      this.device.defaultQueue.submit([command]);
+      this.numPendingDispatches += 1;
+      if (this.numPendingDispatches >= kMaxPendingDispatches) {
+        this.flushCommands();
+      }
     };
 
     return submitShader;
@@ -225,6 +273,8 @@ export class WebGPUContext {
     this.bufferTable[idx] = undefined;
     assert(buffer !== undefined);
     this.bufferTableFreeId.push(idx);
+    // The pending dispatches may still use the buffer.
+    this.flushCommands();
     buffer.destroy();
   }
 
@@ -247,6 +297,7 @@ export class WebGPUContext {
     viewU8.set(this.memory.loadRawBytes(from, nbytes));
     gpuTemp.unmap();
 
+    this.flushCommands();
     const copyEncoder = this.device.createCommandEncoder();
     copyEncoder.copyBufferToBuffer(
       gpuTemp,
@@ -272,6 +323,7 @@ export class WebGPUContext {
       usage: GPUBufferUsage.MAP_READ | GPUBufferUsage.COPY_DST,
     });
 
+    this.flushCommands();
     const copyEncoder = this.device.createCommandEncoder();
     copyEncoder.copyBufferToBuffer(
       this.gpuBufferFromPtr(from),
@@ -309,6 +361,7 @@ export class WebGPUContext {
     toOffset: number,
     nbytes: number
   ): void {
+    this.flushCommands();
     const copyEncoder = this.device.createCommandEncoder();
     copyEncoder.copyBufferToBuffer(
       this.gpuBufferFromPtr(from),